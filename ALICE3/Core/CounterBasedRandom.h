@@ -0,0 +1,158 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+///
+/// \file CounterBasedRandom.h
+///
+/// \brief Counter-based random numbers for the smearing of the on-the-fly detectors
+///
+/// The random numbers of a track are a function of (seed, event key, track key, stream) only, computed
+/// with the Philox4x32-10 generator of Salmon et al. (SC'11). Contrary to a sequential engine such as
+/// TRandom3, the smearing of a track does not depend on how many numbers were drawn before it, so the
+/// tracks can be processed in any order and by any number of threads with identical results.
+/// TabulatedDistribution samples a distribution given as a function by inversion of its cumulative,
+/// tabulated once, as a thread-safe replacement of TF1::GetRandom.
+///
+
+#ifndef ALICE3_CORE_COUNTERBASEDRANDOM_H_
+#define ALICE3_CORE_COUNTERBASEDRANDOM_H_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace o2::upgrade
+{
+
+class CounterBasedRandom
+{
+ public:
+  explicit CounterBasedRandom(uint64_t seed = 0) { setSeed(seed); }
+  void setSeed(uint64_t seed) { mSeed = seed; }
+  uint64_t getSeed() const { return mSeed; }
+
+  /// Four independent 32-bit random words of the counter (event, track, stream)
+  std::array<uint32_t, 4> generate(uint64_t event, uint32_t track, uint32_t stream) const
+  {
+    std::array<uint32_t, 4> counter = {static_cast<uint32_t>(event), static_cast<uint32_t>(event >> 32), track, stream};
+    std::array<uint32_t, 2> key = {static_cast<uint32_t>(mSeed), static_cast<uint32_t>(mSeed >> 32)};
+    for (int round = 0; round < NRounds; round++) {
+      const uint64_t product0 = static_cast<uint64_t>(Multiplier0) * counter[0];
+      const uint64_t product1 = static_cast<uint64_t>(Multiplier1) * counter[2];
+      counter = {static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ key[0], static_cast<uint32_t>(product1),
+                 static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ key[1], static_cast<uint32_t>(product0)};
+      key[0] += Weyl0;
+      key[1] += Weyl1;
+    }
+    return counter;
+  }
+
+  /// Uniform in (0, 1) from one of the words of generate()
+  static double toUniform(uint32_t word) { return (static_cast<double>(word) + 0.5) / 4294967296.; }
+
+  /// Uniform in (0, 1)
+  double uniform(uint64_t event, uint32_t track, uint32_t stream) const
+  {
+    return toUniform(generate(event, track, stream)[0]);
+  }
+
+  /// Two independent standard normal numbers (Box-Muller)
+  std::array<double, 2> normals(uint64_t event, uint32_t track, uint32_t stream) const
+  {
+    const auto words = generate(event, track, stream);
+    const double radius = std::sqrt(-2. * std::log(toUniform(words[0])));
+    const double angle = TwoPi * toUniform(words[1]);
+    return {radius * std::cos(angle), radius * std::sin(angle)};
+  }
+
+  double gaus(double mean, double sigma, uint64_t event, uint32_t track, uint32_t stream) const
+  {
+    return mean + sigma * normals(event, track, stream)[0];
+  }
+
+  /// Key built from the bits of the given values, e.g. the MC vertex and time of a collision, which does not
+  /// depend on the position of the collision in the dataframe
+  template <typename... TValues>
+  static uint64_t key(TValues... values)
+  {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    (mix(hash, values), ...);
+    return hash;
+  }
+
+ private:
+  static constexpr int NRounds = 10;
+  static constexpr uint32_t Multiplier0 = 0xD2511F53;
+  static constexpr uint32_t Multiplier1 = 0xCD9E8D57;
+  static constexpr uint32_t Weyl0 = 0x9E3779B9;
+  static constexpr uint32_t Weyl1 = 0xBB67AE85;
+  static constexpr double TwoPi = 2. * M_PI;
+
+  template <typename T>
+  static void mix(uint64_t& hash, T value)
+  {
+    uint64_t bits = 0;
+    std::memcpy(&bits, &value, std::min(sizeof(T), sizeof(bits)));
+    hash ^= bits + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2);
+    hash *= 0x100000001B3ULL;
+  }
+
+  uint64_t mSeed = 0;
+};
+
+class TabulatedDistribution
+{
+ public:
+  /// Tabulate the cumulative of f in [xMin, xMax] with nPoints intervals; f needs not be normalised
+  template <typename TFunction>
+  void tabulate(TFunction&& f, double xMin, double xMax, int nPoints = 100)
+  {
+    nPoints = std::max(nPoints, 1);
+    mX.resize(nPoints + 1);
+    mCumulative.resize(nPoints + 1);
+    const double step = (xMax - xMin) / nPoints;
+    mX[0] = xMin;
+    mCumulative[0] = 0.;
+    double previous = std::max(f(xMin), 0.);
+    for (int i = 1; i <= nPoints; i++) {
+      mX[i] = xMin + i * step;
+      const double current = std::max(f(mX[i]), 0.);
+      mCumulative[i] = mCumulative[i - 1] + 0.5 * (previous + current) * step;
+      previous = current;
+    }
+    if (mCumulative.back() > 0.) {
+      for (auto& value : mCumulative) {
+        value /= mCumulative.back();
+      }
+    }
+  }
+  bool empty() const { return mX.empty() || !(mCumulative.back() > 0.); }
+
+  /// Value of the distribution for a uniform number u in (0, 1)
+  double sample(double u) const
+  {
+    const auto upper = std::upper_bound(mCumulative.begin() + 1, mCumulative.end() - 1, u);
+    const std::size_t i = upper - mCumulative.begin();
+    const double width = mCumulative[i] - mCumulative[i - 1];
+    const double fraction = width > 0. ? (u - mCumulative[i - 1]) / width : 0.;
+    return mX[i - 1] + fraction * (mX[i] - mX[i - 1]);
+  }
+
+ private:
+  std::vector<double> mX;
+  std::vector<double> mCumulative;
+};
+
+} // namespace o2::upgrade
+
+#endif // ALICE3_CORE_COUNTERBASEDRANDOM_H_
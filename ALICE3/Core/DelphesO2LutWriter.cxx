@@ -23,7 +23,17 @@
 
 #include "ALICE3/Core/DelphesO2TrackSmearer.h"
 #include "ALICE3/Core/DelphesO2LutWriter.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <iostream>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "RZip.h"
+#include "TRandom3.h"
 #include "TMatrixD.h"
 #include "TVectorD.h"
 #include "TAxis.h"
@@ -57,24 +67,31 @@ bool DelphesO2LutWriter::fatSolve(lutEntry_t& lutEntry,
                                   int itof,
                                   int otof,
                                   int q,
-                                  const float nch)
+                                  const float nch,
+                                  FastTrackContext* context)
 {
   lutEntry.valid = false;
 
-  static TLorentzVector tlv;
+  TLorentzVector tlv;
   tlv.SetPtEtaPhiM(pt, eta, 0., mass);
   o2::track::TrackParCov trkIn;
   o2::upgrade::convertTLorentzVectorToO2Track(q, tlv, {0., 0., 0.}, trkIn);
   o2::track::TrackParCov trkOut;
-  const int status = fat.FastTrack(trkIn, trkOut, nch);
+  const int status = context ? fat.FastTrack(trkIn, trkOut, nch, *context) : fat.FastTrack(trkIn, trkOut, nch);
   if (status <= 0) {
     Printf(" --- fatSolve: FastTrack failed --- \n");
     tlv.Print();
     return false;
   }
+  auto goodHitProb = [&](int layer) -> float {
+    if (!context) {
+      return fat.GetGoodHitProb(layer);
+    }
+    return (layer >= 0 && static_cast<size_t>(layer) < context->goodHitProbability.size()) ? context->goodHitProbability[layer] : 0.0f;
+  };
   lutEntry.valid = true;
-  lutEntry.itof = fat.GetGoodHitProb(itof);
-  lutEntry.otof = fat.GetGoodHitProb(otof);
+  lutEntry.itof = goodHitProb(itof);
+  lutEntry.otof = goodHitProb(otof);
   for (int i = 0; i < 15; ++i)
     lutEntry.covm[i] = trkOut.getCov()[i];
 
@@ -82,13 +99,13 @@ bool DelphesO2LutWriter::fatSolve(lutEntry_t& lutEntry,
   auto totfake = 0.;
   lutEntry.eff = 1.;
   for (int i = 1; i < 20; ++i) {
-    auto igoodhit = fat.GetGoodHitProb(i);
+    auto igoodhit = goodHitProb(i);
     if (igoodhit <= 0. || i == itof || i == otof)
       continue;
     lutEntry.eff *= igoodhit;
     auto pairfake = 0.;
     for (int j = i + 1; j < 20; ++j) {
-      auto jgoodhit = fat.GetGoodHitProb(j);
+      auto jgoodhit = goodHitProb(j);
       if (jgoodhit <= 0. || j == itof || j == otof)
         continue;
       pairfake = (1. - igoodhit) * (1. - jgoodhit);
@@ -115,7 +132,7 @@ bool DelphesO2LutWriter::fwdSolve(float*, float, float, float)
 }
 #endif
 
-bool DelphesO2LutWriter::fwdPara(lutEntry_t& lutEntry, float pt, float eta, float mass, float Bfield)
+bool DelphesO2LutWriter::fwdPara(lutEntry_t& lutEntry, float pt, float eta, float mass, float Bfield, FastTrackContext* context)
 {
   lutEntry.valid = false;
 
@@ -123,7 +140,7 @@ bool DelphesO2LutWriter::fwdPara(lutEntry_t& lutEntry, float pt, float eta, floa
   if (std::fabs(eta) < etaMaxBarrel || std::fabs(eta) > 4)
     return false;
 
-  if (!fatSolve(lutEntry, pt, etaMaxBarrel, mass))
+  if (!fatSolve(lutEntry, pt, etaMaxBarrel, mass, 0, 0, 1, 1, context))
     return false;
   float covmbarrel[15] = {0};
   for (int i = 0; i < 15; ++i) {
@@ -180,30 +197,15 @@ bool DelphesO2LutWriter::fwdPara(lutEntry_t& lutEntry, float pt, float eta, floa
   return true;
 }
 
-void DelphesO2LutWriter::lutWrite(const char* filename, int pdg, float field, int itof, int otof)
+bool DelphesO2LutWriter::lutSetup(lutHeader_t& lutHeader, int& q, int pdg, float field)
 {
-
-  if (useFlatDipole && useDipole) {
-    Printf("Both dipole and dipole flat flags are on, please use only one of them");
-    return;
-  }
-
-  // output file
-  std::ofstream lutFile(filename, std::ofstream::binary);
-  if (!lutFile.is_open()) {
-    Printf("Did not manage to open output file!!");
-    return;
-  }
-
-  // write header
-  lutHeader_t lutHeader;
   // pid
   lutHeader.pdg = pdg;
   lutHeader.mass = TDatabasePDG::Instance()->GetParticle(pdg)->Mass();
-  const int q = std::abs(TDatabasePDG::Instance()->GetParticle(pdg)->Charge()) / 3;
+  q = std::abs(TDatabasePDG::Instance()->GetParticle(pdg)->Charge()) / 3;
   if (q <= 0) {
     Printf("Negative or null charge (%f) for pdg code %i. Fix the charge!", TDatabasePDG::Instance()->GetParticle(pdg)->Charge(), pdg);
-    return;
+    return false;
   }
   lutHeader.field = field;
   // nch
@@ -226,6 +228,77 @@ void DelphesO2LutWriter::lutWrite(const char* filename, int pdg, float field, in
   lutHeader.ptmap.nbins = 200;
   lutHeader.ptmap.min = -2;
   lutHeader.ptmap.max = 2.;
+  return true;
+}
+
+bool DelphesO2LutWriter::solveEntry(lutEntry_t& lutEntry, const lutHeader_t& lutHeader, int itof, int otof, int q, FastTrackContext* context)
+{
+  lutEntry.valid = true;
+  if (std::fabs(lutEntry.eta) <= etaMaxBarrel) { // full lever arm ends at etaMaxBarrel
+    // printf(" --- fatSolve: pt = %f, eta = %f, mass = %f, field=%f \n", lutEntry.pt, lutEntry.eta, lutHeader.mass, lutHeader.field);
+    if (!fatSolve(lutEntry, lutEntry.pt, lutEntry.eta, lutHeader.mass, itof, otof, q, 1, context)) {
+      // printf(" --- fatSolve: error \n");
+      lutEntry.valid = false;
+      lutEntry.eff = 0.;
+      lutEntry.eff2 = 0.;
+      for (int i = 0; i < 15; ++i) {
+        lutEntry.covm[i] = 0.;
+      }
+      return false;
+    }
+    return true;
+  }
+  // printf(" --- fwdSolve: pt = %f, eta = %f, mass = %f, field=%f \n", lutEntry.pt, lutEntry.eta, lutHeader.mass, lutHeader.field);
+  lutEntry.eff = 1.;
+  lutEntry.eff2 = 1.;
+  bool retval = true;
+  if (useFlatDipole) { // Using the parametrization at the border of the barrel
+    retval = fatSolve(lutEntry, lutEntry.pt, etaMaxBarrel, lutHeader.mass, itof, otof, q, 1, context);
+  } else if (usePara) {
+    retval = fwdPara(lutEntry, lutEntry.pt, lutEntry.eta, lutHeader.mass, lutHeader.field, context);
+  } else {
+    retval = fwdSolve(lutEntry.covm, lutEntry.pt, lutEntry.eta, lutHeader.mass);
+  }
+  if (useDipole) { // Using the parametrization at the border of the barrel only for efficiency and momentum resolution
+    lutEntry_t lutEntryBarrel;
+    retval = fatSolve(lutEntryBarrel, lutEntry.pt, etaMaxBarrel, lutHeader.mass, itof, otof, q, 1, context);
+    lutEntry.valid = lutEntryBarrel.valid;
+    lutEntry.covm[14] = lutEntryBarrel.covm[14];
+    lutEntry.eff = lutEntryBarrel.eff;
+    lutEntry.eff2 = lutEntryBarrel.eff2;
+  }
+  if (!retval) {
+    printf(" --- fwdSolve: error \n");
+    lutEntry.valid = false;
+    for (int i = 0; i < 15; ++i) {
+      lutEntry.covm[i] = 0.;
+    }
+    return false;
+  }
+  return true;
+}
+
+void DelphesO2LutWriter::lutWrite(const char* filename, int pdg, float field, int itof, int otof)
+{
+
+  if (useFlatDipole && useDipole) {
+    Printf("Both dipole and dipole flat flags are on, please use only one of them");
+    return;
+  }
+
+  // output file
+  std::ofstream lutFile(filename, std::ofstream::binary);
+  if (!lutFile.is_open()) {
+    Printf("Did not manage to open output file!!");
+    return;
+  }
+
+  // write header
+  lutHeader_t lutHeader;
+  int q = 0;
+  if (!lutSetup(lutHeader, q, pdg, field)) {
+    return;
+  }
   lutFile.write(reinterpret_cast<char*>(&lutHeader), sizeof(lutHeader));
 
   // entries
@@ -249,58 +322,15 @@ void DelphesO2LutWriter::lutWrite(const char* filename, int pdg, float field, in
       for (int ieta = 0; ieta < neta; ++ieta) {
         nCalls++;
         Printf(" --- writing ieta = %d/%d", ieta, neta);
-        auto eta = lutHeader.etamap.eval(ieta);
         lutEntry.eta = lutHeader.etamap.eval(ieta);
         for (int ipt = 0; ipt < npt; ++ipt) {
           Printf(" --- writing ipt = %d/%d", ipt, npt);
           lutEntry.pt = lutHeader.ptmap.eval(ipt);
-          lutEntry.valid = true;
-          if (std::fabs(eta) <= etaMaxBarrel) { // full lever arm ends at etaMaxBarrel
-            Printf("Solving in the barrel");
-            // printf(" --- fatSolve: pt = %f, eta = %f, mass = %f, field=%f \n", lutEntry.pt, lutEntry.eta, lutHeader.mass, lutHeader.field);
+          Printf("%s", std::fabs(lutEntry.eta) <= etaMaxBarrel ? "Solving in the barrel" : "Solving outside the barrel");
+          if (solveEntry(lutEntry, lutHeader, itof, otof, q)) {
             successfullCalls++;
-            if (!fatSolve(lutEntry, lutEntry.pt, lutEntry.eta, lutHeader.mass, itof, otof, q)) {
-              // printf(" --- fatSolve: error \n");
-              lutEntry.valid = false;
-              lutEntry.eff = 0.;
-              lutEntry.eff2 = 0.;
-              for (int i = 0; i < 15; ++i) {
-                lutEntry.covm[i] = 0.;
-              }
-              successfullCalls--;
-              failedCalls++;
-            }
           } else {
-            Printf("Solving outside the barrel");
-            // printf(" --- fwdSolve: pt = %f, eta = %f, mass = %f, field=%f \n", lutEntry.pt, lutEntry.eta, lutHeader.mass, lutHeader.field);
-            lutEntry.eff = 1.;
-            lutEntry.eff2 = 1.;
-            bool retval = true;
-            successfullCalls++;
-            if (useFlatDipole) { // Using the parametrization at the border of the barrel
-              retval = fatSolve(lutEntry, lutEntry.pt, etaMaxBarrel, lutHeader.mass, itof, otof, q);
-            } else if (usePara) {
-              retval = fwdPara(lutEntry, lutEntry.pt, lutEntry.eta, lutHeader.mass, field);
-            } else {
-              retval = fwdSolve(lutEntry.covm, lutEntry.pt, lutEntry.eta, lutHeader.mass);
-            }
-            if (useDipole) { // Using the parametrization at the border of the barrel only for efficiency and momentum resolution
-              lutEntry_t lutEntryBarrel;
-              retval = fatSolve(lutEntryBarrel, lutEntry.pt, etaMaxBarrel, lutHeader.mass, itof, otof, q);
-              lutEntry.valid = lutEntryBarrel.valid;
-              lutEntry.covm[14] = lutEntryBarrel.covm[14];
-              lutEntry.eff = lutEntryBarrel.eff;
-              lutEntry.eff2 = lutEntryBarrel.eff2;
-            }
-            if (!retval) {
-              printf(" --- fwdSolve: error \n");
-              lutEntry.valid = false;
-              for (int i = 0; i < 15; ++i) {
-                lutEntry.covm[i] = 0.;
-              }
-              successfullCalls--;
-              failedCalls++;
-            }
+            failedCalls++;
           }
           Printf("Diagonalizing");
           diagonalise(lutEntry);
@@ -315,7 +345,180 @@ void DelphesO2LutWriter::lutWrite(const char* filename, int pdg, float field, in
   lutFile.close();
 }
 
-void DelphesO2LutWriter::diagonalise(lutEntry_t& lutEntry)
+bool DelphesO2LutWriter::lutWriteParallel(const char* filename, int pdg, float field, int itof, int otof, int nThreads, int compressionLevel)
+{
+  if (useFlatDipole && useDipole) {
+    Printf("Both dipole and dipole flat flags are on, please use only one of them");
+    return false;
+  }
+  lutHeader_t lutHeader;
+  int q = 0;
+  if (!lutSetup(lutHeader, q, pdg, field)) {
+    return false;
+  }
+  const int nnch = lutHeader.nchmap.nbins;
+  const int nrad = lutHeader.radmap.nbins;
+  const int neta = lutHeader.etamap.nbins;
+  const int npt = lutHeader.ptmap.nbins;
+  const size_t nEntries = static_cast<size_t>(nnch) * nrad * neta * npt;
+  const size_t flatSize = sizeof(lutHeader_t) + nEntries * sizeof(lutEntry_t);
+
+  // flat layout of TrackSmearer::loadTable, written in place in the output file, or in memory if the file is compressed
+  int lutFile = -1;
+  void* lutMap = MAP_FAILED;
+  if (compressionLevel > 0) {
+    lutMap = mmap(nullptr, flatSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  } else {
+    lutFile = open(filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (lutFile < 0 || ftruncate(lutFile, flatSize) != 0) {
+      Printf("Did not manage to open output file!!");
+      if (lutFile >= 0) {
+        close(lutFile);
+      }
+      return false;
+    }
+    lutMap = mmap(nullptr, flatSize, PROT_READ | PROT_WRITE, MAP_SHARED, lutFile, 0);
+    close(lutFile);
+  }
+  if (lutMap == MAP_FAILED) {
+    Printf("Did not manage to map the LUT of %zu bytes", flatSize);
+    return false;
+  }
+  std::memcpy(lutMap, &lutHeader, sizeof(lutHeader_t));
+  lutEntry_t* lutEntries = reinterpret_cast<lutEntry_t*>(static_cast<char*>(lutMap) + sizeof(lutHeader_t));
+
+  // the (nch, radius, eta) rows of pt points are handed out one by one to the threads, each with its own tracking
+  // context; the random generator of the efficiency check is reseeded per row, so that the LUT does not depend
+  // on the number of threads
+  const int nRows = nnch * nrad * neta;
+  std::atomic<int> nextRow{0};
+  std::vector<int> successfullCalls(std::max(nThreads, 1), 0);
+  std::vector<int> failedCalls(std::max(nThreads, 1), 0);
+  auto worker = [&](int iThread) {
+    TRandom3 random;
+    FastTrackContext context;
+    context.random = &random;
+    lutEntry_t lutEntry;
+    for (int row = nextRow++; row < nRows; row = nextRow++) {
+      const int inch = row / (nrad * neta);
+      const int ieta = row % neta;
+      random.SetSeed(row + 1);
+      lutEntry = lutEntry_t{};
+      lutEntry.nch = lutHeader.nchmap.eval(inch);
+      lutEntry.eta = lutHeader.etamap.eval(ieta);
+      for (int ipt = 0; ipt < npt; ++ipt) {
+        lutEntry.pt = lutHeader.ptmap.eval(ipt);
+        if (solveEntry(lutEntry, lutHeader, itof, otof, q, &context)) {
+          successfullCalls[iThread]++;
+        } else {
+          failedCalls[iThread]++;
+        }
+        diagonalise(lutEntry, false);
+        lutEntries[static_cast<size_t>(row) * npt + ipt] = lutEntry;
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  for (int iThread = 1; iThread < nThreads; ++iThread) {
+    threads.emplace_back(worker, iThread);
+  }
+  worker(0);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  int nSuccessfull = 0, nFailed = 0;
+  for (size_t iThread = 0; iThread < successfullCalls.size(); ++iThread) {
+    nSuccessfull += successfullCalls[iThread];
+    nFailed += failedCalls[iThread];
+  }
+  Printf(" --- successfull calls: %d/%zu, failed calls: %d/%zu", nSuccessfull, nEntries, nFailed, nEntries);
+
+  bool written = true;
+  if (compressionLevel > 0) {
+    written = lutCompress(filename, lutHeader, lutEntries, nThreads, compressionLevel);
+  } else {
+    written = msync(lutMap, flatSize, MS_SYNC) == 0;
+  }
+  munmap(lutMap, flatSize);
+  if (!written) {
+    Printf("Did not manage to write output file %s", filename);
+    return false;
+  }
+  Printf(" --- finished writing LUT file %s", filename);
+  return true;
+}
+
+bool DelphesO2LutWriter::lutCompress(const char* filename, const lutHeader_t& lutHeader, const lutEntry_t* lutEntries, int nThreads, int compressionLevel)
+{
+  const int nRowsPerSlice = lutHeader.nchmap.nbins * lutHeader.radmap.nbins;
+  const int neta = lutHeader.etamap.nbins;
+  const int npt = lutHeader.ptmap.nbins;
+  const size_t rowSize = npt * sizeof(lutEntry_t);
+  const size_t sliceSize = nRowsPerSlice * rowSize;
+
+  // the slices are compressed independently, in chunks of at most the maximum buffer size of R__zip;
+  // a slice that does not compress is stored as it is
+  std::vector<std::vector<char>> slices(neta);
+  std::atomic<int> nextSlice{0};
+  auto worker = [&]() {
+    std::vector<char> raw(sliceSize);
+    for (int ieta = nextSlice++; ieta < neta; ieta = nextSlice++) {
+      for (int iRow = 0; iRow < nRowsPerSlice; ++iRow) {
+        std::memcpy(raw.data() + iRow * rowSize, lutEntries + (static_cast<size_t>(iRow) * neta + ieta) * npt, rowSize);
+      }
+      auto& slice = slices[ieta];
+      slice.resize(sliceSize);
+      size_t compressedSize = 0;
+      for (size_t offset = 0; offset < sliceSize;) {
+        int srcSize = std::min<size_t>(sliceSize - offset, kMaxZipChunk);
+        int tgtSize = sliceSize - compressedSize;
+        int irep = 0;
+        R__zip(compressionLevel, &srcSize, raw.data() + offset, &tgtSize, slice.data() + compressedSize, &irep);
+        if (irep <= 0) {
+          compressedSize = sliceSize;
+          break;
+        }
+        offset += srcSize;
+        compressedSize += irep;
+      }
+      if (compressedSize >= sliceSize) {
+        slice = raw;
+      } else {
+        slice.resize(compressedSize);
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  for (int iThread = 1; iThread < nThreads; ++iThread) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  std::ofstream lutFile(filename, std::ofstream::binary);
+  if (!lutFile.is_open()) {
+    return false;
+  }
+  lutHeader_t compressedHeader = lutHeader;
+  compressedHeader.version = LUTCOVM_VERSION_COMPRESSED;
+  lutFile.write(reinterpret_cast<char*>(&compressedHeader), sizeof(lutHeader_t));
+  std::vector<lutSlice_t> index(neta);
+  uint64_t offset = sizeof(lutHeader_t) + neta * sizeof(lutSlice_t);
+  for (int ieta = 0; ieta < neta; ++ieta) {
+    index[ieta] = {offset, slices[ieta].size(), sliceSize};
+    offset += slices[ieta].size();
+  }
+  lutFile.write(reinterpret_cast<char*>(index.data()), neta * sizeof(lutSlice_t));
+  for (const auto& slice : slices) {
+    lutFile.write(slice.data(), slice.size());
+  }
+  Printf(" --- compressed LUT: %llu bytes instead of %zu", static_cast<unsigned long long>(offset), sizeof(lutHeader_t) + neta * sliceSize);
+  return lutFile.good();
+}
+
+void DelphesO2LutWriter::diagonalise(lutEntry_t& lutEntry, bool verbose)
 {
   TMatrixDSym m(5);
   for (int i = 0, k = 0; i < 5; ++i) {
@@ -325,7 +528,9 @@ void DelphesO2LutWriter::diagonalise(lutEntry_t& lutEntry)
     }
   }
 
-  m.Print();
+  if (verbose) {
+    m.Print();
+  }
   TMatrixDSymEigen eigen(m);
   // eigenvalues vector
   TVectorD eigenVal = eigen.GetEigenValues();
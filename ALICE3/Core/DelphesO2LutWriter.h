@@ -35,7 +35,7 @@ class DelphesO2LutWriter
   virtual ~DelphesO2LutWriter() = default;
 
   o2::fastsim::FastTracker fat;
-  void diagonalise(lutEntry_t& lutEntry);
+  void diagonalise(lutEntry_t& lutEntry, bool verbose = true);
   float etaMaxBarrel = 1.75f;
   bool usePara = true;        // use fwd parameterisation
   bool useDipole = false;     // use dipole i.e. flat parametrization for efficiency and momentum resolution
@@ -56,12 +56,26 @@ class DelphesO2LutWriter
                 int itof = 0,
                 int otof = 0,
                 int q = 1,
-                const float nch = 1);
+                const float nch = 1,
+                FastTrackContext* context = nullptr);
   bool fwdSolve(float* covm, float pt = 0.1, float eta = 0.0, float mass = 0.13957000);
-  bool fwdPara(lutEntry_t& lutEntry, float pt = 0.1, float eta = 0.0, float mass = 0.13957000, float Bfield = 0.5);
+  bool fwdPara(lutEntry_t& lutEntry, float pt = 0.1, float eta = 0.0, float mass = 0.13957000, float Bfield = 0.5, FastTrackContext* context = nullptr);
   void lutWrite(const char* filename = "lutCovm.dat", int pdg = 211, float field = 0.2, int itof = 0, int otof = 0);
+  /// Same LUT as lutWrite, with the grid points distributed over nThreads threads writing the entries in place in the
+  /// memory-mapped output file; with compressionLevel > 0 (ROOT compression settings) the file is instead written
+  /// compressed per eta slice, which TrackSmearer::loadTable inflates at loading
+  bool lutWriteParallel(const char* filename = "lutCovm.dat", int pdg = 211, float field = 0.2, int itof = 0, int otof = 0, int nThreads = 4, int compressionLevel = 0);
   TGraph* lutRead(const char* filename, int pdg, int what, int vs, float nch = 0., float radius = 0., float eta = 0., float pt = 0.);
 
+ private:
+  static constexpr int kMaxZipChunk = 0xffffff; // maximum size of a buffer compressed by R__zip
+
+  /// Header of the LUT and charge of the particle; false if the particle is not charged
+  bool lutSetup(lutHeader_t& lutHeader, int& q, int pdg, float field);
+  /// Resolution and efficiency of the entry at (nch, eta, pt) of lutEntry; false if the solving failed
+  bool solveEntry(lutEntry_t& lutEntry, const lutHeader_t& lutHeader, int itof, int otof, int q, FastTrackContext* context = nullptr);
+  bool lutCompress(const char* filename, const lutHeader_t& lutHeader, const lutEntry_t* lutEntries, int nThreads, int compressionLevel);
+
   ClassDef(DelphesO2LutWriter, 1);
 };
 } // namespace o2::fastsim
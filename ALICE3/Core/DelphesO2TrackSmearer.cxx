@@ -36,11 +36,83 @@
 
 #include "ALICE3/Core/DelphesO2TrackSmearer.h"
 
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "RZip.h"
+
 namespace o2
 {
 namespace delphes
 {
 
+namespace
+{
+/// inflates a LUT compressed per eta slice (see DelphesO2LutWriter::lutWriteParallel) into the flat layout of the
+/// uncompressed files; empty if the file is corrupted
+std::shared_ptr<void> inflateTable(char* file, size_t fileSize, size_t& flatSize)
+{
+  lutHeader_t header;
+  std::memcpy(&header, file, sizeof(lutHeader_t));
+  const size_t nRowsPerSlice = static_cast<size_t>(header.nchmap.nbins) * header.radmap.nbins;
+  const size_t neta = header.etamap.nbins;
+  const size_t rowSize = header.ptmap.nbins * sizeof(lutEntry_t);
+  const size_t sliceSize = nRowsPerSlice * rowSize;
+  if (fileSize < sizeof(lutHeader_t) + neta * sizeof(lutSlice_t)) {
+    return {};
+  }
+  flatSize = sizeof(lutHeader_t) + neta * sliceSize;
+  std::shared_ptr<void> storage(std::malloc(flatSize), std::free);
+  if (!storage) {
+    return {};
+  }
+  char* flat = static_cast<char*>(storage.get());
+  header.version = LUTCOVM_VERSION;
+  std::memcpy(flat, &header, sizeof(lutHeader_t));
+
+  const auto* index = reinterpret_cast<const lutSlice_t*>(file + sizeof(lutHeader_t));
+  std::vector<char> slice(sliceSize);
+  for (size_t ieta = 0; ieta < neta; ++ieta) {
+    const lutSlice_t& sliceInfo = index[ieta];
+    if (sliceInfo.size != sliceSize || sliceInfo.offset + sliceInfo.compressedSize > fileSize) {
+      return {};
+    }
+    auto* source = reinterpret_cast<unsigned char*>(file + sliceInfo.offset);
+    if (sliceInfo.compressedSize == sliceInfo.size) {
+      std::memcpy(slice.data(), source, sliceSize);
+    } else {
+      // sequence of R__zip buffers, each with its own header
+      size_t in = 0, out = 0;
+      while (in < sliceInfo.compressedSize) {
+        int sourceSize = 0, targetSize = 0, irep = 0;
+        if (R__unzip_header(&sourceSize, source + in, &targetSize) != 0 || in + sourceSize > sliceInfo.compressedSize || out + targetSize > sliceSize) {
+          return {};
+        }
+        R__unzip(&sourceSize, source + in, &targetSize, reinterpret_cast<unsigned char*>(slice.data() + out), &irep);
+        if (irep != targetSize) {
+          return {};
+        }
+        in += sourceSize;
+        out += targetSize;
+      }
+      if (out != sliceSize) {
+        return {};
+      }
+    }
+    for (size_t iRow = 0; iRow < nRowsPerSlice; ++iRow) {
+      std::memcpy(flat + sizeof(lutHeader_t) + (iRow * neta + ieta) * rowSize, slice.data() + iRow * rowSize, rowSize);
+    }
+  }
+  return storage;
+}
+} // namespace
+
 /*****************************************************************/
 
 bool TrackSmearer::loadTable(int pdg, const char* filename, bool forceReload)
@@ -50,60 +122,65 @@ bool TrackSmearer::loadTable(int pdg, const char* filename, bool forceReload)
     std::cout << " --- LUT table for PDG " << pdg << " has been already loaded with index " << ipdg << std::endl;
     return false;
   }
-  mLUTHeader[ipdg] = new lutHeader_t;
+  mLUTHeader[ipdg] = nullptr;
+  mLUTEntry[ipdg] = nullptr;
+  mLUTStorage[ipdg].reset();
 
-  std::ifstream lutFile(filename, std::ifstream::binary);
-  if (!lutFile.is_open()) {
+  // the LUT file is the header followed by all the entries, which are memory-mapped instead of read:
+  // the pages are shared between the processes of a node and only the entries in use are loaded
+  // (N.B.: a LUT file must hence not be rewritten in place while it is in use)
+  int lutFile = open(filename, O_RDONLY);
+  if (lutFile < 0) {
     std::cout << " --- cannot open covariance matrix file for PDG " << pdg << ": " << filename << std::endl;
-    delete mLUTHeader[ipdg];
-    mLUTHeader[ipdg] = nullptr;
     return false;
   }
-  lutFile.read(reinterpret_cast<char*>(mLUTHeader[ipdg]), sizeof(lutHeader_t));
-  if (lutFile.gcount() != sizeof(lutHeader_t)) {
+  struct stat lutFileStat;
+  size_t fileSize = fstat(lutFile, &lutFileStat) == 0 ? lutFileStat.st_size : 0;
+  if (fileSize < sizeof(lutHeader_t)) {
     std::cout << " --- troubles reading covariance matrix header for PDG " << pdg << ": " << filename << std::endl;
-    delete mLUTHeader[ipdg];
-    mLUTHeader[ipdg] = nullptr;
+    close(lutFile);
     return false;
   }
-  if (mLUTHeader[ipdg]->version != LUTCOVM_VERSION) {
-    std::cout << " --- LUT header version mismatch: expected/detected = " << LUTCOVM_VERSION << "/" << mLUTHeader[ipdg]->version << std::endl;
-    delete mLUTHeader[ipdg];
-    mLUTHeader[ipdg] = nullptr;
+  // copy-on-write mapping: the entries returned by getLUTEntry stay writable without touching the file
+  void* lutMap = mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, lutFile, 0);
+  close(lutFile);
+  if (lutMap == MAP_FAILED) {
+    std::cout << " --- cannot map covariance matrix file for PDG " << pdg << ": " << filename << std::endl;
     return false;
   }
-  if (mLUTHeader[ipdg]->pdg != pdg) {
-    std::cout << " --- LUT header PDG mismatch: expected/detected = " << pdg << "/" << mLUTHeader[ipdg]->pdg << std::endl;
-    delete mLUTHeader[ipdg];
-    mLUTHeader[ipdg] = nullptr;
+  std::shared_ptr<void> lutStorage(lutMap, [fileSize](void* map) { munmap(map, fileSize); });
+
+  auto lutHeader = reinterpret_cast<lutHeader_t*>(lutMap);
+  if (lutHeader->version == LUTCOVM_VERSION_COMPRESSED) {
+    // compressed LUT: inflated into a private copy, the mapping of the file is released
+    size_t flatSize = 0;
+    lutStorage = inflateTable(static_cast<char*>(lutMap), fileSize, flatSize);
+    if (!lutStorage) {
+      std::cout << " --- troubles inflating compressed covariance matrix file for PDG " << pdg << ": " << filename << std::endl;
+      return false;
+    }
+    lutMap = lutStorage.get();
+    fileSize = flatSize;
+    lutHeader = reinterpret_cast<lutHeader_t*>(lutMap);
+  }
+  if (lutHeader->version != LUTCOVM_VERSION) {
+    std::cout << " --- LUT header version mismatch: expected/detected = " << LUTCOVM_VERSION << "/" << lutHeader->version << std::endl;
     return false;
   }
-  const int nnch = mLUTHeader[ipdg]->nchmap.nbins;
-  const int nrad = mLUTHeader[ipdg]->radmap.nbins;
-  const int neta = mLUTHeader[ipdg]->etamap.nbins;
-  const int npt = mLUTHeader[ipdg]->ptmap.nbins;
-  mLUTEntry[ipdg] = new lutEntry_t****[nnch];
-  for (int inch = 0; inch < nnch; ++inch) {
-    mLUTEntry[ipdg][inch] = new lutEntry_t***[nrad];
-    for (int irad = 0; irad < nrad; ++irad) {
-      mLUTEntry[ipdg][inch][irad] = new lutEntry_t**[neta];
-      for (int ieta = 0; ieta < neta; ++ieta) {
-        mLUTEntry[ipdg][inch][irad][ieta] = new lutEntry_t*[npt];
-        for (int ipt = 0; ipt < npt; ++ipt) {
-          mLUTEntry[ipdg][inch][irad][ieta][ipt] = new lutEntry_t;
-          lutFile.read(reinterpret_cast<char*>(mLUTEntry[ipdg][inch][irad][ieta][ipt]), sizeof(lutEntry_t));
-          if (lutFile.gcount() != sizeof(lutEntry_t)) {
-            std::cout << " --- troubles reading covariance matrix entry for PDG " << pdg << ": " << filename << std::endl;
-            return false;
-          }
-        }
-      }
-    }
+  if (lutHeader->pdg != pdg) {
+    std::cout << " --- LUT header PDG mismatch: expected/detected = " << pdg << "/" << lutHeader->pdg << std::endl;
+    return false;
   }
+  const size_t nEntries = static_cast<size_t>(lutHeader->nchmap.nbins) * lutHeader->radmap.nbins * lutHeader->etamap.nbins * lutHeader->ptmap.nbins;
+  if (fileSize < sizeof(lutHeader_t) + nEntries * sizeof(lutEntry_t)) {
+    std::cout << " --- troubles reading covariance matrix entry for PDG " << pdg << ": " << filename << std::endl;
+    return false;
+  }
+  mLUTStorage[ipdg] = lutStorage;
+  mLUTHeader[ipdg] = lutHeader;
+  mLUTEntry[ipdg] = reinterpret_cast<lutEntry_t*>(static_cast<char*>(lutMap) + sizeof(lutHeader_t));
   std::cout << " --- read covariance matrix table for PDG " << pdg << ": " << filename << std::endl;
   mLUTHeader[ipdg]->print();
-
-  lutFile.close();
   return true;
 }
 
@@ -126,48 +203,51 @@ lutEntry_t*
     if (fraction > 0.5) {
       if (mWhatEfficiency == 1) {
         if (inch < mLUTHeader[ipdg]->nchmap.nbins - 1) {
-          interpolatedEff = (1.5f - fraction) * mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff + (-0.5f + fraction) * mLUTEntry[ipdg][inch + 1][irad][ieta][ipt]->eff;
+          interpolatedEff = (1.5f - fraction) * getEntry(ipdg, inch, irad, ieta, ipt)->eff + (-0.5f + fraction) * getEntry(ipdg, inch + 1, irad, ieta, ipt)->eff;
         } else {
-          interpolatedEff = mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff;
+          interpolatedEff = getEntry(ipdg, inch, irad, ieta, ipt)->eff;
         }
       }
       if (mWhatEfficiency == 2) {
         if (inch < mLUTHeader[ipdg]->nchmap.nbins - 1) {
-          interpolatedEff = (1.5f - fraction) * mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff2 + (-0.5f + fraction) * mLUTEntry[ipdg][inch + 1][irad][ieta][ipt]->eff2;
+          interpolatedEff = (1.5f - fraction) * getEntry(ipdg, inch, irad, ieta, ipt)->eff2 + (-0.5f + fraction) * getEntry(ipdg, inch + 1, irad, ieta, ipt)->eff2;
         } else {
-          interpolatedEff = mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff2;
+          interpolatedEff = getEntry(ipdg, inch, irad, ieta, ipt)->eff2;
         }
       }
     } else {
       float comparisonValue = mLUTHeader[ipdg]->nchmap.log ? log10(nch) : nch;
       if (mWhatEfficiency == 1) {
         if (inch > 0 && comparisonValue < mLUTHeader[ipdg]->nchmap.max) {
-          interpolatedEff = (0.5f + fraction) * mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff + (0.5f - fraction) * mLUTEntry[ipdg][inch - 1][irad][ieta][ipt]->eff;
+          interpolatedEff = (0.5f + fraction) * getEntry(ipdg, inch, irad, ieta, ipt)->eff + (0.5f - fraction) * getEntry(ipdg, inch - 1, irad, ieta, ipt)->eff;
         } else {
-          interpolatedEff = mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff;
+          interpolatedEff = getEntry(ipdg, inch, irad, ieta, ipt)->eff;
         }
       }
       if (mWhatEfficiency == 2) {
         if (inch > 0 && comparisonValue < mLUTHeader[ipdg]->nchmap.max) {
-          interpolatedEff = (0.5f + fraction) * mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff2 + (0.5f - fraction) * mLUTEntry[ipdg][inch - 1][irad][ieta][ipt]->eff2;
+          interpolatedEff = (0.5f + fraction) * getEntry(ipdg, inch, irad, ieta, ipt)->eff2 + (0.5f - fraction) * getEntry(ipdg, inch - 1, irad, ieta, ipt)->eff2;
         } else {
-          interpolatedEff = mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff2;
+          interpolatedEff = getEntry(ipdg, inch, irad, ieta, ipt)->eff2;
         }
       }
     }
   } else {
     if (mWhatEfficiency == 1)
-      interpolatedEff = mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff;
+      interpolatedEff = getEntry(ipdg, inch, irad, ieta, ipt)->eff;
     if (mWhatEfficiency == 2)
-      interpolatedEff = mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff2;
+      interpolatedEff = getEntry(ipdg, inch, irad, ieta, ipt)->eff2;
   }
-  return mLUTEntry[ipdg][inch][irad][ieta][ipt];
+  return getEntry(ipdg, inch, irad, ieta, ipt);
 } //;
 
 /*****************************************************************/
 
-bool TrackSmearer::smearTrack(O2Track& o2track, lutEntry_t* lutEntry, float interpolatedEff)
+bool TrackSmearer::smearTrack(O2Track& o2track, lutEntry_t* lutEntry, float interpolatedEff, TRandom* random)
 {
+  if (!random) {
+    random = gRandom;
+  }
   bool isReconstructed = true;
   // generate efficiency
   if (mUseEfficiency) {
@@ -178,7 +258,7 @@ bool TrackSmearer::smearTrack(O2Track& o2track, lutEntry_t* lutEntry, float inte
       eff = lutEntry->eff2;
     if (mInterpolateEfficiency)
       eff = interpolatedEff;
-    if (gRandom->Uniform() > eff)
+    if (random->Uniform() > eff)
       isReconstructed = false;
   }
 
@@ -192,7 +272,7 @@ bool TrackSmearer::smearTrack(O2Track& o2track, lutEntry_t* lutEntry, float inte
     double val = 0.;
     for (int j = 0; j < 5; ++j)
       val += lutEntry->eigvec[j][i] * o2track.getParam(j);
-    params_[i] = gRandom->Gaus(val, sqrt(lutEntry->eigval[i]));
+    params_[i] = random->Gaus(val, sqrt(lutEntry->eigval[i]));
   }
   // transform back params vector
   for (int i = 0; i < 5; ++i) {
@@ -213,7 +293,7 @@ bool TrackSmearer::smearTrack(O2Track& o2track, lutEntry_t* lutEntry, float inte
 
 /*****************************************************************/
 
-bool TrackSmearer::smearTrack(O2Track& o2track, int pdg, float nch)
+bool TrackSmearer::smearTrack(O2Track& o2track, int pdg, float nch, TRandom* random)
 {
 
   auto pt = o2track.getPt();
@@ -225,7 +305,7 @@ bool TrackSmearer::smearTrack(O2Track& o2track, int pdg, float nch)
   auto lutEntry = getLUTEntry(pdg, nch, 0., eta, pt, interpolatedEff);
   if (!lutEntry || !lutEntry->valid)
     return false;
-  return smearTrack(o2track, lutEntry, interpolatedEff);
+  return smearTrack(o2track, lutEntry, interpolatedEff, random);
 }
 
 /*****************************************************************/
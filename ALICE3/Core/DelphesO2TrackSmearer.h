@@ -24,7 +24,9 @@
 #ifndef ALICE3_CORE_DELPHESO2TRACKSMEARER_H_
 #define ALICE3_CORE_DELPHESO2TRACKSMEARER_H_
 
+#include <cstdint>
 #include <map>
+#include <memory>
 #include <iostream>
 #include <fstream>
 
@@ -40,6 +42,7 @@
 
 // #pragma // once
 #define LUTCOVM_VERSION 20210801
+#define LUTCOVM_VERSION_COMPRESSED 20251015 // header followed by the index of the eta slices and the compressed slices
 
 struct map_t {
   int nbins = 1;
@@ -118,6 +121,13 @@ struct lutHeader_t {
   } //;
 };
 
+/// eta slice of a compressed LUT: the entries of one eta bin in (nch, radius, pt) order, compressed with R__zip
+struct lutSlice_t {
+  uint64_t offset = 0;         // position in the file
+  uint64_t compressedSize = 0; // equal to size for a slice stored uncompressed
+  uint64_t size = 0;
+};
+
 struct lutEntry_t {
   float nch = 0.;
   float eta = 0.;
@@ -184,8 +194,9 @@ class TrackSmearer
   lutHeader_t* getLUTHeader(int pdg) { return mLUTHeader[getIndexPDG(pdg)]; } //;
   lutEntry_t* getLUTEntry(int pdg, float nch, float radius, float eta, float pt, float& interpolatedEff);
 
-  bool smearTrack(O2Track& o2track, lutEntry_t* lutEntry, float interpolatedEff);
-  bool smearTrack(O2Track& o2track, int pdg, float nch);
+  /// smear a track, drawing from random if given (e.g. one stream per particle for concurrent smearing) and from gRandom otherwise
+  bool smearTrack(O2Track& o2track, lutEntry_t* lutEntry, float interpolatedEff, TRandom* random = nullptr);
+  bool smearTrack(O2Track& o2track, int pdg, float nch, TRandom* random = nullptr);
   // bool smearTrack(Track& track, bool atDCA = true); // Only in DelphesO2
   double getPtRes(int pdg, float nch, float eta, float pt);
   double getEtaRes(int pdg, float nch, float eta, float pt);
@@ -220,9 +231,17 @@ class TrackSmearer
   void setdNdEta(float val) { mdNdEta = val; } //;
 
  protected:
+  /// entry of the flat LUT, stored in (nch, radius, eta, pt) order as in the LUT file
+  lutEntry_t* getEntry(int ipdg, int inch, int irad, int ieta, int ipt)
+  {
+    const lutHeader_t* header = mLUTHeader[ipdg];
+    return mLUTEntry[ipdg] + ((static_cast<size_t>(inch) * header->radmap.nbins + irad) * header->etamap.nbins + ieta) * header->ptmap.nbins + ipt;
+  }
+
   static constexpr unsigned int nLUTs = 8; // Number of LUT available
   lutHeader_t* mLUTHeader[nLUTs] = {nullptr};
-  lutEntry_t***** mLUTEntry[nLUTs] = {nullptr};
+  lutEntry_t* mLUTEntry[nLUTs] = {nullptr};
+  std::shared_ptr<void> mLUTStorage[nLUTs]; // memory-mapped LUT files (header and entries), unmapped with the last copy of the smearer
   bool mUseEfficiency = true;
   bool mInterpolateEfficiency = false;
   bool mSkipUnreconstructed = true; // don't smear tracks that are not reco'ed
@@ -47,6 +47,7 @@ void FastTracker::AddLayer(TString name, float r, float z, float x0, float xrho,
   }
   // Add the new layer to the layers vector
   layers.push_back(newLayer);
+  UpdateHitDensities();
 }
 
 DetLayer FastTracker::GetLayer(int layer, bool ignoreBarrelLayers) const
@@ -189,7 +190,7 @@ void FastTracker::AddTPC(float phiResMean, float zResMean)
   }
 }
 
-float FastTracker::Dist(float z, float r)
+float FastTracker::Dist(float z, float r) const
 {
   // porting of DetektorK::Dist
   // see here:
@@ -212,7 +213,7 @@ float FastTracker::Dist(float z, float r)
   return dist;
 }
 
-float FastTracker::OneEventHitDensity(float multiplicity, float radius)
+float FastTracker::OneEventHitDensity(float multiplicity, float radius) const
 {
   // porting of DetektorK::OneEventHitDensity
   // see here:
@@ -223,7 +224,7 @@ float FastTracker::OneEventHitDensity(float multiplicity, float radius)
   return den;
 }
 
-float FastTracker::IntegratedHitDensity(float multiplicity, float radius)
+float FastTracker::IntegratedHitDensity(float multiplicity, float radius) const
 {
   // porting of DetektorK::IntegratedHitDensity
   // see here:
@@ -235,7 +236,7 @@ float FastTracker::IntegratedHitDensity(float multiplicity, float radius)
   return den;
 }
 
-float FastTracker::UpcHitDensity(float radius)
+float FastTracker::UpcHitDensity(float radius) const
 {
   // porting of DetektorK::UpcHitDensity
   // see here:
@@ -249,14 +250,14 @@ float FastTracker::UpcHitDensity(float radius)
   return mUPCelectrons;
 }
 
-float FastTracker::HitDensity(float radius)
+float FastTracker::HitDensity(float radius, int dNdEta) const
 {
   // porting of DetektorK::HitDensity
   // see here:
   // https://github.com/AliceO2Group/DelphesO2/blob/master/src/DetectorK/DetectorK.cxx#L663
   float arealDensity = 0.;
   if (radius > maxRadiusSlowDet) {
-    arealDensity = OneEventHitDensity(dNdEtaCent, radius);
+    arealDensity = OneEventHitDensity(dNdEta, radius);
     arealDensity += otherBackground * OneEventHitDensity(dNdEtaMinB, radius);
   }
 
@@ -264,29 +265,56 @@ float FastTracker::HitDensity(float radius)
   // Look-up tables, UpcHitDensity(radius) always returns 0,
   // hence it is left commented out for now
   if (radius < maxRadiusSlowDet) {
-    arealDensity = OneEventHitDensity(dNdEtaCent, radius);
+    arealDensity = OneEventHitDensity(dNdEta, radius);
     arealDensity += otherBackground * OneEventHitDensity(dNdEtaMinB, radius) + IntegratedHitDensity(dNdEtaMinB, radius);
     // +UpcHitDensity(radius);
   }
   return arealDensity;
 }
 
-float FastTracker::ProbGoodChiSqHit(float radius, float searchRadiusRPhi, float searchRadiusZ)
+void FastTracker::UpdateHitDensities()
+{
+  // HitDensity is linear in dN/deta: the one-event density of the collision
+  // under study plus a background that depends only on the configuration
+  mLayerHitDensityBackground.resize(layers.size());
+  mLayerHitDensityPerUnitMult.resize(layers.size());
+  for (size_t il = 0; il < layers.size(); il++) {
+    const float radius = layers[il].getRadius() * 100; // as in the good hit probability calculation of FastTrack
+    mLayerHitDensityBackground[il] = HitDensity(radius, 0);
+    mLayerHitDensityPerUnitMult[il] = radius != maxRadiusSlowDet ? OneEventHitDensity(1.f, radius) : 0.f;
+  }
+}
+
+float FastTracker::LayerHitDensity(const int layer, int dNdEta) const
+{
+  if (static_cast<size_t>(layer) >= mLayerHitDensityBackground.size()) { // not available, e.g. after reading from file
+    return HitDensity(layers[layer].getRadius() * 100, dNdEta);
+  }
+  return mLayerHitDensityBackground[layer] + dNdEta * mLayerHitDensityPerUnitMult[layer];
+}
+
+float FastTracker::ProbGoodChiSqHit(float radius, float searchRadiusRPhi, float searchRadiusZ, int dNdEta) const
 {
   // porting of DetektorK::ProbGoodChiSqHit
   // see here:
   // https://github.com/AliceO2Group/DelphesO2/blob/master/src/DetectorK/DetectorK.cxx#L629
   float sx, goodHit;
-  sx = o2::constants::math::TwoPI * searchRadiusRPhi * searchRadiusZ * HitDensity(radius);
+  sx = o2::constants::math::TwoPI * searchRadiusRPhi * searchRadiusZ * HitDensity(radius, dNdEta);
   goodHit = 1. / (1 + sx);
   return goodHit;
 }
 
 // function to provide a reconstructed track from a perfect input track
 // returns number of intercepts (generic for now)
-int FastTracker::FastTrack(o2::track::TrackParCov inputTrack, o2::track::TrackParCov& outputTrack, const float nch)
+int FastTracker::FastTrack(o2::track::TrackParCov inputTrack, o2::track::TrackParCov& outputTrack, const float nch, FastTrackContext& context) const
 {
-  dNdEtaCent = nch; // set the number of charged particles per unit rapidity
+  const int dNdEta = nch; // number of charged particles per unit rapidity, integer as in SetdNdEtaCent
+  TRandom* random = context.random ? context.random : gRandom;
+  auto& hits = context.hits;
+  auto& goodHitProbability = context.goodHitProbability;
+  auto& nIntercepts = context.nIntercepts;
+  auto& nSiliconPoints = context.nSiliconPoints;
+  auto& nGasPoints = context.nGasPoints;
   hits.clear();
   nIntercepts = 0;
   nSiliconPoints = 0;
@@ -314,10 +342,7 @@ int FastTracker::FastTrack(o2::track::TrackParCov inputTrack, o2::track::TrackPa
   const int xrhosteps = 100;
   const bool applyAngularCorrection = true;
 
-  goodHitProbability.clear();
-  for (int i = 0; i < kMaxNumberOfDetectors; ++i) {
-    goodHitProbability.push_back(-1.);
-  }
+  goodHitProbability.assign(kMaxNumberOfDetectors, -1.);
   goodHitProbability[0] = 1.; // we use layer zero to accumulate
 
   // +-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+
@@ -473,7 +498,7 @@ int FastTracker::FastTrack(o2::track::TrackParCov inputTrack, o2::track::TrackPa
     if (!layers[il].isInert()) { // good hit probability calculation
       float sigYCmb = o2::math_utils::sqrt(inwardTrack.getSigmaY2() + layers[il].getResolutionRPhi() * layers[il].getResolutionRPhi());
       float sigZCmb = o2::math_utils::sqrt(inwardTrack.getSigmaZ2() + layers[il].getResolutionZ() * layers[il].getResolutionZ());
-      goodHitProbability[il] = ProbGoodChiSqHit(layers[il].getRadius() * 100, sigYCmb * 100, sigZCmb * 100);
+      goodHitProbability[il] = 1. / (1 + o2::constants::math::TwoPI * (sigYCmb * 100) * (sigZCmb * 100) * LayerHitDensity(il, dNdEta)); // ProbGoodChiSqHit with the tabulated hit density
       goodHitProbability[0] *= goodHitProbability[il];
     }
   }
@@ -504,7 +529,7 @@ int FastTracker::FastTrack(o2::track::TrackParCov inputTrack, o2::track::TrackPa
     eff *= iGoodHit;
   }
   if (mApplyEffCorrection) {
-    if (gRandom->Uniform() > eff)
+    if (random->Uniform() > eff)
       return -8;
   }
 
@@ -560,11 +585,11 @@ int FastTracker::FastTrack(o2::track::TrackParCov inputTrack, o2::track::TrackPa
       LOG(info) << "Cov matrix: ";
       m.Print();
     }
-    covMatNotOK++;
+    context.covMatNotOK++;
     nIntercepts = -1; // mark as problematic so that it isn't used
     return -1;
   }
-  covMatOK++;
+  context.covMatOK++;
 
   // transform parameter vector and smear
   float params_[5];
@@ -573,7 +598,7 @@ int FastTracker::FastTrack(o2::track::TrackParCov inputTrack, o2::track::TrackPa
     for (int j = 0; j < 5; ++j)
       val += eigVec[j][ii] * outputTrack.getParam(j);
     // smear parameters according to eigenvalues
-    params_[ii] = gRandom->Gaus(val, sqrt(eigVal[ii]));
+    params_[ii] = random->Gaus(val, sqrt(eigVal[ii]));
   }
 
   // invert eigenvector matrix
@@ -21,6 +21,8 @@
 #include <string>
 #include <vector>
 
+class TRandom;
+
 namespace o2
 {
 namespace fastsim
@@ -28,6 +30,21 @@ namespace fastsim
 
 // +-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+
 
+// state of the fast tracking of one track, owned by the caller so that
+// several tracks can be tracked concurrently with the same FastTracker
+struct FastTrackContext {
+  std::vector<std::vector<float>> hits; /// hits added to the track
+  std::vector<float> goodHitProbability;
+  int nIntercepts = 0;       /// found in first outward propagation
+  int nSiliconPoints = 0;    /// silicon-based space points added to track
+  int nGasPoints = 0;        /// tpc-based space points added to track
+  uint64_t covMatOK = 0;     /// tracks whose cov mat has positive eigenvals, accumulated over calls
+  uint64_t covMatNotOK = 0;  /// tracks whose cov mat has negative eigenvals, accumulated over calls
+  TRandom* random = nullptr; /// random generator for efficiency and smearing (nullptr: gRandom)
+};
+
+// +-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+
+
 // this class implements a synthetic smearer that allows
 // for on-demand smearing of TrackParCovs in a certain flexible t
 // detector layout.
@@ -46,7 +63,11 @@ class FastTracker
   size_t GetNLayers() const { return layers.size(); }
   bool IsLayerInert(const int layer) const { return layers[layer].isInert(); }
   void SetRadiationLength(const std::string layerName, float x0) { layers[GetLayerIndex(layerName)].setRadiationLength(x0); }
-  void SetRadius(const std::string layerName, float r) { layers[GetLayerIndex(layerName)].setRadius(r); }
+  void SetRadius(const std::string layerName, float r)
+  {
+    layers[GetLayerIndex(layerName)].setRadius(r);
+    UpdateHitDensities();
+  }
   void SetResolutionRPhi(const std::string layerName, float resRPhi) { layers[GetLayerIndex(layerName)].setResolutionRPhi(resRPhi); }
   void SetResolutionZ(const std::string layerName, float resZ) { layers[GetLayerIndex(layerName)].setResolutionZ(resZ); }
   void SetResolution(const std::string layerName, float resRPhi, float resZ)
@@ -72,20 +93,40 @@ class FastTracker
    * @param nch Charged particle multiplicity (used for hit density calculations).
    * @return int i.e. number of intercepts (implementation-defined).
    */
-  int FastTrack(o2::track::TrackParCov inputTrack, o2::track::TrackParCov& outputTrack, const float nch);
+  int FastTrack(o2::track::TrackParCov inputTrack, o2::track::TrackParCov& outputTrack, const float nch)
+  {
+    dNdEtaCent = nch; // set the number of charged particles per unit rapidity
+    return FastTrack(inputTrack, outputTrack, nch, mLastTrack);
+  }
+  /// Re-entrant version, the state of the track is kept in the context given by the caller
+  int FastTrack(o2::track::TrackParCov inputTrack, o2::track::TrackParCov& outputTrack, const float nch, FastTrackContext& context) const;
 
   // For efficiency calculation
-  float Dist(float z, float radius);
-  float OneEventHitDensity(float multiplicity, float radius);
-  float IntegratedHitDensity(float multiplicity, float radius);
-  float UpcHitDensity(float radius);
-  float HitDensity(float radius);
-  float ProbGoodChiSqHit(float radius, float searchRadiusRPhi, float searchRadiusZ);
+  float Dist(float z, float radius) const;
+  float OneEventHitDensity(float multiplicity, float radius) const;
+  float IntegratedHitDensity(float multiplicity, float radius) const;
+  float UpcHitDensity(float radius) const;
+  float HitDensity(float radius) const { return HitDensity(radius, dNdEtaCent); }
+  float HitDensity(float radius, int dNdEta) const;
+  float ProbGoodChiSqHit(float radius, float searchRadiusRPhi, float searchRadiusZ) const { return ProbGoodChiSqHit(radius, searchRadiusRPhi, searchRadiusZ, dNdEtaCent); }
+  float ProbGoodChiSqHit(float radius, float searchRadiusRPhi, float searchRadiusZ, int dNdEta) const;
 
   // Setters and getters for configuration
-  void SetIntegrationTime(float t) { integrationTime = t; }
-  void SetMaxRadiusOfSlowDetectors(float r) { maxRadiusSlowDet = r; }
-  void SetAvgRapidity(float y) { avgRapidity = y; }
+  void SetIntegrationTime(float t)
+  {
+    integrationTime = t;
+    UpdateHitDensities();
+  }
+  void SetMaxRadiusOfSlowDetectors(float r)
+  {
+    maxRadiusSlowDet = r;
+    UpdateHitDensities();
+  }
+  void SetAvgRapidity(float y)
+  {
+    avgRapidity = y;
+    UpdateHitDensities();
+  }
   void SetdNdEtaCent(int d) { dNdEtaCent = d; }
   void SetLhcUPCscale(float s) { lhcUPCScale = s; }
   void SetBField(float b) { magneticField = b; }
@@ -96,25 +137,33 @@ class FastTracker
   void SetApplyElossCorrection(bool b) { mApplyElossCorrection = b; }
   void SetApplyEffCorrection(bool b) { mApplyEffCorrection = b; }
 
-  // Getters for the last track
-  int GetNIntercepts() const { return nIntercepts; }
-  int GetNSiliconPoints() const { return nSiliconPoints; }
-  int GetNGasPoints() const { return nGasPoints; }
+  // Getters for the last track tracked without an explicit context
+  int GetNIntercepts() const { return mLastTrack.nIntercepts; }
+  int GetNSiliconPoints() const { return mLastTrack.nSiliconPoints; }
+  int GetNGasPoints() const { return mLastTrack.nGasPoints; }
   float GetGoodHitProb(int layer) const
   {
-    return (layer >= 0 && static_cast<size_t>(layer) < goodHitProbability.size()) ? goodHitProbability[layer] : 0.0f;
+    return (layer >= 0 && static_cast<size_t>(layer) < mLastTrack.goodHitProbability.size()) ? mLastTrack.goodHitProbability[layer] : 0.0f;
   }
-  std::size_t GetNHits() const { return hits.size(); }
-  float GetHitX(const int i) const { return hits[i][0]; }
-  float GetHitY(const int i) const { return hits[i][1]; }
-  float GetHitZ(const int i) const { return hits[i][2]; }
-  uint64_t GetCovMatOK() const { return covMatOK; }
-  uint64_t GetCovMatNotOK() const { return covMatNotOK; }
+  std::size_t GetNHits() const { return mLastTrack.hits.size(); }
+  float GetHitX(const int i) const { return mLastTrack.hits[i][0]; }
+  float GetHitY(const int i) const { return mLastTrack.hits[i][1]; }
+  float GetHitZ(const int i) const { return mLastTrack.hits[i][2]; }
+  uint64_t GetCovMatOK() const { return mLastTrack.covMatOK; }
+  uint64_t GetCovMatNotOK() const { return mLastTrack.covMatNotOK; }
 
  private:
+  /// Hit density of each layer, evaluated as in FastTrack, for the given multiplicity
+  float LayerHitDensity(const int layer, int dNdEta) const;
+  /// Recompute the per-layer hit densities, to be called whenever the layers or the background change
+  void UpdateHitDensities();
+
   // Definition of detector layers
   std::vector<DetLayer> layers;
-  std::vector<std::vector<float>> hits; // bookkeep last added hits
+
+  /// hit density on each layer as a linear function of dN/deta, dN/deta independent part and slope
+  std::vector<float> mLayerHitDensityBackground;  //!
+  std::vector<float> mLayerHitDensityPerUnitMult; //!
 
   /// configuration parameters
   bool mApplyZacceptance = false;       /// check z acceptance or not
@@ -137,17 +186,10 @@ class FastTracker
   float upcBackgroundMultiplier = 1.0f; /// multiplier for UPC background
   float fMinRadTrack = 132.f;           /// minimum radius for track propagation in cm
 
-  /// counters for covariance matrix statuses
-  uint64_t covMatOK = 0;    /// cov mat has positive eigenvals
-  uint64_t covMatNotOK = 0; /// cov mat has negative eigenvals
-
-  /// last track information
-  int nIntercepts = 0;    /// found in first outward propagation
-  int nSiliconPoints = 0; /// silicon-based space points added to track
-  int nGasPoints = 0;     /// tpc-based space points added to track
-  std::vector<float> goodHitProbability;
+  /// last track information and covariance matrix status counters of the non re-entrant interface
+  FastTrackContext mLastTrack; //!
 
-  ClassDef(FastTracker, 1);
+  ClassDef(FastTracker, 2);
 };
 
 // +-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+
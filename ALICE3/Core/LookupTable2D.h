@@ -0,0 +1,92 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+///
+/// \file LookupTable2D.h
+///
+/// \brief Function of two variables tabulated on a uniform grid, for the on-the-fly PID tasks
+///
+/// The function is evaluated once on the nodes of the grid and then interpolated bilinearly.
+/// Nodes where the function is not finite are stored as NaN, so that the queries outside of the
+/// grid or in a cell touching an invalid node return NaN and the caller can fall back to the
+/// analytic function, e.g. close to a threshold.
+///
+
+#ifndef ALICE3_CORE_LOOKUPTABLE2D_H_
+#define ALICE3_CORE_LOOKUPTABLE2D_H_
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace o2::upgrade
+{
+
+class LookupTable2D
+{
+ public:
+  /// Tabulate function(x, y) on nX x nY cells in [minX, maxX] x [minY, maxY]
+  template <typename Function>
+  void build(int nX, float minX, float maxX, int nY, float minY, float maxY, Function function)
+  {
+    mNX = std::max(nX, 1);
+    mNY = std::max(nY, 1);
+    mMinX = minX;
+    mMaxX = maxX;
+    mMinY = minY;
+    mMaxY = maxY;
+    mInvStepX = mNX / (maxX - minX);
+    mInvStepY = mNY / (maxY - minY);
+    mValues.resize((mNX + 1) * (mNY + 1));
+    for (int iX = 0; iX <= mNX; iX++) {
+      const float x = minX + iX * (maxX - minX) / mNX;
+      for (int iY = 0; iY <= mNY; iY++) {
+        const float y = minY + iY * (maxY - minY) / mNY;
+        const float value = function(x, y);
+        mValues[iX * (mNY + 1) + iY] = std::isfinite(value) ? value : std::numeric_limits<float>::quiet_NaN();
+      }
+    }
+  }
+
+  bool isBuilt() const { return !mValues.empty(); }
+
+  /// Interpolated value, NaN if not available
+  float get(float x, float y) const
+  {
+    if (!(x >= mMinX && x <= mMaxX && y >= mMinY && y <= mMaxY) || mValues.empty()) { // also catches NaN
+      return std::numeric_limits<float>::quiet_NaN();
+    }
+    const float fX = (x - mMinX) * mInvStepX;
+    const float fY = (y - mMinY) * mInvStepY;
+    const int iX = std::min(static_cast<int>(fX), mNX - 1);
+    const int iY = std::min(static_cast<int>(fY), mNY - 1);
+    const float tX = fX - iX;
+    const float tY = fY - iY;
+    const float* v0 = &mValues[iX * (mNY + 1) + iY];
+    const float* v1 = v0 + (mNY + 1);
+    return (1.f - tX) * ((1.f - tY) * v0[0] + tY * v0[1]) + tX * ((1.f - tY) * v1[0] + tY * v1[1]);
+  }
+
+ private:
+  int mNX = 0;
+  int mNY = 0;
+  float mMinX = 0.f;
+  float mMaxX = 0.f;
+  float mMinY = 0.f;
+  float mMaxY = 0.f;
+  float mInvStepX = 0.f;
+  float mInvStepY = 0.f;
+  std::vector<float> mValues; // (nX + 1) x (nY + 1) nodes, y fastest
+};
+
+} // namespace o2::upgrade
+
+#endif // ALICE3_CORE_LOOKUPTABLE2D_H_
@@ -0,0 +1,223 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+///
+/// \file MulticharmFinder.h
+///
+/// \brief Helpers of the multi-charm candidate finder: MC ancestry of a dataframe and (eta, phi) index of the daughters
+///
+/// McAncestry stores the mothers of all the MC particles of a dataframe in flat arrays, so that the
+/// same-mother checks of the track combinations are comparisons of integers instead of nested loops
+/// over the mothers of the particles. AngularIndex sorts the candidate daughters of a collision into
+/// (eta, phi) cells, so that the daughters within a window around the direction of the parent are
+/// found by visiting the cells of the window only.
+///
+
+#ifndef ALICE3_CORE_MULTICHARMFINDER_H_
+#define ALICE3_CORE_MULTICHARMFINDER_H_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace o2::upgrade
+{
+
+class McAncestry
+{
+ public:
+  /// Whether the ancestry was built from this table of MC particles
+  template <typename TMcParticles>
+  bool isBoundTo(TMcParticles const& mcParticles) const
+  {
+    return !mOffsets.empty() && mOffsets.size() == static_cast<std::size_t>(mcParticles.size()) + 1 && mFingerprint == fingerprint(mcParticles);
+  }
+
+  /// Copy the mothers of all the MC particles of the table
+  template <typename TMcParticles>
+  void build(TMcParticles const& mcParticles)
+  {
+    mOffsets.clear();
+    mMothers.clear();
+    mOffsets.reserve(mcParticles.size() + 1);
+    mOffsets.push_back(0);
+    for (auto const& mcParticle : mcParticles) {
+      for (const auto& motherId : mcParticle.mothersIds()) {
+        if (motherId >= 0) {
+          mMothers.push_back(motherId);
+        }
+      }
+      mOffsets.push_back(mMothers.size());
+    }
+    mFingerprint = fingerprint(mcParticles);
+  }
+
+  /// Whether the particles share a mother; false if any of them is not an MC particle (negative index)
+  bool shareMother(int particle1, int particle2) const
+  {
+    if (particle1 < 0 || particle2 < 0) {
+      return false;
+    }
+    for (int i = mOffsets[particle1]; i < mOffsets[particle1 + 1]; i++) {
+      if (isMotherOf(mMothers[i], particle2)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// Whether a grandmother of particle1 is a mother of particle2
+  bool grandmotherIsMotherOf(int particle1, int particle2) const
+  {
+    if (particle1 < 0 || particle2 < 0) {
+      return false;
+    }
+    for (int i = mOffsets[particle1]; i < mOffsets[particle1 + 1]; i++) {
+      const int mother = mMothers[i];
+      for (int j = mOffsets[mother]; j < mOffsets[mother + 1]; j++) {
+        if (isMotherOf(mMothers[j], particle2)) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+ private:
+  bool isMotherOf(int mother, int particle) const
+  {
+    for (int i = mOffsets[particle]; i < mOffsets[particle + 1]; i++) {
+      if (mMothers[i] == mother) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  template <typename TMcParticles>
+  static std::array<float, 4> fingerprint(TMcParticles const& mcParticles)
+  {
+    if (mcParticles.size() == 0) {
+      return {};
+    }
+    auto first = mcParticles.rawIteratorAt(0);
+    auto last = mcParticles.rawIteratorAt(mcParticles.size() - 1);
+    return {first.px(), first.pz(), last.px(), last.pz()};
+  }
+
+  std::vector<int> mOffsets; // mothers of particle i in [mOffsets[i], mOffsets[i + 1])
+  std::vector<int> mMothers;
+  std::array<float, 4> mFingerprint{};
+};
+
+class AngularIndex
+{
+ public:
+  /// Grid of nEta x nPhi cells in [etaMin, etaMax] x [0, 2pi]
+  void setGrid(int nEta, float etaMin, float etaMax, int nPhi)
+  {
+    mNEta = std::max(nEta, 1);
+    mNPhi = std::max(nPhi, 1);
+    mEtaMin = etaMin;
+    mEtaMax = etaMax;
+    mCellStarts.assign(mNEta * mNPhi + 1, 0);
+  }
+
+  /// Index the entries 0..n-1 with their eta and phi
+  void fill(std::vector<float> const& eta, std::vector<float> const& phi)
+  {
+    const int n = eta.size();
+    mCells.resize(n);
+    std::fill(mCellStarts.begin(), mCellStarts.end(), 0);
+    for (int i = 0; i < n; i++) {
+      mCells[i] = etaBin(eta[i]) * mNPhi + phiBin(phi[i]);
+      mCellStarts[mCells[i] + 1]++;
+    }
+    for (std::size_t iCell = 1; iCell < mCellStarts.size(); iCell++) {
+      mCellStarts[iCell] += mCellStarts[iCell - 1];
+    }
+    mEntries.resize(n);
+    std::vector<int> next(mCellStarts.begin(), mCellStarts.end() - 1);
+    for (int i = 0; i < n; i++) {
+      mEntries[next[mCells[i]]++] = i;
+    }
+    mEta = eta;
+    mPhi = phi;
+  }
+
+  /// Entries with |eta - eta0| <= deltaEta and |phi - phi0| <= deltaPhi (modulo 2pi), in increasing order;
+  /// a negative window does not restrict the corresponding coordinate
+  void select(float eta0, float phi0, float deltaEta, float deltaPhi, std::vector<int>& selected) const
+  {
+    selected.clear();
+    const int n = mEta.size();
+    if (deltaEta < 0.f && deltaPhi < 0.f) {
+      for (int i = 0; i < n; i++) {
+        selected.push_back(i);
+      }
+      return;
+    }
+    const int iEtaLow = deltaEta < 0.f ? 0 : etaBin(eta0 - deltaEta);
+    const int iEtaHigh = deltaEta < 0.f ? mNEta - 1 : etaBin(eta0 + deltaEta);
+    const bool checkPhi = deltaPhi >= 0.f && 2.f * deltaPhi < TwoPi;
+    const bool allPhiCells = !checkPhi || 2.f * deltaPhi >= TwoPi * (mNPhi - 1) / mNPhi; // window wider than all cells but one
+    const int iPhiLow = allPhiCells ? 0 : phiBin(phi0 - deltaPhi);
+    const int nPhiCells = allPhiCells ? mNPhi : (phiBin(phi0 + deltaPhi) - iPhiLow + mNPhi) % mNPhi + 1;
+    for (int iEta = iEtaLow; iEta <= iEtaHigh; iEta++) {
+      for (int k = 0; k < nPhiCells; k++) {
+        const int cell = iEta * mNPhi + (iPhiLow + k) % mNPhi;
+        for (int j = mCellStarts[cell]; j < mCellStarts[cell + 1]; j++) {
+          const int i = mEntries[j];
+          if (deltaEta >= 0.f && std::fabs(mEta[i] - eta0) > deltaEta) {
+            continue;
+          }
+          if (checkPhi && std::fabs(std::remainder(mPhi[i] - phi0, TwoPi)) > deltaPhi) {
+            continue;
+          }
+          selected.push_back(i);
+        }
+      }
+    }
+    std::sort(selected.begin(), selected.end());
+  }
+
+ private:
+  static constexpr float TwoPi = 2.f * static_cast<float>(M_PI);
+
+  int etaBin(float eta) const
+  {
+    const int bin = static_cast<int>(std::floor((eta - mEtaMin) / (mEtaMax - mEtaMin) * mNEta));
+    return std::clamp(bin, 0, mNEta - 1); // first and last cells include under- and overflow
+  }
+  int phiBin(float phi) const
+  {
+    float phi02pi = std::fmod(phi, TwoPi);
+    if (phi02pi < 0.f) {
+      phi02pi += TwoPi;
+    }
+    return std::min(static_cast<int>(phi02pi / TwoPi * mNPhi), mNPhi - 1);
+  }
+
+  int mNEta = 1;
+  int mNPhi = 1;
+  float mEtaMin = -4.f;
+  float mEtaMax = 4.f;
+  std::vector<int> mCellStarts{0, 0}; // entries of cell c in mEntries[mCellStarts[c], mCellStarts[c + 1])
+  std::vector<int> mCells;
+  std::vector<int> mEntries;
+  std::vector<float> mEta;
+  std::vector<float> mPhi;
+};
+
+} // namespace o2::upgrade
+
+#endif // ALICE3_CORE_MULTICHARMFINDER_H_
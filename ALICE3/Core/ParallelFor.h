@@ -0,0 +1,53 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+///
+/// \file ParallelFor.h
+///
+/// \brief Split a loop over the tracks of a dataframe or collision into contiguous chunks run by threads
+///
+/// The body is called as f(begin, end) on disjoint ranges and must only write to the entries of its range;
+/// with one thread (or one entry) it is called once in the calling thread.
+///
+
+#ifndef ALICE3_CORE_PARALLELFOR_H_
+#define ALICE3_CORE_PARALLELFOR_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace o2::upgrade
+{
+
+template <typename TFunction>
+void parallelFor(std::size_t n, int nThreads, TFunction&& f)
+{
+  const std::size_t nChunks = std::min(static_cast<std::size_t>(std::max(nThreads, 1)), n);
+  if (nChunks <= 1) {
+    f(std::size_t{0}, n);
+    return;
+  }
+  const std::size_t chunkSize = (n + nChunks - 1) / nChunks;
+  std::vector<std::thread> workers;
+  workers.reserve(nChunks - 1);
+  for (std::size_t begin = chunkSize; begin < n; begin += chunkSize) {
+    workers.emplace_back([&f, begin, end = std::min(begin + chunkSize, n)]() { f(begin, end); });
+  }
+  f(std::size_t{0}, std::min(chunkSize, n));
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+} // namespace o2::upgrade
+
+#endif // ALICE3_CORE_PARALLELFOR_H_
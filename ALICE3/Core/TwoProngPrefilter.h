@@ -0,0 +1,125 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+///
+/// \file TwoProngPrefilter.h
+///
+/// \brief Positive x negative track pairing with loose mass and DCA prefilters, before the vertex fit
+///
+/// The positive and negative daughter candidates of a collision are copied into two blocks of flat
+/// arrays. For each positive track the whole negative block is tested in a branch-free loop, which
+/// the compiler can vectorise: invariant mass of the pair from the momenta at the DCA to the PV
+/// within a loose window, and distance in z of the two tracks at their DCA to the PV. Only the pairs
+/// passing these checks are handed over to the DCA fitter.
+///
+
+#ifndef ALICE3_CORE_TWOPRONGPREFILTER_H_
+#define ALICE3_CORE_TWOPRONGPREFILTER_H_
+
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace o2::upgrade
+{
+
+class TwoProngPrefilter
+{
+ public:
+  /// Daughter candidates of one charge
+  struct Block {
+    std::vector<float> px;
+    std::vector<float> py;
+    std::vector<float> pz;
+    std::vector<float> p2;
+    std::vector<float> z;
+    std::vector<int64_t> row; // position in the tracks of the collision
+    std::vector<int> mcParticle;
+
+    std::size_t size() const { return row.size(); }
+    void clear()
+    {
+      px.clear();
+      py.clear();
+      pz.clear();
+      p2.clear();
+      z.clear();
+      row.clear();
+      mcParticle.clear();
+    }
+  };
+
+  /// Copy the tracks, offset being the global index of the first track of the collision
+  template <typename TTracks>
+  static void fill(TTracks const& tracks, int64_t offset, Block& block)
+  {
+    block.clear();
+    for (auto const& track : tracks) {
+      block.px.push_back(track.px());
+      block.py.push_back(track.py());
+      block.pz.push_back(track.pz());
+      block.p2.push_back(track.px() * track.px() + track.py() * track.py() + track.pz() * track.pz());
+      block.z.push_back(track.z());
+      block.row.push_back(track.globalIndex() - offset);
+      block.mcParticle.push_back(track.mcParticleId());
+    }
+  }
+
+  /// Window on the invariant mass of the pair; a negative bound is not applied
+  void setMassWindow(float massMin, float massMax)
+  {
+    mMass2Min = massMin < 0.f ? -1e30f : massMin * massMin;
+    mMass2Max = massMax < 0.f ? 1e30f : massMax * massMax;
+  }
+  /// Maximum distance in z of the tracks at their DCA to the PV; negative: not applied
+  void setMaxDeltaZ(float maxDeltaZ) { mMaxDeltaZ = maxDeltaZ < 0.f ? 1e30f : maxDeltaZ; }
+
+  /// Pairs (positive, negative) of block indices passing the prefilters, with the given mass hypotheses
+  void findPairs(Block const& positive, Block const& negative, float massPositive, float massNegative, std::vector<std::pair<int, int>>& pairs)
+  {
+    pairs.clear();
+    const int nNegative = negative.size();
+    const float mass2Positive = massPositive * massPositive;
+    const float mass2Negative = massNegative * massNegative;
+    mEnergyNegative.resize(nNegative);
+    mPass.resize(nNegative);
+    for (int in = 0; in < nNegative; in++) {
+      mEnergyNegative[in] = std::sqrt(negative.p2[in] + mass2Negative);
+    }
+    for (std::size_t ip = 0; ip < positive.size(); ip++) {
+      const float px = positive.px[ip];
+      const float py = positive.py[ip];
+      const float pz = positive.pz[ip];
+      const float z = positive.z[ip];
+      const float energy = std::sqrt(positive.p2[ip] + mass2Positive);
+      for (int in = 0; in < nNegative; in++) {
+        const float mass2 = mass2Positive + mass2Negative + 2.f * (energy * mEnergyNegative[in] - px * negative.px[in] - py * negative.py[in] - pz * negative.pz[in]);
+        mPass[in] = (mass2 >= mMass2Min) & (mass2 <= mMass2Max) & (std::fabs(z - negative.z[in]) <= mMaxDeltaZ);
+      }
+      for (int in = 0; in < nNegative; in++) {
+        if (mPass[in]) {
+          pairs.emplace_back(ip, in);
+        }
+      }
+    }
+  }
+
+ private:
+  float mMass2Min = -1e30f;
+  float mMass2Max = 1e30f;
+  float mMaxDeltaZ = 1e30f;
+  std::vector<float> mEnergyNegative;
+  std::vector<uint8_t> mPass;
+};
+
+} // namespace o2::upgrade
+
+#endif // ALICE3_CORE_TWOPRONGPREFILTER_H_
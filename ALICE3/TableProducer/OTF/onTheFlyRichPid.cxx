@@ -32,8 +32,10 @@
 
 #include <utility>
 #include <cmath>
+#include <limits>
 #include <vector>
 #include <map>
+#include <random>
 #include <string>
 
 #include <TPDGCode.h>
@@ -48,6 +50,8 @@
 #include "Common/DataModel/TrackSelectionTables.h"
 #include "Common/Core/trackUtilities.h"
 #include "ALICE3/Core/TrackUtilities.h"
+#include "ALICE3/Core/LookupTable2D.h"
+#include "ALICE3/Core/CounterBasedRandom.h"
 #include "ReconstructionDataFormats/DCA.h"
 #include "DetectorsBase/Propagator.h"
 #include "DetectorsBase/GeometryManager.h"
@@ -58,7 +62,6 @@
 #include "DataFormatsCalibration/MeanVertexObject.h"
 #include "CommonConstants/GeomConstants.h"
 #include "CommonConstants/PhysicsConstants.h"
-#include "TRandom3.h"
 #include "TVector3.h"
 #include "TString.h"
 #include "ALICE3/DataModel/OTFRICH.h"
@@ -100,6 +103,7 @@ struct OnTheFlyRichPid {
   Configurable<bool> flagIncludeTrackAngularRes{"flagIncludeTrackAngularRes", true, "flag to include or exclude track time resolution"};
   Configurable<float> multiplicityEtaRange{"multiplicityEtaRange", 0.800000012, "eta range to compute the multiplicity"};
   Configurable<bool> flagRICHLoadDelphesLUTs{"flagRICHLoadDelphesLUTs", false, "flag to load Delphes LUTs for tracking correction (use recoTrack parameters if false)"};
+  Configurable<int> randomSeed{"randomSeed", 0, "seed of the angle smearing (0: different at every run)"};
   /*Configurable<float> bRichRefractiveIndexSector0AndNMinus1{"bRichRefractiveIndexSector0AndMinus1", 1.03, "barrel RICH refractive index sector 0 and N-1"};
   Configurable<float> bRichRefractiveIndexSector1AndNMinus2{"bRichRefractiveIndexSector1AndMinus2", 1.03, "barrel RICH refractive index sector 1 and N-2"};
   Configurable<float> bRichRefractiveIndexSector2AndNMinus3{"bRichRefractiveIndexSector2AndMinus3", 1.03, "barrel RICH refractive index sector 2 and N-3"};
@@ -144,6 +148,9 @@ struct OnTheFlyRichPid {
   Configurable<float> bRichRefractiveIndexSector20{"bRichRefractiveIndexSector20", 1.03, "barrel RICH refractive index central(s)-20 and central(s)+20"}; // central(s)-20 and central(s)+20
   Configurable<float> bRICHPixelSize{"bRICHPixelSize", 0.1, "barrel RICH pixel size (cm)"};
   Configurable<float> bRichGapRefractiveIndex{"bRichGapRefractiveIndex", 1.000283, "barrel RICH gap refractive index"};
+  Configurable<int> lookupTableMode{"lookupTableMode", 0, "ring angular resolution: 0 analytic, 1 tabulated at init, 2 tabulated and cross-checked against the analytic result"};
+  Configurable<int> lookupTableBinsTheta{"lookupTableBinsTheta", 200, "number of Cherenkov angle bins of the ring angular resolution tables"};
+  Configurable<int> lookupTableBinsEta{"lookupTableBinsEta", 200, "number of eta bins per sector of the ring angular resolution tables"};
 
   struct : ConfigurableGroup {
     Configurable<std::string> lutEl{"lutEl", "inherit", "LUT for electrons (if inherit, inherits from otf tracker task)"};
@@ -159,7 +166,7 @@ struct OnTheFlyRichPid {
   o2::delphes::DelphesO2TrackSmearer mSmearer;
 
   // needed: random number generator for smearing
-  TRandom3 pRandomNumberGenerator;
+  o2::upgrade::CounterBasedRandom pRandomNumberGenerator; // keyed by collision and track, independent of the processing order
 
   // for handling basic QA histograms if requested
   HistogramRegistry histos{"Histos", {}, OutputObjHandlingPolicy::AnalysisObject};
@@ -184,6 +191,9 @@ struct OnTheFlyRichPid {
   std::vector<float> photodetrctor_length;
   std::vector<float> gap_thickness;
 
+  // Ring angular resolution vs (Cherenkov angle, eta), one table per sector
+  std::vector<o2::upgrade::LookupTable2D> ringResolutionTables;
+
   // Update projective geometry
   void updateProjectiveParameters()
   {
@@ -319,7 +329,7 @@ struct OnTheFlyRichPid {
 
   void init(o2::framework::InitContext& initContext)
   {
-    pRandomNumberGenerator.SetSeed(0); // fully randomize
+    pRandomNumberGenerator.setSeed(randomSeed.value != 0 ? randomSeed.value : std::random_device{}()); // 0: fully randomize
 
     // Check if inheriting the LUT configuration
     auto configLutPath = [&](Configurable<std::string>& lut) {
@@ -445,6 +455,60 @@ struct OnTheFlyRichPid {
 
     // Update projective parameters
     updateProjectiveParameters();
+
+    if (lookupTableMode > 0) {
+      buildRingResolutionTables();
+      if (lookupTableMode > 1) {
+        const AxisSpec axisEta{static_cast<int>(nBinsEta), -2.0f, +2.0f, "#eta"};
+        histos.add("h2dRingResolutionTableRelDiffVsEta", "h2dRingResolutionTableRelDiffVsEta", kTH2F, {axisEta, {200, -0.01f, 0.01f, "(tabulated - analytic) / analytic ring angular resolution"}});
+      }
+    }
+  }
+
+  /// tabulate the ring angular resolution of each sector in its eta range, for the Cherenkov angles giving enough photons
+  void buildRingResolutionTables()
+  {
+    ringResolutionTables.clear();
+    ringResolutionTables.resize(mNumberSectors);
+    const float minPhotonsSin2 = 3. / (230. * bRichRadiatorThickness); // see CherenkovAngle
+    if (minPhotonsSin2 >= 1.) {
+      return;
+    }
+    const float minTheta = std::asin(std::sqrt(minPhotonsSin2));
+    for (int i_sector = 0; i_sector < mNumberSectors; i_sector++) {
+      const float maxTheta = std::acos(1. / aerogel_rindex[i_sector]);
+      // sector boundaries are excluded by findSector and fractionPhotonsProjectiveRICH, stay slightly inside
+      const float minEta = -std::log(std::tan(theta_min[i_sector] / 2.));
+      const float maxEta = -std::log(std::tan(theta_max[i_sector] / 2.));
+      const float margin = 1e-4 * (maxEta - minEta);
+      if (!(maxTheta > minTheta) || !(maxEta > minEta)) {
+        continue;
+      }
+      ringResolutionTables[i_sector].build(lookupTableBinsTheta, minTheta, maxTheta, lookupTableBinsEta, minEta + margin, maxEta - margin, [&](float theta, float eta) {
+        const float resolution = extract_ring_angular_resolution(eta, aerogel_rindex[i_sector], bRichGapRefractiveIndex, bRichRadiatorThickness, gap_thickness[i_sector], bRICHPixelSize, theta, photodetrctor_length[i_sector]);
+        return resolution > error_value + 1 ? resolution : std::numeric_limits<float>::quiet_NaN();
+      });
+    }
+    LOGF(info, "Tabulated the ring angular resolution of %d sectors with %d x %d bins", mNumberSectors, static_cast<int>(lookupTableBinsTheta), static_cast<int>(lookupTableBinsEta));
+  }
+
+  /// returns the ring angular resolution, from the tables if enabled and available, analytic otherwise
+  /// \param eta the pseudorapidity of the track
+  /// \param i_sector the index of the track RICH sector
+  /// \param theta_c the Cherenkov angle of the track
+  float ringAngularResolution(float eta, int i_sector, float theta_c)
+  {
+    if (lookupTableMode > 0 && theta_c > error_value + 1) {
+      const float tabulated = ringResolutionTables[i_sector].get(theta_c, eta);
+      if (!std::isnan(tabulated)) {
+        if (lookupTableMode > 1) {
+          const float analytic = extract_ring_angular_resolution(eta, aerogel_rindex[i_sector], bRichGapRefractiveIndex, bRichRadiatorThickness, gap_thickness[i_sector], bRICHPixelSize, theta_c, photodetrctor_length[i_sector]);
+          histos.fill(HIST("h2dRingResolutionTableRelDiffVsEta"), eta, (tabulated - analytic) / analytic);
+        }
+        return tabulated;
+      }
+    }
+    return extract_ring_angular_resolution(eta, aerogel_rindex[i_sector], bRichGapRefractiveIndex, bRichRadiatorThickness, gap_thickness[i_sector], bRICHPixelSize, theta_c, photodetrctor_length[i_sector]);
   }
 
   /// check if particle reaches radiator
@@ -744,7 +808,10 @@ struct OnTheFlyRichPid {
       }
     }
 
+    const uint64_t eventKey = o2::upgrade::CounterBasedRandom::key(mcPvVtx.getX(), mcPvVtx.getY(), mcPvVtx.getZ(), collision.posZ(), collision.collisionTime(), tracks.size());
+    uint32_t trackKey = 0;
     for (const auto& track : tracks) {
+      trackKey++;
       // first step: find precise arrival time (if any)
       // --- convert track into perfect track
       if (!track.has_mcParticle()) // should always be OK but check please
@@ -772,7 +839,7 @@ struct OnTheFlyRichPid {
 
       float expectedAngleBarrelRich = CherenkovAngle(o2track.getP(), pdgInfo->Mass(), aerogel_rindex[i_sector]);
       // float barrelRICHAngularResolution = AngularResolution(o2track.getEta());
-      float barrelRICHAngularResolution = extract_ring_angular_resolution(o2track.getEta(), aerogel_rindex[i_sector], bRichGapRefractiveIndex, bRichRadiatorThickness, gap_thickness[i_sector], bRICHPixelSize, expectedAngleBarrelRich, photodetrctor_length[i_sector]);
+      float barrelRICHAngularResolution = ringAngularResolution(o2track.getEta(), i_sector, expectedAngleBarrelRich);
       float projectiveRadiatorRadius = radiusRipple(o2track.getEta(), i_sector);
       bool flagReachesRadiator = false;
       if (projectiveRadiatorRadius > error_value + 1.) {
@@ -784,7 +851,7 @@ struct OnTheFlyRichPid {
       ///             Discrepancies may be negligible, but would be more rigorous if propagation tool is available
 
       // Smear with expected resolutions
-      float measuredAngleBarrelRich = pRandomNumberGenerator.Gaus(expectedAngleBarrelRich, barrelRICHAngularResolution);
+      float measuredAngleBarrelRich = pRandomNumberGenerator.gaus(expectedAngleBarrelRich, barrelRICHAngularResolution, eventKey, trackKey, 0);
 
       // Now we calculate the expected Cherenkov angle following certain mass hypotheses
       // and the (imperfect!) reconstructed track parametrizations
@@ -25,7 +25,10 @@
 ///
 
 #include <utility>
+#include <array>
+#include <cmath>
 #include <map>
+#include <random>
 #include <string>
 #include <vector>
 
@@ -41,6 +44,9 @@
 #include "Common/DataModel/TrackSelectionTables.h"
 #include "Common/Core/trackUtilities.h"
 #include "ALICE3/Core/TrackUtilities.h"
+#include "ALICE3/Core/LookupTable2D.h"
+#include "ALICE3/Core/CounterBasedRandom.h"
+#include "ALICE3/Core/ParallelFor.h"
 #include "ReconstructionDataFormats/DCA.h"
 #include "DetectorsBase/Propagator.h"
 #include "DetectorsBase/GeometryManager.h"
@@ -51,7 +57,6 @@
 #include "DataFormatsCalibration/MeanVertexObject.h"
 #include "CommonConstants/GeomConstants.h"
 #include "CommonConstants/PhysicsConstants.h"
-#include "TRandom3.h"
 #include "ALICE3/DataModel/OTFTOF.h"
 #include "DetectorsVertexing/HelixHelper.h"
 #include "TableHelper.h"
@@ -99,6 +104,13 @@ struct OnTheFlyTofPid {
     Configurable<std::string> lutPi{"lutPi", "inherit", "LUT for pions (if inherit, inherits from otf tracker task)"};
     Configurable<std::string> lutKa{"lutKa", "inherit", "LUT for kaons (if inherit, inherits from otf tracker task)"};
     Configurable<std::string> lutPr{"lutPr", "inherit", "LUT for protons (if inherit, inherits from otf tracker task)"};
+    Configurable<int> lookupTableMode{"lookupTableMode", 0, "track time resolution: 0 analytic, 1 tabulated at init, 2 tabulated and cross-checked against the analytic result"};
+    Configurable<int> lookupTableBinsPt{"lookupTableBinsPt", 400, "number of log(pt) bins of the track time resolution tables"};
+    Configurable<int> lookupTableBinsEta{"lookupTableBinsEta", 200, "number of eta bins of the track time resolution tables"};
+    Configurable<float> lookupTableMaxPt{"lookupTableMaxPt", 20.f, "maximum pt of the track time resolution tables (GeV/c)"};
+    Configurable<float> lookupTableMaxEta{"lookupTableMaxEta", 4.f, "maximum |eta| of the track time resolution tables"};
+    Configurable<int> randomSeed{"randomSeed", 0, "seed of the time smearing (0: different at every run)"};
+    Configurable<int> nThreads{"nThreads", 1, "number of threads propagating the tracks of a collision"};
   } simConfig;
 
   struct : ConfigurableGroup {
@@ -129,17 +141,22 @@ struct OnTheFlyTofPid {
   // Track smearer (here used to get absolute pt and eta uncertainties if simConfig.flagTOFLoadDelphesLUTs is true)
   o2::delphes::DelphesO2TrackSmearer mSmearer;
 
-  // needed: random number generator for smearing
-  TRandom3 pRandomNumberGenerator;
+  // needed: random number generator for smearing, keyed by collision and track
+  o2::upgrade::CounterBasedRandom pRandomNumberGenerator;
 
   // for handling basic QA histograms if requested
   HistogramRegistry histos{"Histos", {}, OutputObjHandlingPolicy::AnalysisObject};
   OutputObj<THashList> listEfficiency{"efficiency"};
   static constexpr int kParticles = 5;
+  static constexpr int kLayers = 2; // inner and outer TOF
+
+  // Derivatives of the time of flight with respect to pt and eta vs (log(pt), eta), per mass hypothesis and layer
+  std::array<std::array<o2::upgrade::LookupTable2D, kLayers>, kParticles> trackTimeDerivativePt;
+  std::array<std::array<o2::upgrade::LookupTable2D, kLayers>, kParticles> trackTimeDerivativeEta;
 
   void init(o2::framework::InitContext& initContext)
   {
-    pRandomNumberGenerator.SetSeed(0); // fully randomize
+    pRandomNumberGenerator.setSeed(simConfig.randomSeed.value != 0 ? simConfig.randomSeed.value : std::random_device{}()); // 0: fully randomize
 
     // Check if inheriting the LUT configuration
     auto configLutPath = [&](Configurable<std::string>& lut) {
@@ -251,6 +268,14 @@ struct OnTheFlyTofPid {
         }
       }
     }
+
+    if (simConfig.flagIncludeTrackTimeRes && simConfig.lookupTableMode > 0) {
+      buildTrackTimeTables();
+      if (simConfig.lookupTableMode > 1) {
+        const AxisSpec axisPt{static_cast<int>(plotsConfig.nBinsP), 0.0f, +4.0f, "#it{p}_{T} (GeV/#it{c})"};
+        histos.add("h2dTrackTimeResTableRelDiffVsPt", "h2dTrackTimeResTableRelDiffVsPt", kTH2F, {axisPt, {200, -0.01f, 0.01f, "(tabulated - analytic) / analytic track time resolution"}});
+      }
+    }
   }
 
   /// function to calculate track length of this track up to a certain radius
@@ -357,6 +382,68 @@ struct OnTheFlyTofPid {
   };
 
   std::vector<TracksWithTime> tracksWithTime;
+
+  /// Arrival of a track at the TOF layers, computed from this track only
+  struct TrackArrival {
+    enum Status { kNoMcParticle,
+                  kUnknownPdg,
+                  kOk };
+    Status status = kNoMcParticle;
+    int pdgCode = 0;
+    float mass = 0.f;
+    o2::track::TrackParCov mcTrack;   // perfect track, propagated to the MC PV
+    o2::track::TrackParCov recoTrack; // reconstructed track, propagated to the reconstructed PV
+    float trackLengthInnerTOF = -1.f, trackLengthOuterTOF = -1.f;
+    float trackLengthRecoInnerTOF = -1.f, trackLengthRecoOuterTOF = -1.f;
+    float expectedTimeInnerTOF = 0.f, expectedTimeOuterTOF = 0.f;
+    float measuredTimeInnerTOF = 0.f, measuredTimeOuterTOF = 0.f;
+  };
+  std::vector<TrackArrival> trackArrivals;
+
+  /// Propagates the tracks, computes the track lengths and smears the arrival times; thread safe, the random
+  /// numbers depending only on the collision and on the position of the track in the collision
+  void computeArrival(TrackArrival& arrival, o2::dataformats::VertexBase const& pvVtx, o2::dataformats::VertexBase const& mcPvVtx,
+                      float eventCollisionTimePS, uint64_t eventKey, uint32_t trackKey)
+  {
+    if (arrival.status == TrackArrival::kNoMcParticle) {
+      return;
+    }
+    static constexpr float kTrkXThreshold = -99.f; // Threshold to consider a good propagation of the track
+    float xPv = -100.f;
+    if (arrival.mcTrack.propagateToDCA(mcPvVtx, simConfig.dBz)) {
+      xPv = arrival.mcTrack.getX();
+    }
+    arrival.trackLengthInnerTOF = -1.f;
+    arrival.trackLengthOuterTOF = -1.f;
+    if (xPv > kTrkXThreshold) {
+      arrival.trackLengthInnerTOF = computeTrackLength(arrival.mcTrack, simConfig.innerTOFRadius, simConfig.dBz);
+      arrival.trackLengthOuterTOF = computeTrackLength(arrival.mcTrack, simConfig.outerTOFRadius, simConfig.dBz);
+    }
+    if (arrival.status == TrackArrival::kUnknownPdg) {
+      return;
+    }
+    const float v = computeParticleVelocity(arrival.mcTrack.getP(), arrival.mass);
+    arrival.expectedTimeInnerTOF = arrival.trackLengthInnerTOF / v + eventCollisionTimePS; // arrival time to the Inner TOF in ps
+    arrival.expectedTimeOuterTOF = arrival.trackLengthOuterTOF / v + eventCollisionTimePS; // arrival time to the Outer TOF in ps
+
+    // Smear with expected resolutions
+    const auto normals = pRandomNumberGenerator.normals(eventKey, trackKey, 0);
+    arrival.measuredTimeInnerTOF = arrival.expectedTimeInnerTOF + simConfig.innerTOFTimeReso * normals[0];
+    arrival.measuredTimeOuterTOF = arrival.expectedTimeOuterTOF + simConfig.outerTOFTimeReso * normals[1];
+
+    // Now we calculate the expected arrival time following certain mass hypotheses
+    // and the (imperfect!) reconstructed track parametrizations
+    xPv = -100.f;
+    if (arrival.recoTrack.propagateToDCA(pvVtx, simConfig.dBz)) {
+      xPv = arrival.recoTrack.getX();
+    }
+    arrival.trackLengthRecoInnerTOF = -1.f;
+    arrival.trackLengthRecoOuterTOF = -1.f;
+    if (xPv > kTrkXThreshold) {
+      arrival.trackLengthRecoInnerTOF = computeTrackLength(arrival.recoTrack, simConfig.innerTOFRadius, simConfig.dBz);
+      arrival.trackLengthRecoOuterTOF = computeTrackLength(arrival.recoTrack, simConfig.outerTOFRadius, simConfig.dBz);
+    }
+  }
   bool eventTime(std::vector<TracksWithTime>& tracks,
                  std::array<float, 2>& tzero)
   {
@@ -407,6 +494,28 @@ struct OnTheFlyTofPid {
     return true;
   }
 
+  /// returns the absolute derivatives of the time of flight with respect to pt and eta
+  /// \param pt the transverse momentum of the tarck
+  /// \param eta the pseudorapidity of the tarck
+  /// \param mass the mass of the particle
+  /// \param detRadius the radius of the cylindrical layer
+  /// \param magneticField the magnetic field (along Z)
+  std::pair<double, double> calculateTrackTimeDerivatives(const float pt,
+                                                          const float eta,
+                                                          const float mass,
+                                                          const float detRadius,
+                                                          const float magneticField)
+  {
+    // Compute tracking contribution to timing using the error propagation formula
+    // Uses light speed in m/ps, magnetic field in T (*0.1 for conversion kGauss -> T)
+    double a0 = mass * mass;
+    double a1 = 0.299792458 * (0.1 * magneticField) * (0.01 * o2::constants::physics::LightSpeedCm2NS / 1e+3);
+    double a2 = (detRadius * 0.01) * (detRadius * 0.01) * (0.299792458) * (0.299792458) * (0.1 * magneticField) * (0.1 * magneticField) / 2.0;
+    double dtofOndPt = (std::pow(pt, 4) * std::pow(std::cosh(eta), 2) * std::acos(1.0 - a2 / std::pow(pt, 2)) - 2.0 * a2 * std::pow(pt, 2) * (a0 + std::pow(pt * std::cosh(eta), 2)) / std::sqrt(a2 * (2.0 * std::pow(pt, 2) - a2))) / (a1 * std::pow(pt, 3) * std::sqrt(a0 + std::pow(pt * std::cosh(eta), 2)));
+    double dtofOndEta = std::pow(pt, 2) * std::sinh(eta) * std::cosh(eta) * std::acos(1.0 - a2 / std::pow(pt, 2)) / (a1 * std::sqrt(a0 + std::pow(pt * std::cosh(eta), 2)));
+    return {std::fabs(dtofOndPt), std::fabs(dtofOndEta)};
+  }
+
   /// returns track time resolution
   /// \param pt the transverse momentum of the tarck
   /// \param eta the pseudorapidity of the tarck
@@ -423,17 +532,59 @@ struct OnTheFlyTofPid {
                                               const float detRadius,
                                               const float magneticField)
   {
-    // Compute tracking contribution to timing using the error propagation formula
-    // Uses light speed in m/ps, magnetic field in T (*0.1 for conversion kGauss -> T)
-    double a0 = mass * mass;
-    double a1 = 0.299792458 * (0.1 * magneticField) * (0.01 * o2::constants::physics::LightSpeedCm2NS / 1e+3);
-    double a2 = (detRadius * 0.01) * (detRadius * 0.01) * (0.299792458) * (0.299792458) * (0.1 * magneticField) * (0.1 * magneticField) / 2.0;
-    double dtofOndPt = (std::pow(pt, 4) * std::pow(std::cosh(eta), 2) * std::acos(1.0 - a2 / std::pow(pt, 2)) - 2.0 * a2 * std::pow(pt, 2) * (a0 + std::pow(pt * std::cosh(eta), 2)) / std::sqrt(a2 * (2.0 * std::pow(pt, 2) - a2))) / (a1 * std::pow(pt, 3) * std::sqrt(a0 + std::pow(pt * std::cosh(eta), 2)));
-    double dtofOndEta = std::pow(pt, 2) * std::sinh(eta) * std::cosh(eta) * std::acos(1.0 - a2 / std::pow(pt, 2)) / (a1 * std::sqrt(a0 + std::pow(pt * std::cosh(eta), 2)));
-    double trackTimeResolution = std::hypot(std::fabs(dtofOndPt) * trackPtResolution, std::fabs(dtofOndEta) * trackEtaResolution);
+    const auto [dtofOndPt, dtofOndEta] = calculateTrackTimeDerivatives(pt, eta, mass, detRadius, magneticField);
+    double trackTimeResolution = std::hypot(dtofOndPt * trackPtResolution, dtofOndEta * trackEtaResolution);
     return trackTimeResolution;
   }
 
+  /// tabulate the derivatives of the time of flight of each mass hypothesis and layer
+  void buildTrackTimeTables()
+  {
+    static constexpr int kParticlePdgs[kParticles] = {kElectron, kMuonMinus, kPiPlus, kKPlus, kProton};
+    const float radii[kLayers] = {simConfig.innerTOFRadius, simConfig.outerTOFRadius};
+    for (int ii = 0; ii < kParticles; ii++) {
+      const float mass = pdg->GetParticle(kParticlePdgs[ii])->Mass();
+      for (int iLayer = 0; iLayer < kLayers; iLayer++) {
+        // the derivatives diverge at the pt needed to reach the layer, leave the region close to it to the analytic calculation
+        const float minPt = 1.1f * 0.299792458f * (0.1f * simConfig.dBz) * (0.01f * radii[iLayer]) / 2.f;
+        if (!(simConfig.lookupTableMaxPt > minPt)) {
+          continue;
+        }
+        const float radius = radii[iLayer];
+        const float minLogPt = std::log(minPt);
+        const float maxLogPt = std::log(simConfig.lookupTableMaxPt.value);
+        trackTimeDerivativePt[ii][iLayer].build(simConfig.lookupTableBinsPt, minLogPt, maxLogPt, simConfig.lookupTableBinsEta, -simConfig.lookupTableMaxEta, simConfig.lookupTableMaxEta, [&](float logPt, float eta) {
+          return static_cast<float>(calculateTrackTimeDerivatives(std::exp(logPt), eta, mass, radius, simConfig.dBz).first);
+        });
+        trackTimeDerivativeEta[ii][iLayer].build(simConfig.lookupTableBinsPt, minLogPt, maxLogPt, simConfig.lookupTableBinsEta, -simConfig.lookupTableMaxEta, simConfig.lookupTableMaxEta, [&](float logPt, float eta) {
+          return static_cast<float>(calculateTrackTimeDerivatives(std::exp(logPt), eta, mass, radius, simConfig.dBz).second);
+        });
+      }
+    }
+    LOGF(info, "Tabulated the track time resolution of %d mass hypotheses and %d layers with %d x %d bins", kParticles, kLayers, static_cast<int>(simConfig.lookupTableBinsPt), static_cast<int>(simConfig.lookupTableBinsEta));
+  }
+
+  /// returns track time resolution, from the tables if enabled and available, analytic otherwise
+  /// \param iLayer 0 for the inner TOF, 1 for the outer TOF
+  float trackTimeResolution(const float pt, const float eta, const float trackPtResolution, const float trackEtaResolution, const int ii, const float mass, const int iLayer)
+  {
+    const float detRadius = iLayer == 0 ? simConfig.innerTOFRadius : simConfig.outerTOFRadius;
+    if (simConfig.lookupTableMode > 0) {
+      const float logPt = std::log(pt);
+      const float dtofOndPt = trackTimeDerivativePt[ii][iLayer].get(logPt, eta);
+      const float dtofOndEta = trackTimeDerivativeEta[ii][iLayer].get(logPt, eta);
+      if (!std::isnan(dtofOndPt) && !std::isnan(dtofOndEta)) {
+        const float tabulated = std::hypot(dtofOndPt * trackPtResolution, dtofOndEta * trackEtaResolution);
+        if (simConfig.lookupTableMode > 1) {
+          const float analytic = calculateTrackTimeResolutionAdvanced(pt, eta, trackPtResolution, trackEtaResolution, mass, detRadius, simConfig.dBz);
+          histos.fill(HIST("h2dTrackTimeResTableRelDiffVsPt"), pt, (tabulated - analytic) / analytic);
+        }
+        return tabulated;
+      }
+    }
+    return calculateTrackTimeResolutionAdvanced(pt, eta, trackPtResolution, trackEtaResolution, mass, detRadius, simConfig.dBz);
+  }
+
   void process(soa::Join<aod::Collisions, aod::McCollisionLabels>::iterator const& collision,
                soa::Join<aod::Tracks, aod::TracksCov, aod::McTrackLabels> const& tracks,
                aod::McParticles const&,
@@ -481,69 +632,56 @@ struct OnTheFlyTofPid {
 
     tracksWithTime.clear(); // clear the vector of tracks with time to prepare the cache for the next event
     tracksWithTime.reserve(tracks.size());
-    // First loop to generate the arrival time of the particles to the TOF layers
+    // First loop to generate the arrival time of the particles to the TOF layers:
+    // the perfect and reconstructed tracks are prepared serially, propagated by chunks of tracks in parallel
+    // and the results are stored in the track order
+    trackArrivals.resize(tracks.size());
+    std::size_t iTrack = 0;
     for (const auto& track : tracks) {
-      // first step: find precise arrival time (if any)
-      // --- convert track into perfect track
+      auto& arrival = trackArrivals[iTrack++];
+      arrival.status = TrackArrival::kNoMcParticle;
       if (!track.has_mcParticle()) { // should always be OK but check please
-        upgradeTofMC(-999.f, -999.f, -999.f, -999.f);
         continue;
-      } else {
-        LOG(debug) << "Track without mcParticle found!";
       }
       const auto& mcParticle = track.mcParticle();
-      o2::track::TrackParCov o2track = o2::upgrade::convertMCParticleToO2Track(mcParticle, pdg);
-
-      float xPv = -100.f;
-      static constexpr float kTrkXThreshold = -99.f; // Threshold to consider a good propagation of the track
-      if (o2track.propagateToDCA(mcPvVtx, simConfig.dBz)) {
-        xPv = o2track.getX();
-      }
-      float trackLengthInnerTOF = -1, trackLengthOuterTOF = -1;
-      if (xPv > kTrkXThreshold) {
-        trackLengthInnerTOF = computeTrackLength(o2track, simConfig.innerTOFRadius, simConfig.dBz);
-        trackLengthOuterTOF = computeTrackLength(o2track, simConfig.outerTOFRadius, simConfig.dBz);
-      }
-
+      arrival.pdgCode = mcParticle.pdgCode();
+      arrival.mcTrack = o2::upgrade::convertMCParticleToO2Track(mcParticle, pdg);
+      arrival.recoTrack = getTrackParCov(track);
       // get mass to calculate velocity
       auto pdgInfo = pdg->GetParticle(mcParticle.pdgCode());
       if (pdgInfo == nullptr) {
         LOG(error) << "PDG code " << mcParticle.pdgCode() << " not found in the database";
-        upgradeTofMC(-999.f, -999.f, -999.f, -999.f);
+        arrival.status = TrackArrival::kUnknownPdg;
         continue;
       }
-      const float v = computeParticleVelocity(o2track.getP(), pdgInfo->Mass());
-      const float expectedTimeInnerTOF = trackLengthInnerTOF / v + eventCollisionTimePS; // arrival time to the Inner TOF in ps
-      const float expectedTimeOuterTOF = trackLengthOuterTOF / v + eventCollisionTimePS; // arrival time to the Outer TOF in ps
-      upgradeTofMC(expectedTimeInnerTOF, trackLengthInnerTOF, expectedTimeOuterTOF, trackLengthOuterTOF);
-
-      // Smear with expected resolutions
-      const float measuredTimeInnerTOF = pRandomNumberGenerator.Gaus(expectedTimeInnerTOF, simConfig.innerTOFTimeReso);
-      const float measuredTimeOuterTOF = pRandomNumberGenerator.Gaus(expectedTimeOuterTOF, simConfig.outerTOFTimeReso);
-
-      // Now we calculate the expected arrival time following certain mass hypotheses
-      // and the (imperfect!) reconstructed track parametrizations
-      float trackLengthRecoInnerTOF = -1, trackLengthRecoOuterTOF = -1;
-      auto recoTrack = getTrackParCov(track);
-      xPv = -100.f;
-      if (recoTrack.propagateToDCA(pvVtx, simConfig.dBz)) {
-        xPv = recoTrack.getX();
+      arrival.mass = pdgInfo->Mass();
+      arrival.status = TrackArrival::kOk;
+    }
+
+    const uint64_t eventKey = o2::upgrade::CounterBasedRandom::key(mcPvVtx.getX(), mcPvVtx.getY(), mcPvVtx.getZ(), collision.posZ(), eventCollisionTimePS, tracks.size());
+    o2::upgrade::parallelFor(trackArrivals.size(), simConfig.nThreads, [&](std::size_t begin, std::size_t end) {
+      for (std::size_t i = begin; i < end; i++) {
+        computeArrival(trackArrivals[i], pvVtx, mcPvVtx, eventCollisionTimePS, eventKey, i);
       }
-      if (xPv > kTrkXThreshold) {
-        trackLengthRecoInnerTOF = computeTrackLength(recoTrack, simConfig.innerTOFRadius, simConfig.dBz);
-        trackLengthRecoOuterTOF = computeTrackLength(recoTrack, simConfig.outerTOFRadius, simConfig.dBz);
+    });
+
+    for (const auto& arrival : trackArrivals) {
+      if (arrival.status != TrackArrival::kOk) {
+        upgradeTofMC(-999.f, -999.f, -999.f, -999.f);
+        continue;
       }
+      upgradeTofMC(arrival.expectedTimeInnerTOF, arrival.trackLengthInnerTOF, arrival.expectedTimeOuterTOF, arrival.trackLengthOuterTOF);
 
       // cache the track info needed for the event time calculation
       // Reuse or emplace a new object in the vector
-      tracksWithTime.emplace_back(TracksWithTime{mcParticle.pdgCode(),
-                                                 {measuredTimeInnerTOF, simConfig.innerTOFTimeReso},
-                                                 {measuredTimeOuterTOF, simConfig.outerTOFTimeReso},
-                                                 {trackLengthRecoInnerTOF, trackLengthInnerTOF},
-                                                 {trackLengthRecoOuterTOF, trackLengthOuterTOF},
-                                                 {recoTrack.getP(), recoTrack.getSigma1Pt2()},
-                                                 {recoTrack.getEta(), recoTrack.getSigmaTgl2()},
-                                                 o2track.getPt()});
+      tracksWithTime.emplace_back(TracksWithTime{arrival.pdgCode,
+                                                 {arrival.measuredTimeInnerTOF, simConfig.innerTOFTimeReso},
+                                                 {arrival.measuredTimeOuterTOF, simConfig.outerTOFTimeReso},
+                                                 {arrival.trackLengthRecoInnerTOF, arrival.trackLengthInnerTOF},
+                                                 {arrival.trackLengthRecoOuterTOF, arrival.trackLengthOuterTOF},
+                                                 {arrival.recoTrack.getP(), arrival.recoTrack.getSigma1Pt2()},
+                                                 {arrival.recoTrack.getEta(), arrival.recoTrack.getSigmaTgl2()},
+                                                 arrival.mcTrack.getPt()});
     }
 
     // Now we compute the event time for the tracks
@@ -639,8 +777,8 @@ struct OnTheFlyTofPid {
             ptResolution = mSmearer.getAbsPtRes(pdgInfoThis->PdgCode(), dNdEta, pseudorapidity, momentum / std::cosh(pseudorapidity));
             etaResolution = mSmearer.getAbsEtaRes(pdgInfoThis->PdgCode(), dNdEta, pseudorapidity, momentum / std::cosh(pseudorapidity));
           }
-          float innerTrackTimeReso = calculateTrackTimeResolutionAdvanced(momentum / std::cosh(pseudorapidity), pseudorapidity, ptResolution, etaResolution, masses[ii], simConfig.innerTOFRadius, simConfig.dBz);
-          float outerTrackTimeReso = calculateTrackTimeResolutionAdvanced(momentum / std::cosh(pseudorapidity), pseudorapidity, ptResolution, etaResolution, masses[ii], simConfig.outerTOFRadius, simConfig.dBz);
+          float innerTrackTimeReso = trackTimeResolution(momentum / std::cosh(pseudorapidity), pseudorapidity, ptResolution, etaResolution, ii, masses[ii], 0);
+          float outerTrackTimeReso = trackTimeResolution(momentum / std::cosh(pseudorapidity), pseudorapidity, ptResolution, etaResolution, ii, masses[ii], 1);
           innerTotalTimeReso = std::hypot(simConfig.innerTOFTimeReso, innerTrackTimeReso);
           outerTotalTimeReso = std::hypot(simConfig.outerTOFTimeReso, outerTrackTimeReso);
 
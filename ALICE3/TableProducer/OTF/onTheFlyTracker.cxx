@@ -54,8 +54,12 @@
 #include <TPDGCode.h>
 #include <TRandom3.h>
 
+#include <algorithm>
 #include <array>
+#include <cstdint>
+#include <future>
 #include <map>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -95,6 +99,7 @@ struct OnTheFlyTracker {
   Configurable<bool> enableNucleiSmearing{"enableNucleiSmearing", false, "Enable smearing of nuclei"};
   Configurable<bool> enablePrimaryVertexing{"enablePrimaryVertexing", true, "Enable primary vertexing"};
   Configurable<bool> interpolateLutEfficiencyVsNch{"interpolateLutEfficiencyVsNch", true, "interpolate LUT efficiency as f(Nch)"};
+  Configurable<int> nSmearingThreads{"nSmearingThreads", 0, "number of threads smearing the primaries of a collision (0: serial). If > 0, each particle is smeared with its own random stream, the result does not depend on the number of threads"};
 
   Configurable<bool> populateTracksDCA{"populateTracksDCA", true, "populate TracksDCA table"};
   Configurable<bool> populateTracksDCACov{"populateTracksDCACov", false, "populate TracksDCACov table"};
@@ -161,6 +166,7 @@ struct OnTheFlyTracker {
 
   // FastTracker machinery
   o2::fastsim::FastTracker fastTracker;
+  o2::fastsim::FastTrackContext fastTrackContext;
 
   // Class to hold the track information for the O2 vertexing
   class TrackAlice3 : public o2::track::TrackParCov
@@ -240,6 +246,65 @@ struct OnTheFlyTracker {
   // For TGenPhaseSpace seed
   TRandom3 rand;
 
+  // For the smearing with one random stream per particle
+  struct SmearedTrack {
+    int64_t mcLabel;
+    int pdgCode;
+    o2::track::TrackParCov trackParCov;
+    bool reconstructed = true;
+  };
+  std::vector<SmearedTrack> smearedTracks;                // primaries of the collision, in the order of the particle loop
+  std::vector<std::unique_ptr<TRandom3>> smearingRandoms; // one per thread
+  TRandom3 particleRandom;
+
+  /// seed of the random stream of a particle
+  uint64_t getParticleSeed(int64_t mcCollisionIndex, int64_t mcParticleIndex) const
+  {
+    // splitmix64 of the configured seed and of the indices
+    uint64_t x = static_cast<uint64_t>(seed.value) ^ (static_cast<uint64_t>(mcCollisionIndex) << 32) ^ static_cast<uint64_t>(mcParticleIndex);
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x ? x : 1; // 0 would seed TRandom3 from the time
+  }
+
+  /// smear the primaries of a collision concurrently, before the serial particle loop
+  void smearPrimaries(aod::McCollision const& mcCollision, aod::McParticles const& mcParticles)
+  {
+    smearedTracks.clear();
+    for (const auto& mcParticle : mcParticles) {
+      // same selection as in the particle loop, up to the smearing
+      const auto pdg = std::abs(mcParticle.pdgCode());
+      if (!mcParticle.isPhysicalPrimary() || (pdg != kElectron && pdg != kMuonMinus && pdg != kPiPlus && pdg != kKPlus && pdg != kProton)) {
+        continue;
+      }
+      if (std::fabs(mcParticle.eta()) > maxEta || mcParticle.pt() < minPt) {
+        continue;
+      }
+      SmearedTrack smearedTrack{mcParticle.globalIndex(), mcParticle.pdgCode()};
+      o2::upgrade::convertMCParticleToO2Track(mcParticle, smearedTrack.trackParCov, pdgDB);
+      smearedTracks.push_back(smearedTrack);
+    }
+
+    const int nWorkers = std::min<int>(smearingRandoms.size(), smearedTracks.size());
+    const int64_t mcCollisionIndex = mcCollision.globalIndex();
+    std::vector<std::future<void>> workers;
+    for (int iWorker = 0; iWorker < nWorkers; iWorker++) {
+      workers.push_back(std::async(std::launch::async, [this, iWorker, nWorkers, mcCollisionIndex]() {
+        TRandom3& random = *smearingRandoms[iWorker];
+        for (size_t i = iWorker; i < smearedTracks.size(); i += nWorkers) {
+          auto& smearedTrack = smearedTracks[i];
+          random.SetSeed(getParticleSeed(mcCollisionIndex, smearedTrack.mcLabel));
+          smearedTrack.reconstructed = mSmearer.smearTrack(smearedTrack.trackParCov, smearedTrack.pdgCode, dNdEta, &random);
+        }
+      }));
+    }
+    for (auto& worker : workers) {
+      worker.get();
+    }
+  }
+
   void init(o2::framework::InitContext&)
   {
     if (enableLUT) {
@@ -432,6 +497,10 @@ struct OnTheFlyTracker {
 
     // print fastTracker settings
     fastTracker.Print();
+
+    for (int i = 0; i < nSmearingThreads; i++) {
+      smearingRandoms.push_back(std::make_unique<TRandom3>());
+    }
   }
 
   /// Function to decay the xi
@@ -538,6 +607,12 @@ struct OnTheFlyTracker {
     histos.fill(HIST("hLUTMultiplicity"), dNdEta);
     gRandom->SetSeed(seed);
 
+    const bool smearWithParticleStreams = nSmearingThreads > 0;
+    size_t nextSmearedTrack = 0;
+    if (smearWithParticleStreams && enablePrimarySmearing) {
+      smearPrimaries(mcCollision, mcParticles);
+    }
+
     for (const auto& mcParticle : mcParticles) {
       double xiDecayRadius2D = 0;
       double laDecayRadius2D = 0;
@@ -615,6 +690,12 @@ struct OnTheFlyTracker {
         if (xiDecayRadius2D > 20) {
           continue;
         }
+        TRandom* xiRandom = gRandom;
+        if (smearWithParticleStreams) {
+          particleRandom.SetSeed(getParticleSeed(mcCollision.globalIndex(), mcParticle.globalIndex()));
+          xiRandom = &particleRandom;
+        }
+        fastTrackContext.random = xiRandom;
 
         o2::upgrade::convertTLorentzVectorToO2Track(-211, decayProducts[0], xiDecayVertex, xiDaughterTrackParCovsPerfect[0], pdgDB);
         o2::upgrade::convertTLorentzVectorToO2Track(-211, decayProducts[1], laDecayVertex, xiDaughterTrackParCovsPerfect[1], pdgDB);
@@ -626,9 +707,9 @@ struct OnTheFlyTracker {
           nSiliconHits[i] = 0;
           nTPCHits[i] = 0;
           if (enableSecondarySmearing) {
-            nHits[i] = fastTracker.FastTrack(xiDaughterTrackParCovsPerfect[i], xiDaughterTrackParCovsTracked[i], dNdEta);
-            nSiliconHits[i] = fastTracker.GetNSiliconPoints();
-            nTPCHits[i] = fastTracker.GetNGasPoints();
+            nHits[i] = fastTracker.FastTrack(xiDaughterTrackParCovsPerfect[i], xiDaughterTrackParCovsTracked[i], dNdEta, fastTrackContext);
+            nSiliconHits[i] = fastTrackContext.nSiliconPoints;
+            nTPCHits[i] = fastTrackContext.nGasPoints;
 
             if (nHits[i] < 0) { // QA
               histos.fill(HIST("hFastTrackerQA"), o2::math_utils::abs(nHits[i]));
@@ -639,8 +720,8 @@ struct OnTheFlyTracker {
             } else {
               continue; // extra sure
             }
-            for (uint32_t ih = 0; ih < fastTracker.GetNHits(); ih++) {
-              histos.fill(HIST("hFastTrackerHits"), fastTracker.GetHitZ(ih), std::hypot(fastTracker.GetHitX(ih), fastTracker.GetHitY(ih)));
+            for (const auto& hit : fastTrackContext.hits) {
+              histos.fill(HIST("hFastTrackerHits"), hit[2], std::hypot(hit[0], hit[1]));
             }
           } else {
             isReco[i] = true;
@@ -806,10 +887,10 @@ struct OnTheFlyTracker {
                     o2::fastsim::DetLayer currentTrackingLayer = fastTracker.GetLayer(i);
 
                     if (currentTrackingLayer.getResolutionRPhi() > 1e-8 && currentTrackingLayer.getResolutionZ() > 1e-8) { // catch zero (though should not really happen...)
-                      phi = gRandom->Gaus(phi, std::asin(currentTrackingLayer.getResolutionRPhi() / r));
+                      phi = xiRandom->Gaus(phi, std::asin(currentTrackingLayer.getResolutionRPhi() / r));
                       posClusterCandidate[0] = r * std::cos(phi);
                       posClusterCandidate[1] = r * std::sin(phi);
-                      posClusterCandidate[2] = gRandom->Gaus(posClusterCandidate[2], currentTrackingLayer.getResolutionZ());
+                      posClusterCandidate[2] = xiRandom->Gaus(posClusterCandidate[2], currentTrackingLayer.getResolutionZ());
                     }
 
                     if (std::isnan(phi))
@@ -866,7 +947,15 @@ struct OnTheFlyTracker {
 
       bool reconstructed = true;
       if (enablePrimarySmearing) {
-        reconstructed = mSmearer.smearTrack(trackParCov, mcParticle.pdgCode(), dNdEta);
+        if (smearWithParticleStreams) {
+          while (smearedTracks[nextSmearedTrack].mcLabel != mcParticle.globalIndex()) {
+            nextSmearedTrack++;
+          }
+          trackParCov = smearedTracks[nextSmearedTrack].trackParCov;
+          reconstructed = smearedTracks[nextSmearedTrack].reconstructed;
+        } else {
+          reconstructed = mSmearer.smearTrack(trackParCov, mcParticle.pdgCode(), dNdEta);
+        }
       }
 
       if (!reconstructed && !processUnreconstructedTracks) {
@@ -1110,8 +1199,8 @@ struct OnTheFlyTracker {
     }
 
     // do bookkeeping of fastTracker tracking
-    histos.fill(HIST("hCovMatOK"), 0.0f, fastTracker.GetCovMatNotOK());
-    histos.fill(HIST("hCovMatOK"), 1.0f, fastTracker.GetCovMatOK());
+    histos.fill(HIST("hCovMatOK"), 0.0f, fastTrackContext.covMatNotOK);
+    histos.fill(HIST("hCovMatOK"), 1.0f, fastTrackContext.covMatOK);
   } // end process
 };
 
@@ -24,6 +24,7 @@
 #include <map>
 #include <string>
 #include <algorithm>
+#include <random>
 #include <vector>
 
 #include "Framework/AnalysisDataModel.h"
@@ -36,6 +37,8 @@
 #include "Common/DataModel/TrackSelectionTables.h"
 #include "Common/Core/trackUtilities.h"
 #include "ALICE3/Core/TrackUtilities.h"
+#include "ALICE3/Core/CounterBasedRandom.h"
+#include "ALICE3/Core/ParallelFor.h"
 #include "ReconstructionDataFormats/DCA.h"
 #include "DetectorsBase/Propagator.h"
 #include "DetectorsBase/GeometryManager.h"
@@ -46,7 +49,6 @@
 #include "DataFormatsCalibration/MeanVertexObject.h"
 #include "CommonConstants/GeomConstants.h"
 #include "CommonConstants/PhysicsConstants.h"
-#include "TRandom3.h"
 #include "TF1.h"
 #include "TH2F.h"
 #include "TVector3.h"
@@ -74,6 +76,8 @@ struct OnTheFlyTrackerPid {
     Configurable<std::string> efficiencyFormula{"efficiencyFormula", "1.0/(1.0+exp(-(x-0.01)/0.2))", "ROOT TF1 formula for efficiency"};
     Configurable<std::string> landauFormula{"landauFormula", "TMath::Landau(x, 1, 1, true)", "ROOT TF1 formula for Landau distribution (e.g. ToT response)"};
     Configurable<int> averageMethod{"averageMethod", 0, "Method to average the ToT and cluster size. 0: truncated mean"};
+    Configurable<int> randomSeed{"randomSeed", 0, "seed of the signal simulation (0: different at every run)"};
+    Configurable<int> nThreads{"nThreads", 1, "number of threads simulating the signals of the tracks of a collision"};
   } simConfig;
 
   TF1* mEfficiency = nullptr;
@@ -86,42 +90,104 @@ struct OnTheFlyTrackerPid {
 
   std::array<std::array<TF1*, kPtBins>, kEtaBins> mElossPi;
 
+  // Thread-safe samplers of the energy loss distributions, random numbers keyed by collision and track
+  std::array<std::array<o2::upgrade::TabulatedDistribution, kPtBins>, kEtaBins> mElossPiSampler;
+  o2::upgrade::CounterBasedRandom mRandom;
+
+  /// Signals of a track, computed from this track only
+  struct TrackSignal {
+    bool valid = false;
+    int binnedEta = 0;
+    int binnedPt = 0;
+    float efficiency = 0.f;
+    float meanToT = 0.f;
+    float meanClusterSize = 0.f;
+  };
+  std::vector<TrackSignal> trackSignals;
+
   void init(o2::framework::InitContext&)
   {
 
     for (int i = 0; i < kEtaBins; i++) {
       for (int j = 0; j < kPtBins; j++) {
         mElossPi[i][j] = new TF1(Form("mElossPi_%d_%d", i, j), simConfig.landauFormula.value.c_str(), 0, 20);
+        mElossPiSampler[i][j].tabulate([&](double x) { return mElossPi[i][j]->Eval(x); }, mElossPi[i][j]->GetXmin(), mElossPi[i][j]->GetXmax(), mElossPi[i][j]->GetNpx());
       }
     }
     mEfficiency = new TF1("mEfficiency", simConfig.efficiencyFormula.value.c_str(), 0, 20);
+    mRandom.setSeed(simConfig.randomSeed.value != 0 ? simConfig.randomSeed.value : std::random_device{}()); // 0: fully randomize
   }
 
-  void process(soa::Join<aod::Collisions, aod::McCollisionLabels>::iterator const&,
-               soa::Join<aod::Tracks, aod::TracksCov, aod::McTrackLabels> const& tracks,
-               aod::McParticles const&,
-               aod::McCollisions const&)
+  /// Simulates the layer signals and averages them; thread safe
+  void computeSignal(TrackSignal& signal, uint64_t eventKey, uint32_t trackKey) const
   {
+    if (!signal.valid) {
+      return;
+    }
     std::array<float, kMaxBarrelLayers> timeOverThresholdBarrel;
     std::array<float, kMaxBarrelLayers> clusterSizeBarrel;
     // std::array<float, kMaxForwardLayers> timeOverThresholdForward;
     // std::array<float, kMaxForwardLayers> clusterSizeForward;
+    const auto& sampler = mElossPiSampler[signal.binnedEta][signal.binnedPt];
+    for (int i = 0; i < kMaxBarrelLayers; i++) {
+      timeOverThresholdBarrel[i] = -1;
+      clusterSizeBarrel[i] = -1;
+
+      // Check if layer is efficient
+      const auto words = mRandom.generate(eventKey, trackKey, i);
+      if (signal.efficiency > o2::upgrade::CounterBasedRandom::toUniform(words[0])) {
+        timeOverThresholdBarrel[i] = sampler.sample(o2::upgrade::CounterBasedRandom::toUniform(words[1])); // Simulate ToT
+        clusterSizeBarrel[i] = sampler.sample(o2::upgrade::CounterBasedRandom::toUniform(words[2]));       // Simulate cluster size
+      }
+    }
+
+    // Now we do the average
+    switch (simConfig.averageMethod.value) {
+      case 0: { // truncated mean
+        float meanToT = 0;
+        float meanClusterSize = 0;
+        // Order them by ToT
+        std::sort(timeOverThresholdBarrel.begin(), timeOverThresholdBarrel.end());
+        std::sort(clusterSizeBarrel.begin(), clusterSizeBarrel.end());
+        static constexpr int kTruncatedMean = 5;
+        // Take the mean of the first 5 values
+        for (int i = 0; i < kTruncatedMean; i++) {
+          meanToT += timeOverThresholdBarrel[i];
+          meanClusterSize += clusterSizeBarrel[i];
+        }
+        signal.meanToT = meanToT / kTruncatedMean;
+        signal.meanClusterSize = meanClusterSize / kTruncatedMean;
+      } break;
+
+      default:
+        LOG(fatal) << "Unknown average method " << simConfig.averageMethod.value;
+        break;
+    }
+  }
 
+  void process(soa::Join<aod::Collisions, aod::McCollisionLabels>::iterator const& collision,
+               soa::Join<aod::Tracks, aod::TracksCov, aod::McTrackLabels> const& tracks,
+               aod::McParticles const&,
+               aod::McCollisions const&)
+  {
     auto noSignalTrack = [&]() {
       tableUpgradeTrkPidSignals(0.f, 0.f);          // no PID information
       tableUpgradeTrkPids(0.f, 0.f, 0.f, 0.f, 0.f); // no PID information
     };
 
+    // The efficiencies are evaluated serially (TF1), the layer signals by chunks of tracks in parallel
+    trackSignals.resize(tracks.size());
+    std::size_t iTrack = 0;
     for (const auto& track : tracks) {
+      auto& signal = trackSignals[iTrack++];
+      signal.valid = false;
       if (!track.has_mcParticle()) {
-        noSignalTrack();
         continue;
       }
       const auto& mcParticle = track.mcParticle();
       const auto& pdgInfo = pdg->GetParticle(mcParticle.pdgCode());
       if (!pdgInfo) {
         LOG(warning) << "PDG code " << mcParticle.pdgCode() << " not found in the database";
-        noSignalTrack();
         continue;
       }
       const float pt = mcParticle.pt();
@@ -130,44 +196,28 @@ struct OnTheFlyTrackerPid {
       const int binnedPt = static_cast<int>((pt - kPtMin) / kPtBins);
       const int binnedEta = static_cast<int>((eta - kEtaMin) / kEtaBins);
       if (binnedPt < 0 || binnedPt >= kPtBins || binnedEta < 0 || binnedEta >= kEtaBins) {
-        noSignalTrack();
         continue;
       }
-      for (int i = 0; i < kMaxBarrelLayers; i++) {
-        timeOverThresholdBarrel[i] = -1;
-        clusterSizeBarrel[i] = -1;
-
-        // Check if layer is efficient
-        if (mEfficiency->Eval(pt) > gRandom->Uniform(0, 1)) {
-          timeOverThresholdBarrel[i] = mElossPi[binnedEta][binnedPt]->GetRandom(); // Simulate ToT
-          clusterSizeBarrel[i] = mElossPi[binnedEta][binnedPt]->GetRandom();       // Simulate cluster size
-        }
+      signal.binnedPt = binnedPt;
+      signal.binnedEta = binnedEta;
+      signal.efficiency = mEfficiency->Eval(pt);
+      signal.valid = true;
+    }
+
+    const uint64_t eventKey = o2::upgrade::CounterBasedRandom::key(collision.posX(), collision.posY(), collision.posZ(), collision.collisionTime(), tracks.size());
+    o2::upgrade::parallelFor(trackSignals.size(), simConfig.nThreads, [&](std::size_t begin, std::size_t end) {
+      for (std::size_t i = begin; i < end; i++) {
+        computeSignal(trackSignals[i], eventKey, i);
       }
+    });
 
-      // Now we do the average
-      switch (simConfig.averageMethod) {
-        case 0: { // truncated mean
-          float meanToT = 0;
-          float meanClusterSize = 0;
-          // Order them by ToT
-          std::sort(timeOverThresholdBarrel.begin(), timeOverThresholdBarrel.end());
-          std::sort(clusterSizeBarrel.begin(), clusterSizeBarrel.end());
-          static constexpr int kTruncatedMean = 5;
-          // Take the mean of the first 5 values
-          for (int i = 0; i < kTruncatedMean; i++) {
-            meanToT += timeOverThresholdBarrel[i];
-            meanClusterSize += clusterSizeBarrel[i];
-          }
-          meanToT /= kTruncatedMean;
-          meanClusterSize /= kTruncatedMean;
-          // Fill the table
-          tableUpgradeTrkPidSignals(meanToT, meanClusterSize);
-        } break;
-
-        default:
-          LOG(fatal) << "Unknown average method " << simConfig.averageMethod;
-          break;
+    for (const auto& signal : trackSignals) {
+      if (!signal.valid) {
+        noSignalTrack();
+        continue;
       }
+      // Fill the table
+      tableUpgradeTrkPidSignals(signal.meanToT, signal.meanClusterSize);
     }
   }
 };
@@ -14,6 +14,8 @@
 ///
 /// \author Fabio Colamaria <fabio.colamaria@ba.infn.it>, INFN Bari
 
+#include <algorithm>
+#include <cmath>
 #include <vector>
 
 #include "CommonConstants/PhysicsConstants.h"
@@ -87,6 +89,30 @@ struct alice3correlatorddbar {
 
   // HfHelper hfHelper; //not needed for now
 
+  // selected candidates of the collision in flat arrays, for the pair loop of processDataPool
+  struct {
+    std::vector<float> pt;
+    std::vector<float> eta;
+    std::vector<float> phi;
+    std::vector<float> m;
+    std::vector<int> isSelD0;
+    std::vector<int> isSelD0bar;
+
+    void clear()
+    {
+      pt.clear();
+      eta.clear();
+      phi.clear();
+      m.clear();
+      isSelD0.clear();
+      isSelD0bar.clear();
+    }
+  } candidatePool;
+
+  // thresholds of hDDbarVsEtaCut, in the order of the loops of processData
+  std::vector<double> etaCutValues;
+  std::vector<double> ptCutValues;
+
   Partition<soa::Join<aod::Alice3D0Meson, aod::Alice3D0Sel>> selectedCandidates = aod::a3D0meson::y > -yCandMax&& aod::a3D0meson::y<yCandMax && aod::a3D0meson::pt> ptCandMin && (aod::a3D0Selection::isSelD0 >= selectionFlagD0 || aod::a3D0Selection::isSelD0bar >= selectionFlagD0bar);
   Partition<soa::Join<aod::Alice3D0Meson, aod::Alice3D0Sel, aod::Alice3D0MCTruth>> selectedCandidatesMC = aod::a3D0meson::y > -yCandMax&& aod::a3D0meson::y<yCandMax && aod::a3D0meson::pt> ptCandMin && (aod::a3D0Selection::isSelD0 >= selectionFlagD0 || aod::a3D0Selection::isSelD0bar >= selectionFlagD0bar);
 
@@ -121,6 +147,17 @@ struct alice3correlatorddbar {
     registry.add("hMassD0barMCRecSig", "D0bar signal candidates - MC reco;inv. mass D0bar only (#pi K) (GeV/#it{c}^{2});entries", {HistType::kTH2F, {{massAxisBins, massAxisMin, massAxisMax}, {vbins, "#it{p}_{T} (GeV/#it{c})"}}});
     registry.add("hMassD0barMCRecRefl", "D0bar reflection candidates - MC reco;inv. mass D0bar only (#pi K) (GeV/#it{c}^{2});entries", {HistType::kTH2F, {{massAxisBins, massAxisMin, massAxisMax}, {vbins, "#it{p}_{T} (GeV/#it{c})"}}});
     registry.add("hMassD0barMCRecBkg", "D0bar background candidates - MC reco;inv. mass D0bar only (#pi K) (GeV/#it{c}^{2});entries", {HistType::kTH2F, {{massAxisBins, massAxisMin, massAxisMax}, {vbins, "#it{p}_{T} (GeV/#it{c})"}}});
+
+    double etaCut = 0.;
+    do {
+      etaCut += incrementEtaCut;
+      etaCutValues.push_back(etaCut);
+    } while (etaCut < maxEtaCut - epsilon);
+    double ptCut = 0.;
+    do {
+      ptCutValues.push_back(ptCut);
+      ptCut += incrementPtThreshold;
+    } while (ptCut < ptThresholdForMaxEtaCut - epsilon);
   }
 
   /// D0-D0bar correlation pair builder - for real data and data-like analysis (i.e. reco-level w/o matching request via MC truth)
@@ -198,6 +235,87 @@ struct alice3correlatorddbar {
 
   PROCESS_SWITCH(alice3correlatorddbar, processData, "Process data", true);
 
+  /// D0-D0bar correlation pair builder as processData, with the candidates of the collision first copied into flat arrays
+  void processDataPool(aod::Collision const& collision,
+                       soa::Join<aod::Alice3D0Meson, aod::Alice3D0Sel> const&)
+  {
+    auto selectedCandidatesGrouped = selectedCandidates->sliceByCached(aod::a3D0meson::collisionId, collision.globalIndex(), cache);
+
+    candidatePool.clear();
+    for (const auto& candidate : selectedCandidatesGrouped) {
+      double efficiencyWeight = 1.;
+      if (applyEfficiency) {
+        efficiencyWeight = 1. / efficiencyD->at(o2::analysis::findBin(binsPt, candidate.pt()));
+      }
+
+      // fill invariant mass plots and generic info from all D0/D0bar candidates
+      if (candidate.isSelD0() >= selectionFlagD0) {
+        registry.fill(HIST("hMass"), candidate.m(), candidate.pt(), efficiencyWeight);
+        registry.fill(HIST("hMassD0"), candidate.m(), candidate.pt(), efficiencyWeight);
+      }
+      if (candidate.isSelD0bar() >= selectionFlagD0bar) {
+        registry.fill(HIST("hMass"), candidate.m(), candidate.pt(), efficiencyWeight);
+        registry.fill(HIST("hMassD0bar"), candidate.m(), candidate.pt(), efficiencyWeight);
+      }
+      registry.fill(HIST("hPtCand"), candidate.pt());
+      registry.fill(HIST("hPtProng0"), candidate.ptProng0());
+      registry.fill(HIST("hPtProng1"), candidate.ptProng1());
+      registry.fill(HIST("hEta"), candidate.eta());
+      registry.fill(HIST("hPhi"), candidate.phi());
+      registry.fill(HIST("hY"), candidate.y());
+      registry.fill(HIST("hSelectionStatus"), candidate.isSelD0() + (candidate.isSelD0bar() * 2));
+
+      candidatePool.pt.push_back(candidate.pt());
+      candidatePool.eta.push_back(candidate.eta());
+      candidatePool.phi.push_back(candidate.phi());
+      candidatePool.m.push_back(candidate.m());
+      candidatePool.isSelD0.push_back(candidate.isSelD0());
+      candidatePool.isSelD0bar.push_back(candidate.isSelD0bar());
+    }
+
+    // D-Dbar correlation dedicated section
+    const std::size_t nCandidates = candidatePool.pt.size();
+    for (std::size_t i1 = 0; i1 < nCandidates; i1++) {
+      if (candidatePool.isSelD0[i1] < selectionFlagD0) {
+        continue;
+      }
+      for (std::size_t i2 = 0; i2 < nCandidates; i2++) {
+        if (candidatePool.isSelD0bar[i2] < selectionFlagD0bar) { // keep only D0bar candidates passing the selection
+          continue;
+        }
+        if (i1 == i2) {
+          continue;
+        }
+        if ((candidatePool.pt[i1] - candidatePool.pt[i2]) < 1e-5 && (candidatePool.eta[i1] - candidatePool.eta[i2]) < 1e-5 && (candidatePool.phi[i1] - candidatePool.phi[i2]) < 1e-5) { // same condition as in processData
+          continue;
+        }
+        entryD0D0barPair(getDeltaPhi(candidatePool.phi[i2], candidatePool.phi[i1]),
+                         candidatePool.eta[i2] - candidatePool.eta[i1],
+                         candidatePool.pt[i1],
+                         candidatePool.pt[i2]);
+        entryD0D0barRecoInfo(candidatePool.m[i1], // mD0
+                             candidatePool.m[i2], // mD0bar
+                             0);
+        // pairs vs etaCut plot: the eta condition holds from the first eta cut above both |eta|, the pT one up to the last pT cut below both pT
+        const double absEtaMax = std::max(std::abs(candidatePool.eta[i1]), std::abs(candidatePool.eta[i2]));
+        const double ptMin = std::min(candidatePool.pt[i1], candidatePool.pt[i2]);
+        for (const double etaCut : etaCutValues) {
+          if (absEtaMax >= etaCut) {
+            continue;
+          }
+          for (const double ptCut : ptCutValues) {
+            if (ptMin <= ptCut) {
+              break;
+            }
+            registry.fill(HIST("hDDbarVsEtaCut"), etaCut - epsilon, ptCut + epsilon);
+          }
+        }
+      } // end inner loop (Dbars)
+    } // end outer loop
+  }
+
+  PROCESS_SWITCH(alice3correlatorddbar, processDataPool, "Process data, with the candidates copied into flat arrays", false);
+
   /// D0-D0bar correlation pair builder - for MC reco-level analysis (candidates matched to true signal only, but also the various bkg sources are studied)
   void processMcRec(aod::Collision const& collision,
                     soa::Join<aod::Alice3D0Meson, aod::Alice3D0Sel, aod::Alice3D0MCTruth> const&)
@@ -46,6 +46,8 @@
 #include "ALICE3/DataModel/OTFTOF.h"
 #include "ALICE3/DataModel/RICH.h"
 #include "ALICE3/DataModel/A3DecayFinderTables.h"
+#include "ALICE3/Core/MulticharmFinder.h"
+#include "ALICE3/Core/TwoProngPrefilter.h"
 
 using namespace o2;
 using namespace o2::framework;
@@ -113,6 +115,11 @@ struct alice3decayFinder {
   Configurable<float> prFromLc_dcaXYconstant{"prFromLc_dcaXYconstant", -1.0f, "[0] in |DCAxy| > [0]+[1]/pT"};
   Configurable<float> prFromLc_dcaXYpTdep{"prFromLc_dcaXYpTdep", 0.0, "[1] in |DCAxy| > [0]+[1]/pT"};
 
+  // prefilters of the D0 pairs before the vertex fit, from the track momenta and positions at the DCA to the PV
+  Configurable<float> dMassMinPrefit{"dMassMinPrefit", -1.0f, "Minimum pair mass before the fit (GeV/c^2, negative: not applied)"};
+  Configurable<float> dMassMaxPrefit{"dMassMaxPrefit", -1.0f, "Maximum pair mass before the fit (GeV/c^2, negative: not applied)"};
+  Configurable<float> dMaxDeltaZPrefit{"dMaxDeltaZPrefit", -1.0f, "Maximum distance in z of the daughters at their DCA to the PV (cm, negative: not applied)"};
+
   Configurable<float> lowPtDLimit{"lowPtDLimit", 3.5, "Upper boundary of low pT D range, for topological selection (GeV/c)"};
   Configurable<float> highPtDLimit{"highPtDLimit", 16, "Upper boundary of high pT D range, for topological selection (GeV/c)"};
 
@@ -204,6 +211,14 @@ struct alice3decayFinder {
     float eta;
   } lcbaryon;
 
+  // MC mothers of the dataframe, for the same-mother checks
+  o2::upgrade::McAncestry mcAncestry;
+
+  // daughter candidates of the collision and the pairs passing the prefilters
+  o2::upgrade::TwoProngPrefilter pairPrefilter;
+  o2::upgrade::TwoProngPrefilter::Block piPlusFromD, kaMinusFromD, kaPlusFromD, piMinusFromD;
+  std::vector<std::pair<int, int>> pairs;
+
   template <typename TTrackType>
   bool buildDecayCandidateTwoBody(TTrackType const& posTrackRow, TTrackType const& negTrackRow, float posMass, float negMass, aod::McParticles const& mcParticles)
   {
@@ -313,27 +328,11 @@ struct alice3decayFinder {
     return true;
   }
 
-  /// function to check if tracks have the same mother in MC
+  /// function to check if tracks have the same mother in MC, with the mothers of the dataframe cached in mcAncestry
   template <typename TTrackType>
   bool checkSameMother(TTrackType const& track1, TTrackType const& track2)
   {
-    bool returnValue = false;
-    // Association check
-    // There might be smarter ways of doing this in the future
-    if (track1.has_mcParticle() && track2.has_mcParticle()) {
-      auto mcParticle1 = track1.template mcParticle_as<aod::McParticles>();
-      auto mcParticle2 = track2.template mcParticle_as<aod::McParticles>();
-      if (mcParticle1.has_mothers() && mcParticle2.has_mothers()) {
-        for (auto& mcParticleMother1 : mcParticle1.template mothers_as<aod::McParticles>()) {
-          for (auto& mcParticleMother2 : mcParticle2.template mothers_as<aod::McParticles>()) {
-            if (mcParticleMother1.globalIndex() == mcParticleMother2.globalIndex()) {
-              returnValue = true;
-            }
-          }
-        }
-      }
-    } // end association check
-    return returnValue;
+    return mcAncestry.shareMother(track1.mcParticleId(), track2.mcParticleId());
   }
 
   void init(InitContext&)
@@ -361,6 +360,9 @@ struct alice3decayFinder {
     fitter3.setBz(magneticField);
     fitter3.setMatCorrType(o2::base::Propagator::MatCorrType::USEMatCorrNONE);
 
+    pairPrefilter.setMassWindow(dMassMinPrefit, dMassMaxPrefit);
+    pairPrefilter.setMaxDeltaZ(dMaxDeltaZPrefit);
+
     if (doprocessFindDmesons) {
       histos.add("h2dGenD", "h2dGenD", kTH2F, {axisPt, axisEta});
       histos.add("h2dGenD_KpiOnly", "h2dGenD_KpiOnly", kTH2F, {axisPt, axisEta});
@@ -516,7 +518,7 @@ struct alice3decayFinder {
   }
 
   //*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*
-  void processFindDmesons(aod::Collision const& collision, alice3tracks const&, aod::McParticles const& mcParticles)
+  void processFindDmesons(aod::Collision const& collision, alice3tracks const& tracks, aod::McParticles const& mcParticles)
   {
     // group with this collision
     auto tracksPiPlusFromDgrouped = tracksPiPlusFromD->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache);
@@ -535,305 +537,317 @@ struct alice3decayFinder {
         histos.fill(HIST("h2dDCAxyVsPtKaMinusFromD"), track.pt(), track.dcaXY() * 1e+4);
     }
 
-    // D0 mesons
-    for (auto const& posTrackRow : tracksPiPlusFromDgrouped) {
-      for (auto const& negTrackRow : tracksKaMinusFromDgrouped) {
-
-        if (mcSameMotherCheck && !checkSameMother(posTrackRow, negTrackRow))
-          continue;
-        if (!buildDecayCandidateTwoBody(posTrackRow, negTrackRow, o2::constants::physics::MassPionCharged, o2::constants::physics::MassKaonCharged, mcParticles))
-          continue;
-
-        dmeson.cosPA = RecoDecay::cpa(std::array{collision.posX(), collision.posY(), collision.posZ()}, std::array{dmeson.posSV[0], dmeson.posSV[1], dmeson.posSV[2]}, std::array{dmeson.P[0], dmeson.P[1], dmeson.P[2]});
-        dmeson.cosPAxy = RecoDecay::cpaXY(std::array{collision.posX(), collision.posY(), collision.posZ()}, std::array{dmeson.posSV[0], dmeson.posSV[1], dmeson.posSV[2]}, std::array{dmeson.P[0], dmeson.P[1], dmeson.P[2]});
-
-        const float dmesonCtau = 0.012301;
-        dmeson.normalizedDecayLength = ((dmeson.mass * std::fabs(std::hypot(collision.posX(), collision.posY(), collision.posZ()) - std::hypot(dmeson.posSV[0], dmeson.posSV[1], dmeson.posSV[2]))) / std::hypot(dmeson.P[0], dmeson.P[1], dmeson.P[2])) / dmesonCtau;
-
-        auto impParXY_daugPos = RecoDecay::impParXY(std::array{collision.posX(), collision.posY(), collision.posZ()}, std::array{dmeson.posSV[0], dmeson.posSV[1], dmeson.posSV[2]}, std::array{dmeson.Pdaug[0], dmeson.Pdaug[1], dmeson.Pdaug[2]});
-        auto impParXY_daugNeg = RecoDecay::impParXY(std::array{collision.posX(), collision.posY(), collision.posZ()}, std::array{dmeson.posSV[0], dmeson.posSV[1], dmeson.posSV[2]}, std::array{dmeson.Ndaug[0], dmeson.Ndaug[1], dmeson.Ndaug[2]});
-        auto decayLength = std::hypot(collision.posX() - dmeson.posSV[0], collision.posY() - dmeson.posSV[1], collision.posZ() - dmeson.posSV[2]);
-        auto decayLengthXY = std::hypot(collision.posX() - dmeson.posSV[0], collision.posY() - dmeson.posSV[1]);
-
-        // fill plots of topological variables before topological selection
-        histos.fill(HIST("hDCosPA"), dmeson.cosPA);
-        histos.fill(HIST("hDCosPAxy"), dmeson.cosPAxy);
-        histos.fill(HIST("hDCosThetaStar"), dmeson.cosThetaStar);
-        histos.fill(HIST("hDDecayLength"), decayLength);
-        histos.fill(HIST("hDDecayLengthXY"), decayLengthXY);
-        histos.fill(HIST("hDNormDecayLength"), dmeson.normalizedDecayLength);
-        histos.fill(HIST("hImpParPi"), impParXY_daugPos);
-        histos.fill(HIST("hImpParK"), impParXY_daugNeg);
-        histos.fill(HIST("hImpParProduct"), impParXY_daugPos * impParXY_daugNeg);
-        if (doDCAplotsD)
-          histos.fill(HIST("hDCADDaughters"), dmeson.dcaDau * 1e+4);
-
-        if (doTopoPlotsForSAndB) {   // fill plots of topological variables for S and B separately (reflections not considered here)
-          if (dmeson.mcTruth == 1) { // true D0
-            histos.fill(HIST("hDCosPA_Signal"), dmeson.cosPA);
-            histos.fill(HIST("hDCosPAxy_Signal"), dmeson.cosPAxy);
-            histos.fill(HIST("hDCosThetaStar_Signal"), dmeson.cosThetaStar);
-            histos.fill(HIST("hDDecayLength_Signal"), decayLength);
-            histos.fill(HIST("hDDecayLengthXY_Signal"), decayLengthXY);
-            histos.fill(HIST("hDNormDecayLength_Signal"), dmeson.normalizedDecayLength);
-            histos.fill(HIST("hImpParPi_Signal"), impParXY_daugPos);
-            histos.fill(HIST("hImpParK_Signal"), impParXY_daugNeg);
-            histos.fill(HIST("hImpParProduct_Signal"), impParXY_daugPos * impParXY_daugNeg);
-            if (doDCAplotsD)
-              histos.fill(HIST("hDCADDaughters_Signal"), dmeson.dcaDau * 1e+4);
-          } else if (!dmeson.mcTruth) { // bkg D0
-            histos.fill(HIST("hDCosPA_Bkg"), dmeson.cosPA);
-            histos.fill(HIST("hDCosPAxy_Bkg"), dmeson.cosPAxy);
-            histos.fill(HIST("hDCosThetaStar_Bkg"), dmeson.cosThetaStar);
-            histos.fill(HIST("hDDecayLength_Bkg"), decayLength);
-            histos.fill(HIST("hDDecayLengthXY_Bkg"), decayLengthXY);
-            histos.fill(HIST("hDNormDecayLength_Bkg"), dmeson.normalizedDecayLength);
-            histos.fill(HIST("hImpParPi_Bkg"), impParXY_daugPos);
-            histos.fill(HIST("hImpParK_Bkg"), impParXY_daugNeg);
-            histos.fill(HIST("hImpParProduct_Bkg"), impParXY_daugPos * impParXY_daugNeg);
-            if (doDCAplotsD)
-              histos.fill(HIST("hDCADDaughters_Bkg"), dmeson.dcaDau * 1e+4);
-          }
-        }
-
-        if (dmeson.dcaDau > dcaDaughtersSelection)
-          continue;
-
-        if (dmeson.pt <= lowPtDLimit && dmeson.cosPA < DCosPA)
-          continue;
-        else if (dmeson.pt > lowPtDLimit && dmeson.cosPA < DCosPAHighPt)
-          continue;
-
-        if (dmeson.pt <= lowPtDLimit && dmeson.cosPAxy < DCosPAxy)
-          continue;
-        else if (dmeson.pt > lowPtDLimit && dmeson.cosPAxy < DCosPAxyHighPt)
-          continue;
-
-        if (dmeson.pt <= lowPtDLimit && std::fabs(dmeson.cosThetaStar) > DCosThetaStarLowPt)
-          continue;
-        else if (dmeson.pt <= highPtDLimit && std::fabs(dmeson.cosThetaStar) > DCosThetaStarHighPt)
-          continue;
-        else if (dmeson.pt > highPtDLimit && std::fabs(dmeson.cosThetaStar) > DCosThetaStarVHighPt)
-          continue;
-
-        if (dmeson.normalizedDecayLength < DMinNormDecayLength || dmeson.normalizedDecayLength > DMaxNormDecayLength)
-          continue;
-
-        if (dmeson.ptdaugPos < minPtPi) // track1 (positive) is the pion
-          continue;
-        if (dmeson.ptdaugNeg < minPtK) // track2 (negative) is the kaon
-          continue;
-
-        if (impParXY_daugPos > maxImpParPi)
-          continue;
-        if (impParXY_daugNeg > maxImpParK)
-          continue;
-        if (impParXY_daugPos * impParXY_daugNeg > maxImpParProduct)
-          continue;
-
-        if (decayLength < DMinDecayLength || decayLength > DMaxDecayLength)
-          continue;
-        if (decayLengthXY < DMinDecayLengthXY || decayLengthXY > DMaxDecayLengthXY)
-          continue;
-        auto decayLengthSquaredCut = std::min((std::hypot(dmeson.P[0], dmeson.P[1], dmeson.P[2]) * 0.0066) + 0.01, (double)DDecayLengthSquaredCut);
-        if (decayLength * decayLength < decayLengthSquaredCut * decayLengthSquaredCut)
-          continue;
+    if (mcSameMotherCheck && !mcAncestry.isBoundTo(mcParticles)) {
+      mcAncestry.build(mcParticles);
+    }
+    o2::upgrade::TwoProngPrefilter::fill(tracksPiPlusFromDgrouped, tracks.offset(), piPlusFromD);
+    o2::upgrade::TwoProngPrefilter::fill(tracksKaMinusFromDgrouped, tracks.offset(), kaMinusFromD);
+    o2::upgrade::TwoProngPrefilter::fill(tracksKaPlusFromDgrouped, tracks.offset(), kaPlusFromD);
+    o2::upgrade::TwoProngPrefilter::fill(tracksPiMinusFromDgrouped, tracks.offset(), piMinusFromD);
 
-        // fill plots of topological variables after topological selection
-        histos.fill(HIST("hDCosPA_Selected"), dmeson.cosPA);
-        histos.fill(HIST("hDCosPAxy_Selected"), dmeson.cosPAxy);
-        histos.fill(HIST("hDCosThetaStar_Selected"), dmeson.cosThetaStar);
-        histos.fill(HIST("hDDecayLength_Selected"), decayLength);
-        histos.fill(HIST("hDDecayLengthXY_Selected"), decayLengthXY);
-        histos.fill(HIST("hDNormDecayLength_Selected"), dmeson.normalizedDecayLength);
-        histos.fill(HIST("hImpParPi_Selected"), impParXY_daugPos);
-        histos.fill(HIST("hImpParK_Selected"), impParXY_daugNeg);
-        histos.fill(HIST("hImpParProduct_Selected"), impParXY_daugPos * impParXY_daugNeg);
-        if (doDCAplotsD)
-          histos.fill(HIST("hDCADDaughters_Selected"), dmeson.dcaDau * 1e+4);
-
-        // filling of mass plots for selected candidates
-        histos.fill(HIST("hMassD"), dmeson.mass);
-        histos.fill(HIST("h3dRecD"), dmeson.pt, dmeson.eta, dmeson.mass);
-        if (dmeson.mcTruth == 1) { // true D0 meson, reco as D0 (= correct matching)
-          histos.fill(HIST("h3dRecDSig"), dmeson.pt, dmeson.eta, dmeson.mass);
-          histos.fill(HIST("hMassDSig"), dmeson.mass);
-          histos.fill(HIST("hDRecForEfficiency"), dmeson.pt, dmeson.y); // for efficiency
-        } else if (dmeson.mcTruth == 2) {                               // true D0bar meson, reco as D0 (= reflection)
-          histos.fill(HIST("hMassDRefl"), dmeson.mass);
-          histos.fill(HIST("h3dRecDRefl"), dmeson.pt, dmeson.eta, dmeson.mass);
-        } else { // background, reco as D0
-          histos.fill(HIST("hMassDBkg"), dmeson.mass);
-          histos.fill(HIST("h3dRecDBkg"), dmeson.pt, dmeson.eta, dmeson.mass);
+    // D0 mesons
+    pairPrefilter.findPairs(piPlusFromD, kaMinusFromD, o2::constants::physics::MassPionCharged, o2::constants::physics::MassKaonCharged, pairs);
+    for (auto const& [iPos, iNeg] : pairs) {
+      if (mcSameMotherCheck && !mcAncestry.shareMother(piPlusFromD.mcParticle[iPos], kaMinusFromD.mcParticle[iNeg]))
+        continue;
+      auto posTrackRow = tracks.rawIteratorAt(piPlusFromD.row[iPos]);
+      auto negTrackRow = tracks.rawIteratorAt(kaMinusFromD.row[iNeg]);
+      if (!buildDecayCandidateTwoBody(posTrackRow, negTrackRow, o2::constants::physics::MassPionCharged, o2::constants::physics::MassKaonCharged, mcParticles))
+        continue;
+
+      dmeson.cosPA = RecoDecay::cpa(std::array{collision.posX(), collision.posY(), collision.posZ()}, std::array{dmeson.posSV[0], dmeson.posSV[1], dmeson.posSV[2]}, std::array{dmeson.P[0], dmeson.P[1], dmeson.P[2]});
+      dmeson.cosPAxy = RecoDecay::cpaXY(std::array{collision.posX(), collision.posY(), collision.posZ()}, std::array{dmeson.posSV[0], dmeson.posSV[1], dmeson.posSV[2]}, std::array{dmeson.P[0], dmeson.P[1], dmeson.P[2]});
+
+      const float dmesonCtau = 0.012301;
+      dmeson.normalizedDecayLength = ((dmeson.mass * std::fabs(std::hypot(collision.posX(), collision.posY(), collision.posZ()) - std::hypot(dmeson.posSV[0], dmeson.posSV[1], dmeson.posSV[2]))) / std::hypot(dmeson.P[0], dmeson.P[1], dmeson.P[2])) / dmesonCtau;
+
+      auto impParXY_daugPos = RecoDecay::impParXY(std::array{collision.posX(), collision.posY(), collision.posZ()}, std::array{dmeson.posSV[0], dmeson.posSV[1], dmeson.posSV[2]}, std::array{dmeson.Pdaug[0], dmeson.Pdaug[1], dmeson.Pdaug[2]});
+      auto impParXY_daugNeg = RecoDecay::impParXY(std::array{collision.posX(), collision.posY(), collision.posZ()}, std::array{dmeson.posSV[0], dmeson.posSV[1], dmeson.posSV[2]}, std::array{dmeson.Ndaug[0], dmeson.Ndaug[1], dmeson.Ndaug[2]});
+      auto decayLength = std::hypot(collision.posX() - dmeson.posSV[0], collision.posY() - dmeson.posSV[1], collision.posZ() - dmeson.posSV[2]);
+      auto decayLengthXY = std::hypot(collision.posX() - dmeson.posSV[0], collision.posY() - dmeson.posSV[1]);
+
+      // fill plots of topological variables before topological selection
+      histos.fill(HIST("hDCosPA"), dmeson.cosPA);
+      histos.fill(HIST("hDCosPAxy"), dmeson.cosPAxy);
+      histos.fill(HIST("hDCosThetaStar"), dmeson.cosThetaStar);
+      histos.fill(HIST("hDDecayLength"), decayLength);
+      histos.fill(HIST("hDDecayLengthXY"), decayLengthXY);
+      histos.fill(HIST("hDNormDecayLength"), dmeson.normalizedDecayLength);
+      histos.fill(HIST("hImpParPi"), impParXY_daugPos);
+      histos.fill(HIST("hImpParK"), impParXY_daugNeg);
+      histos.fill(HIST("hImpParProduct"), impParXY_daugPos * impParXY_daugNeg);
+      if (doDCAplotsD)
+        histos.fill(HIST("hDCADDaughters"), dmeson.dcaDau * 1e+4);
+
+      if (doTopoPlotsForSAndB) {   // fill plots of topological variables for S and B separately (reflections not considered here)
+        if (dmeson.mcTruth == 1) { // true D0
+          histos.fill(HIST("hDCosPA_Signal"), dmeson.cosPA);
+          histos.fill(HIST("hDCosPAxy_Signal"), dmeson.cosPAxy);
+          histos.fill(HIST("hDCosThetaStar_Signal"), dmeson.cosThetaStar);
+          histos.fill(HIST("hDDecayLength_Signal"), decayLength);
+          histos.fill(HIST("hDDecayLengthXY_Signal"), decayLengthXY);
+          histos.fill(HIST("hDNormDecayLength_Signal"), dmeson.normalizedDecayLength);
+          histos.fill(HIST("hImpParPi_Signal"), impParXY_daugPos);
+          histos.fill(HIST("hImpParK_Signal"), impParXY_daugNeg);
+          histos.fill(HIST("hImpParProduct_Signal"), impParXY_daugPos * impParXY_daugNeg);
+          if (doDCAplotsD)
+            histos.fill(HIST("hDCADDaughters_Signal"), dmeson.dcaDau * 1e+4);
+        } else if (!dmeson.mcTruth) { // bkg D0
+          histos.fill(HIST("hDCosPA_Bkg"), dmeson.cosPA);
+          histos.fill(HIST("hDCosPAxy_Bkg"), dmeson.cosPAxy);
+          histos.fill(HIST("hDCosThetaStar_Bkg"), dmeson.cosThetaStar);
+          histos.fill(HIST("hDDecayLength_Bkg"), decayLength);
+          histos.fill(HIST("hDDecayLengthXY_Bkg"), decayLengthXY);
+          histos.fill(HIST("hDNormDecayLength_Bkg"), dmeson.normalizedDecayLength);
+          histos.fill(HIST("hImpParPi_Bkg"), impParXY_daugPos);
+          histos.fill(HIST("hImpParK_Bkg"), impParXY_daugNeg);
+          histos.fill(HIST("hImpParProduct_Bkg"), impParXY_daugPos * impParXY_daugNeg);
+          if (doDCAplotsD)
+            histos.fill(HIST("hDCADDaughters_Bkg"), dmeson.dcaDau * 1e+4);
         }
+      }
 
-        // store D0 in output table
-        candidateD0meson(collision.globalIndex(),
-                         dmeson.Pdaug[0], dmeson.Pdaug[1], dmeson.Pdaug[2],
-                         dmeson.Ndaug[0], dmeson.Ndaug[1], dmeson.Ndaug[2],
-                         dmeson.P[0], dmeson.P[1], dmeson.P[2],
-                         dmeson.pt,
-                         dmeson.mass,
-                         dmeson.eta,
-                         dmeson.phi,
-                         dmeson.y);
-        selectionOutcome(1, 0); // isSelD0 true, isSelD0bar false
-        mcTruthOutcome(dmeson.mcTruth);
+      if (dmeson.dcaDau > dcaDaughtersSelection)
+        continue;
+
+      if (dmeson.pt <= lowPtDLimit && dmeson.cosPA < DCosPA)
+        continue;
+      else if (dmeson.pt > lowPtDLimit && dmeson.cosPA < DCosPAHighPt)
+        continue;
+
+      if (dmeson.pt <= lowPtDLimit && dmeson.cosPAxy < DCosPAxy)
+        continue;
+      else if (dmeson.pt > lowPtDLimit && dmeson.cosPAxy < DCosPAxyHighPt)
+        continue;
+
+      if (dmeson.pt <= lowPtDLimit && std::fabs(dmeson.cosThetaStar) > DCosThetaStarLowPt)
+        continue;
+      else if (dmeson.pt <= highPtDLimit && std::fabs(dmeson.cosThetaStar) > DCosThetaStarHighPt)
+        continue;
+      else if (dmeson.pt > highPtDLimit && std::fabs(dmeson.cosThetaStar) > DCosThetaStarVHighPt)
+        continue;
+
+      if (dmeson.normalizedDecayLength < DMinNormDecayLength || dmeson.normalizedDecayLength > DMaxNormDecayLength)
+        continue;
+
+      if (dmeson.ptdaugPos < minPtPi) // track1 (positive) is the pion
+        continue;
+      if (dmeson.ptdaugNeg < minPtK) // track2 (negative) is the kaon
+        continue;
+
+      if (impParXY_daugPos > maxImpParPi)
+        continue;
+      if (impParXY_daugNeg > maxImpParK)
+        continue;
+      if (impParXY_daugPos * impParXY_daugNeg > maxImpParProduct)
+        continue;
+
+      if (decayLength < DMinDecayLength || decayLength > DMaxDecayLength)
+        continue;
+      if (decayLengthXY < DMinDecayLengthXY || decayLengthXY > DMaxDecayLengthXY)
+        continue;
+      auto decayLengthSquaredCut = std::min((std::hypot(dmeson.P[0], dmeson.P[1], dmeson.P[2]) * 0.0066) + 0.01, (double)DDecayLengthSquaredCut);
+      if (decayLength * decayLength < decayLengthSquaredCut * decayLengthSquaredCut)
+        continue;
+
+      // fill plots of topological variables after topological selection
+      histos.fill(HIST("hDCosPA_Selected"), dmeson.cosPA);
+      histos.fill(HIST("hDCosPAxy_Selected"), dmeson.cosPAxy);
+      histos.fill(HIST("hDCosThetaStar_Selected"), dmeson.cosThetaStar);
+      histos.fill(HIST("hDDecayLength_Selected"), decayLength);
+      histos.fill(HIST("hDDecayLengthXY_Selected"), decayLengthXY);
+      histos.fill(HIST("hDNormDecayLength_Selected"), dmeson.normalizedDecayLength);
+      histos.fill(HIST("hImpParPi_Selected"), impParXY_daugPos);
+      histos.fill(HIST("hImpParK_Selected"), impParXY_daugNeg);
+      histos.fill(HIST("hImpParProduct_Selected"), impParXY_daugPos * impParXY_daugNeg);
+      if (doDCAplotsD)
+        histos.fill(HIST("hDCADDaughters_Selected"), dmeson.dcaDau * 1e+4);
+
+      // filling of mass plots for selected candidates
+      histos.fill(HIST("hMassD"), dmeson.mass);
+      histos.fill(HIST("h3dRecD"), dmeson.pt, dmeson.eta, dmeson.mass);
+      if (dmeson.mcTruth == 1) { // true D0 meson, reco as D0 (= correct matching)
+        histos.fill(HIST("h3dRecDSig"), dmeson.pt, dmeson.eta, dmeson.mass);
+        histos.fill(HIST("hMassDSig"), dmeson.mass);
+        histos.fill(HIST("hDRecForEfficiency"), dmeson.pt, dmeson.y); // for efficiency
+      } else if (dmeson.mcTruth == 2) {                               // true D0bar meson, reco as D0 (= reflection)
+        histos.fill(HIST("hMassDRefl"), dmeson.mass);
+        histos.fill(HIST("h3dRecDRefl"), dmeson.pt, dmeson.eta, dmeson.mass);
+      } else { // background, reco as D0
+        histos.fill(HIST("hMassDBkg"), dmeson.mass);
+        histos.fill(HIST("h3dRecDBkg"), dmeson.pt, dmeson.eta, dmeson.mass);
       }
+
+      // store D0 in output table
+      candidateD0meson(collision.globalIndex(),
+                       dmeson.Pdaug[0], dmeson.Pdaug[1], dmeson.Pdaug[2],
+                       dmeson.Ndaug[0], dmeson.Ndaug[1], dmeson.Ndaug[2],
+                       dmeson.P[0], dmeson.P[1], dmeson.P[2],
+                       dmeson.pt,
+                       dmeson.mass,
+                       dmeson.eta,
+                       dmeson.phi,
+                       dmeson.y);
+      selectionOutcome(1, 0); // isSelD0 true, isSelD0bar false
+      mcTruthOutcome(dmeson.mcTruth);
     }
 
     // D0bar mesons
-    for (auto const& posTrackRow : tracksKaPlusFromDgrouped) {
-      for (auto const& negTrackRow : tracksPiMinusFromDgrouped) {
-
-        if (mcSameMotherCheck && !checkSameMother(posTrackRow, negTrackRow))
-          continue;
-        if (!buildDecayCandidateTwoBody(posTrackRow, negTrackRow, o2::constants::physics::MassKaonCharged, o2::constants::physics::MassPionCharged, mcParticles))
-          continue;
-
-        dmeson.cosPA = RecoDecay::cpa(std::array{collision.posX(), collision.posY(), collision.posZ()}, std::array{dmeson.posSV[0], dmeson.posSV[1], dmeson.posSV[2]}, std::array{dmeson.P[0], dmeson.P[1], dmeson.P[2]});
-        dmeson.cosPAxy = RecoDecay::cpaXY(std::array{collision.posX(), collision.posY(), collision.posZ()}, std::array{dmeson.posSV[0], dmeson.posSV[1], dmeson.posSV[2]}, std::array{dmeson.P[0], dmeson.P[1], dmeson.P[2]});
-
-        const float dmesonCtau = 0.012301;
-        dmeson.normalizedDecayLength = ((dmeson.mass * std::fabs(std::hypot(collision.posX(), collision.posY(), collision.posZ()) - std::hypot(dmeson.posSV[0], dmeson.posSV[1], dmeson.posSV[2]))) / std::hypot(dmeson.P[0], dmeson.P[1], dmeson.P[2])) / dmesonCtau;
-
-        auto impParXY_daugPos = RecoDecay::impParXY(std::array{collision.posX(), collision.posY(), collision.posZ()}, std::array{dmeson.posSV[0], dmeson.posSV[1], dmeson.posSV[2]}, std::array{dmeson.Pdaug[0], dmeson.Pdaug[1], dmeson.Pdaug[2]});
-        auto impParXY_daugNeg = RecoDecay::impParXY(std::array{collision.posX(), collision.posY(), collision.posZ()}, std::array{dmeson.posSV[0], dmeson.posSV[1], dmeson.posSV[2]}, std::array{dmeson.Ndaug[0], dmeson.Ndaug[1], dmeson.Ndaug[2]});
-        auto decayLength = std::hypot(collision.posX() - dmeson.posSV[0], collision.posY() - dmeson.posSV[1], collision.posZ() - dmeson.posSV[2]);
-        auto decayLengthXY = std::hypot(collision.posX() - dmeson.posSV[0], collision.posY() - dmeson.posSV[1]);
-
-        // fill plots of topological variables before topological selection
-        histos.fill(HIST("hDCosPA"), dmeson.cosPA);
-        histos.fill(HIST("hDCosPAxy"), dmeson.cosPAxy);
-        histos.fill(HIST("hDCosThetaStar"), dmeson.cosThetaStar);
-        histos.fill(HIST("hDDecayLength"), decayLength);
-        histos.fill(HIST("hDDecayLengthXY"), decayLengthXY);
-        histos.fill(HIST("hDNormDecayLength"), dmeson.normalizedDecayLength);
-        histos.fill(HIST("hImpParPi"), impParXY_daugNeg);
-        histos.fill(HIST("hImpParK"), impParXY_daugPos);
-        histos.fill(HIST("hImpParProduct"), impParXY_daugPos * impParXY_daugNeg);
-        if (doDCAplotsD)
-          histos.fill(HIST("hDCADbarDaughters"), dmeson.dcaDau * 1e+4);
-
-        if (doTopoPlotsForSAndB) {   // fill plots of topological variables for S and B separately (reflections not considered here)
-          if (dmeson.mcTruth == 2) { // true D0bar
-            histos.fill(HIST("hDCosPA_Signal"), dmeson.cosPA);
-            histos.fill(HIST("hDCosPAxy_Signal"), dmeson.cosPAxy);
-            histos.fill(HIST("hDCosThetaStar_Signal"), dmeson.cosThetaStar);
-            histos.fill(HIST("hDDecayLength_Signal"), decayLength);
-            histos.fill(HIST("hDDecayLengthXY_Signal"), decayLengthXY);
-            histos.fill(HIST("hDNormDecayLength_Signal"), dmeson.normalizedDecayLength);
-            histos.fill(HIST("hImpParPi_Signal"), impParXY_daugNeg);
-            histos.fill(HIST("hImpParK_Signal"), impParXY_daugPos);
-            histos.fill(HIST("hImpParProduct_Signal"), impParXY_daugPos * impParXY_daugNeg);
-            if (doDCAplotsD)
-              histos.fill(HIST("hDCADbarDaughters_Signal"), dmeson.dcaDau * 1e+4);
-          } else if (!dmeson.mcTruth) { // bkg D0bar
-            histos.fill(HIST("hDCosPA_Bkg"), dmeson.cosPA);
-            histos.fill(HIST("hDCosPAxy_Bkg"), dmeson.cosPAxy);
-            histos.fill(HIST("hDCosThetaStar_Bkg"), dmeson.cosThetaStar);
-            histos.fill(HIST("hDDecayLength_Bkg"), decayLength);
-            histos.fill(HIST("hDDecayLengthXY_Bkg"), decayLengthXY);
-            histos.fill(HIST("hDNormDecayLength_Bkg"), dmeson.normalizedDecayLength);
-            histos.fill(HIST("hImpParPi_Bkg"), impParXY_daugNeg);
-            histos.fill(HIST("hImpParK_Bkg"), impParXY_daugPos);
-            histos.fill(HIST("hImpParProduct_Bkg"), impParXY_daugPos * impParXY_daugNeg);
-          }
+    pairPrefilter.findPairs(kaPlusFromD, piMinusFromD, o2::constants::physics::MassKaonCharged, o2::constants::physics::MassPionCharged, pairs);
+    for (auto const& [iPos, iNeg] : pairs) {
+      if (mcSameMotherCheck && !mcAncestry.shareMother(kaPlusFromD.mcParticle[iPos], piMinusFromD.mcParticle[iNeg]))
+        continue;
+      auto posTrackRow = tracks.rawIteratorAt(kaPlusFromD.row[iPos]);
+      auto negTrackRow = tracks.rawIteratorAt(piMinusFromD.row[iNeg]);
+      if (!buildDecayCandidateTwoBody(posTrackRow, negTrackRow, o2::constants::physics::MassKaonCharged, o2::constants::physics::MassPionCharged, mcParticles))
+        continue;
+
+      dmeson.cosPA = RecoDecay::cpa(std::array{collision.posX(), collision.posY(), collision.posZ()}, std::array{dmeson.posSV[0], dmeson.posSV[1], dmeson.posSV[2]}, std::array{dmeson.P[0], dmeson.P[1], dmeson.P[2]});
+      dmeson.cosPAxy = RecoDecay::cpaXY(std::array{collision.posX(), collision.posY(), collision.posZ()}, std::array{dmeson.posSV[0], dmeson.posSV[1], dmeson.posSV[2]}, std::array{dmeson.P[0], dmeson.P[1], dmeson.P[2]});
+
+      const float dmesonCtau = 0.012301;
+      dmeson.normalizedDecayLength = ((dmeson.mass * std::fabs(std::hypot(collision.posX(), collision.posY(), collision.posZ()) - std::hypot(dmeson.posSV[0], dmeson.posSV[1], dmeson.posSV[2]))) / std::hypot(dmeson.P[0], dmeson.P[1], dmeson.P[2])) / dmesonCtau;
+
+      auto impParXY_daugPos = RecoDecay::impParXY(std::array{collision.posX(), collision.posY(), collision.posZ()}, std::array{dmeson.posSV[0], dmeson.posSV[1], dmeson.posSV[2]}, std::array{dmeson.Pdaug[0], dmeson.Pdaug[1], dmeson.Pdaug[2]});
+      auto impParXY_daugNeg = RecoDecay::impParXY(std::array{collision.posX(), collision.posY(), collision.posZ()}, std::array{dmeson.posSV[0], dmeson.posSV[1], dmeson.posSV[2]}, std::array{dmeson.Ndaug[0], dmeson.Ndaug[1], dmeson.Ndaug[2]});
+      auto decayLength = std::hypot(collision.posX() - dmeson.posSV[0], collision.posY() - dmeson.posSV[1], collision.posZ() - dmeson.posSV[2]);
+      auto decayLengthXY = std::hypot(collision.posX() - dmeson.posSV[0], collision.posY() - dmeson.posSV[1]);
+
+      // fill plots of topological variables before topological selection
+      histos.fill(HIST("hDCosPA"), dmeson.cosPA);
+      histos.fill(HIST("hDCosPAxy"), dmeson.cosPAxy);
+      histos.fill(HIST("hDCosThetaStar"), dmeson.cosThetaStar);
+      histos.fill(HIST("hDDecayLength"), decayLength);
+      histos.fill(HIST("hDDecayLengthXY"), decayLengthXY);
+      histos.fill(HIST("hDNormDecayLength"), dmeson.normalizedDecayLength);
+      histos.fill(HIST("hImpParPi"), impParXY_daugNeg);
+      histos.fill(HIST("hImpParK"), impParXY_daugPos);
+      histos.fill(HIST("hImpParProduct"), impParXY_daugPos * impParXY_daugNeg);
+      if (doDCAplotsD)
+        histos.fill(HIST("hDCADbarDaughters"), dmeson.dcaDau * 1e+4);
+
+      if (doTopoPlotsForSAndB) {   // fill plots of topological variables for S and B separately (reflections not considered here)
+        if (dmeson.mcTruth == 2) { // true D0bar
+          histos.fill(HIST("hDCosPA_Signal"), dmeson.cosPA);
+          histos.fill(HIST("hDCosPAxy_Signal"), dmeson.cosPAxy);
+          histos.fill(HIST("hDCosThetaStar_Signal"), dmeson.cosThetaStar);
+          histos.fill(HIST("hDDecayLength_Signal"), decayLength);
+          histos.fill(HIST("hDDecayLengthXY_Signal"), decayLengthXY);
+          histos.fill(HIST("hDNormDecayLength_Signal"), dmeson.normalizedDecayLength);
+          histos.fill(HIST("hImpParPi_Signal"), impParXY_daugNeg);
+          histos.fill(HIST("hImpParK_Signal"), impParXY_daugPos);
+          histos.fill(HIST("hImpParProduct_Signal"), impParXY_daugPos * impParXY_daugNeg);
           if (doDCAplotsD)
-            histos.fill(HIST("hDCADbarDaughters_Bkg"), dmeson.dcaDau * 1e+4);
+            histos.fill(HIST("hDCADbarDaughters_Signal"), dmeson.dcaDau * 1e+4);
+        } else if (!dmeson.mcTruth) { // bkg D0bar
+          histos.fill(HIST("hDCosPA_Bkg"), dmeson.cosPA);
+          histos.fill(HIST("hDCosPAxy_Bkg"), dmeson.cosPAxy);
+          histos.fill(HIST("hDCosThetaStar_Bkg"), dmeson.cosThetaStar);
+          histos.fill(HIST("hDDecayLength_Bkg"), decayLength);
+          histos.fill(HIST("hDDecayLengthXY_Bkg"), decayLengthXY);
+          histos.fill(HIST("hDNormDecayLength_Bkg"), dmeson.normalizedDecayLength);
+          histos.fill(HIST("hImpParPi_Bkg"), impParXY_daugNeg);
+          histos.fill(HIST("hImpParK_Bkg"), impParXY_daugPos);
+          histos.fill(HIST("hImpParProduct_Bkg"), impParXY_daugPos * impParXY_daugNeg);
         }
-
-        if (dmeson.dcaDau > dcaDaughtersSelection)
-          continue;
-
-        if (dmeson.pt <= lowPtDLimit && dmeson.cosPA < DCosPA)
-          continue;
-        else if (dmeson.pt > lowPtDLimit && dmeson.cosPA < DCosPAHighPt)
-          continue;
-
-        if (dmeson.pt <= lowPtDLimit && dmeson.cosPAxy < DCosPAxy)
-          continue;
-        else if (dmeson.pt > lowPtDLimit && dmeson.cosPAxy < DCosPAxyHighPt)
-          continue;
-
-        if (dmeson.pt <= highPtDLimit && std::fabs(dmeson.cosThetaStar) > DCosThetaStarLowPt)
-          continue;
-        else if (dmeson.pt <= highPtDLimit && std::fabs(dmeson.cosThetaStar) > DCosThetaStarHighPt)
-          continue;
-        else if (dmeson.pt > highPtDLimit && std::fabs(dmeson.cosThetaStar) > DCosThetaStarVHighPt)
-          continue;
-
-        if (dmeson.normalizedDecayLength < DMinNormDecayLength || dmeson.normalizedDecayLength > DMaxNormDecayLength)
-          continue;
-
-        if (dmeson.ptdaugPos < minPtK) // track1 is the kaon
-          continue;
-        if (dmeson.ptdaugNeg < minPtPi) // track2 is the pion
-          continue;
-
-        if (impParXY_daugPos > maxImpParK)
-          continue;
-        if (impParXY_daugNeg > maxImpParPi)
-          continue;
-        if (impParXY_daugPos * impParXY_daugNeg > maxImpParProduct)
-          continue;
-
-        if (decayLength < DMinDecayLength || decayLength > DMaxDecayLength)
-          continue;
-        if (decayLengthXY < DMinDecayLengthXY || decayLengthXY > DMaxDecayLengthXY)
-          continue;
-        auto decayLengthSquaredCut = std::min((std::hypot(dmeson.P[0], dmeson.P[1], dmeson.P[2]) * 0.0066) + 0.01, (double)DDecayLengthSquaredCut);
-        if (decayLength * decayLength < decayLengthSquaredCut * decayLengthSquaredCut)
-          continue;
-
-        // fill plots of topological variables after topological selection
-        histos.fill(HIST("hDCosPA_Selected"), dmeson.cosPA);
-        histos.fill(HIST("hDCosPAxy_Selected"), dmeson.cosPAxy);
-        histos.fill(HIST("hDCosThetaStar_Selected"), dmeson.cosThetaStar);
-        histos.fill(HIST("hDDecayLength_Selected"), decayLength);
-        histos.fill(HIST("hDDecayLengthXY_Selected"), decayLengthXY);
-        histos.fill(HIST("hDNormDecayLength_Selected"), dmeson.normalizedDecayLength);
-        histos.fill(HIST("hImpParK_Selected"), impParXY_daugPos);
-        histos.fill(HIST("hImpParPi_Selected"), impParXY_daugNeg);
-        histos.fill(HIST("hImpParProduct_Selected"), impParXY_daugPos * impParXY_daugNeg);
         if (doDCAplotsD)
-          histos.fill(HIST("hDCADbarDaughters_Selected"), dmeson.dcaDau * 1e+4);
-
-        // filling of mass plots for selected candidates
-        histos.fill(HIST("hMassDbar"), dmeson.mass);
-        histos.fill(HIST("h3dRecDbar"), dmeson.pt, dmeson.eta, dmeson.mass);
-        if (dmeson.mcTruth == 2) { // true D0bar meson, reco as D0bar (= correct matching)
-          histos.fill(HIST("h3dRecDbarSig"), dmeson.pt, dmeson.eta, dmeson.mass);
-          histos.fill(HIST("hMassDbarSig"), dmeson.mass);
-          histos.fill(HIST("hDRecForEfficiency"), dmeson.pt, dmeson.y); // for efficiency
-        } else if (dmeson.mcTruth == 1) {                               // true D0 meson, reco as D0bar (= reflection)
-          histos.fill(HIST("hMassDbarRefl"), dmeson.mass);
-          histos.fill(HIST("h3dRecDbarRefl"), dmeson.pt, dmeson.eta, dmeson.mass);
-        } else { // background, reco as D0
-          histos.fill(HIST("hMassDbarBkg"), dmeson.mass);
-          histos.fill(HIST("h3dRecDbarBkg"), dmeson.pt, dmeson.eta, dmeson.mass);
-        }
+          histos.fill(HIST("hDCADbarDaughters_Bkg"), dmeson.dcaDau * 1e+4);
+      }
 
-        // store D0bar in output table
-        candidateD0meson(collision.globalIndex(),
-                         dmeson.Pdaug[0], dmeson.Pdaug[1], dmeson.Pdaug[2],
-                         dmeson.Ndaug[0], dmeson.Ndaug[1], dmeson.Ndaug[2],
-                         dmeson.P[0], dmeson.P[1], dmeson.P[2],
-                         dmeson.pt,
-                         dmeson.mass,
-                         dmeson.eta,
-                         dmeson.phi,
-                         dmeson.y);
-        selectionOutcome(0, 1); // isSelD0 true, isSelD0bar false
-        mcTruthOutcome(dmeson.mcTruth);
+      if (dmeson.dcaDau > dcaDaughtersSelection)
+        continue;
+
+      if (dmeson.pt <= lowPtDLimit && dmeson.cosPA < DCosPA)
+        continue;
+      else if (dmeson.pt > lowPtDLimit && dmeson.cosPA < DCosPAHighPt)
+        continue;
+
+      if (dmeson.pt <= lowPtDLimit && dmeson.cosPAxy < DCosPAxy)
+        continue;
+      else if (dmeson.pt > lowPtDLimit && dmeson.cosPAxy < DCosPAxyHighPt)
+        continue;
+
+      if (dmeson.pt <= highPtDLimit && std::fabs(dmeson.cosThetaStar) > DCosThetaStarLowPt)
+        continue;
+      else if (dmeson.pt <= highPtDLimit && std::fabs(dmeson.cosThetaStar) > DCosThetaStarHighPt)
+        continue;
+      else if (dmeson.pt > highPtDLimit && std::fabs(dmeson.cosThetaStar) > DCosThetaStarVHighPt)
+        continue;
+
+      if (dmeson.normalizedDecayLength < DMinNormDecayLength || dmeson.normalizedDecayLength > DMaxNormDecayLength)
+        continue;
+
+      if (dmeson.ptdaugPos < minPtK) // track1 is the kaon
+        continue;
+      if (dmeson.ptdaugNeg < minPtPi) // track2 is the pion
+        continue;
+
+      if (impParXY_daugPos > maxImpParK)
+        continue;
+      if (impParXY_daugNeg > maxImpParPi)
+        continue;
+      if (impParXY_daugPos * impParXY_daugNeg > maxImpParProduct)
+        continue;
+
+      if (decayLength < DMinDecayLength || decayLength > DMaxDecayLength)
+        continue;
+      if (decayLengthXY < DMinDecayLengthXY || decayLengthXY > DMaxDecayLengthXY)
+        continue;
+      auto decayLengthSquaredCut = std::min((std::hypot(dmeson.P[0], dmeson.P[1], dmeson.P[2]) * 0.0066) + 0.01, (double)DDecayLengthSquaredCut);
+      if (decayLength * decayLength < decayLengthSquaredCut * decayLengthSquaredCut)
+        continue;
+
+      // fill plots of topological variables after topological selection
+      histos.fill(HIST("hDCosPA_Selected"), dmeson.cosPA);
+      histos.fill(HIST("hDCosPAxy_Selected"), dmeson.cosPAxy);
+      histos.fill(HIST("hDCosThetaStar_Selected"), dmeson.cosThetaStar);
+      histos.fill(HIST("hDDecayLength_Selected"), decayLength);
+      histos.fill(HIST("hDDecayLengthXY_Selected"), decayLengthXY);
+      histos.fill(HIST("hDNormDecayLength_Selected"), dmeson.normalizedDecayLength);
+      histos.fill(HIST("hImpParK_Selected"), impParXY_daugPos);
+      histos.fill(HIST("hImpParPi_Selected"), impParXY_daugNeg);
+      histos.fill(HIST("hImpParProduct_Selected"), impParXY_daugPos * impParXY_daugNeg);
+      if (doDCAplotsD)
+        histos.fill(HIST("hDCADbarDaughters_Selected"), dmeson.dcaDau * 1e+4);
+
+      // filling of mass plots for selected candidates
+      histos.fill(HIST("hMassDbar"), dmeson.mass);
+      histos.fill(HIST("h3dRecDbar"), dmeson.pt, dmeson.eta, dmeson.mass);
+      if (dmeson.mcTruth == 2) { // true D0bar meson, reco as D0bar (= correct matching)
+        histos.fill(HIST("h3dRecDbarSig"), dmeson.pt, dmeson.eta, dmeson.mass);
+        histos.fill(HIST("hMassDbarSig"), dmeson.mass);
+        histos.fill(HIST("hDRecForEfficiency"), dmeson.pt, dmeson.y); // for efficiency
+      } else if (dmeson.mcTruth == 1) {                               // true D0 meson, reco as D0bar (= reflection)
+        histos.fill(HIST("hMassDbarRefl"), dmeson.mass);
+        histos.fill(HIST("h3dRecDbarRefl"), dmeson.pt, dmeson.eta, dmeson.mass);
+      } else { // background, reco as D0
+        histos.fill(HIST("hMassDbarBkg"), dmeson.mass);
+        histos.fill(HIST("h3dRecDbarBkg"), dmeson.pt, dmeson.eta, dmeson.mass);
       }
+
+      // store D0bar in output table
+      candidateD0meson(collision.globalIndex(),
+                       dmeson.Pdaug[0], dmeson.Pdaug[1], dmeson.Pdaug[2],
+                       dmeson.Ndaug[0], dmeson.Ndaug[1], dmeson.Ndaug[2],
+                       dmeson.P[0], dmeson.P[1], dmeson.P[2],
+                       dmeson.pt,
+                       dmeson.mass,
+                       dmeson.eta,
+                       dmeson.phi,
+                       dmeson.y);
+      selectionOutcome(0, 1); // isSelD0 true, isSelD0bar false
+      mcTruthOutcome(dmeson.mcTruth);
     }
   }
   //*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*
 
   //*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*
-  void processFindLcBaryons(aod::Collision const& collision, alice3tracks const&, aod::McParticles const&)
+  void processFindLcBaryons(aod::Collision const& collision, alice3tracks const&, aod::McParticles const& mcParticles)
   {
+    if (mcSameMotherCheck && !mcAncestry.isBoundTo(mcParticles)) {
+      mcAncestry.build(mcParticles);
+    }
+
     // group with this collision
     auto tracksPiPlusFromLcgrouped = tracksPiPlusFromLc->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache);
     auto tracksKaPlusFromLcgrouped = tracksKaPlusFromLc->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache);
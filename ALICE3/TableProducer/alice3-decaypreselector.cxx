@@ -17,6 +17,7 @@
 //    HF decays. Work in progress: use at your own risk!
 //
 
+#include <algorithm>
 #include <cmath>
 #include <array>
 #include <cstdlib>
@@ -80,25 +81,24 @@ struct alice3decaypreselector {
 
   HistogramRegistry histos{"histos", {}, OutputObjHandlingPolicy::AnalysisObject};
 
-  //*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*
-  /// function to check PDG + PDG mother
-  template <typename TTrack>
-  bool checkPDG(TTrack const& track, int pdgMother, int pdg)
-  {
-    bool returnValue = false;
-    // Association check
-    if (track.has_mcParticle()) {
-      auto mcParticle = track.template mcParticle_as<aod::McParticles>();
-      if (mcParticle.has_mothers()) {
-        for (auto& mcParticleMother : mcParticle.template mothers_as<aod::McParticles>()) {
-          if (mcParticle.pdgCode() == pdg && mcParticleMother.pdgCode() == pdgMother)
-            returnValue = true;
-        }
-      }
-    } // end association check
-    return returnValue;
-  }
-  //*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*
+  // MC truth bits: {PDG of the mother, PDG of the track, bit}, the bit being kept if the track matches
+  static constexpr std::array<std::array<int, 3>, 13> mcTruthBits{{
+    // D mesons
+    {+421, -321, kTrueKaMinusFromD}, //+421 -> -321 +211
+    {-421, +321, kTrueKaPlusFromD},  //-421 -> +321 -211
+    {+421, +211, kTruePiPlusFromD},  //+421 -> -321 +211
+    {-421, -211, kTruePiMinusFromD}, //-421 -> +321 -211
+    // Lambdac baryons
+    {+4122, +2212, kTruePrPlusFromLc},  //+4122 -> +2212 -321 +211
+    {+4122, -321, kTrueKaMinusFromLc},  //+4122 -> +2212 -321 +211
+    {+4122, +211, kTruePiPlusFromLc},   //+4122 -> +2212 -321 +211
+    {-4122, -2212, kTruePrMinusFromLc}, //-4122 -> -2212 +321 -211
+    {-4122, +321, kTrueKaPlusFromLc},   //-4122 -> -2212 +321 -211
+    {-4122, -211, kTruePiMinusFromLc},  //-4122 -> -2212 +321 -211
+    // XiCC daughters
+    {4422, 211, kTruePiFromXiCC},  // 4422 -> 4232 211, pi from xicc
+    {4232, 3312, kTrueXiFromXiC},  // 4232 -> 3312 211 211, xi from xic
+    {4232, 211, kTruePiFromXiC}}}; // 4232 -> 3312 211 211, pi from xic
 
   void init(InitContext&)
   {
@@ -162,38 +162,23 @@ struct alice3decaypreselector {
   //*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*
   void processFilterOnMonteCarloTruth(labeledTracks const& tracks, aod::McParticles const&)
   {
+    std::vector<int> motherPdgs;
     for (auto const& track : tracks) {
-      // D mesons
-      if (!checkPDG(track, 421, -321)) //+421 -> -321 +211
-        bitoff(selectionMap[track.globalIndex()], kTrueKaMinusFromD);
-      if (!checkPDG(track, -421, +321)) //-421 -> +321 -211
-        bitoff(selectionMap[track.globalIndex()], kTrueKaPlusFromD);
-      if (!checkPDG(track, 421, +211)) //+421 -> -321 +211
-        bitoff(selectionMap[track.globalIndex()], kTruePiPlusFromD);
-      if (!checkPDG(track, -421, -211)) //-421 -> +321 -211
-        bitoff(selectionMap[track.globalIndex()], kTruePiMinusFromD);
-
-      // Lambdac baryons
-      if (!checkPDG(track, +4122, +2212)) //+4122 -> +2212 -321 +211
-        bitoff(selectionMap[track.globalIndex()], kTruePrPlusFromLc);
-      if (!checkPDG(track, +4122, -321)) //+4122 -> +2212 -321 +211
-        bitoff(selectionMap[track.globalIndex()], kTrueKaMinusFromLc);
-      if (!checkPDG(track, +4122, +211)) //+4122 -> +2212 -321 +211
-        bitoff(selectionMap[track.globalIndex()], kTruePiPlusFromLc);
-      if (!checkPDG(track, -4122, -2212)) //-4122 -> -2212 +321 -211
-        bitoff(selectionMap[track.globalIndex()], kTruePrMinusFromLc);
-      if (!checkPDG(track, -4122, +321)) //-4122 -> -2212 +321 -211
-        bitoff(selectionMap[track.globalIndex()], kTrueKaPlusFromLc);
-      if (!checkPDG(track, -4122, -211)) //-4122 -> -2212 +321 -211
-        bitoff(selectionMap[track.globalIndex()], kTruePiMinusFromLc);
-
-      // XiCC daughters
-      if (!checkPDG(track, 4422, 211)) // 4422 -> 4232 211, pi from xicc
-        bitoff(selectionMap[track.globalIndex()], kTruePiFromXiCC);
-      if (!checkPDG(track, 4232, 3312)) // 4232 -> 3312 211 211, xi from xic
-        bitoff(selectionMap[track.globalIndex()], kTrueXiFromXiC);
-      if (!checkPDG(track, 4232, 211)) // 4232 -> 3312 211 211, pi from xic
-        bitoff(selectionMap[track.globalIndex()], kTruePiFromXiC);
+      // PDG codes of the particle and of its mothers, looked up once for all the bits
+      int pdg = 0;
+      motherPdgs.clear();
+      if (track.has_mcParticle()) {
+        auto mcParticle = track.template mcParticle_as<aod::McParticles>();
+        pdg = mcParticle.pdgCode();
+        if (mcParticle.has_mothers()) {
+          for (auto const& mcParticleMother : mcParticle.template mothers_as<aod::McParticles>())
+            motherPdgs.push_back(mcParticleMother.pdgCode());
+        }
+      }
+      for (auto const& [pdgMother, pdgTrack, bit] : mcTruthBits) {
+        if (pdg != pdgTrack || std::find(motherPdgs.begin(), motherPdgs.end(), pdgMother) == motherPdgs.end())
+          bitoff(selectionMap[track.globalIndex()], bit);
+      }
     }
   }
   //*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*
@@ -23,6 +23,7 @@
 #include <map>
 #include <iterator>
 #include <utility>
+#include <vector>
 
 #include "Framework/runDataProcessing.h"
 #include "Framework/RunningWorkflowInfo.h"
@@ -49,6 +50,7 @@
 #include "ALICE3/DataModel/OTFStrangeness.h"
 #include "ALICE3/DataModel/OTFMulticharm.h"
 #include "ALICE3/DataModel/tracksAlice3.h"
+#include "ALICE3/Core/MulticharmFinder.h"
 #include "DetectorsVertexing/PVertexer.h"
 #include "DetectorsVertexing/PVertexerHelpers.h"
 #include "CommonConstants/PhysicsConstants.h"
@@ -121,6 +123,16 @@ struct alice3multicharmTable {
   Configurable<float> massWindowXi{"massWindowXi", 0.015, "Mass window around Xi peak (GeV/c)"};
   Configurable<float> massWindowXiC{"massWindowXiC", 0.015, "Mass window around XiC peak (GeV/c)"};
 
+  // Candidate finding: daughters searched around the direction of the parent, loose mass windows before the DCA fits
+  Configurable<float> piFromXiC_maxDeltaEta{"piFromXiC_maxDeltaEta", -1.0f, "max |eta(pi) - eta(Xi)| for XiC pions (negative: no limit)"};
+  Configurable<float> piFromXiC_maxDeltaPhi{"piFromXiC_maxDeltaPhi", -1.0f, "max |phi(pi) - phi(Xi)| for XiC pions (negative: no limit)"};
+  Configurable<float> piFromXiCC_maxDeltaEta{"piFromXiCC_maxDeltaEta", -1.0f, "max |eta(pi) - eta(XiC)| for XiCC pions (negative: no limit)"};
+  Configurable<float> piFromXiCC_maxDeltaPhi{"piFromXiCC_maxDeltaPhi", -1.0f, "max |phi(pi) - phi(XiC)| for XiCC pions (negative: no limit)"};
+  Configurable<float> massWindowXiCPrefit{"massWindowXiCPrefit", -1.0f, "Mass window around XiC peak before the fit, momenta at the DCA to the PV (GeV/c, negative: no prefilter)"};
+  Configurable<float> massWindowXiCCPrefit{"massWindowXiCCPrefit", -1.0f, "Mass window around XiCC peak before the fit, XiC pion momentum at the DCA to the PV (GeV/c, negative: no prefilter)"};
+  Configurable<int> nEtaCellsPions{"nEtaCellsPions", 32, "number of eta cells of the pion index, in the range of axisEta"};
+  Configurable<int> nPhiCellsPions{"nPhiCellsPions", 36, "number of phi cells of the pion index"};
+
   ConfigurableAxis axisEta{"axisEta", {80, -4.0f, +4.0f}, "#eta"};
   ConfigurableAxis axisPt{"axisPt", {VARIABLE_WIDTH, 0.0f, 0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f, 0.7f, 0.8f, 0.9f, 1.0f, 1.1f, 1.2f, 1.3f, 1.4f, 1.5f, 1.6f, 1.7f, 1.8f, 1.9f, 2.0f, 2.2f, 2.4f, 2.6f, 2.8f, 3.0f, 3.2f, 3.4f, 3.6f, 3.8f, 4.0f, 4.4f, 4.8f, 5.2f, 5.6f, 6.0f, 6.5f, 7.0f, 7.5f, 8.0f, 9.0f, 10.0f, 11.0f, 12.0f, 13.0f, 14.0f, 15.0f, 17.0f, 19.0f, 21.0f, 23.0f, 25.0f, 30.0f, 35.0f, 40.0f, 50.0f}, "pt axis for QA histograms"};
   ConfigurableAxis axisDCA2D{"axisDCA2D", {400, -200, 200}, "DCA2d (#mum)"};
@@ -159,6 +171,58 @@ struct alice3multicharmTable {
 
   Partition<alice3tracks> tracksPiFromXiCC = ((aod::a3DecayMap::decayMap & trackSelectionPiFromXiCC) == trackSelectionPiFromXiCC) && aod::track::signed1Pt > 0.0f && 1.0f / nabs(aod::track::signed1Pt) > minPiCCPt&& nabs(aod::track::dcaXY) > piFromXiCC_dcaXYconstant + piFromXiCC_dcaXYpTdep* nabs(aod::track::signed1Pt);
 
+  // MC mothers of the dataframe, for the same-mother checks
+  o2::upgrade::McAncestry mcAncestry;
+
+  // Pion candidates of the collision, with the quantities needed by the combinatorics
+  struct PionCandidates {
+    std::vector<int64_t> row; // position in the tracks of the collision
+    std::vector<int64_t> globalIndex;
+    std::vector<int> mcParticle;
+    std::vector<float> pt;
+    std::vector<float> eta;
+    std::vector<float> phi;
+    std::vector<std::array<float, 3>> momentum;
+    std::vector<float> tofDiffInner;
+    std::vector<float> tofDiffOuter;
+    o2::upgrade::AngularIndex index;
+
+    void clear()
+    {
+      row.clear();
+      globalIndex.clear();
+      mcParticle.clear();
+      pt.clear();
+      eta.clear();
+      phi.clear();
+      momentum.clear();
+      tofDiffInner.clear();
+      tofDiffOuter.clear();
+    }
+  };
+  PionCandidates piFromXiC;
+  PionCandidates piFromXiCC;
+  std::vector<int> selectedPiFromXiC;
+  std::vector<int> selectedPiFromXiCC;
+
+  template <typename TPions>
+  void fillPionCandidates(TPions const& pions, int64_t offset, PionCandidates& candidates)
+  {
+    candidates.clear();
+    for (auto const& pion : pions) {
+      candidates.row.push_back(pion.globalIndex() - offset);
+      candidates.globalIndex.push_back(pion.globalIndex());
+      candidates.mcParticle.push_back(pion.mcParticleId());
+      candidates.pt.push_back(pion.pt());
+      candidates.eta.push_back(pion.eta());
+      candidates.phi.push_back(pion.phi());
+      candidates.momentum.push_back(pion.pVector());
+      candidates.tofDiffInner.push_back(std::fabs(pion.innerTOFTrackTimeReco() - pion.innerTOFExpectedTimePi()));
+      candidates.tofDiffOuter.push_back(std::fabs(pion.outerTOFTrackTimeReco() - pion.outerTOFExpectedTimePi()));
+    }
+    candidates.index.fill(candidates.eta, candidates.phi);
+  }
+
   // Helper struct to pass candidate information
   struct {
     // decay properties
@@ -321,56 +385,6 @@ struct alice3multicharmTable {
     return true;
   }
 
-  /// function to check if tracks have the same mother in MC
-  template <typename TTrackType1, typename TTrackType2>
-  bool checkSameMother(TTrackType1 const& track1, TTrackType2 const& track2)
-  {
-    bool returnValue = false;
-    // Association check
-    // There might be smarter ways of doing this in the future
-    if (track1.has_mcParticle() && track2.has_mcParticle()) {
-      auto mcParticle1 = track1.template mcParticle_as<aod::McParticles>();
-      auto mcParticle2 = track2.template mcParticle_as<aod::McParticles>();
-      if (mcParticle1.has_mothers() && mcParticle2.has_mothers()) {
-        for (auto& mcParticleMother1 : mcParticle1.template mothers_as<aod::McParticles>()) {
-          for (auto& mcParticleMother2 : mcParticle2.template mothers_as<aod::McParticles>()) {
-            if (mcParticleMother1.globalIndex() == mcParticleMother2.globalIndex()) {
-              returnValue = true;
-            }
-          }
-        }
-      }
-    } // end association check
-    return returnValue;
-  }
-
-  // Association check for the XiCC pion
-  template <typename TTrackType1, typename TTrackType2>
-  bool checkSameMotherExtra(TTrackType1 const& track1, TTrackType2 const& track2)
-  {
-    bool returnValue = false;
-    // This might perhaps be a bit excessive
-    // Could be joined with `checkSameMother` but leaving as is for now
-    if (track1.has_mcParticle() && track2.has_mcParticle()) {
-      auto mcParticle1 = track1.template mcParticle_as<aod::McParticles>();
-      auto mcParticle2 = track2.template mcParticle_as<aod::McParticles>();
-      if (mcParticle1.has_mothers() && mcParticle2.has_mothers()) {
-        for (auto& mcParticleMother1 : mcParticle1.template mothers_as<aod::McParticles>()) {
-          if (mcParticleMother1.has_mothers()) {
-            for (auto& mcParticleGrandMother1 : mcParticleMother1.template mothers_as<aod::McParticles>()) {
-              for (auto& mcParticleMother2 : mcParticle2.template mothers_as<aod::McParticles>()) {
-                if (mcParticleGrandMother1.globalIndex() == mcParticleMother2.globalIndex()) {
-                  returnValue = true;
-                }
-              }
-            }
-          }
-        }
-      }
-    } // end association check
-    return returnValue;
-  }
-
   void init(InitContext&)
   {
     // initialize O2 2-prong fitter (only once)
@@ -396,6 +410,10 @@ struct alice3multicharmTable {
     fitter3.setBz(magneticField);
     fitter3.setMatCorrType(o2::base::Propagator::MatCorrType::USEMatCorrNONE);
 
+    const AxisSpec axisEtaCells{axisEta, "#eta"};
+    piFromXiC.index.setGrid(nEtaCellsPions, axisEtaCells.binEdges.front(), axisEtaCells.binEdges.back(), nPhiCellsPions);
+    piFromXiCC.index.setGrid(nEtaCellsPions, axisEtaCells.binEdges.front(), axisEtaCells.binEdges.back(), nPhiCellsPions);
+
     // This histogram bookkeeps the attempts at DCA minimization and their eventual
     // failure rates.
     // --- 0: attempt XiC, 1: success XiC
@@ -472,7 +490,7 @@ struct alice3multicharmTable {
   }
 
   //*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*
-  void processFindXiCC(aod::Collision const& collision, alice3tracks const& tracks, aod::McParticles const&, aod::UpgradeCascades const& cascades)
+  void processFindXiCC(aod::Collision const& collision, alice3tracks const& tracks, aod::McParticles const& mcParticles, aod::UpgradeCascades const& cascades)
   {
     histos.fill(HIST("hNCollisions"), 1);
     histos.fill(HIST("hNTracks"), tracks.size());
@@ -487,6 +505,13 @@ struct alice3multicharmTable {
     auto tracksPiFromXiCgrouped = tracksPiFromXiC->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache);
     auto tracksPiFromXiCCgrouped = tracksPiFromXiCC->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache);
 
+    // quantities of the pions computed once per collision, MC mothers once per dataframe
+    fillPionCandidates(tracksPiFromXiCgrouped, tracks.offset(), piFromXiC);
+    fillPionCandidates(tracksPiFromXiCCgrouped, tracks.offset(), piFromXiCC);
+    if (mcSameMotherCheck && !mcAncestry.isBoundTo(mcParticles)) {
+      mcAncestry.build(mcParticles);
+    }
+
     if (doDCAplots) {
       for (auto const& cascade : cascades) {
         if (cascade.has_cascadeTrack()) {
@@ -529,39 +554,44 @@ struct alice3multicharmTable {
         continue;
 
       histos.fill(HIST("hMinXiDecayRadius"), xiCand.cascRadius());
-      for (auto const& pi1c : tracksPiFromXiCgrouped) {
-        if (mcSameMotherCheck && !checkSameMother(xi, pi1c))
+      const int xiMcParticle = xi.mcParticleId();
+      piFromXiC.index.select(xi.eta(), xi.phi(), piFromXiC_maxDeltaEta, piFromXiC_maxDeltaPhi, selectedPiFromXiC);
+      for (const int i1 : selectedPiFromXiC) {
+        if (mcSameMotherCheck && !mcAncestry.shareMother(xiMcParticle, piFromXiC.mcParticle[i1]))
           continue;
-        if (xiCand.posTrackId() == pi1c.globalIndex() || xiCand.negTrackId() == pi1c.globalIndex() || xiCand.bachTrackId() == pi1c.globalIndex())
+        const int64_t pi1cIndex = piFromXiC.globalIndex[i1];
+        if (xiCand.posTrackId() == pi1cIndex || xiCand.negTrackId() == pi1cIndex || xiCand.bachTrackId() == pi1cIndex)
           continue; // avoid using any track that was already used
 
-        if (pi1c.pt() < minPiCPt)
+        if (piFromXiC.pt[i1] < minPiCPt)
           continue; // too low momentum
 
-        histos.fill(HIST("hPi1cPt"), pi1c.pt());
-        float pi1cTOFDiffInner = std::fabs(pi1c.innerTOFTrackTimeReco() - pi1c.innerTOFExpectedTimePi());
-        float pi1cTOFDiffOuter = std::fabs(pi1c.outerTOFTrackTimeReco() - pi1c.outerTOFExpectedTimePi());
+        histos.fill(HIST("hPi1cPt"), piFromXiC.pt[i1]);
+        float pi1cTOFDiffInner = piFromXiC.tofDiffInner[i1];
+        float pi1cTOFDiffOuter = piFromXiC.tofDiffOuter[i1];
         if (pi1cTOFDiffInner > piFromXiC_tofDiffInner)
           continue; // did not arrive at expected time
 
         histos.fill(HIST("hInnerTOFTrackTimeRecoPi1c"), pi1cTOFDiffInner);
+        auto pi1c = tracks.rawIteratorAt(piFromXiC.row[i1]);
         // second pion from XiC decay for starts here
-        for (auto const& pi2c : tracksPiFromXiCgrouped) {
-          if (mcSameMotherCheck && !checkSameMother(xi, pi2c))
-            continue; // keep only if same mother
-
-          if (pi1c.globalIndex() >= pi2c.globalIndex())
+        for (const int i2 : selectedPiFromXiC) {
+          const int64_t pi2cIndex = piFromXiC.globalIndex[i2];
+          if (pi1cIndex >= pi2cIndex)
             continue; // avoid same-mother, avoid double-counting
 
-          if (xiCand.posTrackId() == pi2c.globalIndex() || xiCand.negTrackId() == pi2c.globalIndex() || xiCand.bachTrackId() == pi2c.globalIndex())
+          if (mcSameMotherCheck && !mcAncestry.shareMother(xiMcParticle, piFromXiC.mcParticle[i2]))
+            continue; // keep only if same mother
+
+          if (xiCand.posTrackId() == pi2cIndex || xiCand.negTrackId() == pi2cIndex || xiCand.bachTrackId() == pi2cIndex)
             continue; // avoid using any track that was already used
 
-          if (pi2c.pt() < minPiCPt)
+          if (piFromXiC.pt[i2] < minPiCPt)
             continue; // too low momentum
 
-          histos.fill(HIST("hPi2cPt"), pi2c.pt());
-          float pi2cTOFDiffInner = std::fabs(pi2c.innerTOFTrackTimeReco() - pi2c.innerTOFExpectedTimePi());
-          float pi2cTOFDiffOuter = std::fabs(pi2c.outerTOFTrackTimeReco() - pi2c.outerTOFExpectedTimePi());
+          histos.fill(HIST("hPi2cPt"), piFromXiC.pt[i2]);
+          float pi2cTOFDiffInner = piFromXiC.tofDiffInner[i2];
+          float pi2cTOFDiffOuter = piFromXiC.tofDiffOuter[i2];
           if (pi2cTOFDiffInner > piFromXiC_tofDiffInner)
             continue; // did not arrive at expected time
 
@@ -570,6 +600,13 @@ struct alice3multicharmTable {
           // will now attempt to build a three-body decay candidate with these three track rows.
 
           nCombinationsC++;
+          if (massWindowXiCPrefit >= 0.f) {
+            const float massPrefit = RecoDecay::m(array{xi.pVector(), piFromXiC.momentum[i1], piFromXiC.momentum[i2]}, array{o2::constants::physics::MassXiMinus, o2::constants::physics::MassPionCharged, o2::constants::physics::MassPionCharged});
+            if (std::fabs(massPrefit - o2::constants::physics::MassXiCPlus) > massWindowXiCPrefit)
+              continue; // far from the mass region already before the fit
+          }
+
+          auto pi2c = tracks.rawIteratorAt(piFromXiC.row[i2]);
           histos.fill(HIST("hCharmBuilding"), 0.0f);
           if (!buildDecayCandidateThreeBody(xi, pi1c, pi2c, o2::constants::physics::MassXiMinus, o2::constants::physics::MassPionCharged, o2::constants::physics::MassPionCharged))
             continue; // failed at building candidate
@@ -618,27 +655,36 @@ struct alice3multicharmTable {
 
           // attempt XiCC finding
           uint32_t nCombinationsCC = 0;
-          for (auto const& picc : tracksPiFromXiCCgrouped) {
-            if (mcSameMotherCheck && !checkSameMotherExtra(xi, picc))
+          piFromXiCC.index.select(thisXiCcandidate.eta, std::atan2(momentumC[1], momentumC[0]), piFromXiCC_maxDeltaEta, piFromXiCC_maxDeltaPhi, selectedPiFromXiCC);
+          for (const int icc : selectedPiFromXiCC) {
+            if (mcSameMotherCheck && !mcAncestry.grandmotherIsMotherOf(xiMcParticle, piFromXiCC.mcParticle[icc]))
               continue;
 
-            if (xiCand.posTrackId() == picc.globalIndex() || xiCand.negTrackId() == picc.globalIndex() || xiCand.bachTrackId() == picc.globalIndex())
+            const int64_t piccIndex = piFromXiCC.globalIndex[icc];
+            if (xiCand.posTrackId() == piccIndex || xiCand.negTrackId() == piccIndex || xiCand.bachTrackId() == piccIndex)
               continue; // avoid using any track that was already used
 
-            if (picc.pt() < minPiCCPt)
+            if (piFromXiCC.pt[icc] < minPiCCPt)
               continue; // too low momentum
 
-            histos.fill(HIST("hPiccPt"), picc.pt());
+            histos.fill(HIST("hPiccPt"), piFromXiCC.pt[icc]);
 
-            float piccTOFDiffInner = std::fabs(picc.innerTOFTrackTimeReco() - picc.innerTOFExpectedTimePi());
-            float piccTOFDiffOuter = std::fabs(picc.outerTOFTrackTimeReco() - picc.outerTOFExpectedTimePi());
+            float piccTOFDiffInner = piFromXiCC.tofDiffInner[icc];
+            float piccTOFDiffOuter = piFromXiCC.tofDiffOuter[icc];
             if (piccTOFDiffInner > piFromXiCC_tofDiffInner)
               continue; // did not arrive at expected time
 
             histos.fill(HIST("hInnerTOFTrackTimeRecoPicc"), piccTOFDiffInner);
 
-            o2::track::TrackParCov piccTrack = getTrackParCov(picc);
             nCombinationsCC++;
+            if (massWindowXiCCPrefit >= 0.f) {
+              const float massPrefit = RecoDecay::m(array{momentumC, piFromXiCC.momentum[icc]}, array{o2::constants::physics::MassXiCPlus, o2::constants::physics::MassPionCharged});
+              if (std::fabs(massPrefit - o2::constants::physics::MassXiCCPlusPlus) > massWindowXiCCPrefit)
+                continue; // far from the mass region already before the fit
+            }
+
+            auto picc = tracks.rawIteratorAt(piFromXiCC.row[icc]);
+            o2::track::TrackParCov piccTrack = getTrackParCov(picc);
             histos.fill(HIST("hCharmBuilding"), 2.0f);
             if (!buildDecayCandidateTwoBody(xicTrack, piccTrack, o2::constants::physics::MassXiCPlus, o2::constants::physics::MassPionCharged))
               continue; // failed at building candidate
@@ -0,0 +1,161 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   ccdbLocalCache.cxx
+/// \brief  Node-local on-disk cache of run-wise CCDB objects, with asynchronous prefetching
+///
+
+#include "ccdbLocalCache.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <sstream>
+
+#include "CCDB/BasicCCDBManager.h"
+#include "Framework/Logger.h"
+
+namespace o2
+{
+
+ccdbLocalCache& ccdbLocalCache::instance()
+{
+  static ccdbLocalCache cache;
+  return cache;
+}
+
+ccdbLocalCache::ccdbLocalCache()
+{
+  if (const char* cacheDir = std::getenv("O2PHYSICS_CCDB_LOCALCACHE")) {
+    configure(cacheDir);
+  }
+}
+
+void ccdbLocalCache::configure(std::string const& cacheDir, int prefetchThreads)
+{
+  waitForPrefetch();
+  std::lock_guard<std::mutex> lock(mMutex);
+  mCacheDir = cacheDir;
+  mPrefetchThreads = std::max(prefetchThreads, 1);
+  if (!mCacheDir.empty()) {
+    std::filesystem::create_directories(mCacheDir);
+    LOG(info) << "Local cache of the run-wise CCDB objects in " << mCacheDir;
+  }
+}
+
+void ccdbLocalCache::prefetch(std::string const& ccdbUrl, std::vector<int> const& runs, std::vector<Request> const& requests)
+{
+  if (!isEnabled() || runs.empty() || requests.empty()) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mMutex);
+  const int nWorkers = std::min<int>(mPrefetchThreads, runs.size());
+  LOGP(info, "Prefetching {} CCDB objects for {} runs with {} threads", requests.size(), runs.size(), nWorkers);
+  for (int iWorker{0}; iWorker < nWorkers; ++iWorker) {
+    mPrefetches.push_back(std::async(std::launch::async, [this, ccdbUrl, runs, requests, iWorker, nWorkers]() {
+      o2::ccdb::CcdbApi api;
+      api.init(ccdbUrl);
+      for (size_t iRun = iWorker; iRun < runs.size(); iRun += nWorkers) {
+        std::vector<Request> missing;
+        std::copy_if(requests.begin(), requests.end(), std::back_inserter(missing), [&](Request const& request) { return !std::filesystem::exists(getFileName(request.path, runs[iRun])); });
+        if (missing.empty()) {
+          continue;
+        }
+        const auto runDuration = o2::ccdb::BasicCCDBManager::getRunDuration(api, runs[iRun], false);
+        if (runDuration.first <= 0 || runDuration.second <= 0) {
+          LOGP(warning, "Run {} not found in CCDB, its objects will not be prefetched", runs[iRun]);
+          continue;
+        }
+        const int64_t runTimestamp = runDuration.first / 2 + runDuration.second / 2;
+        for (auto const& request : missing) {
+          download(api, request.path, runs[iRun], runTimestamp, request.useRunMetadata);
+        }
+      }
+    }));
+  }
+}
+
+void ccdbLocalCache::waitForPrefetch()
+{
+  std::vector<std::future<void>> prefetches;
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    prefetches.swap(mPrefetches);
+  }
+  for (auto& prefetch : prefetches) {
+    prefetch.get();
+  }
+}
+
+std::string ccdbLocalCache::getLocalFile(std::string const& ccdbUrl, std::string const& path, int runNumber, int64_t timestamp, bool useRunMetadata)
+{
+  waitForPrefetch();
+  const std::string fileName = getFileName(path, runNumber);
+  if (std::filesystem::exists(fileName)) {
+    LOGP(debug, "Reading {} for run {} from the local cache", path, runNumber);
+    return fileName;
+  }
+  std::lock_guard<std::mutex> lock(mMutex);
+  auto& api = mApis[ccdbUrl];
+  if (!api) {
+    api = std::make_unique<o2::ccdb::CcdbApi>();
+    api->init(ccdbUrl);
+  }
+  return download(*api, path, runNumber, timestamp, useRunMetadata) ? fileName : "";
+}
+
+std::string ccdbLocalCache::getFileName(std::string const& path, int runNumber) const
+{
+  return fmt::format("{}/{}/run{}.root", mCacheDir, path, runNumber);
+}
+
+bool ccdbLocalCache::download(o2::ccdb::CcdbApi const& api, std::string const& path, int runNumber, int64_t timestamp, bool useRunMetadata) const
+{
+  const std::string targetDir = fmt::format("{}/{}", mCacheDir, path);
+  const std::string tmpFileName = fmt::format("run{}.root.{}.tmp", runNumber, getpid());
+  std::filesystem::create_directories(targetDir);
+  std::map<std::string, std::string> metadata;
+  if (useRunMetadata) {
+    metadata["runNumber"] = std::to_string(runNumber);
+  }
+  const bool retrieved = api.retrieveBlob(path, targetDir, metadata, timestamp, false, tmpFileName);
+  const std::filesystem::path tmpFile{targetDir + "/" + tmpFileName};
+  if (!retrieved || !std::filesystem::exists(tmpFile)) {
+    LOGP(warning, "Could not retrieve {} for run {} from CCDB", path, runNumber);
+    std::filesystem::remove(tmpFile);
+    return false;
+  }
+  std::filesystem::rename(tmpFile, getFileName(path, runNumber)); /// Atomic, other processes never see a partial file
+  return true;
+}
+
+std::vector<int> ccdbLocalCache::runsFromMetadata(MetadataHelper const& metadataInfo)
+{
+  std::vector<int> runs;
+  if (!metadataInfo.isKeyDefined("Run")) {
+    return runs;
+  }
+  std::string runList = metadataInfo.get("Run");
+  std::replace(runList.begin(), runList.end(), ',', ' ');
+  std::istringstream stream(runList);
+  int run{0};
+  while (stream >> run) {
+    runs.push_back(run);
+  }
+  std::sort(runs.begin(), runs.end());
+  runs.erase(std::unique(runs.begin(), runs.end()), runs.end());
+  return runs;
+}
+
+} // namespace o2
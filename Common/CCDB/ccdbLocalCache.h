@@ -0,0 +1,99 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   ccdbLocalCache.h
+/// \brief  Node-local on-disk cache of run-wise CCDB objects, with asynchronous prefetching
+///
+/// Objects that are constant over a run (e.g. GRPLHCIF, CTP configuration and scalers, Zorro counters)
+/// are stored as <cacheDir>/<ccdb path>/run<runNumber>.root, so that all the processes of a train
+/// running on the same node download them only once. Files are written atomically, hence several
+/// processes can share the same directory. The cache is disabled unless a directory is configured,
+/// either with configure() or with the O2PHYSICS_CCDB_LOCALCACHE environment variable.
+///
+
+#ifndef COMMON_CCDB_CCDBLOCALCACHE_H_
+#define COMMON_CCDB_CCDBLOCALCACHE_H_
+
+#include <TFile.h>
+
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "CCDB/CcdbApi.h"
+#include "Common/Core/MetadataHelper.h"
+
+namespace o2
+{
+
+class ccdbLocalCache
+{
+ public:
+  /// CCDB object to be prefetched for each run
+  struct Request {
+    std::string path;           /// CCDB path
+    bool useRunMetadata = true; /// Query with the runNumber metadata
+  };
+
+  /// Access to the process-wide instance
+  static ccdbLocalCache& instance();
+
+  /// Configure the cache
+  /// \param cacheDir node-local directory of the cache (empty = cache disabled)
+  /// \param prefetchThreads number of threads used to prefetch the objects
+  void configure(std::string const& cacheDir, int prefetchThreads = 4);
+  bool isEnabled() const { return !mCacheDir.empty(); }
+
+  /// Download asynchronously the requested objects of all the runs that are not in the cache yet
+  void prefetch(std::string const& ccdbUrl, std::vector<int> const& runs, std::vector<Request> const& requests);
+  /// Wait for the pending prefetches, called automatically by the first look-up
+  void waitForPrefetch();
+
+  /// Get an object valid for the whole run, from the local cache if available and from CCDB otherwise
+  /// \return a new object owned by the caller, nullptr if it is neither in the cache nor in CCDB
+  template <typename T>
+  std::shared_ptr<T> getForRun(std::string const& ccdbUrl, std::string const& path, int runNumber, int64_t timestamp, bool useRunMetadata = true)
+  {
+    const std::string fileName = getLocalFile(ccdbUrl, path, runNumber, timestamp, useRunMetadata);
+    if (fileName.empty()) {
+      return nullptr;
+    }
+    std::unique_ptr<TFile> file{TFile::Open(fileName.data(), "READ")};
+    if (!file || file->IsZombie()) {
+      return nullptr;
+    }
+    return std::shared_ptr<T>(o2::ccdb::CcdbApi::extractFromTFile<T>(*file));
+  }
+
+  /// Runs of the input files, from the (comma or space separated) Run entry of the AOD metadata
+  static std::vector<int> runsFromMetadata(MetadataHelper const& metadataInfo);
+
+ private:
+  ccdbLocalCache();
+
+  std::string getLocalFile(std::string const& ccdbUrl, std::string const& path, int runNumber, int64_t timestamp, bool useRunMetadata);
+  std::string getFileName(std::string const& path, int runNumber) const;
+  bool download(o2::ccdb::CcdbApi const& api, std::string const& path, int runNumber, int64_t timestamp, bool useRunMetadata) const;
+
+  std::mutex mMutex;
+  std::string mCacheDir = "";
+  int mPrefetchThreads = 4;
+  std::vector<std::future<void>> mPrefetches;
+  std::map<std::string, std::unique_ptr<o2::ccdb::CcdbApi>> mApis; /// CCDB clients of the look-ups, by URL
+};
+
+} // namespace o2
+
+#endif // COMMON_CCDB_CCDBLOCALCACHE_H_
@@ -12,6 +12,7 @@
 #include "ctpRateFetcher.h"
 
 #include <map>
+#include <string>
 #include <vector>
 
 #include "CommonConstants/LHCConstants.h"
@@ -19,6 +20,7 @@
 #include "DataFormatsCTP/Scalers.h"
 #include "DataFormatsParameters/GRPLHCIFData.h"
 #include "CCDB/BasicCCDBManager.h"
+#include "ccdbLocalCache.h"
 
 namespace o2
 {
@@ -56,15 +58,20 @@ double ctpRateFetcher::fetch(o2::ccdb::BasicCCDBManager* ccdb, uint64_t timeStam
 
 double ctpRateFetcher::fetchCTPratesClasses(o2::ccdb::BasicCCDBManager* /*ccdb*/, uint64_t timeStamp, int /*runNumber*/, const std::string& className, int inputType)
 {
-  std::vector<ctp::CTPClass> ctpcls = mConfig->getCTPClasses();
-  std::vector<int> clslist = mConfig->getTriggerClassList();
-  int classIndex = -1;
-  for (size_t i = 0; i < clslist.size(); i++) {
-    if (ctpcls[i].name.find(className) != std::string::npos) {
-      classIndex = i;
-      break;
+  auto found = mClassIndices.find(className);
+  if (found == mClassIndices.end()) {
+    const auto& ctpcls = mConfig->getCTPClasses();
+    const auto& clslist = mConfig->getTriggerClassList();
+    int classIndex = -1;
+    for (size_t i = 0; i < clslist.size(); i++) {
+      if (ctpcls[i].name.find(className) != std::string::npos) {
+        classIndex = i;
+        break;
+      }
     }
+    found = mClassIndices.emplace(className, classIndex).first;
   }
+  const int classIndex = found->second;
   if (classIndex == -1) {
     LOG(warn) << "Trigger class " << className << " not found in CTPConfiguration";
     return -1.;
@@ -75,8 +82,7 @@ double ctpRateFetcher::fetchCTPratesClasses(o2::ccdb::BasicCCDBManager* /*ccdb*/
 
 double ctpRateFetcher::fetchCTPratesInputs(o2::ccdb::BasicCCDBManager* /*ccdb*/, uint64_t timeStamp, int /*runNumber*/, int input)
 {
-  std::vector<ctp::CTPScalerRecordO2> recs = mScalers->getScalerRecordO2();
-  if (recs[0].scalersInps.size() == 48) {
+  if (mInputsAvailable) {
     return pileUpCorrection(mScalers->getRateGivenT(timeStamp * 1.e-3, input, 7).second);
   } else {
     LOG(error) << "Inputs not available";
@@ -89,9 +95,7 @@ double ctpRateFetcher::pileUpCorrection(double triggerRate)
   if (mLHCIFdata == nullptr) {
     LOG(fatal) << "No filling" << std::endl;
   }
-  auto bfilling = mLHCIFdata->getBunchFilling();
-  std::vector<int> bcs = bfilling.getFilledBCs();
-  double nbc = bcs.size();
+  double nbc = mNfilledBCs;
   double nTriggersPerFilledBC = triggerRate / nbc / constants::lhc::LHCRevFreq;
   double mu = -std::log(1 - nTriggersPerFilledBC);
   return mu * nbc * constants::lhc::LHCRevFreq;
@@ -104,26 +108,49 @@ void ctpRateFetcher::setupRun(int runNumber, o2::ccdb::BasicCCDBManager* ccdb, u
   }
   mRunNumber = runNumber;
   LOG(debug) << "Setting up CTP scalers for run " << mRunNumber;
-  if (mManualCleanup) {
+  if (mManualCleanup && mLocalCacheObjects.empty()) {
     delete mConfig;
     delete mScalers;
     delete mLHCIFdata;
   }
-  std::map<string, string> metadata;
-  mLHCIFdata = ccdb->getSpecific<parameters::GRPLHCIFData>("GLO/Config/GRPLHCIF", timeStamp, metadata);
+  mLocalCacheObjects.clear();
+  auto& localCache = ccdbLocalCache::instance();
+  if (localCache.isEnabled()) {
+    auto lhcifData = localCache.getForRun<parameters::GRPLHCIFData>(ccdb->getURL(), "GLO/Config/GRPLHCIF", mRunNumber, timeStamp, false);
+    auto config = localCache.getForRun<ctp::CTPConfiguration>(ccdb->getURL(), "CTP/Config/Config", mRunNumber, timeStamp);
+    auto scalers = localCache.getForRun<ctp::CTPRunScalers>(ccdb->getURL(), "CTP/Calib/Scalers", mRunNumber, timeStamp);
+    mLHCIFdata = lhcifData.get();
+    mConfig = config.get();
+    mScalers = scalers.get();
+    mLocalCacheObjects = {lhcifData, config, scalers};
+  } else {
+    std::map<string, string> metadata;
+    mLHCIFdata = ccdb->getSpecific<parameters::GRPLHCIFData>("GLO/Config/GRPLHCIF", timeStamp, metadata);
+    metadata["runNumber"] = std::to_string(mRunNumber);
+    mConfig = ccdb->getSpecific<ctp::CTPConfiguration>("CTP/Config/Config", timeStamp, metadata);
+    mScalers = ccdb->getSpecific<ctp::CTPRunScalers>("CTP/Calib/Scalers", timeStamp, metadata);
+  }
   if (mLHCIFdata == nullptr) {
     LOG(fatal) << "GRPLHCIFData not in database, timestamp:" << timeStamp;
   }
-  metadata["runNumber"] = std::to_string(mRunNumber);
-  mConfig = ccdb->getSpecific<ctp::CTPConfiguration>("CTP/Config/Config", timeStamp, metadata);
   if (mConfig == nullptr) {
     LOG(fatal) << "CTPRunConfig not in database, timestamp:" << timeStamp;
   }
-  mScalers = ccdb->getSpecific<ctp::CTPRunScalers>("CTP/Calib/Scalers", timeStamp, metadata);
   if (mScalers == nullptr) {
     LOG(fatal) << "CTPRunScalers not in database, timestamp:" << timeStamp;
   }
   mScalers->convertRawToO2();
+
+  // quantities that do not change within the run, instead of recomputing them at each fetch
+  mNfilledBCs = mLHCIFdata->getBunchFilling().getFilledBCs().size();
+  const auto& recs = mScalers->getScalerRecordO2();
+  mInputsAvailable = !recs.empty() && recs[0].scalersInps.size() == 48;
+  mClassIndices.clear();
+}
+
+void ctpRateFetcher::prefetch(o2::ccdb::BasicCCDBManager* ccdb, std::vector<int> const& runs)
+{
+  ccdbLocalCache::instance().prefetch(ccdb->getURL(), runs, {{"GLO/Config/GRPLHCIF", false}, {"CTP/Config/Config", true}, {"CTP/Calib/Scalers", true}});
 }
 
 } // namespace o2
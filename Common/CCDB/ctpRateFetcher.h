@@ -12,7 +12,10 @@
 #ifndef COMMON_CCDB_CTPRATEFETCHER_H_
 #define COMMON_CCDB_CTPRATEFETCHER_H_
 
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "CCDB/BasicCCDBManager.h"
 
@@ -38,6 +41,9 @@ class ctpRateFetcher
 
   void setManualCleanup(bool manualCleanup = true) { mManualCleanup = manualCleanup; }
 
+  /// Prefetch the CCDB objects of the given runs into the local cache, if enabled (see ccdbLocalCache)
+  static void prefetch(o2::ccdb::BasicCCDBManager* ccdb, std::vector<int> const& runs);
+
  private:
   double fetchCTPratesInputs(o2::ccdb::BasicCCDBManager* ccdb, uint64_t timeStamp, int runNumber, int input);
   double fetchCTPratesClasses(o2::ccdb::BasicCCDBManager* ccdb, uint64_t timeStamp, int runNumber, const std::string& className, int inputType = 1);
@@ -49,6 +55,10 @@ class ctpRateFetcher
   ctp::CTPConfiguration* mConfig = nullptr;
   ctp::CTPRunScalers* mScalers = nullptr;
   parameters::GRPLHCIFData* mLHCIFdata = nullptr;
+  int mNfilledBCs = 0;                                   /// Number of filled bunches of the current run
+  bool mInputsAvailable = false;                         /// Whether the scalers of the current run include the inputs
+  std::unordered_map<std::string, int> mClassIndices;    /// Index of the trigger classes already looked up in the current run, -1 if absent
+  std::vector<std::shared_ptr<void>> mLocalCacheObjects; /// Objects of the current run read from the local cache
 };
 } // namespace o2
 
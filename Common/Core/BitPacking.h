@@ -0,0 +1,209 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   BitPacking.h
+/// \brief  Quantisation of floats into few-bit codes and packing of several codes into one table column
+///
+/// A codec maps a float to a code of nBits bits and back. The top code of every codec is reserved
+/// for non-finite inputs and decodes to NaN, so that any selection on the decoded value fails.
+///  - UniformCodec: equidistant levels in [min, max], values outside saturate to min or max
+///  - AsinhCodec: levels equidistant in asinh(x / scale), i.e. linear around 0 and logarithmic in the tails
+///  - TabulatedCodec: arbitrary bin edges (e.g. quantiles or the cut values used by the analyses),
+///    decoded to the bin centre, with one underflow and one overflow code decoded to the first and last edge.
+///    Cuts placed on the edges give the same result on the decoded value as on the original one.
+/// PackedLayout<TWord, Codecs...> places the codes of several quantities in one unsigned word.
+/// DECLARE_SOA_PACKED_COLUMN declares the dynamic column decoding one of them.
+///
+
+#ifndef COMMON_CORE_BITPACKING_H_
+#define COMMON_CORE_BITPACKING_H_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace o2::common::core::packing
+{
+
+template <int NBits>
+struct CodecBase {
+  static_assert(NBits > 1 && NBits <= 32, "Invalid number of bits");
+  static constexpr int nBits = NBits;
+  static constexpr uint32_t invalidCode = static_cast<uint32_t>((uint64_t{1} << NBits) - 1);
+  static constexpr uint32_t nValidCodes = invalidCode; // codes 0 ... invalidCode - 1
+};
+
+/// Equidistant levels, the central one is 0 for a symmetric range
+template <int NBits, float Min, float Max>
+struct UniformCodec : CodecBase<NBits> {
+  using CodecBase<NBits>::invalidCode;
+  static_assert(Min < Max, "Invalid range");
+  static constexpr float step = (Max - Min) / (CodecBase<NBits>::nValidCodes - 1);
+
+  static uint32_t encode(float value)
+  {
+    if (!std::isfinite(value)) {
+      return invalidCode;
+    }
+    return std::min(static_cast<uint32_t>((std::clamp(value, Min, Max) - Min) / step + 0.5f), CodecBase<NBits>::nValidCodes - 1);
+  }
+  static float decode(uint32_t code)
+  {
+    return code == invalidCode ? std::numeric_limits<float>::quiet_NaN() : Min + step * code;
+  }
+};
+
+/// Levels equidistant in asinh(x / Scale): resolution ~Scale / levels around 0, relative in the tails
+template <int NBits, float Min, float Max, float Scale>
+struct AsinhCodec : CodecBase<NBits> {
+  using CodecBase<NBits>::invalidCode;
+  static_assert(Min < Max && Scale > 0, "Invalid range");
+
+  static uint32_t encode(float value)
+  {
+    if (!std::isfinite(value)) {
+      return invalidCode;
+    }
+    const Range& r = range();
+    return std::min(static_cast<uint32_t>(std::max((std::asinh(std::clamp(value, Min, Max) / Scale) - r.uMin) * r.invStep + 0.5f, 0.f)), CodecBase<NBits>::nValidCodes - 1);
+  }
+  static float decode(uint32_t code)
+  {
+    if (code == invalidCode) {
+      return std::numeric_limits<float>::quiet_NaN();
+    }
+    const Range& r = range();
+    return Scale * std::sinh(r.uMin + r.step * code);
+  }
+
+ private:
+  struct Range {
+    float uMin, step, invStep;
+  };
+  static const Range& range()
+  {
+    static const Range r = [] {
+      const float uMin = std::asinh(Min / Scale);
+      const float step = (std::asinh(Max / Scale) - uMin) / (CodecBase<NBits>::nValidCodes - 1);
+      return Range{uMin, step, 1.f / step};
+    }();
+    return r;
+  }
+};
+
+/// Bins given by sorted edges: code 0 underflow, 1 ... N - 1 the bins, N overflow
+template <int NBits, auto Edges>
+struct TabulatedCodec : CodecBase<NBits> {
+  using CodecBase<NBits>::invalidCode;
+  static constexpr int nEdges = Edges.size();
+  static_assert(nEdges >= 2 && nEdges + 1 <= static_cast<int>(CodecBase<NBits>::nValidCodes), "Too many edges for the number of bits");
+
+  static uint32_t encode(float value)
+  {
+    if (!std::isfinite(value)) {
+      return invalidCode;
+    }
+    return std::upper_bound(Edges.begin(), Edges.end(), value) - Edges.begin();
+  }
+  static float decode(uint32_t code)
+  {
+    if (code == invalidCode) {
+      return std::numeric_limits<float>::quiet_NaN();
+    }
+    if (code == 0) {
+      return Edges.front();
+    }
+    if (code >= static_cast<uint32_t>(nEdges)) {
+      return Edges.back();
+    }
+    return 0.5f * (Edges[code - 1] + Edges[code]);
+  }
+};
+
+/// Codes of several quantities in one word, the first codec in the lowest bits
+template <typename TWord, typename... Codecs>
+struct PackedLayout {
+  static_assert(std::is_unsigned_v<TWord>, "The packed word must be unsigned");
+  using word_t = TWord;
+  static constexpr int nFields = sizeof...(Codecs);
+  template <int I>
+  using codec = std::tuple_element_t<I, std::tuple<Codecs...>>;
+
+  static constexpr int offset(int field)
+  {
+    constexpr std::array<int, nFields> nBits{Codecs::nBits...};
+    int res = 0;
+    for (int i = 0; i < field; i++) {
+      res += nBits[i];
+    }
+    return res;
+  }
+  static constexpr int nBitsUsed = offset(nFields);
+  static_assert(nBitsUsed <= 8 * static_cast<int>(sizeof(TWord)), "The codecs do not fit in the packed word");
+
+  template <typename... Ts>
+  static word_t pack(Ts... values)
+  {
+    static_assert(sizeof...(Ts) == nFields, "One value per field expected");
+    return packImpl(std::index_sequence_for<Codecs...>{}, static_cast<float>(values)...);
+  }
+
+  template <int I>
+  static uint32_t code(word_t word)
+  {
+    constexpr word_t mask = static_cast<word_t>((uint64_t{1} << codec<I>::nBits) - 1);
+    return static_cast<uint32_t>((word >> offset(I)) & mask);
+  }
+
+  template <int I>
+  static float unpack(word_t word)
+  {
+    return codec<I>::decode(code<I>(word));
+  }
+
+ private:
+  template <std::size_t... Is, typename... Ts>
+  static word_t packImpl(std::index_sequence<Is...>, Ts... values)
+  {
+    return (static_cast<word_t>(static_cast<word_t>(codec<Is>::encode(values)) << offset(Is)) | ...);
+  }
+};
+
+/// Edges of nEdges - 1 bins with equal population in the given sample, to build a TabulatedCodec offline
+inline std::vector<float> quantileEdges(std::vector<float> sample, int nEdges)
+{
+  sample.erase(std::remove_if(sample.begin(), sample.end(), [](float x) { return !std::isfinite(x); }), sample.end());
+  if (sample.empty() || nEdges < 2) {
+    return {};
+  }
+  std::sort(sample.begin(), sample.end());
+  std::vector<float> edges(nEdges);
+  for (int i = 0; i < nEdges; i++) {
+    edges[i] = sample[static_cast<std::size_t>(static_cast<double>(i) * (sample.size() - 1) / (nEdges - 1))];
+  }
+  edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+  return edges;
+}
+
+} // namespace o2::common::core::packing
+
+/// Dynamic column decoding the field _Index_ of a word packed with _Layout_ (an alias of a PackedLayout)
+#define DECLARE_SOA_PACKED_COLUMN(_Name_, _Getter_, _Layout_, _Index_) \
+  DECLARE_SOA_DYNAMIC_COLUMN(_Name_, _Getter_, [](_Layout_::word_t word) -> float { return _Layout_::unpack<_Index_>(word); })
+
+#endif // COMMON_CORE_BITPACKING_H_
@@ -20,6 +20,9 @@
 #ifndef COMMON_CORE_COLLISIONASSOCIATION_H_
 #define COMMON_CORE_COLLISIONASSOCIATION_H_
 
+#include <algorithm>
+#include <cstdint>
+#include <limits>
 #include <vector>
 #include <memory>
 #include <utility>
@@ -57,6 +60,7 @@ class CollisionAssociation
   void setIncludeUnassigned(bool enable = true) { mIncludeUnassigned = enable; }
   void setFillTableOfCollIdsPerTrack(bool fill = true) { mFillTableOfCollIdsPerTrack = fill; }
   void setBcWindow(int bcWindow = 115) { mBcWindowForOneSigma = bcWindow; }
+  void setUseTimeIndex(bool enable = true) { mUseTimeIndex = enable; }
 
   template <typename TTracks, typename Slice, typename Assoc, typename RevIndices>
   void runStandardAssoc(o2::aod::Collisions const& collisions,
@@ -125,6 +129,38 @@ class CollisionAssociation
                         Assoc& association,
                         RevIndices& reverseIndices)
   {
+    // dense map from track index to the first globalBC of its ambiguous-track entry (-1: no BC, -2: no entry), replaces a scan of the ambiguous tracks per track
+    std::vector<int64_t> ambiguousTrackBC;
+    if (mIncludeUnassigned) {
+      ambiguousTrackBC.assign(tracksUnfiltered.size(), -2);
+      for (const auto& ambTrack : ambiguousTracks) {
+        int64_t trackId = -1;
+        if constexpr (isCentralBarrel) { // FIXME: to be removed as soon as it is possible to use getId<Table>() for joined tables
+          trackId = ambTrack.trackId();
+        } else {
+          trackId = ambTrack.template getId<TTracks>();
+        }
+        if (trackId < 0) {
+          continue;
+        }
+        if (trackId >= static_cast<int64_t>(ambiguousTrackBC.size())) {
+          ambiguousTrackBC.resize(trackId + 1, -2);
+        }
+        if (ambiguousTrackBC[trackId] != -2) {
+          continue; // the first entry of a track wins
+        }
+        if constexpr (isCentralBarrel) {
+          if (!ambTrack.has_bc() || ambTrack.bc().size() == 0) {
+            ambiguousTrackBC[trackId] = -1;
+          } else {
+            ambiguousTrackBC[trackId] = ambTrack.bc().begin().globalBC();
+          }
+        } else {
+          ambiguousTrackBC[trackId] = ambTrack.bc().begin().globalBC();
+        }
+      }
+    }
+
     // cache globalBC and track time in BC for optimization
     std::vector<int64_t> globalBC;
     std::vector<int64_t> trackBCCache;
@@ -142,21 +178,9 @@ class CollisionAssociation
       if (track.has_collision()) {
         trackBC = track.collision().bc().globalBC();
       } else if (mIncludeUnassigned) {
-        for (const auto& ambTrack : ambiguousTracks) {
-          if constexpr (isCentralBarrel) { // FIXME: to be removed as soon as it is possible to use getId<Table>() for joined tables
-            if (ambTrack.trackId() == track.globalIndex()) {
-              if (!ambTrack.has_bc() || ambTrack.bc().size() == 0) {
-                break;
-              }
-              trackBC = ambTrack.bc().begin().globalBC();
-              break;
-            }
-          } else {
-            if (ambTrack.template getId<TTracks>() == track.globalIndex()) {
-              trackBC = ambTrack.bc().begin().globalBC();
-              break;
-            }
-          }
+        const int64_t trackId = track.globalIndex();
+        if (trackId < static_cast<int64_t>(ambiguousTrackBC.size()) && ambiguousTrackBC[trackId] >= 0) {
+          trackBC = ambiguousTrackBC[trackId];
         }
       }
       globalBC.push_back(trackBC);
@@ -182,15 +206,116 @@ class CollisionAssociation
 
     // loop over collisions to find time-compatible tracks
     int64_t bcOffsetMax = mBcWindowForOneSigma * mNumSigmaForTimeCompat + mTimeMargin / o2::constants::lhc::LHCBunchSpacingNS;
+
+    // time index: windows without the sorted-by-BC optimisation below are indexed by the time of their tracks in BC, so that the
+    // candidates of a collision, i.e. the tracks with |trackBCCache - collBC| <= bcOffsetMax, are found with two binary searches
+    std::vector<std::vector<std::pair<int64_t, int64_t>>> timeIndex(trackIterationWindows.size()); // (time in BC, filtered index) per window
+    std::vector<int64_t> candidates;
+    if (mUseTimeIndex) {
+      for (size_t iWindow = 0; iWindow < trackIterationWindows.size(); ++iWindow) {
+        const auto& iterationWindow = trackIterationWindows[iWindow];
+        const bool isAssignedTrackWindow = (iterationWindow.first != iterationWindow.second) ? iterationWindow.first.has_collision() : false;
+        if (isCentralBarrel && isAssignedTrackWindow) {
+          continue;
+        }
+        for (auto track = iterationWindow.first; track != iterationWindow.second; ++track) {
+          if (globalBC[track.filteredIndex()] >= 0) {
+            timeIndex[iWindow].emplace_back(trackBCCache[track.filteredIndex()], track.filteredIndex());
+          }
+        }
+        std::sort(timeIndex[iWindow].begin(), timeIndex[iWindow].end());
+      }
+    }
+
     for (const auto& collision : collisions) {
       const float collTime = collision.collisionTime();
       const float collTimeRes2 = collision.collisionTimeRes() * collision.collisionTimeRes();
+      const float collTimeWindow = mNumSigmaForTimeCompat * std::sqrt(collTimeRes2) + mTimeMargin; // window of the tracks whose time resolution is a range
       uint64_t collBC = collision.bc().globalBC();
 
+      // time compatibility of a track which passed the BC pre-selection
+      auto associateIfCompatible = [&](auto const& track, int64_t trackBC) {
+        const int64_t bcOffset = trackBC - (int64_t)collBC;
+
+        float trackTime = 0;
+        float trackTimeRes = 0;
+        if constexpr (isCentralBarrel) {
+          if (mUsePvAssociation && track.isPVContributor()) {
+            trackTime = track.collision().collisionTime();        // if PV contributor, we assume the time to be the one of the collision
+            trackTimeRes = o2::constants::lhc::LHCBunchSpacingNS; // 1 BC
+          } else {
+            trackTime = track.trackTime();
+            trackTimeRes = track.trackTimeRes();
+          }
+        } else {
+          trackTime = track.trackTime();
+          trackTimeRes = track.trackTimeRes();
+        }
+
+        const float deltaTime = trackTime - collTime + bcOffset * o2::constants::lhc::LHCBunchSpacingNS;
+        float sigmaTimeRes2 = collTimeRes2 + trackTimeRes * trackTimeRes;
+        LOGP(debug, "collision time={}, collision time res={}, track time={}, track time res={}, bc collision={}, bc track={}, delta time={}", collTime, collision.collisionTimeRes(), track.trackTime(), track.trackTimeRes(), collBC, trackBC, deltaTime);
+
+        float thresholdTime = 0.;
+        if constexpr (isCentralBarrel) {
+          if (mUsePvAssociation && track.isPVContributor()) {
+            thresholdTime = trackTimeRes;
+          } else if (TESTBIT(track.flags(), o2::aod::track::TrackTimeResIsRange)) {
+            // the track time resolution is a range, not a gaussian resolution
+            thresholdTime = trackTimeRes + collTimeWindow;
+          } else {
+            thresholdTime = mNumSigmaForTimeCompat * std::sqrt(sigmaTimeRes2) + mTimeMargin;
+          }
+        } else {
+          // the track is not a central track
+          if constexpr (TTracks::template contains<o2::aod::MFTTracks>()) {
+            // then the track is an MFT track, or an MFT track with additionnal joined info
+            // in this case TrackTimeResIsRange
+            thresholdTime = trackTimeRes + collTimeWindow;
+          } else if constexpr (TTracks::template contains<o2::aod::FwdTracks>()) {
+            // the track is a fwd track, with a gaussian time resolution
+            thresholdTime = mNumSigmaForTimeCompat * std::sqrt(sigmaTimeRes2) + mTimeMargin;
+          }
+        }
+
+        if (std::abs(deltaTime) < thresholdTime) {
+          const auto collIdx = collision.globalIndex();
+          const auto trackIdx = track.globalIndex();
+          LOGP(debug, "Filling track id {} for coll id {}", trackIdx, collIdx);
+          association(collIdx, trackIdx);
+          if (mFillTableOfCollIdsPerTrack) {
+            if (collsPerTrack[trackIdx] == nullptr) {
+              collsPerTrack[trackIdx] = std::make_unique<std::vector<int>>();
+            }
+            collsPerTrack[trackIdx].get()->push_back(collIdx);
+          }
+        }
+      };
+
       // This is done per block to allow optimization below. Within each block the globalBC increase continously
-      for (auto& iterationWindow : trackIterationWindows) {
+      for (size_t iWindow = 0; iWindow < trackIterationWindows.size(); ++iWindow) {
+        auto& iterationWindow = trackIterationWindows[iWindow];
         bool iteratorMoved = false;
         const bool isAssignedTrackWindow = (iterationWindow.first != iterationWindow.second) ? iterationWindow.first.has_collision() : false;
+
+        if (mUseTimeIndex && !(isCentralBarrel && isAssignedTrackWindow)) {
+          // candidates of the time index, visited in the same (filtered index) order as the sequential scan
+          const auto& index = timeIndex[iWindow];
+          auto first = std::lower_bound(index.begin(), index.end(), std::make_pair((int64_t)collBC - bcOffsetMax, std::numeric_limits<int64_t>::min()));
+          auto last = std::upper_bound(first, index.end(), std::make_pair((int64_t)collBC + bcOffsetMax, std::numeric_limits<int64_t>::max()));
+          candidates.clear();
+          for (auto it = first; it != last; ++it) {
+            candidates.push_back(it->second);
+          }
+          std::sort(candidates.begin(), candidates.end());
+          auto track = iterationWindow.first;
+          for (const auto& candidate : candidates) {
+            track.setCursor(candidate);
+            associateIfCompatible(track, globalBC[candidate]);
+          }
+          continue;
+        }
+
         for (auto track = iterationWindow.first; track != iterationWindow.second; ++track) {
           int64_t trackBC = globalBC[track.filteredIndex()];
           if (trackBC < 0) {
@@ -219,59 +344,7 @@ class CollisionAssociation
             continue;
           }
 
-          float trackTime = 0;
-          float trackTimeRes = 0;
-          if constexpr (isCentralBarrel) {
-            if (mUsePvAssociation && track.isPVContributor()) {
-              trackTime = track.collision().collisionTime();        // if PV contributor, we assume the time to be the one of the collision
-              trackTimeRes = o2::constants::lhc::LHCBunchSpacingNS; // 1 BC
-            } else {
-              trackTime = track.trackTime();
-              trackTimeRes = track.trackTimeRes();
-            }
-          } else {
-            trackTime = track.trackTime();
-            trackTimeRes = track.trackTimeRes();
-          }
-
-          const float deltaTime = trackTime - collTime + bcOffset * o2::constants::lhc::LHCBunchSpacingNS;
-          float sigmaTimeRes2 = collTimeRes2 + trackTimeRes * trackTimeRes;
-          LOGP(debug, "collision time={}, collision time res={}, track time={}, track time res={}, bc collision={}, bc track={}, delta time={}", collTime, collision.collisionTimeRes(), track.trackTime(), track.trackTimeRes(), collBC, trackBC, deltaTime);
-
-          float thresholdTime = 0.;
-          if constexpr (isCentralBarrel) {
-            if (mUsePvAssociation && track.isPVContributor()) {
-              thresholdTime = trackTimeRes;
-            } else if (TESTBIT(track.flags(), o2::aod::track::TrackTimeResIsRange)) {
-              // the track time resolution is a range, not a gaussian resolution
-              thresholdTime = trackTimeRes + mNumSigmaForTimeCompat * std::sqrt(collTimeRes2) + mTimeMargin;
-            } else {
-              thresholdTime = mNumSigmaForTimeCompat * std::sqrt(sigmaTimeRes2) + mTimeMargin;
-            }
-          } else {
-            // the track is not a central track
-            if constexpr (TTracks::template contains<o2::aod::MFTTracks>()) {
-              // then the track is an MFT track, or an MFT track with additionnal joined info
-              // in this case TrackTimeResIsRange
-              thresholdTime = trackTimeRes + mNumSigmaForTimeCompat * std::sqrt(collTimeRes2) + mTimeMargin;
-            } else if constexpr (TTracks::template contains<o2::aod::FwdTracks>()) {
-              // the track is a fwd track, with a gaussian time resolution
-              thresholdTime = mNumSigmaForTimeCompat * std::sqrt(sigmaTimeRes2) + mTimeMargin;
-            }
-          }
-
-          if (std::abs(deltaTime) < thresholdTime) {
-            const auto collIdx = collision.globalIndex();
-            const auto trackIdx = track.globalIndex();
-            LOGP(debug, "Filling track id {} for coll id {}", trackIdx, collIdx);
-            association(collIdx, trackIdx);
-            if (mFillTableOfCollIdsPerTrack) {
-              if (collsPerTrack[trackIdx] == nullptr) {
-                collsPerTrack[trackIdx] = std::make_unique<std::vector<int>>();
-              }
-              collsPerTrack[trackIdx].get()->push_back(collIdx);
-            }
-          }
+          associateIfCompatible(track, trackBC);
         }
       }
     }
@@ -298,6 +371,7 @@ class CollisionAssociation
   bool mIncludeUnassigned{true};                                                     // include tracks that were originally not assigned to any collision
   bool mFillTableOfCollIdsPerTrack{false};                                           // fill additional table with vectors of compatible collisions per track
   int mBcWindowForOneSigma{115};                                                     // BC window to be multiplied by the number of sigmas to define maximum window to be considered
+  bool mUseTimeIndex{true};                                                          // find the candidates of unsorted track blocks with a time index instead of a full scan
 };
 
 #endif // COMMON_CORE_COLLISIONASSOCIATION_H_
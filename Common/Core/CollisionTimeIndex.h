@@ -0,0 +1,111 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   CollisionTimeIndex.h
+/// \brief  Per-DF index of the collisions sorted in time, with prefix sums of their multiplicities
+///
+/// Queries like "sum of the tracks of the other collisions within +/- dt" become two binary searches
+/// and a subtraction instead of a scan of the neighbouring collisions. Ranges are expressed as
+/// half-open intervals [first, last) of positions in time order.
+///
+
+#ifndef COMMON_CORE_COLLISIONTIMEINDEX_H_
+#define COMMON_CORE_COLLISIONTIMEINDEX_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace o2::common::core
+{
+
+class CollisionTimeIndex
+{
+ public:
+  /// Build the index of a DF
+  /// \param globalBCs global BC of each collision, indexed by collision
+  /// \param nTracks number of tracks of each collision
+  /// \param ampFT0C FT0C amplitude of each collision
+  /// \param ampThresholds FT0C thresholds for which the number of collisions above threshold is counted
+  void build(std::vector<int64_t> const& globalBCs, std::vector<int> const& nTracks, std::vector<float> const& ampFT0C, std::vector<float> const& ampThresholds = {})
+  {
+    const int n = globalBCs.size();
+    mCollisions.resize(n);
+    std::iota(mCollisions.begin(), mCollisions.end(), 0);
+    std::stable_sort(mCollisions.begin(), mCollisions.end(), [&](int a, int b) { return globalBCs[a] < globalBCs[b]; });
+    mPositions.resize(n);
+    mGlobalBCs.resize(n);
+    mSumTracks.assign(n + 1, 0);
+    mSumAmpFT0C.assign(n + 1, 0.);
+    mCountAmpAbove.assign(ampThresholds.size(), std::vector<int>(n + 1, 0));
+    for (int pos = 0; pos < n; pos++) {
+      const int col = mCollisions[pos];
+      mPositions[col] = pos;
+      mGlobalBCs[pos] = globalBCs[col];
+      mSumTracks[pos + 1] = mSumTracks[pos] + nTracks[col];
+      mSumAmpFT0C[pos + 1] = mSumAmpFT0C[pos] + ampFT0C[col];
+      for (size_t iThr = 0; iThr < ampThresholds.size(); iThr++) {
+        mCountAmpAbove[iThr][pos + 1] = mCountAmpAbove[iThr][pos] + (ampFT0C[col] > ampThresholds[iThr]);
+      }
+    }
+  }
+
+  int size() const { return mCollisions.size(); }
+  /// Position in time order of a collision
+  int position(int collision) const { return mPositions[collision]; }
+  /// Collision at a given position in time order
+  int collisionAt(int pos) const { return mCollisions[pos]; }
+  int64_t globalBCAt(int pos) const { return mGlobalBCs[pos]; }
+
+  /// First position whose global BC does not satisfy pred; pred must be true for all the earlier BCs
+  /// (e.g. [](int64_t bc) { return bc < bcMin; }), which allows to use the exact selection of the caller
+  template <typename Pred>
+  int partitionPoint(Pred pred) const
+  {
+    return std::partition_point(mGlobalBCs.begin(), mGlobalBCs.end(), pred) - mGlobalBCs.begin();
+  }
+
+  /// Sums over the range [first, last), excluding the collision at position excluded if it is in the range
+  int64_t sumTracks(int first, int last, int excluded = -1) const
+  {
+    return first < last ? mSumTracks[last] - mSumTracks[first] - (inRange(excluded, first, last) ? mSumTracks[excluded + 1] - mSumTracks[excluded] : 0) : 0;
+  }
+  double sumAmpFT0C(int first, int last, int excluded = -1) const
+  {
+    return first < last ? mSumAmpFT0C[last] - mSumAmpFT0C[first] - (inRange(excluded, first, last) ? mSumAmpFT0C[excluded + 1] - mSumAmpFT0C[excluded] : 0.) : 0.;
+  }
+  /// Number of collisions with FT0C amplitude above the iThr-th threshold given to build()
+  int countAmpAbove(int iThr, int first, int last, int excluded = -1) const
+  {
+    auto const& count = mCountAmpAbove[iThr];
+    return first < last ? count[last] - count[first] - (inRange(excluded, first, last) ? count[excluded + 1] - count[excluded] : 0) : 0;
+  }
+  int count(int first, int last, int excluded = -1) const
+  {
+    return first < last ? last - first - inRange(excluded, first, last) : 0;
+  }
+
+ private:
+  static bool inRange(int pos, int first, int last) { return pos >= first && pos < last; }
+
+  std::vector<int> mCollisions;                 // collision indices in time order
+  std::vector<int> mPositions;                  // position in time order, by collision index
+  std::vector<int64_t> mGlobalBCs;              // sorted global BCs
+  std::vector<int64_t> mSumTracks;              // prefix sums of the number of tracks
+  std::vector<double> mSumAmpFT0C;              // prefix sums of the FT0C amplitudes
+  std::vector<std::vector<int>> mCountAmpAbove; // prefix counts of collisions above the FT0C thresholds
+};
+
+} // namespace o2::common::core
+
+#endif // COMMON_CORE_COLLISIONTIMEINDEX_H_
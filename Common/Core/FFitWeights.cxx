@@ -29,7 +29,8 @@ ClassImp(FFitWeights)
                                CentBin{100},
                                qAxis{nullptr},
                                nResolution{3000},
-                               qnTYPE{0}
+                               qnTYPE{0},
+                               fFrozen{false}
 {
 }
 
@@ -38,7 +39,8 @@ FFitWeights::FFitWeights(const char* name) : TNamed(name, name),
                                              CentBin{100},
                                              qAxis{nullptr},
                                              nResolution{3000},
-                                             qnTYPE{0} {}
+                                             qnTYPE{0},
+                                             fFrozen{false} {}
 
 FFitWeights::~FFitWeights()
 {
@@ -161,7 +163,10 @@ float FFitWeights::eval(float centr, const float& dqn, const int nh, const char*
   }
 
   TGraph* spline{nullptr};
-  spline = reinterpret_cast<TGraph*>(tar->FindObject(Form("sp_q%i%s_%i", nh, pf, isp)));
+  if (fFrozen)
+    spline = getSplines(nh, pf)[isp];
+  else
+    spline = reinterpret_cast<TGraph*>(tar->FindObject(Form("sp_q%i%s_%i", nh, pf, isp)));
   if (!spline) {
     return -1;
   }
@@ -173,3 +178,22 @@ float FFitWeights::eval(float centr, const float& dqn, const int nh, const char*
 
   return qn_val;
 };
+
+void FFitWeights::freeze()
+{
+  fSplineCache.clear();
+  fFrozen = true;
+};
+
+const std::vector<TGraph*>& FFitWeights::getSplines(const int nh, const char* pf)
+{
+  for (const auto& cache : fSplineCache) {
+    if (cache.nh == nh && cache.pf == pf)
+      return cache.splines;
+  }
+  SplineCache cache{nh, pf, std::vector<TGraph*>(91, nullptr)};
+  for (int isp{0}; isp < 91; isp++)
+    cache.splines[isp] = reinterpret_cast<TGraph*>(fW_data->FindObject(Form("sp_q%i%s_%i", nh, pf, isp)));
+  fSplineCache.push_back(std::move(cache));
+  return fSplineCache.back().splines;
+};
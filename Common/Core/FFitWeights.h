@@ -34,6 +34,8 @@
 #include "TString.h"
 #include "TMath.h"
 
+class TGraph;
+
 class FFitWeights : public TNamed
 {
  public:
@@ -58,6 +60,7 @@ class FFitWeights : public TNamed
   void setResolution(int res) { nResolution = res; }
   int getResolution() const { return nResolution; }
   void setQnType(std::vector<std::pair<int, std::string>> qninp) { qnTYPE = qninp; }
+  void freeze(); // cache the spline look-up of eval, call again if fW_data is modified afterwards
 
  private:
   TObjArray* fW_data;
@@ -68,6 +71,15 @@ class FFitWeights : public TNamed
 
   std::vector<std::pair<int, std::string>> qnTYPE;
 
+  struct SplineCache {
+    int nh;
+    std::string pf;
+    std::vector<TGraph*> splines; // indexed by centrality percentile
+  };
+  bool fFrozen;                          //!
+  std::vector<SplineCache> fSplineCache; //!
+  const std::vector<TGraph*>& getSplines(const int nh, const char* pf);
+
   const char* getQName(const int nh, const char* pf = "")
   {
     return Form("q%i%s", nh, pf);
@@ -0,0 +1,690 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   FormulaEvaluator.cxx
+/// \brief  Evaluator of TFormula expressions compiled to a small stack bytecode
+///
+
+#include "Common/Core/FormulaEvaluator.h"
+
+#include <fairlogger/Logger.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <numbers>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using o2::common::core::FormulaEvaluator;
+
+namespace
+{
+struct UnaryFunction {
+  std::string_view name;
+  double (*function)(double);
+};
+
+// Names as in the C library and in TMath, looked up after removing the std:: or TMath:: prefix
+constexpr UnaryFunction kUnaryFunctions[] = {
+  {"abs", [](double a) { return std::abs(a); }},
+  {"fabs", [](double a) { return std::abs(a); }},
+  {"Abs", [](double a) { return std::abs(a); }},
+  {"sqrt", [](double a) { return std::sqrt(a); }},
+  {"Sqrt", [](double a) { return std::sqrt(a); }},
+  {"Sq", [](double a) { return a * a; }},
+  {"exp", [](double a) { return std::exp(a); }},
+  {"Exp", [](double a) { return std::exp(a); }},
+  {"log", [](double a) { return std::log(a); }},
+  {"Log", [](double a) { return std::log(a); }},
+  {"log10", [](double a) { return std::log10(a); }},
+  {"Log10", [](double a) { return std::log10(a); }},
+  {"sin", [](double a) { return std::sin(a); }},
+  {"Sin", [](double a) { return std::sin(a); }},
+  {"cos", [](double a) { return std::cos(a); }},
+  {"Cos", [](double a) { return std::cos(a); }},
+  {"tan", [](double a) { return std::tan(a); }},
+  {"Tan", [](double a) { return std::tan(a); }},
+  {"asin", [](double a) { return std::asin(a); }},
+  {"ASin", [](double a) { return std::asin(a); }},
+  {"acos", [](double a) { return std::acos(a); }},
+  {"ACos", [](double a) { return std::acos(a); }},
+  {"atan", [](double a) { return std::atan(a); }},
+  {"ATan", [](double a) { return std::atan(a); }},
+  {"sinh", [](double a) { return std::sinh(a); }},
+  {"SinH", [](double a) { return std::sinh(a); }},
+  {"cosh", [](double a) { return std::cosh(a); }},
+  {"CosH", [](double a) { return std::cosh(a); }},
+  {"tanh", [](double a) { return std::tanh(a); }},
+  {"TanH", [](double a) { return std::tanh(a); }},
+  {"floor", [](double a) { return std::floor(a); }},
+  {"Floor", [](double a) { return std::floor(a); }},
+  {"ceil", [](double a) { return std::ceil(a); }},
+  {"Ceil", [](double a) { return std::ceil(a); }},
+  {"erf", [](double a) { return std::erf(a); }},
+  {"Erf", [](double a) { return std::erf(a); }},
+  {"erfc", [](double a) { return std::erfc(a); }},
+  {"Erfc", [](double a) { return std::erfc(a); }}};
+
+struct Constant {
+  std::string_view name;
+  double value;
+};
+
+// Constants written as identifiers (pi) or as functions without arguments (TMath::Pi())
+constexpr Constant kConstants[] = {
+  {"pi", std::numbers::pi},
+  {"Pi", std::numbers::pi},
+  {"TwoPi", 2. * std::numbers::pi},
+  {"PiOver2", std::numbers::pi / 2.},
+  {"e", std::numbers::e},
+  {"E", std::numbers::e},
+  {"sqrt2", std::numbers::sqrt2},
+  {"Sqrt2", std::numbers::sqrt2},
+  {"ln10", std::numbers::ln10},
+  {"Ln10", std::numbers::ln10}};
+
+std::string_view stripNamespace(std::string_view name)
+{
+  for (std::string_view prefix : {"TMath::", "std::"}) {
+    if (name.starts_with(prefix)) {
+      return name.substr(prefix.size());
+    }
+  }
+  return name;
+}
+} // namespace
+
+/// Recursive descent parser emitting the bytecode in postfix order. An operation whose operands are
+/// all constants is folded into a constant as soon as it is emitted, since its operands are then the
+/// last instructions of the code.
+class FormulaEvaluator::Parser
+{
+ public:
+  Parser(const std::string& expression, std::vector<Instruction>& code) : mText(expression), mCode(code) {}
+
+  void parse()
+  {
+    parseOr();
+    skipSpaces();
+    if (mPos != mText.size()) {
+      fail("unexpected character");
+    }
+  }
+  int nParameters() const { return mNParameters; }
+  int nDimensions() const { return mNDimensions; }
+
+ private:
+  [[noreturn]] void fail(const std::string& what) const
+  {
+    throw std::runtime_error(what + " at position " + std::to_string(mPos));
+  }
+
+  void skipSpaces()
+  {
+    while (mPos < mText.size() && std::isspace(static_cast<unsigned char>(mText[mPos]))) {
+      ++mPos;
+    }
+  }
+  bool accept(std::string_view token)
+  {
+    skipSpaces();
+    if (mText.compare(mPos, token.size(), token) == 0) {
+      mPos += token.size();
+      return true;
+    }
+    return false;
+  }
+  void expect(std::string_view token)
+  {
+    if (!accept(token)) {
+      fail("expected '" + std::string(token) + "'");
+    }
+  }
+  // Accept the operator op when it is not the start of the longer operator longer, e.g. * and not **
+  bool acceptOperator(std::string_view op, std::string_view longer = {})
+  {
+    skipSpaces();
+    if (!longer.empty() && mText.compare(mPos, longer.size(), longer) == 0) {
+      return false;
+    }
+    return accept(op);
+  }
+
+  void emitConstant(double value) { mCode.push_back({OpCode::kConst, 0, value}); }
+  void emitVariable(int index)
+  {
+    mCode.push_back({OpCode::kVar, index});
+    mNDimensions = std::max(mNDimensions, index + 1);
+  }
+  void emitParameter(int index)
+  {
+    mCode.push_back({OpCode::kPar, index});
+    mNParameters = std::max(mNParameters, index + 1);
+  }
+  void emitUnary(OpCode op, double (*function)(double) = nullptr)
+  {
+    auto& last = mCode.back();
+    if (last.op == OpCode::kConst) {
+      last.value = op == OpCode::kFunction ? function(last.value) : apply(op, last.value, 0.);
+      return;
+    }
+    mCode.push_back({op, 0, 0., function});
+  }
+  void emitBinary(OpCode op)
+  {
+    const auto n = mCode.size();
+    if (mCode[n - 2].op == OpCode::kConst && mCode[n - 1].op == OpCode::kConst) {
+      mCode[n - 2].value = apply(op, mCode[n - 2].value, mCode[n - 1].value);
+      mCode.pop_back();
+      return;
+    }
+    mCode.push_back({op});
+  }
+
+  void parseOr()
+  {
+    parseAnd();
+    while (acceptOperator("||")) {
+      parseAnd();
+      emitBinary(OpCode::kOr);
+    }
+  }
+  void parseAnd()
+  {
+    parseComparison();
+    while (acceptOperator("&&")) {
+      parseComparison();
+      emitBinary(OpCode::kAnd);
+    }
+  }
+  void parseComparison()
+  {
+    parseSum();
+    while (true) {
+      OpCode op;
+      if (accept("<=")) {
+        op = OpCode::kLessEqual;
+      } else if (accept(">=")) {
+        op = OpCode::kGreaterEqual;
+      } else if (accept("==")) {
+        op = OpCode::kEqual;
+      } else if (accept("!=")) {
+        op = OpCode::kNotEqual;
+      } else if (accept("<")) {
+        op = OpCode::kLess;
+      } else if (accept(">")) {
+        op = OpCode::kGreater;
+      } else {
+        return;
+      }
+      parseSum();
+      emitBinary(op);
+    }
+  }
+  void parseSum()
+  {
+    parseProduct();
+    while (true) {
+      OpCode op;
+      if (accept("+")) {
+        op = OpCode::kAdd;
+      } else if (accept("-")) {
+        op = OpCode::kSub;
+      } else {
+        return;
+      }
+      parseProduct();
+      emitBinary(op);
+    }
+  }
+  void parseProduct()
+  {
+    parseUnary();
+    while (true) {
+      OpCode op;
+      if (acceptOperator("*", "**")) {
+        op = OpCode::kMul;
+      } else if (accept("/")) {
+        op = OpCode::kDiv;
+      } else if (accept("%")) {
+        op = OpCode::kMod;
+      } else {
+        return;
+      }
+      parseUnary();
+      emitBinary(op);
+    }
+  }
+  // As in TFormula, the power binds tighter than the sign: -x^2 is -(x^2), and is right associative
+  void parseUnary()
+  {
+    if (accept("-")) {
+      parseUnary();
+      emitUnary(OpCode::kNeg);
+    } else if (accept("+")) {
+      parseUnary();
+    } else if (acceptOperator("!", "!=")) {
+      parseUnary();
+      emitUnary(OpCode::kNot);
+    } else {
+      parsePower();
+    }
+  }
+  void parsePower()
+  {
+    parsePrimary();
+    if (accept("^") || accept("**")) {
+      parseUnary();
+      emitBinary(OpCode::kPow);
+    }
+  }
+
+  void parsePrimary()
+  {
+    skipSpaces();
+    if (mPos == mText.size()) {
+      fail("unexpected end of the expression");
+    }
+    const char c = mText[mPos];
+    if (std::isdigit(static_cast<unsigned char>(c)) || c == '.') {
+      const char* begin = mText.c_str() + mPos;
+      char* end = nullptr;
+      const double value = std::strtod(begin, &end);
+      if (end == begin) {
+        fail("invalid number");
+      }
+      mPos += end - begin;
+      emitConstant(value);
+    } else if (c == '[') {
+      ++mPos;
+      emitParameter(parseIndex());
+      expect("]");
+    } else if (c == '(') {
+      ++mPos;
+      parseOr();
+      expect(")");
+    } else if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+      parseIdentifier();
+    } else {
+      fail("unexpected character");
+    }
+  }
+
+  int parseIndex()
+  {
+    skipSpaces();
+    std::size_t end = mPos;
+    while (end < mText.size() && std::isdigit(static_cast<unsigned char>(mText[end]))) {
+      ++end;
+    }
+    if (end == mPos) {
+      fail("only numbered parameters are supported");
+    }
+    const int index = std::stoi(mText.substr(mPos, end - mPos));
+    mPos = end;
+    return index;
+  }
+  // Parameter offset of the predefined functions, e.g. the 2 of pol1(2)
+  int parseOffset()
+  {
+    const auto start = mPos;
+    if (accept("(")) {
+      skipSpaces();
+      if (mPos < mText.size() && std::isdigit(static_cast<unsigned char>(mText[mPos]))) {
+        const int offset = parseIndex();
+        if (accept(")")) {
+          return offset;
+        }
+      }
+    }
+    mPos = start;
+    return 0;
+  }
+
+  void parseIdentifier()
+  {
+    const auto start = mPos;
+    while (mPos < mText.size()) {
+      const char c = mText[mPos];
+      if (std::isalnum(static_cast<unsigned char>(c)) || c == '_') {
+        ++mPos;
+      } else if (c == ':' && mPos + 1 < mText.size() && mText[mPos + 1] == ':') {
+        mPos += 2;
+      } else {
+        break;
+      }
+    }
+    const std::string_view fullName(mText.data() + start, mPos - start);
+    const std::string_view name = stripNamespace(fullName);
+    skipSpaces();
+    const bool isCall = mPos < mText.size() && mText[mPos] == '(';
+
+    if (!isCall && name.size() == 1) {
+      constexpr std::string_view kVariables = "xyzt";
+      if (const auto index = kVariables.find(name[0]); index != std::string_view::npos) {
+        emitVariable(static_cast<int>(index));
+        return;
+      }
+    }
+    for (const auto& constant : kConstants) {
+      if (name == constant.name) {
+        if (isCall) {
+          expect("(");
+          expect(")");
+        }
+        emitConstant(constant.value);
+        return;
+      }
+    }
+    if (parsePredefined(name)) {
+      return;
+    }
+    if (!isCall) {
+      fail("unknown identifier '" + std::string(fullName) + "'");
+    }
+    for (const auto& function : kUnaryFunctions) {
+      if (name == function.name) {
+        expect("(");
+        parseOr();
+        expect(")");
+        emitUnary(OpCode::kFunction, function.function);
+        return;
+      }
+    }
+    OpCode op;
+    if (name == "pow" || name == "Power") {
+      op = OpCode::kPow;
+    } else if (name == "min" || name == "Min") {
+      op = OpCode::kMin;
+    } else if (name == "max" || name == "Max") {
+      op = OpCode::kMax;
+    } else if (name == "atan2" || name == "ATan2") {
+      op = OpCode::kAtan2;
+    } else {
+      fail("unknown function '" + std::string(fullName) + "'");
+    }
+    expect("(");
+    parseOr();
+    expect(",");
+    parseOr();
+    expect(")");
+    emitBinary(op);
+  }
+
+  // polN, expo and gaus of x, with the parameters from the offset given in parentheses
+  bool parsePredefined(std::string_view name)
+  {
+    if (name.starts_with("pol") && name.size() > 3 &&
+        std::all_of(name.begin() + 3, name.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)); })) {
+      const int degree = std::stoi(std::string(name.substr(3)));
+      const int offset = parseOffset();
+      // Horner scheme
+      emitParameter(offset + degree);
+      for (int i = degree - 1; i >= 0; --i) {
+        emitVariable(0);
+        emitBinary(OpCode::kMul);
+        emitParameter(offset + i);
+        emitBinary(OpCode::kAdd);
+      }
+      return true;
+    }
+    if (name == "expo") {
+      const int offset = parseOffset();
+      emitParameter(offset);
+      emitParameter(offset + 1);
+      emitVariable(0);
+      emitBinary(OpCode::kMul);
+      emitBinary(OpCode::kAdd);
+      emitUnary(OpCode::kFunction, [](double a) { return std::exp(a); });
+      return true;
+    }
+    if (name == "gaus") {
+      const int offset = parseOffset();
+      emitParameter(offset);
+      emitVariable(0);
+      emitParameter(offset + 1);
+      emitBinary(OpCode::kSub);
+      emitParameter(offset + 2);
+      emitBinary(OpCode::kDiv);
+      emitUnary(OpCode::kFunction, [](double a) { return std::exp(-0.5 * a * a); });
+      emitBinary(OpCode::kMul);
+      return true;
+    }
+    return false;
+  }
+
+  const std::string& mText;
+  std::vector<Instruction>& mCode;
+  std::size_t mPos = 0;
+  int mNParameters = 0;
+  int mNDimensions = 0;
+};
+
+FormulaEvaluator::FormulaEvaluator(std::string_view expression)
+{
+  if (!compile(expression)) {
+    LOG(fatal) << "Cannot compile the formula \"" << expression << "\": " << mError;
+  }
+}
+
+bool FormulaEvaluator::compile(std::string_view expression)
+{
+  mExpression = expression;
+  mError.clear();
+  mCode.clear();
+  mParameters.clear();
+  mNdim = 0;
+  mStackSize = 0;
+
+  Parser parser(mExpression, mCode);
+  try {
+    parser.parse();
+  } catch (const std::runtime_error& e) {
+    mError = e.what();
+    mCode.clear();
+    return false;
+  }
+
+  std::size_t depth = 0;
+  for (const auto& instruction : mCode) {
+    switch (instruction.op) {
+      case OpCode::kConst:
+      case OpCode::kVar:
+      case OpCode::kPar:
+        mStackSize = std::max(mStackSize, ++depth);
+        break;
+      case OpCode::kNeg:
+      case OpCode::kNot:
+      case OpCode::kFunction:
+        break;
+      default:
+        --depth;
+    }
+  }
+  if (mStackSize > kMaxStack) {
+    mError = "expression nested too deeply";
+    mCode.clear();
+    return false;
+  }
+  mCode.shrink_to_fit();
+  mParameters.assign(parser.nParameters(), 0.);
+  mNdim = parser.nDimensions();
+  return true;
+}
+
+void FormulaEvaluator::setParameters(std::span<const double> values)
+{
+  std::copy_n(values.begin(), std::min(values.size(), mParameters.size()), mParameters.begin());
+}
+
+double FormulaEvaluator::apply(OpCode op, double a, double b)
+{
+  switch (op) {
+    case OpCode::kNeg:
+      return -a;
+    case OpCode::kNot:
+      return a == 0.;
+    case OpCode::kAdd:
+      return a + b;
+    case OpCode::kSub:
+      return a - b;
+    case OpCode::kMul:
+      return a * b;
+    case OpCode::kDiv:
+      return a / b;
+    case OpCode::kMod:
+      return std::fmod(a, b);
+    case OpCode::kPow:
+      return std::pow(a, b);
+    case OpCode::kLess:
+      return a < b;
+    case OpCode::kLessEqual:
+      return a <= b;
+    case OpCode::kGreater:
+      return a > b;
+    case OpCode::kGreaterEqual:
+      return a >= b;
+    case OpCode::kEqual:
+      return a == b;
+    case OpCode::kNotEqual:
+      return a != b;
+    case OpCode::kAnd:
+      return a != 0. && b != 0.;
+    case OpCode::kOr:
+      return a != 0. || b != 0.;
+    case OpCode::kMin:
+      return std::min(a, b);
+    case OpCode::kMax:
+      return std::max(a, b);
+    case OpCode::kAtan2:
+      return std::atan2(a, b);
+    default:
+      return 0.;
+  }
+}
+
+double FormulaEvaluator::run(const double* vars, const double* params) const
+{
+  if (mCode.empty()) {
+    return std::nan("");
+  }
+  double stack[kMaxStack];
+  std::size_t top = 0;
+  for (const auto& instruction : mCode) {
+    switch (instruction.op) {
+      case OpCode::kConst:
+        stack[top++] = instruction.value;
+        break;
+      case OpCode::kVar:
+        stack[top++] = vars[instruction.index];
+        break;
+      case OpCode::kPar:
+        stack[top++] = params[instruction.index];
+        break;
+      case OpCode::kFunction:
+        stack[top - 1] = instruction.function(stack[top - 1]);
+        break;
+      case OpCode::kNeg:
+      case OpCode::kNot:
+        stack[top - 1] = apply(instruction.op, stack[top - 1], 0.);
+        break;
+      default:
+        --top;
+        stack[top - 1] = apply(instruction.op, stack[top - 1], stack[top]);
+    }
+  }
+  return stack[0];
+}
+
+void FormulaEvaluator::evalBatch(std::span<const double> x, std::span<double> out) const
+{
+  const std::span<const double> columns[1] = {x};
+  evalBatch(columns, out);
+}
+
+namespace
+{
+template <typename F>
+inline void applyColumns(double* a, const double* b, std::size_t n, F f)
+{
+  for (std::size_t i = 0; i < n; ++i) {
+    a[i] = f(a[i], b[i]);
+  }
+}
+} // namespace
+
+// The points are evaluated in chunks, running each instruction over the whole chunk so that the
+// dispatch is paid once per chunk and the arithmetic loops can be vectorised
+void FormulaEvaluator::evalBatch(std::span<const std::span<const double>> columns, std::span<double> out) const
+{
+  if (mCode.empty() || static_cast<int>(columns.size()) < mNdim) {
+    std::fill(out.begin(), out.end(), std::nan(""));
+    return;
+  }
+  double stack[kMaxStack][kBatchChunk];
+  for (std::size_t first = 0; first < out.size(); first += kBatchChunk) {
+    const std::size_t n = std::min(kBatchChunk, out.size() - first);
+    std::size_t top = 0;
+    for (const auto& instruction : mCode) {
+      switch (instruction.op) {
+        case OpCode::kConst:
+          std::fill_n(stack[top++], n, instruction.value);
+          break;
+        case OpCode::kVar:
+          std::copy_n(columns[instruction.index].data() + first, n, stack[top++]);
+          break;
+        case OpCode::kPar:
+          std::fill_n(stack[top++], n, mParameters[instruction.index]);
+          break;
+        case OpCode::kFunction:
+          std::transform(stack[top - 1], stack[top - 1] + n, stack[top - 1], instruction.function);
+          break;
+        case OpCode::kNeg:
+        case OpCode::kNot: {
+          const auto op = instruction.op;
+          std::transform(stack[top - 1], stack[top - 1] + n, stack[top - 1], [op](double a) { return apply(op, a, 0.); });
+          break;
+        }
+        default: {
+          --top;
+          double* a = stack[top - 1];
+          const double* b = stack[top];
+          switch (instruction.op) {
+            case OpCode::kAdd:
+              applyColumns(a, b, n, [](double u, double v) { return u + v; });
+              break;
+            case OpCode::kSub:
+              applyColumns(a, b, n, [](double u, double v) { return u - v; });
+              break;
+            case OpCode::kMul:
+              applyColumns(a, b, n, [](double u, double v) { return u * v; });
+              break;
+            case OpCode::kDiv:
+              applyColumns(a, b, n, [](double u, double v) { return u / v; });
+              break;
+            default: {
+              const auto op = instruction.op;
+              applyColumns(a, b, n, [op](double u, double v) { return apply(op, u, v); });
+            }
+          }
+        }
+      }
+    }
+    std::copy_n(stack[0], n, out.data() + first);
+  }
+}
@@ -89,6 +89,13 @@ void TOFResoParamsV3::setTimeShiftParameters(TGraph* g, const bool positive)
 }
 float TOFResoParamsV3::getTimeShift(float eta, int16_t sign) const
 {
+  if (mUseTables && eta >= mTabEtaMin && eta < mTabEtaMax) {
+    const std::vector<float>& table = sign > 0 ? mPosTimeShiftTable : mNegTimeShiftTable;
+    const float xEta = (eta - mTabEtaMin) * mTabInvDeltaEta;
+    const int iEta = std::min(static_cast<int>(xEta), mTabNEta - 2);
+    const float wEta = xEta - iEta;
+    return (1.f - wEta) * table[iEta] + wEta * table[iEta + 1];
+  }
   if (sign > 0) {
     if (!gPosEtaTimeCorr) {
       return 0.f;
@@ -101,4 +108,70 @@ float TOFResoParamsV3::getTimeShift(float eta, int16_t sign) const
   return gNegEtaTimeCorr->Eval(eta);
 }
 
+void TOFResoParamsV3::setResolutionTables(const int nP, const float pMin, const float pMax, const int nEta, const float etaMin, const float etaMax)
+{
+  if (nP < 2 || nEta < 2 || pMin >= pMax || etaMin >= etaMax) {
+    LOG(fatal) << "TOFResoParamsV3 tables: invalid grid " << nP << " x " << nEta << " in p [" << pMin << ", " << pMax << "] and eta [" << etaMin << ", " << etaMax << "]";
+  }
+  mUseTables = false; // Tables are filled from the analytic functions
+  mTabNP = nP;
+  mTabNEta = nEta;
+  mTabPMin = pMin;
+  mTabPMax = pMax;
+  mTabEtaMin = etaMin;
+  mTabEtaMax = etaMax;
+  const float deltaP = (pMax - pMin) / (nP - 1);
+  const float deltaEta = (etaMax - etaMin) / (nEta - 1);
+  mTabInvDeltaP = 1.f / deltaP;
+  mTabInvDeltaEta = 1.f / deltaEta;
+
+  mResolutionTable.resize(9 * nP * nEta);
+  for (int pid = 0; pid < 9; pid++) {
+    for (int iP = 0; iP < nP; iP++) {
+      for (int iEta = 0; iEta < nEta; iEta++) {
+        mResolutionTable[(pid * nP + iP) * nEta + iEta] = mResolution[pid]->Eval(pMin + iP * deltaP, etaMin + iEta * deltaEta);
+      }
+    }
+  }
+  mPosTimeShiftTable.resize(nEta);
+  mNegTimeShiftTable.resize(nEta);
+  for (int iEta = 0; iEta < nEta; iEta++) {
+    mPosTimeShiftTable[iEta] = getTimeShift(etaMin + iEta * deltaEta, 1);
+    mNegTimeShiftTable[iEta] = getTimeShift(etaMin + iEta * deltaEta, -1);
+  }
+  mUseTables = true;
+  LOG(info) << "TOFResoParamsV3: tabulated resolution on " << nP << " x " << nEta << " grid in p [" << pMin << ", " << pMax << "] and eta [" << etaMin << ", " << etaMax << "]";
+}
+
+float TOFResoParamsV3::checkResolutionTables(const int nCheck) const
+{
+  if (!mUseTables) {
+    return 0.f;
+  }
+  float maxRelDeviation = 0.f;
+  float maxTimeShiftDeviation = 0.f;
+  for (int iP = 0; iP < nCheck; iP++) {
+    const float p = mTabPMin + (iP + 0.5f) / nCheck * (mTabPMax - mTabPMin);
+    for (int iEta = 0; iEta < nCheck; iEta++) {
+      const float eta = mTabEtaMin + (iEta + 0.5f) / nCheck * (mTabEtaMax - mTabEtaMin);
+      for (int pid = 0; pid < 9; pid++) {
+        const float analytic = mResolution[pid]->Eval(p, eta);
+        if (analytic <= 0.f) { // Non-positive values select the parametrisation of the expected sigma, only the sign matters
+          continue;
+        }
+        const float tabulated = interpolateResolution(mResolutionTable.data() + pid * mTabNP * mTabNEta, p, eta);
+        maxRelDeviation = std::max(maxRelDeviation, std::abs(tabulated - analytic) / analytic);
+      }
+      if (iP == 0) {
+        const float analyticPos = gPosEtaTimeCorr ? gPosEtaTimeCorr->Eval(eta) : 0.f;
+        const float analyticNeg = gNegEtaTimeCorr ? gNegEtaTimeCorr->Eval(eta) : 0.f;
+        maxTimeShiftDeviation = std::max(maxTimeShiftDeviation, std::abs(getTimeShift(eta, 1) - analyticPos));
+        maxTimeShiftDeviation = std::max(maxTimeShiftDeviation, std::abs(getTimeShift(eta, -1) - analyticNeg));
+      }
+    }
+  }
+  LOG(info) << "TOFResoParamsV3 tables: max. relative deviation of the resolution " << maxRelDeviation << ", max. deviation of the time shift " << maxTimeShiftDeviation << " ps";
+  return maxRelDeviation;
+}
+
 } // namespace o2::pid::tof
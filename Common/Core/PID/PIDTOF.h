@@ -19,6 +19,7 @@
 #ifndef COMMON_CORE_PID_PIDTOF_H_
 #define COMMON_CORE_PID_PIDTOF_H_
 
+#include <algorithm>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -173,6 +174,33 @@ class TOFResoParamsV2 : public o2::tof::Parameters<13>
   // Time shift for post calibration
   TGraph* gPosEtaTimeCorr = nullptr; /// Time shift correction for positive tracks
   TGraph* gNegEtaTimeCorr = nullptr; /// Time shift correction for negative tracks
+
+  // Tabulated resolution and time shift
+  bool mUseTables = false;
+  int mTabNP = 0;
+  int mTabNEta = 0;
+  float mTabPMin = 0.f;
+  float mTabPMax = 0.f;
+  float mTabEtaMin = 0.f;
+  float mTabEtaMax = 0.f;
+  float mTabInvDeltaP = 0.f;
+  float mTabInvDeltaEta = 0.f;
+  std::vector<float> mResolutionTable; /// Resolution, species-major then p-major: [pid][iP][iEta]
+  std::vector<float> mPosTimeShiftTable; /// Time shift for positive tracks vs eta
+  std::vector<float> mNegTimeShiftTable; /// Time shift for negative tracks vs eta
+
+  float interpolateResolution(const float* table, const float p, const float eta) const
+  {
+    const float xP = (p - mTabPMin) * mTabInvDeltaP;
+    const float xEta = (eta - mTabEtaMin) * mTabInvDeltaEta;
+    const int iP = std::min(static_cast<int>(xP), mTabNP - 2);
+    const int iEta = std::min(static_cast<int>(xEta), mTabNEta - 2);
+    const float wP = xP - iP;
+    const float wEta = xEta - iEta;
+    const float* row0 = table + iP * mTabNEta + iEta;
+    const float* row1 = row0 + mTabNEta;
+    return (1.f - wP) * ((1.f - wEta) * row0[0] + wEta * row0[1]) + wP * ((1.f - wEta) * row1[0] + wEta * row1[1]);
+  }
 };
 
 /// \brief Next implementation class to store TOF response parameters for exp. times
@@ -289,9 +317,28 @@ class TOFResoParamsV3 : public o2::tof::Parameters<13>
   template <o2::track::PID::ID pid>
   float getResolution(const float p, const float eta) const
   {
+    if (mUseTables && p >= mTabPMin && p < mTabPMax && eta >= mTabEtaMin && eta < mTabEtaMax) {
+      return interpolateResolution(mResolutionTable.data() + pid * mTabNP * mTabNEta, p, eta);
+    }
     return mResolution[pid]->Eval(p, eta);
   }
 
+  /// Tabulates the resolution functions of all species and the time shifts on regular (p, eta) grids
+  /// Inside the grid, getResolution and getTimeShift are then evaluated with a bilinear (linear) interpolation
+  /// \param nP number of grid points in momentum
+  /// \param pMin lower edge of the momentum grid
+  /// \param pMax upper edge of the momentum grid
+  /// \param nEta number of grid points in eta
+  /// \param etaMin lower edge of the eta grid
+  /// \param etaMax upper edge of the eta grid
+  void setResolutionTables(const int nP, const float pMin, const float pMax, const int nEta, const float etaMin, const float etaMax);
+  /// Switches back to the analytic evaluation
+  void resetResolutionTables() { mUseTables = false; }
+  bool useResolutionTables() const { return mUseTables; }
+  /// Compares the tabulated and the analytic resolution at the centres of nCheck x nCheck cells covering the grid
+  /// \return the maximum relative deviation over all species
+  float checkResolutionTables(const int nCheck) const;
+
   void printResolution() const
   {
     // Print a summary
@@ -333,6 +380,33 @@ class TOFResoParamsV3 : public o2::tof::Parameters<13>
   // Time shift for post calibration
   TGraph* gPosEtaTimeCorr = nullptr; /// Time shift correction for positive tracks
   TGraph* gNegEtaTimeCorr = nullptr; /// Time shift correction for negative tracks
+
+  // Tabulated resolution and time shift
+  bool mUseTables = false;
+  int mTabNP = 0;
+  int mTabNEta = 0;
+  float mTabPMin = 0.f;
+  float mTabPMax = 0.f;
+  float mTabEtaMin = 0.f;
+  float mTabEtaMax = 0.f;
+  float mTabInvDeltaP = 0.f;
+  float mTabInvDeltaEta = 0.f;
+  std::vector<float> mResolutionTable; /// Resolution, species-major then p-major: [pid][iP][iEta]
+  std::vector<float> mPosTimeShiftTable; /// Time shift for positive tracks vs eta
+  std::vector<float> mNegTimeShiftTable; /// Time shift for negative tracks vs eta
+
+  float interpolateResolution(const float* table, const float p, const float eta) const
+  {
+    const float xP = (p - mTabPMin) * mTabInvDeltaP;
+    const float xEta = (eta - mTabEtaMin) * mTabInvDeltaEta;
+    const int iP = std::min(static_cast<int>(xP), mTabNP - 2);
+    const int iEta = std::min(static_cast<int>(xEta), mTabNEta - 2);
+    const float wP = xP - iP;
+    const float wEta = xEta - iEta;
+    const float* row0 = table + iP * mTabNEta + iEta;
+    const float* row1 = row0 + mTabNEta;
+    return (1.f - wP) * ((1.f - wEta) * row0[0] + wEta * row0[1]) + wP * ((1.f - wEta) * row1[0] + wEta * row1[1]);
+  }
 };
 
 /// \brief Class to handle the the TOF detector response for the TOF beta measurement
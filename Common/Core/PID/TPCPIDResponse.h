@@ -85,6 +85,17 @@ class Response
   float GetSignalDelta(const TrackType& trk, const o2::track::PID::ID id) const;
   /// Gets relative dEdx resolution contribution due to relative pt resolution
   float GetRelativeResolutiondEdx(const float p, const float mass, const float charge, const float resol) const;
+  /// Gets the expected signal and resolution of all species for a set of tracks stored as columns
+  /// \param nTracks number of tracks
+  /// \param tpcInnerParam momentum at the TPC inner wall of each track
+  /// \param tgl tangent of the dip angle of each track
+  /// \param signed1Pt signed inverse pT of each track
+  /// \param nClsFound number of found TPC clusters of each track
+  /// \param multTPC TPC multiplicity of the collision of each track
+  /// \param expSignal output array of size PID::NIDs * nTracks, species-major, filled with the expected signals
+  /// \param expSigma output array of size PID::NIDs * nTracks, species-major, filled with the expected resolutions
+  /// \note Same parametrisation as GetExpectedSignal and GetExpectedSigma, the TPC presence of the tracks must be checked by the caller
+  void GetExpectedSignalsAndSigmas(const std::size_t nTracks, const float* tpcInnerParam, const float* tgl, const float* signed1Pt, const float* nClsFound, const float* multTPC, float* expSignal, float* expSigma) const;
 
   void PrintAll() const;
 
@@ -197,6 +208,53 @@ inline float Response::GetRelativeResolutiondEdx(const float p, const float mass
   return deltaRel;
 }
 
+/// Gets the expected signal and resolution of all species for a set of tracks stored as columns
+/// Loops run over contiguous arrays with the species-dependent factors computed once, so that they can be vectorised by the compiler
+inline void Response::GetExpectedSignalsAndSigmas(const std::size_t nTracks, const float* tpcInnerParam, const float* tgl, const float* signed1Pt, const float* nClsFound, const float* multTPC, float* expSignal, float* expSigma) const
+{
+  const float bb0 = mBetheBlochParams[0];
+  const float bb1 = mBetheBlochParams[1];
+  const float bb2 = mBetheBlochParams[2];
+  const float bb3 = mBetheBlochParams[3];
+  const float bb4 = mBetheBlochParams[4];
+  for (int id = 0; id < o2::track::PID::NIDs; id++) {
+    const float mass = o2::track::pid_constants::sMasses[id];
+    const float charge = o2::track::pid_constants::sCharges[id];
+    const float chargeFactor = std::pow(charge, mChargeFactor);
+    float* signal = expSignal + id * nTracks;
+    float* sigma = expSigma + id * nTracks;
+
+    for (std::size_t i = 0; i < nTracks; i++) {
+      const float bethe = mMIP * o2::tpc::BetheBlochAleph(tpcInnerParam[i] / mass, bb0, bb1, bb2, bb3, bb4) * chargeFactor;
+      signal[i] = bethe >= 0.f ? bethe : -999.f;
+    }
+
+    if (mUseDefaultResolutionParam) {
+      for (std::size_t i = 0; i < nTracks; i++) {
+        const float reso = signal[i] * mResolutionParamsDefault[0] * (nClsFound[i] > 0 ? std::sqrt(1. + mResolutionParamsDefault[1] / nClsFound[i]) : 1.f);
+        sigma[i] = reso >= 0.f ? reso : -999.f;
+      }
+      continue;
+    }
+
+    const double p0Sq = mResolutionParams[0] * mResolutionParams[0];
+    const double p1Sq = mResolutionParams[1] * mResolutionParams[1];
+    for (std::size_t i = 0; i < nTracks; i++) {
+      const double ncl = nClNorm / nClsFound[i];
+      const double p = tpcInnerParam[i];
+      const double dEdx = o2::tpc::BetheBlochAleph(static_cast<float>(p / mass), bb0, bb1, bb2, bb3, bb4) * chargeFactor;
+      const double relReso = GetRelativeResolutiondEdx(p, mass, charge, mResolutionParams[3]);
+      const double invdEdx = 1.f / dEdx;
+      const double sqrtNcl = std::sqrt(ncl);
+      const double mult = multTPC[i] / mMultNormalization;
+      const double tanDip = tgl[i];
+      const double invdEdxTgl = invdEdx / std::sqrt(1 + tanDip * tanDip);
+      const float reso = std::sqrt(p0Sq * invdEdx + p1Sq * (sqrtNcl * mResolutionParams[5]) * std::pow(invdEdxTgl, mResolutionParams[2]) + sqrtNcl * relReso * relReso + std::pow(mResolutionParams[4] * signed1Pt[i], 2) + std::pow(mult * mResolutionParams[6], 2) + std::pow(mult * invdEdxTgl * mResolutionParams[7], 2)) * dEdx * mMIP;
+      sigma[i] = reso >= 0.f ? reso : -999.f;
+    }
+  }
+}
+
 inline void Response::PrintAll() const
 {
   LOGP(info, "==== TPC PID response parameters: ====");
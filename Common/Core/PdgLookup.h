@@ -0,0 +1,113 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   PdgLookup.h
+/// \brief  Cache of the mass, charge and stability of the particles of a PDG database
+///
+/// The properties of a PDG code are taken from the database (TDatabasePDG or the O2DatabasePDG
+/// service) the first time the code is requested and then read from the cache: a dense array for
+/// |code| < kNDense, i.e. all the leptons, mesons and baryons, and a hash map for the other codes
+/// (nuclei, ions, generator specific codes). The values are the ones of TParticlePDG, the charge
+/// being given in units of e instead of |e|/3. Codes unknown to the database have isKnown false
+/// and 0 mass and charge.
+///
+
+#ifndef COMMON_CORE_PDGLOOKUP_H_
+#define COMMON_CORE_PDGLOOKUP_H_
+
+#include <TDatabasePDG.h>
+#include <TParticlePDG.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace o2::common::core
+{
+
+class PdgLookup
+{
+ public:
+  struct Properties {
+    double mass = 0.;
+    double charge = 0.; // in units of e
+    bool isStable = false;
+    bool isKnown = false;
+  };
+
+  static constexpr int kNDense = 10000;
+
+  /// Use the given database (pointer or Service) instead of TDatabasePDG::Instance()
+  template <typename TDatabase>
+  void setDatabase(TDatabase db)
+  {
+    mGetParticle = [db](int code) -> TParticlePDG* { return db->GetParticle(code); };
+    clear();
+  }
+  bool hasDatabase() const { return static_cast<bool>(mGetParticle); }
+
+  void clear()
+  {
+    mDense.clear();
+    mOthers.clear();
+  }
+
+  const Properties& get(int code) const
+  {
+    if (std::abs(code) < kNDense) {
+      if (mDense.empty()) {
+        mDense.resize(2 * kNDense);
+      }
+      auto& entry = mDense[code + kNDense];
+      if (!entry.filled) {
+        entry.properties = fetch(code);
+        entry.filled = true;
+      }
+      return entry.properties;
+    }
+    auto found = mOthers.find(code);
+    if (found == mOthers.end()) {
+      found = mOthers.emplace(code, fetch(code)).first;
+    }
+    return found->second;
+  }
+
+  double mass(int code) const { return get(code).mass; }
+  double charge(int code) const { return get(code).charge; }
+  bool isStable(int code) const { return get(code).isStable; }
+  bool isKnown(int code) const { return get(code).isKnown; }
+
+ private:
+  struct Entry {
+    Properties properties;
+    bool filled = false;
+  };
+
+  Properties fetch(int code) const
+  {
+    const TParticlePDG* particle = mGetParticle ? mGetParticle(code) : TDatabasePDG::Instance()->GetParticle(code);
+    if (!particle) {
+      return Properties{};
+    }
+    return Properties{particle->Mass(), particle->Charge() / 3., static_cast<bool>(particle->Stable()), true};
+  }
+
+  std::function<TParticlePDG*(int)> mGetParticle{};
+  mutable std::vector<Entry> mDense;                   // code + kNDense
+  mutable std::unordered_map<int, Properties> mOthers; // |code| >= kNDense
+};
+
+} // namespace o2::common::core
+
+#endif // COMMON_CORE_PDGLOOKUP_H_
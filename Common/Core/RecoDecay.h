@@ -21,10 +21,13 @@
 #include <algorithm> // std::find
 #include <array>     // std::array
 #include <cmath>     // std::abs, std::sqrt
+#include <cstdint>
 #include <cstdio>
-#include <tuple>   // std::apply
-#include <utility> // std::move
-#include <vector>  // std::vector
+#include <functional>    // std::hash
+#include <tuple>         // std::apply
+#include <unordered_map> // std::unordered_map
+#include <utility>       // std::move
+#include <vector>        // std::vector
 
 // ROOT includes
 #include <TMCProcess.h> // for VMC Particle Production Process
@@ -534,6 +537,119 @@ struct RecoDecay {
     return maxNormDeltaIP;
   }
 
+  /// Per-DF memo of the mother look-ups in the MC decay trees.
+  /// While an instance is alive, getMother (hence getMatchedMCRec) resolves the mothers of the particles
+  /// of the table it was built from using flat arrays of PDG codes and mother ranges, and remembers the result
+  /// of each (particle, expected mother) query, so that prongs shared by several candidates or decay hypotheses
+  /// are walked only once. It is meant to be created at the beginning of the MC matching of a DF, e.g.
+  /// RecoDecay::McAncestryCache mcAncestry(mcParticles);
+  /// and does not change the results of the matching.
+  class McAncestryCache
+  {
+   public:
+    template <typename T>
+    explicit McAncestryCache(const T& particlesMC) : mPrevious(sActive)
+    {
+      mOffset = particlesMC.offset();
+      mPdgCodes.reserve(particlesMC.size());
+      mMothersFirst.reserve(particlesMC.size());
+      mMothersLast.reserve(particlesMC.size());
+      for (const auto& particle : particlesMC) {
+        mPdgCodes.push_back(particle.pdgCode());
+        if (particle.has_mothers()) {
+          mMothersFirst.push_back(particle.mothersIds().front());
+          mMothersLast.push_back(particle.mothersIds().back());
+        } else {
+          mMothersFirst.push_back(0);
+          mMothersLast.push_back(-1);
+        }
+      }
+      sActive = this;
+    }
+    ~McAncestryCache() { sActive = mPrevious; }
+    McAncestryCache(const McAncestryCache&) = delete;
+    McAncestryCache& operator=(const McAncestryCache&) = delete;
+
+    /// Cache in use in this thread, nullptr if none
+    static McAncestryCache* active() { return sActive; }
+
+    /// Whether the cache was built from this table
+    template <typename T>
+    bool isFor(const T& particlesMC) const
+    {
+      return particlesMC.offset() == mOffset && static_cast<std::size_t>(particlesMC.size()) == mPdgCodes.size();
+    }
+
+    /// Same search as the table-based getMother, without the flavour-oscillation correction of the sign
+    int getMother(int64_t index, int pdgMother, bool acceptAntiParticles, int8_t& sign, int8_t depthMax)
+    {
+      auto [entry, inserted] = mMothers.try_emplace(Key{index, pdgMother, depthMax, acceptAntiParticles});
+      if (inserted) {
+        entry->second = findMother(index, pdgMother, acceptAntiParticles, depthMax);
+      }
+      sign = entry->second.sign;
+      return entry->second.index;
+    }
+
+   private:
+    struct Key {
+      int64_t index;
+      int pdgMother;
+      int8_t depthMax;
+      bool acceptAntiParticles;
+      bool operator==(const Key& other) const { return index == other.index && pdgMother == other.pdgMother && depthMax == other.depthMax && acceptAntiParticles == other.acceptAntiParticles; }
+    };
+    struct KeyHash {
+      std::size_t operator()(const Key& key) const
+      {
+        return std::hash<int64_t>{}(key.index * 1000003 + key.pdgMother) ^ (static_cast<std::size_t>(key.depthMax) << 1 | key.acceptAntiParticles);
+      }
+    };
+    struct Mother {
+      int index = -1;
+      int8_t sign = 0;
+    };
+
+    Mother findMother(int64_t index, int pdgMother, bool acceptAntiParticles, int8_t depthMax)
+    {
+      Mother found;
+      int depth = 0;
+      mStage.assign(1, index);
+      while (found.index < 0 && !mStage.empty() && (depthMax < 0 || depth < depthMax)) {
+        mNextStage.clear();
+        for (auto iPart : mStage) { // o2-linter: disable=const-ref-in-for-loop (int elements)
+          for (auto iMother = mMothersFirst[iPart - mOffset]; iMother <= mMothersLast[iPart - mOffset]; ++iMother) {
+            if (std::find(mNextStage.begin(), mNextStage.end(), iMother) != mNextStage.end()) {
+              continue;
+            }
+            auto pdgParticleIMother = mPdgCodes[iMother - mOffset];
+            if (pdgParticleIMother == pdgMother) {
+              found = {static_cast<int>(iMother), 1};
+              break;
+            } else if (acceptAntiParticles && pdgParticleIMother == -pdgMother) {
+              found = {static_cast<int>(iMother), -1};
+              break;
+            }
+            mNextStage.push_back(iMother);
+          }
+        }
+        mStage.swap(mNextStage);
+        depth++;
+      }
+      return found;
+    }
+
+    static inline thread_local McAncestryCache* sActive = nullptr;
+    McAncestryCache* mPrevious = nullptr;
+    int64_t mOffset = 0;
+    std::vector<int> mPdgCodes;                        // PDG code of each particle
+    std::vector<int64_t> mMothersFirst;                // first mother index of each particle
+    std::vector<int64_t> mMothersLast;                 // last mother index of each particle, first - 1 if no mothers
+    std::vector<int64_t> mStage;                       // mothers at the current level of the search
+    std::vector<int64_t> mNextStage;                   // mothers at the next level of the search
+    std::unordered_map<Key, Mother, KeyHash> mMothers; // memoised results of the searches
+  };
+
   /// Finds the mother of an MC particle by looking for the expected PDG code in the mother chain.
   /// \param particlesMC  table with MC particles
   /// \param particle  MC particle
@@ -558,47 +674,51 @@ struct RecoDecay {
       *sign = sgn;
     }
 
-    // vector of vectors with mother indices; each line corresponds to a "stage"
-    std::vector<std::vector<int64_t>> arrayIds{};
-    std::vector<int64_t> initVec{particle.globalIndex()};
-    arrayIds.push_back(initVec); // the first vector contains the index of the original particle
-
-    while (!motherFound && arrayIds[-stage].size() > 0 && (depthMax < 0 || -stage < depthMax)) {
-      // vector of mother indices for the current stage
-      std::vector<int64_t> arrayIdsStage{};
-      for (auto iPart : arrayIds[-stage]) { // check all the particles that were the mothers at the previous stage, o2-linter: disable=const-ref-in-for-loop (int elements)
-        auto particleMother = particlesMC.rawIteratorAt(iPart - particlesMC.offset());
-        if (particleMother.has_mothers()) {
-          for (auto iMother = particleMother.mothersIds().front(); iMother <= particleMother.mothersIds().back(); ++iMother) { // loop over the mother particles of the analysed particle
-            if (std::find(arrayIdsStage.begin(), arrayIdsStage.end(), iMother) != arrayIdsStage.end()) {                       // if a mother is still present in the vector, do not check it again
-              continue;
-            }
-            auto mother = particlesMC.rawIteratorAt(iMother - particlesMC.offset());
-            // Check mother's PDG code.
-            auto pdgParticleIMother = mother.pdgCode(); // PDG code of the mother
-            // printf("getMother: ");
-            // for (int i = stage; i < 0; i++) // Indent to make the tree look nice.
-            //   printf(" ");
-            // printf("Stage %d: Mother PDG: %d, Index: %d\n", stage, pdgParticleIMother, iMother);
-            if (pdgParticleIMother == pdgMother) { // exact PDG match
-              sgn = 1;
-              indexMother = iMother;
-              motherFound = true;
-              break;
-            } else if (acceptAntiParticles && pdgParticleIMother == -pdgMother) { // antiparticle PDG match
-              sgn = -1;
-              indexMother = iMother;
-              motherFound = true;
-              break;
+    if (auto* cache = McAncestryCache::active(); cache && cache->isFor(particlesMC)) {
+      indexMother = cache->getMother(particle.globalIndex(), pdgMother, acceptAntiParticles, sgn, depthMax);
+    } else {
+      // vector of vectors with mother indices; each line corresponds to a "stage"
+      std::vector<std::vector<int64_t>> arrayIds{};
+      std::vector<int64_t> initVec{particle.globalIndex()};
+      arrayIds.push_back(initVec); // the first vector contains the index of the original particle
+
+      while (!motherFound && arrayIds[-stage].size() > 0 && (depthMax < 0 || -stage < depthMax)) {
+        // vector of mother indices for the current stage
+        std::vector<int64_t> arrayIdsStage{};
+        for (auto iPart : arrayIds[-stage]) { // check all the particles that were the mothers at the previous stage, o2-linter: disable=const-ref-in-for-loop (int elements)
+          auto particleMother = particlesMC.rawIteratorAt(iPart - particlesMC.offset());
+          if (particleMother.has_mothers()) {
+            for (auto iMother = particleMother.mothersIds().front(); iMother <= particleMother.mothersIds().back(); ++iMother) { // loop over the mother particles of the analysed particle
+              if (std::find(arrayIdsStage.begin(), arrayIdsStage.end(), iMother) != arrayIdsStage.end()) {                       // if a mother is still present in the vector, do not check it again
+                continue;
+              }
+              auto mother = particlesMC.rawIteratorAt(iMother - particlesMC.offset());
+              // Check mother's PDG code.
+              auto pdgParticleIMother = mother.pdgCode(); // PDG code of the mother
+              // printf("getMother: ");
+              // for (int i = stage; i < 0; i++) // Indent to make the tree look nice.
+              //   printf(" ");
+              // printf("Stage %d: Mother PDG: %d, Index: %d\n", stage, pdgParticleIMother, iMother);
+              if (pdgParticleIMother == pdgMother) { // exact PDG match
+                sgn = 1;
+                indexMother = iMother;
+                motherFound = true;
+                break;
+              } else if (acceptAntiParticles && pdgParticleIMother == -pdgMother) { // antiparticle PDG match
+                sgn = -1;
+                indexMother = iMother;
+                motherFound = true;
+                break;
+              }
+              // add mother index in the vector for the current stage
+              arrayIdsStage.push_back(iMother);
             }
-            // add mother index in the vector for the current stage
-            arrayIdsStage.push_back(iMother);
           }
         }
+        // add vector of mother indices for the current stage
+        arrayIds.push_back(arrayIdsStage);
+        stage--;
       }
-      // add vector of mother indices for the current stage
-      arrayIds.push_back(arrayIdsStage);
-      stage--;
     }
     if (sign) {
       if constexpr (acceptFlavourOscillation) {
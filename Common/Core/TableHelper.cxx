@@ -17,8 +17,13 @@
 
 #include "Common/Core/TableHelper.h"
 
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
 #include <string>
+#include <vector>
 
+#include "Framework/ConfigContext.h"
 #include "Framework/InitContext.h"
 #include "Framework/RunningWorkflowInfo.h"
 
@@ -98,3 +103,37 @@ void enableFlagIfTableRequired(o2::framework::InitContext& initContext, const st
     LOG(info) << "Table disabled and not required: " + table;
   }
 }
+
+/// Function to check if tables of a producer are already in the input AO2D
+/// @param cfgc configuration context of defineDataProcessing
+/// @param tables descriptions of the tables of the producer
+bool areTablesInInput(o2::framework::ConfigContext const& cfgc, std::vector<std::string> const& tables)
+{
+  const char* reuse = std::getenv("O2PHYSICS_SERVICE_TABLES_FROM_INPUT");
+  if (reuse == nullptr || std::string(reuse) != "1") {
+    return false;
+  }
+  if (!cfgc.options().hasOption("aod-metadata-tables")) {
+    LOG(info) << "No list of the input tables in the metadata, the service tables are produced";
+    return false;
+  }
+  auto toLower = [](std::string name) {
+    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::tolower(c); });
+    return name;
+  };
+  // The trees are named O2<description>, with a _<version> suffix for the versioned tables
+  for (auto const& inputTable : cfgc.options().get<std::vector<std::string>>("aod-metadata-tables")) {
+    std::string name = toLower(inputTable);
+    if (auto version = name.find('_'); version != std::string::npos && version + 1 < name.size() &&
+                                       std::all_of(name.begin() + version + 1, name.end(), [](unsigned char c) { return std::isdigit(c); })) {
+      name.resize(version);
+    }
+    for (auto const& table : tables) {
+      if (name == "o2" + toLower(table)) {
+        LOG(info) << "Table " << table << " found in the input";
+        return true;
+      }
+    }
+  }
+  return false;
+}
@@ -19,7 +19,9 @@
 #define COMMON_CORE_TABLEHELPER_H_
 
 #include <string>
+#include <vector>
 
+#include "Framework/ConfigContext.h"
 #include "Framework/Configurable.h"
 #include "Framework/InitContext.h"
 #include "Framework/RunningWorkflowInfo.h"
@@ -55,6 +57,13 @@ void enableFlagIfTableRequired(o2::framework::InitContext& initContext, const st
   enableFlagIfTableRequired(initContext, table, flag.value);
 }
 
+/// Function to check if tables of a producer are already in the input AO2D, e.g. in a sidecar file of service tables produced with the same configuration (see Scripts/shared_producers.py).
+/// The producer can then be left out of the workflow, and its tables are read from the input. This is done only if the environment variable O2PHYSICS_SERVICE_TABLES_FROM_INPUT is set to 1, otherwise the producers always run.
+/// @param cfgc configuration context of defineDataProcessing
+/// @param tables descriptions of the tables of the producer (e.g. "EVSEL"), compared with the tables listed in the aod-metadata-tables option
+/// @return true if any of the tables is in the input
+bool areTablesInInput(o2::framework::ConfigContext const& cfgc, std::vector<std::string> const& tables);
+
 /// Function to check for a specific configurable from another task in the current workflow and fetch its value. Useful for tasks that need to know the value of a configurable in another task.
 /// @param initContext initContext of the init function
 /// @param taskName name of the task to check for
@@ -0,0 +1,316 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   TaskInstrumentation.h
+/// \brief  Scoped timers and counters for the hot sections of a task
+///
+/// The sections are declared once in init and identified by their index afterwards.
+/// Each timed call adds its duration, the rows processed and the bytes produced to the section
+/// and fills the histograms of the folder "Instrumentation/" of the given HistogramRegistry:
+///  - hTime, hCalls, hRows, hBytes: totals per section
+///  - hTimePerCall: distribution of log10 of the duration of a call in ns, per section
+/// The processing of a DF can be enclosed in dataFrame(): the time between two DFs, i.e. the time the
+/// task waited for its input (reading of the AO2D and upstream devices), is then filled per DF in
+/// hInputWaitPerDF, as log10 of the wait in ns.
+/// A JSON summary of the totals is printed at destruction (i.e. at the end of the run of the device).
+/// An instrumentation which has not been initialised does nothing, so it can be left in the code
+/// and enabled with a Configurable.
+///
+/// Allocation tracking is enabled by defining O2_TASK_INSTRUMENTATION_TRACK_ALLOCATIONS before including
+/// this header in the (single) source file of the workflow, which replaces the global operator new.
+/// The timed calls then also count the allocations done with new in their scope, their size and the
+/// largest one, published in hAllocations, hAllocatedBytes and hAllocationsPerCall.
+///
+
+#ifndef COMMON_CORE_TASKINSTRUMENTATION_H_
+#define COMMON_CORE_TASKINSTRUMENTATION_H_
+
+#include "Framework/HistogramRegistry.h"
+#include "Framework/Logger.h"
+
+#include <TH1.h>
+#include <TH2.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace o2::common::core
+{
+
+/// Allocations done with operator new by the current thread, counted only when the tracking is enabled
+struct AllocationCounters {
+  uint64_t allocations = 0;
+  uint64_t bytes = 0;
+  uint64_t largest = 0; // largest allocation since the last reset
+};
+
+inline thread_local AllocationCounters allocationCounters;
+
+inline bool& allocationTrackingEnabled()
+{
+  static bool enabled = false;
+  return enabled;
+}
+
+inline void countAllocation(std::size_t size)
+{
+  auto& counters = allocationCounters;
+  counters.allocations++;
+  counters.bytes += size;
+  counters.largest = std::max<uint64_t>(counters.largest, size);
+}
+
+class TaskInstrumentation
+{
+ public:
+  class ScopedTimer;
+  class DataFrameScope;
+
+  TaskInstrumentation() = default;
+  TaskInstrumentation(TaskInstrumentation const&) = delete;
+  TaskInstrumentation& operator=(TaskInstrumentation const&) = delete;
+  ~TaskInstrumentation()
+  {
+    if (isEnabled()) {
+      LOG(info) << "Task instrumentation summary: " << summary();
+    }
+  }
+
+  /// Book the histograms of the sections, whose index is their position in the vector
+  void init(o2::framework::HistogramRegistry& registry, std::string const& taskName, std::vector<std::string> const& sections)
+  {
+    using o2::framework::HistType;
+    mTaskName = taskName;
+    mSections.assign(sections.size(), Section{});
+    const int nSections = sections.size();
+    const o2::framework::AxisSpec axisSections{nSections, -0.5, nSections - 0.5, "section"};
+    mHistTime = registry.add<TH1>("Instrumentation/hTime", "Total time;;time (s)", HistType::kTH1D, {axisSections});
+    mHistCalls = registry.add<TH1>("Instrumentation/hCalls", "Number of calls;;calls", HistType::kTH1D, {axisSections});
+    mHistRows = registry.add<TH1>("Instrumentation/hRows", "Rows processed;;rows", HistType::kTH1D, {axisSections});
+    mHistBytes = registry.add<TH1>("Instrumentation/hBytes", "Bytes produced;;bytes", HistType::kTH1D, {axisSections});
+    mHistTimePerCall = registry.add<TH2>("Instrumentation/hTimePerCall", "Time per call;;log_{10}(time / ns)", HistType::kTH2F, {axisSections, {100, 0., 10.}});
+    mHistInputWait = registry.add<TH1>("Instrumentation/hInputWaitPerDF", "Wait for the input per DF;log_{10}(time / ns);DFs", HistType::kTH1D, {{120, 0., 12.}});
+    std::vector<TH1*> hists{mHistTime.get(), mHistCalls.get(), mHistRows.get(), mHistBytes.get(), mHistTimePerCall.get()};
+    if (allocationTrackingEnabled()) {
+      mHistAllocations = registry.add<TH1>("Instrumentation/hAllocations", "Allocations;;allocations", HistType::kTH1D, {axisSections});
+      mHistAllocatedBytes = registry.add<TH1>("Instrumentation/hAllocatedBytes", "Allocated bytes;;bytes", HistType::kTH1D, {axisSections});
+      mHistAllocationsPerCall = registry.add<TH2>("Instrumentation/hAllocationsPerCall", "Allocations per call;;log_{10}(allocations + 1)", HistType::kTH2F, {axisSections, {80, 0., 8.}});
+      hists.insert(hists.end(), {mHistAllocations.get(), mHistAllocatedBytes.get(), mHistAllocationsPerCall.get()});
+    }
+    for (int iSection = 0; iSection < nSections; iSection++) {
+      mSections[iSection].name = sections[iSection];
+      for (auto* hist : hists) {
+        hist->GetXaxis()->SetBinLabel(iSection + 1, sections[iSection].c_str());
+      }
+    }
+  }
+
+  bool isEnabled() const { return !mSections.empty(); }
+
+  /// Timer of a section, stopped at destruction or with stop()
+  ScopedTimer time(int section, uint64_t rows = 0);
+
+  /// Scope of the processing of a DF, to be opened once per DF (e.g. in the first process function called)
+  DataFrameScope dataFrame();
+
+  /// Start of the processing of a DF, recording the wait since the end of the previous one
+  void startDataFrame()
+  {
+    const auto now = std::chrono::steady_clock::now();
+    mDataFrames++;
+    if (!isEnabled() || mDataFrames == 1) {
+      return;
+    }
+    const int64_t wait = std::chrono::duration_cast<std::chrono::nanoseconds>(now - mLastDataFrameEnd).count();
+    mInputWaitNanoseconds += wait;
+    mHistInputWait->Fill(wait > 0 ? std::log10(static_cast<double>(wait)) : 0.);
+  }
+  void endDataFrame() { mLastDataFrameEnd = std::chrono::steady_clock::now(); }
+
+  /// Add a call of a section which took nanoseconds
+  void record(int section, int64_t nanoseconds, uint64_t rows = 0, uint64_t bytes = 0)
+  {
+    if (section < 0 || section >= static_cast<int>(mSections.size())) {
+      return;
+    }
+    auto& sec = mSections[section];
+    sec.calls++;
+    sec.nanoseconds += nanoseconds;
+    sec.rows += rows;
+    sec.bytes += bytes;
+    mHistTime->Fill(section, 1.e-9 * nanoseconds);
+    mHistCalls->Fill(section);
+    mHistRows->Fill(section, rows);
+    mHistBytes->Fill(section, bytes);
+    mHistTimePerCall->Fill(section, nanoseconds > 0 ? std::log10(static_cast<double>(nanoseconds)) : 0.);
+  }
+
+  /// Add the allocations of a call of a section
+  void recordAllocations(int section, AllocationCounters const& allocations)
+  {
+    if (!mHistAllocations || section < 0 || section >= static_cast<int>(mSections.size())) {
+      return;
+    }
+    auto& sec = mSections[section];
+    sec.allocations += allocations.allocations;
+    sec.allocatedBytes += allocations.bytes;
+    sec.largestAllocation = std::max(sec.largestAllocation, allocations.largest);
+    mHistAllocations->Fill(section, allocations.allocations);
+    mHistAllocatedBytes->Fill(section, allocations.bytes);
+    mHistAllocationsPerCall->Fill(section, std::log10(allocations.allocations + 1.));
+  }
+
+  /// Totals of the sections as a JSON object
+  std::string summary() const
+  {
+    std::ostringstream json;
+    json << "{\"task\": \"" << mTaskName << "\", \"sections\": [";
+    for (size_t iSection = 0; iSection < mSections.size(); iSection++) {
+      const auto& sec = mSections[iSection];
+      json << (iSection ? ", " : "") << "{\"name\": \"" << sec.name << "\", \"calls\": " << sec.calls << ", \"seconds\": " << 1.e-9 * sec.nanoseconds
+           << ", \"rows\": " << sec.rows << ", \"bytes\": " << sec.bytes << ", \"rowsPerSecond\": " << (sec.nanoseconds > 0 ? 1.e9 * sec.rows / sec.nanoseconds : 0.);
+      if (mHistAllocations) {
+        json << ", \"allocations\": " << sec.allocations << ", \"allocatedBytes\": " << sec.allocatedBytes << ", \"largestAllocation\": " << sec.largestAllocation
+             << ", \"allocationsPerCall\": " << (sec.calls > 0 ? static_cast<double>(sec.allocations) / sec.calls : 0.);
+      }
+      json << "}";
+    }
+    json << "], \"dataFrames\": " << mDataFrames << ", \"inputWaitSeconds\": " << 1.e-9 * mInputWaitNanoseconds << "}";
+    return json.str();
+  }
+
+ private:
+  struct Section {
+    std::string name;
+    uint64_t calls = 0;
+    int64_t nanoseconds = 0;
+    uint64_t rows = 0;
+    uint64_t bytes = 0;
+    uint64_t allocations = 0;
+    uint64_t allocatedBytes = 0;
+    uint64_t largestAllocation = 0;
+  };
+
+  std::string mTaskName;
+  std::vector<Section> mSections;
+  std::shared_ptr<TH1> mHistTime;
+  std::shared_ptr<TH1> mHistCalls;
+  std::shared_ptr<TH1> mHistRows;
+  std::shared_ptr<TH1> mHistBytes;
+  std::shared_ptr<TH2> mHistTimePerCall;
+  std::shared_ptr<TH1> mHistAllocations;
+  std::shared_ptr<TH1> mHistAllocatedBytes;
+  std::shared_ptr<TH2> mHistAllocationsPerCall;
+  std::shared_ptr<TH1> mHistInputWait;
+  uint64_t mDataFrames = 0;
+  int64_t mInputWaitNanoseconds = 0; // from the end of a DF to the start of the next one
+  std::chrono::steady_clock::time_point mLastDataFrameEnd;
+};
+
+class TaskInstrumentation::ScopedTimer
+{
+ public:
+  using clock = std::chrono::steady_clock;
+
+  ScopedTimer(TaskInstrumentation& instrumentation, int section, uint64_t rows = 0) : mInstrumentation(instrumentation), mSection(section), mRows(rows), mAllocationsStart(allocationCounters), mStart(clock::now())
+  {
+    allocationCounters.largest = 0;
+  }
+  ScopedTimer(ScopedTimer const&) = delete;
+  ScopedTimer& operator=(ScopedTimer const&) = delete;
+  ~ScopedTimer() { stop(); }
+
+  void addRows(uint64_t rows) { mRows += rows; }
+  void addBytes(uint64_t bytes) { mBytes += bytes; }
+
+  /// Record the call and return its duration in ns, only the first call records
+  int64_t stop()
+  {
+    if (!mStopped) {
+      mElapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - mStart).count();
+      mStopped = true;
+      // allocations in the scope, the largest one of the enclosing scope is restored
+      const auto& counters = allocationCounters;
+      const AllocationCounters allocations{counters.allocations - mAllocationsStart.allocations, counters.bytes - mAllocationsStart.bytes, counters.largest};
+      allocationCounters.largest = std::max(mAllocationsStart.largest, counters.largest);
+      mInstrumentation.record(mSection, mElapsed, mRows, mBytes);
+      mInstrumentation.recordAllocations(mSection, allocations);
+    }
+    return mElapsed;
+  }
+
+ private:
+  TaskInstrumentation& mInstrumentation;
+  int mSection;
+  uint64_t mRows;
+  uint64_t mBytes = 0;
+  AllocationCounters mAllocationsStart;
+  clock::time_point mStart;
+  int64_t mElapsed = 0;
+  bool mStopped = false;
+};
+
+inline TaskInstrumentation::ScopedTimer TaskInstrumentation::time(int section, uint64_t rows)
+{
+  return ScopedTimer(*this, section, rows);
+}
+
+class TaskInstrumentation::DataFrameScope
+{
+ public:
+  explicit DataFrameScope(TaskInstrumentation& instrumentation) : mInstrumentation(instrumentation) { mInstrumentation.startDataFrame(); }
+  DataFrameScope(DataFrameScope const&) = delete;
+  DataFrameScope& operator=(DataFrameScope const&) = delete;
+  ~DataFrameScope() { mInstrumentation.endDataFrame(); }
+
+ private:
+  TaskInstrumentation& mInstrumentation;
+};
+
+inline TaskInstrumentation::DataFrameScope TaskInstrumentation::dataFrame()
+{
+  return DataFrameScope(*this);
+}
+
+} // namespace o2::common::core
+
+#ifdef O2_TASK_INSTRUMENTATION_TRACK_ALLOCATIONS
+// replacements of the global operator new counting the allocations, to be defined in a single source file
+namespace o2::common::core
+{
+static const bool allocationTrackingRegistered = (allocationTrackingEnabled() = true);
+} // namespace o2::common::core
+
+void* operator new(std::size_t size)
+{
+  o2::common::core::countAllocation(size);
+  if (void* ptr = std::malloc(size ? size : 1)) {
+    return ptr;
+  }
+  throw std::bad_alloc{};
+}
+void* operator new[](std::size_t size) { return ::operator new(size); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+#endif
+
+#endif // COMMON_CORE_TASKINSTRUMENTATION_H_
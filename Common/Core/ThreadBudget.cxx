@@ -0,0 +1,75 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   ThreadBudget.cxx
+/// \brief  Process-wide budget of the threads of the thread pools used by the tasks of a device
+///
+
+#include "Common/Core/ThreadBudget.h"
+
+#include <fairlogger/Logger.h>
+
+#include <algorithm>
+#include <mutex>
+#include <string>
+
+using o2::common::core::ThreadBudget;
+
+ThreadBudget& ThreadBudget::instance()
+{
+  static ThreadBudget budget;
+  return budget;
+}
+
+void ThreadBudget::configure(int nThreads)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  if (mBudget > 0) {
+    if (nThreads != mBudget) {
+      LOGP(warning, "Thread budget already set to {}, ignoring the new value {}", mBudget, nThreads);
+    }
+    return;
+  }
+  mBudget = std::max(nThreads, 0);
+  if (mBudget > 0) {
+    LOGP(info, "Thread budget of the process set to {}", mBudget);
+  }
+}
+
+int ThreadBudget::getBudget() const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mBudget;
+}
+
+int ThreadBudget::getAvailable() const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  return std::max(mBudget - mUsed, 0);
+}
+
+int ThreadBudget::request(std::string const& owner, int nThreads)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  if (mBudget <= 0) {
+    return nThreads;
+  }
+  const int available = std::max(mBudget - mUsed, 1);
+  const int granted = nThreads <= 0 ? available : std::min(nThreads, available);
+  mUsed += granted;
+  if (nThreads > 0 && granted < nThreads) {
+    LOGP(warning, "{}: {} threads requested, {} granted by the thread budget ({} in total)", owner, nThreads, granted, mBudget);
+  } else {
+    LOGP(info, "{}: {} threads granted by the thread budget ({} used out of {})", owner, granted, mUsed, mBudget);
+  }
+  return granted;
+}
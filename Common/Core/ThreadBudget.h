@@ -0,0 +1,62 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   ThreadBudget.h
+/// \brief  Process-wide budget of the threads of the thread pools used by the tasks of a device
+///
+/// When several tasks are fused in one device, each of them choosing the threads of its ONNX sessions
+/// (or of any other thread pool) independently oversubscribes the cores of the slot. The components
+/// ask the budget for the threads they would use and get at most what is left of it, and at least one.
+/// Without a budget (default) the requests are returned unchanged.
+/// The budget is set once per process, by the first task configuring it; the requests made before
+/// are not counted.
+///
+
+#ifndef COMMON_CORE_THREADBUDGET_H_
+#define COMMON_CORE_THREADBUDGET_H_
+
+#include <mutex>
+#include <string>
+
+namespace o2::common::core
+{
+
+class ThreadBudget
+{
+ public:
+  /// Access to the process-wide instance
+  static ThreadBudget& instance();
+
+  /// Set the total number of threads of the process
+  /// \param nThreads number of threads (<= 0: no limit)
+  void configure(int nThreads);
+
+  int getBudget() const;
+  int getAvailable() const;
+
+  /// Threads granted to a component
+  /// \param owner name of the component, for the log
+  /// \param nThreads threads requested (<= 0: default of the component, all the available ones under a budget)
+  /// \return number of threads to use, nThreads if no budget is set
+  int request(std::string const& owner, int nThreads);
+
+ private:
+  ThreadBudget() = default;
+
+  mutable std::mutex mMutex;
+  int mBudget = 0; // 0 = no limit
+  int mUsed = 0;
+};
+
+} // namespace o2::common::core
+
+#endif // COMMON_CORE_THREADBUDGET_H_
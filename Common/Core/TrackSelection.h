@@ -66,6 +66,10 @@ class TrackSelection
 
   static const std::string mCutNames[static_cast<int>(TrackCuts::kNCuts)];
 
+  // Mask with the bits of all the cuts, PassesAllCuts(IsSelectedMask(track)) is equivalent to IsSelected(track)
+  static constexpr uint16_t kAllCutsMask = (1U << static_cast<int>(TrackCuts::kNCuts)) - 1;
+  static bool PassesAllCuts(uint16_t mask) { return mask == kAllCutsMask; }
+
   // Temporary function to check if track passes selection criteria. To be replaced by framework filters.
   template <typename T>
   bool IsSelected(T const& track) const
@@ -19,6 +19,8 @@
 
 #include <TPDGCode.h>
 
+#include <cstdint>
+
 #include "Framework/Logger.h"
 #include "ReconstructionDataFormats/PID.h"
 
@@ -32,6 +34,66 @@ struct TrackSelectorPID {
     Conditional,
     Accepted
   };
+
+  /// Selections stored in a PID status bitmap, 2 bits each
+  enum Selection {
+    Tpc = 0,
+    Tof,
+    TpcOrTof,
+    TpcAndTof,
+    Bayes,
+    NSelections
+  };
+
+  static constexpr int NBitsStatus = 2;
+
+  /// \return status of a selection stored in a PID status bitmap (see TrackSelectorPidBase::statusBitmap)
+  static Status getStatus(uint16_t bitmap, Selection selection)
+  {
+    return static_cast<Status>((bitmap >> (NBitsStatus * selection)) & 0x3);
+  }
+
+  /// Store the status of a selection in a PID status bitmap
+  static void setStatus(uint16_t& bitmap, Selection selection, int status)
+  {
+    bitmap = (bitmap & ~(0x3 << (NBitsStatus * selection))) | ((status & 0x3) << (NBitsStatus * selection));
+  }
+
+  /// Combination of the TPC and TOF statuses: accepted if accepted by either detector or conditional for both
+  static Status combineTpcOrTof(int pidTpc, int pidTof)
+  {
+    if (pidTpc == Accepted || pidTof == Accepted) {
+      return Accepted;
+    }
+    if (pidTpc == Conditional && pidTof == Conditional) {
+      return Accepted;
+    }
+    if (pidTpc == Rejected || pidTof == Rejected) {
+      return Rejected;
+    }
+    return NotApplicable; // (NotApplicable for one detector) and (NotApplicable or Conditional for the other)
+  }
+
+  /// Combination of the TPC and TOF statuses: accepted if not rejected by either detector and accepted or conditional for both
+  static Status combineTpcAndTof(int pidTpc, int pidTof)
+  {
+    if (pidTpc == Accepted && pidTof == Accepted) {
+      return Accepted;
+    }
+    if (pidTpc == Accepted && (pidTof == NotApplicable || pidTof == Conditional)) {
+      return Accepted;
+    }
+    if ((pidTpc == NotApplicable || pidTpc == Conditional) && pidTof == Accepted) {
+      return Accepted;
+    }
+    if (pidTpc == Conditional && pidTof == Conditional) {
+      return Accepted;
+    }
+    if (pidTpc == Rejected || pidTof == Rejected) {
+      return Rejected;
+    }
+    return NotApplicable; // (NotApplicable for one detector) and (NotApplicable or Conditional for the other)
+  }
 };
 
 template <uint64_t pdg = kPiPlus>
@@ -407,17 +469,7 @@ class TrackSelectorPidBase
   {
     int pidTpc = statusTpc(track, tpcNSigmaCustom);
     int pidTof = statusTof(track, tofNSigmaCustom);
-
-    if (pidTpc == TrackSelectorPID::Accepted || pidTof == TrackSelectorPID::Accepted) {
-      return TrackSelectorPID::Accepted;
-    }
-    if (pidTpc == TrackSelectorPID::Conditional && pidTof == TrackSelectorPID::Conditional) {
-      return TrackSelectorPID::Accepted;
-    }
-    if (pidTpc == TrackSelectorPID::Rejected || pidTof == TrackSelectorPID::Rejected) {
-      return TrackSelectorPID::Rejected;
-    }
-    return TrackSelectorPID::NotApplicable; // (NotApplicable for one detector) and (NotApplicable or Conditional for the other)
+    return TrackSelectorPID::combineTpcOrTof(pidTpc, pidTof);
   }
 
   /// Returns status of combined PID (TPC and TOF) selection for a given track when both detectors are applicable. Returns status of single PID otherwise.
@@ -434,23 +486,27 @@ class TrackSelectorPidBase
     if (track.hasTOF()) {
       pidTof = statusTof(track, tofNSigmaCustom);
     }
+    return TrackSelectorPID::combineTpcAndTof(pidTpc, pidTof);
+  }
 
-    if (pidTpc == TrackSelectorPID::Accepted && pidTof == TrackSelectorPID::Accepted) {
-      return TrackSelectorPID::Accepted;
-    }
-    if (pidTpc == TrackSelectorPID::Accepted && (pidTof == TrackSelectorPID::NotApplicable || pidTof == TrackSelectorPID::Conditional)) {
-      return TrackSelectorPID::Accepted;
-    }
-    if ((pidTpc == TrackSelectorPID::NotApplicable || pidTpc == TrackSelectorPID::Conditional) && pidTof == TrackSelectorPID::Accepted) {
-      return TrackSelectorPID::Accepted;
-    }
-    if (pidTpc == TrackSelectorPID::Conditional && pidTof == TrackSelectorPID::Conditional) {
-      return TrackSelectorPID::Accepted;
-    }
-    if (pidTpc == TrackSelectorPID::Rejected || pidTof == TrackSelectorPID::Rejected) {
-      return TrackSelectorPID::Rejected;
-    }
-    return TrackSelectorPID::NotApplicable; // (NotApplicable for one detector) and (NotApplicable or Conditional for the other)
+  /// Returns the statuses of all the selections packed in a bitmap, with the TPC and TOF selections evaluated once.
+  /// The Bayesian status is filled only if the track has the Bayesian PID columns.
+  /// \param track  track
+  /// \return PID status bitmap, to be read with TrackSelectorPID::getStatus
+  template <typename T>
+  uint16_t statusBitmap(const T& track, float tpcNSigmaCustom = -999.f, float tofNSigmaCustom = -999.f)
+  {
+    const int pidTpc = statusTpc(track, tpcNSigmaCustom);
+    const int pidTof = statusTof(track, tofNSigmaCustom);
+    uint16_t bitmap{0};
+    TrackSelectorPID::setStatus(bitmap, TrackSelectorPID::Tpc, pidTpc);
+    TrackSelectorPID::setStatus(bitmap, TrackSelectorPID::Tof, pidTof);
+    TrackSelectorPID::setStatus(bitmap, TrackSelectorPID::TpcOrTof, TrackSelectorPID::combineTpcOrTof(pidTpc, pidTof));
+    TrackSelectorPID::setStatus(bitmap, TrackSelectorPID::TpcAndTof, TrackSelectorPID::combineTpcAndTof(track.hasTPC() ? pidTpc : TrackSelectorPID::NotApplicable, track.hasTOF() ? pidTof : TrackSelectorPID::NotApplicable));
+    if constexpr (requires { track.bayesID(); }) {
+      TrackSelectorPID::setStatus(bitmap, TrackSelectorPID::Bayes, statusBayes(track));
+    }
+    return bitmap;
   }
 
   /// Checks whether a track is identified as electron and rejected as pion by TOF or RICH.
@@ -0,0 +1,109 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file VariationSet.h
+/// \brief Set of variations of a selection, evaluated in a single pass over the data
+///
+/// Systematic studies run the same selection with several values of its cuts. Instead of one task
+/// instance per variation, a task can hold the variations in a VariationSet: the quantities of a
+/// candidate are computed once, each variation is evaluated on them and the result is a mask with
+/// one bit per variation passed, used to fill per variation outputs (e.g. histograms with a
+/// variation axis). The variations are built from a nominal selection and a configurable table
+/// with one row per variation and one column per varied parameter; the selection class provides
+/// bool setParameter(std::string const& name, float value), returning false for unknown names.
+
+#ifndef COMMON_CORE_VARIATIONSET_H_
+#define COMMON_CORE_VARIATIONSET_H_
+
+#include "Framework/Array2D.h"
+#include "Framework/Logger.h"
+
+#include <bit>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace o2::analysis
+{
+
+template <typename TSelection>
+class VariationSet
+{
+ public:
+  static constexpr std::size_t MaxVariations = 64;
+
+  /// \brief builds one variation per row of the table, as the nominal selection with the parameters of the columns changed
+  void build(TSelection const& nominal, o2::framework::LabeledArray<float> const& table)
+  {
+    clear();
+    const auto& parameters = table.getLabelsCols();
+    const auto& names = table.getLabelsRows();
+    for (uint32_t iRow = 0; iRow < table.rows(); iRow++) {
+      TSelection variation = nominal;
+      for (uint32_t iCol = 0; iCol < table.cols(); iCol++) {
+        if (!variation.setParameter(parameters[iCol], table.get(iRow, iCol))) {
+          LOGF(fatal, "Unknown parameter %s in the selection variations", parameters[iCol]);
+        }
+      }
+      add(variation, iRow < names.size() ? names[iRow] : std::to_string(iRow));
+    }
+  }
+
+  void add(TSelection const& variation, std::string const& name)
+  {
+    if (mVariations.size() == MaxVariations) {
+      LOGF(fatal, "At most %d selection variations are supported", MaxVariations);
+    }
+    mVariations.push_back(variation);
+    mNames.push_back(name);
+  }
+  void clear()
+  {
+    mVariations.clear();
+    mNames.clear();
+  }
+
+  std::size_t size() const { return mVariations.size(); }
+  bool empty() const { return mVariations.empty(); }
+  TSelection const& operator[](std::size_t i) const { return mVariations[i]; }
+  std::string const& name(std::size_t i) const { return mNames[i]; }
+
+  /// \brief mask of the variations accepting a candidate, accepts(variation, index) being evaluated for each of them
+  template <typename TAccepts>
+  uint64_t accepted(TAccepts&& accepts) const
+  {
+    uint64_t mask = 0;
+    for (std::size_t i = 0; i < mVariations.size(); i++) {
+      if (accepts(mVariations[i], i)) {
+        mask |= static_cast<uint64_t>(1) << i;
+      }
+    }
+    return mask;
+  }
+
+  /// \brief calls f(index) for each variation in the mask
+  template <typename TFunction>
+  static void forEach(uint64_t mask, TFunction&& f)
+  {
+    while (mask != 0) {
+      f(static_cast<std::size_t>(std::countr_zero(mask)));
+      mask &= mask - 1;
+    }
+  }
+
+ private:
+  std::vector<TSelection> mVariations;
+  std::vector<std::string> mNames;
+};
+
+} // namespace o2::analysis
+
+#endif // COMMON_CORE_VARIATIONSET_H_
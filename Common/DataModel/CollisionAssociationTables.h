@@ -32,6 +32,15 @@ DECLARE_SOA_INDEX_COLUMN(Track, track);                    //! Track index
 DECLARE_SOA_INDEX_COLUMN(FwdTrack, fwdtrack);              //! FwdTrack index
 DECLARE_SOA_INDEX_COLUMN(MFTTrack, mfttrack);              //! MFTTrack index
 DECLARE_SOA_ARRAY_INDEX_COLUMN(Collision, compatibleColl); //! Array of collision indices
+DECLARE_SOA_COLUMN(DcaXY, dcaXY, float);                   //! Impact parameter in XY of the track to the associated collision
+DECLARE_SOA_COLUMN(DcaZ, dcaZ, float);                     //! Impact parameter in Z of the track to the associated collision
+DECLARE_SOA_COLUMN(X, x, float);                           //! X of the track parameters propagated to the associated collision
+DECLARE_SOA_COLUMN(Alpha, alpha, float);                   //! Alpha of the track parameters propagated to the associated collision
+DECLARE_SOA_COLUMN(Y, y, float);                           //! Y of the track parameters propagated to the associated collision
+DECLARE_SOA_COLUMN(Z, z, float);                           //! Z of the track parameters propagated to the associated collision
+DECLARE_SOA_COLUMN(Snp, snp, float);                       //! Snp of the track parameters propagated to the associated collision
+DECLARE_SOA_COLUMN(Tgl, tgl, float);                       //! Tgl of the track parameters propagated to the associated collision
+DECLARE_SOA_COLUMN(Signed1Pt, signed1Pt, float);           //! q/pt of the track parameters propagated to the associated collision
 } // namespace track_association
 
 DECLARE_SOA_TABLE(TrackAssoc, "AOD", "TRACKASSOC", //! Table for track-to-collision association for e.g. HF vertex finding - tracks can appear for several collisions
@@ -41,6 +50,19 @@ DECLARE_SOA_TABLE(TrackAssoc, "AOD", "TRACKASSOC", //! Table for track-to-collis
 DECLARE_SOA_TABLE(TrackCompColls, "AOD", "TRACKCOMPCOLL", //! Table with vectors of collision indices stored per track
                   track_association::CollisionIds);
 
+DECLARE_SOA_TABLE(TrackAssocDCA, "AOD", "TRACKASSOCDCA", //! DCA of the track to the collision of each entry of TrackAssoc (joinable with TrackAssoc)
+                  track_association::DcaXY,
+                  track_association::DcaZ);
+
+DECLARE_SOA_TABLE(TrackAssocPars, "AOD", "TRACKASSOCPARS", //! Track parameters at the DCA to the collision of each entry of TrackAssoc (joinable with TrackAssoc)
+                  track_association::X,
+                  track_association::Alpha,
+                  track_association::Y,
+                  track_association::Z,
+                  track_association::Snp,
+                  track_association::Tgl,
+                  track_association::Signed1Pt);
+
 DECLARE_SOA_TABLE(FwdTrackAssoc, "AOD", "FWDTRACKASSOC", //! Table for fwdtrack-to-collision association
                   track_association::CollisionId,
                   track_association::FwdTrackId);
@@ -32,26 +32,37 @@ namespace o2::aod
 {
 
 struct ITSResponse {
-  static float averageClusterSize(uint32_t itsClusterSizes)
+  /// Summary of the cluster sizes of the 7 ITS layers, packed in 4 bits each in itsClusterSizes
+  struct ClusterSizeSummary {
+    float truncatedMean = 0.f; // mean without the largest cluster size
+    int max = 0;
+    int nClusters = 0;
+  };
+
+  static ClusterSizeSummary clusterSizeSummary(uint32_t itsClusterSizes)
   {
+    ClusterSizeSummary summary;
     float sum = 0;
-    int nclusters = 0;
-    int max = 0;
     for (int layer = 0; layer < 7; layer++) {
       int clsize = (itsClusterSizes >> (layer * 4)) & 0xf;
       if (clsize > 0) {
-        nclusters++;
+        summary.nClusters++;
         sum += clsize;
-        if (clsize > max) {
-          max = clsize;
+        if (clsize > summary.max) {
+          summary.max = clsize;
         }
       }
     }
-    if (nclusters == 0) {
-      return 0;
+    if (summary.nClusters > 0) {
+      // truncated mean
+      summary.truncatedMean = (sum - summary.max) / (summary.nClusters - 1);
     }
-    // truncated mean
-    return (sum - max) / (nclusters - 1);
+    return summary;
+  }
+
+  static float averageClusterSize(uint32_t itsClusterSizes)
+  {
+    return clusterSizeSummary(itsClusterSizes).truncatedMean;
   };
 
   template <o2::track::PID::ID id>
@@ -198,7 +209,18 @@ using ITSNSigmaTr = ITSNSigmaTrImp<o2::aod::track::ITSClusterSizes, o2::aod::tra
 using ITSNSigmaHe = ITSNSigmaHeImp<o2::aod::track::ITSClusterSizes, o2::aod::track::P, o2::aod::track::Eta>;
 using ITSNSigmaAl = ITSNSigmaAlImp<o2::aod::track::ITSClusterSizes, o2::aod::track::P, o2::aod::track::Eta>;
 
+// Stored summary of the ITS cluster sizes, to avoid unpacking itsClusterSizes in every task
+DECLARE_SOA_COLUMN(ITSClsSizeTruncMean, itsClsSizeTruncMean, float);         //! Mean of the ITS cluster sizes without the largest one, as ITSResponse::averageClusterSize
+DECLARE_SOA_COLUMN(ITSClsSizeMax, itsClsSizeMax, uint8_t);                   //! Largest ITS cluster size
+DECLARE_SOA_COLUMN(ITSClsSizeNCls, itsClsSizeNCls, uint8_t);                 //! Number of ITS layers with a cluster size
+DECLARE_SOA_COLUMN(ITSClsSizeTruncMeanCosL, itsClsSizeTruncMeanCosL, float); //! Truncated mean of the ITS cluster sizes times cos(lambda)
+
 } // namespace pidits
+
+DECLARE_SOA_TABLE(ITSClsSizeSummaries, "AOD", "ITSCLSSIZESUM", //! Summary of the ITS cluster sizes of the tracks, joinable with the tracks
+                  pidits::ITSClsSizeTruncMean, pidits::ITSClsSizeMax, pidits::ITSClsSizeNCls, pidits::ITSClsSizeTruncMeanCosL);
+using ITSClsSizeSummary = ITSClsSizeSummaries::iterator;
+
 } // namespace o2::aod
 
 #endif // COMMON_DATAMODEL_PIDRESPONSEITS_H_
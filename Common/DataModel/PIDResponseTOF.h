@@ -20,6 +20,8 @@
 #ifndef COMMON_DATAMODEL_PIDRESPONSETOF_H_
 #define COMMON_DATAMODEL_PIDRESPONSETOF_H_
 
+#include <algorithm>
+#include <cmath>
 #include <experimental/type_traits>
 
 // O2 includes
@@ -364,6 +366,41 @@ struct binning {
   {
     return bin_width * static_cast<float>(valueToUnpack);
   }
+
+  // Thresholds in bin space, to select on the stored binned column without unpacking it, e.g. in a Filter:
+  // unPackInTable(v) < cut  <=>  v <= binnedBelow(cut)  and  unPackInTable(v) > cut  <=>  v >= binnedAbove(cut),
+  // hence |nsigma| < cut  <=>  binnedAbove(-cut) <= v <= binnedBelow(cut)
+  // Largest binned value whose unpacked value is below cut (underflowBin - 1 if none)
+  static int binnedBelow(const float& cut)
+  {
+    if (!(unPackInTable(underflowBin) < cut)) {
+      return underflowBin - 1;
+    }
+    int bin = std::clamp(static_cast<int>(std::floor(cut / bin_width)), static_cast<int>(underflowBin), static_cast<int>(overflowBin));
+    while (!(unPackInTable(bin) < cut)) {
+      bin--;
+    }
+    while (bin < overflowBin && unPackInTable(bin + 1) < cut) {
+      bin++;
+    }
+    return bin;
+  }
+
+  // Smallest binned value whose unpacked value is above cut (overflowBin + 1 if none)
+  static int binnedAbove(const float& cut)
+  {
+    if (!(unPackInTable(overflowBin) > cut)) {
+      return overflowBin + 1;
+    }
+    int bin = std::clamp(static_cast<int>(std::ceil(cut / bin_width)), static_cast<int>(underflowBin), static_cast<int>(overflowBin));
+    while (!(unPackInTable(bin) > cut)) {
+      bin++;
+    }
+    while (bin > underflowBin && unPackInTable(bin - 1) > cut) {
+      bin--;
+    }
+    return bin;
+  }
 };
 
 // NSigma with reduced size 8 bit
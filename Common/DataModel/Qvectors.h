@@ -98,12 +98,19 @@ DECLARE_SOA_COLUMN(LabelsBPos, labelsBPos, std::vector<int>);
 DECLARE_SOA_COLUMN(LabelsBNeg, labelsBNeg, std::vector<int>);
 DECLARE_SOA_COLUMN(LabelsBTot, labelsBTot, std::vector<int>);
 /////////////////////////////////////////////////////////////////
+
+constexpr int NDetectors = 7;                     // FT0C, FT0A, FT0M, FV0A, TPCpos, TPCneg, TPCall
+DECLARE_SOA_COLUMN(Psi, psi, std::vector<float>); //! Event-plane angles, psi[iHarmonic * NDetectors + iDetector]
 } // namespace qvec
 
 DECLARE_SOA_TABLE(Qvectors, "AOD", "QVECTORDEVS", //! Table with all Qvectors.
                   qvec::Cent, qvec::IsCalibrated, qvec::QvecRe, qvec::QvecIm, qvec::QvecAmp);
 using Qvector = Qvectors::iterator;
 
+DECLARE_SOA_TABLE(EventPlaneSummaries, "AOD", "EPSUMMARY", //! Event-plane angles of all the detectors and harmonics, at the selected correction level
+                  qvec::Cent, qvec::IsCalibrated, qvec::Psi);
+using EventPlaneSummary = EventPlaneSummaries::iterator;
+
 DECLARE_SOA_TABLE(QvectorFT0Cs, "AOD", "QVECTORSFT0C", qvec::IsCalibrated, qvec::QvecFT0CRe, qvec::QvecFT0CIm, qvec::SumAmplFT0C);
 DECLARE_SOA_TABLE(QvectorFT0As, "AOD", "QVECTORSFT0A", qvec::IsCalibrated, qvec::QvecFT0ARe, qvec::QvecFT0AIm, qvec::SumAmplFT0A);
 DECLARE_SOA_TABLE(QvectorFT0Ms, "AOD", "QVECTORSFT0M", qvec::IsCalibrated, qvec::QvecFT0MRe, qvec::QvecFT0MIm, qvec::SumAmplFT0M);
@@ -0,0 +1,65 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file converterHelpers.h
+/// \brief Column conversions shared by the data-model converters
+///
+/// The packed columns which are built bit by bit from an older column are tabulated once at compile time,
+/// so that the converters fill them with one lookup per row.
+
+#ifndef COMMON_TABLEPRODUCER_CONVERTERS_CONVERTERHELPERS_H_
+#define COMMON_TABLEPRODUCER_CONVERTERS_CONVERTERHELPERS_H_
+
+#include <array>
+#include <cstdint>
+
+namespace o2::aod::converters
+{
+
+/// ITS cluster sizes (4 bits per layer) of a track with the given ITS cluster map:
+/// for each layer with a hit, the cluster size is set to the overflow value 0xf
+inline uint32_t itsClusterSizesFromMap(uint8_t itsClusterMap)
+{
+  constexpr int NLayersITS = 7;
+  static constexpr auto Table = [] {
+    std::array<uint32_t, 1 << NLayersITS> table{};
+    for (uint32_t map = 0; map < table.size(); map++) {
+      for (int layer = 0; layer < NLayersITS; layer++) {
+        if (map & (1 << layer)) {
+          table[map] |= (0xfu << (layer * 4));
+        }
+      }
+    }
+    return table;
+  }();
+  return Table[itsClusterMap & ((1 << NLayersITS) - 1)];
+}
+
+/// MFT cluster sizes and track flags (6 bits per layer) of a track with the given number of clusters:
+/// the first nClusters layers get a cluster of size 1
+inline uint64_t mftClusterSizesFromNClusters(int8_t nClusters)
+{
+  constexpr int NLayersMFT = 10;
+  static constexpr auto Table = [] {
+    std::array<uint64_t, NLayersMFT + 1> table{};
+    for (int n = 0; n <= NLayersMFT; n++) {
+      for (int layer = 0; layer < n; layer++) {
+        table[n] |= (1ULL << (layer * 6));
+      }
+    }
+    return table;
+  }();
+  return Table[nClusters < 0 ? 0 : (nClusters > NLayersMFT ? NLayersMFT : nClusters)];
+}
+
+} // namespace o2::aod::converters
+
+#endif // COMMON_TABLEPRODUCER_CONVERTERS_CONVERTERHELPERS_H_
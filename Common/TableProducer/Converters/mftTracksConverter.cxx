@@ -23,6 +23,8 @@
 #include "Framework/AnalysisTask.h"
 #include "Framework/AnalysisDataModel.h"
 
+#include "Common/TableProducer/Converters/converterHelpers.h"
+
 using namespace o2;
 using namespace o2::framework;
 
@@ -31,14 +33,9 @@ struct MftTracksConverter {
   void process(aod::MFTTracks_000 const& mftTracks_000)
   {
 
+    mftTracks_001.reserve(mftTracks_000.size());
     for (const auto& track0 : mftTracks_000) {
-      uint64_t mftClusterSizesAndTrackFlags = 0;
-      int8_t nClusters = track0.nClusters();
-
-      for (int layer = 0; layer < 10; ++layer) {
-        mftClusterSizesAndTrackFlags &= ~(0x3fULL << (layer * 6));
-        mftClusterSizesAndTrackFlags |= (layer < nClusters) ? (1ULL << (layer * 6)) : 0;
-      }
+      uint64_t mftClusterSizesAndTrackFlags = aod::converters::mftClusterSizesFromNClusters(track0.nClusters());
 
       mftTracks_001(track0.collisionId(),
                     track0.x(),
@@ -22,6 +22,7 @@ struct TrackQAConverter002 {
 
   void process000(aod::TracksQA_000 const& tracksQA_000)
   {
+    tracksQA_002.reserve(tracksQA_000.size());
     for (const auto& trackQA : tracksQA_000) {
       tracksQA_002(
         trackQA.trackId(),
@@ -56,6 +57,7 @@ struct TrackQAConverter002 {
 
   void process001(aod::TracksQA_001 const& tracksQA_001)
   {
+    tracksQA_002.reserve(tracksQA_001.size());
     for (const auto& trackQA : tracksQA_001) {
       tracksQA_002(
         trackQA.trackId(),
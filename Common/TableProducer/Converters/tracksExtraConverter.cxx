@@ -23,6 +23,8 @@
 #include "Framework/AnalysisTask.h"
 #include "Framework/AnalysisDataModel.h"
 
+#include "Common/TableProducer/Converters/converterHelpers.h"
+
 using namespace o2;
 using namespace o2::framework;
 
@@ -31,14 +33,10 @@ struct TracksExtraConverter {
   void process(aod::TracksExtra_000 const& tracksExtra_000)
   {
 
+    tracksExtra_001.reserve(tracksExtra_000.size());
     for (const auto& track0 : tracksExtra_000) {
 
-      uint32_t itsClusterSizes = 0;
-      for (int layer = 0; layer < 7; layer++) {
-        if (track0.itsClusterMap() & (1 << layer)) {
-          itsClusterSizes |= (0xf << (layer * 4));
-        }
-      }
+      uint32_t itsClusterSizes = aod::converters::itsClusterSizesFromMap(track0.itsClusterMap());
 
       tracksExtra_001(track0.tpcInnerParam(),
                       track0.flags(),
@@ -19,6 +19,7 @@
 ///         Only the tables for the mass hypotheses requested are filled, the others are sent empty.
 ///
 
+#include <cmath>
 #include <utility>
 #include <vector>
 #include <string>
@@ -71,6 +72,8 @@ struct itsPid {
   Configurable<std::string> recoPass{"recoPass", "", "Reconstruction pass name for CCDB query (automatically takes latest object for timestamp if blank)"};
   Configurable<int64_t> ccdbTimestamp{"ccdb-timestamp", 0, "timestamp of the object used to query in CCDB the detector response. Exceptions: -1 gets the latest object, 0 gets the run dependent timestamp"};
 
+  Produces<o2::aod::ITSClsSizeSummaries> tableClsSizeSummary;
+
   void init(o2::framework::InitContext&)
   {
     if (getFromCCDB) {
@@ -113,6 +116,17 @@ struct itsPid {
     }
   }
   PROCESS_SWITCH(itsPid, processTest, "Produce a test", false);
+
+  void processClusterSizeSummary(o2::soa::Join<aod::TracksIU, aod::TracksExtra> const& tracks)
+  {
+    tableClsSizeSummary.reserve(tracks.size());
+    for (const auto& track : tracks) {
+      const auto summary = o2::aod::ITSResponse::clusterSizeSummary(track.itsClusterSizes());
+      const float cosLambda = 1.f / std::sqrt(1.f + track.tgl() * track.tgl());
+      tableClsSizeSummary(summary.truncatedMean, summary.max, summary.nClusters, summary.truncatedMean * cosLambda);
+    }
+  }
+  PROCESS_SWITCH(itsPid, processClusterSizeSummary, "Produce the table with the summary of the ITS cluster sizes of the tracks", false);
 };
 
 WorkflowSpec defineDataProcessing(ConfigContext const& cfgc)
@@ -18,9 +18,13 @@
 #ifndef COMMON_TABLEPRODUCER_PID_PIDTOFBASE_H_
 #define COMMON_TABLEPRODUCER_PID_PIDTOFBASE_H_
 
+#include <optional>
 #include <string>
 #include <vector>
 
+// O2
+#include "TOFBase/EventTimeMaker.h"
+
 // O2Physics
 #include "PID/ParamBase.h"
 #include "PID/PIDTOF.h"
@@ -52,4 +56,58 @@ DECLARE_SOA_TABLE(EvTimeTOFOnly, "AOD", "EvTimeTOFOnly", //! Table for the TOF e
                   pidtofevtime::EvTimeTOFMult);
 } // namespace o2::aod
 
+namespace o2::pid::tof
+{
+
+/// \brief TOF event time of the collisions of a dataframe, computed once per collision.
+/// The event time of a collision is computed when the first of its tracks is met, then the event time without the
+/// bias of each track is given track by track. Tracks are expected in the order of the track table, so that the
+/// per-track tables stay aligned with the tracks also when the tracks of a collision are not contiguous.
+class TOFEventTimeCache
+{
+ public:
+  struct Entry {
+    std::optional<o2::tof::eventTimeContainer> evTime; // TOF event time of the collision
+    int nGoodTracks = 0;                               // tracks of the collision used in the event time so far
+    float eventTime = 0.f;                             // event time for the current track
+    float eventTimeError = 0.f;                        // error of the event time for the current track
+  };
+
+  /// Forget the collisions of the previous dataframe
+  void reset(int nCollisions)
+  {
+    mEntries.clear();
+    mEntries.resize(nCollisions);
+  }
+
+  /// Entry of the collision, with its event time computed by compute() if the collision was not met yet
+  template <typename TCompute>
+  Entry& get(int collisionId, TCompute&& compute)
+  {
+    if (collisionId >= static_cast<int>(mEntries.size())) {
+      mEntries.resize(collisionId + 1);
+    }
+    auto& entry = mEntries[collisionId];
+    if (!entry.evTime) {
+      entry.evTime.emplace(compute());
+      entry.nGoodTracks = 0;
+      entry.eventTime = entry.evTime->mEventTime;
+      entry.eventTimeError = entry.evTime->mEventTimeError;
+    }
+    return entry;
+  }
+
+  /// Remove the contribution of the next track of the collision from the event time of the entry
+  template <typename TTrack, bool (*trackFilter)(const TTrack&)>
+  static void removeBias(Entry& entry, const TTrack& track)
+  {
+    entry.evTime->template removeBias<TTrack, trackFilter>(track, entry.nGoodTracks, entry.eventTime, entry.eventTimeError, 2);
+  }
+
+ private:
+  std::vector<Entry> mEntries; // per collision index
+};
+
+} // namespace o2::pid::tof
+
 #endif // COMMON_TABLEPRODUCER_PID_PIDTOFBASE_H_
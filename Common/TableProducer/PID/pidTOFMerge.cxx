@@ -636,11 +636,12 @@ struct tofEventTime {
   /// Process function to prepare the event for each track on Run 3 data without the FT0
   // Define slice per collision
   Preslice<Run3TrksWtof> perCollision = aod::track::collisionId;
+  o2::pid::tof::TOFEventTimeCache mEvTimeCache; // TOF event time per collision of the dataframe
   template <o2::track::PID::ID pid>
   using ResponseImplementationEvTime = o2::pid::tof::ExpTimes<Run3TrksWtof::iterator, pid>;
   void processRun3(Run3TrksWtof const& tracks,
                    aod::FT0s const&,
-                   EvTimeCollisionsFT0 const&,
+                   EvTimeCollisionsFT0 const& collisions,
                    aod::BCsWithTimestamps const& bcs)
   {
     if (!enableTableTOFEvTime) {
@@ -675,8 +676,8 @@ struct tofEventTime {
     LOG(debug) << "Running on " << CollisionSystemType::getCollisionSystemName(mTOFCalibConfig.collisionSystem()) << " mComputeEvTimeWithTOF " << mComputeEvTimeWithTOF.value << " mComputeEvTimeWithFT0 " << mComputeEvTimeWithFT0.value;
 
     if (mComputeEvTimeWithTOF == 1 && mComputeEvTimeWithFT0 == 1) {
-      int lastCollisionId = -1;                                                                                       // Last collision ID analysed
-      for (auto const& t : tracks) {                                                                                  // Loop on collisions
+      mEvTimeCache.reset(collisions.size());
+      for (auto const& t : tracks) {                                                                                  // Loop on tracks
         if (!t.has_collision() || ((sel8TOFEvTime.value == true) && !t.collision_as<EvTimeCollisionsFT0>().sel8())) { // Track was not assigned, cannot compute event time or event did not pass the event selection
           tableFlags(0);
           tableEvTime(0.f, 999.f);
@@ -685,75 +686,60 @@ struct tofEventTime {
           }
           continue;
         }
-        if (t.collisionId() == lastCollisionId) { // Event time from this collision is already in the table
-          continue;
-        }
-        /// Create new table for the tracks in a collision
-        lastCollisionId = t.collisionId(); /// Cache last collision ID
-
-        const auto& tracksInCollision = tracks.sliceBy(perCollision, lastCollisionId);
         const auto& collision = t.collision_as<EvTimeCollisionsFT0>();
 
-        // Compute the TOF event time
-        const auto evTimeMakerTOF = evTimeMakerForTracks<Run3TrksWtof::iterator, filterForTOFEventTime, o2::pid::tof::ExpTimes>(tracksInCollision, mRespParamsV3, kDiamond);
-
-        float t0AC[2] = {.0f, 999.f};                                                                                             // Value and error of T0A or T0C or T0AC
-        float t0TOF[2] = {static_cast<float_t>(evTimeMakerTOF.mEventTime), static_cast<float_t>(evTimeMakerTOF.mEventTimeError)}; // Value and error of TOF
+        // TOF event time of the collision, computed when its first track is met
+        auto& evTimeTOF = mEvTimeCache.get(t.collisionId(), [&]() {
+          const auto& tracksInCollision = tracks.sliceBy(perCollision, t.collisionId());
+          return evTimeMakerForTracks<Run3TrksWtof::iterator, filterForTOFEventTime, o2::pid::tof::ExpTimes>(tracksInCollision, mRespParamsV3, kDiamond);
+        });
+        // Remove the bias on TOF ev. time
+        if constexpr (kRemoveTOFEvTimeBias) {
+          o2::pid::tof::TOFEventTimeCache::removeBias<Run3TrksWtof::iterator, filterForTOFEventTime>(evTimeTOF, t);
+        }
+        const float t0TOF[2] = {evTimeTOF.eventTime, evTimeTOF.eventTimeError}; // Value and error of TOF
+        float t0AC[2] = {.0f, 999.f};                                             // Value and error of T0A or T0C or T0AC
 
         uint8_t flags = 0;
-        int nGoodTracksForTOF = 0;
         float eventTime = 0.f;
         float sumOfWeights = 0.f;
         float weight = 0.f;
+        if (t0TOF[1] < kErrDiamond && (maxEvTimeTOF <= 0 || std::abs(t0TOF[0]) < maxEvTimeTOF)) {
+          flags |= o2::aod::pidflags::enums::PIDFlags::EvTimeTOF;
 
-        for (auto const& trk : tracksInCollision) { // Loop on Tracks
-          // Reset the flag
-          flags = 0;
-          // Reset the event time
-          eventTime = 0.f;
-          sumOfWeights = 0.f;
-          weight = 0.f;
-          // Remove the bias on TOF ev. time
-          if constexpr (kRemoveTOFEvTimeBias) {
-            evTimeMakerTOF.removeBias<Run3TrksWtof::iterator, filterForTOFEventTime>(trk, nGoodTracksForTOF, t0TOF[0], t0TOF[1], 2);
-          }
-          if (t0TOF[1] < kErrDiamond && (maxEvTimeTOF <= 0 || std::abs(t0TOF[0]) < maxEvTimeTOF)) {
-            flags |= o2::aod::pidflags::enums::PIDFlags::EvTimeTOF;
+          weight = 1.f / (t0TOF[1] * t0TOF[1]);
+          eventTime += t0TOF[0] * weight;
+          sumOfWeights += weight;
+        }
 
-            weight = 1.f / (t0TOF[1] * t0TOF[1]);
-            eventTime += t0TOF[0] * weight;
-            sumOfWeights += weight;
+        if (collision.has_foundFT0()) { // T0 measurement is available
+          // const auto& ft0 = collision.foundFT0();
+          if (collision.t0ACValid()) {
+            t0AC[0] = collision.t0AC() * 1000.f;
+            t0AC[1] = collision.t0resolution() * 1000.f;
+            flags |= o2::aod::pidflags::enums::PIDFlags::EvTimeT0AC;
           }
 
-          if (collision.has_foundFT0()) { // T0 measurement is available
-            // const auto& ft0 = collision.foundFT0();
-            if (collision.t0ACValid()) {
-              t0AC[0] = collision.t0AC() * 1000.f;
-              t0AC[1] = collision.t0resolution() * 1000.f;
-              flags |= o2::aod::pidflags::enums::PIDFlags::EvTimeT0AC;
-            }
-
-            weight = 1.f / (t0AC[1] * t0AC[1]);
-            eventTime += t0AC[0] * weight;
-            sumOfWeights += weight;
-          }
+          weight = 1.f / (t0AC[1] * t0AC[1]);
+          eventTime += t0AC[0] * weight;
+          sumOfWeights += weight;
+        }
 
-          if (sumOfWeights < kWeightDiamond) { // avoiding sumOfWeights = 0 or worse that kDiamond
-            eventTime = 0;
-            sumOfWeights = kWeightDiamond;
-            tableFlags(0);
-          } else {
-            tableFlags(flags);
-          }
-          tableEvTime(eventTime / sumOfWeights, std::sqrt(1. / sumOfWeights));
-          if (enableTableEvTimeTOFOnly) {
-            tableEvTimeTOFOnly((uint8_t)filterForTOFEventTime(trk), t0TOF[0], t0TOF[1], evTimeMakerTOF.mEventTimeMultiplicity);
-          }
+        if (sumOfWeights < kWeightDiamond) { // avoiding sumOfWeights = 0 or worse that diamond
+          eventTime = 0;
+          sumOfWeights = kWeightDiamond;
+          tableFlags(0);
+        } else {
+          tableFlags(flags);
+        }
+        tableEvTime(eventTime / sumOfWeights, std::sqrt(1. / sumOfWeights));
+        if (enableTableEvTimeTOFOnly) {
+          tableEvTimeTOFOnly((uint8_t)filterForTOFEventTime(t), t0TOF[0], t0TOF[1], evTimeTOF.evTime->mEventTimeMultiplicity);
         }
       }
     } else if (mComputeEvTimeWithTOF == 1 && mComputeEvTimeWithFT0 == 0) {
-      int lastCollisionId = -1;                                                                                    // Last collision ID analysed
-      for (auto const& t : tracks) {                                                                               // Loop on collisions
+      mEvTimeCache.reset(collisions.size());
+      for (auto const& t : tracks) {                                                                               // Loop on tracks
         if (!t.has_collision() || ((sel8TOFEvTime.value == true) && !t.collision_as<EvTimeCollisions>().sel8())) { // Track was not assigned, cannot compute event time or event did not pass the event selection
           tableFlags(0);
           tableEvTime(0.f, 999.f);
@@ -762,36 +748,28 @@ struct tofEventTime {
           }
           continue;
         }
-        if (t.collisionId() == lastCollisionId) { // Event time from this collision is already in the table
-          continue;
-        }
-        /// Create new table for the tracks in a collision
-        lastCollisionId = t.collisionId(); /// Cache last collision ID
 
-        const auto& tracksInCollision = tracks.sliceBy(perCollision, lastCollisionId);
-
-        // First make table for event time
-        const auto evTimeMakerTOF = evTimeMakerForTracks<Run3TrksWtof::iterator, filterForTOFEventTime, o2::pid::tof::ExpTimes>(tracksInCollision, mRespParamsV3, kDiamond);
-        int nGoodTracksForTOF = 0;
-        float et = evTimeMakerTOF.mEventTime;
-        float erret = evTimeMakerTOF.mEventTimeError;
-
-        for (auto const& trk : tracksInCollision) { // Loop on Tracks
-          if constexpr (kRemoveTOFEvTimeBias) {
-            evTimeMakerTOF.removeBias<Run3TrksWtof::iterator, filterForTOFEventTime>(trk, nGoodTracksForTOF, et, erret, 2);
-          }
-          uint8_t flags = 0;
-          if (erret < kErrDiamond && (maxEvTimeTOF <= 0.f || std::abs(et) < maxEvTimeTOF)) {
-            flags |= o2::aod::pidflags::enums::PIDFlags::EvTimeTOF;
-          } else {
-            et = 0.f;
-            erret = kErrDiamond;
-          }
-          tableFlags(flags);
-          tableEvTime(et, erret);
-          if (enableTableEvTimeTOFOnly) {
-            tableEvTimeTOFOnly((uint8_t)filterForTOFEventTime(trk), et, erret, evTimeMakerTOF.mEventTimeMultiplicity);
-          }
+        // TOF event time of the collision, computed when its first track is met
+        auto& evTimeTOF = mEvTimeCache.get(t.collisionId(), [&]() {
+          const auto& tracksInCollision = tracks.sliceBy(perCollision, t.collisionId());
+          return evTimeMakerForTracks<Run3TrksWtof::iterator, filterForTOFEventTime, o2::pid::tof::ExpTimes>(tracksInCollision, mRespParamsV3, kDiamond);
+        });
+        if constexpr (kRemoveTOFEvTimeBias) {
+          o2::pid::tof::TOFEventTimeCache::removeBias<Run3TrksWtof::iterator, filterForTOFEventTime>(evTimeTOF, t);
+        }
+        float& et = evTimeTOF.eventTime;
+        float& erret = evTimeTOF.eventTimeError;
+        uint8_t flags = 0;
+        if (erret < kErrDiamond && (maxEvTimeTOF <= 0.f || std::abs(et) < maxEvTimeTOF)) {
+          flags |= o2::aod::pidflags::enums::PIDFlags::EvTimeTOF;
+        } else {
+          et = 0.f;
+          erret = kErrDiamond;
+        }
+        tableFlags(flags);
+        tableEvTime(et, erret);
+        if (enableTableEvTimeTOFOnly) {
+          tableEvTimeTOFOnly((uint8_t)filterForTOFEventTime(t), et, erret, evTimeTOF.evTime->mEventTimeMultiplicity);
         }
       }
     } else if (mComputeEvTimeWithTOF == 0 && mComputeEvTimeWithFT0 == 1) {
@@ -885,6 +863,20 @@ struct tofPidMerge {
   Configurable<bool> enableQaHistograms{"enableQaHistograms", false, "Flag to enable the QA histograms"};
   Configurable<bool> enableTOFParamsForBetaMass{"enableTOFParamsForBetaMass", false, "Flag to use TOF parameters for TOF Beta and Mass"};
 
+  // Tabulated resolution and time shift, built at each run change
+  struct : ConfigurableGroup {
+    Configurable<bool> cfgEnableTables{"enableResolutionTables", false, "Flag to evaluate the expected resolution and time shift from (p, eta) lookup tables instead of the analytic parametrisation"};
+    Configurable<int> cfgTableNP{"tableNP", 800, "Number of momentum points of the lookup tables"};
+    Configurable<float> cfgTablePMin{"tablePMin", 0.1f, "Lower momentum edge of the lookup tables, outside the analytic parametrisation is used"};
+    Configurable<float> cfgTablePMax{"tablePMax", 20.f, "Upper momentum edge of the lookup tables, outside the analytic parametrisation is used"};
+    Configurable<int> cfgTableNEta{"tableNEta", 101, "Number of eta points of the lookup tables"};
+    Configurable<float> cfgTableEtaMin{"tableEtaMin", -1.f, "Lower eta edge of the lookup tables, outside the analytic parametrisation is used"};
+    Configurable<float> cfgTableEtaMax{"tableEtaMax", 1.f, "Upper eta edge of the lookup tables, outside the analytic parametrisation is used"};
+    Configurable<int> cfgTableCheckPoints{"tableCheckPoints", 0, "Number of points per dimension to check the lookup tables against the analytic parametrisation (0 = no check)"};
+    Configurable<float> cfgTableMaxRelDeviation{"tableMaxRelDeviation", 0.005f, "Maximum relative deviation of the tabulated resolution from the analytic one, the tables are disabled if exceeded"};
+  } cfgTables;
+  int mLastRunNumberTables = -1; // Run number for which the lookup tables were built
+
   // Configuration flags to include and exclude particle hypotheses
   Configurable<LabeledArray<int>> enableParticle{"enableParticle",
                                                  {kDefaultParEnabled[0], nSpecies, kParEnabledN, particleNames, kParEnabledNames},
@@ -1150,6 +1142,24 @@ struct tofPidMerge {
 
   void process(aod::BCs const&) {}
 
+  /// Builds the lookup tables of the resolution and time shift from the current parametrisation, once per run
+  template <typename BcType>
+  void updateResolutionTables(const BcType& bc)
+  {
+    if (!cfgTables.cfgEnableTables || mLastRunNumberTables == bc.runNumber()) {
+      return;
+    }
+    mLastRunNumberTables = bc.runNumber();
+    mRespParamsV3.setResolutionTables(cfgTables.cfgTableNP, cfgTables.cfgTablePMin, cfgTables.cfgTablePMax, cfgTables.cfgTableNEta, cfgTables.cfgTableEtaMin, cfgTables.cfgTableEtaMax);
+    if (cfgTables.cfgTableCheckPoints > 0) {
+      const float deviation = mRespParamsV3.checkResolutionTables(cfgTables.cfgTableCheckPoints);
+      if (deviation > cfgTables.cfgTableMaxRelDeviation) {
+        LOG(warning) << "Lookup tables of the TOF resolution deviate by " << deviation << " from the analytic parametrisation (max. allowed " << cfgTables.cfgTableMaxRelDeviation.value << ") for run " << bc.runNumber() << ": using the analytic parametrisation";
+        mRespParamsV3.resetResolutionTables();
+      }
+    }
+  }
+
   template <o2::track::PID::ID pid>
   using ResponseImplementation = o2::pid::tof::ExpTimes<Run3TrksWtofWevTime::iterator, pid>;
   void processRun3(Run3TrksWtofWevTime const& tracks,
@@ -1167,6 +1177,7 @@ struct tofPidMerge {
     constexpr auto responseAl = ResponseImplementation<PID::Alpha>();
 
     mTOFCalibConfig.processSetup(mRespParamsV3, ccdb, bcs.iteratorAt(0)); // Update the calibration parameters
+    updateResolutionTables(bcs.iteratorAt(0));
 
     for (auto const& pidId : mEnabledParticles) {
       reserveTable(pidId, tracks.size(), false);
@@ -1329,6 +1340,7 @@ struct tofPidMerge {
     constexpr auto responseAl = ResponseImplementationRun2<PID::Alpha>();
 
     mTOFCalibConfig.processSetup(mRespParamsV3, ccdb, bcs.iteratorAt(0)); // Update the calibration parameters
+    updateResolutionTables(bcs.iteratorAt(0));
 
     for (auto const& pidId : mEnabledParticles) {
       reserveTable(pidId, tracks.size(), false);
@@ -1528,8 +1540,17 @@ WorkflowSpec defineDataProcessing(ConfigContext const& cfgc)
 {
   // Parse the metadata
   metadataInfo.initMetadata(cfgc);
-  auto workflow = WorkflowSpec{adaptAnalysisTask<tofSignal>(cfgc)};
-  workflow.push_back(adaptAnalysisTask<tofEventTime>(cfgc));
-  workflow.push_back(adaptAnalysisTask<tofPidMerge>(cfgc));
+  // Each task is left out if its tables are read from the input
+  auto workflow = WorkflowSpec{};
+  if (!areTablesInInput(cfgc, {"TOFSignal", "pidTOFFlags"})) {
+    workflow.push_back(adaptAnalysisTask<tofSignal>(cfgc));
+  }
+  if (!areTablesInInput(cfgc, {"TOFEvTime", "EvTimeTOFOnly", "pidEvTimeFlags"})) {
+    workflow.push_back(adaptAnalysisTask<tofEventTime>(cfgc));
+  }
+  if (!areTablesInInput(cfgc, {"pidTOFFullEl", "pidTOFFullMu", "pidTOFFullPi", "pidTOFFullKa", "pidTOFFullPr", "pidTOFFullDe", "pidTOFFullTr", "pidTOFFullHe", "pidTOFFullAl",
+                               "pidTOFEl", "pidTOFMu", "pidTOFPi", "pidTOFKa", "pidTOFPr", "pidTOFDe", "pidTOFTr", "pidTOFHe", "pidTOFAl", "pidTOFbeta", "pidTOFmass"})) {
+    workflow.push_back(adaptAnalysisTask<tofPidMerge>(cfgc));
+  }
   return workflow;
 }
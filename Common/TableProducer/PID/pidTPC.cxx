@@ -18,6 +18,7 @@
 /// \brief  Task to produce PID tables for TPC split for each particle.
 ///         Only the tables for the mass hypotheses requested are filled, and only for the requested table size ("Full" or "Tiny"). The others are sent empty.
 ///
+#include <algorithm>
 #include <utility>
 #include <map>
 #include <memory>
@@ -33,15 +34,19 @@
 #include "Framework/AnalysisTask.h"
 #include "Framework/runDataProcessing.h"
 #include "Framework/ASoAHelpers.h"
+#include "Framework/HistogramRegistry.h"
 #include "ReconstructionDataFormats/Track.h"
 #include "CCDB/CcdbApi.h"
 #include "Common/DataModel/PIDResponseTPC.h"
 #include "Common/Core/PID/TPCPIDResponse.h"
+#include "Common/Core/TaskInstrumentation.h"
+#include "Common/Core/ThreadBudget.h"
 #include "Framework/AnalysisDataModel.h"
 #include "Common/DataModel/Multiplicity.h"
 #include "Common/DataModel/EventSelection.h"
 #include "TableHelper.h"
 #include "Tools/ML/model.h"
+#include "Tools/ML/SessionRegistry.h"
 #include "pidTPCBase.h"
 #include "MetadataHelper.h"
 
@@ -103,6 +108,23 @@ struct tpcPid {
   std::vector<int> speciesNetworkFlags = std::vector<int>(9);
   std::string networkVersion;
 
+  // Per-DF track columns used as network input
+  std::vector<float> netTpcInnerParam;
+  std::vector<float> netTgl;
+  std::vector<float> netSigned1Pt;
+  std::vector<float> netMult;
+  std::vector<float> netNcl;
+  std::vector<float> netOccupancy;
+
+  // Per-DF track columns and expected signals/sigmas of the columnar mode, species-major
+  std::vector<float> colTpcInnerParam;
+  std::vector<float> colTgl;
+  std::vector<float> colSigned1Pt;
+  std::vector<float> colNClsFound;
+  std::vector<float> colMultTPC;
+  std::vector<float> colExpSignal;
+  std::vector<float> colExpSigma;
+
   // Input parameters
   Service<o2::ccdb::BasicCCDBManager> ccdb;
   Configurable<std::string> paramfile{"param-file", "", "Path to the parametrization object, if empty the parametrization is not taken from file"};
@@ -118,6 +140,8 @@ struct tpcPid {
   Configurable<std::string> networkPathCCDB{"networkPathCCDB", "Analysis/PID/TPC/ML", "Path on CCDB"};
   Configurable<bool> enableNetworkOptimizations{"enableNetworkOptimizations", 1, "(bool) If the neural network correction is used, this enables GraphOptimizationLevel::ORT_ENABLE_EXTENDED in the ONNX session"};
   Configurable<int> networkSetNumThreads{"networkSetNumThreads", 0, "Especially important for running on a SLURM cluster. Sets the number of threads used for execution."};
+  Configurable<int> threadBudget{"threadBudget", 0, "Total number of threads of the ONNX sessions and other thread pools of all the tasks of the device, shared with the other tasks (0 = no limit)"};
+  Configurable<int> onnxGlobalThreads{"onnxGlobalThreads", 0, "Number of threads of a process-wide ONNX thread pool used by all the sessions of the device (0 = one thread pool per session)"};
   // Configuration flags to include and exclude particle hypotheses
   Configurable<int> pidFullEl{"pid-full-el", -1, {"Produce PID information for the Electron mass hypothesis, overrides the automatic setup: the corresponding table can be set off (0) or on (1)"}};
   Configurable<int> pidFullMu{"pid-full-mu", -1, {"Produce PID information for the Muon mass hypothesis, overrides the automatic setup: the corresponding table can be set off (0) or on (1)"}};
@@ -148,16 +172,34 @@ struct tpcPid {
   Configurable<int> useNetworkHe{"useNetworkHe", 1, {"Switch for applying neural network on the helium3 mass hypothesis (if network enabled) (set to 0 to disable)"}};
   Configurable<int> useNetworkAl{"useNetworkAl", 1, {"Switch for applying neural network on the alpha mass hypothesis (if network enabled) (set to 0 to disable)"}};
   Configurable<float> networkBetaGammaCutoff{"networkBetaGammaCutoff", 0.45, {"Lower value of beta-gamma to override the NN application"}};
+  Configurable<int> networkBatchSize{"networkBatchSize", 0, {"Maximum number of tracks evaluated in a single network call (0 = all tracks of the DF)"}};
+  Configurable<bool> useColumnarResponse{"useColumnarResponse", false, {"(bool) Evaluate the expected signal and sigma of all mass hypotheses for the whole DF at once. The response object is taken at the first track of the DF"}};
+  Configurable<bool> enableInstrumentation{"enableInstrumentation", false, {"(bool) Time the processing and the network evaluation and publish them in the Instrumentation folder"}};
 
   // Parametrization configuration
   bool useCCDBParam = false;
 
+  // Timing of the hot sections
+  enum InstrumentedSections { kProcess = 0,
+                              kNetworkTotal,
+                              kNetworkEval };
+  HistogramRegistry registry{"registry", {}, OutputObjHandlingPolicy::AnalysisObject};
+  o2::common::core::TaskInstrumentation instrumentation;
+
   void init(o2::framework::InitContext& initContext)
   {
     // Protection for process flags
     if ((doprocessStandard && doprocessMcTuneOnData) || (!doprocessStandard && !doprocessMcTuneOnData)) {
       LOG(fatal) << "pid-tpc must have only one of the options 'processStandard' OR 'processMcTuneOnData' enabled. Please check your configuration.";
     }
+    if (enableInstrumentation) {
+      instrumentation.init(registry, "pid-tpc", {"Process", "NetworkTotal", "NetworkEval"});
+    }
+    // Process-wide settings, to be set before the first ONNX session of the device is created
+    o2::common::core::ThreadBudget::instance().configure(threadBudget.value);
+    if (onnxGlobalThreads.value > 0) {
+      o2::ml::SessionRegistry::instance().configure(onnxGlobalThreads.value);
+    }
     response = new o2::pid::tpc::Response();
     // Checking the tables are requested in the workflow and enabling them
     auto enableFlag = [&](const std::string particle, Configurable<int>& flag) {
@@ -296,7 +338,7 @@ struct tpcPid {
 
     std::vector<float> network_prediction;
 
-    auto start_network_total = std::chrono::high_resolution_clock::now();
+    auto timerNetworkTotal = instrumentation.time(kNetworkTotal, size * 9);
     if (autofetchNetworks) {
       const auto& bc = bcs.begin();
       // Initialise correct TPC response object before NN setup (for NCl normalisation)
@@ -346,60 +388,70 @@ struct tpcPid {
 
     network_prediction = std::vector<float>(prediction_size * 9); // For each mass hypotheses
     const float nNclNormalization = response->GetNClNormalization();
-    float duration_network = 0;
+    double duration_network = 0;
+
+    // Reading the track columns once per DF in SoA arrays, the network input for each mass hypothesis is then built from them
+    netTpcInnerParam.clear();
+    netTgl.clear();
+    netSigned1Pt.clear();
+    netMult.clear();
+    netNcl.clear();
+    netOccupancy.clear();
+    const bool useOccupancy = input_dimensions == 7 && networkVersion == "2";
+    for (auto const& trk : tracks) {
+      if (!trk.hasTPC()) {
+        continue;
+      }
+      if (skipTPCOnly) {
+        if (!trk.hasITS() && !trk.hasTRD() && !trk.hasTOF()) {
+          continue;
+        }
+      }
+      netTpcInnerParam.push_back(trk.tpcInnerParam());
+      netTgl.push_back(trk.tgl());
+      netSigned1Pt.push_back(trk.signed1Pt());
+      netMult.push_back(trk.has_collision() ? collisions.iteratorAt(trk.collisionId()).multTPC() / 11000. : 1.);
+      netNcl.push_back(std::sqrt(nNclNormalization / trk.tpcNClsFound()));
+      if (useOccupancy) {
+        netOccupancy.push_back(trk.has_collision() ? collisions.iteratorAt(trk.collisionId()).ft0cOccupancyInTimeRange() / 60000. : 1.);
+      }
+    }
 
     std::vector<float> track_properties(track_prop_size);
-    uint64_t counter_track_props = 0;
-    int loop_counter = 0;
+    std::vector<float> output_network;
 
     // Filling a std::vector<float> to be evaluated by the network
-    // Evaluation on single tracks brings huge overhead: Thus evaluation is done on one large vector
+    // Evaluation on single tracks brings huge overhead: Thus evaluation is done on one large vector, split in chunks of networkBatchSize tracks
     for (int i = 0; i < 9; i++) { // Loop over particle number for which network correction is used
-      for (auto const& trk : tracks) {
-        if (!trk.hasTPC()) {
-          continue;
-        }
-        if (skipTPCOnly) {
-          if (!trk.hasITS() && !trk.hasTRD() && !trk.hasTOF()) {
-            continue;
-          }
-        }
-        track_properties[counter_track_props] = trk.tpcInnerParam();
-        track_properties[counter_track_props + 1] = trk.tgl();
-        track_properties[counter_track_props + 2] = trk.signed1Pt();
-        track_properties[counter_track_props + 3] = o2::track::pid_constants::sMasses[i];
-        track_properties[counter_track_props + 4] = trk.has_collision() ? collisions.iteratorAt(trk.collisionId()).multTPC() / 11000. : 1.;
-        track_properties[counter_track_props + 5] = std::sqrt(nNclNormalization / trk.tpcNClsFound());
-        if (input_dimensions == 7 && networkVersion == "2") {
-          track_properties[counter_track_props + 6] = trk.has_collision() ? collisions.iteratorAt(trk.collisionId()).ft0cOccupancyInTimeRange() / 60000. : 1.;
-        }
-        counter_track_props += input_dimensions;
-      }
-
-      auto start_network_eval = std::chrono::high_resolution_clock::now();
-      float* output_network = network.evalModel(track_properties);
-      auto stop_network_eval = std::chrono::high_resolution_clock::now();
-      duration_network += std::chrono::duration<float, std::ratio<1, 1000000000>>(stop_network_eval - start_network_eval).count();
-      for (uint64_t i = 0; i < prediction_size; i += output_dimensions) {
-        for (int j = 0; j < output_dimensions; j++) {
-          network_prediction[i + j + prediction_size * loop_counter] = output_network[i + j];
+      const float mass = o2::track::pid_constants::sMasses[i];
+      for (uint64_t itrk = 0; itrk < size; itrk++) {
+        float* props = track_properties.data() + itrk * input_dimensions;
+        props[0] = netTpcInnerParam[itrk];
+        props[1] = netTgl[itrk];
+        props[2] = netSigned1Pt[itrk];
+        props[3] = mass;
+        props[4] = netMult[itrk];
+        props[5] = netNcl[itrk];
+        if (useOccupancy) {
+          props[6] = netOccupancy[itrk];
         }
       }
 
-      counter_track_props = 0;
-      loop_counter += 1;
+      auto timerNetworkEval = instrumentation.time(kNetworkEval, size);
+      network.evalModelBatch(track_properties, output_network, static_cast<std::size_t>(networkBatchSize.value));
+      duration_network += timerNetworkEval.stop();
+      std::copy_n(output_network.begin(), std::min<uint64_t>(prediction_size, output_network.size()), network_prediction.begin() + prediction_size * i);
     }
-    track_properties.clear();
 
-    auto stop_network_total = std::chrono::high_resolution_clock::now();
+    const double duration_network_total = timerNetworkTotal.stop();
     LOG(debug) << "Neural Network for the TPC PID response correction: Time per track (eval ONNX): " << duration_network / (size * 9) << "ns ; Total time (eval ONNX): " << duration_network / 1000000000 << " s";
-    LOG(debug) << "Neural Network for the TPC PID response correction: Time per track (eval + overhead): " << std::chrono::duration<float, std::ratio<1, 1000000000>>(stop_network_total - start_network_total).count() / (size * 9) << "ns ; Total time (eval + overhead): " << std::chrono::duration<float, std::ratio<1, 1000000000>>(stop_network_total - start_network_total).count() / 1000000000 << " s";
+    LOG(debug) << "Neural Network for the TPC PID response correction: Time per track (eval + overhead): " << duration_network_total / (size * 9) << "ns ; Total time (eval + overhead): " << duration_network_total / 1000000000 << " s";
 
     return network_prediction;
   }
 
   template <typename C, typename T, typename NSF, typename NST>
-  void makePidTables(const int flagFull, NSF& tableFull, const int flagTiny, NST& tableTiny, const o2::track::PID::ID pid, const float tpcSignal, const T& trk, const C& collisions, const std::vector<float>& network_prediction, const int& count_tracks, const int& tracksForNet_size)
+  void makePidTables(const int flagFull, NSF& tableFull, const int flagTiny, NST& tableTiny, const o2::track::PID::ID pid, const float tpcSignal, const T& trk, const C& collisions, const std::vector<float>& network_prediction, const int& count_tracks, const int& tracksForNet_size, const int64_t columnarIndex = -1)
   {
     if (flagFull != 1 && flagTiny != 1) {
       return;
@@ -420,9 +472,16 @@ struct tpcPid {
         return;
       }
     }
-    auto expSignal = response->GetExpectedSignal(trk, pid);
-    auto expSigma = trk.has_collision() ? response->GetExpectedSigma(collisions.iteratorAt(trk.collisionId()), trk, pid) : 0.07 * expSignal; // use default sigma value of 7% if no collision information to estimate resolution
-    if (expSignal < 0. || expSigma < 0.) {                                                                                                   // skip if expected signal invalid
+    float expSignal = 0.f;
+    float expSigma = 0.f;
+    if (columnarIndex >= 0) { // precomputed for the whole DF
+      expSignal = colExpSignal[pid * colTpcInnerParam.size() + columnarIndex];
+      expSigma = trk.has_collision() ? colExpSigma[pid * colTpcInnerParam.size() + columnarIndex] : 0.07 * expSignal;
+    } else {
+      expSignal = response->GetExpectedSignal(trk, pid);
+      expSigma = trk.has_collision() ? response->GetExpectedSigma(collisions.iteratorAt(trk.collisionId()), trk, pid) : 0.07 * expSignal; // use default sigma value of 7% if no collision information to estimate resolution
+    }
+    if (expSignal < 0. || expSigma < 0.) { // skip if expected signal invalid
       if (flagFull)
         tableFull(-999.f, -999.f);
       if (flagTiny)
@@ -452,6 +511,8 @@ struct tpcPid {
       } else {
         LOGF(fatal, "Network output-dimensions incompatible!");
       }
+    } else if (columnarIndex >= 0) {
+      nSigma = (tpcSignal - expSignal) / expSigma;
     } else {
       nSigma = response->GetNumberOfSigmaMCTuned(collisions.iteratorAt(trk.collisionId()), trk, pid, tpcSignal);
     }
@@ -461,10 +522,35 @@ struct tpcPid {
       aod::pidtpc_tiny::binning::packInTable(nSigma, tableTiny);
   };
 
+  /// Columnar mode: reads the track columns in SoA arrays and evaluates the expected signal and sigma of all mass hypotheses at once
+  template <typename C, typename T>
+  void fillColumnarResponse(C const& collisions, T const& tracks)
+  {
+    const std::size_t nTracks = tracks.size();
+    colTpcInnerParam.resize(nTracks);
+    colTgl.resize(nTracks);
+    colSigned1Pt.resize(nTracks);
+    colNClsFound.resize(nTracks);
+    colMultTPC.resize(nTracks);
+    colExpSignal.resize(o2::track::PID::NIDs * nTracks);
+    colExpSigma.resize(o2::track::PID::NIDs * nTracks);
+    std::size_t itrk = 0;
+    for (auto const& trk : tracks) {
+      colTpcInnerParam[itrk] = trk.tpcInnerParam();
+      colTgl[itrk] = trk.tgl();
+      colSigned1Pt[itrk] = trk.signed1Pt();
+      colNClsFound[itrk] = trk.tpcNClsFound();
+      colMultTPC[itrk] = trk.has_collision() ? collisions.iteratorAt(trk.collisionId()).multTPC() : 0.f;
+      itrk++;
+    }
+    response->GetExpectedSignalsAndSigmas(nTracks, colTpcInnerParam.data(), colTgl.data(), colSigned1Pt.data(), colNClsFound.data(), colMultTPC.data(), colExpSignal.data(), colExpSigma.data());
+  }
+
   void processStandard(Coll const& collisions, Trks const& tracks, aod::BCsWithTimestamps const& bcs)
   {
 
     const uint64_t outTable_size = tracks.size();
+    auto timerProcess = instrumentation.time(kProcess, outTable_size);
 
     auto reserveTable = [&outTable_size](const Configurable<int>& flag, auto& table) {
       if (flag.value != 1) {
@@ -502,6 +588,7 @@ struct tpcPid {
     }
 
     uint64_t count_tracks = 0;
+    int64_t columnarIndex = -1;
 
     for (auto const& trk : tracks) {
       // Loop on Tracks
@@ -527,8 +614,15 @@ struct tpcPid {
         response->PrintAll();
       }
 
-      auto makePidTablesDefault = [&trk, &collisions, &network_prediction, &count_tracks, &tracksForNet_size, this](const int flagFull, auto& tableFull, const int flagTiny, auto& tableTiny, const o2::track::PID::ID pid) {
-        makePidTables(flagFull, tableFull, flagTiny, tableTiny, pid, trk.tpcSignal(), trk, collisions, network_prediction, count_tracks, tracksForNet_size);
+      if (useColumnarResponse) {
+        if (columnarIndex < 0) { // first track of the DF, the response is now up to date
+          fillColumnarResponse(collisions, tracks);
+        }
+        columnarIndex++;
+      }
+
+      auto makePidTablesDefault = [&trk, &collisions, &network_prediction, &count_tracks, &tracksForNet_size, &columnarIndex, this](const int flagFull, auto& tableFull, const int flagTiny, auto& tableTiny, const o2::track::PID::ID pid) {
+        makePidTables(flagFull, tableFull, flagTiny, tableTiny, pid, trk.tpcSignal(), trk, collisions, network_prediction, count_tracks, tracksForNet_size, columnarIndex);
       };
 
       makePidTablesDefault(pidFullEl, tablePIDFullEl, pidTinyEl, tablePIDTinyEl, o2::track::PID::Electron);
@@ -556,6 +650,7 @@ struct tpcPid {
   {
     gRandom->SetSeed(0); // Ensure unique seed from UUID for each process call
     const uint64_t outTable_size = tracksMc.size();
+    auto timerProcess = instrumentation.time(kProcess, outTable_size);
 
     auto reserveTable = [&outTable_size](const Configurable<int>& flag, auto& table) {
       if (flag.value != 1) {
@@ -678,5 +773,10 @@ struct tpcPid {
 WorkflowSpec defineDataProcessing(ConfigContext const& cfgc)
 {
   metadataInfo.initMetadata(cfgc); // Parse AO2D metadata
+  if (areTablesInInput(cfgc, {"pidTPCFullEl", "pidTPCFullMu", "pidTPCFullPi", "pidTPCFullKa", "pidTPCFullPr", "pidTPCFullDe", "pidTPCFullTr", "pidTPCFullHe", "pidTPCFullAl",
+                              "pidTPCEl", "pidTPCMu", "pidTPCPi", "pidTPCKa", "pidTPCPr", "pidTPCDe", "pidTPCTr", "pidTPCHe", "pidTPCAl", "MCTPCTUNEONDATA"})) {
+    LOG(info) << "TPC PID tables read from the input, the TPC PID task is not added";
+    return WorkflowSpec{};
+  }
   return WorkflowSpec{adaptAnalysisTask<tpcPid>(cfgc)};
 }
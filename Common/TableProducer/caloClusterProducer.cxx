@@ -15,9 +15,13 @@
 /// \author Dmitri Peresunko <Dmitri.Peresunko@cern.ch>
 
 #include <algorithm>
+#include <array>
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "Framework/ConfigParamSpec.h"
@@ -110,6 +114,16 @@ struct CaloClusterProducer {
     int mEnd[kCpvCells];   // Z (theta) track coordinate in PHOS plane
   };
 
+  // CPV clusters and tracks per grid cell and TrigRec, kept across TFs to reuse their storage
+  std::vector<std::pair<float, float>> cpvMatchPoints[kCpvCells]; // CPV clusters in grid/cell in PHOS
+  std::vector<TrackTrigRec> cpvNMatchPoints;                      // Number of entries in each cell per TrigRecord
+  std::vector<TrackMatch> trackMatchPoints[kCpvCells];            // tracks hit in grid/cell in PHOS
+  std::vector<TrackTrigRec> trackNMatchPoints;                    // Number of entries in each cell per TrigRecord
+  std::unordered_map<int64_t, int> cpvTRIndex;                    // first CPV TrigRec of each BC
+  std::unordered_map<int64_t, int> trackTRIndex;                  // first track TrigRec of each BC
+  std::unordered_set<int64_t> phosTRBCs;                          // BCs with PHOS clusters
+  std::array<std::vector<int>, kCpvCells> cpvNeighbours;          // grid cells around each grid cell, starting with the cell itself
+
   void init(o2::framework::InitContext&)
   {
     ccdb->setURL(o2::base::NameConf::getCCDBServer());
@@ -117,6 +131,24 @@ struct CaloClusterProducer {
     ccdb->setLocalObjectValidityChecking();
     geomPHOS = std::make_unique<o2::phos::Geometry>("PHOS");
     clusterizerPHOS = std::make_unique<o2::phos::Clusterer>();
+
+    // The 9 regions looked at around a PHOS cluster, within the same module
+    for (int mod = 1; mod <= 4; mod++) {
+      for (int ix = 0; ix < kCpvX; ix++) {
+        for (int iz = 0; iz < kCpvZ; iz++) {
+          const int index = (mod - 1) * kCpvX * kCpvZ + ix * kCpvZ + iz;
+          cpvNeighbours[index] = {index};
+          for (int dx = -1; dx <= 1; dx++) {
+            for (int dz = -1; dz <= 1; dz++) {
+              if ((dx == 0 && dz == 0) || ix + dx < 0 || ix + dx >= kCpvX || iz + dz < 0 || iz + dz >= kCpvZ) {
+                continue;
+              }
+              cpvNeighbours[index].push_back(index + dx * kCpvZ + dz);
+            }
+          }
+        }
+      }
+    }
   }
 
   void processStandalone(o2::aod::BCsWithTimestamps const& bcs,
@@ -225,9 +257,10 @@ struct CaloClusterProducer {
                                   outputPHOSClusters, outputCluElements, outputPHOSClusterTrigRecs, dummyMC);
 
     // Find  CPV clusters corresponding to PHOS trigger records
-    std::vector<std::pair<float, float>> cpvMatchPoints[kCpvCells];
-    // Number of entries in each cell per TrigRecord
-    std::vector<TrackTrigRec> cpvNMatchPoints;
+    for (auto& points : cpvMatchPoints) {
+      points.clear();
+    }
+    cpvNMatchPoints.clear();
     cpvNMatchPoints.reserve(outputPHOSClusterTrigRecs.size());
     int64_t curBC = -1;
     if (cpvs.begin() != cpvs.end()) {
@@ -266,6 +299,7 @@ struct CaloClusterProducer {
     }
 
     // Fill output
+    indexTrigRecs(cpvNMatchPoints, cpvTRIndex);
     for (const auto& cluTR : outputPHOSClusterTrigRecs) {
       int firstClusterInEvent = cluTR.getFirstEntry();
       int lastClusterInEvent = firstClusterInEvent + cluTR.getNumberOfObjects();
@@ -283,14 +317,8 @@ struct CaloClusterProducer {
 
       bool cpvExist = false;
       // find cpvTR for this BC
-      auto cpvPoints = cpvNMatchPoints.begin();
-      while (cpvPoints != cpvNMatchPoints.end()) {
-        if (cpvPoints->mTR == cluTR.getBCData().toLong()) {
-          cpvExist = true;
-          break;
-        }
-        cpvPoints++;
-      }
+      auto cpvPoints = findTrigRec(cpvNMatchPoints, cpvTRIndex, cluTR.getBCData().toLong());
+      cpvExist = cpvPoints != cpvNMatchPoints.end();
 
       for (int i = firstClusterInEvent; i < lastClusterInEvent; i++) {
         o2::phos::Cluster& clu = outputPHOSClusters[i];
@@ -322,38 +350,11 @@ struct CaloClusterProducer {
         mom.SetMag(e);
 
         float cpvdist = 99.;
-        const float cellSizeX = 2 * kCpvMaxX / kCpvX;
-        const float cellSizeZ = 2 * kCpvMaxZ / kCpvZ;
         // look 9 CPV regions around PHOS cluster
 
         if (mod >= 2 && cpvExist) { // CPV exist in mods 2,3,4
           int phosIndex = cpvMatchIndex(mod, posX, posZ);
-          std::vector<int> regions;
-          regions.push_back(phosIndex);
-          if (posX > -kCpvMaxX + cellSizeX) {
-            if (posZ > -kCpvMaxZ + cellSizeZ) { // bottom left
-              regions.push_back(phosIndex - kCpvZ - 1);
-            }
-            regions.push_back(phosIndex - kCpvZ);
-            if (posZ < kCpvMaxZ - cellSizeZ) { // top left
-              regions.push_back(phosIndex - kCpvZ + 1);
-            }
-          }
-          if (posZ > -kCpvMaxZ + cellSizeZ) { // bottom
-            regions.push_back(phosIndex - 1);
-          }
-          if (posZ < kCpvMaxZ - cellSizeZ) { // top
-            regions.push_back(phosIndex + 1);
-          }
-          if (posX < kCpvMaxX - cellSizeX) {
-            if (posZ > -kCpvMaxZ + cellSizeZ) { // bottom right
-              regions.push_back(phosIndex + kCpvZ - 1);
-            }
-            regions.push_back(phosIndex + kCpvZ);
-            if (posZ < kCpvMaxZ - cellSizeZ) { // top right
-              regions.push_back(phosIndex + kCpvZ + 1);
-            }
-          }
+          auto const& regions = cpvNeighbours[phosIndex];
           float sigmaX = 1. / std::min(5.2, 1.111 + 0.56 * std::exp(-0.031 * e * e) + 4.8 / std::pow(e + 0.61, 3)); // inverse sigma X
           float sigmaZ = 1. / std::min(3.3, 1.12 + 0.35 * std::exp(-0.032 * e * e) + 0.75 / std::pow(e + 0.24, 3)); // inverse sigma Z
 
@@ -541,9 +542,10 @@ struct CaloClusterProducer {
                                   outputPHOSClusters, outputCluElements, outputPHOSClusterTrigRecs, outputTruthCont);
 
     // Find  CPV clusters corresponding to PHOS trigger records
-    std::vector<std::pair<float, float>> cpvMatchPoints[kCpvCells];
-    // Number of entries in each cell per TrigRecord
-    std::vector<TrackTrigRec> cpvNMatchPoints;
+    for (auto& points : cpvMatchPoints) {
+      points.clear();
+    }
+    cpvNMatchPoints.clear();
     cpvNMatchPoints.reserve(outputPHOSClusterTrigRecs.size());
     int64_t curBC = -1;
     if (cpvs.begin() != cpvs.end()) {
@@ -582,6 +584,7 @@ struct CaloClusterProducer {
     }
 
     // Fill output
+    indexTrigRecs(cpvNMatchPoints, cpvTRIndex);
     for (const auto& cluTR : outputPHOSClusterTrigRecs) {
       int firstClusterInEvent = cluTR.getFirstEntry();
       int lastClusterInEvent = firstClusterInEvent + cluTR.getNumberOfObjects();
@@ -599,14 +602,8 @@ struct CaloClusterProducer {
 
       bool cpvExist = false;
       // find cpvTR for this BC
-      auto cpvPoints = cpvNMatchPoints.begin();
-      while (cpvPoints != cpvNMatchPoints.end()) {
-        if (cpvPoints->mTR == cluTR.getBCData().toLong()) {
-          cpvExist = true;
-          break;
-        }
-        cpvPoints++;
-      }
+      auto cpvPoints = findTrigRec(cpvNMatchPoints, cpvTRIndex, cluTR.getBCData().toLong());
+      cpvExist = cpvPoints != cpvNMatchPoints.end();
 
       for (int i = firstClusterInEvent; i < lastClusterInEvent; i++) {
         o2::phos::Cluster& clu = outputPHOSClusters[i];
@@ -638,38 +635,11 @@ struct CaloClusterProducer {
         mom.SetMag(e);
 
         float cpvdist = 99.;
-        const float cellSizeX = 2 * kCpvMaxX / kCpvX;
-        const float cellSizeZ = 2 * kCpvMaxZ / kCpvZ;
         // look 9 CPV regions around PHOS cluster
 
         if (mod >= 2 && cpvExist) { // CPV exist in mods 2,3,4
           int phosIndex = cpvMatchIndex(mod, posX, posZ);
-          std::vector<int> regions;
-          regions.push_back(phosIndex);
-          if (posX > -kCpvMaxX + cellSizeX) {
-            if (posZ > -kCpvMaxZ + cellSizeZ) { // bottom left
-              regions.push_back(phosIndex - kCpvZ - 1);
-            }
-            regions.push_back(phosIndex - kCpvZ);
-            if (posZ < kCpvMaxZ - cellSizeZ) { // top left
-              regions.push_back(phosIndex - kCpvZ + 1);
-            }
-          }
-          if (posZ > -kCpvMaxZ + cellSizeZ) { // bottom
-            regions.push_back(phosIndex - 1);
-          }
-          if (posZ < kCpvMaxZ - cellSizeZ) { // top
-            regions.push_back(phosIndex + 1);
-          }
-          if (posX < kCpvMaxX - cellSizeX) {
-            if (posZ > -kCpvMaxZ + cellSizeZ) { // bottom right
-              regions.push_back(phosIndex + kCpvZ - 1);
-            }
-            regions.push_back(phosIndex + kCpvZ);
-            if (posZ < kCpvMaxZ - cellSizeZ) { // top right
-              regions.push_back(phosIndex + kCpvZ + 1);
-            }
-          }
+          auto const& regions = cpvNeighbours[phosIndex];
           float sigmaX = 1. / std::min(5.2, 1.111 + 0.56 * std::exp(-0.031 * e * e) + 4.8 / std::pow(e + 0.61, 3)); // inverse sigma X
           float sigmaZ = 1. / std::min(3.3, 1.12 + 0.35 * std::exp(-0.032 * e * e) + 0.75 / std::pow(e + 0.24, 3)); // inverse sigma Z
 
@@ -861,9 +831,10 @@ struct CaloClusterProducer {
                                   outputPHOSClusters, outputCluElements, outputPHOSClusterTrigRecs, dummyMC);
 
     // Find  CPV clusters corresponding to PHOS trigger records
-    std::vector<std::pair<float, float>> cpvMatchPoints[kCpvCells];
-    // Number of entries in each cell per TrigRecord
-    std::vector<TrackTrigRec> cpvNMatchPoints;
+    for (auto& points : cpvMatchPoints) {
+      points.clear();
+    }
+    cpvNMatchPoints.clear();
     cpvNMatchPoints.reserve(outputPHOSClusterTrigRecs.size());
 
     int64_t curBC = -1;
@@ -901,9 +872,10 @@ struct CaloClusterProducer {
       }
     }
     // same for tracks
-    std::vector<TrackMatch> trackMatchPoints[kCpvCells]; // tracks hit in grid/cell in PHOS
-    // Number of entries in each cell per TrigRecord
-    std::vector<TrackTrigRec> trackNMatchPoints;
+    for (auto& points : trackMatchPoints) {
+      points.clear();
+    }
+    trackNMatchPoints.clear();
     trackNMatchPoints.reserve(outputPHOSClusterTrigRecs.size());
 
     curBC = 0;
@@ -913,13 +885,11 @@ struct CaloClusterProducer {
         break;
       }
     }
-    bool keepBC = false;
+    phosTRBCs.clear();
     for (const auto& cluTR : outputPHOSClusterTrigRecs) {
-      if (cluTR.getBCData().toLong() == curBC) {
-        keepBC = true;
-        break;
-      }
+      phosTRBCs.insert(cluTR.getBCData().toLong());
     }
+    bool keepBC = phosTRBCs.count(curBC) > 0;
     if (keepBC) {
       trackNMatchPoints.emplace_back();
       trackNMatchPoints.back().mTR = curBC;
@@ -940,13 +910,7 @@ struct CaloClusterProducer {
           }
           curBC = track.collision().bc_as<aod::BCsWithTimestamps>().globalBC();
         }
-        keepBC = false;
-        for (const auto& cluTR : outputPHOSClusterTrigRecs) {
-          if (cluTR.getBCData().toLong() == curBC) {
-            keepBC = true;
-            break;
-          }
-        }
+        keepBC = phosTRBCs.count(curBC) > 0;
         if (!keepBC) {
           continue;
         }
@@ -976,6 +940,8 @@ struct CaloClusterProducer {
     }
 
     // Fill output tables
+    indexTrigRecs(cpvNMatchPoints, cpvTRIndex);
+    indexTrigRecs(trackNMatchPoints, trackTRIndex);
     for (const auto& cluTR : outputPHOSClusterTrigRecs) {
       int firstClusterInEvent = cluTR.getFirstEntry();
       int lastClusterInEvent = firstClusterInEvent + cluTR.getNumberOfObjects();
@@ -993,23 +959,11 @@ struct CaloClusterProducer {
 
       bool cpvExist = false;
       // find cpvTR for this BC
-      auto cpvPoints = cpvNMatchPoints.begin();
-      while (cpvPoints != cpvNMatchPoints.end()) {
-        if (cpvPoints->mTR == cluTR.getBCData().toLong()) {
-          cpvExist = true;
-          break;
-        }
-        cpvPoints++;
-      }
+      auto cpvPoints = findTrigRec(cpvNMatchPoints, cpvTRIndex, cluTR.getBCData().toLong());
+      cpvExist = cpvPoints != cpvNMatchPoints.end();
 
       // find cpvTR for this BC
-      auto trackPoints = trackNMatchPoints.begin();
-      while (trackPoints != trackNMatchPoints.end()) {
-        if (trackPoints->mTR == cluTR.getBCData().toLong()) {
-          break;
-        }
-        trackPoints++;
-      }
+      auto trackPoints = findTrigRec(trackNMatchPoints, trackTRIndex, cluTR.getBCData().toLong());
 
       for (int i = firstClusterInEvent; i < lastClusterInEvent; i++) {
         o2::phos::Cluster& clu = outputPHOSClusters[i];
@@ -1041,36 +995,9 @@ struct CaloClusterProducer {
         mom.SetMag(e);
 
         // CPV and track match
-        const float cellSizeX = 2 * kCpvMaxX / kCpvX;
-        const float cellSizeZ = 2 * kCpvMaxZ / kCpvZ;
         // look 9 CPV regions around PHOS cluster
         int phosIndex = cpvMatchIndex(mod, posX, posZ);
-        std::vector<int> regions;
-        regions.push_back(phosIndex);
-        if (posX > -kCpvMaxX + cellSizeX) {
-          if (posZ > -kCpvMaxZ + cellSizeZ) { // bottom left
-            regions.push_back(phosIndex - kCpvZ - 1);
-          }
-          regions.push_back(phosIndex - kCpvZ);
-          if (posZ < kCpvMaxZ - cellSizeZ) { // top left
-            regions.push_back(phosIndex - kCpvZ + 1);
-          }
-        }
-        if (posZ > -kCpvMaxZ + cellSizeZ) { // bottom
-          regions.push_back(phosIndex - 1);
-        }
-        if (posZ < kCpvMaxZ - cellSizeZ) { // top
-          regions.push_back(phosIndex + 1);
-        }
-        if (posX < kCpvMaxX - cellSizeX) {
-          if (posZ > -kCpvMaxZ + cellSizeZ) { // bottom right
-            regions.push_back(phosIndex + kCpvZ - 1);
-          }
-          regions.push_back(phosIndex + kCpvZ);
-          if (posZ < kCpvMaxZ - cellSizeZ) { // top right
-            regions.push_back(phosIndex + kCpvZ + 1);
-          }
-        }
+        auto const& regions = cpvNeighbours[phosIndex];
         float sigmaX = 1. / std::min(5.2, 1.111 + 0.56 * std::exp(-0.031 * e * e) + 4.8 / std::pow(e + 0.61, 3)); // inverse sigma X
         float sigmaZ = 1. / std::min(3.3, 1.12 + 0.35 * std::exp(-0.032 * e * e) + 0.75 / std::pow(e + 0.24, 3)); // inverse sigma Z
         float cpvdist = 99., trackdist = 99.;
@@ -1292,9 +1219,10 @@ struct CaloClusterProducer {
                                   outputPHOSClusters, outputCluElements, outputPHOSClusterTrigRecs, outputTruthCont);
 
     // Find  CPV clusters corresponding to PHOS trigger records
-    std::vector<std::pair<float, float>> cpvMatchPoints[kCpvCells];
-    // Number of entries in each cell per TrigRecord
-    std::vector<TrackTrigRec> cpvNMatchPoints;
+    for (auto& points : cpvMatchPoints) {
+      points.clear();
+    }
+    cpvNMatchPoints.clear();
     cpvNMatchPoints.reserve(outputPHOSClusterTrigRecs.size());
 
     int64_t curBC = -1;
@@ -1332,9 +1260,10 @@ struct CaloClusterProducer {
       }
     }
     // same for tracks
-    std::vector<TrackMatch> trackMatchPoints[kCpvCells]; // tracks hit in grid/cell in PHOS
-    // Number of entries in each cell per TrigRecord
-    std::vector<TrackTrigRec> trackNMatchPoints;
+    for (auto& points : trackMatchPoints) {
+      points.clear();
+    }
+    trackNMatchPoints.clear();
     trackNMatchPoints.reserve(outputPHOSClusterTrigRecs.size());
 
     curBC = -1;
@@ -1344,13 +1273,11 @@ struct CaloClusterProducer {
         break;
       }
     }
-    bool keepBC = false;
+    phosTRBCs.clear();
     for (const auto& cluTR : outputPHOSClusterTrigRecs) {
-      if (cluTR.getBCData().toLong() == curBC) {
-        keepBC = true;
-        break;
-      }
+      phosTRBCs.insert(cluTR.getBCData().toLong());
     }
+    bool keepBC = phosTRBCs.count(curBC) > 0;
     if (keepBC) {
       trackNMatchPoints.emplace_back();
       trackNMatchPoints.back().mTR = curBC;
@@ -1371,13 +1298,7 @@ struct CaloClusterProducer {
           }
           curBC = track.collision().bc_as<aod::BCsWithTimestamps>().globalBC();
         }
-        keepBC = false;
-        for (const auto& cluTR : outputPHOSClusterTrigRecs) {
-          if (cluTR.getBCData().toLong() == curBC) {
-            keepBC = true;
-            break;
-          }
-        }
+        keepBC = phosTRBCs.count(curBC) > 0;
         if (!keepBC) {
           continue;
         }
@@ -1407,6 +1328,8 @@ struct CaloClusterProducer {
     }
 
     // Fill output tables
+    indexTrigRecs(cpvNMatchPoints, cpvTRIndex);
+    indexTrigRecs(trackNMatchPoints, trackTRIndex);
     for (const auto& cluTR : outputPHOSClusterTrigRecs) {
       int firstClusterInEvent = cluTR.getFirstEntry();
       int lastClusterInEvent = firstClusterInEvent + cluTR.getNumberOfObjects();
@@ -1424,22 +1347,10 @@ struct CaloClusterProducer {
 
       bool cpvExist = false;
       // find cpvTR for this BC
-      auto cpvPoints = cpvNMatchPoints.begin();
-      while (cpvPoints != cpvNMatchPoints.end()) {
-        if (cpvPoints->mTR == cluTR.getBCData().toLong()) {
-          cpvExist = true;
-          break;
-        }
-        cpvPoints++;
-      }
+      auto cpvPoints = findTrigRec(cpvNMatchPoints, cpvTRIndex, cluTR.getBCData().toLong());
+      cpvExist = cpvPoints != cpvNMatchPoints.end();
       // find cpvTR for this BC
-      auto trackPoints = trackNMatchPoints.begin();
-      while (trackPoints != trackNMatchPoints.end()) {
-        if (trackPoints->mTR == cluTR.getBCData().toLong()) {
-          break;
-        }
-        trackPoints++;
-      }
+      auto trackPoints = findTrigRec(trackNMatchPoints, trackTRIndex, cluTR.getBCData().toLong());
 
       for (int i = firstClusterInEvent; i < lastClusterInEvent; i++) {
         o2::phos::Cluster& clu = outputPHOSClusters[i];
@@ -1470,36 +1381,9 @@ struct CaloClusterProducer {
 
         mom.SetMag(e);
         // CPV and track match
-        const float cellSizeX = 2 * kCpvMaxX / kCpvX;
-        const float cellSizeZ = 2 * kCpvMaxZ / kCpvZ;
         // look 9 CPV regions around PHOS cluster
         int phosIndex = cpvMatchIndex(mod, posX, posZ);
-        std::vector<int> regions;
-        regions.push_back(phosIndex);
-        if (posX > -kCpvMaxX + cellSizeX) {
-          if (posZ > -kCpvMaxZ + cellSizeZ) { // bottom left
-            regions.push_back(phosIndex - kCpvZ - 1);
-          }
-          regions.push_back(phosIndex - kCpvZ);
-          if (posZ < kCpvMaxZ - cellSizeZ) { // top left
-            regions.push_back(phosIndex - kCpvZ + 1);
-          }
-        }
-        if (posZ > -kCpvMaxZ + cellSizeZ) { // bottom
-          regions.push_back(phosIndex - 1);
-        }
-        if (posZ < kCpvMaxZ - cellSizeZ) { // top
-          regions.push_back(phosIndex + 1);
-        }
-        if (posX < kCpvMaxX - cellSizeX) {
-          if (posZ > -kCpvMaxZ + cellSizeZ) { // bottom right
-            regions.push_back(phosIndex + kCpvZ - 1);
-          }
-          regions.push_back(phosIndex + kCpvZ);
-          if (posZ < kCpvMaxZ - cellSizeZ) { // top right
-            regions.push_back(phosIndex + kCpvZ + 1);
-          }
-        }
+        auto const& regions = cpvNeighbours[phosIndex];
         float sigmaX = 1. / std::min(5.2, 1.111 + 0.56 * std::exp(-0.031 * e * e) + 4.8 / std::pow(e + 0.61, 3)); // inverse sigma X
         float sigmaZ = 1. / std::min(3.3, 1.12 + 0.35 * std::exp(-0.032 * e * e) + 0.75 / std::pow(e + 0.24, 3)); // inverse sigma Z
         float cpvdist = 99., trackdist = 99.;
@@ -1594,6 +1478,21 @@ struct CaloClusterProducer {
 
   PROCESS_SWITCH(CaloClusterProducer, processFullMC, "Process MC with track matching", false);
 
+  // Position of the first TrigRec of each BC
+  static void indexTrigRecs(std::vector<TrackTrigRec> const& trigRecs, std::unordered_map<int64_t, int>& index)
+  {
+    index.clear();
+    for (int i = trigRecs.size(); i--;) {
+      index[trigRecs[i].mTR] = i;
+    }
+  }
+
+  static std::vector<TrackTrigRec>::iterator findTrigRec(std::vector<TrackTrigRec>& trigRecs, std::unordered_map<int64_t, int> const& index, int64_t bc)
+  {
+    auto found = index.find(bc);
+    return found == index.end() ? trigRecs.end() : trigRecs.begin() + found->second;
+  }
+
   int cpvMatchIndex(int16_t module, float x, float z)
   {
     // calculate cell index in grid over PHOS detector
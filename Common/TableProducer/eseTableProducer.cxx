@@ -125,6 +125,7 @@ struct EseTableProducer {
       qSelection = ccdb->getForTimeStamp<FFitWeights>(cfgEsePath, timestamp);
       if (!qSelection)
         LOGF(fatal, "failed loading qSelection with ese flag");
+      qSelection->freeze();
       LOGF(info, "successfully loaded qSelection");
     }
   }
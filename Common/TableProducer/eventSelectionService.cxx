@@ -20,6 +20,7 @@
 //===============================================================
 
 #include "MetadataHelper.h"
+#include "TableHelper.h"
 
 #include "Common/Core/trackUtilities.h"
 #include "Common/DataModel/TrackSelectionTables.h"
@@ -165,6 +166,11 @@ WorkflowSpec defineDataProcessing(ConfigContext const& cfgc)
   // Parse the metadata for later too
   metadataInfo.initMetadata(cfgc);
 
+  if (areTablesInInput(cfgc, {"BCSEL", "EVSEL"})) {
+    LOGF(info, "Event selection tables read from the input, the event selection is not added");
+    return WorkflowSpec{};
+  }
+
   bool isRun3 = true, hasRunInfo = false;
   if (cfgc.options().hasOption("aod-metadata-Run") == true) {
     hasRunInfo = true;
@@ -38,6 +38,7 @@ struct FwdTrackToCollisionAssociation {
   Configurable<bool> includeUnassigned{"includeUnassigned", false, "consider also tracks which are not assigned to any collision"};
   Configurable<bool> fillTableOfCollIdsPerTrack{"fillTableOfCollIdsPerTrack", false, "fill additional table with vector of collision ids per track"};
   Configurable<int> bcWindowForOneSigma{"bcWindowForOneSigma", 115, "BC window to be multiplied by the number of sigmas to define maximum window to be considered"};
+  Configurable<bool> useTimeIndex{"useTimeIndex", true, "find the time-compatible tracks of blocks not sorted by BC with a time index instead of a full scan (same output)"};
 
   CollisionAssociation<false> collisionAssociator;
 
@@ -65,6 +66,7 @@ struct FwdTrackToCollisionAssociation {
     collisionAssociator.setIncludeUnassigned(includeUnassigned);
     collisionAssociator.setFillTableOfCollIdsPerTrack(fillTableOfCollIdsPerTrack);
     collisionAssociator.setBcWindow(bcWindowForOneSigma);
+    collisionAssociator.setUseTimeIndex(useTimeIndex);
   }
 
   void processFwdAssocWithTime(Collisions const& collisions,
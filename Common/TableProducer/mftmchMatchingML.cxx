@@ -11,7 +11,11 @@
 
 #include <math.h>
 #include <onnxruntime_cxx_api.h>
+#include <algorithm>
+#include <cmath>
 #include <string>
+#include <utility>
+#include <vector>
 #include <regex>
 #include <TLorentzVector.h>
 #include "Common/DataModel/MftmchMatchingML.h"
@@ -76,127 +80,58 @@ struct mftmchMatchingML {
   std::shared_ptr<Ort::Session> onnx_session = nullptr;
   OnnxModel model;
 
-  template <typename F, typename M>
-  std::vector<float> getVariables(F const& fwdtrack, M const& mfttrack)
-  {
-
-    static constexpr Double_t MatchingPlaneZ = -77.5;
-
-    // propagate muontrack to matching position
-    double muonchi2 = fwdtrack.chi2();
-    SMatrix5 muonpars(fwdtrack.x(), fwdtrack.y(), fwdtrack.phi(), fwdtrack.tgl(), fwdtrack.signed1Pt());
-    std::vector<double> muonv1;
-    SMatrix55 muoncovs(muonv1.begin(), muonv1.end());
-    o2::track::TrackParCovFwd muonpars1{fwdtrack.z(), muonpars, muoncovs, muonchi2};
-    muonpars1.propagateToZlinear(MatchingPlaneZ);
-
-    // propagate mfttrack to matching position
-    double mftchi2 = mfttrack.chi2();
-    SMatrix5 mftpars(mfttrack.x(), mfttrack.y(), mfttrack.phi(), mfttrack.tgl(), mfttrack.signed1Pt());
-    std::vector<double> mftv1;
-    SMatrix55 mftcovs(mftv1.begin(), mftv1.end());
-    o2::track::TrackParCovFwd mftpars1{mfttrack.z(), mftpars, mftcovs, mftchi2};
-    mftpars1.propagateToZlinear(MatchingPlaneZ);
-
-    Float_t MFT_X = mftpars1.getX();
-    Float_t MFT_Y = mftpars1.getY();
-    Float_t MFT_Phi = mftpars1.getPhi();
-    Float_t MFT_Tanl = mftpars1.getTanl();
-
-    Float_t MCH_X = muonpars1.getX();
-    Float_t MCH_Y = muonpars1.getY();
-    Float_t MCH_Phi = muonpars1.getPhi();
-    Float_t MCH_Tanl = muonpars1.getTanl();
+  Configurable<int> cfgMaxBatchSize{"max-batch-size", 0, "Maximum number of pairs scored in one ONNX call (0 = all the pairs of the DF)"};
 
-    Float_t Ratio_X = MFT_X / MCH_X;
-    Float_t Ratio_Y = MFT_Y / MCH_Y;
-    Float_t Ratio_Phi = MFT_Phi / MCH_Phi;
-    Float_t Ratio_Tanl = MFT_Tanl / MCH_Tanl;
+  static constexpr double MatchingPlaneZ = -77.5;
 
-    Float_t Delta_X = MFT_X - MCH_X;
-    Float_t Delta_Y = MFT_Y - MCH_Y;
-    Float_t Delta_Phi = MFT_Phi - MCH_Phi;
-    Float_t Delta_Tanl = MFT_Tanl - MCH_Tanl;
-
-    Float_t Delta_XY = sqrt(Delta_X * Delta_X + Delta_Y * Delta_Y);
+  // Track parameters at the matching plane
+  struct TrackAtMatchingPlane {
+    float x = 0.f;
+    float y = 0.f;
+    float phi = 0.f;
+    float tanl = 0.f;
+  };
 
-    std::vector<float> input_tensor_values{
-      MFT_X,
-      MFT_Y,
-      MFT_Phi,
-      MFT_Tanl,
-      MCH_X,
-      MCH_Y,
-      MCH_Phi,
-      MCH_Tanl,
-      Delta_XY,
-      Delta_X,
-      Delta_Y,
-      Delta_Phi,
-      Delta_Tanl,
-      Ratio_X,
-      Ratio_Y,
-      Ratio_Phi,
-      Ratio_Tanl,
-    };
-    return input_tensor_values;
+  // Candidate pairs of the DF, their variables and scores, and the MFT grid, kept to reuse their memory
+  std::vector<TrackAtMatchingPlane> mftAtPlane;
+  std::vector<std::pair<int64_t, int>> mftGrid; // (cell key, MFT row), sorted by key and row
+  std::vector<int> firstPairOfMuon;
+  std::vector<int> mftOfPair;
+  std::vector<int> candidates;
+  std::vector<float> variables;
+  std::vector<float> scores;
+
+  template <typename T>
+  TrackAtMatchingPlane propagateToMatchingPlane(T const& track)
+  {
+    SMatrix5 pars(track.x(), track.y(), track.phi(), track.tgl(), track.signed1Pt());
+    std::vector<double> v1;
+    SMatrix55 covs(v1.begin(), v1.end());
+    o2::track::TrackParCovFwd pars1{track.z(), pars, covs, track.chi2()};
+    pars1.propagateToZlinear(MatchingPlaneZ);
+    return {static_cast<float>(pars1.getX()), static_cast<float>(pars1.getY()), static_cast<float>(pars1.getPhi()), static_cast<float>(pars1.getTanl())};
   }
 
-  template <typename F, typename M>
-  double matchONNX(F const& fwdtrack, M const& mfttrack)
+  // Append the input variables of the model for a pair
+  static void addVariables(TrackAtMatchingPlane const& mft, TrackAtMatchingPlane const& mch, std::vector<float>& vars)
   {
-    std::vector<std::string> input_names;
-    std::vector<std::vector<int64_t>> input_shapes;
-    std::vector<std::string> output_names;
-    std::vector<std::vector<int64_t>> output_shapes;
-
-    Ort::AllocatorWithDefaultOptions tmpAllocator;
-    for (size_t i = 0; i < onnx_session->GetInputCount(); ++i) {
-      input_names.push_back(onnx_session->GetInputNameAllocated(i, tmpAllocator).get());
-    }
-    for (size_t i = 0; i < onnx_session->GetInputCount(); ++i) {
-      input_shapes.emplace_back(onnx_session->GetInputTypeInfo(i).GetTensorTypeAndShapeInfo().GetShape());
-    }
-    for (size_t i = 0; i < onnx_session->GetOutputCount(); ++i) {
-      output_names.push_back(onnx_session->GetOutputNameAllocated(i, tmpAllocator).get());
-    }
-    for (size_t i = 0; i < onnx_session->GetOutputCount(); ++i) {
-      output_shapes.emplace_back(onnx_session->GetOutputTypeInfo(i).GetTensorTypeAndShapeInfo().GetShape());
-    }
-
-    auto input_shape = input_shapes[0];
-    input_shape[0] = 1;
-
-    std::vector<float> input_tensor_values;
-    input_tensor_values = getVariables(fwdtrack, mfttrack);
-
-    if (input_tensor_values[8] < cfgXYWindow) {
-      std::vector<Ort::Value> input_tensors;
-      Ort::MemoryInfo mem_info =
-        Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
-      input_tensors.push_back(Ort::Value::CreateTensor<float>(mem_info, input_tensor_values.data(), input_tensor_values.size(), input_shape.data(), input_shape.size()));
-
-      Ort::RunOptions runOptions;
-      std::vector<const char*> inputNamesChar(input_names.size(), nullptr);
-      std::transform(std::begin(input_names), std::end(input_names), std::begin(inputNamesChar),
-                     [&](const std::string& str) { return str.c_str(); });
-
-      std::vector<const char*> outputNamesChar(output_names.size(), nullptr);
-      std::transform(std::begin(output_names), std::end(output_names), std::begin(outputNamesChar),
-                     [&](const std::string& str) { return str.c_str(); });
-
-      std::vector<Ort::Value> output_tensors = onnx_session->Run(runOptions, inputNamesChar.data(), input_tensors.data(), input_tensors.size(), outputNamesChar.data(), outputNamesChar.size());
-
-      const float* output_value = output_tensors[0].GetTensorData<float>();
-
-      auto score = output_value[0];
+    const float deltaX = mft.x - mch.x;
+    const float deltaY = mft.y - mch.y;
+    vars.insert(vars.end(), {mft.x, mft.y, mft.phi, mft.tanl,
+                             mch.x, mch.y, mch.phi, mch.tanl,
+                             std::sqrt(deltaX * deltaX + deltaY * deltaY), deltaX, deltaY, mft.phi - mch.phi, mft.tanl - mch.tanl,
+                             mft.x / mch.x, mft.y / mch.y, mft.phi / mch.phi, mft.tanl / mch.tanl});
+  }
 
-      return score;
-    } else {
-      auto score = 0;
-      return score;
-    }
-  };
+  // Key of the grid cell of the MFT tracks of a collision, with cells of the size of the XY window
+  static int64_t cellKey(int collisionId, int ix, int iy)
+  {
+    return (static_cast<int64_t>(collisionId) << 32) | (static_cast<int64_t>(ix & 0xffff) << 16) | static_cast<int64_t>(iy & 0xffff);
+  }
+  static int cellIndex(float coordinate, float cellSize)
+  {
+    return static_cast<int>(std::clamp(std::floor(coordinate / cellSize), -30000.f, 30000.f));
+  }
 
   void init(o2::framework::InitContext&)
   {
@@ -221,43 +156,111 @@ struct mftmchMatchingML {
     }
   }
 
+  // The MFT and MCH tracks are propagated to the matching plane once, and the MFT tracks are indexed in
+  // an (x, y) grid per collision. Each standalone muon is paired with the MFT tracks of the collision
+  // window found in the neighbouring cells within the XY window, and all the pairs of the DF are scored
+  // in batched calls of the model. As before, the MFT track kept is the last one, in table order,
+  // above the score threshold.
   void process(aod::Collisions const&, soa::Filtered<aod::FwdTracks> const& fwdtracks, aod::MFTTracks const& mfttracks)
   {
-    for (auto& fwdtrack : fwdtracks) {
-      if (fwdtrack.trackType() == aod::fwdtrack::ForwardTrackTypeEnum::MuonStandaloneTrack) {
-        double bestscore = 0;
-        int bestmfttrackid = -1;
-        for (auto& mfttrack : mfttracks) {
-          if (fwdtrack.has_collision() && mfttrack.has_collision()) {
-            if (0 <= fwdtrack.collisionId() - mfttrack.collisionId() && fwdtrack.collisionId() - mfttrack.collisionId() < cfgColWindow) {
-              double result = matchONNX(fwdtrack, mfttrack);
-              if (result > cfgThrScore) {
-                bestscore = result;
-                bestmfttrackid = mfttrack.globalIndex();
+    const float xyWindow = cfgXYWindow;
+    mftAtPlane.assign(mfttracks.size(), {});
+    mftGrid.clear();
+    if (xyWindow > 0.f) {
+      for (auto const& mfttrack : mfttracks) {
+        if (!mfttrack.has_collision()) {
+          continue;
+        }
+        const auto& atPlane = mftAtPlane[mfttrack.globalIndex()] = propagateToMatchingPlane(mfttrack);
+        if (std::isfinite(atPlane.x) && std::isfinite(atPlane.y)) {
+          mftGrid.emplace_back(cellKey(mfttrack.collisionId(), cellIndex(atPlane.x, xyWindow), cellIndex(atPlane.y, xyWindow)), mfttrack.globalIndex());
+        }
+      }
+      std::sort(mftGrid.begin(), mftGrid.end());
+    }
+
+    firstPairOfMuon.clear();
+    mftOfPair.clear();
+    variables.clear();
+    for (auto const& fwdtrack : fwdtracks) {
+      if (fwdtrack.trackType() != aod::fwdtrack::ForwardTrackTypeEnum::MuonStandaloneTrack) {
+        continue;
+      }
+      firstPairOfMuon.push_back(static_cast<int>(mftOfPair.size()));
+      if (!fwdtrack.has_collision() || mftGrid.empty()) {
+        continue;
+      }
+      const auto muon = propagateToMatchingPlane(fwdtrack);
+      if (!std::isfinite(muon.x) || !std::isfinite(muon.y)) {
+        continue;
+      }
+      const int ix = cellIndex(muon.x, xyWindow);
+      const int iy = cellIndex(muon.y, xyWindow);
+      candidates.clear();
+      for (int deltaCollision = 0; deltaCollision < cfgColWindow; deltaCollision++) {
+        for (int jx = ix - 1; jx <= ix + 1; jx++) {
+          for (int jy = iy - 1; jy <= iy + 1; jy++) {
+            const int64_t key = cellKey(fwdtrack.collisionId() - deltaCollision, jx, jy);
+            auto cell = std::lower_bound(mftGrid.begin(), mftGrid.end(), std::make_pair(key, -1));
+            for (; cell != mftGrid.end() && cell->first == key; ++cell) {
+              const auto& mft = mftAtPlane[cell->second];
+              const float deltaX = mft.x - muon.x;
+              const float deltaY = mft.y - muon.y;
+              if (std::sqrt(deltaX * deltaX + deltaY * deltaY) < xyWindow) {
+                candidates.push_back(cell->second);
               }
             }
           }
         }
-        if (bestmfttrackid != -1) {
-          for (auto& mfttrack : mfttracks) {
-            if (mfttrack.globalIndex() == bestmfttrackid) {
-              double mftchi2 = mfttrack.chi2();
-              SMatrix5 mftpars(mfttrack.x(), mfttrack.y(), mfttrack.phi(), mfttrack.tgl(), mfttrack.signed1Pt());
-              std::vector<double> mftv1;
-              SMatrix55 mftcovs(mftv1.begin(), mftv1.end());
-              o2::track::TrackParCovFwd mftpars1{mfttrack.z(), mftpars, mftcovs, mftchi2};
-              mftpars1.propagateToZlinear(mfttrack.collision().posZ());
+      }
+      std::sort(candidates.begin(), candidates.end());
+      for (const int mftRow : candidates) {
+        mftOfPair.push_back(mftRow);
+        addVariables(mftAtPlane[mftRow], muon, variables);
+      }
+    }
+    firstPairOfMuon.push_back(static_cast<int>(mftOfPair.size()));
 
-              float dcaX = (mftpars1.getX() - mfttrack.collision().posX());
-              float dcaY = (mftpars1.getY() - mfttrack.collision().posY());
-              double px = fwdtrack.p() * sin(M_PI / 2 - atan(mfttrack.tgl())) * cos(mfttrack.phi());
-              double py = fwdtrack.p() * sin(M_PI / 2 - atan(mfttrack.tgl())) * sin(mfttrack.phi());
-              double pz = fwdtrack.p() * cos(M_PI / 2 - atan(mfttrack.tgl()));
-              fwdtrackml(fwdtrack.collisionId(), 0, mfttrack.x(), mfttrack.y(), mfttrack.z(), mfttrack.phi(), mfttrack.tgl(), fwdtrack.sign() / std::sqrt(std::pow(px, 2) + std::pow(py, 2)), fwdtrack.nClusters(), fwdtrack.pDca(), fwdtrack.rAtAbsorberEnd(), 0, 0, 0, bestscore, mfttrack.globalIndex(), fwdtrack.globalIndex(), fwdtrack.mchBitMap(), fwdtrack.midBitMap(), fwdtrack.midBoards(), mfttrack.trackTime(), mfttrack.trackTimeRes(), mfttrack.eta(), std::sqrt(std::pow(px, 2) + std::pow(py, 2)), std::sqrt(std::pow(px, 2) + std::pow(py, 2) + std::pow(pz, 2)), dcaX, dcaY);
-            }
-          }
+    std::size_t nScoresPerPair = 0;
+    if (!mftOfPair.empty()) {
+      if (!onnx_session) {
+        LOG(fatal) << "No matching model loaded";
+      }
+      nScoresPerPair = model.evalModelBatch(variables, scores, static_cast<std::size_t>(std::max(0, cfgMaxBatchSize.value)), 0);
+    }
+
+    int iMuon = 0;
+    for (auto const& fwdtrack : fwdtracks) {
+      if (fwdtrack.trackType() != aod::fwdtrack::ForwardTrackTypeEnum::MuonStandaloneTrack) {
+        continue;
+      }
+      double bestscore = 0;
+      int bestmfttrackid = -1;
+      for (int iPair = firstPairOfMuon[iMuon]; iPair < firstPairOfMuon[iMuon + 1]; iPair++) {
+        const double result = scores[iPair * nScoresPerPair];
+        if (result > cfgThrScore) {
+          bestscore = result;
+          bestmfttrackid = mftOfPair[iPair];
         }
       }
+      iMuon++;
+      if (bestmfttrackid == -1) {
+        continue;
+      }
+      auto const& mfttrack = mfttracks.rawIteratorAt(bestmfttrackid);
+      double mftchi2 = mfttrack.chi2();
+      SMatrix5 mftpars(mfttrack.x(), mfttrack.y(), mfttrack.phi(), mfttrack.tgl(), mfttrack.signed1Pt());
+      std::vector<double> mftv1;
+      SMatrix55 mftcovs(mftv1.begin(), mftv1.end());
+      o2::track::TrackParCovFwd mftpars1{mfttrack.z(), mftpars, mftcovs, mftchi2};
+      mftpars1.propagateToZlinear(mfttrack.collision().posZ());
+
+      float dcaX = (mftpars1.getX() - mfttrack.collision().posX());
+      float dcaY = (mftpars1.getY() - mfttrack.collision().posY());
+      double px = fwdtrack.p() * sin(M_PI / 2 - atan(mfttrack.tgl())) * cos(mfttrack.phi());
+      double py = fwdtrack.p() * sin(M_PI / 2 - atan(mfttrack.tgl())) * sin(mfttrack.phi());
+      double pz = fwdtrack.p() * cos(M_PI / 2 - atan(mfttrack.tgl()));
+      fwdtrackml(fwdtrack.collisionId(), 0, mfttrack.x(), mfttrack.y(), mfttrack.z(), mfttrack.phi(), mfttrack.tgl(), fwdtrack.sign() / std::sqrt(std::pow(px, 2) + std::pow(py, 2)), fwdtrack.nClusters(), fwdtrack.pDca(), fwdtrack.rAtAbsorberEnd(), 0, 0, 0, bestscore, mfttrack.globalIndex(), fwdtrack.globalIndex(), fwdtrack.mchBitMap(), fwdtrack.midBitMap(), fwdtrack.midBoards(), mfttrack.trackTime(), mfttrack.trackTimeRes(), mfttrack.eta(), std::sqrt(std::pow(px, 2) + std::pow(py, 2)), std::sqrt(std::pow(px, 2) + std::pow(py, 2) + std::pow(pz, 2)), dcaX, dcaY);
     }
   }
 };
@@ -40,6 +40,7 @@
 #include "Common/Tools/StandardCCDBLoader.h"
 #include "Framework/O2DatabasePDGPlugin.h"
 #include "MetadataHelper.h"
+#include "TableHelper.h"
 #include "Common/Tools/MultModule.h"
 
 using namespace o2;
@@ -200,6 +201,12 @@ struct MultCentTable {
 WorkflowSpec defineDataProcessing(ConfigContext const& cfgc)
 {
   metadataInfo.initMetadata(cfgc);
+  if (areTablesInInput(cfgc, {"FV0MULT", "FT0MULT", "FDDMULT", "ZDCMULT", "TRKLTMULT", "TPCMULT", "PVMULT", "MULTSELECTIONS", "MULTGLOBAL", "MFTMULT",
+                              "CENTFV0A", "CENTFT0M", "CENTFT0A", "CENTFT0C", "CENTFT0Cvar1", "CENTFDDM", "CENTNTPV", "CENTNGLOBAL", "CENTMFT",
+                              "CENTRUN2V0M", "CENTRUN2V0A", "CENTRUN2SPDTRK", "CENTRUN2SPDCLS", "CENTRUN2CL0", "CENTRUN2CL1"})) {
+    LOG(info) << "Multiplicity and centrality tables read from the input, the mult-cent table task is not added";
+    return WorkflowSpec{};
+  }
   WorkflowSpec workflow{adaptAnalysisTask<MultCentTable>(cfgc)};
   return workflow;
 }
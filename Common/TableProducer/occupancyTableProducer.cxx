@@ -132,6 +132,8 @@ struct OccupancyTableProducer {
 
   std::vector<int> tfList;
   std::vector<std::vector<int64_t>> bcTFMap;
+  std::vector<std::vector<int>> nCollStartUnfm80; // Number of collisions starting in each bin, to keep empty drift windows exactly at zero
+  std::vector<double> driftWindowBuffer;
 
   std::vector<std::vector<float>> occPrimUnfm80;
   std::vector<std::vector<float>> occFV0AUnfm80;
@@ -183,6 +185,7 @@ struct OccupancyTableProducer {
     // outer vector resized at runtime
     tfList.resize(occVecArraySize);
     bcTFMap.resize(occVecArraySize);
+    nCollStartUnfm80.resize(occVecArraySize);
 
     if (buildFullOccTableProducer || buildOnlyOccsPrim || buildOnlyOccsT0V0Prim || buildOnlyOccsFDDT0V0Prim || buildOnlyOccsNtrackDet || buildOnlyOccsMultExtra) {
       occPrimUnfm80.resize(occVecArraySize);
@@ -224,6 +227,7 @@ struct OccupancyTableProducer {
 
     for (int i = 0; i < occVecArraySize; i++) {
       bcTFMap[i].resize(nBCinTF / bcGrouping);
+      nCollStartUnfm80[i].resize(nBCinTF / bcGrouping);
       if (buildFullOccTableProducer || buildOnlyOccsPrim || buildOnlyOccsT0V0Prim || buildOnlyOccsFDDT0V0Prim || buildOnlyOccsNtrackDet || buildOnlyOccsMultExtra) {
         occPrimUnfm80[i].resize(nBCinTF / bcGrouping);
       }
@@ -307,41 +311,74 @@ struct OccupancyTableProducer {
     std::vector<std::array<int, 2>>& medianPosVec,
     const Vecs&... vectors)
   {
-    const int n = sizeof...(Vecs);                             // Number of vectors
+    constexpr int n = sizeof...(Vecs);                         // Number of vectors
     const int size = std::get<0>(std::tie(vectors...)).size(); // Size of the first vector
 
+    std::array<std::pair<double, int>, n> data; // first element is entry, second is index
     for (int i = 0; i < size; i++) {
-      std::vector<std::array<double, 2>> data; // first element is entry, second is index
       int iEntry = 0;
 
       // Lambda to iterate over all vectors
       auto collect = [&](const auto& vec) {
-        data.push_back({vec[i], static_cast<double>(iEntry)});
+        data[iEntry] = {vec[i], iEntry};
         iEntry++;
       };
       (collect(vectors), ...); // Unpack variadic arguments and apply lambda
 
-      // Sort the data
-      std::sort(data.begin(), data.end(), [](const std::array<double, 2>& a, const std::array<double, 2>& b) {
-        return a[0] < b[0];
-      });
+      // Sort the data, a handful of entries: insertion sort without allocations
+      for (int j = 1; j < n; j++) {
+        for (int k = j; k > 0 && data[k].first < data[k - 1].first; k--) {
+          std::swap(data[k], data[k - 1]);
+        }
+      }
 
       double median;
       int two = 2;
       // Find the median
       if (n % two == 0) {
-        median = (data[(n - 1) / 2][0] + data[(n - 1) / 2 + 1][0]) / 2;
-        medianPosVec[i][0] = static_cast<int>(data[(n - 1) / 2][1] + 0.001);
-        medianPosVec[i][1] = static_cast<int>(data[(n - 1) / 2 + 1][1] + 0.001);
+        median = (data[(n - 1) / 2].first + data[(n - 1) / 2 + 1].first) / 2;
+        medianPosVec[i][0] = data[(n - 1) / 2].second;
+        medianPosVec[i][1] = data[(n - 1) / 2 + 1].second;
       } else {
-        median = data[n / 2][0];
-        medianPosVec[i][0] = static_cast<int>(data[n / 2][1] + 0.001);
+        median = data[n / 2].first;
+        medianPosVec[i][0] = data[n / 2].second;
         medianPosVec[i][1] = -10; // For odd entries, only one value can be the median
       }
       medianVector[i] = median;
     }
   }
 
+  // Turn the per-bin sums of the collisions starting in each bin into the sums over the drift window
+  // following each collision, with a running sum instead of depositing every collision in all the bins of its window
+  template <typename... Vecs>
+  void integrateOverDriftWindow(const std::vector<int>& nCollStart, Vecs&... vectors)
+  {
+    const int nBins = nCollStart.size();
+    const int nBinsInDrift = std::min(nBCinDrift / bcGrouping, nBins);
+
+    auto integrate = [&](std::vector<float>& vec) {
+      if (static_cast<int>(vec.size()) != nBins) {
+        return;
+      }
+      driftWindowBuffer.assign(vec.begin(), vec.end());
+      double sum = 0.;
+      int nColl = 0;
+      for (int k = 0; k < nBinsInDrift; k++) { // window of the first bin, wrapping around the TF like the bin deposits
+        sum += driftWindowBuffer[(nBins - k) % nBins];
+        nColl += nCollStart[(nBins - k) % nBins];
+      }
+      for (int j = 0; j < nBins; j++) {
+        if (j > 0) {
+          const int binOut = (j - nBinsInDrift + nBins) % nBins;
+          sum += driftWindowBuffer[j] - driftWindowBuffer[binOut];
+          nColl += nCollStart[j] - nCollStart[binOut];
+        }
+        vec[j] = nColl > 0 ? sum : 0.;
+      }
+    };
+    (integrate(vectors), ...);
+  }
+
   void getRunInfo(const int& run, int& nBCsPerTF, int64_t& bcSOR)
   {
     auto runDuration = ccdb->getRunDuration(run, true);
@@ -485,6 +522,7 @@ struct OccupancyTableProducer {
       for (int i = 0; i < occVecArraySize; i++) {
         tfList[i] = -1;
         bcTFMap[i].clear(); // list of BCs used in one time frame;
+        std::fill(nCollStartUnfm80[i].begin(), nCollStartUnfm80[i].end(), 0);
         if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccPrim || processMode == kProcessOnlyOccT0V0Prim || processMode == kProcessOnlyOccFDDT0V0Prim || processMode == kProcessOnlyOccNtrackDet || processMode == kProcessOnlyOccMultExtra) {
           std::fill(occPrimUnfm80[i].begin(), occPrimUnfm80[i].end(), 0.);
         }
@@ -722,47 +760,45 @@ struct OccupancyTableProducer {
           fNTrackITSTPCA = nTrackITSTPCA;
           fNTrackITSTPCC = nTrackITSTPCC;
         }
-        // Processing for bcGrouping of 80 BCs
-        for (int deltaBin = 0; deltaBin < nBCinDrift / bcGrouping; deltaBin++) {
-
-          if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccPrim || processMode == kProcessOnlyOccT0V0Prim || processMode == kProcessOnlyOccFDDT0V0Prim || processMode == kProcessOnlyOccNtrackDet || processMode == kProcessOnlyOccMultExtra) {
-            (*tfOccPrimUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += fNumContrib * 1;
-          }
-          if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccT0V0Prim || processMode == kProcessOnlyOccFDDT0V0Prim) {
-            (*tfOccFV0AUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += fMultFV0A * 1;
-            (*tfOccFV0CUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += fMultFV0C * 1;
-            (*tfOccFT0AUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += fMultFT0A * 1;
-            (*tfOccFT0CUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += fMultFT0C * 1;
-          }
-          if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccFDDT0V0Prim) {
-            (*tfOccFDDAUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += fMultFDDA * 1;
-            (*tfOccFDDCUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += fMultFDDC * 1;
-          }
-          if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccNtrackDet) {
-            (*tfOccNTrackITSUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += fNTrackITS * 1;
-            (*tfOccNTrackTPCUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += fNTrackTPC * 1;
-            (*tfOccNTrackTRDUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += fNTrackTRD * 1;
-            (*tfOccNTrackTOFUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += fNTrackTOF * 1;
-            (*tfOccNTrackSizeUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += fNTrackSize * 1;
-            (*tfOccNTrackTPCAUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += fNTrackTPCA * 1;
-            (*tfOccNTrackTPCCUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += fNTrackTPCC * 1;
-            (*tfOccNTrackITSTPCAUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += fNTrackITSTPCA * 1;
-            (*tfOccNTrackITSTPCCUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += fNTrackITSTPCC * 1;
-          }
-          if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccNtrackDet || processMode == kProcessOnlyOccMultExtra) {
-            (*tfOccNTrackITSTPCUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += fNTrackITSTPC * 1;
-          }
+        // Processing for bcGrouping of 80 BCs: the collision is deposited in its own bin and integrated over the drift window after the collision loop
+        nCollStartUnfm80[tfIDX][bin80Zero]++;
+        if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccPrim || processMode == kProcessOnlyOccT0V0Prim || processMode == kProcessOnlyOccFDDT0V0Prim || processMode == kProcessOnlyOccNtrackDet || processMode == kProcessOnlyOccMultExtra) {
+          (*tfOccPrimUnfm80)[bin80Zero] += fNumContrib * 1;
+        }
+        if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccT0V0Prim || processMode == kProcessOnlyOccFDDT0V0Prim) {
+          (*tfOccFV0AUnfm80)[bin80Zero] += fMultFV0A * 1;
+          (*tfOccFV0CUnfm80)[bin80Zero] += fMultFV0C * 1;
+          (*tfOccFT0AUnfm80)[bin80Zero] += fMultFT0A * 1;
+          (*tfOccFT0CUnfm80)[bin80Zero] += fMultFT0C * 1;
+        }
+        if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccFDDT0V0Prim) {
+          (*tfOccFDDAUnfm80)[bin80Zero] += fMultFDDA * 1;
+          (*tfOccFDDCUnfm80)[bin80Zero] += fMultFDDC * 1;
+        }
+        if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccNtrackDet) {
+          (*tfOccNTrackITSUnfm80)[bin80Zero] += fNTrackITS * 1;
+          (*tfOccNTrackTPCUnfm80)[bin80Zero] += fNTrackTPC * 1;
+          (*tfOccNTrackTRDUnfm80)[bin80Zero] += fNTrackTRD * 1;
+          (*tfOccNTrackTOFUnfm80)[bin80Zero] += fNTrackTOF * 1;
+          (*tfOccNTrackSizeUnfm80)[bin80Zero] += fNTrackSize * 1;
+          (*tfOccNTrackTPCAUnfm80)[bin80Zero] += fNTrackTPCA * 1;
+          (*tfOccNTrackTPCCUnfm80)[bin80Zero] += fNTrackTPCC * 1;
+          (*tfOccNTrackITSTPCAUnfm80)[bin80Zero] += fNTrackITSTPCA * 1;
+          (*tfOccNTrackITSTPCCUnfm80)[bin80Zero] += fNTrackITSTPCC * 1;
+        }
+        if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccNtrackDet || processMode == kProcessOnlyOccMultExtra) {
+          (*tfOccNTrackITSTPCUnfm80)[bin80Zero] += fNTrackITSTPC * 1;
+        }
 
-          if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccMultExtra) {
-            (*tfOccMultNTracksHasITSUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += collision.multNTracksHasITS() * 1;
-            (*tfOccMultNTracksHasTPCUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += collision.multNTracksHasTPC() * 1;
-            (*tfOccMultNTracksHasTOFUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += collision.multNTracksHasTOF() * 1;
-            (*tfOccMultNTracksHasTRDUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += collision.multNTracksHasTRD() * 1;
-            (*tfOccMultNTracksITSOnlyUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += collision.multNTracksITSOnly() * 1;
-            (*tfOccMultNTracksTPCOnlyUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += collision.multNTracksTPCOnly() * 1;
-            (*tfOccMultNTracksITSTPCUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += collision.multNTracksITSTPC() * 1;
-            (*tfOccMultAllTracksTPCOnlyUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += collision.multAllTracksTPCOnly() * 1;
-          }
+        if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccMultExtra) {
+          (*tfOccMultNTracksHasITSUnfm80)[bin80Zero] += collision.multNTracksHasITS() * 1;
+          (*tfOccMultNTracksHasTPCUnfm80)[bin80Zero] += collision.multNTracksHasTPC() * 1;
+          (*tfOccMultNTracksHasTOFUnfm80)[bin80Zero] += collision.multNTracksHasTOF() * 1;
+          (*tfOccMultNTracksHasTRDUnfm80)[bin80Zero] += collision.multNTracksHasTRD() * 1;
+          (*tfOccMultNTracksITSOnlyUnfm80)[bin80Zero] += collision.multNTracksITSOnly() * 1;
+          (*tfOccMultNTracksTPCOnlyUnfm80)[bin80Zero] += collision.multNTracksTPCOnly() * 1;
+          (*tfOccMultNTracksITSTPCUnfm80)[bin80Zero] += collision.multNTracksITSTPC() * 1;
+          (*tfOccMultAllTracksTPCOnlyUnfm80)[bin80Zero] += collision.multAllTracksTPCOnly() * 1;
         }
       }
       // collision Loop is over
@@ -791,6 +827,15 @@ struct OccupancyTableProducer {
         LOG(debug) << "DEBUG :: ERROR :: filled TF list and collision size mismatch ::  filledTF_Size = " << totalBCcountSize << " != " << collisions.size() << " = collisions.size()";
       }
 
+      for (uint i = 0; i < tfCounted; i++) {
+        integrateOverDriftWindow(nCollStartUnfm80[i], occPrimUnfm80[i],
+                                 occFV0AUnfm80[i], occFV0CUnfm80[i], occFT0AUnfm80[i], occFT0CUnfm80[i], occFDDAUnfm80[i], occFDDCUnfm80[i],
+                                 occNTrackITSUnfm80[i], occNTrackTPCUnfm80[i], occNTrackTRDUnfm80[i], occNTrackTOFUnfm80[i], occNTrackSizeUnfm80[i],
+                                 occNTrackTPCAUnfm80[i], occNTrackTPCCUnfm80[i], occNTrackITSTPCUnfm80[i], occNTrackITSTPCAUnfm80[i], occNTrackITSTPCCUnfm80[i],
+                                 occMultNTracksHasITSUnfm80[i], occMultNTracksHasTPCUnfm80[i], occMultNTracksHasTOFUnfm80[i], occMultNTracksHasTRDUnfm80[i],
+                                 occMultNTracksITSOnlyUnfm80[i], occMultNTracksTPCOnlyUnfm80[i], occMultNTracksITSTPCUnfm80[i], occMultAllTracksTPCOnlyUnfm80[i]);
+      }
+
       // Fill the Producers
       for (uint i = 0; i < tfCounted; i++) {
 
@@ -19,7 +19,10 @@
 ///
 
 // C++/ROOT includes.
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <cmath>
 #include <string>
 #include <vector>
 #include <TComplex.h>
@@ -63,6 +66,7 @@ struct qVectorsTable {
     kTPCneg,
     kTPCall
   };
+  static_assert(kTPCall + 1 == aod::qvec::NDetectors, "detectors of the event-plane summary");
 
   // Configurables.
   struct : ConfigurableGroup {
@@ -113,6 +117,8 @@ struct qVectorsTable {
   Produces<aod::QvectorTPCposVecs> qVectorTPCposVec;
   Produces<aod::QvectorTPCnegVecs> qVectorTPCnegVec;
   Produces<aod::QvectorTPCallVecs> qVectorTPCallVec;
+  Produces<aod::EventPlaneSummaries> eventPlaneSummary;
+  bool produceEventPlaneSummary = false; // only when a task subscribes to it
 
   std::vector<float> FT0RelGainConst{};
   std::vector<float> FV0RelGainConst{};
@@ -133,7 +139,53 @@ struct qVectorsTable {
   int runNumber{-1};
   float cent;
 
-  std::vector<TH3F*> objQvec{};
+  // flat copy of a Q-vector calibration histogram (centrality, correction, detector),
+  // to avoid the TH3 look-ups for each collision
+  struct QvecCalibTable {
+    int nBinsX = 0;
+    int nBinsY = 0;
+    int nBinsZ = 0;
+    std::vector<float> content{};
+
+    void set(TH3F const* hist)
+    {
+      nBinsX = hist->GetNbinsX();
+      nBinsY = hist->GetNbinsY();
+      nBinsZ = hist->GetNbinsZ();
+      content.resize((nBinsX + 2) * (nBinsY + 2) * (nBinsZ + 2));
+      for (int iz = 0; iz < nBinsZ + 2; iz++) {
+        for (int iy = 0; iy < nBinsY + 2; iy++) {
+          for (int ix = 0; ix < nBinsX + 2; ix++) {
+            content[ix + (nBinsX + 2) * (iy + (nBinsY + 2) * iz)] = hist->GetBinContent(ix, iy, iz);
+          }
+        }
+      }
+    }
+    // same as TH3::GetBinContent(binX, binY, binZ)
+    float get(int binX, int binY, int binZ) const
+    {
+      binX = std::clamp(binX, 0, nBinsX + 1);
+      binY = std::clamp(binY, 0, nBinsY + 1);
+      binZ = std::clamp(binZ, 0, nBinsZ + 1);
+      return content[binX + (nBinsX + 2) * (binY + (nBinsY + 2) * binZ)];
+    }
+    // all the corrections of a detector in a centrality bin: x0, y0 (recentering), lp, lm (twist), ap, am (rescale)
+    std::array<float, 6> getCorrections(int binCent, int binDetector) const
+    {
+      std::array<float, 6> corrections{};
+      for (int iCorr = 0; iCorr < 6; iCorr++) {
+        corrections[iCorr] = get(binCent, iCorr + 1, binDetector);
+      }
+      return corrections;
+    }
+  };
+  std::vector<QvecCalibTable> qvecCalib{};
+
+  // cos(n*phi) and sin(n*phi) of each FIT channel for each harmonic, updated at each run with the alignment
+  std::vector<std::vector<double>> cosPhiFT0{};
+  std::vector<std::vector<double>> sinPhiFT0{};
+  std::vector<std::vector<double>> cosPhiFV0{};
+  std::vector<std::vector<double>> sinPhiFV0{};
 
   // Deprecated, will be removed in future after transition time //
   Configurable<bool> cfgUseBPos{"cfgUseBPos", false, "Initial value for using BPos. By default obtained from DataModel."};
@@ -167,6 +219,9 @@ struct qVectorsTable {
     auto& workflows = initContext.services().get<RunningWorkflowInfo const>();
     for (DeviceSpec const& device : workflows.devices) {
       for (auto const& input : device.inputs) {
+        if (input.matcher.binding == "EventPlaneSummaries") {
+          produceEventPlaneSummary = true;
+        }
         if (input.matcher.binding == "Qvectors") {
           for (auto det : useDetector) {
             useDetector[det.first.data()] = true;
@@ -239,7 +294,7 @@ struct qVectorsTable {
       LOGF(fatal, "Could not get the alignment parameters for FV0.");
     }
 
-    objQvec.clear();
+    qvecCalib.assign(cfgnMods->size(), QvecCalibTable{});
     for (std::size_t i = 0; i < cfgnMods->size(); i++) {
       int ind = cfgnMods->at(i);
       fullPath = cfgQvecCalibPath;
@@ -251,7 +306,28 @@ struct qVectorsTable {
         fullPath += "/v2";
         objqvec = getForTsOrRun<TH3F>(fullPath, timestamp, runnumber);
       }
-      objQvec.push_back(objqvec);
+      if (objqvec) {
+        qvecCalib[i].set(objqvec);
+      }
+    }
+
+    cosPhiFT0.assign(cfgnMods->size(), std::vector<double>(208));
+    sinPhiFT0.assign(cfgnMods->size(), std::vector<double>(208));
+    cosPhiFV0.assign(cfgnMods->size(), std::vector<double>(48));
+    sinPhiFV0.assign(cfgnMods->size(), std::vector<double>(48));
+    for (auto iCh{0u}; iCh < 208; iCh++) {
+      const double phi = helperEP.GetPhiFT0(iCh, ft0geom);
+      for (std::size_t i = 0; i < cfgnMods->size(); i++) {
+        cosPhiFT0[i][iCh] = std::cos(phi * cfgnMods->at(i));
+        sinPhiFT0[i][iCh] = std::sin(phi * cfgnMods->at(i));
+      }
+    }
+    for (auto iCh{0u}; iCh < 48; iCh++) {
+      const double phi = helperEP.GetPhiFV0(iCh, fv0geom);
+      for (std::size_t i = 0; i < cfgnMods->size(); i++) {
+        cosPhiFV0[i][iCh] = std::cos(phi * cfgnMods->at(i));
+        sinPhiFV0[i][iCh] = std::sin(phi * cfgnMods->at(i));
+      }
     }
     fullPath = cfgGainEqPath;
     fullPath += "/FT0";
@@ -316,9 +392,17 @@ struct qVectorsTable {
     }
   }
 
-  template <typename Nmode, typename CollType, typename TrackType>
-  void CalQvec(const Nmode nmode, const CollType& coll, const TrackType& track, std::vector<float>& QvecRe, std::vector<float>& QvecIm, std::vector<float>& QvecAmp, std::vector<int>& TrkTPCposLabel, std::vector<int>& TrkTPCnegLabel, std::vector<int>& TrkTPCallLabel)
+  /// Add the contribution of a FIT channel to a Q-vector, with the precomputed cos/sin of the channel
+  void SumQvectors(std::vector<double> const& cosPhi, std::vector<double> const& sinPhi, int chno, float ampl, TComplex& Qvec, float& sum)
+  {
+    Qvec += TComplex(ampl * cosPhi[chno], ampl * sinPhi[chno]);
+    sum += ampl;
+  }
+
+  template <typename CollType, typename TrackType>
+  void CalQvec(const std::size_t iHarm, const CollType& coll, const TrackType& track, std::vector<float>& QvecRe, std::vector<float>& QvecIm, std::vector<float>& QvecAmp, std::vector<int>& TrkTPCposLabel, std::vector<int>& TrkTPCnegLabel, std::vector<int>& TrkTPCallLabel)
   {
+    const int nmode = cfgnMods->at(iHarm);
     float qVectFT0A[2] = {0.};
     float qVectFT0C[2] = {0.};
     float qVectFT0M[2] = {0.};
@@ -345,8 +429,8 @@ struct qVectorsTable {
           histosQA.fill(HIST("FT0Amp"), ampl, FT0AchId);
           histosQA.fill(HIST("FT0AmpCor"), ampl / FT0RelGainConst[FT0AchId], FT0AchId);
 
-          helperEP.SumQvectors(0, FT0AchId, ampl / FT0RelGainConst[FT0AchId], nmode, QvecDet, sumAmplFT0A, ft0geom, fv0geom);
-          helperEP.SumQvectors(0, FT0AchId, ampl / FT0RelGainConst[FT0AchId], nmode, QvecFT0M, sumAmplFT0M, ft0geom, fv0geom);
+          SumQvectors(cosPhiFT0[iHarm], sinPhiFT0[iHarm], FT0AchId, ampl / FT0RelGainConst[FT0AchId], QvecDet, sumAmplFT0A);
+          SumQvectors(cosPhiFT0[iHarm], sinPhiFT0[iHarm], FT0AchId, ampl / FT0RelGainConst[FT0AchId], QvecFT0M, sumAmplFT0M);
         }
         if (sumAmplFT0A > 1e-8) {
           QvecDet /= sumAmplFT0A;
@@ -367,8 +451,8 @@ struct qVectorsTable {
           histosQA.fill(HIST("FT0Amp"), ampl, FT0CchId);
           histosQA.fill(HIST("FT0AmpCor"), ampl / FT0RelGainConst[FT0CchId], FT0CchId);
 
-          helperEP.SumQvectors(0, FT0CchId, ampl / FT0RelGainConst[FT0CchId], nmode, QvecDet, sumAmplFT0C, ft0geom, fv0geom);
-          helperEP.SumQvectors(0, FT0CchId, ampl / FT0RelGainConst[FT0CchId], nmode, QvecFT0M, sumAmplFT0M, ft0geom, fv0geom);
+          SumQvectors(cosPhiFT0[iHarm], sinPhiFT0[iHarm], FT0CchId, ampl / FT0RelGainConst[FT0CchId], QvecDet, sumAmplFT0C);
+          SumQvectors(cosPhiFT0[iHarm], sinPhiFT0[iHarm], FT0CchId, ampl / FT0RelGainConst[FT0CchId], QvecFT0M, sumAmplFT0M);
         }
 
         if (sumAmplFT0C > 1e-8) {
@@ -412,7 +496,7 @@ struct qVectorsTable {
         histosQA.fill(HIST("FV0Amp"), ampl, FV0AchId);
         histosQA.fill(HIST("FV0AmpCor"), ampl / FV0RelGainConst[FV0AchId], FV0AchId);
 
-        helperEP.SumQvectors(1, FV0AchId, ampl / FV0RelGainConst[FV0AchId], nmode, QvecDet, sumAmplFV0A, ft0geom, fv0geom);
+        SumQvectors(cosPhiFV0[iHarm], sinPhiFV0[iHarm], FV0AchId, ampl / FV0RelGainConst[FV0AchId], QvecDet, sumAmplFV0A);
       }
 
       if (sumAmplFV0A > 1e-8) {
@@ -562,24 +646,24 @@ struct qVectorsTable {
       IsCalibrated = false;
     }
     for (std::size_t id = 0; id < cfgnMods->size(); id++) {
-      int ind = cfgnMods->at(id);
-      CalQvec(ind, coll, tracks, qvecRe, qvecIm, qvecAmp, TrkTPCposLabel, TrkTPCnegLabel, TrkTPCallLabel);
+      CalQvec(id, coll, tracks, qvecRe, qvecIm, qvecAmp, TrkTPCposLabel, TrkTPCnegLabel, TrkTPCallLabel);
       if (cent < cfgMaxCentrality) {
+        if (qvecCalib.at(id).content.empty()) {
+          LOGF(fatal, "Q-vector calibration for harmonic %d not available.", cfgnMods->at(id));
+        }
         for (auto i{0u}; i < kTPCall + 1; i++) {
-          helperEP.DoRecenter(qvecRe[(kTPCall + 1) * 4 * id + i * 4 + 1], qvecIm[(kTPCall + 1) * 4 * id + i * 4 + 1],
-                              objQvec.at(id)->GetBinContent(static_cast<int>(cent) + 1, 1, i + 1), objQvec.at(id)->GetBinContent(static_cast<int>(cent) + 1, 2, i + 1));
-
-          helperEP.DoRecenter(qvecRe[(kTPCall + 1) * 4 * id + i * 4 + 2], qvecIm[(kTPCall + 1) * 4 * id + i * 4 + 2],
-                              objQvec.at(id)->GetBinContent(static_cast<int>(cent) + 1, 1, i + 1), objQvec.at(id)->GetBinContent(static_cast<int>(cent) + 1, 2, i + 1));
-          helperEP.DoTwist(qvecRe[(kTPCall + 1) * 4 * id + i * 4 + 2], qvecIm[(kTPCall + 1) * 4 * id + i * 4 + 2],
-                           objQvec.at(id)->GetBinContent(static_cast<int>(cent) + 1, 3, i + 1), objQvec.at(id)->GetBinContent(static_cast<int>(cent) + 1, 4, i + 1));
-
-          helperEP.DoRecenter(qvecRe[(kTPCall + 1) * 4 * id + i * 4 + 3], qvecIm[(kTPCall + 1) * 4 * id + i * 4 + 3],
-                              objQvec.at(id)->GetBinContent(static_cast<int>(cent) + 1, 1, i + 1), objQvec.at(id)->GetBinContent(static_cast<int>(cent) + 1, 2, i + 1));
-          helperEP.DoTwist(qvecRe[(kTPCall + 1) * 4 * id + i * 4 + 3], qvecIm[(kTPCall + 1) * 4 * id + i * 4 + 3],
-                           objQvec.at(id)->GetBinContent(static_cast<int>(cent) + 1, 3, i + 1), objQvec.at(id)->GetBinContent(static_cast<int>(cent) + 1, 4, i + 1));
-          helperEP.DoRescale(qvecRe[(kTPCall + 1) * 4 * id + i * 4 + 3], qvecIm[(kTPCall + 1) * 4 * id + i * 4 + 3],
-                             objQvec.at(id)->GetBinContent(static_cast<int>(cent) + 1, 5, i + 1), objQvec.at(id)->GetBinContent(static_cast<int>(cent) + 1, 6, i + 1));
+          const auto corr = qvecCalib.at(id).getCorrections(static_cast<int>(cent) + 1, i + 1);
+          float* re = &qvecRe[(kTPCall + 1) * 4 * id + i * 4];
+          float* im = &qvecIm[(kTPCall + 1) * 4 * id + i * 4];
+
+          helperEP.DoRecenter(re[1], im[1], corr[0], corr[1]);
+
+          helperEP.DoRecenter(re[2], im[2], corr[0], corr[1]);
+          helperEP.DoTwist(re[2], im[2], corr[2], corr[3]);
+
+          helperEP.DoRecenter(re[3], im[3], corr[0], corr[1]);
+          helperEP.DoTwist(re[3], im[3], corr[2], corr[3]);
+          helperEP.DoRescale(re[3], im[3], corr[4], corr[5]);
         }
       }
       int CorrLevel = cfgCorrLevel == 0 ? 0 : cfgCorrLevel - 1;
@@ -624,6 +708,18 @@ struct qVectorsTable {
     qVectorTPCnegVec(IsCalibrated, qvecReTPCneg, qvecImTPCneg, qvecAmp[kTPCneg], TrkTPCnegLabel);
     qVectorTPCallVec(IsCalibrated, qvecReTPCall, qvecImTPCall, qvecAmp[kTPCall], TrkTPCallLabel);
 
+    if (produceEventPlaneSummary) {
+      int CorrLevel = cfgCorrLevel == 0 ? 0 : cfgCorrLevel - 1;
+      std::vector<float> psi(cfgnMods->size() * (kTPCall + 1));
+      for (std::size_t id = 0; id < cfgnMods->size(); id++) {
+        for (auto i{0u}; i < kTPCall + 1; i++) {
+          const int index = (kTPCall + 1) * 4 * id + i * 4 + CorrLevel;
+          psi[(kTPCall + 1) * id + i] = helperEP.GetEventPlane(qvecRe[index], qvecIm[index], cfgnMods->at(id));
+        }
+      }
+      eventPlaneSummary(cent, IsCalibrated, psi);
+    }
+
     // Deprecated, will be removed in future after transition time //
     if (useDetector["QvectorBPoss"])
       qVectorBPos(IsCalibrated, qvecReTPCpos.at(0), qvecImTPCpos.at(0), qvecAmp[kTPCpos], TrkTPCposLabel);
@@ -15,7 +15,12 @@
 /// \since  2020-06-22
 /// \brief  A task to fill the timestamp table from run number.
 ///         Uses headers from CCDB
+///         The orbit-reset timestamps and run durations can be resolved at init from a
+///         precomputed table on CCDB, a local cache file kept across jobs and a list of runs
 ///
+#include <fstream>
+#include <string>
+#include <utility>
 #include <vector>
 #include <map>
 #include "Framework/runDataProcessing.h"
@@ -48,6 +53,9 @@ struct TimestampTask {
   Configurable<std::string> orbit_reset_path{"orbit-reset-path", "CTP/Calib/OrbitReset", "path to the ccdb orbit-reset objects"};
   Configurable<std::string> url{"ccdb-url", "http://alice-ccdb.cern.ch", "URL of the CCDB database"};
   Configurable<int> isRun2MC{"isRun2MC", -1, "Running mode: enable only for Run 2 MC. Timestamps are set to SOR timestamp. Default: -1 (autoset from metadata) 0 (Standard) 1 (Run 2 MC)"};
+  Configurable<std::string> runTablePath{"run-table-path", "", "path to a ccdb std::vector<Long64_t> of (run, orbit-reset, SOR, EOR) quadruplets, read once at init. Empty: not used"};
+  Configurable<std::string> cacheFile{"cache-file", "", "local file caching (run, orbit-reset, SOR, EOR) across jobs, read at init and updated with the runs queried from CCDB. Empty: not used"};
+  Configurable<std::vector<int>> preloadRuns{"preload-runs", {}, "run numbers to resolve at init instead of at the first BC of the run"};
 
   void init(o2::framework::InitContext&)
   {
@@ -65,6 +73,85 @@ struct TimestampTask {
         isRun2MC.value = 0;
       }
     }
+
+    if (!runTablePath.value.empty()) {
+      auto runTable = ccdb->get<std::vector<Long64_t>>(runTablePath.value);
+      if (!runTable || runTable->size() % 4 != 0) {
+        LOGF(fatal, "Invalid table of runs %s, expected (run, orbit-reset, SOR, EOR) quadruplets", runTablePath.value.data());
+      }
+      for (size_t i = 0; i < runTable->size(); i += 4) {
+        addRun((*runTable)[i], (*runTable)[i + 1], {(*runTable)[i + 2], (*runTable)[i + 3]});
+      }
+      LOGF(info, "Read %zu runs from the table %s", runTable->size() / 4, runTablePath.value.data());
+    }
+    if (!cacheFile.value.empty()) {
+      std::ifstream file(cacheFile.value);
+      int runNumber;
+      int64_t orbitReset, sor, eor;
+      int nRuns = 0;
+      while (file >> runNumber >> orbitReset >> sor >> eor) {
+        addRun(runNumber, orbitReset, {sor, eor});
+        nRuns++;
+      }
+      LOGF(info, "Read %i runs from the cache file %s", nRuns, cacheFile.value.data());
+    }
+    for (const auto& runNumber : preloadRuns.value) {
+      if (!mapRunToOrbitReset.count(runNumber)) {
+        queryRun(runNumber);
+      }
+    }
+  }
+
+  /// Adds a run to the cache maps. The orbit-reset timestamp of the runs where it is set to the SOR
+  /// is recomputed, so that the entries do not depend from the running mode of the job which stored them
+  void addRun(int runNumber, int64_t orbitReset, std::pair<int64_t, int64_t> const& duration)
+  {
+    const bool isUnanchoredRun3MC = runNumber >= 300000 && runNumber < 500000;
+    if (isRun2MC.value == 1 || isUnanchoredRun3MC) {
+      orbitReset = duration.first * 1000; // from ms to us
+    }
+    mapRunToOrbitReset[runNumber] = orbitReset;
+    mapRunToRunDuration[runNumber] = duration;
+  }
+
+  /// Queries the run duration and the orbit-reset timestamp of a run from CCDB and adds them to the cache
+  void queryRun(int runNumber)
+  {
+    LOGF(debug, "Getting start-of-run and end-of-run timestamps from CCDB");
+    runDuration = ccdb->getRunDuration(runNumber, true); /// fatalise if timestamps are not found
+    int64_t sorTimestamp = runDuration.first;            // timestamp of the SOR/SOX/STF in ms
+    int64_t eorTimestamp = runDuration.second;           // timestamp of the EOR/EOX/ETF in ms
+
+    const bool isUnanchoredRun3MC = runNumber >= 300000 && runNumber < 500000;
+    if (isRun2MC.value == 1 || isUnanchoredRun3MC) {
+      // isRun2MC: bc/orbit distributions are not simulated in Run2 MC. All bcs are set to 0.
+      // isUnanchoredRun3MC: assuming orbit-reset is done in the beginning of each run
+      // Setting orbit-reset timestamp to start-of-run timestamp
+      orbitResetTimestamp = sorTimestamp * 1000; // from ms to us
+    } else if (runNumber < 300000) {             // Run 2
+      LOGF(debug, "Getting orbit-reset timestamp using start-of-run timestamp from CCDB");
+      auto ctp = ccdb->getForTimeStamp<std::vector<Long64_t>>(orbit_reset_path.value.data(), sorTimestamp);
+      orbitResetTimestamp = (*ctp)[0];
+    } else {
+      // sometimes orbit is reset after SOR. Using EOR timestamps for orbitReset query is more reliable
+      LOGF(debug, "Getting orbit-reset timestamp using end-of-run timestamp from CCDB");
+      auto ctp = ccdb->getForTimeStamp<std::vector<Long64_t>>(orbit_reset_path.value.data(), eorTimestamp / 2 + sorTimestamp / 2);
+      orbitResetTimestamp = (*ctp)[0];
+    }
+
+    // Adding the timestamp to the cache map
+    std::pair<std::map<int, int64_t>::iterator, bool> check;
+    check = mapRunToOrbitReset.insert(std::pair<int, int64_t>(runNumber, orbitResetTimestamp));
+    if (!check.second) {
+      LOGF(fatal, "Run number %i already existed with a orbit-reset timestamp of %llu", runNumber, check.first->second);
+    }
+    mapRunToRunDuration[runNumber] = runDuration;
+    LOGF(info, "Add new run number %i with orbit-reset timestamp %llu, SOR: %llu, EOR: %llu to cache", runNumber, orbitResetTimestamp, runDuration.first, runDuration.second);
+
+    if (!cacheFile.value.empty()) {
+      std::ofstream file(cacheFile.value, std::ios::app);
+      file << runNumber << " " << orbitResetTimestamp << " " << runDuration.first << " " << runDuration.second << "\n";
+    }
   }
 
   void process(aod::BC const& bc)
@@ -80,36 +167,7 @@ struct TimestampTask {
       orbitResetTimestamp = mapRunToOrbitReset[runNumber];
       runDuration = mapRunToRunDuration[runNumber];
     } else { // The run was not requested before: need to acccess CCDB!
-      LOGF(debug, "Getting start-of-run and end-of-run timestamps from CCDB");
-      runDuration = ccdb->getRunDuration(runNumber, true); /// fatalise if timestamps are not found
-      int64_t sorTimestamp = runDuration.first;            // timestamp of the SOR/SOX/STF in ms
-      int64_t eorTimestamp = runDuration.second;           // timestamp of the EOR/EOX/ETF in ms
-
-      const bool isUnanchoredRun3MC = runNumber >= 300000 && runNumber < 500000;
-      if (isRun2MC.value == 1 || isUnanchoredRun3MC) {
-        // isRun2MC: bc/orbit distributions are not simulated in Run2 MC. All bcs are set to 0.
-        // isUnanchoredRun3MC: assuming orbit-reset is done in the beginning of each run
-        // Setting orbit-reset timestamp to start-of-run timestamp
-        orbitResetTimestamp = sorTimestamp * 1000; // from ms to us
-      } else if (runNumber < 300000) {             // Run 2
-        LOGF(debug, "Getting orbit-reset timestamp using start-of-run timestamp from CCDB");
-        auto ctp = ccdb->getForTimeStamp<std::vector<Long64_t>>(orbit_reset_path.value.data(), sorTimestamp);
-        orbitResetTimestamp = (*ctp)[0];
-      } else {
-        // sometimes orbit is reset after SOR. Using EOR timestamps for orbitReset query is more reliable
-        LOGF(debug, "Getting orbit-reset timestamp using end-of-run timestamp from CCDB");
-        auto ctp = ccdb->getForTimeStamp<std::vector<Long64_t>>(orbit_reset_path.value.data(), eorTimestamp / 2 + sorTimestamp / 2);
-        orbitResetTimestamp = (*ctp)[0];
-      }
-
-      // Adding the timestamp to the cache map
-      std::pair<std::map<int, int64_t>::iterator, bool> check;
-      check = mapRunToOrbitReset.insert(std::pair<int, int64_t>(runNumber, orbitResetTimestamp));
-      if (!check.second) {
-        LOGF(fatal, "Run number %i already existed with a orbit-reset timestamp of %llu", runNumber, check.first->second);
-      }
-      mapRunToRunDuration[runNumber] = runDuration;
-      LOGF(info, "Add new run number %i with orbit-reset timestamp %llu, SOR: %llu, EOR: %llu to cache", runNumber, orbitResetTimestamp, runDuration.first, runDuration.second);
+      queryRun(runNumber);
     }
 
     if (verbose.value) {
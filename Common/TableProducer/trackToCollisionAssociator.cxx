@@ -15,12 +15,21 @@
 /// \author Fabrizio Grosa <fgrosa@cern.ch>, CERN
 /// \author Mattia Faggin <mfaggin@cern.ch>, University and INFN Padova
 
+#include <array>
+#include <string>
+#include <vector>
+
 #include "Common/Core/CollisionAssociation.h"
+#include "Common/Core/trackUtilities.h"
 #include "Common/DataModel/CollisionAssociationTables.h"
 #include "Common/DataModel/TrackSelectionTables.h"
+#include "CCDB/BasicCCDBManager.h"
+#include "DataFormatsParameters/GRPMagField.h"
+#include "DetectorsBase/Propagator.h"
 #include "Framework/AnalysisDataModel.h"
 #include "Framework/AnalysisTask.h"
 #include "Framework/runDataProcessing.h"
+#include "TableHelper.h"
 
 using namespace o2;
 using namespace o2::framework;
@@ -39,6 +48,7 @@ struct TrackToCollisionAssociation {
   Configurable<bool> includeUnassigned{"includeUnassigned", false, "consider also tracks which are not assigned to any collision"};
   Configurable<bool> fillTableOfCollIdsPerTrack{"fillTableOfCollIdsPerTrack", false, "fill additional table with vector of collision ids per track"};
   Configurable<int> bcWindowForOneSigma{"bcWindowForOneSigma", 60, "BC window to be multiplied by the number of sigmas to define maximum window to be considered"};
+  Configurable<bool> useTimeIndex{"useTimeIndex", true, "find the time-compatible tracks of blocks not sorted by BC with a time index instead of a full scan (same output)"};
 
   CollisionAssociation<true> collisionAssociator;
 
@@ -63,6 +73,7 @@ struct TrackToCollisionAssociation {
     collisionAssociator.setIncludeUnassigned(includeUnassigned);
     collisionAssociator.setFillTableOfCollIdsPerTrack(fillTableOfCollIdsPerTrack);
     collisionAssociator.setBcWindow(bcWindowForOneSigma);
+    collisionAssociator.setUseTimeIndex(useTimeIndex);
   }
 
   void processAssocWithTime(Collisions const& collisions, TracksWithSel const& tracksUnfiltered, TracksWithSelFilter const& tracks, AmbiguousTracks const& ambiguousTracks, BCs const& bcs)
@@ -78,8 +89,126 @@ struct TrackToCollisionAssociation {
   PROCESS_SWITCH(TrackToCollisionAssociation, processStandardAssoc, "Use standard track-to-collision association", false);
 };
 
+// Propagates the tracks to each of their associated collisions, so that the consumers of TrackAssoc do not have to
+// propagate the ambiguous tracks themselves. The associations are grouped by track: the parameters of a track are
+// loaded once and copied for each of its collisions, and the rows are filled in the order of TrackAssoc.
+struct TrackToCollisionAssociationPropagation {
+
+  Produces<TrackAssocDCA> associationDCA;
+  Produces<TrackAssocPars> associationPars;
+
+  Service<o2::ccdb::BasicCCDBManager> ccdb;
+
+  Configurable<std::string> ccdburl{"ccdb-url", "http://alice-ccdb.cern.ch", "url of the ccdb repository"};
+  Configurable<std::string> lutPath{"lutPath", "GLO/Param/MatLUT", "Path of the Lut parametrization"};
+  Configurable<std::string> grpmagPath{"grpmagPath", "GLO/Config/GRPMagField", "CCDB path of the GRPMagField object"};
+
+  o2::base::Propagator::MatCorrType matCorr = o2::base::Propagator::MatCorrType::USEMatCorrLUT;
+  o2::base::MatLayerCylSet* lut = nullptr;
+  int runNumber = -1;
+  bool fillAssociationPars = false;
+
+  // Running variables
+  std::vector<int> assocOffsets; // associations of track i in assocByTrack[assocOffsets[i], assocOffsets[i + 1])
+  std::vector<int> assocByTrack;
+  std::vector<std::array<float, 2>> dcas;
+  std::vector<std::array<float, 7>> pars;
+
+  void init(InitContext& initContext)
+  {
+    if (!doprocessPropagation) {
+      return;
+    }
+    fillAssociationPars = isTableRequiredInWorkflow(initContext, "TrackAssocPars");
+
+    ccdb->setURL(ccdburl);
+    ccdb->setCaching(true);
+    ccdb->setLocalObjectValidityChecking();
+  }
+
+  void initCCDB(BCsWithTimestamps::iterator const& bc)
+  {
+    if (runNumber == bc.runNumber()) {
+      return;
+    }
+    if (!lut) {
+      LOG(info) << "Loading material look-up table for timestamp: " << bc.timestamp();
+      lut = o2::base::MatLayerCylSet::rectifyPtrFromFile(ccdb->getForTimeStamp<o2::base::MatLayerCylSet>(lutPath, bc.timestamp()));
+    }
+    auto grpmag = ccdb->getForTimeStamp<o2::parameters::GRPMagField>(grpmagPath, bc.timestamp());
+    LOG(info) << "Setting magnetic field to current " << grpmag->getL3Current() << " A for run " << bc.runNumber() << " from its GRPMagField CCDB object";
+    o2::base::Propagator::initFieldFromGRP(grpmag);
+    o2::base::Propagator::Instance()->setMatLUT(lut);
+    runNumber = bc.runNumber();
+  }
+
+  void process(BCsWithTimestamps const&) {}
+
+  void processPropagation(TrackAssoc const& associations, Collisions const& collisions, Tracks const& tracks, BCsWithTimestamps const& bcs)
+  {
+    if (bcs.size() == 0) {
+      return;
+    }
+    initCCDB(bcs.begin());
+
+    // group the associations by track
+    const int nAssoc = associations.size();
+    assocOffsets.assign(tracks.size() + 1, 0);
+    for (const auto& association : associations) {
+      assocOffsets[association.trackId() + 1]++;
+    }
+    for (std::size_t iTrack = 1; iTrack < assocOffsets.size(); iTrack++) {
+      assocOffsets[iTrack] += assocOffsets[iTrack - 1];
+    }
+    assocByTrack.resize(nAssoc);
+    std::vector<int> next(assocOffsets.begin(), assocOffsets.end() - 1);
+    for (const auto& association : associations) {
+      assocByTrack[next[association.trackId()]++] = association.globalIndex();
+    }
+
+    dcas.assign(nAssoc, {999.f, 999.f});
+    if (fillAssociationPars) {
+      pars.assign(nAssoc, {});
+    }
+    o2::track::TrackParametrization<float> trackPar;
+    std::array<float, 2> dcaInfo;
+    for (const auto& track : tracks) {
+      const int begin = assocOffsets[track.globalIndex()];
+      const int end = assocOffsets[track.globalIndex() + 1];
+      if (begin == end) {
+        continue;
+      }
+      const auto trackParAtPV = getTrackPar(track);
+      for (int i = begin; i < end; i++) {
+        const int iAssoc = assocByTrack[i];
+        const auto collision = collisions.rawIteratorAt(associations.rawIteratorAt(iAssoc).collisionId());
+        trackPar = trackParAtPV;
+        if (o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackPar, 2.f, matCorr, &dcaInfo)) {
+          dcas[iAssoc] = dcaInfo;
+        }
+        if (fillAssociationPars) {
+          pars[iAssoc] = {trackPar.getX(), trackPar.getAlpha(), trackPar.getY(), trackPar.getZ(), trackPar.getSnp(), trackPar.getTgl(), trackPar.getQ2Pt()};
+        }
+      }
+    }
+
+    associationDCA.reserve(nAssoc);
+    for (const auto& dca : dcas) {
+      associationDCA(dca[0], dca[1]);
+    }
+    if (fillAssociationPars) {
+      associationPars.reserve(nAssoc);
+      for (const auto& par : pars) {
+        associationPars(par[0], par[1], par[2], par[3], par[4], par[5], par[6]);
+      }
+    }
+  }
+  PROCESS_SWITCH(TrackToCollisionAssociationPropagation, processPropagation, "Propagate the tracks to each of their associated collisions", false);
+};
+
 //________________________________________________________________________________________________________________________
 WorkflowSpec defineDataProcessing(ConfigContext const& cfgc)
 {
-  return WorkflowSpec{adaptAnalysisTask<TrackToCollisionAssociation>(cfgc)};
+  return WorkflowSpec{adaptAnalysisTask<TrackToCollisionAssociation>(cfgc),
+                      adaptAnalysisTask<TrackToCollisionAssociationPropagation>(cfgc)};
 }
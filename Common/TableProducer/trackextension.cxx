@@ -16,6 +16,7 @@
 #include "Framework/AnalysisDataModel.h"
 #include "Framework/AnalysisTask.h"
 #include "Framework/runDataProcessing.h"
+#include "TableHelper.h"
 #include "Common/Core/TrackSelection.h"
 #include "Common/DataModel/TrackSelectionTables.h"
 #include "Common/DataModel/Multiplicity.h"
@@ -58,11 +59,18 @@ struct TrackExtension {
   o2::base::MatLayerCylSet* lut;
   int mRunNumber;
   float mMagField;
+  bool fillTracksDCA = true;
 
-  void init(InitContext&)
+  void init(InitContext& initContext)
   {
     using namespace analysis::trackextension;
 
+    // The propagation is only done if the DCA table is consumed in the workflow
+    fillTracksDCA = isTableRequiredInWorkflow(initContext, "TracksDCA");
+    if (!fillTracksDCA) {
+      LOG(info) << "TracksDCA is not required in the workflow, tracks will not be propagated";
+    }
+
     ccdb->setURL(ccdburl);
     ccdb->setCaching(true);
     ccdb->setLocalObjectValidityChecking();
@@ -76,21 +84,29 @@ struct TrackExtension {
   void processRun2(aod::FullTracks const& tracks, aod::Collisions const&, aod::BCsWithTimestamps const&)
   {
     using namespace analysis::trackextension;
+    if (!fillTracksDCA) {
+      return;
+    }
+    extendedTrackQuantities.reserve(tracks.size());
 
+    int lastCollisionId = -1; // the run is checked once per collision
     for (auto& track : tracks) {
       std::array<float, 2> dca{1e10f, 1e10f};
       if (track.has_collision()) {
         if (track.trackType() == o2::aod::track::TrackTypeEnum::Run2Track && track.itsChi2NCl() != 0.f && track.tpcChi2NCl() != 0.f && std::abs(track.x()) < 10.f) {
-          auto bc = track.collision_as<aod::Collisions>().bc_as<aod::BCsWithTimestamps>();
-          if (mRunNumber != bc.runNumber()) {
-            o2::parameters::GRPObject* grpo = ccdb->getForTimeStamp<o2::parameters::GRPObject>(ccdbpath_grp, bc.timestamp());
-            if (grpo != nullptr) {
-              mMagField = grpo->getNominalL3Field();
-              LOGF(info, "Setting magnetic field to %f kG for run %d", mMagField, bc.runNumber());
-            } else {
-              LOGF(fatal, "GRP object is not available in CCDB for run=%d at timestamp=%llu", bc.runNumber(), bc.timestamp());
+          if (track.collisionId() != lastCollisionId) {
+            lastCollisionId = track.collisionId();
+            auto bc = track.collision_as<aod::Collisions>().bc_as<aod::BCsWithTimestamps>();
+            if (mRunNumber != bc.runNumber()) {
+              o2::parameters::GRPObject* grpo = ccdb->getForTimeStamp<o2::parameters::GRPObject>(ccdbpath_grp, bc.timestamp());
+              if (grpo != nullptr) {
+                mMagField = grpo->getNominalL3Field();
+                LOGF(info, "Setting magnetic field to %f kG for run %d", mMagField, bc.runNumber());
+              } else {
+                LOGF(fatal, "GRP object is not available in CCDB for run=%d at timestamp=%llu", bc.runNumber(), bc.timestamp());
+              }
+              mRunNumber = bc.runNumber();
             }
-            mRunNumber = bc.runNumber();
           }
           auto trackPar = getTrackPar(track);
           auto const& collision = track.collision();
@@ -114,23 +130,31 @@ struct TrackExtension {
     /* so probably the whole initialization sequence is needed        */
     /* when a new run (Run3) is processed                           */
     o2::base::Propagator::MatCorrType matCorr = o2::base::Propagator::MatCorrType::USEMatCorrLUT;
+    if (!fillTracksDCA) {
+      return;
+    }
+    extendedTrackQuantities.reserve(tracks.size());
 
+    int lastCollisionId = -1; // the run is checked once per collision
     for (auto& track : tracks) {
       std::array<float, 2> dca{1e10f, 1e10f};
       if (track.has_collision()) {
         if (((compatibilityIU.value) && track.trackType() == o2::aod::track::TrackTypeEnum::TrackIU) ||
             ((!compatibilityIU.value) && track.trackType() == o2::aod::track::TrackTypeEnum::Track)) {
-          auto bc = track.collision_as<aod::Collisions>().bc_as<aod::BCsWithTimestamps>();
-          if (mRunNumber != bc.runNumber()) {
-            auto grpo = ccdb->getForTimeStamp<o2::parameters::GRPObject>(ccdbpath_grp, bc.timestamp());
-            if (grpo != nullptr) {
-              o2::base::Propagator::initFieldFromGRP(grpo);
-              o2::base::Propagator::Instance()->setMatLUT(lut);
-              LOGF(info, "Setting magnetic field to %d kG for run %d from its GRP CCDB object", grpo->getNominalL3Field(), bc.runNumber());
-            } else {
-              LOGF(fatal, "GRP object is not available in CCDB for run=%d at timestamp=%llu", bc.runNumber(), bc.timestamp());
+          if (track.collisionId() != lastCollisionId) {
+            lastCollisionId = track.collisionId();
+            auto bc = track.collision_as<aod::Collisions>().bc_as<aod::BCsWithTimestamps>();
+            if (mRunNumber != bc.runNumber()) {
+              auto grpo = ccdb->getForTimeStamp<o2::parameters::GRPObject>(ccdbpath_grp, bc.timestamp());
+              if (grpo != nullptr) {
+                o2::base::Propagator::initFieldFromGRP(grpo);
+                o2::base::Propagator::Instance()->setMatLUT(lut);
+                LOGF(info, "Setting magnetic field to %d kG for run %d from its GRP CCDB object", grpo->getNominalL3Field(), bc.runNumber());
+              } else {
+                LOGF(fatal, "GRP object is not available in CCDB for run=%d at timestamp=%llu", bc.runNumber(), bc.timestamp());
+              }
+              mRunNumber = bc.runNumber();
             }
-            mRunNumber = bc.runNumber();
           }
           auto trackPar = getTrackPar(track);
           auto const& collision = track.collision();
@@ -150,20 +150,25 @@ struct TrackSelectionTask {
     }
     if (isRun3) {
       for (auto& track : tracks) {
+        // each selection is evaluated once per track, the full masks are only needed for the extended table
+        o2::aod::track::TrackSelectionFlags::flagtype trackflagGlob = globalTracks.IsSelectedMask(track);
+        o2::aod::track::TrackSelectionFlags::flagtype trackflagFB1 = 0;
+        o2::aod::track::TrackSelectionFlags::flagtype trackflagFB2 = 0;
+        if (produceFBextendedTable == 1) {
+          trackflagFB1 = filtBit1.IsSelectedMask(track);
+          trackflagFB2 = filtBit2.IsSelectedMask(track);
+        }
 
         if (produceTable == 1) {
           filterTable((uint8_t)0,
-                      globalTracks.IsSelectedMask(track),
-                      filtBit1.IsSelected(track),
-                      filtBit2.IsSelected(track),
+                      trackflagGlob,
+                      produceFBextendedTable == 1 ? TrackSelection::PassesAllCuts(trackflagFB1) : filtBit1.IsSelected(track),
+                      produceFBextendedTable == 1 ? TrackSelection::PassesAllCuts(trackflagFB2) : filtBit2.IsSelected(track),
                       filtBit3.IsSelected(track),
                       filtBit4.IsSelected(track),
                       filtBit5.IsSelected(track));
         }
         if (produceFBextendedTable == 1) {
-          o2::aod::track::TrackSelectionFlags::flagtype trackflagGlob = globalTracks.IsSelectedMask(track);
-          o2::aod::track::TrackSelectionFlags::flagtype trackflagFB1 = filtBit1.IsSelectedMask(track);
-          o2::aod::track::TrackSelectionFlags::flagtype trackflagFB2 = filtBit2.IsSelectedMask(track);
           // o2::aod::track::TrackSelectionFlags::flagtype trackflagFB3 = filtBit3.IsSelectedMask(track); // only temporarily commented, will be used
           // o2::aod::track::TrackSelectionFlags::flagtype trackflagFB4 = filtBit4.IsSelectedMask(track);
           // o2::aod::track::TrackSelectionFlags::flagtype trackflagFB5 = filtBit5.IsSelectedMask(track);
@@ -194,7 +199,7 @@ struct TrackSelectionTask {
       o2::aod::track::TrackSelectionFlags::flagtype trackflagGlob = globalTracks.IsSelectedMask(track);
       if (produceTable == 1) {
         filterTable((uint8_t)globalTracksSDD.IsSelected(track),
-                    globalTracks.IsSelectedMask(track),
+                    trackflagGlob,
                     filtBit1.IsSelected(track),
                     filtBit2.IsSelected(track),
                     filtBit3.IsSelected(track),
@@ -231,6 +236,10 @@ struct TrackSelectionTask {
 //****************************************************************************************
 WorkflowSpec defineDataProcessing(ConfigContext const& cfgc)
 {
+  if (areTablesInInput(cfgc, {"TRACKSELECTION", "TRACKSELEXTRA"})) {
+    LOG(info) << "Track selection tables read from the input, track-selection is not added";
+    return WorkflowSpec{};
+  }
   WorkflowSpec workflow{adaptAnalysisTask<TrackSelectionTask>(cfgc, TaskName{"track-selection"})};
   return workflow;
 }
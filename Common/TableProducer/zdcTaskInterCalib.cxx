@@ -46,6 +46,7 @@ struct ZdcTaskInterCalib {
   Configurable<bool> tdcCut{"tdcCut", false, "Flag for TDC cut"};
   Configurable<float> tdcZNmincut{"tdcZNmincut", -2.5, "Min ZN TDC cut"};
   Configurable<float> tdcZNmaxcut{"tdcZNmaxcut", -2.5, "Max ZN TDC cut"};
+  Configurable<bool> fillNormalEquations{"fillNormalEquations", false, "Accumulate the sums of the products of the PMC and PMQ signals for the least-squares intercalibration"};
   // Event selections
   Configurable<bool> cfgEvSelSel8{"cfgEvSelSel8", true, "Event selection: sel8"};
   Configurable<float> cfgEvSelVtxZ{"cfgEvSelVtxZ", 10, "Event selection: zVtx"};
@@ -59,6 +60,8 @@ struct ZdcTaskInterCalib {
   //
   HistogramRegistry registry{"Histos", {}, OutputObjHandlingPolicy::AnalysisObject};
 
+  static constexpr int NSignals = 5; // common PM and 4 towers
+
   enum SelectionCriteria {
     evSel_zvtx,
     evSel_sel8,
@@ -86,6 +89,11 @@ struct ZdcTaskInterCalib {
     registry.add("ZNCpm4", "ZNCpm4; ZNC PM4; Entries", {HistType::kTH1F, {{nBins, -0.5, maxZN}}});
     registry.add("ZNAsumq", "ZNAsumq; ZNA uncalib. sum PMQ; Entries", {HistType::kTH1F, {{nBins, -0.5, maxZN}}});
     registry.add("ZNCsumq", "ZNCsumq; ZNC uncalib. sum PMQ; Entries", {HistType::kTH1F, {{nBins, -0.5, maxZN}}});
+    if (fillNormalEquations) {
+      // bin (i, j) holds the sum over the events of x_i * x_j, with x = (PMC, PMQ1, ..., PMQ4)
+      registry.add("ZNAnormalEq", "ZNAnormalEq; ZNA signal i; ZNA signal j", {HistType::kTH2D, {{NSignals, -0.5, NSignals - 0.5}, {NSignals, -0.5, NSignals - 0.5}}});
+      registry.add("ZNCnormalEq", "ZNCnormalEq; ZNC signal i; ZNC signal j", {HistType::kTH2D, {{NSignals, -0.5, NSignals - 0.5}, {NSignals, -0.5, NSignals - 0.5}}});
+    }
 
     registry.add("hEventCount", "Number of Event; Cut; #Events Passed Cut", {HistType::kTH1D, {{nEventSelections, 0, nEventSelections}}});
     registry.get<TH1>(HIST("hEventCount"))->GetXaxis()->SetBinLabel(evSel_allEvents + 1, "All events");
@@ -99,6 +107,20 @@ struct ZdcTaskInterCalib {
     registry.get<TH1>(HIST("hEventCount"))->GetXaxis()->SetBinLabel(evSel_kIsGoodITSLayersAll + 1, "kkIsGoodITSLayersAll");
   }
 
+  /// Add the products of the signals of one event to the sums of the least-squares intercalibration.
+  /// The coefficients c_i such that PMC = sum_i c_i PMQ_i are the solution of A c = b, with
+  /// A_ij = sum PMQ_i PMQ_j (bins (i, j) with i, j >= 1) and b_i = sum PMC PMQ_i (bins (0, i))
+  void addToNormalEquations(TH2* hSums, double pmc, const double pmq[4])
+  {
+    const double x[NSignals]{pmc, pmq[0], pmq[1], pmq[2], pmq[3]};
+    for (int i = 0; i < NSignals; i++) {
+      for (int j = 0; j < NSignals; j++) {
+        hSums->AddBinContent(hSums->GetBin(i + 1, j + 1), x[i] * x[j]);
+      }
+    }
+    hSums->SetEntries(hSums->GetEntries() + 1);
+  }
+
   template <typename TCollision>
   uint8_t eventSelected(TCollision collision)
   {
@@ -225,6 +247,9 @@ struct ZdcTaskInterCalib {
           registry.get<TH1>(HIST("ZNCpm3"))->Fill(pmqZNC[2]);
           registry.get<TH1>(HIST("ZNCpm4"))->Fill(pmqZNC[3]);
           registry.get<TH1>(HIST("ZNCsumq"))->Fill(sumZNC);
+          if (fillNormalEquations) {
+            addToNormalEquations(registry.get<TH2>(HIST("ZNCnormalEq")).get(), pmcZNC, pmqZNC);
+          }
         }
         if (isZNAhit) {
           for (int it = 0; it < nTowers; it++) {
@@ -238,6 +263,9 @@ struct ZdcTaskInterCalib {
           registry.get<TH1>(HIST("ZNApm3"))->Fill(pmqZNA[2]);
           registry.get<TH1>(HIST("ZNApm4"))->Fill(pmqZNA[3]);
           registry.get<TH1>(HIST("ZNAsumq"))->Fill(sumZNA);
+          if (fillNormalEquations) {
+            addToNormalEquations(registry.get<TH2>(HIST("ZNAnormalEq")).get(), pmcZNA, pmqZNA);
+          }
         }
         if (isZNAhit || isZNChit)
           zTab(pmcZNA, pmqZNA[0], pmqZNA[1], pmqZNA[2], pmqZNA[3], tdcZNC, pmcZNC, pmqZNC[0], pmqZNC[1], pmqZNC[2], pmqZNC[3], tdcZNA, centrality, foundBC.timestamp(), evSelection);
@@ -45,7 +45,11 @@
 #include "Math/Vector4D.h"
 #include "TGeoGlobalMagField.h"
 
+#include <algorithm>
 #include <chrono>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 using namespace std;
 using namespace o2;
@@ -145,6 +149,24 @@ struct VarClusters {
   vector<int> DEIDs;
 };
 
+// Refitted and propagated parameters of a muon track, computed once per DF for all the pairs it enters
+struct VarDimuonTrack {
+  bool valid = false; // false if the refit is not valid
+  VarTrack muon;
+  VarTrack muonPV;
+};
+
+// Same for the leading global muon matched to an MCH track
+struct VarGlobalDimuonTrack {
+  bool valid = false; // false if the refit of the MCH track is not valid
+  VarTrack mch;
+  VarTrack mchPV;
+  VarTrack mft;
+  VarTrack muonPV;
+  VarTrack mftPV;
+  VarTrack subleadingMuonPV; // sub-leading global muon, if any
+};
+
 struct muonQa {
   ////   Variables for enabling QA options
   struct : ConfigurableGroup {
@@ -1026,38 +1048,50 @@ struct muonQa {
                     std::vector<MuonPair>& muonPairs,
                     std::vector<GlobalMuonPair>& globalMuonPairs)
   {
-    // muon tracks - outer loop over collisions
-    for (auto& [collisionIndex1, collisionInfo1] : collisionInfos) {
-
-      // outer loop over muon tracks
-      auto muonCollision1 = muons.sliceBy(fwdtracksPerCollision, collisionInfo1.globalIndex);
-      for (auto muon1 : muonCollision1) {
-
-        if (muon1.trackType() <= 2) {
+    // muon tracks of each collision, sliced once, and collisions sorted in z to only test the mixing criteria
+    // on those within the vertex-z window (slightly enlarged, the criteria are applied as before)
+    std::map<uint64_t, std::vector<uint64_t>> muonsPerCollision;
+    std::map<uint64_t, std::vector<std::pair<uint64_t, const std::vector<uint64_t>*>>> globalMuonsPerCollision;
+    std::vector<std::pair<float, uint64_t>> collisionsByZ;
+    for (auto& [collisionIndex, collisionInfo] : collisionInfos) {
+      collisionsByZ.emplace_back(collisionInfo.z, collisionIndex);
+      auto& muonIndices = muonsPerCollision[collisionIndex];
+      auto& globalMuonIndices = globalMuonsPerCollision[collisionIndex];
+      auto muonCollision = muons.sliceBy(fwdtracksPerCollision, collisionInfo.globalIndex);
+      for (auto muon : muonCollision) {
+        if (muon.trackType() <= 2) {
           continue;
         }
-        auto mchIndex1 = muon1.globalIndex();
+        auto mchIndex = muon.globalIndex();
+        muonIndices.push_back(mchIndex);
+        auto matchingCandidateIt = matchingCandidates.find(mchIndex);
+        if (matchingCandidateIt != matchingCandidates.end()) {
+          globalMuonIndices.emplace_back(mchIndex, &matchingCandidateIt->second);
+        }
+      }
+    }
+    std::sort(collisionsByZ.begin(), collisionsByZ.end());
+    const float zWindow = configMixing.fEventMaxDeltaVtxZ + 0.001f;
 
-        // inner loop over collisions
-        for (auto& [collisionIndex2, collisionInfo2] : collisionInfos) {
-          // avoid double-counting of collisions
-          if (collisionIndex2 < collisionIndex1)
-            continue;
+    std::vector<uint64_t> pairedCollisions;
+    for (auto& [collisionIndex1, collisionInfo1] : collisionInfos) {
+      // inner collisions: the same one, and the following ones (to avoid double-counting) that can be mixed with it
+      pairedCollisions.clear();
+      pairedCollisions.push_back(collisionIndex1);
+      auto first = std::lower_bound(collisionsByZ.begin(), collisionsByZ.end(), std::make_pair(collisionInfo1.z - zWindow, uint64_t{0}));
+      for (auto it = first; it != collisionsByZ.end() && it->first <= collisionInfo1.z + zWindow; ++it) {
+        auto collisionIndex2 = it->second;
+        if (collisionIndex2 > collisionIndex1 && IsMixedEvent(collisionInfo1, collisionInfos.at(collisionIndex2))) {
+          pairedCollisions.push_back(collisionIndex2);
+        }
+      }
+      std::sort(pairedCollisions.begin() + 1, pairedCollisions.end());
 
+      // muon tracks
+      for (auto mchIndex1 : muonsPerCollision[collisionIndex1]) {
+        for (auto collisionIndex2 : pairedCollisions) {
           bool sameEvent = (collisionIndex1 == collisionIndex2);
-          bool mixedEvent = IsMixedEvent(collisionInfo1, collisionInfo2);
-
-          if (!sameEvent && !mixedEvent)
-            continue;
-
-          // inner loop over muon tracks
-          auto muonCollision2 = muons.sliceBy(fwdtracksPerCollision, collisionInfo2.globalIndex);
-          for (auto muon2 : muonCollision2) {
-            if (muon2.trackType() <= 2) {
-              continue;
-            }
-            auto mchIndex2 = muon2.globalIndex();
-
+          for (auto mchIndex2 : muonsPerCollision[collisionIndex2]) {
             // avoid double-counting of muon pairs if we are not mixing events
             if (sameEvent && mchIndex2 <= mchIndex1)
               continue;
@@ -1067,54 +1101,17 @@ struct muonQa {
           }
         }
       }
-    }
-
-    // global muon tracks - outer loop over collisions
-    for (auto& [collisionIndex1, collisionInfo1] : collisionInfos) {
-
-      // outer loop over global muon tracks
-      auto muonCollision1 = muons.sliceBy(fwdtracksPerCollision, collisionInfo1.globalIndex);
-      for (auto muon1 : muonCollision1) {
-
-        if (muon1.trackType() <= 2) {
-          continue;
-        }
-        auto mchIndex1 = muon1.globalIndex();
-        auto matchingCandidateIt1 = matchingCandidates.find(mchIndex1);
-        if (matchingCandidateIt1 == matchingCandidates.end()) {
-          continue;
-        }
-
-        // inner loop over collisions
-        for (auto& [collisionIndex2, collisionInfo2] : collisionInfos) {
-          // avoid double-counting of collisions
-          if (collisionIndex2 < collisionIndex1)
-            continue;
 
+      // global muon tracks
+      for (auto& [mchIndex1, candidates1] : globalMuonsPerCollision[collisionIndex1]) {
+        for (auto collisionIndex2 : pairedCollisions) {
           bool sameEvent = (collisionIndex1 == collisionIndex2);
-          bool mixedEvent = IsMixedEvent(collisionInfo1, collisionInfo2);
-
-          if (!sameEvent && !mixedEvent)
-            continue;
-
-          // outer loop over global muon tracks
-          auto muonCollision2 = muons.sliceBy(fwdtracksPerCollision, collisionInfo2.globalIndex);
-          for (auto muon2 : muonCollision2) {
-
-            if (muon2.trackType() <= 2) {
-              continue;
-            }
-            auto mchIndex2 = muon2.globalIndex();
-            auto matchingCandidateIt2 = matchingCandidates.find(mchIndex2);
-            if (matchingCandidateIt2 == matchingCandidates.end()) {
-              continue;
-            }
-
+          for (auto& [mchIndex2, candidates2] : globalMuonsPerCollision[collisionIndex2]) {
             // avoid double-counting of muon pairs if we are not mixing events
             if (sameEvent && mchIndex2 <= mchIndex1)
               continue;
 
-            GlobalMuonPair muonPair{{collisionIndex1, matchingCandidateIt1->second}, {collisionIndex2, matchingCandidateIt2->second}};
+            GlobalMuonPair muonPair{{collisionIndex1, *candidates1}, {collisionIndex2, *candidates2}};
             globalMuonPairs.emplace_back(muonPair);
           }
         }
@@ -2239,6 +2236,98 @@ struct muonQa {
     }
   }
 
+  /// Refit and propagation of a muon track for the dimuon QA, done at its first pair and cached for the others
+  template <typename TMuon, typename VarC, typename TMuonCls>
+  VarDimuonTrack const& GetDimuonTrack(std::unordered_map<uint64_t, VarDimuonTrack>& cache, TMuon const& muonTrack, VarC const& collision, TMuonCls const& clusters)
+  {
+    auto [it, inserted] = cache.try_emplace(muonTrack.globalIndex());
+    auto& track = it->second;
+    if (!inserted) {
+      return track;
+    }
+
+    mch::Track mchrealigned;
+    VarClusters fgValuesCls;
+    if (!FillClusters(muonTrack, clusters, fgValuesCls, mchrealigned)) {
+      return track; // Refit is not valid
+    }
+    track.valid = true;
+
+    if (configRealign.fDoRealign) {
+      FillTrack(mchrealigned, track.muon);
+
+      // Propagate MCH to PV
+      FillPropagation(mchrealigned, collision, track.muonPV);
+
+      // Recalculate pDCA and Rabs values
+      FillPropagation(mchrealigned, collision, track.muon, kToAbsEnd);
+      FillPropagation(mchrealigned, collision, track.muon, kToDCA);
+    } else {
+      FillTrack<1>(muonTrack, track.muon);
+
+      // Propagate MCH to PV
+      FillPropagation<1>(muonTrack, collision, track.muon, track.muonPV);
+    }
+    return track;
+  }
+
+  /// Same for the leading (and sub-leading) global muons matched to an MCH track
+  template <typename TFwdTracks, typename VarC, typename TMuonCls>
+  VarGlobalDimuonTrack const& GetGlobalDimuonTrack(std::unordered_map<uint64_t, VarGlobalDimuonTrack>& cache, TFwdTracks const& muonTracks, std::vector<uint64_t> const& globalTracksVector, VarC const& collision, TMuonCls const& clusters)
+  {
+    auto [it, inserted] = cache.try_emplace(globalTracksVector[0]);
+    auto& track = it->second;
+    if (!inserted) {
+      return track;
+    }
+
+    auto const& muonTrack = muonTracks.rawIteratorAt(globalTracksVector[0]);
+    auto const& mftTrack = muonTrack.template matchMFTTrack_as<MyMFTs>();
+    auto const& mchTrack = muonTrack.template matchMCHTrack_as<MyMuonsWithCov>();
+
+    // Fill MCH and MFT tracks
+    FillTrack<1>(mchTrack, track.mch);
+    FillTrack<0>(mftTrack, track.mft);
+
+    //// Fill matching chi2
+    FillMatching(muonTrack, track.mch, track.mft);
+
+    mch::Track mchrealigned;
+    VarClusters fgValuesCls;
+    if (!FillClusters(mchTrack, clusters, fgValuesCls, mchrealigned)) {
+      return track; // Refit is not valid
+    }
+    track.valid = true;
+
+    if (configRealign.fDoRealign) {
+      FillTrack(mchrealigned, track.mch);
+
+      // Propagate MCH to PV
+      FillPropagation(mchrealigned, collision, track.mchPV);
+
+      // Recalculate pDCA and Rabs values
+      FillPropagation(mchrealigned, collision, track.mch, kToAbsEnd);
+      FillPropagation(mchrealigned, collision, track.mch, kToDCA);
+    } else {
+      FillTrack<1>(mchTrack, track.mch);
+
+      // Propagate MCH to PV
+      FillPropagation<1>(mchTrack, collision, track.mch, track.mchPV);
+    }
+
+    // Propagate global muon tracks to PV
+    FillPropagation<0>(muonTrack, collision, track.mch, track.muonPV);
+
+    // Propagate MFT tracks to PV
+    FillPropagation<0, 1>(mftTrack, collision, track.mch, track.mftPV);
+
+    if (globalTracksVector.size() > 1) {
+      auto const& muonTrackb = muonTracks.rawIteratorAt(globalTracksVector[1]);
+      FillPropagation<0>(muonTrackb, collision, track.mch, track.subleadingMuonPV);
+    }
+    return track;
+  }
+
   template <typename TEventMap, typename TCandidateMap, typename TFwdTracks, typename TMuonCls>
   void runDimuonQA(TEventMap const& collisions, TCandidateMap const& matchingCandidates, TFwdTracks const& muonTracks, TMuonCls const& clusters)
   {
@@ -2247,6 +2336,10 @@ struct muonQa {
 
     GetMuonPairs(muonTracks, matchingCandidates, collisions, muonPairs, globalMuonPairs);
 
+    // tracks refitted and propagated once, indexed by the muon global index
+    std::unordered_map<uint64_t, VarDimuonTrack> dimuonTracks;
+    std::unordered_map<uint64_t, VarGlobalDimuonTrack> globalDimuonTracks;
+
     for (auto& [muon1, muon2] : muonPairs) {
       auto collisionIndex1 = muon1.first;
       auto const& collision1 = collisions.at(collisionIndex1);
@@ -2258,36 +2351,15 @@ struct muonQa {
       auto const& muonTrack1 = muonTracks.rawIteratorAt(mchIndex1);
       auto const& muonTrack2 = muonTracks.rawIteratorAt(mchIndex2);
 
-      VarTrack fgValuesMuon1, fgValuesMuonPV1;
-      VarTrack fgValuesMuon2, fgValuesMuonPV2;
-      mch::Track mchrealigned1, mchrealigned2;
-      VarClusters fgValuesCls1, fgValuesCls2;
-      if (!FillClusters(muonTrack1, clusters, fgValuesCls1, mchrealigned1) || !FillClusters(muonTrack2, clusters, fgValuesCls2, mchrealigned2)) {
+      auto const& dimuonTrack1 = GetDimuonTrack(dimuonTracks, muonTrack1, collision1, clusters);
+      auto const& dimuonTrack2 = GetDimuonTrack(dimuonTracks, muonTrack2, collision2, clusters);
+      if (!dimuonTrack1.valid || !dimuonTrack2.valid) {
         continue; // Refit is not valid
       }
-
-      if (configRealign.fDoRealign) {
-
-        FillTrack(mchrealigned1, fgValuesMuon1);
-        FillTrack(mchrealigned2, fgValuesMuon2);
-
-        // Propagate MCH to PV
-        FillPropagation(mchrealigned1, collision1, fgValuesMuonPV1);
-        FillPropagation(mchrealigned2, collision2, fgValuesMuonPV2);
-
-        // Recalculate pDCA and Rabs values
-        FillPropagation(mchrealigned1, collision1, fgValuesMuon1, kToAbsEnd);
-        FillPropagation(mchrealigned1, collision1, fgValuesMuon1, kToDCA);
-        FillPropagation(mchrealigned2, collision2, fgValuesMuon2, kToAbsEnd);
-        FillPropagation(mchrealigned2, collision2, fgValuesMuon2, kToDCA);
-      } else {
-        FillTrack<1>(muonTrack1, fgValuesMuon1);
-        FillTrack<1>(muonTrack2, fgValuesMuon2);
-
-        // Propagate MCH to PV
-        FillPropagation<1>(muonTrack1, collision1, fgValuesMuon1, fgValuesMuonPV1);
-        FillPropagation<1>(muonTrack2, collision2, fgValuesMuon1, fgValuesMuonPV2);
-      }
+      auto const& fgValuesMuon1 = dimuonTrack1.muon;
+      auto const& fgValuesMuonPV1 = dimuonTrack1.muonPV;
+      auto const& fgValuesMuon2 = dimuonTrack2.muon;
+      auto const& fgValuesMuonPV2 = dimuonTrack2.muonPV;
 
       int sign1 = muonTrack1.sign();
       int sign2 = muonTrack2.sign();
@@ -2462,63 +2534,24 @@ struct muonQa {
 
       auto const& muonTrack1 = muonTracks.rawIteratorAt(globalTracksVector1[0]);
       auto const& muonTrack2 = muonTracks.rawIteratorAt(globalTracksVector2[0]);
-      auto const& mftTrack1 = muonTrack1.template matchMFTTrack_as<MyMFTs>();
-      auto const& mftTrack2 = muonTrack2.template matchMFTTrack_as<MyMFTs>();
       auto const& mchTrack1 = muonTrack1.template matchMCHTrack_as<MyMuonsWithCov>();
       auto const& mchTrack2 = muonTrack2.template matchMCHTrack_as<MyMuonsWithCov>();
 
-      VarTrack fgValuesMuon1, fgValuesMuonPV1, fgValuesMCH1, fgValuesMCHpv1, fgValuesMFT1, fgValuesMFTpv1;
-      VarTrack fgValuesMuon2, fgValuesMuonPV2, fgValuesMCH2, fgValuesMCHpv2, fgValuesMFT2, fgValuesMFTpv2;
-
-      // Fill MCH and MFT tracks
-      FillTrack<1>(mchTrack1, fgValuesMCH1);
-      FillTrack<0>(mftTrack1, fgValuesMFT1);
-      FillTrack<1>(muonTrack1, fgValuesMuon1);
-      FillTrack<1>(mchTrack2, fgValuesMCH2);
-      FillTrack<0>(mftTrack2, fgValuesMFT2);
-      FillTrack<1>(muonTrack2, fgValuesMuon2);
-
-      //// Fill matching chi2
-      FillMatching(muonTrack1, fgValuesMCH1, fgValuesMFT1);
-      FillMatching(muonTrack2, fgValuesMCH2, fgValuesMFT2);
-
-      mch::Track mchrealigned1, mchrealigned2;
-      VarClusters fgValuesCls1, fgValuesCls2;
-      if (!FillClusters(mchTrack1, clusters, fgValuesCls1, mchrealigned1) || !FillClusters(mchTrack2, clusters, fgValuesCls2, mchrealigned2)) {
+      auto const& globalDimuonTrack1 = GetGlobalDimuonTrack(globalDimuonTracks, muonTracks, globalTracksVector1, collision1, clusters);
+      auto const& globalDimuonTrack2 = GetGlobalDimuonTrack(globalDimuonTracks, muonTracks, globalTracksVector2, collision2, clusters);
+      if (!globalDimuonTrack1.valid || !globalDimuonTrack2.valid) {
         continue; // Refit is not valid
       }
-
-      if (configRealign.fDoRealign) {
-
-        FillTrack(mchrealigned1, fgValuesMCH1);
-        FillTrack(mchrealigned2, fgValuesMCH2);
-
-        // Propagate MCH to PV
-        FillPropagation(mchrealigned1, collision1, fgValuesMCHpv1);
-        FillPropagation(mchrealigned2, collision2, fgValuesMCHpv2);
-
-        // Recalculate pDCA and Rabs values
-        FillPropagation(mchrealigned1, collision1, fgValuesMCH1, kToAbsEnd);
-        FillPropagation(mchrealigned1, collision1, fgValuesMCH1, kToDCA);
-        FillPropagation(mchrealigned2, collision2, fgValuesMCH2, kToAbsEnd);
-        FillPropagation(mchrealigned2, collision2, fgValuesMCH2, kToDCA);
-
-      } else {
-        FillTrack<1>(mchTrack1, fgValuesMCH1);
-        FillTrack<1>(mchTrack2, fgValuesMCH2);
-
-        // Propagate MCH to PV
-        FillPropagation<1>(mchTrack1, collision1, fgValuesMCH1, fgValuesMCHpv1);
-        FillPropagation<1>(mchTrack2, collision2, fgValuesMCH2, fgValuesMCHpv2);
-      }
-
-      // Propagate global muon tracks to PV
-      FillPropagation<0>(muonTrack1, collision1, fgValuesMCH1, fgValuesMuonPV1);
-      FillPropagation<0>(muonTrack2, collision2, fgValuesMCH2, fgValuesMuonPV2);
-
-      // Propagate MFT tracks to PV
-      FillPropagation<0, 1>(mftTrack1, collision1, fgValuesMCH1, fgValuesMFTpv1);
-      FillPropagation<0, 1>(mftTrack2, collision2, fgValuesMCH2, fgValuesMFTpv2);
+      auto const& fgValuesMCH1 = globalDimuonTrack1.mch;
+      auto const& fgValuesMCHpv1 = globalDimuonTrack1.mchPV;
+      auto const& fgValuesMFT1 = globalDimuonTrack1.mft;
+      auto const& fgValuesMuonPV1 = globalDimuonTrack1.muonPV;
+      auto const& fgValuesMFTpv1 = globalDimuonTrack1.mftPV;
+      auto const& fgValuesMCH2 = globalDimuonTrack2.mch;
+      auto const& fgValuesMCHpv2 = globalDimuonTrack2.mchPV;
+      auto const& fgValuesMFT2 = globalDimuonTrack2.mft;
+      auto const& fgValuesMuonPV2 = globalDimuonTrack2.muonPV;
+      auto const& fgValuesMFTpv2 = globalDimuonTrack2.mftPV;
 
       int sign1 = mchTrack1.sign();
       int sign2 = mchTrack2.sign();
@@ -2588,10 +2621,8 @@ struct muonQa {
       // plots for sub-leading matches are only filled in the same-event case
       if (sameEvent) {
         if (globalTracksVector1.size() > 1) {
-          VarTrack fgValuesMuonb1, fgValuesMuonbpv1, fgValuesMFTb1;
-          auto const& muonTrack1b = muonTracks.rawIteratorAt(globalTracksVector1[1]);
-          FillTrack<1>(muonTrack1b, fgValuesMuonb1);
-          FillPropagation<0>(muonTrack1b, collision1, fgValuesMCH1, fgValuesMuonbpv1);
+          VarTrack fgValuesMFTb1;
+          auto const& fgValuesMuonbpv1 = globalDimuonTrack1.subleadingMuonPV;
 
           goodGlobalMuonTracks = (IsGoodGlobalMuon(fgValuesMCH1, fgValuesMCHpv1) && IsGoodGlobalMuon(fgValuesMCH2, fgValuesMCHpv2));
           goodGlobalMuonMatches = (IsGoodGlobalMatching(fgValuesMFTb1) && IsGoodGlobalMatching(fgValuesMFT2));
@@ -2603,10 +2634,8 @@ struct muonQa {
         }
 
         if (globalTracksVector2.size() > 1) {
-          VarTrack fgValuesMuonb2, fgValuesMuonbpv2, fgValuesMFTb2;
-          auto const& muonTrack2b = muonTracks.rawIteratorAt(globalTracksVector2[1]);
-          FillTrack<1>(muonTrack2b, fgValuesMuonb2);
-          FillPropagation<0>(muonTrack2b, collision2, fgValuesMCH2, fgValuesMuonbpv2);
+          VarTrack fgValuesMFTb2;
+          auto const& fgValuesMuonbpv2 = globalDimuonTrack2.subleadingMuonPV;
 
           goodGlobalMuonTracks = (IsGoodGlobalMuon(fgValuesMCH1, fgValuesMCHpv1) && IsGoodGlobalMuon(fgValuesMCH2, fgValuesMCHpv2));
           goodGlobalMuonMatches = (IsGoodGlobalMatching(fgValuesMFTb2) && IsGoodGlobalMatching(fgValuesMFT1));
@@ -2618,16 +2647,9 @@ struct muonQa {
         }
 
         if (globalTracksVector1.size() > 1 && globalTracksVector2.size() > 1) {
-          VarTrack fgValuesMuonb1, fgValuesMuonbpv1, fgValuesMFTb1;
-          VarTrack fgValuesMuonb2, fgValuesMuonbpv2, fgValuesMFTb2;
-          auto const& muonTrack1b = muonTracks.rawIteratorAt(globalTracksVector1[1]);
-          auto const& muonTrack2b = muonTracks.rawIteratorAt(globalTracksVector2[1]);
-
-          FillTrack<1>(muonTrack1b, fgValuesMuonb1);
-          FillPropagation<0>(muonTrack1b, collision1, fgValuesMCH1, fgValuesMuonbpv1);
-
-          FillTrack<1>(muonTrack2b, fgValuesMuonb2);
-          FillPropagation<0>(muonTrack2b, collision2, fgValuesMCH2, fgValuesMuonbpv2);
+          VarTrack fgValuesMFTb1, fgValuesMFTb2;
+          auto const& fgValuesMuonbpv1 = globalDimuonTrack1.subleadingMuonPV;
+          auto const& fgValuesMuonbpv2 = globalDimuonTrack2.subleadingMuonPV;
 
           goodGlobalMuonTracks = (IsGoodGlobalMuon(fgValuesMCH1, fgValuesMCHpv1) && IsGoodGlobalMuon(fgValuesMCH2, fgValuesMCHpv2));
           goodGlobalMuonMatches = (IsGoodGlobalMatching(fgValuesMFTb1) && IsGoodGlobalMatching(fgValuesMFTb2));
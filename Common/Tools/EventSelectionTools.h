@@ -24,6 +24,7 @@
 
 #include "Common/CCDB/EventSelectionParams.h"
 #include "Common/CCDB/TriggerAliases.h"
+#include "Common/Core/CollisionTimeIndex.h"
 #include "Common/DataModel/EventSelection.h"
 
 #include "CCDB/BasicCCDBManager.h"
@@ -603,6 +604,8 @@ class EventSelectionModule
   int rofOffset = -1;     // ITS ROF offset, in bc
   int rofLength = -1;     // ITS ROF length, in bc
 
+  o2::common::core::CollisionTimeIndex collTimeIndex; // collisions of the DF sorted in time, for the occupancy calculation
+
   int32_t findClosest(int64_t globalBC, std::map<int64_t, int32_t>& bcs)
   {
     auto it = bcs.lower_bound(globalBC);
@@ -985,119 +988,25 @@ class EventSelectionModule
       vCollisionsPerBc[vFoundBCindex[colIndex]]++;
     }
 
-    // save indices of collisions for occupancy calculation (both in ROF and in time range)
-    std::vector<std::vector<int>> vCollsInSameITSROF;
-    std::vector<std::vector<int>> vCollsInPrevITSROF;
-    std::vector<std::vector<int>> vCollsInTimeWin;
-    std::vector<std::vector<float>> vTimeDeltaForColls; // delta time wrt a given collision
+    // FT0C amplitude per collision
     for (const auto& col : cols) {
       int32_t colIndex = col.globalIndex();
-      int64_t foundGlobalBC = vFoundGlobalBC[colIndex];
       auto bcselEntr = bcselbuffer[vFoundBCindex[colIndex]];
       if (bcselEntr.foundFT0Id > -1) {
         // required: explicit ft0s table
         auto foundFT0 = ft0s.rawIteratorAt(bcselEntr.foundFT0Id);
         vAmpFT0CperColl[colIndex] = foundFT0.sumAmpC();
       }
-
-      int64_t tfId = (foundGlobalBC - bcSOR) / nBCsPerTF;
-      int64_t rofId = (foundGlobalBC + nBCsPerOrbit - rofOffset) / rofLength;
-
-      // ### for in-ROF occupancy
-      std::vector<int> vAssocCollInSameROF;
-      // find all collisions in the same ROF before a given collision
-      int32_t minColIndex = colIndex - 1;
-      while (minColIndex >= 0) {
-        int64_t thisBC = vFoundGlobalBC[minColIndex];
-        // check if this is still the same TF
-        int64_t thisTFid = (thisBC - bcSOR) / nBCsPerTF;
-        if (thisTFid != tfId)
-          break;
-        // int thisRofIdInTF = (thisBC - rofOffset) / rofLength;
-        int64_t thisRofId = (thisBC + nBCsPerOrbit - rofOffset) / rofLength;
-
-        // check if we are within the same ROF
-        if (thisRofId != rofId)
-          break;
-        vAssocCollInSameROF.push_back(minColIndex);
-        minColIndex--;
-      }
-      // find all collisions in the same ROF after the current one
-      int32_t maxColIndex = colIndex + 1;
-      while (maxColIndex < cols.size()) {
-        int64_t thisBC = vFoundGlobalBC[maxColIndex];
-        int64_t thisTFid = (thisBC - bcSOR) / nBCsPerTF;
-        if (thisTFid != tfId)
-          break;
-        int64_t thisRofId = (thisBC + nBCsPerOrbit - rofOffset) / rofLength;
-        if (thisRofId != rofId)
-          break;
-        vAssocCollInSameROF.push_back(maxColIndex);
-        maxColIndex++;
-      }
-      vCollsInSameITSROF.push_back(vAssocCollInSameROF);
-
-      // ### bookkeep collisions in previous ROF
-      std::vector<int> vAssocCollInPrevROF;
-      minColIndex = colIndex - 1;
-      while (minColIndex >= 0) {
-        int64_t thisBC = vFoundGlobalBC[minColIndex];
-        // check if this is still the same TF
-        int64_t thisTFid = (thisBC - bcSOR) / nBCsPerTF;
-        if (thisTFid != tfId)
-          break;
-        int64_t thisRofId = (thisBC + nBCsPerOrbit - rofOffset) / rofLength;
-        if (thisRofId == rofId - 1)
-          vAssocCollInPrevROF.push_back(minColIndex);
-        else if (thisRofId < rofId - 1)
-          break;
-        minColIndex--;
-      }
-      vCollsInPrevITSROF.push_back(vAssocCollInPrevROF);
-
-      // ### for occupancy in time windows
-      std::vector<int> vAssocToThisCol;
-      std::vector<float> vCollsTimeDeltaWrtGivenColl;
-      // protection against the TF borders
-      if (!vIsFullInfoForOccupancy[colIndex]) {
-        vCollsInTimeWin.push_back(vAssocToThisCol);
-        vTimeDeltaForColls.push_back(vCollsTimeDeltaWrtGivenColl);
-        continue;
-      }
-      // find all collisions in time window before the current one
-      minColIndex = colIndex - 1;
-      while (minColIndex >= 0) {
-        int64_t thisBC = vFoundGlobalBC[minColIndex];
-        // check if this is still the same TF
-        int64_t thisTFid = (thisBC - bcSOR) / nBCsPerTF;
-        if (thisTFid != tfId)
-          break;
-        float dt = (thisBC - foundGlobalBC) * bcNS; // ns
-        // check if we are within the chosen time range
-        if (dt < timeWinOccupancyCalcMinNS)
-          break;
-        vAssocToThisCol.push_back(minColIndex);
-        vCollsTimeDeltaWrtGivenColl.push_back(dt);
-        minColIndex--;
-      }
-      // find all collisions in time window after the current one
-      maxColIndex = colIndex + 1;
-      while (maxColIndex < cols.size()) {
-        int64_t thisBC = vFoundGlobalBC[maxColIndex];
-        int64_t thisTFid = (thisBC - bcSOR) / nBCsPerTF;
-        if (thisTFid != tfId)
-          break;
-        float dt = (thisBC - foundGlobalBC) * bcNS; // ns
-        if (dt > timeWinOccupancyCalcMaxNS)
-          break;
-        vAssocToThisCol.push_back(maxColIndex);
-        vCollsTimeDeltaWrtGivenColl.push_back(dt);
-        maxColIndex++;
-      }
-      vCollsInTimeWin.push_back(vAssocToThisCol);
-      vTimeDeltaForColls.push_back(vCollsTimeDeltaWrtGivenColl);
     }
 
+    // index of collisions in time, the occupancy in ITS ROFs and in time ranges is obtained with binary searches
+    enum { kAmpCutInROF = 0,
+           kAmpCutInTimeRange,
+           kAmpCutInTimeRangeStrict };
+    collTimeIndex.build(vFoundGlobalBC, vTracksITS567perColl, vAmpFT0CperColl, {evselOpts.confFT0CamplCutVetoOnCollInROF, static_cast<float>(evselOpts.confFT0CamplCutVetoOnCollInTimeRange), static_cast<float>(evselOpts.confFT0CamplCutVetoOnCollInTimeRange / 5)});
+    auto getTFid = [&](int64_t thisBC) { return (thisBC - bcSOR) / nBCsPerTF; };
+    auto getRofId = [&](int64_t thisBC) { return (thisBC + nBCsPerOrbit - rofOffset) / rofLength; };
+
     // perform the occupancy calculation per ITS ROF and also in the pre-defined time window
     std::vector<int> vNumTracksITS567inFullTimeWin(cols.size(), 0); // counter of tracks in full time window for occupancy studies (excluding given event)
     std::vector<float> vSumAmpFT0CinFullTimeWin(cols.size(), 0);    // sum of FT0C of tracks in full time window for occupancy studies (excluding given event)
@@ -1114,32 +1023,33 @@ class EventSelectionModule
     for (const auto& col : cols) {
       int32_t colIndex = col.globalIndex();
       float vZ = col.posZ();
+      int64_t foundGlobalBC = vFoundGlobalBC[colIndex];
+      int64_t tfId = getTFid(foundGlobalBC);
+      int64_t rofId = getRofId(foundGlobalBC);
+      int pos = collTimeIndex.position(colIndex); // position of this collision in time order, excluded from all sums
+
+      // only collisions in the same TF are considered
+      int firstInTF = collTimeIndex.partitionPoint([&](int64_t thisBC) { return getTFid(thisBC) < tfId; });
+      int lastInTF = collTimeIndex.partitionPoint([&](int64_t thisBC) { return getTFid(thisBC) <= tfId; });
 
       // ### in-ROF occupancy
-      std::vector<int> vAssocCollInSameROF = vCollsInSameITSROF[colIndex];
-      int nITS567tracksForSameRofVetoStrict = 0;    // to veto events with other collisions in the same ITS ROF
-      int nCollsInRofWithFT0CAboveVetoStandard = 0; // to veto events with other collisions in the same ITS ROF, with per-collision multiplicity above threshold
-      int nITS567tracksForRofVetoOnCloseVz = 0;     // to veto events with nearby collisions with close vZ
-      for (uint32_t iCol = 0; iCol < vAssocCollInSameROF.size(); iCol++) {
-        int thisColIndex = vAssocCollInSameROF[iCol];
-        nITS567tracksForSameRofVetoStrict += vTracksITS567perColl[thisColIndex];
-        if (vAmpFT0CperColl[thisColIndex] > evselOpts.confFT0CamplCutVetoOnCollInROF)
-          nCollsInRofWithFT0CAboveVetoStandard++;
-        if (std::fabs(vCollVz[thisColIndex] - vZ) < evselOpts.confEpsilonVzDiffVetoInROF)
+      int firstInRof = std::max(firstInTF, collTimeIndex.partitionPoint([&](int64_t thisBC) { return getRofId(thisBC) < rofId; }));
+      int lastInRof = std::min(lastInTF, collTimeIndex.partitionPoint([&](int64_t thisBC) { return getRofId(thisBC) <= rofId; }));
+      int nITS567tracksForRofVetoOnCloseVz = 0; // to veto events with nearby collisions with close vZ
+      for (int iPos = firstInRof; iPos < lastInRof; iPos++) {
+        int thisColIndex = collTimeIndex.collisionAt(iPos);
+        if (iPos != pos && std::fabs(vCollVz[thisColIndex] - vZ) < evselOpts.confEpsilonVzDiffVetoInROF)
           nITS567tracksForRofVetoOnCloseVz += vTracksITS567perColl[thisColIndex];
       }
       // in-ROF occupancy flags
-      vNoCollInSameRofStrict[colIndex] = (nITS567tracksForSameRofVetoStrict == 0);
-      vNoCollInSameRofStandard[colIndex] = (nCollsInRofWithFT0CAboveVetoStandard == 0);
+      vNoCollInSameRofStrict[colIndex] = (collTimeIndex.sumTracks(firstInRof, lastInRof, pos) == 0);
+      vNoCollInSameRofStandard[colIndex] = (collTimeIndex.countAmpAbove(kAmpCutInROF, firstInRof, lastInRof, pos) == 0);
       vNoCollInSameRofWithCloseVz[colIndex] = (nITS567tracksForRofVetoOnCloseVz == 0);
 
       // ### occupancy in previous ROF
-      std::vector<int> vAssocCollInPrevROF = vCollsInPrevITSROF[colIndex];
-      float totalFT0amplInPrevROF = 0;
-      for (uint32_t iCol = 0; iCol < vAssocCollInPrevROF.size(); iCol++) {
-        int thisColIndex = vAssocCollInPrevROF[iCol];
-        totalFT0amplInPrevROF += vAmpFT0CperColl[thisColIndex];
-      }
+      int firstInPrevRof = std::max(firstInTF, collTimeIndex.partitionPoint([&](int64_t thisBC) { return getRofId(thisBC) < rofId - 1; }));
+      int lastInPrevRof = std::min(lastInTF, collTimeIndex.partitionPoint([&](int64_t thisBC) { return getRofId(thisBC) < rofId; }));
+      float totalFT0amplInPrevROF = collTimeIndex.sumAmpFT0C(firstInPrevRof, lastInPrevRof);
       // veto events if FT0C amplitude in previous ITS ROF is above threshold
       vNoHighMultCollInPrevRof[colIndex] = (totalFT0amplInPrevROF < evselOpts.confFT0CamplCutVetoOnCollInROF);
 
@@ -1150,20 +1060,28 @@ class EventSelectionModule
         vSumAmpFT0CinFullTimeWin[colIndex] = -1;
         continue;
       }
-      std::vector<int> vAssocToThisCol = vCollsInTimeWin[colIndex];
-      std::vector<float> vCollsTimeDeltaWrtGivenColl = vTimeDeltaForColls[colIndex];
+      // delta time wrt a given collision, in us
+      auto getDeltaTime = [&](int64_t thisBC) -> float {
+        float dt = (thisBC - foundGlobalBC) * bcNS; // ns
+        return dt / 1e3;
+      };
+      // range of collisions with dt in ]dtMin, dtMax[ (or [dtMin, dtMax] if inclusive), within the occupancy time window
+      int firstInWin = std::max(firstInTF, collTimeIndex.partitionPoint([&](int64_t thisBC) { float dt = (thisBC - foundGlobalBC) * bcNS; return dt < timeWinOccupancyCalcMinNS; }));
+      int lastInWin = std::min(lastInTF, collTimeIndex.partitionPoint([&](int64_t thisBC) { float dt = (thisBC - foundGlobalBC) * bcNS; return dt <= timeWinOccupancyCalcMaxNS; }));
+      auto getRangeInWin = [&](float dtMin, float dtMax, bool inclusiveMax = false) {
+        int first = std::max(firstInWin, collTimeIndex.partitionPoint([&](int64_t thisBC) { return getDeltaTime(thisBC) <= dtMin; }));
+        int last = std::min(lastInWin, collTimeIndex.partitionPoint([&](int64_t thisBC) { return inclusiveMax ? getDeltaTime(thisBC) <= dtMax : getDeltaTime(thisBC) < dtMax; }));
+        return std::make_pair(first, std::max(first, last));
+      };
+
       int nITS567tracksInFullTimeWindow = 0;
       float sumAmpFT0CInFullTimeWindow = 0;
-      int nITS567tracksForVetoNarrow = 0;      // to veto events with nearby collisions (narrower range)
-      int nITS567tracksForVetoStrict = 0;      // to veto events with nearby collisions
-      int nCollsWithFT0CAboveVetoStandard = 0; // to veto events with per-collision multiplicity above threshold
-      for (uint32_t iCol = 0; iCol < vAssocToThisCol.size(); iCol++) {
-        int thisColIndex = vAssocToThisCol[iCol];
-        float dt = vCollsTimeDeltaWrtGivenColl[iCol] / 1e3; // ns -> us
-        float wOccup = 1.;
-        if (evselOpts.confUseWeightsForOccupancyVariable) {
-          // weighted occupancy
-          wOccup = 0;
+      if (evselOpts.confUseWeightsForOccupancyVariable) {
+        // weighted occupancy, collisions are added first backwards and then forwards in time wrt a given one
+        auto addWeighted = [&](int iPos) {
+          int thisColIndex = collTimeIndex.collisionAt(iPos);
+          float dt = getDeltaTime(collTimeIndex.globalBCAt(iPos));
+          float wOccup = 0;
           if (dt >= -40 && dt < -5)                     // collisions in the past                    // o2-linter: disable=magic-number (to be checked by Igor)
             wOccup = 1. / 1225 * (dt + 40) * (dt + 40); // o2-linter: disable=magic-number (to be checked by Igor)
           else if (dt >= -5 && dt < 15)                 // collisions near a given one           // o2-linter: disable=magic-number (to be checked by Igor)
@@ -1174,29 +1092,38 @@ class EventSelectionModule
             wOccup = -0.4 / 25 * dt + 1.24;          // o2-linter: disable=magic-number (to be checked by Igor)
           else if (dt >= 40 && dt < 100)             // collisions from the distant future   // o2-linter: disable=magic-number (to be checked by Igor)
             wOccup = -0.4 / 60 * dt + 0.6 + 0.8 / 3; // o2-linter: disable=magic-number (to be checked by Igor)
-        }
-        nITS567tracksInFullTimeWindow += wOccup * vTracksITS567perColl[thisColIndex];
-        sumAmpFT0CInFullTimeWindow += wOccup * vAmpFT0CperColl[thisColIndex];
-
-        // counting tracks from other collisions in fixed time windows
-        if (std::fabs(dt) < evselOpts.confTimeRangeVetoOnCollNarrow)
-          nITS567tracksForVetoNarrow += vTracksITS567perColl[thisColIndex];
-        if (std::fabs(dt) < evselOpts.confTimeRangeVetoOnCollStandard)
-          nITS567tracksForVetoStrict += vTracksITS567perColl[thisColIndex];
-
-        // standard cut on other collisions vs delta-times
-        const float driftV = 2.5;  // drift velocity in cm/us, TPC drift_length / drift_time = 250 cm / 100 us
-        if (std::fabs(dt) < 2.0) { // us, complete veto on other collisions  // o2-linter: disable=magic-number (to be checked by Igor)
-          nCollsWithFT0CAboveVetoStandard++;
-        } else if (dt > -4.0 && dt <= -2.0) { // us, strict veto to suppress fake ITS-TPC matches more  // o2-linter: disable=magic-number (to be checked by Igor)
-          if (vAmpFT0CperColl[thisColIndex] > evselOpts.confFT0CamplCutVetoOnCollInTimeRange / 5)
-            nCollsWithFT0CAboveVetoStandard++;
-        } else if (std::fabs(dt) < 8 + std::fabs(vZ) / driftV) { // loose veto, 8 us corresponds to maximum possible |vZ|, which is ~20 cm  // o2-linter: disable=magic-number (to be checked by Igor)
-          // counting number of other collisions with multiplicity above threshold
-          if (vAmpFT0CperColl[thisColIndex] > evselOpts.confFT0CamplCutVetoOnCollInTimeRange)
-            nCollsWithFT0CAboveVetoStandard++;
-        }
+          nITS567tracksInFullTimeWindow += wOccup * vTracksITS567perColl[thisColIndex];
+          sumAmpFT0CInFullTimeWindow += wOccup * vAmpFT0CperColl[thisColIndex];
+        };
+        int split = std::clamp(pos, firstInWin, lastInWin);
+        for (int iPos = split - 1; iPos >= firstInWin; iPos--)
+          addWeighted(iPos);
+        for (int iPos = split; iPos < lastInWin; iPos++)
+          if (iPos != pos)
+            addWeighted(iPos);
+      } else {
+        nITS567tracksInFullTimeWindow = collTimeIndex.sumTracks(firstInWin, lastInWin, pos);
+        sumAmpFT0CInFullTimeWindow = collTimeIndex.sumAmpFT0C(firstInWin, lastInWin, pos);
       }
+
+      // counting tracks from other collisions in fixed time windows
+      auto [firstVetoNarrow, lastVetoNarrow] = getRangeInWin(-evselOpts.confTimeRangeVetoOnCollNarrow, evselOpts.confTimeRangeVetoOnCollNarrow);
+      auto [firstVetoStrict, lastVetoStrict] = getRangeInWin(-evselOpts.confTimeRangeVetoOnCollStandard, evselOpts.confTimeRangeVetoOnCollStandard);
+      int nITS567tracksForVetoNarrow = collTimeIndex.sumTracks(firstVetoNarrow, lastVetoNarrow, pos); // to veto events with nearby collisions (narrower range)
+      int nITS567tracksForVetoStrict = collTimeIndex.sumTracks(firstVetoStrict, lastVetoStrict, pos); // to veto events with nearby collisions
+
+      // standard cut on other collisions vs delta-times
+      const float driftV = 2.5;                                                           // drift velocity in cm/us, TPC drift_length / drift_time = 250 cm / 100 us
+      const float maxDeltaTimeLooseVeto = 8 + std::fabs(vZ) / driftV;                     // loose veto, 8 us corresponds to maximum possible |vZ|, which is ~20 cm  // o2-linter: disable=magic-number (to be checked by Igor)
+      auto [firstVetoComplete, lastVetoComplete] = getRangeInWin(-2.0, 2.0);              // us, complete veto on other collisions  // o2-linter: disable=magic-number (to be checked by Igor)
+      auto [firstVetoFakeMatches, lastVetoFakeMatches] = getRangeInWin(-4.0, -2.0, true); // us, strict veto to suppress fake ITS-TPC matches more  // o2-linter: disable=magic-number (to be checked by Igor)
+      auto [firstVetoLoose, lastVetoLoose] = getRangeInWin(-maxDeltaTimeLooseVeto, maxDeltaTimeLooseVeto);
+      // counting number of other collisions with multiplicity above threshold
+      int nCollsWithFT0CAboveVetoStandard = collTimeIndex.count(firstVetoComplete, lastVetoComplete, pos);
+      nCollsWithFT0CAboveVetoStandard += collTimeIndex.countAmpAbove(kAmpCutInTimeRangeStrict, firstVetoFakeMatches, lastVetoFakeMatches);
+      nCollsWithFT0CAboveVetoStandard += collTimeIndex.countAmpAbove(kAmpCutInTimeRange, firstVetoLoose, std::max(firstVetoLoose, firstVetoFakeMatches));
+      nCollsWithFT0CAboveVetoStandard += collTimeIndex.countAmpAbove(kAmpCutInTimeRange, lastVetoComplete, std::max(lastVetoComplete, lastVetoLoose));
+
       vNumTracksITS567inFullTimeWin[colIndex] = nITS567tracksInFullTimeWindow; // occupancy by a sum of number of ITS tracks (without a current collision)
       vSumAmpFT0CinFullTimeWin[colIndex] = sumAmpFT0CInFullTimeWindow;         // occupancy by a sum of FT0C amplitudes (without a current collision)
       // occupancy flags based on nearby collisions
@@ -23,10 +23,12 @@
 #include <array>
 #include <string>
 #include <map>
+#include <algorithm>
 #include "Framework/AnalysisDataModel.h"
 #include "Framework/Configurable.h"
 #include "Framework/HistogramSpec.h"
 #include "TableHelper.h"
+#include "Common/Core/PdgLookup.h"
 #include "Common/Core/TPCVDriftManager.h"
 #include "Common/DataModel/Multiplicity.h"
 #include "Common/DataModel/Centrality.h"
@@ -271,6 +273,79 @@ struct multEntry {
   uint16_t spdClustersL1 = 0;
 };
 
+// counting kernel for the barrel track multiplicities: every track only increments the counter of its
+// detector pattern (and of its eta bin if PV contributor), the estimators are reductions over the patterns
+struct barrelTrackCounter {
+  enum detectorBit { kITS = 0x1,
+                     kTPC = 0x2,
+                     kTOF = 0x4,
+                     kTRD = 0x8 };
+  static constexpr int nPatterns = 16;
+  static constexpr int nEtaBins = 4; // |eta| < 0.5, 0.8, 1.0 and above
+
+  std::array<int, nPatterns> nAllTracks{};
+  std::array<int, nPatterns> nContribs{};
+  std::array<int, nEtaBins> nContribsEta{};
+
+  template <typename TTrack>
+  void add(TTrack const& track)
+  {
+    const int pattern = track.hasITS() * kITS | track.hasTPC() * kTPC | track.hasTOF() * kTOF | track.hasTRD() * kTRD;
+    const float absEta = std::abs(track.eta());
+    const int etaBin = !(absEta < 0.5) + !(absEta < 0.8) + !(absEta < 1.0);
+    const int isContributor = track.isPVContributor();
+    nAllTracks[pattern]++;
+    nContribs[pattern] += isContributor;
+    nContribsEta[etaBin] += isContributor;
+  }
+
+  // number of tracks with all the required detectors and none of the vetoed ones
+  static int count(std::array<int, nPatterns> const& counts, int required, int vetoed = 0)
+  {
+    int n = 0;
+    for (int pattern = 0; pattern < nPatterns; pattern++) {
+      n += ((pattern & required) == required && (pattern & vetoed) == 0) ? counts[pattern] : 0;
+    }
+    return n;
+  }
+
+  void fill(multEntry& mults) const
+  {
+    mults.multTPC += count(nAllTracks, kTPC);
+    mults.multAllTracksITSTPC += count(nAllTracks, kITS | kTPC);
+    mults.multAllTracksTPCOnly += count(nAllTracks, kTPC, kITS);
+    mults.multNContribsEtaHalf += nContribsEta[0];
+    mults.multNContribs += nContribsEta[0] + nContribsEta[1];
+    mults.multNContribsEta1 += nContribsEta[0] + nContribsEta[1] + nContribsEta[2];
+    mults.multHasITS += count(nContribs, kITS);
+    mults.multITSTPC += count(nContribs, kITS | kTPC);
+    mults.multITSOnly += count(nContribs, kITS, kTPC | kTOF | kTRD);
+    mults.multHasTPC += count(nContribs, kTPC);
+    mults.multTPCOnly += count(nContribs, kTPC, kITS | kTOF | kTRD);
+    mults.multHasTOF += count(nContribs, kTOF);
+    mults.multHasTRD += count(nContribs, kTRD);
+  }
+};
+
+// eta acceptances of the generated multiplicity estimators, in the order of the MultMCExtras table
+enum mcEtaWindow { kMcFT0A = 0,
+                   kMcFT0C,
+                   kMcFV0A,
+                   kMcFDDA,
+                   kMcFDDC,
+                   kMcBarrelEta05,
+                   kMcBarrelEta08,
+                   kMcBarrelEta10,
+                   kNMcEtaWindows };
+static constexpr std::array<std::array<double, 2>, kNMcEtaWindows> mcEtaWindows{{{3.5, 4.9},
+                                                                                {-3.3, -2.1},
+                                                                                {2.2, 5.0},
+                                                                                {4.7, 6.3},
+                                                                                {-6.9, -4.9},
+                                                                                {-0.5, 0.5},
+                                                                                {-0.8, 0.8},
+                                                                                {-1.0, 1.0}}};
+
 // strangenessBuilder: 1st-order configurables
 struct standardConfigurables : o2::framework::ConfigurableGroup {
   // self-configuration configurables
@@ -331,6 +406,9 @@ class MultModule
   TProfile* hVtxZFDDC;
   TProfile* hVtxZNTracks;
 
+  // charges of the generated particles, cached from the PDG database
+  o2::common::core::PdgLookup pdgLookup;
+
   // declaration of structs here
   // (N.B.: will be invisible to the outside, create your own copies)
   o2::common::multiplicity::standardConfigurables internalOpts;
@@ -377,6 +455,12 @@ class MultModule
     TH1* mhMultSelCalib = nullptr;
     float mMCScalePars[6] = {0.0};
     TFormula* mMCScale = nullptr;
+    // flat copy of mhMultSelCalib, to evaluate the percentiles without TH1 look-ups in the event loop
+    int mNbins = 0;
+    double mMinX = 0.;
+    double mMaxX = 0.;
+    std::vector<double> mBinEdges;   // only for variable bin widths
+    std::vector<float> mPercentiles; // bin contents, including underflow and overflow
     explicit CalibrationInfo(std::string name)
       : name(name),
         mCalibrationStored(false),
@@ -401,6 +485,38 @@ class MultModule
       }
       return true;
     }
+    void compile()
+    {
+      const TAxis* axis = mhMultSelCalib->GetXaxis();
+      mNbins = axis->GetNbins();
+      mMinX = axis->GetXmin();
+      mMaxX = axis->GetXmax();
+      mBinEdges.clear();
+      if (axis->GetXbins()->GetSize() > 0) {
+        mBinEdges.assign(axis->GetXbins()->GetArray(), axis->GetXbins()->GetArray() + axis->GetXbins()->GetSize());
+      }
+      mPercentiles.resize(mNbins + 2);
+      for (int i = 0; i < mNbins + 2; i++) {
+        mPercentiles[i] = mhMultSelCalib->GetBinContent(i);
+      }
+    }
+    // same as mhMultSelCalib->GetBinContent(mhMultSelCalib->FindFixBin(x)), O(1) for uniform bins
+    float getPercentile(double x) const
+    {
+      int bin = mNbins + 1;
+      if (x < mMinX) {
+        bin = 0;
+      } else if (x < mMaxX) {
+        if (mBinEdges.empty()) {
+          bin = 1 + static_cast<int>(mNbins * (x - mMinX) / (mMaxX - mMinX));
+        } else {
+          // as TMath::BinarySearch: last edge below x, or first edge equal to x
+          auto edge = std::lower_bound(mBinEdges.begin(), mBinEdges.end(), x);
+          bin = (edge != mBinEdges.end() && *edge == x) ? edge - mBinEdges.begin() + 1 : edge - mBinEdges.begin();
+        }
+      }
+      return mPercentiles[bin];
+    }
   };
 
   CalibrationInfo fv0aInfo = CalibrationInfo("FV0");
@@ -738,47 +854,9 @@ class MultModule
     // determine if barrel track loop is required, do it (once!) if so but save CPU if not
     if (internalOpts.mEnabledTables[kTPCMults] || internalOpts.mEnabledTables[kPVMults] || internalOpts.mEnabledTables[kMultsExtra] || internalOpts.mEnabledTables[kPVMultZeqs] || internalOpts.mEnabledTables[kMultsGlobal]) {
       // single loop to calculate all
+      barrelTrackCounter barrelCounter;
       for (const auto& track : tracks) {
-        if (track.hasTPC()) {
-          mults.multTPC++;
-          if (track.hasITS()) {
-            mults.multAllTracksITSTPC++; // multsextra
-          } else {
-            mults.multAllTracksTPCOnly++; // multsextra
-          }
-        }
-        // PV contributor checked explicitly
-        if (track.isPVContributor()) {
-          if (std::abs(track.eta()) < 1.0) {
-            mults.multNContribsEta1++; // pvmults
-            if (std::abs(track.eta()) < 0.8) {
-              mults.multNContribs++; // pvmults
-              if (std::abs(track.eta()) < 0.5) {
-                mults.multNContribsEtaHalf++; // pvmults
-              }
-            }
-          }
-          if (track.hasITS()) {
-            mults.multHasITS++; // multsextra
-            if (track.hasTPC())
-              mults.multITSTPC++; // multsextra
-            if (!track.hasTPC() && !track.hasTOF() && !track.hasTRD()) {
-              mults.multITSOnly++; // multsextra
-            }
-          }
-          if (track.hasTPC()) {
-            mults.multHasTPC++; // multsextra
-            if (!track.hasITS() && !track.hasTOF() && !track.hasTRD()) {
-              mults.multTPCOnly++; // multsextra
-            }
-          }
-          if (track.hasTOF()) {
-            mults.multHasTOF++; // multsextra
-          }
-          if (track.hasTRD()) {
-            mults.multHasTRD++; // multsextra
-          }
-        }
+        barrelCounter.add(track);
 
         // global counters: do them only in case information is provided in tracks table
         if constexpr (requires { tracks.isQualityTrack(); }) {
@@ -802,6 +880,7 @@ class MultModule
           }
         } // end constexpr requires track selection stuff
       }
+      barrelCounter.fill(mults);
 
       cursors.multsGlobal(mults.multGlobalTracks, mults.multNbrContribsEta08GlobalTrackWoDCA, mults.multNbrContribsEta10GlobalTrackWoDCA, mults.multNbrContribsEta05GlobalTrackWoDCA);
     }
@@ -840,49 +919,25 @@ class MultModule
   template <typename TMCCollision, typename TMCParticles, typename TPDGService, typename TOutputGroup>
   void collisionProcessMonteCarlo(TMCCollision const& mccollision, TMCParticles const& mcparticles, TPDGService const& pdg, TOutputGroup& cursors)
   {
-    int multFT0A = 0;
-    int multFV0A = 0;
-    int multFT0C = 0;
-    int multFDDA = 0;
-    int multFDDC = 0;
-    int multBarrelEta05 = 0;
-    int multBarrelEta08 = 0;
-    int multBarrelEta10 = 0;
+    std::array<int, kNMcEtaWindows> mcMults{};
     for (auto const& mcPart : mcparticles) {
       if (!mcPart.isPhysicalPrimary()) {
         continue;
       }
 
-      auto charge = 0.;
-      auto* p = pdg->GetParticle(mcPart.pdgCode());
-      if (p != nullptr) {
-        charge = p->Charge();
+      if (!pdgLookup.hasDatabase()) {
+        pdgLookup.setDatabase(pdg);
       }
-      if (std::abs(charge) < 1e-3) {
+      if (std::abs(pdgLookup.charge(mcPart.pdgCode())) < 1e-3) {
         continue; // reject neutral particles in counters
       }
 
-      if (std::abs(mcPart.eta()) < 1.0) {
-        multBarrelEta10++;
-        if (std::abs(mcPart.eta()) < 0.8) {
-          multBarrelEta08++;
-          if (std::abs(mcPart.eta()) < 0.5) {
-            multBarrelEta05++;
-          }
-        }
+      const double eta = mcPart.eta();
+      for (int iWindow = 0; iWindow < kNMcEtaWindows; iWindow++) {
+        mcMults[iWindow] += (mcEtaWindows[iWindow][0] < eta && eta < mcEtaWindows[iWindow][1]);
       }
-      if (-3.3 < mcPart.eta() && mcPart.eta() < -2.1)
-        multFT0C++;
-      if (3.5 < mcPart.eta() && mcPart.eta() < 4.9)
-        multFT0A++;
-      if (2.2 < mcPart.eta() && mcPart.eta() < 5.0)
-        multFV0A++;
-      if (-6.9 < mcPart.eta() && mcPart.eta() < -4.9)
-        multFDDC++;
-      if (4.7 < mcPart.eta() && mcPart.eta() < 6.3)
-        multFDDA++;
     }
-    cursors.tableExtraMc(multFT0A, multFT0C, multFV0A, multFDDA, multFDDC, multBarrelEta05, multBarrelEta08, multBarrelEta10, mccollision.posZ());
+    cursors.tableExtraMc(mcMults[kMcFT0A], mcMults[kMcFT0C], mcMults[kMcFV0A], mcMults[kMcFDDA], mcMults[kMcFDDC], mcMults[kMcBarrelEta05], mcMults[kMcBarrelEta08], mcMults[kMcBarrelEta10], mccollision.posZ());
   }
 
   //__________________________________________________
@@ -1111,6 +1166,7 @@ class MultModule
             }
             estimator.mCalibrationStored = true;
             estimator.isSane();
+            estimator.compile();
           } else {
             LOGF(info, "Calibration information from %s for run %d not available, will fill this estimator with invalid values and continue (no crash).", estimator.name.c_str(), bc.runNumber());
           }
@@ -1180,7 +1236,7 @@ class MultModule
             scaledMultiplicity = scaleMC(multiplicity, estimator.mMCScalePars);
             LOGF(debug, "Unscaled %s multiplicity: %f, scaled %s multiplicity: %f", estimator.name.c_str(), multiplicity, estimator.name.c_str(), scaledMultiplicity);
           }
-          percentile = estimator.mhMultSelCalib->GetBinContent(estimator.mhMultSelCalib->FindFixBin(scaledMultiplicity));
+          percentile = estimator.getPercentile(scaledMultiplicity);
           if (assignOutOfRange)
             percentile = 100.5f;
         }
@@ -27,6 +27,8 @@
 #include "TArrayF.h"
 #include "multCalibrator.h"
 
+#include <algorithm>
+
 using namespace std;
 
 const TString multCalibrator::fCentEstimName[kNCentEstim] = {
@@ -42,7 +44,11 @@ multCalibrator::multCalibrator() : TNamed(),
                                    fAnchorPointValue(-1),
                                    fAnchorPointPercentage(100),
                                    fCalibHists(0x0),
-                                   fPrecisionHistogram(0x0)
+                                   fPrecisionHistogram(0x0),
+                                   fCumulativeHisto(0x0),
+                                   fCumulativeFirstBin(1),
+                                   fCumulativeTotal(0),
+                                   fCumulativeRawMax(0)
 {
   // Constructor
   // Make sure the TList owns its objects
@@ -59,7 +65,11 @@ multCalibrator::multCalibrator(const char* name, const char* title) : TNamed(nam
                                                                       fAnchorPointValue(-1),
                                                                       fAnchorPointPercentage(90),
                                                                       fCalibHists(0x0),
-                                                                      fPrecisionHistogram(0x0)
+                                                                      fPrecisionHistogram(0x0),
+                                                                      fCumulativeHisto(0x0),
+                                                                      fCumulativeFirstBin(1),
+                                                                      fCumulativeTotal(0),
+                                                                      fCumulativeRawMax(0)
 {
   // Named Constructor
   // Make sure the TList owns its objects
@@ -149,12 +159,47 @@ Double_t multCalibrator::GetBoundaryForPercentile(TH1* histo, Double_t lPercenti
   //that corresponds to those bins. If this percentage is O(percentile bin
   //width requested), then the user should worry and we print out a warning.
 
-  const Double_t lPrecisionConstant = 2.0;
+  PrepareCumulative(histo);
+  Double_t lReturnValue = GetBoundaryFromCumulative(lPercentileRequested, lPrecisionEstimate);
+  fCumulativeHisto = 0x0;
+  return lReturnValue;
+}
+
+//________________________________________________________________
+void multCalibrator::PrepareCumulative(TH1* histo)
+{
+  //Counts summed bin by bin from the first bin, as when searching for a boundary,
+  //so that all the boundaries of a histogram are found with a binary search
+  fCumulativeHisto = histo;
+  fCumulativeRawMax = GetRawMax(histo);
+  Double_t lCount = 0;
+
+  // Anchor point changes: if anchored, start at the first bin that includes that
+  fCumulativeFirstBin = 1;
+  fCumulativeTotal = histo->Integral(1, histo->GetNbinsX()); // histo->GetEntries();
+  if (fAnchorPointValue > 0) {
+    fCumulativeFirstBin = histo->FindBin(fAnchorPointValue + 1e-6);
+    Double_t lAbove = histo->Integral(fCumulativeFirstBin, histo->GetNbinsX());
+    fCumulativeTotal = lAbove * 100.0 / (fAnchorPointPercentage);
+    lCount = fCumulativeTotal - lAbove; // the relevant anchored-out part
+  }
+
+  const Long_t lNBins = histo->GetNbinsX();
+  fCumulative.assign(std::max(lNBins, fCumulativeFirstBin), 0.0);
+  for (Long_t ibin = fCumulativeFirstBin; ibin < lNBins; ibin++) {
+    lCount += histo->GetBinContent(ibin);
+    fCumulative[ibin] = lCount;
+  }
+}
 
-  Double_t lRawMax = GetRawMax(histo);
+//________________________________________________________________
+Double_t multCalibrator::GetBoundaryFromCumulative(Double_t lPercentileRequested, Double_t& lPrecisionEstimate)
+{
+  const Double_t lPrecisionConstant = 2.0;
+  TH1* histo = fCumulativeHisto;
 
   if (lPercentileRequested < 1e-7)
-    return lRawMax; //safeguard
+    return fCumulativeRawMax; //safeguard
   if (lPercentileRequested > 100 - 1e-7)
     return 0.0; //safeguard
 
@@ -164,35 +209,24 @@ Double_t multCalibrator::GetBoundaryForPercentile(TH1* histo, Double_t lPercenti
   lPrecisionEstimate = -1;
   if (lPercentile < lPercentileAnchor + 1e-7)
     return fAnchorPointValue;
-  Double_t lCount = 0;
 
-  // Anchor point changes: if anchored, start at the first bin that includes that
-  Long_t lFirstBin = 1;
-  Double_t lHadronicTotal = histo->Integral(1, histo->GetNbinsX()); // histo->GetEntries();
-  if (fAnchorPointValue > 0) {
-    lFirstBin = histo->FindBin(fAnchorPointValue + 1e-6);
-    Double_t lAbove = histo->Integral(lFirstBin, histo->GetNbinsX());
-    lHadronicTotal = lAbove * 100.0 / (fAnchorPointPercentage);
-    lCount = lHadronicTotal - lAbove; // the relevant anchored-out part
-  }
-
-  const Long_t lNBins = histo->GetNbinsX();
+  const Double_t lHadronicTotal = fCumulativeTotal;
   Double_t lCountDesired = lPercentile * lHadronicTotal / 100;
 
-  for (Long_t ibin = lFirstBin; ibin < lNBins; ibin++) {
-    lCount += histo->GetBinContent(ibin);
-    if (lCount >= lCountDesired) {
-      //Found bin I am looking for!
-      Double_t lWidth = histo->GetBinWidth(ibin);
-      Double_t lLeftPercentile = 100. * (lCount - histo->GetBinContent(ibin)) / lHadronicTotal;
-      Double_t lRightPercentile = 100. * lCount / lHadronicTotal;
-      lPrecisionEstimate = (lRightPercentile - lLeftPercentile) / lPrecisionConstant;
+  //First bin reaching the desired count
+  auto lFound = std::lower_bound(fCumulative.begin() + fCumulativeFirstBin, fCumulative.end(), lCountDesired);
+  if (lFound != fCumulative.end()) {
+    //Found bin I am looking for!
+    Long_t ibin = lFound - fCumulative.begin();
+    Double_t lCount = *lFound;
+    Double_t lWidth = histo->GetBinWidth(ibin);
+    Double_t lLeftPercentile = 100. * (lCount - histo->GetBinContent(ibin)) / lHadronicTotal;
+    Double_t lRightPercentile = 100. * lCount / lHadronicTotal;
+    lPrecisionEstimate = (lRightPercentile - lLeftPercentile) / lPrecisionConstant;
 
-      Double_t lProportion = (lPercentile - lLeftPercentile) / (lRightPercentile - lLeftPercentile);
+    Double_t lProportion = (lPercentile - lLeftPercentile) / (lRightPercentile - lLeftPercentile);
 
-      lReturnValue = histo->GetBinLowEdge(ibin) + lProportion * lWidth;
-      break;
-    }
+    lReturnValue = histo->GetBinLowEdge(ibin) + lProportion * lWidth;
   }
   return lReturnValue;
 }
@@ -269,11 +303,12 @@ TH1F* multCalibrator::GetCalibrationHistogram(TH1* histoRaw, TString lHistoName)
     lBounds[0] = 0;
   }
 
+  PrepareCumulative(histoRaw);
   for (Int_t ii = 0; ii < lNDesiredBoundaries; ii++) {
     Int_t lDisplacedii = ii;
     if (fAnchorPointValue > 0)
       lDisplacedii++;
-    lBounds[lDisplacedii] = GetBoundaryForPercentile(histoRaw, lDesiredBoundaries[ii], lPrecision[ii]);
+    lBounds[lDisplacedii] = GetBoundaryFromCumulative(lDesiredBoundaries[ii], lPrecision[ii]);
     TString lPrecisionString = "(Precision OK)";
     if (ii != 0 && ii != lNDesiredBoundaries - 1) {
       //check precision, please
@@ -284,6 +319,7 @@ TH1F* multCalibrator::GetCalibrationHistogram(TH1* histoRaw, TString lHistoName)
     }
     cout << histoRaw->GetName() << " boundaries, percentile: " << lDesiredBoundaries[ii] << "%\t Signal value = " << lBounds[lDisplacedii] << "\tprecision = " << lPrecision[ii] << "% " << lPrecisionString.Data() << endl;
   }
+  fCumulativeHisto = 0x0;
   TH1F* hCalib = new TH1F(lHistoName.Data(), "", fAnchorPointValue < 0 ? lNDesiredBoundaries - 1 : lNDesiredBoundaries, lBounds);
   hCalib->SetDirectory(0);
   hCalib->SetBinContent(0, 100.5);
@@ -21,6 +21,7 @@
 
 #include <iostream>
 #include <map>
+#include <vector>
 
 #include "TNamed.h"
 #include "TH1D.h"
@@ -107,6 +108,15 @@ class multCalibrator : public TNamed
 
   TH1D* fPrecisionHistogram; //for bookkeeping of precision report
 
+  //Cumulative counts of the histogram being calibrated, computed once for all its boundaries
+  void PrepareCumulative(TH1* histo);
+  Double_t GetBoundaryFromCumulative(Double_t lPercentileRequested, Double_t& lPrecisionEstimate);
+  TH1* fCumulativeHisto;             //! histogram of the cumulative counts
+  std::vector<Double_t> fCumulative; //! counts up to each bin, starting at the anchored-out part
+  Long_t fCumulativeFirstBin;        //! first bin after the anchor point
+  Double_t fCumulativeTotal;         //! hadronic total
+  Double_t fCumulativeRawMax;        //! GetRawMax of the histogram
+
   ClassDef(multCalibrator, 1);
   //(this classdef is only for bookkeeping, class will not usually
   // be streamed according to current workflow except in very specific
@@ -34,6 +34,8 @@
 #include "TProfile.h"
 #include "TFitResult.h"
 
+#include <utility>
+
 using namespace std;
 
 ClassImp(multGlauberNBDFitter);
@@ -56,7 +58,9 @@ multGlauberNBDFitter::multGlauberNBDFitter() : TNamed(),
                                                ff(0.8),
                                                fnorm(100),
                                                fFitOptions("R0"),
-                                               fFitNpx(5000)
+                                               fFitNpx(5000),
+                                               fUseCache(kTRUE),
+                                               fCacheValid(kFALSE)
 {
   // Constructor
   fNpart = new Double_t[fMaxNpNcPairs];
@@ -103,7 +107,9 @@ multGlauberNBDFitter::multGlauberNBDFitter(const char* name, const char* title)
                                                                                   ff(0.8),
                                                                                   fnorm(100),
                                                                                   fFitOptions("R0"),
-                                                                                  fFitNpx(5000)
+                                                                                  fFitNpx(5000),
+                                                                                  fUseCache(kTRUE),
+                                                                                  fCacheValid(kFALSE)
 {
   //Named constructor
   fNpart = new Double_t[fMaxNpNcPairs];
@@ -160,7 +166,6 @@ Double_t multGlauberNBDFitter::ProbDistrib(Double_t* x, Double_t* par)
 //Master fitter function
 {
   Double_t lMultValue = x[0];
-  Double_t lProbability = 0.0;
   ffChanged = kTRUE;
   const Double_t lAlmost0 = 1.e-13;
   //Comment this line in order to make the code evaluate Nancestor all the time
@@ -171,6 +176,7 @@ Double_t multGlauberNBDFitter::ProbDistrib(Double_t* x, Double_t* par)
   //Recalculate the ancestor distribution in case f changed
   if (ffChanged) {
     fCurrentf = par[2];
+    fCacheValid = kFALSE;
     fhNanc->Reset();
 
     for (int ibin = 0; ibin < fNNpNcPairs; ibin++) {
@@ -192,6 +198,21 @@ Double_t multGlauberNBDFitter::ProbDistrib(Double_t* x, Double_t* par)
     fhNanc->Scale(1. / fhNanc->Integral());
   }
   //______________________________________________________
+  //Read the tabulated function if possible
+  if (fUseCache && lMultValue > 1e-6 && UpdateCache(par)) {
+    Double_t lIndex = TMath::Floor(lMultValue);
+    Int_t lTable = GetCacheTable(fAncestorMode != 2 ? 0.0 : lMultValue - lIndex);
+    if (lTable >= 0 && lIndex < fCacheTables[lTable].size())
+      return par[3] * fCacheTables[lTable][(Long_t)lIndex];
+  }
+  return par[3] * SumNBDsDirect(lMultValue, par);
+}
+
+//______________________________________________________
+Double_t multGlauberNBDFitter::SumNBDsDirect(Double_t lMultValue, const Double_t* par)
+{
+  Double_t lProbability = 0.0;
+  //______________________________________________________
   //Actually evaluate function
   Int_t lStartBin = fhNanc->FindBin(0.0) + 1;
   for (Long_t iNanc = lStartBin; iNanc < fhNanc->GetNbinsX() + 1; iNanc++) {
@@ -210,8 +231,84 @@ Double_t multGlauberNBDFitter::ProbDistrib(Double_t* x, Double_t* par)
       lMult = fAncestorMode != 2 ? fNBD->Eval(lMultValue) : ContinuousNBD(lMultValue, lThisMu, lThisk);
     lProbability += lNancestorCount * lMult;
   }
-  //______________________________________________________
-  return par[3] * lProbability;
+  return lProbability;
+}
+
+//______________________________________________________
+Bool_t multGlauberNBDFitter::UpdateCache(const Double_t* par)
+{
+  if (fCacheValid && par[0] == fCachePar[0] && par[1] == fCachePar[1] && par[4] == fCachePar[2])
+    return kTRUE;
+
+  fCacheValid = kFALSE;
+  fCacheMu.clear();
+  fCacheK.clear();
+  fCacheContent.clear();
+  fCacheOffsets.clear();
+  fCacheTables.clear();
+  Int_t lStartBin = fhNanc->FindBin(0.0) + 1;
+  for (Long_t iNanc = lStartBin; iNanc < fhNanc->GetNbinsX() + 1; iNanc++) {
+    Double_t lNancestorCount = fhNanc->GetBinContent(iNanc);
+    if (lNancestorCount == 0)
+      continue;
+    Double_t lNancestors = fhNanc->GetBinCenter(iNanc);
+    Double_t lThisMu = lNancestors * (par[0] + par[4] * lNancestors);
+    Double_t lThisk = lNancestors * par[1];
+    //No recurrence for unphysical parameters: use the direct evaluation
+    if (!(lThisMu > 0 && lThisk > 0))
+      return kFALSE;
+    fCacheMu.push_back(lThisMu);
+    fCacheK.push_back(lThisk);
+    fCacheContent.push_back(lNancestorCount);
+  }
+  fCachePar[0] = par[0];
+  fCachePar[1] = par[1];
+  fCachePar[2] = par[4];
+  fCacheValid = kTRUE;
+  return kTRUE;
+}
+
+//______________________________________________________
+Int_t multGlauberNBDFitter::GetCacheTable(Double_t lOffset)
+{
+  //Few offsets are used in a fit (bin centres), the other ones (e.g. drawing) are evaluated directly
+  const size_t lMaxTables = 4;
+  const Double_t lMinProbability = 1.e-300;
+  for (size_t iTable = 0; iTable < fCacheOffsets.size(); iTable++) {
+    if (TMath::Abs(fCacheOffsets[iTable] - lOffset) < 1.e-9)
+      return iTable;
+  }
+  if (fCacheOffsets.size() >= lMaxTables)
+    return -1;
+
+  const Long_t lMaxIndex = (Long_t)TMath::Floor(fGlauberNBD->GetXmax()) + 1;
+  std::vector<Double_t> lTable(lMaxIndex + 1, 0.0);
+  for (size_t iAnc = 0; iAnc < fCacheMu.size(); iAnc++) {
+    const Double_t lThisMu = fCacheMu[iAnc];
+    const Double_t lThisk = fCacheK[iAnc];
+    const Double_t lNancestorCount = fCacheContent[iAnc];
+    const Double_t lRatio = lThisMu / (lThisMu + lThisk);
+    //Start from the mean, close to the maximum, and go down both tails until the NBD vanishes
+    const Long_t lStart = TMath::Min(lMaxIndex, TMath::Max(0L, (Long_t)TMath::Floor(lThisMu - lOffset)));
+    const Double_t lStartProbability = ContinuousNBD(lOffset + lStart, lThisMu, lThisk);
+    Double_t lMult = lStartProbability;
+    for (Long_t j = lStart; j <= lMaxIndex && lMult > lMinProbability; j++) {
+      lTable[j] += lNancestorCount * lMult;
+      Double_t n = lOffset + j;
+      lMult *= (n + lThisk) / (n + 1.) * lRatio;
+    }
+    lMult = lStartProbability;
+    for (Long_t j = lStart - 1; j >= 0; j--) {
+      Double_t n = lOffset + j;
+      lMult *= (n + 1.) / ((n + lThisk) * lRatio);
+      if (lMult < lMinProbability)
+        break;
+      lTable[j] += lNancestorCount * lMult;
+    }
+  }
+  fCacheOffsets.push_back(lOffset);
+  fCacheTables.push_back(std::move(lTable));
+  return fCacheOffsets.size() - 1;
 }
 
 //________________________________________________________________
@@ -13,6 +13,7 @@
 #define MULTGLAUBERNBDFITTER_H
 
 #include <iostream>
+#include <vector>
 #include "TNamed.h"
 #include "TF1.h"
 #include "TH1.h"
@@ -71,6 +72,9 @@ class multGlauberNBDFitter : public TNamed
   void SetFitOptions(TString lOpt);
   void SetFitNpx(Long_t lNpx);
 
+  //Tabulation of the NBDs summed over the ancestors, on by default
+  void SetUseCache(Bool_t lUseCache = kTRUE) { fUseCache = lUseCache; }
+
   //For ancestor mode 2
   Double_t ContinuousNBD(Double_t n, Double_t mu, Double_t k);
 
@@ -115,6 +119,21 @@ class multGlauberNBDFitter : public TNamed
   TString fFitOptions;
   Long_t fFitNpx;
 
+  //Memoisation of the fit function: for a set of (mu, k, f, dMu/dNanc), the NBDs of the
+  //ancestors are summed once on a grid of multiplicities offset + j, j = 0 ... xmax,
+  //using the recurrence P(n + 1) = P(n) (n + k) / (n + 1) mu / (mu + k) from the mode of each NBD
+  Double_t SumNBDsDirect(Double_t lMultValue, const Double_t* par);
+  Bool_t UpdateCache(const Double_t* par);
+  Int_t GetCacheTable(Double_t lOffset);
+  Bool_t fUseCache;                                //!
+  Bool_t fCacheValid;                              //!
+  Double_t fCachePar[3];                           //! mu, k, dMu/dNanc of the cache
+  std::vector<Double_t> fCacheMu;                  //! NBD mu of the non-empty ancestor bins
+  std::vector<Double_t> fCacheK;                   //! NBD k of the non-empty ancestor bins
+  std::vector<Double_t> fCacheContent;             //! normalised content of the non-empty ancestor bins
+  std::vector<Double_t> fCacheOffsets;             //! offsets of the tables
+  std::vector<std::vector<Double_t>> fCacheTables; //! sum of the NBDs at offset + j
+
   ClassDef(multGlauberNBDFitter, 1);
 };
 #endif
@@ -20,6 +20,7 @@
 #include <cstdlib>
 #include <cmath>
 #include <array>
+#include <unordered_map>
 #include "Framework/AnalysisDataModel.h"
 
 //__________________________________________
@@ -76,10 +77,16 @@ class StandardCCDBLoader
       return;
     }
 
-    // load matLUT for this timestamp
+    // load matLUT for this timestamp, unless another loader of this process did it already
     if (!lut) {
-      LOG(info) << "Loading material look-up table for timestamp: " << currentRunNumber;
-      lut = o2::base::MatLayerCylSet::rectifyPtrFromFile(ccdb->template getForRun<o2::base::MatLayerCylSet>(cGroup.lutPath.value, currentRunNumber));
+      auto& processLut = sharedLut(cGroup.lutPath.value);
+      if (!processLut) {
+        LOG(info) << "Loading material look-up table for timestamp: " << currentRunNumber;
+        processLut = o2::base::MatLayerCylSet::rectifyPtrFromFile(ccdb->template getForRun<o2::base::MatLayerCylSet>(cGroup.lutPath.value, currentRunNumber));
+      } else {
+        LOG(info) << "Material look-up table already loaded in this process. Not reloading.";
+      }
+      lut = processLut;
     } else {
       LOG(info) << "Material look-up table already in place. Not reloading.";
     }
@@ -98,6 +105,15 @@ class StandardCCDBLoader
 
     runNumber = currentRunNumber;
   }
+
+ private:
+  // rectified material LUTs per CCDB path, shared by all the loaders of the process.
+  // The GRPMagField and MeanVertexObject are already cached per run by the CCDB manager.
+  static o2::base::MatLayerCylSet*& sharedLut(std::string const& path)
+  {
+    static std::unordered_map<std::string, o2::base::MatLayerCylSet*> luts;
+    return luts[path];
+  }
 };
 
 } // namespace common
@@ -16,11 +16,15 @@
 #ifndef COMMON_TOOLS_TRACKPROPAGATIONMODULE_H_
 #define COMMON_TOOLS_TRACKPROPAGATIONMODULE_H_
 
+#include <algorithm>
 #include <memory>
 #include <cstdlib>
 #include <cmath>
 #include <array>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 #include "Framework/AnalysisDataModel.h"
 #include "Framework/Configurable.h"
 #include "Framework/HistogramSpec.h"
@@ -55,6 +59,7 @@ struct TrackPropagationProducts : o2::framework::ProducesGroup {
 struct TrackPropagationConfigurables : o2::framework::ConfigurableGroup {
   std::string prefix = "trackPropagation";
   o2::framework::Configurable<float> minPropagationRadius{"minPropagationDistance", o2::constants::geom::XTPCInnerRef + 0.1, "Only tracks which are at a smaller radius will be propagated, defaults to TPC inner wall"};
+  o2::framework::Configurable<bool> fillPropagationCache{"fillPropagationCache", false, "Keep the propagated tracks of the DF in a cache that can be queried for other collisions in the same task (requires the covariance tables)"};
   // for TrackTuner only (MC smearing)
   o2::framework::Configurable<bool> useTrackTuner{"useTrackTuner", false, "Apply track tuner corrections to MC"};
   o2::framework::Configurable<bool> useTrkPid{"useTrkPid", false, "use pid in tracking"};
@@ -64,6 +69,94 @@ struct TrackPropagationConfigurables : o2::framework::ConfigurableGroup {
   o2::framework::ConfigurableAxis axisPtQA{"axisPtQA", {o2::framework::VARIABLE_WIDTH, 0.0f, 0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f, 0.7f, 0.8f, 0.9f, 1.0f, 1.1f, 1.2f, 1.3f, 1.4f, 1.5f, 1.6f, 1.7f, 1.8f, 1.9f, 2.0f, 2.2f, 2.4f, 2.6f, 2.8f, 3.0f, 3.2f, 3.4f, 3.6f, 3.8f, 4.0f, 4.4f, 4.8f, 5.2f, 5.6f, 6.0f, 6.5f, 7.0f, 7.5f, 8.0f, 9.0f, 10.0f, 11.0f, 12.0f, 13.0f, 14.0f, 15.0f, 17.0f, 19.0f, 21.0f, 23.0f, 25.0f, 30.0f, 35.0f, 40.0f, 50.0f}, "pt axis for QA histograms"};
 };
 
+//__________________________________________
+// cache of tracks propagated to collision vertices
+//
+// keyed by (track global index, collision global index), it keeps the
+// propagated parameters and DCAs of the current DF so that consumers in
+// the same task (e.g. ambiguous-track or alternative-collision studies)
+// do not propagate the same pair twice. Misses are propagated lazily,
+// lists of pairs can be propagated at once with propagateBatch.
+
+struct PropagatedTrack {
+  o2::track::TrackParametrizationWithError<float> trackParCov;
+  o2::dataformats::DCA dcaInfo;
+  bool isPropagated = false; // false if the track was not propagated (outside the propagation radius or failed propagation)
+};
+
+class TrackPropagationCache
+{
+ public:
+  float minPropagationRadius = o2::constants::geom::XTPCInnerRef + 0.1;
+  o2::base::Propagator::MatCorrType matCorr = o2::base::Propagator::MatCorrType::USEMatCorrLUT;
+
+  // to be called at the beginning of each DF
+  void clear() { mCache.clear(); }
+  void reserve(std::size_t nEntries) { mCache.reserve(nEntries); }
+  std::size_t size() const { return mCache.size(); }
+
+  static uint64_t key(int64_t trackId, int64_t collisionId)
+  {
+    return (static_cast<uint64_t>(trackId) << 32) | static_cast<uint32_t>(collisionId);
+  }
+
+  // store the result of a propagation done elsewhere (e.g. in fillTrackTables)
+  void insert(int64_t trackId, int64_t collisionId, o2::track::TrackParametrizationWithError<float> const& trackParCov, o2::dataformats::DCA const& dcaInfo, bool isPropagated)
+  {
+    mCache[key(trackId, collisionId)] = {trackParCov, dcaInfo, isPropagated};
+  }
+
+  // look up a propagated track, nullptr if the pair was not propagated yet
+  PropagatedTrack const* find(int64_t trackId, int64_t collisionId) const
+  {
+    auto it = mCache.find(key(trackId, collisionId));
+    return it == mCache.end() ? nullptr : &it->second;
+  }
+
+  // propagated track to the vertex of the collision, propagating it if not in the cache
+  template <typename TTrack, typename TCollision>
+  PropagatedTrack const& get(TTrack const& track, TCollision const& collision)
+  {
+    auto [it, isNew] = mCache.try_emplace(key(track.globalIndex(), collision.globalIndex()));
+    if (isNew) {
+      propagate(track, collision, it->second);
+    }
+    return it->second;
+  }
+
+  // propagate a list of (track, collision) global index pairs, e.g. all the compatible collisions of the ambiguous tracks
+  template <typename TTracks, typename TCollisions>
+  void propagateBatch(std::vector<std::pair<int64_t, int64_t>> trackCollisionPairs, TTracks const& tracks, TCollisions const& collisions)
+  {
+    std::sort(trackCollisionPairs.begin(), trackCollisionPairs.end()); // visit the tracks in table order
+    trackCollisionPairs.erase(std::unique(trackCollisionPairs.begin(), trackCollisionPairs.end()), trackCollisionPairs.end());
+    mCache.reserve(mCache.size() + trackCollisionPairs.size());
+    for (auto const& [trackId, collisionId] : trackCollisionPairs) {
+      auto [it, isNew] = mCache.try_emplace(key(trackId, collisionId));
+      if (isNew) {
+        propagate(tracks.rawIteratorAt(trackId), collisions.rawIteratorAt(collisionId), it->second);
+      }
+    }
+  }
+
+ private:
+  template <typename TTrack, typename TCollision>
+  void propagate(TTrack const& track, TCollision const& collision, PropagatedTrack& result)
+  {
+    setTrackParCov(track, result.trackParCov);
+    result.dcaInfo.set(999, 999, 999, 999, 999);
+    result.isPropagated = false;
+    if (track.trackType() == o2::aod::track::TrackIU && track.x() < minPropagationRadius) {
+      mVtx.setPos({collision.posX(), collision.posY(), collision.posZ()});
+      mVtx.setCov(collision.covXX(), collision.covXY(), collision.covYY(), collision.covXZ(), collision.covYZ(), collision.covZZ());
+      result.isPropagated = o2::base::Propagator::Instance()->propagateToDCABxByBz(mVtx, result.trackParCov, 2.f, matCorr, &result.dcaInfo);
+    }
+  }
+
+  o2::dataformats::VertexBase mVtx;
+  std::unordered_map<uint64_t, PropagatedTrack> mCache;
+};
+
 class TrackPropagationModule
 {
  public:
@@ -82,6 +175,10 @@ class TrackPropagationModule
   std::shared_ptr<TH1> trackTunedTracks;
   TrackTuner trackTunerObj;
 
+  // propagated tracks of the current DF, filled if fillPropagationCache is enabled
+  bool fillPropagationCache = false;
+  TrackPropagationCache propagationCache;
+
   // Running variables
   std::array<float, 2> mDcaInfo;
   o2::dataformats::DCA mDcaInfoCov;
@@ -96,6 +193,12 @@ class TrackPropagationModule
     fillTracksCov = isTableRequiredInWorkflow(initContext, "TracksCov");
     fillTracksDCA = isTableRequiredInWorkflow(initContext, "TracksDCA");
     fillTracksDCACov = isTableRequiredInWorkflow(initContext, "TracksDCACov");
+    fillPropagationCache = cGroup.fillPropagationCache.value;
+    if (fillPropagationCache && !fillTracksCov) {
+      LOG(warning) << "The propagation cache needs the track covariances: it will only be filled by the look-ups of the consumers";
+    }
+    propagationCache.minPropagationRadius = cGroup.minPropagationRadius.value;
+    propagationCache.matCorr = matCorr;
 
     /// TrackTuner initialization
     if (cGroup.useTrackTuner.value) {
@@ -129,6 +232,12 @@ class TrackPropagationModule
   template <bool isMc, typename TConfigurableGroup, typename TCCDBLoader, typename TCollisions, typename TTracks, typename TOutputGroup, typename THistoRegistry>
   void fillTrackTables(TConfigurableGroup const& cGroup, TCCDBLoader const& ccdbLoader, TCollisions const& collisions, TTracks const& tracks, TOutputGroup& cursors, THistoRegistry& registry)
   {
+    if (fillPropagationCache) {
+      propagationCache.clear();
+      if (fillTracksCov) {
+        propagationCache.reserve(tracks.size());
+      }
+    }
     if (fillTracksCov) {
       cursors.tracksParCovPropagated.reserve(tracks.size());
       cursors.tracksParCovExtensionPropagated.reserve(tracks.size());
@@ -206,6 +315,9 @@ class TrackPropagationModule
         if (isPropagationOK) {
           trackType = o2::aod::track::Track;
         }
+        if (fillPropagationCache && fillTracksCov && track.has_collision()) {
+          propagationCache.insert(track.globalIndex(), track.collisionId(), mTrackParCov, mDcaInfoCov, isPropagationOK);
+        }
         // filling some QA histograms for track tuner test purpose
         if (fillTracksCov) {
           if constexpr (isMc) { // checking MC and fillCovMat block begins
@@ -47,6 +47,11 @@
 #include "ReconstructionDataFormats/Track.h"
 #include <TGraphErrors.h>
 
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+#include <vector>
+
 namespace o2::aod
 {
 namespace track_tuner
@@ -125,6 +130,13 @@ struct TrackTuner : o2::framework::ConfigurableGroup {
   std::vector<std::unique_ptr<TGraphErrors>> grDcaZPullVsPtPionMC;
   std::vector<std::unique_ptr<TGraphErrors>> grDcaZPullVsPtPionData;
 
+  /// points of a graph sorted in x, for the linear interpolation done by TGraph::Eval without its per-call overhead
+  struct GraphPoints {
+    std::vector<double> x;
+    std::vector<double> y;
+  };
+  std::unordered_map<const TGraphErrors*, GraphPoints> graphPoints; // filled at the end of getDcaGraphs
+
   /// @brief Function doing a few sanity-checks on the configurations
   void checkConfig()
   {
@@ -568,6 +580,32 @@ struct TrackTuner : o2::framework::ConfigurableGroup {
       grOneOverPtPionMC.reset(dynamic_cast<TGraphErrors*>(inputFileQoverPt->Get(grOneOverPtPionNameMC.c_str())));
       grOneOverPtPionData.reset(dynamic_cast<TGraphErrors*>(inputFileQoverPt->Get(grOneOverPtPionNameData.c_str())));
     }
+
+    // sorted copies of the points of the graphs, used by evalGraph for every track
+    graphPoints.clear();
+    auto cachePoints = [&](const TGraphErrors* graph) {
+      if (!graph || graph->GetN() < 1) {
+        return;
+      }
+      const int nPoints = graph->GetN();
+      std::vector<int> order(nPoints);
+      std::iota(order.begin(), order.end(), 0);
+      std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return graph->GetX()[a] < graph->GetX()[b]; });
+      GraphPoints& points = graphPoints[graph];
+      for (const auto& iPoint : order) {
+        points.x.push_back(graph->GetX()[iPoint]);
+        points.y.push_back(graph->GetY()[iPoint]);
+      }
+    };
+    for (const auto* graphs : {&grDcaXYResVsPtPionMC, &grDcaXYResVsPtPionData, &grDcaZResVsPtPionMC, &grDcaZResVsPtPionData,
+                               &grDcaXYMeanVsPtPionMC, &grDcaXYMeanVsPtPionData, &grDcaZMeanVsPtPionMC, &grDcaZMeanVsPtPionData,
+                               &grDcaXYPullVsPtPionMC, &grDcaXYPullVsPtPionData, &grDcaZPullVsPtPionMC, &grDcaZPullVsPtPionData}) {
+      for (const auto& graph : *graphs) {
+        cachePoints(graph.get());
+      }
+    }
+    cachePoints(grOneOverPtPionMC.get());
+    cachePoints(grOneOverPtPionData.get());
   } // getDcaGraphs() ends here
 
   template <typename T1, typename T2, typename T3, typename T4, typename H>
@@ -1024,10 +1062,23 @@ struct TrackTuner : o2::framework::ConfigurableGroup {
     double xMin = graph->GetX()[0];
     double xMax = graph->GetX()[nPoints - 1];
     if (x > xMax)
-      return graph->Eval(xMax);
+      x = xMax;
     if (x < xMin)
-      return graph->Eval(xMin);
-    return graph->Eval(x);
+      x = xMin;
+    const auto cached = graphPoints.find(graph);
+    if (cached == graphPoints.end() || cached->second.x.size() < 2) {
+      return graph->Eval(x);
+    }
+    // linear interpolation between the two closest points, or extrapolation from the first (last) two, as TGraph::Eval
+    const auto& px = cached->second.x;
+    const auto& py = cached->second.y;
+    size_t up = std::upper_bound(px.begin(), px.end(), x) - px.begin();
+    up = std::clamp<size_t>(up, 1, px.size() - 1);
+    const size_t low = up - 1;
+    if (py[up] == py[low] || px[up] == px[low]) {
+      return py[low];
+    }
+    return py[low] + (x - px[low]) * (py[up] - py[low]) / (px[up] - px[low]);
   }
 };
 
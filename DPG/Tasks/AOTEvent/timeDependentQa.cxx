@@ -57,6 +57,7 @@ struct TimeDependentQaTask {
   Configurable<int> confTakeVerticesWithUPCsettings{"ConsiderVerticesWithUPCsettings", 0, "Take vertices: 0 - all , 1 - only without UPC settings, 2 - only with UPC settings"}; // o2-linter: disable=name/configurable (temporary fix)
   Configurable<int> confFlagFillPhiVsTimeHist{"FlagFillPhiVsTimeHist", 2, "0 - don't fill , 1 - fill only for global/7cls/TRD/TOF tracks, 2 - fill also layer-by-layer"};        // o2-linter: disable=name/configurable (temporary fix)
   Configurable<int> confFlagFillEtaPhiVsTimeHist{"FlagFillEtaPhiVsTimeHist", 0, "0 - don't fill , 1 - fill"};                                                                    // o2-linter: disable=name/configurable (temporary fix)
+  Configurable<bool> confUseSparseVsTimeHists{"UseSparseVsTimeHists", false, "Book the phi (eta) vs time histograms as THnSparse"};                                              // o2-linter: disable=name/configurable (temporary fix)
   Configurable<float> confCutOnNtpcClsForSharedFractAndDeDxCalc{"CutOnNtpcClsForSharedFractAndDeDxCalc", 70, ""};                                                                // o2-linter: disable=name/configurable (temporary fix)
   Configurable<int> confFlagCheckMshape{"FlagCheckMshape", 0, "0 - don't check , 1 - check"};                                                                                    // o2-linter: disable=name/configurable (temporary fix)
   Configurable<int> confFlagCheckQoverPtHist{"FlagCheckQoverPtHist", 1, "0 - don't check , 1 - check"};                                                                          // o2-linter: disable=name/configurable (temporary fix)
@@ -383,23 +384,26 @@ struct TimeDependentQaTask {
       // phi holes vs time
       const AxisSpec axisPhi{64, 0, TMath::TwoPi(), "#varphi"}; // o2-linter: disable=external-pi (temporary fix)
       const AxisSpec axisEta{10, -0.8, 0.8, "#eta"};
+      // the time axis spans the whole run: with sparse histograms, only the seconds that are filled take memory
+      const HistType typeVsTime2D = confUseSparseVsTimeHists ? kTHnSparseF : kTH2F;
+      const HistType typeVsTime3D = confUseSparseVsTimeHists ? kTHnSparseF : kTH3F;
       if (confFlagFillPhiVsTimeHist == 2) {
-        histos.add("hSecondsITSlayer0vsPhi", "", kTH2F, {axisSeconds, axisPhi});
-        histos.add("hSecondsITSlayer1vsPhi", "", kTH2F, {axisSeconds, axisPhi});
-        histos.add("hSecondsITSlayer2vsPhi", "", kTH2F, {axisSeconds, axisPhi});
-        histos.add("hSecondsITSlayer3vsPhi", "", kTH2F, {axisSeconds, axisPhi});
-        histos.add("hSecondsITSlayer4vsPhi", "", kTH2F, {axisSeconds, axisPhi});
-        histos.add("hSecondsITSlayer5vsPhi", "", kTH2F, {axisSeconds, axisPhi});
-        histos.add("hSecondsITSlayer6vsPhi", "", kTH2F, {axisSeconds, axisPhi});
+        histos.add("hSecondsITSlayer0vsPhi", "", typeVsTime2D, {axisSeconds, axisPhi});
+        histos.add("hSecondsITSlayer1vsPhi", "", typeVsTime2D, {axisSeconds, axisPhi});
+        histos.add("hSecondsITSlayer2vsPhi", "", typeVsTime2D, {axisSeconds, axisPhi});
+        histos.add("hSecondsITSlayer3vsPhi", "", typeVsTime2D, {axisSeconds, axisPhi});
+        histos.add("hSecondsITSlayer4vsPhi", "", typeVsTime2D, {axisSeconds, axisPhi});
+        histos.add("hSecondsITSlayer5vsPhi", "", typeVsTime2D, {axisSeconds, axisPhi});
+        histos.add("hSecondsITSlayer6vsPhi", "", typeVsTime2D, {axisSeconds, axisPhi});
       }
       if (confFlagFillPhiVsTimeHist > 0) {
-        histos.add("hSecondsITS7clsVsPhi", "", kTH2F, {axisSeconds, axisPhi});
-        histos.add("hSecondsITSglobalVsPhi", "", kTH2F, {axisSeconds, axisPhi});
-        histos.add("hSecondsITSTRDVsPhi", "", kTH2F, {axisSeconds, axisPhi});
-        histos.add("hSecondsITSTOFVsPhi", "", kTH2F, {axisSeconds, axisPhi});
+        histos.add("hSecondsITS7clsVsPhi", "", typeVsTime2D, {axisSeconds, axisPhi});
+        histos.add("hSecondsITSglobalVsPhi", "", typeVsTime2D, {axisSeconds, axisPhi});
+        histos.add("hSecondsITSTRDVsPhi", "", typeVsTime2D, {axisSeconds, axisPhi});
+        histos.add("hSecondsITSTOFVsPhi", "", typeVsTime2D, {axisSeconds, axisPhi});
       }
       if (confFlagFillEtaPhiVsTimeHist)
-        histos.add("hSecondsITSglobalVsEtaPhi", "", kTH3F, {axisSeconds, axisEta, axisPhi});
+        histos.add("hSecondsITSglobalVsEtaPhi", "", typeVsTime3D, {axisSeconds, axisEta, axisPhi});
     }
 
     // count TVX triggers per DF
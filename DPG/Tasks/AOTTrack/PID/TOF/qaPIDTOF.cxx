@@ -151,19 +151,26 @@ struct tofPidQa {
     bool enableFullHistos = false;
     int enabledProcesses = 0;
     switch (id) { // Skipping disabled particles
-#define particleCase(particleId)                                 \
-  case PID::particleId:                                          \
-    if (!doprocess##particleId && !doprocessFull##particleId) {  \
-      return;                                                    \
-    }                                                            \
-    if (doprocess##particleId) {                                 \
-      enabledProcesses++;                                        \
-    }                                                            \
-    if (doprocessFull##particleId) {                             \
-      enableFullHistos = true;                                   \
-      enabledProcesses++;                                        \
-    }                                                            \
-    LOGF(info, "Enabled TOF QA for %s %s", #particleId, pT[id]); \
+#define particleCase(particleId)                                                                      \
+  case PID::particleId:                                                                               \
+    if (!doprocess##particleId && !doprocessFull##particleId && !doprocessAll && !doprocessFullAll) { \
+      return;                                                                                         \
+    }                                                                                                 \
+    if (doprocess##particleId) {                                                                      \
+      enabledProcesses++;                                                                             \
+    }                                                                                                 \
+    if (doprocessFull##particleId) {                                                                  \
+      enableFullHistos = true;                                                                        \
+      enabledProcesses++;                                                                             \
+    }                                                                                                 \
+    if (doprocessAll) {                                                                               \
+      enabledProcesses++;                                                                             \
+    }                                                                                                 \
+    if (doprocessFullAll) {                                                                           \
+      enableFullHistos = true;                                                                        \
+      enabledProcesses++;                                                                             \
+    }                                                                                                 \
+    LOGF(info, "Enabled TOF QA for %s %s", #particleId, pT[id]);                                      \
     break;
 
       particleCase(Electron);
@@ -516,126 +523,182 @@ struct tofPidQa {
     }
   }
 
-  template <o2::track::PID::ID id, bool fillFullHistograms,
-            typename TrackType>
-  void processSingleParticle(CollisionCandidate const& collision,
-                             TrackType const& tracks)
+  // Event time used for a track, as in the ev. time split histograms
+  enum EvTimeType { EvTimeFill = 0,
+                    EvTimeTOF,
+                    EvTimeFT0,
+                    EvTimeTOFFT0 };
+
+  // Quantities common to all the particle hypotheses, evaluated once per track
+  struct TrackInfo {
+    float p;
+    float pt;
+    float eta;
+    float phi;
+    float sign;
+    float tof; // t - t_ev
+    EvTimeType evTime;
+  };
+
+  template <typename TrackType>
+  TrackInfo getTrackInfo(const TrackType& t)
   {
-    if (!isEventSelected<false>(collision, tracks)) {
-      return;
-    }
+    TrackInfo info{t.p(), t.pt(), t.eta(), t.phi(), static_cast<float>(t.sign()), t.tofSignal() - t.tofEvTime(), EvTimeFill};
+    if (t.isEvTimeTOF() && t.isEvTimeT0AC()) { // TOF + FT0 Ev. Time
+      info.evTime = EvTimeTOFFT0;
+    } else if (t.isEvTimeT0AC()) { // FT0 Ev. Time
+      info.evTime = EvTimeFT0;
+    } else if (t.isEvTimeTOF()) { // TOF Ev. Time
+      info.evTime = EvTimeTOF;
+    }
+    return info;
+  }
 
-    for (auto t : tracks) {
-      if (!isTrackSelected<false>(collision, t)) {
-        continue;
+  template <o2::track::PID::ID id, bool fillFullHistograms, typename TrackType>
+  void fillParticleHistograms(const TrackType& t, const TrackInfo& info)
+  {
+    if (applyRapidityCut) {
+      if (std::abs(t.rapidity(PID::getMass(id))) > 0.5) {
+        return;
       }
+    }
 
-      if (applyRapidityCut) {
-        if (std::abs(t.rapidity(PID::getMass(id))) > 0.5) {
-          continue;
+    const auto nsigma = o2::aod::pidutils::tofNSigma<id>(t);
+    histos.fill(HIST(hnsigma[id]), info.p, nsigma);
+    if (splitSignalPerCharge) {
+      histos.fill(HIST(hnsigma_pt[id]), info.pt, nsigma, info.sign);
+    } else {
+      histos.fill(HIST(hnsigma_pt[id]), info.pt, nsigma);
+    }
+    // Filling info split per ev. time
+    if (enableEvTimeSplitting) {
+      if (info.evTime == EvTimeTOFFT0) { // TOF + FT0 Ev. Time
+        histos.fill(HIST(hnsigma_evtime_tofft0[id]), info.p, nsigma);
+        if (splitSignalPerCharge) {
+          histos.fill(HIST(hnsigma_pt_evtime_tofft0[id]), info.pt, nsigma, info.sign);
+        } else {
+          histos.fill(HIST(hnsigma_pt_evtime_tofft0[id]), info.pt, nsigma);
+        }
+      } else if (info.evTime == EvTimeFT0) { // FT0 Ev. Time
+        histos.fill(HIST(hnsigma_evtime_ft0[id]), info.p, nsigma);
+        if (splitSignalPerCharge) {
+          histos.fill(HIST(hnsigma_pt_evtime_ft0[id]), info.pt, nsigma, info.sign);
+        } else {
+          histos.fill(HIST(hnsigma_pt_evtime_ft0[id]), info.pt, nsigma);
+        }
+      } else if (info.evTime == EvTimeTOF) { // TOF Ev. Time
+        histos.fill(HIST(hnsigma_evtime_tof[id]), info.p, nsigma);
+        if (splitSignalPerCharge) {
+          histos.fill(HIST(hnsigma_pt_evtime_tof[id]), info.pt, nsigma, info.sign);
+        } else {
+          histos.fill(HIST(hnsigma_pt_evtime_tof[id]), info.pt, nsigma);
+        }
+      } else { // No Ev. Time -> Fill Ev. Time
+        histos.fill(HIST(hnsigma_evtime_fill[id]), info.p, nsigma);
+        if (splitSignalPerCharge) {
+          histos.fill(HIST(hnsigma_pt_evtime_fill[id]), info.pt, nsigma, info.sign);
+        } else {
+          histos.fill(HIST(hnsigma_pt_evtime_fill[id]), info.pt, nsigma);
         }
       }
+    }
 
-      const auto nsigma = o2::aod::pidutils::tofNSigma<id>(t);
-      histos.fill(HIST(hnsigma[id]), t.p(), nsigma);
+    if constexpr (fillFullHistograms) {
+      const auto& diff = o2::aod::pidutils::tofExpSignalDiff<id>(t);
+      // Fill histograms
+      histos.fill(HIST(hexpected[id]), info.p, info.tof - diff);
+      histos.fill(HIST(hdelta[id]), info.p, diff);
       if (splitSignalPerCharge) {
-        histos.fill(HIST(hnsigma_pt[id]), t.pt(), nsigma, t.sign());
+        histos.fill(HIST(hdelta_pt[id]), info.pt, diff, info.sign);
       } else {
-        histos.fill(HIST(hnsigma_pt[id]), t.pt(), nsigma);
+        histos.fill(HIST(hdelta_pt[id]), info.pt, diff);
       }
+
+      if (produceDeltaTEtaPhiMap) {
+        if (info.pt > ptDeltaTEtaPhiMapMin && info.pt < ptDeltaTEtaPhiMapMax) {
+          histos.fill(HIST(hdelta_etaphi[id]), info.eta, info.phi, diff);
+        }
+      }
+      histos.fill(HIST(hexpsigma[id]), info.p, o2::aod::pidutils::tofExpSigma<id>(t));
+
       // Filling info split per ev. time
       if (enableEvTimeSplitting) {
-        if (t.isEvTimeTOF() && t.isEvTimeT0AC()) { // TOF + FT0 Ev. Time
-          histos.fill(HIST(hnsigma_evtime_tofft0[id]), t.p(), nsigma);
+        if (info.evTime == EvTimeTOFFT0) { // TOF + FT0 Ev. Time
+          if (enableVsMomentumHistograms) {
+            histos.fill(HIST(hdelta_evtime_tofft0[id]), info.p, diff);
+          }
           if (splitSignalPerCharge) {
-            histos.fill(HIST(hnsigma_pt_evtime_tofft0[id]), t.pt(), nsigma, t.sign());
+            histos.fill(HIST(hdelta_pt_evtime_tofft0[id]), info.pt, diff, info.sign);
           } else {
-            histos.fill(HIST(hnsigma_pt_evtime_tofft0[id]), t.pt(), nsigma);
+            histos.fill(HIST(hdelta_pt_evtime_tofft0[id]), info.pt, diff);
+          }
+        } else if (info.evTime == EvTimeFT0) { // FT0 Ev. Time
+          if (enableVsMomentumHistograms) {
+            histos.fill(HIST(hdelta_evtime_ft0[id]), info.p, diff);
           }
-        } else if (t.isEvTimeT0AC()) { // FT0 Ev. Time
-          histos.fill(HIST(hnsigma_evtime_ft0[id]), t.p(), nsigma);
           if (splitSignalPerCharge) {
-            histos.fill(HIST(hnsigma_pt_evtime_ft0[id]), t.pt(), nsigma, t.sign());
+            histos.fill(HIST(hdelta_pt_evtime_ft0[id]), info.pt, diff, info.sign);
           } else {
-            histos.fill(HIST(hnsigma_pt_evtime_ft0[id]), t.pt(), nsigma);
+            histos.fill(HIST(hdelta_pt_evtime_ft0[id]), info.pt, diff);
+          }
+        } else if (info.evTime == EvTimeTOF) { // TOF Ev. Time
+          if (enableVsMomentumHistograms) {
+            histos.fill(HIST(hdelta_evtime_tof[id]), info.p, diff);
           }
-        } else if (t.isEvTimeTOF()) { // TOF Ev. Time
-          histos.fill(HIST(hnsigma_evtime_tof[id]), t.p(), nsigma);
           if (splitSignalPerCharge) {
-            histos.fill(HIST(hnsigma_pt_evtime_tof[id]), t.pt(), nsigma, t.sign());
+            histos.fill(HIST(hdelta_pt_evtime_tof[id]), info.pt, diff, info.sign);
           } else {
-            histos.fill(HIST(hnsigma_pt_evtime_tof[id]), t.pt(), nsigma);
+            histos.fill(HIST(hdelta_pt_evtime_tof[id]), info.pt, diff);
           }
         } else { // No Ev. Time -> Fill Ev. Time
-          histos.fill(HIST(hnsigma_evtime_fill[id]), t.p(), nsigma);
+          if (enableVsMomentumHistograms) {
+            histos.fill(HIST(hdelta_evtime_fill[id]), info.p, diff);
+          }
           if (splitSignalPerCharge) {
-            histos.fill(HIST(hnsigma_pt_evtime_fill[id]), t.pt(), nsigma, t.sign());
+            histos.fill(HIST(hdelta_pt_evtime_fill[id]), info.pt, diff, info.sign);
           } else {
-            histos.fill(HIST(hnsigma_pt_evtime_fill[id]), t.pt(), nsigma);
+            histos.fill(HIST(hdelta_pt_evtime_fill[id]), info.pt, diff);
           }
         }
       }
+    }
+  }
 
-      if constexpr (fillFullHistograms) {
-        const float& tof = t.tofSignal() - t.tofEvTime();
-        const auto& diff = o2::aod::pidutils::tofExpSignalDiff<id>(t);
-        // Fill histograms
-        histos.fill(HIST(hexpected[id]), t.p(), tof - diff);
-        histos.fill(HIST(hdelta[id]), t.p(), diff);
-        if (splitSignalPerCharge) {
-          histos.fill(HIST(hdelta_pt[id]), t.pt(), diff, t.sign());
-        } else {
-          histos.fill(HIST(hdelta_pt[id]), t.pt(), diff);
-        }
+  template <o2::track::PID::ID id, bool fillFullHistograms,
+            typename TrackType>
+  void processSingleParticle(CollisionCandidate const& collision,
+                             TrackType const& tracks)
+  {
+    if (!isEventSelected<false>(collision, tracks)) {
+      return;
+    }
 
-        if (produceDeltaTEtaPhiMap) {
-          if (t.pt() > ptDeltaTEtaPhiMapMin && t.pt() < ptDeltaTEtaPhiMapMax) {
-            histos.fill(HIST(hdelta_etaphi[id]), t.eta(), t.phi(), diff);
-          }
-        }
-        histos.fill(HIST(hexpsigma[id]), t.p(), o2::aod::pidutils::tofExpSigma<id>(t));
-
-        // Filling info split per ev. time
-        if (enableEvTimeSplitting) {
-          if (t.isEvTimeTOF() && t.isEvTimeT0AC()) { // TOF + FT0 Ev. Time
-            if (enableVsMomentumHistograms) {
-              histos.fill(HIST(hdelta_evtime_tofft0[id]), t.p(), diff);
-            }
-            if (splitSignalPerCharge) {
-              histos.fill(HIST(hdelta_pt_evtime_tofft0[id]), t.pt(), diff, t.sign());
-            } else {
-              histos.fill(HIST(hdelta_pt_evtime_tofft0[id]), t.pt(), diff);
-            }
-          } else if (t.isEvTimeT0AC()) { // FT0 Ev. Time
-            if (enableVsMomentumHistograms) {
-              histos.fill(HIST(hdelta_evtime_ft0[id]), t.p(), diff);
-            }
-            if (splitSignalPerCharge) {
-              histos.fill(HIST(hdelta_pt_evtime_ft0[id]), t.pt(), diff, t.sign());
-            } else {
-              histos.fill(HIST(hdelta_pt_evtime_ft0[id]), t.pt(), diff);
-            }
-          } else if (t.isEvTimeTOF()) { // TOF Ev. Time
-            if (enableVsMomentumHistograms) {
-              histos.fill(HIST(hdelta_evtime_tof[id]), t.p(), diff);
-            }
-            if (splitSignalPerCharge) {
-              histos.fill(HIST(hdelta_pt_evtime_tof[id]), t.pt(), diff, t.sign());
-            } else {
-              histos.fill(HIST(hdelta_pt_evtime_tof[id]), t.pt(), diff);
-            }
-          } else { // No Ev. Time -> Fill Ev. Time
-            if (enableVsMomentumHistograms) {
-              histos.fill(HIST(hdelta_evtime_fill[id]), t.p(), diff);
-            }
-            if (splitSignalPerCharge) {
-              histos.fill(HIST(hdelta_pt_evtime_fill[id]), t.pt(), diff, t.sign());
-            } else {
-              histos.fill(HIST(hdelta_pt_evtime_fill[id]), t.pt(), diff);
-            }
-          }
-        }
+    for (auto t : tracks) {
+      if (!isTrackSelected<false>(collision, t)) {
+        continue;
+      }
+      fillParticleHistograms<id, fillFullHistograms>(t, getTrackInfo(t));
+    }
+  }
+
+  // Single pass over the tracks for all the particle hypotheses: the event and track selections and the
+  // event time of the track are evaluated once, then the histograms of every particle are filled
+  template <bool fillFullHistograms, typename TrackType>
+  void processAllParticles(CollisionCandidate const& collision,
+                           TrackType const& tracks)
+  {
+    if (!isEventSelected<false>(collision, tracks)) {
+      return;
+    }
+
+    for (const auto& t : tracks) {
+      if (!isTrackSelected<false>(collision, t)) {
+        continue;
       }
+      const TrackInfo info = getTrackInfo(t);
+      static_for<0, 8>([&](auto i) {
+        fillParticleHistograms<i, fillFullHistograms>(t, info);
+      });
     }
   }
 
@@ -678,6 +741,27 @@ struct tofPidQa {
   makeProcessFunction(aod::pidTOFFullHe, Helium3);
   makeProcessFunction(aod::pidTOFFullAl, Alpha);
 #undef makeProcessFunction
+
+  // QA of all the hypotheses in a single pass over the tracks
+  void processAll(CollisionCandidate const& collision,
+                  soa::Filtered<soa::Join<TrackCandidates,
+                                          aod::pidTOFEl, aod::pidTOFMu, aod::pidTOFPi,
+                                          aod::pidTOFKa, aod::pidTOFPr, aod::pidTOFDe,
+                                          aod::pidTOFTr, aod::pidTOFHe, aod::pidTOFAl>> const& tracks)
+  {
+    processAllParticles<false>(collision, tracks);
+  }
+  PROCESS_SWITCH(tofPidQa, processAll, "Process for all the hypotheses in a single pass for TOF NSigma QA", false);
+
+  void processFullAll(CollisionCandidate const& collision,
+                      soa::Filtered<soa::Join<TrackCandidates,
+                                              aod::pidTOFFullEl, aod::pidTOFFullMu, aod::pidTOFFullPi,
+                                              aod::pidTOFFullKa, aod::pidTOFFullPr, aod::pidTOFFullDe,
+                                              aod::pidTOFFullTr, aod::pidTOFFullHe, aod::pidTOFFullAl>> const& tracks)
+  {
+    processAllParticles<true>(collision, tracks);
+  }
+  PROCESS_SWITCH(tofPidQa, processFullAll, "Process for all the hypotheses in a single pass for full TOF PID QA", false);
 };
 
 WorkflowSpec defineDataProcessing(ConfigContext const& cfgc)
@@ -1041,8 +1041,19 @@ struct QaEfficiency {
     }
     return false; // Otherwise, not considered a tertiary particle
   }
+  /// Whether the track is assigned to a collision of the MC collision of its particle, always true if numSameCollision is disabled
+  bool isSameMcCollision(const TrackCandidatesMC::iterator& track, const o2::aod::McParticles::iterator& mcParticle)
+  {
+    if (!numSameCollision) {
+      return true;
+    }
+    const CollisionCandidatesMC::iterator& collision = track.collision_as<CollisionCandidatesMC>();
+    return collision.has_mcCollision() && mcParticle.mcCollisionId() == collision.mcCollisionId();
+  }
+
+  /// mcParticle is the particle of the track, the collision check (isSameMcCollision) is done once per track by the caller
   template <int pdgSign, o2::track::PID::ID id>
-  void fillMCTrackHistograms(const TrackCandidatesMC::iterator& track, const bool doMakeHistograms)
+  void fillMCTrackHistograms(const TrackCandidatesMC::iterator& track, const o2::aod::McParticles::iterator& mcParticle, const bool doMakeHistograms)
   {
     static_assert(pdgSign == 0 || pdgSign == 1);
     if (!doMakeHistograms) {
@@ -1060,17 +1071,6 @@ struct QaEfficiency {
     }
     constexpr int histogramIndex = id + pdgSign * nSpecies;
     LOG(debug) << "fillMCTrackHistograms for pdgSign '" << pdgSign << "' and id '" << static_cast<int>(id) << "' " << particleName(pdgSign, id) << " with index " << histogramIndex;
-    const o2::aod::McParticles::iterator& mcParticle = track.mcParticle();
-    const CollisionCandidatesMC::iterator& collision = track.collision_as<CollisionCandidatesMC>();
-    float radius = std::sqrt(mcParticle.vx() * mcParticle.vx() + mcParticle.vy() * mcParticle.vy());
-    if (numSameCollision) {
-      if (!collision.has_mcCollision()) {
-        return;
-      }
-      if (mcParticle.mcCollision().globalIndex() != collision.mcCollision().globalIndex()) {
-        return;
-      }
-    }
     histos.fill(HIST("MC/trackSelection"), trkCutSameColl);
 
     if (!isPdgSelected<pdgSign, id>(mcParticle)) { // Selecting PDG code
@@ -1078,6 +1078,7 @@ struct QaEfficiency {
     }
 
     histos.fill(HIST("MC/trackSelection"), trkCutIdxN + id);
+    const float radius = std::sqrt(mcParticle.vx() * mcParticle.vx() + mcParticle.vy() * mcParticle.vy());
 
     if (passedITS) {
       hPtIts[histogramIndex]->Fill(mcParticle.pt());
@@ -1234,7 +1235,6 @@ struct QaEfficiency {
 
     constexpr int histogramIndex = id + pdgSign * nSpecies;
     LOG(debug) << "fillMCParticleHistograms for pdgSign '" << pdgSign << "' and id '" << static_cast<int>(id) << "' " << particleName(pdgSign, id) << " with index " << histogramIndex;
-    float radius = std::sqrt(mcParticle.vx() * mcParticle.vx() + mcParticle.vy() * mcParticle.vy());
     if (!isPdgSelected<pdgSign, id>(mcParticle)) { // Selecting PDG code
       return;
     }
@@ -1246,6 +1246,7 @@ struct QaEfficiency {
       return;
     }
     histos.fill(HIST("MC/particleSelection"), 6 + id);
+    const float radius = std::sqrt(mcParticle.vx() * mcParticle.vx() + mcParticle.vy() * mcParticle.vy());
 
     hPGenerated[histogramIndex]->Fill(mcParticle.p());
     hPtGenerated[histogramIndex]->Fill(mcParticle.pt());
@@ -1858,16 +1859,19 @@ struct QaEfficiency {
 
           // Filling variable histograms
           histos.fill(HIST("MC/trackLength"), track.length());
+          if (!isSameMcCollision(track, particle)) {
+            continue;
+          }
           static_for<0, 1>([&](auto pdgSign) {
-            fillMCTrackHistograms<pdgSign, o2::track::PID::Electron>(track, doEl);
-            fillMCTrackHistograms<pdgSign, o2::track::PID::Muon>(track, doMu);
-            fillMCTrackHistograms<pdgSign, o2::track::PID::Pion>(track, doPi);
-            fillMCTrackHistograms<pdgSign, o2::track::PID::Kaon>(track, doKa);
-            fillMCTrackHistograms<pdgSign, o2::track::PID::Proton>(track, doPr);
-            fillMCTrackHistograms<pdgSign, o2::track::PID::Deuteron>(track, doDe);
-            fillMCTrackHistograms<pdgSign, o2::track::PID::Triton>(track, doTr);
-            fillMCTrackHistograms<pdgSign, o2::track::PID::Helium3>(track, doHe);
-            fillMCTrackHistograms<pdgSign, o2::track::PID::Alpha>(track, doAl);
+            fillMCTrackHistograms<pdgSign, o2::track::PID::Electron>(track, particle, doEl);
+            fillMCTrackHistograms<pdgSign, o2::track::PID::Muon>(track, particle, doMu);
+            fillMCTrackHistograms<pdgSign, o2::track::PID::Pion>(track, particle, doPi);
+            fillMCTrackHistograms<pdgSign, o2::track::PID::Kaon>(track, particle, doKa);
+            fillMCTrackHistograms<pdgSign, o2::track::PID::Proton>(track, particle, doPr);
+            fillMCTrackHistograms<pdgSign, o2::track::PID::Deuteron>(track, particle, doDe);
+            fillMCTrackHistograms<pdgSign, o2::track::PID::Triton>(track, particle, doTr);
+            fillMCTrackHistograms<pdgSign, o2::track::PID::Helium3>(track, particle, doHe);
+            fillMCTrackHistograms<pdgSign, o2::track::PID::Alpha>(track, particle, doAl);
           });
         }
 
@@ -2027,16 +2031,19 @@ struct QaEfficiency {
 
       // Filling variable histograms
       histos.fill(HIST("MC/trackLength"), track.length());
+      if (!isSameMcCollision(track, particle)) {
+        continue;
+      }
       static_for<0, 1>([&](auto pdgSign) {
-        fillMCTrackHistograms<pdgSign, o2::track::PID::Electron>(track, doEl);
-        fillMCTrackHistograms<pdgSign, o2::track::PID::Muon>(track, doMu);
-        fillMCTrackHistograms<pdgSign, o2::track::PID::Pion>(track, doPi);
-        fillMCTrackHistograms<pdgSign, o2::track::PID::Kaon>(track, doKa);
-        fillMCTrackHistograms<pdgSign, o2::track::PID::Proton>(track, doPr);
-        fillMCTrackHistograms<pdgSign, o2::track::PID::Deuteron>(track, doDe);
-        fillMCTrackHistograms<pdgSign, o2::track::PID::Triton>(track, doTr);
-        fillMCTrackHistograms<pdgSign, o2::track::PID::Helium3>(track, doHe);
-        fillMCTrackHistograms<pdgSign, o2::track::PID::Alpha>(track, doAl);
+        fillMCTrackHistograms<pdgSign, o2::track::PID::Electron>(track, particle, doEl);
+        fillMCTrackHistograms<pdgSign, o2::track::PID::Muon>(track, particle, doMu);
+        fillMCTrackHistograms<pdgSign, o2::track::PID::Pion>(track, particle, doPi);
+        fillMCTrackHistograms<pdgSign, o2::track::PID::Kaon>(track, particle, doKa);
+        fillMCTrackHistograms<pdgSign, o2::track::PID::Proton>(track, particle, doPr);
+        fillMCTrackHistograms<pdgSign, o2::track::PID::Deuteron>(track, particle, doDe);
+        fillMCTrackHistograms<pdgSign, o2::track::PID::Triton>(track, particle, doTr);
+        fillMCTrackHistograms<pdgSign, o2::track::PID::Helium3>(track, particle, doHe);
+        fillMCTrackHistograms<pdgSign, o2::track::PID::Alpha>(track, particle, doAl);
       });
     }
 
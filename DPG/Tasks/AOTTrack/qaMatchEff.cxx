@@ -1501,6 +1501,19 @@ struct qaMatchEff {
     float tofNSigmaProton = -999.f;
     float hasdet = -999.f;
     //
+    // PID windows, looked up once and not for every track
+    const float nSigTpcPionMin = nSigmaPID->get("TPC", "nSigPionMin");
+    const float nSigTpcPionMax = nSigmaPID->get("TPC", "nSigPionMax");
+    const float nSigTofPionMin = nSigmaPID->get("TOF", "nSigPionMin");
+    const float nSigTofPionMax = nSigmaPID->get("TOF", "nSigPionMax");
+    const float nSigTpcKaonMin = nSigmaPID->get("TPC", "nSigKaonMin");
+    const float nSigTpcKaonMax = nSigmaPID->get("TPC", "nSigKaonMax");
+    const float nSigTofKaonMin = nSigmaPID->get("TOF", "nSigKaonMin");
+    const float nSigTofKaonMax = nSigmaPID->get("TOF", "nSigKaonMax");
+    const float nSigTpcProtonMin = nSigmaPID->get("TPC", "nSigProtonMin");
+    const float nSigTpcProtonMax = nSigmaPID->get("TPC", "nSigProtonMax");
+    const float nSigTofProtonMin = nSigmaPID->get("TOF", "nSigProtonMin");
+    const float nSigTofProtonMax = nSigmaPID->get("TOF", "nSigProtonMax");
     //
     for (auto& track : tracks) {
       // choose if we keep the track according to the TRD presence requirement
@@ -1575,12 +1588,15 @@ struct qaMatchEff {
       const bool trkWTOF = track.hasTOF();
       const bool trkWTPC = track.hasTPC();
       const bool trkWITS = track.hasITS();
-      bool pionPIDwithTPC = (nSigmaPID->get("TPC", "nSigPionMin") < tpcNSigmaPion && tpcNSigmaPion < nSigmaPID->get("TPC", "nSigPionMax"));
-      bool pionPIDwithTOF = (nSigmaPID->get("TOF", "nSigPionMin") < tofNSigmaPion && tofNSigmaPion < nSigmaPID->get("TOF", "nSigPionMax"));
-      bool kaonPIDwithTPC = (nSigmaPID->get("TPC", "nSigKaonMin") < tpcNSigmaKaon && tpcNSigmaKaon < nSigmaPID->get("TPC", "nSigKaonMax"));
-      bool kaonPIDwithTOF = (nSigmaPID->get("TOF", "nSigKaonMin") < tofNSigmaKaon && tofNSigmaKaon < nSigmaPID->get("TOF", "nSigKaonMax"));
-      bool protonPIDwithTPC = (nSigmaPID->get("TPC", "nSigProtonMin") < tpcNSigmaProton && tpcNSigmaProton < nSigmaPID->get("TPC", "nSigProtonMax"));
-      bool protonPIDwithTOF = (nSigmaPID->get("TOF", "nSigProtonMin") < tofNSigmaProton && tofNSigmaProton < nSigmaPID->get("TOF", "nSigProtonMax"));
+      // the ITS and TPC selections, used by most of the blocks below, are evaluated once per track
+      const bool isITSSelected = isTrackSelectedITSCuts(track);
+      const bool isTPCSelected = isTrackSelectedTPCCuts(track);
+      bool pionPIDwithTPC = (nSigTpcPionMin < tpcNSigmaPion && tpcNSigmaPion < nSigTpcPionMax);
+      bool pionPIDwithTOF = (nSigTofPionMin < tofNSigmaPion && tofNSigmaPion < nSigTofPionMax);
+      bool kaonPIDwithTPC = (nSigTpcKaonMin < tpcNSigmaKaon && tpcNSigmaKaon < nSigTpcKaonMax);
+      bool kaonPIDwithTOF = (nSigTofKaonMin < tofNSigmaKaon && tofNSigmaKaon < nSigTofKaonMax);
+      bool protonPIDwithTPC = (nSigTpcProtonMin < tpcNSigmaProton && tpcNSigmaProton < nSigTpcProtonMax);
+      bool protonPIDwithTOF = (nSigTofProtonMin < tofNSigmaProton && tofNSigmaProton < nSigTofProtonMax);
       // isPion
       bool isPion = false;
       if (isPIDPionRequired && pionPIDwithTPC && ((!trkWTOF) || pionPIDwithTOF))
@@ -1674,7 +1690,7 @@ struct qaMatchEff {
       //***************************************************************************************************************************************************************************
       //  MIND!!!!   THESE SETS OVERLAP!!!  ___M__U__S__T___ select one of the conditions in the analysis
       hasdet = 0;
-      if (trkWITS && isTrackSelectedITSCuts(track)) { // ITS at least
+      if (trkWITS && isITSSelected) { // ITS at least
         hasdet = 1;
         //
         //
@@ -1691,7 +1707,7 @@ struct qaMatchEff {
           }
         }
       }
-      if (trkWTPC && isTrackSelectedTPCCuts(track)) { // TPC at least
+      if (trkWTPC && isTPCSelected) { // TPC at least
         hasdet = 2;
         //
         //
@@ -1708,7 +1724,7 @@ struct qaMatchEff {
           }
         }
       }
-      if (trkWITS && trkWTPC && isTrackSelectedTPCCuts(track) && isTrackSelectedITSCuts(track)) { // ITS + TPC at least
+      if (trkWITS && trkWTPC && isTPCSelected && isITSSelected) { // ITS + TPC at least
         hasdet = 3;
         //
         //
@@ -1725,7 +1741,7 @@ struct qaMatchEff {
           }
         }
       }
-      if (trkWTOF && trkWTPC && isTrackSelectedTPCCuts(track)) { // TOF + TPC at least
+      if (trkWTOF && trkWTPC && isTPCSelected) { // TOF + TPC at least
         hasdet = 4;
         //
         //
@@ -1742,7 +1758,7 @@ struct qaMatchEff {
           }
         }
       }
-      if (trkWITS && isTrackSelectedITSCuts(track) && trkWTOF) { // TOF + ITS at least
+      if (trkWITS && isITSSelected && trkWTOF) { // TOF + ITS at least
         hasdet = 5;
         //
         //
@@ -1759,7 +1775,7 @@ struct qaMatchEff {
           }
         }
       }
-      if (trkWITS && trkWTOF && trkWTPC && isTrackSelectedTPCCuts(track) && isTrackSelectedITSCuts(track)) { // TOF + TPC +ITS at least
+      if (trkWITS && trkWTOF && trkWTPC && isTPCSelected && isITSSelected) { // TOF + TPC +ITS at least
         hasdet = 6;
         //
         //
@@ -1776,7 +1792,7 @@ struct qaMatchEff {
           }
         }
       }
-      if (trkWITS && isTrackSelectedITSCuts(track) && !trkWTPC) { // ITS at least, NO TPC
+      if (trkWITS && isITSSelected && !trkWTPC) { // ITS at least, NO TPC
         hasdet = 7;
         //
         //
@@ -1793,7 +1809,7 @@ struct qaMatchEff {
           }
         }
       }
-      if (trkWTPC && isTrackSelectedTPCCuts(track) && !trkWITS) { // TPC at least, NO ITS
+      if (trkWTPC && isTPCSelected && !trkWITS) { // TPC at least, NO ITS
         hasdet = 8;
         //
         //
@@ -1810,7 +1826,7 @@ struct qaMatchEff {
           }
         }
       }
-      if (trkWITS && isTrackSelectedITSCuts(track) && trkWTRD) { // ITS + TRD at least
+      if (trkWITS && isITSSelected && trkWTRD) { // ITS + TRD at least
         hasdet = 9;
         //
         //
@@ -1827,7 +1843,7 @@ struct qaMatchEff {
           }
         }
       }
-      if (trkWITS && isTrackSelectedITSCuts(track) && trkWTRD && trkWTOF) { // ITS + TRD + TOF at least
+      if (trkWITS && isITSSelected && trkWTRD && trkWTOF) { // ITS + TRD + TOF at least
         hasdet = 10;
         //
         //
@@ -1844,7 +1860,7 @@ struct qaMatchEff {
           }
         }
       }
-      if (trkWITS && isTrackSelectedITSCuts(track) && !trkWTRD && !trkWTOF && !trkWTPC) { // ITS ONLY!
+      if (trkWITS && isITSSelected && !trkWTRD && !trkWTOF && !trkWTPC) { // ITS ONLY!
         hasdet = 11;
         //
         //
@@ -1957,7 +1973,7 @@ struct qaMatchEff {
       //
       // all tracks w/TPC
       //
-      if (trkWTPC && isTrackSelectedTPCCuts(track)) {
+      if (trkWTPC && isTPCSelected) {
         if constexpr (IS_MC) { ////////////////////////   MC
           //
           // TPC clusters
@@ -2043,7 +2059,7 @@ struct qaMatchEff {
           //     histos.get<TH1>(HIST("MC/TPCclust/tpcsFindableMinusCrossedRows_pr_tpc_1g"))->Fill(crowstpc);
           //   }
           // }
-          // if (trkWITS && isTrackSelectedITSCuts(track)) { ////////////////////////////////////////////   ITS tag inside TPC tagged
+          // if (trkWITS && isITSSelected) { ////////////////////////////////////////////   ITS tag inside TPC tagged
           //   if (isPion) {
           //     //
           //     // TPC clusters
@@ -2374,7 +2390,7 @@ struct qaMatchEff {
           } // not pions, nor kaons, nor protons
         } // end if DATA
         //
-        if (trkWITS && isTrackSelectedITSCuts(track)) { ////////////////////////////////////////////   ITS tag inside TPC tagged
+        if (trkWITS && isITSSelected) { ////////////////////////////////////////////   ITS tag inside TPC tagged
           if constexpr (IS_MC) {                        ////////////////////////   MC
             //
             // TPC clusters
@@ -2751,7 +2767,7 @@ struct qaMatchEff {
       //      if (trkWTPC && trkWTRD && trkWTOF)
       //        histos.get<TH1>(HIST("data/control/itsCMwTPCwTOFwTRD"))->Fill(track.itsClusterMap());
       //    }
-      //    if (isTrackSelectedITSCuts(track)) {
+      //    if (isITSSelected) {
       //      if (IS_MC) { ////////////////////////   MC
       //        if (!trkWTPC)
       //          histos.get<TH1>(HIST("MC/control/SitsCMnoTPC"))->Fill(track.itsClusterMap());
@@ -2792,7 +2808,7 @@ struct qaMatchEff {
       //
       // all tracks with pt>0.5
       // if (trackPt > 0.5) {
-      //   if (trkWTPC && isTrackSelectedTPCCuts(track)) {
+      //   if (trkWTPC && isTPCSelected) {
       //     if constexpr (IS_MC) { ////////////////////////   MC
       //       histos.get<TH1>(HIST("MC/pthist_tpc_05"))->Fill(trackPt);
       //       histos.get<TH1>(HIST("MC/phihist_tpc_05"))->Fill(track.phi());
@@ -2802,7 +2818,7 @@ struct qaMatchEff {
       //       histos.get<TH1>(HIST("data/phihist_tpc_05"))->Fill(track.phi());
       //       histos.get<TH1>(HIST("data/etahist_tpc_05"))->Fill(track.eta());
       //     }
-      //     if (trkWITS && isTrackSelectedITSCuts(track)) {
+      //     if (trkWITS && isITSSelected) {
       //       if constexpr (IS_MC) {
       //         histos.get<TH1>(HIST("MC/pthist_tpcits_05"))->Fill(trackPt);
       //         histos.get<TH1>(HIST("MC/phihist_tpcits_05"))->Fill(track.phi());
@@ -2818,7 +2834,7 @@ struct qaMatchEff {
       //
       // positive only
       if (track.signed1Pt() > 0) {
-        if (trkWTPC && isTrackSelectedTPCCuts(track)) {
+        if (trkWTPC && isTPCSelected) {
           if constexpr (IS_MC) {
             histos.get<TH1>(HIST("MC/pthist_tpc_pos"))->Fill(trackPt);
             histos.get<TH1>(HIST("MC/phihist_tpc_pos"))->Fill(track.phi());
@@ -2828,7 +2844,7 @@ struct qaMatchEff {
             histos.get<TH1>(HIST("data/phihist_tpc_pos"))->Fill(track.phi());
             histos.get<TH1>(HIST("data/etahist_tpc_pos"))->Fill(track.eta());
           }
-          if (trkWITS && isTrackSelectedITSCuts(track)) {
+          if (trkWITS && isITSSelected) {
             if constexpr (IS_MC) {
               histos.get<TH1>(HIST("MC/pthist_tpcits_pos"))->Fill(trackPt);
               histos.get<TH1>(HIST("MC/phihist_tpcits_pos"))->Fill(track.phi());
@@ -2845,7 +2861,7 @@ struct qaMatchEff {
       //
       // negative only
       if (track.signed1Pt() < 0) {
-        if (trkWTPC && isTrackSelectedTPCCuts(track)) {
+        if (trkWTPC && isTPCSelected) {
           if constexpr (IS_MC) {
             histos.get<TH1>(HIST("MC/pthist_tpc_neg"))->Fill(trackPt);
             histos.get<TH1>(HIST("MC/phihist_tpc_neg"))->Fill(track.phi());
@@ -2855,7 +2871,7 @@ struct qaMatchEff {
             histos.get<TH1>(HIST("data/phihist_tpc_neg"))->Fill(track.phi());
             histos.get<TH1>(HIST("data/etahist_tpc_neg"))->Fill(track.eta());
           }
-          if (trkWITS && isTrackSelectedITSCuts(track)) {
+          if (trkWITS && isITSSelected) {
             if constexpr (IS_MC) {
               histos.get<TH1>(HIST("MC/pthist_tpcits_neg"))->Fill(trackPt);
               histos.get<TH1>(HIST("MC/phihist_tpcits_neg"))->Fill(track.phi());
@@ -2875,7 +2891,7 @@ struct qaMatchEff {
         //
         // only primaries
         if (mcpart.isPhysicalPrimary()) {
-          if (trkWTPC && isTrackSelectedTPCCuts(track)) {
+          if (trkWTPC && isTPCSelected) {
             // histos.get<TH1>(HIST("MC/primsec/zDCA_tpc_prim"))->Fill(track.dcaZ());
             // histos.get<TH1>(HIST("MC/primsec/xyDCA_tpc_prim"))->Fill(track.dcaXY());
             //
@@ -2883,7 +2899,7 @@ struct qaMatchEff {
             histos.get<TH1>(HIST("MC/primsec/pthist_tpc_prim"))->Fill(trackPt);
             histos.get<TH1>(HIST("MC/primsec/phihist_tpc_prim"))->Fill(track.phi());
             histos.get<TH1>(HIST("MC/primsec/etahist_tpc_prim"))->Fill(track.eta());
-            if (trkWITS && isTrackSelectedITSCuts(track)) {
+            if (trkWITS && isITSSelected) {
               // histos.get<TH1>(HIST("MC/primsec/zDCA_tpcits_prim"))->Fill(track.dcaZ());
               // histos.get<TH1>(HIST("MC/primsec/xyDCA_tpcits_prim"))->Fill(track.dcaXY());
               //
@@ -2897,7 +2913,7 @@ struct qaMatchEff {
         } else if (mcpart.getProcess() == 4) {
           //
           // only secondaries from decay
-          if (trkWTPC && isTrackSelectedTPCCuts(track)) {
+          if (trkWTPC && isTPCSelected) {
             // histos.get<TH1>(HIST("MC/primsec/zDCA_tpc_secd"))->Fill(track.dcaZ());
             // histos.get<TH1>(HIST("MC/primsec/xyDCA_tpc_secd"))->Fill(track.dcaXY());
             //
@@ -2905,7 +2921,7 @@ struct qaMatchEff {
             histos.get<TH1>(HIST("MC/primsec/pthist_tpc_secd"))->Fill(trackPt);
             histos.get<TH1>(HIST("MC/primsec/phihist_tpc_secd"))->Fill(track.phi());
             histos.get<TH1>(HIST("MC/primsec/etahist_tpc_secd"))->Fill(track.eta());
-            if (trkWITS && isTrackSelectedITSCuts(track)) {
+            if (trkWITS && isITSSelected) {
               // histos.get<TH1>(HIST("MC/primsec/zDCA_tpcits_secd"))->Fill(track.dcaZ());
               // histos.get<TH1>(HIST("MC/primsec/xyDCA_tpcits_secd"))->Fill(track.dcaXY());
               //
@@ -2919,7 +2935,7 @@ struct qaMatchEff {
         } else {
           //
           // only secondaries from material
-          if (trkWTPC && isTrackSelectedTPCCuts(track)) {
+          if (trkWTPC && isTPCSelected) {
             // histos.get<TH1>(HIST("MC/primsec/zDCA_tpc_secm"))->Fill(track.dcaZ());
             // histos.get<TH1>(HIST("MC/primsec/xyDCA_tpc_secm"))->Fill(track.dcaXY());
             //
@@ -2927,7 +2943,7 @@ struct qaMatchEff {
             histos.get<TH1>(HIST("MC/primsec/pthist_tpc_secm"))->Fill(trackPt);
             histos.get<TH1>(HIST("MC/primsec/phihist_tpc_secm"))->Fill(track.phi());
             histos.get<TH1>(HIST("MC/primsec/etahist_tpc_secm"))->Fill(track.eta());
-            if (trkWITS && isTrackSelectedITSCuts(track)) {
+            if (trkWITS && isITSSelected) {
               // histos.get<TH1>(HIST("MC/primsec/zDCA_tpcits_secm"))->Fill(track.dcaZ());
               // histos.get<TH1>(HIST("MC/primsec/xyDCA_tpcits_secm"))->Fill(track.dcaXY());
               //
@@ -2941,7 +2957,7 @@ struct qaMatchEff {
         //
         // protons only
         if (tpPDGCode == 2212) {
-          if (trkWTPC && isTrackSelectedTPCCuts(track)) {
+          if (trkWTPC && isTPCSelected) {
             //
             // TPC clusters
             histos.get<TH1>(HIST("MC/TPCclust/tpcNClsFound_prMC_tpc"))->Fill(clustpc);
@@ -2972,7 +2988,7 @@ struct qaMatchEff {
               histos.get<TH1>(HIST("MC/PID/phihist_tpc_prminus"))->Fill(track.phi());
               histos.get<TH1>(HIST("MC/PID/etahist_tpc_prminus"))->Fill(track.eta());
             }
-            if (trkWITS && isTrackSelectedITSCuts(track)) {
+            if (trkWITS && isITSSelected) {
               //
               // TPC clusters
               histos.get<TH1>(HIST("MC/TPCclust/tpcNClsFound_prMC_tpcits"))->Fill(clustpc);
@@ -3009,7 +3025,7 @@ struct qaMatchEff {
         //
         // pions only
         if (tpPDGCode == 211) {
-          if (trkWTPC && isTrackSelectedTPCCuts(track)) {
+          if (trkWTPC && isTPCSelected) {
             //
             // TPC clusters
             histos.get<TH1>(HIST("MC/TPCclust/tpcNClsFound_piMC_tpc"))->Fill(clustpc);
@@ -3040,7 +3056,7 @@ struct qaMatchEff {
               histos.get<TH1>(HIST("MC/PID/phihist_tpc_piminus"))->Fill(track.phi());
               histos.get<TH1>(HIST("MC/PID/etahist_tpc_piminus"))->Fill(track.eta());
             }
-            if (trkWITS && isTrackSelectedITSCuts(track)) {
+            if (trkWITS && isITSSelected) {
               //
               // TPC clusters
               histos.get<TH1>(HIST("MC/TPCclust/tpcNClsFound_piMC_tpcits"))->Fill(clustpc);
@@ -3076,11 +3092,11 @@ struct qaMatchEff {
           //
           // only primary pions
           if (mcpart.isPhysicalPrimary()) {
-            if (trkWTPC && isTrackSelectedTPCCuts(track)) {
+            if (trkWTPC && isTPCSelected) {
               histos.get<TH1>(HIST("MC/PID/pthist_tpc_pi_prim"))->Fill(trackPt);
               histos.get<TH1>(HIST("MC/PID/phihist_tpc_pi_prim"))->Fill(track.phi());
               histos.get<TH1>(HIST("MC/PID/etahist_tpc_pi_prim"))->Fill(track.eta());
-              if (trkWITS && isTrackSelectedITSCuts(track)) {
+              if (trkWITS && isITSSelected) {
                 histos.get<TH1>(HIST("MC/PID/pthist_tpcits_pi_prim"))->Fill(trackPt);
                 histos.get<TH1>(HIST("MC/PID/phihist_tpcits_pi_prim"))->Fill(track.phi());
                 histos.get<TH1>(HIST("MC/PID/etahist_tpcits_pi_prim"))->Fill(track.eta());
@@ -3090,11 +3106,11 @@ struct qaMatchEff {
           } else if (mcpart.getProcess() == 4) {
             //
             // only secondary pions from decay
-            if (trkWTPC && isTrackSelectedTPCCuts(track)) {
+            if (trkWTPC && isTPCSelected) {
               histos.get<TH1>(HIST("MC/PID/pthist_tpc_pi_secd"))->Fill(trackPt);
               histos.get<TH1>(HIST("MC/PID/phihist_tpc_pi_secd"))->Fill(track.phi());
               histos.get<TH1>(HIST("MC/PID/etahist_tpc_pi_secd"))->Fill(track.eta());
-              if (trkWITS && isTrackSelectedITSCuts(track)) {
+              if (trkWITS && isITSSelected) {
                 histos.get<TH1>(HIST("MC/PID/pthist_tpcits_pi_secd"))->Fill(trackPt);
                 histos.get<TH1>(HIST("MC/PID/phihist_tpcits_pi_secd"))->Fill(track.phi());
                 histos.get<TH1>(HIST("MC/PID/etahist_tpcits_pi_secd"))->Fill(track.eta());
@@ -3104,11 +3120,11 @@ struct qaMatchEff {
           } else {
             //
             // only secondary pions from material
-            if (trkWTPC && isTrackSelectedTPCCuts(track)) {
+            if (trkWTPC && isTPCSelected) {
               histos.get<TH1>(HIST("MC/PID/pthist_tpc_pi_secm"))->Fill(trackPt);
               histos.get<TH1>(HIST("MC/PID/phihist_tpc_pi_secm"))->Fill(track.phi());
               histos.get<TH1>(HIST("MC/PID/etahist_tpc_pi_secm"))->Fill(track.eta());
-              if (trkWITS && isTrackSelectedITSCuts(track)) {
+              if (trkWITS && isITSSelected) {
                 histos.get<TH1>(HIST("MC/PID/pthist_tpcits_pi_secm"))->Fill(trackPt);
                 histos.get<TH1>(HIST("MC/PID/phihist_tpcits_pi_secm"))->Fill(track.phi());
                 histos.get<TH1>(HIST("MC/PID/etahist_tpcits_pi_secm"))->Fill(track.eta());
@@ -3128,12 +3144,12 @@ struct qaMatchEff {
           else
             pdg_fill = -10.0;
           //
-          if (trkWTPC && isTrackSelectedTPCCuts(track)) {
+          if (trkWTPC && isTPCSelected) {
             histos.get<TH1>(HIST("MC/PID/pthist_tpc_nopi"))->Fill(trackPt);
             histos.get<TH1>(HIST("MC/PID/phihist_tpc_nopi"))->Fill(track.phi());
             histos.get<TH1>(HIST("MC/PID/etahist_tpc_nopi"))->Fill(track.eta());
             histos.get<TH1>(HIST("MC/PID/pdghist_den"))->Fill(pdg_fill);
-            if (trkWITS && isTrackSelectedITSCuts(track)) {
+            if (trkWITS && isITSSelected) {
               histos.get<TH1>(HIST("MC/PID/pthist_tpcits_nopi"))->Fill(trackPt);
               histos.get<TH1>(HIST("MC/PID/phihist_tpcits_nopi"))->Fill(track.phi());
               histos.get<TH1>(HIST("MC/PID/etahist_tpcits_nopi"))->Fill(track.eta());
@@ -3144,7 +3160,7 @@ struct qaMatchEff {
         //
         // kaons only
         if (tpPDGCode == 321) {
-          if (trkWTPC && isTrackSelectedTPCCuts(track)) {
+          if (trkWTPC && isTPCSelected) {
             //
             // TPC clusters
             histos.get<TH1>(HIST("MC/TPCclust/tpcNClsFound_kaMC_tpc"))->Fill(clustpc);
@@ -3175,7 +3191,7 @@ struct qaMatchEff {
               histos.get<TH1>(HIST("MC/PID/phihist_tpc_kaminus"))->Fill(track.phi());
               histos.get<TH1>(HIST("MC/PID/etahist_tpc_kaminus"))->Fill(track.eta());
             }
-            if (trkWITS && isTrackSelectedITSCuts(track)) {
+            if (trkWITS && isITSSelected) {
               //
               // TPC clusters
               histos.get<TH1>(HIST("MC/TPCclust/tpcNClsFound_kaMC_tpcits"))->Fill(clustpc);
@@ -3212,11 +3228,11 @@ struct qaMatchEff {
         //
         // pions and kaons together
         if (tpPDGCode == 211 || tpPDGCode == 321) {
-          if (trkWTPC && isTrackSelectedTPCCuts(track)) {
+          if (trkWTPC && isTPCSelected) {
             histos.get<TH1>(HIST("MC/PID/pthist_tpc_piK"))->Fill(trackPt);
             histos.get<TH1>(HIST("MC/PID/phihist_tpc_piK"))->Fill(track.phi());
             histos.get<TH1>(HIST("MC/PID/etahist_tpc_piK"))->Fill(track.eta());
-            if (trkWITS && isTrackSelectedITSCuts(track)) {
+            if (trkWITS && isITSSelected) {
               histos.get<TH1>(HIST("MC/PID/pthist_tpcits_piK"))->Fill(trackPt);
               histos.get<TH1>(HIST("MC/PID/phihist_tpcits_piK"))->Fill(track.phi());
               histos.get<TH1>(HIST("MC/PID/etahist_tpcits_piK"))->Fill(track.eta());
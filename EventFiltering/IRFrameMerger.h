@@ -0,0 +1,60 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//
+
+#ifndef EVENTFILTERING_IRFRAMEMERGER_H_
+#define EVENTFILTERING_IRFRAMEMERGER_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "CommonDataFormat/IRFrame.h"
+
+/// Union of BC ranges built while they are added, without a global sort.
+/// The merged ranges are kept sorted and disjoint; ranges that overlap or touch are merged, as
+/// when merging the sorted list. A new range is compared with the merged ranges from the back,
+/// so the work is proportional to how far it arrives out of order: for frames coming from
+/// time-ordered collisions only the last few ranges are visited.
+/// clear() keeps the memory, so one instance can be reused for every TF.
+class IRFrameMerger
+{
+ public:
+  void add(const o2::dataformats::IRFrame& frame)
+  {
+    // the merged ranges ending at or after the start of the frame are a suffix [first, end)
+    std::size_t first = mMerged.size();
+    while (first > 0 && mMerged[first - 1].getMax() >= frame.getMin()) {
+      --first;
+    }
+    // among them, those starting at or before its end overlap it
+    std::size_t last = first;
+    while (last < mMerged.size() && mMerged[last].getMin() <= frame.getMax()) {
+      ++last;
+    }
+    if (first == last) {
+      mMerged.insert(mMerged.begin() + first, frame);
+      return;
+    }
+    mMerged[first].getMin() = std::min(mMerged[first].getMin(), frame.getMin());
+    mMerged[first].getMax() = std::max(mMerged[last - 1].getMax(), frame.getMax());
+    mMerged.erase(mMerged.begin() + first + 1, mMerged.begin() + last);
+  }
+
+  const std::vector<o2::dataformats::IRFrame>& getMerged() const { return mMerged; }
+  bool empty() const { return mMerged.empty(); }
+  void clear() { mMerged.clear(); }
+
+ private:
+  std::vector<o2::dataformats::IRFrame> mMerged; /// Merged ranges, sorted and disjoint
+};
+
+#endif // EVENTFILTERING_IRFRAMEMERGER_H_
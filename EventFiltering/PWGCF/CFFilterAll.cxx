@@ -253,6 +253,7 @@ struct CFFilterAll {
                                               cf_trigger::limitNames,
                                               cf_trigger::filterNames},
                                              "Limits for trigger. Tight limit without downsampling and loose with downsampling"};
+    Configurable<bool> skipUnusedCandidates{"skipUnusedCandidates", true, "Build the lambda, phi and rho candidates only in events where they can enter an enabled trigger (their QA is then filled only for these events)"};
   } TriggerSelections;
 
   struct : ConfigurableGroup {
@@ -320,8 +321,18 @@ struct CFFilterAll {
   std::array<int, cf_trigger::kNTriggers> signalTightLimit;
   std::array<int, cf_trigger::kNTriggers> signalLooseLimit;
 
+  // trigger switches and limits, looked up once instead of by label in the candidate loops
+  std::array<bool, cf_trigger::kNTriggers> triggerSwitches;
+  std::array<float, cf_trigger::kNTriggers> triggerTightLimits;
+  std::array<float, cf_trigger::kNTriggers> triggerLooseLimits;
+
   void init(o2::framework::InitContext&)
   {
+    for (int iTrigger = 0; iTrigger < cf_trigger::kNTriggers; iTrigger++) {
+      triggerSwitches[iTrigger] = TriggerSelections.filterSwitches->get("Switch", cf_trigger::filterNames[iTrigger].c_str()) > 0;
+      triggerTightLimits[iTrigger] = TriggerSelections.limits->get("Tight Limit", cf_trigger::filterNames[iTrigger].c_str());
+      triggerLooseLimits[iTrigger] = TriggerSelections.limits->get("Loose Limit", cf_trigger::filterNames[iTrigger].c_str());
+    }
 
     // setup strangeness builder
     mStraHelper.v0selections.minCrossedRows = V0BuilderOpts.minCrossedRows.value;
@@ -1664,130 +1675,140 @@ struct CFFilterAll {
       }
     }
 
+    // build only the candidates that can still enter an enabled trigger, given the selected (anti)protons and (anti)deuterons
+    const bool twoProtons = vecProton.size() >= 2 || vecAntiProton.size() >= 2;
+    const bool anyProton = !vecProton.empty() || !vecAntiProton.empty();
+    const bool anyDeuteron = !vecDeuteron.empty() || !vecAntiDeuteron.empty();
+    const bool buildLambdas = !TriggerSelections.skipUnusedCandidates || triggerSwitches[cf_trigger::kLLL] || (triggerSwitches[cf_trigger::kPPL] && twoProtons) || (triggerSwitches[cf_trigger::kPLL] && anyProton) || (triggerSwitches[cf_trigger::kLD] && anyDeuteron);
+    const bool buildPhis = !TriggerSelections.skipUnusedCandidates || (triggerSwitches[cf_trigger::kPPPhi] && twoProtons) || (triggerSwitches[cf_trigger::kPhiD] && anyDeuteron);
+    const bool buildRhos = !TriggerSelections.skipUnusedCandidates || (triggerSwitches[cf_trigger::kPPRho] && twoProtons) || (triggerSwitches[cf_trigger::kRhoD] && anyDeuteron);
+
     // loop over and build v0s
-    for (auto const& v0 : v0s) {
+    if (buildLambdas) {
+      for (auto const& v0 : v0s) {
 
-      auto posTrack = v0.posTrack_as<cf_trigger::FullTracks>();
-      auto negTrack = v0.negTrack_as<cf_trigger::FullTracks>();
+        auto posTrack = v0.posTrack_as<cf_trigger::FullTracks>();
+        auto negTrack = v0.negTrack_as<cf_trigger::FullTracks>();
 
-      auto posTrackPar = getTrackParCov(posTrack);
-      auto negTrackPar = getTrackParCov(negTrack);
+        auto posTrackPar = getTrackParCov(posTrack);
+        auto negTrackPar = getTrackParCov(negTrack);
 
-      if (!mStraHelper.buildV0Candidate(v0.collisionId(), col.posX(), col.posY(), col.posZ(), posTrack, negTrack, posTrackPar, negTrackPar, false, false, false)) {
-        continue;
-      }
+        if (!mStraHelper.buildV0Candidate(v0.collisionId(), col.posX(), col.posY(), col.posZ(), posTrack, negTrack, posTrackPar, negTrackPar, false, false, false)) {
+          continue;
+        }
 
-      float lambdaPt = std::hypot(mStraHelper.v0.momentum[0], mStraHelper.v0.momentum[1]);
-      float lambdaPos = std::hypot(mStraHelper.v0.position[0] - col.posX(), mStraHelper.v0.position[1] - col.posY(), mStraHelper.v0.position[2] - col.posZ());
-      float lambdaRadius = std::hypot(mStraHelper.v0.position[0], mStraHelper.v0.position[1]);
-      float lambdaEta = RecoDecay::eta(std::array{mStraHelper.v0.momentum[0], mStraHelper.v0.momentum[1], mStraHelper.v0.momentum[2]});
-      float lambdaPhi = RecoDecay::phi(mStraHelper.v0.momentum[0], mStraHelper.v0.momentum[1]);
-      float lambdaCpa = std::cos(mStraHelper.v0.pointingAngle);
-      float lambdaDauDca = mStraHelper.v0.daughterDCA;
-      float lambdaMass = mStraHelper.v0.massLambda;
-      float antiLambdaMass = mStraHelper.v0.massAntiLambda;
-      float kaonMass = mStraHelper.v0.massK0Short;
-
-      float posTrackEta = RecoDecay::eta(std::array{mStraHelper.v0.positiveMomentum[0], mStraHelper.v0.positiveMomentum[1], mStraHelper.v0.positiveMomentum[2]});
-      float posTrackDca = mStraHelper.v0.positiveDCAxy;
-      float negTrackEta = RecoDecay::eta(std::array{mStraHelper.v0.negativeMomentum[0], mStraHelper.v0.negativeMomentum[1], mStraHelper.v0.negativeMomentum[2]});
-      float negTrackDca = mStraHelper.v0.negativeDCAxy;
-
-      registryParticleQA.fill(HIST("LambdaQA/Before/fPt"), lambdaPt);
-      registryParticleQA.fill(HIST("LambdaQA/Before/fEta"), lambdaEta);
-      registryParticleQA.fill(HIST("LambdaQA/Before/fPhi"), lambdaPhi);
-      registryParticleQA.fill(HIST("LambdaQA/Before/fInvMassLambda"), lambdaMass);
-      registryParticleQA.fill(HIST("LambdaQA/Before/fInvMassAntiLambda"), antiLambdaMass);
-      registryParticleQA.fill(HIST("LambdaQA/Before/fInvMassLambdaVsAntiLambda"), lambdaMass, antiLambdaMass);
-      registryParticleQA.fill(HIST("LambdaQA/Before/fInvMassLambdaVsKaon"), lambdaMass, kaonMass);
-      registryParticleQA.fill(HIST("LambdaQA/Before/fInvMassAntiLambdaVsKaon"), antiLambdaMass, kaonMass);
-      registryParticleQA.fill(HIST("LambdaQA/Before/fDcaDaugh"), lambdaDauDca);
-      registryParticleQA.fill(HIST("LambdaQA/Before/fCpa"), lambdaCpa);
-      registryParticleQA.fill(HIST("LambdaQA/Before/fTranRad"), lambdaRadius);
-      registryParticleQA.fill(HIST("LambdaQA/Before/fDecVtx"), lambdaPos);
-
-      registryParticleQA.fill(HIST("LambdaQA/Before/PosDaughter/fPt"), posTrack.pt());
-      registryParticleQA.fill(HIST("LambdaQA/Before/PosDaughter/fEta"), posTrackEta);
-      registryParticleQA.fill(HIST("LambdaQA/Before/PosDaughter/fPhi"), posTrack.phi());
-      registryParticleQA.fill(HIST("LambdaQA/Before/PosDaughter/fDcaXy"), posTrack.pt(), posTrackDca);
-      registryParticleQA.fill(HIST("LambdaQA/Before/PosDaughter/fTpcClusters"), posTrack.tpcNClsFound());
-      registryParticleQA.fill(HIST("LambdaQA/Before/PosDaughter/fNsigmaTpcProton"), posTrack.p(), posTrack.tpcNSigmaPr());
-      registryParticleQA.fill(HIST("LambdaQA/Before/PosDaughter/fNsigmaTpcPion"), posTrack.p(), posTrack.tpcNSigmaPi());
-
-      registryParticleQA.fill(HIST("LambdaQA/Before/NegDaughter/fPt"), negTrack.pt());
-      registryParticleQA.fill(HIST("LambdaQA/Before/NegDaughter/fEta"), negTrackEta);
-      registryParticleQA.fill(HIST("LambdaQA/Before/NegDaughter/fPhi"), negTrack.phi());
-      registryParticleQA.fill(HIST("LambdaQA/Before/NegDaughter/fDcaXy"), negTrack.pt(), negTrackDca);
-      registryParticleQA.fill(HIST("LambdaQA/Before/NegDaughter/fTpcClusters"), negTrack.tpcNClsFound());
-      registryParticleQA.fill(HIST("LambdaQA/Before/NegDaughter/fNsigmaTpcProton"), negTrack.p(), negTrack.tpcNSigmaPr());
-      registryParticleQA.fill(HIST("LambdaQA/Before/NegDaughter/fNsigmaTpcPion"), negTrack.p(), negTrack.tpcNSigmaPi());
-
-      if (checkLambda(lambdaPt, lambdaDauDca, lambdaCpa, lambdaRadius, lambdaPos, kaonMass, lambdaMass) && checkLambdaDaughter(posTrack, posTrackEta, posTrackDca, posTrack.tpcNSigmaPr()) && checkLambdaDaughter(negTrack, negTrackEta, negTrackDca, negTrack.tpcNSigmaPi())) {
-        vecLambda.emplace_back(lambdaPt, lambdaEta, lambdaPhi, o2::constants::physics::MassLambda0);
-        idxLambdaDaughProton.push_back(posTrack.globalIndex());
-        idxLambdaDaughPion.push_back(negTrack.globalIndex());
-
-        registryParticleQA.fill(HIST("LambdaQA/After/Lambda/fPt"), lambdaPt);
-        registryParticleQA.fill(HIST("LambdaQA/After/Lambda/fEta"), lambdaEta);
-        registryParticleQA.fill(HIST("LambdaQA/After/Lambda/fPhi"), lambdaPhi);
-        registryParticleQA.fill(HIST("LambdaQA/After/Lambda/fInvMass"), lambdaMass);
-        registryParticleQA.fill(HIST("LambdaQA/After/Lambda/fInvMassLambdaVsAntiLambda"), lambdaMass, antiLambdaMass);
-        registryParticleQA.fill(HIST("LambdaQA/After/Lambda/fInvMassLambdaVsKaon"), lambdaMass, kaonMass);
-        registryParticleQA.fill(HIST("LambdaQA/After/Lambda/fDcaDaugh"), lambdaDauDca);
-        registryParticleQA.fill(HIST("LambdaQA/After/Lambda/fCpa"), lambdaCpa);
-        registryParticleQA.fill(HIST("LambdaQA/After/Lambda/fTranRad"), lambdaRadius);
-        registryParticleQA.fill(HIST("LambdaQA/After/Lambda/fDecVtx"), lambdaPos);
-
-        registryParticleQA.fill(HIST("LambdaQA/After/Lambda/PosDaughter/fPt"), posTrack.pt());
-        registryParticleQA.fill(HIST("LambdaQA/After/Lambda/PosDaughter/fEta"), posTrackEta);
-        registryParticleQA.fill(HIST("LambdaQA/After/Lambda/PosDaughter/fPhi"), posTrack.phi());
-        registryParticleQA.fill(HIST("LambdaQA/After/Lambda/PosDaughter/fDcaXy"), posTrack.pt(), posTrackDca);
-        registryParticleQA.fill(HIST("LambdaQA/After/Lambda/PosDaughter/fTpcClusters"), posTrack.tpcNClsFound());
-        registryParticleQA.fill(HIST("LambdaQA/After/Lambda/PosDaughter/fNsigmaTpc"), posTrack.p(), posTrack.tpcNSigmaPr());
-
-        registryParticleQA.fill(HIST("LambdaQA/After/Lambda/NegDaughter/fPt"), negTrack.pt());
-        registryParticleQA.fill(HIST("LambdaQA/After/Lambda/NegDaughter/fEta"), negTrackEta);
-        registryParticleQA.fill(HIST("LambdaQA/After/Lambda/NegDaughter/fPhi"), negTrack.phi());
-        registryParticleQA.fill(HIST("LambdaQA/After/Lambda/NegDaughter/fDcaXy"), negTrack.pt(), negTrackDca);
-        registryParticleQA.fill(HIST("LambdaQA/After/Lambda/NegDaughter/fTpcClusters"), negTrack.tpcNClsFound());
-        registryParticleQA.fill(HIST("LambdaQA/After/Lambda/NegDaughter/fNsigmaTpc"), negTrack.p(), negTrack.tpcNSigmaPi());
-      }
+        float lambdaPt = std::hypot(mStraHelper.v0.momentum[0], mStraHelper.v0.momentum[1]);
+        float lambdaPos = std::hypot(mStraHelper.v0.position[0] - col.posX(), mStraHelper.v0.position[1] - col.posY(), mStraHelper.v0.position[2] - col.posZ());
+        float lambdaRadius = std::hypot(mStraHelper.v0.position[0], mStraHelper.v0.position[1]);
+        float lambdaEta = RecoDecay::eta(std::array{mStraHelper.v0.momentum[0], mStraHelper.v0.momentum[1], mStraHelper.v0.momentum[2]});
+        float lambdaPhi = RecoDecay::phi(mStraHelper.v0.momentum[0], mStraHelper.v0.momentum[1]);
+        float lambdaCpa = std::cos(mStraHelper.v0.pointingAngle);
+        float lambdaDauDca = mStraHelper.v0.daughterDCA;
+        float lambdaMass = mStraHelper.v0.massLambda;
+        float antiLambdaMass = mStraHelper.v0.massAntiLambda;
+        float kaonMass = mStraHelper.v0.massK0Short;
+
+        float posTrackEta = RecoDecay::eta(std::array{mStraHelper.v0.positiveMomentum[0], mStraHelper.v0.positiveMomentum[1], mStraHelper.v0.positiveMomentum[2]});
+        float posTrackDca = mStraHelper.v0.positiveDCAxy;
+        float negTrackEta = RecoDecay::eta(std::array{mStraHelper.v0.negativeMomentum[0], mStraHelper.v0.negativeMomentum[1], mStraHelper.v0.negativeMomentum[2]});
+        float negTrackDca = mStraHelper.v0.negativeDCAxy;
+
+        registryParticleQA.fill(HIST("LambdaQA/Before/fPt"), lambdaPt);
+        registryParticleQA.fill(HIST("LambdaQA/Before/fEta"), lambdaEta);
+        registryParticleQA.fill(HIST("LambdaQA/Before/fPhi"), lambdaPhi);
+        registryParticleQA.fill(HIST("LambdaQA/Before/fInvMassLambda"), lambdaMass);
+        registryParticleQA.fill(HIST("LambdaQA/Before/fInvMassAntiLambda"), antiLambdaMass);
+        registryParticleQA.fill(HIST("LambdaQA/Before/fInvMassLambdaVsAntiLambda"), lambdaMass, antiLambdaMass);
+        registryParticleQA.fill(HIST("LambdaQA/Before/fInvMassLambdaVsKaon"), lambdaMass, kaonMass);
+        registryParticleQA.fill(HIST("LambdaQA/Before/fInvMassAntiLambdaVsKaon"), antiLambdaMass, kaonMass);
+        registryParticleQA.fill(HIST("LambdaQA/Before/fDcaDaugh"), lambdaDauDca);
+        registryParticleQA.fill(HIST("LambdaQA/Before/fCpa"), lambdaCpa);
+        registryParticleQA.fill(HIST("LambdaQA/Before/fTranRad"), lambdaRadius);
+        registryParticleQA.fill(HIST("LambdaQA/Before/fDecVtx"), lambdaPos);
+
+        registryParticleQA.fill(HIST("LambdaQA/Before/PosDaughter/fPt"), posTrack.pt());
+        registryParticleQA.fill(HIST("LambdaQA/Before/PosDaughter/fEta"), posTrackEta);
+        registryParticleQA.fill(HIST("LambdaQA/Before/PosDaughter/fPhi"), posTrack.phi());
+        registryParticleQA.fill(HIST("LambdaQA/Before/PosDaughter/fDcaXy"), posTrack.pt(), posTrackDca);
+        registryParticleQA.fill(HIST("LambdaQA/Before/PosDaughter/fTpcClusters"), posTrack.tpcNClsFound());
+        registryParticleQA.fill(HIST("LambdaQA/Before/PosDaughter/fNsigmaTpcProton"), posTrack.p(), posTrack.tpcNSigmaPr());
+        registryParticleQA.fill(HIST("LambdaQA/Before/PosDaughter/fNsigmaTpcPion"), posTrack.p(), posTrack.tpcNSigmaPi());
+
+        registryParticleQA.fill(HIST("LambdaQA/Before/NegDaughter/fPt"), negTrack.pt());
+        registryParticleQA.fill(HIST("LambdaQA/Before/NegDaughter/fEta"), negTrackEta);
+        registryParticleQA.fill(HIST("LambdaQA/Before/NegDaughter/fPhi"), negTrack.phi());
+        registryParticleQA.fill(HIST("LambdaQA/Before/NegDaughter/fDcaXy"), negTrack.pt(), negTrackDca);
+        registryParticleQA.fill(HIST("LambdaQA/Before/NegDaughter/fTpcClusters"), negTrack.tpcNClsFound());
+        registryParticleQA.fill(HIST("LambdaQA/Before/NegDaughter/fNsigmaTpcProton"), negTrack.p(), negTrack.tpcNSigmaPr());
+        registryParticleQA.fill(HIST("LambdaQA/Before/NegDaughter/fNsigmaTpcPion"), negTrack.p(), negTrack.tpcNSigmaPi());
+
+        if (checkLambda(lambdaPt, lambdaDauDca, lambdaCpa, lambdaRadius, lambdaPos, kaonMass, lambdaMass) && checkLambdaDaughter(posTrack, posTrackEta, posTrackDca, posTrack.tpcNSigmaPr()) && checkLambdaDaughter(negTrack, negTrackEta, negTrackDca, negTrack.tpcNSigmaPi())) {
+          vecLambda.emplace_back(lambdaPt, lambdaEta, lambdaPhi, o2::constants::physics::MassLambda0);
+          idxLambdaDaughProton.push_back(posTrack.globalIndex());
+          idxLambdaDaughPion.push_back(negTrack.globalIndex());
+
+          registryParticleQA.fill(HIST("LambdaQA/After/Lambda/fPt"), lambdaPt);
+          registryParticleQA.fill(HIST("LambdaQA/After/Lambda/fEta"), lambdaEta);
+          registryParticleQA.fill(HIST("LambdaQA/After/Lambda/fPhi"), lambdaPhi);
+          registryParticleQA.fill(HIST("LambdaQA/After/Lambda/fInvMass"), lambdaMass);
+          registryParticleQA.fill(HIST("LambdaQA/After/Lambda/fInvMassLambdaVsAntiLambda"), lambdaMass, antiLambdaMass);
+          registryParticleQA.fill(HIST("LambdaQA/After/Lambda/fInvMassLambdaVsKaon"), lambdaMass, kaonMass);
+          registryParticleQA.fill(HIST("LambdaQA/After/Lambda/fDcaDaugh"), lambdaDauDca);
+          registryParticleQA.fill(HIST("LambdaQA/After/Lambda/fCpa"), lambdaCpa);
+          registryParticleQA.fill(HIST("LambdaQA/After/Lambda/fTranRad"), lambdaRadius);
+          registryParticleQA.fill(HIST("LambdaQA/After/Lambda/fDecVtx"), lambdaPos);
+
+          registryParticleQA.fill(HIST("LambdaQA/After/Lambda/PosDaughter/fPt"), posTrack.pt());
+          registryParticleQA.fill(HIST("LambdaQA/After/Lambda/PosDaughter/fEta"), posTrackEta);
+          registryParticleQA.fill(HIST("LambdaQA/After/Lambda/PosDaughter/fPhi"), posTrack.phi());
+          registryParticleQA.fill(HIST("LambdaQA/After/Lambda/PosDaughter/fDcaXy"), posTrack.pt(), posTrackDca);
+          registryParticleQA.fill(HIST("LambdaQA/After/Lambda/PosDaughter/fTpcClusters"), posTrack.tpcNClsFound());
+          registryParticleQA.fill(HIST("LambdaQA/After/Lambda/PosDaughter/fNsigmaTpc"), posTrack.p(), posTrack.tpcNSigmaPr());
+
+          registryParticleQA.fill(HIST("LambdaQA/After/Lambda/NegDaughter/fPt"), negTrack.pt());
+          registryParticleQA.fill(HIST("LambdaQA/After/Lambda/NegDaughter/fEta"), negTrackEta);
+          registryParticleQA.fill(HIST("LambdaQA/After/Lambda/NegDaughter/fPhi"), negTrack.phi());
+          registryParticleQA.fill(HIST("LambdaQA/After/Lambda/NegDaughter/fDcaXy"), negTrack.pt(), negTrackDca);
+          registryParticleQA.fill(HIST("LambdaQA/After/Lambda/NegDaughter/fTpcClusters"), negTrack.tpcNClsFound());
+          registryParticleQA.fill(HIST("LambdaQA/After/Lambda/NegDaughter/fNsigmaTpc"), negTrack.p(), negTrack.tpcNSigmaPi());
+        }
 
-      if (checkLambda(lambdaPt, lambdaDauDca, lambdaCpa, lambdaRadius, lambdaPos, kaonMass, antiLambdaMass) && checkLambdaDaughter(posTrack, posTrackEta, posTrackDca, posTrack.tpcNSigmaPi()) && checkLambdaDaughter(negTrack, negTrackEta, negTrackDca, negTrack.tpcNSigmaPr())) {
-        vecAntiLambda.emplace_back(lambdaPt, lambdaEta, lambdaPhi, o2::constants::physics::MassLambda0);
-
-        idxAntiLambdaDaughProton.push_back(negTrack.globalIndex());
-        idxAntiLambdaDaughPion.push_back(posTrack.globalIndex());
-
-        registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/fPt"), lambdaPt);
-        registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/fEta"), lambdaEta);
-        registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/fPhi"), lambdaPhi);
-        registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/fInvMass"), antiLambdaMass);
-        registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/fInvMassAntiLambdaVsLambda"), antiLambdaMass, lambdaMass);
-        registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/fInvMassAntiLambdaVsKaon"), antiLambdaMass, kaonMass);
-        registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/fDcaDaugh"), lambdaDauDca);
-        registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/fCpa"), lambdaCpa);
-        registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/fTranRad"), lambdaRadius);
-        registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/fDecVtx"), lambdaPos);
-
-        registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/PosDaughter/fPt"), posTrack.pt());
-        registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/PosDaughter/fEta"), posTrackEta);
-        registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/PosDaughter/fPhi"), posTrack.phi());
-        registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/PosDaughter/fDcaXy"), posTrack.pt(), posTrackDca);
-        registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/PosDaughter/fTpcClusters"), posTrack.tpcNClsFound());
-        registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/PosDaughter/fNsigmaTpc"), posTrack.p(), posTrack.tpcNSigmaPr());
-
-        registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/NegDaughter/fPt"), negTrack.pt());
-        registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/NegDaughter/fEta"), negTrackEta);
-        registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/NegDaughter/fPhi"), negTrack.phi());
-        registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/NegDaughter/fDcaXy"), negTrack.pt(), negTrackDca);
-        registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/NegDaughter/fTpcClusters"), negTrack.tpcNClsFound());
-        registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/NegDaughter/fNsigmaTpc"), negTrack.p(), negTrack.tpcNSigmaPi());
+        if (checkLambda(lambdaPt, lambdaDauDca, lambdaCpa, lambdaRadius, lambdaPos, kaonMass, antiLambdaMass) && checkLambdaDaughter(posTrack, posTrackEta, posTrackDca, posTrack.tpcNSigmaPi()) && checkLambdaDaughter(negTrack, negTrackEta, negTrackDca, negTrack.tpcNSigmaPr())) {
+          vecAntiLambda.emplace_back(lambdaPt, lambdaEta, lambdaPhi, o2::constants::physics::MassLambda0);
+
+          idxAntiLambdaDaughProton.push_back(negTrack.globalIndex());
+          idxAntiLambdaDaughPion.push_back(posTrack.globalIndex());
+
+          registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/fPt"), lambdaPt);
+          registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/fEta"), lambdaEta);
+          registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/fPhi"), lambdaPhi);
+          registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/fInvMass"), antiLambdaMass);
+          registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/fInvMassAntiLambdaVsLambda"), antiLambdaMass, lambdaMass);
+          registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/fInvMassAntiLambdaVsKaon"), antiLambdaMass, kaonMass);
+          registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/fDcaDaugh"), lambdaDauDca);
+          registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/fCpa"), lambdaCpa);
+          registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/fTranRad"), lambdaRadius);
+          registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/fDecVtx"), lambdaPos);
+
+          registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/PosDaughter/fPt"), posTrack.pt());
+          registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/PosDaughter/fEta"), posTrackEta);
+          registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/PosDaughter/fPhi"), posTrack.phi());
+          registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/PosDaughter/fDcaXy"), posTrack.pt(), posTrackDca);
+          registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/PosDaughter/fTpcClusters"), posTrack.tpcNClsFound());
+          registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/PosDaughter/fNsigmaTpc"), posTrack.p(), posTrack.tpcNSigmaPr());
+
+          registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/NegDaughter/fPt"), negTrack.pt());
+          registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/NegDaughter/fEta"), negTrackEta);
+          registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/NegDaughter/fPhi"), negTrack.phi());
+          registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/NegDaughter/fDcaXy"), negTrack.pt(), negTrackDca);
+          registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/NegDaughter/fTpcClusters"), negTrack.tpcNClsFound());
+          registryParticleQA.fill(HIST("LambdaQA/After/AntiLambda/NegDaughter/fNsigmaTpc"), negTrack.p(), negTrack.tpcNSigmaPi());
+        }
       }
     }
 
     // build phi candidates
-    for (size_t k1 = 0; k1 < vecKaon.size(); k1++) {
+    for (size_t k1 = 0; buildPhis && k1 < vecKaon.size(); k1++) {
       for (size_t k2 = 0; k2 < vecAntiKaon.size(); k2++) {
         ROOT::Math::PtEtaPhiMVector phi = vecKaon.at(k1) + vecAntiKaon.at(k2);
 
@@ -1811,7 +1832,7 @@ struct CFFilterAll {
     }
 
     // build rho candidates
-    for (size_t p1 = 0; p1 < vecPion.size(); p1++) {
+    for (size_t p1 = 0; buildRhos && p1 < vecPion.size(); p1++) {
       for (size_t p2 = 0; p2 < vecAntiPion.size(); p2++) {
         ROOT::Math::PtEtaPhiMVector rho = vecPion.at(p1) + vecAntiPion.at(p2);
 
@@ -1836,7 +1857,7 @@ struct CFFilterAll {
     float q3 = 999.f, kstar = 999.f;
 
     // PPP
-    if (TriggerSelections.filterSwitches->get("Switch", "PPP") > 0) {
+    if (triggerSwitches[cf_trigger::kPPP]) {
       for (size_t p1 = 0; p1 < vecProton.size(); p1++) {
         for (size_t p2 = p1 + 1; p2 < vecProton.size(); p2++) {
           for (size_t p3 = p2 + 1; p3 < vecProton.size(); p3++) {
@@ -1847,7 +1868,7 @@ struct CFFilterAll {
             registryTriggerQA.fill(HIST("PPP/all/fProtonQ3VsPt"), q3, vecProton.at(p1).Pt());
             registryTriggerQA.fill(HIST("PPP/all/fProtonQ3VsPt"), q3, vecProton.at(p2).Pt());
             registryTriggerQA.fill(HIST("PPP/all/fProtonQ3VsPt"), q3, vecProton.at(p3).Pt());
-            if (q3 < TriggerSelections.limits->get("Loose Limit", "PPP")) {
+            if (q3 < triggerLooseLimits[cf_trigger::kPPP]) {
               signalLooseLimit[cf_trigger::kPPP] += 1;
               registryTriggerQA.fill(HIST("PPP/loose/fMultiplicity"), col.multNTracksPV());
               registryTriggerQA.fill(HIST("PPP/loose/fZvtx"), col.posZ());
@@ -1855,7 +1876,7 @@ struct CFFilterAll {
               registryTriggerQA.fill(HIST("PPP/loose/fProtonQ3VsPt"), q3, vecProton.at(p1).Pt());
               registryTriggerQA.fill(HIST("PPP/loose/fProtonQ3VsPt"), q3, vecProton.at(p2).Pt());
               registryTriggerQA.fill(HIST("PPP/loose/fProtonQ3VsPt"), q3, vecProton.at(p3).Pt());
-              if (q3 < TriggerSelections.limits->get("Tight Limit", "PPP")) {
+              if (q3 < triggerTightLimits[cf_trigger::kPPP]) {
                 signalTightLimit[cf_trigger::kPPP] += 1;
                 registryTriggerQA.fill(HIST("PPP/tight/fMultiplicity"), col.multNTracksPV());
                 registryTriggerQA.fill(HIST("PPP/tight/fZvtx"), col.posZ());
@@ -1878,7 +1899,7 @@ struct CFFilterAll {
             registryTriggerQA.fill(HIST("PPP/all/fAntiProtonQ3VsPt"), q3, vecAntiProton.at(p1).Pt());
             registryTriggerQA.fill(HIST("PPP/all/fAntiProtonQ3VsPt"), q3, vecAntiProton.at(p2).Pt());
             registryTriggerQA.fill(HIST("PPP/all/fAntiProtonQ3VsPt"), q3, vecAntiProton.at(p3).Pt());
-            if (q3 < TriggerSelections.limits->get("Loose Limit", "PPP")) {
+            if (q3 < triggerLooseLimits[cf_trigger::kPPP]) {
               signalLooseLimit[cf_trigger::kPPP] += 1;
               registryTriggerQA.fill(HIST("PPP/loose/fMultiplicity"), col.multNTracksPV());
               registryTriggerQA.fill(HIST("PPP/loose/fZvtx"), col.posZ());
@@ -1886,7 +1907,7 @@ struct CFFilterAll {
               registryTriggerQA.fill(HIST("PPP/loose/fAntiProtonQ3VsPt"), q3, vecAntiProton.at(p1).Pt());
               registryTriggerQA.fill(HIST("PPP/loose/fAntiProtonQ3VsPt"), q3, vecAntiProton.at(p2).Pt());
               registryTriggerQA.fill(HIST("PPP/loose/fAntiProtonQ3VsPt"), q3, vecAntiProton.at(p3).Pt());
-              if (q3 < TriggerSelections.limits->get("Tight Limit", "PPP")) {
+              if (q3 < triggerTightLimits[cf_trigger::kPPP]) {
                 signalTightLimit[cf_trigger::kPPP] += 1;
                 registryTriggerQA.fill(HIST("PPP/tight/fMultiplicity"), col.multNTracksPV());
                 registryTriggerQA.fill(HIST("PPP/tight/fZvtx"), col.posZ());
@@ -1901,7 +1922,7 @@ struct CFFilterAll {
       }
     }
     // PPL
-    if (TriggerSelections.filterSwitches->get("Switch", "PPL") > 0) {
+    if (triggerSwitches[cf_trigger::kPPL]) {
       for (size_t p1 = 0; p1 < vecProton.size(); p1++) {
         for (size_t p2 = p1 + 1; p2 < vecProton.size(); p2++) {
           for (size_t l1 = 0; l1 < vecLambda.size(); l1++) {
@@ -1915,7 +1936,7 @@ struct CFFilterAll {
             registryTriggerQA.fill(HIST("PPL/all/fProtonQ3VsPt"), q3, vecProton.at(p1).Pt());
             registryTriggerQA.fill(HIST("PPL/all/fProtonQ3VsPt"), q3, vecProton.at(p2).Pt());
             registryTriggerQA.fill(HIST("PPL/all/fLambdaQ3VsPt"), q3, vecLambda.at(l1).Pt());
-            if (q3 < TriggerSelections.limits->get("Loose Limit", "PPL")) {
+            if (q3 < triggerLooseLimits[cf_trigger::kPPL]) {
               signalLooseLimit[cf_trigger::kPPL] += 1;
               registryTriggerQA.fill(HIST("PPL/loose/fMultiplicity"), col.multNTracksPV());
               registryTriggerQA.fill(HIST("PPL/loose/fZvtx"), col.posZ());
@@ -1923,7 +1944,7 @@ struct CFFilterAll {
               registryTriggerQA.fill(HIST("PPL/loose/fProtonQ3VsPt"), q3, vecProton.at(p1).Pt());
               registryTriggerQA.fill(HIST("PPL/loose/fProtonQ3VsPt"), q3, vecProton.at(p2).Pt());
               registryTriggerQA.fill(HIST("PPL/loose/fLambdaQ3VsPt"), q3, vecLambda.at(l1).Pt());
-              if (q3 < TriggerSelections.limits->get("Tight Limit", "PPL")) {
+              if (q3 < triggerTightLimits[cf_trigger::kPPL]) {
                 signalTightLimit[cf_trigger::kPPL] += 1;
                 registryTriggerQA.fill(HIST("PPL/tight/fMultiplicity"), col.multNTracksPV());
                 registryTriggerQA.fill(HIST("PPL/tight/fZvtx"), col.posZ());
@@ -1949,7 +1970,7 @@ struct CFFilterAll {
             registryTriggerQA.fill(HIST("PPL/all/fAntiProtonQ3VsPt"), q3, vecAntiProton.at(p1).Pt());
             registryTriggerQA.fill(HIST("PPL/all/fAntiProtonQ3VsPt"), q3, vecAntiProton.at(p2).Pt());
             registryTriggerQA.fill(HIST("PPL/all/fAntiLambdaQ3VsPt"), q3, vecAntiLambda.at(l1).Pt());
-            if (q3 < TriggerSelections.limits->get("Loose Limit", "PPL")) {
+            if (q3 < triggerLooseLimits[cf_trigger::kPPL]) {
               signalLooseLimit[cf_trigger::kPPL] += 1;
               registryTriggerQA.fill(HIST("PPL/loose/fMultiplicity"), col.multNTracksPV());
               registryTriggerQA.fill(HIST("PPL/loose/fZvtx"), col.posZ());
@@ -1957,7 +1978,7 @@ struct CFFilterAll {
               registryTriggerQA.fill(HIST("PPL/loose/fAntiProtonQ3VsPt"), q3, vecAntiProton.at(p1).Pt());
               registryTriggerQA.fill(HIST("PPL/loose/fAntiProtonQ3VsPt"), q3, vecAntiProton.at(p2).Pt());
               registryTriggerQA.fill(HIST("PPL/loose/fAntiLambdaQ3VsPt"), q3, vecAntiLambda.at(l1).Pt());
-              if (q3 < TriggerSelections.limits->get("Tight Limit", "PPL")) {
+              if (q3 < triggerTightLimits[cf_trigger::kPPL]) {
                 signalTightLimit[cf_trigger::kPPL] += 1;
                 registryTriggerQA.fill(HIST("PPL/tight/fMultiplicity"), col.multNTracksPV());
                 registryTriggerQA.fill(HIST("PPL/tight/fZvtx"), col.posZ());
@@ -1972,7 +1993,7 @@ struct CFFilterAll {
       }
     }
     // PLL
-    if (TriggerSelections.filterSwitches->get("Switch", "PLL") > 0) {
+    if (triggerSwitches[cf_trigger::kPLL]) {
       for (size_t l1 = 0; l1 < vecLambda.size(); l1++) {
         for (size_t l2 = l1 + 1; l2 < vecLambda.size(); l2++) {
           for (size_t p1 = 0; p1 < vecProton.size(); p1++) {
@@ -1989,7 +2010,7 @@ struct CFFilterAll {
             registryTriggerQA.fill(HIST("PLL/all/fLambdaQ3VsPt"), q3, vecLambda.at(l1).Pt());
             registryTriggerQA.fill(HIST("PLL/all/fLambdaQ3VsPt"), q3, vecLambda.at(l2).Pt());
             registryTriggerQA.fill(HIST("PLL/all/fProtonQ3VsPt"), q3, vecProton.at(p1).Pt());
-            if (q3 < TriggerSelections.limits->get("Loose Limit", "PLL")) {
+            if (q3 < triggerLooseLimits[cf_trigger::kPLL]) {
               signalLooseLimit[cf_trigger::kPLL] += 1;
               registryTriggerQA.fill(HIST("PLL/loose/fMultiplicity"), col.multNTracksPV());
               registryTriggerQA.fill(HIST("PLL/loose/fZvtx"), col.posZ());
@@ -1997,7 +2018,7 @@ struct CFFilterAll {
               registryTriggerQA.fill(HIST("PLL/loose/fLambdaQ3VsPt"), q3, vecLambda.at(l1).Pt());
               registryTriggerQA.fill(HIST("PLL/loose/fLambdaQ3VsPt"), q3, vecLambda.at(l2).Pt());
               registryTriggerQA.fill(HIST("PLL/loose/fProtonQ3VsPt"), q3, vecProton.at(p1).Pt());
-              if (q3 < TriggerSelections.limits->get("Tight Limit", "PLL")) {
+              if (q3 < triggerTightLimits[cf_trigger::kPLL]) {
                 signalTightLimit[cf_trigger::kPLL] += 1;
                 registryTriggerQA.fill(HIST("PLL/tight/fMultiplicity"), col.multNTracksPV());
                 registryTriggerQA.fill(HIST("PLL/tight/fZvtx"), col.posZ());
@@ -2026,7 +2047,7 @@ struct CFFilterAll {
             registryTriggerQA.fill(HIST("PLL/all/fAntiLambdaQ3VsPt"), q3, vecAntiLambda.at(l1).Pt());
             registryTriggerQA.fill(HIST("PLL/all/fAntiLambdaQ3VsPt"), q3, vecAntiLambda.at(l2).Pt());
             registryTriggerQA.fill(HIST("PLL/all/fAntiProtonQ3VsPt"), q3, vecAntiProton.at(p1).Pt());
-            if (q3 < TriggerSelections.limits->get("Loose Limit", "PLL")) {
+            if (q3 < triggerLooseLimits[cf_trigger::kPLL]) {
               signalLooseLimit[cf_trigger::kPLL] += 1;
               registryTriggerQA.fill(HIST("PLL/loose/fMultiplicity"), col.multNTracksPV());
               registryTriggerQA.fill(HIST("PLL/loose/fZvtx"), col.posZ());
@@ -2034,7 +2055,7 @@ struct CFFilterAll {
               registryTriggerQA.fill(HIST("PLL/loose/fAntiLambdaQ3VsPt"), q3, vecAntiLambda.at(l1).Pt());
               registryTriggerQA.fill(HIST("PLL/loose/fAntiLambdaQ3VsPt"), q3, vecAntiLambda.at(l2).Pt());
               registryTriggerQA.fill(HIST("PLL/loose/fAntiProtonQ3VsPt"), q3, vecAntiProton.at(p1).Pt());
-              if (q3 < TriggerSelections.limits->get("Tight Limit", "PLL")) {
+              if (q3 < triggerTightLimits[cf_trigger::kPLL]) {
                 signalTightLimit[cf_trigger::kPLL] += 1;
                 registryTriggerQA.fill(HIST("PLL/tight/fMultiplicity"), col.multNTracksPV());
                 registryTriggerQA.fill(HIST("PLL/tight/fZvtx"), col.posZ());
@@ -2049,7 +2070,7 @@ struct CFFilterAll {
       }
     }
     // LLL
-    if (TriggerSelections.filterSwitches->get("Switch", "LLL") > 0) {
+    if (triggerSwitches[cf_trigger::kLLL]) {
       for (size_t l1 = 0; l1 < vecLambda.size(); l1++) {
         for (size_t l2 = l1 + 1; l2 < vecLambda.size(); l2++) {
           for (size_t l3 = l2 + 1; l3 < vecLambda.size(); l3++) {
@@ -2065,7 +2086,7 @@ struct CFFilterAll {
             registryTriggerQA.fill(HIST("LLL/all/fLambdaQ3VsPt"), q3, vecLambda.at(l1).Pt());
             registryTriggerQA.fill(HIST("LLL/all/fLambdaQ3VsPt"), q3, vecLambda.at(l2).Pt());
             registryTriggerQA.fill(HIST("LLL/all/fLambdaQ3VsPt"), q3, vecLambda.at(l3).Pt());
-            if (q3 < TriggerSelections.limits->get("Loose Limit", "LLL")) {
+            if (q3 < triggerLooseLimits[cf_trigger::kLLL]) {
               signalLooseLimit[cf_trigger::kLLL] += 1;
               registryTriggerQA.fill(HIST("LLL/loose/fMultiplicity"), col.multNTracksPV());
               registryTriggerQA.fill(HIST("LLL/loose/fZvtx"), col.posZ());
@@ -2073,7 +2094,7 @@ struct CFFilterAll {
               registryTriggerQA.fill(HIST("LLL/loose/fLambdaQ3VsPt"), q3, vecLambda.at(l1).Pt());
               registryTriggerQA.fill(HIST("LLL/loose/fLambdaQ3VsPt"), q3, vecLambda.at(l2).Pt());
               registryTriggerQA.fill(HIST("LLL/loose/fLambdaQ3VsPt"), q3, vecLambda.at(l3).Pt());
-              if (q3 < TriggerSelections.limits->get("Tight Limit", "LLL")) {
+              if (q3 < triggerTightLimits[cf_trigger::kLLL]) {
                 signalTightLimit[cf_trigger::kLLL] += 1;
                 registryTriggerQA.fill(HIST("LLL/tight/fMultiplicity"), col.multNTracksPV());
                 registryTriggerQA.fill(HIST("LLL/tight/fZvtx"), col.posZ());
@@ -2101,7 +2122,7 @@ struct CFFilterAll {
             registryTriggerQA.fill(HIST("LLL/all/fLambdaQ3VsPt"), q3, vecAntiLambda.at(l1).Pt());
             registryTriggerQA.fill(HIST("LLL/all/fLambdaQ3VsPt"), q3, vecAntiLambda.at(l2).Pt());
             registryTriggerQA.fill(HIST("LLL/all/fLambdaQ3VsPt"), q3, vecAntiLambda.at(l3).Pt());
-            if (q3 < TriggerSelections.limits->get("Loose Limit", "LLL")) {
+            if (q3 < triggerLooseLimits[cf_trigger::kLLL]) {
               signalLooseLimit[cf_trigger::kLLL] += 1;
               registryTriggerQA.fill(HIST("LLL/loose/fMultiplicity"), col.multNTracksPV());
               registryTriggerQA.fill(HIST("LLL/loose/fZvtx"), col.posZ());
@@ -2109,7 +2130,7 @@ struct CFFilterAll {
               registryTriggerQA.fill(HIST("LLL/loose/fLambdaQ3VsPt"), q3, vecAntiLambda.at(l1).Pt());
               registryTriggerQA.fill(HIST("LLL/loose/fLambdaQ3VsPt"), q3, vecAntiLambda.at(l2).Pt());
               registryTriggerQA.fill(HIST("LLL/loose/fLambdaQ3VsPt"), q3, vecAntiLambda.at(l3).Pt());
-              if (q3 < TriggerSelections.limits->get("Tight Limit", "LLL")) {
+              if (q3 < triggerTightLimits[cf_trigger::kLLL]) {
                 signalTightLimit[cf_trigger::kLLL] += 1;
                 registryTriggerQA.fill(HIST("LLL/tight/fMultiplicity"), col.multNTracksPV());
                 registryTriggerQA.fill(HIST("LLL/tight/fZvtx"), col.posZ());
@@ -2124,7 +2145,7 @@ struct CFFilterAll {
       }
     }
     // PPPhi
-    if (TriggerSelections.filterSwitches->get("Switch", "PPPhi") > 0) {
+    if (triggerSwitches[cf_trigger::kPPPhi]) {
       for (size_t p1 = 0; p1 < vecProton.size(); p1++) {
         for (size_t p2 = p1 + 1; p2 < vecProton.size(); p2++) {
           for (size_t phi1 = 0; phi1 < vecPhi.size(); phi1++) {
@@ -2139,7 +2160,7 @@ struct CFFilterAll {
             registryTriggerQA.fill(HIST("PPPhi/all/fProtonQ3VsPt"), q3, vecProton.at(p2).Pt());
             registryTriggerQA.fill(HIST("PPPhi/all/fPhiQ3VsPt"), q3, vecPhi.at(phi1).Pt());
             registryTriggerQA.fill(HIST("PPPhi/all/fPhiQ3VsInvMass"), q3, vecPhi.at(phi1).M());
-            if (q3 < TriggerSelections.limits->get("Loose Limit", "PPPhi")) {
+            if (q3 < triggerLooseLimits[cf_trigger::kPPPhi]) {
               signalLooseLimit[cf_trigger::kPPPhi] += 1;
               registryTriggerQA.fill(HIST("PPPhi/loose/fMultiplicity"), col.multNTracksPV());
               registryTriggerQA.fill(HIST("PPPhi/loose/fZvtx"), col.posZ());
@@ -2148,7 +2169,7 @@ struct CFFilterAll {
               registryTriggerQA.fill(HIST("PPPhi/loose/fProtonQ3VsPt"), q3, vecProton.at(p2).Pt());
               registryTriggerQA.fill(HIST("PPPhi/loose/fPhiQ3VsPt"), q3, vecPhi.at(phi1).Pt());
               registryTriggerQA.fill(HIST("PPPhi/loose/fPhiQ3VsInvMass"), q3, vecPhi.at(phi1).M());
-              if (q3 < TriggerSelections.limits->get("Tight Limit", "PPPhi") &&
+              if (q3 < triggerTightLimits[cf_trigger::kPPPhi] &&
                   vecPhi.at(phi1).M() > PhiSelections.tightInvMassLow.value && vecPhi.at(phi1).M() < PhiSelections.tightInvMassUp.value) {
                 signalTightLimit[cf_trigger::kPPPhi] += 1;
                 registryTriggerQA.fill(HIST("PPPhi/tight/fMultiplicity"), col.multNTracksPV());
@@ -2177,7 +2198,7 @@ struct CFFilterAll {
             registryTriggerQA.fill(HIST("PPPhi/all/fAntiProtonQ3VsPt"), q3, vecAntiProton.at(p2).Pt());
             registryTriggerQA.fill(HIST("PPPhi/all/fPhiQ3VsPt"), q3, vecPhi.at(phi1).Pt());
             registryTriggerQA.fill(HIST("PPPhi/all/fPhiQ3VsInvMass"), q3, vecPhi.at(phi1).M());
-            if (q3 < TriggerSelections.limits->get("Loose Limit", "PPPhi")) {
+            if (q3 < triggerLooseLimits[cf_trigger::kPPPhi]) {
               signalLooseLimit[cf_trigger::kPPPhi] += 1;
               registryTriggerQA.fill(HIST("PPPhi/loose/fMultiplicity"), col.multNTracksPV());
               registryTriggerQA.fill(HIST("PPPhi/loose/fZvtx"), col.posZ());
@@ -2186,7 +2207,7 @@ struct CFFilterAll {
               registryTriggerQA.fill(HIST("PPPhi/loose/fAntiProtonQ3VsPt"), q3, vecAntiProton.at(p2).Pt());
               registryTriggerQA.fill(HIST("PPPhi/loose/fPhiQ3VsPt"), q3, vecPhi.at(phi1).Pt());
               registryTriggerQA.fill(HIST("PPPhi/loose/fPhiQ3VsInvMass"), q3, vecPhi.at(phi1).M());
-              if (q3 < TriggerSelections.limits->get("Tight Limit", "PPPhi") &&
+              if (q3 < triggerTightLimits[cf_trigger::kPPPhi] &&
                   vecPhi.at(phi1).M() > PhiSelections.tightInvMassLow.value && vecPhi.at(phi1).M() < PhiSelections.tightInvMassUp.value) {
                 signalTightLimit[cf_trigger::kPPPhi] += 1;
                 registryTriggerQA.fill(HIST("PPPhi/tight/fMultiplicity"), col.multNTracksPV());
@@ -2203,7 +2224,7 @@ struct CFFilterAll {
       }
     }
     // PPRho
-    if (TriggerSelections.filterSwitches->get("Switch", "PPRho") > 0) {
+    if (triggerSwitches[cf_trigger::kPPRho]) {
       for (size_t p1 = 0; p1 < vecProton.size(); p1++) {
         for (size_t p2 = p1 + 1; p2 < vecProton.size(); p2++) {
           for (size_t r1 = 0; r1 < vecRho.size(); r1++) {
@@ -2218,7 +2239,7 @@ struct CFFilterAll {
             registryTriggerQA.fill(HIST("PPRho/all/fProtonQ3VsPt"), q3, vecProton.at(p2).Pt());
             registryTriggerQA.fill(HIST("PPRho/all/fRhoQ3VsPt"), q3, vecRho.at(r1).Pt());
             registryTriggerQA.fill(HIST("PPRho/all/fRhoQ3VsInvMass"), q3, vecRho.at(r1).M());
-            if (q3 < TriggerSelections.limits->get("Loose Limit", "PPRho")) {
+            if (q3 < triggerLooseLimits[cf_trigger::kPPRho]) {
               signalLooseLimit[cf_trigger::kPPRho] += 1;
               registryTriggerQA.fill(HIST("PPRho/loose/fMultiplicity"), col.multNTracksPV());
               registryTriggerQA.fill(HIST("PPRho/loose/fZvtx"), col.posZ());
@@ -2227,7 +2248,7 @@ struct CFFilterAll {
               registryTriggerQA.fill(HIST("PPRho/loose/fProtonQ3VsPt"), q3, vecProton.at(p2).Pt());
               registryTriggerQA.fill(HIST("PPRho/loose/fRhoQ3VsPt"), q3, vecRho.at(r1).Pt());
               registryTriggerQA.fill(HIST("PPRho/loose/fRhoQ3VsInvMass"), q3, vecRho.at(r1).M());
-              if (q3 < TriggerSelections.limits->get("Tight Limit", "PPRho") &&
+              if (q3 < triggerTightLimits[cf_trigger::kPPRho] &&
                   vecRho.at(r1).M() > RhoSelections.tightInvMassLow.value && vecRho.at(r1).M() < RhoSelections.tightInvMassUp.value) {
                 signalTightLimit[cf_trigger::kPPRho] += 1;
                 registryTriggerQA.fill(HIST("PPRho/tight/fMultiplicity"), col.multNTracksPV());
@@ -2256,7 +2277,7 @@ struct CFFilterAll {
             registryTriggerQA.fill(HIST("PPRho/all/fAntiProtonQ3VsPt"), q3, vecAntiProton.at(p2).Pt());
             registryTriggerQA.fill(HIST("PPRho/all/fRhoQ3VsPt"), q3, vecRho.at(r1).Pt());
             registryTriggerQA.fill(HIST("PPRho/all/fRhoQ3VsInvMass"), q3, vecRho.at(r1).M());
-            if (q3 < TriggerSelections.limits->get("Loose Limit", "PPRho")) {
+            if (q3 < triggerLooseLimits[cf_trigger::kPPRho]) {
               signalLooseLimit[cf_trigger::kPPRho] += 1;
               registryTriggerQA.fill(HIST("PPRho/loose/fMultiplicity"), col.multNTracksPV());
               registryTriggerQA.fill(HIST("PPRho/loose/fZvtx"), col.posZ());
@@ -2265,7 +2286,7 @@ struct CFFilterAll {
               registryTriggerQA.fill(HIST("PPRho/loose/fAntiProtonQ3VsPt"), q3, vecAntiProton.at(p2).Pt());
               registryTriggerQA.fill(HIST("PPRho/loose/fRhoQ3VsPt"), q3, vecRho.at(r1).Pt());
               registryTriggerQA.fill(HIST("PPRho/loose/fRhoQ3VsInvMass"), q3, vecRho.at(r1).M());
-              if (q3 < TriggerSelections.limits->get("Tight Limit", "PPRho") &&
+              if (q3 < triggerTightLimits[cf_trigger::kPPRho] &&
                   vecRho.at(r1).M() > RhoSelections.tightInvMassLow.value && vecRho.at(r1).M() < RhoSelections.tightInvMassUp.value) {
                 signalTightLimit[cf_trigger::kPPRho] += 1;
                 registryTriggerQA.fill(HIST("PPRho/tight/fMultiplicity"), col.multNTracksPV());
@@ -2282,7 +2303,7 @@ struct CFFilterAll {
       }
     }
     // PD
-    if (TriggerSelections.filterSwitches->get("Switch", "PD") > 0) {
+    if (triggerSwitches[cf_trigger::kPD]) {
       for (size_t p1 = 0; p1 < vecProton.size(); p1++) {
         for (size_t d1 = 0; d1 < vecDeuteron.size(); d1++) {
           if (idxProton.at(p1) == idxDeuteron.at(d1)) {
@@ -2294,14 +2315,14 @@ struct CFFilterAll {
           registryTriggerQA.fill(HIST("PD/all/fSE_particle"), kstar);
           registryTriggerQA.fill(HIST("PD/all/fProtonKstarVsPt"), kstar, vecProton.at(p1).Pt());
           registryTriggerQA.fill(HIST("PD/all/fDeuteronKstarVsPt"), kstar, vecDeuteron.at(d1).Pt());
-          if (kstar < TriggerSelections.limits->get("Loose Limit", "PD")) {
+          if (kstar < triggerLooseLimits[cf_trigger::kPD]) {
             signalLooseLimit[cf_trigger::kPD] += 1;
             registryTriggerQA.fill(HIST("PD/loose/fMultiplicity"), col.multNTracksPV());
             registryTriggerQA.fill(HIST("PD/loose/fZvtx"), col.posZ());
             registryTriggerQA.fill(HIST("PD/loose/fSE_particle"), kstar);
             registryTriggerQA.fill(HIST("PD/loose/fProtonKstarVsPt"), kstar, vecProton.at(p1).Pt());
             registryTriggerQA.fill(HIST("PD/loose/fDeuteronKstarVsPt"), kstar, vecDeuteron.at(d1).Pt());
-            if (kstar < TriggerSelections.limits->get("Tight Limit", "PD")) {
+            if (kstar < triggerTightLimits[cf_trigger::kPD]) {
               signalTightLimit[cf_trigger::kPD] += 1;
               registryTriggerQA.fill(HIST("PD/tight/fMultiplicity"), col.multNTracksPV());
               registryTriggerQA.fill(HIST("PD/tight/fZvtx"), col.posZ());
@@ -2323,14 +2344,14 @@ struct CFFilterAll {
           registryTriggerQA.fill(HIST("PD/all/fSE_antiparticle"), kstar);
           registryTriggerQA.fill(HIST("PD/all/fAntiProtonKstarVsPt"), kstar, vecAntiProton.at(p1).Pt());
           registryTriggerQA.fill(HIST("PD/all/fAntiDeuteronKstarVsPt"), kstar, vecAntiDeuteron.at(d1).Pt());
-          if (kstar < TriggerSelections.limits->get("Loose Limit", "PD")) {
+          if (kstar < triggerLooseLimits[cf_trigger::kPD]) {
             signalLooseLimit[cf_trigger::kPD] += 1;
             registryTriggerQA.fill(HIST("PD/loose/fMultiplicity"), col.multNTracksPV());
             registryTriggerQA.fill(HIST("PD/loose/fZvtx"), col.posZ());
             registryTriggerQA.fill(HIST("PD/loose/fSE_antiparticle"), kstar);
             registryTriggerQA.fill(HIST("PD/loose/fAntiProtonKstarVsPt"), kstar, vecAntiProton.at(p1).Pt());
             registryTriggerQA.fill(HIST("PD/loose/fAntiDeuteronKstarVsPt"), kstar, vecAntiDeuteron.at(d1).Pt());
-            if (kstar < TriggerSelections.limits->get("Tight Limit", "PD")) {
+            if (kstar < triggerTightLimits[cf_trigger::kPD]) {
               signalTightLimit[cf_trigger::kPD] += 1;
               registryTriggerQA.fill(HIST("PD/tight/fMultiplicity"), col.multNTracksPV());
               registryTriggerQA.fill(HIST("PD/tight/fZvtx"), col.posZ());
@@ -2343,7 +2364,7 @@ struct CFFilterAll {
       }
     }
     // LD
-    if (TriggerSelections.filterSwitches->get("Switch", "LD") > 0) {
+    if (triggerSwitches[cf_trigger::kLD]) {
       for (size_t l1 = 0; l1 < vecLambda.size(); l1++) {
         for (size_t d1 = 0; d1 < vecDeuteron.size(); d1++) {
           if (idxLambdaDaughProton.at(l1) == idxDeuteron.at(d1)) {
@@ -2355,14 +2376,14 @@ struct CFFilterAll {
           registryTriggerQA.fill(HIST("LD/all/fSE_particle"), kstar);
           registryTriggerQA.fill(HIST("LD/all/fLambdaKstarVsPt"), kstar, vecLambda.at(l1).Pt());
           registryTriggerQA.fill(HIST("LD/all/fDeuteronKstarVsPt"), kstar, vecDeuteron.at(d1).Pt());
-          if (kstar < TriggerSelections.limits->get("Loose Limit", "LD")) {
+          if (kstar < triggerLooseLimits[cf_trigger::kLD]) {
             signalLooseLimit[cf_trigger::kLD] += 1;
             registryTriggerQA.fill(HIST("LD/loose/fMultiplicity"), col.multNTracksPV());
             registryTriggerQA.fill(HIST("LD/loose/fZvtx"), col.posZ());
             registryTriggerQA.fill(HIST("LD/loose/fSE_particle"), kstar);
             registryTriggerQA.fill(HIST("LD/loose/fLambdaKstarVsPt"), kstar, vecLambda.at(l1).Pt());
             registryTriggerQA.fill(HIST("LD/loose/fDeuteronKstarVsPt"), kstar, vecDeuteron.at(d1).Pt());
-            if (kstar < TriggerSelections.limits->get("Tight Limit", "LD")) {
+            if (kstar < triggerTightLimits[cf_trigger::kLD]) {
               signalTightLimit[cf_trigger::kLD] += 1;
               registryTriggerQA.fill(HIST("LD/tight/fMultiplicity"), col.multNTracksPV());
               registryTriggerQA.fill(HIST("LD/tight/fZvtx"), col.posZ());
@@ -2384,14 +2405,14 @@ struct CFFilterAll {
           registryTriggerQA.fill(HIST("LD/all/fSE_antiparticle"), kstar);
           registryTriggerQA.fill(HIST("LD/all/fAntiLambdaKstarVsPt"), kstar, vecAntiLambda.at(l1).Pt());
           registryTriggerQA.fill(HIST("LD/all/fAntiDeuteronKstarVsPt"), kstar, vecAntiDeuteron.at(d1).Pt());
-          if (kstar < TriggerSelections.limits->get("Loose Limit", "LD")) {
+          if (kstar < triggerLooseLimits[cf_trigger::kLD]) {
             signalLooseLimit[cf_trigger::kLD] += 1;
             registryTriggerQA.fill(HIST("LD/loose/fMultiplicity"), col.multNTracksPV());
             registryTriggerQA.fill(HIST("LD/loose/fZvtx"), col.posZ());
             registryTriggerQA.fill(HIST("LD/loose/fSE_antiparticle"), kstar);
             registryTriggerQA.fill(HIST("LD/loose/fAntiLambdaKstarVsPt"), kstar, vecAntiLambda.at(l1).Pt());
             registryTriggerQA.fill(HIST("LD/loose/fAntiDeuteronKstarVsPt"), kstar, vecAntiDeuteron.at(d1).Pt());
-            if (kstar < TriggerSelections.limits->get("Tight Limit", "LD")) {
+            if (kstar < triggerTightLimits[cf_trigger::kLD]) {
               signalTightLimit[cf_trigger::kLD] += 1;
               registryTriggerQA.fill(HIST("LD/tight/fMultiplicity"), col.multNTracksPV());
               registryTriggerQA.fill(HIST("LD/tight/fZvtx"), col.posZ());
@@ -2404,7 +2425,7 @@ struct CFFilterAll {
       }
     }
     // PhiD
-    if (TriggerSelections.filterSwitches->get("Switch", "PhiD") > 0) {
+    if (triggerSwitches[cf_trigger::kPhiD]) {
       for (size_t phi1 = 0; phi1 < vecPhi.size(); phi1++) {
         for (size_t d1 = 0; d1 < vecDeuteron.size(); d1++) {
           if (idxPhiDaughPos.at(phi1) == idxDeuteron.at(d1)) {
@@ -2417,7 +2438,7 @@ struct CFFilterAll {
           registryTriggerQA.fill(HIST("PhiD/all/fPhiKstarVsPt"), kstar, vecPhi.at(phi1).Pt());
           registryTriggerQA.fill(HIST("PhiD/all/fDeuteronKstarVsPt"), kstar, vecDeuteron.at(d1).Pt());
           registryTriggerQA.fill(HIST("PhiD/all/fPhiKstarVsInvMass"), kstar, vecPhi.at(phi1).M());
-          if (kstar < TriggerSelections.limits->get("Loose Limit", "PhiD")) {
+          if (kstar < triggerLooseLimits[cf_trigger::kPhiD]) {
             signalLooseLimit[cf_trigger::kPhiD] += 1;
             registryTriggerQA.fill(HIST("PhiD/loose/fMultiplicity"), col.multNTracksPV());
             registryTriggerQA.fill(HIST("PhiD/loose/fZvtx"), col.posZ());
@@ -2425,7 +2446,7 @@ struct CFFilterAll {
             registryTriggerQA.fill(HIST("PhiD/loose/fPhiKstarVsPt"), kstar, vecPhi.at(phi1).Pt());
             registryTriggerQA.fill(HIST("PhiD/loose/fDeuteronKstarVsPt"), kstar, vecDeuteron.at(d1).Pt());
             registryTriggerQA.fill(HIST("PhiD/loose/fPhiKstarVsInvMass"), kstar, vecPhi.at(phi1).M());
-            if (kstar < TriggerSelections.limits->get("Tight Limit", "PhiD") &&
+            if (kstar < triggerTightLimits[cf_trigger::kPhiD] &&
                 vecPhi.at(phi1).M() > PhiSelections.tightInvMassLow.value && vecPhi.at(phi1).M() < PhiSelections.tightInvMassUp.value) {
               signalTightLimit[cf_trigger::kPhiD] += 1;
               registryTriggerQA.fill(HIST("PhiD/tight/fMultiplicity"), col.multNTracksPV());
@@ -2450,7 +2471,7 @@ struct CFFilterAll {
           registryTriggerQA.fill(HIST("PhiD/all/fPhiKstarVsPt"), kstar, vecPhi.at(phi1).Pt());
           registryTriggerQA.fill(HIST("PhiD/all/fAntiDeuteronKstarVsPt"), kstar, vecAntiDeuteron.at(d1).Pt());
           registryTriggerQA.fill(HIST("PhiD/all/fPhiKstarVsInvMass"), kstar, vecPhi.at(phi1).M());
-          if (kstar < TriggerSelections.limits->get("Loose Limit", "PhiD")) {
+          if (kstar < triggerLooseLimits[cf_trigger::kPhiD]) {
             signalLooseLimit[cf_trigger::kPhiD] += 1;
             registryTriggerQA.fill(HIST("PhiD/loose/fMultiplicity"), col.multNTracksPV());
             registryTriggerQA.fill(HIST("PhiD/loose/fZvtx"), col.posZ());
@@ -2458,7 +2479,7 @@ struct CFFilterAll {
             registryTriggerQA.fill(HIST("PhiD/loose/fPhiKstarVsPt"), kstar, vecPhi.at(phi1).Pt());
             registryTriggerQA.fill(HIST("PhiD/loose/fAntiDeuteronKstarVsPt"), kstar, vecAntiDeuteron.at(d1).Pt());
             registryTriggerQA.fill(HIST("PhiD/loose/fPhiKstarVsInvMass"), kstar, vecPhi.at(phi1).M());
-            if (kstar < TriggerSelections.limits->get("Tight Limit", "PhiD") &&
+            if (kstar < triggerTightLimits[cf_trigger::kPhiD] &&
                 vecPhi.at(phi1).M() > PhiSelections.tightInvMassLow.value && vecPhi.at(phi1).M() < PhiSelections.tightInvMassUp.value) {
               signalTightLimit[cf_trigger::kPhiD] += 1;
               registryTriggerQA.fill(HIST("PhiD/tight/fMultiplicity"), col.multNTracksPV());
@@ -2473,7 +2494,7 @@ struct CFFilterAll {
       }
     }
     // RhoD
-    if (TriggerSelections.filterSwitches->get("Switch", "RhoD") > 0) {
+    if (triggerSwitches[cf_trigger::kRhoD]) {
       for (size_t r1 = 0; r1 < vecRho.size(); r1++) {
         for (size_t d1 = 0; d1 < vecDeuteron.size(); d1++) {
           if (idxRhoDaughPos.at(r1) == idxDeuteron.at(d1)) {
@@ -2486,7 +2507,7 @@ struct CFFilterAll {
           registryTriggerQA.fill(HIST("RhoD/all/fRhoKstarVsPt"), kstar, vecRho.at(r1).Pt());
           registryTriggerQA.fill(HIST("RhoD/all/fDeuteronKstarVsPt"), kstar, vecDeuteron.at(d1).Pt());
           registryTriggerQA.fill(HIST("RhoD/all/fRhoKstarVsInvMass"), kstar, vecRho.at(r1).M());
-          if (kstar < TriggerSelections.limits->get("Loose Limit", "RhoD")) {
+          if (kstar < triggerLooseLimits[cf_trigger::kRhoD]) {
             signalLooseLimit[cf_trigger::kRhoD] += 1;
             registryTriggerQA.fill(HIST("RhoD/loose/fMultiplicity"), col.multNTracksPV());
             registryTriggerQA.fill(HIST("RhoD/loose/fZvtx"), col.posZ());
@@ -2494,7 +2515,7 @@ struct CFFilterAll {
             registryTriggerQA.fill(HIST("RhoD/loose/fRhoKstarVsPt"), kstar, vecRho.at(r1).Pt());
             registryTriggerQA.fill(HIST("RhoD/loose/fDeuteronKstarVsPt"), kstar, vecDeuteron.at(d1).Pt());
             registryTriggerQA.fill(HIST("RhoD/loose/fRhoKstarVsInvMass"), kstar, vecRho.at(r1).M());
-            if (kstar < TriggerSelections.limits->get("Tight Limit", "RhoD") &&
+            if (kstar < triggerTightLimits[cf_trigger::kRhoD] &&
                 vecRho.at(r1).M() > RhoSelections.tightInvMassLow.value && vecRho.at(r1).M() < RhoSelections.tightInvMassUp.value) {
               signalTightLimit[cf_trigger::kRhoD] += 1;
               registryTriggerQA.fill(HIST("RhoD/tight/fMultiplicity"), col.multNTracksPV());
@@ -2519,7 +2540,7 @@ struct CFFilterAll {
           registryTriggerQA.fill(HIST("RhoD/all/fRhoKstarVsPt"), kstar, vecRho.at(r1).Pt());
           registryTriggerQA.fill(HIST("RhoD/all/fAntiDeuteronKstarVsPt"), kstar, vecAntiDeuteron.at(d1).Pt());
           registryTriggerQA.fill(HIST("RhoD/all/fRhoKstarVsInvMass"), kstar, vecRho.at(r1).M());
-          if (kstar < TriggerSelections.limits->get("Loose Limit", "RhoD")) {
+          if (kstar < triggerLooseLimits[cf_trigger::kRhoD]) {
             signalLooseLimit[cf_trigger::kRhoD] += 1;
             registryTriggerQA.fill(HIST("RhoD/loose/fMultiplicity"), col.multNTracksPV());
             registryTriggerQA.fill(HIST("RhoD/loose/fZvtx"), col.posZ());
@@ -2527,7 +2548,7 @@ struct CFFilterAll {
             registryTriggerQA.fill(HIST("RhoD/loose/fRhoKstarVsPt"), kstar, vecRho.at(r1).Pt());
             registryTriggerQA.fill(HIST("RhoD/loose/fAntiDeuteronKstarVsPt"), kstar, vecAntiDeuteron.at(d1).Pt());
             registryTriggerQA.fill(HIST("RhoD/loose/fRhoKstarVsInvMass"), kstar, vecRho.at(r1).M());
-            if (kstar < TriggerSelections.limits->get("Tight Limit", "RhoD") &&
+            if (kstar < triggerTightLimits[cf_trigger::kRhoD] &&
                 vecRho.at(r1).M() > RhoSelections.tightInvMassLow.value && vecRho.at(r1).M() < RhoSelections.tightInvMassUp.value) {
               signalTightLimit[cf_trigger::kRhoD] += 1;
               registryTriggerQA.fill(HIST("RhoD/tight/fMultiplicity"), col.multNTracksPV());
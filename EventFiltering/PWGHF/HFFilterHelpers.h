@@ -30,7 +30,6 @@
 #include "Common/Core/trackUtilities.h"
 
 #include <CCDB/BasicCCDBManager.h>
-#include <CCDB/CcdbApi.h>
 #include <CommonConstants/MathConstants.h>
 #include <CommonConstants/PhysicsConstants.h>
 #include <DCAFitter/DCAFitterN.h>
@@ -58,7 +57,6 @@
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
-#include <map>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -391,6 +389,74 @@ o2::framework::LabeledArray<double> cutsSingleTrackDummy{cutsTrackDummy[0], o2::
 constexpr double defDownscaleFactors[kNtriggersHF][1] = {{1.1}, {1.1}, {1.1}, {1.1}, {1.1}, {1.1}, {1.1}, {1.1}, {1.1}, {1.1}, {1.1}, {1.1}, {1.1}, {1.1}, {1.1}, {1.1}, {1.1}, {1.1}, {1.1}, {1.1}, {1.1}, {1.1}, {1.1}, {1.1}, {1.1}, {1.1}, {1.1}}; // one for each trigger
 static const std::vector<std::string> labelsDownscaleFactor = {"Downscale factor"};
 
+// Helper struct holding the binning of a TAxis, with the same bin search as TAxis::FindBin
+struct FlatAxis {
+  int nBins{0};
+  double min{0.};
+  double max{1.};
+  std::vector<double> edges{}; // empty for uniform binning
+
+  void set(const TAxis* axis)
+  {
+    nBins = axis->GetNbins();
+    min = axis->GetXmin();
+    max = axis->GetXmax();
+    edges.clear();
+    if (axis->GetXbins()->GetSize() > 0) {
+      edges.assign(axis->GetXbins()->GetArray(), axis->GetXbins()->GetArray() + nBins + 1);
+    }
+  }
+
+  /// \return the bin index in [0, nBins), under- and overflows are moved to the first and last bins
+  int findBin(const double value) const
+  {
+    int bin{0};
+    if (value < min) {
+      bin = 0;
+    } else if (!(value < max)) {
+      bin = nBins - 1;
+    } else if (edges.empty()) {
+      bin = static_cast<int>(nBins * (value - min) / (max - min));
+    } else {
+      bin = std::upper_bound(edges.begin(), edges.end(), value) - edges.begin() - 1;
+    }
+    return std::clamp(bin, 0, nBins - 1);
+  }
+};
+
+// Helper struct holding the mean and width TH3F maps of the TPC PID postcalibrations of a species in flat arrays
+struct TpcPostCalibMap {
+  std::array<FlatAxis, 3> axes{}; // number of TPC clusters, TPC inner momentum, pseudorapidity
+  std::vector<float> mean{};
+  std::vector<float> width{};
+
+  bool isSet() const { return !mean.empty(); }
+
+  void set(const TH3F* hMean, const TH3F* hWidth)
+  {
+    axes[0].set(hMean->GetXaxis());
+    axes[1].set(hMean->GetYaxis());
+    axes[2].set(hMean->GetZaxis());
+    mean.resize(axes[0].nBins * axes[1].nBins * axes[2].nBins);
+    width.resize(mean.size());
+    for (int iX{0}; iX < axes[0].nBins; ++iX) {
+      for (int iY{0}; iY < axes[1].nBins; ++iY) {
+        for (int iZ{0}; iZ < axes[2].nBins; ++iZ) {
+          const int index = (iX * axes[1].nBins + iY) * axes[2].nBins + iZ;
+          mean[index] = hMean->GetBinContent(iX + 1, iY + 1, iZ + 1);
+          width[index] = hWidth->GetBinContent(iX + 1, iY + 1, iZ + 1);
+        }
+      }
+    }
+  }
+
+  /// \return the position in the flat arrays of the bin containing (x, y, z)
+  int getIndex(const float x, const float y, const float z) const
+  {
+    return (axes[0].findBin(x) * axes[1].nBins + axes[1].findBin(y)) * axes[2].nBins + axes[2].findBin(z);
+  }
+};
+
 // Main helper class
 
 class HfFilterHelper
@@ -673,7 +739,7 @@ class HfFilterHelper
   bool buildCascade(Casc const& cascIndices, V const& v0Indices, T const& tracks, C const& collision, o2::vertexing::DCAFitterN<2>& dcaFitter, const std::vector<int>& vetoedTrackIds, CascCand& cascCand);
 
   // PID
-  void setValuesBB(o2::ccdb::CcdbApi& ccdbApi, aod::BCsWithTimestamps::iterator const& bunchCrossing, const std::array<std::string, 8>& ccdbPaths);
+  void setValuesBB(o2::framework::Service<o2::ccdb::BasicCCDBManager> const& ccdb, aod::BCsWithTimestamps::iterator const& bunchCrossing, const std::array<std::string, 8>& ccdbPaths);
   void setTpcRecalibMaps(o2::framework::Service<o2::ccdb::BasicCCDBManager> const& ccdb, aod::BCsWithTimestamps::iterator const& bunchCrossing, const std::string& ccdbPath);
 
  private:
@@ -788,8 +854,8 @@ class HfFilterHelper
   float mMinItsIbCluster{1.};                                                     // Minimum required number of ITS clusters for IB
   // PID recalibrations
   int mTpcPidCalibrationOption{0};                          // Option for TPC PID calibration (0 -> AO2D, 1 -> postcalibrations, 2 -> alternative bethe bloch parametrisation)
-  std::array<TH3F*, 8> mHistMapPiPrKaDe{};                  // Map for TPC PID postcalibrations for pions, kaon, protons and deuterons
-  std::array<std::vector<double>, 8> mBetheBlochPiKaPrDe{}; // Bethe-Bloch parametrisations for pions, antipions, kaons, antikaons, protons, antiprotons, deuterons, antideuterons in TPC
+  std::array<TpcPostCalibMap, 4> mTpcPostCalibMapsPiKaPrDe{}; // Maps for TPC PID postcalibrations for pions, kaon, protons and deuterons
+  std::array<std::vector<double>, 8> mBetheBlochPiKaPrDe{};   // Bethe-Bloch parametrisations for pions, antipions, kaons, antikaons, protons, antiprotons, deuterons, antideuterons in TPC
 };
 
 /// Selection of high-pt 2-prong candidates
@@ -1854,14 +1920,13 @@ inline int HfFilterHelper::computeNumberOfCandidates(std::vector<std::vector<T>>
 /// PID postcalibrations
 
 /// load the TPC spline from the CCDB
-/// \param ccdbApi is Api for CCDB
+/// \param ccdb is the CCDB object
 /// \param bunchCrossing is the timestamp of bunchcrossing for the run number
 /// \param ccdbPaths  are the paths on CCDB for pions, antipions, kaons, antikaons, protons, antiprotons
-inline void HfFilterHelper::setValuesBB(o2::ccdb::CcdbApi& ccdbApi, aod::BCsWithTimestamps::iterator const& bunchCrossing, const std::array<std::string, 8>& ccdbPaths)
+inline void HfFilterHelper::setValuesBB(o2::framework::Service<o2::ccdb::BasicCCDBManager> const& ccdb, aod::BCsWithTimestamps::iterator const& bunchCrossing, const std::array<std::string, 8>& ccdbPaths)
 {
   for (int iSpecie{0u}; iSpecie < 8; ++iSpecie) {
-    std::map<std::string, std::string> metadata;
-    auto hSpline = ccdbApi.retrieveFromTFileAny<TH1F>(ccdbPaths[iSpecie], metadata, bunchCrossing.timestamp());
+    auto hSpline = ccdb->getForTimeStamp<TH1F>(ccdbPaths[iSpecie], bunchCrossing.timestamp());
 
     if (!hSpline) {
       LOG(fatal) << "File from CCDB in path " << ccdbPaths[iSpecie] << " was not found for run " << bunchCrossing.runNumber();
@@ -1889,17 +1954,19 @@ inline void HfFilterHelper::setTpcRecalibMaps(o2::framework::Service<o2::ccdb::B
   }
   std::array<std::string, 8> mapNames = {"mean_map_pion", "sigma_map_pion", "mean_map_kaon", "sigma_map_kaon", "mean_map_proton", "sigma_map_proton", "mean_map_deuteron", "sigma_map_deuteron"};
 
-  for (size_t iMap = 0; iMap < mapNames.size(); iMap++) {
-    mHistMapPiPrKaDe[iMap] = nullptr;
+  for (auto& map : mTpcPostCalibMapsPiKaPrDe) {
+    map = TpcPostCalibMap{};
   }
 
-  for (size_t iMap = 0; iMap < mapNames.size(); iMap++) {
-
-    mHistMapPiPrKaDe[iMap] = reinterpret_cast<TH3F*>(calibList->FindObject(mapNames[iMap].data()));
-    if (!mHistMapPiPrKaDe[iMap]) {
-      LOG(fatal) << "Cannot find histogram: " << mapNames[iMap].data();
+  for (size_t iMap = 0; iMap < mapNames.size(); iMap += 2) {
+    auto hMean = reinterpret_cast<TH3F*>(calibList->FindObject(mapNames[iMap].data()));
+    auto hWidth = reinterpret_cast<TH3F*>(calibList->FindObject(mapNames[iMap + 1].data()));
+    if (!hMean || !hWidth) {
+      LOG(fatal) << "Cannot find histogram: " << (hMean ? mapNames[iMap + 1] : mapNames[iMap]).data();
       return;
     }
+    // the maps are copied in flat arrays, to avoid the histogram bin search for each track and species
+    mTpcPostCalibMapsPiKaPrDe[iMap / 2].set(hMean, hWidth);
   }
 }
 
@@ -2504,35 +2571,25 @@ inline float HfFilterHelper::getTPCSplineCalib(const float tpcPin, const float d
 /// \return the corrected Nsigma value for the PID species
 inline float HfFilterHelper::getTPCPostCalib(const float tpcPin, const float tpcNCls, const float eta, const float tpcNSigma, const int& pidSpecies)
 {
-  int iHist{0};
+  int iMap{0};
   if (pidSpecies == kPi) {
-    iHist = 0;
+    iMap = 0;
   } else if (pidSpecies == kKa) {
-    iHist = 2;
+    iMap = 1;
   } else if (pidSpecies == kPr) {
-    iHist = 4;
+    iMap = 2;
   } else {
     LOG(fatal) << "Wrong PID Species be selected, please check!";
   }
 
-  if (!mHistMapPiPrKaDe[iHist] || !mHistMapPiPrKaDe[iHist + 1]) {
+  const auto& map = mTpcPostCalibMapsPiKaPrDe[iMap];
+  if (!map.isSet()) {
     LOGP(warn, "Postcalibration TPC PID histograms not set. Use default Nsigma values.");
+    return tpcNSigma;
   }
 
-  auto binTPCNCls = mHistMapPiPrKaDe[iHist]->GetXaxis()->FindBin(tpcNCls);
-  binTPCNCls = (binTPCNCls == 0 ? 1 : binTPCNCls);
-  binTPCNCls = std::min(mHistMapPiPrKaDe[iHist]->GetXaxis()->GetNbins(), binTPCNCls);
-  auto binPin = mHistMapPiPrKaDe[iHist]->GetYaxis()->FindBin(tpcPin);
-  binPin = (binPin == 0 ? 1 : binPin);
-  binPin = std::min(mHistMapPiPrKaDe[iHist]->GetYaxis()->GetNbins(), binPin);
-  auto binEta = mHistMapPiPrKaDe[iHist]->GetZaxis()->FindBin(eta);
-  binEta = (binEta == 0 ? 1 : binEta);
-  binEta = std::min(mHistMapPiPrKaDe[iHist]->GetZaxis()->GetNbins(), binEta);
-
-  auto mean = mHistMapPiPrKaDe[iHist]->GetBinContent(binTPCNCls, binPin, binEta);
-  auto width = mHistMapPiPrKaDe[iHist + 1]->GetBinContent(binTPCNCls, binPin, binEta);
-
-  return (tpcNSigma - mean) / width;
+  const int index = map.getIndex(tpcNCls, tpcPin, eta);
+  return (tpcNSigma - map.mean[index]) / map.width[index];
 }
 
 /// compute TPC postcalibrated nsigma based on calibration histograms from CCDB
@@ -18,6 +18,7 @@
 #include <TList.h>
 
 #include "CCDB/BasicCCDBManager.h"
+#include "Common/CCDB/ccdbLocalCache.h"
 #include "CommonDataFormat/InteractionRecord.h"
 
 using o2::InteractionRecord;
@@ -33,6 +34,22 @@ int findBin(TH1* hist, const std::string& label)
   }
   return -1;
 }
+
+uint64_t lowerBound(const std::vector<uint64_t>& sorted, uint64_t value)
+{ // Branchless binary search of the first element not smaller than value
+  if (sorted.empty()) {
+    return 0;
+  }
+  const uint64_t* first = sorted.data();
+  size_t length = sorted.size();
+  while (length > 1) {
+    const size_t half = length / 2;
+    first += (first[half - 1] < value) * half;
+    length -= half;
+  }
+  first += (*first < value);
+  return first - sorted.data();
+}
 } // namespace
 
 void Zorro::populateHistRegistry(o2::framework::HistogramRegistry& histRegistry, int runNumber, std::string folderName)
@@ -171,11 +188,28 @@ std::vector<int> Zorro::initCCDB(o2::ccdb::BasicCCDBManager* ccdb, int runNumber
   metadata["runNumber"] = std::to_string(runNumber);
   mRunDuration = mCCDB->getRunDuration(runNumber, true);
   int64_t runTs = (mRunDuration.first / 2 + mRunDuration.second / 2);
-  auto ctp = ccdb->getForTimeStamp<std::vector<Long64_t>>("CTP/Calib/OrbitReset", runTs);
-  mOrbitResetTimestamp = (*ctp)[0];
-  mScalers = mCCDB->getSpecific<TH1D>(mBaseCCDBPath + "FilterCounters", runTs, metadata);
-  mSelections = mCCDB->getSpecific<TH1D>(mBaseCCDBPath + "SelectionCounters", runTs, metadata);
-  mInspectedTVX = mCCDB->getSpecific<TH1D>(mBaseCCDBPath + "InspectedTVX", runTs, metadata);
+  mLocalCacheObjects.clear();
+  auto& localCache = o2::ccdbLocalCache::instance();
+  if (localCache.isEnabled()) {
+    auto ctp = localCache.getForRun<std::vector<Long64_t>>(mCCDB->getURL(), "CTP/Calib/OrbitReset", runNumber, runTs, false);
+    auto scalers = localCache.getForRun<TH1D>(mCCDB->getURL(), mBaseCCDBPath + "FilterCounters", runNumber, runTs);
+    auto selections = localCache.getForRun<TH1D>(mCCDB->getURL(), mBaseCCDBPath + "SelectionCounters", runNumber, runTs);
+    auto inspectedTVX = localCache.getForRun<TH1D>(mCCDB->getURL(), mBaseCCDBPath + "InspectedTVX", runNumber, runTs);
+    if (!ctp) {
+      LOGF(fatal, "Orbit reset timestamp not available for run %d", runNumber);
+    }
+    mOrbitResetTimestamp = (*ctp)[0];
+    mScalers = scalers.get();
+    mSelections = selections.get();
+    mInspectedTVX = inspectedTVX.get();
+    mLocalCacheObjects = {scalers, selections, inspectedTVX};
+  } else {
+    auto ctp = ccdb->getForTimeStamp<std::vector<Long64_t>>("CTP/Calib/OrbitReset", runTs);
+    mOrbitResetTimestamp = (*ctp)[0];
+    mScalers = mCCDB->getSpecific<TH1D>(mBaseCCDBPath + "FilterCounters", runTs, metadata);
+    mSelections = mCCDB->getSpecific<TH1D>(mBaseCCDBPath + "SelectionCounters", runTs, metadata);
+    mInspectedTVX = mCCDB->getSpecific<TH1D>(mBaseCCDBPath + "InspectedTVX", runTs, metadata);
+  }
   setupHelpers(timestamp);
   mLastBCglobalId = 0;
   mLastSelectedIdx = 0;
@@ -208,42 +242,61 @@ std::vector<int> Zorro::initCCDB(o2::ccdb::BasicCCDBManager* ccdb, int runNumber
   return mTOIidx;
 }
 
+void Zorro::prefetch(o2::ccdb::BasicCCDBManager* ccdb, std::vector<int> const& runs) const
+{
+  o2::ccdbLocalCache::instance().prefetch(ccdb->getURL(), runs, {{"CTP/Calib/OrbitReset", false}, {mBaseCCDBPath + "FilterCounters", true}, {mBaseCCDBPath + "SelectionCounters", true}, {mBaseCCDBPath + "InspectedTVX", true}});
+}
+
 std::bitset<128> Zorro::fetch(uint64_t bcGlobalId, uint64_t tolerance)
 {
   mLastResult.reset();
-  if (bcGlobalId < mBCranges.front().getMin().toLong() - tolerance || bcGlobalId > mBCranges.back().getMax().toLong() + tolerance) {
+  if (bcGlobalId < mBCrangeMin.front() - tolerance || bcGlobalId > mBCrangeMax.back() + tolerance) {
     setupHelpers((mOrbitResetTimestamp + int64_t(bcGlobalId * o2::constants::lhc::LHCBunchSpacingNS * 1e-3)) / 1000);
   }
 
   o2::dataformats::IRFrame bcFrame{InteractionRecord::long2IR(bcGlobalId) - tolerance, InteractionRecord::long2IR(bcGlobalId) + tolerance};
+  const uint64_t frameMin = bcFrame.getMin().toLong(), frameMax = bcFrame.getMax().toLong();
   if (bcGlobalId < mLastBCglobalId) { /// Handle the possible discontinuity in the BC processed by the analyses
     mLastSelectedIdx = 0;
   }
   uint64_t lastSelectedIdx = mLastSelectedIdx;
   mLastBCglobalId = bcGlobalId;
-  for (size_t i = mLastSelectedIdx; i < mBCranges.size(); i++) {
-    if (!mBCranges[i].isOutside(bcFrame)) {
-      for (int iMask{0}; iMask < 2; ++iMask) {
-        for (int iTOI{0}; iTOI < 64; ++iTOI) {
-          if (mZorroHelpers->at(i).selMask[iMask] & (1ull << iTOI)) {
-            mLastResult.set(iMask * 64 + iTOI, 1);
-            if (mAnalysedTriggers && !mAccountedBCranges[i]) {
-              mAnalysedTriggers->Fill(iMask * 64 + iTOI);
-            }
+  /// All the ranges before the first one whose running maximum reaches the frame are entirely before it: jump there directly
+  const uint64_t firstCandidate = lowerBound(mBCrangeMaxPrefix, frameMin);
+  if (firstCandidate > mLastSelectedIdx) {
+    mLastSelectedIdx = firstCandidate - 1;
+  }
+  for (size_t i = std::max(lastSelectedIdx, firstCandidate); i < mBCrangeMin.size(); i++) {
+    if (mBCrangeMax[i] >= frameMin && mBCrangeMin[i] <= frameMax) {
+      mLastResult |= mBCrangeMasks[i];
+      if (mAnalysedTriggers && !mAccountedBCranges[i]) {
+        for (int iBit{0}; iBit < 128; ++iBit) {
+          if (mBCrangeMasks[i].test(iBit)) {
+            mAnalysedTriggers->Fill(iBit);
           }
         }
       }
       mAccountedBCranges[i] = true;
       mLastSelectedIdx = mLastSelectedIdx == lastSelectedIdx-- ? i : mLastSelectedIdx; /// Decrease lastSelectedIdx to make sure this check is valid only in its first instance
-    } else if (mBCranges[i].getMax() < bcFrame.getMin()) {
+    } else if (mBCrangeMax[i] < frameMin) {
       mLastSelectedIdx = i;
-    } else if (mBCranges[i].getMin() > bcFrame.getMax()) {
+    } else if (mBCrangeMin[i] > frameMax) {
       break;
     }
   }
   return mLastResult;
 }
 
+std::vector<std::bitset<128>> Zorro::fetch(std::span<const uint64_t> bcGlobalIds, uint64_t tolerance)
+{
+  std::vector<std::bitset<128>> results;
+  results.reserve(bcGlobalIds.size());
+  for (auto bcGlobalId : bcGlobalIds) {
+    results.push_back(fetch(bcGlobalId, tolerance));
+  }
+  return results;
+}
+
 bool Zorro::isSelected(uint64_t bcGlobalId, uint64_t tolerance, TH2* ToiHisto)
 {
   uint64_t lastSelectedIdx = mLastSelectedIdx;
@@ -304,10 +357,20 @@ void Zorro::setupHelpers(int64_t timestamp)
   }
   mZorroHelpers = mCCDB->getSpecific<std::vector<ZorroHelper>>(mBaseCCDBPath + "ZorroHelpers", timestamp, {{"runNumber", std::to_string(mRunNumber)}});
   std::sort(mZorroHelpers->begin(), mZorroHelpers->end(), [](const auto& a, const auto& b) { return std::min(a.bcAOD, a.bcEvSel) < std::min(b.bcAOD, b.bcEvSel); });
-  mBCranges.clear();
+  mBCrangeMin.clear();
+  mBCrangeMax.clear();
+  mBCrangeMaxPrefix.clear();
+  mBCrangeMasks.clear();
   mAccountedBCranges.clear();
-  for (auto helper : *mZorroHelpers) {
-    mBCranges.emplace_back(InteractionRecord::long2IR(std::min(helper.bcAOD, helper.bcEvSel)), InteractionRecord::long2IR(std::max(helper.bcAOD, helper.bcEvSel)));
+  mBCrangeMin.reserve(mZorroHelpers->size());
+  mBCrangeMax.reserve(mZorroHelpers->size());
+  mBCrangeMaxPrefix.reserve(mZorroHelpers->size());
+  mBCrangeMasks.reserve(mZorroHelpers->size());
+  for (const auto& helper : *mZorroHelpers) {
+    mBCrangeMin.push_back(std::min(helper.bcAOD, helper.bcEvSel));
+    mBCrangeMax.push_back(std::max(helper.bcAOD, helper.bcEvSel));
+    mBCrangeMaxPrefix.push_back(mBCrangeMaxPrefix.empty() ? mBCrangeMax.back() : std::max(mBCrangeMaxPrefix.back(), mBCrangeMax.back()));
+    mBCrangeMasks.emplace_back((std::bitset<128>(helper.selMask[1]) << 64) | std::bitset<128>(helper.selMask[0]));
   }
-  mAccountedBCranges.resize(mBCranges.size(), false);
+  mAccountedBCranges.resize(mBCrangeMin.size(), false);
 }
@@ -21,6 +21,7 @@
 
 #include <bitset>
 #include <memory>
+#include <span>
 #include <string>
 #include <utility>
 #include <vector>
@@ -45,7 +46,9 @@ class Zorro
  public:
   Zorro() = default;
   std::vector<int> initCCDB(o2::ccdb::BasicCCDBManager* ccdb, int runNumber, uint64_t timestamp, std::string tois, int bcTolerance = 500);
+  void prefetch(o2::ccdb::BasicCCDBManager* ccdb, std::vector<int> const& runs) const; /// Prefetch the run-wise objects into the local CCDB cache, if enabled
   std::bitset<128> fetch(uint64_t bcGlobalId, uint64_t tolerance = 100);
+  std::vector<std::bitset<128>> fetch(std::span<const uint64_t> bcGlobalIds, uint64_t tolerance = 100); /// Results for a batch of BCs, equivalent to fetching them one by one
   bool isSelected(uint64_t bcGlobalId, uint64_t tolerance = 100, TH2* toiHisto = nullptr);
   bool isNotSelectedByAny(uint64_t bcGlobalId, uint64_t tolerance = 100);
 
@@ -90,9 +93,13 @@ class Zorro
   TH1D* mSelections = nullptr;
   TH1D* mInspectedTVX = nullptr;
   std::bitset<128> mLastResult;
-  std::vector<bool> mAccountedBCranges; /// Avoid double accounting of inspected BC ranges
-  std::vector<o2::dataformats::IRFrame> mBCranges;
+  std::vector<bool> mAccountedBCranges;        /// Avoid double accounting of inspected BC ranges
+  std::vector<uint64_t> mBCrangeMin;           /// Lower edges of the BC ranges of the current run, sorted
+  std::vector<uint64_t> mBCrangeMax;           /// Upper edges of the BC ranges
+  std::vector<uint64_t> mBCrangeMaxPrefix;     /// Running maximum of the upper edges, binary searched for the first candidate range
+  std::vector<std::bitset<128>> mBCrangeMasks; /// Selection masks of the BC ranges
   std::vector<ZorroHelper>* mZorroHelpers = nullptr;
+  std::vector<std::shared_ptr<void>> mLocalCacheObjects; /// Run-wise objects read from the local CCDB cache
   std::vector<std::string> mTOIs;
   std::vector<int> mTOIidx;
   std::vector<int> mTOIcounts;
@@ -14,6 +14,8 @@
 #include <rapidjson/document.h>
 #include <rapidjson/filereadstream.h>
 
+#include <algorithm>
+#include <chrono>
 #include <cstdio>
 #include <random>
 #include <string>
@@ -215,6 +217,7 @@ struct centralEventFilterTask {
 
   Configurable<bool> cfgDisableDownscalings{"cfgDisableDownscalings", false, "Disable downscalings"};
   Configurable<bool> cfgSkipUntriggeredEvents{"cfgSkipUntriggeredEvents", false, "Skip untriggered events"};
+  ConfigurableAxis cfgTimeAxis{"cfgTimeAxis", {1000, 0., 10000.}, "Binning of the processing time per TF of each filter table (#mus)"};
 
   FILTER_CONFIGURABLE(F1ProtonFilters);
   FILTER_CONFIGURABLE(DoublePhiFilters);
@@ -242,6 +245,8 @@ struct centralEventFilterTask {
     auto mScalers = std::get<std::shared_ptr<TH1>>(scalers.add("mScalers", ";;Number of events", HistType::kTH1D, {{nCols + 2, -0.5, 1.5 + nCols}}));
     auto mFiltered = std::get<std::shared_ptr<TH1>>(scalers.add("mFiltered", ";;Number of filtered events", HistType::kTH1D, {{nCols + 2, -0.5, 1.5 + nCols}}));
     auto mCovariance = std::get<std::shared_ptr<TH2>>(scalers.add("mCovariance", "Selection covariance", HistType::kTH2D, {{nCols, -0.5, nCols - 0.5}, {nCols, -0.5, nCols - 0.5}}));
+    const int nTables = mDownscaling.size();
+    auto mProcessingTime = std::get<std::shared_ptr<TH2>>(scalers.add("mProcessingTime", "Processing time of the filter tables per TF;;Time (#mus)", HistType::kTH2D, {{std::max(nTables, 1), -0.5, std::max(nTables, 1) - 0.5}, {cfgTimeAxis}}));
 
     mScalers->GetXaxis()->SetBinLabel(1, "Total number of events");
     mFiltered->GetXaxis()->SetBinLabel(1, "Total number of events");
@@ -249,8 +254,10 @@ struct centralEventFilterTask {
     mFiltered->GetXaxis()->SetBinLabel(nCols + 2, "Filtered events");
     int bin{2};
 
+    int tableBin{1};
     for (auto& table : mDownscaling) {
       LOG(info) << "Setting downscalings for table " << table.first;
+      mProcessingTime->GetXaxis()->SetBinLabel(tableBin++, table.first.data());
       for (auto& column : table.second) {
         mCovariance->GetXaxis()->SetBinLabel(bin - 1, column.first.data());
         mCovariance->GetYaxis()->SetBinLabel(bin - 1, column.first.data());
@@ -309,10 +316,13 @@ struct centralEventFilterTask {
     auto mScalers{scalers.get<TH1>(HIST("mScalers"))};
     auto mFiltered{scalers.get<TH1>(HIST("mFiltered"))};
     auto mCovariance{scalers.get<TH2>(HIST("mCovariance"))};
+    auto mProcessingTime{scalers.get<TH2>(HIST("mProcessingTime"))};
 
     int64_t nEvents{collTabPtr->num_rows()};
     std::vector<std::array<uint64_t, 2>> outTrigger, outDecision;
+    int iTable{0};
     for (auto& tableName : mDownscaling) {
+      const auto start = std::chrono::steady_clock::now();
       if (!pc.inputs().isValid(tableName.first)) {
         LOG(fatal) << tableName.first << " table is not valid.";
       }
@@ -355,6 +365,7 @@ struct centralEventFilterTask {
           }
         }
       }
+      mProcessingTime->Fill(iTable++, std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
     }
     mScalers->SetBinContent(1, mScalers->GetBinContent(1) + nEvents - startCollision);
     mFiltered->SetBinContent(1, mFiltered->GetBinContent(1) + nEvents - startCollision);
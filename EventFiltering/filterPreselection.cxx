@@ -0,0 +1,92 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file filterPreselection.cxx
+/// \brief Track preselection computed once per TF and shared by the software triggers
+///
+/// The bits of preselection::TrackPreselectionBits are stored in the FilterTrackPresels table,
+/// one row per track, which the filters can join with their track tables and use in a Filter
+/// expression instead of repeating the same quality, DCA and TPC PID selections.
+
+#include <cmath>
+#include <cstdint>
+
+#include "Common/DataModel/PIDResponse.h"
+#include "Common/DataModel/TrackSelectionTables.h"
+#include "Framework/AnalysisTask.h"
+#include "Framework/HistogramRegistry.h"
+#include "Framework/runDataProcessing.h"
+
+#include "filterTables.h"
+
+using namespace o2;
+using namespace o2::framework;
+using namespace o2::aod::preselection;
+
+struct FilterPreselection {
+
+  Produces<aod::FilterTrackPresels> trackPresels;
+
+  Configurable<int> cfgMinNclusITS{"cfgMinNclusITS", 2, "Minimum number of ITS clusters for the quality bit"};
+  Configurable<int> cfgMinNclusTPC{"cfgMinNclusTPC", 70, "Minimum number of TPC clusters for the quality bit"};
+  Configurable<float> cfgMaxChi2TPC{"cfgMaxChi2TPC", 4.f, "Maximum TPC chi2 per cluster for the quality bit"};
+  Configurable<float> cfgLooseDCAxy{"cfgLooseDCAxy", 1.f, "Maximum DCAxy for the loose DCA bit"};
+  Configurable<float> cfgLooseDCAz{"cfgLooseDCAz", 2.f, "Maximum DCAz for the loose DCA bit"};
+  Configurable<float> cfgTightDCAxy{"cfgTightDCAxy", 0.1f, "Maximum DCAxy for the tight DCA bit"};
+  Configurable<float> cfgTightDCAz{"cfgTightDCAz", 0.2f, "Maximum DCAz for the tight DCA bit"};
+  Configurable<float> cfgMaxNsigmaTPC{"cfgMaxNsigmaTPC", 5.f, "Maximum |n sigma TPC| for the PID bits"};
+
+  HistogramRegistry qaHists{"qaHists", {}, OutputObjHandlingPolicy::AnalysisObject};
+
+  using TrackCandidates = soa::Join<aod::TracksIU, aod::TracksExtra, aod::TracksDCA, aod::pidTPCFullPi, aod::pidTPCFullKa, aod::pidTPCFullPr, aod::pidTPCFullDe, aod::pidTPCFullHe>;
+
+  void init(InitContext&)
+  {
+    auto hBits = qaHists.add<TH1>("hTrackBits", ";;Number of tracks", HistType::kTH1D, {{kNTrackPreselectionBits + 1, -0.5, kNTrackPreselectionBits + 0.5}});
+    const char* labels[kNTrackPreselectionBits + 1]{"All", "ITS-TPC quality", "TOF", "Loose DCA", "Tight DCA", "TPC #pi", "TPC K", "TPC p", "TPC d", "TPC ^{3}He"};
+    for (int iBin = 0; iBin <= kNTrackPreselectionBits; iBin++) {
+      hBits->GetXaxis()->SetBinLabel(iBin + 1, labels[iBin]);
+    }
+  }
+
+  void process(TrackCandidates const& tracks)
+  {
+    auto hBits = qaHists.get<TH1>(HIST("hTrackBits"));
+    trackPresels.reserve(tracks.size());
+    for (auto const& track : tracks) {
+      uint16_t bits{0};
+      const float absDcaXY = std::abs(track.dcaXY());
+      const float absDcaZ = std::abs(track.dcaZ());
+      bits |= (track.itsNCls() >= cfgMinNclusITS && track.tpcNClsFound() >= cfgMinNclusTPC && track.tpcChi2NCl() < cfgMaxChi2TPC) << kITSTPCQuality;
+      bits |= track.hasTOF() << kHasTOF;
+      bits |= (absDcaXY < cfgLooseDCAxy && absDcaZ < cfgLooseDCAz) << kDcaLoose;
+      bits |= (absDcaXY < cfgTightDCAxy && absDcaZ < cfgTightDCAz) << kDcaTight;
+      bits |= (std::abs(track.tpcNSigmaPi()) < cfgMaxNsigmaTPC) << kTPCPion;
+      bits |= (std::abs(track.tpcNSigmaKa()) < cfgMaxNsigmaTPC) << kTPCKaon;
+      bits |= (std::abs(track.tpcNSigmaPr()) < cfgMaxNsigmaTPC) << kTPCProton;
+      bits |= (std::abs(track.tpcNSigmaDe()) < cfgMaxNsigmaTPC) << kTPCDeuteron;
+      bits |= (std::abs(track.tpcNSigmaHe()) < cfgMaxNsigmaTPC) << kTPCHelium;
+      trackPresels(bits);
+
+      hBits->Fill(0);
+      for (int iBit = 0; iBit < kNTrackPreselectionBits; iBit++) {
+        if (bits & BIT(iBit)) {
+          hBits->Fill(iBit + 1);
+        }
+      }
+    }
+  }
+};
+
+WorkflowSpec defineDataProcessing(ConfigContext const& cfg)
+{
+  return WorkflowSpec{adaptAnalysisTask<FilterPreselection>(cfg)};
+}
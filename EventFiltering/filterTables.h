@@ -231,6 +231,25 @@ DECLARE_SOA_COLUMN(BCend, hasBCend, uint64_t);     //! CEFP bcrange
 
 } // namespace bcrange
 
+namespace preselection
+{
+/// Bits of the track preselection shared by the filters
+enum TrackPreselectionBits : uint32_t {
+  kITSTPCQuality = 0, /// minimum number of ITS and TPC clusters and maximum TPC chi2
+  kHasTOF,            /// TOF matched
+  kDcaLoose,          /// inside the loose DCAxy and DCAz windows
+  kDcaTight,          /// inside the tight DCAxy and DCAz windows
+  kTPCPion,           /// TPC PID compatible with the species
+  kTPCKaon,
+  kTPCProton,
+  kTPCDeuteron,
+  kTPCHelium,
+  kNTrackPreselectionBits
+};
+
+DECLARE_SOA_COLUMN(TrackBits, trackBits, uint16_t); //! Bit map of the TrackPreselectionBits
+} // namespace preselection
+
 // nuclei
 DECLARE_SOA_TABLE(NucleiFilters, "AOD", "NucleiFilters", //!
                   filtering::H2, filtering::He, filtering::HeV0, filtering::TritonFemto, filtering::H3L3Body, filtering::Tracked3Body, filtering::ITSmildIonisation,
@@ -364,6 +383,11 @@ DECLARE_SOA_TABLE(BCRanges, "AOD", "BCRanges", //!
                   bcrange::BCstart, bcrange::BCend);
 using BCRange = BCRanges::iterator;
 
+// track preselection, one row per track, joinable with the track tables
+DECLARE_SOA_TABLE(FilterTrackPresels, "AOD", "FTrkPresel", //!
+                  preselection::TrackBits);
+using FilterTrackPresel = FilterTrackPresels::iterator;
+
 /// List of the available filters, the description of their tables and the name of the tasks
 constexpr int NumberOfFilters{14};
 constexpr std::array<char[32], NumberOfFilters> AvailableFilters{"NucleiFilters", "DiffractionFilters", "DqFilters", "HfFilters", "CFFilters", "JetFilters", "JetHFFilters", "FullJetFilters", "StrangenessFilters", "MultFilters", "PhotonFilters", "F1ProtonFilters", "DoublePhiFilters", "HeavyNeutralMesonFilters"};
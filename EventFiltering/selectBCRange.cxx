@@ -18,6 +18,7 @@
 #include "Framework/runDataProcessing.h"
 
 #include "filterTables.h"
+#include "IRFrameMerger.h"
 
 using namespace o2;
 using namespace o2::framework;
@@ -34,6 +35,8 @@ struct BCRangeSelector {
   // buffer for task output
   Produces<aod::BCRanges> tags;
 
+  IRFrameMerger bcRanges;
+
   template <typename T>
   IRFrame getIRFrame(T& collision)
   {
@@ -73,21 +76,25 @@ struct BCRangeSelector {
 
     auto filt = decisions.begin();
     int firstSelectedCollision{-1};
-    std::vector<IRFrame> bcRanges;
+    IRFrame firstFrame;
+    bcRanges.clear();
     int nColl{0}, nSelected{0};
+    /// While collisions are sorted by time, the corresponding minBCs can be unsorted as the collision time resolution is not constant: the merger takes care of it
     for (auto collision : cols) {
       if (filt.cefpSelected0() || filt.cefpSelected1()) {
         if (firstSelectedCollision < 0) {
           firstSelectedCollision = nColl;
+          firstFrame = getIRFrame(collision); // added after the loop, once extended to the MB events
+        } else {
+          bcRanges.add(getIRFrame(collision));
         }
-        bcRanges.push_back(getIRFrame(collision));
         nSelected++;
       }
       nColl++;
       filt++;
     }
 
-    if (bcRanges.empty()) {
+    if (firstSelectedCollision < 0) {
       LOGF(warning, "No BCs selected!");
       return;
     }
@@ -99,29 +106,15 @@ struct BCRangeSelector {
     int minCollisionId = (maxCollisionId == nMB) ? 0 : firstSelectedCollision - nMB;
     auto minCollision = cols.begin() + minCollisionId;
     IRFrame minFrame{getIRFrame(minCollision)};
-    bcRanges[0].getMin() = std::min(bcRanges[0].getMin(), minFrame.getMin());
+    firstFrame.getMin() = std::min(firstFrame.getMin(), minFrame.getMin());
     if (maxCollisionId == nMB) {
       auto maxCollision = cols.begin() + nMB;
       IRFrame maxFrame{getIRFrame(maxCollision)};
-      bcRanges[0].getMax() = std::max(bcRanges[0].getMax(), maxFrame.getMax());
-    }
-
-    /// We cannot merge the ranges in the previous loop because while collisions are sorted by time, the corresponding minBCs can be unsorted as the collision time resolution is not constant
-    std::sort(bcRanges.begin(), bcRanges.end(), [](const IRFrame& a, const IRFrame& b) {
-      return a.getMin() < b.getMin();
-    });
-
-    std::vector<IRFrame> bcRangesMerged(1, bcRanges[0]);
-    for (uint64_t iR{1}; iR < bcRanges.size(); ++iR) {
-      if (bcRangesMerged.back().getMax() >= bcRanges[iR].getMin()) {
-        bcRangesMerged.back().getMax() = std::max(bcRangesMerged.back().getMax(), bcRanges[iR].getMax());
-      } else {
-        bcRangesMerged.push_back(bcRanges[iR]);
-      }
+      firstFrame.getMax() = std::max(firstFrame.getMax(), maxFrame.getMax());
     }
-    bcRanges.swap(bcRangesMerged);
+    bcRanges.add(firstFrame);
 
-    for (auto& range : bcRanges) {
+    for (const auto& range : bcRanges.getMerged()) {
       tags(range.getMin().toLong(), range.getMax().toLong());
     }
   }
@@ -29,6 +29,11 @@
 #include "THn.h"
 #include "Framework/HistogramSpec.h"
 #include "CommonConstants/MathConstants.h"
+#include "TArray.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
 
 using namespace o2;
 using namespace o2::framework;
@@ -1651,3 +1656,118 @@ void CorrelationContainer::fillEvent(Float_t centrality, CFStep step)
   // Fill per-event information
   mEventCount->Fill(step, centrality);
 }
+
+//____________________________________________________________________
+CorrelationPairBuffer::CorrelationPairBuffer(Int_t capacity) : mCapacity(capacity)
+{
+  for (auto& values : mValues) {
+    values.reserve(mCapacity);
+  }
+  mWeights.reserve(mCapacity);
+  mBins.reserve(mCapacity);
+}
+
+//____________________________________________________________________
+void CorrelationPairBuffer::setTarget(StepTHn* pairHist, Int_t step)
+{
+  if (pairHist == mTarget && step == mStep) {
+    return;
+  }
+  flush();
+  mTarget = pairHist;
+  mStep = step;
+}
+
+//____________________________________________________________________
+void CorrelationPairBuffer::flush()
+{
+  if (mWeights.empty()) {
+    return;
+  }
+  if (!mTarget) {
+    LOGF(fatal, "CorrelationPairBuffer: pairs added without target histogram");
+  }
+  fill(mTarget, mStep, mWeights.size(), mValues[0].data(), mValues[1].data(), mValues[2].data(), mValues[3].data(), mValues[4].data(), mValues[5].data(), mWeights.data());
+  for (auto& values : mValues) {
+    values.clear();
+  }
+  mWeights.clear();
+}
+
+//____________________________________________________________________
+const std::vector<CorrelationPairBuffer::AxisCache>& CorrelationPairBuffer::getAxes(StepTHn* pairHist)
+{
+  // axis parameters are cached per histogram, the buffer usually alternates between same and mixed event
+  for (const auto& entry : mAxisCache) {
+    if (entry.first == pairHist) {
+      return entry.second;
+    }
+  }
+
+  if (pairHist->getNVar() != kNAxes) {
+    LOGF(fatal, "CorrelationPairBuffer: pair histogram has %d axes, only %d are supported", pairHist->getNVar(), kNAxes);
+  }
+  std::vector<AxisCache> axes(kNAxes);
+  for (Int_t i = 0; i < kNAxes; i++) {
+    const TAxis* axis = pairHist->GetAxis(i);
+    axes[i].nBins = axis->GetNbins();
+    axes[i].min = axis->GetXmin();
+    axes[i].max = axis->GetXmax();
+    if (axis->GetXbins()->fN) {
+      axes[i].edges.assign(axis->GetXbins()->GetArray(), axis->GetXbins()->GetArray() + axis->GetXbins()->fN);
+    }
+  }
+  mAxisCache.emplace_back(pairHist, std::move(axes));
+  return mAxisCache.back().second;
+}
+
+//____________________________________________________________________
+void CorrelationPairBuffer::fill(StepTHn* pairHist, Int_t step, Int_t n, const Float_t* deltaEta, const Float_t* ptAssoc, const Float_t* ptTrig, const Float_t* multiplicity, const Float_t* deltaPhi, const Float_t* zVtx, const Float_t* weight)
+{
+  const auto& axes = getAxes(pairHist);
+  const Float_t* values[kNAxes] = {deltaEta, ptAssoc, ptTrig, multiplicity, deltaPhi, zVtx};
+
+  // linear bin index as in StepTHn::Fill (first axis slowest, bins starting from 0), -1 for under- and overflow
+  mBins.assign(n, 0);
+  Long64_t* bins = mBins.data();
+  for (Int_t i = 0; i < kNAxes; i++) {
+    const AxisCache& axis = axes[i];
+    const Float_t* x = values[i];
+    if (axis.edges.empty()) {
+      // same arithmetic as TAxis::FindBin for fixed bins, branch-free so that the loop vectorises
+      for (Int_t j = 0; j < n; j++) {
+        const Double_t value = x[j];
+        const bool inRange = value >= axis.min && value < axis.max;
+        const Long64_t bin = inRange ? static_cast<Long64_t>(axis.nBins * (value - axis.min) / (axis.max - axis.min)) : 0;
+        bins[j] = (inRange && bins[j] >= 0) ? bins[j] * axis.nBins + bin : -1;
+      }
+    } else {
+      for (Int_t j = 0; j < n; j++) {
+        const Double_t value = x[j];
+        const bool inRange = value >= axis.min && value < axis.max;
+        const Long64_t bin = inRange ? std::upper_bound(axis.edges.begin(), axis.edges.end(), value) - axis.edges.begin() - 1 : 0;
+        bins[j] = (inRange && bins[j] >= 0) ? bins[j] * axis.nBins + bin : -1;
+      }
+    }
+  }
+
+  // accumulate; the first fill of a step and the first weight != 1 go through StepTHn::Fill which creates the containers
+  TArray* content = pairHist->getValues(step);
+  TArray* sumw2 = pairHist->getSumw2(step);
+  for (Int_t j = 0; j < n; j++) {
+    if (bins[j] < 0) {
+      continue;
+    }
+    const Double_t w = weight ? weight[j] : 1.;
+    if (!content || (w != 1. && !sumw2)) {
+      pairHist->Fill(step, deltaEta[j], ptAssoc[j], ptTrig[j], multiplicity[j], deltaPhi[j], zVtx[j], w);
+      content = pairHist->getValues(step);
+      sumw2 = pairHist->getSumw2(step);
+      continue;
+    }
+    content->SetAt(content->GetAt(bins[j]) + w, bins[j]);
+    if (sumw2) {
+      sumw2->SetAt(sumw2->GetAt(bins[j]) + w * w, bins[j]);
+    }
+  }
+}
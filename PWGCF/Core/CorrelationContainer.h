@@ -18,6 +18,9 @@
 #include "TString.h"
 #include "Framework/HistogramSpec.h"
 
+#include <utility>
+#include <vector>
+
 class TH1;
 class TH1F;
 class TH3;
@@ -181,4 +184,55 @@ class CorrelationContainer : public TNamed
   ClassDef(CorrelationContainer, 2) // underlying event histogram container
 };
 
+// Bulk filling of the pair histogram (6 correlation axes, no user axes) of a CorrelationContainer
+//   Pairs are collected in structure-of-arrays form and flushed when the buffer is full or when the target changes.
+//   At flush the linear bins are computed axis by axis over all pairs and the weights are added directly to the
+//   bins of the StepTHn, which gives the same content as calling StepTHn::Fill pair by pair.
+class CorrelationPairBuffer
+{
+ public:
+  explicit CorrelationPairBuffer(Int_t capacity = 4096);
+  ~CorrelationPairBuffer() { flush(); }
+
+  // flushes the pending pairs if the target histogram or step changes
+  void setTarget(StepTHn* pairHist, Int_t step);
+  void add(Float_t deltaEta, Float_t ptAssoc, Float_t ptTrig, Float_t multiplicity, Float_t deltaPhi, Float_t zVtx, Float_t weight)
+  {
+    mValues[0].push_back(deltaEta);
+    mValues[1].push_back(ptAssoc);
+    mValues[2].push_back(ptTrig);
+    mValues[3].push_back(multiplicity);
+    mValues[4].push_back(deltaPhi);
+    mValues[5].push_back(zVtx);
+    mWeights.push_back(weight);
+    if (static_cast<Int_t>(mWeights.size()) >= mCapacity) {
+      flush();
+    }
+  }
+  void flush();
+
+  // bulk fill of n pairs, the arrays follow the axis order of the pair histogram, weight can be nullptr
+  void fill(StepTHn* pairHist, Int_t step, Int_t n, const Float_t* deltaEta, const Float_t* ptAssoc, const Float_t* ptTrig, const Float_t* multiplicity, const Float_t* deltaPhi, const Float_t* zVtx, const Float_t* weight);
+
+ private:
+  static constexpr Int_t kNAxes = 6;
+
+  struct AxisCache {
+    Int_t nBins = 0;
+    Double_t min = 0;
+    Double_t max = 0;
+    std::vector<Double_t> edges; // only for variable binning
+  };
+
+  const std::vector<AxisCache>& getAxes(StepTHn* pairHist);
+
+  Int_t mCapacity;
+  StepTHn* mTarget = nullptr;
+  Int_t mStep = 0;
+  std::vector<Float_t> mValues[kNAxes];
+  std::vector<Float_t> mWeights;
+  std::vector<Long64_t> mBins;
+  std::vector<std::pair<StepTHn*, std::vector<AxisCache>>> mAxisCache; // per target histogram
+};
+
 #endif
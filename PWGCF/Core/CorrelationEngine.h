@@ -0,0 +1,220 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#ifndef PWGCF_CORE_CORRELATIONENGINE_H_
+#define PWGCF_CORE_CORRELATIONENGINE_H_
+
+#include "CommonConstants/MathConstants.h"
+
+#include <cstdint>
+#include <vector>
+
+// Trigger x associated loop of the two-particle correlation tasks
+//   The particles of an event (or of the two events of a mixed-event pair) are copied once into
+//   structure-of-arrays form together with their weights (e.g. the efficiency correction). For each trigger
+//   the selection of the associated particles (self pairs, pT ordering, charges) is computed as a mask over all
+//   associated particles, the pairs passing it can be vetoed by a pair cut (e.g. PairCuts), and the selected
+//   pairs are handed over as a block of arrays (delta eta, delta phi, pT associated, weight) to a sink, which
+//   fills the task histograms, e.g. through a CorrelationPairBuffer.
+
+class CorrelationParticles
+{
+ public:
+  // read-only view of one particle, with the accessors needed by PairCuts
+  class Particle
+  {
+   public:
+    Particle(const CorrelationParticles& particles, int index) : mParticles(particles), mIndex(index) {}
+    int index() const { return mIndex; }
+    float pt() const { return mParticles.pt[mIndex]; }
+    float eta() const { return mParticles.eta[mIndex]; }
+    float phi() const { return mParticles.phi[mIndex]; }
+    int sign() const { return mParticles.sign[mIndex]; }
+    int64_t globalIndex() const { return mParticles.id[mIndex]; }
+    float weight() const { return mParticles.weight[mIndex]; }
+
+   private:
+    const CorrelationParticles& mParticles;
+    int mIndex;
+  };
+
+  void clear()
+  {
+    pt.clear();
+    eta.clear();
+    phi.clear();
+    sign.clear();
+    id.clear();
+    weight.clear();
+  }
+  void reserve(std::size_t n)
+  {
+    pt.reserve(n);
+    eta.reserve(n);
+    phi.reserve(n);
+    sign.reserve(n);
+    id.reserve(n);
+    weight.reserve(n);
+  }
+  void add(float ptValue, float etaValue, float phiValue, int signValue, int64_t idValue, float weightValue = 1.f)
+  {
+    pt.push_back(ptValue);
+    eta.push_back(etaValue);
+    phi.push_back(phiValue);
+    sign.push_back(static_cast<int8_t>(signValue));
+    id.push_back(idValue);
+    weight.push_back(weightValue);
+  }
+  int size() const { return static_cast<int>(pt.size()); }
+  Particle operator[](int i) const { return Particle(*this, i); }
+
+  class Iterator
+  {
+   public:
+    Iterator(const CorrelationParticles& particles, int index) : mParticles(particles), mIndex(index) {}
+    Particle operator*() const { return mParticles[mIndex]; }
+    Iterator& operator++()
+    {
+      mIndex++;
+      return *this;
+    }
+    bool operator!=(const Iterator& other) const { return mIndex != other.mIndex; }
+
+   private:
+    const CorrelationParticles& mParticles;
+    int mIndex;
+  };
+  Iterator begin() const { return Iterator(*this, 0); }
+  Iterator end() const { return Iterator(*this, size()); }
+
+  std::vector<float> pt;
+  std::vector<float> eta;
+  std::vector<float> phi; // in [0, 2 pi)
+  std::vector<int8_t> sign;
+  std::vector<int64_t> id; // global index, pairs of a particle with itself are skipped
+  std::vector<float> weight;
+};
+
+class CorrelationEngine
+{
+ public:
+  struct Selection {
+    bool ptOrder = false;      // keep the pairs with pT,assoc < pT,trig
+    int triggerCharge = 0;     // 0 = all; 1 = positive; -1 = negative
+    int associatedCharge = 0;  // 0 = all; 1 = positive; -1 = negative
+    int pairCharge = 0;        // 0 = all; 1 = like sign; -1 = unlike sign
+    bool skipSelfPairs = true; // skip the pairs with the same global index (same event)
+  };
+
+  void setSelection(const Selection& selection) { mSelection = selection; }
+  const Selection& getSelection() const { return mSelection; }
+
+  // Correlates the triggers with the associated particles. For each trigger passing the trigger charge selection
+  //   triggerSink(trigger, weight) is called with weight = eventWeight x trigger weight, then the associated
+  //   particles are selected, vetoed with veto(trigger particle, associated particle) when it returns true, and
+  //   pairSink(trigger, n, deltaEta, deltaPhi, ptAssoc, weight) is called with the n selected pairs, with delta phi
+  //   in [-pi/2, 3pi/2) and weight = eventWeight x trigger weight x associated weight.
+  template <typename TTriggerSink, typename TVeto, typename TPairSink>
+  void correlate(const CorrelationParticles& triggers, const CorrelationParticles& associated, float eventWeight,
+                 TTriggerSink&& triggerSink, TVeto&& veto, TPairSink&& pairSink);
+
+  // as above, without a pair veto
+  template <typename TTriggerSink, typename TPairSink>
+  void correlate(const CorrelationParticles& triggers, const CorrelationParticles& associated, float eventWeight,
+                 TTriggerSink&& triggerSink, TPairSink&& pairSink)
+  {
+    correlate(triggers, associated, eventWeight, triggerSink, [](const CorrelationParticles::Particle&, const CorrelationParticles::Particle&) { return false; }, pairSink);
+  }
+
+ private:
+  Selection mSelection;
+
+  // per-trigger work arrays
+  std::vector<uint8_t> mMask;
+  std::vector<float> mDeltaEta;
+  std::vector<float> mDeltaPhi;
+  std::vector<float> mPtAssoc;
+  std::vector<float> mWeight;
+};
+
+template <typename TTriggerSink, typename TVeto, typename TPairSink>
+void CorrelationEngine::correlate(const CorrelationParticles& triggers, const CorrelationParticles& associated, float eventWeight,
+                                  TTriggerSink&& triggerSink, TVeto&& veto, TPairSink&& pairSink)
+{
+  using o2::constants::math::PIHalf;
+  using o2::constants::math::TwoPI;
+
+  const int nAssoc = associated.size();
+  mMask.resize(nAssoc);
+  mDeltaEta.resize(nAssoc);
+  mDeltaPhi.resize(nAssoc);
+  mPtAssoc.resize(nAssoc);
+  mWeight.resize(nAssoc);
+
+  const float* ptA = associated.pt.data();
+  const float* etaA = associated.eta.data();
+  const float* phiA = associated.phi.data();
+  const int8_t* signA = associated.sign.data();
+  const int64_t* idA = associated.id.data();
+  const float* weightA = associated.weight.data();
+  uint8_t* mask = mMask.data();
+
+  const bool ptOrder = mSelection.ptOrder;
+  const bool skipSelf = mSelection.skipSelfPairs;
+  const int associatedCharge = mSelection.associatedCharge;
+  const int pairCharge = mSelection.pairCharge;
+
+  for (int iTrig = 0; iTrig < triggers.size(); iTrig++) {
+    const int signT = triggers.sign[iTrig];
+    if (mSelection.triggerCharge != 0 && mSelection.triggerCharge * signT < 0) {
+      continue;
+    }
+    const float ptT = triggers.pt[iTrig];
+    const float etaT = triggers.eta[iTrig];
+    const float phiT = triggers.phi[iTrig];
+    const int64_t idT = triggers.id[iTrig];
+    const float triggerWeight = eventWeight * triggers.weight[iTrig];
+    triggerSink(iTrig, triggerWeight);
+
+    // selection mask, branch-free so that the loop vectorises
+    for (int j = 0; j < nAssoc; j++) {
+      bool keep = !(skipSelf && idA[j] == idT);
+      keep &= !(ptOrder && ptA[j] >= ptT);
+      keep &= !(associatedCharge != 0 && associatedCharge * signA[j] < 0);
+      keep &= !(pairCharge != 0 && pairCharge * signT * signA[j] < 0);
+      mask[j] = keep;
+    }
+
+    // pair cuts and compaction of the selected pairs
+    int n = 0;
+    for (int j = 0; j < nAssoc; j++) {
+      if (!mask[j] || veto(triggers[iTrig], associated[j])) {
+        continue;
+      }
+      float deltaPhi = phiT - phiA[j];
+      if (deltaPhi < -PIHalf) {
+        deltaPhi += TwoPI;
+      } else if (deltaPhi >= 3 * PIHalf) {
+        deltaPhi -= TwoPI;
+      }
+      mDeltaEta[n] = etaT - etaA[j];
+      mDeltaPhi[n] = deltaPhi;
+      mPtAssoc[n] = ptA[j];
+      mWeight[n] = triggerWeight * weightA[j];
+      n++;
+    }
+    if (n > 0) {
+      pairSink(iTrig, n, mDeltaEta.data(), mDeltaPhi.data(), mPtAssoc.data(), mWeight.data());
+    }
+  }
+}
+
+#endif // PWGCF_CORE_CORRELATIONENGINE_H_
@@ -0,0 +1,148 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file FilterTrackClassification.h
+/// \brief Per track classification shared by the dptDpt and identifiedBf filters
+///
+/// The filters store for each track a compact code: the species index times two for positive tracks and
+/// the species index times two plus one for negative tracks, negative if the track is not accepted.
+/// The helpers here compute that code, check the ambiguity of the track collision association and cache
+/// the codes of a dataframe, so that process variants running on the same tracks classify them once.
+
+#ifndef PWGCF_CORE_FILTERTRACKCLASSIFICATION_H_
+#define PWGCF_CORE_FILTERTRACKCLASSIFICATION_H_
+
+#include "Framework/AnalysisDataModel.h"
+#include "Framework/ASoA.h"
+#include "Common/DataModel/CollisionAssociationTables.h"
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace o2::analysis::filtertracks
+{
+
+/// \enum AmbiguityTypes
+/// \brief The types of track collision association
+enum AmbiguityTypes {
+  kNoAmbiguous = 0,             ///< no ambiguous track
+  kOnePossibilitySame = 1,      ///< the track is in the collision association table with the same collision, so it is not ambiguous
+  kOnePossibilityDifferent = 2, ///< the track is in the collision association table with a different collision, so it is ambiguous
+  kMoreThanOnePossibility = 3   ///< the track is associated to more than one collision, so it is ambiguous
+};
+
+/// \brief the code of an accepted track of the given species and sign
+inline int8_t speciesChargeCode(int8_t species, int sign)
+{
+  return (sign > 0) ? species * 2 : species * 2 + 1;
+}
+/// \brief the species of an accepted track code
+inline int8_t speciesFromCode(int8_t code) { return code / 2; }
+/// \brief whether an accepted track code corresponds to a positive track
+inline bool isPositiveCode(int8_t code) { return code % 2 == 0; }
+
+/// \brief Computes RMS of the values of the passed vector
+/// \param vec  vector of values to compute RMS
+template <typename T>
+T computeRMS(std::vector<T>& vec)
+{
+  T sum = std::accumulate(vec.begin(), vec.end(), 0.0);
+  T mean = sum / vec.size();
+
+  std::vector<T> diff(vec.size());
+  std::transform(vec.begin(), vec.end(), diff.begin(), [mean](T x) { return x - mean; });
+  T sqSum = std::inner_product(diff.begin(), diff.end(), diff.begin(), 0.0);
+  T stdDev = std::sqrt(sqSum / vec.size());
+
+  return stdDev;
+}
+
+/// \brief Classifies the collision association of the track
+/// \param zvertexes filled with the z of the vertexes of the compatible collisions for the ambiguous tracks
+/// Only the tracks joined with the collision association table can be ambiguous
+template <typename CollisionObjects, typename TrackObject>
+AmbiguityTypes trackAmbiguity(CollisionObjects const& collisions, TrackObject const& track, std::vector<double>& zvertexes)
+{
+  zvertexes.clear();
+  if constexpr (framework::has_type_v<aod::track_association::CollisionIds, typename TrackObject::all_columns>) {
+    if (track.compatibleCollIds().size() > 0) {
+      if (track.compatibleCollIds().size() == 1) {
+        if (track.collisionId() != track.compatibleCollIds()[0]) {
+          /* in principle we should not be here because the track is associated to two collisions at least */
+          zvertexes.push_back(collisions.iteratorAt(track.collisionId()).posZ());
+          zvertexes.push_back(collisions.iteratorAt(track.compatibleCollIds()[0]).posZ());
+          return kOnePossibilityDifferent;
+        }
+        return kOnePossibilitySame;
+      }
+      /* the track is associated to more than one collision */
+      for (const auto& collIdx : track.compatibleCollIds()) {
+        zvertexes.push_back(collisions.iteratorAt(collIdx).posZ());
+      }
+      return kMoreThanOnePossibility;
+    }
+  }
+  return kNoAmbiguous;
+}
+
+/// \brief Cache of the track codes of a dataframe
+/// The cache is bound to a track table through its size and the kinematics of its first and last tracks,
+/// which identifies the dataframe without framework support; a process variant finding the cache bound to
+/// its tracks reuses the codes instead of classifying the tracks again, with their histograms and multiplicities.
+class TrackCodeCache
+{
+ public:
+  static constexpr int8_t kNotClassified = INT8_MIN;
+
+  template <typename TrackObjects>
+  bool isBoundTo(TrackObjects const& tracks) const
+  {
+    return !mCodes.empty() && mCodes.size() == static_cast<std::size_t>(tracks.size()) && mFingerprint == fingerprint(tracks);
+  }
+  template <typename TrackObjects>
+  void bind(TrackObjects const& tracks)
+  {
+    mCodes.assign(tracks.size(), kNotClassified);
+    mFingerprint = fingerprint(tracks);
+  }
+  void clear()
+  {
+    mCodes.clear();
+    mFingerprint = {};
+  }
+  /// \brief the code of the track at the given position in the table, kNotClassified if not stored
+  int8_t get(int64_t position) const { return mCodes[position]; }
+  void set(int64_t position, int8_t code) { mCodes[position] = code; }
+
+ private:
+  template <typename TrackObjects>
+  static std::array<float, 4> fingerprint(TrackObjects const& tracks)
+  {
+    if (tracks.size() == 0) {
+      return {};
+    }
+    auto first = tracks.rawIteratorAt(0);
+    auto last = tracks.rawIteratorAt(tracks.size() - 1);
+    return {first.pt(), first.eta(), last.pt(), last.eta()};
+  }
+
+  std::vector<int8_t> mCodes;
+  std::array<float, 4> mFingerprint{};
+};
+
+} // namespace o2::analysis::filtertracks
+
+#endif // PWGCF_CORE_FILTERTRACKCLASSIFICATION_H_
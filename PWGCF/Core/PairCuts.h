@@ -13,6 +13,8 @@
 #define O2_ANALYSIS_PAIRCUTS_H
 
 #include <cmath>
+#include <cstdint>
+#include <vector>
 
 #include "Framework/Logger.h"
 #include "Framework/HistogramRegistry.h"
@@ -65,6 +67,28 @@ class PairCuts
   template <typename T>
   bool twoTrackCut(T const& track1, T const& track2, int magField);
 
+  // Single-track quantities of the pair cuts, computed once per event with fillTrackCache
+  //   phiStar holds, for each track, phi - charge * asin(0.015 B r / pT) at the radii scanned by twoTrackCut
+  //   (from mTwoTrackRadius in steps of 1 cm, then 2.5 m), so that the pair cuts need no trigonometric calls.
+  //   The tracks are referred to by their position in the cache; the two tracks of a pair can come from two
+  //   caches (mixed events) filled with the same magnetic field.
+  struct TrackCache {
+    int nRadii = 0; // number of radii scanned, phiStar has nRadii + 1 entries per track
+    std::vector<float> pt;
+    std::vector<float> eta;
+    std::vector<float> phi;
+    std::vector<int8_t> sign;
+    std::vector<float> cotTheta;     // 1 / tan(theta)
+    std::vector<float> cotThetaFast; // 1 / tan(theta) from the expansion of exp(-eta) in getInvMassSquaredFast
+    std::vector<float> phiStar;
+  };
+
+  template <typename TTracks>
+  void fillTrackCache(TrackCache& cache, TTracks const& tracks, int magField) const;
+
+  bool conversionCuts(TrackCache const& cache1, int i1, TrackCache const& cache2, int i2);
+  bool twoTrackCut(TrackCache const& cache1, int i1, TrackCache const& cache2, int i2);
+
  protected:
   float mCuts[ParticlesLastEntry] = {-1};
   float mTwoTrackDistance = -1; // distance below which the pair is flagged as to be removed
@@ -83,6 +107,13 @@ class PairCuts
 
   template <typename T>
   float getDPhiStar(T const& track1, T const& track2, float radius, int magField);
+
+  bool conversionCut(TrackCache const& cache1, int i1, TrackCache const& cache2, int i2, Particle conv, double cut);
+  void fillTwoTrackHistograms(int stage, float deta, float dphistarmin, float deltaPt);
+
+  static bool getConversionMasses(Particle conv, double& massD1, double& massD2, double& massM);
+  static float getFastCosDeltaPhi(float phi1, float phi2);
+  static float foldDPhiStar(float dphistar);
 };
 
 template <typename T>
@@ -142,18 +173,14 @@ bool PairCuts::twoTrackCut(T const& track1, T const& track2, int magField)
         }
       }
 
-      if (histogramRegistry != nullptr) {
-        histogramRegistry->fill(HIST("TwoTrackDistancePt_0"), deta, dphistarmin, std::fabs(track1.pt() - track2.pt()));
-      }
+      fillTwoTrackHistograms(0, deta, dphistarmin, std::fabs(track1.pt() - track2.pt()));
 
       if (dphistarminabs < mTwoTrackDistance && std::fabs(deta) < mTwoTrackDistance) {
         //LOGF(debug, "Removed track pair %ld %ld with %f %f %f %f %d %f %f %d %d", track1.index(), track2.index(), deta, dphistarminabs, track1.phi2(), track1.pt(), track1.sign(), track2.phi2(), track2.pt(), track2.sign(), magField);
         return true;
       }
 
-      if (histogramRegistry != nullptr) {
-        histogramRegistry->fill(HIST("TwoTrackDistancePt_1"), deta, dphistarmin, std::fabs(track1.pt() - track2.pt()));
-      }
+      fillTwoTrackHistograms(1, deta, dphistarmin, std::fabs(track1.pt() - track2.pt()));
     }
   }
 
@@ -170,37 +197,8 @@ bool PairCuts::conversionCut(T const& track1, T const& track2, Particle conv, do
   }
 
   double massD1, massD2, massM;
-
-  switch (conv) {
-    case Photon:
-      massD1 = 0.51e-3;
-      massD2 = 0.51e-3;
-      massM = 0;
-      break;
-    case K0:
-      massD1 = 0.1396;
-      massD2 = 0.1396;
-      massM = 0.4976;
-      break;
-    case Lambda:
-      massD1 = 0.9383;
-      massD2 = 0.1396;
-      massM = 1.115;
-      break;
-    case Phi:
-      massD1 = 0.4937;
-      massD2 = 0.4937;
-      massM = 1.019;
-      break;
-    case Rho:
-      massD1 = 0.1396;
-      massD2 = 0.1396;
-      massM = 0.770;
-      break;
-    default:
-      LOGF(fatal, "Particle now known");
-      return false;
-      break;
+  if (!getConversionMasses(conv, massD1, massD2, massM)) {
+    return false;
   }
 
   auto massC = getInvMassSquaredFast(track1, massD1, track2, massD2);
@@ -284,23 +282,7 @@ double PairCuts::getInvMassSquaredFast(T const& track1, double m0_1, T const& tr
   float e1squ = m0_1 * m0_1 + pt1 * pt1 * (1.0f + 1.0f / tantheta1 / tantheta1);
   float e2squ = m0_2 * m0_2 + pt2 * pt2 * (1.0f + 1.0f / tantheta2 / tantheta2);
 
-  // fold onto 0...pi
-  float deltaPhi = std::fabs(phi1 - phi2);
-  while (deltaPhi > TwoPI) {
-    deltaPhi -= TwoPI;
-  }
-  if (deltaPhi > PI) {
-    deltaPhi = TwoPI - deltaPhi;
-  }
-
-  float cosDeltaPhi = 0;
-  if (deltaPhi < PI / 3.0f) {
-    cosDeltaPhi = 1.0 - deltaPhi * deltaPhi / 2 + deltaPhi * deltaPhi * deltaPhi * deltaPhi / 24;
-  } else if (deltaPhi < 2.0f * PI / 3.0f) {
-    cosDeltaPhi = -(deltaPhi - PI / 2) + 1.0 / 6 * std::pow((deltaPhi - PI / 2), 3);
-  } else {
-    cosDeltaPhi = -1.0f + 1.0f / 2.0f * (deltaPhi - PI) * (deltaPhi - PI) - 1.0f / 24.0f * std::pow(deltaPhi - PI, 4.0f);
-  }
+  float cosDeltaPhi = getFastCosDeltaPhi(phi1, phi2);
 
   double mass2 = m0_1 * m0_1 + m0_2 * m0_2 + 2.0f * (std::sqrt(e1squ * e2squ) - (pt1 * pt2 * (cosDeltaPhi + 1.0f / tantheta1 / tantheta2)));
 
@@ -326,6 +308,235 @@ float PairCuts::getDPhiStar(T const& track1, T const& track2, float radius, int
 
   float dphistar = phi1 - phi2 - charge1 * std::asin(0.015 * magField * radius / pt1) + charge2 * std::asin(0.015 * magField * radius / pt2);
 
+  return foldDPhiStar(dphistar);
+}
+
+template <typename TTracks>
+void PairCuts::fillTrackCache(TrackCache& cache, TTracks const& tracks, int magField) const
+{
+  cache.pt.clear();
+  cache.eta.clear();
+  cache.phi.clear();
+  cache.sign.clear();
+  cache.cotTheta.clear();
+  cache.cotThetaFast.clear();
+  cache.phiStar.clear();
+
+  std::vector<float> radii;
+  if (mTwoTrackDistance > 0) {
+    for (Double_t rad = mTwoTrackRadius; rad < 2.51; rad += 0.01) {
+      radii.push_back(rad);
+    }
+    radii.push_back(2.5);
+  }
+  cache.nRadii = static_cast<int>(radii.size()) - 1;
+  cache.phiStar.reserve(tracks.size() * radii.size());
+
+  for (const auto& track : tracks) {
+    const float eta = track.eta();
+    const float phi = track.phi();
+    const float pt = track.pt();
+    const int sign = track.sign();
+    cache.pt.push_back(pt);
+    cache.eta.push_back(eta);
+    cache.phi.push_back(phi);
+    cache.sign.push_back(static_cast<int8_t>(sign));
+
+    // as in getInvMassSquared and getInvMassSquaredFast
+    float tantheta = 1e10f;
+    float tanthetaFast = 1e10f;
+    if (eta < -1e-10f || eta > 1e-10f) {
+      float expTmp = std::exp(-eta);
+      tantheta = 2.0 * expTmp / (1.0 - expTmp * expTmp);
+      expTmp = 1.0f - eta + eta * eta / 2.0f - eta * eta * eta / 6.0f + eta * eta * eta * eta / 24.0f;
+      tanthetaFast = 2.0f * expTmp / (1.0f - expTmp * expTmp);
+    }
+    cache.cotTheta.push_back(1.0f / tantheta);
+    cache.cotThetaFast.push_back(1.0f / tanthetaFast);
+
+    for (const auto radius : radii) {
+      cache.phiStar.push_back(phi - sign * std::asin(0.015 * magField * radius / pt));
+    }
+  }
+}
+
+inline bool PairCuts::conversionCuts(TrackCache const& cache1, int i1, TrackCache const& cache2, int i2)
+{
+  // skip if like sign
+  if (cache1.sign[i1] * cache2.sign[i2] > 0) {
+    return false;
+  }
+
+  for (int i = 0; i < static_cast<int>(ParticlesLastEntry); i++) {
+    Particle particle = static_cast<Particle>(i);
+    if (mCuts[i] > 0) {
+      if (conversionCut(cache1, i1, cache2, i2, particle, mCuts[i])) {
+        return true;
+      }
+      if (particle == Lambda) {
+        if (conversionCut(cache2, i2, cache1, i1, particle, mCuts[i])) {
+          return true;
+        }
+      }
+    }
+  }
+
+  return false;
+}
+
+inline bool PairCuts::conversionCut(TrackCache const& cache1, int i1, TrackCache const& cache2, int i2, Particle conv, double cut)
+{
+  if (cut < 0) {
+    return false;
+  }
+
+  double massD1, massD2, massM;
+  if (!getConversionMasses(conv, massD1, massD2, massM)) {
+    return false;
+  }
+
+  const float pt1 = cache1.pt[i1];
+  const float pt2 = cache2.pt[i2];
+  const float ptProduct = pt1 * pt2;
+
+  // approximate mass as in getInvMassSquaredFast
+  float cot1 = cache1.cotThetaFast[i1];
+  float cot2 = cache2.cotThetaFast[i2];
+  float e1squ = massD1 * massD1 + pt1 * pt1 * (1.0f + cot1 * cot1);
+  float e2squ = massD2 * massD2 + pt2 * pt2 * (1.0f + cot2 * cot2);
+  double massC = massD1 * massD1 + massD2 * massD2 + 2.0f * (std::sqrt(e1squ * e2squ) - (ptProduct * (getFastCosDeltaPhi(cache1.phi[i1], cache2.phi[i2]) + cot1 * cot2)));
+
+  if (std::fabs(massC - massM * massM) > cut * 5) {
+    return false;
+  }
+
+  // mass as in getInvMassSquared
+  cot1 = cache1.cotTheta[i1];
+  cot2 = cache2.cotTheta[i2];
+  e1squ = massD1 * massD1 + pt1 * pt1 * (1.0 + cot1 * cot1);
+  e2squ = massD2 * massD2 + pt2 * pt2 * (1.0 + cot2 * cot2);
+  massC = massD1 * massD1 + massD2 * massD2 + 2 * (std::sqrt(e1squ * e2squ) - (ptProduct * (std::cos(cache1.phi[i1] - cache2.phi[i2]) + cot1 * cot2)));
+
+  if (histogramRegistry != nullptr) {
+    histogramRegistry->fill(HIST("ControlConvResonances"), static_cast<int>(conv), massC - massM * massM);
+  }
+
+  return massC > (massM - cut) * (massM - cut) && massC < (massM + cut) * (massM + cut);
+}
+
+inline bool PairCuts::twoTrackCut(TrackCache const& cache1, int i1, TrackCache const& cache2, int i2)
+{
+  auto deta = cache1.eta[i1] - cache2.eta[i2];
+
+  if (std::fabs(deta) < mTwoTrackDistance * 2.5 * 3) {
+    const int nRadii = cache1.nRadii;
+    const float* phiStar1 = cache1.phiStar.data() + static_cast<std::size_t>(i1) * (nRadii + 1);
+    const float* phiStar2 = cache2.phiStar.data() + static_cast<std::size_t>(i2) * (nRadii + 1);
+
+    // check first boundaries to see if is worth to loop and find the minimum
+    float dphistar1 = foldDPhiStar(phiStar1[0] - phiStar2[0]);
+    float dphistar2 = foldDPhiStar(phiStar1[nRadii] - phiStar2[nRadii]);
+
+    const float kLimit = mTwoTrackDistance * 3;
+
+    if (std::fabs(dphistar1) < kLimit || std::fabs(dphistar2) < kLimit || dphistar1 * dphistar2 < 0) {
+      float dphistarminabs = 1e5;
+      float dphistarmin = 1e5;
+      for (int k = 0; k < nRadii; k++) {
+        float dphistar = foldDPhiStar(phiStar1[k] - phiStar2[k]);
+
+        float dphistarabs = std::fabs(dphistar);
+
+        if (dphistarabs < dphistarminabs) {
+          dphistarmin = dphistar;
+          dphistarminabs = dphistarabs;
+        }
+      }
+
+      fillTwoTrackHistograms(0, deta, dphistarmin, std::fabs(cache1.pt[i1] - cache2.pt[i2]));
+
+      if (dphistarminabs < mTwoTrackDistance && std::fabs(deta) < mTwoTrackDistance) {
+        return true;
+      }
+
+      fillTwoTrackHistograms(1, deta, dphistarmin, std::fabs(cache1.pt[i1] - cache2.pt[i2]));
+    }
+  }
+
+  return false;
+}
+
+inline void PairCuts::fillTwoTrackHistograms(int stage, float deta, float dphistarmin, float deltaPt)
+{
+  if (histogramRegistry == nullptr) {
+    return;
+  }
+  if (stage == 0) {
+    histogramRegistry->fill(HIST("TwoTrackDistancePt_0"), deta, dphistarmin, deltaPt);
+  } else {
+    histogramRegistry->fill(HIST("TwoTrackDistancePt_1"), deta, dphistarmin, deltaPt);
+  }
+}
+
+inline bool PairCuts::getConversionMasses(Particle conv, double& massD1, double& massD2, double& massM)
+{
+  switch (conv) {
+    case Photon:
+      massD1 = 0.51e-3;
+      massD2 = 0.51e-3;
+      massM = 0;
+      break;
+    case K0:
+      massD1 = 0.1396;
+      massD2 = 0.1396;
+      massM = 0.4976;
+      break;
+    case Lambda:
+      massD1 = 0.9383;
+      massD2 = 0.1396;
+      massM = 1.115;
+      break;
+    case Phi:
+      massD1 = 0.4937;
+      massD2 = 0.4937;
+      massM = 1.019;
+      break;
+    case Rho:
+      massD1 = 0.1396;
+      massD2 = 0.1396;
+      massM = 0.770;
+      break;
+    default:
+      LOGF(fatal, "Particle now known");
+      return false;
+  }
+  return true;
+}
+
+inline float PairCuts::getFastCosDeltaPhi(float phi1, float phi2)
+{
+  // fold onto 0...pi
+  float deltaPhi = std::fabs(phi1 - phi2);
+  while (deltaPhi > TwoPI) {
+    deltaPhi -= TwoPI;
+  }
+  if (deltaPhi > PI) {
+    deltaPhi = TwoPI - deltaPhi;
+  }
+
+  float cosDeltaPhi = 0;
+  if (deltaPhi < PI / 3.0f) {
+    cosDeltaPhi = 1.0 - deltaPhi * deltaPhi / 2 + deltaPhi * deltaPhi * deltaPhi * deltaPhi / 24;
+  } else if (deltaPhi < 2.0f * PI / 3.0f) {
+    cosDeltaPhi = -(deltaPhi - PI / 2) + 1.0 / 6 * std::pow((deltaPhi - PI / 2), 3);
+  } else {
+    cosDeltaPhi = -1.0f + 1.0f / 2.0f * (deltaPhi - PI) * (deltaPhi - PI) - 1.0f / 24.0f * std::pow(deltaPhi - PI, 4.0f);
+  }
+  return cosDeltaPhi;
+}
+
+inline float PairCuts::foldDPhiStar(float dphistar)
+{
   if (dphistar > PI) {
     dphistar = TwoPI - dphistar;
   }
@@ -335,7 +546,6 @@ float PairCuts::getDPhiStar(T const& track1, T const& track2, float radius, int
   if (dphistar > PI) { // might look funny but is needed
     dphistar = TwoPI - dphistar;
   }
-
   return dphistar;
 }
 
@@ -0,0 +1,209 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file CumulantEngine.h
+/// \brief Efficiency corrected moments and cumulants of event-by-event multiplicity distributions
+///
+/// Building blocks shared by the cumulant tasks:
+/// - EfficiencyTable: the efficiency map (pT, eta) copied once into flat arrays, so that the per track
+///   lookup is a bin search instead of a histogram FindBin and GetBinContent;
+/// - addInverseEfficiencyPowers: the sums of the inverse efficiency powers of the tracks, entering the
+///   efficiency corrected factorial moments, computed by repeated multiplication instead of std::pow;
+/// - powers: the raw moment terms x, x^2, ..., x^N of an event;
+/// - SubsampleMoments: dense accumulation of the raw moments of any order per centrality bin and subsample,
+///   with the conversion of the moments into cumulants.
+
+#ifndef PWGCF_EBYEFLUCTUATIONS_CORE_CUMULANTENGINE_H_
+#define PWGCF_EBYEFLUCTUATIONS_CORE_CUMULANTENGINE_H_
+
+#include <TH2.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace o2::analysis::ebyefluctuations
+{
+
+/// \brief efficiency as a function of pT and eta, frozen into flat arrays
+/// Outside the map the efficiency is zero, as for the under- and overflow bins of the source histogram.
+class EfficiencyTable
+{
+ public:
+  /// \brief copies the map of a histogram with pT on the x axis and eta on the y axis
+  void fromHistogram(const TH2* histogram)
+  {
+    clear();
+    if (histogram == nullptr) {
+      return;
+    }
+    const TAxis* xAxis = histogram->GetXaxis();
+    const TAxis* yAxis = histogram->GetYaxis();
+    for (int ix = 1; ix <= xAxis->GetNbins() + 1; ix++) {
+      mPtEdges.push_back(xAxis->GetBinLowEdge(ix));
+    }
+    for (int iy = 1; iy <= yAxis->GetNbins() + 1; iy++) {
+      mEtaEdges.push_back(yAxis->GetBinLowEdge(iy));
+    }
+    mValues.reserve(xAxis->GetNbins() * yAxis->GetNbins());
+    for (int ix = 1; ix <= xAxis->GetNbins(); ix++) {
+      for (int iy = 1; iy <= yAxis->GetNbins(); iy++) {
+        mValues.push_back(histogram->GetBinContent(ix, iy));
+      }
+    }
+  }
+  /// \brief efficiency depending only on pT, values[i] for pT in [edges[i], edges[i + 1])
+  void fromPtBins(const std::vector<float>& edges, const std::vector<float>& values)
+  {
+    clear();
+    const std::size_t nBins = std::min(edges.size() > 0 ? edges.size() - 1 : 0, values.size());
+    mPtEdges.assign(edges.begin(), edges.begin() + (nBins > 0 ? nBins + 1 : 0));
+    mValues.assign(values.begin(), values.begin() + nBins);
+  }
+  void clear()
+  {
+    mPtEdges.clear();
+    mEtaEdges.clear();
+    mValues.clear();
+  }
+  bool empty() const { return mValues.empty(); }
+
+  float get(float pt, float eta) const
+  {
+    const int ipt = bin(mPtEdges, pt);
+    if (ipt < 0) {
+      return 0.f;
+    }
+    if (mEtaEdges.empty()) {
+      return mValues[ipt];
+    }
+    const int ieta = bin(mEtaEdges, eta);
+    if (ieta < 0) {
+      return 0.f;
+    }
+    return mValues[ipt * (mEtaEdges.size() - 1) + ieta];
+  }
+
+ private:
+  static int bin(const std::vector<float>& edges, float value)
+  {
+    if (edges.size() < 2 || !(value >= edges.front()) || value >= edges.back()) {
+      return -1;
+    }
+    return static_cast<int>(std::upper_bound(edges.begin(), edges.end(), value) - edges.begin()) - 1;
+  }
+
+  std::vector<float> mPtEdges;
+  std::vector<float> mEtaEdges; // empty for an efficiency depending only on pT
+  std::vector<float> mValues;   // pT major
+};
+
+/// \brief adds 1/eff, 1/eff^2, ..., 1/eff^(N-1) to sums[1], ..., sums[N-1]; tracks with zero efficiency are skipped
+template <typename T, std::size_t N>
+void addInverseEfficiencyPowers(std::array<T, N>& sums, float efficiency)
+{
+  if (efficiency == 0.f) {
+    return;
+  }
+  const double inverse = 1.0 / efficiency;
+  double power = inverse;
+  for (std::size_t i = 1; i < N; i++) {
+    sums[i] += power;
+    power *= inverse;
+  }
+}
+
+/// \brief x, x^2, ..., x^N at positions 0, ..., N - 1
+template <std::size_t N>
+std::array<double, N> powers(double x)
+{
+  std::array<double, N> result{};
+  double power = 1.0;
+  for (std::size_t i = 0; i < N; i++) {
+    power *= x;
+    result[i] = power;
+  }
+  return result;
+}
+
+/// \brief dense accumulation of the raw moments <x^k>, k = 1..order, per centrality bin and subsample
+/// The sums of a (centrality bin, subsample) cell are contiguous, so that an event updates a single block.
+class SubsampleMoments
+{
+ public:
+  void init(int nCentralityBins, int nSubsamples, int order)
+  {
+    mNSubsamples = nSubsamples;
+    mOrder = order;
+    mSums.assign(static_cast<std::size_t>(nCentralityBins) * nSubsamples * (order + 1), 0.0);
+  }
+  /// \brief adds an event with the value x and the weight w
+  void fill(int centralityBin, int subsample, double x, double w = 1.0)
+  {
+    double* sums = cell(centralityBin, subsample);
+    sums[0] += w;
+    double power = w;
+    for (int k = 1; k <= mOrder; k++) {
+      power *= x;
+      sums[k] += power;
+    }
+  }
+  double entries(int centralityBin, int subsample) const { return cell(centralityBin, subsample)[0]; }
+  /// \brief <x^k> of a subsample, 0 if the subsample is empty
+  double moment(int centralityBin, int subsample, int k) const
+  {
+    const double* sums = cell(centralityBin, subsample);
+    return sums[0] > 0 ? sums[k] / sums[0] : 0.0;
+  }
+  /// \brief cumulants kappa_1..kappa_order of a subsample from its raw moments
+  std::vector<double> cumulants(int centralityBin, int subsample) const
+  {
+    std::vector<double> mu(mOrder + 1, 0.0);
+    for (int k = 1; k <= mOrder; k++) {
+      mu[k] = moment(centralityBin, subsample, k);
+    }
+    return cumulantsFromMoments(mu);
+  }
+
+  /// \brief cumulants from the raw moments mu[1..n], with the recursion kappa_n = mu_n - sum_{m=1}^{n-1} C(n-1, m-1) kappa_m mu_{n-m}
+  static std::vector<double> cumulantsFromMoments(const std::vector<double>& mu)
+  {
+    const int order = static_cast<int>(mu.size()) - 1;
+    std::vector<double> kappa(order + 1, 0.0);
+    std::vector<double> binomial(order + 1, 0.0); // C(n-1, m-1) for the current n
+    for (int n = 1; n <= order; n++) {
+      // row n-1 of the Pascal triangle, updated in place
+      binomial[n - 1] = 1.0;
+      for (int m = n - 2; m > 0; m--) {
+        binomial[m] += binomial[m - 1];
+      }
+      binomial[0] = 1.0;
+      kappa[n] = mu[n];
+      for (int m = 1; m < n; m++) {
+        kappa[n] -= binomial[m - 1] * kappa[m] * mu[n - m];
+      }
+    }
+    return kappa;
+  }
+
+ private:
+  double* cell(int centralityBin, int subsample) { return mSums.data() + (static_cast<std::size_t>(centralityBin) * mNSubsamples + subsample) * (mOrder + 1); }
+  const double* cell(int centralityBin, int subsample) const { return mSums.data() + (static_cast<std::size_t>(centralityBin) * mNSubsamples + subsample) * (mOrder + 1); }
+
+  int mNSubsamples = 0;
+  int mOrder = 0;
+  std::vector<double> mSums;
+};
+
+} // namespace o2::analysis::ebyefluctuations
+
+#endif // PWGCF_EBYEFLUCTUATIONS_CORE_CUMULANTENGINE_H_
@@ -0,0 +1,136 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file FactorialMomentsEngine.h
+/// \brief Event factorial moments of the track counts in (eta, phi) grids of several granularities
+///
+/// The tracks of an event are kept as a list of (eta, phi). For each granularity M the tracks are counted
+/// into a dense M x M integer array and only the occupied bins are visited, to sum the falling factorials
+/// n(n-1)...(n-q+1) of their counts for all orders q at once, each order from the previous one by a
+/// multiplication. The cost per granularity is then proportional to the number of tracks and not to M^2,
+/// and nothing has to be reset but the occupied bins.
+
+#ifndef PWGCF_EBYEFLUCTUATIONS_CORE_FACTORIALMOMENTSENGINE_H_
+#define PWGCF_EBYEFLUCTUATIONS_CORE_FACTORIALMOMENTSENGINE_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace o2::analysis::ebyefluctuations
+{
+
+class FactorialMomentsEngine
+{
+ public:
+  /// \brief grid of eta x phi with the given granularities (M bins along each axis) and orders q = 2..maxOrder
+  void init(float etaMin, float etaMax, float phiMin, float phiMax, const std::vector<int>& binnings, int maxOrder)
+  {
+    mEtaMin = etaMin;
+    mEtaMax = etaMax;
+    mPhiMin = phiMin;
+    mPhiMax = phiMax;
+    mBinnings = binnings;
+    mMaxOrder = maxOrder;
+    const int maxM = mBinnings.empty() ? 0 : *std::max_element(mBinnings.begin(), mBinnings.end());
+    mCounts.assign(static_cast<std::size_t>(maxM) * maxM, 0);
+    mOccupied.reserve(1024);
+    mMeanBinContent.assign(mBinnings.size(), 0.);
+    mFactorialMoments.assign(mBinnings.size() * (mMaxOrder - 1), 0.);
+    clear();
+  }
+
+  void clear()
+  {
+    mEta.clear();
+    mPhi.clear();
+  }
+  void addTrack(float eta, float phi)
+  {
+    mEta.push_back(eta);
+    mPhi.push_back(phi);
+  }
+  std::size_t nTracks() const { return mEta.size(); }
+
+  /// \brief computes, for each granularity, the mean bin content and the sums over the bins of the falling factorials
+  /// of order q = 2..maxOrder, divided by the number of bins M^2; bins follow the TH2 convention [low, high)
+  void compute()
+  {
+    const std::size_t nTracks = mEta.size();
+    const float etaWidth = mEtaMax - mEtaMin;
+    const float phiWidth = mPhiMax - mPhiMin;
+    std::vector<double> sums(mMaxOrder + 1);
+    for (std::size_t iM = 0; iM < mBinnings.size(); iM++) {
+      const int m = mBinnings[iM];
+      // counting
+      mOccupied.clear();
+      for (std::size_t i = 0; i < nTracks; i++) {
+        const float xEta = m * (mEta[i] - mEtaMin) / etaWidth;
+        const float xPhi = m * (mPhi[i] - mPhiMin) / phiWidth;
+        if (!(xEta >= 0.f) || !(xPhi >= 0.f)) {
+          continue;
+        }
+        const int iEta = static_cast<int>(xEta);
+        const int iPhi = static_cast<int>(xPhi);
+        if (iEta >= m || iPhi >= m) {
+          continue;
+        }
+        const int bin = iEta * m + iPhi;
+        if (mCounts[bin]++ == 0) {
+          mOccupied.push_back(bin);
+        }
+      }
+      // falling factorials of the occupied bins
+      std::fill(sums.begin(), sums.end(), 0.);
+      double content = 0.;
+      for (const int bin : mOccupied) {
+        const double n = mCounts[bin];
+        mCounts[bin] = 0;
+        content += n;
+        double fallingFactorial = n;
+        for (int q = 2; q <= mMaxOrder && n >= q; q++) {
+          fallingFactorial *= n - q + 1;
+          sums[q] += fallingFactorial;
+        }
+      }
+      const double nBins = static_cast<double>(m) * m;
+      mMeanBinContent[iM] = content / nBins;
+      for (int q = 2; q <= mMaxOrder; q++) {
+        mFactorialMoments[iM * (mMaxOrder - 1) + q - 2] = sums[q] / nBins;
+      }
+    }
+  }
+
+  /// \brief mean bin content of the granularity iM
+  double meanBinContent(std::size_t iM) const { return mMeanBinContent[iM]; }
+  /// \brief sum over the bins of n(n-1)...(n-q+1), divided by M^2, for the granularity iM
+  double factorialMoment(int q, std::size_t iM) const { return mFactorialMoments[iM * (mMaxOrder - 1) + q - 2]; }
+
+ private:
+  float mEtaMin = 0.f;
+  float mEtaMax = 1.f;
+  float mPhiMin = 0.f;
+  float mPhiMax = 1.f;
+  std::vector<int> mBinnings;
+  int mMaxOrder = 2;
+
+  std::vector<float> mEta; // tracks of the event
+  std::vector<float> mPhi;
+  std::vector<uint16_t> mCounts;         // dense M x M counts, zero outside compute()
+  std::vector<int> mOccupied;            // occupied bins of the current granularity
+  std::vector<double> mMeanBinContent;   // per granularity
+  std::vector<double> mFactorialMoments; // per granularity, per order
+};
+
+} // namespace o2::analysis::ebyefluctuations
+
+#endif // PWGCF_EBYEFLUCTUATIONS_CORE_FACTORIALMOMENTSENGINE_H_
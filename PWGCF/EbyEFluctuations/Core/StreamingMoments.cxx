@@ -0,0 +1,121 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file StreamingMoments.cxx
+/// \brief Mergeable streaming accumulators of the central moments of event observables
+
+#include "StreamingMoments.h"
+
+#include <TCollection.h>
+#include <Framework/Logger.h>
+
+#include <algorithm>
+
+ClassImp(StreamingMoments);
+
+void StreamingMoments::Configure(const std::vector<std::string>& selections, const std::vector<std::string>& observables, const std::vector<double>& centralityEdges)
+{
+  fSelections = selections;
+  fObservables = observables;
+  fCentralityEdges = centralityEdges;
+  const std::size_t nCells = fSelections.size() * fObservables.size() * GetNCentralityBins();
+  fN.assign(nCells, 0.);
+  fMean.assign(nCells, 0.);
+  fM2.assign(nCells, 0.);
+  fM3.assign(nCells, 0.);
+  fM4.assign(nCells, 0.);
+}
+
+int StreamingMoments::CentralityBin(double centrality) const
+{
+  if (fCentralityEdges.size() < 2 || !(centrality >= fCentralityEdges.front()) || centrality >= fCentralityEdges.back()) {
+    return -1;
+  }
+  return std::upper_bound(fCentralityEdges.begin(), fCentralityEdges.end(), centrality) - fCentralityEdges.begin() - 1;
+}
+
+double StreamingMoments::GetCumulant(int order, int selection, int observable, int centralityBin) const
+{
+  const std::size_t i = Index(selection, observable, centralityBin);
+  const double n = fN[i];
+  if (n <= 0.) {
+    return 0.;
+  }
+  switch (order) {
+    case 1:
+      return fMean[i];
+    case 2:
+      return fM2[i] / n;
+    case 3:
+      return fM3[i] / n;
+    case 4:
+      return fM4[i] / n - 3. * (fM2[i] / n) * (fM2[i] / n);
+    default:
+      LOGF(error, "StreamingMoments: cumulants are available up to the fourth order, not %d", order);
+      return 0.;
+  }
+}
+
+void StreamingMoments::Add(const StreamingMoments& other)
+{
+  for (std::size_t i = 0; i < fN.size(); i++) {
+    const double na = fN[i];
+    const double nb = other.fN[i];
+    if (nb <= 0.) {
+      continue;
+    }
+    if (na <= 0.) {
+      fN[i] = nb;
+      fMean[i] = other.fMean[i];
+      fM2[i] = other.fM2[i];
+      fM3[i] = other.fM3[i];
+      fM4[i] = other.fM4[i];
+      continue;
+    }
+    const double n = na + nb;
+    const double delta = other.fMean[i] - fMean[i];
+    const double delta2 = delta * delta;
+    const double m2a = fM2[i];
+    const double m2b = other.fM2[i];
+    const double m3a = fM3[i];
+    const double m3b = other.fM3[i];
+    fM4[i] += other.fM4[i] + delta2 * delta2 * na * nb * (na * na - na * nb + nb * nb) / (n * n * n) + 6. * delta2 * (na * na * m2b + nb * nb * m2a) / (n * n) + 4. * delta * (na * m3b - nb * m3a) / n;
+    fM3[i] += m3b + delta2 * delta * na * nb * (na - nb) / (n * n) + 3. * delta * (na * m2b - nb * m2a) / n;
+    fM2[i] += m2b + delta2 * na * nb / n;
+    fMean[i] += delta * nb / n;
+    fN[i] = n;
+  }
+}
+
+Long64_t StreamingMoments::Merge(TCollection* list)
+{
+  if (!list) {
+    return 0;
+  }
+  if (list->IsEmpty()) {
+    return 1;
+  }
+  Long64_t count = 0;
+  TIter next(list);
+  while (TObject* obj = next()) {
+    auto* entry = dynamic_cast<StreamingMoments*>(obj);
+    if (entry == nullptr) {
+      continue;
+    }
+    if (entry->fSelections != fSelections || entry->fObservables != fObservables || entry->fCentralityEdges != fCentralityEdges) {
+      LOGF(error, "StreamingMoments: cannot merge %s, its cells differ", entry->GetName());
+      continue;
+    }
+    Add(*entry);
+    count++;
+  }
+  return count + 1;
+}
@@ -0,0 +1,95 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file StreamingMoments.h
+/// \brief Mergeable streaming accumulators of the central moments of event observables
+///
+/// For each (selection, observable, centrality bin) the number of entries, the mean and the sums of the
+/// second, third and fourth powers of the deviations from the mean are updated at each fill (Welford,
+/// with the higher order updates of Pebay), which is numerically stable, and merged exactly with the
+/// pairwise combination formulas. The cumulants up to the fourth order follow from them without
+/// filling a histogram of the observable per cell.
+
+#ifndef PWGCF_EBYEFLUCTUATIONS_CORE_STREAMINGMOMENTS_H_
+#define PWGCF_EBYEFLUCTUATIONS_CORE_STREAMINGMOMENTS_H_
+
+#include <TNamed.h>
+
+#include <string>
+#include <vector>
+
+class TCollection;
+
+class StreamingMoments : public TNamed
+{
+ public:
+  StreamingMoments() = default;
+  StreamingMoments(const char* name, const char* title) : TNamed(name, title) {}
+  ~StreamingMoments() override = default;
+
+  /// \brief defines the cells: the selections, the observables and the edges of the centrality bins
+  void Configure(const std::vector<std::string>& selections, const std::vector<std::string>& observables, const std::vector<double>& centralityEdges);
+
+  /// \brief centrality bin of the value, -1 if outside the edges
+  int CentralityBin(double centrality) const;
+
+  void Fill(int selection, int observable, int centralityBin, double x)
+  {
+    const std::size_t i = Index(selection, observable, centralityBin);
+    const double n1 = fN[i];
+    const double n = n1 + 1.;
+    const double delta = x - fMean[i];
+    const double deltaN = delta / n;
+    const double deltaN2 = deltaN * deltaN;
+    const double term1 = delta * deltaN * n1;
+    fN[i] = n;
+    fMean[i] += deltaN;
+    fM4[i] += term1 * deltaN2 * (n * n - 3. * n + 3.) + 6. * deltaN2 * fM2[i] - 4. * deltaN * fM3[i];
+    fM3[i] += term1 * deltaN * (n - 2.) - 3. * deltaN * fM2[i];
+    fM2[i] += term1;
+  }
+
+  double GetEntries(int selection, int observable, int centralityBin) const { return fN[Index(selection, observable, centralityBin)]; }
+  double GetMean(int selection, int observable, int centralityBin) const { return fMean[Index(selection, observable, centralityBin)]; }
+  /// \brief cumulant of order 1 to 4 (population estimates), 0 for an empty cell
+  double GetCumulant(int order, int selection, int observable, int centralityBin) const;
+
+  int GetNSelections() const { return fSelections.size(); }
+  int GetNObservables() const { return fObservables.size(); }
+  int GetNCentralityBins() const { return fCentralityEdges.empty() ? 0 : fCentralityEdges.size() - 1; }
+  const std::vector<std::string>& GetSelections() const { return fSelections; }
+  const std::vector<std::string>& GetObservables() const { return fObservables; }
+
+  Long64_t Merge(TCollection* list);
+
+ private:
+  std::size_t Index(int selection, int observable, int centralityBin) const
+  {
+    return (static_cast<std::size_t>(selection) * fObservables.size() + observable) * GetNCentralityBins() + centralityBin;
+  }
+  /// \brief adds the accumulators of another object with the same cells
+  void Add(const StreamingMoments& other);
+
+  std::vector<std::string> fSelections;
+  std::vector<std::string> fObservables;
+  std::vector<double> fCentralityEdges;
+
+  // per cell
+  std::vector<double> fN;
+  std::vector<double> fMean;
+  std::vector<double> fM2; // sums of the powers of the deviations from the mean
+  std::vector<double> fM3;
+  std::vector<double> fM4;
+
+  ClassDefOverride(StreamingMoments, 1);
+};
+
+#endif // PWGCF_EBYEFLUCTUATIONS_CORE_STREAMINGMOMENTS_H_
@@ -29,6 +29,7 @@
 #include "ReconstructionDataFormats/GlobalTrackID.h"
 #include "ReconstructionDataFormats/Track.h"
 #include "Framework/ASoAHelpers.h"
+#include "PWGCF/EbyEFluctuations/Core/FactorialMomentsEngine.h"
 using std::array;
 using namespace o2;
 using namespace o2::framework;
@@ -98,7 +99,8 @@ struct FactorialMoments {
   array<Int_t, 5> countTracks{0, 0, 0, 0, 0};
   array<array<array<Double_t, nBins>, 5>, 6> fqEvent;
   array<array<Double_t, nBins>, 5> binConEvent;
-  std::vector<std::shared_ptr<TH2>> mHistArrReset;
+  // per pT bin, counts the tracks in the (eta, phi) grids of all binnings M
+  std::vector<o2::analysis::ebyefluctuations::FactorialMomentsEngine> mEngines;
   std::vector<std::shared_ptr<TH1>> mHistArrQA;
   std::vector<std::shared_ptr<TH1>> mFqBinFinal;
   std::vector<std::shared_ptr<TH1>> mBinConFinal;
@@ -123,10 +125,7 @@ struct FactorialMoments {
       mHistArrQA.push_back(std::get<std::shared_ptr<TH1>>(histos.add(Form("bin%i/mPt", iPt + 1), Form("pT for bin %.2f-%.2f;pT", confPtBins.value[2 * iPt], confPtBins.value[2 * iPt + 1]), HistType::kTH1F, {axisPt[iPt]})));
       mHistArrQA.push_back(std::get<std::shared_ptr<TH1>>(histos.add(Form("bin%i/mPhi", iPt + 1), Form("#phi for bin %.2f-%.2f;#phi", confPtBins.value[2 * iPt], confPtBins.value[2 * iPt + 1]), HistType::kTH1F, {{1000, 0, 2 * TMath::Pi()}})));
       mHistArrQA.push_back(std::get<std::shared_ptr<TH1>>(histos.add(Form("bin%i/mMultiplicity", iPt + 1), Form("Multiplicity for bin %.2f-%.2f;Multiplicity", confPtBins.value[2 * iPt], confPtBins.value[2 * iPt + 1]), HistType::kTH1F, {{1000, 0, 8000}})));
-      for (auto iM = 0; iM < nBins; ++iM) {
-        auto mHistsR = std::get<std::shared_ptr<TH2>>(histos.add(Form("bin%i/Reset/mEtaPhi%i", iPt + 1, iM), Form("#eta#phi_%i for bin %.2f-%.2f;#eta;#phi", iM, confPtBins.value[2 * iPt], confPtBins.value[2 * iPt + 1]), HistType::kTH2F, {{binningM[iM], -0.8, 0.8}, {binningM[iM], 0, 2 * TMath::Pi()}}));
-        mHistArrReset.push_back(mHistsR);
-      }
+      mEngines.emplace_back().init(-0.8, 0.8, 0, 2 * TMath::Pi(), std::vector<int>(binningM.begin(), binningM.end()), 7);
       for (auto i = 0; i < 6; ++i) {
         auto mHistFq = std::get<std::shared_ptr<TH1>>(histos.add(Form("mFinalFq%i_bin%i", i + 2, iPt + 1), Form("Final F_%i for bin %.2f-%.2f;M", i + 2, confPtBins.value[2 * iPt], confPtBins.value[2 * iPt + 1]), HistType::kTH1F, {{nBins, -0.5, nBins - 0.5}}));
         mFqBinFinal.push_back(mHistFq);
@@ -151,43 +150,20 @@ struct FactorialMoments {
         mHistArrQA[iPt * 4 + 1]->Fill(track.pt());
         mHistArrQA[iPt * 4 + 2]->Fill(iphi);
         countTracks[iPt]++;
-        for (auto iM = 0; iM < nBins; ++iM) {
-          mHistArrReset[iPt * nBins + iM]->Fill(track.eta(), track.phi());
-        }
+        mEngines[iPt].addTrack(track.eta(), track.phi());
       }
     }
   }
-  void calculateMoments(std::vector<std::shared_ptr<TH2>> hist)
+  void calculateMoments()
   {
-    Double_t binContent = 0;
     // Calculate the normalized factorial moments
     for (auto iPt = 0; iPt < confNumPt; ++iPt) {
+      auto& engine = mEngines[iPt];
+      engine.compute();
       for (auto iM = 0; iM < nBins; ++iM) {
-        binContent = 0;
-        Double_t sumfqBin[6] = {0};
-
-        for (auto iEta = 1; iEta <= hist[iPt * nBins + iM]->GetNbinsX(); ++iEta) {
-          for (auto iPhi = 1; iPhi <= hist[iPt * nBins + iM]->GetNbinsY(); ++iPhi) {
-            double binconVal = 0;
-            binconVal = hist[iPt * nBins + iM]->GetBinContent(iEta, iPhi);
-            binContent += binconVal;
-            for (auto iOrder = 0; iOrder < 6; ++iOrder) {
-              Double_t fqBin = 0;
-              if (binconVal >= iOrder + 2) {
-                fqBin = TMath::Factorial(binconVal) / (TMath::Factorial(binconVal - (iOrder + 2)));
-              }
-              if (std::isnan(fqBin)) {
-                break;
-              }
-              sumfqBin[iOrder] += fqBin;
-            }
-          }
-        }
-        binConEvent[iPt][iM] = binContent / (TMath::Power(binningM[iM], 2));
+        binConEvent[iPt][iM] = engine.meanBinContent(iM);
         for (auto iOrder = 0; iOrder < 6; ++iOrder) {
-          if (sumfqBin[iOrder] > 0) {
-            fqEvent[iOrder][iPt][iM] = sumfqBin[iOrder] / (TMath::Power(binningM[iM], 2));
-          }
+          fqEvent[iOrder][iPt][iM] = engine.factorialMoment(iOrder + 2, iM);
           mFqBinFinal[iPt * 6 + iOrder]->Fill(iM, fqEvent[iOrder][iPt][iM]);
           mBinConFinal[iPt * 6 + iOrder]->Fill(iM, binConEvent[iPt][iM]);
         }
@@ -221,8 +197,8 @@ struct FactorialMoments {
     histos.fill(HIST("mCentFV0A"), coll.centFV0A());
     histos.fill(HIST("mCentFT0A"), coll.centFT0A());
     histos.fill(HIST("mCentFT0C"), coll.centFT0C());
-    for (auto const& h : mHistArrReset) {
-      h->Reset();
+    for (auto& engine : mEngines) {
+      engine.clear();
     }
     countTracks = {0, 0, 0, 0, 0};
     fqEvent = {{{{{0, 0, 0, 0, 0, 0}}}}};
@@ -259,7 +235,7 @@ struct FactorialMoments {
       }
     }
     // Calculate the normalized factorial moments
-    calculateMoments(mHistArrReset);
+    calculateMoments();
   }
   PROCESS_SWITCH(FactorialMoments, processRun3, "main process function", true);
 
@@ -276,8 +252,8 @@ struct FactorialMoments {
     histos.fill(HIST("mVertexZ"), coll.posZ());
     histos.fill(HIST("mCentFT0M"), coll.centRun2V0M());
 
-    for (auto const& h : mHistArrReset) {
-      h->Reset();
+    for (auto& engine : mEngines) {
+      engine.clear();
     }
 
     countTracks = {0, 0, 0, 0, 0};
@@ -318,7 +294,7 @@ struct FactorialMoments {
       }
     }
     // Calculate the normalized factorial moments
-    calculateMoments(mHistArrReset);
+    calculateMoments();
   }
   PROCESS_SWITCH(FactorialMoments, processRun2, "for RUN2", false);
 };
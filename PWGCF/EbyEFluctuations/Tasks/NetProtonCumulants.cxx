@@ -23,6 +23,7 @@
 #include "Common/DataModel/TrackSelectionTables.h"
 #include "Common/DataModel/Centrality.h"
 #include "Common/DataModel/PIDResponse.h"
+#include "PWGCF/EbyEFluctuations/Core/CumulantEngine.h"
 
 #include "TList.h"
 #include "TProfile.h"
@@ -245,45 +246,48 @@ struct NetProtonCumulants_analysis {
   {
     // LOGF(info, "Centrality= %f Nch= %f net-proton no. = %f", event_netproton.centrality(), event_netproton.n_ch(), event_netproton.net_prot_no());
 
+    // powers of the net-proton number, mu[k - 1] = N^k
+    const auto mu = o2::analysis::ebyefluctuations::powers<8>(event_netproton.net_prot_no());
+
     // filling profiles for central values
-    registry.get<TProfile2D>(HIST("Prof2D_mu1_netproton"))->Fill(event_netproton.centrality(), event_netproton.n_ch(), pow(event_netproton.net_prot_no(), 1.0));
-    registry.get<TProfile2D>(HIST("Prof2D_mu2_netproton"))->Fill(event_netproton.centrality(), event_netproton.n_ch(), pow(event_netproton.net_prot_no(), 2.0));
-    registry.get<TProfile2D>(HIST("Prof2D_mu3_netproton"))->Fill(event_netproton.centrality(), event_netproton.n_ch(), pow(event_netproton.net_prot_no(), 3.0));
-    registry.get<TProfile2D>(HIST("Prof2D_mu4_netproton"))->Fill(event_netproton.centrality(), event_netproton.n_ch(), pow(event_netproton.net_prot_no(), 4.0));
-    registry.get<TProfile2D>(HIST("Prof2D_mu5_netproton"))->Fill(event_netproton.centrality(), event_netproton.n_ch(), pow(event_netproton.net_prot_no(), 5.0));
-    registry.get<TProfile2D>(HIST("Prof2D_mu6_netproton"))->Fill(event_netproton.centrality(), event_netproton.n_ch(), pow(event_netproton.net_prot_no(), 6.0));
-    registry.get<TProfile2D>(HIST("Prof2D_mu7_netproton"))->Fill(event_netproton.centrality(), event_netproton.n_ch(), pow(event_netproton.net_prot_no(), 7.0));
-    registry.get<TProfile2D>(HIST("Prof2D_mu8_netproton"))->Fill(event_netproton.centrality(), event_netproton.n_ch(), pow(event_netproton.net_prot_no(), 8.0));
-
-    registry.get<TProfile>(HIST("Prof_mu1_netproton"))->Fill(event_netproton.centrality(), pow(event_netproton.net_prot_no(), 1.0));
-    registry.get<TProfile>(HIST("Prof_mu2_netproton"))->Fill(event_netproton.centrality(), pow(event_netproton.net_prot_no(), 2.0));
-    registry.get<TProfile>(HIST("Prof_mu3_netproton"))->Fill(event_netproton.centrality(), pow(event_netproton.net_prot_no(), 3.0));
-    registry.get<TProfile>(HIST("Prof_mu4_netproton"))->Fill(event_netproton.centrality(), pow(event_netproton.net_prot_no(), 4.0));
-    registry.get<TProfile>(HIST("Prof_mu5_netproton"))->Fill(event_netproton.centrality(), pow(event_netproton.net_prot_no(), 5.0));
-    registry.get<TProfile>(HIST("Prof_mu6_netproton"))->Fill(event_netproton.centrality(), pow(event_netproton.net_prot_no(), 6.0));
-    registry.get<TProfile>(HIST("Prof_mu7_netproton"))->Fill(event_netproton.centrality(), pow(event_netproton.net_prot_no(), 7.0));
-    registry.get<TProfile>(HIST("Prof_mu8_netproton"))->Fill(event_netproton.centrality(), pow(event_netproton.net_prot_no(), 8.0));
+    registry.get<TProfile2D>(HIST("Prof2D_mu1_netproton"))->Fill(event_netproton.centrality(), event_netproton.n_ch(), mu[0]);
+    registry.get<TProfile2D>(HIST("Prof2D_mu2_netproton"))->Fill(event_netproton.centrality(), event_netproton.n_ch(), mu[1]);
+    registry.get<TProfile2D>(HIST("Prof2D_mu3_netproton"))->Fill(event_netproton.centrality(), event_netproton.n_ch(), mu[2]);
+    registry.get<TProfile2D>(HIST("Prof2D_mu4_netproton"))->Fill(event_netproton.centrality(), event_netproton.n_ch(), mu[3]);
+    registry.get<TProfile2D>(HIST("Prof2D_mu5_netproton"))->Fill(event_netproton.centrality(), event_netproton.n_ch(), mu[4]);
+    registry.get<TProfile2D>(HIST("Prof2D_mu6_netproton"))->Fill(event_netproton.centrality(), event_netproton.n_ch(), mu[5]);
+    registry.get<TProfile2D>(HIST("Prof2D_mu7_netproton"))->Fill(event_netproton.centrality(), event_netproton.n_ch(), mu[6]);
+    registry.get<TProfile2D>(HIST("Prof2D_mu8_netproton"))->Fill(event_netproton.centrality(), event_netproton.n_ch(), mu[7]);
+
+    registry.get<TProfile>(HIST("Prof_mu1_netproton"))->Fill(event_netproton.centrality(), mu[0]);
+    registry.get<TProfile>(HIST("Prof_mu2_netproton"))->Fill(event_netproton.centrality(), mu[1]);
+    registry.get<TProfile>(HIST("Prof_mu3_netproton"))->Fill(event_netproton.centrality(), mu[2]);
+    registry.get<TProfile>(HIST("Prof_mu4_netproton"))->Fill(event_netproton.centrality(), mu[3]);
+    registry.get<TProfile>(HIST("Prof_mu5_netproton"))->Fill(event_netproton.centrality(), mu[4]);
+    registry.get<TProfile>(HIST("Prof_mu6_netproton"))->Fill(event_netproton.centrality(), mu[5]);
+    registry.get<TProfile>(HIST("Prof_mu7_netproton"))->Fill(event_netproton.centrality(), mu[6]);
+    registry.get<TProfile>(HIST("Prof_mu8_netproton"))->Fill(event_netproton.centrality(), mu[7]);
 
     // selecting subsample and filling profiles
     float l_Random = fRndm->Rndm();
     int SampleIndex = static_cast<int>(cfgNSubsample * l_Random);
-    Subsample2D[SampleIndex][0]->Fill(event_netproton.centrality(), event_netproton.n_ch(), pow(event_netproton.net_prot_no(), 1.0));
-    Subsample2D[SampleIndex][1]->Fill(event_netproton.centrality(), event_netproton.n_ch(), pow(event_netproton.net_prot_no(), 2.0));
-    Subsample2D[SampleIndex][2]->Fill(event_netproton.centrality(), event_netproton.n_ch(), pow(event_netproton.net_prot_no(), 3.0));
-    Subsample2D[SampleIndex][3]->Fill(event_netproton.centrality(), event_netproton.n_ch(), pow(event_netproton.net_prot_no(), 4.0));
-    Subsample2D[SampleIndex][4]->Fill(event_netproton.centrality(), event_netproton.n_ch(), pow(event_netproton.net_prot_no(), 5.0));
-    Subsample2D[SampleIndex][5]->Fill(event_netproton.centrality(), event_netproton.n_ch(), pow(event_netproton.net_prot_no(), 6.0));
-    Subsample2D[SampleIndex][6]->Fill(event_netproton.centrality(), event_netproton.n_ch(), pow(event_netproton.net_prot_no(), 7.0));
-    Subsample2D[SampleIndex][7]->Fill(event_netproton.centrality(), event_netproton.n_ch(), pow(event_netproton.net_prot_no(), 8.0));
-
-    Subsample[SampleIndex][0]->Fill(event_netproton.centrality(), pow(event_netproton.net_prot_no(), 1.0));
-    Subsample[SampleIndex][1]->Fill(event_netproton.centrality(), pow(event_netproton.net_prot_no(), 2.0));
-    Subsample[SampleIndex][2]->Fill(event_netproton.centrality(), pow(event_netproton.net_prot_no(), 3.0));
-    Subsample[SampleIndex][3]->Fill(event_netproton.centrality(), pow(event_netproton.net_prot_no(), 4.0));
-    Subsample[SampleIndex][4]->Fill(event_netproton.centrality(), pow(event_netproton.net_prot_no(), 5.0));
-    Subsample[SampleIndex][5]->Fill(event_netproton.centrality(), pow(event_netproton.net_prot_no(), 6.0));
-    Subsample[SampleIndex][6]->Fill(event_netproton.centrality(), pow(event_netproton.net_prot_no(), 7.0));
-    Subsample[SampleIndex][7]->Fill(event_netproton.centrality(), pow(event_netproton.net_prot_no(), 8.0));
+    Subsample2D[SampleIndex][0]->Fill(event_netproton.centrality(), event_netproton.n_ch(), mu[0]);
+    Subsample2D[SampleIndex][1]->Fill(event_netproton.centrality(), event_netproton.n_ch(), mu[1]);
+    Subsample2D[SampleIndex][2]->Fill(event_netproton.centrality(), event_netproton.n_ch(), mu[2]);
+    Subsample2D[SampleIndex][3]->Fill(event_netproton.centrality(), event_netproton.n_ch(), mu[3]);
+    Subsample2D[SampleIndex][4]->Fill(event_netproton.centrality(), event_netproton.n_ch(), mu[4]);
+    Subsample2D[SampleIndex][5]->Fill(event_netproton.centrality(), event_netproton.n_ch(), mu[5]);
+    Subsample2D[SampleIndex][6]->Fill(event_netproton.centrality(), event_netproton.n_ch(), mu[6]);
+    Subsample2D[SampleIndex][7]->Fill(event_netproton.centrality(), event_netproton.n_ch(), mu[7]);
+
+    Subsample[SampleIndex][0]->Fill(event_netproton.centrality(), mu[0]);
+    Subsample[SampleIndex][1]->Fill(event_netproton.centrality(), mu[1]);
+    Subsample[SampleIndex][2]->Fill(event_netproton.centrality(), mu[2]);
+    Subsample[SampleIndex][3]->Fill(event_netproton.centrality(), mu[3]);
+    Subsample[SampleIndex][4]->Fill(event_netproton.centrality(), mu[4]);
+    Subsample[SampleIndex][5]->Fill(event_netproton.centrality(), mu[5]);
+    Subsample[SampleIndex][6]->Fill(event_netproton.centrality(), mu[6]);
+    Subsample[SampleIndex][7]->Fill(event_netproton.centrality(), mu[7]);
   }
 };
 
@@ -41,6 +41,7 @@
 #include "DataFormatsFT0/Digit.h"
 
 #include "PWGLF/DataModel/LFStrangenessTables.h"
+#include "PWGCF/EbyEFluctuations/Core/StreamingMoments.h"
 
 using namespace std;
 using namespace o2;
@@ -184,6 +185,17 @@ struct RobustFluctuationObservables {
   vector<vector<std::shared_ptr<TH1>>> pHist1D;
   vector<vector<std::shared_ptr<TH2>>> pHist2D;
 
+  // moments of the event multiplicities for the various cuts, per centrality bin
+  Configurable<int> flagIncludeMultMoments{"flagIncludeMultMoments", 1, "flagIncludeMultMoments: 0 - no, 1 - yes"};
+  Configurable<std::vector<double>> vMultMomentsCentBins{"multMomentsCentBins", {0., 5., 10., 20., 30., 40., 50., 60., 70., 80., 90., 100.}, "centrality bin edges of the multiplicity moments"};
+  OutputObj<StreamingMoments> multMoments{"multMoments"};
+  enum MultMomentsObservables { kMultTrk = 0,
+                                kMultGlobalTr,
+                                kMultTrkPV,
+                                kMultT0A,
+                                kMultT0C,
+                                kMultV0A };
+
   // QA for pt vs various cuts
   map<string, int> mPtStudyCuts;
   vector<std::shared_ptr<TH1>> pHistPtStudy1D;
@@ -609,6 +621,11 @@ struct RobustFluctuationObservables {
       pHist2D.push_back(v2D);
     }
 
+    if (flagIncludeMultMoments) {
+      multMoments.setObject(new StreamingMoments("multMoments", "moments of the multiplicities vs cuts and centrality"));
+      multMoments->Configure(vector<string>(strCutNames, strCutNames + nCutsQA), {"multAllTr", "multGlobalTr", "multTrkPV", "multT0A", "multT0C", "multV0A"}, vMultMomentsCentBins.value);
+    }
+
     AxisSpec axisCounterAllVsTF{10, -0.5, 9.5, "cut"};
     histosEventCounters.add("hNtracksAll_vs_variousCuts", "hNtracksAll_vs_variousCuts", kTH1D, {axisCounterAllVsTF});
     histosEventCounters.add("hNtracksGlobal_vs_variousCuts", "hNtracksGlobal_vs_variousCuts", kTH1D, {axisCounterAllVsTF});
@@ -2297,7 +2314,7 @@ struct RobustFluctuationObservables {
   }     // end of processRobustFluctuationObservables()
 
   // shortcut function to fill 2D histograms
-  void fillHistForThisCut(string cutName, int multNTracksPV, int multTrk, int nTracksGlobalAccepted, double multT0A, double multT0C, double multV0A, double /*t0cCentr*/, int bc)
+  void fillHistForThisCut(string cutName, int multNTracksPV, int multTrk, int nTracksGlobalAccepted, double multT0A, double multT0C, double multV0A, double t0cCentr, int bc)
   {
     // registry.get<TH1>(HIST("eta"))->Fill(track.eta());
     // arrPointers[histId][cutId]->Fill(xval, yval, weight);
@@ -2327,6 +2344,18 @@ struct RobustFluctuationObservables {
     FILL_QA_HIST_2D(cutId, "multT0C_vs_multT0A", multT0A, multT0C);
     FILL_QA_HIST_2D(cutId, "multV0A_vs_multT0A", multT0A, multV0A);
     FILL_QA_HIST_2D(cutId, "multV0A_vs_multT0C", multT0C, multV0A);
+
+    if (flagIncludeMultMoments) {
+      int centBin = multMoments->CentralityBin(t0cCentr);
+      if (centBin >= 0) {
+        multMoments->Fill(cutId, kMultTrk, centBin, multTrk);
+        multMoments->Fill(cutId, kMultGlobalTr, centBin, nTracksGlobalAccepted);
+        multMoments->Fill(cutId, kMultTrkPV, centBin, multNTracksPV);
+        multMoments->Fill(cutId, kMultT0A, centBin, multT0A);
+        multMoments->Fill(cutId, kMultT0C, centBin, multT0C);
+        multMoments->Fill(cutId, kMultV0A, centBin, multV0A);
+      }
+    }
     // if (flagPbPb) {
     //   FILL_QA_HIST_2D(cutId, "multAllTr_vs_Cent", t0cCentr, multTrk);
     //   FILL_QA_HIST_2D(cutId, "multGlobalTr_vs_Cent", t0cCentr, nTracksGlobalAccepted);
@@ -35,6 +35,7 @@
 #include "Common/DataModel/PIDResponseITS.h"
 #include "Common/DataModel/Multiplicity.h"
 #include "Common/Core/trackUtilities.h"
+#include "PWGCF/EbyEFluctuations/Core/CumulantEngine.h"
 #include "CommonConstants/PhysicsConstants.h"
 #include "Framework/O2DatabasePDGPlugin.h"
 #include "DataFormatsParameters/GRPObject.h"
@@ -114,6 +115,9 @@ struct NetprotonCumulantsMc {
   // Eff histograms 2d: eff(pT, eta)
   TH2F* hRatio2DEtaVsPtProton = nullptr;
   TH2F* hRatio2DEtaVsPtAntiproton = nullptr;
+  // the same efficiencies (or the ones of the pT bins), frozen for the per track lookup
+  o2::analysis::ebyefluctuations::EfficiencyTable effProton;
+  o2::analysis::ebyefluctuations::EfficiencyTable effAntiproton;
 
   // Filter command for rec (data)***********
   Filter collisionFilter = nabs(aod::collision::posZ) < cfgCutVertex;
@@ -149,6 +153,11 @@ struct NetprotonCumulantsMc {
       hRatio2DEtaVsPtAntiproton = reinterpret_cast<TH2F*>(lst->FindObject("hRatio2DEtaVsPtAntiproton"));
       if (!hRatio2DEtaVsPtProton || !hRatio2DEtaVsPtAntiproton)
         LOGF(info, "FATAL!! could not get efficiency---------> check");
+      effProton.fromHistogram(hRatio2DEtaVsPtProton);
+      effAntiproton.fromHistogram(hRatio2DEtaVsPtAntiproton);
+    } else {
+      effProton.fromPtBins(cfgPtBins.value, cfgProtonEff.value);
+      effAntiproton.fromPtBins(cfgPtBins.value, cfgAntiprotonEff.value);
     }
 
     // Define your axes
@@ -902,37 +911,13 @@ struct NetprotonCumulantsMc {
   template <typename T>
   float getEfficiency(const T& candidate)
   {
-    // Load eff from histograms in CCDB
-    if (cfgLoadEff) {
-      if (candidate.sign() > 0) {
-        float effmeanval = hRatio2DEtaVsPtProton->GetBinContent(hRatio2DEtaVsPtProton->FindBin(candidate.pt(), candidate.eta()));
-        return effmeanval;
-      }
-      if (candidate.sign() < 0) {
-        float effmeanval = hRatio2DEtaVsPtAntiproton->GetBinContent(hRatio2DEtaVsPtAntiproton->FindBin(candidate.pt(), candidate.eta()));
-        return effmeanval;
-      }
-      return 0.0;
-    } else {
-      // Find the pt bin index based on the track's pt value
-      int binIndex = -1;
-
-      for (int i = 0; i < 16; ++i) {
-        if (candidate.pt() >= cfgPtBins.value[i] && candidate.pt() < cfgPtBins.value[i + 1]) {
-          binIndex = i;
-          break;
-        }
-      }
-      // If the pt is outside the defined bins, return a default efficiency or handle it differently
-      if (binIndex == -1) {
-        return 0.0; // Default efficiency (0% if outside bins)
-      }
-      if (candidate.sign() > 0)
-        return cfgProtonEff.value[binIndex];
-      if (candidate.sign() < 0)
-        return cfgAntiprotonEff.value[binIndex];
-      return 0.0;
+    if (candidate.sign() > 0) {
+      return effProton.get(candidate.pt(), candidate.eta());
     }
+    if (candidate.sign() < 0) {
+      return effAntiproton.get(candidate.pt(), candidate.eta());
+    }
+    return 0.0;
   }
 
   void processMCGen(aod::McCollision const& mcCollision, aod::McParticles const& mcParticles, const soa::SmallGroups<EventCandidatesMC>& collisions)
@@ -1024,6 +1009,7 @@ struct NetprotonCumulantsMc {
     } //! end particle loop
 
     float netProt = nProt - nAntiprot;
+    const auto netProtPowers = o2::analysis::ebyefluctuations::powers<8>(netProt); // netProtPowers[k - 1] = netProt^k
     histos.fill(HIST("hgenNetProtonVsCentrality"), netProt, cent);
     histos.fill(HIST("hgenProtonVsCentrality"), nProt, cent);
     histos.fill(HIST("hgenAntiprotonVsCentrality"), nAntiprot, cent);
@@ -1035,14 +1021,14 @@ struct NetprotonCumulantsMc {
     //-------------------------------------------------------------------------------------------
 
     if (cfgIsCalculateCentral) {
-      histos.get<TProfile>(HIST("GenProf_mu1_netproton"))->Fill(cent, std::pow(netProt, 1.0));
-      histos.get<TProfile>(HIST("GenProf_mu2_netproton"))->Fill(cent, std::pow(netProt, 2.0));
-      histos.get<TProfile>(HIST("GenProf_mu3_netproton"))->Fill(cent, std::pow(netProt, 3.0));
-      histos.get<TProfile>(HIST("GenProf_mu4_netproton"))->Fill(cent, std::pow(netProt, 4.0));
-      histos.get<TProfile>(HIST("GenProf_mu5_netproton"))->Fill(cent, std::pow(netProt, 5.0));
-      histos.get<TProfile>(HIST("GenProf_mu6_netproton"))->Fill(cent, std::pow(netProt, 6.0));
-      histos.get<TProfile>(HIST("GenProf_mu7_netproton"))->Fill(cent, std::pow(netProt, 7.0));
-      histos.get<TProfile>(HIST("GenProf_mu8_netproton"))->Fill(cent, std::pow(netProt, 8.0));
+      histos.get<TProfile>(HIST("GenProf_mu1_netproton"))->Fill(cent, netProtPowers[0]);
+      histos.get<TProfile>(HIST("GenProf_mu2_netproton"))->Fill(cent, netProtPowers[1]);
+      histos.get<TProfile>(HIST("GenProf_mu3_netproton"))->Fill(cent, netProtPowers[2]);
+      histos.get<TProfile>(HIST("GenProf_mu4_netproton"))->Fill(cent, netProtPowers[3]);
+      histos.get<TProfile>(HIST("GenProf_mu5_netproton"))->Fill(cent, netProtPowers[4]);
+      histos.get<TProfile>(HIST("GenProf_mu6_netproton"))->Fill(cent, netProtPowers[5]);
+      histos.get<TProfile>(HIST("GenProf_mu7_netproton"))->Fill(cent, netProtPowers[6]);
+      histos.get<TProfile>(HIST("GenProf_mu8_netproton"))->Fill(cent, netProtPowers[7]);
     }
 
     if (cfgIsCalculateError) {
@@ -1050,14 +1036,14 @@ struct NetprotonCumulantsMc {
       float lRandom = fRndm->Rndm();
       int sampleIndex = static_cast<int>(cfgNSubsample * lRandom);
 
-      histos.get<TProfile2D>(HIST("GenProf2D_mu1_netproton"))->Fill(cent, sampleIndex, std::pow(netProt, 1.0));
-      histos.get<TProfile2D>(HIST("GenProf2D_mu2_netproton"))->Fill(cent, sampleIndex, std::pow(netProt, 2.0));
-      histos.get<TProfile2D>(HIST("GenProf2D_mu3_netproton"))->Fill(cent, sampleIndex, std::pow(netProt, 3.0));
-      histos.get<TProfile2D>(HIST("GenProf2D_mu4_netproton"))->Fill(cent, sampleIndex, std::pow(netProt, 4.0));
-      histos.get<TProfile2D>(HIST("GenProf2D_mu5_netproton"))->Fill(cent, sampleIndex, std::pow(netProt, 5.0));
-      histos.get<TProfile2D>(HIST("GenProf2D_mu6_netproton"))->Fill(cent, sampleIndex, std::pow(netProt, 6.0));
-      histos.get<TProfile2D>(HIST("GenProf2D_mu7_netproton"))->Fill(cent, sampleIndex, std::pow(netProt, 7.0));
-      histos.get<TProfile2D>(HIST("GenProf2D_mu8_netproton"))->Fill(cent, sampleIndex, std::pow(netProt, 8.0));
+      histos.get<TProfile2D>(HIST("GenProf2D_mu1_netproton"))->Fill(cent, sampleIndex, netProtPowers[0]);
+      histos.get<TProfile2D>(HIST("GenProf2D_mu2_netproton"))->Fill(cent, sampleIndex, netProtPowers[1]);
+      histos.get<TProfile2D>(HIST("GenProf2D_mu3_netproton"))->Fill(cent, sampleIndex, netProtPowers[2]);
+      histos.get<TProfile2D>(HIST("GenProf2D_mu4_netproton"))->Fill(cent, sampleIndex, netProtPowers[3]);
+      histos.get<TProfile2D>(HIST("GenProf2D_mu5_netproton"))->Fill(cent, sampleIndex, netProtPowers[4]);
+      histos.get<TProfile2D>(HIST("GenProf2D_mu6_netproton"))->Fill(cent, sampleIndex, netProtPowers[5]);
+      histos.get<TProfile2D>(HIST("GenProf2D_mu7_netproton"))->Fill(cent, sampleIndex, netProtPowers[6]);
+      histos.get<TProfile2D>(HIST("GenProf2D_mu8_netproton"))->Fill(cent, sampleIndex, netProtPowers[7]);
     }
     //-------------------------------------------------------------------------------------------
   }
@@ -1168,12 +1154,7 @@ struct NetprotonCumulantsMc {
             histos.fill(HIST("hrecDcaZProton"), track.dcaZ());
             if (particle.pt() < cfgCutPtUpper) {
               nProt = nProt + 1.0;
-              float pEff = getEfficiency(track); // get efficiency of track
-              if (pEff != 0) {
-                for (int i = 1; i < 7; i++) {
-                  powerEffProt[i] += std::pow(1.0 / pEff, i);
-                }
-              }
+              o2::analysis::ebyefluctuations::addInverseEfficiencyPowers(powerEffProt, getEfficiency(track));
             }
             if (particle.pdgCode() == PDG_t::kProton) {
               histos.fill(HIST("hrecTruePtProton"), particle.pt()); //! hist for p purity
@@ -1190,12 +1171,7 @@ struct NetprotonCumulantsMc {
             histos.fill(HIST("hrecDcaZAntiproton"), track.dcaZ());
             if (particle.pt() < cfgCutPtUpper) {
               nAntiprot = nAntiprot + 1.0;
-              float pEff = getEfficiency(track); // get efficiency of track
-              if (pEff != 0) {
-                for (int i = 1; i < 7; i++) {
-                  powerEffAntiprot[i] += std::pow(1.0 / pEff, i);
-                }
-              }
+              o2::analysis::ebyefluctuations::addInverseEfficiencyPowers(powerEffAntiprot, getEfficiency(track));
             }
             if (particle.pdgCode() == PDG_t::kProtonBar) {
               histos.fill(HIST("hrecTruePtAntiproton"), particle.pt()); //! hist for anti-p purity
@@ -1206,6 +1182,7 @@ struct NetprotonCumulantsMc {
     } //! end track loop
 
     float netProt = nProt - nAntiprot;
+    const auto netProtPowers = o2::analysis::ebyefluctuations::powers<8>(netProt); // netProtPowers[k - 1] = netProt^k
     histos.fill(HIST("hrecNetProtonVsCentrality"), netProt, cent);
     histos.fill(HIST("hrecProtonVsCentrality"), nProt, cent);
     histos.fill(HIST("hrecAntiprotonVsCentrality"), nAntiprot, cent);
@@ -1493,14 +1470,14 @@ struct NetprotonCumulantsMc {
     if (cfgIsCalculateCentral) {
 
       // uncorrected
-      histos.get<TProfile>(HIST("Prof_mu1_netproton"))->Fill(cent, std::pow(netProt, 1.0));
-      histos.get<TProfile>(HIST("Prof_mu2_netproton"))->Fill(cent, std::pow(netProt, 2.0));
-      histos.get<TProfile>(HIST("Prof_mu3_netproton"))->Fill(cent, std::pow(netProt, 3.0));
-      histos.get<TProfile>(HIST("Prof_mu4_netproton"))->Fill(cent, std::pow(netProt, 4.0));
-      histos.get<TProfile>(HIST("Prof_mu5_netproton"))->Fill(cent, std::pow(netProt, 5.0));
-      histos.get<TProfile>(HIST("Prof_mu6_netproton"))->Fill(cent, std::pow(netProt, 6.0));
-      histos.get<TProfile>(HIST("Prof_mu7_netproton"))->Fill(cent, std::pow(netProt, 7.0));
-      histos.get<TProfile>(HIST("Prof_mu8_netproton"))->Fill(cent, std::pow(netProt, 8.0));
+      histos.get<TProfile>(HIST("Prof_mu1_netproton"))->Fill(cent, netProtPowers[0]);
+      histos.get<TProfile>(HIST("Prof_mu2_netproton"))->Fill(cent, netProtPowers[1]);
+      histos.get<TProfile>(HIST("Prof_mu3_netproton"))->Fill(cent, netProtPowers[2]);
+      histos.get<TProfile>(HIST("Prof_mu4_netproton"))->Fill(cent, netProtPowers[3]);
+      histos.get<TProfile>(HIST("Prof_mu5_netproton"))->Fill(cent, netProtPowers[4]);
+      histos.get<TProfile>(HIST("Prof_mu6_netproton"))->Fill(cent, netProtPowers[5]);
+      histos.get<TProfile>(HIST("Prof_mu7_netproton"))->Fill(cent, netProtPowers[6]);
+      histos.get<TProfile>(HIST("Prof_mu8_netproton"))->Fill(cent, netProtPowers[7]);
 
       // eff. corrected
       histos.get<TProfile>(HIST("Prof_Q11_1"))->Fill(cent, fQ11_1);
@@ -1754,14 +1731,14 @@ struct NetprotonCumulantsMc {
       float lRandom = fRndm->Rndm();
       int sampleIndex = static_cast<int>(cfgNSubsample * lRandom);
 
-      histos.get<TProfile2D>(HIST("Prof2D_mu1_netproton"))->Fill(cent, sampleIndex, std::pow(netProt, 1.0));
-      histos.get<TProfile2D>(HIST("Prof2D_mu2_netproton"))->Fill(cent, sampleIndex, std::pow(netProt, 2.0));
-      histos.get<TProfile2D>(HIST("Prof2D_mu3_netproton"))->Fill(cent, sampleIndex, std::pow(netProt, 3.0));
-      histos.get<TProfile2D>(HIST("Prof2D_mu4_netproton"))->Fill(cent, sampleIndex, std::pow(netProt, 4.0));
-      histos.get<TProfile2D>(HIST("Prof2D_mu5_netproton"))->Fill(cent, sampleIndex, std::pow(netProt, 5.0));
-      histos.get<TProfile2D>(HIST("Prof2D_mu6_netproton"))->Fill(cent, sampleIndex, std::pow(netProt, 6.0));
-      histos.get<TProfile2D>(HIST("Prof2D_mu7_netproton"))->Fill(cent, sampleIndex, std::pow(netProt, 7.0));
-      histos.get<TProfile2D>(HIST("Prof2D_mu8_netproton"))->Fill(cent, sampleIndex, std::pow(netProt, 8.0));
+      histos.get<TProfile2D>(HIST("Prof2D_mu1_netproton"))->Fill(cent, sampleIndex, netProtPowers[0]);
+      histos.get<TProfile2D>(HIST("Prof2D_mu2_netproton"))->Fill(cent, sampleIndex, netProtPowers[1]);
+      histos.get<TProfile2D>(HIST("Prof2D_mu3_netproton"))->Fill(cent, sampleIndex, netProtPowers[2]);
+      histos.get<TProfile2D>(HIST("Prof2D_mu4_netproton"))->Fill(cent, sampleIndex, netProtPowers[3]);
+      histos.get<TProfile2D>(HIST("Prof2D_mu5_netproton"))->Fill(cent, sampleIndex, netProtPowers[4]);
+      histos.get<TProfile2D>(HIST("Prof2D_mu6_netproton"))->Fill(cent, sampleIndex, netProtPowers[5]);
+      histos.get<TProfile2D>(HIST("Prof2D_mu7_netproton"))->Fill(cent, sampleIndex, netProtPowers[6]);
+      histos.get<TProfile2D>(HIST("Prof2D_mu8_netproton"))->Fill(cent, sampleIndex, netProtPowers[7]);
 
       histos.get<TProfile2D>(HIST("Prof2D_Q11_1"))->Fill(cent, sampleIndex, fQ11_1);
       histos.get<TProfile2D>(HIST("Prof2D_Q11_2"))->Fill(cent, sampleIndex, fQ11_2);
@@ -2105,12 +2082,7 @@ struct NetprotonCumulantsMc {
 
           if (track.pt() < cfgCutPtUpper) {
             nProt = nProt + 1.0;
-            float pEff = getEfficiency(track); // get efficiency of track
-            if (pEff != 0) {
-              for (int i = 1; i < 7; i++) {
-                powerEffProt[i] += std::pow(1.0 / pEff, i);
-              }
-            }
+            o2::analysis::ebyefluctuations::addInverseEfficiencyPowers(powerEffProt, getEfficiency(track));
           }
         }
         // for anti-protons
@@ -2123,12 +2095,7 @@ struct NetprotonCumulantsMc {
           histos.fill(HIST("hrecDcaZAntiproton"), track.dcaZ());
           if (track.pt() < cfgCutPtUpper) {
             nAntiprot = nAntiprot + 1.0;
-            float pEff = getEfficiency(track); // get efficiency of track
-            if (pEff != 0) {
-              for (int i = 1; i < 7; i++) {
-                powerEffAntiprot[i] += std::pow(1.0 / pEff, i);
-              }
-            }
+            o2::analysis::ebyefluctuations::addInverseEfficiencyPowers(powerEffAntiprot, getEfficiency(track));
           }
         }
 
@@ -2136,6 +2103,7 @@ struct NetprotonCumulantsMc {
     } //! end track loop
 
     float netProt = nProt - nAntiprot;
+    const auto netProtPowers = o2::analysis::ebyefluctuations::powers<8>(netProt); // netProtPowers[k - 1] = netProt^k
     histos.fill(HIST("hrecNetProtonVsCentrality"), netProt, cent);
     histos.fill(HIST("hrecProtonVsCentrality"), nProt, cent);
     histos.fill(HIST("hrecAntiprotonVsCentrality"), nAntiprot, cent);
@@ -2423,14 +2391,14 @@ struct NetprotonCumulantsMc {
     if (cfgIsCalculateCentral) {
 
       // uncorrected
-      histos.get<TProfile>(HIST("Prof_mu1_netproton"))->Fill(cent, std::pow(netProt, 1.0));
-      histos.get<TProfile>(HIST("Prof_mu2_netproton"))->Fill(cent, std::pow(netProt, 2.0));
-      histos.get<TProfile>(HIST("Prof_mu3_netproton"))->Fill(cent, std::pow(netProt, 3.0));
-      histos.get<TProfile>(HIST("Prof_mu4_netproton"))->Fill(cent, std::pow(netProt, 4.0));
-      histos.get<TProfile>(HIST("Prof_mu5_netproton"))->Fill(cent, std::pow(netProt, 5.0));
-      histos.get<TProfile>(HIST("Prof_mu6_netproton"))->Fill(cent, std::pow(netProt, 6.0));
-      histos.get<TProfile>(HIST("Prof_mu7_netproton"))->Fill(cent, std::pow(netProt, 7.0));
-      histos.get<TProfile>(HIST("Prof_mu8_netproton"))->Fill(cent, std::pow(netProt, 8.0));
+      histos.get<TProfile>(HIST("Prof_mu1_netproton"))->Fill(cent, netProtPowers[0]);
+      histos.get<TProfile>(HIST("Prof_mu2_netproton"))->Fill(cent, netProtPowers[1]);
+      histos.get<TProfile>(HIST("Prof_mu3_netproton"))->Fill(cent, netProtPowers[2]);
+      histos.get<TProfile>(HIST("Prof_mu4_netproton"))->Fill(cent, netProtPowers[3]);
+      histos.get<TProfile>(HIST("Prof_mu5_netproton"))->Fill(cent, netProtPowers[4]);
+      histos.get<TProfile>(HIST("Prof_mu6_netproton"))->Fill(cent, netProtPowers[5]);
+      histos.get<TProfile>(HIST("Prof_mu7_netproton"))->Fill(cent, netProtPowers[6]);
+      histos.get<TProfile>(HIST("Prof_mu8_netproton"))->Fill(cent, netProtPowers[7]);
 
       // eff. corrected
       histos.get<TProfile>(HIST("Prof_Q11_1"))->Fill(cent, fQ11_1);
@@ -2684,14 +2652,14 @@ struct NetprotonCumulantsMc {
       float lRandom = fRndm->Rndm();
       int sampleIndex = static_cast<int>(cfgNSubsample * lRandom);
 
-      histos.get<TProfile2D>(HIST("Prof2D_mu1_netproton"))->Fill(cent, sampleIndex, std::pow(netProt, 1.0));
-      histos.get<TProfile2D>(HIST("Prof2D_mu2_netproton"))->Fill(cent, sampleIndex, std::pow(netProt, 2.0));
-      histos.get<TProfile2D>(HIST("Prof2D_mu3_netproton"))->Fill(cent, sampleIndex, std::pow(netProt, 3.0));
-      histos.get<TProfile2D>(HIST("Prof2D_mu4_netproton"))->Fill(cent, sampleIndex, std::pow(netProt, 4.0));
-      histos.get<TProfile2D>(HIST("Prof2D_mu5_netproton"))->Fill(cent, sampleIndex, std::pow(netProt, 5.0));
-      histos.get<TProfile2D>(HIST("Prof2D_mu6_netproton"))->Fill(cent, sampleIndex, std::pow(netProt, 6.0));
-      histos.get<TProfile2D>(HIST("Prof2D_mu7_netproton"))->Fill(cent, sampleIndex, std::pow(netProt, 7.0));
-      histos.get<TProfile2D>(HIST("Prof2D_mu8_netproton"))->Fill(cent, sampleIndex, std::pow(netProt, 8.0));
+      histos.get<TProfile2D>(HIST("Prof2D_mu1_netproton"))->Fill(cent, sampleIndex, netProtPowers[0]);
+      histos.get<TProfile2D>(HIST("Prof2D_mu2_netproton"))->Fill(cent, sampleIndex, netProtPowers[1]);
+      histos.get<TProfile2D>(HIST("Prof2D_mu3_netproton"))->Fill(cent, sampleIndex, netProtPowers[2]);
+      histos.get<TProfile2D>(HIST("Prof2D_mu4_netproton"))->Fill(cent, sampleIndex, netProtPowers[3]);
+      histos.get<TProfile2D>(HIST("Prof2D_mu5_netproton"))->Fill(cent, sampleIndex, netProtPowers[4]);
+      histos.get<TProfile2D>(HIST("Prof2D_mu6_netproton"))->Fill(cent, sampleIndex, netProtPowers[5]);
+      histos.get<TProfile2D>(HIST("Prof2D_mu7_netproton"))->Fill(cent, sampleIndex, netProtPowers[6]);
+      histos.get<TProfile2D>(HIST("Prof2D_mu8_netproton"))->Fill(cent, sampleIndex, netProtPowers[7]);
 
       histos.get<TProfile2D>(HIST("Prof2D_Q11_1"))->Fill(cent, sampleIndex, fQ11_1);
       histos.get<TProfile2D>(HIST("Prof2D_Q11_2"))->Fill(cent, sampleIndex, fQ11_2);
@@ -24,6 +24,7 @@
 // #include "Framework/Logger.h"
 // #include "Common/DataModel/Multiplicity.h"
 
+#include <algorithm>
 #include <vector>
 #include <memory>
 #include "TLorentzVector.h"
@@ -33,6 +34,8 @@
 #include "CommonConstants/PhysicsConstants.h"
 #include "CommonConstants/MathConstants.h"
 
+#include "Common/Core/PdgLookup.h"
+
 double particle_mass(const int PDGcode)
 {
   switch (std::abs(PDGcode)) {
@@ -51,7 +54,8 @@ double particle_mass(const int PDGcode)
     default:
       break;
   }
-  return TDatabasePDG::Instance()->GetParticle(PDGcode)->Mass();
+  static const o2::common::core::PdgLookup pdgLookup; // the other masses are cached after the first query
+  return pdgLookup.mass(PDGcode);
 }
 
 // for the variable binning in 3D DCA histos in the PairMC task
@@ -99,20 +103,21 @@ template <typename Type>
 Type getBinIndex(float const& value, std::vector<float> const& binning, int const& NsubBins = 1)
 {
   Type res = 10e6;
-  for (unsigned int i = 0; i < binning.size() - 1; i++) {
-    if (value >= binning[i] && binning[i + 1] > value) {
-      if (NsubBins < 2) {
-        res = (Type)i;
-        break;
-      } else {
-        float subBinWidth = (binning[i + 1] - binning[i]) / NsubBins;
-        int subBin = std::floor((value - binning[i]) / subBinWidth);
-        int delimeter = std::pow(10, std::to_string(NsubBins).size());
-
-        res = (Type)i + (Type)subBin / delimeter;
-        break;
-      }
+  if (binning.size() < 2 || !(value >= binning.front() && value < binning.back())) { // also catches NaN
+    return res;
+  }
+  const unsigned int i = std::upper_bound(binning.begin(), binning.end(), value) - binning.begin() - 1; // binning[i] <= value < binning[i + 1]
+  if (NsubBins < 2) {
+    res = (Type)i;
+  } else {
+    float subBinWidth = (binning[i + 1] - binning[i]) / NsubBins;
+    int subBin = std::floor((value - binning[i]) / subBinWidth);
+    int delimeter = 10; // smallest power of 10 larger than NsubBins
+    while (delimeter <= NsubBins) {
+      delimeter *= 10;
     }
+
+    res = (Type)i + (Type)subBin / delimeter;
   }
   return res;
 }
@@ -363,12 +368,22 @@ TVector3 FemtoPair<TrackType>::GetQLCMS() const
   if (_PDG1 * _PDG2 == 0)
     return TVector3(-1000, -1000, -1000);
 
-  TLorentzVector first4momentum;
-  first4momentum.SetPtEtaPhiM(_first->pt(), _first->eta(), _first->phi(), particle_mass(_PDG1));
-  TLorentzVector second4momentum;
-  second4momentum.SetPtEtaPhiM(_second->pt(), _second->eta(), _second->phi(), particle_mass(_PDG2));
-
-  return GetQLCMSFrom4vectors(first4momentum, second4momentum);
+  // same as GetQLCMSFrom4vectors, without building and boosting the TLorentzVectors:
+  // longitudinal boost to the LCMS and rotation of the X axis along the pair kT
+  const double m1 = particle_mass(_PDG1), m2 = particle_mass(_PDG2);
+  const double pt1 = _first->pt(), pt2 = _second->pt();
+  const double px1 = pt1 * std::cos(_first->phi()), py1 = pt1 * std::sin(_first->phi()), pz1 = pt1 * std::sinh(_first->eta());
+  const double px2 = pt2 * std::cos(_second->phi()), py2 = pt2 * std::sin(_second->phi()), pz2 = pt2 * std::sinh(_second->eta());
+  const double e1 = std::sqrt(pt1 * pt1 + pz1 * pz1 + m1 * m1), e2 = std::sqrt(pt2 * pt2 + pz2 * pz2 + m2 * m2);
+
+  const double sumPx = px1 + px2, sumPy = py1 + py2, sumPz = pz1 + pz2, sumE = e1 + e2;
+  const double difPx = px1 - px2, difPy = py1 - py2, difPz = pz1 - pz2, difE = e1 - e2;
+  const double sumPt = std::sqrt(sumPx * sumPx + sumPy * sumPy);
+  const double cosPhi = sumPt > 0. ? sumPx / sumPt : 1., sinPhi = sumPt > 0. ? sumPy / sumPt : 0.;
+
+  return TVector3(difPx * cosPhi + difPy * sinPhi,
+                  difPy * cosPhi - difPx * sinPhi,
+                  (sumE * difPz - sumPz * difE) / std::sqrt(sumE * sumE - sumPz * sumPz));
 }
 
 template <typename TrackType>
@@ -17,11 +17,13 @@
 #define PWGCF_FEMTO3D_DATAMODEL_SINGLETRACKSELECTOR_H_
 
 // #include <experimental/type_traits>
+#include <array>
 #include <utility>
 #include <vector>
 
 #include "Framework/ASoA.h"
 #include "Framework/AnalysisDataModel.h"
+#include "Common/Core/BitPacking.h"
 #include "Common/DataModel/PIDResponse.h"
 #include "Common/DataModel/PIDResponseITS.h"
 #include "Framework/Logger.h"
@@ -119,6 +121,13 @@ using dca = dca_v2;
 using chi2 = binningParent<std::pair<float, float>(0.f, 10.f)>;
 using rowsOverFindable = binningParent<std::pair<float, float>(0.f, 3.f)>;
 
+// 5-bit nsigma codebook of the packed PID table: edges on the usual cut values, the missing TOF (-999) goes to the underflow
+inline constexpr std::array<float, 29> nsigmaPackedEdges{-10.f, -7.f, -5.f, -4.f, -3.5f, -3.25f, -3.f, -2.75f, -2.5f, -2.25f, -2.f, -1.5f, -1.f, -0.5f, 0.f,
+                                                         0.5f, 1.f, 1.5f, 2.f, 2.25f, 2.5f, 2.75f, 3.f, 3.25f, 3.5f, 4.f, 5.f, 7.f, 10.f};
+using nsigmaPacked = o2::common::core::packing::TabulatedCodec<5, nsigmaPackedEdges>;
+// TPC and TOF nsigma of pions, kaons and protons in 30 bits
+using nsigmaPackedPiKaPr = o2::common::core::packing::PackedLayout<uint32_t, nsigmaPacked, nsigmaPacked, nsigmaPacked, nsigmaPacked, nsigmaPacked, nsigmaPacked>;
+
 } // namespace binning
 
 //==================================== base event characteristics ====================================
@@ -273,6 +282,15 @@ DECLARE_SOA_COLUMN(StoredTPCNSigmaHe, storedTpcNSigmaHe, binning::nsigma::binned
 DECLARE_SOA_DYNAMIC_COLUMN(TPCNSigmaHe, tpcNSigmaHe,
                            [](binning::nsigma::binned_t nsigma_binned) -> float { return singletrackselector::unPackSymmetric<binning::nsigma>(nsigma_binned); });
 
+//------------------------------------ Packed pions, kaons and protons ------------------------------------
+DECLARE_SOA_COLUMN(StoredNSigmaPiKaPr, storedNSigmaPiKaPr, binning::nsigmaPackedPiKaPr::word_t); // TPC and TOF nsigma packed with binning::nsigmaPackedPiKaPr
+DECLARE_SOA_PACKED_COLUMN(PackedTPCNSigmaPi, tpcNSigmaPi, binning::nsigmaPackedPiKaPr, 0);
+DECLARE_SOA_PACKED_COLUMN(PackedTOFNSigmaPi, tofNSigmaPi, binning::nsigmaPackedPiKaPr, 1);
+DECLARE_SOA_PACKED_COLUMN(PackedTPCNSigmaKa, tpcNSigmaKa, binning::nsigmaPackedPiKaPr, 2);
+DECLARE_SOA_PACKED_COLUMN(PackedTOFNSigmaKa, tofNSigmaKa, binning::nsigmaPackedPiKaPr, 3);
+DECLARE_SOA_PACKED_COLUMN(PackedTPCNSigmaPr, tpcNSigmaPr, binning::nsigmaPackedPiKaPr, 4);
+DECLARE_SOA_PACKED_COLUMN(PackedTOFNSigmaPr, tofNSigmaPr, binning::nsigmaPackedPiKaPr, 5);
+
 using StoredTOFNSigmaPi_v1 = StoredTOFNSigmaPi; // compatibility with the old tables of version 2 -- to be removed later
 using StoredTPCNSigmaPi_v1 = StoredTPCNSigmaPi; // compatibility with the old tables of version 2 -- to be removed later
 
@@ -472,6 +490,17 @@ DECLARE_SOA_TABLE(SinglePIDHes, "AOD", "SINGLEPIDHE",
                   singletrackselector::TOFNSigmaHe<singletrackselector::StoredTOFNSigmaHe>,
                   singletrackselector::TPCNSigmaHe<singletrackselector::StoredTPCNSigmaHe>);
 
+// Alternative to SinglePIDPis, SinglePIDKas and SinglePIDPrs with the same getters (not to be joined with them): 4 bytes instead of 6, coarser binning
+DECLARE_SOA_TABLE(SinglePIDPackeds, "AOD", "SINGLEPIDPACKED",
+                  singletrackselector::StoredNSigmaPiKaPr,
+
+                  singletrackselector::PackedTPCNSigmaPi<singletrackselector::StoredNSigmaPiKaPr>,
+                  singletrackselector::PackedTOFNSigmaPi<singletrackselector::StoredNSigmaPiKaPr>,
+                  singletrackselector::PackedTPCNSigmaKa<singletrackselector::StoredNSigmaPiKaPr>,
+                  singletrackselector::PackedTOFNSigmaKa<singletrackselector::StoredNSigmaPiKaPr>,
+                  singletrackselector::PackedTPCNSigmaPr<singletrackselector::StoredNSigmaPiKaPr>,
+                  singletrackselector::PackedTOFNSigmaPr<singletrackselector::StoredNSigmaPiKaPr>);
+
 DECLARE_SOA_TABLE(SingleTrkExtras, "AOD", "SINGLETRKEXTRA",
                   singletrackselector::TPCInnerParam,
                   singletrackselector::TPCSignal,
@@ -109,6 +109,7 @@ struct singleTrackSelector {
   Produces<o2::aod::SinglePIDDes> tableRowPIDDe;
   Produces<o2::aod::SinglePIDTrs> tableRowPIDTr;
   Produces<o2::aod::SinglePIDHes> tableRowPIDHe;
+  Produces<o2::aod::SinglePIDPackeds> tableRowPIDPacked;
 
   Produces<o2::aod::SingleTrkMCs> tableRowMC;
   // Produces<o2::aod::SingleTrkMCExtras> tableRowMCExtra;
@@ -279,6 +280,10 @@ struct singleTrackSelector {
           tableRowPIDHe(singletrackselector::packSymmetric<singletrackselector::binning::nsigma>(track.tofNSigmaHe()),
                         singletrackselector::packSymmetric<singletrackselector::binning::nsigma>(track.tpcNSigmaHe()));
 
+          tableRowPIDPacked(singletrackselector::binning::nsigmaPackedPiKaPr::pack(track.tpcNSigmaPi(), track.tofNSigmaPi(),
+                                                                                   track.tpcNSigmaKa(), track.tofNSigmaKa(),
+                                                                                   track.tpcNSigmaPr(), track.tofNSigmaPr()));
+
           if constexpr (isMC) {
             int origin = -1;
             if (track.mcParticle().isPhysicalPrimary()) {
@@ -16,6 +16,10 @@
 /// \since  03/05/2024
 ///
 
+#include <array>
+#include <cmath>
+#include <vector>
+
 #include "PWGCF/Femto3D/DataModel/singletrackselector.h"
 #include "TH1F.h"
 #include "TCanvas.h"
@@ -122,6 +126,35 @@ bool process(const TString outputName, const int nevents = 100000)
   return gausOk && uniformOk && gausMeanOk && uniformMeanOk;
 }
 
+// The selections with cuts on the codebook edges must be the same before and after the packing, for all the fields
+bool processPackedPid(const int nevents = 100000)
+{
+  using layout = aod::singletrackselector::binning::nsigmaPackedPiKaPr;
+  const std::vector<float> cuts{2.f, 2.5f, 3.f, 3.5f, 5.f};
+  int nFailed = 0;
+  for (int i = 0; i < nevents; i++) {
+    std::array<float, 6> values;
+    for (auto& value : values) {
+      value = (i % 2) ? gRandom->Gaus(0, 2) : gRandom->Uniform(-12, 12);
+    }
+    if (i % 10 == 0) {
+      values[1] = -999.f; // missing TOF
+    }
+    const auto word = layout::pack(values[0], values[1], values[2], values[3], values[4], values[5]);
+    const std::array<float, 6> unpacked{layout::unpack<0>(word), layout::unpack<1>(word), layout::unpack<2>(word),
+                                        layout::unpack<3>(word), layout::unpack<4>(word), layout::unpack<5>(word)};
+    for (int iField = 0; iField < 6; iField++) {
+      for (const auto& cut : cuts) {
+        if ((std::abs(values[iField]) < cut) != (std::abs(unpacked[iField]) < cut)) {
+          nFailed++;
+        }
+      }
+    }
+  }
+  LOG(info) << "Packed PID: " << layout::nBitsUsed << " bits used, " << nFailed << " selections changed by the packing";
+  return nFailed == 0;
+}
+
 int main(int /*argc*/, char* /*argv*/[])
 {
 
@@ -139,4 +172,11 @@ int main(int /*argc*/, char* /*argv*/[])
     LOG(fatal) << "Packing and unpacking of DCA signals (dca) in the Femto is incorrect.";
   }
 
+  LOG(info) << "Checking the packing and unpacking of the packed PID table in the Femto.";
+  if (processPackedPid(100000)) {
+    LOG(info) << "Packing and unpacking of the packed PID table in the Femto is correct.";
+  } else {
+    LOG(fatal) << "Packing and unpacking of the packed PID table in the Femto is incorrect.";
+  }
+
 } // main
@@ -20,6 +20,8 @@
 #define PWGCF_FEMTODREAM_CORE_FEMTODREAMCONTAINER_H_
 
 #include <fairlogger/Logger.h>
+#include <array>
+#include <memory>
 #include <vector>
 #include <string>
 
@@ -70,7 +72,7 @@ class FemtoDreamContainer
   /// \param kTAxis axis object for the kT axis
   /// \param mTAxis axis object for the mT axis
 
-  template <bool isHF = false, typename T>
+  template <o2::aod::femtodreamMCparticle::MCType mc, bool isHF = false, typename T>
   void init_base(std::string folderName, std::string femtoObs,
                  T& femtoObsAxis, T& pTAxis, T& kTAxis, T& mTAxis, T& multAxis, T& multPercentileAxis,
                  T& /*kstarAxis4D*/, T& mTAxis4D, T& multAxis4D, T& multPercentileAxis4D,
@@ -78,30 +80,35 @@ class FemtoDreamContainer
   {
 
     if constexpr (isHF) {
-      mHistogramRegistry->add((folderName + "/relPairkstarmP2").c_str(), ("; " + femtoObs + "; Mass (GeV)").c_str(), kTH2F, {femtoObsAxis, mP2Axis});
+      mPairHists2D[mc][kRelPairkstarmP2] = mHistogramRegistry->add<TH2>((folderName + "/relPairkstarmP2").c_str(), ("; " + femtoObs + "; Mass (GeV)").c_str(), kTH2F, {femtoObsAxis, mP2Axis});
     }
 
-    mHistogramRegistry->add((folderName + "/relPairDist").c_str(), ("; " + femtoObs + "; Entries").c_str(), kTH1F, {femtoObsAxis});
-    mHistogramRegistry->add((folderName + "/relPairkT").c_str(), "; #it{k}_{T} (GeV/#it{c}); Entries", kTH1F, {kTAxis});
-    mHistogramRegistry->add((folderName + "/relPairkstarkT").c_str(), ("; " + femtoObs + "; #it{k}_{T} (GeV/#it{c})").c_str(), kTH2F, {femtoObsAxis, kTAxis});
-    mHistogramRegistry->add((folderName + "/relPairkstarmT").c_str(), ("; " + femtoObs + "; #it{m}_{T} (GeV/#it{c}^{2})").c_str(), kTH2F, {femtoObsAxis, mTAxis});
-    mHistogramRegistry->add((folderName + "/relPairkstarMult").c_str(), ("; " + femtoObs + "; Multiplicity").c_str(), kTH2F, {femtoObsAxis, multAxis});
-    mHistogramRegistry->add((folderName + "/relPairkstarMultPercentile").c_str(), ("; " + femtoObs + "; Multiplicity Percentile").c_str(), kTH2F, {femtoObsAxis, multPercentileAxis4D});
-    mHistogramRegistry->add((folderName + "/kstarPtPart1").c_str(), ("; " + femtoObs + "; #it{p} _{T} Particle 1 (GeV/#it{c})").c_str(), kTH2F, {femtoObsAxis, pTAxis});
-    mHistogramRegistry->add((folderName + "/kstarPtPart2").c_str(), ("; " + femtoObs + "; #it{p} _{T} Particle 2 (GeV/#it{c})").c_str(), kTH2F, {femtoObsAxis, pTAxis});
-    mHistogramRegistry->add((folderName + "/MultPtPart1").c_str(), "; #it{p} _{T} Particle 1 (GeV/#it{c}); Multiplicity", kTH2F, {pTAxis, multAxis});
-    mHistogramRegistry->add((folderName + "/MultPtPart2").c_str(), "; #it{p} _{T} Particle 2 (GeV/#it{c}); Multiplicity", kTH2F, {pTAxis, multAxis});
-    mHistogramRegistry->add((folderName + "/MultPercentilePtPart1").c_str(), "; #it{p} _{T} Particle 1 (GeV/#it{c}); Multiplicity Percentile", kTH2F, {pTAxis, multPercentileAxis});
-    mHistogramRegistry->add((folderName + "/MultPercentilePtPart2").c_str(), "; #it{p} _{T} Particle 2 (GeV/#it{c}); Multiplicity Percentile", kTH2F, {pTAxis, multPercentileAxis});
-    mHistogramRegistry->add((folderName + "/PtPart1PtPart2").c_str(), "; #it{p} _{T} Particle 1 (GeV/#it{c}); #it{p} _{T} Particle 2 (GeV/#it{c})", kTH2F, {pTAxis, pTAxis});
+    mPairHists1D[mc][kRelPairDist] = mHistogramRegistry->add<TH1>((folderName + "/relPairDist").c_str(), ("; " + femtoObs + "; Entries").c_str(), kTH1F, {femtoObsAxis});
+    mPairHists1D[mc][kRelPairkT] = mHistogramRegistry->add<TH1>((folderName + "/relPairkT").c_str(), "; #it{k}_{T} (GeV/#it{c}); Entries", kTH1F, {kTAxis});
+    mPairHists2D[mc][kRelPairkstarkT] = mHistogramRegistry->add<TH2>((folderName + "/relPairkstarkT").c_str(), ("; " + femtoObs + "; #it{k}_{T} (GeV/#it{c})").c_str(), kTH2F, {femtoObsAxis, kTAxis});
+    mPairHists2D[mc][kRelPairkstarmT] = mHistogramRegistry->add<TH2>((folderName + "/relPairkstarmT").c_str(), ("; " + femtoObs + "; #it{m}_{T} (GeV/#it{c}^{2})").c_str(), kTH2F, {femtoObsAxis, mTAxis});
+    mPairHists2D[mc][kRelPairkstarMult] = mHistogramRegistry->add<TH2>((folderName + "/relPairkstarMult").c_str(), ("; " + femtoObs + "; Multiplicity").c_str(), kTH2F, {femtoObsAxis, multAxis});
+    mPairHists2D[mc][kRelPairkstarMultPercentile] = mHistogramRegistry->add<TH2>((folderName + "/relPairkstarMultPercentile").c_str(), ("; " + femtoObs + "; Multiplicity Percentile").c_str(), kTH2F, {femtoObsAxis, multPercentileAxis4D});
+    mPairHists2D[mc][kKstarPtPart1] = mHistogramRegistry->add<TH2>((folderName + "/kstarPtPart1").c_str(), ("; " + femtoObs + "; #it{p} _{T} Particle 1 (GeV/#it{c})").c_str(), kTH2F, {femtoObsAxis, pTAxis});
+    mPairHists2D[mc][kKstarPtPart2] = mHistogramRegistry->add<TH2>((folderName + "/kstarPtPart2").c_str(), ("; " + femtoObs + "; #it{p} _{T} Particle 2 (GeV/#it{c})").c_str(), kTH2F, {femtoObsAxis, pTAxis});
+    mPairHists2D[mc][kMultPtPart1] = mHistogramRegistry->add<TH2>((folderName + "/MultPtPart1").c_str(), "; #it{p} _{T} Particle 1 (GeV/#it{c}); Multiplicity", kTH2F, {pTAxis, multAxis});
+    mPairHists2D[mc][kMultPtPart2] = mHistogramRegistry->add<TH2>((folderName + "/MultPtPart2").c_str(), "; #it{p} _{T} Particle 2 (GeV/#it{c}); Multiplicity", kTH2F, {pTAxis, multAxis});
+    mPairHists2D[mc][kMultPercentilePtPart1] = mHistogramRegistry->add<TH2>((folderName + "/MultPercentilePtPart1").c_str(), "; #it{p} _{T} Particle 1 (GeV/#it{c}); Multiplicity Percentile", kTH2F, {pTAxis, multPercentileAxis});
+    mPairHists2D[mc][kMultPercentilePtPart2] = mHistogramRegistry->add<TH2>((folderName + "/MultPercentilePtPart2").c_str(), "; #it{p} _{T} Particle 2 (GeV/#it{c}); Multiplicity Percentile", kTH2F, {pTAxis, multPercentileAxis});
+    mPairHists2D[mc][kPtPart1PtPart2] = mHistogramRegistry->add<TH2>((folderName + "/PtPart1PtPart2").c_str(), "; #it{p} _{T} Particle 1 (GeV/#it{c}); #it{p} _{T} Particle 2 (GeV/#it{c})", kTH2F, {pTAxis, pTAxis});
     if (use4dplots) {
-      mHistogramRegistry->add((folderName + "/relPairkstarmTMultMultPercentile").c_str(), ("; " + femtoObs + "; #it{m}_{T} (GeV/#it{c}^{2}); Multiplicity").c_str(), kTHnSparseF, {femtoObsAxis, mTAxis4D, multAxis4D, multPercentileAxis4D});
+      mHighDimHists[mc][0] = addHighDimHist((folderName + "/relPairkstarmTMultMultPercentile").c_str(), ("; " + femtoObs + "; #it{m}_{T} (GeV/#it{c}^{2}); Multiplicity").c_str(), {femtoObsAxis, mTAxis4D, multAxis4D, multPercentileAxis4D});
     }
     if (extendedplots) {
-      mHistogramRegistry->add((folderName + "/relPairkstarmTPtPart1PtPart2MultPercentile").c_str(), ("; :" + femtoObs + "; #it{m}_{T} (GeV/#it{c}^{2}); #it{p} _{T} Particle 1 (GeV/#it{c}); #it{p} _{T} Particle 2 (GeV/#it{c}); Multiplicity Percentile (%)").c_str(), kTHnSparseF, {femtoObsAxis, mTAxis4D, pTAxis, pTAxis, multPercentileAxis4D});
+      mHighDimHists[mc][1] = addHighDimHist((folderName + "/relPairkstarmTPtPart1PtPart2MultPercentile").c_str(), ("; :" + femtoObs + "; #it{m}_{T} (GeV/#it{c}^{2}); #it{p} _{T} Particle 1 (GeV/#it{c}); #it{p} _{T} Particle 2 (GeV/#it{c}); Multiplicity Percentile (%)").c_str(), {femtoObsAxis, mTAxis4D, pTAxis, pTAxis, multPercentileAxis4D});
     }
   }
 
+  /// Store the 4D/5D pair histograms as dense THnF instead of THnSparseF, to be called before init
+  /// Filling a dense THn is much cheaper than filling a THnSparse, but the memory scales with the product of the number of bins, so coarse 4D axes are needed
+  /// \param dense true for THnF, false (default) for THnSparseF
+  void setDenseHighDimPlots(bool dense) { mDenseHighDimPlots = dense; }
+
   /// Initializes specialized Monte Carlo truth histograms for the task
   /// internal function called by init only in case of Monte Carlo truth
   /// \tparam T type of the xxis Object
@@ -165,14 +172,14 @@ class FemtoDreamContainer
 
     std::string folderName = static_cast<std::string>(mFolderSuffix[mEventType]) + static_cast<std::string>(o2::aod::femtodreamMCparticle::MCTypeName[o2::aod::femtodreamMCparticle::MCType::kRecon]);
 
-    init_base<isHF>(folderName, femtoObs,
+    init_base<o2::aod::femtodreamMCparticle::MCType::kRecon, isHF>(folderName, femtoObs,
                     femtoObsAxis, pTAxis, kTAxis, mTAxis, multAxis, multPercentileAxis,
                     kstarAxis4D, mTAxis4D, multAxis4D, multPercentileAxis4D,
                     use4dplots, extendedplots, mP2Axis);
 
     if (isMC) {
       folderName = static_cast<std::string>(mFolderSuffix[mEventType]) + static_cast<std::string>(o2::aod::femtodreamMCparticle::MCTypeName[o2::aod::femtodreamMCparticle::MCType::kTruth]);
-      init_base<isHF>(folderName, femtoObs,
+      init_base<o2::aod::femtodreamMCparticle::MCType::kTruth, isHF>(folderName, femtoObs,
                       femtoObsAxis, pTAxis, kTAxis, mTAxis, multAxis, multPercentileAxis,
                       kstarAxis4D, mTAxis4D, multAxis4D, multPercentileAxis4D,
                       use4dplots, extendedplots, mP2Axis);
@@ -208,26 +215,29 @@ class FemtoDreamContainer
       } else {
         mP2 = part2.m(std::array{o2::constants::physics::MassPiPlus, o2::constants::physics::MassKPlus, o2::constants::physics::MassProton});
       }
-      mHistogramRegistry->fill(HIST(mFolderSuffix[mEventType]) + HIST(o2::aod::femtodreamMCparticle::MCTypeName[mc]) + HIST("/relPairkstarmP2"), femtoObs, mP2);
+      mPairHists2D[mc][kRelPairkstarmP2]->Fill(femtoObs, mP2);
     }
-    mHistogramRegistry->fill(HIST(mFolderSuffix[mEventType]) + HIST(o2::aod::femtodreamMCparticle::MCTypeName[mc]) + HIST("/relPairDist"), femtoObs);
-    mHistogramRegistry->fill(HIST(mFolderSuffix[mEventType]) + HIST(o2::aod::femtodreamMCparticle::MCTypeName[mc]) + HIST("/relPairkT"), kT);
-    mHistogramRegistry->fill(HIST(mFolderSuffix[mEventType]) + HIST(o2::aod::femtodreamMCparticle::MCTypeName[mc]) + HIST("/relPairkstarkT"), femtoObs, kT);
-    mHistogramRegistry->fill(HIST(mFolderSuffix[mEventType]) + HIST(o2::aod::femtodreamMCparticle::MCTypeName[mc]) + HIST("/relPairkstarmT"), femtoObs, mT);
-    mHistogramRegistry->fill(HIST(mFolderSuffix[mEventType]) + HIST(o2::aod::femtodreamMCparticle::MCTypeName[mc]) + HIST("/relPairkstarMult"), femtoObs, mult);
-    mHistogramRegistry->fill(HIST(mFolderSuffix[mEventType]) + HIST(o2::aod::femtodreamMCparticle::MCTypeName[mc]) + HIST("/relPairkstarMultPercentile"), femtoObs, multPercentile);
-    mHistogramRegistry->fill(HIST(mFolderSuffix[mEventType]) + HIST(o2::aod::femtodreamMCparticle::MCTypeName[mc]) + HIST("/kstarPtPart1"), femtoObs, part1.pt());
-    mHistogramRegistry->fill(HIST(mFolderSuffix[mEventType]) + HIST(o2::aod::femtodreamMCparticle::MCTypeName[mc]) + HIST("/kstarPtPart2"), femtoObs, part2.pt());
-    mHistogramRegistry->fill(HIST(mFolderSuffix[mEventType]) + HIST(o2::aod::femtodreamMCparticle::MCTypeName[mc]) + HIST("/MultPtPart1"), part1.pt(), mult);
-    mHistogramRegistry->fill(HIST(mFolderSuffix[mEventType]) + HIST(o2::aod::femtodreamMCparticle::MCTypeName[mc]) + HIST("/MultPtPart2"), part2.pt(), mult);
-    mHistogramRegistry->fill(HIST(mFolderSuffix[mEventType]) + HIST(o2::aod::femtodreamMCparticle::MCTypeName[mc]) + HIST("/MultPercentilePtPart1"), part1.pt(), multPercentile);
-    mHistogramRegistry->fill(HIST(mFolderSuffix[mEventType]) + HIST(o2::aod::femtodreamMCparticle::MCTypeName[mc]) + HIST("/MultPercentilePtPart2"), part2.pt(), multPercentile);
-    mHistogramRegistry->fill(HIST(mFolderSuffix[mEventType]) + HIST(o2::aod::femtodreamMCparticle::MCTypeName[mc]) + HIST("/PtPart1PtPart2"), part1.pt(), part2.pt());
+    mPairHists1D[mc][kRelPairDist]->Fill(femtoObs);
+    mPairHists1D[mc][kRelPairkT]->Fill(kT);
+    mPairHists2D[mc][kRelPairkstarkT]->Fill(femtoObs, kT);
+    mPairHists2D[mc][kRelPairkstarmT]->Fill(femtoObs, mT);
+    mPairHists2D[mc][kRelPairkstarMult]->Fill(femtoObs, mult);
+    mPairHists2D[mc][kRelPairkstarMultPercentile]->Fill(femtoObs, multPercentile);
+    mPairHists2D[mc][kKstarPtPart1]->Fill(femtoObs, part1.pt());
+    mPairHists2D[mc][kKstarPtPart2]->Fill(femtoObs, part2.pt());
+    mPairHists2D[mc][kMultPtPart1]->Fill(part1.pt(), mult);
+    mPairHists2D[mc][kMultPtPart2]->Fill(part2.pt(), mult);
+    mPairHists2D[mc][kMultPercentilePtPart1]->Fill(part1.pt(), multPercentile);
+    mPairHists2D[mc][kMultPercentilePtPart2]->Fill(part2.pt(), multPercentile);
+    mPairHists2D[mc][kPtPart1PtPart2]->Fill(part1.pt(), part2.pt());
+    // high-dimensional histograms are filled through the handles resolved at init
     if (use4dplots) {
-      mHistogramRegistry->fill(HIST(mFolderSuffix[mEventType]) + HIST(o2::aod::femtodreamMCparticle::MCTypeName[mc]) + HIST("/relPairkstarmTMultMultPercentile"), femtoObs, mT, mult, multPercentile);
+      const double values[] = {femtoObs, mT, static_cast<double>(mult), multPercentile};
+      mHighDimHists[mc][0]->Fill(values);
     }
     if (extendedplots) {
-      mHistogramRegistry->fill(HIST(mFolderSuffix[mEventType]) + HIST(o2::aod::femtodreamMCparticle::MCTypeName[mc]) + HIST("/relPairkstarmTPtPart1PtPart2MultPercentile"), femtoObs, mT, part1.pt(), part2.pt(), multPercentile);
+      const double values[] = {femtoObs, mT, part1.pt(), part2.pt(), multPercentile};
+      mHighDimHists[mc][1]->Fill(values);
     }
   }
 
@@ -325,6 +335,43 @@ class FemtoDreamContainer
   int mPDGOne = 0;                                                                  ///< PDG code of particle 1
   int mPDGTwo = 0;                                                                  ///< PDG code of particle 2
   float mHighkstarCut = 6.;
+  bool mDenseHighDimPlots = false; ///< THnF instead of THnSparseF for the 4D/5D pair histograms
+
+  /// Pair histograms filled for every pair, resolved at init so that the fills do not look them up by name
+  enum PairHist1D { kRelPairDist,
+                    kRelPairkT,
+                    kNPairHists1D };
+  enum PairHist2D { kRelPairkstarmP2,
+                    kRelPairkstarkT,
+                    kRelPairkstarmT,
+                    kRelPairkstarMult,
+                    kRelPairkstarMultPercentile,
+                    kKstarPtPart1,
+                    kKstarPtPart2,
+                    kMultPtPart1,
+                    kMultPtPart2,
+                    kMultPercentilePtPart1,
+                    kMultPercentilePtPart2,
+                    kPtPart1PtPart2,
+                    kNPairHists2D };
+  std::array<std::array<std::shared_ptr<TH1>, kNPairHists1D>, o2::aod::femtodreamMCparticle::MCType::kNMCTypes> mPairHists1D{};
+  std::array<std::array<std::shared_ptr<TH2>, kNPairHists2D>, o2::aod::femtodreamMCparticle::MCType::kNMCTypes> mPairHists2D{};
+
+  /// Handles of relPairkstarmTMultMultPercentile and relPairkstarmTPtPart1PtPart2MultPercentile per MC type
+  std::array<std::array<std::shared_ptr<THnBase>, 2>, o2::aod::femtodreamMCparticle::MCType::kNMCTypes> mHighDimHists{};
+
+  std::shared_ptr<THnBase> addHighDimHist(const char* name, const char* title, const std::vector<framework::AxisSpec>& axes)
+  {
+    if (mDenseHighDimPlots) {
+      long bins = 1;
+      for (const auto& axis : axes) {
+        bins *= axis.getNbins() + 2;
+      }
+      LOGF(info, "Creating dense %s with %ld bins (approx. %ld MB of memory)", name, bins, bins * 4 / 1024 / 1024);
+      return mHistogramRegistry->add<THn>(name, title, kTHnF, axes);
+    }
+    return mHistogramRegistry->add<THnSparse>(name, title, kTHnSparseF, axes);
+  }
 };
 
 } // namespace o2::analysis::femtoDream
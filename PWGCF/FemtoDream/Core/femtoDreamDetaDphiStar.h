@@ -16,6 +16,9 @@
 #ifndef PWGCF_FEMTODREAM_CORE_FEMTODREAMDETADPHISTAR_H_
 #define PWGCF_FEMTODREAM_CORE_FEMTODREAMDETADPHISTAR_H_
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <memory>
 #include <string>
 #include <vector>
@@ -63,6 +66,7 @@ class FemtoDreamDetaDphiStar
     atWhichRadiiToSelect = atWhichRadiiToCut;
     radiiTPC = radiiTPCtoCut;
     fillQA = fillTHSparse;
+    phiStarCache = PhiStarCache{};
 
     if constexpr (mPartOneType == o2::aod::femtodreamparticle::ParticleType::kTrack && (mPartTwoType == o2::aod::femtodreamparticle::ParticleType::kTrack || mPartTwoType == o2::aod::femtodreamparticle::ParticleType::kCascadeV0Child || mPartTwoType == o2::aod::femtodreamparticle::ParticleType::kCascadeBachelor)) {
       std::string dirName = static_cast<std::string>(dirNames[0]);
@@ -151,7 +155,7 @@ class FemtoDreamDetaDphiStar
       }
       auto deta = part1.eta() - part2.eta();
       auto dphi_AT_PV = part1.phi() - part2.phi();
-      auto dphi_AT_SpecificRadii = PhiAtSpecificRadiiTPC(part1, radiiTPC) - PhiAtSpecificRadiiTPC(part2, radiiTPC);
+      auto dphi_AT_SpecificRadii = CachedPhiAtSpecificRadiiTPC(part1) - CachedPhiAtSpecificRadiiTPC(part2);
       bool sameCharge = false;
       auto dphiAvg = AveragePhiStar(part1, part2, 0, &sameCharge);
       if (Q3 == 999) {
@@ -235,7 +239,7 @@ class FemtoDreamDetaDphiStar
         auto daughter = particles.begin() + indexOfDaughter;
         auto deta = part1.eta() - daughter.eta();
         auto dphi_AT_PV = part1.phi() - daughter.phi();
-        auto dphi_AT_SpecificRadii = PhiAtSpecificRadiiTPC(part1, radiiTPC) - PhiAtSpecificRadiiTPC(daughter, radiiTPC);
+        auto dphi_AT_SpecificRadii = CachedPhiAtSpecificRadiiTPC(part1) - CachedPhiAtSpecificRadiiTPC(*daughter);
         bool sameCharge = false;
         auto dphiAvg = AveragePhiStar(part1, *daughter, i, &sameCharge);
         if (Q3 == 999) {
@@ -315,7 +319,7 @@ class FemtoDreamDetaDphiStar
             daughterPhi = part2.prong0Phi();
             deta = part1.eta() - daughterEta;
             dphi_AT_PV = part1.phi() - daughterPhi;
-            dphi_AT_SpecificRadii = PhiAtSpecificRadiiTPC(part1, radiiTPC) - PhiAtSpecificRadiiTPC<true, 0>(part2, radiiTPC);
+            dphi_AT_SpecificRadii = CachedPhiAtSpecificRadiiTPC(part1) - PhiAtSpecificRadiiTPC<true, 0>(part2, radiiTPC);
             dphiAvg = AveragePhiStar<true>(part1, part2, 0, &sameCharge);
             // histdetadpi[0][0]->Fill(deta, dphiAvg);
             break;
@@ -324,7 +328,7 @@ class FemtoDreamDetaDphiStar
             daughterPhi = part2.prong1Phi();
             deta = part1.eta() - daughterEta;
             dphi_AT_PV = part1.phi() - daughterPhi;
-            dphi_AT_SpecificRadii = PhiAtSpecificRadiiTPC(part1, radiiTPC) - PhiAtSpecificRadiiTPC<true, 1>(part2, radiiTPC);
+            dphi_AT_SpecificRadii = CachedPhiAtSpecificRadiiTPC(part1) - PhiAtSpecificRadiiTPC<true, 1>(part2, radiiTPC);
             dphiAvg = AveragePhiStar<true>(part1, part2, 1, &sameCharge);
             // histdetadpi[1][0]->Fill(deta, dphiAvg);
             break;
@@ -333,7 +337,7 @@ class FemtoDreamDetaDphiStar
             daughterPhi = part2.prong2Phi();
             deta = part1.eta() - daughterEta;
             dphi_AT_PV = part1.phi() - daughterPhi;
-            dphi_AT_SpecificRadii = PhiAtSpecificRadiiTPC(part1, radiiTPC) - PhiAtSpecificRadiiTPC<true, 2>(part2, radiiTPC);
+            dphi_AT_SpecificRadii = CachedPhiAtSpecificRadiiTPC(part1) - PhiAtSpecificRadiiTPC<true, 2>(part2, radiiTPC);
             dphiAvg = AveragePhiStar<true>(part1, part2, 2, &sameCharge);
             // histdetadpi[2][0]->Fill(deta, dphiAvg);
             break;
@@ -414,7 +418,7 @@ class FemtoDreamDetaDphiStar
         auto daughter = particles.begin() + indexOfDaughter;
         auto deta = part1.eta() - daughter.eta();
         auto dphi_AT_PV = part1.phi() - daughter.phi();
-        auto dphi_AT_SpecificRadii = PhiAtSpecificRadiiTPC(part1, radiiTPC) - PhiAtSpecificRadiiTPC(daughter, radiiTPC);
+        auto dphi_AT_SpecificRadii = CachedPhiAtSpecificRadiiTPC(part1) - CachedPhiAtSpecificRadiiTPC(*daughter);
         bool sameCharge = false;
         auto dphiAvg = AveragePhiStar(part1, *daughter, i, &sameCharge);
         if (Q3 == 999) {
@@ -531,6 +535,19 @@ class FemtoDreamDetaDphiStar
   std::array<std::shared_ptr<THnSparse>, 3> histdetadpi_eta{};
   std::array<std::shared_ptr<THnSparse>, 3> histdetadpi_phi{};
 
+  /// Per-particle cache of phi* (SoA, indexed by globalIndex), so that the propagation is done once per particle and not for every pair
+  /// An entry is valid as long as pt, phi and magnetic field match the particle it is requested for
+  static constexpr int kNRadiiTPC = 9;             ///< number of radii in tmpRadiiTPC
+  static constexpr int kNPhiStar = kNRadiiTPC + 1; ///< phi* at tmpRadiiTPC and at radiiTPC
+  struct PhiStarCache {
+    std::vector<float> pt;
+    std::vector<float> phi;
+    std::vector<float> magField;
+    std::vector<int> charge;
+    std::vector<float> phiStar; ///< kNPhiStar entries per particle
+  };
+  PhiStarCache phiStarCache;
+
   ///  Calculate phi at all required radii stored in tmpRadiiTPC
   /// Magnetic field to be provided in Tesla
   template <typename T>
@@ -568,6 +585,43 @@ class FemtoDreamDetaDphiStar
     return charge;
   }
 
+  /// Fill the phi* cache for a particle if needed
+  /// \return offset of the phi* values of the particle in phiStarCache.phiStar
+  template <typename T>
+  size_t CachePhiStar(const T& part, int& charge)
+  {
+    const size_t index = part.globalIndex();
+    if (index >= phiStarCache.pt.size()) {
+      const size_t size = std::max(index + 1, 2 * phiStarCache.pt.size());
+      phiStarCache.pt.resize(size, std::numeric_limits<float>::quiet_NaN());
+      phiStarCache.phi.resize(size);
+      phiStarCache.magField.resize(size);
+      phiStarCache.charge.resize(size);
+      phiStarCache.phiStar.resize(size * kNPhiStar);
+    }
+    const size_t offset = index * kNPhiStar;
+    if (phiStarCache.pt[index] == part.pt() && phiStarCache.phi[index] == part.phi() && phiStarCache.magField[index] == magfield) {
+      charge = phiStarCache.charge[index];
+      return offset;
+    }
+    std::vector<float> tmpVec;
+    charge = PhiAtRadiiTPC(part, tmpVec);
+    std::copy(tmpVec.begin(), tmpVec.end(), phiStarCache.phiStar.begin() + offset);
+    phiStarCache.phiStar[offset + kNRadiiTPC] = PhiAtSpecificRadiiTPC(part, radiiTPC);
+    phiStarCache.pt[index] = part.pt();
+    phiStarCache.phi[index] = part.phi();
+    phiStarCache.magField[index] = magfield;
+    phiStarCache.charge[index] = charge;
+    return offset;
+  }
+
+  template <typename T>
+  float CachedPhiAtSpecificRadiiTPC(const T& part)
+  {
+    int charge = 0;
+    return phiStarCache.phiStar[CachePhiStar(part, charge) + kNRadiiTPC];
+  }
+
   ///  Calculate phi at specific radii
   /// Magnetic field to be provided in Tesla
   template <bool isHF = false, int prong = 0, typename T>
@@ -675,11 +729,13 @@ class FemtoDreamDetaDphiStar
   template <bool isHF = false, typename T1, typename T2>
   float AveragePhiStar(const T1& part1, const T2& part2, int iHist, bool* sameCharge)
   {
-    std::vector<float> tmpVec1;
+    int charge1 = 0;
+    const size_t offset1 = CachePhiStar(part1, charge1);
+    size_t offset2 = 0;
     std::vector<float> tmpVec2;
-    auto charge1 = PhiAtRadiiTPC(part1, tmpVec1);
     if constexpr (!isHF) {
-      auto charge2 = PhiAtRadiiTPC(part2, tmpVec2);
+      int charge2 = 0;
+      offset2 = CachePhiStar(part2, charge2);
       if (charge1 == charge2) {
         *sameCharge = true;
       }
@@ -687,13 +743,16 @@ class FemtoDreamDetaDphiStar
       PhiAtRadiiTPCForHF(part2, tmpVec2, iHist);
       *sameCharge = true; // always true as we checked the condition in the HF task
     }
-    int num = tmpVec1.size();
+    // pointers are taken after both cache look-ups, which may reallocate the cache
+    const float* phiStar1 = phiStarCache.phiStar.data() + offset1;
+    const float* phiStar2 = isHF ? tmpVec2.data() : phiStarCache.phiStar.data() + offset2;
+    int num = kNRadiiTPC;
     int meaningfulEntries = num;
     float dPhiAvg = 0;
     float dphi;
     for (int i = 0; i < num; i++) {
-      if (tmpVec1.at(i) != 999 && tmpVec2.at(i) != 999) {
-        dphi = tmpVec1.at(i) - tmpVec2.at(i);
+      if (phiStar1[i] != 999 && phiStar2[i] != 999) {
+        dphi = phiStar1[i] - phiStar2[i];
       } else {
         dphi = 0;
         meaningfulEntries = meaningfulEntries - 1;
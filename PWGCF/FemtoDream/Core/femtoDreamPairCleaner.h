@@ -16,6 +16,10 @@
 #ifndef PWGCF_FEMTODREAM_CORE_FEMTODREAMPAIRCLEANER_H_
 #define PWGCF_FEMTODREAM_CORE_FEMTODREAMPAIRCLEANER_H_
 
+#include <algorithm>
+#include <array>
+#include <vector>
+
 #include "PWGCF/DataModel/FemtoDerived.h"
 #include "Framework/HistogramRegistry.h"
 
@@ -45,6 +49,33 @@ class FemtoDreamPairCleaner
     }
   }
 
+  /// Store the constituents of the V0 or cascade candidates of the current event, so that isCleanPair
+  /// does not need to access their children for every pair. To be called for every event, or never
+  /// \tparam Candidates Data type of the candidates (partTwo) of the event
+  /// \tparam Parts Data type of the collection of all particles
+  /// \param candidates Candidates of the event
+  /// \param particles Collection of all particles passed to the task
+  template <typename Candidates, typename Parts>
+  void setEventCandidates(Candidates const& candidates, Parts const& particles)
+  {
+    mConstituents.clear();
+    if constexpr (mPartTwoType == o2::aod::femtodreamparticle::ParticleType::kV0 || mPartTwoType == o2::aod::femtodreamparticle::ParticleType::kCascade) {
+      if (candidates.size() == 0) {
+        return;
+      }
+      int64_t lastRow = 0;
+      mFirstCandidateRow = candidates.begin().index();
+      for (auto const& candidate : candidates) {
+        mFirstCandidateRow = std::min<int64_t>(mFirstCandidateRow, candidate.index());
+        lastRow = std::max<int64_t>(lastRow, candidate.index());
+      }
+      mConstituents.assign(lastRow - mFirstCandidateRow + 1, Constituents{kNoConstituent, kNoConstituent, kNoConstituent});
+      for (auto const& candidate : candidates) {
+        mConstituents[candidate.index() - mFirstCandidateRow] = readConstituents(candidate, particles);
+      }
+    }
+  }
+
   /// Check whether a given pair has shared tracks
   /// \tparam Part Data type of the particle
   /// \tparam Parts Data type of the collection of all particles
@@ -68,12 +99,7 @@ class FemtoDreamPairCleaner
         LOG(fatal) << "FemtoDreamPairCleaner: passed arguments don't agree with FemtoDreamPairCleaner instantiation! Please provide second argument kV0 candidate.";
         return false;
       }
-      const auto& posChild = particles.iteratorAt(part2.index() - 2);
-      const auto& negChild = particles.iteratorAt(part2.index() - 1);
-      if (part1.index() != posChild.childrenIds()[0] && part1.index() != negChild.childrenIds()[1]) {
-        return true;
-      }
-      return false;
+      return !isConstituent(part1.index(), getConstituents(part2, particles));
     } else if constexpr (mPartOneType == o2::aod::femtodreamparticle::ParticleType::kTrack && mPartTwoType == o2::aod::femtodreamparticle::ParticleType::kCharmHadron) {
       /// Track-CharmHadron combination
       if (part2.candidateSelFlag() < o2::aod::fdhf::lcToPKPi) {
@@ -91,13 +117,7 @@ class FemtoDreamPairCleaner
         LOG(fatal) << "FemtoDreamPairCleaner: passed arguments don't agree with FemtoDreamPairCleaner instantiation! Please provide second argument kCascade candidate.";
         return false;
       }
-      const auto& posChild = particles.iteratorAt(part2.index() - 3);
-      const auto& negChild = particles.iteratorAt(part2.index() - 2);
-      const auto& bachChild = particles.iteratorAt(part2.index() - 1);
-      if (part1.index() != posChild.childrenIds()[0] && part1.index() != negChild.childrenIds()[1] && part1.index() != bachChild.childrenIds()[2]) {
-        return true;
-      }
-      return false;
+      return !isConstituent(part1.index(), getConstituents(part2, particles));
     } else {
       LOG(fatal) << "FemtoDreamPairCleaner: Combination of objects not defined - quitting!";
       return false;
@@ -105,6 +125,37 @@ class FemtoDreamPairCleaner
   }
 
  private:
+  using Constituents = std::array<int, 3>; ///< Rows of the tracks stored as children of a V0 or cascade candidate
+  static constexpr int kNoConstituent = -1;
+
+  /// Children rows of a V0 or a cascade, which are stored right before the candidate
+  template <typename Part, typename Parts>
+  static Constituents readConstituents(Part const& part, Parts const& particles)
+  {
+    if constexpr (mPartTwoType == o2::aod::femtodreamparticle::ParticleType::kCascade) {
+      return {particles.iteratorAt(part.index() - 3).childrenIds()[0], particles.iteratorAt(part.index() - 2).childrenIds()[1], particles.iteratorAt(part.index() - 1).childrenIds()[2]};
+    } else {
+      return {particles.iteratorAt(part.index() - 2).childrenIds()[0], particles.iteratorAt(part.index() - 1).childrenIds()[1], kNoConstituent};
+    }
+  }
+
+  template <typename Part, typename Parts>
+  Constituents getConstituents(Part const& part, Parts const& particles) const
+  {
+    const int64_t iCandidate = part.index() - mFirstCandidateRow;
+    if (iCandidate >= 0 && iCandidate < static_cast<int64_t>(mConstituents.size()) && mConstituents[iCandidate][0] != kNoConstituent) {
+      return mConstituents[iCandidate];
+    }
+    return readConstituents(part, particles);
+  }
+
+  static bool isConstituent(int64_t row, Constituents const& constituents)
+  {
+    return (row == constituents[0]) | (row == constituents[1]) | (row == constituents[2]);
+  }
+
+  std::vector<Constituents> mConstituents; ///< Constituents of the candidates of the current event, by row - mFirstCandidateRow
+  int64_t mFirstCandidateRow = 0;
   HistogramRegistry* mHistogramRegistry;                                             ///< For QA output
   static constexpr o2::aod::femtodreamparticle::ParticleType mPartOneType = partOne; ///< Type of particle 1
   static constexpr o2::aod::femtodreamparticle::ParticleType mPartTwoType = partTwo; ///< Type of particle 2
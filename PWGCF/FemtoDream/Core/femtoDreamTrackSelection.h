@@ -17,6 +17,7 @@
 #ifndef PWGCF_FEMTODREAM_CORE_FEMTODREAMTRACKSELECTION_H_
 #define PWGCF_FEMTODREAM_CORE_FEMTODREAMTRACKSELECTION_H_
 
+#include <array>
 #include <string>
 #include <vector>
 #include <cmath>
@@ -113,6 +114,9 @@ class FemtoDreamTrackSelection : public FemtoDreamObjectSelection<float, femtoDr
     for (o2::track::PID pid : tmpPids) {
       mPIDspecies.push_back(pid);
     }
+    mPIDnSigmaTPC.resize(mPIDspecies.size());
+    mPIDnSigmaComb.resize(mPIDspecies.size());
+    mPIDnSigmaITS.resize(mPIDspecies.size());
   }
 
   /// Computes the n_sigma for a track and a particle-type hypothesis in the TPC
@@ -256,6 +260,9 @@ class FemtoDreamTrackSelection : public FemtoDreamObjectSelection<float, femtoDr
   float nSigmaPIDOffsetTPC;
   float nSigmaPIDOffsetTOF;
   std::vector<o2::track::PID> mPIDspecies; ///< All the particle species for which the n_sigma values need to be stored
+  std::vector<float> mPIDnSigmaTPC;        ///< Per-species n_sigma TPC of the current track, after offset; sized in setPIDSpecies to avoid allocations per track
+  std::vector<float> mPIDnSigmaComb;       ///< Per-species combined TPC+TOF n_sigma of the current track, after offsets
+  std::vector<float> mPIDnSigmaITS;        ///< Per-species n_sigma ITS of the current track
   static constexpr int kNtrackSelection = 14;
   static constexpr std::string_view mSelectionNames[kNtrackSelection] = {"Sign",
                                                                          "PtMin",
@@ -436,11 +443,6 @@ bool FemtoDreamTrackSelection::isSelectedMinimal(T const& track)
   const auto dcaZ = track.dcaZ();
   const auto dca = track.dcaXY(); // Accordingly to FemtoDream in AliPhysics  as well as LF analysis,
                                   // only dcaXY should be checked; NOT std::sqrt(pow(dcaXY, 2.) + pow(dcaZ, 2.))
-  std::vector<float> pidTPC, pidTOF;
-  for (auto it : mPIDspecies) {
-    pidTPC.push_back(getNsigmaTPC(track, it));
-    pidTOF.push_back(getNsigmaTOF(track, it));
-  }
 
   if (nPtMinSel > 0 && pT < pTMin) {
     return false;
@@ -484,8 +486,8 @@ bool FemtoDreamTrackSelection::isSelectedMinimal(T const& track)
 
   if (nPIDnSigmaSel > 0) {
     bool isFulfilled = false;
-    for (size_t i = 0; i < pidTPC.size(); ++i) {
-      auto pidTPCVal = pidTPC.at(i);
+    for (auto it : mPIDspecies) {
+      auto pidTPCVal = getNsigmaTPC(track, it);
       if (std::fabs(pidTPCVal - nSigmaPIDOffsetTPC) < nSigmaPIDMax) {
         isFulfilled = true;
       }
@@ -503,88 +505,47 @@ std::array<cutContainerType, 2> FemtoDreamTrackSelection::getCutContainer(T cons
   cutContainerType output = 0;
   size_t counter = 0;
   cutContainerType outputPID = 0;
-  const auto sign = track.sign();
-  const auto pt = Pt;
-  const auto eta = Eta;
-  const auto tpcNClsF = track.tpcNClsFound();
-  const auto tpcRClsC = track.tpcCrossedRowsOverFindableCls();
-  const auto tpcNClsC = track.tpcNClsCrossedRows();
-  const auto tpcNClsS = track.tpcNClsShared();
-  const auto itsNCls = track.itsNCls();
-  const auto itsNClsIB = track.itsNClsInnerBarrel();
-  const auto dcaXY = track.dcaXY();
-  const auto dcaZ = track.dcaZ();
-  const auto dca = Dca;
-
-  std::vector<float> pidTPC, pidTOF, pidITS;
-  for (auto it : mPIDspecies) {
-    pidTPC.push_back(getNsigmaTPC(track, it));
-    pidTOF.push_back(getNsigmaTOF(track, it));
+  /// Observables indexed by the selection variable, so that each selection is evaluated without dispatching on its type
+  std::array<float, kNtrackSelection> observables{};
+  observables[femtoDreamTrackSelection::kSign] = track.sign();
+  observables[femtoDreamTrackSelection::kpTMin] = Pt;
+  observables[femtoDreamTrackSelection::kpTMax] = Pt;
+  observables[femtoDreamTrackSelection::kEtaMax] = Eta;
+  observables[femtoDreamTrackSelection::kTPCnClsMin] = track.tpcNClsFound();
+  observables[femtoDreamTrackSelection::kTPCfClsMin] = track.tpcCrossedRowsOverFindableCls();
+  observables[femtoDreamTrackSelection::kTPCcRowsMin] = track.tpcNClsCrossedRows();
+  observables[femtoDreamTrackSelection::kTPCsClsMax] = track.tpcNClsShared();
+  observables[femtoDreamTrackSelection::kITSnClsMin] = track.itsNCls();
+  observables[femtoDreamTrackSelection::kITSnClsIbMin] = track.itsNClsInnerBarrel();
+  observables[femtoDreamTrackSelection::kDCAxyMax] = track.dcaXY();
+  observables[femtoDreamTrackSelection::kDCAzMax] = track.dcaZ();
+  observables[femtoDreamTrackSelection::kDCAMin] = Dca;
+
+  /// The n_sigma of each species are computed once, whatever the number of PID selections
+  for (size_t i = 0; i < mPIDspecies.size(); ++i) {
+    const float pidTPCVal = getNsigmaTPC(track, mPIDspecies[i]) - nSigmaPIDOffsetTPC;
+    const float pidTOFVal = getNsigmaTOF(track, mPIDspecies[i]) - nSigmaPIDOffsetTOF;
+    mPIDnSigmaTPC[i] = pidTPCVal;
+    mPIDnSigmaComb[i] = std::sqrt(pidTPCVal * pidTPCVal + pidTOFVal * pidTOFVal);
     if constexpr (useItsPid) {
-      pidITS.push_back(getNsigmaITS(track, it));
+      mPIDnSigmaITS[i] = getNsigmaITS(track, mPIDspecies[i]);
     }
   }
 
-  float observable = 0.;
   for (auto& sel : mSelections) {
     const auto selVariable = sel.getSelectionVariable();
     if (selVariable == femtoDreamTrackSelection::kPIDnSigmaMax) {
-      /// PID needsgetNsigmaITSto be handled a bit differently since we may need more than one species
+      /// PID needs to be handled a bit differently since we may need more than one species
       for (size_t i = 0; i < mPIDspecies.size(); ++i) {
-        auto pidTPCVal = pidTPC.at(i) - nSigmaPIDOffsetTPC;
-        auto pidTOFVal = pidTOF.at(i) - nSigmaPIDOffsetTOF;
-        auto pidComb = std::sqrt(pidTPCVal * pidTPCVal + pidTOFVal * pidTOFVal);
-        sel.checkSelectionSetBitPID(pidTPCVal, outputPID);
-        sel.checkSelectionSetBitPID(pidComb, outputPID);
+        sel.checkSelectionSetBitPID(mPIDnSigmaTPC[i], outputPID);
+        sel.checkSelectionSetBitPID(mPIDnSigmaComb[i], outputPID);
         if constexpr (useItsPid) {
-          auto pidITSVal = pidITS.at(i);
-          sel.checkSelectionSetBitPID(pidITSVal, outputPID);
+          sel.checkSelectionSetBitPID(mPIDnSigmaITS[i], outputPID);
         }
       }
     } else {
       /// for the rest it's all the same
-      switch (selVariable) {
-        case (femtoDreamTrackSelection::kSign):
-          observable = sign;
-          break;
-        case (femtoDreamTrackSelection::kpTMin):
-        case (femtoDreamTrackSelection::kpTMax):
-          observable = pt;
-          break;
-        case (femtoDreamTrackSelection::kEtaMax):
-          observable = eta;
-          break;
-        case (femtoDreamTrackSelection::kTPCnClsMin):
-          observable = tpcNClsF;
-          break;
-        case (femtoDreamTrackSelection::kTPCfClsMin):
-          observable = tpcRClsC;
-          break;
-        case (femtoDreamTrackSelection::kTPCcRowsMin):
-          observable = tpcNClsC;
-          break;
-        case (femtoDreamTrackSelection::kTPCsClsMax):
-          observable = tpcNClsS;
-          break;
-        case (femtoDreamTrackSelection::kITSnClsMin):
-          observable = itsNCls;
-          break;
-        case (femtoDreamTrackSelection::kITSnClsIbMin):
-          observable = itsNClsIB;
-          break;
-        case (femtoDreamTrackSelection::kDCAxyMax):
-          observable = dcaXY;
-          break;
-        case (femtoDreamTrackSelection::kDCAzMax):
-          observable = dcaZ;
-          break;
-        case (femtoDreamTrackSelection::kDCAMin):
-          observable = dca;
-          break;
-        case (femtoDreamTrackSelection::kPIDnSigmaMax):
-          break;
-      }
-      sel.checkSelectionSetBit(observable, output, counter, mHistogramRegistry);
+      sel.checkSelectionSetBit(observables[selVariable], output, counter, mHistogramRegistry);
     }
   }
   return {output, outputPID};
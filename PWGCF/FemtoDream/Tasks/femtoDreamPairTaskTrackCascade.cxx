@@ -260,6 +260,7 @@ struct femtoDreamPairTaskTrackCascade {
       bachChildHistos.fillQA<false, false>(bachChild, aod::femtodreamparticle::kPt, col.multNtr(), col.multV0M());
     }
     /// Now build particle combinations
+    pairCleaner.setEventCandidates(SliceCascade2, parts);
     for (auto const& [p1, p2] : combinations(CombinationsFullIndexPolicy(SliceTrk1, SliceCascade2))) {
       const auto& posChild = parts.iteratorAt(p2.index() - 3);
       const auto& negChild = parts.iteratorAt(p2.index() - 2);
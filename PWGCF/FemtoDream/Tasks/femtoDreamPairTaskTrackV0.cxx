@@ -331,6 +331,7 @@ struct femtoDreamPairTaskTrackV0 {
       }
     }
     /// Now build particle combinations
+    pairCleaner.setEventCandidates(SliceV02, parts);
     for (auto const& [p1, p2] : combinations(CombinationsFullIndexPolicy(SliceTrk1, SliceV02))) {
       const auto& posChild = parts.iteratorAt(p2.index() - 2);
       const auto& negChild = parts.iteratorAt(p2.index() - 1);
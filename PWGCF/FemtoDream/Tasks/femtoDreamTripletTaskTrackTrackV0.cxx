@@ -324,6 +324,7 @@ struct femtoDreamTripletTaskTrackTrackV0 {
     }
 
     /// Now build the combinations
+    pairCleanerTrackV0.setEventCandidates(groupSelectedV0s, parts);
     for (auto& V0 : groupSelectedV0s) {
       const auto& posChild = parts.iteratorAt(V0.index() - 2);
       const auto& negChild = parts.iteratorAt(V0.index() - 1);
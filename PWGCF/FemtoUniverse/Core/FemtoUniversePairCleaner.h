@@ -22,6 +22,8 @@
 #include "PWGCF/FemtoUniverse/DataModel/FemtoDerived.h"
 #include "Framework/HistogramRegistry.h"
 
+#include <cstdint>
+
 namespace o2::analysis::femto_universe
 {
 
@@ -76,28 +78,15 @@ class FemtoUniversePairCleaner
         LOG(fatal) << "FemtoUniversePairCleaner: passed arguments don't agree with FemtoUniversePairCleaner instantiation! Please provide second argument kV0 candidate.";
         return false;
       }
-      // Getting v0 (part2) children
-      const auto& posChild = particles.iteratorAt(part2.index() - 2);
-      const auto& negChild = particles.iteratorAt(part2.index() - 1);
-      if (part1.globalIndex() == posChild.globalIndex() || part1.globalIndex() == negChild.globalIndex()) {
-        return false;
-      }
-      return part1.globalIndex() != part2.globalIndex();
+      // v0 (part2) children
+      return !isChild<2>(part1.globalIndex(), part2, particles) && part1.globalIndex() != part2.globalIndex();
     } else if constexpr (kPartOneType == o2::aod::femtouniverseparticle::ParticleType::kV0 && kPartTwoType == o2::aod::femtouniverseparticle::ParticleType::kV0) {
       /// V0-V0 combination both part1 and part2 are v0
       if (part1.partType() != o2::aod::femtouniverseparticle::ParticleType::kV0 || part2.partType() != o2::aod::femtouniverseparticle::ParticleType::kV0) {
         LOG(fatal) << "FemtoUniversePairCleaner: passed arguments don't agree with FemtoUniversePairCleaner instantiation! Please provide first and second arguments kV0 candidate.";
         return false;
       }
-      // Getting v0 children for part1
-      const auto& posChild1 = particles.iteratorAt(part1.index() - 2);
-      const auto& negChild1 = particles.iteratorAt(part1.index() - 1);
-      // Getting v0 children for part2
-      const auto& posChild2 = particles.iteratorAt(part2.index() - 2);
-      const auto& negChild2 = particles.iteratorAt(part2.index() - 1);
-      if (posChild1.globalIndex() == posChild2.globalIndex() || negChild1.globalIndex() == negChild2.globalIndex()) {
-        return false;
-      }
+      // the children are at the same offset from their mothers, they are the same only if the v0s are the same
       return part1.globalIndex() != part2.globalIndex();
     } else if constexpr (kPartOneType == o2::aod::femtouniverseparticle::ParticleType::kTrack && kPartTwoType == o2::aod::femtouniverseparticle::ParticleType::kCascade) {
       /// Track-Cascade combination part1 is hadron and part2 is cascade
@@ -105,31 +94,15 @@ class FemtoUniversePairCleaner
         LOG(fatal) << "FemtoUniversePairCleaner: passed arguments don't agree with FemtoUniversePairCleaner instantiation! Please provide first argument kTrack candidate and second argument kCascade candidate.";
         return false;
       }
-      // Getting cascade children for part2
-      const auto& posChild = particles.iteratorAt(part2.index() - 3);
-      const auto& negChild = particles.iteratorAt(part2.index() - 2);
-      const auto& bachelor = particles.iteratorAt(part2.index() - 1);
-      if (part1.globalIndex() == posChild.globalIndex() || part1.globalIndex() == negChild.globalIndex() || part1.globalIndex() == bachelor.globalIndex()) {
-        return false;
-      }
-      return part1.globalIndex() != part2.globalIndex();
+      // cascade (part2) children
+      return !isChild<3>(part1.globalIndex(), part2, particles) && part1.globalIndex() != part2.globalIndex();
     } else if constexpr (kPartOneType == o2::aod::femtouniverseparticle::ParticleType::kCascade && kPartTwoType == o2::aod::femtouniverseparticle::ParticleType::kCascade) {
       /// Cascade-Cascade combination both part1 and part2 are cascades
       if (part1.partType() != o2::aod::femtouniverseparticle::ParticleType::kCascade || part2.partType() != o2::aod::femtouniverseparticle::ParticleType::kCascade) {
         LOG(fatal) << "FemtoUniversePairCleaner: passed arguments don't agree with FemtoUniversePairCleaner instantiation! Please provide first and second arguments kCascade candidate.";
         return false;
       }
-      // Getting cascade children for part1
-      const auto& posChild1 = particles.iteratorAt(part1.index() - 3);
-      const auto& negChild1 = particles.iteratorAt(part1.index() - 2);
-      const auto& bachelor1 = particles.iteratorAt(part1.index() - 1);
-      // Getting cascade children for part2
-      const auto& posChild2 = particles.iteratorAt(part2.index() - 3);
-      const auto& negChild2 = particles.iteratorAt(part2.index() - 2);
-      const auto& bachelor2 = particles.iteratorAt(part2.index() - 1);
-      if (posChild1.globalIndex() == posChild2.globalIndex() || negChild1.globalIndex() == negChild2.globalIndex() || bachelor1.globalIndex() == bachelor2.globalIndex()) {
-        return false;
-      }
+      // the children are at the same offset from their mothers, they are the same only if the cascades are the same
       return part1.globalIndex() != part2.globalIndex();
     } else if constexpr (kPartOneType == o2::aod::femtouniverseparticle::ParticleType::kTrack && kPartTwoType == o2::aod::femtouniverseparticle::ParticleType::kD0) {
       /// Track-D0 combination part1 is hadron and part2 is D0
@@ -137,14 +110,8 @@ class FemtoUniversePairCleaner
         LOG(fatal) << "FemtoUniversePairCleaner: passed arguments don't agree with FemtoUniversePairCleaner instantiation! Please provide second argument kD0 candidate.";
         return false;
       }
-      // Getting D0 (part2) children
-      const auto& posChild = particles.iteratorAt(part2.index() - 2);
-      const auto& negChild = particles.iteratorAt(part2.index() - 1);
-
-      if (part1.globalIndex() != posChild.globalIndex() && part1.globalIndex() != negChild.globalIndex()) {
-        return true;
-      }
-      return false;
+      // D0 (part2) children
+      return !isChild<2>(part1.globalIndex(), part2, particles);
     } else if constexpr (kPartOneType == o2::aod::femtouniverseparticle::ParticleType::kTrack && kPartTwoType == o2::aod::femtouniverseparticle::ParticleType::kPhi) {
       /// Track-Phi combination part1 is Phi and part 2 is hadron
       if (part1.partType() != o2::aod::femtouniverseparticle::ParticleType::kTrack || part2.partType() != o2::aod::femtouniverseparticle::ParticleType::kPhi) {
@@ -152,14 +119,8 @@ class FemtoUniversePairCleaner
         return false;
       }
 
-      // getting Phi (part1) children
-      const auto& posChild = particles.iteratorAt(part2.index() - 2);
-      const auto& negChild = particles.iteratorAt(part2.index() - 1);
-
-      if (part1.globalIndex() != posChild.globalIndex() && part1.globalIndex() != negChild.globalIndex()) {
-        return true;
-      }
-      return false;
+      // Phi (part2) children
+      return !isChild<2>(part1.globalIndex(), part2, particles);
     } else {
       LOG(fatal) << "FemtoUniversePairCleaner: Combination of objects not defined - quitting!";
       return false;
@@ -167,6 +128,15 @@ class FemtoUniversePairCleaner
   }
 
  private:
+  /// Whether globalIndex is one of the nChildren children of mother, which are stored right before it:
+  /// their global indices are obtained without building the rows of the children
+  template <int nChildren, typename Part, typename Parts>
+  static bool isChild(int64_t globalIndex, Part const& mother, Parts const& particles)
+  {
+    const int64_t firstChild = particles.offset() + mother.index() - nChildren; // global index of particles.iteratorAt(mother.index() - nChildren)
+    return globalIndex >= firstChild && globalIndex < firstChild + nChildren;
+  }
+
   HistogramRegistry* mHistogramRegistry;                                                ///< For QA output
   static constexpr o2::aod::femtouniverseparticle::ParticleType kPartOneType = partOne; ///< Type of particle 1
   static constexpr o2::aod::femtouniverseparticle::ParticleType kPartTwoType = partTwo; ///< Type of particle 2
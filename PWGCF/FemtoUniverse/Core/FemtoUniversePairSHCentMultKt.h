@@ -20,6 +20,7 @@
 #include <string>
 #include <complex>
 #include <memory>
+#include <array>
 #include "Framework/HistogramRegistry.h"
 
 // using namespace o2::constants::physics;
@@ -248,7 +249,6 @@ class PairSHCentMultKt
   {
     int fMultBin = multval;
     int fKtBin = ktval;
-    std::vector<std::complex<double>> fYlmBuffer(kMaxJM);
     std::vector<double> f3d;
     setPionPairMass();
     f3d = FemtoUniverseMath::newpairfunc(part1, mMassOne, part2, mMassTwo,
@@ -263,8 +263,7 @@ class PairSHCentMultKt
     // int nqbin = fbinctn[0][0]->GetXaxis()->FindFixBin(kv);
     // int nqbinnotfix = fbinctn[0][0]->GetXaxis()->FindBin(kv);
 
-    FemtoUniverseSpherHarMath kYlm;
-    kYlm.doYlmUpToL(kMaxL, qout, qside, qlong, fYlmBuffer.data());
+    fYlm.doYlmUpToL(kMaxL, qout, qside, qlong, fYlmBuffer.data());
 
     if (ChosenEventType == femto_universe_sh_container::EventType::same) {
       for (int ihist = 0; ihist < kMaxJM; ihist++) {
@@ -272,39 +271,42 @@ class PairSHCentMultKt
         fnumsimag[fMultBin][fKtBin][ihist]->Fill(kv, -imag(fYlmBuffer[ihist]));
         fbinctn[fMultBin][fKtBin]->Fill(kv, 1.0);
       }
-      for (int ilmzero = 0; ilmzero < kMaxJM * 2; ilmzero++) {
-        for (int ilmprim = 0; ilmprim < kMaxJM * 2; ilmprim++) {
-          if ((ilmzero % 2) == 0 && (ilmprim % 2) == 0) {
-            fcovnum[fMultBin][fKtBin]->Fill(kv, ilmzero, ilmprim, (real(fYlmBuffer[ilmzero / 2]) * real(fYlmBuffer[ilmprim / 2])));
-          } else if ((ilmzero % 2) == 0 && (ilmprim % 2) == 1) {
-            fcovnum[fMultBin][fKtBin]->Fill(kv, ilmzero, ilmprim, (real(fYlmBuffer[ilmzero / 2]) * -imag(fYlmBuffer[ilmprim / 2])));
-          } else if ((ilmzero % 2) == 1 && (ilmprim % 2) == 0) {
-            fcovnum[fMultBin][fKtBin]->Fill(kv, ilmzero, ilmprim, (-imag(fYlmBuffer[ilmzero / 2]) * real(fYlmBuffer[ilmprim / 2])));
-          } else if ((ilmzero % 2) == 1 && (ilmprim % 2) == 1) {
-            fcovnum[fMultBin][fKtBin]->Fill(kv, ilmzero, ilmprim, (-imag(fYlmBuffer[ilmzero / 2]) * -imag(fYlmBuffer[ilmprim / 2])));
-          }
-        }
-      }
+      addCovariance(fcovnum[fMultBin][fKtBin].get(), kv);
     } else if (ChosenEventType == femto_universe_sh_container::EventType::mixed) {
       for (int ihist = 0; ihist < kMaxJM; ihist++) {
         fdensreal[fMultBin][fKtBin][ihist]->Fill(kv, real(fYlmBuffer[ihist]));
         fdensimag[fMultBin][fKtBin][ihist]->Fill(kv, -imag(fYlmBuffer[ihist]));
         fbinctd[fMultBin][fKtBin]->Fill(kv, 1.0);
       }
-      for (int ilmzero = 0; ilmzero < kMaxJM * 2; ilmzero++) {
-        for (int ilmprim = 0; ilmprim < kMaxJM * 2; ilmprim++) {
-          if ((ilmzero % 2) == 0 && (ilmprim % 2) == 0) {
-            fcovden[fMultBin][fKtBin]->Fill(kv, ilmzero, ilmprim, (real(fYlmBuffer[ilmzero / 2]) * real(fYlmBuffer[ilmprim / 2])));
-          } else if ((ilmzero % 2) == 0 && (ilmprim % 2) == 1) {
-            fcovden[fMultBin][fKtBin]->Fill(kv, ilmzero, ilmprim, (real(fYlmBuffer[ilmzero / 2]) * -imag(fYlmBuffer[ilmprim / 2])));
-          } else if ((ilmzero % 2) == 1 && (ilmprim % 2) == 0) {
-            fcovden[fMultBin][fKtBin]->Fill(kv, ilmzero, ilmprim, (-imag(fYlmBuffer[ilmzero / 2]) * real(fYlmBuffer[ilmprim / 2])));
-          } else if ((ilmzero % 2) == 1 && (ilmprim % 2) == 1) {
-            fcovden[fMultBin][fKtBin]->Fill(kv, ilmzero, ilmprim, (-imag(fYlmBuffer[ilmzero / 2]) * -imag(fYlmBuffer[ilmprim / 2])));
-          }
+      addCovariance(fcovden[fMultBin][fKtBin].get(), kv);
+    }
+  }
+
+  /// Function to add the products of the Ylms of the current pair to the covariance histogram
+  /// The y and z bins are ilm + 1, so only the k* bin is looked up and the contents are added directly,
+  /// (the statistics of the histogram are then computed from the bin contents)
+  /// \param hist covariance histogram of the multiplicity and kT bin
+  /// \param kv k* of the pair
+  void addCovariance(TH3* hist, double kv)
+  {
+    std::array<double, kMaxJM * 2> ylmParts;
+    for (int ilm = 0; ilm < kMaxJM; ilm++) {
+      ylmParts[ilm * 2] = real(fYlmBuffer[ilm]);
+      ylmParts[ilm * 2 + 1] = -imag(fYlmBuffer[ilm]);
+    }
+    int nqbin = hist->GetXaxis()->FindBin(kv);
+    double* sumw2 = hist->GetSumw2N() > 0 ? hist->GetSumw2()->GetArray() : nullptr;
+    for (int ilmzero = 0; ilmzero < kMaxJM * 2; ilmzero++) {
+      for (int ilmprim = 0; ilmprim < kMaxJM * 2; ilmprim++) {
+        double weight = ylmParts[ilmzero] * ylmParts[ilmprim];
+        int bin = hist->GetBin(nqbin, ilmzero + 1, ilmprim + 1);
+        hist->AddBinContent(bin, weight);
+        if (sumw2) {
+          sumw2[bin] += weight * weight;
         }
       }
     }
+    hist->SetEntries(hist->GetEntries() + kMaxJM * kMaxJM * 4);
   }
 
   /// Function to fill covariance matrix in 3D histograms
@@ -372,6 +374,9 @@ class PairSHCentMultKt
   std::array<std::array<std::shared_ptr<TH3>, 7>, 4> fcovnum{};
   std::array<std::array<std::shared_ptr<TH3>, 7>, 4> fcovden{};
 
+  FemtoUniverseSpherHarMath fYlm;                        ///< Ylm calculator, with its coefficients set once
+  std::array<std::complex<double>, kMaxJM> fYlmBuffer{}; ///< Ylms of the current pair
+
  protected:
   HistogramRegistry* pairSHCentMultKtRegistry = nullptr;
   static constexpr std::string_view FolderSuffix[2] = {"SameEvent", "MixedEvent"}; ///< Folder naming for the output according to EventType
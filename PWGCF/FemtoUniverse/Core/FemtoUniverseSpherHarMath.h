@@ -18,6 +18,9 @@
 
 #include <vector>
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
 
 #include "Math/Vector4D.h"
 #include "Math/Boost.h"
@@ -32,6 +35,8 @@ namespace o2::analysis::femto_universe
 class FemtoUniverseSpherHarMath
 {
  public:
+  FemtoUniverseSpherHarMath() { initializeYlms(); }
+
   /// Values of various coefficients
   void initializeYlms()
   {
@@ -166,34 +171,68 @@ class FemtoUniverseSpherHarMath
   /// Function to calculate a set of Ylms up to a given l with cartesian input
   void doYlmUpToL(int lmax, double x, double y, double z, std::complex<double>* ylms)
   {
-    double ctheta, phi;
+    double ctheta, cphi, sphi;
+    cosinesOf(x, y, z, ctheta, cphi, sphi);
+    fillYlms(lmax, ctheta, cphi, sphi, ylms);
+  }
+
+  /// Function to calculate a set of Ylms up to a given l with spherical input
+  void doYlmUpToL(int lmax, double ctheta, double phi, std::complex<double>* ylms)
+  {
+    fillYlms(lmax, ctheta, std::cos(phi), std::sin(phi), ylms);
+  }
+
+  /// Function to calculate the Ylms of a block of n vectors given as separate x, y and z arrays
+  /// \param ylms output of (lmax + 1)^2 values per vector, those of the vector i starting at ylms[i * (lmax + 1)^2]
+  void doYlmUpToL(int lmax, int n, const double* x, const double* y, const double* z, std::complex<double>* ylms)
+  {
+    fCthetas.resize(n);
+    fCphis.resize(n);
+    fSphis.resize(n);
+    for (int i = 0; i < n; i++) {
+      cosinesOf(x[i], y[i], z[i], fCthetas[i], fCphis[i], fSphis[i]);
+    }
+    const int nlm = (lmax + 1) * (lmax + 1);
+    for (int i = 0; i < n; i++) {
+      fillYlms(lmax, fCthetas[i], fCphis[i], fSphis[i], ylms + i * nlm);
+    }
+  }
+
+ private:
+  static std::complex<double> fCeiphi(double phi);
 
+  /// cos(theta), cos(phi) and sin(phi) of a vector, phi = 0 on the z axis as for atan2(0, 0)
+  static void cosinesOf(double x, double y, double z, double& ctheta, double& cphi, double& sphi)
+  {
     double r = std::sqrt(x * x + y * y + z * z);
     if (r < 1e-10 || std::fabs(z) < 1e-10)
       ctheta = 0.0;
     else
       ctheta = z / r;
-    phi = std::atan2(y, x);
-    doYlmUpToL(lmax, ctheta, phi, ylms);
+    double rho = std::sqrt(x * x + y * y);
+    if (rho > 0.0) {
+      cphi = x / rho;
+      sphi = y / rho;
+    } else {
+      cphi = 1.0;
+      sphi = 0.0;
+    }
   }
 
-  /// Function to calculate a set of Ylms up to a given l with spherical input
-  void doYlmUpToL(int lmax, double ctheta, double phi, std::complex<double>* ylms)
+  /// Ylms from cos(theta) and e^{i phi}, the e^{i m phi} being obtained by successive products
+  void fillYlms(int lmax, double ctheta, double cphi, double sphi, std::complex<double>* ylms)
   {
     int lcur = 0;
     double lpol;
 
-    double coss[6];
-    double sins[6];
+    std::complex<double> eimphi[6];
+    eimphi[0] = std::complex<double>(cphi, sphi);
+    for (int iter = 1; iter < lmax; iter++) {
+      eimphi[iter] = eimphi[iter - 1] * eimphi[0];
+    }
 
     double lbuf[36];
     legendreUpToYlm(lmax, ctheta, lbuf);
-    initializeYlms();
-
-    for (int iter = 1; iter <= lmax; iter++) {
-      coss[iter - 1] = std::cos(iter * phi);
-      sins[iter - 1] = std::sin(iter * phi);
-    }
 
     ylms[lcur++] = fgPrefactors[0] * lbuf[0] * std::complex<double>(1, 0);
 
@@ -203,19 +242,20 @@ class FemtoUniverseSpherHarMath
       // Im != 0
       for (int im = 1; im <= il; im++) {
         lpol = lbuf[static_cast<int>(fgPlmshift[il]) - im];
-        ylms[lcur + il - im] = fgPrefactors[fgPrefshift[il] - im] * lpol * std::complex<double>(coss[im - 1], -sins[im - 1]);
-        ylms[lcur + il + im] = fgPrefactors[fgPrefshift[il] + im] * lpol * std::complex<double>(coss[im - 1], sins[im - 1]);
+        ylms[lcur + il - im] = fgPrefactors[fgPrefshift[il] - im] * lpol * std::conj(eimphi[im - 1]);
+        ylms[lcur + il + im] = fgPrefactors[fgPrefshift[il] + im] * lpol * eimphi[im - 1];
       }
       lcur += 2 * il + 1;
     }
   }
 
- private:
-  static std::complex<double> fCeiphi(double phi);
-
   std::array<float, 36> fgPrefactors;
   std::array<float, 10> fgPrefshift;
   std::array<float, 10> fgPlmshift;
+
+  std::vector<double> fCthetas; ///< Buffers of the block version of doYlmUpToL
+  std::vector<double> fCphis;
+  std::vector<double> fSphis;
 };
 
 } // namespace o2::analysis::femto_universe
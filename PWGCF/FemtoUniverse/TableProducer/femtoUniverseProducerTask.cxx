@@ -22,7 +22,8 @@
 #include <TPDGCode.h>
 #include <vector>
 #include <algorithm>
-#include <set>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "CommonConstants/PhysicsConstants.h"
 #include "Common/CCDB/ctpRateFetcher.h"
@@ -739,18 +740,16 @@ struct FemtoUniverseProducerTask {
       auto pdgCode2 = kaon2MC.pdgCode();
 
       int phiOrigin = 99;
-      auto motherskaon1MC = kaon1MC.template mothers_as<aod::McParticles>();
-      auto motherskaon2MC = kaon2MC.template mothers_as<aod::McParticles>();
 
       if (std::abs(pdgCode1) == std::abs(321) || std::abs(pdgCode2) == std::abs(-321)) {
-        if ((kaon1MC.isPhysicalPrimary() && kaon2MC.isPhysicalPrimary()) && (!motherskaon1MC.empty() && !motherskaon2MC.empty())) {
-          for (const auto& particleMotherOfNeg : motherskaon1MC) {
-            for (const auto& particleMotherOfPos : motherskaon2MC) {
-              if (particleMotherOfNeg == particleMotherOfPos && particleMotherOfNeg.pdgCode() == 333) {
-                phiOrigin = aod::femtouniverse_mc_particle::ParticleOriginMCTruth::kPrimary;
-              } else {
-                phiOrigin = aod::femtouniverse_mc_particle::ParticleOriginMCTruth::kFake;
-              }
+        if ((kaon1MC.isPhysicalPrimary() && kaon2MC.isPhysicalPrimary()) && (kaon1MC.has_mothers() && kaon2MC.has_mothers())) {
+          // the two kaons must share a phi mother, the mothers of the second kaon are only compared by index
+          const auto motherIdsKaon2 = kaon2MC.mothersIds();
+          phiOrigin = aod::femtouniverse_mc_particle::ParticleOriginMCTruth::kFake;
+          for (const auto& motherOfKaon1 : kaon1MC.template mothers_as<aod::McParticles>()) {
+            if (motherOfKaon1.pdgCode() == 333 && std::find(motherIdsKaon2.begin(), motherIdsKaon2.end(), motherOfKaon1.globalIndex()) != motherIdsKaon2.end()) {
+              phiOrigin = aod::femtouniverse_mc_particle::ParticleOriginMCTruth::kPrimary;
+              break;
             }
           }
         } else {
@@ -1503,45 +1502,42 @@ struct FemtoUniverseProducerTask {
     }
   }
 
+  /// Kaon PID selection of the phi daughters
+  template <typename TrackType>
+  bool isPhiDaughter(TrackType const& track)
+  {
+    if (ConfPhiSelection.confPhiDoLFPID4Kaons) {
+      if (!track.isGlobalTrackWoDCA() || !track.isPVContributor()) {
+        return false;
+      }
+      if (!isKaonNSigmaLF(track.pt(), trackCuts.getNsigmaTPC(track, o2::track::PID::Kaon), trackCuts.getNsigmaTOF(track, o2::track::PID::Kaon), track.hasTOF())) {
+        return false;
+      }
+    } else {
+      if (!isKaonNSigma(track.pt(), trackCuts.getNsigmaTPC(track, o2::track::PID::Kaon), trackCuts.getNsigmaTOF(track, o2::track::PID::Kaon))) {
+        return false;
+      }
+    }
+    return !isKaonRejected(track.p(), trackCuts.getNsigmaTPC(track, o2::track::PID::Proton), trackCuts.getNsigmaTOF(track, o2::track::PID::Proton), trackCuts.getNsigmaTPC(track, o2::track::PID::Pion), trackCuts.getNsigmaTOF(track, o2::track::PID::Pion));
+  }
+
   template <bool isMC, typename TrackType, typename CollisionType>
   void fillPhi(CollisionType const& col, TrackType const& tracks)
   {
     std::vector<int> childIDs = {0, 0}; // these IDs are necessary to keep track of the children
     std::vector<int> tmpIDtrack;        // this vector keeps track of the matching of the primary track table row <-> aod::track table global index
-    // lorentz vectors and filling the tables
-    for (const auto& [p1, p2] : combinations(soa::CombinationsFullIndexPolicy(tracks, tracks))) {
-      if (!trackCuts.isSelectedMinimal(p1) || !trackCuts.isSelectedMinimal(p1)) {
-        continue;
-      }
-      if ((!(p1.sign() == 1)) || (!(p2.sign() == -1))) {
-        continue;
-      }
-      // implementing PID cuts for phi children
-      if (ConfPhiSelection.confPhiDoLFPID4Kaons) {
-        if ((p1.isGlobalTrackWoDCA() == false) || (p2.isGlobalTrackWoDCA() == false) || (p1.isPVContributor() == false) || (p2.isPVContributor() == false)) {
-          continue;
-        }
-        if (!(isKaonNSigmaLF(p1.pt(), trackCuts.getNsigmaTPC(p1, o2::track::PID::Kaon), trackCuts.getNsigmaTOF(p1, o2::track::PID::Kaon), p1.hasTOF()))) {
-          continue;
-        }
-        if (!(isKaonNSigmaLF(p2.pt(), trackCuts.getNsigmaTPC(p2, o2::track::PID::Kaon), trackCuts.getNsigmaTOF(p2, o2::track::PID::Kaon), p2.hasTOF()))) {
-          continue;
-        }
-      } else {
-        if (!(isKaonNSigma(p1.pt(), trackCuts.getNsigmaTPC(p1, o2::track::PID::Kaon), trackCuts.getNsigmaTOF(p1, o2::track::PID::Kaon)))) {
-          continue;
-        }
-        if (!(isKaonNSigma(p2.pt(), trackCuts.getNsigmaTPC(p2, o2::track::PID::Kaon), trackCuts.getNsigmaTOF(p2, o2::track::PID::Kaon)))) {
-          continue;
-        }
-      }
-      if (isKaonRejected(p1.p(), trackCuts.getNsigmaTPC(p1, o2::track::PID::Proton), trackCuts.getNsigmaTOF(p1, o2::track::PID::Proton), trackCuts.getNsigmaTPC(p1, o2::track::PID::Pion), trackCuts.getNsigmaTOF(p1, o2::track::PID::Pion))) {
-        continue;
-      }
-      if (isKaonRejected(p2.p(), trackCuts.getNsigmaTPC(p2, o2::track::PID::Proton), trackCuts.getNsigmaTOF(p2, o2::track::PID::Proton), trackCuts.getNsigmaTPC(p2, o2::track::PID::Pion), trackCuts.getNsigmaTOF(p2, o2::track::PID::Pion))) {
+    // the kaon selection only depends on the track, it is evaluated once per track instead of once per pair
+    std::vector<typename TrackType::iterator> posKaons, negKaons;
+    for (const auto& track : tracks) {
+      if ((track.sign() != 1 && track.sign() != -1) || !trackCuts.isSelectedMinimal(track) || !isPhiDaughter(track)) {
         continue;
       }
-
+      (track.sign() == 1 ? posKaons : negKaons).push_back(track);
+    }
+    // lorentz vectors and filling the tables
+    for (std::size_t iPair = 0; iPair < posKaons.size() * negKaons.size(); iPair++) {
+      const auto& p1 = posKaons[iPair / negKaons.size()];
+      const auto& p2 = negKaons[iPair % negKaons.size()];
       TLorentzVector part1Vec;
       TLorentzVector part2Vec;
 
@@ -1637,10 +1633,11 @@ struct FemtoUniverseProducerTask {
   }
 
   template <typename TrackType, bool transientLabels = false, bool resolveDaughs = false>
-  void fillParticles(TrackType const& tracks, std::optional<std::reference_wrapper<const std::set<int>>> recoMcIds = std::nullopt)
+  void fillParticles(TrackType const& tracks, std::optional<std::reference_wrapper<const std::unordered_set<int>>> recoMcIds = std::nullopt)
   {
     std::vector<int> childIDs = {0, 0}; // these IDs are necessary to keep track of the children
     std::vector<int> tmpIDtrack;
+    std::vector<int> tmpPDGCodes = confMCTruthPDGCodes; // necessary due to some features of the Configurable
 
     for (const auto& particle : tracks) {
       /// if the most open selection criteria are not fulfilled there is no
@@ -1655,7 +1652,6 @@ struct FemtoUniverseProducerTask {
 
       if (confMCTruthAnalysisWithPID) {
         bool pass = false;
-        std::vector<int> tmpPDGCodes = confMCTruthPDGCodes; // necessary due to some features of the Configurable
         for (auto const& pdg : tmpPDGCodes) {
           if (static_cast<int>(pdg) == static_cast<int>(pdgCode)) {
             if (pdgCode == 333) { // && (recoMcIds && recoMcIds->get().contains(particle.globalIndex()))) { // ATTENTION: all Phi mesons are NOT primary particles
@@ -1722,15 +1718,17 @@ struct FemtoUniverseProducerTask {
         childIDs.push_back(0);
         minDaughs = 3ul;
       }
+      std::unordered_map<int, int> rowOfMcParticle; // McParticle index -> position in tmpIDtrack
+      rowOfMcParticle.reserve(tmpIDtrack.size());
+      for (std::size_t i = 0; i < tmpIDtrack.size(); i++) {
+        rowOfMcParticle.try_emplace(tmpIDtrack[i], i);
+      }
       for (std::size_t i = 0; i < tmpIDtrack.size(); i++) {
         const auto& particle = tracks.iteratorAt(tmpIDtrack[i] - tracks.begin().globalIndex());
         for (int daughIndex = 0, n = std::min(minDaughs, particle.daughtersIds().size()); daughIndex < n; daughIndex++) {
-          // loop to find the corresponding index of the daughters
-          for (std::size_t j = 0; j < tmpIDtrack.size(); j++) {
-            if (tmpIDtrack[j] == particle.daughtersIds()[daughIndex]) {
-              childIDs[daughIndex] = i - j;
-              break;
-            }
+          // find the corresponding index of the daughters
+          if (auto daugh = rowOfMcParticle.find(particle.daughtersIds()[daughIndex]); daugh != rowOfMcParticle.end()) {
+            childIDs[daughIndex] = i - daugh->second;
           }
         }
 
@@ -1763,10 +1761,11 @@ struct FemtoUniverseProducerTask {
   }
 
   template <typename TrackType, bool transientLabels = false, bool resolveDaughs = false>
-  void fillMCTruthParticlesD0(TrackType const& tracks, std::optional<std::reference_wrapper<const std::set<int>>> recoMcIds = std::nullopt)
+  void fillMCTruthParticlesD0(TrackType const& tracks, std::optional<std::reference_wrapper<const std::unordered_set<int>>> recoMcIds = std::nullopt)
   {
     std::vector<int> childIDs = {0, 0}; // these IDs are necessary to keep track of the children
     std::vector<int> tmpIDtrack;
+    std::vector<int> tmpPDGCodes = confMCTruthPDGCodes; // necessary due to some features of the Configurable
 
     for (const auto& particle : tracks) {
       /// if the most open selection criteria are not fulfilled there is no
@@ -1781,7 +1780,6 @@ struct FemtoUniverseProducerTask {
 
       if (confMCTruthAnalysisWithPID) {
         bool pass = false;
-        std::vector<int> tmpPDGCodes = confMCTruthPDGCodes; // necessary due to some features of the Configurable
         for (auto const& pdg : tmpPDGCodes) {
           if (static_cast<int>(pdg) == static_cast<int>(pdgCode)) {
             if (pdgCode == 333) { // && (recoMcIds && recoMcIds->get().contains(particle.globalIndex()))) { // ATTENTION: all Phi mesons are NOT primary particles
@@ -1857,15 +1855,17 @@ struct FemtoUniverseProducerTask {
     if constexpr (resolveDaughs) {
       childIDs[0] = 0;
       childIDs[1] = 0;
+      std::unordered_map<int, int> rowOfMcParticle; // McParticle index -> position in tmpIDtrack
+      rowOfMcParticle.reserve(tmpIDtrack.size());
+      for (std::size_t i = 0; i < tmpIDtrack.size(); i++) {
+        rowOfMcParticle.try_emplace(tmpIDtrack[i], i);
+      }
       for (std::size_t i = 0; i < tmpIDtrack.size(); i++) {
         const auto& particle = tracks.iteratorAt(tmpIDtrack[i] - tracks.begin().globalIndex());
         for (int daughIndex = 0, n = std::min(2ul, particle.daughtersIds().size()); daughIndex < n; daughIndex++) {
-          // loop to find the corresponding index of the daughters
-          for (std::size_t j = 0; j < tmpIDtrack.size(); j++) {
-            if (tmpIDtrack[j] == particle.daughtersIds()[daughIndex]) {
-              childIDs[daughIndex] = i - j;
-              break;
-            }
+          // find the corresponding index of the daughters
+          if (auto daugh = rowOfMcParticle.find(particle.daughtersIds()[daughIndex]); daugh != rowOfMcParticle.end()) {
+            childIDs[daughIndex] = i - daugh->second;
           }
         }
         outputParts(outputCollision.lastIndex(),
@@ -2142,7 +2142,7 @@ struct FemtoUniverseProducerTask {
     Preslice<StrangePartType>& ps)
   {
     // recos
-    std::set<int> recoMcIds;
+    std::unordered_set<int> recoMcIds;
     for (const auto& col : collisions) {
       auto groupedTracks = tracks.sliceBy(perCollisionTracks, col.globalIndex());
       auto groupedStrageParts = strangeParts.sliceBy(ps, col.globalIndex());
@@ -2178,7 +2178,7 @@ struct FemtoUniverseProducerTask {
                                      aod::BCsWithTimestamps const&)
   {
     // recos
-    std::set<int> recoMcIds;
+    std::unordered_set<int> recoMcIds;
     for (const auto& col : collisions) {
       auto groupedTracks = tracks.sliceBy(perCollisionTracks, col.globalIndex());
       auto bc = col.bc_as<aod::BCsWithTimestamps>();
@@ -2235,7 +2235,7 @@ struct FemtoUniverseProducerTask {
   {
 
     // recos
-    std::set<int> recoMcIds;
+    std::unordered_set<int> recoMcIds;
     for (const auto& col : collisions) {
       auto groupedTracks = tracks.sliceBy(perCollisionTracks, col.globalIndex());
       auto groupedV0Parts = fullV0s.sliceBy(perCollisionV0s, col.globalIndex());
@@ -2289,7 +2289,7 @@ struct FemtoUniverseProducerTask {
   {
 
     // recos
-    std::set<int> recoMcIds;
+    std::unordered_set<int> recoMcIds;
     for (const auto& col : collisions) {
       auto groupedTracks = tracks.sliceBy(perCollisionTracks, col.globalIndex());
       auto groupedCascParts = fullCascades.sliceBy(perCollisionCascs, col.globalIndex());
@@ -2330,7 +2330,7 @@ struct FemtoUniverseProducerTask {
                         aod::BCsWithTimestamps const&)
   {
     // MC Reco
-    std::set<int> recoMcIds;
+    std::unordered_set<int> recoMcIds;
     for (const auto& col : collisions) {
       auto groupedTracks = tracks.sliceBy(perCollisionTracks, col.globalIndex());
       auto groupedD0s = hfMcRecoCands.sliceBy(perCollisionD0s, col.globalIndex());
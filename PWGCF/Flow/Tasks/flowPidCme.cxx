@@ -14,8 +14,11 @@
 /// \brief  task to calculate the pikp cme signal and bacground.
 // C++/ROOT includes.
 #include <CCDB/BasicCCDBManager.h>
+#include <array>
 #include <chrono>
+#include <complex>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <utility>
 #include <memory>
@@ -2026,6 +2029,7 @@ struct FlowPidCme {
   Configurable<bool> cfgkOpenKaPr{"cfgkOpenKaPr", true, "open Ka-Pr"};
   Configurable<bool> cfgkOpenHaHa{"cfgkOpenHaHa", true, "open Ha-Ha"};
   Configurable<bool> cfgkOpenSsOsCrossCheck{"cfgkOpenSsOsCrossCheck", false, "open check for matter an antimatter #gamma#delta"};
+  Configurable<bool> cfgkCMEFromFlowVectors{"cfgkCMEFromFlowVectors", false, "compute the integrated #gamma and #delta from per-species flow vectors instead of pair loops (pair loops still used if the differential plots are open)"};
   Configurable<bool> cfgkOpenTPCITSPurityCut{"cfgkOpenTPCITSPurityCut", true, "open ITS-TPC purity cut"};
   Configurable<bool> cfgkOpenTPCITSPurityCutQA{"cfgkOpenTPCITSPurityCutQA", true, "open ITS-TPC purity cut QA plots"};
   Configurable<bool> cfgkOpenDebugPIDCME{"cfgkOpenDebugPIDCME", false, "open pidcme workflow debug mode"};
@@ -2244,6 +2248,9 @@ struct FlowPidCme {
     }
 
     if (cfgkOpenCME) {
+      if (cfgkCMEFromFlowVectors && cfgkOpenCMEDifferential) {
+        LOGF(warning, "cfgkCMEFromFlowVectors needs cfgkOpenCMEDifferential off, the pair loops are used");
+      }
       if (cfgkOpenPiPi) {
         histosQA.add<TProfile>(Form("PIDCME/histgamma_PiPi_ss"), "", {HistType::kTProfile, {axisCentMerged}});
         histosQA.add<TProfile>(Form("PIDCME/histgamma_PiPi_os"), "", {HistType::kTProfile, {axisCentMerged}});
@@ -2701,6 +2708,72 @@ struct FlowPidCme {
     }
   }
 
+  // Flow vectors of the selected tracks of one species, per charge (0: positive, 1: negative)
+  struct CmeFlowVectors {
+    std::array<std::complex<double>, 2> q1{};
+    std::array<std::complex<double>, 2> q2{};
+    std::array<double, 2> mult{};
+  };
+  static constexpr std::string_view kCmePairNames[] = {"PiPi", "KaKa", "PrPr", "PiKa", "PiPr", "KaPr"};
+
+  template <typename TrackType>
+  CmeFlowVectors getCmeFlowVectors(const TrackType& tracks, float cent)
+  {
+    CmeFlowVectors flowVectors;
+    for (const auto& trk : tracks) {
+      if (!selTrack(trk, cent))
+        continue;
+      const int iCharge = trk.sign() > 0 ? 0 : 1;
+      flowVectors.q1[iCharge] += std::polar(1., static_cast<double>(trk.phi()));
+      flowVectors.q2[iCharge] += std::polar(1., 2. * trk.phi());
+      flowVectors.mult[iCharge] += 1.;
+    }
+    return flowVectors;
+  }
+
+  // #gamma = <cos(phi1 + phi2 - 2 psi)> and #delta = <cos(phi1 - phi2)> over the ordered pairs (trk1 of a, trk2 of b) of the event,
+  // from the flow vectors: the sums over the pairs are products of the flow vectors, minus the pairs of a track with itself
+  // for the same species and charge. Each event fills the profiles with its average weighted by its number of pairs, which
+  // gives the same means as filling every pair of the pair loops.
+  template <int iPair>
+  void fillCmeFromFlowVectors(const CmeFlowVectors& a, const CmeFlowVectors& b, bool sameSpecies, float cent, float psiN)
+  {
+    const auto rotation = std::polar(1., -2. * psiN);
+    double gamma[2][2], delta[2][2], nPairs[2][2];
+    for (int ia = 0; ia < 2; ia++) {
+      for (int ib = 0; ib < 2; ib++) {
+        if (sameSpecies && ia == ib) {
+          gamma[ia][ib] = std::real((a.q1[ia] * a.q1[ia] - a.q2[ia]) * rotation);
+          delta[ia][ib] = std::norm(a.q1[ia]) - a.mult[ia];
+          nPairs[ia][ib] = a.mult[ia] * (a.mult[ia] - 1.);
+        } else {
+          gamma[ia][ib] = std::real(a.q1[ia] * b.q1[ib] * rotation);
+          delta[ia][ib] = std::real(a.q1[ia] * std::conj(b.q1[ib]));
+          nPairs[ia][ib] = a.mult[ia] * b.mult[ib];
+        }
+      }
+    }
+    auto fillAverage = [&](auto histName, double sum, double n) {
+      if (n > 0.) {
+        histosQA.fill(histName, cent, sum / n, n);
+      }
+    };
+    fillAverage(HIST("PIDCME/histgamma_") + HIST(kCmePairNames[iPair]) + HIST("_ss"), gamma[0][0] + gamma[1][1], nPairs[0][0] + nPairs[1][1]);
+    fillAverage(HIST("PIDCME/histdelta_") + HIST(kCmePairNames[iPair]) + HIST("_ss"), delta[0][0] + delta[1][1], nPairs[0][0] + nPairs[1][1]);
+    fillAverage(HIST("PIDCME/histgamma_") + HIST(kCmePairNames[iPair]) + HIST("_os"), gamma[0][1] + gamma[1][0], nPairs[0][1] + nPairs[1][0]);
+    fillAverage(HIST("PIDCME/histdelta_") + HIST(kCmePairNames[iPair]) + HIST("_os"), delta[0][1] + delta[1][0], nPairs[0][1] + nPairs[1][0]);
+    if (cfgkOpenSsOsCrossCheck) {
+      fillAverage(HIST("PIDCME/histgamma_") + HIST(kCmePairNames[iPair]) + HIST("_PP"), gamma[0][0], nPairs[0][0]);
+      fillAverage(HIST("PIDCME/histdelta_") + HIST(kCmePairNames[iPair]) + HIST("_PP"), delta[0][0], nPairs[0][0]);
+      fillAverage(HIST("PIDCME/histgamma_") + HIST(kCmePairNames[iPair]) + HIST("_NN"), gamma[1][1], nPairs[1][1]);
+      fillAverage(HIST("PIDCME/histdelta_") + HIST(kCmePairNames[iPair]) + HIST("_NN"), delta[1][1], nPairs[1][1]);
+      fillAverage(HIST("PIDCME/histgamma_") + HIST(kCmePairNames[iPair]) + HIST("_PN"), gamma[0][1], nPairs[0][1]);
+      fillAverage(HIST("PIDCME/histdelta_") + HIST(kCmePairNames[iPair]) + HIST("_PN"), delta[0][1], nPairs[0][1]);
+      fillAverage(HIST("PIDCME/histgamma_") + HIST(kCmePairNames[iPair]) + HIST("_NP"), gamma[1][0], nPairs[1][0]);
+      fillAverage(HIST("PIDCME/histdelta_") + HIST(kCmePairNames[iPair]) + HIST("_NP"), delta[1][0], nPairs[1][0]);
+    }
+  }
+
   template <typename CollType, typename TrackType>
   void fillHistosFlowGammaDelta(const CollType& collision, const TrackType& track1, const TrackType& track2, const TrackType& track3, int nmode)
   {
@@ -2823,7 +2896,31 @@ struct FlowPidCme {
         }
       }
     }
-    if (cfgkOpenCME) {
+    if (cfgkOpenCME && cfgkCMEFromFlowVectors && !cfgkOpenCMEDifferential) {
+      if (nmode == fourier_mode::kMode2) {
+        const auto flowVectorsPi = getCmeFlowVectors(track1, cent);
+        const auto flowVectorsKa = getCmeFlowVectors(track2, cent);
+        const auto flowVectorsPr = getCmeFlowVectors(track3, cent);
+        if (cfgkOpenPiPi) {
+          fillCmeFromFlowVectors<0>(flowVectorsPi, flowVectorsPi, true, cent, psiN);
+        }
+        if (cfgkOpenKaKa) {
+          fillCmeFromFlowVectors<1>(flowVectorsKa, flowVectorsKa, true, cent, psiN);
+        }
+        if (cfgkOpenPrPr) {
+          fillCmeFromFlowVectors<2>(flowVectorsPr, flowVectorsPr, true, cent, psiN);
+        }
+        if (cfgkOpenPiKa) {
+          fillCmeFromFlowVectors<3>(flowVectorsPi, flowVectorsKa, false, cent, psiN);
+        }
+        if (cfgkOpenPiPr) {
+          fillCmeFromFlowVectors<4>(flowVectorsPi, flowVectorsPr, false, cent, psiN);
+        }
+        if (cfgkOpenKaPr) {
+          fillCmeFromFlowVectors<5>(flowVectorsKa, flowVectorsPr, false, cent, psiN);
+        }
+      }
+    } else if (cfgkOpenCME) {
       if (cfgkOpenPiPi) {
         for (const auto& trk1 : track1) {
           if (!selTrack(trk1, cent))
@@ -43,6 +43,7 @@ void BootstrapProfile::InitializeSubsamples(Int_t nSub)
   }
   if (fListOfEntries)
     delete fListOfEntries;
+  fSubProfiles.clear();
   fListOfEntries = new TList();
   fListOfEntries->SetOwner(kTRUE);
   TProfile* dummyPF = reinterpret_cast<TProfile*>(this);
@@ -60,7 +61,21 @@ void BootstrapProfile::FillProfile(const Double_t& xv, const Double_t& yv, const
   Int_t targetInd = rn * fNSubs;
   if (targetInd >= fNSubs)
     targetInd = 0;
-  reinterpret_cast<TProfile*>(fListOfEntries->At(targetInd))->Fill(xv, yv, w);
+  if (static_cast<Int_t>(fSubProfiles.size()) != fNSubs)
+    CacheSubProfiles();
+  if (targetInd >= static_cast<Int_t>(fSubProfiles.size()))
+    return;
+  fSubProfiles[targetInd]->Fill(xv, yv, w);
+}
+void BootstrapProfile::CacheSubProfiles()
+{
+  fSubProfiles.clear();
+  if (!fListOfEntries)
+    return;
+  TIter next(fListOfEntries);
+  TProfile* subPf = 0;
+  while ((subPf = reinterpret_cast<TProfile*>(next())))
+    fSubProfiles.push_back(subPf);
 }
 void BootstrapProfile::FillProfile(const Double_t& xv, const Double_t& yv, const Double_t& w)
 {
@@ -123,6 +138,7 @@ Long64_t BootstrapProfile::Merge(TCollection* collist)
       continue;
     if (!fListOfEntries) {
       fListOfEntries = reinterpret_cast<TList*>(tarL->Clone());
+      fSubProfiles.clear();
       for (Int_t i = 0; i < fListOfEntries->GetEntries(); i++)
         reinterpret_cast<TProfile*>(fListOfEntries->At(i))->Reset();
     }
@@ -200,6 +216,7 @@ void BootstrapProfile::MergeBS(BootstrapProfile* target)
     if (!target->fListOfEntries)
       return;
     fListOfEntries = reinterpret_cast<TList*>(tarL->Clone());
+    fSubProfiles.clear();
     for (Int_t i = 0; i < fListOfEntries->GetEntries(); i++)
       reinterpret_cast<TProfile*>(fListOfEntries->At(i))->Reset();
   }
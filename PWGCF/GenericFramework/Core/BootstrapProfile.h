@@ -18,6 +18,8 @@
 #include "TCollection.h"
 #include "TMath.h"
 
+#include <vector>
+
 class BootstrapProfile : public TProfile
 {
  public:
@@ -52,9 +54,11 @@ class BootstrapProfile : public TProfile
   TH1* getWeightBasedRebin(Int_t ind = -1);
   Bool_t fProfInitialized;
   Int_t fNSubs;
-  Int_t fMultiRebin;                //! externaly set runtime, no need to store
-  Double_t* fMultiRebinEdges;       //! externaly set runtime, no need to store
-  BootstrapProfile* fPresetWeights; //! BootstrapProfile whose weights we should copy
+  Int_t fMultiRebin;                   //! externaly set runtime, no need to store
+  Double_t* fMultiRebinEdges;          //! externaly set runtime, no need to store
+  BootstrapProfile* fPresetWeights;    //! BootstrapProfile whose weights we should copy
+  std::vector<TProfile*> fSubProfiles; //! subprofiles of fListOfEntries, TList::At is linear in the index
+  void CacheSubProfiles();
   void ResetBin(TProfile* tpf, Int_t nbin)
   {
     tpf->SetBinEntries(nbin, 0);
@@ -137,15 +137,29 @@ int FlowContainer::FillProfile(const char* hname, double multi, double corr, dou
 {
   if (!fProf)
     return -1;
-  int yin = fProf->GetYaxis()->FindBin(hname);
-  if (!yin) {
+  int yin = GetCorrIndex(hname);
+  if (yin < 1) {
     printf("Could not find bin %s\n", hname);
     return -1;
   }
-  fProf->Fill(multi, yin, corr, w);
+  return FillProfile(yin, multi, corr, w, rn);
+};
+int FlowContainer::GetCorrIndex(const char* hname)
+{
+  if (!fProf)
+    return -1;
+  return fProf->GetYaxis()->FindBin(hname);
+}
+int FlowContainer::FillProfile(int corrIndex, double multi, double corr, double w, double rn)
+{
+  if (!fProf || corrIndex < 1)
+    return -1;
+  fProf->Fill(multi, corrIndex, corr, w);
   if (fNRandom) {
-    double rnind = rn * fNRandom;
-    dynamic_cast<TProfile2D*>(fProfRand->At(static_cast<int>(rnind)))->Fill(multi, yin, corr, w);
+    int rnind = static_cast<int>(rn * fNRandom);
+    if (rnind >= fNRandom)
+      rnind = 0;
+    static_cast<TProfile2D*>(fProfRand->UncheckedAt(rnind))->Fill(multi, corrIndex, corr, w);
   }
   return 0;
 };
@@ -51,6 +51,8 @@ class FlowContainer : public TNamed
   int GetNMultiBins() { return fProf->GetNbinsX(); }
   double GetMultiAtBin(int bin) { return fProf->GetXaxis()->GetBinCenter(bin); }
   int FillProfile(const char* hname, double multi, double y, double w, double rn);
+  int GetCorrIndex(const char* hname);                                         // y bin of the correlator, to be looked up once and passed to FillProfile
+  int FillProfile(int corrIndex, double multi, double y, double w, double rn); // no label lookup
   TProfile2D* GetProfile() { return fProf; }
   void OverrideProfileErrors(TProfile2D* inpf);
   void ReadAndMerge(const char* infile);
@@ -19,6 +19,9 @@ If used, modified, or distributed, please aknowledge the author of this code.
 
 #include "GFW.h"
 
+#include <map>
+#include <tuple>
+
 using std::complex;
 using std::pair;
 using std::string;
@@ -89,9 +92,8 @@ int GFW::CreateRegions()
   }
   int nRegions = 0;
   for (auto pItr = fRegions.begin(); pItr != fRegions.end(); pItr++) {
-    GFWCumulant* lCumulant = new GFWCumulant();
-    lCumulant->CreateComplexVectorArrayVarPower(pItr->Nhar, pItr->NparVec, pItr->NpT);
-    fCumulants.push_back(*lCumulant);
+    GFWCumulant& lCumulant = fCumulants.emplace_back();
+    lCumulant.CreateComplexVectorArrayVarPower(pItr->Nhar, pItr->NparVec, pItr->NpT);
     ++nRegions;
   }
   if (nRegions)
@@ -260,7 +262,7 @@ complex<double> GFW::Calculate(int poi, int ref, vector<int> hars, int ptbin)
   GFWCumulant* qovl = qpoi;
   return RecursiveCorr(qpoi, qref, qovl, ptbin, hars);
 };
-complex<double> GFW::Calculate(CorrConfig corconf, int ptbin, bool SetHarmsToZero)
+complex<double> GFW::Calculate(const CorrConfig& corconf, int ptbin, bool SetHarmsToZero)
 {
   // if(!fInitialized) return complex<double>(0,0); //First check if initialised, if not -- initialize, and if it fails, return
   if (corconf.Regs.size() == 0)
@@ -296,14 +298,145 @@ complex<double> GFW::Calculate(CorrConfig corconf, int ptbin, bool SetHarmsToZer
       qovl = &fCumulants.at(ovl);
     else if (ref == poi)
       qovl = qref; // If ref and poi are the same, then the same is for overlap. Only, when OL not explicitly defined
-    if (SetHarmsToZero) {
-      for (int j = 0; j < static_cast<int>(corconf.Hars.at(i).size()); j++) {
-        corconf.Hars.at(i).at(j) = 0;
+    vector<int> hars = SetHarmsToZero ? vector<int>(corconf.Hars.at(i).size(), 0) : corconf.Hars.at(i);
+    retval *= RecursiveCorr(qpoi, qref, qovl, ptInd, hars);
+  }
+  return retval;
+};
+struct GFW::PlanMemo {
+  std::map<std::tuple<int, int, int, int>, int> Qvectors;                               // <region, harmonic, power, pT bin> -> node
+  std::map<std::tuple<int, int, int, int, vector<int>, vector<int>>, int> Correlations; // <POI, ref, overlap, pT bin, harmonics, powers> -> node
+};
+int GFW::CompileQvector(CorrPlan& plan, PlanMemo& memo, int region, int har, int pow, int ptbin)
+{
+  auto [itr, inserted] = memo.Qvectors.try_emplace(std::make_tuple(region, har, pow, ptbin), static_cast<int>(plan.Nodes.size()));
+  if (inserted) {
+    PlanNode node;
+    node.Region = region;
+    node.Har = har;
+    node.Pow = pow;
+    node.PtBin = ptbin;
+    plan.Nodes.push_back(node);
+  }
+  return itr->second;
+};
+int GFW::CompileRecursiveCorr(CorrPlan& plan, PlanMemo& memo, int poi, int ref, int ovl, int ptbin, vector<int>& hars, vector<int>& pows)
+{
+  // Same recursion as RecursiveCorr, but each term is booked only once as a node of the plan
+  if ((pows.at(0) != 1) && ovl > -1)
+    poi = ovl;
+  if (hars.size() < 2)
+    return CompileQvector(plan, memo, poi, hars.at(0), pows.at(0), ptbin);
+  auto key = std::make_tuple(poi, ref, ovl, ptbin, hars, pows);
+  auto itr = memo.Correlations.find(key);
+  if (itr != memo.Correlations.end())
+    return itr->second;
+  PlanNode node;
+  vector<pair<double, int>> terms;
+  if (hars.size() < 3) {
+    node.A = CompileQvector(plan, memo, poi, hars.at(0), pows.at(0), ptbin);
+    node.B = CompileQvector(plan, memo, ref, hars.at(1), pows.at(1), ptbin);
+    if (ovl > -1)
+      terms.emplace_back(1., CompileQvector(plan, memo, ovl, hars.at(0) + hars.at(1), pows.at(0) + pows.at(1), ptbin));
+  } else {
+    int harlast = hars.at(hars.size() - 1);
+    int powlast = pows.at(pows.size() - 1);
+    hars.erase(hars.end() - 1);
+    pows.erase(pows.end() - 1);
+    node.A = CompileRecursiveCorr(plan, memo, poi, ref, ovl, ptbin, hars, pows);
+    node.B = CompileQvector(plan, memo, ref, harlast, powlast, 0); // RecursiveCorr takes the last Q-vector from the first pT bin
+    int lDegeneracy = 1;
+    int harSize = static_cast<int>(hars.size());
+    for (int i = harSize - 1; i >= 0; i--) {
+      if (i > 2) {
+        if (hars.at(i) == hars.at(i - 1) && pows.at(i) == pows.at(i - 1)) {
+          lDegeneracy++;
+          continue;
+        }
       }
+      hars.at(i) += harlast;
+      pows.at(i) += powlast;
+      terms.emplace_back(lDegeneracy, CompileRecursiveCorr(plan, memo, poi, ref, ovl, ptbin, hars, pows));
+      lDegeneracy = 1;
+      hars.at(i) -= harlast;
+      pows.at(i) -= powlast;
     }
-    retval *= RecursiveCorr(qpoi, qref, qovl, ptInd, corconf.Hars.at(i));
+    hars.push_back(harlast);
+    pows.push_back(powlast);
+  }
+  node.TermBegin = static_cast<int>(plan.Terms.size());
+  plan.Terms.insert(plan.Terms.end(), terms.begin(), terms.end());
+  node.TermEnd = static_cast<int>(plan.Terms.size());
+  int index = static_cast<int>(plan.Nodes.size());
+  plan.Nodes.push_back(node);
+  memo.Correlations.emplace(key, index);
+  return index;
+};
+GFW::CorrPlan GFW::CompilePlan(const vector<CorrConfig>& configs, bool SetHarmsToZero)
+{
+  CorrPlan plan;
+  PlanMemo memo;
+  for (const CorrConfig& corconf : configs) {
+    bool isEmpty = (corconf.Regs.size() == 0);
+    for (const auto& regs : corconf.Regs)
+      isEmpty |= (regs.size() == 0);
+    if (isEmpty) {
+      plan.Configs.emplace_back(-1, -1); // same as Calculate: nothing to correlate
+      continue;
+    }
+    int first = static_cast<int>(plan.Subevents.size());
+    for (int i = 0; i < static_cast<int>(corconf.Regs.size()); i++) {
+      int ptInd = corconf.ptInd.at(i) < 0 ? -1 : corconf.ptInd.at(i);
+      int poi = corconf.Regs.at(i).at(0);
+      int ref = (corconf.Regs.at(i).size() > 1) ? corconf.Regs.at(i).at(1) : corconf.Regs.at(i).at(0);
+      int ovl = corconf.Overlap.at(i);
+      if (ovl < 0 && ref == poi)
+        ovl = ref;
+      int sz1 = corconf.Hars.at(i).size();
+      if (poi != ref)
+        sz1--;
+      vector<int> hars = SetHarmsToZero ? vector<int>(corconf.Hars.at(i).size(), 0) : corconf.Hars.at(i);
+      vector<int> pows(hars.size(), 1);
+      int root = CompileRecursiveCorr(plan, memo, poi, ref, ovl, ptInd, hars, pows);
+      plan.Subevents.push_back(PlanSubevent{poi, ref, ptInd, sz1, root});
+    }
+    plan.Configs.emplace_back(first, static_cast<int>(plan.Subevents.size()));
+  }
+  plan.Values.resize(plan.Nodes.size());
+  return plan;
+};
+void GFW::Calculate(CorrPlan& plan, int ptbin, vector<complex<double>>& results)
+{
+  plan.Values.resize(plan.Nodes.size());
+  for (int i = 0; i < static_cast<int>(plan.Nodes.size()); i++) {
+    const PlanNode& node = plan.Nodes[i];
+    if (node.Region > -1) {
+      plan.Values[i] = fCumulants[node.Region].Vec(node.Har, node.Pow, (node.PtBin < 0) ? ptbin : node.PtBin);
+      continue;
+    }
+    complex<double> formula = plan.Values[node.A] * plan.Values[node.B];
+    for (int t = node.TermBegin; t < node.TermEnd; t++)
+      formula -= plan.Values[plan.Terms[t].second] * plan.Terms[t].first;
+    plan.Values[i] = formula;
+  }
+  results.resize(plan.Configs.size());
+  for (int c = 0; c < static_cast<int>(plan.Configs.size()); c++) {
+    complex<double> retval(1, 0);
+    if (plan.Configs[c].first < 0)
+      retval = complex<double>(0, 0);
+    for (int i = plan.Configs[c].first; i < plan.Configs[c].second; i++) {
+      const PlanSubevent& sub = plan.Subevents[i];
+      int ptInd = (sub.PtBin < 0) ? ptbin : sub.PtBin;
+      GFWCumulant& qref = fCumulants[sub.Ref];
+      GFWCumulant& qpoi = fCumulants[sub.Poi];
+      if (!qref.IsPtBinFilled(ptInd) || !qpoi.IsPtBinFilled(ptInd) || qref.GetN() < sub.MinN) {
+        retval = complex<double>(0, 0);
+        break;
+      }
+      retval *= plan.Values[sub.Root];
+    }
+    results[c] = retval;
   }
-  return retval;
 };
 vector<pair<int, vector<int>>> GFW::GetHarmonicsSingleConfig(const CorrConfig& incfg)
 {
@@ -52,6 +52,27 @@ class GFW
     bool pTDif = false;
     std::string Head = "";
   };
+  // Set of correlators compiled into a DAG of Q-vector products. Terms shared between correlators are evaluated only once per call.
+  struct PlanNode {
+    int Region = -1; // Q-vector: region index; -1 for product nodes
+    int Har = 0;     // Q-vector: harmonic
+    int Pow = 0;     // Q-vector: power
+    int PtBin = -1;  // Q-vector: pT bin, -1 = pT bin requested at evaluation
+    int A = -1;      // Product node: A*B - sum of terms
+    int B = -1;
+    int TermBegin = 0;
+    int TermEnd = 0;
+  };
+  struct PlanSubevent {
+    int Poi, Ref, PtBin, MinN, Root;
+  };
+  struct CorrPlan {
+    std::vector<PlanNode> Nodes{};               // in evaluation order, children always come first
+    std::vector<std::pair<double, int>> Terms{}; // subtracted terms of product nodes: <multiplicity, node>
+    std::vector<PlanSubevent> Subevents{};       // subevents of all correlators, with the conditions to be checked before the evaluation
+    std::vector<std::pair<int, int>> Configs{};  // range of subevents per correlator, <-1, -1> if the correlator is always 0
+    std::vector<std::complex<double>> Values{};  // node values of the last evaluation
+  };
   GFW();
   ~GFW();
   std::vector<Region> fRegions;
@@ -63,9 +84,11 @@ class GFW
   int CreateRegions();
   void Fill(double eta, int ptin, double phi, double weight, int mask, double secondWeight = -1);
   void Clear();
-  GFWCumulant GetCumulant(int index) { return fCumulants.at(index); }
+  GFWCumulant& GetCumulant(int index) { return fCumulants.at(index); }
   CorrConfig GetCorrelatorConfig(std::string config, std::string head = "", bool ptdif = false);
-  std::complex<double> Calculate(CorrConfig corconf, int ptbin, bool SetHarmsToZero);
+  std::complex<double> Calculate(const CorrConfig& corconf, int ptbin, bool SetHarmsToZero);
+  CorrPlan CompilePlan(const std::vector<CorrConfig>& configs, bool SetHarmsToZero = false);
+  void Calculate(CorrPlan& plan, int ptbin, std::vector<std::complex<double>>& results); // all correlators of the plan, in the order they were compiled
   void InitializePowerArrays();
 
  protected:
@@ -74,6 +97,9 @@ class GFW
   std::complex<double> TwoRec(int n1, int n2, int p1, int p2, int ptbin, GFWCumulant*, GFWCumulant*, GFWCumulant*);
   std::complex<double> RecursiveCorr(GFWCumulant* qpoi, GFWCumulant* qref, GFWCumulant* qol, int ptbin, std::vector<int>& hars, std::vector<int>& pows); // POI, Ref. flow, overlapping region
   std::complex<double> RecursiveCorr(GFWCumulant* qpoi, GFWCumulant* qref, GFWCumulant* qol, int ptbin, std::vector<int>& hars);                         // POI, Ref. flow, overlapping region
+  struct PlanMemo;
+  int CompileRecursiveCorr(CorrPlan& plan, PlanMemo& memo, int poi, int ref, int ovl, int ptbin, std::vector<int>& hars, std::vector<int>& pows);
+  int CompileQvector(CorrPlan& plan, PlanMemo& memo, int region, int har, int pow, int ptbin);
   void AddRegion(Region inreg) { fRegions.push_back(inreg); }
   Region GetRegion(int index) { return fRegions.at(index); }
   int FindRegionByName(std::string refName);
@@ -19,16 +19,21 @@ If used, modified, or distributed, please aknowledge the author of this code.
 
 #include "GFWCumulant.h"
 
+#include <algorithm>
+
 using std::complex;
 using std::vector;
 
-GFWCumulant::GFWCumulant() : fQvector(0),
+GFWCumulant::GFWCumulant() : fQre(),
+                             fQim(),
                              fUsed(kBlank),
                              fNEntries(-1),
                              fN(1),
                              fPow(1),
                              fPt(1),
-                             fFilledPts(0),
+                             fMaxPow(0),
+                             fNStride(0),
+                             fFilledPts(),
                              fInitialized(false) {}
 
 GFWCumulant::~GFWCumulant() {}
@@ -41,21 +46,33 @@ void GFWCumulant::FillArray(int ptin, double phi, double weight, double SecondWe
   else if (ptin < 0 || ptin >= fPt)
     return;
   fFilledPts[ptin] = true;
-  for (int lN = 0; lN < fN; lN++) {
-    double lSin = sin(lN * phi); // No need to recalculate for each power
-    double lCos = cos(lN * phi); // No need to recalculate for each power
-    for (int lPow = 0; lPow < PW(lN); lPow++) {
-      double lPrefactor = 0;
-      // Dont calculate it twice; multiplication is cheaper that power
-      // Also, if second weight is specified, then keep the first weight with power no more than 1, and us the other weight otherwise
-      // this is important when POIs are a subset of REFs and have different weights than REFs
-      if (SecondWeight > 0 && lPow > 1)
-        lPrefactor = pow(SecondWeight, lPow - 1) * weight;
-      else
-        lPrefactor = pow(weight, lPow);
-      double qsin = lPrefactor * lSin;
-      double qcos = lPrefactor * lCos;
-      fQvector[ptin][lN][lPow] += complex<double>(qcos, qsin);
+  // cos(n*phi) and sin(n*phi) for all harmonics at once, with Chebyshev recurrences; no need to recalculate for each power
+  double* lCos = fCosN.data();
+  double* lSin = fSinN.data();
+  const double lCos1 = cos(phi);
+  lCos[0] = 1.;
+  lSin[0] = 0.;
+  if (fN > 1) {
+    lCos[1] = lCos1;
+    lSin[1] = sin(phi);
+  }
+  for (int lN = 2; lN < fN; lN++) {
+    lCos[lN] = 2. * lCos1 * lCos[lN - 1] - lCos[lN - 2];
+    lSin[lN] = 2. * lCos1 * lSin[lN - 1] - lSin[lN - 2];
+  }
+  double* lQre = fQre.data() + QIndex(ptin, 0, 0);
+  double* lQim = fQim.data() + QIndex(ptin, 0, 0);
+  double lPrefactor = 1.;
+  for (int lPow = 0; lPow < fMaxPow; lPow++, lQre += fNStride, lQim += fNStride) {
+    // Dont calculate it twice; multiplication is cheaper that power
+    // Also, if second weight is specified, then keep the first weight with power no more than 1, and us the other weight otherwise
+    // this is important when POIs are a subset of REFs and have different weights than REFs
+    if (lPow > 0)
+      lPrefactor *= (SecondWeight > 0 && lPow > 1) ? SecondWeight : weight;
+    const int lNHar = fNHarPerPow[lPow];
+    for (int lN = 0; lN < lNHar; lN++) {
+      lQre[lN] += lPrefactor * lCos[lN];
+      lQim[lN] += lPrefactor * lSin[lN];
     }
   }
   Inc();
@@ -64,30 +81,21 @@ void GFWCumulant::ResetQs()
 {
   if (!fNEntries)
     return; // If 0 entries, then no need to reset. Otherwise, if -1, then just initialized and need to set to 0.
-  for (int i = 0; i < fPt; i++) {
-    fFilledPts[i] = false;
-    for (int lN = 0; lN < fN; lN++) {
-      for (int lPow = 0; lPow < PW(lN); lPow++) {
-        fQvector[i][lN][lPow] = fNullQ;
-      }
-    }
-  }
+  std::fill(fFilledPts.begin(), fFilledPts.end(), false);
+  std::fill(fQre.begin(), fQre.end(), 0.);
+  std::fill(fQim.begin(), fQim.end(), 0.);
   fNEntries = 0;
 };
 void GFWCumulant::DestroyComplexVectorArray()
 {
   if (!fInitialized)
     return;
-  for (int l_n = 0; l_n < fN; l_n++) {
-    for (int i = 0; i < fPt; i++) {
-      delete[] fQvector[i][l_n];
-    }
-  }
-  for (int i = 0; i < fPt; i++) {
-    delete[] fQvector[i];
-  }
-  delete[] fQvector;
-  delete[] fFilledPts;
+  fQre.clear();
+  fQim.clear();
+  fNHarPerPow.clear();
+  fCosN.clear();
+  fSinN.clear();
+  fFilledPts.clear();
   fInitialized = false;
   fNEntries = -1;
 };
@@ -106,17 +114,22 @@ void GFWCumulant::CreateComplexVectorArrayVarPower(int N, vector<int> PowVec, in
   fN = N;
   fPow = 0;
   fPt = Pt;
-  fFilledPts = new bool[Pt];
+  fFilledPts.resize(Pt);
   fPowVec = PowVec;
-  fQvector = new complex<double>**[fPt];
-  for (int i = 0; i < fPt; i++) {
-    fQvector[i] = new complex<double>*[fN];
-  }
+  fMaxPow = 0;
+  for (int l_n = 0; l_n < fN; l_n++)
+    fMaxPow = std::max(fMaxPow, PW(l_n));
+  // Powers are usually decreasing with the harmonic; for each power, fill up to the last harmonic which needs it
+  fNHarPerPow.assign(fMaxPow, 0);
   for (int l_n = 0; l_n < fN; l_n++) {
-    for (int i = 0; i < fPt; i++) {
-      fQvector[i][l_n] = new complex<double>[PW(l_n)];
-    }
+    for (int lPow = 0; lPow < PW(l_n); lPow++)
+      fNHarPerPow[lPow] = l_n + 1;
   }
+  fNStride = std::max(kHarmonicPadding, (fN + kHarmonicPadding - 1) / kHarmonicPadding * kHarmonicPadding);
+  fQre.resize(fPt * fMaxPow * fNStride);
+  fQim.resize(fPt * fMaxPow * fNStride);
+  fCosN.resize(fNStride);
+  fSinN.resize(fNStride);
   ResetQs();
   fInitialized = true;
 };
@@ -127,12 +140,12 @@ complex<double> GFWCumulant::Vec(int n, int p, int ptbin)
   if (ptbin >= fPt || ptbin < 0)
     ptbin = 0;
   if (n >= 0)
-    return fQvector[ptbin][n][p];
-  return conj(fQvector[ptbin][-n][p]);
+    return complex<double>(fQre[QIndex(ptbin, p, n)], fQim[QIndex(ptbin, p, n)]);
+  return complex<double>(fQre[QIndex(ptbin, p, -n)], -fQim[QIndex(ptbin, p, -n)]);
 };
 bool GFWCumulant::IsPtBinFilled(int ptb)
 {
-  if (!fFilledPts)
+  if (fFilledPts.empty())
     return false;
   if (ptb > 0) {
     if (fPt == 1)
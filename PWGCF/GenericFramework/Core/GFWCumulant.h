@@ -47,17 +47,26 @@ class GFWCumulant
   void DestroyComplexVectorArray();
   std::complex<double> Vec(int, int, int ptbin = 0); // envelope class to summarize pt-dif. Q-vec getter
  protected:
-  std::complex<double>*** fQvector;
+  // Q-vectors are stored in flat arrays of real and imaginary parts, indexed [pt][power][harmonic].
+  // The harmonic stride is padded to a multiple of kHarmonicPadding, so that the rows of all powers are equally aligned.
+  static constexpr int kHarmonicPadding = 4;
+  int QIndex(int ptbin, int p, int n) const { return (ptbin * fMaxPow + p) * fNStride + n; }
+  std::vector<double> fQre; //! Real parts of Q-vectors
+  std::vector<double> fQim; //! Imaginary parts of Q-vectors
   uint fUsed;
   int fNEntries;
   // Q-vectors. Could be done recursively, but maybe defining each one of them explicitly is easier to read
-  int fN;                   //! Harmonics
-  int fPow;                 //! Power
-  std::vector<int> fPowVec; //! Powers array
-  int fPt;                  //! fPt bins
-  bool* fFilledPts;
+  int fN;                       //! Harmonics
+  int fPow;                     //! Power
+  std::vector<int> fPowVec;     //! Powers array
+  int fPt;                      //! fPt bins
+  int fMaxPow;                  //! Max. power over all harmonics
+  int fNStride;                 //! Padded number of harmonics
+  std::vector<int> fNHarPerPow; //! Number of harmonics to fill for each power
+  std::vector<double> fCosN;    //! Scratch array for cos(n*phi)
+  std::vector<double> fSinN;    //! Scratch array for sin(n*phi)
+  std::vector<char> fFilledPts;
   bool fInitialized; // Arrays are initialized
-  std::complex<double> fNullQ = 0;
 };
 
 #endif // PWGCF_GENERICFRAMEWORK_CORE_GFWCUMULANT_H_
@@ -23,7 +23,8 @@ GFWWeights::GFWWeights() : TNamed("", ""),
                            fIntEff(0),
                            fAccInt(0),
                            fNbinsPt(0),
-                           fbinsPt(0) {}
+                           fbinsPt(0),
+                           fFrozen(kFALSE) {}
 GFWWeights::GFWWeights(const char* name) : TNamed(name, name),
                                            fDataFilled(kFALSE),
                                            fMCFilled(kFALSE),
@@ -34,7 +35,8 @@ GFWWeights::GFWWeights(const char* name) : TNamed(name, name),
                                            fIntEff(0),
                                            fAccInt(0),
                                            fNbinsPt(0),
-                                           fbinsPt(0) {}
+                                           fbinsPt(0),
+                           fFrozen(kFALSE) {}
 GFWWeights::~GFWWeights()
 {
   delete fW_data;
@@ -132,6 +134,11 @@ double GFWWeights::getWeight(double phi, double eta, double vz, double pt, doubl
   }
   if (!tar)
     return 1;
+  if (fFrozen) {
+    if (!fFrozenW[htype].valid())
+      return 1;
+    return fFrozenW[htype].getWeight(htype ? pt : phi, eta, vz);
+  }
   TH3D* th3 = reinterpret_cast<TH3D*>(tar->FindObject(getBinName(0, 0, pf)));
   if (!th3)
     return 1; //-1;
@@ -145,6 +152,14 @@ double GFWWeights::getWeight(double phi, double eta, double vz, double pt, doubl
 };
 double GFWWeights::getNUA(double phi, double eta, double vz)
 {
+  if (fFrozen) {
+    if (!fAccInt) {
+      createNUA();
+      freeze();
+    }
+    if (fFrozenNUA.valid())
+      return fFrozenNUA.getWeight(phi, eta, vz);
+  }
   if (!fAccInt)
     createNUA();
   int xind = fAccInt->GetXaxis()->FindBin(phi);
@@ -157,6 +172,14 @@ double GFWWeights::getNUA(double phi, double eta, double vz)
 }
 double GFWWeights::getNUE(double pt, double eta, double vz)
 {
+  if (fFrozen) {
+    if (!fEffInt) {
+      createNUE();
+      freeze();
+    }
+    if (fFrozenNUE.valid())
+      return fFrozenNUE.getWeight(pt, eta, vz);
+  }
   if (!fEffInt)
     createNUE();
   int xind = fEffInt->GetXaxis()->FindBin(pt);
@@ -167,6 +190,31 @@ double GFWWeights::getNUE(double pt, double eta, double vz)
     return 1. / weight;
   return 1;
 }
+void GFWWeights::FrozenGrid::set(const TH3D* th3)
+{
+  values.clear();
+  if (!th3)
+    return;
+  x.set(th3->GetXaxis());
+  y.set(th3->GetYaxis());
+  z.set(th3->GetZaxis());
+  values.resize(static_cast<size_t>(x.nBins + 2) * (y.nBins + 2) * (z.nBins + 2));
+  for (size_t bin = 0; bin < values.size(); ++bin) {
+    double weight = th3->GetBinContent(bin);
+    values[bin] = (weight != 0) ? 1. / weight : 1.;
+  }
+}
+void GFWWeights::freeze()
+{
+  // Weights are in TH3D's looked up by name for every track, replace with flat grids with the same binning
+  TObjArray* arrays[3] = {fW_data, fW_mcrec, fW_mcgen};
+  const char* pfs[3] = {"data", "mcrec", "mcgen"};
+  for (int i = 0; i < 3; ++i)
+    fFrozenW[i].set(arrays[i] ? reinterpret_cast<TH3D*>(arrays[i]->FindObject(getBinName(0, 0, pfs[i]))) : nullptr);
+  fFrozenNUA.set(fAccInt);
+  fFrozenNUE.set(fEffInt);
+  fFrozen = kTRUE;
+}
 double GFWWeights::findMax(TH3D* inh, int& ix, int& iy, int& iz)
 {
   double maxv = inh->GetBinContent(1, 1, 1);
@@ -26,6 +26,10 @@
 #include "TFile.h"
 #include "TCollection.h"
 #include "TString.h"
+#include "TAxis.h"
+
+#include <algorithm>
+#include <vector>
 
 class GFWWeights : public TNamed
 {
@@ -61,8 +65,50 @@ class GFWWeights : public TNamed
   TH1D* getEfficiency(double etamin, double etamax, double vzmin, double vzmax);
   void mergeWeights(GFWWeights* other);
   void setTH3D(TH3D* th3d);
+  void freeze(); // copy the current weights into flat look-up grids used by getWeight/getNUA/getNUE. Call again if the weights are modified afterwards
+  bool isFrozen() const { return fFrozen; }
 
  private:
+  /// Axis of a frozen grid, reproducing TAxis::FindBin without the TAxis lookup
+  struct FrozenAxis {
+    int nBins = 0;
+    double min = 0;
+    double max = 0;
+    std::vector<double> edges; // only for variable binning
+    void set(const TAxis* axis)
+    {
+      nBins = axis->GetNbins();
+      min = axis->GetXmin();
+      max = axis->GetXmax();
+      edges.clear();
+      if (axis->GetXbins()->fN)
+        edges.assign(axis->GetXbins()->GetArray(), axis->GetXbins()->GetArray() + axis->GetXbins()->fN);
+    }
+    int findBin(double x) const
+    {
+      if (x < min)
+        return 0;
+      if (!(x < max))
+        return nBins + 1;
+      if (edges.empty())
+        return 1 + static_cast<int>(nBins * (x - min) / (max - min));
+      return static_cast<int>(std::upper_bound(edges.begin(), edges.end(), x) - edges.begin());
+    }
+  };
+  /// Inverse weights of a TH3D stored in a flat array with the same global bin layout, under- and overflow included
+  struct FrozenGrid {
+    FrozenAxis x;
+    FrozenAxis y;
+    FrozenAxis z;
+    std::vector<float> values; // 1/content, 1 for empty bins
+    bool valid() const { return !values.empty(); }
+    void set(const TH3D* th3);
+    double getWeight(double vx, double vy, double vz) const
+    {
+      return values[x.findBin(vx) + (x.nBins + 2) * (y.findBin(vy) + (y.nBins + 2) * z.findBin(vz))];
+    }
+  };
+
   bool fDataFilled;
   bool fMCFilled;
   TObjArray* fW_data;
@@ -73,6 +119,11 @@ class GFWWeights : public TNamed
   TH3D* fAccInt;   //!
   int fNbinsPt;    //! do not store
   double* fbinsPt; //! do not store
+
+  bool fFrozen;           //!
+  FrozenGrid fFrozenW[3]; //! data, mc rec, mc gen
+  FrozenGrid fFrozenNUA;  //! from fAccInt
+  FrozenGrid fFrozenNUE;  //! from fEffInt
   void addArray(TObjArray* targ, TObjArray* sour);
   const char* getBinName(double /*ptv*/, double /*v0mv*/, const char* pf = "")
   {
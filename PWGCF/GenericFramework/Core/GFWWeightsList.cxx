@@ -87,11 +87,16 @@ GFWWeights* GFWWeightsList::getGFWWeightsByRun(int runNumber)
     LOGF(error, "weight list is not initialized\n");
     return nullptr;
   }
-  if (!runNumberMap.contains(runNumber)) {
+  if (runNumber == lastRun)
+    return lastRunWeights;
+  auto it = runNumberMap.find(runNumber);
+  if (it == runNumberMap.end()) {
     LOGF(error, "weight for run %d is not found\n", runNumber);
     return nullptr;
   }
-  return runNumberMap.at(runNumber);
+  lastRun = runNumber;
+  lastRunWeights = it->second;
+  return lastRunWeights;
 }
 
 void GFWWeightsList::addPIDGFWWeightsByName(const char* weightName, int nPtBins, double* ptBins, double ptrefup, bool addData, bool addMC)
@@ -161,11 +166,23 @@ GFWWeights* GFWWeightsList::getPIDGFWWeightsByRun(int runNumber, int pidIndex)
     LOGF(error, "weight list is not initialized\n");
     return nullptr;
   }
-  if (!runNumberPIDMap.contains(runNumber)) {
-    LOGF(error, "PID weights for run %d is not found\n", runNumber);
-    return nullptr;
+  if (runNumber != lastPIDRun) {
+    auto it = runNumberPIDMap.find(runNumber);
+    if (it == runNumberPIDMap.end()) {
+      LOGF(error, "PID weights for run %d is not found\n", runNumber);
+      return nullptr;
+    }
+    lastPIDRun = runNumber;
+    lastPIDRunWeights = &(it->second);
   }
-  return runNumberPIDMap.at(runNumber)[pidIndex];
+  return (*lastPIDRunWeights)[pidIndex];
+}
+void GFWWeightsList::freeze()
+{
+  if (!list)
+    return;
+  for (int i = 0; i < list->GetEntries(); i++)
+    reinterpret_cast<GFWWeights*>(list->At(i))->freeze();
 }
 Long64_t GFWWeightsList::Merge(TCollection* collist)
 {
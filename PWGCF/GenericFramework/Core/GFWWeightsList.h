@@ -47,6 +47,8 @@ class GFWWeightsList : public TNamed
       printf("%i\n", el.first);
   }
 
+  void freeze(); // freeze all weights in the list, see GFWWeights::freeze
+
   TObjArray* getList() const { return list; }
   Long64_t Merge(TCollection* collist);
 
@@ -55,6 +57,10 @@ class GFWWeightsList : public TNamed
   std::vector<std::string> species = {"_ref", "_ch", "_pi", "_ka", "_pr"}; //!
   std::map<int, GFWWeights*> runNumberMap;
   std::map<int, std::vector<GFWWeights*>> runNumberPIDMap;
+  int lastRun = -1;                                      //! run of the last getGFWWeightsByRun call
+  GFWWeights* lastRunWeights = nullptr;                  //!
+  int lastPIDRun = -1;                                   //! run of the last getPIDGFWWeightsByRun call
+  std::vector<GFWWeights*>* lastPIDRunWeights = nullptr; //!
   void addArray(TObjArray* target, TObjArray* source);
 
   ClassDef(GFWWeightsList, 1);
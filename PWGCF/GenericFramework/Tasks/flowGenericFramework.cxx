@@ -178,6 +178,7 @@ struct FlowGenericFramework {
   // Generic Framework
   GFW* fGFW = new GFW();
   std::vector<GFW::CorrConfig> corrconfigs;
+  std::vector<std::vector<int>> fcCorrIndices; // FlowContainer bin of each correlator (and pT bin), looked up once in init
 
   TRandom3* fRndm = new TRandom3(0);
   TAxis* fPtAxis;
@@ -373,6 +374,17 @@ struct FlowGenericFramework {
       fFCgen->Initialize(oba, multAxis, cfgNbootstrap);
     }
     delete oba;
+    FlowContainer* fcForIndices = (doprocessData || doprocessRun2 || doprocessMCReco) ? fFC.object.get() : fFCgen.object.get();
+    for (const auto& corrconf : corrconfigs) {
+      std::vector<int> indices;
+      if (!corrconf.pTDif) {
+        indices.push_back(fcForIndices->GetCorrIndex(corrconf.Head.c_str()));
+      } else {
+        for (int i = 1; i <= fPtAxis->GetNbins(); i++)
+          indices.push_back(fcForIndices->GetCorrIndex(Form("%s_pt_%i", corrconf.Head.c_str(), i)));
+      }
+      fcCorrIndices.push_back(indices);
+    }
     fFCpt->setUseCentralMoments(cfgUseCentralMoments);
     fFCpt->setUseGapMethod(cfgUseGapMethod);
     fFCpt->initialise(multAxis, cfgMpar, o2::analysis::gfw::configs, cfgNbootstrap);
@@ -473,6 +485,10 @@ struct FlowGenericFramework {
       } else {
         cfg.mAcceptance.push_back(ccdb->getForTimeStamp<GFWWeights>(cfgAcceptance.value + runstr, timestamp));
       }
+      for (const auto& acc : cfg.mAcceptance) {
+        if (acc)
+          acc->freeze();
+      }
     }
     if (!cfgEfficiency.value.empty()) {
       cfg.mEfficiency = ccdb->getForTimeStamp<TH1D>(cfgEfficiency, timestamp);
@@ -734,7 +750,7 @@ struct FlowGenericFramework {
           continue;
         auto val = fGFW->Calculate(corrconfigs.at(l_ind), 0, kFALSE).real() / dnx;
         if (std::abs(val) < 1) {
-          (dt == kGen) ? fFCgen->FillProfile(corrconfigs.at(l_ind).Head.c_str(), centmult, val, dnx, rndm) : fFC->FillProfile(corrconfigs.at(l_ind).Head.c_str(), centmult, val, dnx, rndm);
+          (dt == kGen) ? fFCgen->FillProfile(fcCorrIndices[l_ind][0], centmult, val, dnx, rndm) : fFC->FillProfile(fcCorrIndices[l_ind][0], centmult, val, dnx, rndm);
           if (cfgUseGapMethod)
             fFCpt->fillVnPtProfiles(centmult, val, dnx, rndm, o2::analysis::gfw::configs.GetpTCorrMasks()[l_ind]);
         }
@@ -746,7 +762,7 @@ struct FlowGenericFramework {
           continue;
         auto val = fGFW->Calculate(corrconfigs.at(l_ind), i - 1, kFALSE).real() / dnx;
         if (std::abs(val) < 1)
-          (dt == kGen) ? fFCgen->FillProfile(Form("%s_pt_%i", corrconfigs.at(l_ind).Head.c_str(), i), centmult, val, dnx, rndm) : fFC->FillProfile(Form("%s_pt_%i", corrconfigs.at(l_ind).Head.c_str(), i), centmult, val, dnx, rndm);
+          (dt == kGen) ? fFCgen->FillProfile(fcCorrIndices[l_ind][i - 1], centmult, val, dnx, rndm) : fFC->FillProfile(fcCorrIndices[l_ind][i - 1], centmult, val, dnx, rndm);
       }
     }
     return;
@@ -45,7 +45,7 @@ struct : ConfigurableGroup {
   Configurable<std::string> cfSkipTheseRuns{"cfSkipTheseRuns", "", "Set here via comma-separated list which runs will be skipped during hl analysis (a.k.a. \"bad runs\"). Leave empty to ignore. Example format and list for LHC23zzh: \"544116,544091\""};
   Configurable<bool> cfUseSetBinLabel{"cfUseSetBinLabel", false, "until hist->SetBinLabel(...) large memory consumption is resolved, for each histogram dump all that info in the y-axis title. See also local executable PostprocessLabels.C, where I do the final bin labeling offline"};
   Configurable<bool> cfUseClone{"cfUseClone", false, "until hist->Clone(...) large memory consumption is resolved, do not use cloning. See ROOT Forum thread."};
-  Configurable<bool> cfUseFormula{"cfUseFormula", false, "until TFormula large memory consumption is resolved, do not use this class. See ROOT Forum thread."};
+  Configurable<bool> cfUseFormula{"cfUseFormula", false, "evaluate the formula-based event cuts with FormulaEvaluator (TFormula syntax, without its memory blow-up), instead of the p0 + p1*x workaround"};
 } cf_tc;
 
 // *) QA:
@@ -254,6 +254,7 @@ struct : ConfigurableGroup {
   Configurable<bool> cfCalculateCustomNestedLoops{"cfCalculateCustomNestedLoops", false, "cross-check e-b-e all correlations with custom nested loops"};
   Configurable<bool> cfCalculateKineCustomNestedLoops{"cfCalculateKineCustomNestedLoops", false, "cross-check e-b-e all differential (vs. pt, eta, etc.) correlations with custom nested loops"};
   Configurable<int> cfMaxNestedLoop{"cfMaxNestedLoop", -1, "if set to e.g. 4, all nested loops beyond that, e.g. 6-p and 8-p, are NOT calculated"};
+  Configurable<int> cfNestedLoopsThreads{"cfNestedLoopsThreads", 1, "number of threads sharing the nested loops of cfCalculateNestedLoops (1 = no additional threads)"};
 } cf_nl;
 
 // *) Toy NUA:
@@ -79,7 +79,7 @@ struct TaskConfiguration {
   bool fUseSetBinLabel = false;          // until SetBinLabel(...) large memory consumption is resolved, do not use hist->SetBinLabel(...), see ROOT Forum
                                          // See also local executable PostprocessLabels.C
   bool fUseClone = false;                // until Clone(...) large memory consumption is resolved, do not use hist->Clone(...), see ROOT Forum
-  bool fUseFormula = false;              // until TFormula large memory consumption is resolved, do not use, see ROOT Forum
+  bool fUseFormula = false;              // evaluate the formula-based event cuts with FormulaEvaluator, instead of the p0 + p1*x workaround
 } tc;                                    // "tc" labels an instance of this group of variables.
 
 // *) Event-by-event quantities:
@@ -195,7 +195,7 @@ struct EventCuts {
   float fCentralityCorrelationsCutTreshold = 5.;               // see bool CentralityCorrelationCut()
   TString fCentralityCorrelationsCutVersion = "Absolute";      // see bool CentralityCorrelationCut()
   float fCentralityValues[2] = {0.};                           // [0] value of first cent. estimator, [1] = value of second cent. estimator, when CentralityCorrelationsCut is requested
-  TFormula* fEventCutsFormulas[eEventCutsFormulas_N] = {NULL}; // see enum TBI 20250415 I do not use it for the time being, due to memory blow-up in TFormula
+  o2::common::core::FormulaEvaluator fEventCutsFormulas[eEventCutsFormulas_N]; // see enum, formulas compiled without TFormula, to avoid its memory blow-up
   float fdEventCutsFormulas[eEventCutsFormulas_N][2] = {{0.}}; // I need this only temporarily until large memory consumption with TFormula is resolved.
                                                                // I support at the moment only linear cut in the format p0 + p1*x. Then, [0] = p0, [1] = p1.
 } ec;                                                          // "ec" is a common label for objects in this struct
@@ -249,16 +249,22 @@ struct ParticleCuts {
   float fdParticleCuts[eParticleCuts_N][2] = {{0.}};          // particles cuts defined via [min,max) . Remark: I use here eParticleHistograms_N , not to duplicate these enums for ParticleCuts.
   TString fsParticleCuts[eParticleCuts_N] = {""};             // particles cuts defined via booleans via string
   TH1F* fParticleCutCounterHist[2][eCutCounter_N] = {{NULL}}; //!<! [rec,sim][see enum eCutCounter] histogram to store how many any times each particle cut triggered
-  TFormula* fPtDependentDCAxyFormula = NULL;                  // the actual formula, used to evaluate for a given pT, the corresponding DCAxy, where the parameterization is given by configurable cfPtDependentDCAxyParameterization
+  o2::common::core::FormulaEvaluator fPtDependentDCAxyFormula; // the actual formula, used to evaluate for a given pT, the corresponding DCAxy, where the parameterization is given by configurable cfPtDependentDCAxyParameterization
 } pc;                                                         // "pc" is a common label for objects in this struct
 
 // *) Q-vectors:
+struct RecursionKeyHash { // hash of the keys of memoised correlators, see RecursionMemoised()
+  size_t operator()(const std::pair<uint64_t, uint64_t>& key) const { return std::hash<uint64_t>{}(key.first ^ (key.second * 0x9E3779B97F4A7C15ULL)); }
+};
 struct Qvector {
   TList* fQvectorList = NULL;                                                                                                          // list to hold all Q-vector objects
   TProfile* fQvectorFlagsPro = NULL;                                                                                                   // profile to hold all flags for Q-vector
   bool fCalculateQvectors = true;                                                                                                      // to calculate or not to calculate Q-vectors, that's a Boolean...
                                                                                                                                        // Does NOT apply to Qa, Qb, etc., vectors, needed for eta separ.
   TComplex fQ[gMaxHarmonic * gMaxCorrelator + 1][gMaxCorrelator + 1] = {{TComplex(0., 0.)}};                                           //! generic Q-vector
+  std::complex<double> fQtable[2 * gMaxHarmonic * gMaxCorrelator + 1][gMaxCorrelator + 1] = {{std::complex<double>(0., 0.)}};          //! generic Q-vector as a contiguous table for RecursionMemoised(), [n + gMaxHarmonic * gMaxCorrelator][wp], also for n < 0
+  bool fQtableIsFilled = false;                                                                                                        //! fQtable and fRecursionMemo correspond to the current content of fQ
+  std::unordered_map<std::pair<uint64_t, uint64_t>, std::complex<double>, RecursionKeyHash> fRecursionMemo;                            //! memoised sub-correlators of RecursionMemoised(), for the current content of fQ
   TComplex fQvector[gMaxHarmonic * gMaxCorrelator + 1][gMaxCorrelator + 1] = {{TComplex(0., 0.)}};                                     //! "integrated" Q-vector
   TComplex fqvector[eqvectorKine_N][gMaxNoBinsKine][gMaxHarmonic * gMaxCorrelator + 1][gMaxCorrelator + 1] = {{{{TComplex(0., 0.)}}}}; //! "differenttial" q-vector [kine var.][binNo][fMaxHarmonic*fMaxCorrelator+1][fMaxCorrelator+1] = [6*12+1][12+1]
   int fqVectorEntries[eqvectorKine_N][gMaxNoBinsKine] = {{0}};                                                                         // count number of entries in each differential q-vector
@@ -315,6 +321,15 @@ struct CentralityWeights {
 } cw;
 
 // *) Nested loops:
+struct NestedLoopsWorkspace {                        // per-thread accumulators of the nested loops, see CalculateNestedLoops()
+  std::vector<char> fUsed;                           // particles already in the current combination
+  int fIndex[gMaxCorrelator] = {0};                  // particle indices of the current combination
+  double fRe[gMaxCorrelator][gMaxHarmonic] = {{0.}}; // running product of exp(+-i(h+1)phi) up to each position, real part
+  double fIm[gMaxCorrelator][gMaxHarmonic] = {{0.}}; // running product of exp(+-i(h+1)phi) up to each position, imaginary part
+  double fW[gMaxCorrelator] = {0.};                  // running product of particle weights up to each position
+  double fSumWCos[gMaxHarmonic] = {0.};              // sum over visited combinations of weight * cos
+  double fSumW = 0.;                                 // sum over visited combinations of weight
+};
 struct NestedLoops {
   TList* fNestedLoopsList = NULL;                                              // list to hold all nested loops objects
   TProfile* fNestedLoopsFlagsPro = NULL;                                       // profile to hold all flags for nested loops
@@ -322,6 +337,7 @@ struct NestedLoops {
   bool fCalculateCustomNestedLoops = false;                                    // validate e-b-e all correlations with custom nested loop
   bool fCalculateKineCustomNestedLoops = false;                                // validate e-b-e all differential (vs pt, eta, etc.) correlations with custom nested loop
   int fMaxNestedLoop = -1;                                                     // if set to e.g. 4, all nested loops beyond that, e.g. 6-p and 8-p, are NOT calculated
+  int fNestedLoopsThreads = 1;                                                 // number of threads sharing the nested loops of fCalculateNestedLoops
   TProfile* fNestedLoopsPro[4][gMaxHarmonic][eAsFunctionOf_N] = {{{NULL}}};    //! multiparticle correlations from nested loops
                                                                                //! [2p=0,4p=1,6p=2,8p=3][n=1,n=2,...,n=gMaxHarmonic][0=integrated,1=vs.
                                                                                //! multiplicity,2=vs. centrality,3=pT,4=eta]
@@ -611,6 +611,7 @@ void DefaultConfiguration()
   nl.fCalculateCustomNestedLoops = cf_nl.cfCalculateCustomNestedLoops;
   nl.fCalculateKineCustomNestedLoops = cf_nl.cfCalculateKineCustomNestedLoops;
   nl.fMaxNestedLoop = cf_nl.cfMaxNestedLoop;
+  nl.fNestedLoopsThreads = cf_nl.cfNestedLoopsThreads;
 
   // ...
 
@@ -4546,12 +4547,13 @@ void BookEventCutsHistograms()
   //  **) eRefMultVsNContrUp:
   if (ec.fUseEventCuts[eRefMultVsNContrUp]) {
     if (tc.fUseFormula) {
-      ec.fEventCutsFormulas[eRefMultVsNContrUp_Formula] = new TFormula("RefMultVsNContrUp_Formula", ec.fsEventCuts[eRefMultVsNContrUp].Data());
-
-      LOGF(info, "\033[1;33m%s at line %d: !!!! WARNING !!!! There is a large memory blow-up when using TFormula() !!!! WARNING !!!! \033[0m", __FUNCTION__, __LINE__);
+      // Compiled once with FormulaEvaluator, which has the TFormula syntax but not its memory blow-up:
+      if (!ec.fEventCutsFormulas[eRefMultVsNContrUp_Formula].compile(ec.fsEventCuts[eRefMultVsNContrUp].Data())) {
+        LOGF(fatal, "\033[1;31m%s at line %d : cannot compile formula %s : %s\033[0m", __FUNCTION__, __LINE__, ec.fsEventCuts[eRefMultVsNContrUp].Data(), ec.fEventCutsFormulas[eRefMultVsNContrUp_Formula].error().data());
+      }
 
       // As a quick insanity check, try immediately to evaluate something from this formula:
-      if (std::isnan(ec.fEventCutsFormulas[eRefMultVsNContrUp_Formula]->Eval(1.44))) {
+      if (std::isnan(ec.fEventCutsFormulas[eRefMultVsNContrUp_Formula].eval(1.44))) {
         LOGF(fatal, "\033[1;31m%s at line %d\033[0m", __FUNCTION__, __LINE__);
       }
     } else {
@@ -4570,12 +4572,13 @@ void BookEventCutsHistograms()
   //  **) eRefMultVsNContrLow:
   if (ec.fUseEventCuts[eRefMultVsNContrLow]) {
     if (tc.fUseFormula) {
-      ec.fEventCutsFormulas[eRefMultVsNContrLow_Formula] = new TFormula("RefMultVsNContrLow_Formula", ec.fsEventCuts[eRefMultVsNContrLow].Data());
-
-      LOGF(info, "\033[1;33m%s at line %d: !!!! WARNING !!!! There is a large memory blow-up when using TFormula() !!!! WARNING !!!! \033[0m", __FUNCTION__, __LINE__);
+      // Compiled once with FormulaEvaluator, which has the TFormula syntax but not its memory blow-up:
+      if (!ec.fEventCutsFormulas[eRefMultVsNContrLow_Formula].compile(ec.fsEventCuts[eRefMultVsNContrLow].Data())) {
+        LOGF(fatal, "\033[1;31m%s at line %d : cannot compile formula %s : %s\033[0m", __FUNCTION__, __LINE__, ec.fsEventCuts[eRefMultVsNContrLow].Data(), ec.fEventCutsFormulas[eRefMultVsNContrLow_Formula].error().data());
+      }
 
       // As a quick insanity check, try immediately to evaluate something from this formula:
-      if (std::isnan(ec.fEventCutsFormulas[eRefMultVsNContrLow_Formula]->Eval(1.44))) {
+      if (std::isnan(ec.fEventCutsFormulas[eRefMultVsNContrLow_Formula].eval(1.44))) {
         LOGF(fatal, "\033[1;31m%s at line %d\033[0m", __FUNCTION__, __LINE__);
       }
     } else {
@@ -5126,12 +5129,13 @@ void BookParticleCutsHistograms()
 
   // d) Book the formula for pt-dependent DCAxy cut:
   if (pc.fUseParticleCuts[ePtDependentDCAxyParameterization]) {
-    pc.fPtDependentDCAxyFormula = new TFormula("fPtDependentDCAxyFormula", pc.fsParticleCuts[ePtDependentDCAxyParameterization].Data());
-
-    LOGF(info, "\033[1;33m%s at line %d: !!!! WARNING !!!! There is a large memory blow-up when using TFormula() !!!! WARNING !!!! \033[0m", __FUNCTION__, __LINE__);
+    // Compiled once with FormulaEvaluator, which has the TFormula syntax but not its memory blow-up:
+    if (!pc.fPtDependentDCAxyFormula.compile(pc.fsParticleCuts[ePtDependentDCAxyParameterization].Data())) {
+      LOGF(fatal, "\033[1;31m%s at line %d : cannot compile formula %s : %s\033[0m", __FUNCTION__, __LINE__, pc.fsParticleCuts[ePtDependentDCAxyParameterization].Data(), pc.fPtDependentDCAxyFormula.error().data());
+    }
 
     // As a quick insanity check, try immediately to evaluate something from this formula:
-    if (std::isnan(pc.fPtDependentDCAxyFormula->Eval(1.44))) {
+    if (std::isnan(pc.fPtDependentDCAxyFormula.eval(1.44))) {
       LOGF(fatal, "\033[1;31m%s at line %d\033[0m", __FUNCTION__, __LINE__);
     }
   } // if(pc.fUseParticleCuts[ePtDependentDCAxyParameterization]) {
@@ -7778,7 +7782,7 @@ bool EventCuts(T1 const& collision, T2 const& tracks, eCutModus cutModus)
     if (ec.fUseEventCuts[eRefMultVsNContrUp]) {
       if (cutModus == eCutCounterBinning) {
         EventCut(eRec, eRefMultVsNContrUp, eCutCounterBinning);
-      } else if (collision.numContrib() > (tc.fUseFormula ? ec.fEventCutsFormulas[eRefMultVsNContrUp_Formula]->Eval(ebye.fReferenceMultiplicity) : RefMultVsNContr(ebye.fReferenceMultiplicity, eRefMultVsNContrUp_Formula))) {
+      } else if (collision.numContrib() > (tc.fUseFormula ? ec.fEventCutsFormulas[eRefMultVsNContrUp_Formula].eval(ebye.fReferenceMultiplicity) : RefMultVsNContr(ebye.fReferenceMultiplicity, eRefMultVsNContrUp_Formula))) {
         if (!EventCut(eRec, eRefMultVsNContrUp, cutModus)) {
           return false;
         }
@@ -7789,7 +7793,7 @@ bool EventCuts(T1 const& collision, T2 const& tracks, eCutModus cutModus)
     if (ec.fUseEventCuts[eRefMultVsNContrLow]) {
       if (cutModus == eCutCounterBinning) {
         EventCut(eRec, eRefMultVsNContrLow, eCutCounterBinning);
-      } else if (collision.numContrib() < (tc.fUseFormula ? ec.fEventCutsFormulas[eRefMultVsNContrLow_Formula]->Eval(ebye.fReferenceMultiplicity) : RefMultVsNContr(ebye.fReferenceMultiplicity, eRefMultVsNContrLow_Formula))) {
+      } else if (collision.numContrib() < (tc.fUseFormula ? ec.fEventCutsFormulas[eRefMultVsNContrLow_Formula].eval(ebye.fReferenceMultiplicity) : RefMultVsNContr(ebye.fReferenceMultiplicity, eRefMultVsNContrLow_Formula))) {
         if (!EventCut(eRec, eRefMultVsNContrLow, cutModus)) {
           return false;
         }
@@ -9574,7 +9578,7 @@ bool ParticleCuts(T const& track, eCutModus cutModus)
     if (pc.fUseParticleCuts[ePtDependentDCAxyParameterization]) {
       if (cutModus == eCutCounterBinning) {
         ParticleCut(eRec, ePtDependentDCAxyParameterization, eCutCounterBinning);
-      } else if (std::abs(track.dcaXY()) > pc.fPtDependentDCAxyFormula->Eval(track.pt())) {
+      } else if (std::abs(track.dcaXY()) > pc.fPtDependentDCAxyFormula.eval(track.pt())) {
         if (!ParticleCut(eRec, ePtDependentDCAxyParameterization, cutModus)) {
           return false;
         }
@@ -10952,6 +10956,7 @@ void CalculateKineTest0(eAsFunctionOf AFO_variable)
         qv.fQ[h][wp] = qv.fqvector[qvKine][b][h][wp];
       }
     }
+    qv.fQtableIsFilled = false; // memoised correlators from the previous bin are no longer valid
 
     // *) Okay, let's do the differential calculus:
     double correlation = 0.;
@@ -11337,10 +11342,19 @@ void CalculateNestedLoops()
 {
   // Calculate correlations with nested loops.
 
-  // a) 2-particle nested loops;
-  // b) 4-particle nested loops;
-  // c) 6-particle nested loops;
-  // d) 8-particle nested loops.
+  // a) Copy the particles into contiguous per-event arrays;
+  // b) 2-particle nested loops;
+  // c) 4-particle nested loops;
+  // d) 6-particle nested loops;
+  // e) 8-particle nested loops.
+
+  // Remarks:
+  // 1. All correlators cos(n(phi1+...+phik-phi(k+1)-...-phi2k)) are symmetric under permutations within each half and under the exchange
+  //    of the two halves. Therefore, only combinations with increasing indices in each half, and with the 1st index of the 2nd half larger
+  //    than the 1st index of the 1st half, are visited, and multiplied with the number of equivalent combinations 2*(k!)^2.
+  // 2. The range of the 1st index is shared dynamically between nl.fNestedLoopsThreads threads, each with its own accumulators.
+  // 3. Sums are merged at the end of each order and filled once per event, with the sum of weights as the weight, i.e. in the
+  //    same way as for the correlations from Q-vectors. Bin content of fNestedLoopsPro is therefore unchanged.
 
   if (tc.fVerbose) {
     StartFunction(__FUNCTION__);
@@ -11362,301 +11376,102 @@ void CalculateNestedLoops()
    cout<<"nParticles = "<<nParticles<<endl;
   */
 
-  // a) 2-particle nested loops:
   if (nParticles < 2) {
     return;
   }
-  if (nl.fMaxNestedLoop > 0 && nl.fMaxNestedLoop < 2) {
-    return;
+
+  // a) Copy the particles into contiguous per-event arrays:
+  std::vector<double> re(nParticles * gMaxHarmonic); // cos((h+1)*phi) of each particle
+  std::vector<double> im(nParticles * gMaxHarmonic); // sin((h+1)*phi) of each particle
+  std::vector<double> w(nParticles);                 // product of all particle weights
+  for (int i = 0; i < nParticles; i++) {
+    double dPhi = nl.ftaNestedLoops[0]->GetAt(i);
+    w[i] = nl.ftaNestedLoops[1]->GetAt(i);
+    for (int h = 0; h < gMaxHarmonic; h++) {
+      re[i * gMaxHarmonic + h] = std::cos((h + 1.) * dPhi);
+      im[i * gMaxHarmonic + h] = std::sin((h + 1.) * dPhi);
+    }
   }
-  LOGF(info, "  Calculating 2-p correlations with nested loops .... ");
-  for (int i1 = 0; i1 < nParticles; i1++) {
-    double dPhi1 = nl.ftaNestedLoops[0]->GetAt(i1);
-    double dW1 = nl.ftaNestedLoops[1]->GetAt(i1);
-    for (int i2 = 0; i2 < nParticles; i2++) {
-      if (i2 == i1) {
-        continue;
-      }
-      double dPhi2 = nl.ftaNestedLoops[0]->GetAt(i2);
-      double dW2 = nl.ftaNestedLoops[1]->GetAt(i2);
-      for (int h = 0; h < gMaxHarmonic; h++) {
-        // fill cos, 2p, integreated:
-        if (nl.fNestedLoopsPro[0][h][AFO_INTEGRATED]) {
-          nl.fNestedLoopsPro[0][h][AFO_INTEGRATED]->Fill(
-            0.5, std::cos((h + 1.) * (dPhi1 - dPhi2)), dW1 * dW2);
-        }
-        // fill cos, 2p, vs. multiplicity:
-        if (nl.fNestedLoopsPro[0][h][AFO_MULTIPLICITY]) {
-          nl.fNestedLoopsPro[0][h][AFO_MULTIPLICITY]->Fill(
-            ebye.fMultiplicity + 0.5, std::cos((h + 1.) * (dPhi1 - dPhi2)),
-            dW1 * dW2);
-        }
-        // fill cos, 2p, vs. centrality:
-        if (nl.fNestedLoopsPro[0][h][AFO_CENTRALITY]) {
-          nl.fNestedLoopsPro[0][h][AFO_CENTRALITY]->Fill(
-            ebye.fCentrality, std::cos((h + 1.) * (dPhi1 - dPhi2)), dW1 * dW2);
-        }
-        // fill cos, 2p, vs. occupancy:
-        if (nl.fNestedLoopsPro[0][h][AFO_OCCUPANCY]) {
-          nl.fNestedLoopsPro[0][h][AFO_OCCUPANCY]->Fill(
-            ebye.fOccupancy, std::cos((h + 1.) * (dPhi1 - dPhi2)), dW1 * dW2);
-        }
-        // fill cos, 2p, vs. interaction rate:
-        if (nl.fNestedLoopsPro[0][h][AFO_INTERACTIONRATE]) {
-          nl.fNestedLoopsPro[0][h][AFO_INTERACTIONRATE]->Fill(
-            ebye.fInteractionRate, std::cos((h + 1.) * (dPhi1 - dPhi2)), dW1 * dW2);
-        }
-        // fill cos, 2p, vs. current run duration:
-        if (nl.fNestedLoopsPro[0][h][AFO_CURRENTRUNDURATION]) {
-          nl.fNestedLoopsPro[0][h][AFO_CURRENTRUNDURATION]->Fill(
-            ebye.fCurrentRunDuration, std::cos((h + 1.) * (dPhi1 - dPhi2)), dW1 * dW2);
-        }
-        // fill cos, 2p, vs. vertex z position:
-        if (nl.fNestedLoopsPro[0][h][AFO_VZ]) {
-          nl.fNestedLoopsPro[0][h][AFO_VZ]->Fill(
-            ebye.fVz, std::cos((h + 1.) * (dPhi1 - dPhi2)), dW1 * dW2);
-        }
 
-      } // for(int h=1; h<=6; h++)
-    } // for(int i2=0; i2<nParticles; i2++)
-  } // for(int i1=0; i1<nParticles; i1++)
-  LOGF(info, "  Done! ");
+  // b) - e) 2-, 4-, 6- and 8-particle nested loops:
+  for (int o = 0; o < 4; o++) { // [2p=0,4p=1,6p=2,8p=3]
+    int order = 2 * (o + 1);
+    if (nParticles < order) {
+      return;
+    }
+    if (nl.fMaxNestedLoop > 0 && nl.fMaxNestedLoop < order) {
+      return;
+    }
+    LOGF(info, "  Calculating %d-p correlations with nested loops .... ", order);
 
-  // b) 4-particle nested loops:
-  if (nParticles < 4) {
-    return;
-  }
-  if (nl.fMaxNestedLoop > 0 && nl.fMaxNestedLoop < 4) {
-    return;
-  }
-  LOGF(info, "  Calculating 4-p correlations with nested loops .... ");
-  for (int i1 = 0; i1 < nParticles; i1++) {
-    double dPhi1 = nl.ftaNestedLoops[0]->GetAt(i1);
-    double dW1 = nl.ftaNestedLoops[1]->GetAt(i1);
-    for (int i2 = 0; i2 < nParticles; i2++) {
-      if (i2 == i1) {
-        continue;
+    int nThreads = std::max(1, std::min(nl.fNestedLoopsThreads, nParticles));
+    std::vector<NestedLoopsWorkspace> workspaces(nThreads);
+    std::atomic<int> nextIndex(0);
+    auto work = [&](NestedLoopsWorkspace& ws) {
+      ws.fUsed.assign(nParticles, 0);
+      for (int i1 = nextIndex++; i1 < nParticles; i1 = nextIndex++) {
+        NestedLoopsRecursion(ws, o + 1, 0, i1, nParticles, re.data(), im.data(), w.data());
       }
-      double dPhi2 = nl.ftaNestedLoops[0]->GetAt(i2);
-      double dW2 = nl.ftaNestedLoops[1]->GetAt(i2);
-      for (int i3 = 0; i3 < nParticles; i3++) {
-        if (i3 == i1 || i3 == i2) {
-          continue;
-        }
-        double dPhi3 = nl.ftaNestedLoops[0]->GetAt(i3);
-        double dW3 = nl.ftaNestedLoops[1]->GetAt(i3);
-        for (int i4 = 0; i4 < nParticles; i4++) {
-          if (i4 == i1 || i4 == i2 || i4 == i3) {
-            continue;
-          }
-          double dPhi4 = nl.ftaNestedLoops[0]->GetAt(i4);
-          double dW4 = nl.ftaNestedLoops[1]->GetAt(i4);
-          for (int h = 0; h < gMaxHarmonic; h++) {
-            // fill cos, 4p, integreated:
-            if (nl.fNestedLoopsPro[1][h][AFO_INTEGRATED]) {
-              nl.fNestedLoopsPro[1][h][AFO_INTEGRATED]->Fill(0.5, std::cos((h + 1.) * (dPhi1 + dPhi2 - dPhi3 - dPhi4)), dW1 * dW2 * dW3 * dW4);
-            }
-            // fill cos, 4p, all harmonics, vs. M:
-            if (nl.fNestedLoopsPro[1][h][AFO_MULTIPLICITY]) {
-              nl.fNestedLoopsPro[1][h][AFO_MULTIPLICITY]->Fill(ebye.fMultiplicity + 0.5, std::cos((h + 1.) * (dPhi1 + dPhi2 - dPhi3 - dPhi4)), dW1 * dW2 * dW3 * dW4);
-            }
-            // fill cos, 4p, all harmonics, vs. centrality:
-            if (nl.fNestedLoopsPro[1][h][AFO_CENTRALITY]) {
-              nl.fNestedLoopsPro[1][h][AFO_CENTRALITY]->Fill(ebye.fCentrality, std::cos((h + 1.) * (dPhi1 + dPhi2 - dPhi3 - dPhi4)), dW1 * dW2 * dW3 * dW4);
-            }
-            // fill cos, 4p, all harmonics, vs. occupancy:
-            if (nl.fNestedLoopsPro[1][h][AFO_OCCUPANCY]) {
-              nl.fNestedLoopsPro[1][h][AFO_OCCUPANCY]->Fill(ebye.fOccupancy, std::cos((h + 1.) * (dPhi1 + dPhi2 - dPhi3 - dPhi4)), dW1 * dW2 * dW3 * dW4);
-            }
-            // fill cos, 4p, all harmonics, vs. interaction rate:
-            if (nl.fNestedLoopsPro[1][h][AFO_INTERACTIONRATE]) {
-              nl.fNestedLoopsPro[1][h][AFO_INTERACTIONRATE]->Fill(ebye.fInteractionRate, std::cos((h + 1.) * (dPhi1 + dPhi2 - dPhi3 - dPhi4)), dW1 * dW2 * dW3 * dW4);
-            }
-            // fill cos, 4p, all harmonics, vs. current run duratione:
-            if (nl.fNestedLoopsPro[1][h][AFO_CURRENTRUNDURATION]) {
-              nl.fNestedLoopsPro[1][h][AFO_CURRENTRUNDURATION]->Fill(ebye.fCurrentRunDuration, std::cos((h + 1.) * (dPhi1 + dPhi2 - dPhi3 - dPhi4)), dW1 * dW2 * dW3 * dW4);
-            }
-            // fill cos, 4p, all harmonics, vs. vertex z position:
-            if (nl.fNestedLoopsPro[1][h][AFO_VZ]) {
-              nl.fNestedLoopsPro[1][h][AFO_VZ]->Fill(ebye.fVz, std::cos((h + 1.) * (dPhi1 + dPhi2 - dPhi3 - dPhi4)), dW1 * dW2 * dW3 * dW4);
-            }
-          } // for(int h=0; h<gMaxHarmonic; h++)
-        } // for(int i4=0; i4<nParticles; i4++)
-      } // for(int i3=0; i3<nParticles; i3++)
-    } // for(int i2=0; i2<nTracks; i2++)
-  } // for(int i1=0; i1<nTracks; i1++)
-  LOGF(info, "  Done! ");
+    };
+    std::vector<std::thread> threads;
+    for (int t = 1; t < nThreads; t++) {
+      threads.emplace_back(work, std::ref(workspaces[t]));
+    }
+    work(workspaces[0]);
+    for (auto& thread : threads) {
+      thread.join();
+    }
 
-  // c) 6-particle nested loops:
-  if (nParticles < 6) {
-    return;
-  }
-  if (nl.fMaxNestedLoop > 0 && nl.fMaxNestedLoop < 6) {
-    return;
-  }
-  LOGF(info, "  Calculating 6-p correlations with nested loops .... ");
-  for (int i1 = 0; i1 < nParticles; i1++) {
-    double dPhi1 = nl.ftaNestedLoops[0]->GetAt(i1);
-    double dW1 = nl.ftaNestedLoops[1]->GetAt(i1);
-    for (int i2 = 0; i2 < nParticles; i2++) {
-      if (i2 == i1) {
-        continue;
+    // Merge the accumulators and fill:
+    double combinations = 2.; // number of equivalent combinations, 2*(k!)^2
+    for (int k = 2; k <= o + 1; k++) {
+      combinations *= k * k;
+    }
+    double sumW = 0.;
+    double sumWCos[gMaxHarmonic] = {0.};
+    for (const auto& ws : workspaces) {
+      sumW += ws.fSumW;
+      for (int h = 0; h < gMaxHarmonic; h++) {
+        sumWCos[h] += ws.fSumWCos[h];
       }
-      double dPhi2 = nl.ftaNestedLoops[0]->GetAt(i2);
-      double dW2 = nl.ftaNestedLoops[1]->GetAt(i2);
-      for (int i3 = 0; i3 < nParticles; i3++) {
-        if (i3 == i1 || i3 == i2) {
-          continue;
-        }
-        double dPhi3 = nl.ftaNestedLoops[0]->GetAt(i3);
-        double dW3 = nl.ftaNestedLoops[1]->GetAt(i3);
-        for (int i4 = 0; i4 < nParticles; i4++) {
-          if (i4 == i1 || i4 == i2 || i4 == i3) {
-            continue;
-          }
-          double dPhi4 = nl.ftaNestedLoops[0]->GetAt(i4);
-          double dW4 = nl.ftaNestedLoops[1]->GetAt(i4);
-          for (int i5 = 0; i5 < nParticles; i5++) {
-            if (i5 == i1 || i5 == i2 || i5 == i3 || i5 == i4) {
-              continue;
-            }
-            double dPhi5 = nl.ftaNestedLoops[0]->GetAt(i5);
-            double dW5 = nl.ftaNestedLoops[1]->GetAt(i5);
-            for (int i6 = 0; i6 < nParticles; i6++) {
-              if (i6 == i1 || i6 == i2 || i6 == i3 || i6 == i4 || i6 == i5) {
-                continue;
-              }
-              double dPhi6 = nl.ftaNestedLoops[0]->GetAt(i6);
-              double dW6 = nl.ftaNestedLoops[1]->GetAt(i6);
-              for (int h = 0; h < gMaxHarmonic; h++) {
-                // fill cos, 6p, integreated:
-                if (nl.fNestedLoopsPro[2][h][AFO_INTEGRATED]) {
-                  nl.fNestedLoopsPro[2][h][AFO_INTEGRATED]->Fill(0.5, std::cos((h + 1.) * (dPhi1 + dPhi2 + dPhi3 - dPhi4 - dPhi5 - dPhi6)), dW1 * dW2 * dW3 * dW4 * dW5 * dW6);
-                }
-                // fill cos, 6p, all harmonics, vs. M:
-                if (nl.fNestedLoopsPro[2][h][AFO_MULTIPLICITY]) {
-                  nl.fNestedLoopsPro[2][h][AFO_MULTIPLICITY]->Fill(ebye.fMultiplicity + 0.5, std::cos((h + 1.) * (dPhi1 + dPhi2 + dPhi3 - dPhi4 - dPhi5 - dPhi6)), dW1 * dW2 * dW3 * dW4 * dW5 * dW6);
-                }
-                // fill cos, 6p, all harmonics, vs. centrality:
-                if (nl.fNestedLoopsPro[2][h][AFO_CENTRALITY]) {
-                  nl.fNestedLoopsPro[2][h][AFO_CENTRALITY]->Fill(ebye.fCentrality, std::cos((h + 1.) * (dPhi1 + dPhi2 + dPhi3 - dPhi4 - dPhi5 - dPhi6)), dW1 * dW2 * dW3 * dW4 * dW5 * dW6);
-                }
-                // fill cos, 6p, all harmonics, vs. occupancy:
-                if (nl.fNestedLoopsPro[2][h][AFO_OCCUPANCY]) {
-                  nl.fNestedLoopsPro[2][h][AFO_OCCUPANCY]->Fill(ebye.fOccupancy, std::cos((h + 1.) * (dPhi1 + dPhi2 + dPhi3 - dPhi4 - dPhi5 - dPhi6)), dW1 * dW2 * dW3 * dW4 * dW5 * dW6);
-                }
-                // fill cos, 6p, all harmonics, vs. interaction rate:
-                if (nl.fNestedLoopsPro[2][h][AFO_INTERACTIONRATE]) {
-                  nl.fNestedLoopsPro[2][h][AFO_INTERACTIONRATE]->Fill(ebye.fInteractionRate, std::cos((h + 1.) * (dPhi1 + dPhi2 + dPhi3 - dPhi4 - dPhi5 - dPhi6)), dW1 * dW2 * dW3 * dW4 * dW5 * dW6);
-                }
-                // fill cos, 6p, all harmonics, vs. current run duration:
-                if (nl.fNestedLoopsPro[2][h][AFO_CURRENTRUNDURATION]) {
-                  nl.fNestedLoopsPro[2][h][AFO_CURRENTRUNDURATION]->Fill(ebye.fCurrentRunDuration, std::cos((h + 1.) * (dPhi1 + dPhi2 + dPhi3 - dPhi4 - dPhi5 - dPhi6)), dW1 * dW2 * dW3 * dW4 * dW5 * dW6);
-                }
-                // fill cos, 6p, all harmonics, vs. vertex z position:
-                if (nl.fNestedLoopsPro[2][h][AFO_VZ]) {
-                  nl.fNestedLoopsPro[2][h][AFO_VZ]->Fill(ebye.fVz, std::cos((h + 1.) * (dPhi1 + dPhi2 + dPhi3 - dPhi4 - dPhi5 - dPhi6)), dW1 * dW2 * dW3 * dW4 * dW5 * dW6);
-                }
-              } // for(int h=0; h<gMaxHarmonic; h++)
-            } // if(i6==i1||i6==i2||i6==i3||i6==i4||i6==i5){continue;}
-          } // if(i5==i1||i5==i2||i5==i3||i5==i4){continue;}
-        } // for(int i4=0; i4<nParticles; i4++)
-      } // for(int i3=0; i3<nParticles; i3++)
-    } // for(int i2=0; i2<nTracks; i2++)
-  } // for(int i1=0; i1<nTracks; i1++)
-  LOGF(info, "  Done! ");
-
-  // d) 8-particle nested loops:
-  if (nParticles < 8) {
-    return;
-  }
-  if (nl.fMaxNestedLoop > 0 && nl.fMaxNestedLoop < 8) {
-    return;
-  }
-  LOGF(info, "  Calculating 8-p correlations with nested loops .... ");
-  for (int i1 = 0; i1 < nParticles; i1++) {
-    double dPhi1 = nl.ftaNestedLoops[0]->GetAt(i1);
-    double dW1 = nl.ftaNestedLoops[1]->GetAt(i1);
-    for (int i2 = 0; i2 < nParticles; i2++) {
-      if (i2 == i1) {
-        continue;
+    }
+    sumW *= combinations;
+    if (!(sumW > 0.)) {
+      continue;
+    }
+    for (int h = 0; h < gMaxHarmonic; h++) {
+      double correlation = combinations * sumWCos[h] / sumW;
+      // fill cos, integrated:
+      if (nl.fNestedLoopsPro[o][h][AFO_INTEGRATED]) {
+        nl.fNestedLoopsPro[o][h][AFO_INTEGRATED]->Fill(0.5, correlation, sumW);
       }
-      double dPhi2 = nl.ftaNestedLoops[0]->GetAt(i2);
-      double dW2 = nl.ftaNestedLoops[1]->GetAt(i2);
-      for (int i3 = 0; i3 < nParticles; i3++) {
-        if (i3 == i1 || i3 == i2) {
-          continue;
-        }
-        double dPhi3 = nl.ftaNestedLoops[0]->GetAt(i3);
-        double dW3 = nl.ftaNestedLoops[1]->GetAt(i3);
-        for (int i4 = 0; i4 < nParticles; i4++) {
-          if (i4 == i1 || i4 == i2 || i4 == i3) {
-            continue;
-          }
-          double dPhi4 = nl.ftaNestedLoops[0]->GetAt(i4);
-          double dW4 = nl.ftaNestedLoops[1]->GetAt(i4);
-          for (int i5 = 0; i5 < nParticles; i5++) {
-            if (i5 == i1 || i5 == i2 || i5 == i3 || i5 == i4) {
-              continue;
-            }
-            double dPhi5 = nl.ftaNestedLoops[0]->GetAt(i5);
-            double dW5 = nl.ftaNestedLoops[1]->GetAt(i5);
-            for (int i6 = 0; i6 < nParticles; i6++) {
-              if (i6 == i1 || i6 == i2 || i6 == i3 || i6 == i4 || i6 == i5) {
-                continue;
-              }
-              double dPhi6 = nl.ftaNestedLoops[0]->GetAt(i6);
-              double dW6 = nl.ftaNestedLoops[1]->GetAt(i6);
-              for (int i7 = 0; i7 < nParticles; i7++) {
-                if (i7 == i1 || i7 == i2 || i7 == i3 || i7 == i4 || i7 == i5 || i7 == i6) {
-                  continue;
-                }
-                double dPhi7 = nl.ftaNestedLoops[0]->GetAt(i7);
-                double dW7 = nl.ftaNestedLoops[1]->GetAt(i7);
-                for (int i8 = 0; i8 < nParticles; i8++) {
-                  if (i8 == i1 || i8 == i2 || i8 == i3 || i8 == i4 || i8 == i5 || i8 == i6 || i8 == i7) {
-                    continue;
-                  }
-                  double dPhi8 = nl.ftaNestedLoops[0]->GetAt(i8);
-                  double dW8 = nl.ftaNestedLoops[1]->GetAt(i8);
-                  for (int h = 0; h < gMaxHarmonic; h++) {
-                    // fill cos, 8p, integreated:
-                    if (nl.fNestedLoopsPro[3][h][AFO_INTEGRATED]) {
-                      nl.fNestedLoopsPro[3][h][AFO_INTEGRATED]->Fill(0.5, std::cos((h + 1.) * (dPhi1 + dPhi2 + dPhi3 + dPhi4 - dPhi5 - dPhi6 - dPhi7 - dPhi8)), dW1 * dW2 * dW3 * dW4 * dW5 * dW6 * dW7 * dW8);
-                    }
-                    // fill cos, 8p, all harmonics, vs. M:
-                    if (nl.fNestedLoopsPro[3][h][AFO_MULTIPLICITY]) {
-                      nl.fNestedLoopsPro[3][h][AFO_MULTIPLICITY]->Fill(ebye.fMultiplicity + 0.5, std::cos((h + 1.) * (dPhi1 + dPhi2 + dPhi3 + dPhi4 - dPhi5 - dPhi6 - dPhi7 - dPhi8)), dW1 * dW2 * dW3 * dW4 * dW5 * dW6 * dW7 * dW8);
-                    }
-                    // fill cos, 8p, all harmonics, vs. centrality:
-                    if (nl.fNestedLoopsPro[3][h][AFO_CENTRALITY]) {
-                      nl.fNestedLoopsPro[3][h][AFO_CENTRALITY]->Fill(ebye.fCentrality, std::cos((h + 1.) * (dPhi1 + dPhi2 + dPhi3 + dPhi4 - dPhi5 - dPhi6 - dPhi7 - dPhi8)), dW1 * dW2 * dW3 * dW4 * dW5 * dW6 * dW7 * dW8);
-                    }
-                    // fill cos, 8p, all harmonics, vs. occupancy:
-                    if (nl.fNestedLoopsPro[3][h][AFO_OCCUPANCY]) {
-                      nl.fNestedLoopsPro[3][h][AFO_OCCUPANCY]->Fill(ebye.fOccupancy, std::cos((h + 1.) * (dPhi1 + dPhi2 + dPhi3 + dPhi4 - dPhi5 - dPhi6 - dPhi7 - dPhi8)), dW1 * dW2 * dW3 * dW4 * dW5 * dW6 * dW7 * dW8);
-                    }
-                    // fill cos, 8p, all harmonics, vs. interaction rate:
-                    if (nl.fNestedLoopsPro[3][h][AFO_INTERACTIONRATE]) {
-                      nl.fNestedLoopsPro[3][h][AFO_INTERACTIONRATE]->Fill(ebye.fInteractionRate, std::cos((h + 1.) * (dPhi1 + dPhi2 + dPhi3 + dPhi4 - dPhi5 - dPhi6 - dPhi7 - dPhi8)), dW1 * dW2 * dW3 * dW4 * dW5 * dW6 * dW7 * dW8);
-                    }
-                    // fill cos, 8p, all harmonics, vs. current run duration:
-                    if (nl.fNestedLoopsPro[3][h][AFO_CURRENTRUNDURATION]) {
-                      nl.fNestedLoopsPro[3][h][AFO_CURRENTRUNDURATION]->Fill(ebye.fCurrentRunDuration, std::cos((h + 1.) * (dPhi1 + dPhi2 + dPhi3 + dPhi4 - dPhi5 - dPhi6 - dPhi7 - dPhi8)), dW1 * dW2 * dW3 * dW4 * dW5 * dW6 * dW7 * dW8);
-                    }
-                    // fill cos, 8p, all harmonics, vs. vertex z position:
-                    if (nl.fNestedLoopsPro[3][h][AFO_VZ]) {
-                      nl.fNestedLoopsPro[3][h][AFO_VZ]->Fill(ebye.fVz, std::cos((h + 1.) * (dPhi1 + dPhi2 + dPhi3 + dPhi4 - dPhi5 - dPhi6 - dPhi7 - dPhi8)), dW1 * dW2 * dW3 * dW4 * dW5 * dW6 * dW7 * dW8);
-                    }
-                  } // for(int h=0; h<gMaxHarmonic; h++)
-                } // for(int i8=0; i8<nParticles; i8++)
-              } // for(int i7=0; i7<nParticles; i7++)
-            } // for(int i6=0; i6<nParticles; i6++)
-          } // for(int i5=0; i5<nParticles; i6++)
-        } // for(int i4=0; i4<nParticles; i4++)
-      } // for(int i3=0; i3<nParticles; i3++)
-    } // for(int i2=0; i2<nParticles; i2++)
-  } // for(int i1=0; i1<nParticles; i1++)
+      // fill cos, vs. multiplicity:
+      if (nl.fNestedLoopsPro[o][h][AFO_MULTIPLICITY]) {
+        nl.fNestedLoopsPro[o][h][AFO_MULTIPLICITY]->Fill(ebye.fMultiplicity + 0.5, correlation, sumW);
+      }
+      // fill cos, vs. centrality:
+      if (nl.fNestedLoopsPro[o][h][AFO_CENTRALITY]) {
+        nl.fNestedLoopsPro[o][h][AFO_CENTRALITY]->Fill(ebye.fCentrality, correlation, sumW);
+      }
+      // fill cos, vs. occupancy:
+      if (nl.fNestedLoopsPro[o][h][AFO_OCCUPANCY]) {
+        nl.fNestedLoopsPro[o][h][AFO_OCCUPANCY]->Fill(ebye.fOccupancy, correlation, sumW);
+      }
+      // fill cos, vs. interaction rate:
+      if (nl.fNestedLoopsPro[o][h][AFO_INTERACTIONRATE]) {
+        nl.fNestedLoopsPro[o][h][AFO_INTERACTIONRATE]->Fill(ebye.fInteractionRate, correlation, sumW);
+      }
+      // fill cos, vs. current run duration:
+      if (nl.fNestedLoopsPro[o][h][AFO_CURRENTRUNDURATION]) {
+        nl.fNestedLoopsPro[o][h][AFO_CURRENTRUNDURATION]->Fill(ebye.fCurrentRunDuration, correlation, sumW);
+      }
+      // fill cos, vs. vertex z position:
+      if (nl.fNestedLoopsPro[o][h][AFO_VZ]) {
+        nl.fNestedLoopsPro[o][h][AFO_VZ]->Fill(ebye.fVz, correlation, sumW);
+      }
+    } // for(int h=0; h<gMaxHarmonic; h++)
+    LOGF(info, "  Done! ");
+  } // for (int o = 0; o < 4; o++)
 
   if (tc.fVerbose) {
     ExitFunction(__FUNCTION__);
@@ -11666,6 +11481,53 @@ void CalculateNestedLoops()
 
 //============================================================
 
+void NestedLoopsRecursion(NestedLoopsWorkspace& ws, int half, int depth, int index, int nParticles, const double* re, const double* im, const double* w)
+{
+  // Add particle 'index' at position 'depth' of the current combination, and loop over all particles at the next position.
+  // Positions [0, half) are the 1st half of the correlator (exp(+i n phi)), positions [half, 2*half) the 2nd half (exp(-i n phi)).
+  // Indices increase within each half, and the 1st index of the 2nd half is larger than the 1st index of the 1st half (see CalculateNestedLoops()).
+
+  const double sign = (depth < half) ? 1. : -1.;
+  const double* reI = re + index * gMaxHarmonic;
+  const double* imI = im + index * gMaxHarmonic;
+  if (depth == 0) {
+    for (int h = 0; h < gMaxHarmonic; h++) {
+      ws.fRe[0][h] = reI[h];
+      ws.fIm[0][h] = imI[h];
+    }
+    ws.fW[0] = w[index];
+  } else {
+    for (int h = 0; h < gMaxHarmonic; h++) {
+      ws.fRe[depth][h] = ws.fRe[depth - 1][h] * reI[h] - sign * ws.fIm[depth - 1][h] * imI[h];
+      ws.fIm[depth][h] = ws.fIm[depth - 1][h] * reI[h] + sign * ws.fRe[depth - 1][h] * imI[h];
+    }
+    ws.fW[depth] = ws.fW[depth - 1] * w[index];
+  }
+  ws.fIndex[depth] = index;
+
+  int next = depth + 1;
+  if (next == 2 * half) { // complete combination
+    ws.fSumW += ws.fW[depth];
+    for (int h = 0; h < gMaxHarmonic; h++) {
+      ws.fSumWCos[h] += ws.fW[depth] * ws.fRe[depth][h];
+    }
+    return;
+  }
+
+  ws.fUsed[index] = 1;
+  int first = (next == half) ? ws.fIndex[0] + 1 : index + 1;
+  for (int i = first; i < nParticles; i++) {
+    if (next >= half && ws.fUsed[i]) {
+      continue;
+    }
+    NestedLoopsRecursion(ws, half, next, i, nParticles, re, im, w);
+  }
+  ws.fUsed[index] = 0;
+
+} // void NestedLoopsRecursion(NestedLoopsWorkspace& ws, int half, int depth, int index, int nParticles, const double* re, const double* im, const double* w)
+
+//============================================================
+
 void ComparisonNestedLoopsVsCorrelations()
 {
   // Compare analytic results from Q-vectors and brute force results from nested loops.
@@ -11799,10 +11661,13 @@ TComplex Four(int n1, int n2, int n3, int n4)
 TComplex Five(int n1, int n2, int n3, int n4, int n5)
 {
   // Generic five-particle correlation <exp[i(n1*phi1+n2*phi2+n3*phi3+n4*phi4+n5*phi5)]>.
+  // Evaluated with the memoised recursion, which is equivalent to the explicit 52-term expression.
+
+  int harmonic[5] = {n1, n2, n3, n4, n5};
 
-  TComplex five = Q(n1, 1) * Q(n2, 1) * Q(n3, 1) * Q(n4, 1) * Q(n5, 1) - Q(n1 + n2, 2) * Q(n3, 1) * Q(n4, 1) * Q(n5, 1) - Q(n2, 1) * Q(n1 + n3, 2) * Q(n4, 1) * Q(n5, 1) - Q(n1, 1) * Q(n2 + n3, 2) * Q(n4, 1) * Q(n5, 1) + 2. * Q(n1 + n2 + n3, 3) * Q(n4, 1) * Q(n5, 1) - Q(n2, 1) * Q(n3, 1) * Q(n1 + n4, 2) * Q(n5, 1) + Q(n2 + n3, 2) * Q(n1 + n4, 2) * Q(n5, 1) - Q(n1, 1) * Q(n3, 1) * Q(n2 + n4, 2) * Q(n5, 1) + Q(n1 + n3, 2) * Q(n2 + n4, 2) * Q(n5, 1) + 2. * Q(n3, 1) * Q(n1 + n2 + n4, 3) * Q(n5, 1) - Q(n1, 1) * Q(n2, 1) * Q(n3 + n4, 2) * Q(n5, 1) + Q(n1 + n2, 2) * Q(n3 + n4, 2) * Q(n5, 1) + 2. * Q(n2, 1) * Q(n1 + n3 + n4, 3) * Q(n5, 1) + 2. * Q(n1, 1) * Q(n2 + n3 + n4, 3) * Q(n5, 1) - 6. * Q(n1 + n2 + n3 + n4, 4) * Q(n5, 1) - Q(n2, 1) * Q(n3, 1) * Q(n4, 1) * Q(n1 + n5, 2) + Q(n2 + n3, 2) * Q(n4, 1) * Q(n1 + n5, 2) + Q(n3, 1) * Q(n2 + n4, 2) * Q(n1 + n5, 2) + Q(n2, 1) * Q(n3 + n4, 2) * Q(n1 + n5, 2) - 2. * Q(n2 + n3 + n4, 3) * Q(n1 + n5, 2) - Q(n1, 1) * Q(n3, 1) * Q(n4, 1) * Q(n2 + n5, 2) + Q(n1 + n3, 2) * Q(n4, 1) * Q(n2 + n5, 2) + Q(n3, 1) * Q(n1 + n4, 2) * Q(n2 + n5, 2) + Q(n1, 1) * Q(n3 + n4, 2) * Q(n2 + n5, 2) - 2. * Q(n1 + n3 + n4, 3) * Q(n2 + n5, 2) + 2. * Q(n3, 1) * Q(n4, 1) * Q(n1 + n2 + n5, 3) - 2. * Q(n3 + n4, 2) * Q(n1 + n2 + n5, 3) - Q(n1, 1) * Q(n2, 1) * Q(n4, 1) * Q(n3 + n5, 2) + Q(n1 + n2, 2) * Q(n4, 1) * Q(n3 + n5, 2) + Q(n2, 1) * Q(n1 + n4, 2) * Q(n3 + n5, 2) + Q(n1, 1) * Q(n2 + n4, 2) * Q(n3 + n5, 2) - 2. * Q(n1 + n2 + n4, 3) * Q(n3 + n5, 2) + 2. * Q(n2, 1) * Q(n4, 1) * Q(n1 + n3 + n5, 3) - 2. * Q(n2 + n4, 2) * Q(n1 + n3 + n5, 3) + 2. * Q(n1, 1) * Q(n4, 1) * Q(n2 + n3 + n5, 3) - 2. * Q(n1 + n4, 2) * Q(n2 + n3 + n5, 3) - 6. * Q(n4, 1) * Q(n1 + n2 + n3 + n5, 4) - Q(n1, 1) * Q(n2, 1) * Q(n3, 1) * Q(n4 + n5, 2) + Q(n1 + n2, 2) * Q(n3, 1) * Q(n4 + n5, 2) + Q(n2, 1) * Q(n1 + n3, 2) * Q(n4 + n5, 2) + Q(n1, 1) * Q(n2 + n3, 2) * Q(n4 + n5, 2) - 2. * Q(n1 + n2 + n3, 3) * Q(n4 + n5, 2) + 2. * Q(n2, 1) * Q(n3, 1) * Q(n1 + n4 + n5, 3) - 2. * Q(n2 + n3, 2) * Q(n1 + n4 + n5, 3) + 2. * Q(n1, 1) * Q(n3, 1) * Q(n2 + n4 + n5, 3) - 2. * Q(n1 + n3, 2) * Q(n2 + n4 + n5, 3) - 6. * Q(n3, 1) * Q(n1 + n2 + n4 + n5, 4) + 2. * Q(n1, 1) * Q(n2, 1) * Q(n3 + n4 + n5, 3) - 2. * Q(n1 + n2, 2) * Q(n3 + n4 + n5, 3) - 6. * Q(n2, 1) * Q(n1 + n3 + n4 + n5, 4) - 6. * Q(n1, 1) * Q(n2 + n3 + n4 + n5, 4) + 24. * Q(n1 + n2 + n3 + n4 + n5, 5);
+  std::complex<double> five = RecursionMemoised(5, harmonic);
 
-  return five;
+  return TComplex(five.real(), five.imag());
 
 } // TComplex Five(int n1, int n2, int n3, int n4, int n5)
 
@@ -11811,10 +11676,13 @@ TComplex Five(int n1, int n2, int n3, int n4, int n5)
 TComplex Six(int n1, int n2, int n3, int n4, int n5, int n6)
 {
   // Generic six-particle correlation <exp[i(n1*phi1+n2*phi2+n3*phi3+n4*phi4+n5*phi5+n6*phi6)]>.
+  // Evaluated with the memoised recursion, which is equivalent to the explicit 203-term expression.
+
+  int harmonic[6] = {n1, n2, n3, n4, n5, n6};
 
-  TComplex six = Q(n1, 1) * Q(n2, 1) * Q(n3, 1) * Q(n4, 1) * Q(n5, 1) * Q(n6, 1) - Q(n1 + n2, 2) * Q(n3, 1) * Q(n4, 1) * Q(n5, 1) * Q(n6, 1) - Q(n2, 1) * Q(n1 + n3, 2) * Q(n4, 1) * Q(n5, 1) * Q(n6, 1) - Q(n1, 1) * Q(n2 + n3, 2) * Q(n4, 1) * Q(n5, 1) * Q(n6, 1) + 2. * Q(n1 + n2 + n3, 3) * Q(n4, 1) * Q(n5, 1) * Q(n6, 1) - Q(n2, 1) * Q(n3, 1) * Q(n1 + n4, 2) * Q(n5, 1) * Q(n6, 1) + Q(n2 + n3, 2) * Q(n1 + n4, 2) * Q(n5, 1) * Q(n6, 1) - Q(n1, 1) * Q(n3, 1) * Q(n2 + n4, 2) * Q(n5, 1) * Q(n6, 1) + Q(n1 + n3, 2) * Q(n2 + n4, 2) * Q(n5, 1) * Q(n6, 1) + 2. * Q(n3, 1) * Q(n1 + n2 + n4, 3) * Q(n5, 1) * Q(n6, 1) - Q(n1, 1) * Q(n2, 1) * Q(n3 + n4, 2) * Q(n5, 1) * Q(n6, 1) + Q(n1 + n2, 2) * Q(n3 + n4, 2) * Q(n5, 1) * Q(n6, 1) + 2. * Q(n2, 1) * Q(n1 + n3 + n4, 3) * Q(n5, 1) * Q(n6, 1) + 2. * Q(n1, 1) * Q(n2 + n3 + n4, 3) * Q(n5, 1) * Q(n6, 1) - 6. * Q(n1 + n2 + n3 + n4, 4) * Q(n5, 1) * Q(n6, 1) - Q(n2, 1) * Q(n3, 1) * Q(n4, 1) * Q(n1 + n5, 2) * Q(n6, 1) + Q(n2 + n3, 2) * Q(n4, 1) * Q(n1 + n5, 2) * Q(n6, 1) + Q(n3, 1) * Q(n2 + n4, 2) * Q(n1 + n5, 2) * Q(n6, 1) + Q(n2, 1) * Q(n3 + n4, 2) * Q(n1 + n5, 2) * Q(n6, 1) - 2. * Q(n2 + n3 + n4, 3) * Q(n1 + n5, 2) * Q(n6, 1) - Q(n1, 1) * Q(n3, 1) * Q(n4, 1) * Q(n2 + n5, 2) * Q(n6, 1) + Q(n1 + n3, 2) * Q(n4, 1) * Q(n2 + n5, 2) * Q(n6, 1) + Q(n3, 1) * Q(n1 + n4, 2) * Q(n2 + n5, 2) * Q(n6, 1) + Q(n1, 1) * Q(n3 + n4, 2) * Q(n2 + n5, 2) * Q(n6, 1) - 2. * Q(n1 + n3 + n4, 3) * Q(n2 + n5, 2) * Q(n6, 1) + 2. * Q(n3, 1) * Q(n4, 1) * Q(n1 + n2 + n5, 3) * Q(n6, 1) - 2. * Q(n3 + n4, 2) * Q(n1 + n2 + n5, 3) * Q(n6, 1) - Q(n1, 1) * Q(n2, 1) * Q(n4, 1) * Q(n3 + n5, 2) * Q(n6, 1) + Q(n1 + n2, 2) * Q(n4, 1) * Q(n3 + n5, 2) * Q(n6, 1) + Q(n2, 1) * Q(n1 + n4, 2) * Q(n3 + n5, 2) * Q(n6, 1) + Q(n1, 1) * Q(n2 + n4, 2) * Q(n3 + n5, 2) * Q(n6, 1) - 2. * Q(n1 + n2 + n4, 3) * Q(n3 + n5, 2) * Q(n6, 1) + 2. * Q(n2, 1) * Q(n4, 1) * Q(n1 + n3 + n5, 3) * Q(n6, 1) - 2. * Q(n2 + n4, 2) * Q(n1 + n3 + n5, 3) * Q(n6, 1) + 2. * Q(n1, 1) * Q(n4, 1) * Q(n2 + n3 + n5, 3) * Q(n6, 1) - 2. * Q(n1 + n4, 2) * Q(n2 + n3 + n5, 3) * Q(n6, 1) - 6. * Q(n4, 1) * Q(n1 + n2 + n3 + n5, 4) * Q(n6, 1) - Q(n1, 1) * Q(n2, 1) * Q(n3, 1) * Q(n4 + n5, 2) * Q(n6, 1) + Q(n1 + n2, 2) * Q(n3, 1) * Q(n4 + n5, 2) * Q(n6, 1) + Q(n2, 1) * Q(n1 + n3, 2) * Q(n4 + n5, 2) * Q(n6, 1) + Q(n1, 1) * Q(n2 + n3, 2) * Q(n4 + n5, 2) * Q(n6, 1) - 2. * Q(n1 + n2 + n3, 3) * Q(n4 + n5, 2) * Q(n6, 1) + 2. * Q(n2, 1) * Q(n3, 1) * Q(n1 + n4 + n5, 3) * Q(n6, 1) - 2. * Q(n2 + n3, 2) * Q(n1 + n4 + n5, 3) * Q(n6, 1) + 2. * Q(n1, 1) * Q(n3, 1) * Q(n2 + n4 + n5, 3) * Q(n6, 1) - 2. * Q(n1 + n3, 2) * Q(n2 + n4 + n5, 3) * Q(n6, 1) - 6. * Q(n3, 1) * Q(n1 + n2 + n4 + n5, 4) * Q(n6, 1) + 2. * Q(n1, 1) * Q(n2, 1) * Q(n3 + n4 + n5, 3) * Q(n6, 1) - 2. * Q(n1 + n2, 2) * Q(n3 + n4 + n5, 3) * Q(n6, 1) - 6. * Q(n2, 1) * Q(n1 + n3 + n4 + n5, 4) * Q(n6, 1) - 6. * Q(n1, 1) * Q(n2 + n3 + n4 + n5, 4) * Q(n6, 1) + 24. * Q(n1 + n2 + n3 + n4 + n5, 5) * Q(n6, 1) - Q(n2, 1) * Q(n3, 1) * Q(n4, 1) * Q(n5, 1) * Q(n1 + n6, 2) + Q(n2 + n3, 2) * Q(n4, 1) * Q(n5, 1) * Q(n1 + n6, 2) + Q(n3, 1) * Q(n2 + n4, 2) * Q(n5, 1) * Q(n1 + n6, 2) + Q(n2, 1) * Q(n3 + n4, 2) * Q(n5, 1) * Q(n1 + n6, 2) - 2. * Q(n2 + n3 + n4, 3) * Q(n5, 1) * Q(n1 + n6, 2) + Q(n3, 1) * Q(n4, 1) * Q(n2 + n5, 2) * Q(n1 + n6, 2) - Q(n3 + n4, 2) * Q(n2 + n5, 2) * Q(n1 + n6, 2) + Q(n2, 1) * Q(n4, 1) * Q(n3 + n5, 2) * Q(n1 + n6, 2) - Q(n2 + n4, 2) * Q(n3 + n5, 2) * Q(n1 + n6, 2) - 2. * Q(n4, 1) * Q(n2 + n3 + n5, 3) * Q(n1 + n6, 2) + Q(n2, 1) * Q(n3, 1) * Q(n4 + n5, 2) * Q(n1 + n6, 2) - Q(n2 + n3, 2) * Q(n4 + n5, 2) * Q(n1 + n6, 2) - 2. * Q(n3, 1) * Q(n2 + n4 + n5, 3) * Q(n1 + n6, 2) - 2. * Q(n2, 1) * Q(n3 + n4 + n5, 3) * Q(n1 + n6, 2) + 6. * Q(n2 + n3 + n4 + n5, 4) * Q(n1 + n6, 2) - Q(n1, 1) * Q(n3, 1) * Q(n4, 1) * Q(n5, 1) * Q(n2 + n6, 2) + Q(n1 + n3, 2) * Q(n4, 1) * Q(n5, 1) * Q(n2 + n6, 2) + Q(n3, 1) * Q(n1 + n4, 2) * Q(n5, 1) * Q(n2 + n6, 2) + Q(n1, 1) * Q(n3 + n4, 2) * Q(n5, 1) * Q(n2 + n6, 2) - 2. * Q(n1 + n3 + n4, 3) * Q(n5, 1) * Q(n2 + n6, 2) + Q(n3, 1) * Q(n4, 1) * Q(n1 + n5, 2) * Q(n2 + n6, 2) - Q(n3 + n4, 2) * Q(n1 + n5, 2) * Q(n2 + n6, 2) + Q(n1, 1) * Q(n4, 1) * Q(n3 + n5, 2) * Q(n2 + n6, 2) - Q(n1 + n4, 2) * Q(n3 + n5, 2) * Q(n2 + n6, 2) - 2. * Q(n4, 1) * Q(n1 + n3 + n5, 3) * Q(n2 + n6, 2) + Q(n1, 1) * Q(n3, 1) * Q(n4 + n5, 2) * Q(n2 + n6, 2) - Q(n1 + n3, 2) * Q(n4 + n5, 2) * Q(n2 + n6, 2) - 2. * Q(n3, 1) * Q(n1 + n4 + n5, 3) * Q(n2 + n6, 2) - 2. * Q(n1, 1) * Q(n3 + n4 + n5, 3) * Q(n2 + n6, 2) + 6. * Q(n1 + n3 + n4 + n5, 4) * Q(n2 + n6, 2) + 2. * Q(n3, 1) * Q(n4, 1) * Q(n5, 1) * Q(n1 + n2 + n6, 3) - 2. * Q(n3 + n4, 2) * Q(n5, 1) * Q(n1 + n2 + n6, 3) - 2. * Q(n4, 1) * Q(n3 + n5, 2) * Q(n1 + n2 + n6, 3) - 2. * Q(n3, 1) * Q(n4 + n5, 2) * Q(n1 + n2 + n6, 3) + 4. * Q(n3 + n4 + n5, 3) * Q(n1 + n2 + n6, 3) - Q(n1, 1) * Q(n2, 1) * Q(n4, 1) * Q(n5, 1) * Q(n3 + n6, 2) + Q(n1 + n2, 2) * Q(n4, 1) * Q(n5, 1) * Q(n3 + n6, 2) + Q(n2, 1) * Q(n1 + n4, 2) * Q(n5, 1) * Q(n3 + n6, 2) + Q(n1, 1) * Q(n2 + n4, 2) * Q(n5, 1) * Q(n3 + n6, 2) - 2. * Q(n1 + n2 + n4, 3) * Q(n5, 1) * Q(n3 + n6, 2) + Q(n2, 1) * Q(n4, 1) * Q(n1 + n5, 2) * Q(n3 + n6, 2) - Q(n2 + n4, 2) * Q(n1 + n5, 2) * Q(n3 + n6, 2) + Q(n1, 1) * Q(n4, 1) * Q(n2 + n5, 2) * Q(n3 + n6, 2) - Q(n1 + n4, 2) * Q(n2 + n5, 2) * Q(n3 + n6, 2) - 2. * Q(n4, 1) * Q(n1 + n2 + n5, 3) * Q(n3 + n6, 2) + Q(n1, 1) * Q(n2, 1) * Q(n4 + n5, 2) * Q(n3 + n6, 2) - Q(n1 + n2, 2) * Q(n4 + n5, 2) * Q(n3 + n6, 2) - 2. * Q(n2, 1) * Q(n1 + n4 + n5, 3) * Q(n3 + n6, 2) - 2. * Q(n1, 1) * Q(n2 + n4 + n5, 3) * Q(n3 + n6, 2) + 6. * Q(n1 + n2 + n4 + n5, 4) * Q(n3 + n6, 2) + 2. * Q(n2, 1) * Q(n4, 1) * Q(n5, 1) * Q(n1 + n3 + n6, 3) - 2. * Q(n2 + n4, 2) * Q(n5, 1) * Q(n1 + n3 + n6, 3) - 2. * Q(n4, 1) * Q(n2 + n5, 2) * Q(n1 + n3 + n6, 3) - 2. * Q(n2, 1) * Q(n4 + n5, 2) * Q(n1 + n3 + n6, 3) + 4. * Q(n2 + n4 + n5, 3) * Q(n1 + n3 + n6, 3) + 2. * Q(n1, 1) * Q(n4, 1) * Q(n5, 1) * Q(n2 + n3 + n6, 3) - 2. * Q(n1 + n4, 2) * Q(n5, 1) * Q(n2 + n3 + n6, 3) - 2. * Q(n4, 1) * Q(n1 + n5, 2) * Q(n2 + n3 + n6, 3) - 2. * Q(n1, 1) * Q(n4 + n5, 2) * Q(n2 + n3 + n6, 3) + 4. * Q(n1 + n4 + n5, 3) * Q(n2 + n3 + n6, 3) - 6. * Q(n4, 1) * Q(n5, 1) * Q(n1 + n2 + n3 + n6, 4) + 6. * Q(n4 + n5, 2) * Q(n1 + n2 + n3 + n6, 4) - Q(n1, 1) * Q(n2, 1) * Q(n3, 1) * Q(n5, 1) * Q(n4 + n6, 2) + Q(n1 + n2, 2) * Q(n3, 1) * Q(n5, 1) * Q(n4 + n6, 2) + Q(n2, 1) * Q(n1 + n3, 2) * Q(n5, 1) * Q(n4 + n6, 2) + Q(n1, 1) * Q(n2 + n3, 2) * Q(n5, 1) * Q(n4 + n6, 2) - 2. * Q(n1 + n2 + n3, 3) * Q(n5, 1) * Q(n4 + n6, 2) + Q(n2, 1) * Q(n3, 1) * Q(n1 + n5, 2) * Q(n4 + n6, 2) - Q(n2 + n3, 2) * Q(n1 + n5, 2) * Q(n4 + n6, 2) + Q(n1, 1) * Q(n3, 1) * Q(n2 + n5, 2) * Q(n4 + n6, 2) - Q(n1 + n3, 2) * Q(n2 + n5, 2) * Q(n4 + n6, 2) - 2. * Q(n3, 1) * Q(n1 + n2 + n5, 3) * Q(n4 + n6, 2) + Q(n1, 1) * Q(n2, 1) * Q(n3 + n5, 2) * Q(n4 + n6, 2) - Q(n1 + n2, 2) * Q(n3 + n5, 2) * Q(n4 + n6, 2) - 2. * Q(n2, 1) * Q(n1 + n3 + n5, 3) * Q(n4 + n6, 2) - 2. * Q(n1, 1) * Q(n2 + n3 + n5, 3) * Q(n4 + n6, 2) + 6. * Q(n1 + n2 + n3 + n5, 4) * Q(n4 + n6, 2) + 2. * Q(n2, 1) * Q(n3, 1) * Q(n5, 1) * Q(n1 + n4 + n6, 3) - 2. * Q(n2 + n3, 2) * Q(n5, 1) * Q(n1 + n4 + n6, 3) - 2. * Q(n3, 1) * Q(n2 + n5, 2) * Q(n1 + n4 + n6, 3) - 2. * Q(n2, 1) * Q(n3 + n5, 2) * Q(n1 + n4 + n6, 3) + 4. * Q(n2 + n3 + n5, 3) * Q(n1 + n4 + n6, 3) + 2. * Q(n1, 1) * Q(n3, 1) * Q(n5, 1) * Q(n2 + n4 + n6, 3) - 2. * Q(n1 + n3, 2) * Q(n5, 1) * Q(n2 + n4 + n6, 3) - 2. * Q(n3, 1) * Q(n1 + n5, 2) * Q(n2 + n4 + n6, 3) - 2. * Q(n1, 1) * Q(n3 + n5, 2) * Q(n2 + n4 + n6, 3) + 4. * Q(n1 + n3 + n5, 3) * Q(n2 + n4 + n6, 3) - 6. * Q(n3, 1) * Q(n5, 1) * Q(n1 + n2 + n4 + n6, 4) + 6. * Q(n3 + n5, 2) * Q(n1 + n2 + n4 + n6, 4) + 2. * Q(n1, 1) * Q(n2, 1) * Q(n5, 1) * Q(n3 + n4 + n6, 3) - 2. * Q(n1 + n2, 2) * Q(n5, 1) * Q(n3 + n4 + n6, 3) - 2. * Q(n2, 1) * Q(n1 + n5, 2) * Q(n3 + n4 + n6, 3) - 2. * Q(n1, 1) * Q(n2 + n5, 2) * Q(n3 + n4 + n6, 3) + 4. * Q(n1 + n2 + n5, 3) * Q(n3 + n4 + n6, 3) - 6. * Q(n2, 1) * Q(n5, 1) * Q(n1 + n3 + n4 + n6, 4) + 6. * Q(n2 + n5, 2) * Q(n1 + n3 + n4 + n6, 4) - 6. * Q(n1, 1) * Q(n5, 1) * Q(n2 + n3 + n4 + n6, 4) + 6. * Q(n1 + n5, 2) * Q(n2 + n3 + n4 + n6, 4) + 24. * Q(n5, 1) * Q(n1 + n2 + n3 + n4 + n6, 5) - Q(n1, 1) * Q(n2, 1) * Q(n3, 1) * Q(n4, 1) * Q(n5 + n6, 2) + Q(n1 + n2, 2) * Q(n3, 1) * Q(n4, 1) * Q(n5 + n6, 2) + Q(n2, 1) * Q(n1 + n3, 2) * Q(n4, 1) * Q(n5 + n6, 2) + Q(n1, 1) * Q(n2 + n3, 2) * Q(n4, 1) * Q(n5 + n6, 2) - 2. * Q(n1 + n2 + n3, 3) * Q(n4, 1) * Q(n5 + n6, 2) + Q(n2, 1) * Q(n3, 1) * Q(n1 + n4, 2) * Q(n5 + n6, 2) - Q(n2 + n3, 2) * Q(n1 + n4, 2) * Q(n5 + n6, 2) + Q(n1, 1) * Q(n3, 1) * Q(n2 + n4, 2) * Q(n5 + n6, 2) - Q(n1 + n3, 2) * Q(n2 + n4, 2) * Q(n5 + n6, 2) - 2. * Q(n3, 1) * Q(n1 + n2 + n4, 3) * Q(n5 + n6, 2) + Q(n1, 1) * Q(n2, 1) * Q(n3 + n4, 2) * Q(n5 + n6, 2) - Q(n1 + n2, 2) * Q(n3 + n4, 2) * Q(n5 + n6, 2) - 2. * Q(n2, 1) * Q(n1 + n3 + n4, 3) * Q(n5 + n6, 2) - 2. * Q(n1, 1) * Q(n2 + n3 + n4, 3) * Q(n5 + n6, 2) + 6. * Q(n1 + n2 + n3 + n4, 4) * Q(n5 + n6, 2) + 2. * Q(n2, 1) * Q(n3, 1) * Q(n4, 1) * Q(n1 + n5 + n6, 3) - 2. * Q(n2 + n3, 2) * Q(n4, 1) * Q(n1 + n5 + n6, 3) - 2. * Q(n3, 1) * Q(n2 + n4, 2) * Q(n1 + n5 + n6, 3) - 2. * Q(n2, 1) * Q(n3 + n4, 2) * Q(n1 + n5 + n6, 3) + 4. * Q(n2 + n3 + n4, 3) * Q(n1 + n5 + n6, 3) + 2. * Q(n1, 1) * Q(n3, 1) * Q(n4, 1) * Q(n2 + n5 + n6, 3) - 2. * Q(n1 + n3, 2) * Q(n4, 1) * Q(n2 + n5 + n6, 3) - 2. * Q(n3, 1) * Q(n1 + n4, 2) * Q(n2 + n5 + n6, 3) - 2. * Q(n1, 1) * Q(n3 + n4, 2) * Q(n2 + n5 + n6, 3) + 4. * Q(n1 + n3 + n4, 3) * Q(n2 + n5 + n6, 3) - 6. * Q(n3, 1) * Q(n4, 1) * Q(n1 + n2 + n5 + n6, 4) + 6. * Q(n3 + n4, 2) * Q(n1 + n2 + n5 + n6, 4) + 2. * Q(n1, 1) * Q(n2, 1) * Q(n4, 1) * Q(n3 + n5 + n6, 3) - 2. * Q(n1 + n2, 2) * Q(n4, 1) * Q(n3 + n5 + n6, 3) - 2. * Q(n2, 1) * Q(n1 + n4, 2) * Q(n3 + n5 + n6, 3) - 2. * Q(n1, 1) * Q(n2 + n4, 2) * Q(n3 + n5 + n6, 3) + 4. * Q(n1 + n2 + n4, 3) * Q(n3 + n5 + n6, 3) - 6. * Q(n2, 1) * Q(n4, 1) * Q(n1 + n3 + n5 + n6, 4) + 6. * Q(n2 + n4, 2) * Q(n1 + n3 + n5 + n6, 4) - 6. * Q(n1, 1) * Q(n4, 1) * Q(n2 + n3 + n5 + n6, 4) + 6. * Q(n1 + n4, 2) * Q(n2 + n3 + n5 + n6, 4) + 24. * Q(n4, 1) * Q(n1 + n2 + n3 + n5 + n6, 5) + 2. * Q(n1, 1) * Q(n2, 1) * Q(n3, 1) * Q(n4 + n5 + n6, 3) - 2. * Q(n1 + n2, 2) * Q(n3, 1) * Q(n4 + n5 + n6, 3) - 2. * Q(n2, 1) * Q(n1 + n3, 2) * Q(n4 + n5 + n6, 3) - 2. * Q(n1, 1) * Q(n2 + n3, 2) * Q(n4 + n5 + n6, 3) + 4. * Q(n1 + n2 + n3, 3) * Q(n4 + n5 + n6, 3) - 6. * Q(n2, 1) * Q(n3, 1) * Q(n1 + n4 + n5 + n6, 4) + 6. * Q(n2 + n3, 2) * Q(n1 + n4 + n5 + n6, 4) - 6. * Q(n1, 1) * Q(n3, 1) * Q(n2 + n4 + n5 + n6, 4) + 6. * Q(n1 + n3, 2) * Q(n2 + n4 + n5 + n6, 4) + 24. * Q(n3, 1) * Q(n1 + n2 + n4 + n5 + n6, 5) - 6. * Q(n1, 1) * Q(n2, 1) * Q(n3 + n4 + n5 + n6, 4) + 6. * Q(n1 + n2, 2) * Q(n3 + n4 + n5 + n6, 4) + 24. * Q(n2, 1) * Q(n1 + n3 + n4 + n5 + n6, 5) + 24. * Q(n1, 1) * Q(n2 + n3 + n4 + n5 + n6, 5) - 120. * Q(n1 + n2 + n3 + n4 + n5 + n6, 6);
+  std::complex<double> six = RecursionMemoised(6, harmonic);
 
-  return six;
+  return TComplex(six.real(), six.imag());
 
 } // TComplex Six(int n1, int n2, int n3, int n4, int n5, int n6)
 
@@ -11826,9 +11694,9 @@ TComplex Seven(int n1, int n2, int n3, int n4, int n5, int n6, int n7)
 
   int harmonic[7] = {n1, n2, n3, n4, n5, n6, n7};
 
-  TComplex seven = Recursion(7, harmonic);
+  std::complex<double> seven = RecursionMemoised(7, harmonic);
 
-  return seven;
+  return TComplex(seven.real(), seven.imag());
 
 } // end of TComplex Seven(int n1, int n2, int n3, int n4, int n5, int n6, int n7)
 
@@ -11840,9 +11708,9 @@ TComplex Eight(int n1, int n2, int n3, int n4, int n5, int n6, int n7, int n8)
 
   int harmonic[8] = {n1, n2, n3, n4, n5, n6, n7, n8};
 
-  TComplex eight = Recursion(8, harmonic);
+  std::complex<double> eight = RecursionMemoised(8, harmonic);
 
-  return eight;
+  return TComplex(eight.real(), eight.imag());
 
 } // end of Eight(int n1, int n2, int n3, int n4, int n5, int n6, int n7, int n8)
 
@@ -11854,9 +11722,9 @@ TComplex Nine(int n1, int n2, int n3, int n4, int n5, int n6, int n7, int n8, in
 
   int harmonic[9] = {n1, n2, n3, n4, n5, n6, n7, n8, n9};
 
-  TComplex nine = Recursion(9, harmonic);
+  std::complex<double> nine = RecursionMemoised(9, harmonic);
 
-  return nine;
+  return TComplex(nine.real(), nine.imag());
 
 } // end of TComplex Nine(int n1, int n2, int n3, int n4, int n5, int n6, int n7, int n8, int n9)
 
@@ -11868,9 +11736,9 @@ TComplex Ten(int n1, int n2, int n3, int n4, int n5, int n6, int n7, int n8, int
 
   int harmonic[10] = {n1, n2, n3, n4, n5, n6, n7, n8, n9, n10};
 
-  TComplex ten = Recursion(10, harmonic);
+  std::complex<double> ten = RecursionMemoised(10, harmonic);
 
-  return ten;
+  return TComplex(ten.real(), ten.imag());
 
 } // end of TComplex Ten(int n1, int n2, int n3, int n4, int n5, int n6, int n7, int n8, int n9, int n10)
 
@@ -11882,9 +11750,9 @@ TComplex Eleven(int n1, int n2, int n3, int n4, int n5, int n6, int n7, int n8,
 
   int harmonic[11] = {n1, n2, n3, n4, n5, n6, n7, n8, n9, n10, n11};
 
-  TComplex eleven = Recursion(11, harmonic);
+  std::complex<double> eleven = RecursionMemoised(11, harmonic);
 
-  return eleven;
+  return TComplex(eleven.real(), eleven.imag());
 
 } // end of TComplex Eleven(int n1, int n2, int n3, int n4, int n5, int n6, int n7, int n8, int n9, int n10, int n11)
 
@@ -11896,9 +11764,9 @@ TComplex Twelve(int n1, int n2, int n3, int n4, int n5, int n6, int n7, int n8,
 
   int harmonic[12] = {n1, n2, n3, n4, n5, n6, n7, n8, n9, n10, n11, n12};
 
-  TComplex twelve = Recursion(12, harmonic);
+  std::complex<double> twelve = RecursionMemoised(12, harmonic);
 
-  return twelve;
+  return TComplex(twelve.real(), twelve.imag());
 
 } // end of TComplex Twelve(int n1, int n2, int n3, int n4, int n5, int n6, int n7, int n8, int n9, int n10, int n11, int n12)
 
@@ -11946,6 +11814,97 @@ TComplex Recursion(int n, int* harmonic, int mult = 1, int skip = 0)
 
 //============================================================
 
+void FillQtable()
+{
+  // Copy the generic Q-vectors into the contiguous table used by RecursionMemoised(), and forget the memoised correlators.
+  // Q{-n,p} = Q{n,p}^* is stored explicitly, so that no branch is needed in the lookup.
+
+  const int offset = gMaxHarmonic * gMaxCorrelator;
+  for (int h = 0; h < gMaxHarmonic * gMaxCorrelator + 1; h++) {
+    for (int wp = 0; wp < gMaxCorrelator + 1; wp++) // weight power
+    {
+      qv.fQtable[offset + h][wp] = std::complex<double>(qv.fQ[h][wp].Re(), qv.fQ[h][wp].Im());
+      qv.fQtable[offset - h][wp] = std::complex<double>(qv.fQ[h][wp].Re(), -qv.fQ[h][wp].Im());
+    }
+  }
+  qv.fRecursionMemo.clear();
+  qv.fQtableIsFilled = true;
+
+} // void FillQtable()
+
+//============================================================
+
+std::complex<double> RecursionMemoised(int n, int* harmonic, int mult = 1, int skip = 0)
+{
+  // Same algorithm as in Recursion(), in std::complex<double> arithmetic and on the contiguous table filled in FillQtable().
+  // Each sub-correlator is fully determined by (harmonic[0], ..., harmonic[n-1], mult, skip), so it is evaluated only
+  // once per event and then reused, both within one correlator and between different correlators (e.g. all the weights).
+  // Remark: Whenever qv.fQ is modified, qv.fQtableIsFilled has to be set to false (see ResetQ()).
+
+  if (!qv.fQtableIsFilled) {
+    FillQtable();
+  }
+
+  const int offset = gMaxHarmonic * gMaxCorrelator;
+  int nm1 = n - 1;
+  std::complex<double> c(qv.fQtable[offset + harmonic[nm1]][mult]);
+  if (nm1 == 0)
+    return c;
+
+  // Key: 8 bits per harmonic (shifted to be non-negative), up to 12 harmonics, followed by n, mult and skip:
+  std::pair<uint64_t, uint64_t> key(0, (static_cast<uint64_t>(n) << 32) | (static_cast<uint64_t>(mult) << 40) | (static_cast<uint64_t>(skip) << 48));
+  for (int i = 0; i < n; i++) {
+    uint64_t h = static_cast<uint64_t>(harmonic[i] + offset);
+    if (i < 8) {
+      key.first |= h << (8 * i);
+    } else {
+      key.second |= h << (8 * (i - 8));
+    }
+  }
+  auto cached = qv.fRecursionMemo.find(key);
+  if (cached != qv.fRecursionMemo.end()) {
+    return cached->second;
+  }
+
+  c *= RecursionMemoised(nm1, harmonic);
+  if (nm1 == skip) {
+    qv.fRecursionMemo.emplace(key, c);
+    return c;
+  }
+
+  int multp1 = mult + 1;
+  int nm2 = n - 2;
+  int counter1 = 0;
+  int hhold = harmonic[counter1];
+  harmonic[counter1] = harmonic[nm2];
+  harmonic[nm2] = hhold + harmonic[nm1];
+  std::complex<double> c2(RecursionMemoised(nm1, harmonic, multp1, nm2));
+  int counter2 = n - 3;
+  while (counter2 >= skip) {
+    harmonic[nm2] = harmonic[counter1];
+    harmonic[counter1] = hhold;
+    ++counter1;
+    hhold = harmonic[counter1];
+    harmonic[counter1] = harmonic[nm2];
+    harmonic[nm2] = hhold + harmonic[nm1];
+    c2 += RecursionMemoised(nm1, harmonic, multp1, counter2);
+    --counter2;
+  }
+  harmonic[nm2] = harmonic[counter1];
+  harmonic[counter1] = hhold;
+
+  if (mult == 1) {
+    c -= c2;
+  } else {
+    c -= static_cast<double>(mult) * c2;
+  }
+  qv.fRecursionMemo.emplace(key, c);
+  return c;
+
+} // std::complex<double> RecursionMemoised(int n, int* harmonic, int mult = 1, int skip = 0)
+
+//============================================================
+
 void ResetQ()
 {
   // Reset the components of generic Q-vectors. Use it whenever you call the
@@ -11961,6 +11920,7 @@ void ResetQ()
       qv.fQ[h][wp] = TComplex(0., 0.);
     }
   }
+  qv.fQtableIsFilled = false; // memoised correlators are no longer valid
 
   if (tc.fVerbose) {
     ExitFunction(__FUNCTION__);
@@ -15695,14 +15655,71 @@ void BailOut(bool finalBailout = false)
 
 //============================================================
 
+template <bool useWeights>
+void AccumulateQvectors(const double& dPhi, const double& dEta, const double& weight)
+{
+  // Add one particle to the integrated Q-vectors and to the Q-vectors with eta separations.
+  // Common to FillQvector() and FillQvectorFromSparse(), which differ only in how the particle weight is obtained.
+  // For useWeights = false the bare Q-vectors are filled, and weight is not used.
+
+  // Remark: cos(h*dPhi), sin(h*dPhi) and weight^p are tabulated once for this particle, instead of being
+  //         recalculated for each (h, p) pair. The sums are the same, term by term, as before.
+
+  const int nHarmonics = qv.fCalculateQvectors ? gMaxHarmonic * gMaxCorrelator + 1 : gMaxHarmonic + 1;
+  double cosHarmonic[gMaxHarmonic * gMaxCorrelator + 1] = {0.};
+  double sinHarmonic[gMaxHarmonic * gMaxCorrelator + 1] = {0.};
+  for (int h = 0; h < nHarmonics; h++) {
+    cosHarmonic[h] = std::cos(h * dPhi);
+    sinHarmonic[h] = std::sin(h * dPhi);
+  }
+
+  if (qv.fCalculateQvectors) {
+    if constexpr (useWeights) {
+      double wToPowerP[gMaxCorrelator + 1] = {0.}; // weight raised to power p
+      for (int wp = 0; wp < gMaxCorrelator + 1; wp++) {
+        wToPowerP[wp] = std::pow(weight, wp);
+      }
+      for (int h = 0; h < gMaxHarmonic * gMaxCorrelator + 1; h++) {
+        for (int wp = 0; wp < gMaxCorrelator + 1; wp++) {                                                 // weight power
+          qv.fQvector[h][wp] += TComplex(wToPowerP[wp] * cosHarmonic[h], wToPowerP[wp] * sinHarmonic[h]); // Q-vector with weights
+        }
+      }
+    } else {
+      for (int h = 0; h < gMaxHarmonic * gMaxCorrelator + 1; h++) {
+        for (int wp = 0; wp < gMaxCorrelator + 1; wp++) {                 // weight power
+          qv.fQvector[h][wp] += TComplex(cosHarmonic[h], sinHarmonic[h]); // bare Q-vector without weights
+        }
+      }
+    }
+  } // if (qv.fCalculateQvectors) {
+
+  if (es.fCalculateEtaSeparations) { // yes, I can decouple this one from if (qv.fCalculateQvectors)
+    const double w = useWeights ? weight : 1.;
+    const int ab = dEta < 0. ? 0 : 1; // -eta or +eta; particles with dEta = 0 are in neither
+    for (int e = 0; e < gMaxNumberEtaSeparations; e++) {
+      // yes, if eta separation is 0.2, then separation interval runs from -0.1 to 0.1
+      if (!(std::fabs(dEta) > es.fEtaSeparationsValues[e] / 2.) || dEta == 0.) {
+        continue;
+      }
+      qv.fMab[ab][e] += w;
+      for (int h = 0; h < gMaxHarmonic; h++) {
+        if (es.fEtaSeparationsSkipHarmonics[h]) {
+          continue;
+        }
+        qv.fQabVector[ab][h][e] += TComplex(w * cosHarmonic[h + 1], w * sinHarmonic[h + 1]);
+      }
+    } // for (int e = 0; e < gMaxNumberEtaSeparations; e++) { // eta separation
+  } // if(es.fCalculateEtaSeparations) {
+
+} // template <bool useWeights> void AccumulateQvectors(const double& dPhi, const double& dEta, const double& weight)
+
+//============================================================
+
 void FillQvector(const double& dPhi, const double& dPt, const double& dEta)
 {
   // Fill integrated Q-vector.
   // Example usage: this->FillQvector(dPhi, dPt, dEta);
 
-  // TBI 20240430 I could optimize further, and have a bare version of this function when weights are NOT used.
-  //              But since usage of weights amounts to checking a few simple booleans here, I do not anticipate any big gain in efficiency...
-
   if (tc.fVerboseForEachParticle) {
     StartFunction(__FUNCTION__);
     LOGF(info, "\033[1;32m dPhi = %f\033[0m", dPhi);
@@ -15714,7 +15731,6 @@ void FillQvector(const double& dPhi, const double& dPt, const double& dEta)
   double wPhi = 1.;      // integrated phi weight
   double wPt = 1.;       // integrated pt weight
   double wEta = 1.;      // integrated eta weight
-  double wToPowerP = 1.; // weight raised to power p
 
   if (pw.fUseWeights[wPHI]) {
     wPhi = Weight(dPhi, wPHI);
@@ -15740,48 +15756,12 @@ void FillQvector(const double& dPhi, const double& dPt, const double& dEta)
     }
   } // if(pw.fUseWeights[wETA])
 
-  if (qv.fCalculateQvectors) {
-    for (int h = 0; h < gMaxHarmonic * gMaxCorrelator + 1; h++) {
-      for (int wp = 0; wp < gMaxCorrelator + 1; wp++) { // weight power
-        if (pw.fUseWeights[wPHI] || pw.fUseWeights[wPT] || pw.fUseWeights[wETA]) {
-          wToPowerP = std::pow(wPhi * wPt * wEta, wp);
-          qv.fQvector[h][wp] += TComplex(wToPowerP * std::cos(h * dPhi), wToPowerP * std::sin(h * dPhi)); // Q-vector with weights
-        } else {
-          qv.fQvector[h][wp] += TComplex(std::cos(h * dPhi), std::sin(h * dPhi)); // bare Q-vector without weights
-        }
-      } // for(int wp=0;wp<gMaxCorrelator+1;wp++)
-    } // for(int h=0;h<gMaxHarmonic*gMaxCorrelator+1;h++)
-  } // if (qv.fCalculateQvectors) {
-
-  if (es.fCalculateEtaSeparations) { // yes, I can decouple this one from if (qv.fCalculateQvectors)
-    if (dEta < 0.) {
-      for (int e = 0; e < gMaxNumberEtaSeparations; e++) {
-        if (dEta < -1. * es.fEtaSeparationsValues[e] / 2.) { // yes, if eta separation is 0.2, then separation interval runs from -0.1 to 0.1
-          qv.fMab[0][e] += wPhi * wPt * wEta;
-          for (int h = 0; h < gMaxHarmonic; h++) {
-            if (es.fEtaSeparationsSkipHarmonics[h]) {
-              continue;
-            }
-            qv.fQabVector[0][h][e] += TComplex(wPhi * wPt * wEta * std::cos((h + 1) * dPhi), wPhi * wPt * wEta * std::sin((h + 1) * dPhi));
-          }
-        } // for (int h = 0; h < gMaxHarmonic; h++) {
-      } // for (int e = 0; e < gMaxNumberEtaSeparations; e++) { // eta separation
-    } else if (dEta > 0.) {
-      for (int e = 0; e < gMaxNumberEtaSeparations; e++) {
-        if (dEta > es.fEtaSeparationsValues[e] / 2.) { // yes, if eta separation is 0.2, then separation interval runs from -0.1 to 0.1
-          qv.fMab[1][e] += wPhi * wPt * wEta;
-          for (int h = 0; h < gMaxHarmonic; h++) {
-            {
-              if (es.fEtaSeparationsSkipHarmonics[h]) {
-                continue;
-              }
-              qv.fQabVector[1][h][e] += TComplex(wPhi * wPt * wEta * std::cos((h + 1) * dPhi), wPhi * wPt * wEta * std::sin((h + 1) * dPhi));
-            }
-          } // for (int h = 0; h < gMaxHarmonic; h++) {
-        } // for (int e = 0; e < gMaxNumberEtaSeparations; e++) { // eta separation
-      }
-    }
-  } // if(es.fCalculateEtaSeparations) {
+  // *) Q-vectors, with the bare version when no weights are used:
+  if (pw.fUseWeights[wPHI] || pw.fUseWeights[wPT] || pw.fUseWeights[wETA]) {
+    AccumulateQvectors<true>(dPhi, dEta, wPhi * wPt * wEta);
+  } else {
+    AccumulateQvectors<false>(dPhi, dEta, 1.);
+  }
 
   if (tc.fVerboseForEachParticle) {
     ExitFunction(__FUNCTION__);
@@ -15813,7 +15793,6 @@ void FillQvectorFromSparse(const double& dPhi, const double& dPt, const double&
   double wPhi = 1.;      // differential multidimensional phi weight, its dimensions are defined via enum eDiffPhiWeights
   double wPt = 1.;       // differential multidimensional pt weight, its dimensions are defined via enum eDiffPtWeights
   double wEta = 1.;      // differential multidimensional eta weight, its dimensions are defined via enum eDiffEtaWeights
-  double wToPowerP = 1.; // weight raised to power p
 
   // *) Multidimensional phi weights:
   if (pw.fUseDiffPhiWeights[wPhiPhiAxis]) { // yes, 0th axis serves as a comon boolean for this category
@@ -15872,48 +15851,12 @@ void FillQvectorFromSparse(const double& dPhi, const double& dPt, const double&
     }
   } // if(pw.fUseDiffEtaWeights[wEtaEtaAxis])
 
-  if (qv.fCalculateQvectors) {
-    for (int h = 0; h < gMaxHarmonic * gMaxCorrelator + 1; h++) {
-      for (int wp = 0; wp < gMaxCorrelator + 1; wp++) { // weight power
-        if (pw.fUseDiffPhiWeights[wPhiPhiAxis] || pw.fUseDiffPtWeights[wPtPtAxis] || pw.fUseDiffEtaWeights[wEtaEtaAxis]) {
-          wToPowerP = std::pow(wPhi * wPt * wEta, wp);
-          qv.fQvector[h][wp] += TComplex(wToPowerP * std::cos(h * dPhi), wToPowerP * std::sin(h * dPhi)); // Q-vector with weights
-        } else {
-          qv.fQvector[h][wp] += TComplex(std::cos(h * dPhi), std::sin(h * dPhi)); // bare Q-vector without weights
-        }
-      } // for(int wp=0;wp<gMaxCorrelator+1;wp++)
-    } // for(int h=0;h<gMaxHarmonic*gMaxCorrelator+1;h++)
-  } // if (qv.fCalculateQvectors) {
-
-  if (es.fCalculateEtaSeparations) { // yes, I can decouple this one from if (qv.fCalculateQvectors)
-    if (dEta < 0.) {
-      for (int e = 0; e < gMaxNumberEtaSeparations; e++) {
-        if (dEta < -1. * es.fEtaSeparationsValues[e] / 2.) { // yes, if eta separation is 0.2, then separation interval runs from -0.1 to 0.1
-          qv.fMab[0][e] += wPhi * wPt * wEta;
-          for (int h = 0; h < gMaxHarmonic; h++) {
-            if (es.fEtaSeparationsSkipHarmonics[h]) {
-              continue;
-            }
-            qv.fQabVector[0][h][e] += TComplex(wPhi * wPt * wEta * std::cos((h + 1) * dPhi), wPhi * wPt * wEta * std::sin((h + 1) * dPhi));
-          }
-        } // for (int h = 0; h < gMaxHarmonic; h++) {
-      } // for (int e = 0; e < gMaxNumberEtaSeparations; e++) { // eta separation
-    } else if (dEta > 0.) {
-      for (int e = 0; e < gMaxNumberEtaSeparations; e++) {
-        if (dEta > es.fEtaSeparationsValues[e] / 2.) { // yes, if eta separation is 0.2, then separation interval runs from -0.1 to 0.1
-          qv.fMab[1][e] += wPhi * wPt * wEta;
-          for (int h = 0; h < gMaxHarmonic; h++) {
-            {
-              if (es.fEtaSeparationsSkipHarmonics[h]) {
-                continue;
-              }
-              qv.fQabVector[1][h][e] += TComplex(wPhi * wPt * wEta * std::cos((h + 1) * dPhi), wPhi * wPt * wEta * std::sin((h + 1) * dPhi));
-            }
-          } // for (int h = 0; h < gMaxHarmonic; h++) {
-        } // for (int e = 0; e < gMaxNumberEtaSeparations; e++) { // eta separation
-      }
-    }
-  } // if(es.fCalculateEtaSeparations) {
+  // *) Q-vectors, with the bare version when no weights are used:
+  if (pw.fUseDiffPhiWeights[wPhiPhiAxis] || pw.fUseDiffPtWeights[wPtPtAxis] || pw.fUseDiffEtaWeights[wEtaEtaAxis]) {
+    AccumulateQvectors<true>(dPhi, dEta, wPhi * wPt * wEta);
+  } else {
+    AccumulateQvectors<false>(dPhi, dEta, 1.);
+  }
 
   if (tc.fVerboseForEachParticle) {
     ExitFunction(__FUNCTION__);
@@ -15978,7 +15921,6 @@ void Fillqvector(const double& dPhi, const double& kineVarValue, eqvectorKine ki
   }
 
   // *) Get all integrated kinematic weights:
-  double wToPowerP = 1.;     // weight raised to power p
   double kineVarWeight = 1.; // e.g. this can be integrated pT or eta weight
   if (pw.fUseWeights[AFO_weight]) {
     kineVarWeight = Weight(kineVarValue, AFO_weight); // corresponding e.g. pt or eta weight
@@ -16000,18 +15942,32 @@ void Fillqvector(const double& dPhi, const double& kineVarValue, eqvectorKine ki
   } // if(pw.fUseDiffWeights[AFO_diffWeight]) {
 
   // *) Finally, fill differential q-vector in that bin:
+  //    Remark: cos(h*dPhi), sin(h*dPhi) and weight^p are tabulated once for this particle, see AccumulateQvectors().
+  double cosHarmonic[gMaxHarmonic * gMaxCorrelator + 1] = {0.};
+  double sinHarmonic[gMaxHarmonic * gMaxCorrelator + 1] = {0.};
   for (int h = 0; h < gMaxHarmonic * gMaxCorrelator + 1; h++) {
-    for (int wp = 0; wp < gMaxCorrelator + 1; wp++) { // weight power
-      if (pw.fUseWeights[AFO_weight] || pw.fUseDiffWeights[AFO_diffWeight]) {
-        // TBI 20240212 supported at the moment: e.g. q-vector vs pt can be weighted only with diff. phi(pt) and integrated pt weights.
-        // It cannot be weighted in addition with eta weights, since in any case I anticipate I will do always 1-D analysis, by integrating out all other dependencies
-        wToPowerP = std::pow(diffPhiWeightsForThisKineVar * kineVarWeight, wp);
-        qv.fqvector[kineVarChoice][bin - 1][h][wp] += TComplex(wToPowerP * std::cos(h * dPhi), wToPowerP * std::sin(h * dPhi)); // q-vector with weights
-      } else {
-        qv.fqvector[kineVarChoice][bin - 1][h][wp] += TComplex(std::cos(h * dPhi), std::sin(h * dPhi)); // bare q-vector without weights
+    cosHarmonic[h] = std::cos(h * dPhi);
+    sinHarmonic[h] = std::sin(h * dPhi);
+  }
+  if (pw.fUseWeights[AFO_weight] || pw.fUseDiffWeights[AFO_diffWeight]) {
+    // TBI 20240212 supported at the moment: e.g. q-vector vs pt can be weighted only with diff. phi(pt) and integrated pt weights.
+    // It cannot be weighted in addition with eta weights, since in any case I anticipate I will do always 1-D analysis, by integrating out all other dependencies
+    double wToPowerP[gMaxCorrelator + 1] = {0.}; // weight raised to power p
+    for (int wp = 0; wp < gMaxCorrelator + 1; wp++) {
+      wToPowerP[wp] = std::pow(diffPhiWeightsForThisKineVar * kineVarWeight, wp);
+    }
+    for (int h = 0; h < gMaxHarmonic * gMaxCorrelator + 1; h++) {
+      for (int wp = 0; wp < gMaxCorrelator + 1; wp++) {                                                                         // weight power
+        qv.fqvector[kineVarChoice][bin - 1][h][wp] += TComplex(wToPowerP[wp] * cosHarmonic[h], wToPowerP[wp] * sinHarmonic[h]); // q-vector with weights
       }
-    } // for(int wp=0;wp<gMaxCorrelator+1;wp++)
-  } // for(int h=0;h<gMaxHarmonic*gMaxCorrelator+1;h++)
+    }
+  } else {
+    for (int h = 0; h < gMaxHarmonic * gMaxCorrelator + 1; h++) {
+      for (int wp = 0; wp < gMaxCorrelator + 1; wp++) {                                         // weight power
+        qv.fqvector[kineVarChoice][bin - 1][h][wp] += TComplex(cosHarmonic[h], sinHarmonic[h]); // bare q-vector without weights
+      }
+    }
+  }
 
   // *) Differential nested loops:
   if (nl.fCalculateKineCustomNestedLoops) {
@@ -16037,7 +15993,7 @@ void Fillqvector(const double& dPhi, const double& kineVarValue, eqvectorKine ki
             if (es.fEtaSeparationsSkipHarmonics[h]) {
               continue;
             }
-            qv.fqabVector[0][bin - 1][h][e] += TComplex(diffPhiWeightsForThisKineVar * kineVarWeight * std::cos((h + 1) * dPhi), diffPhiWeightsForThisKineVar * kineVarWeight * std::sin((h + 1) * dPhi)); // Remark: I can hardwire linear weight like this only for 2-p correlation
+            qv.fqabVector[0][bin - 1][h][e] += TComplex(diffPhiWeightsForThisKineVar * kineVarWeight * cosHarmonic[h + 1], diffPhiWeightsForThisKineVar * kineVarWeight * sinHarmonic[h + 1]); // Remark: I can hardwire linear weight like this only for 2-p correlation
           }
         } // for (int h = 0; h < gMaxHarmonic; h++) {
       } // for (int e = 0; e < gMaxNumberEtaSeparations; e++) { // eta separation
@@ -16050,7 +16006,7 @@ void Fillqvector(const double& dPhi, const double& kineVarValue, eqvectorKine ki
               if (es.fEtaSeparationsSkipHarmonics[h]) {
                 continue;
               }
-              qv.fqabVector[1][bin - 1][h][e] += TComplex(diffPhiWeightsForThisKineVar * kineVarWeight * std::cos((h + 1) * dPhi), diffPhiWeightsForThisKineVar * kineVarWeight * std::sin((h + 1) * dPhi)); // Remark: I can hardwire linear weight like this only for 2-p correlation
+              qv.fqabVector[1][bin - 1][h][e] += TComplex(diffPhiWeightsForThisKineVar * kineVarWeight * cosHarmonic[h + 1], diffPhiWeightsForThisKineVar * kineVarWeight * sinHarmonic[h + 1]); // Remark: I can hardwire linear weight like this only for 2-p correlation
             }
           } // for (int h = 0; h < gMaxHarmonic; h++) {
         } // for (int e = 0; e < gMaxNumberEtaSeparations; e++) { // eta separation
@@ -16,6 +16,7 @@
 // O2:
 #include <CCDB/BasicCCDBManager.h>
 #include "Common/CCDB/ctpRateFetcher.h"
+#include "Common/Core/FormulaEvaluator.h"
 #include "Framework/runDataProcessing.h"
 #include "Framework/AnalysisTask.h"
 #include "Framework/AnalysisDataModel.h"
@@ -88,6 +89,16 @@ using TracksRec_QA = TracksRec;    // if I would need additional tables for QA,
 #include <TF3.h>
 #include <TObjString.h>
 #include <THnSparse.h>
+
+// *) Standard library:
+#include <algorithm>
+#include <atomic>
+#include <complex>
+#include <cstdint>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 using namespace std;
 
 // *) Enums:
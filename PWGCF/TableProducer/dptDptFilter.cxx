@@ -29,6 +29,7 @@
 #include "Common/Core/TrackSelectionDefaults.h"
 #include "Common/DataModel/PIDResponse.h"
 #include "PWGCF/Core/AnalysisConfigurableCuts.h"
+#include "PWGCF/Core/FilterTrackClassification.h"
 #include "PWGCF/DataModel/DptDptFiltered.h"
 #include "Common/DataModel/TrackSelectionTables.h"
 #include "Common/DataModel/CollisionAssociationTables.h"
@@ -765,22 +766,6 @@ void DptDptFilter::processVertexGenerated(aod::McCollisions const& mccollisions)
   }
 }
 
-/// RMS calculation. Taken from PWGHF/Tasks/taskMcValidation.cxx
-/// \param vec  vector of values to compute RMS
-template <typename T>
-T computeRMS(std::vector<T>& vec)
-{
-  T sum = std::accumulate(vec.begin(), vec.end(), 0.0);
-  T mean = sum / vec.size();
-
-  std::vector<T> diff(vec.size());
-  std::transform(vec.begin(), vec.end(), diff.begin(), [mean](T x) { return x - mean; });
-  T sqSum = std::inner_product(diff.begin(), diff.end(), diff.begin(), 0.0);
-  T stdDev = std::sqrt(sqSum / vec.size());
-
-  return stdDev;
-}
-
 struct DptDptFilterTracks {
 
   Produces<aod::ScannedTracks> scannedtracks;
@@ -826,6 +811,8 @@ struct DptDptFilterTracks {
   bool checkAmbiguousTracks = false;
 
   std::vector<bool> particleReconstructed;
+  std::vector<double> zvertexes;                         /* the z of the compatible collisions of the current ambiguous track */
+  o2::analysis::filtertracks::TrackCodeCache trackcodes; /* the codes of the tracks of the dataframe, reused by the not reconstructed filtering */
 
   void init(InitContext& initContext)
   {
@@ -1194,10 +1181,12 @@ struct DptDptFilterTracks {
         ncollaccepted++;
       }
     }
+    trackcodes.bind(tracks);
     for (auto const& track : tracks) {
       int8_t pid = -1;
       if (track.has_collision() && (track.template collision_as<soa::Join<aod::Collisions, aod::DptDptCFCollisionsInfo>>()).collisionaccepted()) {
         pid = selectTrackAmbiguousCheck<outdebug>(collisions, track);
+        trackcodes.set(track.index(), pid);
         if (!(pid < 0)) {
           naccepted++;
           if (fullDerivedData) {
@@ -1231,19 +1220,25 @@ struct DptDptFilterTracks {
   /* filter the tracks but not creating the filtered tracks table */
   /* the aim is to fill the structure of the generated particles  */
   /* that were reconstructed                                      */
+  /* if the detector level filtering already classified the same  */
+  /* tracks their codes are reused, otherwise the tracks would be */
+  /* selected again filling twice histograms and multiplicities   */
   template <typename passedtracks>
   void filterTracksSpecial(soa::Join<aod::Collisions, aod::DptDptCFCollisionsInfo> const&, passedtracks const& tracks)
   {
     /* do check for special adjustments */
     getCCDBInformation();
 
+    bool classified = trackcodes.isBoundTo(tracks);
     for (auto const& track : tracks) {
       int8_t pid = -1;
-      if (track.has_collision() && (track.template collision_as<soa::Join<aod::Collisions, aod::DptDptCFCollisionsInfo>>()).collisionaccepted()) {
+      if (classified) {
+        pid = trackcodes.get(track.index());
+      } else if (track.has_collision() && (track.template collision_as<soa::Join<aod::Collisions, aod::DptDptCFCollisionsInfo>>()).collisionaccepted()) {
         pid = selectTrack<kNODEBUG, soa::Join<aod::Collisions, aod::DptDptCFCollisionsInfo>>(track);
-        if (!(pid < 0)) {
-          particleReconstructed[track.mcParticleId()] = true;
-        }
+      }
+      if (!(pid < 0)) {
+        particleReconstructed[track.mcParticleId()] = true;
       }
     }
   }
@@ -1524,11 +1519,11 @@ int8_t DptDptFilterTracks::selectTrack(TrackObject const& track)
       if (track.sign() > 0) {
         trkMultPos[sp]++;
         /* positive tracks even pid */
-        sp = sp * 2;
+        sp = o2::analysis::filtertracks::speciesChargeCode(sp, track.sign());
       } else if (track.sign() < 0) {
         trkMultNeg[sp]++;
         /* negative tracks odd pid */
-        sp = sp * 2 + 1;
+        sp = o2::analysis::filtertracks::speciesChargeCode(sp, track.sign());
       }
     }
   }
@@ -1538,41 +1533,11 @@ int8_t DptDptFilterTracks::selectTrack(TrackObject const& track)
 template <StrongDebugging outdebug, typename CollisionObjects, typename TrackObject>
 int8_t DptDptFilterTracks::selectTrackAmbiguousCheck(CollisionObjects const& collisions, TrackObject const& track)
 {
-  enum AmbiguityTypes {
-    kNoAmbiguous = 0,             /* no ambiguous track */
-    kOnePossibilitySame = 1,      /* the track is present in the collision association table but has the same associated collision so the track is not ambiguous */
-    kOnePossibilityDifferent = 2, /* the track is present in the collision association table and has a diffetent collision associeted so the track is ambiguous */
-    kMoreThanOnePossibility = 3   /* the track is associated to more than one collision in the collision association table so the track is ambiguous */
-  };
-  bool ambiguoustrack = false;
-  AmbiguityTypes ambtracktype = kNoAmbiguous;
-  std::vector<double> zvertexes{};
+  using namespace o2::analysis::filtertracks;
+
   /* ambiguous tracks checks if required */
-  if constexpr (has_type_v<aod::track_association::CollisionIds, typename TrackObject::all_columns>) {
-    if (track.compatibleCollIds().size() > 0) {
-      if (track.compatibleCollIds().size() == 1) {
-        if (track.collisionId() != track.compatibleCollIds()[0]) {
-          /* ambiguous track! */
-          ambiguoustrack = true;
-          /* in principle we should not be here because the track is associated to two collisions at least */
-          ambtracktype = kOnePossibilityDifferent;
-          zvertexes.push_back(collisions.iteratorAt(track.collisionId()).posZ());
-          zvertexes.push_back(collisions.iteratorAt(track.compatibleCollIds()[0]).posZ());
-        } else {
-          /* we consider the track as no ambiguous */
-          ambtracktype = kOnePossibilitySame;
-        }
-      } else {
-        /* ambiguous track! */
-        ambiguoustrack = true;
-        ambtracktype = kMoreThanOnePossibility;
-        /* the track is associated to more than one collision */
-        for (const auto& collIdx : track.compatibleCollIds()) {
-          zvertexes.push_back(collisions.iteratorAt(collIdx).posZ());
-        }
-      }
-    }
-  }
+  AmbiguityTypes ambtracktype = trackAmbiguity(collisions, track, zvertexes);
+  bool ambiguoustrack = (ambtracktype == kOnePossibilityDifferent) || (ambtracktype == kMoreThanOnePossibility);
 
   float multiplicityClass = (track.template collision_as<CollisionObjects>()).centmult();
   if (ambiguoustrack) {
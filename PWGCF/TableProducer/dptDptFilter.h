@@ -20,7 +20,9 @@
 #include <TPDGCode.h>
 #include <TMCProcess.h>
 #include <TF1.h>
+#include <TH1.h>
 #include <TList.h>
+#include <array>
 #include <vector>
 #include <bitset>
 #include <string>
@@ -1591,8 +1593,8 @@ struct PIDSpeciesSelection {
   int8_t whichSpecies(TrackObject const& track)
   {
     TString debuginfo;
-    std::vector<float> tpcnsigmas = {track.tpcNSigmaEl(), track.tpcNSigmaMu(), track.tpcNSigmaPi(), track.tpcNSigmaKa(), track.tpcNSigmaPr()};
-    std::vector<float> tofnsigmas = {track.tofNSigmaEl(), track.tofNSigmaMu(), track.tofNSigmaPi(), track.tofNSigmaKa(), track.tofNSigmaPr()};
+    std::array<float, 5> tpcnsigmas = {track.tpcNSigmaEl(), track.tpcNSigmaMu(), track.tpcNSigmaPi(), track.tpcNSigmaKa(), track.tpcNSigmaPr()};
+    std::array<float, 5> tofnsigmas = {track.tofNSigmaEl(), track.tofNSigmaMu(), track.tofNSigmaPi(), track.tofNSigmaKa(), track.tofNSigmaPr()};
 
     auto outmomentumdebug = [&]() {
       if constexpr (outdebug != 0) {
@@ -1862,6 +1864,50 @@ struct PIDSpeciesSelection {
   std::vector<TH1*> tofnsigmasshiftneg{spnames.size(), nullptr};
 };
 
+/// \brief Compact per run accumulator
+/// Fills a histogram whose first axis is the run number, with one alphanumeric and extendable bin per run,
+/// instead of booking a set of full resolution histograms per run. The run bin is looked up only at run change
+/// and the counts are added directly to the linear bin, so the histogram content is one contiguous run indexed
+/// array. As the runs are bin labels, the outputs of the subjobs merge by run.
+class PerRunAccumulator
+{
+ public:
+  /// \brief sets the histogram to fill, its first axis becomes the run axis
+  void setHistogram(TH1* histogram)
+  {
+    mHistogram = histogram;
+    mHistogram->SetCanExtend(TH1::kXaxis);
+    mRunBin = -1;
+  }
+  /// \brief selects the run whose counts are filled, adding its bin if needed
+  void setRun(int runNumber)
+  {
+    mRunBin = mHistogram->GetXaxis()->FindBin(TString::Format("%d", runNumber).Data());
+  }
+  /// \brief adds a count for the observable values (one or two) of the current run
+  void fill(double y, double weight = 1.0)
+  {
+    addToBin(mHistogram->GetBin(mRunBin, mHistogram->GetYaxis()->FindFixBin(y)), weight);
+  }
+  void fill(double y, double z, double weight)
+  {
+    addToBin(mHistogram->GetBin(mRunBin, mHistogram->GetYaxis()->FindFixBin(y), mHistogram->GetZaxis()->FindFixBin(z)), weight);
+  }
+
+ private:
+  void addToBin(int bin, double weight)
+  {
+    mHistogram->AddBinContent(bin, weight);
+    if (mHistogram->GetSumw2N() > 0) {
+      mHistogram->GetSumw2()->AddAt(mHistogram->GetSumw2()->At(bin) + weight * weight, bin);
+    }
+    mHistogram->SetEntries(mHistogram->GetEntries() + 1);
+  }
+
+  TH1* mHistogram = nullptr; ///< the run x observable histogram
+  int mRunBin = -1;          ///< the bin of the current run
+};
+
 } // namespace dptdptfilter
 } // namespace analysis
 } // namespace o2
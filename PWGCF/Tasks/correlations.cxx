@@ -14,6 +14,7 @@
 /// \author Jan Fiete Grosse-Oetringhaus <jan.fiete.grosse-oetringhaus@cern.ch>, Jasper Parkkila <jasper.parkkila@cern.ch>
 
 #include "PWGCF/Core/CorrelationContainer.h"
+#include "PWGCF/Core/CorrelationEngine.h"
 #include "PWGCF/Core/PairCuts.h"
 #include "PWGCF/DataModel/CorrelationsDerived.h"
 
@@ -96,6 +97,7 @@ struct CorrelationTask {
 
   O2_DEFINE_CONFIGURABLE(cfgDecayParticleMask, int, 0, "Selection bitmask for the decay particles: 0 = no selection")
   O2_DEFINE_CONFIGURABLE(cfgMassAxis, int, 0, "Use invariant mass axis (0 = OFF, 1 = ON)")
+  O2_DEFINE_CONFIGURABLE(cfgBulkPairFill, bool, false, "Buffer pairs and fill the pair histogram in bulk (not with mass axis)")
   O2_DEFINE_CONFIGURABLE(cfgMcTriggerPDGs, std::vector<int>, {}, "MC PDG codes to use exclusively as trigger particles and exclude from associated particles. Empty = no selection.")
 
   O2_DEFINE_CONFIGURABLE(cfgPtDepMLbkg, std::vector<float>, {}, "pT interval for ML training")
@@ -137,6 +139,12 @@ struct CorrelationTask {
 
   // persistent caches
   std::vector<float> efficiencyAssociatedCache;
+  CorrelationPairBuffer pairBuffer;
+  CorrelationEngine correlationEngine;
+  CorrelationParticles triggerParticles;
+  CorrelationParticles associatedParticles;
+  PairCuts::TrackCache pairCutCacheTrigger;
+  PairCuts::TrackCache pairCutCacheAssociated;
   std::vector<int> p2indexCache;
 
   struct Config {
@@ -385,9 +393,80 @@ struct CorrelationTask {
   template <class T>
   using HasMlProbD0 = decltype(std::declval<T&>().mlProbD0());
 
+  // the plain (charged) tracks of the reconstructed steps are correlated with the CorrelationEngine when filling in bulk
+  template <CorrelationContainer::CFStep step, typename TTracks1, typename TTracks2>
+  static constexpr bool isEngineCompatible()
+  {
+    using T = typename TTracks1::iterator;
+    if constexpr (!std::is_same<TTracks1, TTracks2>::value || step < CorrelationContainer::kCFStepReconstructed) {
+      return false;
+    } else {
+      return std::experimental::is_detected<HasSign, T>::value && !std::experimental::is_detected<HasDecay, T>::value && !std::experimental::is_detected<HasProng0Id, T>::value && !std::experimental::is_detected<HasMlProbD0, T>::value && !std::experimental::is_detected<HasPDGCode, T>::value;
+    }
+  }
+
+  template <CorrelationContainer::CFStep step, typename TTarget, typename TTracks>
+  void fillCorrelationsEngine(TTarget target, TTracks& tracks1, TTracks& tracks2, float multiplicity, float posZ, int magField, float eventWeight)
+  {
+    auto fillParticles = [&](CorrelationParticles& particles, TTracks& tracks, THn* efficiency) {
+      particles.clear();
+      particles.reserve(tracks.size());
+      for (const auto& track : tracks) {
+        float weight = 1.f;
+        if constexpr (step == CorrelationContainer::kCFStepCorrected) {
+          if (efficiency) {
+            weight = getEfficiencyCorrection(efficiency, track.eta(), track.pt(), multiplicity, posZ);
+          }
+        }
+        particles.add(track.pt(), track.eta(), track.phi(), track.sign(), track.globalIndex(), weight);
+      }
+    };
+    fillParticles(triggerParticles, tracks1, cfg.mEfficiencyTrigger);
+    fillParticles(associatedParticles, tracks2, cfg.mEfficiencyAssociated);
+    const bool pairCuts = cfg.mPairCuts || cfgTwoTrackCut > 0;
+    if (pairCuts) {
+      mPairCuts.fillTrackCache(pairCutCacheTrigger, triggerParticles, magField);
+      mPairCuts.fillTrackCache(pairCutCacheAssociated, associatedParticles, magField);
+    }
+
+    CorrelationEngine::Selection selection;
+    selection.ptOrder = cfgPtOrder != 0;
+    selection.triggerCharge = cfgTriggerCharge;
+    selection.associatedCharge = cfgAssociatedCharge;
+    selection.pairCharge = cfgPairCharge;
+    correlationEngine.setSelection(selection);
+
+    pairBuffer.setTarget(target->getPairHist(), step);
+    correlationEngine.correlate(
+      triggerParticles, associatedParticles, eventWeight,
+      [&](int iTrig, float weight) {
+        target->getTriggerHist()->Fill(step, triggerParticles.pt[iTrig], multiplicity, posZ, weight);
+      },
+      [&](const CorrelationParticles::Particle& trigger, const CorrelationParticles::Particle& associated) {
+        if (!pairCuts) {
+          return false;
+        }
+        return (cfg.mPairCuts && mPairCuts.conversionCuts(pairCutCacheTrigger, trigger.index(), pairCutCacheAssociated, associated.index())) || (cfgTwoTrackCut > 0 && mPairCuts.twoTrackCut(pairCutCacheTrigger, trigger.index(), pairCutCacheAssociated, associated.index()));
+      },
+      [&](int iTrig, int n, const float* deltaEta, const float* deltaPhi, const float* ptAssoc, const float* weight) {
+        const float ptTrig = triggerParticles.pt[iTrig];
+        for (int i = 0; i < n; i++) {
+          pairBuffer.add(deltaEta[i], ptAssoc[i], ptTrig, multiplicity, deltaPhi[i], posZ, weight[i]);
+        }
+      });
+    pairBuffer.flush();
+  }
+
   template <CorrelationContainer::CFStep step, typename TTarget, typename TTracks1, typename TTracks2>
   void fillCorrelations(TTarget target, TTracks1& tracks1, TTracks2& tracks2, float multiplicity, float posZ, int magField, float eventWeight)
   {
+    if constexpr (isEngineCompatible<step, TTracks1, TTracks2>()) {
+      if (cfgBulkPairFill && !cfgMassAxis) {
+        fillCorrelationsEngine<step>(target, tracks1, tracks2, multiplicity, posZ, magField, eventWeight);
+        return;
+      }
+    }
+
     // Cache efficiency for particles (too many FindBin lookups)
     if constexpr (step == CorrelationContainer::kCFStepCorrected) {
       if (cfg.mEfficiencyAssociated) {
@@ -399,6 +478,11 @@ struct CorrelationTask {
       }
     }
 
+    const bool bulkPairFill = cfgBulkPairFill && !cfgMassAxis;
+    if (bulkPairFill) {
+      pairBuffer.setTarget(target->getPairHist(), step);
+    }
+
     for (const auto& track1 : tracks1) {
       // LOGF(info, "Track %f | %f | %f  %d %d", track1.eta(), track1.phi(), track1.pt(), track1.isGlobalTrack(), track1.isGlobalTrackSDD());
 
@@ -564,11 +648,17 @@ struct CorrelationTask {
             target->getPairHist()->Fill(step, track1.eta() - track2.eta(), track2.pt(), track1.pt(), multiplicity, deltaPhi, posZ, track1.invMass(), associatedWeight);
           else
             LOGF(fatal, "Can not fill mass axis without invMass column. Disable cfgMassAxis.");
+        } else if (bulkPairFill) {
+          pairBuffer.add(track1.eta() - track2.eta(), track2.pt(), track1.pt(), multiplicity, deltaPhi, posZ, associatedWeight);
         } else {
           target->getPairHist()->Fill(step, track1.eta() - track2.eta(), track2.pt(), track1.pt(), multiplicity, deltaPhi, posZ, associatedWeight);
         }
       }
     }
+
+    if (bulkPairFill) {
+      pairBuffer.flush();
+    }
   }
 
   void loadEfficiency(uint64_t timestamp)
@@ -15,6 +15,7 @@
 
 #include "PWGCF/TwoParticleCorrelations/TableProducer/identifiedBfFilter.h"
 
+#include <array>
 #include <cmath>
 #include <algorithm>
 #include <string>
@@ -29,6 +30,7 @@
 #include "Common/Core/TrackSelectionDefaults.h"
 #include "Common/DataModel/PIDResponse.h"
 #include "PWGCF/Core/AnalysisConfigurableCuts.h"
+#include "PWGCF/Core/FilterTrackClassification.h"
 #include "PWGCF/TwoParticleCorrelations/DataModel/IdentifiedBfFiltered.h"
 #include "Common/DataModel/TrackSelectionTables.h"
 #include "Common/DataModel/CollisionAssociationTables.h"
@@ -78,8 +80,6 @@ TList* ccdblst = nullptr;
 bool loadfromccdb = false;
 
 std::vector<int> recoIdMethods = {0, 1, 2}; // Reconstructed PID Methods, 0 is no PID, 1 is calculated PID, 2 is MC PID
-std::vector<int> trackTypes = {0, 1, 2, 3};
-const int twoDenom = 2; // Used to test if a value is even or odd
 
 //============================================================================================
 // The IdentifiedBfFilter histogram objects
@@ -678,22 +678,6 @@ void IdentifiedBfFilter::processVertexGenerated(aod::McCollisions const& mccolli
   }
 }
 
-/// RMS calculation. Taken from PWGHF/Tasks/taskMcValidation.cxx
-/// \param vec  vector of values to compute RMS
-template <typename T>
-T computeRMS(std::vector<T>& vec)
-{
-  T sum = std::accumulate(vec.begin(), vec.end(), 0.0);
-  T mean = sum / vec.size();
-
-  std::vector<T> diff(vec.size());
-  std::transform(vec.begin(), vec.end(), diff.begin(), [mean](T x) { return x - mean; });
-  T sqSum = std::inner_product(diff.begin(), diff.end(), diff.begin(), 0.0);
-  T stdev = std::sqrt(sqSum / vec.size());
-
-  return stdev;
-}
-
 struct IdentifiedBfFilterTracks {
 
   struct : ConfigurableGroup {
@@ -778,6 +762,7 @@ struct IdentifiedBfFilterTracks {
 
   OutputObj<TList> fOutput{"IdentifiedBfFilterTracksInfo", OutputObjHandlingPolicy::AnalysisObject};
   bool checkAmbiguousTracks = false;
+  std::vector<double> zvertexes; /* the z of the compatible collisions of the current ambiguous track */
 
   void init(InitContext&)
   {
@@ -1438,7 +1423,7 @@ struct IdentifiedBfFilterTracks {
   template <typename ParticleObject>
   inline void identifyPIDMismatch(ParticleObject const& particle, MatchRecoGenSpecies const& trkId);
   template <typename ParticleObject>
-  inline void identifyRealNSigma(ParticleObject const& particle, std::vector<float> tpcNSigma, std::vector<float> tofNSigma, float tpcInnerParam);
+  inline void identifyRealNSigma(ParticleObject const& particle, std::array<float, kIdBfNoOfSpecies> const& tpcNSigma, std::array<float, kIdBfNoOfSpecies> const& tofNSigma, float tpcInnerParam);
   template <typename ParticleObject>
   inline MatchRecoGenSpecies identifyParticle(ParticleObject const& particle);
   template <typename TrackObject>
@@ -1483,10 +1468,9 @@ struct IdentifiedBfFilterTracks {
         if (!(pid < 0)) {
           naccepted++;
           /* update charged multiplicities */
-          if (pid % twoDenom == trackTypes[0]) {
+          if (o2::analysis::filtertracks::isPositiveCode(pid)) {
             trkMultPos[kIdBfCharged]++;
-          }
-          if (pid % twoDenom == trackTypes[1]) {
+          } else {
             trkMultNeg[kIdBfCharged]++;
           }
           if (fullDerivedData) {
@@ -1705,7 +1689,7 @@ inline void IdentifiedBfFilterTracks::identifyPIDMismatch(ParticleObject const&
 }
 
 template <typename ParticleObject>
-inline void IdentifiedBfFilterTracks::identifyRealNSigma(ParticleObject const& particle, std::vector<float> tpcNSigma, std::vector<float> tofNSigma, float tpcInnerParam)
+inline void IdentifiedBfFilterTracks::identifyRealNSigma(ParticleObject const& particle, std::array<float, kIdBfNoOfSpecies> const& tpcNSigma, std::array<float, kIdBfNoOfSpecies> const& tofNSigma, float tpcInnerParam)
 {
 
   MatchRecoGenSpecies realPID = identifyParticle(particle);
@@ -1784,14 +1768,14 @@ inline MatchRecoGenSpecies IdentifiedBfFilterTracks::identifyTrack(TrackObject c
 
   fillNSigmaHistos(track);
 
-  std::vector<float> actualTPCNSigma(kIdBfNoOfSpecies, 0.);
+  std::array<float, kIdBfNoOfSpecies> actualTPCNSigma{};
 
   actualTPCNSigma[kIdBfElectron] = track.tpcNSigmaEl();
   actualTPCNSigma[kIdBfPion] = track.tpcNSigmaPi();
   actualTPCNSigma[kIdBfKaon] = track.tpcNSigmaKa();
   actualTPCNSigma[kIdBfProton] = track.tpcNSigmaPr();
 
-  std::vector<float> actualTOFNSigma(kIdBfNoOfSpecies, 0.);
+  std::array<float, kIdBfNoOfSpecies> actualTOFNSigma{};
 
   actualTOFNSigma[kIdBfElectron] = track.tofNSigmaEl();
   actualTOFNSigma[kIdBfPion] = track.tofNSigmaPi();
@@ -1922,11 +1906,11 @@ inline int8_t IdentifiedBfFilterTracks::acceptTrack(TrackObject const& track)
         fillTrackHistosAfterSelection(track, sp); //<Fill accepted track histo with PID
         if (track.sign() > 0) {                   // if positive
           trkMultPos[sp]++; //<< Update Particle Multiplicity
-          return speciesChargeValue1[sp];
+          return o2::analysis::filtertracks::speciesChargeCode(sp, track.sign());
         }
         if (track.sign() < 0) { // if negative
           trkMultNeg[sp]++; //<< Update Particle Multiplicity
-          return speciesChargeValue1[sp] + 1;
+          return o2::analysis::filtertracks::speciesChargeCode(sp, track.sign());
         }
       }
     }
@@ -1984,11 +1968,8 @@ inline int8_t IdentifiedBfFilterTracks::acceptParticle(ParticleObject& particle,
             partMultNeg[sp]++;
           }
         }
-        if (charge == 1) {
-          return speciesChargeValue1[sp];
-
-        } else if (charge == -1) {
-          return speciesChargeValue1[sp] + 1;
+        if (sp != kWrongSpecies && (charge == 1 || charge == -1)) {
+          return o2::analysis::filtertracks::speciesChargeCode(sp, static_cast<int>(charge));
         }
       }
     } else {
@@ -2007,36 +1988,11 @@ inline int8_t IdentifiedBfFilterTracks::acceptParticle(ParticleObject& particle,
 template <typename CollisionObjects, typename TrackObject>
 int8_t IdentifiedBfFilterTracks::selectTrackAmbiguousCheck(CollisionObjects const& collisions, TrackObject const& track)
 {
-  // LOGF(info,"Top of AmbiguousCheck");
-  bool ambiguoustrack = false;
-  int tracktype = 0; /* no ambiguous */
-  std::vector<double> zvertexes{};
+  using namespace o2::analysis::filtertracks;
+
   /* ambiguous tracks checks if required */
-  if constexpr (has_type_v<aod::track_association::CollisionIds, typename TrackObject::all_columns>) {
-    if (track.compatibleCollIds().size() > 0) {
-      if (track.compatibleCollIds().size() == 1) {
-        if (track.collisionId() != track.compatibleCollIds()[0]) {
-          /* ambiguous track! */
-          ambiguoustrack = true;
-          /* in principle we should not be here because the track is associated to two collisions at least */
-          tracktype = 2;
-          zvertexes.push_back(collisions.iteratorAt(track.collisionId()).posZ());
-          zvertexes.push_back(collisions.iteratorAt(track.compatibleCollIds()[0]).posZ());
-        } else {
-          /* we consider the track as no ambiguous */
-          tracktype = 1;
-        }
-      } else {
-        /* ambiguous track! */
-        ambiguoustrack = true;
-        tracktype = 3;
-        /* the track is associated to more than one collision */
-        for (const auto& collIdx : track.compatibleCollIds()) {
-          zvertexes.push_back(collisions.iteratorAt(collIdx).posZ());
-        }
-      }
-    }
-  }
+  AmbiguityTypes tracktype = trackAmbiguity(collisions, track, zvertexes);
+  bool ambiguoustrack = (tracktype == kOnePossibilityDifferent) || (tracktype == kMoreThanOnePossibility);
 
   float multiplicityclass = (track.template collision_as<soa::Join<aod::Collisions, aod::IdentifiedBfCFCollisionsInfo>>()).centmult();
   if (ambiguoustrack) {
@@ -2044,7 +2000,7 @@ int8_t IdentifiedBfFilterTracks::selectTrackAmbiguousCheck(CollisionObjects cons
     fhAmbiguousTrackType->Fill(tracktype, multiplicityclass);
     fhAmbiguousTrackPt->Fill(track.pt(), multiplicityclass);
     fhAmbiguityDegree->Fill(zvertexes.size(), multiplicityclass);
-    if (tracktype == trackTypes[2]) {
+    if (tracktype == kOnePossibilityDifferent) {
       fhCompatibleCollisionsZVtxRms->Fill(-computeRMS(zvertexes), multiplicityclass);
     } else {
       fhCompatibleCollisionsZVtxRms->Fill(computeRMS(zvertexes), multiplicityclass);
@@ -90,13 +90,6 @@ const char* speciesName[kIdBfNoOfSpecies + 1] = {"e", "pi", "ka", "p", "ha"};
 
 const char* speciesTitle[kIdBfNoOfSpecies + 1] = {"e", "#pi", "K", "p", "ha"};
 
-const int speciesChargeValue1[kIdBfNoOfSpecies] = {
-  0, //< electron
-  2, //< pion
-  4, //< Kaon
-  6  //< proton
-};
-
 /// \enum SystemType
 /// \brief The type of the system under analysis
 enum SystemType {
@@ -44,6 +44,11 @@ struct DptDptPerRunExtraQc {
   AxisSpec qaPAxis{150, 0.1, 5.0};
 
   HistogramRegistry mHistos{"PerRunExtraQcHistograms", {}, OutputObjHandlingPolicy::AnalysisObject};
+  struct : ConfigurableGroup {
+    Configurable<bool> cfgCompact{"cfgCompact", false, "Accumulate all runs in a run x species x p_{tpciw}/p histogram instead of booking a profile per run"};
+    Configurable<int> cfgRatioBins{"cfgRatioBins", 100, "Number of p_{tpciw}/p bins of the compact histogram"};
+  } cfgCompactPerRun;
+  analysis::dptdptfilter::PerRunAccumulator mCompactPvsTpcIwP;
 
   void initRunNumber(aod::BCsWithTimestamps::iterator const& bc)
   {
@@ -53,6 +58,10 @@ struct DptDptPerRunExtraQc {
       return;
     } else {
       mRunNumber = bc.runNumber();
+      if (cfgCompactPerRun.cfgCompact) {
+        mCompactPvsTpcIwP.setRun(mRunNumber);
+        return;
+      }
       if (gRunMapPvsTpcIwP.find(mRunNumber) == gRunMapPvsTpcIwP.end()) {
         gRunMapPvsTpcIwP[mRunNumber] = mHistos.add<TProfile3D>(TString::Format("Reco/%d_pVsTpcIwP", mRunNumber).Data(), ";species;p (GeV/#it{c}); p_{tpciw} (GeV/#it{c})", {HistType::kTProfile3D, {{10, -0.5, 9.5}, qaPAxis, qaPAxis}}).get();
       }
@@ -65,6 +74,9 @@ struct DptDptPerRunExtraQc {
     using namespace perrunextraqc;
 
     qaPAxis.makeLogarithmic();
+    if (cfgCompactPerRun.cfgCompact) {
+      mCompactPvsTpcIwP.setHistogram(mHistos.add<TH3>("Reco/Compact/pTpcIwOverP", ";run;species;p_{tpciw}/p", {HistType::kTH3D, {{1, 0., 1., "run"}, {10, -0.5, 9.5, "species"}, {cfgCompactPerRun.cfgRatioBins, 0.5, 1.5, "p_{tpciw}/p"}}}).get());
+    }
   }
 
   template <typename PassedTracks>
@@ -72,6 +84,12 @@ struct DptDptPerRunExtraQc {
   {
     using namespace perrunextraqc;
 
+    if (cfgCompactPerRun.cfgCompact) {
+      for (const auto& track : tracks) {
+        mCompactPvsTpcIwP.fill(track.trackacceptedid(), track.tpcInnerParam() / track.p(), 1.0);
+      }
+      return;
+    }
     for (const auto& track : tracks) {
       gCurrentRunPvsPtcIwP->Fill(track.trackacceptedid(), track.p(), track.tpcInnerParam(), track.pt());
     }
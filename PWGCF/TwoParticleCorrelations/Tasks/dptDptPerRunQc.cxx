@@ -13,6 +13,7 @@
 /// \brief basic per run check of the ITS dead chips and of the hadronic interaction rate
 /// \author victor.gonzalez.sebastian@gmail.com
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <unordered_map>
@@ -66,6 +67,16 @@ struct DptDptPerRunQc {
   HistogramRegistry mHistos{"PerRunQaHistograms", {}, OutputObjHandlingPolicy::AnalysisObject};
 
   Configurable<std::string> cfgInteractionRateSource{"cfgInteractionRateSource", "ZNC hadronic", "The shource for the interaction rate measure.PbPb:ZNC hadronic;pp:T0VTX.Default:ZNC hadronic"};
+  struct : ConfigurableGroup {
+    Configurable<bool> cfgCompact{"cfgCompact", false, "Accumulate all runs in run x observable histograms instead of booking histograms per run"};
+    Configurable<int> cfgRateBins{"cfgRateBins", 101, "Number of hadronic rate bins of the compact histograms"};
+    Configurable<int> cfgTimeBins{"cfgTimeBins", 100, "Number of bins of the fraction of the run duration of the compact histograms"};
+  } cfgCompactPerRun;
+
+  double mRunSeconds{1.};
+  analysis::dptdptfilter::PerRunAccumulator mCompactHadronicRate;
+  analysis::dptdptfilter::PerRunAccumulator mCompactCollisionTimeBefore;
+  analysis::dptdptfilter::PerRunAccumulator mCompactCollisionTimeAfter;
 
   void initCCDB(aod::BCsWithTimestamps::iterator const& bc)
   {
@@ -76,6 +87,16 @@ struct DptDptPerRunQc {
       return;
     }
     mRunNumber = bc.runNumber();
+    if (cfgCompactPerRun.cfgCompact) {
+      /* only the run duration is needed, the collision time is stored as fraction of it */
+      auto runDuration = ccdb->getRunDuration(mRunNumber);
+      mMinSeconds = std::floor(runDuration.first * 1.e-3);
+      mRunSeconds = std::max(std::ceil(runDuration.second * 1.e-3) - mMinSeconds, 1.);
+      mCompactHadronicRate.setRun(mRunNumber);
+      mCompactCollisionTimeBefore.setRun(mRunNumber);
+      mCompactCollisionTimeAfter.setRun(mRunNumber);
+      return;
+    }
     if (gHadronicRate.find(mRunNumber) == gHadronicRate.end()) {
       auto runDuration = ccdb->getRunDuration(mRunNumber);
       uint64_t mSOR = runDuration.first;
@@ -112,6 +133,14 @@ struct DptDptPerRunQc {
     ccdb->setURL("http://alice-ccdb.cern.ch");
     ccdb->setCaching(true);
     ccdb->setFatalWhenNull(false);
+
+    if (cfgCompactPerRun.cfgCompact) {
+      const AxisSpec axisRun{1, 0., 1., "run"};
+      const AxisSpec axisRunFraction{cfgCompactPerRun.cfgTimeBins, 0., 1., "Time since SOR / run duration"};
+      mCompactHadronicRate.setHistogram(mHistos.add<TH2>("Compact/hadronicRate", ";run;Hadronic rate (kHz)", kTH2D, {axisRun, {cfgCompactPerRun.cfgRateBins, 0., 1010., "Hadronic rate (kHz)"}}).get());
+      mCompactCollisionTimeBefore.setHistogram(mHistos.add<TH2>("Compact/Before/hCollisionTimeB", "Collision time before;run;Time since SOR / run duration", kTH2D, {axisRun, axisRunFraction}).get());
+      mCompactCollisionTimeAfter.setHistogram(mHistos.add<TH2>("Compact/After/hCollisionTimeA", "Collision time;run;Time since SOR / run duration", kTH2D, {axisRun, axisRunFraction}).get());
+    }
   }
 
   void process(soa::Join<aod::Collisions, aod::EvSels, aod::DptDptCFCollisionsInfo>::iterator const& collision, aod::BCsWithTimestamps const&)
@@ -121,6 +150,17 @@ struct DptDptPerRunQc {
 
     auto bc = collision.bc_as<aod::BCsWithTimestamps>();
     initCCDB(bc);
+    if (cfgCompactPerRun.cfgCompact) {
+      double runFraction = (bc.timestamp() * 1.e-3 - mMinSeconds) / mRunSeconds;
+      mCompactCollisionTimeBefore.fill(runFraction);
+      if (!collision.collisionaccepted()) {
+        return;
+      }
+      double hadronicRate = mRateFetcher.fetch(ccdb.service, bc.timestamp(), mRunNumber, cfgInteractionRateSource) * 1.e-3;
+      mCompactHadronicRate.fill(hadronicRate);
+      mCompactCollisionTimeAfter.fill(runFraction);
+      return;
+    }
     int64_t orbit = bc.globalBC() / nBCsPerOrbit;
     gCurrentCollisionOrbitBefore->Fill(orbit);
 
@@ -11,6 +11,8 @@
 
 #include "PWGDQ/Core/AnalysisCompositeCut.h"
 
+#include <cstddef>
+
 ClassImp(AnalysisCompositeCut)
 
   //____________________________________________________________________________
@@ -45,6 +47,13 @@ AnalysisCompositeCut::AnalysisCompositeCut(const AnalysisCompositeCut& c) : Anal
     fOptionUseAND = c.fOptionUseAND;
     fCutList = c.fCutList;
     fCompositeCutList = c.fCompositeCutList;
+    fCompiled = c.fCompiled;
+    fFlatChecks = c.fFlatChecks;
+    fFlatLimits = c.fFlatLimits;
+    fFlatTerms = c.fFlatTerms;
+    fFlatNodes = c.fFlatNodes;
+    fFlatChildren = c.fFlatChildren;
+    fFlatDecisions = c.fFlatDecisions;
   }
 }
 
@@ -59,6 +68,13 @@ AnalysisCompositeCut& AnalysisCompositeCut::operator=(const AnalysisCompositeCut
     fOptionUseAND = c.fOptionUseAND;
     fCutList = c.fCutList;
     fCompositeCutList = c.fCompositeCutList;
+    fCompiled = c.fCompiled;
+    fFlatChecks = c.fFlatChecks;
+    fFlatLimits = c.fFlatLimits;
+    fFlatTerms = c.fFlatTerms;
+    fFlatNodes = c.fFlatNodes;
+    fFlatChildren = c.fFlatChildren;
+    fFlatDecisions = c.fFlatDecisions;
   }
   return (*this);
 }
@@ -67,32 +83,181 @@ AnalysisCompositeCut& AnalysisCompositeCut::operator=(const AnalysisCompositeCut
 AnalysisCompositeCut::~AnalysisCompositeCut() = default;
 
 //____________________________________________________________________________
-bool AnalysisCompositeCut::IsSelected(float* values)
+void AnalysisCompositeCut::Compile(int nTabulationPoints)
 {
   //
-  // apply cuts
+  // flatten the tree of cuts
+  //
+  fFlatChecks.clear();
+  fFlatLimits.clear();
+  fFlatTerms.clear();
+  fFlatNodes.clear();
+  fFlatChildren.clear();
+  CompileNode(*this, nTabulationPoints);
+  fFlatDecisions.assign(fFlatNodes.size(), 0);
+  fCompiled = true;
+}
+
+//____________________________________________________________________________
+int AnalysisCompositeCut::CompileNode(const AnalysisCompositeCut& cut, int nTabulationPoints)
+{
+  //
+  // add the flattened representation of a composite cut and return the index of its node
+  //
+  FlatNode node;
+  node.fUseAND = cut.fOptionUseAND;
+  node.fFirstTerm = fFlatTerms.size();
+  node.fNTerms = cut.fCutList.size();
+  for (auto const& term : cut.fCutList) {
+    FlatTerm flatTerm{static_cast<int>(fFlatChecks.size()), static_cast<int>(term.GetCuts().size())};
+    for (auto const& c : term.GetCuts()) {
+      FlatCheck check;
+      check.fVar = c.fVar;
+      check.fDepVar = c.fDepVar;
+      check.fDepVar2 = c.fDepVar2;
+      check.fExclude = c.fExclude;
+      check.fDepExclude = c.fDepExclude;
+      check.fDep2Exclude = c.fDep2Exclude;
+      check.fLow = c.fLow;
+      check.fHigh = c.fHigh;
+      check.fDepLow = c.fDepLow;
+      check.fDepHigh = c.fDepHigh;
+      check.fDep2Low = c.fDep2Low;
+      check.fDep2High = c.fDep2High;
+      check.fLimitLow = c.fFuncLow ? AddFlatLimit(c.fFuncLow, nTabulationPoints) : -1;
+      check.fLimitHigh = c.fFuncHigh ? AddFlatLimit(c.fFuncHigh, nTabulationPoints) : -1;
+      fFlatChecks.push_back(check);
+    }
+    fFlatTerms.push_back(flatTerm);
+  }
+
+  std::vector<int> children;
+  for (auto const& child : cut.fCompositeCutList) {
+    children.push_back(CompileNode(child, nTabulationPoints));
+  }
+  node.fFirstChild = fFlatChildren.size();
+  node.fNChildren = children.size();
+  fFlatChildren.insert(fFlatChildren.end(), children.begin(), children.end());
+
+  fFlatNodes.push_back(node);
+  return fFlatNodes.size() - 1;
+}
+
+//____________________________________________________________________________
+int AnalysisCompositeCut::AddFlatLimit(TF1* func, int nTabulationPoints)
+{
+  //
+  // add a function based cut limit, tabulated in the range of the function if requested
+  //
+  FlatLimit limit;
+  limit.fFunc = func;
+  limit.fXmin = func->GetXmin();
+  limit.fInvStep = 0.0;
+  if (nTabulationPoints > 1 && func->GetXmax() > func->GetXmin()) {
+    double step = (func->GetXmax() - func->GetXmin()) / (nTabulationPoints - 1);
+    limit.fInvStep = 1.0 / step;
+    limit.fTable.resize(nTabulationPoints);
+    for (int i = 0; i < nTabulationPoints; ++i) {
+      limit.fTable[i] = func->Eval(func->GetXmin() + i * step);
+    }
+  }
+  fFlatLimits.push_back(limit);
+  return fFlatLimits.size() - 1;
+}
+
+//____________________________________________________________________________
+float AnalysisCompositeCut::EvalFlatLimit(int index, float x) const
+{
+  //
+  // evaluate a function based cut limit, by linear interpolation if tabulated
   //
-  for (std::vector<AnalysisCut>::iterator it = fCutList.begin(); it < fCutList.end(); ++it) {
-    if (fOptionUseAND && !(*it).IsSelected(values)) {
-      return false;
+  const FlatLimit& limit = fFlatLimits[index];
+  if (!limit.fTable.empty()) {
+    float pos = (x - limit.fXmin) * limit.fInvStep;
+    if (pos >= 0.0f && pos < static_cast<float>(limit.fTable.size() - 1)) {
+      int bin = static_cast<int>(pos);
+      float frac = pos - bin;
+      return limit.fTable[bin] + frac * (limit.fTable[bin + 1] - limit.fTable[bin]);
     }
-    if (!fOptionUseAND && (*it).IsSelected(values)) {
-      return true;
+  }
+  return limit.fFunc->Eval(x);
+}
+
+//____________________________________________________________________________
+bool AnalysisCompositeCut::EvalFlatTerm(const FlatTerm& term, const float* values) const
+{
+  //
+  // AND of the range checks of one AnalysisCut; a check fails if it applies (dependent variables in range) and the variable is not in range
+  //
+  bool failed = false;
+  for (int i = term.fFirstCheck; i < term.fFirstCheck + term.fNChecks; ++i) {
+    const FlatCheck& check = fFlatChecks[i];
+    bool applies = true;
+    if (check.fDepVar != -1) {
+      bool inRange = (values[check.fDepVar] > check.fDepLow && values[check.fDepVar] <= check.fDepHigh);
+      applies = (inRange != check.fDepExclude);
     }
+    if (check.fDepVar2 != -1) {
+      bool inRange = (values[check.fDepVar2] > check.fDep2Low && values[check.fDepVar2] <= check.fDep2High);
+      applies &= (inRange != check.fDep2Exclude);
+    }
+    float cutLow = (check.fLimitLow < 0 ? check.fLow : EvalFlatLimit(check.fLimitLow, values[check.fDepVar]));
+    float cutHigh = (check.fLimitHigh < 0 ? check.fHigh : EvalFlatLimit(check.fLimitHigh, values[check.fDepVar]));
+    bool inRange = (values[check.fVar] >= cutLow && values[check.fVar] <= cutHigh);
+    failed |= (applies & (inRange == check.fExclude));
   }
+  return !failed;
+}
 
-  for (std::vector<AnalysisCompositeCut>::iterator it = fCompositeCutList.begin(); it < fCompositeCutList.end(); ++it) {
-    if (fOptionUseAND && !(*it).IsSelected(values)) {
-      return false;
+//____________________________________________________________________________
+bool AnalysisCompositeCut::EvalFlat(const float* values)
+{
+  //
+  // evaluate the nodes in order (children always come before their parent) and return the decision of the root node
+  // the decisions of the terms and child nodes are reduced with AND or OR
+  //
+  for (std::size_t node = 0; node < fFlatNodes.size(); ++node) {
+    const FlatNode& flatNode = fFlatNodes[node];
+    bool all = true;
+    bool any = false;
+    for (int i = flatNode.fFirstTerm; i < flatNode.fFirstTerm + flatNode.fNTerms; ++i) {
+      bool decision = EvalFlatTerm(fFlatTerms[i], values);
+      all &= decision;
+      any |= decision;
     }
-    if (!fOptionUseAND && (*it).IsSelected(values)) {
-      return true;
+    for (int i = flatNode.fFirstChild; i < flatNode.fFirstChild + flatNode.fNChildren; ++i) {
+      bool decision = fFlatDecisions[fFlatChildren[i]];
+      all &= decision;
+      any |= decision;
     }
+    fFlatDecisions[node] = flatNode.fUseAND ? all : any;
+  }
+  return fFlatDecisions.back();
+}
+
+//____________________________________________________________________________
+bool AnalysisCompositeCut::IsSelected(float* values)
+{
+  //
+  // apply cuts
+  //
+  if (!fCompiled) {
+    Compile();
   }
+  return EvalFlat(values);
+}
 
-  if (fOptionUseAND) {
-    return true;
-  } else {
-    return false;
+//____________________________________________________________________________
+void AnalysisCompositeCut::IsSelected(const float* values, int nEntries, int stride, std::vector<uint64_t>& selected)
+{
+  //
+  // apply cuts on a block of entries and fill the selection bitmap
+  //
+  if (!fCompiled) {
+    Compile();
+  }
+  selected.assign((nEntries + 63) / 64, 0);
+  for (int i = 0; i < nEntries; ++i) {
+    selected[i / 64] |= (static_cast<uint64_t>(EvalFlat(values + static_cast<int64_t>(i) * stride)) << (i % 64));
   }
 }
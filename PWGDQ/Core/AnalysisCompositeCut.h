@@ -18,6 +18,7 @@
 #define AnalysisCompositeCut_H
 
 #include "PWGDQ/Core/AnalysisCut.h"
+#include <cstdint>
 #include <vector>
 
 //_________________________________________________________________________
@@ -37,18 +38,77 @@ class AnalysisCompositeCut : public AnalysisCut
     } else {
       fCutList.push_back(*cut);
     }
+    fCompiled = false;
   };
 
   bool GetUseAND() const { return fOptionUseAND; }
   int GetNCuts() const { return fCutList.size() + fCompositeCutList.size(); }
 
+  // Flatten the tree of cuts into a linear list of range checks which is evaluated without recursion.
+  // The compilation is done automatically at the first call of IsSelected(); call it explicitly to tabulate
+  // the TF1 based cut limits on nTabulationPoints points (0: the functions are evaluated for each entry)
+  void Compile(int nTabulationPoints = 0);
+  bool IsCompiled() const { return fCompiled; }
+
   bool IsSelected(float* values) override;
+  // Apply the cut on a block of nEntries entries stored contiguously, the values of entry i starting at values + i * stride.
+  // Bit (i % 64) of word (i / 64) of the selection bitmap is set if entry i is selected
+  void IsSelected(const float* values, int nEntries, int stride, std::vector<uint64_t>& selected);
 
  protected:
   bool fOptionUseAND;                                  // true (default): apply AND on all cuts; false: use OR
   std::vector<AnalysisCut> fCutList;                   // list of cuts
   std::vector<AnalysisCompositeCut> fCompositeCutList; // list of composite cuts
 
+  // flattened representation of the cut tree
+  struct FlatCheck {   // one range check, i.e. one CutContainer of an AnalysisCut
+    short fVar;        // variable to be cut upon
+    short fDepVar;     // first dependent variable, -1 if not used
+    short fDepVar2;    // second dependent variable, -1 if not used
+    bool fExclude;     // if true, use the selection range for exclusion
+    bool fDepExclude;  // if true, use the first dependent variable range as exclusion
+    bool fDep2Exclude; // if true, use the second dependent variable range as exclusion
+    float fLow;        // lower limit, if constant
+    float fHigh;       // upper limit, if constant
+    float fDepLow;     // lower limit for the first dependent variable
+    float fDepHigh;    // upper limit for the first dependent variable
+    float fDep2Low;    // lower limit for the second dependent variable
+    float fDep2High;   // upper limit for the second dependent variable
+    int fLimitLow;     // index in fFlatLimits of the lower limit function, -1 if constant
+    int fLimitHigh;    // index in fFlatLimits of the upper limit function, -1 if constant
+  };
+  struct FlatLimit {           // cut limit given by a TF1 of the first dependent variable, optionally tabulated
+    TF1* fFunc;                // function, used outside of the tabulated range
+    float fXmin;               // lower edge of the tabulated range
+    float fInvStep;            // inverse of the tabulation step
+    std::vector<float> fTable; // tabulated function values, empty if not tabulated
+  };
+  struct FlatNode {  // one AnalysisCompositeCut of the tree
+    bool fUseAND;    // AND or OR of the terms and children
+    int fFirstTerm;  // first term (AnalysisCut) in fFlatTerms
+    int fNTerms;     // number of terms
+    int fFirstChild; // first child node index in fFlatChildren
+    int fNChildren;  // number of child nodes
+  };
+  struct FlatTerm {  // one AnalysisCut, i.e. the AND of a contiguous range of checks
+    int fFirstCheck; // first check in fFlatChecks
+    int fNChecks;    // number of checks
+  };
+
+  int CompileNode(const AnalysisCompositeCut& cut, int nTabulationPoints);
+  int AddFlatLimit(TF1* func, int nTabulationPoints);
+  float EvalFlatLimit(int index, float x) const;
+  bool EvalFlatTerm(const FlatTerm& term, const float* values) const;
+  bool EvalFlat(const float* values);
+
+  bool fCompiled = false;             //! true if the flattened representation is up to date
+  std::vector<FlatCheck> fFlatChecks; //! range checks of all the terms
+  std::vector<FlatLimit> fFlatLimits; //! TF1 based cut limits
+  std::vector<FlatTerm> fFlatTerms;   //! terms of all the nodes
+  std::vector<FlatNode> fFlatNodes;   //! nodes, each after its children and the root node last
+  std::vector<int> fFlatChildren;     //! child node indices of all the nodes
+  std::vector<char> fFlatDecisions;   //! decisions of the nodes for the entry being evaluated
+
   ClassDef(AnalysisCompositeCut, 2);
 };
 
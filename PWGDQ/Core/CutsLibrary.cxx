@@ -14,6 +14,10 @@
 #include "PWGDQ/Core/CutsLibrary.h"
 #include <RtypesCore.h>
 #include <TF1.h>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include <string>
 #include <iostream>
@@ -23,7 +27,75 @@
 using std::cout;
 using std::endl;
 
+namespace
+{
+// factories registered at run time and cuts already built by the library, looked up by name
+template <typename T>
+struct CutRegistry {
+  std::unordered_map<std::string, std::function<T*(const char*)>> factories;
+  std::unordered_map<std::string, std::unique_ptr<T>> built;
+};
+
+CutRegistry<AnalysisCompositeCut>& compositeCutRegistry()
+{
+  static CutRegistry<AnalysisCompositeCut> registry;
+  return registry;
+}
+
+CutRegistry<AnalysisCut>& analysisCutRegistry()
+{
+  static CutRegistry<AnalysisCut> registry;
+  return registry;
+}
+} // namespace
+
+void o2::aod::dqcuts::RegisterCompositeCut(const char* cutName, std::function<AnalysisCompositeCut*(const char*)> factory)
+{
+  compositeCutRegistry().factories[cutName] = std::move(factory);
+}
+
+void o2::aod::dqcuts::RegisterAnalysisCut(const char* cutName, std::function<AnalysisCut*(const char*)> factory)
+{
+  analysisCutRegistry().factories[cutName] = std::move(factory);
+}
+
 AnalysisCompositeCut* o2::aod::dqcuts::GetCompositeCut(const char* cutName)
+{
+  //
+  // look up the cut among the registered factories and the cuts already built; build it from the library only at the first request
+  //
+  auto& registry = compositeCutRegistry();
+  std::string nameStr = cutName;
+  if (auto factory = registry.factories.find(nameStr); factory != registry.factories.end()) {
+    return factory->second(cutName);
+  }
+  auto cut = registry.built.find(nameStr);
+  if (cut == registry.built.end()) {
+    std::unique_ptr<AnalysisCompositeCut> newCut(BuildCompositeCut(cutName));
+    cut = registry.built.emplace(nameStr, std::move(newCut)).first;
+  }
+  return new AnalysisCompositeCut(*(cut->second));
+}
+
+AnalysisCut* o2::aod::dqcuts::GetAnalysisCut(const char* cutName)
+{
+  //
+  // look up the cut among the registered factories and the cuts already built; build it from the library only at the first request
+  //
+  auto& registry = analysisCutRegistry();
+  std::string nameStr = cutName;
+  if (auto factory = registry.factories.find(nameStr); factory != registry.factories.end()) {
+    return factory->second(cutName);
+  }
+  auto cut = registry.built.find(nameStr);
+  if (cut == registry.built.end()) {
+    std::unique_ptr<AnalysisCut> newCut(BuildAnalysisCut(cutName));
+    cut = registry.built.emplace(nameStr, std::move(newCut)).first;
+  }
+  return new AnalysisCut(*(cut->second));
+}
+
+AnalysisCompositeCut* o2::aod::dqcuts::BuildCompositeCut(const char* cutName)
 {
   //
   // define composie cuts, typically combinations of all the ingredients needed for a full cut
@@ -1176,11 +1248,11 @@ AnalysisCompositeCut* o2::aod::dqcuts::GetCompositeCut(const char* cutName)
 
   // Magnus composite cuts -----------------------------------------------------------------------------------------------------------------
 
-  AnalysisCompositeCut* magnus_PID111 = new AnalysisCompositeCut("magnus_PID111", "");
-  magnus_PID111->AddCut(GetAnalysisCut("pidJpsi_magnus_ele1"));
-  magnus_PID111->AddCut(GetAnalysisCut("pidJpsi_magnus_pion1"));
-  magnus_PID111->AddCut(GetAnalysisCut("pidJpsi_magnus_prot1"));
   if (!nameStr.compare("MagnussOptimization111")) {
+    AnalysisCompositeCut* magnus_PID111 = new AnalysisCompositeCut("magnus_PID111", "");
+    magnus_PID111->AddCut(GetAnalysisCut("pidJpsi_magnus_ele1"));
+    magnus_PID111->AddCut(GetAnalysisCut("pidJpsi_magnus_pion1"));
+    magnus_PID111->AddCut(GetAnalysisCut("pidJpsi_magnus_prot1"));
     cut->AddCut(GetAnalysisCut("kineJpsiEle_ionut"));
     cut->AddCut(GetAnalysisCut("dcaCut1_ionut"));
     cut->AddCut(GetAnalysisCut("trackQuality_ionut"));
@@ -1188,11 +1260,11 @@ AnalysisCompositeCut* o2::aod::dqcuts::GetCompositeCut(const char* cutName)
     return cut;
   }
 
-  AnalysisCompositeCut* magnus_PID211 = new AnalysisCompositeCut("magnus_PID211", "");
-  magnus_PID211->AddCut(GetAnalysisCut("pidJpsi_magnus_ele2"));
-  magnus_PID211->AddCut(GetAnalysisCut("pidJpsi_magnus_pion1"));
-  magnus_PID211->AddCut(GetAnalysisCut("pidJpsi_magnus_prot1"));
   if (!nameStr.compare("MagnussOptimization211")) {
+    AnalysisCompositeCut* magnus_PID211 = new AnalysisCompositeCut("magnus_PID211", "");
+    magnus_PID211->AddCut(GetAnalysisCut("pidJpsi_magnus_ele2"));
+    magnus_PID211->AddCut(GetAnalysisCut("pidJpsi_magnus_pion1"));
+    magnus_PID211->AddCut(GetAnalysisCut("pidJpsi_magnus_prot1"));
     cut->AddCut(GetAnalysisCut("kineJpsiEle_ionut"));
     cut->AddCut(GetAnalysisCut("dcaCut1_ionut"));
     cut->AddCut(GetAnalysisCut("trackQuality_ionut"));
@@ -1200,11 +1272,11 @@ AnalysisCompositeCut* o2::aod::dqcuts::GetCompositeCut(const char* cutName)
     return cut;
   }
 
-  AnalysisCompositeCut* magnus_PID311 = new AnalysisCompositeCut("magnus_PID311", "");
-  magnus_PID311->AddCut(GetAnalysisCut("pidJpsi_magnus_ele3"));
-  magnus_PID311->AddCut(GetAnalysisCut("pidJpsi_magnus_pion1"));
-  magnus_PID311->AddCut(GetAnalysisCut("pidJpsi_magnus_prot1"));
   if (!nameStr.compare("MagnussOptimization311")) {
+    AnalysisCompositeCut* magnus_PID311 = new AnalysisCompositeCut("magnus_PID311", "");
+    magnus_PID311->AddCut(GetAnalysisCut("pidJpsi_magnus_ele3"));
+    magnus_PID311->AddCut(GetAnalysisCut("pidJpsi_magnus_pion1"));
+    magnus_PID311->AddCut(GetAnalysisCut("pidJpsi_magnus_prot1"));
     cut->AddCut(GetAnalysisCut("kineJpsiEle_ionut"));
     cut->AddCut(GetAnalysisCut("dcaCut1_ionut"));
     cut->AddCut(GetAnalysisCut("trackQuality_ionut"));
@@ -1212,11 +1284,11 @@ AnalysisCompositeCut* o2::aod::dqcuts::GetCompositeCut(const char* cutName)
     return cut;
   }
 
-  AnalysisCompositeCut* magnus_PID121 = new AnalysisCompositeCut("magnus_PID121", "");
-  magnus_PID121->AddCut(GetAnalysisCut("pidJpsi_magnus_ele1"));
-  magnus_PID121->AddCut(GetAnalysisCut("pidJpsi_magnus_pion2"));
-  magnus_PID121->AddCut(GetAnalysisCut("pidJpsi_magnus_prot1"));
   if (!nameStr.compare("MagnussOptimization121")) {
+    AnalysisCompositeCut* magnus_PID121 = new AnalysisCompositeCut("magnus_PID121", "");
+    magnus_PID121->AddCut(GetAnalysisCut("pidJpsi_magnus_ele1"));
+    magnus_PID121->AddCut(GetAnalysisCut("pidJpsi_magnus_pion2"));
+    magnus_PID121->AddCut(GetAnalysisCut("pidJpsi_magnus_prot1"));
     cut->AddCut(GetAnalysisCut("kineJpsiEle_ionut"));
     cut->AddCut(GetAnalysisCut("dcaCut1_ionut"));
     cut->AddCut(GetAnalysisCut("trackQuality_ionut"));
@@ -1224,11 +1296,11 @@ AnalysisCompositeCut* o2::aod::dqcuts::GetCompositeCut(const char* cutName)
     return cut;
   }
 
-  AnalysisCompositeCut* magnus_PID112 = new AnalysisCompositeCut("magnus_PID112", "");
-  magnus_PID112->AddCut(GetAnalysisCut("pidJpsi_magnus_ele1"));
-  magnus_PID112->AddCut(GetAnalysisCut("pidJpsi_magnus_pion1"));
-  magnus_PID112->AddCut(GetAnalysisCut("pidJpsi_magnus_prot2"));
   if (!nameStr.compare("MagnussOptimization112")) {
+    AnalysisCompositeCut* magnus_PID112 = new AnalysisCompositeCut("magnus_PID112", "");
+    magnus_PID112->AddCut(GetAnalysisCut("pidJpsi_magnus_ele1"));
+    magnus_PID112->AddCut(GetAnalysisCut("pidJpsi_magnus_pion1"));
+    magnus_PID112->AddCut(GetAnalysisCut("pidJpsi_magnus_prot2"));
     cut->AddCut(GetAnalysisCut("kineJpsiEle_ionut"));
     cut->AddCut(GetAnalysisCut("dcaCut1_ionut"));
     cut->AddCut(GetAnalysisCut("trackQuality_ionut"));
@@ -1236,11 +1308,11 @@ AnalysisCompositeCut* o2::aod::dqcuts::GetCompositeCut(const char* cutName)
     return cut;
   }
 
-  AnalysisCompositeCut* magnus_PID122 = new AnalysisCompositeCut("magnus_PID122", "");
-  magnus_PID122->AddCut(GetAnalysisCut("pidJpsi_magnus_ele1"));
-  magnus_PID122->AddCut(GetAnalysisCut("pidJpsi_magnus_pion2"));
-  magnus_PID122->AddCut(GetAnalysisCut("pidJpsi_magnus_prot2"));
   if (!nameStr.compare("MagnussOptimization122")) {
+    AnalysisCompositeCut* magnus_PID122 = new AnalysisCompositeCut("magnus_PID122", "");
+    magnus_PID122->AddCut(GetAnalysisCut("pidJpsi_magnus_ele1"));
+    magnus_PID122->AddCut(GetAnalysisCut("pidJpsi_magnus_pion2"));
+    magnus_PID122->AddCut(GetAnalysisCut("pidJpsi_magnus_prot2"));
     cut->AddCut(GetAnalysisCut("kineJpsiEle_ionut"));
     cut->AddCut(GetAnalysisCut("dcaCut1_ionut"));
     cut->AddCut(GetAnalysisCut("trackQuality_ionut"));
@@ -1248,11 +1320,11 @@ AnalysisCompositeCut* o2::aod::dqcuts::GetCompositeCut(const char* cutName)
     return cut;
   }
 
-  AnalysisCompositeCut* magnus_PID222 = new AnalysisCompositeCut("magnus_PID222", "");
-  magnus_PID222->AddCut(GetAnalysisCut("pidJpsi_magnus_ele2"));
-  magnus_PID222->AddCut(GetAnalysisCut("pidJpsi_magnus_pion2"));
-  magnus_PID222->AddCut(GetAnalysisCut("pidJpsi_magnus_prot2"));
   if (!nameStr.compare("MagnussOptimization222")) {
+    AnalysisCompositeCut* magnus_PID222 = new AnalysisCompositeCut("magnus_PID222", "");
+    magnus_PID222->AddCut(GetAnalysisCut("pidJpsi_magnus_ele2"));
+    magnus_PID222->AddCut(GetAnalysisCut("pidJpsi_magnus_pion2"));
+    magnus_PID222->AddCut(GetAnalysisCut("pidJpsi_magnus_prot2"));
     cut->AddCut(GetAnalysisCut("kineJpsiEle_ionut"));
     cut->AddCut(GetAnalysisCut("dcaCut1_ionut"));
     cut->AddCut(GetAnalysisCut("trackQuality_ionut"));
@@ -1260,11 +1332,11 @@ AnalysisCompositeCut* o2::aod::dqcuts::GetCompositeCut(const char* cutName)
     return cut;
   }
 
-  AnalysisCompositeCut* magnus_PID212 = new AnalysisCompositeCut("magnus_PID212", "");
-  magnus_PID212->AddCut(GetAnalysisCut("pidJpsi_magnus_ele2"));
-  magnus_PID212->AddCut(GetAnalysisCut("pidJpsi_magnus_pion1"));
-  magnus_PID212->AddCut(GetAnalysisCut("pidJpsi_magnus_prot2"));
   if (!nameStr.compare("MagnussOptimization212")) {
+    AnalysisCompositeCut* magnus_PID212 = new AnalysisCompositeCut("magnus_PID212", "");
+    magnus_PID212->AddCut(GetAnalysisCut("pidJpsi_magnus_ele2"));
+    magnus_PID212->AddCut(GetAnalysisCut("pidJpsi_magnus_pion1"));
+    magnus_PID212->AddCut(GetAnalysisCut("pidJpsi_magnus_prot2"));
     cut->AddCut(GetAnalysisCut("kineJpsiEle_ionut"));
     cut->AddCut(GetAnalysisCut("dcaCut1_ionut"));
     cut->AddCut(GetAnalysisCut("trackQuality_ionut"));
@@ -1272,11 +1344,11 @@ AnalysisCompositeCut* o2::aod::dqcuts::GetCompositeCut(const char* cutName)
     return cut;
   }
 
-  AnalysisCompositeCut* magnus_PID221 = new AnalysisCompositeCut("magnus_PID221", "");
-  magnus_PID221->AddCut(GetAnalysisCut("pidJpsi_magnus_ele2"));
-  magnus_PID221->AddCut(GetAnalysisCut("pidJpsi_magnus_pion2"));
-  magnus_PID221->AddCut(GetAnalysisCut("pidJpsi_magnus_prot1"));
   if (!nameStr.compare("MagnussOptimization221")) {
+    AnalysisCompositeCut* magnus_PID221 = new AnalysisCompositeCut("magnus_PID221", "");
+    magnus_PID221->AddCut(GetAnalysisCut("pidJpsi_magnus_ele2"));
+    magnus_PID221->AddCut(GetAnalysisCut("pidJpsi_magnus_pion2"));
+    magnus_PID221->AddCut(GetAnalysisCut("pidJpsi_magnus_prot1"));
     cut->AddCut(GetAnalysisCut("kineJpsiEle_ionut"));
     cut->AddCut(GetAnalysisCut("dcaCut1_ionut"));
     cut->AddCut(GetAnalysisCut("trackQuality_ionut"));
@@ -1284,11 +1356,11 @@ AnalysisCompositeCut* o2::aod::dqcuts::GetCompositeCut(const char* cutName)
     return cut;
   }
 
-  AnalysisCompositeCut* magnus_PID321 = new AnalysisCompositeCut("magnus_PID321", "");
-  magnus_PID321->AddCut(GetAnalysisCut("pidJpsi_magnus_ele3"));
-  magnus_PID321->AddCut(GetAnalysisCut("pidJpsi_magnus_pion2"));
-  magnus_PID321->AddCut(GetAnalysisCut("pidJpsi_magnus_prot1"));
   if (!nameStr.compare("MagnussOptimization321")) {
+    AnalysisCompositeCut* magnus_PID321 = new AnalysisCompositeCut("magnus_PID321", "");
+    magnus_PID321->AddCut(GetAnalysisCut("pidJpsi_magnus_ele3"));
+    magnus_PID321->AddCut(GetAnalysisCut("pidJpsi_magnus_pion2"));
+    magnus_PID321->AddCut(GetAnalysisCut("pidJpsi_magnus_prot1"));
     cut->AddCut(GetAnalysisCut("kineJpsiEle_ionut"));
     cut->AddCut(GetAnalysisCut("dcaCut1_ionut"));
     cut->AddCut(GetAnalysisCut("trackQuality_ionut"));
@@ -1296,11 +1368,11 @@ AnalysisCompositeCut* o2::aod::dqcuts::GetCompositeCut(const char* cutName)
     return cut;
   }
 
-  AnalysisCompositeCut* magnus_PID312 = new AnalysisCompositeCut("magnus_PID312", "");
-  magnus_PID312->AddCut(GetAnalysisCut("pidJpsi_magnus_ele3"));
-  magnus_PID312->AddCut(GetAnalysisCut("pidJpsi_magnus_pion1"));
-  magnus_PID312->AddCut(GetAnalysisCut("pidJpsi_magnus_prot2"));
   if (!nameStr.compare("MagnussOptimization312")) {
+    AnalysisCompositeCut* magnus_PID312 = new AnalysisCompositeCut("magnus_PID312", "");
+    magnus_PID312->AddCut(GetAnalysisCut("pidJpsi_magnus_ele3"));
+    magnus_PID312->AddCut(GetAnalysisCut("pidJpsi_magnus_pion1"));
+    magnus_PID312->AddCut(GetAnalysisCut("pidJpsi_magnus_prot2"));
     cut->AddCut(GetAnalysisCut("kineJpsiEle_ionut"));
     cut->AddCut(GetAnalysisCut("dcaCut1_ionut"));
     cut->AddCut(GetAnalysisCut("trackQuality_ionut"));
@@ -1308,11 +1380,11 @@ AnalysisCompositeCut* o2::aod::dqcuts::GetCompositeCut(const char* cutName)
     return cut;
   }
 
-  AnalysisCompositeCut* magnus_PID322 = new AnalysisCompositeCut("magnus_PID322", "");
-  magnus_PID322->AddCut(GetAnalysisCut("pidJpsi_magnus_ele1"));
-  magnus_PID322->AddCut(GetAnalysisCut("pidJpsi_magnus_pion2"));
-  magnus_PID322->AddCut(GetAnalysisCut("pidJpsi_magnus_prot2"));
   if (!nameStr.compare("MagnussOptimization322")) {
+    AnalysisCompositeCut* magnus_PID322 = new AnalysisCompositeCut("magnus_PID322", "");
+    magnus_PID322->AddCut(GetAnalysisCut("pidJpsi_magnus_ele1"));
+    magnus_PID322->AddCut(GetAnalysisCut("pidJpsi_magnus_pion2"));
+    magnus_PID322->AddCut(GetAnalysisCut("pidJpsi_magnus_prot2"));
     cut->AddCut(GetAnalysisCut("kineJpsiEle_ionut"));
     cut->AddCut(GetAnalysisCut("dcaCut1_ionut"));
     cut->AddCut(GetAnalysisCut("trackQuality_ionut"));
@@ -3723,7 +3795,7 @@ AnalysisCompositeCut* o2::aod::dqcuts::GetCompositeCut(const char* cutName)
   return nullptr;
 }
 
-AnalysisCut* o2::aod::dqcuts::GetAnalysisCut(const char* cutName)
+AnalysisCut* o2::aod::dqcuts::BuildAnalysisCut(const char* cutName)
 {
   //
   // define here cuts which are likely to be used often
@@ -15,6 +15,7 @@
 #ifndef PWGDQ_CORE_CUTSLIBRARY_H_
 #define PWGDQ_CORE_CUTSLIBRARY_H_
 
+#include <functional>
 #include <string>
 #include <vector>
 #include "PWGDQ/Core/AnalysisCut.h"
@@ -103,8 +104,14 @@ namespace o2::aod
 {
 namespace dqcuts
 {
+// The cuts are looked up first among the registered factories, then among the cuts already built in this process
+// (a copy of which is returned), and are built from the library only at their first request
 AnalysisCompositeCut* GetCompositeCut(const char* cutName);
 AnalysisCut* GetAnalysisCut(const char* cutName);
+AnalysisCompositeCut* BuildCompositeCut(const char* cutName);
+AnalysisCut* BuildAnalysisCut(const char* cutName);
+void RegisterCompositeCut(const char* cutName, std::function<AnalysisCompositeCut*(const char*)> factory);
+void RegisterAnalysisCut(const char* cutName, std::function<AnalysisCut*(const char*)> factory);
 
 std::vector<AnalysisCut*> GetCutsFromJSON(const char* json);
 // AnalysisCut** GetCutsFromJSON(const char* json);
@@ -11,10 +11,13 @@
 
 #include "PWGDQ/Core/HistogramManager.h"
 
+#include <cstdio>
 #include <iostream>
 #include <memory>
 #include <fstream>
 #include <list>
+#include <string>
+#include <utility>
 #include <vector>
 #include <algorithm>
 #include "Framework/Logger.h"
@@ -187,6 +190,7 @@ void HistogramManager::AddHistogram(const char* histClass, const char* hname, co
   std::list varList = fVariablesMap[histClass];
   varList.push_back(varVector);
   fVariablesMap[histClass] = varList;
+  fFillPlansStale = true;
 
   // create and configure histograms according to required options
   TH1* h = nullptr;
@@ -397,6 +401,7 @@ void HistogramManager::AddHistogram(const char* histClass, const char* hname, co
   std::list varList = fVariablesMap[histClass];
   varList.push_back(varVector);
   fVariablesMap[histClass] = varList;
+  fFillPlansStale = true;
 
   TH1* h = nullptr;
   switch (dimension) {
@@ -582,6 +587,7 @@ void HistogramManager::AddHistogram(const char* histClass, const char* hname, co
   std::list varList = fVariablesMap[histClass];
   varList.push_back(varVector);
   fVariablesMap[histClass] = varList;
+  fFillPlansStale = true;
 
   uint32_t nbins = 1;
   THnBase* h = nullptr;
@@ -675,6 +681,7 @@ void HistogramManager::AddHistogram(const char* histClass, const char* hname, co
   std::list varList = fVariablesMap[histClass];
   varList.push_back(varVector);
   fVariablesMap[histClass] = varList;
+  fFillPlansStale = true;
 
   // get the min and max for each axis
   auto* xmin = new double[nDimensions];
@@ -741,156 +748,162 @@ void HistogramManager::AddHistogram(const char* histClass, const char* hname, co
 }
 
 //__________________________________________________________________
-void HistogramManager::FillHistClass(const char* className, Float_t* values)
+int HistogramManager::GetFillPlan(const char* className)
 {
   //
-  //  fill a class of histograms
+  // get the handle of the fill plan of a histogram class, compiling it if needed
   //
+  auto it = fFillPlanHandles.find(className);
+  if (it != fFillPlanHandles.end()) {
+    return it->second;
+  }
+  if (!fMainList->FindObject(className)) {
+    return kNothing;
+  }
+  FillPlan plan;
+  plan.fClassName = className;
+  CompileFillPlan(plan);
+  fFillPlans.push_back(std::move(plan));
+  int handle = fFillPlans.size() - 1;
+  fFillPlanHandles[className] = handle;
+  return handle;
+}
 
-  // get the needed histogram list
-  auto* hList = reinterpret_cast<TList*>(fMainList->FindObject(className));
+//_________________________________________________________________
+void HistogramManager::CompileFillPlan(FillPlan& plan)
+{
+  //
+  // decode once the histogram types and variable indices of a histogram class into flat fill records
+  //
+  plan.fRecords.clear();
+  plan.fVars.clear();
+  auto* hList = reinterpret_cast<TList*>(fMainList->FindObject(plan.fClassName.c_str()));
   if (!hList) {
-    // TODO: add some meaningfull error message
-    /*LOG(warn) << "HistogramManager::FillHistClass(): Histogram list " << className << " not found!";
-    LOG(warn) << "         Histogram list not filled" << endl; */
     return;
   }
-
-  // get the corresponding std::list containng identifiers to the needed variables to be filled
-  list varList = fVariablesMap[className];
+  const auto& varList = fVariablesMap[plan.fClassName];
 
   TIter next(hList);
-
-  TObject* h = nullptr;
-  bool isProfile;
-  bool isTHn;
-  int dimension = 0;
-  bool isSparse = kFALSE;
-  bool isFillLabelx = kFALSE;
-  // TODO: At the moment, maximum 20 dimensions are foreseen for the THn histograms. We should make this more dynamic
-  //       But maybe its better to have it like to avoid dynamically allocating this array in the histogram loop
-  double fillValues[20] = {0.0};
-  int varX = -1, varY = -1, varZ = -1, varT = -1, varW = -1;
-
-  // loop over the histogram and std::list
-  // NOTE: these two should contain the same number of elements and be synchronized, otherwise its a mess
-  for (auto varIter = varList.begin(); varIter != varList.end(); varIter++) {
-    h = next(); // get the histogram
-    // decode information from the vector of indices
-    isProfile = (varIter->at(0) == 1 ? true : false);
-    isTHn = (varIter->at(1) > 0 ? true : false);
-    if (isTHn) {
-      dimension = varIter->at(1);
-    } else {
-      dimension = (reinterpret_cast<TH1*>(h))->GetDimension();
+  // NOTE: the histogram list and the std::list of variables contain the same number of elements and are synchronized
+  for (const auto& vars : varList) {
+    TObject* h = next();
+    FillRecord record{h, kFillTH1, vars.at(2), static_cast<int>(plan.fVars.size()), 0};
+    bool isProfile = (vars.at(0) == 1);
+    if (vars.at(1) > 0) {
+      record.fKind = kFillTHn;
+      record.fNVars = vars.at(1);
+      for (int i = 0; i < record.fNVars; i++) {
+        plan.fVars.push_back(vars.at(3 + i));
+      }
+      plan.fRecords.push_back(record);
+      continue;
     }
-
-    // get the various variable indices
-    varW = varIter->at(2);
-    if (isTHn) {
-      for (int i = 0; i < dimension; i++) {
-        fillValues[i] = values[varIter->at(3 + i)];
-      }
-    } else {
-      varX = varIter->at(3);
-      varY = varIter->at(4);
-      varZ = varIter->at(5);
-      varT = varIter->at(6);
-      isFillLabelx = (varIter->at(7) == 1 ? true : false);
+    bool isFillLabelx = (vars.at(7) == 1);
+    int dimension = (reinterpret_cast<TH1*>(h))->GetDimension();
+    switch (dimension) {
+      case 1:
+        record.fKind = isProfile ? (isFillLabelx ? kFillTProfileLabel : kFillTProfile) : (isFillLabelx ? kFillTH1Label : kFillTH1);
+        record.fNVars = isProfile ? 2 : 1;
+        break;
+      case 2:
+        record.fKind = isProfile ? kFillTProfile2D : (isFillLabelx ? kFillTH2Label : kFillTH2);
+        record.fNVars = isProfile ? 3 : 2;
+        break;
+      case 3:
+        record.fKind = isProfile ? kFillTProfile3D : kFillTH3;
+        record.fNVars = isProfile ? 4 : 3;
+        break;
+      default:
+        continue;
+    }
+    for (int i = 0; i < record.fNVars; i++) {
+      plan.fVars.push_back(vars.at(3 + i));
     }
+    plan.fRecords.push_back(record);
+  }
+}
 
-    if (!isTHn) {
-      switch (dimension) {
-        case 1:
-          if (isProfile) {
-            if (varW > kNothing) {
-              if (isFillLabelx) {
-                (reinterpret_cast<TProfile*>(h))->Fill(Form("%d", static_cast<int>(values[varX])), values[varY], values[varW]);
-              } else {
-                (reinterpret_cast<TProfile*>(h))->Fill(values[varX], values[varY], values[varW]);
-              }
-            } else {
-              if (isFillLabelx) {
-                (reinterpret_cast<TProfile*>(h))->Fill(Form("%d", static_cast<int>(values[varX])), values[varY]);
-              } else {
-                (reinterpret_cast<TProfile*>(h))->Fill(values[varX], values[varY]);
-              }
-            }
-          } else {
-            if (varW > kNothing) {
-              if (isFillLabelx) {
-                (reinterpret_cast<TH1*>(h))->Fill(Form("%d", static_cast<int>(values[varX])), values[varW]);
-              } else {
-                (reinterpret_cast<TH1*>(h))->Fill(values[varX], values[varW]);
-              }
-            } else {
-              if (isFillLabelx) {
-                (reinterpret_cast<TH1*>(h))->Fill(Form("%d", static_cast<int>(values[varX])), 1.);
-              } else {
-                (reinterpret_cast<TH1*>(h))->Fill(values[varX]);
-              }
-            }
-          }
-          break;
-        case 2:
-          if (isProfile) {
-            if (varW > kNothing) {
-              (reinterpret_cast<TProfile2D*>(h))->Fill(values[varX], values[varY], values[varZ], values[varW]);
-            } else {
-              (reinterpret_cast<TProfile2D*>(h))->Fill(values[varX], values[varY], values[varZ]);
-            }
-          } else {
-            if (varW > kNothing) {
-              if (isFillLabelx) {
-                (reinterpret_cast<TH2*>(h))->Fill(Form("%d", static_cast<int>(values[varX])), values[varY], values[varW]);
-              } else {
-                (reinterpret_cast<TH2*>(h))->Fill(values[varX], values[varY], values[varW]);
-              }
-            } else {
-              if (isFillLabelx) {
-                (reinterpret_cast<TH2*>(h))->Fill(Form("%d", static_cast<int>(values[varX])), values[varY], 1.);
-              } else {
-                (reinterpret_cast<TH2*>(h))->Fill(values[varX], values[varY]);
-              }
-            }
-          }
-          break;
-        case 3:
-          if (isProfile) {
-            if (varW > kNothing) {
-              (reinterpret_cast<TProfile3D*>(h))->Fill(values[varX], values[varY], values[varZ], values[varT], values[varW]);
-            } else {
-              (reinterpret_cast<TProfile3D*>(h))->Fill(values[varX], values[varY], values[varZ], values[varT]);
-            }
-          } else {
-            if (varW > kNothing) {
-              (reinterpret_cast<TH3*>(h))->Fill(values[varX], values[varY], values[varZ], values[varW]);
-            } else {
-              (reinterpret_cast<TH3*>(h))->Fill(values[varX], values[varY], values[varZ]);
-            }
-          }
-          break;
+//_________________________________________________________________
+void HistogramManager::FillHistClass(int planHandle, Float_t* values)
+{
+  //
+  //  fill a class of histograms using its compiled fill plan
+  //
+  if (planHandle < 0 || planHandle >= static_cast<int>(fFillPlans.size())) {
+    return;
+  }
+  if (fFillPlansStale) {
+    for (auto& plan : fFillPlans) {
+      CompileFillPlan(plan);
+    }
+    fFillPlansStale = false;
+  }
 
-        default:
-          break;
-      } // end switch
-      // end if(!isTHn)
-    } else {
-      if (varW > kNothing) {
-        if (isSparse) {
-          (reinterpret_cast<THnSparse*>(h))->Fill(fillValues, values[varW]);
-        } else {
-          (reinterpret_cast<THn*>(h))->Fill(fillValues, values[varW]);
-        }
-      } else {
-        if (isSparse) {
-          (reinterpret_cast<THnSparse*>(h))->Fill(fillValues);
-        } else {
-          (reinterpret_cast<THn*>(h))->Fill(fillValues);
+  const FillPlan& plan = fFillPlans[planHandle];
+  // TODO: At the moment, maximum 20 dimensions are foreseen for the THn histograms, as in the name-based filling
+  double fillValues[20] = {0.0};
+  char label[32];
+  for (const auto& record : plan.fRecords) {
+    const int* v = plan.fVars.data() + record.fFirstVar;
+    const double w = (record.fVarW > kNothing) ? values[record.fVarW] : 1.;
+    switch (record.fKind) {
+      case kFillTH1:
+        (reinterpret_cast<TH1*>(record.fHist))->Fill(values[v[0]], w);
+        break;
+      case kFillTH1Label:
+        snprintf(label, sizeof(label), "%d", static_cast<int>(values[v[0]]));
+        (reinterpret_cast<TH1*>(record.fHist))->Fill(label, w);
+        break;
+      case kFillTProfile:
+        (reinterpret_cast<TProfile*>(record.fHist))->Fill(values[v[0]], values[v[1]], w);
+        break;
+      case kFillTProfileLabel:
+        snprintf(label, sizeof(label), "%d", static_cast<int>(values[v[0]]));
+        (reinterpret_cast<TProfile*>(record.fHist))->Fill(label, values[v[1]], w);
+        break;
+      case kFillTH2:
+        (reinterpret_cast<TH2*>(record.fHist))->Fill(values[v[0]], values[v[1]], w);
+        break;
+      case kFillTH2Label:
+        snprintf(label, sizeof(label), "%d", static_cast<int>(values[v[0]]));
+        (reinterpret_cast<TH2*>(record.fHist))->Fill(label, values[v[1]], w);
+        break;
+      case kFillTProfile2D:
+        (reinterpret_cast<TProfile2D*>(record.fHist))->Fill(values[v[0]], values[v[1]], values[v[2]], w);
+        break;
+      case kFillTH3:
+        (reinterpret_cast<TH3*>(record.fHist))->Fill(values[v[0]], values[v[1]], values[v[2]], w);
+        break;
+      case kFillTProfile3D:
+        (reinterpret_cast<TProfile3D*>(record.fHist))->Fill(values[v[0]], values[v[1]], values[v[2]], values[v[3]], w);
+        break;
+      case kFillTHn:
+        for (int i = 0; i < record.fNVars; i++) {
+          fillValues[i] = values[v[i]];
         }
-      }
-    } // end else
-  } // end loop over histograms
+        (reinterpret_cast<THnBase*>(record.fHist))->Fill(fillValues, w);
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+//_________________________________________________________________
+void HistogramManager::FillHistClass(const char* className, Float_t* values)
+{
+  //
+  //  fill a class of histograms
+  //  the fill plan of the class is compiled at the first call and reused afterwards
+  //
+  int handle = GetFillPlan(className);
+  if (handle == kNothing) {
+    // TODO: add some meaningfull error message
+    /*LOG(warn) << "HistogramManager::FillHistClass(): Histogram list " << className << " not found!";
+    LOG(warn) << "         Histogram list not filled" << endl; */
+    return;
+  }
+  FillHistClass(handle, values);
 }
 
 //____________________________________________________________________________________
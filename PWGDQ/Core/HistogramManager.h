@@ -26,6 +26,7 @@
 
 #include <string>
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <list>
 
@@ -47,6 +48,7 @@ class HistogramManager : public TNamed
       delete fMainList;
     }
     fMainList = list;
+    fFillPlansStale = true;
   }
 
   // Create a new histogram class
@@ -85,6 +87,11 @@ class HistogramManager : public TNamed
                     TString* axLabels = nullptr, int varW = -1, bool useSparse = kFALSE, bool isdouble = false);
 
   void FillHistClass(const char* className, float* values);
+  // Resolve a histogram class into an integer handle, to be used with FillHistClass(int, float*)
+  // The corresponding fill plan is compiled once into a flat list of {histogram, fill kind, variables} records
+  // Returns kNothing if the histogram class does not exist
+  int GetFillPlan(const char* className);
+  void FillHistClass(int planHandle, float* values);
 
   void SetUseDefaultVariableNames(bool flag) { fUseDefaultVariableNames = flag; }
   void SetDefaultVarNames(TString* vars, TString* units);
@@ -102,6 +109,37 @@ class HistogramManager : public TNamed
   bool* fUsedVars;                                                  //! flags of used variables
   std::map<std::string, std::list<std::vector<int>>> fVariablesMap; //!  map holding identifiers for all variables needed by histograms
 
+  // compiled fill plans
+  enum FillKind {
+    kFillTH1 = 0,
+    kFillTH1Label,
+    kFillTProfile,
+    kFillTProfileLabel,
+    kFillTH2,
+    kFillTH2Label,
+    kFillTProfile2D,
+    kFillTH3,
+    kFillTProfile3D,
+    kFillTHn
+  };
+  struct FillRecord {
+    TObject* fHist;  // histogram to be filled
+    int fKind;       // one of FillKind
+    int fVarW;       // variable used for weighting, kNothing if none
+    int fFirstVar;   // index of the first variable in FillPlan::fVars
+    int fNVars;      // number of variables (axes, plus the profiled variable)
+  };
+  struct FillPlan {
+    std::string fClassName;
+    std::vector<FillRecord> fRecords;
+    std::vector<int> fVars;
+  };
+  std::vector<FillPlan> fFillPlans;                       //! compiled fill plans, indexed by handle
+  std::unordered_map<std::string, int> fFillPlanHandles; //! handles of the compiled fill plans, by histogram class
+  bool fFillPlansStale = false;                           //! histograms were added after the plans were compiled
+
+  void CompileFillPlan(FillPlan& plan);
+
   // various
   bool fUseDefaultVariableNames;    //! toggle the usage of default variable names and units
   uint64_t fBinsAllocated;          //! number of allocated bins
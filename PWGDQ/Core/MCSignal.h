@@ -357,4 +357,61 @@ bool MCSignal::CheckProng(int i, bool checkSources, const T& track)
   return true;
 }
 
+//_______________________________________________________________________________________________
+// Per-DF cache of the decisions of a list of MC signals for single MC particles.
+// All the single-prong signals of the list are evaluated together the first time an MC particle is looked up,
+// and the decisions are then read back from a bit map, e.g. for tracks associated to several collisions
+// or MC particles checked in several loops. Signals with more than one prong are never matched by a single particle.
+// Reset() has to be called at the beginning of each DF.
+class MCSignalDecisionCache
+{
+ public:
+  void SetSignals(const std::vector<MCSignal*>& signals, bool checkSources = true)
+  {
+    fSignals = signals;
+    fCheckSources = checkSources;
+    fNWords = (signals.size() + 63) / 64;
+    Reset();
+  }
+  void Reset()
+  {
+    fDecisions.clear();
+    fEvaluated.clear();
+  }
+
+  template <typename T>
+  bool IsMatched(const T& mcParticle, int iSignal)
+  {
+    const uint64_t* decisions = GetDecisions(mcParticle);
+    return decisions[iSignal / 64] & (static_cast<uint64_t>(1) << (iSignal % 64));
+  }
+
+ private:
+  std::vector<MCSignal*> fSignals;  // list of signals, in the order of the bits
+  bool fCheckSources = true;        // check the sources of the signals
+  size_t fNWords = 0;               // number of 64-bit words per MC particle
+  std::vector<uint64_t> fDecisions; // decisions of the signals, fNWords words per MC particle
+  std::vector<bool> fEvaluated;     // whether the signals were evaluated for the MC particle
+
+  template <typename T>
+  const uint64_t* GetDecisions(const T& mcParticle)
+  {
+    const size_t index = mcParticle.globalIndex();
+    if (index >= fEvaluated.size()) {
+      fEvaluated.resize(index + 1, false);
+      fDecisions.resize((index + 1) * fNWords, 0);
+    }
+    uint64_t* decisions = fDecisions.data() + index * fNWords;
+    if (!fEvaluated[index]) {
+      for (size_t isig = 0; isig < fSignals.size(); isig++) {
+        if (fSignals[isig]->GetNProngs() == 1 && fSignals[isig]->CheckSignal(fCheckSources, mcParticle)) {
+          decisions[isig / 64] |= (static_cast<uint64_t>(1) << (isig % 64));
+        }
+      }
+      fEvaluated[index] = true;
+    }
+    return decisions;
+  }
+};
+
 #endif // PWGDQ_CORE_MCSIGNAL_H_
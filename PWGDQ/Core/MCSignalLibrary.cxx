@@ -11,7 +11,11 @@
 //
 // Contact: iarsene@cern.ch, i.c.arsene@fys.uio.no
 //
+#include <functional>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 // #include <iostream>
 
@@ -24,7 +28,49 @@ using namespace o2::constants::physics;
 // using std::cout;
 // using std::endl;
 
+namespace
+{
+// factories registered at run time and signals already built by the library, looked up by name
+std::unordered_map<std::string, std::function<MCSignal*(const char*)>>& signalFactories()
+{
+  static std::unordered_map<std::string, std::function<MCSignal*(const char*)>> factories;
+  return factories;
+}
+
+std::unordered_map<std::string, std::unique_ptr<MCSignal>>& builtSignals()
+{
+  static std::unordered_map<std::string, std::unique_ptr<MCSignal>> signals;
+  return signals;
+}
+} // namespace
+
+void o2::aod::dqmcsignals::RegisterMCSignal(const char* name, std::function<MCSignal*(const char*)> factory)
+{
+  signalFactories()[name] = std::move(factory);
+}
+
 MCSignal* o2::aod::dqmcsignals::GetMCSignal(const char* name)
+{
+  //
+  // look up the signal among the registered factories and the signals already built; build it from the library only at the first request
+  //
+  std::string nameStr = name;
+  if (auto factory = signalFactories().find(nameStr); factory != signalFactories().end()) {
+    return factory->second(name);
+  }
+  auto& signals = builtSignals();
+  auto signal = signals.find(nameStr);
+  if (signal == signals.end()) {
+    std::unique_ptr<MCSignal> newSignal(BuildMCSignal(name));
+    if (!newSignal) {
+      return nullptr;
+    }
+    signal = signals.emplace(nameStr, std::move(newSignal)).first;
+  }
+  return new MCSignal(*(signal->second));
+}
+
+MCSignal* o2::aod::dqmcsignals::BuildMCSignal(const char* name)
 {
   std::string nameStr = name;
   MCSignal* signal;
@@ -15,6 +15,7 @@
 #ifndef PWGDQ_CORE_MCSIGNALLIBRARY_H_
 #define PWGDQ_CORE_MCSIGNALLIBRARY_H_
 
+#include <functional>
 #include <string>
 #include "rapidjson/document.h"
 #include "PWGDQ/Core/MCProng.h"
@@ -24,7 +25,11 @@ namespace o2::aod
 {
 namespace dqmcsignals
 {
+// The signals are looked up first among the registered factories, then among the signals already built in this process
+// (a copy of which is returned), and are built from the library only at their first request; nullptr if not defined
 MCSignal* GetMCSignal(const char* signalName);
+MCSignal* BuildMCSignal(const char* signalName);
+void RegisterMCSignal(const char* signalName, std::function<MCSignal*(const char*)> factory);
 
 std::vector<MCSignal*> GetMCSignalsFromJSON(const char* json);
 
@@ -26,7 +26,11 @@ ClassImp(MixingHandler);
 MixingHandler::MixingHandler() : TNamed(),
                                  fIsInitialized(kFALSE),
                                  fVariableLimits(),
-                                 fVariables()
+                                 fVariables(),
+                                 fNCategories(0),
+                                 fStrides(),
+                                 fIsUniform(),
+                                 fInverseWidths()
 {
   //
   // default constructor
@@ -37,7 +41,11 @@ MixingHandler::MixingHandler() : TNamed(),
 MixingHandler::MixingHandler(const char* name, const char* title) : TNamed(name, title),
                                                                     fIsInitialized(kFALSE),
                                                                     fVariableLimits(),
-                                                                    fVariables()
+                                                                    fVariables(),
+                                                                    fNCategories(0),
+                                                                    fStrides(),
+                                                                    fIsUniform(),
+                                                                    fInverseWidths()
 {
   //
   // Named constructor
@@ -63,6 +71,7 @@ void MixingHandler::AddMixingVariable(int var, int nBins, float* binLims)
   varBins.Set(nBins, binLims);
   fVariableLimits.push_back(varBins);
   VarManager::SetUseVariable(var);
+  fIsInitialized = kFALSE; // the lookup tables need to be recomputed
 }
 
 //_________________________________________________________________________
@@ -110,15 +119,59 @@ void MixingHandler::Init()
   //
   // Initialization of pools
   //       The correct event category will be retrieved using the function FindEventCategory()
+  //       The category strides and the uniform-binning lookups are computed here once
   //
-  int size = 1;
-  for (auto v : fVariableLimits) {
-    size *= (v.GetSize() - 1);
+  int nVars = fVariables.size();
+  fStrides.assign(nVars, 1);
+  fIsUniform.assign(nVars, false);
+  fInverseWidths.assign(nVars, 0.0);
+  fNCategories = nVars > 0 ? 1 : 0;
+  for (int iVar = nVars - 1; iVar >= 0; --iVar) {
+    fStrides[iVar] = fNCategories;
+    const TArrayF& limits = fVariableLimits[iVar];
+    int nBins = limits.GetSize() - 1;
+    fNCategories *= (nBins > 0 ? nBins : 0);
+    if (nBins < 1) {
+      continue;
+    }
+    float width = (limits.At(nBins) - limits.At(0)) / nBins;
+    bool isUniform = width > 0;
+    for (int iBin = 0; iBin < nBins && isUniform; ++iBin) {
+      isUniform = TMath::Abs(limits.At(iBin + 1) - limits.At(iBin) - width) <= 1.0e-5 * width;
+    }
+    fIsUniform[iVar] = isUniform;
+    fInverseWidths[iVar] = isUniform ? 1.0 / width : 0.0;
   }
-  (void)size;
   fIsInitialized = kTRUE;
 }
 
+//_________________________________________________________________________
+int MixingHandler::FindBin(int iVar, float value) const
+{
+  //
+  // Bin of value in the limits of the variable iVar, -1 if outside the limits
+  //   Same result as TMath::BinarySearch(), with the values on the last limit also considered outside.
+  //   For uniform binnings the bin is computed from the width and only corrected at the bin edges for rounding
+  //
+  const TArrayF& limits = fVariableLimits[iVar];
+  int nBins = limits.GetSize() - 1;
+  if (nBins < 1 || !(value >= limits.At(0)) || value >= limits.At(nBins)) {
+    return -1;
+  }
+  if (!fIsUniform[iVar]) {
+    return TMath::BinarySearch(limits.GetSize(), limits.GetArray(), value);
+  }
+  int bin = static_cast<int>((value - limits.At(0)) * fInverseWidths[iVar]);
+  bin = TMath::Min(TMath::Max(bin, 0), nBins - 1);
+  while (bin > 0 && value < limits.At(bin)) {
+    --bin;
+  }
+  while (bin < nBins - 1 && value >= limits.At(bin + 1)) {
+    ++bin;
+  }
+  return bin;
+}
+
 //_________________________________________________________________________
 int MixingHandler::FindEventCategory(float* values)
 {
@@ -128,37 +181,47 @@ int MixingHandler::FindEventCategory(float* values)
   if (fVariables.size() == 0) {
     return -1;
   }
-  if (!fIsInitialized) {
+  if (!fIsInitialized || fStrides.size() != fVariables.size()) {
     Init();
   }
 
-  std::vector<int> bin;
-  int iVar = 0;
-  for (auto v = fVariableLimits.begin(); v != fVariableLimits.end(); v++, iVar++) {
-    int binValue = TMath::BinarySearch((*v).GetSize(), (*v).GetArray(), values[fVariables[iVar]]);
-    bin.push_back(binValue);
-    if (bin[iVar] == -1 || bin[iVar] == (*v).GetSize() - 1) {
+  int category = 0;
+  for (int iVar = 0; iVar < static_cast<int>(fVariables.size()); ++iVar) {
+    int bin = FindBin(iVar, values[fVariables[iVar]]);
+    if (bin < 0) {
       return -1; // all variables must be inside limits
     }
+    category += bin * fStrides[iVar];
   }
+  return category;
+}
 
-  int category = 0;
-  int tempCategory = 1;
-  int iv1 = 0;
-  int iv2 = 0;
-  for (auto v1 = fVariables.begin(); v1 != fVariables.end(); v1++, iv1++) {
-    tempCategory = 1;
-    iv2 = iv1;
-    for (auto v2 = v1; v2 != fVariables.end(); v2++, iv2++) {
-      if (iv2 == iv1) {
-        tempCategory *= bin[iv2];
-      } else {
-        tempCategory *= (fVariableLimits[iv2].GetSize() - 1);
+//_________________________________________________________________________
+void MixingHandler::FindEventCategories(const std::vector<std::vector<float>>& values, std::vector<int>& categories)
+{
+  //
+  // Find the event categories of a set of events, variable by variable
+  //   values[iVar][iEvent] is the value of the iVar-th mixing variable of the event iEvent
+  //
+  categories.clear();
+  if (fVariables.size() == 0 || values.size() != fVariables.size()) {
+    return;
+  }
+  if (!fIsInitialized || fStrides.size() != fVariables.size()) {
+    Init();
+  }
+
+  int nEvents = values[0].size();
+  categories.assign(nEvents, 0);
+  for (int iVar = 0; iVar < static_cast<int>(fVariables.size()); ++iVar) {
+    for (int iEvent = 0; iEvent < nEvents; ++iEvent) {
+      if (categories[iEvent] < 0) {
+        continue;
       }
+      int bin = FindBin(iVar, values[iVar][iEvent]);
+      categories[iEvent] = (bin < 0 ? -1 : categories[iEvent] + bin * fStrides[iVar]);
     }
-    category += tempCategory;
   }
-  return category;
 }
 
 //_________________________________________________________________________
@@ -24,6 +24,9 @@
 #include <TList.h>
 #include <TString.h>
 
+#include <span>
+#include <vector>
+
 #include "PWGDQ/Core/HistogramManager.h"
 #include "PWGDQ/Core/VarManager.h"
 
@@ -45,7 +48,10 @@ class MixingHandler : public TNamed
   std::vector<float> GetMixingVariableLimits(VarManager::Variables var);
 
   void Init();
+  int GetNCategories() const { return fNCategories; } // valid after Init()
   int FindEventCategory(float* values);
+  // categories of a set of events; values[iVar][iEvent] is the value of the iVar-th mixing variable (in the order they were added)
+  void FindEventCategories(const std::vector<std::vector<float>>& values, std::vector<int>& categories);
   int GetBinFromCategory(VarManager::Variables var, int category) const;
 
  private:
@@ -58,7 +64,54 @@ class MixingHandler : public TNamed
   std::vector<TArrayF> fVariableLimits;
   std::vector<int> fVariables;
 
-  ClassDef(MixingHandler, 1);
+  // lookup tables filled in Init()
+  int fNCategories;                  //! number of categories
+  std::vector<int> fStrides;         //! category stride of each variable
+  std::vector<bool> fIsUniform;      //! whether the bins of the variable have equal widths
+  std::vector<float> fInverseWidths; //! 1 / bin width, for the uniform binnings
+
+  int FindBin(int iVar, float value) const;
+
+  ClassDef(MixingHandler, 2);
+};
+
+// Events of a dataframe grouped by mixing category, so that the events of one pool are iterated without
+// scanning the whole event table; event indices are kept in increasing order within each pool
+class MixingPools
+{
+ public:
+  // categories[i] is the category of the event i, negative for the events not used in the mixing
+  void Fill(const std::vector<int>& categories, int nCategories)
+  {
+    fStarts.assign(nCategories + 1, 0);
+    for (auto category : categories) {
+      if (category >= 0 && category < nCategories) {
+        fStarts[category + 1]++;
+      }
+    }
+    for (int i = 1; i <= nCategories; i++) {
+      fStarts[i] += fStarts[i - 1];
+    }
+    fEvents.resize(fStarts[nCategories]);
+    std::vector<int> next(fStarts.begin(), fStarts.end() - 1);
+    for (int iEvent = 0; iEvent < static_cast<int>(categories.size()); iEvent++) {
+      if (categories[iEvent] >= 0 && categories[iEvent] < nCategories) {
+        fEvents[next[categories[iEvent]]++] = iEvent;
+      }
+    }
+  }
+  int GetNCategories() const { return fStarts.empty() ? 0 : fStarts.size() - 1; }
+  std::span<const int> GetPool(int category) const
+  {
+    if (category < 0 || category >= GetNCategories()) {
+      return {};
+    }
+    return std::span<const int>(fEvents.data() + fStarts[category], fStarts[category + 1] - fStarts[category]);
+  }
+
+ private:
+  std::vector<int> fStarts; // events of category c in fEvents[fStarts[c], fStarts[c + 1])
+  std::vector<int> fEvents;
 };
 
 #endif
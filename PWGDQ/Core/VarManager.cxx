@@ -9,6 +9,7 @@
 // granted to it by virtue of its status as an Intergovernmental Organization
 // or submit itself to any jurisdiction.
 #include <cmath>
+#include <initializer_list>
 #include <iostream>
 #include <vector>
 #include <map>
@@ -26,7 +27,10 @@ TString VarManager::fgVariableUnits[VarManager::kNVars] = {""};
 std::map<TString, int> VarManager::fgVarNamesMap;
 bool VarManager::fgUsedVars[VarManager::kNVars] = {false};
 bool VarManager::fgUsedKF = false;
-float VarManager::fgMagField = 0.5;
+bool VarManager::fgSparseFilling = false;
+bool VarManager::fgUsedPairVertexing = true;
+bool VarManager::fgUsedPairFlow = true;
+bool VarManager::fgUsedPairFlowME = true;
 float VarManager::fgValues[VarManager::kNVars] = {0.0f};
 float VarManager::fgCenterOfMassEnergy = 13600;         // GeV
 float VarManager::fgMassofCollidingParticle = 9.382720; // GeV
@@ -37,12 +41,10 @@ int VarManager::fgITSROFBorderMarginLow = 0;
 int VarManager::fgITSROFBorderMarginHigh = 0;
 uint64_t VarManager::fgSOR = 0;
 uint64_t VarManager::fgEOR = 0;
-o2::vertexing::DCAFitterN<2> VarManager::fgFitterTwoProngBarrel;
-o2::vertexing::DCAFitterN<3> VarManager::fgFitterThreeProngBarrel;
-o2::vertexing::DCAFitterN<4> VarManager::fgFitterFourProngBarrel;
-o2::vertexing::FwdDCAFitterN<2> VarManager::fgFitterTwoProngFwd;
-o2::vertexing::FwdDCAFitterN<3> VarManager::fgFitterThreeProngFwd;
+VarManager::Context VarManager::fgDefaultContext;
+thread_local VarManager::Context* VarManager::fgContext = nullptr;
 o2::globaltracking::MatchGlobalFwd VarManager::mMatching;
+bool VarManager::fgUseMuonPropagationCache = false;
 std::map<VarManager::CalibObjects, TObject*> VarManager::fgCalibs;
 bool VarManager::fgRunTPCPostCalibration[4] = {false, false, false, false};
 
@@ -92,6 +94,39 @@ void VarManager::SetVariableDependencies()
   if (fgUsedVars[kTrackIsInsideTPCModule]) {
     fgUsedVars[kPhiTPCOuter] = true;
   }
+
+  // Groups of pair variables which are computed together; in sparse filling mode, a group is skipped if none of its variables is used
+  auto anyUsed = [](std::initializer_list<int> vars) {
+    for (auto var : vars) {
+      if (fgUsedVars[var]) {
+        return true;
+      }
+    }
+    return false;
+  };
+  if (!fgSparseFilling) {
+    fgUsedPairVertexing = true;
+    fgUsedPairFlow = true;
+    fgUsedPairFlowME = true;
+    return;
+  }
+  fgUsedPairVertexing = anyUsed({kUsedKF, kVertexingProcCode, kVertexingChi2PCA, kVertexingLxy, kVertexingLxyErr, kVertexingLxyz, kVertexingLxyzErr, kVertexingLz, kVertexingLzErr,
+                                 kVertexingTauxy, kVertexingTauxyErr, kVertexingTauz, kVertexingTauzErr, kVertexingPz, kVertexingSV, kVertexingLzProjected, kVertexingLxyProjected,
+                                 kVertexingLxyzProjected, kVertexingTauzProjected, kVertexingTauxyProjected, kVertexingTauxyProjectedPoleJPsiMass, kVertexingTauxyProjectedNs,
+                                 kVertexingTauxyzProjected, kVertexingLxyOverErr, kVertexingLzOverErr, kVertexingLxyzOverErr, kCosPointingAngle,
+                                 kKFMass, kKFMassGeoTop, kKFNContributorsPV, kKFChi2OverNDFGeo, kKFChi2OverNDFGeoTop, kKFCosPA, kKFTrack0DCAxyz, kKFTrack1DCAxyz, kKFTracksDCAxyzMax,
+                                 kKFDCAxyzBetweenProngs, kKFTrack0DCAxy, kKFTrack1DCAxy, kKFTracksDCAxyMax, kKFDCAxyBetweenProngs, kKFTrack0DeviationFromPV, kKFTrack1DeviationFromPV,
+                                 kKFTrack0DeviationxyFromPV, kKFTrack1DeviationxyFromPV, kKFJpsiDCAxyz, kKFJpsiDCAxy, kKFPairDeviationFromPV, kKFPairDeviationxyFromPV});
+  fgUsedPairFlow = anyUsed({kU2Q2, kU3Q3, kR2SP_AB, kR2SP_AC, kR2SP_BC, kR3SP, kCos2DeltaPhi, kCos3DeltaPhi, kR2EP_AB, kR2EP_AC, kR2EP_BC, kR3EP,
+                            kV2SP, kWV2SP, kV2EP, kWV2EP, kCosPhiVP, kPhiVP,
+                            kM01POI, kM0111POI, kCORR2POI, kCORR4POI, kM01POIoverMp, kM0111POIoverMp, kM11REFoverMp, kM1111REFoverMp, kCORR2REFbydimuons, kCORR4REFbydimuons,
+                            kCORR2CORR4REF, kCORR2POICORR4POI, kCORR2REFCORR4POI, kCORR2REFCORR2POI, kM11M1111REFoverMp, kM01M0111overMp, kM11M0111overMp, kM11M01overMp,
+                            kM11REFoverMpplus, kM1111REFoverMpplus, kM11REFoverMpminus, kM1111REFoverMpminus, kM01POIplus, kM0111POIplus, kCORR2POIplus, kCORR4POIplus,
+                            kM01POIminus, kM0111POIminus, kCORR2POIminus, kCORR4POIminus, kM01POIoverMpminus, kM0111POIoverMpminus, kM01POIoverMpplus, kM0111POIoverMpplus});
+  fgUsedPairFlowME = anyUsed({kCos2DeltaPhi, kCos2DeltaPhiEv1, kCos2DeltaPhiEv2, kU2Q2, kU2Q2Ev1, kU2Q2Ev2, kCos2DeltaPhiMu1, kCos2DeltaPhiMu2,
+                              kV2SP1, kV2SP2, kV2EP1, kV2EP2, kV2ME_SP, kWV2ME_SP, kV2ME_EP, kWV2ME_EP, kV22ME, kWV22ME, kV24ME, kWV24ME,
+                              kM01POIME, kM0111POIME, kCORR2POIME, kCORR4POIME, kM01POIoverMpME, kM0111POIoverMpME, kM11REFoverMpME, kM1111REFoverMpME,
+                              kCORR2REFbydimuonsME, kCORR4REFbydimuonsME});
 }
 
 //__________________________________________________________________
@@ -101,7 +136,7 @@ void VarManager::ResetValues(int startValue, int endValue, float* values)
   // reset all variables to an "innocent" value
   // NOTE: here we use -9999.0 as a neutral value, but depending on situation, this may not be the case
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
   }
   for (Int_t i = startValue; i < endValue; ++i) {
     values[i] = -9999.;
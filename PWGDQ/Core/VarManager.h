@@ -26,6 +26,8 @@
 
 #include <vector>
 #include <map>
+#include <unordered_map>
+#include <limits>
 #include <cmath>
 #include <iostream>
 #include <utility>
@@ -913,6 +915,19 @@ class VarManager : public TObject
     for (auto& var : usedVars) {
       fgUsedVars[var] = true;
     }
+    SetVariableDependencies();
+  }
+  // In sparse filling mode, groups of pair variables (DCAFitter/KF vertexing, dilepton flow) are not computed if none
+  // of their variables is set as used. Only the used variables are then guaranteed to be filled, so all the variables
+  // which are read directly from the values array (e.g. to fill output tables) must be set as used as well.
+  static void SetSparseFilling(bool sparse)
+  {
+    fgSparseFilling = sparse;
+    SetVariableDependencies();
+  }
+  static bool GetSparseFilling()
+  {
+    return fgSparseFilling;
   }
   static bool GetUsedVar(int var)
   {
@@ -927,7 +942,7 @@ class VarManager : public TObject
 
   static void SetMagneticField(float magField)
   {
-    fgMagField = magField;
+    fgDefaultContext.magField = magField;
   }
 
   // Setup the 2 prong KFParticle
@@ -942,45 +957,58 @@ class VarManager : public TObject
     o2::mch::TrackExtrap::setField();
   }
 
+  // Cache of the muon propagations, keyed by (muon, collision, end point), to be reset at each DF
+  //   The key uses the global indices, so the cache must also be reset when switching to another muon table
+  static void SetUseMuonPropagationCache(bool useCache)
+  {
+    fgUseMuonPropagationCache = useCache;
+    ResetMuonPropagationCache();
+  }
+  static void ResetMuonPropagationCache()
+  {
+    CurrentContext().muonPropagationCache.clear();
+    CurrentContext().muonPropagationBz = std::numeric_limits<double>::quiet_NaN();
+  }
+
   // Setup the 2 prong DCAFitterN
   static void SetupTwoProngDCAFitter(float magField, bool propagateToPCA, float maxR, float maxDZIni, float minParamChange, float minRelChi2Change, bool useAbsDCA)
   {
-    fgFitterTwoProngBarrel.setBz(magField);
-    fgFitterTwoProngBarrel.setPropagateToPCA(propagateToPCA);
-    fgFitterTwoProngBarrel.setMaxR(maxR);
-    fgFitterTwoProngBarrel.setMaxDZIni(maxDZIni);
-    fgFitterTwoProngBarrel.setMinParamChange(minParamChange);
-    fgFitterTwoProngBarrel.setMinRelChi2Change(minRelChi2Change);
-    fgFitterTwoProngBarrel.setUseAbsDCA(useAbsDCA);
+    fgDefaultContext.fitterTwoProngBarrel.setBz(magField);
+    fgDefaultContext.fitterTwoProngBarrel.setPropagateToPCA(propagateToPCA);
+    fgDefaultContext.fitterTwoProngBarrel.setMaxR(maxR);
+    fgDefaultContext.fitterTwoProngBarrel.setMaxDZIni(maxDZIni);
+    fgDefaultContext.fitterTwoProngBarrel.setMinParamChange(minParamChange);
+    fgDefaultContext.fitterTwoProngBarrel.setMinRelChi2Change(minRelChi2Change);
+    fgDefaultContext.fitterTwoProngBarrel.setUseAbsDCA(useAbsDCA);
     fgUsedKF = false;
   }
 
   // Setup the 2 prong FwdDCAFitterN
   static void SetupTwoProngFwdDCAFitter(float magField, bool propagateToPCA, float maxR, float minParamChange, float minRelChi2Change, bool useAbsDCA)
   {
-    fgFitterTwoProngFwd.setBz(magField);
-    fgFitterTwoProngFwd.setPropagateToPCA(propagateToPCA);
-    fgFitterTwoProngFwd.setMaxR(maxR);
-    fgFitterTwoProngFwd.setMinParamChange(minParamChange);
-    fgFitterTwoProngFwd.setMinRelChi2Change(minRelChi2Change);
-    fgFitterTwoProngFwd.setUseAbsDCA(useAbsDCA);
+    fgDefaultContext.fitterTwoProngFwd.setBz(magField);
+    fgDefaultContext.fitterTwoProngFwd.setPropagateToPCA(propagateToPCA);
+    fgDefaultContext.fitterTwoProngFwd.setMaxR(maxR);
+    fgDefaultContext.fitterTwoProngFwd.setMinParamChange(minParamChange);
+    fgDefaultContext.fitterTwoProngFwd.setMinRelChi2Change(minRelChi2Change);
+    fgDefaultContext.fitterTwoProngFwd.setUseAbsDCA(useAbsDCA);
     fgUsedKF = false;
   }
   // Use MatLayerCylSet to correct MCS in fwdtrack propagation
   static void SetupMatLUTFwdDCAFitter(o2::base::MatLayerCylSet* m)
   {
-    fgFitterTwoProngFwd.setTGeoMat(false);
-    fgFitterTwoProngFwd.setMatLUT(m);
+    fgDefaultContext.fitterTwoProngFwd.setTGeoMat(false);
+    fgDefaultContext.fitterTwoProngFwd.setMatLUT(m);
   }
   // Use GeometryManager to correct MCS in fwdtrack propagation
   static void SetupTGeoFwdDCAFitter()
   {
-    fgFitterTwoProngFwd.setTGeoMat(true);
+    fgDefaultContext.fitterTwoProngFwd.setTGeoMat(true);
   }
   // No material budget in fwdtrack propagation
   static void SetupFwdDCAFitterNoCorr()
   {
-    fgFitterTwoProngFwd.setTGeoMat(false);
+    fgDefaultContext.fitterTwoProngFwd.setTGeoMat(false);
   }
   // Setup the 3 prong KFParticle
   static void SetupThreeProngKFParticle(float magField)
@@ -992,12 +1020,12 @@ class VarManager : public TObject
   // Setup the 3 prong DCAFitterN
   static void SetupThreeProngDCAFitter(float magField, bool propagateToPCA, float maxR, float /*maxDZIni*/, float minParamChange, float minRelChi2Change, bool useAbsDCA)
   {
-    fgFitterThreeProngBarrel.setBz(magField);
-    fgFitterThreeProngBarrel.setPropagateToPCA(propagateToPCA);
-    fgFitterThreeProngBarrel.setMaxR(maxR);
-    fgFitterThreeProngBarrel.setMinParamChange(minParamChange);
-    fgFitterThreeProngBarrel.setMinRelChi2Change(minRelChi2Change);
-    fgFitterThreeProngBarrel.setUseAbsDCA(useAbsDCA);
+    fgDefaultContext.fitterThreeProngBarrel.setBz(magField);
+    fgDefaultContext.fitterThreeProngBarrel.setPropagateToPCA(propagateToPCA);
+    fgDefaultContext.fitterThreeProngBarrel.setMaxR(maxR);
+    fgDefaultContext.fitterThreeProngBarrel.setMinParamChange(minParamChange);
+    fgDefaultContext.fitterThreeProngBarrel.setMinRelChi2Change(minRelChi2Change);
+    fgDefaultContext.fitterThreeProngBarrel.setUseAbsDCA(useAbsDCA);
     fgUsedKF = false;
   }
 
@@ -1011,12 +1039,12 @@ class VarManager : public TObject
   // Setup the 4 prong DCAFitterN
   static void SetupFourProngDCAFitter(float magField, bool propagateToPCA, float maxR, float /*maxDZIni*/, float minParamChange, float minRelChi2Change, bool useAbsDCA)
   {
-    fgFitterFourProngBarrel.setBz(magField);
-    fgFitterFourProngBarrel.setPropagateToPCA(propagateToPCA);
-    fgFitterFourProngBarrel.setMaxR(maxR);
-    fgFitterFourProngBarrel.setMinParamChange(minParamChange);
-    fgFitterFourProngBarrel.setMinRelChi2Change(minRelChi2Change);
-    fgFitterFourProngBarrel.setUseAbsDCA(useAbsDCA);
+    fgDefaultContext.fitterFourProngBarrel.setBz(magField);
+    fgDefaultContext.fitterFourProngBarrel.setPropagateToPCA(propagateToPCA);
+    fgDefaultContext.fitterFourProngBarrel.setMaxR(maxR);
+    fgDefaultContext.fitterFourProngBarrel.setMinParamChange(minParamChange);
+    fgDefaultContext.fitterFourProngBarrel.setMinRelChi2Change(minRelChi2Change);
+    fgDefaultContext.fitterFourProngBarrel.setUseAbsDCA(useAbsDCA);
     fgUsedKF = false;
   }
 
@@ -1179,12 +1207,59 @@ class VarManager : public TObject
   static float fgValues[kNVars]; // array holding all variables computed during analysis
   static void ResetValues(int startValue = 0, int endValue = kNVars, float* values = nullptr);
 
+  // Mutable state of the variable computation: values, magnetic field, vertexers and muon propagation cache.
+  //   The static API works on a default context (whose values are fgValues). A thread processing its own slice
+  //   binds a context of its own with a ContextScope, after copying the configuration of the default one with
+  //   InitContext(), so that the Fill functions called in that thread do not touch the shared state.
+  //   The used-variable flags, calibrations and collision system are configuration and stay shared: set them before the threads start.
+  struct Context {
+    float values[kNVars] = {0.0f};
+    float magField = 0.5;
+    o2::vertexing::DCAFitterN<2> fitterTwoProngBarrel;
+    o2::vertexing::DCAFitterN<3> fitterThreeProngBarrel;
+    o2::vertexing::DCAFitterN<4> fitterFourProngBarrel;
+    o2::vertexing::FwdDCAFitterN<2> fitterTwoProngFwd;
+    o2::vertexing::FwdDCAFitterN<3> fitterThreeProngFwd;
+    std::unordered_map<uint64_t, o2::dataformats::GlobalFwdTrack> muonPropagationCache;
+    double muonPropagationBz = std::numeric_limits<double>::quiet_NaN(); // field at the centre of the MFT, cached together with the propagations
+  };
+  // Binds a context to the current thread for the lifetime of the scope
+  class ContextScope
+  {
+   public:
+    explicit ContextScope(Context& context) : mPrevious(fgContext) { fgContext = &context; }
+    ~ContextScope() { fgContext = mPrevious; }
+    ContextScope(const ContextScope&) = delete;
+    ContextScope& operator=(const ContextScope&) = delete;
+
+   private:
+    Context* mPrevious;
+  };
+  // Copy the field and the vertexer settings of the default context, and reset the values and the muon cache
+  static void InitContext(Context& context)
+  {
+    std::fill_n(context.values, static_cast<int>(kNVars), 0.0f);
+    context.magField = fgDefaultContext.magField;
+    context.fitterTwoProngBarrel = fgDefaultContext.fitterTwoProngBarrel;
+    context.fitterThreeProngBarrel = fgDefaultContext.fitterThreeProngBarrel;
+    context.fitterFourProngBarrel = fgDefaultContext.fitterFourProngBarrel;
+    context.fitterTwoProngFwd = fgDefaultContext.fitterTwoProngFwd;
+    context.fitterThreeProngFwd = fgDefaultContext.fitterThreeProngFwd;
+    context.muonPropagationCache.clear();
+    context.muonPropagationBz = std::numeric_limits<double>::quiet_NaN();
+  }
+  static Context& CurrentContext() { return fgContext ? *fgContext : fgDefaultContext; }
+  static float* CurrentValues() { return fgContext ? fgContext->values : fgValues; }
+
  private:
   static bool fgUsedVars[kNVars]; // holds flags for when the corresponding variable is needed (e.g., in the histogram manager, in cuts, mixing handler, etc.)
   static bool fgUsedKF;
+  static bool fgSparseFilling;           // if true, the groups of pair variables below are computed only when at least one of their variables is used
+  static bool fgUsedPairVertexing;       // variables filled in FillPairVertexing()
+  static bool fgUsedPairFlow;            // variables filled in FillPairVn()
+  static bool fgUsedPairFlowME;          // flow variables filled in FillPairME()
   static void SetVariableDependencies(); // toggle those variables on which other used variables might depend
 
-  static float fgMagField;
   static float fgCenterOfMassEnergy;      // collision energy
   static float fgMassofCollidingParticle; // mass of the colliding particle
   static float fgTPCInterSectorBoundary;  // TPC inter-sector border size at the TPC outer radius, in cm
@@ -1209,12 +1284,10 @@ class VarManager : public TObject
   template <int pairType, typename T1, typename T2>
   static float calculatePhiV(const T1& t1, const T2& t2);
 
-  static o2::vertexing::DCAFitterN<2> fgFitterTwoProngBarrel;
-  static o2::vertexing::DCAFitterN<3> fgFitterThreeProngBarrel;
-  static o2::vertexing::DCAFitterN<4> fgFitterFourProngBarrel;
-  static o2::vertexing::FwdDCAFitterN<2> fgFitterTwoProngFwd;
-  static o2::vertexing::FwdDCAFitterN<3> fgFitterThreeProngFwd;
+  static Context fgDefaultContext;         // state used by the static API
+  static thread_local Context* fgContext; // context bound to the current thread, nullptr for the default one
   static o2::globaltracking::MatchGlobalFwd mMatching;
+  static bool fgUseMuonPropagationCache;
 
   static std::map<CalibObjects, TObject*> fgCalibs; // map of calibration histograms
   static bool fgRunTPCPostCalibration[4];           // 0-electron, 1-pion, 2-kaon, 3-proton
@@ -1313,6 +1386,19 @@ KFPVertex VarManager::createKFPVertexFromCollision(const T& collision)
 template <typename T, typename C>
 o2::dataformats::GlobalFwdTrack VarManager::PropagateMuon(const T& muon, const C& collision, const int endPoint)
 {
+  bool useCache = false;
+  uint64_t cacheKey = 0;
+  if constexpr (requires { muon.globalIndex(); collision.globalIndex(); }) {
+    if (fgUseMuonPropagationCache) {
+      useCache = true;
+      cacheKey = (static_cast<uint64_t>(muon.globalIndex()) << 32) | (static_cast<uint64_t>(collision.globalIndex() & 0x1FFFFFFF) << 3) | static_cast<uint64_t>(endPoint);
+      auto cached = CurrentContext().muonPropagationCache.find(cacheKey);
+      if (cached != CurrentContext().muonPropagationCache.end()) {
+        return cached->second;
+      }
+    }
+  }
+
   double chi2 = muon.chi2();
   SMatrix5 tpars(muon.x(), muon.y(), muon.phi(), muon.tgl(), muon.signed1Pt());
   std::vector<double> v1{muon.cXX(), muon.cXY(), muon.cYY(), muon.cPhiX(), muon.cPhiY(),
@@ -1344,9 +1430,15 @@ o2::dataformats::GlobalFwdTrack VarManager::PropagateMuon(const T& muon, const C
     propmuon.setCovariances(proptrack.getCovariances());
 
   } else if (static_cast<int>(muon.trackType()) < 2) {
-    double centerMFT[3] = {0, 0, -61.4};
-    o2::field::MagneticField* field = static_cast<o2::field::MagneticField*>(TGeoGlobalMagField::Instance()->GetField());
-    auto Bz = field->getBz(centerMFT); // Get field at centre of MFT
+    double Bz = CurrentContext().muonPropagationBz;
+    if (!useCache || std::isnan(Bz)) {
+      double centerMFT[3] = {0, 0, -61.4};
+      o2::field::MagneticField* field = static_cast<o2::field::MagneticField*>(TGeoGlobalMagField::Instance()->GetField());
+      Bz = field->getBz(centerMFT); // Get field at centre of MFT
+      if (useCache) {
+        CurrentContext().muonPropagationBz = Bz;
+      }
+    }
     auto geoMan = o2::base::GeometryManager::meanMaterialBudget(muon.x(), muon.y(), muon.z(), collision.posX(), collision.posY(), collision.posZ());
     auto x2x0 = static_cast<float>(geoMan.meanX2X0);
     fwdtrack.propagateToVtxhelixWithMCS(collision.posZ(), {collision.posX(), collision.posY()}, {collision.covXX(), collision.covYY()}, Bz, x2x0);
@@ -1354,6 +1446,9 @@ o2::dataformats::GlobalFwdTrack VarManager::PropagateMuon(const T& muon, const C
     propmuon.setZ(fwdtrack.getZ());
     propmuon.setCovariances(fwdtrack.getCovariances());
   }
+  if (useCache) {
+    CurrentContext().muonPropagationCache.emplace(cacheKey, propmuon);
+  }
   return propmuon;
 }
 
@@ -1361,7 +1456,7 @@ template <uint32_t fillMap, typename T, typename C>
 void VarManager::FillMuonPDca(const T& muon, const C& collision, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
   }
 
   if constexpr ((fillMap & MuonCov) > 0 || (fillMap & ReducedMuonCov) > 0) {
@@ -1380,7 +1475,7 @@ template <uint32_t fillMap, typename T, typename C>
 void VarManager::FillPropagateMuon(const T& muon, const C& collision, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
   }
 
   if constexpr ((fillMap & ReducedMuonCov) > 0) {
@@ -1436,7 +1531,7 @@ template <uint32_t fillMap, typename T1, typename T2, typename C>
 void VarManager::FillGlobalMuonRefit(T1 const& muontrack, T2 const& mfttrack, const C& collision, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
   }
   if constexpr ((fillMap & MuonCov) > 0 || (fillMap & ReducedMuonCov) > 0) {
     o2::dataformats::GlobalFwdTrack propmuon = PropagateMuon(muontrack, collision);
@@ -1459,7 +1554,7 @@ template <typename T>
 void VarManager::FillBC(T const& bc, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
   }
   values[kRunNo] = bc.runNumber();
   values[kBC] = bc.globalBC();
@@ -1472,7 +1567,7 @@ template <uint32_t fillMap, typename T>
 void VarManager::FillEvent(T const& event, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
   }
 
   if constexpr ((fillMap & CollisionTimestamp) > 0) {
@@ -1937,7 +2032,7 @@ void VarManager::FillEventTrackEstimators(TEvent const& collision, TAssoc const&
   // This is for studies of the pileup impact on the TPC
 
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
   }
 
   if constexpr ((fillMap & Track) > 0 && (fillMap & TrackDCA) > 0) {
@@ -1950,7 +2045,7 @@ void VarManager::FillEventTrackEstimators(TEvent const& collision, TAssoc const&
       // compute the dca of this track wrt the collision
       auto trackPar = getTrackPar(track);
       std::array<float, 2> dca{1e10f, 1e10f};
-      trackPar.propagateParamToDCA({collision.posX(), collision.posY(), collision.posZ()}, fgMagField, &dca);
+      trackPar.propagateParamToDCA({collision.posX(), collision.posY(), collision.posZ()}, CurrentContext().magField, &dca);
 
       // if it is a displaced track longitudinally, add it to the track vector
       if (abs(dca[0]) < 3.0 && abs(dca[1]) > 4.0) {
@@ -1984,7 +2079,7 @@ template <typename T>
 void VarManager::FillEventFlowResoFactor(T const& hs_sp, T const& hs_ep, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
   }
 
   if (values[kCentFT0C] >= 0.) {
@@ -2000,7 +2095,7 @@ template <typename T>
 void VarManager::FillTwoMixEventsFlowResoFactor(T const& hs_sp, T const& hs_ep, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
   }
 
   if (values[kTwoEvCentFT0C1] >= 0.) {
@@ -2024,7 +2119,7 @@ template <typename T, typename T1, typename T2>
 void VarManager::FillTwoMixEventsCumulants(T const& h_v22ev1, T const& h_v24ev1, T const& h_v22ev2, T const& h_v24ev2, T1 const& t1, T2 const& t2, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
   }
 
   int idx_v22ev1;
@@ -2070,7 +2165,7 @@ template <typename T>
 void VarManager::FillTwoEvents(T const& ev1, T const& ev2, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
   }
 
   values[kTwoEvPosZ1] = ev1.posZ();
@@ -2098,7 +2193,7 @@ template <uint32_t fillMap, typename T1, typename T2>
 void VarManager::FillTwoMixEvents(T1 const& ev1, T1 const& ev2, T2 const& /*tracks1*/, T2 const& /*tracks2*/, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
   }
   values[kTwoEvPosZ1] = ev1.posZ();
   values[kTwoEvPosZ2] = ev2.posZ();
@@ -2136,7 +2231,7 @@ template <uint32_t fillMap, typename T>
 void VarManager::FillTrack(T const& track, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
   }
 
   if constexpr ((fillMap & TrackMFT) > 0) {
@@ -2181,7 +2276,7 @@ void VarManager::FillTrack(T const& track, float* values)
     values[kPhi] = track.phi();
     values[kCharge] = track.sign();
     if (fgUsedVars[kPhiTPCOuter]) {
-      values[kPhiTPCOuter] = track.phi() - (track.sign() > 0 ? 1.0 : -1.0) * (TMath::PiOver2() - TMath::ACos(0.22 * fgMagField / track.pt()));
+      values[kPhiTPCOuter] = track.phi() - (track.sign() > 0 ? 1.0 : -1.0) * (TMath::PiOver2() - TMath::ACos(0.22 * CurrentContext().magField / track.pt()));
       if (values[kPhiTPCOuter] > TMath::TwoPi()) {
         values[kPhiTPCOuter] -= TMath::TwoPi();
       }
@@ -2192,7 +2287,7 @@ void VarManager::FillTrack(T const& track, float* values)
     if (fgUsedVars[kTrackIsInsideTPCModule]) {
       float localSectorPhi = values[kPhiTPCOuter] - TMath::Floor(18.0 * values[kPhiTPCOuter] / TMath::TwoPi()) * (TMath::TwoPi() / 18.0);
       float edge = fgTPCInterSectorBoundary / 2.0 / 246.6; // minimal inter-sector boundary as angle
-      float curvature = 3.0 * 3.33 * track.pt() / fgMagField * (1.0 - TMath::Sin(TMath::ACos(0.22 * fgMagField / track.pt())));
+      float curvature = 3.0 * 3.33 * track.pt() / CurrentContext().magField * (1.0 - TMath::Sin(TMath::ACos(0.22 * CurrentContext().magField / track.pt())));
       if (curvature / 2.466 > edge) {
         edge = curvature / 2.466;
       }
@@ -2609,12 +2704,12 @@ void VarManager::FillTrackCollision(T const& track, C const& collision, float* v
 {
 
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
   }
   if constexpr ((fillMap & ReducedTrackBarrel) > 0 || (fillMap & TrackDCA) > 0) {
     auto trackPar = getTrackPar(track);
     std::array<float, 2> dca{1e10f, 1e10f};
-    trackPar.propagateParamToDCA({collision.posX(), collision.posY(), collision.posZ()}, fgMagField, &dca);
+    trackPar.propagateParamToDCA({collision.posX(), collision.posY(), collision.posZ()}, CurrentContext().magField, &dca);
 
     values[kTrackDCAxy] = dca[0];
     values[kTrackDCAz] = dca[1];
@@ -2643,13 +2738,13 @@ template <uint32_t fillMap, typename T, typename C, typename M, typename P>
 void VarManager::FillTrackCollisionMatCorr(T const& track, C const& collision, M const& materialCorr, P const& propagator, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
   }
   if constexpr ((fillMap & ReducedTrackBarrel) > 0 || (fillMap & TrackDCA) > 0) {
     auto trackPar = getTrackPar(track);
     std::array<float, 2> dca{1e10f, 1e10f};
     std::array<float, 3> pVec = {track.px(), track.py(), track.pz()};
-    // trackPar.propagateParamToDCA({collision.posX(), collision.posY(), collision.posZ()}, fgMagField, &dca);
+    // trackPar.propagateParamToDCA({collision.posX(), collision.posY(), collision.posZ()}, CurrentContext().magField, &dca);
     propagator->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackPar, 2.f, materialCorr, &dca);
     getPxPyPz(trackPar, pVec);
 
@@ -2671,7 +2766,7 @@ template <uint32_t fillMap, typename T>
 void VarManager::FillPhoton(T const& track, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
   }
 
   // Quantities based on the basic table (contains just kine information and filter bits)
@@ -2703,7 +2798,7 @@ template <typename U, typename T>
 void VarManager::FillTrackMC(const U& mcStack, T const& track, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
   }
 
   // Quantities based on the mc particle table
@@ -2736,7 +2831,7 @@ template <uint32_t fillMap, typename T1, typename T2, typename C>
 void VarManager::FillPairPropagateMuon(T1 const& muon1, T2 const& muon2, const C& collision, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
   }
   o2::dataformats::GlobalFwdTrack propmuon1 = PropagateMuon(muon1, collision);
   o2::dataformats::GlobalFwdTrack propmuon2 = PropagateMuon(muon2, collision);
@@ -2761,7 +2856,7 @@ template <int pairType, uint32_t fillMap, typename T1, typename T2>
 void VarManager::FillPair(T1 const& t1, T2 const& t2, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
   }
 
   float m1 = o2::constants::physics::MassElectron;
@@ -2836,9 +2931,9 @@ void VarManager::FillPair(T1 const& t1, T2 const& t2, float* values)
   }
 
   if (fgUsedVars[kPsiPair]) {
-    values[kDeltaPhiPair] = (t1.sign() * fgMagField > 0.) ? (v1.Phi() - v2.Phi()) : (v2.Phi() - v1.Phi());
+    values[kDeltaPhiPair] = (t1.sign() * CurrentContext().magField > 0.) ? (v1.Phi() - v2.Phi()) : (v2.Phi() - v1.Phi());
     double xipair = TMath::ACos((v1.Px() * v2.Px() + v1.Py() * v2.Py() + v1.Pz() * v2.Pz()) / v1.P() / v2.P());
-    values[kPsiPair] = (t1.sign() * fgMagField > 0.) ? TMath::ASin((v1.Theta() - v2.Theta()) / xipair) : TMath::ASin((v2.Theta() - v1.Theta()) / xipair);
+    values[kPsiPair] = (t1.sign() * CurrentContext().magField > 0.) ? TMath::ASin((v1.Theta() - v2.Theta()) / xipair) : TMath::ASin((v2.Theta() - v1.Theta()) / xipair);
   }
 
   if (fgUsedVars[kOpeningAngle]) {
@@ -3034,7 +3129,7 @@ template <int pairType, uint32_t fillMap, typename C, typename T1, typename T2>
 void VarManager::FillPairCollision(const C& collision, T1 const& t1, T2 const& t2, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
   }
 
   if constexpr ((pairType == kDecayToEE) && ((fillMap & TrackCov) > 0 || (fillMap & ReducedTrackBarrelCov) > 0)) {
@@ -3043,11 +3138,11 @@ void VarManager::FillPairCollision(const C& collision, T1 const& t1, T2 const& t
 
       auto trackPart1 = getTrackPar(t1);
       std::array<float, 2> dca1{1e10f, 1e10f};
-      trackPart1.propagateParamToDCA({collision.posX(), collision.posY(), collision.posZ()}, fgMagField, &dca1);
+      trackPart1.propagateParamToDCA({collision.posX(), collision.posY(), collision.posZ()}, CurrentContext().magField, &dca1);
 
       auto trackPart2 = getTrackPar(t2);
       std::array<float, 2> dca2{1e10f, 1e10f};
-      trackPart2.propagateParamToDCA({collision.posX(), collision.posY(), collision.posZ()}, fgMagField, &dca2);
+      trackPart2.propagateParamToDCA({collision.posX(), collision.posY(), collision.posZ()}, CurrentContext().magField, &dca2);
 
       // Recalculated quantities
       double dca1XY = dca1[0];
@@ -3086,7 +3181,7 @@ template <int pairType, uint32_t fillMap, typename C, typename T1, typename T2,
 void VarManager::FillPairCollisionMatCorr(C const& collision, T1 const& t1, T2 const& t2, M const& materialCorr, P const& propagator, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
   }
 
   if constexpr ((pairType == kDecayToEE) && ((fillMap & TrackCov) > 0 || (fillMap & ReducedTrackBarrelCov) > 0)) {
@@ -3096,14 +3191,14 @@ void VarManager::FillPairCollisionMatCorr(C const& collision, T1 const& t1, T2 c
       auto trackPart1 = getTrackPar(t1);
       std::array<float, 2> dca1{1e10f, 1e10f};
       std::array<float, 3> pVect1 = {t1.px(), t1.py(), t1.pz()};
-      // trackPar.propagateParamToDCA({collision.posX(), collision.posY(), collision.posZ()}, fgMagField, &dca);
+      // trackPar.propagateParamToDCA({collision.posX(), collision.posY(), collision.posZ()}, CurrentContext().magField, &dca);
       propagator->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackPart1, 2.f, materialCorr, &dca1);
       getPxPyPz(trackPart1, pVect1);
 
       auto trackPart2 = getTrackPar(t2);
       std::array<float, 2> dca2{1e10f, 1e10f};
       std::array<float, 3> pVect2 = {t2.px(), t2.py(), t2.pz()};
-      // trackPar.propagateParamToDCA({collision.posX(), collision.posY(), collision.posZ()}, fgMagField, &dca);
+      // trackPar.propagateParamToDCA({collision.posX(), collision.posY(), collision.posZ()}, CurrentContext().magField, &dca);
       propagator->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackPart2, 2.f, materialCorr, &dca2);
       getPxPyPz(trackPart2, pVect2);
 
@@ -3145,7 +3240,7 @@ void VarManager::FillTriple(T1 const& t1, T2 const& t2, T3 const& t3, float* val
 {
 
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
   }
   if (pairType == kTripleCandidateToEEPhoton) {
     float m1 = o2::constants::physics::MassElectron;
@@ -3219,7 +3314,7 @@ void VarManager::FillPairME(T1 const& t1, T2 const& t2, float* values)
   // Lightweight fill function called from the innermost event mixing loop
   //
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
   }
 
   float m1 = o2::constants::physics::MassElectron;
@@ -3264,57 +3359,59 @@ void VarManager::FillPairME(T1 const& t1, T2 const& t2, float* values)
   }
 
   if constexpr ((fillMap & ReducedEventQvector) > 0 || (fillMap & CollisionQvect) > 0) {
-    // TODO: provide different computations for vn
-    // Compute the scalar product UQ for two muon from different event using Q-vector from A, for second and third harmonic
-    float Psi2A1 = getEventPlane(2, values[kQ2X0A1], values[kQ2Y0A1]);
-    float Psi2A2 = getEventPlane(2, values[kQ2X0A2], values[kQ2Y0A2]);
-    values[kCos2DeltaPhi] = TMath::Cos(2 * (v12.Phi() - Psi2A1)); // WARNING: using the first event EP
-    values[kCos2DeltaPhiEv1] = TMath::Cos(2 * (v1.Phi() - Psi2A1));
-    values[kCos2DeltaPhiEv2] = TMath::Cos(2 * (v2.Phi() - Psi2A2));
-    values[kU2Q2] = values[kQ2X0A1] * TMath::Cos(2 * v12.Phi()) + values[kQ2Y0A1] * TMath::Sin(2 * v12.Phi()); // WARNING: using the first event EP
-    values[kU2Q2Ev1] = values[kQ2X0A1] * TMath::Cos(2 * v1.Phi()) + values[kQ2Y0A1] * TMath::Sin(2 * v1.Phi());
-    values[kU2Q2Ev2] = values[kQ2X0A2] * TMath::Cos(2 * v2.Phi()) + values[kQ2Y0A2] * TMath::Sin(2 * v2.Phi());
-
-    values[kCos2DeltaPhiMu1] = TMath::Cos(2 * (v1.Phi() - v12.Phi()));
-    values[kCos2DeltaPhiMu2] = TMath::Cos(2 * (v2.Phi() - v12.Phi()));
-
-    values[kV2SP1] = values[kU2Q2Ev1] / values[kTwoR2SP1];
-    values[kV2SP2] = values[kU2Q2Ev2] / values[kTwoR2SP2];
-    values[kV2EP1] = values[kCos2DeltaPhiEv1] / values[kTwoR2EP1];
-    values[kV2EP2] = values[kCos2DeltaPhiEv2] / values[kTwoR2EP2];
-
-    float V2ME_SP = values[kV2SP1] * values[kCos2DeltaPhiMu1] + values[kV2SP2] * values[kCos2DeltaPhiMu2];
-    float V2ME_EP = values[kV2EP1] * values[kCos2DeltaPhiMu1] + values[kV2EP2] * values[kCos2DeltaPhiMu2];
-    values[kV2ME_SP] = std::isnan(V2ME_SP) || std::isinf(V2ME_SP) ? 0. : V2ME_SP;
-    values[kWV2ME_SP] = std::isnan(V2ME_SP) || std::isinf(V2ME_SP) ? 0. : 1.0;
-    values[kV2ME_EP] = std::isnan(V2ME_EP) || std::isinf(V2ME_EP) ? 0. : V2ME_EP;
-    values[kWV2ME_EP] = std::isnan(V2ME_EP) || std::isinf(V2ME_EP) ? 0. : 1.0;
-
-    // Cumulant part
-    float V22ME = values[kV22m] * values[kCos2DeltaPhiMu1] + values[kV22p] * values[kCos2DeltaPhiMu2];
-    float V24ME = values[kV24m] * values[kCos2DeltaPhiMu1] + values[kV24p] * values[kCos2DeltaPhiMu2];
-    values[kV22ME] = (std::isnan(V22ME) || std::isinf(V22ME) || std::isnan(V24ME) || std::isinf(V24ME)) ? 0. : V22ME;
-    values[kWV22ME] = (std::isnan(V22ME) || std::isinf(V22ME) || std::isnan(V24ME) || std::isinf(V24ME)) ? 0. : 1.0;
-    values[kV24ME] = (std::isnan(V22ME) || std::isinf(V22ME) || std::isnan(V24ME) || std::isinf(V24ME)) ? 0. : V24ME;
-    values[kWV24ME] = (std::isnan(V22ME) || std::isinf(V22ME) || std::isnan(V24ME) || std::isinf(V24ME)) ? 0. : 1.0;
-
-    if constexpr ((fillMap & ReducedEventQvectorExtra) > 0) {
-      complex<double> Q21(values[kQ2X0A] * values[kS11A], values[kQ2Y0A] * values[kS11A]);
-      complex<double> Q42(values[kQ42XA], values[kQ42YA]);
-      complex<double> Q23(values[kQ23XA], values[kQ23YA]);
-      complex<double> P2(TMath::Cos(2 * v12.Phi()), TMath::Sin(2 * v12.Phi()));
-      values[kM01POIME] = values[kMultDimuonsME] * values[kS11A];
-      values[kM0111POIME] = values[kMultDimuonsME] * (values[kS31A] - 3. * values[kS11A] * values[kS12A] + 2. * values[kS13A]);
-      values[kCORR2POIME] = (P2 * conj(Q21)).real() / values[kM01POIME];
-      values[kCORR4POIME] = (P2 * Q21 * conj(Q21) * conj(Q21) - P2 * Q21 * conj(Q42) - 2. * values[kS12A] * P2 * conj(Q21) + 2. * P2 * conj(Q23)).real() / values[kM0111POIME];
-      values[kM01POIoverMpME] = values[kMultDimuonsME] > 0 && !(std::isnan(values[kM01POIME]) || std::isinf(values[kM01POIME]) || std::isnan(values[kCORR2POIME]) || std::isinf(values[kCORR2POIME]) || std::isnan(values[kM0111POIME]) || std::isinf(values[kM0111POIME]) || std::isnan(values[kCORR4POIME]) || std::isinf(values[kCORR4POIME])) ? values[kM01POIME] / values[kMultDimuonsME] : 0;
-      values[kM0111POIoverMpME] = values[kMultDimuonsME] > 0 && !(std::isnan(values[kM0111POIME]) || std::isinf(values[kM0111POIME]) || std::isnan(values[kCORR4POIME]) || std::isinf(values[kCORR4POIME]) || std::isnan(values[kM01POIME]) || std::isinf(values[kM01POIME]) || std::isnan(values[kCORR2POIME]) || std::isinf(values[kCORR2POIME])) ? values[kM0111POIME] / values[kMultDimuonsME] : 0;
-      values[kM11REFoverMpME] = values[kMultDimuonsME] > 0 && !(std::isnan(values[kM11REF]) || std::isinf(values[kM11REF]) || std::isnan(values[kCORR2REF]) || std::isinf(values[kCORR2REF]) || std::isnan(values[kM1111REF]) || std::isinf(values[kM1111REF]) || std::isnan(values[kCORR4REF]) || std::isinf(values[kCORR4REF])) ? values[kM11REF] / values[kMultDimuonsME] : 0;
-      values[kM1111REFoverMpME] = values[kMultDimuonsME] > 0 && !(std::isnan(values[kM1111REF]) || std::isinf(values[kM1111REF]) || std::isnan(values[kCORR4REF]) || std::isinf(values[kCORR4REF]) || std::isnan(values[kM11REF]) || std::isinf(values[kM11REF]) || std::isnan(values[kCORR2REF]) || std::isinf(values[kCORR2REF])) ? values[kM1111REF] / values[kMultDimuonsME] : 0;
-      values[kCORR2REFbydimuonsME] = std::isnan(values[kM11REFoverMpME]) || std::isinf(values[kM11REFoverMpME]) || std::isnan(values[kCORR2REF]) || std::isinf(values[kCORR2REF]) || std::isnan(values[kM1111REFoverMpME]) || std::isinf(values[kM1111REFoverMpME]) || std::isnan(values[kCORR4REF]) || std::isinf(values[kCORR4REF]) ? 0 : values[kCORR2REF];
-      values[kCORR4REFbydimuonsME] = std::isnan(values[kM1111REFoverMpME]) || std::isinf(values[kM1111REFoverMpME]) || std::isnan(values[kCORR4REF]) || std::isinf(values[kCORR4REF]) || std::isnan(values[kM11REFoverMpME]) || std::isinf(values[kM11REFoverMpME]) || std::isnan(values[kCORR2REF]) || std::isinf(values[kCORR2REF]) ? 0 : values[kCORR4REF];
-      values[kCORR2POIME] = std::isnan(values[kCORR2POIME]) || std::isinf(values[kCORR2POIME]) || std::isnan(values[kM01POIME]) || std::isinf(values[kM01POIME]) || std::isnan(values[kCORR4POIME]) || std::isinf(values[kCORR4POIME]) || std::isnan(values[kM0111POIME]) || std::isinf(values[kM0111POIME]) ? 0 : values[kCORR2POIME];
-      values[kCORR4POIME] = std::isnan(values[kCORR4POIME]) || std::isinf(values[kCORR4POIME]) || std::isnan(values[kM0111POIME]) || std::isinf(values[kM0111POIME]) || std::isnan(values[kCORR2POIME]) || std::isinf(values[kCORR2POIME]) || std::isnan(values[kM01POIME]) || std::isinf(values[kM01POIME]) ? 0 : values[kCORR4POIME];
+    if (fgUsedPairFlowME) { // skipped in sparse filling mode if none of the flow variables is used
+      // TODO: provide different computations for vn
+      // Compute the scalar product UQ for two muon from different event using Q-vector from A, for second and third harmonic
+      float Psi2A1 = getEventPlane(2, values[kQ2X0A1], values[kQ2Y0A1]);
+      float Psi2A2 = getEventPlane(2, values[kQ2X0A2], values[kQ2Y0A2]);
+      values[kCos2DeltaPhi] = TMath::Cos(2 * (v12.Phi() - Psi2A1)); // WARNING: using the first event EP
+      values[kCos2DeltaPhiEv1] = TMath::Cos(2 * (v1.Phi() - Psi2A1));
+      values[kCos2DeltaPhiEv2] = TMath::Cos(2 * (v2.Phi() - Psi2A2));
+      values[kU2Q2] = values[kQ2X0A1] * TMath::Cos(2 * v12.Phi()) + values[kQ2Y0A1] * TMath::Sin(2 * v12.Phi()); // WARNING: using the first event EP
+      values[kU2Q2Ev1] = values[kQ2X0A1] * TMath::Cos(2 * v1.Phi()) + values[kQ2Y0A1] * TMath::Sin(2 * v1.Phi());
+      values[kU2Q2Ev2] = values[kQ2X0A2] * TMath::Cos(2 * v2.Phi()) + values[kQ2Y0A2] * TMath::Sin(2 * v2.Phi());
+
+      values[kCos2DeltaPhiMu1] = TMath::Cos(2 * (v1.Phi() - v12.Phi()));
+      values[kCos2DeltaPhiMu2] = TMath::Cos(2 * (v2.Phi() - v12.Phi()));
+
+      values[kV2SP1] = values[kU2Q2Ev1] / values[kTwoR2SP1];
+      values[kV2SP2] = values[kU2Q2Ev2] / values[kTwoR2SP2];
+      values[kV2EP1] = values[kCos2DeltaPhiEv1] / values[kTwoR2EP1];
+      values[kV2EP2] = values[kCos2DeltaPhiEv2] / values[kTwoR2EP2];
+
+      float V2ME_SP = values[kV2SP1] * values[kCos2DeltaPhiMu1] + values[kV2SP2] * values[kCos2DeltaPhiMu2];
+      float V2ME_EP = values[kV2EP1] * values[kCos2DeltaPhiMu1] + values[kV2EP2] * values[kCos2DeltaPhiMu2];
+      values[kV2ME_SP] = std::isnan(V2ME_SP) || std::isinf(V2ME_SP) ? 0. : V2ME_SP;
+      values[kWV2ME_SP] = std::isnan(V2ME_SP) || std::isinf(V2ME_SP) ? 0. : 1.0;
+      values[kV2ME_EP] = std::isnan(V2ME_EP) || std::isinf(V2ME_EP) ? 0. : V2ME_EP;
+      values[kWV2ME_EP] = std::isnan(V2ME_EP) || std::isinf(V2ME_EP) ? 0. : 1.0;
+
+      // Cumulant part
+      float V22ME = values[kV22m] * values[kCos2DeltaPhiMu1] + values[kV22p] * values[kCos2DeltaPhiMu2];
+      float V24ME = values[kV24m] * values[kCos2DeltaPhiMu1] + values[kV24p] * values[kCos2DeltaPhiMu2];
+      values[kV22ME] = (std::isnan(V22ME) || std::isinf(V22ME) || std::isnan(V24ME) || std::isinf(V24ME)) ? 0. : V22ME;
+      values[kWV22ME] = (std::isnan(V22ME) || std::isinf(V22ME) || std::isnan(V24ME) || std::isinf(V24ME)) ? 0. : 1.0;
+      values[kV24ME] = (std::isnan(V22ME) || std::isinf(V22ME) || std::isnan(V24ME) || std::isinf(V24ME)) ? 0. : V24ME;
+      values[kWV24ME] = (std::isnan(V22ME) || std::isinf(V22ME) || std::isnan(V24ME) || std::isinf(V24ME)) ? 0. : 1.0;
+
+      if constexpr ((fillMap & ReducedEventQvectorExtra) > 0) {
+        complex<double> Q21(values[kQ2X0A] * values[kS11A], values[kQ2Y0A] * values[kS11A]);
+        complex<double> Q42(values[kQ42XA], values[kQ42YA]);
+        complex<double> Q23(values[kQ23XA], values[kQ23YA]);
+        complex<double> P2(TMath::Cos(2 * v12.Phi()), TMath::Sin(2 * v12.Phi()));
+        values[kM01POIME] = values[kMultDimuonsME] * values[kS11A];
+        values[kM0111POIME] = values[kMultDimuonsME] * (values[kS31A] - 3. * values[kS11A] * values[kS12A] + 2. * values[kS13A]);
+        values[kCORR2POIME] = (P2 * conj(Q21)).real() / values[kM01POIME];
+        values[kCORR4POIME] = (P2 * Q21 * conj(Q21) * conj(Q21) - P2 * Q21 * conj(Q42) - 2. * values[kS12A] * P2 * conj(Q21) + 2. * P2 * conj(Q23)).real() / values[kM0111POIME];
+        values[kM01POIoverMpME] = values[kMultDimuonsME] > 0 && !(std::isnan(values[kM01POIME]) || std::isinf(values[kM01POIME]) || std::isnan(values[kCORR2POIME]) || std::isinf(values[kCORR2POIME]) || std::isnan(values[kM0111POIME]) || std::isinf(values[kM0111POIME]) || std::isnan(values[kCORR4POIME]) || std::isinf(values[kCORR4POIME])) ? values[kM01POIME] / values[kMultDimuonsME] : 0;
+        values[kM0111POIoverMpME] = values[kMultDimuonsME] > 0 && !(std::isnan(values[kM0111POIME]) || std::isinf(values[kM0111POIME]) || std::isnan(values[kCORR4POIME]) || std::isinf(values[kCORR4POIME]) || std::isnan(values[kM01POIME]) || std::isinf(values[kM01POIME]) || std::isnan(values[kCORR2POIME]) || std::isinf(values[kCORR2POIME])) ? values[kM0111POIME] / values[kMultDimuonsME] : 0;
+        values[kM11REFoverMpME] = values[kMultDimuonsME] > 0 && !(std::isnan(values[kM11REF]) || std::isinf(values[kM11REF]) || std::isnan(values[kCORR2REF]) || std::isinf(values[kCORR2REF]) || std::isnan(values[kM1111REF]) || std::isinf(values[kM1111REF]) || std::isnan(values[kCORR4REF]) || std::isinf(values[kCORR4REF])) ? values[kM11REF] / values[kMultDimuonsME] : 0;
+        values[kM1111REFoverMpME] = values[kMultDimuonsME] > 0 && !(std::isnan(values[kM1111REF]) || std::isinf(values[kM1111REF]) || std::isnan(values[kCORR4REF]) || std::isinf(values[kCORR4REF]) || std::isnan(values[kM11REF]) || std::isinf(values[kM11REF]) || std::isnan(values[kCORR2REF]) || std::isinf(values[kCORR2REF])) ? values[kM1111REF] / values[kMultDimuonsME] : 0;
+        values[kCORR2REFbydimuonsME] = std::isnan(values[kM11REFoverMpME]) || std::isinf(values[kM11REFoverMpME]) || std::isnan(values[kCORR2REF]) || std::isinf(values[kCORR2REF]) || std::isnan(values[kM1111REFoverMpME]) || std::isinf(values[kM1111REFoverMpME]) || std::isnan(values[kCORR4REF]) || std::isinf(values[kCORR4REF]) ? 0 : values[kCORR2REF];
+        values[kCORR4REFbydimuonsME] = std::isnan(values[kM1111REFoverMpME]) || std::isinf(values[kM1111REFoverMpME]) || std::isnan(values[kCORR4REF]) || std::isinf(values[kCORR4REF]) || std::isnan(values[kM11REFoverMpME]) || std::isinf(values[kM11REFoverMpME]) || std::isnan(values[kCORR2REF]) || std::isinf(values[kCORR2REF]) ? 0 : values[kCORR4REF];
+        values[kCORR2POIME] = std::isnan(values[kCORR2POIME]) || std::isinf(values[kCORR2POIME]) || std::isnan(values[kM01POIME]) || std::isinf(values[kM01POIME]) || std::isnan(values[kCORR4POIME]) || std::isinf(values[kCORR4POIME]) || std::isnan(values[kM0111POIME]) || std::isinf(values[kM0111POIME]) ? 0 : values[kCORR2POIME];
+        values[kCORR4POIME] = std::isnan(values[kCORR4POIME]) || std::isinf(values[kCORR4POIME]) || std::isnan(values[kM0111POIME]) || std::isinf(values[kM0111POIME]) || std::isnan(values[kCORR2POIME]) || std::isinf(values[kCORR2POIME]) || std::isnan(values[kM01POIME]) || std::isinf(values[kM01POIME]) ? 0 : values[kCORR4POIME];
+      }
     }
   }
   if constexpr (pairType == kDecayToMuMu) {
@@ -3337,7 +3434,7 @@ template <int pairType, typename T1, typename T2>
 void VarManager::FillPairMC(T1 const& t1, T2 const& t2, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
   }
 
   float m1 = o2::constants::physics::MassElectron;
@@ -3500,7 +3597,7 @@ template <typename T1, typename T2, typename T3>
 void VarManager::FillTripleMC(T1 const& t1, T2 const& t2, T3 const& t3, float* values, PairCandidateType pairType)
 {
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
   }
 
   if (pairType == kTripleCandidateToEEPhoton) {
@@ -3561,7 +3658,7 @@ void VarManager::FillPairVertexing(C const& collision, T const& t1, T const& t2,
   constexpr bool muonHasCov = ((fillMap & MuonCov) > 0 || (fillMap & ReducedMuonCov) > 0);
 
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
   }
   float m1 = o2::constants::physics::MassElectron;
   float m2 = o2::constants::physics::MassElectron;
@@ -3573,6 +3670,16 @@ void VarManager::FillPairVertexing(C const& collision, T const& t1, T const& t2,
     m1 = o2::constants::physics::MassMuon;
     m2 = o2::constants::physics::MassMuon;
   }
+  if (!fgUsedPairVertexing && !propToSV) {
+    // none of the vertexing variables is used (sparse filling mode), skip the secondary vertex fit
+    values[kPt1] = t1.pt();
+    values[kEta1] = t1.eta();
+    values[kPhi1] = t1.phi();
+    values[kPt2] = t2.pt();
+    values[kEta2] = t2.eta();
+    values[kPhi2] = t2.phi();
+    return;
+  }
   ROOT::Math::PtEtaPhiMVector v1(t1.pt(), t1.eta(), t1.phi(), m1);
   ROOT::Math::PtEtaPhiMVector v2(t2.pt(), t2.eta(), t2.phi(), m2);
   ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
@@ -3596,7 +3703,7 @@ void VarManager::FillPairVertexing(C const& collision, T const& t1, T const& t2,
                                       t2.cSnpSnp(), t2.cTglY(), t2.cTglZ(), t2.cTglSnp(), t2.cTglTgl(),
                                       t2.c1PtY(), t2.c1PtZ(), t2.c1PtSnp(), t2.c1PtTgl(), t2.c1Pt21Pt2()};
       o2::track::TrackParCov pars2{t2.x(), t2.alpha(), t2pars, t2covs};
-      procCode = fgFitterTwoProngBarrel.process(pars1, pars2);
+      procCode = CurrentContext().fitterTwoProngBarrel.process(pars1, pars2);
     } else if constexpr ((pairType == kDecayToMuMu) && muonHasCov) {
       // Initialize track parameters for forward
       double chi21 = t1.chi2();
@@ -3613,7 +3720,7 @@ void VarManager::FillPairVertexing(C const& collision, T const& t1, T const& t2,
                              t2.c1PtX(), t2.c1PtY(), t2.c1PtPhi(), t2.c1PtTgl(), t2.c1Pt21Pt2()};
       SMatrix55 t2covs(v2.begin(), v2.end());
       o2::track::TrackParCovFwd pars2{t2.z(), t2pars, t2covs, chi22};
-      procCode = fgFitterTwoProngFwd.process(pars1, pars2);
+      procCode = CurrentContext().fitterTwoProngFwd.process(pars1, pars2);
     } else {
       return;
     }
@@ -3652,11 +3759,11 @@ void VarManager::FillPairVertexing(C const& collision, T const& t1, T const& t2,
       auto covMatrixPV = primaryVertex.getCov();
 
       if constexpr ((pairType == kDecayToEE || pairType == kDecayToKPi) && trackHasCov) {
-        secondaryVertex = fgFitterTwoProngBarrel.getPCACandidate();
-        covMatrixPCA = fgFitterTwoProngBarrel.calcPCACovMatrixFlat();
-        auto chi2PCA = fgFitterTwoProngBarrel.getChi2AtPCACandidate();
-        auto trackParVar0 = fgFitterTwoProngBarrel.getTrack(0);
-        auto trackParVar1 = fgFitterTwoProngBarrel.getTrack(1);
+        secondaryVertex = CurrentContext().fitterTwoProngBarrel.getPCACandidate();
+        covMatrixPCA = CurrentContext().fitterTwoProngBarrel.calcPCACovMatrixFlat();
+        auto chi2PCA = CurrentContext().fitterTwoProngBarrel.getChi2AtPCACandidate();
+        auto trackParVar0 = CurrentContext().fitterTwoProngBarrel.getTrack(0);
+        auto trackParVar1 = CurrentContext().fitterTwoProngBarrel.getTrack(1);
         values[kVertexingChi2PCA] = chi2PCA;
         v1 = {trackParVar0.getPt(), trackParVar0.getEta(), trackParVar0.getPhi(), m1};
         v2 = {trackParVar1.getPt(), trackParVar1.getEta(), trackParVar1.getPhi(), m2};
@@ -3664,11 +3771,11 @@ void VarManager::FillPairVertexing(C const& collision, T const& t1, T const& t2,
 
       } else if constexpr (pairType == kDecayToMuMu && muonHasCov) {
         // Get pca candidate from forward DCA fitter
-        secondaryVertex = fgFitterTwoProngFwd.getPCACandidate();
-        covMatrixPCA = fgFitterTwoProngFwd.calcPCACovMatrixFlat();
-        auto chi2PCA = fgFitterTwoProngFwd.getChi2AtPCACandidate();
-        auto trackParVar0 = fgFitterTwoProngFwd.getTrack(0);
-        auto trackParVar1 = fgFitterTwoProngFwd.getTrack(1);
+        secondaryVertex = CurrentContext().fitterTwoProngFwd.getPCACandidate();
+        covMatrixPCA = CurrentContext().fitterTwoProngFwd.calcPCACovMatrixFlat();
+        auto chi2PCA = CurrentContext().fitterTwoProngFwd.getChi2AtPCACandidate();
+        auto trackParVar0 = CurrentContext().fitterTwoProngFwd.getTrack(0);
+        auto trackParVar1 = CurrentContext().fitterTwoProngFwd.getTrack(1);
         values[kVertexingChi2PCA] = chi2PCA;
         v1 = {trackParVar0.getPt(), trackParVar0.getEta(), trackParVar0.getPhi(), m1};
         v2 = {trackParVar1.getPt(), trackParVar1.getEta(), trackParVar1.getPhi(), m2};
@@ -3958,7 +4065,7 @@ void VarManager::FillTripletVertexing(C const& collision, T const& t1, T const&
   bool trackHasCov = ((fillMap & ReducedTrackBarrelCov) > 0);
 
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
   }
 
   float m1, m2, m3;
@@ -3998,7 +4105,7 @@ void VarManager::FillTripletVertexing(C const& collision, T const& t1, T const&
                                       t3.cSnpSnp(), t3.cTglY(), t3.cTglZ(), t3.cTglSnp(), t3.cTglTgl(),
                                       t3.c1PtY(), t3.c1PtZ(), t3.c1PtSnp(), t3.c1PtTgl(), t3.c1Pt21Pt2()};
       o2::track::TrackParCov pars3{t3.x(), t3.alpha(), t3pars, t3covs};
-      procCode = VarManager::fgFitterThreeProngBarrel.process(pars1, pars2, pars3);
+      procCode = CurrentContext().fitterThreeProngBarrel.process(pars1, pars2, pars3);
     } else {
       return;
     }
@@ -4032,9 +4139,9 @@ void VarManager::FillTripletVertexing(C const& collision, T const& t1, T const&
     Vec3D secondaryVertex;
 
     if constexpr (eventHasVtxCov) {
-      secondaryVertex = fgFitterThreeProngBarrel.getPCACandidate();
+      secondaryVertex = CurrentContext().fitterThreeProngBarrel.getPCACandidate();
 
-      std::array<float, 6> covMatrixPCA = fgFitterThreeProngBarrel.calcPCACovMatrixFlat();
+      std::array<float, 6> covMatrixPCA = CurrentContext().fitterThreeProngBarrel.calcPCACovMatrixFlat();
 
       o2::math_utils::Point3D<float> vtxXYZ(collision.posX(), collision.posY(), collision.posZ());
       std::array<float, 6> vtxCov{collision.covXX(), collision.covXY(), collision.covYY(), collision.covXZ(), collision.covYZ(), collision.covZZ()};
@@ -4042,7 +4149,7 @@ void VarManager::FillTripletVertexing(C const& collision, T const& t1, T const&
       auto covMatrixPV = primaryVertex.getCov();
 
       if (fgUsedVars[kVertexingChi2PCA]) {
-        auto chi2PCA = fgFitterThreeProngBarrel.getChi2AtPCACandidate();
+        auto chi2PCA = CurrentContext().fitterThreeProngBarrel.getChi2AtPCACandidate();
         values[VarManager::kVertexingChi2PCA] = chi2PCA;
       }
 
@@ -4180,7 +4287,7 @@ void VarManager::FillDileptonTrackVertexing(C const& collision, T1 const& lepton
   constexpr bool trackHasCov = ((fillMap & TrackCov) > 0 || (fillMap & ReducedTrackBarrelCov) > 0);
   constexpr bool muonHasCov = ((fillMap & MuonCov) > 0 || (fillMap & ReducedMuonCov) > 0);
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
   }
 
   float mtrack;
@@ -4219,8 +4326,8 @@ void VarManager::FillDileptonTrackVertexing(C const& collision, T1 const& lepton
                              track.c1PtX(), track.c1PtY(), track.c1PtPhi(), track.c1PtTgl(), track.c1Pt21Pt2()};
       SMatrix55 t3covs(v3.begin(), v3.end());
       o2::track::TrackParCovFwd pars3{track.z(), t3pars, t3covs, chi23};
-      procCode = VarManager::fgFitterThreeProngFwd.process(pars1, pars2, pars3);
-      procCodeJpsi = VarManager::fgFitterTwoProngFwd.process(pars1, pars2);
+      procCode = CurrentContext().fitterThreeProngFwd.process(pars1, pars2, pars3);
+      procCodeJpsi = CurrentContext().fitterTwoProngFwd.process(pars1, pars2);
     } else if constexpr ((candidateType == kBtoJpsiEEK || candidateType == kDstarToD0KPiPi) && trackHasCov) {
       if constexpr ((candidateType == kBtoJpsiEEK) && trackHasCov) {
         mlepton1 = o2::constants::physics::MassElectron;
@@ -4246,8 +4353,8 @@ void VarManager::FillDileptonTrackVertexing(C const& collision, T1 const& lepton
                                            track.cSnpSnp(), track.cTglY(), track.cTglZ(), track.cTglSnp(), track.cTglTgl(),
                                            track.c1PtY(), track.c1PtZ(), track.c1PtSnp(), track.c1PtTgl(), track.c1Pt21Pt2()};
       o2::track::TrackParCov pars3{track.x(), track.alpha(), lepton3pars, lepton3covs};
-      procCode = VarManager::fgFitterThreeProngBarrel.process(pars1, pars2, pars3);
-      procCodeJpsi = VarManager::fgFitterTwoProngBarrel.process(pars1, pars2);
+      procCode = CurrentContext().fitterThreeProngBarrel.process(pars1, pars2, pars3);
+      procCodeJpsi = CurrentContext().fitterTwoProngBarrel.process(pars1, pars2);
     } else {
       return;
     }
@@ -4305,15 +4412,15 @@ void VarManager::FillDileptonTrackVertexing(C const& collision, T1 const& lepton
       auto covMatrixPV = primaryVertex.getCov();
 
       if constexpr ((candidateType == kBtoJpsiEEK || candidateType == kDstarToD0KPiPi) && trackHasCov) {
-        secondaryVertex = fgFitterThreeProngBarrel.getPCACandidate();
-        covMatrixPCA = fgFitterThreeProngBarrel.calcPCACovMatrixFlat();
+        secondaryVertex = CurrentContext().fitterThreeProngBarrel.getPCACandidate();
+        covMatrixPCA = CurrentContext().fitterThreeProngBarrel.calcPCACovMatrixFlat();
       } else if constexpr (candidateType == kBcToThreeMuons && muonHasCov) {
-        secondaryVertex = fgFitterThreeProngFwd.getPCACandidate();
-        covMatrixPCA = fgFitterThreeProngFwd.calcPCACovMatrixFlat();
+        secondaryVertex = CurrentContext().fitterThreeProngFwd.getPCACandidate();
+        covMatrixPCA = CurrentContext().fitterThreeProngFwd.calcPCACovMatrixFlat();
       }
 
       if (fgUsedVars[kVertexingChi2PCA]) {
-        auto chi2PCA = fgFitterThreeProngBarrel.getChi2AtPCACandidate();
+        auto chi2PCA = CurrentContext().fitterThreeProngBarrel.getChi2AtPCACandidate();
         values[VarManager::kVertexingChi2PCA] = chi2PCA;
       }
 
@@ -4456,7 +4563,7 @@ template <typename C, typename A>
 void VarManager::FillQVectorFromGFW(C const& /*collision*/, A const& compA11, A const& compB11, A const& compC11, A const& compA21, A const& compB21, A const& compC21, A const& compA31, A const& compB31, A const& compC31, A const& compA41, A const& compB41, A const& compC41, A const& compA23, A const& compA42, float S10A, float S10B, float S10C, float S11A, float S11B, float S11C, float S12A, float S13A, float S14A, float S21A, float S22A, float S31A, float S41A, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
   }
 
   // Fill Qn vectors from generic flow framework for different eta gap A, B, C (n=1,2,3,4) with proper normalisation
@@ -4561,7 +4668,7 @@ template <typename C>
 void VarManager::FillQVectorFromCentralFW(C const& collision, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
   }
 
   float xQVecFT0a = collision.qvecFT0ARe();   // already normalised
@@ -4657,7 +4764,7 @@ template <typename C>
 void VarManager::FillSpectatorPlane(C const& collision, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
   }
 
   auto zncEnergy = collision.energySectorZNC();
@@ -4765,7 +4872,13 @@ void VarManager::FillPairVn(T1 const& t1, T2 const& t2, float* values)
 {
 
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
+  }
+  if (!fgUsedPairFlow) {
+    // none of the flow variables is used (sparse filling mode)
+    values[kPt1] = t1.pt();
+    values[kPt2] = t2.pt();
+    return;
   }
 
   float m1 = o2::constants::physics::MassElectron;
@@ -4821,23 +4934,23 @@ void VarManager::FillPairVn(T1 const& t1, T2 const& t2, float* values)
   values[kV2EP] = std::isnan(V2EP) || std::isinf(V2EP) ? 0. : V2EP;
   values[kWV2EP] = std::isnan(V2EP) || std::isinf(V2EP) ? 0. : 1.0;
 
-  if (std::isnan(VarManager::fgValues[VarManager::kU2Q2]) == true) {
+  if (std::isnan(values[kU2Q2]) == true) {
     values[kU2Q2] = -999.;
     values[kR2SP_AB] = -999.;
     values[kR2SP_AC] = -999.;
     values[kR2SP_BC] = -999.;
   }
-  if (std::isnan(VarManager::fgValues[VarManager::kU3Q3]) == true) {
+  if (std::isnan(values[kU3Q3]) == true) {
     values[kU3Q3] = -999.;
     values[kR3SP] = -999.;
   }
-  if (std::isnan(VarManager::fgValues[VarManager::kCos2DeltaPhi]) == true) {
+  if (std::isnan(values[kCos2DeltaPhi]) == true) {
     values[kCos2DeltaPhi] = -999.;
     values[kR2EP_AB] = -999.;
     values[kR2EP_AC] = -999.;
     values[kR2EP_BC] = -999.;
   }
-  if (std::isnan(VarManager::fgValues[VarManager::kCos3DeltaPhi]) == true) {
+  if (std::isnan(values[kCos3DeltaPhi]) == true) {
     values[kCos3DeltaPhi] = -999.;
     values[kR3EP] = -999.;
   }
@@ -4915,7 +5028,7 @@ template <typename T>
 void VarManager::FillZDC(T const& zdc, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
   }
 
   values[kEnergyCommonZNA] = (zdc.energyCommonZNA() > 0) ? zdc.energyCommonZNA() : -1.;
@@ -4932,7 +5045,7 @@ template <typename T1, typename T2>
 void VarManager::FillDileptonHadron(T1 const& dilepton, T2 const& hadron, float* values, float hadronMass)
 {
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
   }
 
   if (fgUsedVars[kPairMass] || fgUsedVars[kPairPt] || fgUsedVars[kPairEta] || fgUsedVars[kPairPhi] || fgUsedVars[kPairMassDau] || fgUsedVars[kPairPtDau] || fgUsedVars[kDileptonHadronKstar]) {
@@ -4979,7 +5092,7 @@ template <typename T1, typename T2>
 void VarManager::FillDileptonPhoton(T1 const& dilepton, T2 const& photon, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
   }
   if (fgUsedVars[kPairMass] || fgUsedVars[kPairPt] || fgUsedVars[kPairEta] || fgUsedVars[kPairPhi]) {
     ROOT::Math::PtEtaPhiMVector v1(dilepton.pt(), dilepton.eta(), dilepton.phi(), dilepton.mass());
@@ -5006,7 +5119,7 @@ template <typename T>
 void VarManager::FillHadron(T const& hadron, float* values, float hadronMass)
 {
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
   }
 
   ROOT::Math::PtEtaPhiMVector vhadron(hadron.pt(), hadron.eta(), hadron.phi(), hadronMass);
@@ -5021,7 +5134,7 @@ template <int partType, typename Cand, typename H, typename T>
 void VarManager::FillSingleDileptonCharmHadron(Cand const& candidate, H hfHelper, T& bdtScoreCharmHad, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
   }
 
   if constexpr (partType == kJPsi) {
@@ -5057,7 +5170,7 @@ template <int candidateType, typename T1, typename T2, typename T3>
 void VarManager::FillDileptonTrackTrack(T1 const& dilepton, T2 const& hadron1, T3 const& hadron2, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
   }
 
   double defaultDileptonMass = 3.096;
@@ -5119,7 +5232,7 @@ void VarManager::FillDileptonTrackTrackVertexing(C const& collision, T1 const& l
   }
 
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
   }
 
   float mtrack1, mtrack2;
@@ -5165,11 +5278,11 @@ void VarManager::FillDileptonTrackTrackVertexing(C const& collision, T1 const& l
                                         track2.c1PtY(), track2.c1PtZ(), track2.c1PtSnp(), track2.c1PtTgl(), track2.c1Pt21Pt2()};
     o2::track::TrackParCov pars4{track2.x(), track2.alpha(), track2pars, track2covs};
 
-    procCodeDilepton = VarManager::fgFitterTwoProngBarrel.process(pars1, pars2);
+    procCodeDilepton = CurrentContext().fitterTwoProngBarrel.process(pars1, pars2);
     // create dilepton track
-    // o2::track::TrackParCov parsDilepton = VarManager::fgFitterTwoProngBarrel.createParentTrackParCov(0);
-    // procCodeDileptonTrackTrack = VarManager::fgFitterThreeProngBarrel.process(parsDilepton, pars3, pars4);
-    procCodeDileptonTrackTrack = VarManager::fgFitterFourProngBarrel.process(pars1, pars2, pars3, pars4);
+    // o2::track::TrackParCov parsDilepton = CurrentContext().fitterTwoProngBarrel.createParentTrackParCov(0);
+    // procCodeDileptonTrackTrack = CurrentContext().fitterThreeProngBarrel.process(parsDilepton, pars3, pars4);
+    procCodeDileptonTrackTrack = CurrentContext().fitterFourProngBarrel.process(pars1, pars2, pars3, pars4);
 
     // fill values
     if (procCodeDilepton == 0 && procCodeDileptonTrackTrack == 0) {
@@ -5194,8 +5307,8 @@ void VarManager::FillDileptonTrackTrackVertexing(C const& collision, T1 const& l
     } else {
       Vec3D secondaryVertex;
       std::array<float, 6> covMatrixPCA;
-      secondaryVertex = fgFitterFourProngBarrel.getPCACandidate();
-      covMatrixPCA = fgFitterFourProngBarrel.calcPCACovMatrixFlat();
+      secondaryVertex = CurrentContext().fitterFourProngBarrel.getPCACandidate();
+      covMatrixPCA = CurrentContext().fitterFourProngBarrel.calcPCACovMatrixFlat();
 
       o2::math_utils::Point3D<float> vtxXYZ(collision.posX(), collision.posY(), collision.posZ());
       std::array<float, 6> vtxCov{collision.covXX(), collision.covXY(), collision.covYY(), collision.covXZ(), collision.covYZ(), collision.covZZ()};
@@ -5372,7 +5485,7 @@ template <int candidateType, typename T1, typename T2>
 void VarManager::FillQuadMC(T1 const& dilepton, T2 const& track1, T2 const& track2, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = CurrentValues();
   }
 
   double defaultDileptonMass = 3.096;
@@ -5433,7 +5546,7 @@ float VarManager::calculatePhiV(T1 const& t1, T2 const& t2)
   ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
 
   float pairPhiV = -999;
-  float bz = fgMagField;
+  float bz = CurrentContext().magField;
 
   bool swapTracks = false;
   if (v1.Pt() < v2.Pt()) { // ordering of track, pt1 > pt2
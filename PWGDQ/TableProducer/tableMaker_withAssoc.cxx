@@ -18,6 +18,7 @@
 // The event filtering, centrality, and V0Bits (from v0-selector) can be switched on/off by selecting one
 //  of the process functions
 // C++ includes
+#include <cmath>
 #include <map>
 #include <memory>
 #include <string>
@@ -250,6 +251,10 @@ struct TableMaker {
     Configurable<bool> fRefitGlobalMuon{"cfgRefitGlobalMuon", true, "Correct global muon parameters"};
     Configurable<float> fMuonMatchEtaMin{"cfgMuonMatchEtaMin", -4.0f, "Definition of the acceptance of muon tracks to be matched with MFT"};
     Configurable<float> fMuonMatchEtaMax{"cfgMuonMatchEtaMax", -2.5f, "Definition of the acceptance of muon tracks to be matched with MFT"};
+    // Loose preselections on the stored kinematics, applied before the propagation and the evaluation of the cuts
+    Configurable<float> fBarrelPreselMinPt{"cfgBarrelPreselMinPt", 0.0f, "Minimum pt of the barrel tracks before propagation and cuts (0: no preselection)"};
+    Configurable<float> fBarrelPreselMaxAbsEta{"cfgBarrelPreselMaxAbsEta", -1.0f, "Maximum |eta| of the barrel tracks before propagation and cuts (negative: no preselection)"};
+    Configurable<float> fMuonPreselMinPt{"cfgMuonPreselMinPt", 0.0f, "Minimum pt of the muons before propagation and cuts (0: no preselection)"};
 
     // TPC occupancy related variables
     Configurable<float> fTPCShortPast{"cfgTPCShortPast", 8.0f, "Time in short past to look for occupancy (micro-seconds)"};
@@ -272,13 +277,20 @@ struct TableMaker {
   bool fDoDetailedQA = false; // Bool to set detailed QA true, if QA is set true
   int fCurrentRun;            // needed to detect if the run changed and trigger update of calibrations etc.
 
-  // maps used to store index info; NOTE: std::map are sorted in ascending order by default (needed for track to collision indices)
-  std::map<uint32_t, uint32_t> fCollIndexMap;             // key: old collision index, value: skimmed collision index
-  std::map<uint32_t, uint32_t> fTrackIndexMap;            // key: old track global index, value: new track global index
-  std::map<uint32_t, uint32_t> fFwdTrackIndexMap;         // key: fwd-track global index, value: new fwd-track global index
-  std::map<uint32_t, uint32_t> fFwdTrackIndexMapReversed; // key: new fwd-track global index, value: fwd-track global index
-  std::map<uint32_t, uint8_t> fFwdTrackFilterMap;         // key: fwd-track global index, value: fwd-track filter map
-  std::map<uint32_t, uint32_t> fMftIndexMap;              // key: MFT tracklet global index, value: new MFT tracklet global index
+  // dense index maps, sized to the input tables of the DF; position: original global index, value: skimmed index or -1 if not skimmed
+  std::vector<int64_t> fCollIndexMap;              // skimmed collision index
+  std::vector<int64_t> fTrackIndexMap;             // skimmed barrel track index
+  std::vector<int64_t> fFwdTrackIndexMap;          // skimmed fwd-track index
+  std::vector<uint32_t> fFwdTrackIndexMapReversed; // fwd-track global index of the fwd-tracks skimmed in the current collision, in the order of their skimmed index
+  std::vector<uint8_t> fFwdTrackFilterMap;         // fwd-track filter map
+  std::vector<int64_t> fMftIndexMap;               // skimmed MFT track index
+  int fNSkimmedCollisions = 0;
+
+  // skimmed index of an original global index, -1 if not skimmed or not in the map
+  static int64_t skimmedIndex(const std::vector<int64_t>& indexMap, int64_t globalIndex)
+  {
+    return (globalIndex >= 0 && globalIndex < static_cast<int64_t>(indexMap.size())) ? indexMap[globalIndex] : -1;
+  }
 
   // FIXME: For now, the skimming is done using the Common track-collision association task, which does not allow to use
   //       our own Filtered tracks. If the filter is very selective, then it may be worth to run the association in this workflow
@@ -338,6 +350,8 @@ struct TableMaker {
       fCCDB->get<TGeoManager>(fConfigCCDB.fConfigGeoPath);
     }
     VarManager::SetDefaultVarNames(); // Important that this is called before DefineCuts() !!
+    // the muons are propagated once per associated collision, both for the selection and for the skimming
+    VarManager::SetUseMuonPropagationCache(fConfigVariousOptions.fPropMuon.value);
 
     // Define the event, track and muon cuts
     DefineCuts();
@@ -757,7 +771,8 @@ struct TableMaker {
     // NOTE: So far, collisions are filtered based on the user specified analysis cuts AND the filterPP or Zorro event filter.
     //      The collision-track associations which point to an event that is not selected for writing are discarded!
 
-    fCollIndexMap.clear();
+    fCollIndexMap.assign(collisions.size(), -1);
+    fNSkimmedCollisions = 0;
     int multTPC = -1.0;
     float multFV0A = -1.0;
     float multFV0C = -1.0;
@@ -935,6 +950,7 @@ struct TableMaker {
       }
 
       fCollIndexMap[collision.globalIndex()] = event.lastIndex();
+      fNSkimmedCollisions++;
     }
   }
 
@@ -961,7 +977,11 @@ struct TableMaker {
       // If the original collision of this track was not selected for skimming, then we skip this track.
       //  Normally, the filter-pp is selecting all collisions which contain the tracks which contributed to the triggering
       //    of an event, so this is rejecting possibly a few tracks unrelated to the trigger, originally associated with collisions distant in time.
-      if (fCollIndexMap.find(track.collisionId()) == fCollIndexMap.end()) {
+      if (skimmedIndex(fCollIndexMap, track.collisionId()) < 0) {
+        continue;
+      }
+      // loose kinematic preselection, before the propagation and the cuts
+      if (track.pt() < fConfigVariousOptions.fBarrelPreselMinPt || (fConfigVariousOptions.fBarrelPreselMaxAbsEta >= 0 && std::abs(track.eta()) > fConfigVariousOptions.fBarrelPreselMaxAbsEta)) {
         continue;
       }
 
@@ -985,7 +1005,7 @@ struct TableMaker {
           trackTempFilterMap |= (static_cast<uint32_t>(1) << i);
           // NOTE: the QA is filled here just for the first occurence of this track.
           //    So if there are histograms of quantities which depend on the collision association, these will not be accurate
-          if (fConfigHistOutput.fConfigQA && (fTrackIndexMap.find(track.globalIndex()) == fTrackIndexMap.end())) {
+          if (fConfigHistOutput.fConfigQA && fTrackIndexMap[track.globalIndex()] < 0) {
             fHistMan->FillHistClass(Form("TrackBarrel_%s", (*cut)->GetName()), VarManager::fgValues);
           }
           (reinterpret_cast<TH1D*>(fStatsList->At(kStatsTracks)))->Fill(static_cast<float>(i));
@@ -997,7 +1017,7 @@ struct TableMaker {
 
       // If this track is already present in the index map, it means it was already skimmed,
       // so we just store the association and we skip the track
-      if (fTrackIndexMap.find(track.globalIndex()) != fTrackIndexMap.end()) {
+      if (fTrackIndexMap[track.globalIndex()] >= 0) {
         trackBarrelAssoc(fCollIndexMap[collision.globalIndex()], fTrackIndexMap[track.globalIndex()]);
         continue;
       }
@@ -1113,7 +1133,7 @@ struct TableMaker {
       }
 
       // write the MFT track global index in the map for skimming (to make sure we have it just once)
-      if (fMftIndexMap.find(track.globalIndex()) == fMftIndexMap.end()) {
+      if (fMftIndexMap[track.globalIndex()] < 0) {
         uint32_t reducedEventIdx = fCollIndexMap[collision.globalIndex()];
         mftTrack(reducedEventIdx, static_cast<uint64_t>(0), track.pt(), track.eta(), track.phi());
         // TODO: We are not writing the DCA at the moment, because this depend on the collision association
@@ -1155,6 +1175,11 @@ struct TableMaker {
         }
       }
 
+      // loose kinematic preselection, before the propagation and the cuts
+      if (muon.pt() < fConfigVariousOptions.fMuonPreselMinPt) {
+        continue;
+      }
+
       VarManager::FillTrack<TMuonFillMap>(muon);
       // NOTE: Muons are propagated to the current associated collisions.
       //       So if a muon is associated to multiple collisions, depending on the selections,
@@ -1188,7 +1213,7 @@ struct TableMaker {
           // NOTE: the QA is filled here just for the first occurence of this muon, which means the current association
           //     will be skipped from histograms if this muon was already filled in the skimming map.
           //    So if there are histograms of quantities which depend on the collision association, these histograms will not be completely accurate
-          if (fConfigHistOutput.fConfigQA && (fFwdTrackIndexMap.find(muon.globalIndex()) == fFwdTrackIndexMap.end())) {
+          if (fConfigHistOutput.fConfigQA && fFwdTrackIndexMap[muon.globalIndex()] < 0) {
             fHistMan->FillHistClass(Form("Muons_%s", (*cut)->GetName()), VarManager::fgValues);
           }
           (reinterpret_cast<TH1D*>(fStatsList->At(kStatsMuons)))->Fill(static_cast<float>(i));
@@ -1202,15 +1227,15 @@ struct TableMaker {
       trackFilteringTag = trackTempFilterMap; // BIT0-7:  user selection cuts
 
       // update the index map if this is a new muon (it can already exist in the map from a different collision association)
-      if (fFwdTrackIndexMap.find(muon.globalIndex()) == fFwdTrackIndexMap.end()) {
+      if (fFwdTrackIndexMap[muon.globalIndex()] < 0) {
         counter++;
         fFwdTrackIndexMap[muon.globalIndex()] = offset + counter;
-        fFwdTrackIndexMapReversed[offset + counter] = muon.globalIndex();
-        fFwdTrackFilterMap[muon.globalIndex()] = trackFilteringTag;                                                    // store here the filtering tag so we don't repeat the cuts in the second iteration
-        if (muon.has_matchMCHTrack() && (fFwdTrackIndexMap.find(muon.matchMCHTrackId()) == fFwdTrackIndexMap.end())) { // write also the matched MCH track
+        fFwdTrackIndexMapReversed.push_back(muon.globalIndex());
+        fFwdTrackFilterMap[muon.globalIndex()] = trackFilteringTag;                      // store here the filtering tag so we don't repeat the cuts in the second iteration
+        if (muon.has_matchMCHTrack() && fFwdTrackIndexMap[muon.matchMCHTrackId()] < 0) { // write also the matched MCH track
           counter++;
           fFwdTrackIndexMap[muon.matchMCHTrackId()] = offset + counter;
-          fFwdTrackIndexMapReversed[offset + counter] = muon.matchMCHTrackId();
+          fFwdTrackIndexMapReversed.push_back(muon.matchMCHTrackId());
           fFwdTrackFilterMap[muon.matchMCHTrackId()] = trackFilteringTag; // store here the filtering tag so we don't repeat the cuts in the second iteration
         }
       } else {
@@ -1222,7 +1247,7 @@ struct TableMaker {
 
     // Now we have the full index map of selected muons so we can proceed with writing the muon tables
     // Special care needed for the MCH and MFT indices
-    for (const auto& [skimIdx, origIdx] : fFwdTrackIndexMapReversed) {
+    for (const auto& origIdx : fFwdTrackIndexMapReversed) {
       // get the muon
       auto muon = muons.rawIteratorAt(origIdx);
       uint32_t reducedEventIdx = fCollIndexMap[collision.globalIndex()];
@@ -1233,10 +1258,10 @@ struct TableMaker {
       uint32_t mchIdx = -1;
       uint32_t mftIdx = -1;
       if (muon.trackType() == static_cast<uint8_t>(0) || muon.trackType() == static_cast<uint8_t>(2)) { // MCH-MID (2) or global (0)
-        if (fFwdTrackIndexMap.find(muon.matchMCHTrackId()) != fFwdTrackIndexMap.end()) {
+        if (skimmedIndex(fFwdTrackIndexMap, muon.matchMCHTrackId()) >= 0) {
           mchIdx = fFwdTrackIndexMap[muon.matchMCHTrackId()];
         }
-        if (fMftIndexMap.find(muon.matchMFTTrackId()) != fMftIndexMap.end()) {
+        if (skimmedIndex(fMftIndexMap, muon.matchMFTTrackId()) >= 0) {
           mftIdx = fMftIndexMap[muon.matchMFTTrackId()];
         }
       }
@@ -1288,6 +1313,7 @@ struct TableMaker {
                     TTracks const& tracksBarrel, TMuons const& muons, TMFTTracks const& mftTracks,
                     TTrackAssoc const& trackAssocs, TFwdTrackAssoc const& fwdTrackAssocs, TMFTTrackAssoc const& mftAssocs)
   {
+    VarManager::ResetMuonPropagationCache();
 
     if (bcs.size() > 0 && fCurrentRun != bcs.begin().runNumber()) {
       if (fConfigPostCalibTPC.fConfigComputeTPCpostCalib) {
@@ -1332,12 +1358,12 @@ struct TableMaker {
     eventVtxCov.reserve(collisions.size());
 
     skimCollisions<TEventFillMap, TTrackFillMap>(collisions, bcs, zdcs, trackAssocs, tracksBarrel);
-    if (fCollIndexMap.size() == 0) {
+    if (fNSkimmedCollisions == 0) {
       return;
     }
 
     if constexpr (static_cast<bool>(TTrackFillMap)) {
-      fTrackIndexMap.clear();
+      fTrackIndexMap.assign(tracksBarrel.size(), -1);
       trackBarrelInfo.reserve(tracksBarrel.size());
       trackBasic.reserve(tracksBarrel.size());
       trackBarrel.reserve(tracksBarrel.size());
@@ -1347,15 +1373,15 @@ struct TableMaker {
     }
 
     if constexpr (static_cast<bool>(TMFTFillMap)) {
-      fMftIndexMap.clear();
+      fMftIndexMap.assign(mftTracks.size(), -1);
       mftTrack.reserve(mftTracks.size());
       mftTrackExtra.reserve(mftTracks.size());
       mftAssoc.reserve(mftTracks.size());
     }
 
     if constexpr (static_cast<bool>(TMuonFillMap)) {
-      fFwdTrackIndexMap.clear();
-      fFwdTrackFilterMap.clear();
+      fFwdTrackIndexMap.assign(muons.size(), -1);
+      fFwdTrackFilterMap.assign(muons.size(), 0);
       muonBasic.reserve(muons.size());
       muonExtra.reserve(muons.size());
       muonInfo.reserve(muons.size());
@@ -1364,7 +1390,10 @@ struct TableMaker {
     }
 
     // loop over selected collisions, group the compatible associations, and run the skimming
-    for (auto const& [origIdx, skimIdx] : fCollIndexMap) {
+    for (int64_t origIdx = 0; origIdx < static_cast<int64_t>(fCollIndexMap.size()); origIdx++) {
+      if (fCollIndexMap[origIdx] < 0) {
+        continue;
+      }
       auto collision = collisions.rawIteratorAt(origIdx);
       // group the barrel track associations for this collision
       if constexpr (static_cast<bool>(TTrackFillMap)) {
@@ -1388,7 +1417,7 @@ struct TableMaker {
       }
     } // end loop over skimmed collisions
 
-    // LOG(info) << "Skims in this TF: " << fCollIndexMap.size() << " collisions; " << trackBasic.lastIndex() << " barrel tracks; "
+    // LOG(info) << "Skims in this TF: " << fNSkimmedCollisions << " collisions; " << trackBasic.lastIndex() << " barrel tracks; "
     //<< muonBasic.lastIndex() << " muon tracks; " << mftTrack.lastIndex() << " MFT tracks; ";
     // LOG(info) << "      " << trackBarrelAssoc.lastIndex() << " barrel assocs; " << muonAssoc.lastIndex() << " muon assocs; " << mftAssoc.lastIndex() << " MFT assoc";
   }
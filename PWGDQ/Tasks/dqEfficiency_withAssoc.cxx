@@ -16,6 +16,7 @@
 #include <vector>
 #include <algorithm>
 #include <map>
+#include <unordered_map>
 #include <string>
 #include <memory>
 #include <utility>
@@ -449,7 +450,8 @@ struct AnalysisTrackSelection {
 
   HistogramManager* fHistMan;
   std::vector<AnalysisCompositeCut*> fTrackCuts;
-  std::vector<MCSignal*> fMCSignals; // list of signals to be checked
+  std::vector<MCSignal*> fMCSignals;        // list of signals to be checked
+  MCSignalDecisionCache fMCSignalDecisions; // decisions of the signals for the MC tracks of the DF
   std::vector<TString> fHistNamesReco;
   std::vector<TString> fHistNamesMCMatched;
 
@@ -506,6 +508,7 @@ struct AnalysisTrackSelection {
         fMCSignals.push_back(mcIt);
       }
     }
+    fMCSignalDecisions.SetSignals(fMCSignals);
 
     if (fConfigQA) {
       fHistMan = new HistogramManager("analysisHistos", "aa", VarManager::kNVars);
@@ -549,6 +552,7 @@ struct AnalysisTrackSelection {
   template <uint32_t TEventFillMap, uint32_t TTrackFillMap, typename TEvents, typename TTracks, typename TEventsMC, typename TTracksMC>
   void runTrackSelection(ReducedTracksAssoc const& assocs, TEvents const& events, TTracks const& tracks, TEventsMC const& /*eventsMC*/, TTracksMC const& tracksMC)
   {
+    fMCSignalDecisions.Reset();
     fNAssocsInBunch.clear();
     fNAssocsOutOfBunch.clear();
 
@@ -631,7 +635,7 @@ struct AnalysisTrackSelection {
         // loop over all MC signals
         for (auto sig = fMCSignals.begin(); sig != fMCSignals.end(); sig++, isig++) {
           // check if this MC signal is matched
-          if ((*sig)->CheckSignal(true, track.reducedMCTrack())) {
+          if (fMCSignalDecisions.IsMatched(track.reducedMCTrack(), isig)) {
             // mcDecision |= (static_cast<uint32_t>(1) << isig);
             //  loop over cuts and fill histograms for the cuts that are fulfilled
             for (unsigned int icut = 0; icut < fTrackCuts.size(); icut++) {
@@ -775,7 +779,8 @@ struct AnalysisMuonSelection {
   std::vector<AnalysisCompositeCut*> fMuonCuts;
   std::vector<TString> fHistNamesReco;
   std::vector<TString> fHistNamesMCMatched;
-  std::vector<MCSignal*> fMCSignals; // list of signals to be checked
+  std::vector<MCSignal*> fMCSignals;        // list of signals to be checked
+  MCSignalDecisionCache fMCSignalDecisions; // decisions of the signals for the MC tracks of the DF
 
   int fCurrentRun; // current run kept to detect run changes and trigger loading params from CCDB
 
@@ -830,6 +835,7 @@ struct AnalysisMuonSelection {
         fMCSignals.push_back(mcIt);
       }
     }
+    fMCSignalDecisions.SetSignals(fMCSignals);
 
     if (fConfigQA) {
       fHistMan = new HistogramManager("analysisHistos", "aa", VarManager::kNVars);
@@ -874,6 +880,7 @@ struct AnalysisMuonSelection {
   template <uint32_t TEventFillMap, uint32_t TMuonFillMap, typename TEvents, typename TMuons>
   void runMuonSelection(ReducedMuonsAssoc const& assocs, TEvents const& events, TMuons const& muons, ReducedMCEvents const& /*eventsMC*/, ReducedMCTracks const& muonsMC)
   {
+    fMCSignalDecisions.Reset();
     if (events.size() > 0 && fCurrentRun != events.begin().runNumber()) {
       o2::parameters::GRPMagField* grpmag = fCCDB->getForTimeStamp<o2::parameters::GRPMagField>(grpmagPath, events.begin().timestamp());
       if (grpmag != nullptr) {
@@ -944,7 +951,7 @@ struct AnalysisMuonSelection {
       for (auto sig = fMCSignals.begin(); sig != fMCSignals.end(); sig++, isig++) {
         if constexpr ((TMuonFillMap & VarManager::ObjTypes::ReducedMuon) > 0) {
           if (track.has_reducedMCTrack()) {
-            if ((*sig)->CheckSignal(true, track.reducedMCTrack())) {
+            if (fMCSignalDecisions.IsMatched(track.reducedMCTrack(), isig)) {
               mcDecision |= (static_cast<uint32_t>(1) << isig);
             }
           }
@@ -1320,8 +1327,14 @@ struct AnalysisSameEventPairing {
   std::map<int, std::vector<TString>> fBarrelHistNamesMCmatched;
   std::map<int, std::vector<TString>> fMuonHistNames;
   std::map<int, std::vector<TString>> fMuonHistNamesMCmatched;
+  // fill plan handles of the histogram classes above, resolved once at the end of init()
+  std::map<int, std::vector<int>> fTrackHistPlans;
+  std::map<int, std::vector<int>> fBarrelHistPlansMCmatched;
+  std::map<int, std::vector<int>> fMuonHistPlans;
+  std::map<int, std::vector<int>> fMuonHistPlansMCmatched;
   std::vector<MCSignal*> fRecMCSignals;
   std::vector<MCSignal*> fGenMCSignals;
+  std::unordered_map<uint64_t, uint32_t> fPairMCDecisions; // decisions of the reconstructed MC signals per pair of MC particles in the DF
 
   std::vector<AnalysisCompositeCut> fPairCuts;
 
@@ -1642,6 +1655,37 @@ struct AnalysisSameEventPairing {
     dqhistograms::AddHistogramsFromJSON(fHistMan, fConfigAddJSONHistograms.value.c_str()); // ad-hoc histograms via JSON
     VarManager::SetUseVars(fHistMan->GetUsedVars());                                   // provide the list of required variables so that VarManager knows what to fill
     fOutputList.setObject(fHistMan->GetMainHistogramList());
+
+    // resolve the histogram classes used in the pairing loop into fill plan handles
+    auto resolvePlans = [&](const std::map<int, std::vector<TString>>& names, std::map<int, std::vector<int>>& plans) {
+      for (const auto& [key, classes] : names) {
+        auto& handles = plans[key];
+        for (const auto& className : classes) {
+          handles.push_back(fHistMan->GetFillPlan(className.Data()));
+        }
+      }
+    };
+    resolvePlans(fTrackHistNames, fTrackHistPlans);
+    resolvePlans(fBarrelHistNamesMCmatched, fBarrelHistPlansMCmatched);
+    resolvePlans(fMuonHistNames, fMuonHistPlans);
+    resolvePlans(fMuonHistNamesMCmatched, fMuonHistPlansMCmatched);
+  }
+
+  // Bit map of the reconstructed MC signals matched by a pair of MC particles; all the signals are checked
+  // once per ordered pair of MC particles in the DF, the other associations of the same legs reuse the result
+  template <typename TMCTrack>
+  uint32_t getPairMCDecision(TMCTrack const& mcTrack1, TMCTrack const& mcTrack2)
+  {
+    uint64_t key = (static_cast<uint64_t>(mcTrack1.globalIndex()) << 32) | static_cast<uint32_t>(mcTrack2.globalIndex());
+    auto [it, isNew] = fPairMCDecisions.try_emplace(key, 0);
+    if (isNew) {
+      for (unsigned int isig = 0; isig < fRecMCSignals.size(); isig++) {
+        if (fRecMCSignals[isig]->CheckSignal(true, mcTrack1, mcTrack2)) {
+          it->second |= (static_cast<uint32_t>(1) << isig);
+        }
+      }
+    }
+    return it->second;
   }
 
   void initParamsFromCCDB(uint64_t timestamp, bool withTwoProngFitter = true)
@@ -1687,16 +1731,11 @@ struct AnalysisSameEventPairing {
       fCurrentRun = events.begin().runNumber();
     }
 
-    TString cutNames = fConfigCuts.track.value;
-    std::map<int, std::vector<TString>> histNames = fTrackHistNames;
-    std::map<int, std::vector<TString>> histNamesMC = fBarrelHistNamesMCmatched;
-    int ncuts = fNCutsBarrel;
-    if constexpr (TPairType == VarManager::kDecayToMuMu) {
-      cutNames = fConfigCuts.muon.value;
-      histNames = fMuonHistNames;
-      histNamesMC = fMuonHistNamesMCmatched;
-      ncuts = fNCutsMuon;
-    }
+    constexpr bool isMuMu = (TPairType == VarManager::kDecayToMuMu);
+    auto& histPlans = isMuMu ? fMuonHistPlans : fTrackHistPlans;
+    auto& histPlansMC = isMuMu ? fMuonHistPlansMCmatched : fBarrelHistPlansMCmatched;
+    int ncuts = isMuMu ? fNCutsMuon : fNCutsBarrel;
+    fPairMCDecisions.clear();
 
     uint32_t twoTrackFilter = static_cast<uint32_t>(0);
     int sign1 = 0;
@@ -1763,15 +1802,10 @@ struct AnalysisSameEventPairing {
           }
 
           // run MC matching for this pair
-          int isig = 0;
           mcDecision = 0;
-          for (auto sig = fRecMCSignals.begin(); sig != fRecMCSignals.end(); sig++, isig++) {
-            if (t1.has_reducedMCTrack() && t2.has_reducedMCTrack()) {
-              if ((*sig)->CheckSignal(true, t1.reducedMCTrack(), t2.reducedMCTrack())) {
-                mcDecision |= (static_cast<uint32_t>(1) << isig);
-              }
-            }
-          } // end loop over MC signals
+          if (t1.has_reducedMCTrack() && t2.has_reducedMCTrack()) {
+            mcDecision = getPairMCDecision(t1.reducedMCTrack(), t2.reducedMCTrack());
+          }
           if (t1.has_reducedMCTrack() && t2.has_reducedMCTrack()) {
             isCorrectAssoc_leg1 = (t1.reducedMCTrack().reducedMCevent() == event.reducedMCevent());
             isCorrectAssoc_leg2 = (t2.reducedMCTrack().reducedMCevent() == event.reducedMCevent());
@@ -1830,15 +1864,10 @@ struct AnalysisSameEventPairing {
           }
 
           // run MC matching for this pair
-          int isig = 0;
           mcDecision = 0;
-          for (auto sig = fRecMCSignals.begin(); sig != fRecMCSignals.end(); sig++, isig++) {
-            if (t1.has_reducedMCTrack() && t2.has_reducedMCTrack()) {
-              if ((*sig)->CheckSignal(true, t1.reducedMCTrack(), t2.reducedMCTrack())) {
-                mcDecision |= (static_cast<uint32_t>(1) << isig);
-              }
-            }
-          } // end loop over MC signals
+          if (t1.has_reducedMCTrack() && t2.has_reducedMCTrack()) {
+            mcDecision = getPairMCDecision(t1.reducedMCTrack(), t2.reducedMCTrack());
+          }
 
           if (t1.has_reducedMCTrack() && t2.has_reducedMCTrack()) {
             isCorrectAssoc_leg1 = (t1.reducedMCTrack().reducedMCevent() == event.reducedMCevent());
@@ -1910,95 +1939,94 @@ struct AnalysisSameEventPairing {
           if (twoTrackFilter & (static_cast<uint32_t>(1) << icut)) {
             isAmbiInBunch = (twoTrackFilter & (static_cast<uint32_t>(1) << 28)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 29));
             isAmbiOutOfBunch = (twoTrackFilter & (static_cast<uint32_t>(1) << 30)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 31));
-            if (sign1 * sign2 < 0) {                                                    // +- pairs
-              fHistMan->FillHistClass(histNames[icut][0].Data(), VarManager::fgValues); // reconstructed, unmatched
-              for (unsigned int isig = 0; isig < fRecMCSignals.size(); isig++) {        // loop over MC signals
-                if (mcDecision & (static_cast<uint32_t>(1) << isig)) {
-                  PromptNonPromptSepTable(VarManager::fgValues[VarManager::kMass], VarManager::fgValues[VarManager::kPt], VarManager::fgValues[VarManager::kVertexingTauxyProjected], VarManager::fgValues[VarManager::kVertexingTauxyProjectedPoleJPsiMass], VarManager::fgValues[VarManager::kVertexingTauzProjected], isAmbiInBunch, isAmbiOutOfBunch, isCorrect_pair);
-                  fHistMan->FillHistClass(histNamesMC[icut * fRecMCSignals.size() + isig][0].Data(), VarManager::fgValues); // matched signal
-                  if (useMiniTree.fConfigMiniTree) {
-                    if constexpr (TPairType == VarManager::kDecayToMuMu) {
-                      twoTrackFilter = a1.isMuonSelected_raw() & a2.isMuonSelected_raw() & fMuonFilterMask;
-                      if (!twoTrackFilter) { // the tracks must have at least one filter bit in common to continue
-                        continue;
-                      }
-                      auto t1 = a1.template reducedmuon_as<TTracks>();
-                      auto t2 = a2.template reducedmuon_as<TTracks>();
-
-                      float dileptonMass = VarManager::fgValues[VarManager::kMass];
-                      if (dileptonMass > useMiniTree.fConfigMiniTreeMinMass && dileptonMass < useMiniTree.fConfigMiniTreeMaxMass) {
-                        dileptonMiniTreeRec(mcDecision,
-                                            VarManager::fgValues[VarManager::kMass],
-                                            VarManager::fgValues[VarManager::kPt], VarManager::fgValues[VarManager::kEta], VarManager::fgValues[VarManager::kPhi], VarManager::fgValues[VarManager::kCentFT0C],
-                                            t1.reducedMCTrack().pt(), t1.reducedMCTrack().eta(), t1.reducedMCTrack().phi(),
-                                            t2.reducedMCTrack().pt(), t2.reducedMCTrack().eta(), t2.reducedMCTrack().phi(),
-                                            VarManager::fgValues[VarManager::kPt1], VarManager::fgValues[VarManager::kEta1], VarManager::fgValues[VarManager::kPhi1],
-                                            VarManager::fgValues[VarManager::kPt2], VarManager::fgValues[VarManager::kEta2], VarManager::fgValues[VarManager::kPhi2]);
-                      }
+            if (sign1 * sign2 < 0) {                                                      // +- pairs
+              fHistMan->FillHistClass(histPlans[icut][0], VarManager::fgValues);          // reconstructed, unmatched
+              for (uint32_t sigBits = mcDecision; sigBits != 0; sigBits &= sigBits - 1) { // loop over the matched MC signals
+                int isig = __builtin_ctz(sigBits);
+                PromptNonPromptSepTable(VarManager::fgValues[VarManager::kMass], VarManager::fgValues[VarManager::kPt], VarManager::fgValues[VarManager::kVertexingTauxyProjected], VarManager::fgValues[VarManager::kVertexingTauxyProjectedPoleJPsiMass], VarManager::fgValues[VarManager::kVertexingTauzProjected], isAmbiInBunch, isAmbiOutOfBunch, isCorrect_pair);
+                fHistMan->FillHistClass(histPlansMC[icut * fRecMCSignals.size() + isig][0], VarManager::fgValues); // matched signal
+                if (useMiniTree.fConfigMiniTree) {
+                  if constexpr (TPairType == VarManager::kDecayToMuMu) {
+                    twoTrackFilter = a1.isMuonSelected_raw() & a2.isMuonSelected_raw() & fMuonFilterMask;
+                    if (!twoTrackFilter) { // the tracks must have at least one filter bit in common to continue
+                      continue;
                     }
-                  }
-                  if (fConfigQA) {
-                    if (isCorrectAssoc_leg1 && isCorrectAssoc_leg2) { // correct track-collision association
-                      fHistMan->FillHistClass(histNamesMC[icut * fRecMCSignals.size() + isig][3].Data(), VarManager::fgValues);
-                    } else { // incorrect track-collision association
-                      fHistMan->FillHistClass(histNamesMC[icut * fRecMCSignals.size() + isig][4].Data(), VarManager::fgValues);
+                    auto t1 = a1.template reducedmuon_as<TTracks>();
+                    auto t2 = a2.template reducedmuon_as<TTracks>();
+
+                    float dileptonMass = VarManager::fgValues[VarManager::kMass];
+                    if (dileptonMass > useMiniTree.fConfigMiniTreeMinMass && dileptonMass < useMiniTree.fConfigMiniTreeMaxMass) {
+                      dileptonMiniTreeRec(mcDecision,
+                                          VarManager::fgValues[VarManager::kMass],
+                                          VarManager::fgValues[VarManager::kPt], VarManager::fgValues[VarManager::kEta], VarManager::fgValues[VarManager::kPhi], VarManager::fgValues[VarManager::kCentFT0C],
+                                          t1.reducedMCTrack().pt(), t1.reducedMCTrack().eta(), t1.reducedMCTrack().phi(),
+                                          t2.reducedMCTrack().pt(), t2.reducedMCTrack().eta(), t2.reducedMCTrack().phi(),
+                                          VarManager::fgValues[VarManager::kPt1], VarManager::fgValues[VarManager::kEta1], VarManager::fgValues[VarManager::kPhi1],
+                                          VarManager::fgValues[VarManager::kPt2], VarManager::fgValues[VarManager::kEta2], VarManager::fgValues[VarManager::kPhi2]);
                     }
-                    if (isAmbiInBunch) { // ambiguous in bunch
-                      fHistMan->FillHistClass(histNamesMC[icut * fRecMCSignals.size() + isig][5].Data(), VarManager::fgValues);
-                      if (isCorrectAssoc_leg1 && isCorrectAssoc_leg2) {
-                        fHistMan->FillHistClass(histNamesMC[icut * fRecMCSignals.size() + isig][6].Data(), VarManager::fgValues);
-                      } else {
-                        fHistMan->FillHistClass(histNamesMC[icut * fRecMCSignals.size() + isig][7].Data(), VarManager::fgValues);
-                      }
+                  }
+                }
+                if (fConfigQA) {
+                  if (isCorrectAssoc_leg1 && isCorrectAssoc_leg2) { // correct track-collision association
+                    fHistMan->FillHistClass(histPlansMC[icut * fRecMCSignals.size() + isig][3], VarManager::fgValues);
+                  } else { // incorrect track-collision association
+                    fHistMan->FillHistClass(histPlansMC[icut * fRecMCSignals.size() + isig][4], VarManager::fgValues);
+                  }
+                  if (isAmbiInBunch) { // ambiguous in bunch
+                    fHistMan->FillHistClass(histPlansMC[icut * fRecMCSignals.size() + isig][5], VarManager::fgValues);
+                    if (isCorrectAssoc_leg1 && isCorrectAssoc_leg2) {
+                      fHistMan->FillHistClass(histPlansMC[icut * fRecMCSignals.size() + isig][6], VarManager::fgValues);
+                    } else {
+                      fHistMan->FillHistClass(histPlansMC[icut * fRecMCSignals.size() + isig][7], VarManager::fgValues);
                     }
-                    if (isAmbiOutOfBunch) { // ambiguous out of bunch
-                      fHistMan->FillHistClass(histNamesMC[icut * fRecMCSignals.size() + isig][8].Data(), VarManager::fgValues);
-                      if (isCorrectAssoc_leg1 && isCorrectAssoc_leg2) {
-                        fHistMan->FillHistClass(histNamesMC[icut * fRecMCSignals.size() + isig][9].Data(), VarManager::fgValues);
-                      } else {
-                        fHistMan->FillHistClass(histNamesMC[icut * fRecMCSignals.size() + isig][10].Data(), VarManager::fgValues);
-                      }
+                  }
+                  if (isAmbiOutOfBunch) { // ambiguous out of bunch
+                    fHistMan->FillHistClass(histPlansMC[icut * fRecMCSignals.size() + isig][8], VarManager::fgValues);
+                    if (isCorrectAssoc_leg1 && isCorrectAssoc_leg2) {
+                      fHistMan->FillHistClass(histPlansMC[icut * fRecMCSignals.size() + isig][9], VarManager::fgValues);
+                    } else {
+                      fHistMan->FillHistClass(histPlansMC[icut * fRecMCSignals.size() + isig][10], VarManager::fgValues);
                     }
                   }
                 }
-                if (fConfigQA) {
+              }
+              if (fConfigQA) {
+                for (unsigned int isig = 0; isig < fRecMCSignals.size(); isig++) { // filled once per MC signal
                   if (isAmbiInBunch) {
-                    fHistMan->FillHistClass(histNames[icut][3].Data(), VarManager::fgValues);
+                    fHistMan->FillHistClass(histPlans[icut][3], VarManager::fgValues);
                   }
                   if (isAmbiOutOfBunch) {
-                    fHistMan->FillHistClass(histNames[icut][3 + 3].Data(), VarManager::fgValues);
+                    fHistMan->FillHistClass(histPlans[icut][3 + 3], VarManager::fgValues);
                   }
                 }
               }
             } else {
               if (sign1 > 0) { // ++ pairs
-                fHistMan->FillHistClass(histNames[icut][1].Data(), VarManager::fgValues);
-                for (unsigned int isig = 0; isig < fRecMCSignals.size(); isig++) { // loop over MC signals
-                  if (mcDecision & (static_cast<uint32_t>(1) << isig)) {
-                    fHistMan->FillHistClass(histNamesMC[icut * fRecMCSignals.size() + isig][1].Data(), VarManager::fgValues);
-                  }
+                fHistMan->FillHistClass(histPlans[icut][1], VarManager::fgValues);
+                for (uint32_t sigBits = mcDecision; sigBits != 0; sigBits &= sigBits - 1) { // loop over the matched MC signals
+                  int isig = __builtin_ctz(sigBits);
+                  fHistMan->FillHistClass(histPlansMC[icut * fRecMCSignals.size() + isig][1], VarManager::fgValues);
                 }
                 if (fConfigQA) {
                   if (isAmbiInBunch) {
-                    fHistMan->FillHistClass(histNames[icut][4].Data(), VarManager::fgValues);
+                    fHistMan->FillHistClass(histPlans[icut][4], VarManager::fgValues);
                   }
                   if (isAmbiOutOfBunch) {
-                    fHistMan->FillHistClass(histNames[icut][4 + 3].Data(), VarManager::fgValues);
+                    fHistMan->FillHistClass(histPlans[icut][4 + 3], VarManager::fgValues);
                   }
                 }
               } else { // -- pairs
-                fHistMan->FillHistClass(histNames[icut][2].Data(), VarManager::fgValues);
-                for (unsigned int isig = 0; isig < fRecMCSignals.size(); isig++) { // loop over MC signals
-                  if (mcDecision & (static_cast<uint32_t>(1) << isig)) {
-                    fHistMan->FillHistClass(histNamesMC[icut * fRecMCSignals.size() + isig][2].Data(), VarManager::fgValues);
-                  }
+                fHistMan->FillHistClass(histPlans[icut][2], VarManager::fgValues);
+                for (uint32_t sigBits = mcDecision; sigBits != 0; sigBits &= sigBits - 1) { // loop over the matched MC signals
+                  int isig = __builtin_ctz(sigBits);
+                  fHistMan->FillHistClass(histPlansMC[icut * fRecMCSignals.size() + isig][2], VarManager::fgValues);
                 }
                 if (fConfigQA) {
                   if (isAmbiInBunch) {
-                    fHistMan->FillHistClass(histNames[icut][5].Data(), VarManager::fgValues);
+                    fHistMan->FillHistClass(histPlans[icut][5], VarManager::fgValues);
                   }
                   if (isAmbiOutOfBunch) {
-                    fHistMan->FillHistClass(histNames[icut][5 + 3].Data(), VarManager::fgValues);
+                    fHistMan->FillHistClass(histPlans[icut][5 + 3], VarManager::fgValues);
                   }
                 }
               }
@@ -2008,12 +2036,12 @@ struct AnalysisSameEventPairing {
               if (!(cut.IsSelected(VarManager::fgValues))) // apply pair cuts
                 continue;
               if (sign1 * sign2 < 0) {
-                fHistMan->FillHistClass(histNames[ncuts + icut * ncuts + iPairCut][0].Data(), VarManager::fgValues);
+                fHistMan->FillHistClass(histPlans[ncuts + icut * ncuts + iPairCut][0], VarManager::fgValues);
               } else {
                 if (sign1 > 0) {
-                  fHistMan->FillHistClass(histNames[ncuts + icut * ncuts + iPairCut][1].Data(), VarManager::fgValues);
+                  fHistMan->FillHistClass(histPlans[ncuts + icut * ncuts + iPairCut][1], VarManager::fgValues);
                 } else {
-                  fHistMan->FillHistClass(histNames[ncuts + icut * ncuts + iPairCut][2].Data(), VarManager::fgValues);
+                  fHistMan->FillHistClass(histPlans[ncuts + icut * ncuts + iPairCut][2], VarManager::fgValues);
                 }
               }
             } // end loop (pair cuts)
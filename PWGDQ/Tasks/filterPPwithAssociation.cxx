@@ -410,6 +410,7 @@ struct DQMuonsSelection {
       if (!o2::base::GeometryManager::isGeometryLoaded()) {
         fCCDB->get<TGeoManager>(geoPath);
       }
+      VarManager::SetUseMuonPropagationCache(true);
     }
 
     TString cutNamesStr = fConfigCuts.value;
@@ -501,6 +502,7 @@ struct DQMuonsSelection {
 
   void processSelection(Collisions const& collisions, BCsWithTimestamps const& bcstimestamps, MyMuons const& muons, aod::FwdTrackAssoc const& muonAssocs)
   {
+    VarManager::ResetMuonPropagationCache();
     for (auto& collision : collisions) {
       auto muonIdsThisCollision = muonAssocs.sliceBy(fwdtrackIndicesPerCollision, collision.globalIndex());
       runMuonSelection<gkMuonFillMap>(collision, bcstimestamps, muons, muonIdsThisCollision);
@@ -662,6 +664,7 @@ struct DQFilterPPTask {
       if (!o2::base::GeometryManager::isGeometryLoaded()) {
         fCCDB->get<TGeoManager>(geoPath);
       }
+      VarManager::SetUseMuonPropagationCache(true);
     }
     DefineCuts();
 
@@ -1061,6 +1064,7 @@ struct DQFilterPPTask {
                        MyBarrelTracksAssocSelected const& trackAssocs, MyMuonsAssocSelected const& muonAssocs)
   {
     fFiltersMap.clear();
+    VarManager::ResetMuonPropagationCache();
     fCEFPfilters.clear();
 
     // Loop over collisions
@@ -1125,6 +1129,7 @@ struct DQFilterPPTask {
                            MyMuonsAssocSelected const& muonAssocs)
   {
     fFiltersMap.clear();
+    VarManager::ResetMuonPropagationCache();
     fCEFPfilters.clear();
 
     uint64_t muonMask = 0;
@@ -1222,6 +1222,7 @@ struct AnalysisSameEventPairing {
     Configurable<std::string> collisionSystem{"syst", "pp", "Collision system, pp or PbPb"};
     Configurable<float> centerMassEnergy{"energy", 13600, "Center of mass energy in GeV"};
     Configurable<bool> propTrack{"cfgPropTrack", true, "Propgate tracks to associated collision to recalculate DCA and momentum vector"};
+    Configurable<bool> sparseVarFilling{"cfgSparseVarFilling", false, "Skip the pair vertexing and flow computations whose variables are not used in histograms, cuts or output tables (not available with flat tables)"};
   } fConfigOptions;
 
   Service<o2::ccdb::BasicCCDBManager> fCCDB;
@@ -1500,6 +1501,19 @@ struct AnalysisSameEventPairing {
       VarManager::SetUseVars(fHistMan->GetUsedVars());                                                          // provide the list of required variables so that VarManager knows what to fill
       fOutputList.setObject(fHistMan->GetMainHistogramList());
     }
+    if (fConfigOptions.sparseVarFilling.value) {
+      if (fConfigOptions.flatTables.value) {
+        LOG(warning) << "Sparse variable filling is not available together with the flat tables, all the pair variables will be computed";
+      } else {
+        VarManager::SetUseVars(AnalysisCut::fgUsedVars); // variables used in the pair cuts
+        // variables written in the dilepton extra tables
+        for (auto var : {VarManager::kVertexingTauz, VarManager::kVertexingLz, VarManager::kVertexingLxy,
+                         VarManager::kVertexingTauzProjected, VarManager::kVertexingLzProjected, VarManager::kVertexingLxyProjected}) {
+          VarManager::SetUseVariable(var);
+        }
+        VarManager::SetSparseFilling(true);
+      }
+    }
     LOG(info) << "Finished initialization of AnalysisSameEventPairing (idstoreh)";
   }
 
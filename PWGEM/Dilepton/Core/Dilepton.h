@@ -55,6 +55,7 @@
 #include <array>
 #include <iterator>
 #include <map>
+#include <set>
 #include <string>
 #include <tuple>
 #include <utility>
@@ -508,7 +509,6 @@ struct Dilepton {
     emh_neg = 0x0;
 
     used_trackIds.clear();
-    used_trackIds.shrink_to_fit();
 
     delete h2sp_resolution;
   }
@@ -800,6 +800,39 @@ struct Dilepton {
     }
   }
 
+  std::vector<int8_t> track_selection_cache; // single track selection by globalIndex in this DF: -1 = not evaluated yet, 0 = rejected, 1 = accepted
+
+  // The single track selection (incl. ML PID and the best MCH-MFT match) does not depend on the partner,
+  // hence it is evaluated once per track and DF instead of once per pair.
+  template <typename TCollision, typename TTrack, typename TCut, typename TAllTracks>
+  bool isSelectedTrack(TCollision const& collision, TTrack const& track, TCut const& cut, TAllTracks const& tracks)
+  {
+    if (track.globalIndex() >= static_cast<int64_t>(track_selection_cache.size())) {
+      track_selection_cache.resize(track.globalIndex() + 1, -1);
+    }
+    int8_t& is_selected = track_selection_cache[track.globalIndex()];
+    if (is_selected >= 0) {
+      return is_selected > 0;
+    }
+    is_selected = 1;
+    if constexpr (pairtype == o2::aod::pwgem::dilepton::utils::pairutil::DileptonPairType::kDielectron) {
+      if (dielectroncuts.cfg_pid_scheme == static_cast<int>(DielectronCut::PIDSchemes::kPIDML)) {
+        if (!cut.template IsSelectedTrack<false, true>(track, collision)) {
+          is_selected = 0;
+        }
+      } else { // cut-based
+        if (!cut.template IsSelectedTrack<false, false>(track)) {
+          is_selected = 0;
+        }
+      }
+    } else if constexpr (pairtype == o2::aod::pwgem::dilepton::utils::pairutil::DileptonPairType::kDimuon) {
+      if (!cut.template IsSelectedTrack<false>(track) || !o2::aod::pwgem::dilepton::utils::emtrackutil::isBestMatch(track, cut, tracks)) {
+        is_selected = 0;
+      }
+    }
+    return is_selected > 0;
+  }
+
   template <int ev_id, typename TCollision, typename TTrack1, typename TTrack2, typename TCut, typename TAllTracks>
   bool fillPairInfo(TCollision const& collision, TTrack1 const& t1, TTrack2 const& t2, TCut const& cut, TAllTracks const& tracks)
   {
@@ -828,27 +861,8 @@ struct Dilepton {
     }
 
     if constexpr (ev_id == 0) {
-      if constexpr (pairtype == o2::aod::pwgem::dilepton::utils::pairutil::DileptonPairType::kDielectron) {
-        if (dielectroncuts.cfg_pid_scheme == static_cast<int>(DielectronCut::PIDSchemes::kPIDML)) {
-          if (!cut.template IsSelectedTrack<false, true>(t1, collision) || !cut.template IsSelectedTrack<false, true>(t2, collision)) {
-            return false;
-          }
-        } else { // cut-based
-          if (!cut.template IsSelectedTrack<false, false>(t1) || !cut.template IsSelectedTrack<false, false>(t2)) {
-            return false;
-          }
-        }
-      } else if constexpr (pairtype == o2::aod::pwgem::dilepton::utils::pairutil::DileptonPairType::kDimuon) {
-        if (!cut.template IsSelectedTrack<false>(t1) || !cut.template IsSelectedTrack<false>(t2)) {
-          return false;
-        }
-
-        if (!o2::aod::pwgem::dilepton::utils::emtrackutil::isBestMatch(t1, cut, tracks)) {
-          return false;
-        }
-        if (!o2::aod::pwgem::dilepton::utils::emtrackutil::isBestMatch(t2, cut, tracks)) {
-          return false;
-        }
+      if (!isSelectedTrack(collision, t1, cut, tracks) || !isSelectedTrack(collision, t2, cut, tracks)) {
+        return false;
       }
     }
 
@@ -1061,8 +1075,7 @@ struct Dilepton {
         std::copy(t1.ambiguousElectronsIds().begin(), t1.ambiguousElectronsIds().end(), std::back_inserter(possibleIds1));
         std::copy(t2.ambiguousElectronsIds().begin(), t2.ambiguousElectronsIds().end(), std::back_inserter(possibleIds2));
 
-        if (std::find(used_trackIds.begin(), used_trackIds.end(), pair_tmp_id1) == used_trackIds.end()) {
-          used_trackIds.emplace_back(pair_tmp_id1);
+        if (used_trackIds.insert(pair_tmp_id1).second) {
           if (cfgDoMix) {
             if (t1.sign() > 0) {
               emh_pos->AddTrackToEventPool(key_df_collision, EMTrackWithCov(ndf, t1.globalIndex(), collision.globalIndex(), t1.trackId(), t1.pt(), t1.eta(), t1.phi(), leptonM1, t1.sign(), t1.dcaXY(), t1.dcaZ(), possibleIds1,
@@ -1075,8 +1088,7 @@ struct Dilepton {
             }
           }
         }
-        if (std::find(used_trackIds.begin(), used_trackIds.end(), pair_tmp_id2) == used_trackIds.end()) {
-          used_trackIds.emplace_back(pair_tmp_id2);
+        if (used_trackIds.insert(pair_tmp_id2).second) {
           if (cfgDoMix) {
             if (t2.sign() > 0) {
               emh_pos->AddTrackToEventPool(key_df_collision, EMTrackWithCov(ndf, t2.globalIndex(), collision.globalIndex(), t2.trackId(), t2.pt(), t2.eta(), t2.phi(), leptonM2, t2.sign(), t2.dcaXY(), t2.dcaZ(), possibleIds2,
@@ -1093,8 +1105,7 @@ struct Dilepton {
         std::copy(t1.ambiguousMuonsIds().begin(), t1.ambiguousMuonsIds().end(), std::back_inserter(possibleIds1));
         std::copy(t2.ambiguousMuonsIds().begin(), t2.ambiguousMuonsIds().end(), std::back_inserter(possibleIds2));
 
-        if (std::find(used_trackIds.begin(), used_trackIds.end(), pair_tmp_id1) == used_trackIds.end()) {
-          used_trackIds.emplace_back(pair_tmp_id1);
+        if (used_trackIds.insert(pair_tmp_id1).second) {
           if (cfgDoMix) {
             if (t1.sign() > 0) {
               emh_pos->AddTrackToEventPool(key_df_collision, EMFwdTrack(ndf, t1.globalIndex(), collision.globalIndex(), t1.fwdtrackId(), t1.pt(), t1.eta(), t1.phi(), o2::constants::physics::MassMuon, t1.sign(), t1.fwdDcaX(), t1.fwdDcaY(), possibleIds1,
@@ -1105,8 +1116,7 @@ struct Dilepton {
             }
           }
         }
-        if (std::find(used_trackIds.begin(), used_trackIds.end(), pair_tmp_id2) == used_trackIds.end()) {
-          used_trackIds.emplace_back(pair_tmp_id2);
+        if (used_trackIds.insert(pair_tmp_id2).second) {
           if (cfgDoMix) {
             if (t2.sign() > 0) {
               emh_pos->AddTrackToEventPool(key_df_collision, EMFwdTrack(ndf, t2.globalIndex(), collision.globalIndex(), t2.fwdtrackId(), t2.pt(), t2.eta(), t2.phi(), o2::constants::physics::MassMuon, t2.sign(), t2.fwdDcaX(), t2.fwdDcaY(), possibleIds2,
@@ -1160,7 +1170,7 @@ struct Dilepton {
   TEMH* emh_neg = nullptr;
   std::map<std::pair<int, int>, uint64_t> map_mixed_eventId_to_globalBC;
 
-  std::vector<std::pair<int, int>> used_trackIds;
+  std::set<std::pair<int, int>> used_trackIds; // <dfId, trackId> already added to the mixing pool
   int ndf = 0;
 
   template <bool isTriggerAnalysis, typename TCollisions, typename TLeptons, typename TPresilce, typename TCut, typename TAllTracks>
@@ -1372,27 +1382,8 @@ struct Dilepton {
   template <typename TCollision, typename TTrack1, typename TTrack2, typename TCut, typename TAllTracks>
   bool isPairOK(TCollision const& collision, TTrack1 const& t1, TTrack2 const& t2, TCut const& cut, TAllTracks const& tracks)
   {
-    if constexpr (pairtype == o2::aod::pwgem::dilepton::utils::pairutil::DileptonPairType::kDielectron) {
-      if (dielectroncuts.cfg_pid_scheme == static_cast<int>(DielectronCut::PIDSchemes::kPIDML)) {
-        if (!cut.template IsSelectedTrack<false, true>(t1, collision) || !cut.template IsSelectedTrack<false, true>(t2, collision)) {
-          return false;
-        }
-      } else { // cut-based
-        if (!cut.template IsSelectedTrack<false, false>(t1) || !cut.template IsSelectedTrack<false, false>(t2)) {
-          return false;
-        }
-      }
-    } else if constexpr (pairtype == o2::aod::pwgem::dilepton::utils::pairutil::DileptonPairType::kDimuon) {
-      if (!cut.IsSelectedTrack(t1) || !cut.IsSelectedTrack(t2)) {
-        return false;
-      }
-
-      if (!o2::aod::pwgem::dilepton::utils::emtrackutil::isBestMatch(t1, cut, tracks)) {
-        return false;
-      }
-      if (!o2::aod::pwgem::dilepton::utils::emtrackutil::isBestMatch(t2, cut, tracks)) {
-        return false;
-      }
+    if (!isSelectedTrack(collision, t1, cut, tracks) || !isSelectedTrack(collision, t2, cut, tracks)) {
+      return false;
     }
 
     if constexpr (pairtype == o2::aod::pwgem::dilepton::utils::pairutil::DileptonPairType::kDielectron) {
@@ -1478,6 +1469,9 @@ struct Dilepton {
       }
     } // end of collision loop
 
+    std::vector<std::pair<int, int>> sorted_pairIds = passed_pairIds; // for binary search of the ambiguous pairs
+    std::sort(sorted_pairIds.begin(), sorted_pairIds.end());
+
     if constexpr (pairtype == o2::aod::pwgem::dilepton::utils::pairutil::DileptonPairType::kDielectron) {
       for (const auto& pairId : passed_pairIds) {
         auto t1 = tracks.rawIteratorAt(std::get<0>(pairId));
@@ -1487,7 +1481,7 @@ struct Dilepton {
         float n = 1.f; // include myself.
         for (const auto& ambId1 : t1.ambiguousElectronsIds()) {
           for (const auto& ambId2 : t2.ambiguousElectronsIds()) {
-            if (std::find(passed_pairIds.begin(), passed_pairIds.end(), std::make_pair(ambId1, ambId2)) != passed_pairIds.end()) {
+            if (std::binary_search(sorted_pairIds.begin(), sorted_pairIds.end(), std::make_pair(ambId1, ambId2))) {
               n += 1.f;
             }
           }
@@ -1502,7 +1496,7 @@ struct Dilepton {
         float n = 1.f; // include myself.
         for (const auto& ambId1 : t1.ambiguousMuonsIds()) {
           for (const auto& ambId2 : t2.ambiguousMuonsIds()) {
-            if (std::find(passed_pairIds.begin(), passed_pairIds.end(), std::make_pair(ambId1, ambId2)) != passed_pairIds.end()) {
+            if (std::binary_search(sorted_pairIds.begin(), sorted_pairIds.end(), std::make_pair(ambId1, ambId2))) {
               n += 1.f;
             }
           }
@@ -1518,12 +1512,14 @@ struct Dilepton {
   {
     if constexpr (pairtype == o2::aod::pwgem::dilepton::utils::pairutil::DileptonPairType::kDielectron) {
       auto electrons = std::get<0>(std::tie(args...));
+      track_selection_cache.clear();
       if (cfgApplyWeightTTCA) {
         fillPairWeightMap<false>(collisions, positive_electrons, negative_electrons, o2::aod::emprimaryelectron::emeventId, fDielectronCut, electrons);
       }
       runPairing<false>(collisions, positive_electrons, negative_electrons, o2::aod::emprimaryelectron::emeventId, fDielectronCut, electrons);
     } else if constexpr (pairtype == o2::aod::pwgem::dilepton::utils::pairutil::DileptonPairType::kDimuon) {
       auto muons = std::get<0>(std::tie(args...));
+      track_selection_cache.clear();
       if (cfgApplyWeightTTCA) {
         fillPairWeightMap<false>(collisions, positive_muons, negative_muons, o2::aod::emprimarymuon::emeventId, fDimuonCut, muons);
       }
@@ -1539,12 +1535,14 @@ struct Dilepton {
   {
     if constexpr (pairtype == o2::aod::pwgem::dilepton::utils::pairutil::DileptonPairType::kDielectron) {
       auto electrons = std::get<0>(std::tie(args...));
+      track_selection_cache.clear();
       if (cfgApplyWeightTTCA) {
         fillPairWeightMap<true>(collisions, positive_electrons, negative_electrons, o2::aod::emprimaryelectron::emeventId, fDielectronCut, electrons);
       }
       runPairing<true>(collisions, positive_electrons, negative_electrons, o2::aod::emprimaryelectron::emeventId, fDielectronCut, electrons);
     } else if constexpr (pairtype == o2::aod::pwgem::dilepton::utils::pairutil::DileptonPairType::kDimuon) {
       auto muons = std::get<0>(std::tie(args...));
+      track_selection_cache.clear();
       if (cfgApplyWeightTTCA) {
         fillPairWeightMap<true>(collisions, positive_muons, negative_muons, o2::aod::emprimarymuon::emeventId, fDimuonCut, muons);
       }
@@ -16,11 +16,17 @@
 #define PWGEM_DILEPTON_UTILS_EVENTMIXINGHANDLER_H_
 
 #include <map>
+#include <span>
 #include <utility>
 #include <vector>
 
 namespace o2::aod::pwgem::dilepton::utils
 {
+// Event pool for event mixing.
+// Each mixing bin (key T, e.g. <zbin, centbin, epbin, occbin>) gets a dense index at first use and owns a fixed-depth ring buffer of events.
+// The ring is stored twice in a row, so that the events of a bin are always contiguous in memory, ordered from the oldest to the newest.
+// Tracks (V) of each event (key U, e.g. pair<df index, global collision index>) live in slots of an arena, which are recycled when an event leaves the pool.
+// Accessors return spans to the internal storage: they are valid until the next call to AddTrackToEventPool or AddCollisionIdAtLast.
 template <typename T, typename U, typename V>
 class EventMixingHandler
 {
@@ -28,50 +34,131 @@ class EventMixingHandler
   EventMixingHandler()
   {
     fNdepth = 0;
-    fMapMixBins.clear();
-    fMap_Tracks_per_collision.clear();
   }
 
   explicit EventMixingHandler(int ndepth)
   {
     fNdepth = ndepth;
-    fMapMixBins.clear();
-    fMap_Tracks_per_collision.clear();
   }
 
-  ~EventMixingHandler()
-  {
-    fMapMixBins.clear();
-    fMap_Tracks_per_collision.clear();
-  }
+  ~EventMixingHandler() = default;
 
+  // only affects the mixing bins which are not used yet
   void SetNdepth(int ndepth) { fNdepth = ndepth; }
 
   void AddTrackToEventPool(U key_df_collision, V obj)
   {
-    fMap_Tracks_per_collision[key_df_collision].emplace_back(obj);
+    fSlotTracks[getSlot(key_df_collision)].emplace_back(obj);
+  }
+
+  std::span<const U> GetCollisionIdsFromEventPool(T key_bin) const
+  {
+    const Pool* pool = findPool(key_bin);
+    if (pool == nullptr) {
+      return {};
+    }
+    return std::span<const U>(pool->keys.data() + pool->first(), pool->nEvents);
+  }
+
+  std::span<const V> GetTracksPerCollision(T key_bin, int index) const
+  {
+    const Pool* pool = findPool(key_bin);
+    if (pool == nullptr || index < 0 || index >= pool->nEvents) {
+      return {};
+    }
+    return fSlotTracks[pool->slots[pool->first() + index]];
   }
 
-  std::vector<U> GetCollisionIdsFromEventPool(T key_bin) { return fMapMixBins[key_bin]; }
-  std::vector<V> GetTracksPerCollision(T key_bin, int index) { return fMap_Tracks_per_collision[fMapMixBins[key_bin][index]]; }
-  std::vector<V> GetTracksPerCollision(U key_df_collision) { return fMap_Tracks_per_collision[key_df_collision]; }
+  std::span<const V> GetTracksPerCollision(U key_df_collision) const
+  {
+    auto it = fSlotIndex.find(key_df_collision);
+    if (it == fSlotIndex.end()) {
+      return {};
+    }
+    return fSlotTracks[it->second];
+  }
 
   // call this function at the end of collision loop
   void AddCollisionIdAtLast(T key_bin, U key_df_collision)
   {
-    // LOGF(info, "fMapMixBins[key_bin].size() = %d", fMapMixBins[key_bin].size());
-    if (static_cast<int>(fMapMixBins[key_bin].size()) >= fNdepth) {
-      fMap_Tracks_per_collision[fMapMixBins[key_bin][0]].clear();
-      fMap_Tracks_per_collision[fMapMixBins[key_bin][0]].shrink_to_fit();
-      fMapMixBins[key_bin].erase(fMapMixBins[key_bin].begin());
+    const int slot = getSlot(key_df_collision);
+    Pool& pool = getPool(key_bin);
+    if (pool.depth <= 0) {
+      releaseSlot(key_df_collision, slot);
+      return;
+    }
+    if (pool.nEvents == pool.depth) { // the oldest event leaves the pool
+      releaseSlot(pool.keys[pool.next], pool.slots[pool.next]);
+    } else {
+      pool.nEvents++;
     }
-    fMapMixBins[key_bin].emplace_back(key_df_collision);
+    pool.keys[pool.next] = pool.keys[pool.next + pool.depth] = key_df_collision;
+    pool.slots[pool.next] = pool.slots[pool.next + pool.depth] = slot;
+    pool.next = (pool.next + 1) % pool.depth;
   }
 
  private:
-  int fNdepth;                                           // depth of event mixing
-  std::map<T, std::vector<U>> fMapMixBins;               // map : e.g. <zbin, centbin, epbin> -> pair<df index, global collision index>
-  std::map<U, std::vector<V>> fMap_Tracks_per_collision; // map : e.g. pair<df index, global collision index> -> track array
+  struct Pool {
+    int depth = 0;          // depth of the ring buffer
+    int nEvents = 0;        // number of events in the ring buffer
+    int next = 0;           // position of the next event to be written, i.e. of the oldest event if the ring is full
+    std::vector<U> keys;    // event keys, stored twice in a row
+    std::vector<int> slots; // arena slots of the events, stored twice in a row
+
+    int first() const { return (next - nEvents + depth) % depth; }
+  };
+
+  const Pool* findPool(const T& key_bin) const
+  {
+    auto it = fBinIndex.find(key_bin);
+    return it == fBinIndex.end() ? nullptr : &fPools[it->second];
+  }
+
+  Pool& getPool(const T& key_bin)
+  {
+    auto [it, inserted] = fBinIndex.try_emplace(key_bin, static_cast<int>(fPools.size()));
+    if (inserted) {
+      Pool& pool = fPools.emplace_back();
+      pool.depth = fNdepth;
+      if (pool.depth > 0) {
+        pool.keys.resize(2 * pool.depth);
+        pool.slots.resize(2 * pool.depth);
+      }
+    }
+    return fPools[it->second];
+  }
+
+  int getSlot(const U& key_df_collision)
+  {
+    auto it = fSlotIndex.find(key_df_collision);
+    if (it != fSlotIndex.end()) {
+      return it->second;
+    }
+    int slot = 0;
+    if (fFreeSlots.empty()) {
+      slot = static_cast<int>(fSlotTracks.size());
+      fSlotTracks.emplace_back();
+    } else {
+      slot = fFreeSlots.back();
+      fFreeSlots.pop_back();
+    }
+    fSlotIndex.emplace(key_df_collision, slot);
+    return slot;
+  }
+
+  void releaseSlot(const U& key_df_collision, int slot)
+  {
+    fSlotTracks[slot].clear(); // keep the capacity for the next event
+    fFreeSlots.emplace_back(slot);
+    fSlotIndex.erase(key_df_collision);
+  }
+
+  int fNdepth;                             // depth of event mixing
+  std::map<T, int> fBinIndex;              // map : e.g. <zbin, centbin, epbin, occbin> -> dense bin index
+  std::vector<Pool> fPools;                // event pool per dense bin index
+  std::map<U, int> fSlotIndex;             // map : e.g. pair<df index, global collision index> -> arena slot, only for events in use
+  std::vector<std::vector<V>> fSlotTracks; // arena : track array per slot
+  std::vector<int> fFreeSlots;             // arena slots ready to be reused
 };
 } // namespace o2::aod::pwgem::dilepton::utils
 #endif // PWGEM_DILEPTON_UTILS_EVENTMIXINGHANDLER_H_
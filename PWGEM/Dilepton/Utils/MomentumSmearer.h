@@ -15,6 +15,10 @@
 #ifndef PWGEM_DILEPTON_UTILS_MOMENTUMSMEARER_H_
 #define PWGEM_DILEPTON_UTILS_MOMENTUMSMEARER_H_
 
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <span>
 #include <vector>
 
 #include <TH1.h>
@@ -25,6 +29,7 @@
 #include <TGrid.h>
 #include <TFile.h>
 #include <TKey.h>
+#include <TRandom.h>
 
 #include "CCDB/BasicCCDBManager.h"
 #include "Framework/Logger.h"
@@ -35,6 +40,116 @@ using namespace o2;
 class MomentumSmearer
 {
  public:
+  /// Bin lookup on a histogram axis, clamped to the first and last bins; uniform axes are indexed without a search
+  struct AxisLookup {
+    int nBins = 1;
+    double min = 0.;
+    double max = 1.;
+    std::vector<double> edges; // only for variable binning
+
+    void set(const TAxis* axis)
+    {
+      nBins = axis->GetNbins();
+      min = axis->GetXmin();
+      max = axis->GetXmax();
+      edges.clear();
+      if (axis->GetXbins()->GetSize() > 0) {
+        edges.assign(axis->GetXbins()->GetArray(), axis->GetXbins()->GetArray() + nBins + 1);
+      }
+    }
+    /// \return 0-based bin
+    int findBin(double x) const
+    {
+      int bin = 0;
+      if (edges.empty()) {
+        bin = static_cast<int>(std::floor((x - min) / (max - min) * nBins));
+      } else {
+        bin = std::upper_bound(edges.begin(), edges.end(), x) - edges.begin() - 1;
+      }
+      return std::clamp(bin, 0, nBins - 1);
+    }
+  };
+
+  /// Normalised cumulative of the contents of a 1D or 3D histogram, tabulated once, sampled as TH1::GetRandom and
+  /// TH3::GetRandom3: linear interpolation along x within the selected bin, uniform along y and z
+  struct InverseCdf {
+    int dimension = 1;
+    int nBinsX = 1;
+    int nBinsY = 1;
+    std::vector<double> cumulative; // empty if the histogram has no content
+    std::vector<double> edgesX;
+    std::vector<double> edgesY;
+    std::vector<double> edgesZ;
+
+    void set(const TH1* hist)
+    {
+      dimension = hist->GetDimension();
+      nBinsX = hist->GetNbinsX();
+      nBinsY = hist->GetNbinsY();
+      const int nBinsZ = hist->GetNbinsZ();
+      cumulative.assign(nBinsX * nBinsY * nBinsZ + 1, 0.);
+      int iBin = 0;
+      for (int iz = 1; iz <= nBinsZ; iz++) {
+        for (int iy = 1; iy <= nBinsY; iy++) {
+          for (int ix = 1; ix <= nBinsX; ix++, iBin++) {
+            cumulative[iBin + 1] = cumulative[iBin] + hist->GetBinContent(ix, iy, iz);
+          }
+        }
+      }
+      if (!(cumulative.back() > 0.)) {
+        cumulative.clear();
+        return;
+      }
+      const double integral = cumulative.back();
+      for (auto& value : cumulative) {
+        value /= integral;
+      }
+      setEdges(hist->GetXaxis(), edgesX);
+      setEdges(hist->GetYaxis(), edgesY);
+      setEdges(hist->GetZaxis(), edgesZ);
+    }
+    bool empty() const { return cumulative.empty(); }
+
+    void sample(TRandom* rng, double& x, double& y, double& z) const
+    {
+      const double r1 = rng->Rndm();
+      const auto last = cumulative.end() - 1;
+      const int iBin = std::max(static_cast<int>(std::upper_bound(cumulative.begin(), last, r1) - cumulative.begin()) - 1, 0);
+      const int ix = iBin % nBinsX;
+      const int iy = (iBin / nBinsX) % nBinsY;
+      const int iz = iBin / (nBinsX * nBinsY);
+      x = edgesX[ix];
+      if (r1 > cumulative[iBin]) {
+        x += (edgesX[ix + 1] - edgesX[ix]) * (r1 - cumulative[iBin]) / (cumulative[iBin + 1] - cumulative[iBin]);
+      }
+      if (dimension == 3) {
+        y = edgesY[iy] + (edgesY[iy + 1] - edgesY[iy]) * rng->Rndm();
+        z = edgesZ[iz] + (edgesZ[iz + 1] - edgesZ[iz]) * rng->Rndm();
+      }
+    }
+    double sample(TRandom* rng) const
+    {
+      double x = 0., y = 0., z = 0.;
+      sample(rng, x, y, z);
+      return x;
+    }
+
+   private:
+    static void setEdges(const TAxis* axis, std::vector<double>& edges)
+    {
+      edges.resize(axis->GetNbins() + 1);
+      for (int i = 1; i <= axis->GetNbins() + 1; i++) {
+        edges[i - 1] = axis->GetBinLowEdge(i);
+      }
+    }
+  };
+
+  /// Resolution tables in bins of pt
+  struct ResoVsPt {
+    AxisLookup axisPt;
+    std::vector<InverseCdf> tables;
+  };
+
   /// Default constructor
   MomentumSmearer() = default;
 
@@ -128,12 +243,15 @@ class MomentumSmearer
     }
   }
 
-  void fillVecReso(TH2F* fReso, std::vector<TH1F*>& fVecReso)
+  void fillVecReso(TH2F* fReso, ResoVsPt& reso)
   {
     TAxis* axisPt = fReso->GetXaxis();
     int nBinsPt = axisPt->GetNbins();
+    reso.axisPt.set(axisPt);
+    reso.tables.resize(nBinsPt);
     for (int i = 1; i <= nBinsPt; i++) {
-      fVecReso.push_back(reinterpret_cast<TH1F*>(fReso->ProjectionY("", i, i)));
+      std::unique_ptr<TH1D> projection(fReso->ProjectionY(Form("%s_py%d", fReso->GetName(), i), i, i));
+      reso.tables[i - 1].set(projection.get());
     }
   }
 
@@ -146,13 +264,11 @@ class MomentumSmearer
     fNPhiBins = hs_reso->GetAxis(3)->GetNbins();
     fNChBins = hs_reso->GetAxis(4)->GetNbins();
     LOGF(info, "ncen = %d, npt = %d, neta = %d, nphi = %d, nch = %d without under- and overflow bins", fNCenBins, fNPtBins, fNEtaBins, fNPhiBins, fNChBins);
-    // fVecResoND.reserve(npt * neta * nphi * nch);
-
-    fVecResoND.resize(fNCenBins, std::vector<std::vector<std::vector<std::vector<TH3D*>>>>(fNPtBins, std::vector<std::vector<std::vector<TH3D*>>>(fNEtaBins, std::vector<std::vector<TH3D*>>(fNPhiBins, std::vector<TH3D*>(fNChBins)))));
-    // fVecResoND.resize(fNPtBins, std::vector<std::vector<std::vector<TH3D*>>>(fNEtaBins, std::vector<std::vector<TH3D*>>(fNPhiBins, std::vector<TH3D*>(fNChBins))));
-    //  auto h3 = reinterpret_cast<TH3D*>(hs_reso->Projection(4, 5, 6));
-    //  h3->SetName(Form("h3reso_pt%d_eta%d_phi%d_ch%d", 0, 0, 0, 0));
-    //  fVecResoND[0][0][0][0] = h3;
+    for (int iAxis = 0; iAxis < 5; iAxis++) {
+      fAxesResoND[iAxis].set(hs_reso->GetAxis(iAxis));
+    }
+    fTablesResoND.clear();
+    fTablesResoND.resize(fNCenBins * fNPtBins * fNEtaBins * fNPhiBins * fNChBins);
 
     for (int icen = 0; icen < fNCenBins; icen++) {
       hs_reso->GetAxis(0)->SetRange(icen + 1, icen + 1);
@@ -167,10 +283,10 @@ class MomentumSmearer
                 continue;
               }
               hs_reso->GetAxis(4)->SetRange(ich + 1, ich + 1);
-              auto h3 = reinterpret_cast<TH3D*>(hs_reso->Projection(5, 6, 7));
+              std::unique_ptr<TH3D> h3(reinterpret_cast<TH3D*>(hs_reso->Projection(5, 6, 7)));
               h3->SetName(Form("h3reso_cen%d_pt%d_eta%d_phi%d_ch%d", icen, ipt, ieta, iphi, ich));
               h3->Scale(1.f, "width"); // convert ntrack to probability density
-              fVecResoND[icen][ipt][ieta][iphi][ich] = h3;
+              fTablesResoND[indexResoND(icen, ipt, ieta, iphi, ich)].set(h3.get());
             } // end of charge loop
           } // end of phi loop
         } // end of eta loop
@@ -252,10 +368,10 @@ class MomentumSmearer
         if (!fResoPhi_Neg) {
           LOGP(fatal, "Could not open {} from file {}", fResPhiNegHistName.Data(), fResFileName.Data());
         }
-        fillVecReso(fResoPt, fVecResoPt);
-        fillVecReso(fResoEta, fVecResoEta);
-        fillVecReso(fResoPhi_Pos, fVecResoPhi_Pos);
-        fillVecReso(fResoPhi_Neg, fVecResoPhi_Neg);
+        fillVecReso(fResoPt, fTablesResoPt);
+        fillVecReso(fResoEta, fTablesResoEta);
+        fillVecReso(fResoPhi_Pos, fTablesResoPhi_Pos);
+        fillVecReso(fResoPhi_Neg, fTablesResoPhi_Neg);
       }
     }
 
@@ -356,7 +472,7 @@ class MomentumSmearer
       if (!fDCA) {
         LOGP(fatal, "Could not open {} from file {}", fDCAHistName.Data(), fDCAFileName.Data());
       }
-      fillVecReso(fDCA, fVecDCA);
+      fillVecReso(fDCA, fTablesDCA);
     }
 
     if (!fFromCcdb) {
@@ -366,26 +482,18 @@ class MomentumSmearer
     fInitialized = true;
   }
 
-  void applySmearing(const float ptgen, const float vargen, const float multiply, float& varsmeared, TH2F* fReso, std::vector<TH1F*>& fVecReso)
+  void applySmearing(const float ptgen, const float vargen, const float multiply, float& varsmeared, const ResoVsPt& reso, TRandom* rng)
   {
     float ptgen_tmp = ptgen > fMinPtGen ? ptgen : fMinPtGen;
-    TAxis* axisPt = fReso->GetXaxis();
-    int nBinsPt = axisPt->GetNbins();
-    int ptbin = axisPt->FindBin(ptgen_tmp);
-    if (ptbin < 1) {
-      ptbin = 1;
-    }
-    if (ptbin > nBinsPt) {
-      ptbin = nBinsPt;
-    }
+    const auto& table = reso.tables[reso.axisPt.findBin(ptgen_tmp)];
     float smearing = 0.;
-    if (fVecReso[ptbin - 1]->GetEntries() > 0) {
-      smearing = fVecReso[ptbin - 1]->GetRandom() * multiply;
+    if (!table.empty()) {
+      smearing = table.sample(rng) * multiply;
     }
     varsmeared = vargen - smearing;
   }
 
-  void applySmearing(const float centrality, const int ch, const float ptgen, const float etagen, const float phigen, float& ptsmeared, float& etasmeared, float& phismeared)
+  void applySmearing(const float centrality, const int ch, const float ptgen, const float etagen, const float phigen, float& ptsmeared, float& etasmeared, float& phismeared, TRandom* rng = gRandom)
   {
     if (fResType == 0) {
       ptsmeared = ptgen;
@@ -401,65 +509,40 @@ class MomentumSmearer
         phismeared = phigen;
         return;
       }
-      applySmearingND(centrality, ch, ptgen, etagen, phigen, ptsmeared, etasmeared, phismeared);
+      applySmearingND(centrality, ch, ptgen, etagen, phigen, ptsmeared, etasmeared, phismeared, rng);
     } else {
-      applySmearing(ptgen, ptgen, ptgen, ptsmeared, fResoPt, fVecResoPt);
-      applySmearing(ptgen, etagen, 1., etasmeared, fResoEta, fVecResoEta);
+      applySmearing(ptgen, ptgen, ptgen, ptsmeared, fTablesResoPt, rng);
+      applySmearing(ptgen, etagen, 1., etasmeared, fTablesResoEta, rng);
       if (ch > 0) {
-        applySmearing(ptgen, phigen, 1., phismeared, fResoPhi_Pos, fVecResoPhi_Pos);
+        applySmearing(ptgen, phigen, 1., phismeared, fTablesResoPhi_Pos, rng);
       } else {
-        applySmearing(ptgen, phigen, 1., phismeared, fResoPhi_Neg, fVecResoPhi_Neg);
+        applySmearing(ptgen, phigen, 1., phismeared, fTablesResoPhi_Neg, rng);
       }
     }
   }
 
-  void applySmearingND(const float centrality, const int ch, const float ptgen, const float etagen, const float phigen, float& ptsmeared, float& etasmeared, float& phismeared)
+  /// Smear a batch of legs of a collision with a random generator owned by the caller
+  void applySmearing(const float centrality, std::span<const int> ch, std::span<const float> ptgen, std::span<const float> etagen, std::span<const float> phigen, std::span<float> ptsmeared, std::span<float> etasmeared, std::span<float> phismeared, TRandom* rng)
   {
-    float ptgen_tmp = ptgen > fMinPtGen ? ptgen : fMinPtGen;
-    int cenbin = fResoND->GetAxis(0)->FindBin(centrality);
-    int ptbin = fResoND->GetAxis(1)->FindBin(ptgen_tmp);
-    int etabin = fResoND->GetAxis(2)->FindBin(etagen);
-    int phibin = fResoND->GetAxis(3)->FindBin(phigen);
-    int chbin = fResoND->GetAxis(4)->FindBin(ch);
-
-    // protection
-    if (cenbin < 1) {
-      cenbin = 1;
-    } else if (cenbin > fNCenBins) {
-      cenbin = fNCenBins;
-    }
-
-    // protection
-    if (ptbin < 1) {
-      ptbin = 1;
-    } else if (ptbin > fNPtBins) {
-      ptbin = fNPtBins;
-    }
-
-    // protection
-    if (etabin < 1) {
-      etabin = 1;
-    } else if (etabin > fNEtaBins) {
-      etabin = fNEtaBins;
-    }
-
-    // protection
-    if (phibin < 1) {
-      phibin = 1;
-    } else if (phibin > fNPhiBins) {
-      phibin = fNPhiBins;
+    for (std::size_t i = 0; i < ptgen.size(); i++) {
+      applySmearing(centrality, ch[i], ptgen[i], etagen[i], phigen[i], ptsmeared[i], etasmeared[i], phismeared[i], rng);
     }
+  }
 
-    // protection
-    if (chbin < 1) {
-      chbin = 1;
-    } else if (chbin > fNChBins) {
-      chbin = fNChBins;
-    }
+  void applySmearingND(const float centrality, const int ch, const float ptgen, const float etagen, const float phigen, float& ptsmeared, float& etasmeared, float& phismeared, TRandom* rng = gRandom)
+  {
+    float ptgen_tmp = ptgen > fMinPtGen ? ptgen : fMinPtGen;
+    // bins clamped to the first and last ones
+    int cenbin = fAxesResoND[0].findBin(centrality);
+    int ptbin = fAxesResoND[1].findBin(ptgen_tmp);
+    int etabin = fAxesResoND[2].findBin(etagen);
+    int phibin = fAxesResoND[3].findBin(phigen);
+    int chbin = fAxesResoND[4].findBin(ch);
 
     double dpt_rel = 0, deta = 0, dphi = 0;
-    if (fVecResoND[cenbin - 1][ptbin - 1][etabin - 1][phibin - 1][chbin - 1]->GetEntries() > 0) {
-      fVecResoND[cenbin - 1][ptbin - 1][etabin - 1][phibin - 1][chbin - 1]->GetRandom3(dpt_rel, deta, dphi);
+    const auto& table = fTablesResoND[indexResoND(cenbin, ptbin, etabin, phibin, chbin)];
+    if (!table.empty()) {
+      table.sample(rng, dpt_rel, deta, dphi);
     }
     ptsmeared = ptgen - dpt_rel * ptgen;
     etasmeared = etagen - deta;
@@ -531,24 +614,16 @@ class MomentumSmearer
     return 1.;
   }
 
-  float getDCA(float ptsmeared)
+  float getDCA(float ptsmeared, TRandom* rng = gRandom)
   {
     if (fDCAType == 0) {
       return 0.;
     }
 
-    TAxis* axisPt = fDCA->GetXaxis();
-    int nBinsPt = axisPt->GetNbins();
-    int ptbin = axisPt->FindBin(ptsmeared);
-    if (ptbin < 1) {
-      ptbin = 1;
-    }
-    if (ptbin > nBinsPt) {
-      ptbin = nBinsPt;
-    }
+    const auto& table = fTablesDCA.tables[fTablesDCA.axisPt.findBin(ptsmeared)];
     float dca = 0.;
-    if (fVecDCA[ptbin - 1]->GetEntries() > 0) {
-      dca = fVecDCA[ptbin - 1]->GetRandom();
+    if (!table.empty()) {
+      dca = table.sample(rng);
     }
     return dca;
   }
@@ -622,23 +697,29 @@ class MomentumSmearer
   TH2F* fResoEta;
   TH2F* fResoPhi_Pos;
   TH2F* fResoPhi_Neg;
-  std::vector<std::vector<std::vector<std::vector<std::vector<TH3D*>>>>> fVecResoND;
+  AxisLookup fAxesResoND[5];              // centrality, pt, eta, phi, charge
+  std::vector<InverseCdf> fTablesResoND; // (dpt/pt, deta, dphi) per (centrality, pt, eta, phi, charge) bin, see indexResoND()
   int fNCenBins = 1;
   int fNPtBins = 1;
   int fNEtaBins = 1;
   int fNPhiBins = 1;
   int fNChBins = 1;
-  std::vector<TH1F*> fVecResoPt;
-  std::vector<TH1F*> fVecResoEta;
-  std::vector<TH1F*> fVecResoPhi_Pos;
-  std::vector<TH1F*> fVecResoPhi_Neg;
+  ResoVsPt fTablesResoPt;
+  ResoVsPt fTablesResoEta;
+  ResoVsPt fTablesResoPhi_Pos;
+  ResoVsPt fTablesResoPhi_Neg;
   TObject* fEff;
   TH2F* fDCA;
-  std::vector<TH1F*> fVecDCA;
+  ResoVsPt fTablesDCA;
   int64_t fTimestamp;
   bool fFromCcdb = false;
   Service<ccdb::BasicCCDBManager> fCcdb;
   float fMinPtGen = -1.f;
+
+  int indexResoND(int icen, int ipt, int ieta, int iphi, int ich) const
+  {
+    return (((icen * fNPtBins + ipt) * fNEtaBins + ieta) * fNPhiBins + iphi) * fNChBins + ich;
+  }
 };
 
 #endif // PWGEM_DILEPTON_UTILS_MOMENTUMSMEARER_H_
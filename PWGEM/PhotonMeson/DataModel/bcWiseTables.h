@@ -20,6 +20,7 @@
 #define PWGEM_PHOTONMESON_DATAMODEL_BCWISETABLES_H_
 
 #include <limits>
+#include <vector>
 
 #include "Framework/AnalysisDataModel.h"
 
@@ -41,6 +42,8 @@ enum Observable {
   kFT0Amp,
   kpT,
   kMu,
+  kCellEnergy,
+  kCellTime,
   nObservables
 };
 
@@ -57,7 +60,9 @@ const float downscalingFactors[nObservables]{
   1E3,  // Z-vertex position
   1E-1, // FT0M amplitude
   1E3,  // MC pi0 pt
-  1E5}; // Mu
+  1E5,  // Mu
+  1E3,  // Cell energy
+  1E1}; // Cell time
 } // namespace emdownscaling
 
 namespace bcwisebc
@@ -121,6 +126,36 @@ DECLARE_SOA_TABLE(BCWiseClusters, "AOD", "BCWISECLUSTER", //! table of skimmed E
                   bcwisecluster::Definition<bcwisecluster::StoredDefinition>, bcwisecluster::E<bcwisecluster::StoredE>, bcwisecluster::Eta<bcwisecluster::StoredEta>, bcwisecluster::Phi<bcwisecluster::StoredPhi>, bcwisecluster::NCells<bcwisecluster::StoredNCells>, bcwisecluster::M02<bcwisecluster::StoredM02>, bcwisecluster::Time<bcwisecluster::StoredTime>, bcwisecluster::IsExotic<bcwisecluster::StoredIsExotic>,
                   bcwisecluster::Pt<bcwisecluster::StoredE, bcwisecluster::StoredEta>);
 
+namespace bcwisecell
+{
+DECLARE_SOA_COLUMN(StoredCellIDDelta, storedCellIDDelta, uint16_t); //! difference of the absolute cell ID to the one of the previous cell in the BC (cells sorted by ID), the first cell of the BC stores its absolute ID
+DECLARE_SOA_COLUMN(StoredE, storedE, uint16_t);                     //! cell energy (1 MeV -> Maximum cell energy of ~65 GeV)
+DECLARE_SOA_COLUMN(StoredTime, storedTime, int16_t);                //! cell time (100 ps resolution)
+
+DECLARE_SOA_DYNAMIC_COLUMN(E, e, [](uint16_t storedE) -> float { return std::nextafter(storedE / emdownscaling::downscalingFactors[emdownscaling::kCellEnergy], std::numeric_limits<float>::infinity()); });      //! cell energy (GeV)
+DECLARE_SOA_DYNAMIC_COLUMN(Time, time, [](int16_t storedTime) -> float { return std::nextafter(storedTime / emdownscaling::downscalingFactors[emdownscaling::kCellTime], std::numeric_limits<float>::infinity()); }); //! cell time (ns)
+} // namespace bcwisecell
+
+DECLARE_SOA_TABLE(BCWiseCells, "AOD", "BCWISECELL", //! table of skimmed EMCal cells, sorted by BC and cell ID in the BC
+                  o2::soa::Index<>, BCWiseBCId, bcwisecell::StoredCellIDDelta, bcwisecell::StoredE, bcwisecell::StoredTime,
+                  bcwisecell::E<bcwisecell::StoredE>, bcwisecell::Time<bcwisecell::StoredTime>);
+
+namespace bcwisecell
+{
+/// \brief Absolute cell IDs of the cells of a BC (a slice of BCWiseCells), decoded from the stored differences
+template <typename TCells>
+void decodeCellIDs(TCells const& cellsInBC, std::vector<int>& cellIDs)
+{
+  cellIDs.clear();
+  cellIDs.reserve(cellsInBC.size());
+  int cellID = 0;
+  for (const auto& cell : cellsInBC) {
+    cellID += cell.storedCellIDDelta();
+    cellIDs.push_back(cellID);
+  }
+}
+} // namespace bcwisecell
+
 namespace bcwisemcpi0s
 {
 DECLARE_SOA_COLUMN(StoredPt, storedPt, uint16_t); //! Transverse momentum of generated pi0 (1 MeV -> Maximum pi0 pT of ~65 GeV)
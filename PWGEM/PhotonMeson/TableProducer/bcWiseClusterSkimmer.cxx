@@ -17,9 +17,11 @@
 ///
 
 #include <limits>
+#include <algorithm>
 #include <vector>
 #include <map>
 #include <string>
+#include <tuple>
 
 #include "Framework/runDataProcessing.h"
 #include "Framework/AnalysisTask.h"
@@ -54,6 +56,7 @@ using SelectedCells = o2::soa::Filtered<aod::Calos>;
 struct bcWiseClusterSkimmer {
   Produces<aod::BCWiseBCs> bcTable;
   Produces<aod::BCWiseClusters> clusterTable;
+  Produces<aod::BCWiseCells> cellTable;
   Produces<aod::BCWiseCollisions> collisionTable;
   Produces<aod::BCWiseMCPi0s> mcpi0Table;
   Produces<aod::BCWiseMCClusters> mcclusterTable;
@@ -74,6 +77,7 @@ struct bcWiseClusterSkimmer {
 
   Configurable<bool> cfgRequirekTVXinEMC{"cfgRequirekTVXinEMC", false, "Only store kTVXinEMC triggered BCs"};
   Configurable<bool> cfgRequireGoodRCTQuality{"cfgRequireGoodRCTQuality", false, "Only store BCs with good quality of T0 and EMC in RCT"};
+  Configurable<bool> cfgStoreCells{"cfgStoreCells", false, "Store the EMCal cells of the selected BCs, with their IDs encoded as differences to the previous cell of the BC"};
   Configurable<bool> cfgStoreMu{"cfgStoreMu", false, "Calculate and store mu (probablity of a TVX collision in the BC) per BC. Otherwise fill with 0"};
   ConfigurableAxis cfgMultiplicityBinning{"cfgMultiplicityBinning", {1000, 0, 10000}, "Binning used for the binning of the number of particles in the event"};
 
@@ -90,6 +94,7 @@ struct bcWiseClusterSkimmer {
   HistogramRegistry mHistManager{"output", {}, OutputObjHandlingPolicy::AnalysisObject, false, false};
 
   std::map<int32_t, int32_t> fMapPi0Index; // Map to connect the MC index of the pi0 to the one saved in the derived table
+  std::vector<std::tuple<int, float, float>> fCellsInBC; // (cell ID, energy, time) of the cells of the current BC
 
   void init(o2::framework::InitContext&)
   {
@@ -132,6 +137,25 @@ struct bcWiseClusterSkimmer {
     return static_cast<OutputType>(valueToBeChecked);
   }
 
+  /// \brief Store the EMCal cells of a BC, sorted by cell ID, with the IDs as differences to the previous cell
+  template <typename Cells>
+  void processCells(Cells const& cells, const int bcID)
+  {
+    fCellsInBC.clear();
+    for (const auto& cell : cells) {
+      fCellsInBC.emplace_back(cell.cellNumber(), cell.amplitude(), cell.time());
+    }
+    std::sort(fCellsInBC.begin(), fCellsInBC.end(), [](const auto& a, const auto& b) { return std::get<0>(a) < std::get<0>(b); });
+    int previousCellID = 0;
+    for (const auto& [cellID, amplitude, time] : fCellsInBC) {
+      cellTable(bcID,
+                static_cast<uint16_t>(cellID - previousCellID),
+                convertForStorage<uint16_t>(amplitude, kCellEnergy),
+                convertForStorage<int16_t>(time, kCellTime));
+      previousCellID = cellID;
+    }
+  }
+
   /// \brief Process EMCAL clusters (either ambigous or unique)
   template <typename Clusters>
   void processClusters(Clusters const& clusters, const int bcID)
@@ -289,6 +313,9 @@ struct bcWiseClusterSkimmer {
       auto cellsInBC = cells.sliceBy(cellsPerBC, bc.globalIndex());
 
       processEventProperties(bc, collisionsInBC, cellsInBC);
+      if (cfgStoreCells) {
+        processCells(cellsInBC, bcTable.lastIndex());
+      }
 
       if (collisionsInBC.size() == 1) {
         auto clustersInBC = uClusters.sliceBy(perCol, collisionsInBC.begin().globalIndex());
@@ -313,6 +340,9 @@ struct bcWiseClusterSkimmer {
       auto cellsInBC = cells.sliceBy(cellsPerBC, bc.globalIndex());
 
       processEventProperties(bc, collisionsInBC, cellsInBC);
+      if (cfgStoreCells) {
+        processCells(cellsInBC, bcTable.lastIndex());
+      }
 
       auto mcCollisionsBC = mcCollisions.sliceBy(mcCollperBC, bc.globalIndex());
       for (const auto& mcCollision : mcCollisionsBC) {
@@ -18,10 +18,12 @@
 #include <cmath>
 #include <array>
 #include <cstdlib>
-#include <map>
 #include <iterator>
+#include <limits>
+#include <numeric>
 #include <utility>
 #include <string>
+#include <tuple>
 #include <set>
 #include <algorithm>
 #include <vector>
@@ -371,6 +373,45 @@ struct PhotonConversionBuilder {
            shiftedtrack.getX(), shiftedtrack.getY(), shiftedtrack.getZ(), shiftedtrack.getTgl());
   }
 
+  // V0 leg propagated to the collision of the V0, computed once per (track, collision) and shared by all the V0 candidates using the track
+  struct V0Leg {
+    int64_t collisionId = -1;
+    int pdg = 0;
+    bool isOK = false;
+    o2::track::TrackParCov track;
+    float dcaXY = 0.f;
+    float dcaZ = 0.f;
+    KFParticle kfp;
+  };
+  std::vector<V0Leg> v0LegCache; // indexed by track global index, sized at the beginning of each DF
+
+  template <class TBCs, class TCollisions, typename TCollision, typename TTrack>
+  const V0Leg& getV0Leg(TCollision const& collision, TTrack const& track, const int pdg)
+  {
+    auto& leg = v0LegCache[track.globalIndex()];
+    if (leg.collisionId == collision.globalIndex() && leg.pdg == pdg) {
+      return leg;
+    }
+    leg.collisionId = collision.globalIndex();
+    leg.pdg = pdg;
+    leg.isOK = false;
+    leg.track = getTrackParCov(track);
+    if (moveTPCTracks && isTPConlyTrack(track) && !mVDriftMgr.moveTPCTrack<TBCs, TCollisions>(collision, track, leg.track)) {
+      LOGP(error, "failed correction for {} tpc track", pdg < 0 ? "positive" : "negative");
+      return leg;
+    }
+    std::array<float, 2> dcaInfo;
+    auto trackC = leg.track;
+    trackC.setPID(o2::track::PID::Electron);
+    o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackC, 2.f, matCorr, &dcaInfo);
+    leg.dcaXY = dcaInfo[0];
+    leg.dcaZ = dcaInfo[1];
+    KFPTrack kfp_track = createKFPTrackFromTrackParCov(leg.track, track.sign(), track.tpcNClsFound(), track.tpcChi2NCl());
+    leg.kfp = KFParticle(kfp_track, pdg);
+    leg.isOK = true;
+    return leg;
+  }
+
   template <bool isMC, class TBCs, class TCollisions, class TTracks, typename TV0>
   void fillV0Table(TV0 const& v0, const bool filltable)
   {
@@ -412,29 +453,20 @@ struct PhotonConversionBuilder {
     // }
 
     // Calculate DCA with respect to the collision associated to the v0, not individual tracks
-    std::array<float, 2> dcaInfo;
-
-    auto pTrack = getTrackParCov(pos);
-    if (moveTPCTracks && isTPConlyTrack(pos) && !mVDriftMgr.moveTPCTrack<TBCs, TCollisions>(collision, pos, pTrack)) {
-      LOGP(error, "failed correction for positive tpc track");
+    const auto& posLeg = getV0Leg<TBCs, TCollisions>(collision, pos, -11);
+    if (!posLeg.isOK) {
       return;
     }
-    auto pTrackC = pTrack;
-    pTrackC.setPID(o2::track::PID::Electron);
-    o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, pTrackC, 2.f, matCorr, &dcaInfo);
-    auto posdcaXY = dcaInfo[0];
-    auto posdcaZ = dcaInfo[1];
-
-    auto nTrack = getTrackParCov(ele);
-    if (moveTPCTracks && isTPConlyTrack(ele) && !mVDriftMgr.moveTPCTrack<TBCs, TCollisions>(collision, ele, nTrack)) {
-      LOGP(error, "failed correction for negative tpc track");
+    const auto& eleLeg = getV0Leg<TBCs, TCollisions>(collision, ele, 11);
+    if (!eleLeg.isOK) {
       return;
     }
-    auto nTrackC = nTrack;
-    nTrackC.setPID(o2::track::PID::Electron);
-    o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, nTrackC, 2.f, matCorr, &dcaInfo);
-    auto eledcaXY = dcaInfo[0];
-    auto eledcaZ = dcaInfo[1];
+    auto pTrack = posLeg.track;
+    auto nTrack = eleLeg.track;
+    auto posdcaXY = posLeg.dcaXY;
+    auto posdcaZ = posLeg.dcaZ;
+    auto eledcaXY = eleLeg.dcaXY;
+    auto eledcaZ = eleLeg.dcaZ;
 
     if (std::fabs(posdcaXY) < dcapostopv || std::fabs(eledcaXY) < dcanegtopv) {
       return;
@@ -450,10 +482,8 @@ struct PhotonConversionBuilder {
       return; // RZ line cut
     }
 
-    KFPTrack kfp_track_pos = createKFPTrackFromTrackParCov(pTrack, pos.sign(), pos.tpcNClsFound(), pos.tpcChi2NCl());
-    KFPTrack kfp_track_ele = createKFPTrackFromTrackParCov(nTrack, ele.sign(), ele.tpcNClsFound(), ele.tpcChi2NCl());
-    KFParticle kfp_pos(kfp_track_pos, -11);
-    KFParticle kfp_ele(kfp_track_ele, 11);
+    const KFParticle& kfp_pos = posLeg.kfp;
+    const KFParticle& kfp_ele = eleLeg.kfp;
     const KFParticle* GammaDaughters[2] = {&kfp_pos, &kfp_ele};
 
     KFParticle gammaKF;
@@ -611,8 +641,9 @@ struct PhotonConversionBuilder {
     if (!checkAP(alpha, qt, max_alpha_ap, max_qt_ap)) { // store only photon conversions
       return;
     }
-    pca_map[std::make_tuple(v0.globalIndex(), collision.globalIndex(), pos.globalIndex(), ele.globalIndex())] = pca_kf;
-    cospa_map[std::make_tuple(v0.globalIndex(), collision.globalIndex(), pos.globalIndex(), ele.globalIndex())] = cospa_kf;
+    if (!filltable) {
+      v0Candidates.emplace_back(V0Candidate{v0.globalIndex(), collision.globalIndex(), pos.globalIndex(), ele.globalIndex(), pca_kf, cospa_kf});
+    }
 
     if (filltable) {
       registry.fill(HIST("V0/hAP"), alpha, qt);
@@ -673,15 +704,26 @@ struct PhotonConversionBuilder {
   }
 
   Preslice<aod::V0s> perCollision = o2::aod::v0::collisionId;
-  std::map<std::tuple<int64_t, int64_t, int64_t, int64_t>, float> pca_map;      // (v0.globalIndex(), collision.globalIndex(), pos.globalIndex(), ele.globalIndex()) -> pca
-  std::map<std::tuple<int64_t, int64_t, int64_t, int64_t>, float> cospa_map;    // (v0.globalIndex(), collision.globalIndex(), pos.globalIndex(), ele.globalIndex()) -> cospa
-  std::vector<std::pair<int64_t, int64_t>> stored_v0Ids;                        // (pos.globalIndex(), ele.globalIndex())
+  struct V0Candidate {
+    int64_t v0Id;
+    int64_t collisionId;
+    int64_t posId;
+    int64_t eleId;
+    float pca;
+    float cospa;
+  };
+  std::vector<V0Candidate> v0Candidates;                                        // photon candidates of the DF passing all the cuts
+  std::vector<float> minPcaPerPos;                                              // per track: minimal pca of the candidates with the track as positive leg
+  std::vector<float> minPcaPerEle;                                              // per track: minimal pca of the candidates with the track as negative leg
+  std::vector<int> candidatesByLegs;                                            // candidate indices sorted by (pos, ele, v0)
+  std::vector<bool> isAcceptedCandidate;                                        // per candidate
   std::vector<std::tuple<int64_t, int64_t, int64_t, int64_t>> stored_fullv0Ids; // (v0.globalIndex(), collision.globalIndex(), pos.globalIndex(), ele.globalIndex())
   std::unordered_map<int64_t, int> nv0_map;                                     // map collisionId -> nv0
 
   template <bool isMC, bool isTriggerAnalysis, bool enableFilter, typename TCollisions, typename TV0s, typename TTracks, typename TBCs>
-  void build(TCollisions const& collisions, TV0s const& v0s, TTracks const&, TBCs const&)
+  void build(TCollisions const& collisions, TV0s const& v0s, TTracks const& tracks, TBCs const&)
   {
+    v0LegCache.assign(tracks.size(), V0Leg{});
     for (const auto& collision : collisions) {
       if constexpr (isMC) {
         if (!collision.has_mcCollision()) {
@@ -715,60 +757,55 @@ struct PhotonConversionBuilder {
       } // end of v0 loop
     } // end of collision loop
 
-    stored_v0Ids.reserve(pca_map.size());     // number of photon candidates per DF
-    stored_fullv0Ids.reserve(pca_map.size()); // number of photon candidates per DF
-
-    // find minimal pca
-    for (const auto& [key, value] : pca_map) {
-      auto v0Id = std::get<0>(key);
-      auto collisionId = std::get<1>(key);
-      auto posId = std::get<2>(key);
-      auto eleId = std::get<3>(key);
-      float v0pca = value;
-      float cospa = cospa_map[key];
-      bool is_closest_v0 = true;
-      bool is_most_aligned_v0 = true;
-
-      for (const auto& [key_tmp, value_tmp] : pca_map) {
-        auto v0Id_tmp = std::get<0>(key_tmp);
-        auto collisionId_tmp = std::get<1>(key_tmp);
-        auto posId_tmp = std::get<2>(key_tmp);
-        auto eleId_tmp = std::get<3>(key_tmp);
-        float v0pca_tmp = value_tmp;
-        float cospa_tmp = cospa_map[key_tmp];
-
-        if (v0Id == v0Id_tmp) { // skip exactly the same v0
-          continue;
-        }
-
-        if (collisionId != collisionId_tmp && eleId == eleId_tmp && posId == posId_tmp && cospa < cospa_tmp) { // same ele and pos, but attached to different collision
-          // LOGF(info, "!reject! | collision id = %d | posid1 = %d , eleid1 = %d , posid2 = %d , eleid2 = %d , cospa1 = %f , cospa2 = %f", collisionId, posId, eleId, posId_tmp, eleId_tmp, cospa, cospa_tmp);
-          is_most_aligned_v0 = false;
-          break;
+    // Among the candidates sharing a leg, only the one with the minimal pca is kept, and among the candidates with the same
+    // legs attached to different collisions, only the most aligned one. The first accepted candidate of each pair of legs is stored.
+    std::sort(v0Candidates.begin(), v0Candidates.end(), [](const V0Candidate& a, const V0Candidate& b) { return a.v0Id < b.v0Id; });
+    const int nCandidates = v0Candidates.size();
+    minPcaPerPos.assign(tracks.size(), std::numeric_limits<float>::max());
+    minPcaPerEle.assign(tracks.size(), std::numeric_limits<float>::max());
+    for (const auto& candidate : v0Candidates) {
+      minPcaPerPos[candidate.posId] = std::min(minPcaPerPos[candidate.posId], candidate.pca);
+      minPcaPerEle[candidate.eleId] = std::min(minPcaPerEle[candidate.eleId], candidate.pca);
+    }
+    isAcceptedCandidate.assign(nCandidates, false);
+    candidatesByLegs.resize(nCandidates);
+    std::iota(candidatesByLegs.begin(), candidatesByLegs.end(), 0);
+    std::sort(candidatesByLegs.begin(), candidatesByLegs.end(), [this](int a, int b) {
+      const auto& ca = v0Candidates[a];
+      const auto& cb = v0Candidates[b];
+      return std::tie(ca.posId, ca.eleId, ca.v0Id) < std::tie(cb.posId, cb.eleId, cb.v0Id);
+    });
+    for (int begin = 0; begin < nCandidates;) {
+      const auto& first = v0Candidates[candidatesByLegs[begin]];
+      int end = begin + 1;
+      while (end < nCandidates && v0Candidates[candidatesByLegs[end]].posId == first.posId && v0Candidates[candidatesByLegs[end]].eleId == first.eleId) {
+        end++;
+      }
+      for (int i = begin; i < end; i++) { // candidates with the same legs, in increasing v0 index
+        const auto& candidate = v0Candidates[candidatesByLegs[i]];
+        bool is_closest_v0 = !(candidate.pca > minPcaPerPos[candidate.posId]) && !(candidate.pca > minPcaPerEle[candidate.eleId]);
+        bool is_most_aligned_v0 = true;
+        for (int j = begin; j < end && is_most_aligned_v0; j++) {
+          const auto& other = v0Candidates[candidatesByLegs[j]];
+          if (other.collisionId != candidate.collisionId && candidate.cospa < other.cospa) { // same ele and pos, but attached to different collision
+            is_most_aligned_v0 = false;
+          }
         }
-
-        if ((eleId == eleId_tmp || posId == posId_tmp) && v0pca > v0pca_tmp) {
-          // LOGF(info, "!reject! | collision id = %d | posid1 = %d , eleid1 = %d , posid2 = %d , eleid2 = %d , pca1 = %f , pca2 = %f", collisionId, posId, eleId, posId_tmp, eleId_tmp, v0pca, v0pca_tmp);
-          is_closest_v0 = false;
-          break;
+        if (is_closest_v0 && is_most_aligned_v0) {
+          isAcceptedCandidate[candidatesByLegs[i]] = true;
+          break; // the legs are stored with this candidate
         }
-      } // end of pca_map tmp loop
-
-      bool is_stored = std::find(stored_v0Ids.begin(), stored_v0Ids.end(), std::make_pair(posId, eleId)) != stored_v0Ids.end();
-      if (is_closest_v0 && is_most_aligned_v0 && !is_stored) {
-        // auto v0 = v0s.rawIteratorAt(v0Id);
-        // auto collision = collisions.rawIteratorAt(collisionId);
-        // auto pos = tracks.rawIteratorAt(posId);
-        // auto ele = tracks.rawIteratorAt(eleId);
-        // LOGF(info, "!accept! | collision id = %d | v0id1 = %d , posid1 = %d , eleid1 = %d , pca1 = %f , cospa = %f", collisionId, v0Id, posId, eleId, v0pca, cospa);
-
-        // fillV0Table<isMC, TCollisions, TTracks>(v0, true);
-        stored_v0Ids.emplace_back(std::make_pair(posId, eleId));
-        stored_fullv0Ids.emplace_back(std::make_tuple(v0Id, collisionId, posId, eleId));
-        nv0_map[collisionId]++;
       }
-    } // end of pca_map loop
-    // LOGF(info, "pca_map.size() = %d", pca_map.size());
+      begin = end;
+    }
+    stored_fullv0Ids.reserve(nCandidates); // number of photon candidates per DF
+    for (int i = 0; i < nCandidates; i++) {
+      if (isAcceptedCandidate[i]) {
+        const auto& candidate = v0Candidates[i];
+        stored_fullv0Ids.emplace_back(std::make_tuple(candidate.v0Id, candidate.collisionId, candidate.posId, candidate.eleId));
+        nv0_map[candidate.collisionId]++;
+      }
+    }
 
     for (auto& fullv0Id : stored_fullv0Ids) {
       auto v0Id = std::get<0>(fullv0Id);
@@ -798,11 +835,9 @@ struct PhotonConversionBuilder {
       events_ngpcm(nv0_map[collision.globalIndex()]);
     } // end of collision loop
 
-    pca_map.clear();
-    cospa_map.clear();
+    v0Candidates.clear();
+    v0LegCache.clear();
     nv0_map.clear();
-    stored_v0Ids.clear();
-    stored_v0Ids.shrink_to_fit();
     stored_fullv0Ids.clear();
     stored_fullv0Ids.shrink_to_fit();
   } // end of build
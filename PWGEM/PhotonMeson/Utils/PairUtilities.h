@@ -16,7 +16,11 @@
 #define PWGEM_PHOTONMESON_UTILS_PAIRUTILITIES_H_
 
 #include <TVector2.h>
+
+#include <algorithm>
 #include <cmath>
+#include <span>
+#include <vector>
 
 namespace o2::aod::pwgem::photonmeson::utils::pairutil
 {
@@ -63,6 +67,39 @@ bool DoesV0LegMatchWithCluster(TV0Leg const& v0leg, TCluster const& cluster, con
   float Ep = cluster.e() / v0leg.p();
   return (pow(deta / max_deta, 2) + pow(dphi / max_dphi, 2) < 1) && (abs(Ep - 1) < max_Ep_width);
 }
+
+// Four-momentum of a photon (or of a dilepton) kept in the event mixing pool
+struct MixingPhoton {
+  float px;
+  float py;
+  float pz;
+  float e;
+};
+
+inline MixingPhoton makeMixingPhoton(float pt, float eta, float phi, float mass)
+{
+  const float pz = pt * std::sinh(eta);
+  return MixingPhoton{pt * std::cos(phi), pt * std::sin(phi), pz, std::sqrt(pt * pt + pz * pz + mass * mass)};
+}
+
+// Invariant mass, pT and rapidity of the pairs of g1 with each photon of a block of the mixing pool.
+// The block is contiguous in the pool, and the loop has no branches, so that it can be vectorised.
+inline void computeMixedPairs(MixingPhoton const& g1, std::span<const MixingPhoton> block, std::vector<float>& mass, std::vector<float>& pt, std::vector<float>& rapidity)
+{
+  const std::size_t n = block.size();
+  mass.resize(n);
+  pt.resize(n);
+  rapidity.resize(n);
+  for (std::size_t i = 0; i < n; i++) {
+    const float px = g1.px + block[i].px;
+    const float py = g1.py + block[i].py;
+    const float pz = g1.pz + block[i].pz;
+    const float e = g1.e + block[i].e;
+    mass[i] = std::sqrt(std::max(e * e - px * px - py * py - pz * pz, 0.f));
+    pt[i] = std::sqrt(px * px + py * py);
+    rapidity[i] = 0.5f * std::log((e + pz) / (e - pz));
+  }
+}
 } // namespace o2::aod::pwgem::photonmeson::photonpair
 
 #endif // PWGEM_PHOTONMESON_UTILS_PAIRUTILITIES_H_
@@ -44,17 +44,27 @@ class HfHelper
   // 2-prong
 
   // D0(bar) → π± K∓
+  // The hypothesis-dependent quantities are read from HfCand2ProngD0Props when it is joined with the candidate table
+  // (candidate creator option storeCandidateProperties), otherwise they are computed from the prong momenta.
 
   template <typename T>
   auto ctD0(const T& candidate)
   {
-    return candidate.ct(o2::constants::physics::MassD0);
+    if constexpr (requires { candidate.storedCtD0(); }) {
+      return candidate.storedCtD0();
+    } else {
+      return candidate.ct(o2::constants::physics::MassD0);
+    }
   }
 
   template <typename T>
   auto yD0(const T& candidate)
   {
-    return candidate.y(o2::constants::physics::MassD0);
+    if constexpr (requires { candidate.storedYD0(); }) {
+      return candidate.storedYD0();
+    } else {
+      return candidate.y(o2::constants::physics::MassD0);
+    }
   }
 
   template <typename T>
@@ -66,25 +76,41 @@ class HfHelper
   template <typename T>
   auto invMassD0ToPiK(const T& candidate)
   {
-    return candidate.m(std::array{o2::constants::physics::MassPiPlus, o2::constants::physics::MassKPlus});
+    if constexpr (requires { candidate.storedMassD0ToPiK(); }) {
+      return candidate.storedMassD0ToPiK();
+    } else {
+      return candidate.m(std::array{o2::constants::physics::MassPiPlus, o2::constants::physics::MassKPlus});
+    }
   }
 
   template <typename T>
   auto invMassD0barToKPi(const T& candidate)
   {
-    return candidate.m(std::array{o2::constants::physics::MassKPlus, o2::constants::physics::MassPiPlus});
+    if constexpr (requires { candidate.storedMassD0barToKPi(); }) {
+      return candidate.storedMassD0barToKPi();
+    } else {
+      return candidate.m(std::array{o2::constants::physics::MassKPlus, o2::constants::physics::MassPiPlus});
+    }
   }
 
   template <typename T>
   auto cosThetaStarD0(const T& candidate)
   {
-    return candidate.cosThetaStar(std::array{o2::constants::physics::MassPiPlus, o2::constants::physics::MassKPlus}, o2::constants::physics::MassD0, 1);
+    if constexpr (requires { candidate.storedCosThetaStarD0(); }) {
+      return candidate.storedCosThetaStarD0();
+    } else {
+      return candidate.cosThetaStar(std::array{o2::constants::physics::MassPiPlus, o2::constants::physics::MassKPlus}, o2::constants::physics::MassD0, 1);
+    }
   }
 
   template <typename T>
   auto cosThetaStarD0bar(const T& candidate)
   {
-    return candidate.cosThetaStar(std::array{o2::constants::physics::MassKPlus, o2::constants::physics::MassPiPlus}, o2::constants::physics::MassD0, 0);
+    if constexpr (requires { candidate.storedCosThetaStarD0bar(); }) {
+      return candidate.storedCosThetaStarD0bar();
+    } else {
+      return candidate.cosThetaStar(std::array{o2::constants::physics::MassKPlus, o2::constants::physics::MassPiPlus}, o2::constants::physics::MassD0, 0);
+    }
   }
 
   // J/ψ
@@ -186,6 +212,7 @@ class HfHelper
   }
 
   // 3-prong
+  // The invariant masses of the D+, Ds and Λc hypotheses are read from HfCand3ProngProps when it is joined with the candidate table.
 
   // D± → π± K∓ π±
 
@@ -210,7 +237,11 @@ class HfHelper
   template <typename T>
   auto invMassDplusToPiKPi(const T& candidate)
   {
-    return candidate.m(std::array{o2::constants::physics::MassPiPlus, o2::constants::physics::MassKPlus, o2::constants::physics::MassPiPlus});
+    if constexpr (requires { candidate.storedMassDplusToPiKPi(); }) {
+      return candidate.storedMassDplusToPiKPi();
+    } else {
+      return candidate.m(std::array{o2::constants::physics::MassPiPlus, o2::constants::physics::MassKPlus, o2::constants::physics::MassPiPlus});
+    }
   }
 
   template <typename T>
@@ -243,13 +274,21 @@ class HfHelper
   template <typename T>
   auto invMassDsToKKPi(const T& candidate)
   {
-    return candidate.m(std::array{o2::constants::physics::MassKPlus, o2::constants::physics::MassKPlus, o2::constants::physics::MassPiPlus});
+    if constexpr (requires { candidate.storedMassDsToKKPi(); }) {
+      return candidate.storedMassDsToKKPi();
+    } else {
+      return candidate.m(std::array{o2::constants::physics::MassKPlus, o2::constants::physics::MassKPlus, o2::constants::physics::MassPiPlus});
+    }
   }
 
   template <typename T>
   auto invMassDsToPiKK(const T& candidate)
   {
-    return candidate.m(std::array{o2::constants::physics::MassPiPlus, o2::constants::physics::MassKPlus, o2::constants::physics::MassKPlus});
+    if constexpr (requires { candidate.storedMassDsToPiKK(); }) {
+      return candidate.storedMassDsToPiKK();
+    } else {
+      return candidate.m(std::array{o2::constants::physics::MassPiPlus, o2::constants::physics::MassKPlus, o2::constants::physics::MassKPlus});
+    }
   }
 
   template <typename T>
@@ -359,13 +398,21 @@ class HfHelper
   template <typename T>
   auto invMassLcToPKPi(const T& candidate)
   {
-    return candidate.m(std::array{o2::constants::physics::MassProton, o2::constants::physics::MassKPlus, o2::constants::physics::MassPiPlus});
+    if constexpr (requires { candidate.storedMassLcToPKPi(); }) {
+      return candidate.storedMassLcToPKPi();
+    } else {
+      return candidate.m(std::array{o2::constants::physics::MassProton, o2::constants::physics::MassKPlus, o2::constants::physics::MassPiPlus});
+    }
   }
 
   template <typename T>
   auto invMassLcToPiKP(const T& candidate)
   {
-    return candidate.m(std::array{o2::constants::physics::MassPiPlus, o2::constants::physics::MassKPlus, o2::constants::physics::MassProton});
+    if constexpr (requires { candidate.storedMassLcToPiKP(); }) {
+      return candidate.storedMassLcToPiKP();
+    } else {
+      return candidate.m(std::array{o2::constants::physics::MassPiPlus, o2::constants::physics::MassKPlus, o2::constants::physics::MassProton});
+    }
   }
 
   template <typename T>
@@ -176,13 +176,13 @@ class HfMlResponseD0ToKPi : public HfMlResponse<TypeOutputScore>
 
   HfHelper hfHelper;
 
-  /// Method to get the input features vector needed for ML inference
+  /// Method to fill the input features vector needed for ML inference, reusing its allocated memory
   /// \param candidate is the D0 candidate
-  /// \return inputFeatures vector
+  /// \param inputFeatures vector filled with the features, in the order of the configurables
   template <bool usingMl = false, typename T1>
-  std::vector<float> getInputFeatures(T1 const& candidate, int const& pdgCode)
+  void fillInputFeatures(T1 const& candidate, int const& pdgCode, std::vector<float>& inputFeatures)
   {
-    std::vector<float> inputFeatures;
+    inputFeatures.clear();
 
     for (const auto& idx : MlResponse<TypeOutputScore>::mCachedIndices) {
       switch (idx) {
@@ -237,7 +237,16 @@ class HfMlResponseD0ToKPi : public HfMlResponse<TypeOutputScore>
         CHECK_AND_FILL_VEC_D0_HFHELPER(candidate, ct, ctD0);
       }
     }
+  }
 
+  /// Method to get the input features vector needed for ML inference
+  /// \param candidate is the D0 candidate
+  /// \return inputFeatures vector
+  template <bool usingMl = false, typename T1>
+  std::vector<float> getInputFeatures(T1 const& candidate, int const& pdgCode)
+  {
+    std::vector<float> inputFeatures;
+    fillInputFeatures<usingMl>(candidate, pdgCode, inputFeatures);
     return inputFeatures;
   }
 
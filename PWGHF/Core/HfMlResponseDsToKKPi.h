@@ -153,17 +153,17 @@ class HfMlResponseDsToKKPi : public HfMlResponse<TypeOutputScore>
 
   HfHelper hfHelper;
 
-  /// Method to get the input features vector needed for ML inference
+  /// Method to fill the input features vector needed for ML inference, reusing its allocated memory
   /// \param candidate is the Ds candidate
   /// \param prong0 is the candidate's prong0
   /// \param prong1 is the candidate's prong1
   /// \param prong2 is the candidate's prong2
   /// \param caseDsToKKPi used to divide the case DsToKKPi from DsToPiKK
-  /// \return inputFeatures vector
+  /// \param inputFeatures vector filled with the features, in the order of the configurables
   template <typename T1>
-  std::vector<float> getInputFeatures(T1 const& candidate, bool const caseDsToKKPi)
+  void fillInputFeatures(T1 const& candidate, bool const caseDsToKKPi, std::vector<float>& inputFeatures)
   {
-    std::vector<float> inputFeatures;
+    inputFeatures.clear();
 
     for (const auto& idx : MlResponse<TypeOutputScore>::mCachedIndices) {
       switch (idx) {
@@ -218,7 +218,20 @@ class HfMlResponseDsToKKPi : public HfMlResponse<TypeOutputScore>
         CHECK_AND_FILL_VEC_DS_HFHELPER_SIGNED(candidate, deltaMassPhi, deltaMassPhiDsToKKPi, deltaMassPhiDsToPiKK);
       }
     }
+  }
 
+  /// Method to get the input features vector needed for ML inference
+  /// \param candidate is the Ds candidate
+  /// \param prong0 is the candidate's prong0
+  /// \param prong1 is the candidate's prong1
+  /// \param prong2 is the candidate's prong2
+  /// \param caseDsToKKPi used to divide the case DsToKKPi from DsToPiKK
+  /// \return inputFeatures vector
+  template <typename T1>
+  std::vector<float> getInputFeatures(T1 const& candidate, bool const caseDsToKKPi)
+  {
+    std::vector<float> inputFeatures;
+    fillInputFeatures(candidate, caseDsToKKPi, inputFeatures);
     return inputFeatures;
   }
 
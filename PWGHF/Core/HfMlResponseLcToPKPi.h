@@ -157,16 +157,16 @@ class HfMlResponseLcToPKPi : public HfMlResponse<TypeOutputScore>
   /// Default destructor
   virtual ~HfMlResponseLcToPKPi() = default;
 
-  /// Method to get the input features vector needed for ML inference
+  /// Method to fill the input features vector needed for ML inference, reusing its allocated memory
   /// \param candidate is the Lc candidate
   /// \param prong0 is the candidate's prong0
   /// \param prong1 is the candidate's prong1
   /// \param prong2 is the candidate's prong2
-  /// \return inputFeatures vector
+  /// \param inputFeatures vector filled with the features, in the order of the configurables
   template <typename T1>
-  std::vector<float> getInputFeatures(T1 const& candidate, bool const caseLcToPKPi)
+  void fillInputFeatures(T1 const& candidate, bool const caseLcToPKPi, std::vector<float>& inputFeatures)
   {
-    std::vector<float> inputFeatures;
+    inputFeatures.clear();
 
     for (const auto& idx : MlResponse<TypeOutputScore>::mCachedIndices) {
       switch (idx) {
@@ -242,6 +242,19 @@ class HfMlResponseLcToPKPi : public HfMlResponse<TypeOutputScore>
         }
       }
     }
+  }
+
+  /// Method to get the input features vector needed for ML inference
+  /// \param candidate is the Lc candidate
+  /// \param prong0 is the candidate's prong0
+  /// \param prong1 is the candidate's prong1
+  /// \param prong2 is the candidate's prong2
+  /// \return inputFeatures vector
+  template <typename T1>
+  std::vector<float> getInputFeatures(T1 const& candidate, bool const caseLcToPKPi)
+  {
+    std::vector<float> inputFeatures;
+    fillInputFeatures(candidate, caseLcToPKPi, inputFeatures);
     return inputFeatures;
   }
 
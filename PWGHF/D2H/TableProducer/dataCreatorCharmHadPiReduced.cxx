@@ -41,6 +41,7 @@
 #include "ReconstructionDataFormats/DCA.h"
 
 #include <algorithm>
+#include <array>
 #include <map>
 #include <memory>
 #include <string>
@@ -179,6 +180,14 @@ struct HfDataCreatorCharmHadPiReduced {
   o2::vertexing::DCAFitterN<3> df3;
   o2::vertexing::DCAFitterN<2> df2;
 
+  // Helper struct with a pion track of a collision, selected and propagated once and then paired with all the charm-hadron candidates
+  template <typename TTrack>
+  struct PionCandidate {
+    TTrack track;
+    o2::track::TrackParCov trackParCov;
+    std::array<float, 3> pVec;
+  };
+
   using TracksPid = soa::Join<aod::pidTPCFullPi, aod::pidTOFFullPi, aod::pidTPCFullKa, aod::pidTOFFullKa, aod::pidTPCFullPr, aod::pidTOFFullPr>; // TODO: revert to pion only once the Nsigma variables for the charm-hadron candidate daughters are in the candidate table for 3 prongs too
   using TracksPidWithSel = soa::Join<aod::TracksWCovDcaExtra, TracksPid, aod::TrackSelection>;
   using TracksPidWithSelAndMc = soa::Join<TracksPidWithSel, aod::McTrackLabels>;
@@ -327,14 +336,13 @@ struct HfDataCreatorCharmHadPiReduced {
     hfEvSel.init(registry);
   }
 
-  /// Pion selection (D Pi <-- B0)
+  /// Pion selection (D Pi <-- B0), the rejection of the charm-hadron daughters is done when pairing
   /// \param trackPion is a track with the pion hypothesis
   /// \param trackParCovPion is the track parametrisation of the pion
   /// \param dcaPion is the 2-D array with track DCAs of the pion
-  /// \param charmDautracks charm-hadron daughter tracks
   /// \return true if trackPion passes all cuts
   template <typename T1, typename T2, typename T3>
-  bool isPionSelected(const T1& trackPion, const T2& trackParCovPion, const T3& dcaPion, const std::vector<T1>& charmDautracks)
+  bool isPionSelected(const T1& trackPion, const T2& trackParCovPion, const T3& dcaPion)
   {
     // check isGlobalTrackWoDCA status for pions if wanted
     if (trackPionConfigurations.usePionIsGlobalTrackWoDCA && !trackPion.isGlobalTrackWoDCA()) {
@@ -344,12 +352,6 @@ struct HfDataCreatorCharmHadPiReduced {
     if (trackParCovPion.getPt() < trackPionConfigurations.ptPionMin || std::abs(trackParCovPion.getEta()) > trackPionConfigurations.etaPionMax || !isSelectedTrackDCA(trackParCovPion, dcaPion, trackPionConfigurations.binsPtPion, trackPionConfigurations.cutsTrackPionDCA)) {
       return false;
     }
-    // reject pions that are charm-hadron daughters
-    for (const auto& track : charmDautracks) {
-      if (trackPion.globalIndex() == track.globalIndex()) {
-        return false;
-      }
-    }
 
     return true;
   }
@@ -928,6 +930,26 @@ struct HfDataCreatorCharmHadPiReduced {
     df3.setBz(bz);
 
     auto thisCollId = collision.globalIndex();
+
+    // select and propagate the pion tracks once per collision, they are then paired with all the charm-hadron candidates
+    std::vector<PionCandidate<typename TTracks::iterator>> pionCandidates{};
+    if (candsC.size() > 0) {
+      for (const auto& trackId : trackIndices) {
+        auto trackPion = trackId.template track_as<TTracks>();
+        auto trackParCovPion = getTrackParCov(trackPion);
+        std::array<float, 2> dcaPion{trackPion.dcaXY(), trackPion.dcaZ()};
+        std::array<float, 3> pVecPion = trackPion.pVector();
+        if (trackPion.collisionId() != thisCollId) {
+          o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParCovPion, 2.f, noMatCorr, &dcaPion);
+          getPxPyPz(trackParCovPion, pVecPion);
+        }
+        if (!isPionSelected(trackPion, trackParCovPion, dcaPion)) {
+          continue;
+        }
+        pionCandidates.push_back({trackPion, trackParCovPion, pVecPion});
+      }
+    }
+
     for (const auto& candC : candsC) {
       int indexHfCandCharm{-1};
       float invMassC0{-1.f}, invMassC1{-1.f};
@@ -1101,17 +1123,9 @@ struct HfDataCreatorCharmHadPiReduced {
         }
       }
 
-      for (const auto& trackId : trackIndices) {
-        auto trackPion = trackId.template track_as<TTracks>();
-
-        // apply selections on pion tracks
-        auto trackParCovPion = getTrackParCov(trackPion);
-        std::array<float, 2> dcaPion{trackPion.dcaXY(), trackPion.dcaZ()};
-        std::array<float, 3> pVecPion = trackPion.pVector();
-        if (trackPion.collisionId() != thisCollId) {
-          o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParCovPion, 2.f, noMatCorr, &dcaPion);
-          getPxPyPz(trackParCovPion, pVecPion);
-        }
+      for (const auto& pionCandidate : pionCandidates) {
+        const auto& trackPion = pionCandidate.track;
+        const auto& trackParCovPion = pionCandidate.trackParCov;
 
         // reject pi D with same sign as D
         if constexpr (decChannel == DecayChannel::B0ToDminusPi || decChannel == DecayChannel::BsToDsminusPi || decChannel == DecayChannel::LbToLcplusPi) { // D∓ → π∓ K± π∓ and Ds∓ → K∓ K± π∓ and Lc∓ → p∓ K± π∓
@@ -1124,14 +1138,14 @@ struct HfDataCreatorCharmHadPiReduced {
           }
         }
 
-        // apply selections on pion tracks
-        if (!isPionSelected(trackPion, trackParCovPion, dcaPion, charmHadDauTracks)) {
+        // reject pions that are charm-hadron daughters
+        if (std::any_of(charmHadDauTracks.begin(), charmHadDauTracks.end(), [&trackPion](const auto& track) { return track.globalIndex() == trackPion.globalIndex(); })) {
           continue;
         }
 
         registry.fill(HIST("hPtPion"), trackParCovPion.getPt());
         // compute invariant mass square and apply selection
-        auto invMass2DPi = RecoDecay::m2(std::array{pVecCharm, pVecPion}, std::array{massC, massPi});
+        auto invMass2DPi = RecoDecay::m2(std::array{pVecCharm, pionCandidate.pVec}, std::array{massC, massPi});
         if ((invMass2DPi < invMass2ChHadPiMin) || (invMass2DPi > invMass2ChHadPiMax)) {
           continue;
         }
@@ -205,7 +205,7 @@ struct HfDataCreatorCharmResoReduced {
   o2::vertexing::DCAFitterN<2> fitter;
 
   // Helper struct to pass V0 informations
-  struct {
+  struct V0Candidate {
     std::array<float, 3> pos;
     std::array<float, 3> mom;
     std::array<float, 3> momPos;
@@ -222,6 +222,25 @@ struct HfDataCreatorCharmResoReduced {
     uint8_t v0Type;
   } candidateV0;
 
+  // Helper struct with a V0 of a collision, built and selected once and then paired with all the D candidates
+  template <typename TTrack>
+  struct BachelorV0 {
+    V0Candidate candidate;
+    int64_t v0Id;
+    TTrack trackPos;
+    TTrack trackNeg;
+    float chi2TpcDauMax;
+    int nItsClsDauMin;
+    int nTpcCrossRowsDauMin;
+  };
+
+  // Helper struct with a bachelor track of a collision, selected and propagated once and then paired with all the D candidates
+  template <typename TTrack>
+  struct BachelorTrack {
+    TTrack track;
+    std::array<float, 3> pVec;
+  };
+
   struct {
     float invMassD;
     float ptD;
@@ -830,6 +849,66 @@ struct HfDataCreatorCharmResoReduced {
       LOG(info) << ">>>>>>>>>>>> Magnetic field: " << bz;
     }
     fitter.setBz(bz);
+    // build and select the bachelor V0s and tracks once per collision, independently of the D candidates,
+    // the rejection of the pairs sharing a daughter is then done in the loop on the D candidates
+    const std::array<int, 3> noDaughtersIds{-1, -1, -1};
+    std::vector<BachelorV0<typename TrIU::iterator>> selectedBachelorV0s{};
+    std::vector<BachelorTrack<typename Tr::iterator>> selectedBachelorTracks{};
+    if (candsD.size() > 0) {
+      if constexpr (doV0s) {
+        for (const auto& v0 : bachelorV0s) {
+          auto trackPos = v0.template posTrack_as<TrIU>();
+          auto trackNeg = v0.template negTrack_as<TrIU>();
+          // Apply selsection
+          auto v0DauTracks = std::array{trackPos, trackNeg};
+          if (!buildAndSelectV0(collision, noDaughtersIds, v0DauTracks)) {
+            continue;
+          }
+          // Get single track variables
+          float chi2TpcDauV0Max = -1.f;
+          int nItsClsDauV0Min = 8, nTpcCrossRowsDauV0Min = 200;
+          for (const auto& v0Track : v0DauTracks) {
+            if (v0Track.itsNCls() < nItsClsDauV0Min) {
+              nItsClsDauV0Min = v0Track.itsNCls();
+            }
+            if (v0Track.tpcNClsCrossedRows() < nTpcCrossRowsDauV0Min) {
+              nTpcCrossRowsDauV0Min = v0Track.tpcNClsCrossedRows();
+            }
+            if (v0Track.tpcChi2NCl() > chi2TpcDauV0Max) {
+              chi2TpcDauV0Max = v0Track.tpcChi2NCl();
+            }
+          }
+          // propagate V0 to primary vertex (if enabled)
+          if (propagateV0toPV) {
+            std::array<float, 3> pVecV0Orig = {candidateV0.mom[0], candidateV0.mom[1], candidateV0.mom[2]};
+            std::array<float, 2> dcaInfo;
+            auto trackParK0 = o2::track::TrackPar(candidateV0.pos, pVecV0Orig, 0, true);
+            trackParK0.setPID(o2::track::PID::K0);
+            trackParK0.setAbsCharge(0);
+            o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParK0, 2.f, matCorr, &dcaInfo);
+            getPxPyPz(trackParK0, candidateV0.mom);
+          }
+          selectedBachelorV0s.push_back({candidateV0, v0.globalIndex(), trackPos, trackNeg, chi2TpcDauV0Max, nItsClsDauV0Min, nTpcCrossRowsDauV0Min});
+        }
+      }
+      if constexpr (doTracks) {
+        for (const auto& trackIndex : bachelorTrks) {
+          auto track = tracks.rawIteratorAt(trackIndex.trackId());
+          if (!isTrackSelected(track, noDaughtersIds)) {
+            continue;
+          }
+          // if the track has been reassociated, re-propagate it to PV (minor difference)
+          auto trackParCovTrack = getTrackParCov(track);
+          std::array<float, 2> dcaTrack{track.dcaXY(), track.dcaZ()};
+          std::array<float, 3> pVecTrack = track.pVector();
+          if (track.collisionId() != collision.globalIndex()) {
+            o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParCovTrack, 2.f, matCorr, &dcaTrack);
+            getPxPyPz(trackParCovTrack, pVecTrack);
+          }
+          selectedBachelorTracks.push_back({track, pVecTrack});
+        }
+      }
+    }
     // loop on D candidates
     for (const auto& candD : candsD) {
       // initialize variables depending on D meson type
@@ -924,38 +1003,14 @@ struct HfDataCreatorCharmResoReduced {
 
       // Loop on the bachelor V0s
       if constexpr (doV0s) {
-        for (const auto& v0 : bachelorV0s) {
-          auto trackPos = v0.template posTrack_as<TrIU>();
-          auto trackNeg = v0.template negTrack_as<TrIU>();
-          // Apply selsection
-          auto v0DauTracks = std::array{trackPos, trackNeg};
-          if (!buildAndSelectV0(collision, prongIdsD, v0DauTracks)) {
+        for (const auto& bachelorV0 : selectedBachelorV0s) {
+          const auto& trackPos = bachelorV0.trackPos;
+          const auto& trackNeg = bachelorV0.trackNeg;
+          // rejection of V0s that share a daughter with the D meson
+          if (rejectPairsWithCommonDaughter && (std::find(prongIdsD.begin(), prongIdsD.end(), trackPos.globalIndex()) != prongIdsD.end() || std::find(prongIdsD.begin(), prongIdsD.end(), trackNeg.globalIndex()) != prongIdsD.end())) {
             continue;
           }
-          // Get single track variables
-          float chi2TpcDauV0Max = -1.f;
-          int nItsClsDauV0Min = 8, nTpcCrossRowsDauV0Min = 200;
-          for (const auto& v0Track : v0DauTracks) {
-            if (v0Track.itsNCls() < nItsClsDauV0Min) {
-              nItsClsDauV0Min = v0Track.itsNCls();
-            }
-            if (v0Track.tpcNClsCrossedRows() < nTpcCrossRowsDauV0Min) {
-              nTpcCrossRowsDauV0Min = v0Track.tpcNClsCrossedRows();
-            }
-            if (v0Track.tpcChi2NCl() > chi2TpcDauV0Max) {
-              chi2TpcDauV0Max = v0Track.tpcChi2NCl();
-            }
-          }
-          // propagate V0 to primary vertex (if enabled)
-          if (propagateV0toPV) {
-            std::array<float, 3> pVecV0Orig = {candidateV0.mom[0], candidateV0.mom[1], candidateV0.mom[2]};
-            std::array<float, 2> dcaInfo;
-            auto trackParK0 = o2::track::TrackPar(candidateV0.pos, pVecV0Orig, 0, true);
-            trackParK0.setPID(o2::track::PID::K0);
-            trackParK0.setAbsCharge(0);
-            o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParK0, 2.f, matCorr, &dcaInfo);
-            getPxPyPz(trackParK0, candidateV0.mom);
-          }
+          candidateV0 = bachelorV0.candidate;
           // compute resonance invariant mass and filling of QA histograms
           if (TESTBIT(candidateV0.v0Type, K0s)) {
             registry.fill(HIST("hMassVsPtK0s"), candidateV0.pT, candidateV0.mK0Short);
@@ -1047,7 +1102,7 @@ struct HfDataCreatorCharmResoReduced {
 
           // fill V0 table
           // if information on V0 already stored, go to next V0
-          if (!selectedV0s.count(v0.globalIndex())) {
+          if (!selectedV0s.count(bachelorV0.v0Id)) {
             hfCandV0(trackPos.globalIndex(), trackNeg.globalIndex(),
                      indexHfReducedCollision,
                      candidateV0.pos[0], candidateV0.pos[1], candidateV0.pos[2],
@@ -1055,9 +1110,9 @@ struct HfDataCreatorCharmResoReduced {
                      candidateV0.momNeg[0], candidateV0.momNeg[1], candidateV0.momNeg[2],
                      candidateV0.cosPA,
                      candidateV0.dcaV0ToPv,
-                     nItsClsDauV0Min, nTpcCrossRowsDauV0Min, chi2TpcDauV0Max,
+                     bachelorV0.nItsClsDauMin, bachelorV0.nTpcCrossRowsDauMin, bachelorV0.chi2TpcDauMax,
                      candidateV0.v0Type);
-            selectedV0s[v0.globalIndex()] = hfCandV0.lastIndex();
+            selectedV0s[bachelorV0.v0Id] = hfCandV0.lastIndex();
           }
           fillHfCandD = true;
           // Optional filling of MC Rec table, for now only implemented for Ds1->D*K0s and Ds2*->D+K0s
@@ -1076,19 +1131,13 @@ struct HfDataCreatorCharmResoReduced {
       } // end of do V0s
       // Loop on the bachelor tracks
       if constexpr (doTracks) {
-        for (const auto& trackIndex : bachelorTrks) {
-          auto track = tracks.rawIteratorAt(trackIndex.trackId());
-          if (!isTrackSelected(track, prongIdsD)) {
+        for (const auto& bachelorTrack : selectedBachelorTracks) {
+          const auto& track = bachelorTrack.track;
+          const auto& pVecTrack = bachelorTrack.pVec;
+          // rejection of tracks that are daughters of the D meson
+          if (rejectPairsWithCommonDaughter && std::find(prongIdsD.begin(), prongIdsD.end(), track.globalIndex()) != prongIdsD.end()) {
             continue;
           }
-          // if the track has been reassociated, re-propagate it to PV (minor difference)
-          auto trackParCovTrack = getTrackParCov(track);
-          std::array<float, 2> dcaTrack{track.dcaXY(), track.dcaZ()};
-          std::array<float, 3> pVecTrack = track.pVector();
-          if (track.collisionId() != collision.globalIndex()) {
-            o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParCovTrack, 2.f, matCorr, &dcaTrack);
-            getPxPyPz(trackParCovTrack, pVecTrack);
-          }
           registry.fill(HIST("hdEdxVsP"), track.p(), track.tpcSignal());
           // compute invariant mass and filling of QA histograms
           switch (dType) {
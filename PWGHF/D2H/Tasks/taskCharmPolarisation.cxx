@@ -16,6 +16,7 @@
 /// \author S. Kundu (CERN) sourav.kundu@cern.ch
 /// \author M. Faggin (CERN) mattia.faggin@cern.ch
 
+#include <cmath>
 #include <vector>
 
 #include "TRandom3.h"
@@ -62,6 +63,23 @@ enum MassHyposLcToPKPi : uint8_t {
   NMassHypoLcToPKPi
 };
 
+/// Projections of the unit momentum of the daughter in the rest frame of the charm hadron
+/// on the helicity axis, on the normal to the production plane and on the beam axis,
+/// shared by the cos(theta*) and phi of all the reference frames
+struct FrameProjections {
+  float helicity{-10.f};
+  float production{-10.f};
+  float beam{-10.f};
+};
+
+inline FrameProjections getFrameProjections(ROOT::Math::XYZVector const& threeVecDauCM, ROOT::Math::XYZVector const& helicityVec, ROOT::Math::XYZVector const& normalVec)
+{
+  const double invNormDau = 1. / std::sqrt(threeVecDauCM.Mag2());
+  return {static_cast<float>(helicityVec.Dot(threeVecDauCM) * invNormDau / std::sqrt(helicityVec.Mag2())),
+          static_cast<float>(normalVec.Dot(threeVecDauCM) * invNormDau / std::sqrt(normalVec.Mag2())),
+          static_cast<float>(threeVecDauCM.Z() * invNormDau)};
+}
+
 /// columns for table to study the Lc->PKPi background
 DECLARE_SOA_COLUMN(MassLc, massLc, float);
 DECLARE_SOA_COLUMN(PtLc, ptLc, float);
@@ -1337,8 +1355,6 @@ struct TaskPolarisationCharmHadrons {
         continue;
       }
 
-      float phiRandom = gRandom->Uniform(0.f, constants::math::TwoPI);
-      float thetaRandom = gRandom->Uniform(0.f, constants::math::PI);
       ROOT::Math::PxPyPzMVector fourVecDau = ROOT::Math::PxPyPzMVector(pxDau, pyDau, pzDau, massDau);
       ROOT::Math::PxPyPzMVector fourVecMother = ROOT::Math::PxPyPzMVector(pxCharmHad, pyCharmHad, pzCharmHad, invMassCharmHad);
       ROOT::Math::Boost boost{fourVecMother.BoostToCM()};
@@ -1375,11 +1391,15 @@ struct TaskPolarisationCharmHadrons {
       float cosThetaStarProduction = -10.f;
       float phiProduction = -10.f;
       // beam
-      ROOT::Math::XYZVector beamVec = ROOT::Math::XYZVector(0.f, 0.f, 1.f);
       float cosThetaStarBeam = -10.f;
       float phiBeam = -10.f;
       // random
       float cosThetaStarRandom = -10.f;
+      // projections of the daughter direction on the axes, computed once for all the enabled frames
+      charm_polarisation::FrameProjections projections{};
+      if (activateTHnSparseCosThStarHelicity || activateTHnSparseCosThStarProduction || activateTHnSparseCosThStarBeam) {
+        projections = charm_polarisation::getFrameProjections(threeVecDauCM, helicityVec, normalVec);
+      }
 
       int8_t nMuons{0u};
       if constexpr (doMc) {
@@ -1388,24 +1408,26 @@ struct TaskPolarisationCharmHadrons {
 
       if (activateTHnSparseCosThStarHelicity) {
         // helicity
-        cosThetaStarHelicity = helicityVec.Dot(threeVecDauCM) / std::sqrt(threeVecDauCM.Mag2()) / std::sqrt(helicityVec.Mag2());
-        phiHelicity = std::atan2(beamVec.Dot(threeVecDauCM) / std::sqrt(threeVecDauCM.Mag2()), normalVec.Dot(threeVecDauCM) / (std::sqrt(threeVecDauCM.Mag2()) * std::sqrt(normalVec.Mag2())));
+        cosThetaStarHelicity = projections.helicity;
+        phiHelicity = std::atan2(projections.beam, projections.production);
         fillRecoHistos<channel, withMl, doMc, charm_polarisation::CosThetaStarType::Helicity>(invMassCharmHadForSparse, ptCharmHad, numPvContributors, rapidity, invMassD0, invMassKPiLc, cosThetaStarHelicity, phiHelicity, outputMl, isRotatedCandidate, origin, ptBhadMother, resoChannelLc, absEtaTrackMin, numItsClsMin, numTpcClsMin, charge, nMuons, partRecoDstar);
       }
       if (activateTHnSparseCosThStarProduction) {
         // production
-        cosThetaStarProduction = normalVec.Dot(threeVecDauCM) / std::sqrt(threeVecDauCM.Mag2()) / std::sqrt(normalVec.Mag2());
-        phiProduction = std::atan2(normalVec.Dot(threeVecDauCM) / (std::sqrt(threeVecDauCM.Mag2()) * std::sqrt(normalVec.Mag2())), helicityVec.Dot(threeVecDauCM) / (std::sqrt(threeVecDauCM.Mag2()) * std::sqrt(helicityVec.Mag2())));
+        cosThetaStarProduction = projections.production;
+        phiProduction = std::atan2(projections.production, projections.helicity);
         fillRecoHistos<channel, withMl, doMc, charm_polarisation::CosThetaStarType::Production>(invMassCharmHadForSparse, ptCharmHad, numPvContributors, rapidity, invMassD0, invMassKPiLc, cosThetaStarProduction, phiProduction, outputMl, isRotatedCandidate, origin, ptBhadMother, resoChannelLc, absEtaTrackMin, numItsClsMin, numTpcClsMin, charge, nMuons, partRecoDstar);
       }
       if (activateTHnSparseCosThStarBeam) {
         // beam
-        cosThetaStarBeam = beamVec.Dot(threeVecDauCM) / std::sqrt(threeVecDauCM.Mag2());
-        phiBeam = std::atan2(helicityVec.Dot(threeVecDauCM) / (std::sqrt(threeVecDauCM.Mag2()) * std::sqrt(helicityVec.Mag2())), beamVec.Dot(threeVecDauCM) / std::sqrt(threeVecDauCM.Mag2()));
+        cosThetaStarBeam = projections.beam;
+        phiBeam = std::atan2(projections.helicity, projections.beam);
         fillRecoHistos<channel, withMl, doMc, charm_polarisation::CosThetaStarType::Beam>(invMassCharmHadForSparse, ptCharmHad, numPvContributors, rapidity, invMassD0, invMassKPiLc, cosThetaStarBeam, phiBeam, outputMl, isRotatedCandidate, origin, ptBhadMother, resoChannelLc, absEtaTrackMin, numItsClsMin, numTpcClsMin, charge, nMuons, partRecoDstar);
       }
       if (activateTHnSparseCosThStarRandom) {
         // random
+        float phiRandom = gRandom->Uniform(0.f, constants::math::TwoPI);
+        float thetaRandom = gRandom->Uniform(0.f, constants::math::PI);
         ROOT::Math::XYZVector randomVec = ROOT::Math::XYZVector(std::sin(thetaRandom) * std::cos(phiRandom), std::sin(thetaRandom) * std::sin(phiRandom), std::cos(thetaRandom));
         cosThetaStarRandom = randomVec.Dot(threeVecDauCM) / std::sqrt(threeVecDauCM.Mag2());
         fillRecoHistos<channel, withMl, doMc, charm_polarisation::CosThetaStarType::Random>(invMassCharmHadForSparse, ptCharmHad, numPvContributors, rapidity, invMassD0, invMassKPiLc, cosThetaStarRandom, -99.f, outputMl, isRotatedCandidate, origin, ptBhadMother, resoChannelLc, absEtaTrackMin, numItsClsMin, numTpcClsMin, charge, nMuons, partRecoDstar);
@@ -1688,30 +1710,31 @@ struct TaskPolarisationCharmHadrons {
       }
     }
 
-    float phiRandom = gRandom->Uniform(0.f, constants::math::TwoPI);
-    float thetaRandom = gRandom->Uniform(0.f, constants::math::PI);
     ROOT::Math::PxPyPzMVector fourVecDau = ROOT::Math::PxPyPzMVector(pxDau, pyDau, pzDau, massDau);
     ROOT::Math::PxPyPzMVector fourVecMother = ROOT::Math::PxPyPzMVector(pxCharmHad, pyCharmHad, pzCharmHad, massCharmHad);
     ROOT::Math::Boost boost{fourVecMother.BoostToCM()};
     ROOT::Math::PxPyPzMVector fourVecDauCM = boost(fourVecDau);
     ROOT::Math::XYZVector threeVecDauCM = fourVecDauCM.Vect();
+    charm_polarisation::FrameProjections projections{};
+    if (activateTHnSparseCosThStarHelicity || activateTHnSparseCosThStarProduction || activateTHnSparseCosThStarBeam) {
+      projections = charm_polarisation::getFrameProjections(threeVecDauCM, fourVecMother.Vect(), ROOT::Math::XYZVector(pyCharmHad, -pxCharmHad, 0.f));
+    }
 
     if (activateTHnSparseCosThStarHelicity) {
-      ROOT::Math::XYZVector helicityVec = fourVecMother.Vect();
-      float cosThetaStarHelicity = helicityVec.Dot(threeVecDauCM) / std::sqrt(threeVecDauCM.Mag2()) / std::sqrt(helicityVec.Mag2());
+      float cosThetaStarHelicity = projections.helicity;
       fillGenHistos<charm_polarisation::CosThetaStarType::Helicity>(ptCharmHad, numPvContributors, rapidity, cosThetaStarHelicity, origin, ptBhadMother, areDauInAcc, resoChannelLc, charge, partRecoDstar);
     }
     if (activateTHnSparseCosThStarProduction) {
-      ROOT::Math::XYZVector normalVec = ROOT::Math::XYZVector(pyCharmHad, -pxCharmHad, 0.f);
-      float cosThetaStarProduction = normalVec.Dot(threeVecDauCM) / std::sqrt(threeVecDauCM.Mag2()) / std::sqrt(normalVec.Mag2());
+      float cosThetaStarProduction = projections.production;
       fillGenHistos<charm_polarisation::CosThetaStarType::Production>(ptCharmHad, numPvContributors, rapidity, cosThetaStarProduction, origin, ptBhadMother, areDauInAcc, resoChannelLc, charge, partRecoDstar);
     }
     if (activateTHnSparseCosThStarBeam) {
-      ROOT::Math::XYZVector beamVec = ROOT::Math::XYZVector(0.f, 0.f, 1.f);
-      float cosThetaStarBeam = beamVec.Dot(threeVecDauCM) / std::sqrt(threeVecDauCM.Mag2());
+      float cosThetaStarBeam = projections.beam;
       fillGenHistos<charm_polarisation::CosThetaStarType::Beam>(ptCharmHad, numPvContributors, rapidity, cosThetaStarBeam, origin, ptBhadMother, areDauInAcc, resoChannelLc, charge, partRecoDstar);
     }
     if (activateTHnSparseCosThStarRandom) {
+      float phiRandom = gRandom->Uniform(0.f, constants::math::TwoPI);
+      float thetaRandom = gRandom->Uniform(0.f, constants::math::PI);
       ROOT::Math::XYZVector randomVec = ROOT::Math::XYZVector(std::sin(thetaRandom) * std::cos(phiRandom), std::sin(thetaRandom) * std::sin(phiRandom), std::cos(thetaRandom));
       float cosThetaStarRandom = randomVec.Dot(threeVecDauCM) / std::sqrt(threeVecDauCM.Mag2());
       fillGenHistos<charm_polarisation::CosThetaStarType::Random>(ptCharmHad, numPvContributors, rapidity, cosThetaStarRandom, origin, ptBhadMother, areDauInAcc, resoChannelLc, charge, partRecoDstar);
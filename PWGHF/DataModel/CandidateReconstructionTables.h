@@ -197,6 +197,19 @@ DECLARE_SOA_COLUMN(WhyRejectColl, whyRejectColl, uint16_t); //!
 DECLARE_SOA_TABLE(HfSelCollision, "AOD", "HFSELCOLLISION", //!
                   hf_sel_collision::WhyRejectColl);
 
+namespace hf_ev_sel
+{
+DECLARE_SOA_COLUMN(EvSelRejectionMask, evSelRejectionMask, uint16_t); //! Bitmask of the HF event selections not satisfied by the collision (see o2::hf_evsel::EventRejection)
+DECLARE_SOA_COLUMN(EvSelCentrality, evSelCentrality, float);          //! Centrality of the collision with the estimator of the event selection, -1 if none
+DECLARE_SOA_COLUMN(EvSelOccupancy, evSelOccupancy, float);            //! Occupancy of the collision with the estimator of the event selection
+} // namespace hf_ev_sel
+
+// HF event selection of each collision, computed once per DF by the hf-event-selection-creator and joinable with the collisions
+DECLARE_SOA_TABLE(HfEvSelColls, "AOD", "HFEVSELCOLL", //!
+                  hf_ev_sel::EvSelRejectionMask,
+                  hf_ev_sel::EvSelCentrality,
+                  hf_ev_sel::EvSelOccupancy);
+
 namespace hf_sel_track
 {
 DECLARE_SOA_COLUMN(IsSelProng, isSelProng, uint32_t);           //!
@@ -237,6 +250,19 @@ DECLARE_SOA_TABLE(HfPvRefitTrack, "AOD", "HFPVREFITTRACK", //!
                   hf_pv_refit_track::PvRefitDcaXY,
                   hf_pv_refit_track::PvRefitDcaZ);
 
+namespace hf_pid_status
+{
+DECLARE_SOA_COLUMN(PidStatusPi, pidStatusPi, uint16_t); //! PID status bitmap of the pion hypothesis (see TrackSelectorPID::Selection)
+DECLARE_SOA_COLUMN(PidStatusKa, pidStatusKa, uint16_t); //! PID status bitmap of the kaon hypothesis (see TrackSelectorPID::Selection)
+DECLARE_SOA_COLUMN(PidStatusPr, pidStatusPr, uint16_t); //! PID status bitmap of the proton hypothesis (see TrackSelectorPID::Selection)
+} // namespace hf_pid_status
+
+// PID statuses of each track, computed once per DF by the pid-status-creator and joinable with the tracks
+DECLARE_SOA_TABLE(HfPidStatusTrack, "AOD", "HFPIDSTATUSTRK", //!
+                  hf_pid_status::PidStatusPi,
+                  hf_pid_status::PidStatusKa,
+                  hf_pid_status::PidStatusPr);
+
 namespace hf_track_index
 {
 DECLARE_SOA_INDEX_COLUMN(Collision, collision);                   //! Collision index
@@ -648,6 +674,14 @@ DECLARE_SOA_COLUMN(FlagMcDecayChanGen, flagMcDecayChanGen, int8_t); //! resonant
 DECLARE_SOA_COLUMN(KfGeoMassD0, kfGeoMassD0, float);       //! mass of the D0 candidate from the KFParticle geometric fit
 DECLARE_SOA_COLUMN(KfGeoMassD0bar, kfGeoMassD0bar, float); //! mass of the D0bar candidate from the KFParticle geometric fit
 
+// hypothesis-dependent properties materialised on demand by the candidate creator, used by HfHelper when joined
+DECLARE_SOA_COLUMN(StoredMassD0ToPiK, storedMassD0ToPiK, float);             //! invariant mass of the D0 → π+ K− hypothesis
+DECLARE_SOA_COLUMN(StoredMassD0barToKPi, storedMassD0barToKPi, float);       //! invariant mass of the D0bar → K+ π− hypothesis
+DECLARE_SOA_COLUMN(StoredCosThetaStarD0, storedCosThetaStarD0, float);       //! cos(θ*) of the D0 hypothesis
+DECLARE_SOA_COLUMN(StoredCosThetaStarD0bar, storedCosThetaStarD0bar, float); //! cos(θ*) of the D0bar hypothesis
+DECLARE_SOA_COLUMN(StoredCtD0, storedCtD0, float);                           //! proper decay length with the D0 mass
+DECLARE_SOA_COLUMN(StoredYD0, storedYD0, float);                             //! rapidity with the D0 mass
+
 // mapping of decay types
 enum DecayType { D0ToPiK = 0,
                  JpsiToEE,
@@ -753,6 +787,12 @@ DECLARE_SOA_TABLE(HfCand2ProngKF, "AOD", "HFCAND2PKF",
                   hf_cand::KfTopolChi2OverNdf,
                   hf_cand_2prong::KfGeoMassD0, hf_cand_2prong::KfGeoMassD0bar);
 
+// optional table of the D0 hypothesis-dependent properties, one row per HfCand2Prong row when enabled in the candidate creator
+DECLARE_SOA_TABLE(HfCand2ProngD0Props, "AOD", "HFCAND2PD0PROP", //!
+                  hf_cand_2prong::StoredMassD0ToPiK, hf_cand_2prong::StoredMassD0barToKPi,
+                  hf_cand_2prong::StoredCosThetaStarD0, hf_cand_2prong::StoredCosThetaStarD0bar,
+                  hf_cand_2prong::StoredCtD0, hf_cand_2prong::StoredYD0);
+
 // table with results of reconstruction level MC matching
 DECLARE_SOA_TABLE(HfCand2ProngMcRec, "AOD", "HFCAND2PMCREC", //!
                   hf_cand_2prong::FlagMcMatchRec,
@@ -1035,6 +1075,13 @@ DECLARE_SOA_COLUMN(KfChi2Topo, kfChi2Topo, float);                       //! chi
 DECLARE_SOA_COLUMN(KfDecayLength, kfDecayLength, float);                 //! decay length
 DECLARE_SOA_COLUMN(KfDecayLengthError, kfDecayLengthError, float);       //! decay length error
 
+// hypothesis-dependent properties materialised on demand by the candidate creator, used by HfHelper when joined
+DECLARE_SOA_COLUMN(StoredMassDplusToPiKPi, storedMassDplusToPiKPi, float); //! invariant mass of the D+ → π+ K− π+ hypothesis
+DECLARE_SOA_COLUMN(StoredMassDsToKKPi, storedMassDsToKKPi, float);         //! invariant mass of the Ds+ → K+ K− π+ hypothesis
+DECLARE_SOA_COLUMN(StoredMassDsToPiKK, storedMassDsToPiKK, float);         //! invariant mass of the Ds+ → π+ K− K+ hypothesis
+DECLARE_SOA_COLUMN(StoredMassLcToPKPi, storedMassLcToPKPi, float);         //! invariant mass of the Λc+ → p K− π+ hypothesis
+DECLARE_SOA_COLUMN(StoredMassLcToPiKP, storedMassLcToPiKP, float);         //! invariant mass of the Λc+ → π+ K− p hypothesis
+
 } // namespace hf_cand_3prong
 
 // 3-prong decay candidate table
@@ -1097,6 +1144,12 @@ DECLARE_SOA_TABLE(HfCand3ProngKF, "AOD", "HFCAND3PKF",
                   hf_cand_3prong::KfChi2GeoProng1Prong2, hf_cand_3prong::KfChi2GeoProng0Prong2, hf_cand_3prong::KfChi2GeoProng0Prong1,
                   hf_cand_3prong::KfChi2Geo, hf_cand_3prong::KfDecayLength, hf_cand_3prong::KfDecayLengthError, hf_cand_3prong::KfChi2Topo);
 
+// optional table of the hypothesis-dependent invariant masses, one row per HfCand3Prong row when enabled in the candidate creator
+DECLARE_SOA_TABLE(HfCand3ProngProps, "AOD", "HFCAND3PPROP", //!
+                  hf_cand_3prong::StoredMassDplusToPiKPi,
+                  hf_cand_3prong::StoredMassDsToKKPi, hf_cand_3prong::StoredMassDsToPiKK,
+                  hf_cand_3prong::StoredMassLcToPKPi, hf_cand_3prong::StoredMassLcToPiKP);
+
 // table with results of reconstruction level MC matching
 DECLARE_SOA_TABLE(HfCand3ProngMcRec, "AOD", "HFCAND3PMCREC", //!
                   hf_cand_3prong::FlagMcMatchRec,
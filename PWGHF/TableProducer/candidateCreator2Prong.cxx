@@ -51,6 +51,7 @@
 #include <KFParticleBase.h>
 #include <KFVertex.h>
 
+#include <array>
 #include <memory>
 #include <string>
 #include <vector>
@@ -76,6 +77,7 @@ struct HfCandidateCreator2Prong {
   Produces<aod::HfProng1PidPi> rowProng1PidPi;
   Produces<aod::HfProng1PidKa> rowProng1PidKa;
   Produces<aod::HfCand2ProngKF> rowCandidateKF;
+  Produces<aod::HfCand2ProngD0Props> rowCandidateD0Props;
 
   // vertexing
   Configurable<bool> constrainKfToPv{"constrainKfToPv", true, "constraint KFParticle to PV"};
@@ -87,6 +89,7 @@ struct HfCandidateCreator2Prong {
   Configurable<double> minParamChange{"minParamChange", 1.e-3, "stop iterations if largest change of any X is smaller than this"};
   Configurable<double> minRelChi2Change{"minRelChi2Change", 0.9, "stop iterations is chi2/chi2old > this"};
   Configurable<bool> fillHistograms{"fillHistograms", true, "do validation plots"};
+  Configurable<bool> storeCandidateProperties{"storeCandidateProperties", false, "fill the table of the D0 hypothesis-dependent properties (masses, cos(theta*), ct, y) read by HfHelper"};
   // magnetic field setting from CCDB
   Configurable<bool> isRun2{"isRun2", false, "enable Run 2 or Run 3 GRP objects for magnetic field"};
   Configurable<std::string> ccdbUrl{"ccdbUrl", "http://alice-ccdb.cern.ch", "url of the ccdb repository"};
@@ -185,6 +188,22 @@ struct HfCandidateCreator2Prong {
     setLabelHistoCands(hCandidates);
   }
 
+  /// Fill the table of the D0 hypothesis-dependent properties from the inputs of the dynamic columns of the base table
+  template <typename TVertex>
+  void fillCandidateProperties(float xPv, float yPv, float zPv, TVertex const& secondaryVertex, std::array<float, 3> const& pVec0, std::array<float, 3> const& pVec1)
+  {
+    const std::array<float, 3> posPv{xPv, yPv, zPv};
+    const std::array<float, 3> posSv{static_cast<float>(secondaryVertex[0]), static_cast<float>(secondaryVertex[1]), static_cast<float>(secondaryVertex[2])};
+    const std::array<float, 3> pVec{pVec0[0] + pVec1[0], pVec0[1] + pVec1[1], pVec0[2] + pVec1[2]};
+    const auto arrayMomenta = std::array{pVec0, pVec1};
+    rowCandidateD0Props(RecoDecay::m(arrayMomenta, std::array{MassPiPlus, MassKPlus}),
+                        RecoDecay::m(arrayMomenta, std::array{MassKPlus, MassPiPlus}),
+                        RecoDecay::cosThetaStar(arrayMomenta, std::array{MassPiPlus, MassKPlus}, MassD0, 1),
+                        RecoDecay::cosThetaStar(arrayMomenta, std::array{MassKPlus, MassPiPlus}, MassD0, 0),
+                        RecoDecay::ct(pVec, RecoDecay::distance(posPv, posSv), MassD0),
+                        RecoDecay::y(pVec, MassD0));
+  }
+
   template <bool doPvRefit, o2::hf_centrality::CentralityEstimator centEstimator, typename Coll, typename CandType, typename TTracks>
   void runCreator2ProngWithDCAFitterN(Coll const&,
                                       CandType const& rowsTrackIndexProng2,
@@ -321,6 +340,10 @@ struct HfCandidateCreator2Prong {
       fillProngPid<HfProngSpecies::Pion>(track1, rowProng1PidPi);
       fillProngPid<HfProngSpecies::Kaon>(track1, rowProng1PidKa);
 
+      if (storeCandidateProperties) {
+        fillCandidateProperties(primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ(), secondaryVertex, pvec0, pvec1);
+      }
+
       // fill histograms
       if (fillHistograms) {
         // calculate invariant masses
@@ -477,6 +500,11 @@ struct HfCandidateCreator2Prong {
       rowCandidateKF(topolChi2PerNdfD0,
                      massD0, massD0bar);
 
+      if (storeCandidateProperties) {
+        fillCandidateProperties(kfpV.GetX(), kfpV.GetY(), kfpV.GetZ(), std::array{kfCandD0.GetX(), kfCandD0.GetY(), kfCandD0.GetZ()},
+                                std::array<float, 3>{kfPosPion.GetPx(), kfPosPion.GetPy(), kfPosPion.GetPz()}, std::array<float, 3>{kfNegKaon.GetPx(), kfNegKaon.GetPy(), kfNegKaon.GetPz()});
+      }
+
       // fill histograms
       if (fillHistograms) {
         registry.fill(HIST("hMass2"), massD0);
@@ -738,6 +766,8 @@ struct HfCandidateCreator2ProngExpressions {
                           BCsInfo const&)
   {
     rowCandidateProng2->bindExternalIndices(&tracks);
+    // memoise the mother searches of the prongs shared by several candidates and decay hypotheses
+    RecoDecay::McAncestryCache mcAncestry(mcParticles);
 
     int indexRec = -1;
     int8_t sign = 0;
@@ -49,6 +49,7 @@
 #include <KFParticleBase.h>
 #include <KFVertex.h>
 
+#include <array>
 #include <memory>
 #include <string>
 #include <utility>
@@ -71,6 +72,7 @@ using namespace o2::aod::pid_tpc_tof_utils;
 struct HfCandidateCreator3Prong {
   Produces<aod::HfCand3ProngBase> rowCandidateBase;
   Produces<aod::HfCand3ProngKF> rowCandidateKF;
+  Produces<aod::HfCand3ProngProps> rowCandidateProps;
   Produces<aod::HfProng0PidPi> rowProng0PidPi;
   Produces<aod::HfProng0PidKa> rowProng0PidKa;
   Produces<aod::HfProng0PidPr> rowProng0PidPr;
@@ -90,6 +92,7 @@ struct HfCandidateCreator3Prong {
   Configurable<double> minParamChange{"minParamChange", 1.e-3, "stop iterations if largest change of any X is smaller than this"};
   Configurable<double> minRelChi2Change{"minRelChi2Change", 0.9, "stop iterations is chi2/chi2old > this"};
   Configurable<bool> fillHistograms{"fillHistograms", true, "do validation plots"};
+  Configurable<bool> storeCandidateProperties{"storeCandidateProperties", false, "fill the table of the hypothesis-dependent invariant masses read by HfHelper"};
   // magnetic field setting from CCDB
   Configurable<bool> isRun2{"isRun2", false, "enable Run 2 or Run 3 GRP objects for magnetic field"};
   Configurable<std::string> ccdbUrl{"ccdbUrl", "http://alice-ccdb.cern.ch", "url of the ccdb repository"};
@@ -236,6 +239,17 @@ struct HfCandidateCreator3Prong {
     }
   }
 
+  /// Fill the table of the hypothesis-dependent invariant masses from the prong momenta stored in the base table
+  void fillCandidateProperties(std::array<float, 3> const& pVec0, std::array<float, 3> const& pVec1, std::array<float, 3> const& pVec2)
+  {
+    const auto arrayMomenta = std::array{pVec0, pVec1, pVec2};
+    rowCandidateProps(RecoDecay::m(arrayMomenta, std::array{MassPiPlus, MassKPlus, MassPiPlus}),
+                      RecoDecay::m(arrayMomenta, std::array{MassKPlus, MassKPlus, MassPiPlus}),
+                      RecoDecay::m(arrayMomenta, std::array{MassPiPlus, MassKPlus, MassKPlus}),
+                      RecoDecay::m(arrayMomenta, std::array{MassProton, MassKPlus, MassPiPlus}),
+                      RecoDecay::m(arrayMomenta, std::array{MassPiPlus, MassKPlus, MassProton}));
+  }
+
   template <bool doPvRefit = false, o2::hf_centrality::CentralityEstimator centEstimator, typename Coll, typename Cand>
   void runCreator3ProngWithDCAFitterN(Coll const&,
                                       Cand const& rowsTrackIndexProng3,
@@ -382,6 +396,10 @@ struct HfCandidateCreator3Prong {
       // fill candidate prong PID rows
       fillProngsPid(track0, track1, track2);
 
+      if (storeCandidateProperties) {
+        fillCandidateProperties(pvec0, pvec1, pvec2);
+      }
+
       // fill histograms
       if (fillHistograms) {
         // calculate invariant mass
@@ -629,6 +647,10 @@ struct HfCandidateCreator3Prong {
       // fill candidate prong PID rows
       fillProngsPid(track0, track1, track2);
 
+      if (storeCandidateProperties) {
+        fillCandidateProperties(pProng0, pProng1, pProng2);
+      }
+
       // fill histograms
       if (fillHistograms) {
         registry.fill(HIST("hMass3PiKPi"), massPiKPi);
@@ -898,6 +920,8 @@ struct HfCandidateCreator3ProngExpressions {
                           BCsInfo const&)
   {
     rowCandidateProng3->bindExternalIndices(&tracks);
+    // memoise the mother searches of the prongs shared by several candidates and decay hypotheses
+    RecoDecay::McAncestryCache mcAncestry(mcParticles);
 
     int indexRec = -1;
     int8_t sign = 0;
@@ -956,7 +980,7 @@ struct HfCandidateCreator3ProngExpressions {
           if (pdg == Pdg::kDStar) {
             depth = MaxDepth + 1; // D0 resonant decays are active
           }
-          auto finalStates = getDecayChannelMain(pdg);
+          const auto& finalStates = getDecayChannelMain(pdg);
           for (const auto& [chn, finalState] : finalStates) {
             std::array<int, 3> finalStateParts3Prong = std::array{finalState[0], finalState[1], finalState[2]};
             if (finalState.size() > 3) { // o2-linter: disable=magic-number (Partly Reco decays with 4 or 5 final state particles)
@@ -15,6 +15,7 @@
 /// \author Nima Zardoshti <nima.zardoshti@cern.ch>, CERN
 /// \author Vít Kučera <vit.kucera@cern.ch>, CERN
 
+#include <array>
 #include <string>
 #include <vector>
 
@@ -78,6 +79,7 @@ struct HfCandidateSelectorD0 {
   Configurable<LabeledArray<double>> cutsMl{"cutsMl", {hf_cuts_ml::Cuts[0], hf_cuts_ml::NBinsPt, hf_cuts_ml::NCutScores, hf_cuts_ml::labelsPt, hf_cuts_ml::labelsCutScore}, "ML selections per pT bin"};
   Configurable<int> nClassesMl{"nClassesMl", static_cast<int>(hf_cuts_ml::NCutScores), "Number of classes in ML model"};
   Configurable<bool> enableDebugMl{"enableDebugMl", false, "Flag to enable histograms to monitor BDT application"};
+  Configurable<int> maxBatchSizeMl{"maxBatchSizeMl", 0, "Maximum number of candidates per ML model call (0 = all candidates of the DF in the same pT bin)"};
   Configurable<std::vector<std::string>> namesInputFeatures{"namesInputFeatures", std::vector<std::string>{"feature1", "feature2"}, "Names of ML model input features"};
   // CCDB configuration
   Configurable<std::string> ccdbUrl{"ccdbUrl", "http://alice-ccdb.cern.ch", "url of the ccdb repository"};
@@ -91,6 +93,13 @@ struct HfCandidateSelectorD0 {
   o2::analysis::HfMlResponseD0ToKPi<float> hfMlResponse;
   std::vector<float> outputMlD0 = {};
   std::vector<float> outputMlD0bar = {};
+  // per-DF buffers for the batched ML inference
+  std::vector<std::array<int, 6>> statusCands = {}; // statusD0, statusD0bar, statusHFFlag, statusTopol, statusCand, statusPID
+  std::vector<std::vector<float>> inputFeaturesMl = {}; // not cleared between DFs, to reuse the memory of the feature vectors
+  std::size_t nInputsMl{0};
+  std::vector<float> ptCandsMl = {};
+  std::vector<std::size_t> idxHypoMl = {}; // 2 * candidate index + (0 for D0, 1 for D0bar)
+  std::vector<bool> isSelectedMl = {};
   o2::ccdb::CcdbApi ccdbApi;
   TrackSelectorPi selectorPion;
   TrackSelectorKa selectorKaon;
@@ -296,6 +305,11 @@ struct HfCandidateSelectorD0 {
   void processSel(CandType const& candidates,
                   TracksSel const&)
   {
+    statusCands.clear();
+    nInputsMl = 0;
+    ptCandsMl.clear();
+    idxHypoMl.clear();
+
     // looping over 2-prong candidates
     for (const auto& candidate : candidates) {
 
@@ -307,14 +321,8 @@ struct HfCandidateSelectorD0 {
       int statusCand = 0;
       int statusPID = 0;
 
-      outputMlD0.clear();
-      outputMlD0bar.clear();
-
       if (!(candidate.hfflag() & 1 << aod::hf_cand_2prong::DecayType::D0ToPiK)) {
-        hfSelD0Candidate(statusD0, statusD0bar, statusHFFlag, statusTopol, statusCand, statusPID);
-        if (applyMl) {
-          hfMlD0Candidate(outputMlD0, outputMlD0bar);
-        }
+        statusCands.push_back({statusD0, statusD0bar, statusHFFlag, statusTopol, statusCand, statusPID});
         continue;
       }
       statusHFFlag = 1;
@@ -325,19 +333,13 @@ struct HfCandidateSelectorD0 {
 
       // implement track quality selection for D0 daughters
       if (!isSelectedCandidateProng(trackPos, trackNeg)) {
-        hfSelD0Candidate(statusD0, statusD0bar, statusHFFlag, statusTopol, statusCand, statusPID);
-        if (applyMl) {
-          hfMlD0Candidate(outputMlD0, outputMlD0bar);
-        }
+        statusCands.push_back({statusD0, statusD0bar, statusHFFlag, statusTopol, statusCand, statusPID});
         continue;
       }
 
       // conjugate-independent topological selection
       if (!selectionTopol<reconstructionType>(candidate)) {
-        hfSelD0Candidate(statusD0, statusD0bar, statusHFFlag, statusTopol, statusCand, statusPID);
-        if (applyMl) {
-          hfMlD0Candidate(outputMlD0, outputMlD0bar);
-        }
+        statusCands.push_back({statusD0, statusD0bar, statusHFFlag, statusTopol, statusCand, statusPID});
         continue;
       }
       statusTopol = 1;
@@ -351,10 +353,7 @@ struct HfCandidateSelectorD0 {
       bool topolD0bar = selectionTopolConjugate<reconstructionType>(candidate, trackNeg, trackPos);
 
       if (!topolD0 && !topolD0bar) {
-        hfSelD0Candidate(statusD0, statusD0bar, statusHFFlag, statusTopol, statusCand, statusPID);
-        if (applyMl) {
-          hfMlD0Candidate(outputMlD0, outputMlD0bar);
-        }
+        statusCands.push_back({statusD0, statusD0bar, statusHFFlag, statusTopol, statusCand, statusPID});
         continue;
       }
       statusCand = 1;
@@ -417,10 +416,7 @@ struct HfCandidateSelectorD0 {
         }
 
         if (pidD0 == 0 && pidD0bar == 0) {
-          hfSelD0Candidate(statusD0, statusD0bar, statusHFFlag, statusTopol, statusCand, statusPID);
-          if (applyMl) {
-            hfMlD0Candidate(outputMlD0, outputMlD0bar);
-          }
+          statusCands.push_back({statusD0, statusD0bar, statusHFFlag, statusTopol, statusCand, statusPID});
           continue;
         }
 
@@ -441,44 +437,85 @@ struct HfCandidateSelectorD0 {
       }
 
       if (applyMl) {
-        // ML selections
-        bool isSelectedMlD0 = false;
-        bool isSelectedMlD0bar = false;
-
+        // collect the ML input features, the model inference is run once per DF below
         if (statusD0 > 0) {
-          std::vector<float> inputFeaturesD0 = hfMlResponse.getInputFeatures(candidate, o2::constants::physics::kD0);
-          isSelectedMlD0 = hfMlResponse.isSelectedMl(inputFeaturesD0, ptCand, outputMlD0);
+          if (nInputsMl == inputFeaturesMl.size()) {
+            inputFeaturesMl.emplace_back();
+          }
+          hfMlResponse.fillInputFeatures(candidate, o2::constants::physics::kD0, inputFeaturesMl[nInputsMl++]);
+          ptCandsMl.push_back(ptCand);
+          idxHypoMl.push_back(2 * statusCands.size());
         }
         if (statusD0bar > 0) {
-          std::vector<float> inputFeaturesD0bar = hfMlResponse.getInputFeatures(candidate, o2::constants::physics::kD0Bar);
-          isSelectedMlD0bar = hfMlResponse.isSelectedMl(inputFeaturesD0bar, ptCand, outputMlD0bar);
+          if (nInputsMl == inputFeaturesMl.size()) {
+            inputFeaturesMl.emplace_back();
+          }
+          hfMlResponse.fillInputFeatures(candidate, o2::constants::physics::kD0Bar, inputFeaturesMl[nInputsMl++]);
+          ptCandsMl.push_back(ptCand);
+          idxHypoMl.push_back(2 * statusCands.size() + 1);
         }
+      }
+      statusCands.push_back({statusD0, statusD0bar, statusHFFlag, statusTopol, statusCand, statusPID});
+    }
+
+    if (!applyMl) {
+      for (const auto& status : statusCands) {
+        hfSelD0Candidate(status[0], status[1], status[2], status[3], status[4], status[5]);
+      }
+      return;
+    }
+
+    // ML selections
+    inputFeaturesMl.resize(nInputsMl);
+    auto scoresMl = hfMlResponse.isSelectedMlBatch(inputFeaturesMl, ptCandsMl, isSelectedMl, static_cast<std::size_t>(maxBatchSizeMl.value));
+    const auto nClasses = static_cast<std::size_t>(nClassesMl.value);
+    std::size_t iHypoMl{0};
+    std::size_t iCand{0};
+    for (const auto& candidate : candidates) {
+      auto& status = statusCands[iCand];
+      outputMlD0.clear();
+      outputMlD0bar.clear();
+      bool isSelectedMlD0 = false;
+      bool isSelectedMlD0bar = false;
+
+      for (; iHypoMl < idxHypoMl.size() && idxHypoMl[iHypoMl] / 2 == iCand; ++iHypoMl) {
+        const auto scoresCand = scoresMl.subspan(iHypoMl * nClasses, nClasses);
+        if (idxHypoMl[iHypoMl] % 2 == 0) {
+          outputMlD0.assign(scoresCand.begin(), scoresCand.end());
+          isSelectedMlD0 = isSelectedMl[iHypoMl];
+        } else {
+          outputMlD0bar.assign(scoresCand.begin(), scoresCand.end());
+          isSelectedMlD0bar = isSelectedMl[iHypoMl];
+        }
+      }
 
+      // candidates rejected before the ML step keep their status and get empty scores
+      if (status[0] > 0 || status[1] > 0) {
         if (!isSelectedMlD0) {
-          statusD0 = 0;
+          status[0] = 0;
         }
         if (!isSelectedMlD0bar) {
-          statusD0bar = 0;
+          status[1] = 0;
         }
 
-        hfMlD0Candidate(outputMlD0, outputMlD0bar);
-
         if (enableDebugMl) {
           if (isSelectedMlD0) {
-            registry.fill(HIST("DebugBdt/hBdtScore1VsStatus"), outputMlD0[0], statusD0);
-            registry.fill(HIST("DebugBdt/hBdtScore2VsStatus"), outputMlD0[1], statusD0);
-            registry.fill(HIST("DebugBdt/hBdtScore3VsStatus"), outputMlD0[2], statusD0);
+            registry.fill(HIST("DebugBdt/hBdtScore1VsStatus"), outputMlD0[0], status[0]);
+            registry.fill(HIST("DebugBdt/hBdtScore2VsStatus"), outputMlD0[1], status[0]);
+            registry.fill(HIST("DebugBdt/hBdtScore3VsStatus"), outputMlD0[2], status[0]);
             registry.fill(HIST("DebugBdt/hMassDmesonSel"), hfHelper.invMassD0ToPiK(candidate));
           }
           if (isSelectedMlD0bar) {
-            registry.fill(HIST("DebugBdt/hBdtScore1VsStatus"), outputMlD0bar[0], statusD0bar);
-            registry.fill(HIST("DebugBdt/hBdtScore2VsStatus"), outputMlD0bar[1], statusD0bar);
-            registry.fill(HIST("DebugBdt/hBdtScore3VsStatus"), outputMlD0bar[2], statusD0bar);
+            registry.fill(HIST("DebugBdt/hBdtScore1VsStatus"), outputMlD0bar[0], status[1]);
+            registry.fill(HIST("DebugBdt/hBdtScore2VsStatus"), outputMlD0bar[1], status[1]);
+            registry.fill(HIST("DebugBdt/hBdtScore3VsStatus"), outputMlD0bar[2], status[1]);
             registry.fill(HIST("DebugBdt/hMassDmesonSel"), hfHelper.invMassD0barToKPi(candidate));
           }
         }
       }
-      hfSelD0Candidate(statusD0, statusD0bar, statusHFFlag, statusTopol, statusCand, statusPID);
+      hfSelD0Candidate(status[0], status[1], status[2], status[3], status[4], status[5]);
+      hfMlD0Candidate(outputMlD0, outputMlD0bar);
+      ++iCand;
     }
   }
 
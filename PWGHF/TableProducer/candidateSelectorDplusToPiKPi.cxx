@@ -90,6 +90,7 @@ struct HfCandidateSelectorDplusToPiKPi {
   HfTrigger3ProngCuts hfTriggerCuts;
 
   using TracksSel = soa::Join<aod::TracksWExtra, aod::TracksPidPi, aod::PidTpcTofFullPi, aod::TracksPidKa, aod::PidTpcTofFullKa>;
+  using TracksPidStatus = soa::Join<aod::Tracks, aod::HfPidStatusTrack>;
 
   HistogramRegistry registry{"registry"};
 
@@ -216,8 +217,11 @@ struct HfCandidateSelectorDplusToPiKPi {
     return true;
   }
 
-  void process(aod::HfCand3ProngWPidPiKa const& candidates,
-               TracksSel const&)
+  /// Candidate selection
+  /// \tparam usePidStatus read the PID statuses from the HfPidStatusTrack table instead of evaluating them
+  /// \param candidates are the 3-prong candidates
+  template <bool usePidStatus, typename TTracks>
+  void runSelection(aod::HfCand3ProngWPidPiKa const& candidates)
   {
     // looping over 3-prong candidates
     for (const auto& candidate : candidates) {
@@ -242,9 +246,9 @@ struct HfCandidateSelectorDplusToPiKPi {
         registry.fill(HIST("hSelections"), 2 + aod::SelectionStep::RecoSkims, ptCand);
       }
 
-      auto trackPos1 = candidate.prong0_as<TracksSel>(); // positive daughter (negative for the antiparticles)
-      auto trackNeg = candidate.prong1_as<TracksSel>();  // negative daughter (positive for the antiparticles)
-      auto trackPos2 = candidate.prong2_as<TracksSel>(); // positive daughter (negative for the antiparticles)
+      auto trackPos1 = candidate.template prong0_as<TTracks>(); // positive daughter (negative for the antiparticles)
+      auto trackNeg = candidate.template prong1_as<TTracks>();  // negative daughter (positive for the antiparticles)
+      auto trackPos2 = candidate.template prong2_as<TTracks>(); // positive daughter (negative for the antiparticles)
 
       // topological selection
       if (!selection(candidate, trackPos1, trackNeg, trackPos2)) {
@@ -264,7 +268,12 @@ struct HfCandidateSelectorDplusToPiKPi {
       int pidTrackNegKaon = -1;
       int pidTrackPos2Pion = -1;
 
-      if (usePidTpcAndTof) {
+      if constexpr (usePidStatus) {
+        const auto selectionPid = usePidTpcAndTof ? TrackSelectorPID::TpcAndTof : TrackSelectorPID::TpcOrTof;
+        pidTrackPos1Pion = TrackSelectorPID::getStatus(trackPos1.pidStatusPi(), selectionPid);
+        pidTrackNegKaon = TrackSelectorPID::getStatus(trackNeg.pidStatusKa(), selectionPid);
+        pidTrackPos2Pion = TrackSelectorPID::getStatus(trackPos2.pidStatusPi(), selectionPid);
+      } else if (usePidTpcAndTof) {
         pidTrackPos1Pion = selectorPion.statusTpcAndTof(trackPos1, candidate.nSigTpcPi0(), candidate.nSigTofPi0());
         pidTrackNegKaon = selectorKaon.statusTpcAndTof(trackNeg, candidate.nSigTpcKa1(), candidate.nSigTofKa1());
         pidTrackPos2Pion = selectorPion.statusTpcAndTof(trackPos2, candidate.nSigTpcPi2(), candidate.nSigTofPi2());
@@ -305,6 +314,20 @@ struct HfCandidateSelectorDplusToPiKPi {
       hfSelDplusToPiKPiCandidate(statusDplusToPiKPi);
     }
   }
+
+  void processWithTrackPid(aod::HfCand3ProngWPidPiKa const& candidates,
+                           TracksSel const&)
+  {
+    runSelection<false, TracksSel>(candidates);
+  }
+  PROCESS_SWITCH(HfCandidateSelectorDplusToPiKPi, processWithTrackPid, "Select candidates evaluating the PID of the prongs", true);
+
+  void processWithPidStatus(aod::HfCand3ProngWPidPiKa const& candidates,
+                            TracksPidStatus const&)
+  {
+    runSelection<true, TracksPidStatus>(candidates);
+  }
+  PROCESS_SWITCH(HfCandidateSelectorDplusToPiKPi, processWithPidStatus, "Select candidates reading the PID statuses of the prongs from the pid-status-creator", false);
 };
 
 WorkflowSpec defineDataProcessing(ConfigContext const& cfgc)
@@ -85,6 +85,7 @@ struct HfCandidateSelectorDsToKKPi {
   o2::analysis::HfMlResponseDsToKKPi<float> hfMlResponse;
   std::vector<float> outputMlDsToKKPi = {};
   std::vector<float> outputMlDsToPiKK = {};
+  std::vector<float> inputFeaturesMl = {}; // reused for all the candidates
   o2::ccdb::CcdbApi ccdbApi;
   TrackSelectorPi selectorPion;
   TrackSelectorKa selectorKaon;
@@ -365,12 +366,12 @@ struct HfCandidateSelectorDsToKKPi {
         bool isSelectedMlDsToPiKK = false;
 
         if (topolDsToKKPi && pidDsToKKPi) {
-          std::vector<float> inputFeaturesDsToKKPi = hfMlResponse.getInputFeatures(candidate, true);
-          isSelectedMlDsToKKPi = hfMlResponse.isSelectedMl(inputFeaturesDsToKKPi, candidate.pt(), outputMlDsToKKPi);
+          hfMlResponse.fillInputFeatures(candidate, true, inputFeaturesMl);
+          isSelectedMlDsToKKPi = hfMlResponse.isSelectedMl(inputFeaturesMl, candidate.pt(), outputMlDsToKKPi);
         }
         if (topolDsToPiKK && pidDsToPiKK) {
-          std::vector<float> inputFeaturesDsToPiKK = hfMlResponse.getInputFeatures(candidate, false);
-          isSelectedMlDsToPiKK = hfMlResponse.isSelectedMl(inputFeaturesDsToPiKK, candidate.pt(), outputMlDsToPiKK);
+          hfMlResponse.fillInputFeatures(candidate, false, inputFeaturesMl);
+          isSelectedMlDsToPiKK = hfMlResponse.isSelectedMl(inputFeaturesMl, candidate.pt(), outputMlDsToPiKK);
         }
 
         hfMlDsToKKPiCandidate(outputMlDsToKKPi, outputMlDsToPiKK);
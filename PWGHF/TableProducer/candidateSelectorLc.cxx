@@ -97,6 +97,7 @@ struct HfCandidateSelectorLc {
   o2::analysis::HfMlResponseLcToPKPi<float, aod::hf_cand::VertexerType::KfParticle> hfMlResponseKF;
   std::vector<float> outputMlLcToPKPi = {};
   std::vector<float> outputMlLcToPiKP = {};
+  std::vector<float> inputFeaturesMl = {}; // reused for all the candidates
   o2::ccdb::CcdbApi ccdbApi;
   TrackSelectorPi selectorPion;
   TrackSelectorKa selectorKaon;
@@ -569,21 +570,21 @@ struct HfCandidateSelectorLc {
 
         if constexpr (reconstructionType == aod::hf_cand::VertexerType::DCAFitter) {
           if (pidLcToPKPi == 1 && pidBayesLcToPKPi == 1 && topolLcToPKPi) {
-            std::vector<float> inputFeaturesLcToPKPi = hfMlResponseDCA.getInputFeatures(candidate, true);
-            isSelectedMlLcToPKPi = hfMlResponseDCA.isSelectedMl(inputFeaturesLcToPKPi, candidate.pt(), outputMlLcToPKPi);
+            hfMlResponseDCA.fillInputFeatures(candidate, true, inputFeaturesMl);
+            isSelectedMlLcToPKPi = hfMlResponseDCA.isSelectedMl(inputFeaturesMl, candidate.pt(), outputMlLcToPKPi);
           }
           if (pidLcToPiKP == 1 && pidBayesLcToPiKP == 1 && topolLcToPiKP) {
-            std::vector<float> inputFeaturesLcToPiKP = hfMlResponseDCA.getInputFeatures(candidate, false);
-            isSelectedMlLcToPiKP = hfMlResponseDCA.isSelectedMl(inputFeaturesLcToPiKP, candidate.pt(), outputMlLcToPiKP);
+            hfMlResponseDCA.fillInputFeatures(candidate, false, inputFeaturesMl);
+            isSelectedMlLcToPiKP = hfMlResponseDCA.isSelectedMl(inputFeaturesMl, candidate.pt(), outputMlLcToPiKP);
           }
         } else {
           if (pidLcToPKPi == 1 && pidBayesLcToPKPi == 1 && topolLcToPKPi) {
-            std::vector<float> inputFeaturesLcToPKPi = hfMlResponseKF.getInputFeatures(candidate, true);
-            isSelectedMlLcToPKPi = hfMlResponseKF.isSelectedMl(inputFeaturesLcToPKPi, candidate.pt(), outputMlLcToPKPi);
+            hfMlResponseKF.fillInputFeatures(candidate, true, inputFeaturesMl);
+            isSelectedMlLcToPKPi = hfMlResponseKF.isSelectedMl(inputFeaturesMl, candidate.pt(), outputMlLcToPKPi);
           }
           if (pidLcToPiKP == 1 && pidBayesLcToPiKP == 1 && topolLcToPiKP) {
-            std::vector<float> inputFeaturesLcToPiKP = hfMlResponseKF.getInputFeatures(candidate, false);
-            isSelectedMlLcToPiKP = hfMlResponseKF.isSelectedMl(inputFeaturesLcToPiKP, candidate.pt(), outputMlLcToPiKP);
+            hfMlResponseKF.fillInputFeatures(candidate, false, inputFeaturesMl);
+            isSelectedMlLcToPiKP = hfMlResponseKF.isSelectedMl(inputFeaturesMl, candidate.pt(), outputMlLcToPiKP);
           }
         }
 
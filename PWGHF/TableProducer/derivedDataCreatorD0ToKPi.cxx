@@ -35,12 +35,14 @@
 #include "PWGHF/DataModel/DerivedTables.h"
 #include "PWGHF/Utils/utilsDerivedData.h"
 #include "PWGHF/Utils/utilsPid.h"
+#include "PWGHF/Utils/utilsTreeCreator.h"
 
 using namespace o2;
 using namespace o2::framework;
 using namespace o2::framework::expressions;
 using namespace o2::aod::pid_tpc_tof_utils;
 using namespace o2::analysis::hf_derived;
+using namespace o2::analysis::hf_trees;
 
 /// Writes the full information in an output TTree
 struct HfDerivedDataCreatorD0ToKPi {
@@ -246,7 +248,7 @@ struct HfDerivedDataCreatorD0ToKPi {
       // Skip collisions without HF candidates (and without HF particles in matched MC collisions if saving indices of reconstructed collisions matched to MC collisions)
       bool mcCollisionHasMcParticles{false};
       if constexpr (isMc) {
-        mcCollisionHasMcParticles = confDerData.fillMcRCollId && collision.has_mcCollision() && rowsCommon.hasMcParticles[collision.mcCollisionId()];
+        mcCollisionHasMcParticles = confDerData.fillMcRCollId && collision.has_mcCollision() && rowsCommon.mcCollisionHasMcParticles(collision.mcCollisionId());
         LOGF(debug, "Rec. collision %d has MC collision %d with MC particles? %s", thisCollId, collision.mcCollisionId(), mcCollisionHasMcParticles ? "yes" : "no");
       }
       if (sizeTableCand == 0 && (!confDerData.fillMcRCollId || !mcCollisionHasMcParticles)) {
@@ -275,11 +277,8 @@ struct HfDerivedDataCreatorD0ToKPi {
             if (TESTBIT(std::abs(flagMcRec), aod::hf_cand_2prong::DecayType::D0ToPiK)) {
               continue;
             }
-            if (downSampleBkgFactor < 1.) {
-              float pseudoRndm = candidate.ptProng0() * 1000. - static_cast<int64_t>(candidate.ptProng0() * 1000);
-              if (candidate.pt() < ptMaxForDownSample && pseudoRndm >= downSampleBkgFactor) {
-                continue;
-              }
+            if (!isKeptByDownSampling(candidate.ptProng0(), candidate.pt(), downSampleBkgFactor, ptMaxForDownSample)) {
+              continue;
             }
           }
           if constexpr (onlySig) {
@@ -288,11 +287,8 @@ struct HfDerivedDataCreatorD0ToKPi {
             }
           }
         } else {
-          if (downSampleBkgFactor < 1.) {
-            float pseudoRndm = candidate.ptProng0() * 1000. - static_cast<int64_t>(candidate.ptProng0() * 1000);
-            if (candidate.pt() < ptMaxForDownSample && pseudoRndm >= downSampleBkgFactor) {
-              continue;
-            }
+          if (!isKeptByDownSampling(candidate.ptProng0(), candidate.pt(), downSampleBkgFactor, ptMaxForDownSample)) {
+            continue;
           }
         }
 
@@ -0,0 +1,101 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file eventSelectionCreator.cxx
+/// \brief Workflow to produce the table of the HF event selection of the collisions
+///
+/// The rejection mask of HfEventSelection, the centrality and the occupancy are evaluated once per collision,
+/// together with the CCDB, Zorro and RCT lookups and the monitoring histograms, so that the HF workflows of
+/// the same train can join the table with the collisions and filter on it instead of running the selection
+/// each. The selection must be configured as the one the reading workflows would apply.
+
+#include "PWGHF/Core/CentralityEstimation.h"
+#include "PWGHF/DataModel/CandidateReconstructionTables.h"
+#include "PWGHF/Utils/utilsEvSelHf.h"
+
+#include "Common/DataModel/Centrality.h"
+#include "Common/DataModel/EventSelection.h"
+
+#include "CCDB/BasicCCDBManager.h"
+#include "Framework/AnalysisTask.h"
+#include "Framework/HistogramRegistry.h"
+#include "Framework/runDataProcessing.h"
+
+#include <array>
+#include <numeric>
+#include <string>
+
+using namespace o2;
+using namespace o2::framework;
+using namespace o2::hf_evsel;
+using namespace o2::hf_centrality;
+using namespace o2::hf_occupancy;
+
+struct HfEventSelectionCreator {
+  Produces<aod::HfEvSelColls> rowEvSel;
+
+  Configurable<std::string> ccdbUrl{"ccdbUrl", "http://alice-ccdb.cern.ch", "url of the ccdb repository"};
+
+  HfEventSelection hfEvSel; // event selection and monitoring
+  Service<o2::ccdb::BasicCCDBManager> ccdb;
+
+  HistogramRegistry registry{"registry"};
+
+  void init(InitContext const&)
+  {
+    std::array<bool, 3> doProcess = {doprocessNoCentrality, doprocessCentFT0C, doprocessCentFT0M};
+    if (std::accumulate(doProcess.begin(), doProcess.end(), 0) != 1) {
+      LOGP(fatal, "One and only one process function must be enabled at a time.");
+    }
+
+    ccdb->setURL(ccdbUrl);
+    ccdb->setCaching(true);
+    ccdb->setLocalObjectValidityChecking();
+
+    hfEvSel.init(registry);
+  }
+
+  template <CentralityEstimator centEstimator, typename Coll>
+  void runEventSelection(Coll const& collisions)
+  {
+    rowEvSel.reserve(collisions.size());
+    for (const auto& collision : collisions) {
+      float centrality{-1.f};
+      const float occupancy = getOccupancyColl(collision, hfEvSel.occEstimator);
+      const auto rejectionMask = hfEvSel.getHfCollisionRejectionMask<true, centEstimator, aod::BCsWithTimestamps>(collision, centrality, ccdb, registry);
+      hfEvSel.fillHistograms(collision, rejectionMask, centrality, occupancy);
+      rowEvSel(rejectionMask, centrality, occupancy);
+    }
+  }
+
+  void processNoCentrality(soa::Join<aod::Collisions, aod::EvSels> const& collisions, aod::BCsWithTimestamps const&)
+  {
+    runEventSelection<CentralityEstimator::None>(collisions);
+  }
+  PROCESS_SWITCH(HfEventSelectionCreator, processNoCentrality, "Event selection without centrality", true);
+
+  void processCentFT0C(soa::Join<aod::Collisions, aod::EvSels, aod::CentFT0Cs> const& collisions, aod::BCsWithTimestamps const&)
+  {
+    runEventSelection<CentralityEstimator::FT0C>(collisions);
+  }
+  PROCESS_SWITCH(HfEventSelectionCreator, processCentFT0C, "Event selection with FT0C centrality", false);
+
+  void processCentFT0M(soa::Join<aod::Collisions, aod::EvSels, aod::CentFT0Ms> const& collisions, aod::BCsWithTimestamps const&)
+  {
+    runEventSelection<CentralityEstimator::FT0M>(collisions);
+  }
+  PROCESS_SWITCH(HfEventSelectionCreator, processCentFT0M, "Event selection with FT0M centrality", false);
+};
+
+WorkflowSpec defineDataProcessing(ConfigContext const& cfgc)
+{
+  return WorkflowSpec{adaptAnalysisTask<HfEventSelectionCreator>(cfgc)};
+}
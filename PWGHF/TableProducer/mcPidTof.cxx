@@ -512,11 +512,12 @@ struct tofEventTime {
   /// Process function to prepare the event for each track on Run 3 data without the FT0
   // Define slice per collision
   Preslice<TrksWtof> perCollision = aod::track::collisionId;
+  o2::pid::tof::TOFEventTimeCache mEvTimeCache; // TOF event time per collision of the dataframe
   template <o2::track::PID::ID pid>
   using ResponseImplementationEvTime = o2::pid::tof::ExpTimes<TrksWtof::iterator, pid>;
   void process(TrksWtof const& tracks,
                aod::FT0s const&,
-               EvTimeCollisionsFT0 const&,
+               EvTimeCollisionsFT0 const& collisions,
                aod::BCsWithTimestamps const& bcs)
   {
     if (!enableTableTOFEvTime) {
@@ -551,8 +552,8 @@ struct tofEventTime {
     LOG(debug) << "Running on " << CollisionSystemType::getCollisionSystemName(mTOFCalibConfig.collisionSystem()) << " mComputeEvTimeWithTOF " << mComputeEvTimeWithTOF.value << " mComputeEvTimeWithFT0 " << mComputeEvTimeWithFT0.value;
 
     if (mComputeEvTimeWithTOF == 1 && mComputeEvTimeWithFT0 == 1) {
-      int lastCollisionId = -1;                                                                                       // Last collision ID analysed
-      for (auto const& t : tracks) {                                                                                  // Loop on collisions
+      mEvTimeCache.reset(collisions.size());
+      for (auto const& t : tracks) {                                                                                  // Loop on tracks
         if (!t.has_collision() || ((sel8TOFEvTime.value == true) && !t.collision_as<EvTimeCollisionsFT0>().sel8())) { // Track was not assigned, cannot compute event time or event did not pass the event selection
           tableFlags(0);
           tableEvTime(0.f, 999.f);
@@ -561,75 +562,60 @@ struct tofEventTime {
           }
           continue;
         }
-        if (t.collisionId() == lastCollisionId) { // Event time from this collision is already in the table
-          continue;
-        }
-        /// Create new table for the tracks in a collision
-        lastCollisionId = t.collisionId(); /// Cache last collision ID
-
-        const auto& tracksInCollision = tracks.sliceBy(perCollision, lastCollisionId);
         const auto& collision = t.collision_as<EvTimeCollisionsFT0>();
 
-        // Compute the TOF event time
-        const auto evTimeMakerTOF = evTimeMakerForTracks<TrksWtof::iterator, filterForTOFEventTime, o2::pid::tof::ExpTimes>(tracksInCollision, mRespParamsV3, diamond);
-
-        float t0AC[2] = {.0f, 999.f};                                                                                             // Value and error of T0A or T0C or T0AC
-        float t0TOF[2] = {static_cast<float_t>(evTimeMakerTOF.mEventTime), static_cast<float_t>(evTimeMakerTOF.mEventTimeError)}; // Value and error of TOF
+        // TOF event time of the collision, computed when its first track is met
+        auto& evTimeTOF = mEvTimeCache.get(t.collisionId(), [&]() {
+          const auto& tracksInCollision = tracks.sliceBy(perCollision, t.collisionId());
+          return evTimeMakerForTracks<TrksWtof::iterator, filterForTOFEventTime, o2::pid::tof::ExpTimes>(tracksInCollision, mRespParamsV3, diamond);
+        });
+        // Remove the bias on TOF ev. time
+        if constexpr (removeTOFEvTimeBias) {
+          o2::pid::tof::TOFEventTimeCache::removeBias<TrksWtof::iterator, filterForTOFEventTime>(evTimeTOF, t);
+        }
+        const float t0TOF[2] = {evTimeTOF.eventTime, evTimeTOF.eventTimeError}; // Value and error of TOF
+        float t0AC[2] = {.0f, 999.f};                                             // Value and error of T0A or T0C or T0AC
 
         uint8_t flags = 0;
-        int nGoodTracksForTOF = 0;
         float eventTime = 0.f;
         float sumOfWeights = 0.f;
         float weight = 0.f;
+        if (t0TOF[1] < errDiamond && (maxEvTimeTOF <= 0 || std::abs(t0TOF[0]) < maxEvTimeTOF)) {
+          flags |= o2::aod::pidflags::enums::PIDFlags::EvTimeTOF;
 
-        for (auto const& trk : tracksInCollision) { // Loop on Tracks
-          // Reset the flag
-          flags = 0;
-          // Reset the event time
-          eventTime = 0.f;
-          sumOfWeights = 0.f;
-          weight = 0.f;
-          // Remove the bias on TOF ev. time
-          if constexpr (removeTOFEvTimeBias) {
-            evTimeMakerTOF.removeBias<TrksWtof::iterator, filterForTOFEventTime>(trk, nGoodTracksForTOF, t0TOF[0], t0TOF[1], 2);
-          }
-          if (t0TOF[1] < errDiamond && (maxEvTimeTOF <= 0 || std::abs(t0TOF[0]) < maxEvTimeTOF)) {
-            flags |= o2::aod::pidflags::enums::PIDFlags::EvTimeTOF;
+          weight = 1.f / (t0TOF[1] * t0TOF[1]);
+          eventTime += t0TOF[0] * weight;
+          sumOfWeights += weight;
+        }
 
-            weight = 1.f / (t0TOF[1] * t0TOF[1]);
-            eventTime += t0TOF[0] * weight;
-            sumOfWeights += weight;
+        if (collision.has_foundFT0()) { // T0 measurement is available
+          // const auto& ft0 = collision.foundFT0();
+          if (collision.t0ACValid()) {
+            t0AC[0] = collision.t0AC() * 1000.f;
+            t0AC[1] = collision.t0resolution() * 1000.f;
+            flags |= o2::aod::pidflags::enums::PIDFlags::EvTimeT0AC;
           }
 
-          if (collision.has_foundFT0()) { // T0 measurement is available
-            // const auto& ft0 = collision.foundFT0();
-            if (collision.t0ACValid()) {
-              t0AC[0] = collision.t0AC() * 1000.f;
-              t0AC[1] = collision.t0resolution() * 1000.f;
-              flags |= o2::aod::pidflags::enums::PIDFlags::EvTimeT0AC;
-            }
-
-            weight = 1.f / (t0AC[1] * t0AC[1]);
-            eventTime += t0AC[0] * weight;
-            sumOfWeights += weight;
-          }
+          weight = 1.f / (t0AC[1] * t0AC[1]);
+          eventTime += t0AC[0] * weight;
+          sumOfWeights += weight;
+        }
 
-          if (sumOfWeights < weightDiamond) { // avoiding sumOfWeights = 0 or worse that diamond
-            eventTime = 0;
-            sumOfWeights = weightDiamond;
-            tableFlags(0);
-          } else {
-            tableFlags(flags);
-          }
-          tableEvTime(eventTime / sumOfWeights, std::sqrt(1. / sumOfWeights));
-          if (enableTableEvTimeTOFOnly) {
-            tableEvTimeTOFOnly((uint8_t)filterForTOFEventTime(trk), t0TOF[0], t0TOF[1], evTimeMakerTOF.mEventTimeMultiplicity);
-          }
+        if (sumOfWeights < weightDiamond) { // avoiding sumOfWeights = 0 or worse that diamond
+          eventTime = 0;
+          sumOfWeights = weightDiamond;
+          tableFlags(0);
+        } else {
+          tableFlags(flags);
+        }
+        tableEvTime(eventTime / sumOfWeights, std::sqrt(1. / sumOfWeights));
+        if (enableTableEvTimeTOFOnly) {
+          tableEvTimeTOFOnly((uint8_t)filterForTOFEventTime(t), t0TOF[0], t0TOF[1], evTimeTOF.evTime->mEventTimeMultiplicity);
         }
       }
     } else if (mComputeEvTimeWithTOF == 1 && mComputeEvTimeWithFT0 == 0) {
-      int lastCollisionId = -1;                                                                                    // Last collision ID analysed
-      for (auto const& t : tracks) {                                                                               // Loop on collisions
+      mEvTimeCache.reset(collisions.size());
+      for (auto const& t : tracks) {                                                                               // Loop on tracks
         if (!t.has_collision() || ((sel8TOFEvTime.value == true) && !t.collision_as<EvTimeCollisions>().sel8())) { // Track was not assigned, cannot compute event time or event did not pass the event selection
           tableFlags(0);
           tableEvTime(0.f, 999.f);
@@ -638,36 +624,28 @@ struct tofEventTime {
           }
           continue;
         }
-        if (t.collisionId() == lastCollisionId) { // Event time from this collision is already in the table
-          continue;
-        }
-        /// Create new table for the tracks in a collision
-        lastCollisionId = t.collisionId(); /// Cache last collision ID
-
-        const auto& tracksInCollision = tracks.sliceBy(perCollision, lastCollisionId);
-
-        // First make table for event time
-        const auto evTimeMakerTOF = evTimeMakerForTracks<TrksWtof::iterator, filterForTOFEventTime, o2::pid::tof::ExpTimes>(tracksInCollision, mRespParamsV3, diamond);
-        int nGoodTracksForTOF = 0;
-        float et = evTimeMakerTOF.mEventTime;
-        float erret = evTimeMakerTOF.mEventTimeError;
 
-        for (auto const& trk : tracksInCollision) { // Loop on Tracks
-          if constexpr (removeTOFEvTimeBias) {
-            evTimeMakerTOF.removeBias<TrksWtof::iterator, filterForTOFEventTime>(trk, nGoodTracksForTOF, et, erret, 2);
-          }
-          uint8_t flags = 0;
-          if (erret < errDiamond && (maxEvTimeTOF <= 0.f || std::abs(et) < maxEvTimeTOF)) {
-            flags |= o2::aod::pidflags::enums::PIDFlags::EvTimeTOF;
-          } else {
-            et = 0.f;
-            erret = errDiamond;
-          }
-          tableFlags(flags);
-          tableEvTime(et, erret);
-          if (enableTableEvTimeTOFOnly) {
-            tableEvTimeTOFOnly((uint8_t)filterForTOFEventTime(trk), et, erret, evTimeMakerTOF.mEventTimeMultiplicity);
-          }
+        // TOF event time of the collision, computed when its first track is met
+        auto& evTimeTOF = mEvTimeCache.get(t.collisionId(), [&]() {
+          const auto& tracksInCollision = tracks.sliceBy(perCollision, t.collisionId());
+          return evTimeMakerForTracks<TrksWtof::iterator, filterForTOFEventTime, o2::pid::tof::ExpTimes>(tracksInCollision, mRespParamsV3, diamond);
+        });
+        if constexpr (removeTOFEvTimeBias) {
+          o2::pid::tof::TOFEventTimeCache::removeBias<TrksWtof::iterator, filterForTOFEventTime>(evTimeTOF, t);
+        }
+        float& et = evTimeTOF.eventTime;
+        float& erret = evTimeTOF.eventTimeError;
+        uint8_t flags = 0;
+        if (erret < errDiamond && (maxEvTimeTOF <= 0.f || std::abs(et) < maxEvTimeTOF)) {
+          flags |= o2::aod::pidflags::enums::PIDFlags::EvTimeTOF;
+        } else {
+          et = 0.f;
+          erret = errDiamond;
+        }
+        tableFlags(flags);
+        tableEvTime(et, erret);
+        if (enableTableEvTimeTOFOnly) {
+          tableEvTimeTOFOnly((uint8_t)filterForTOFEventTime(t), et, erret, evTimeTOF.evTime->mEventTimeMultiplicity);
         }
       }
     } else if (mComputeEvTimeWithTOF == 0 && mComputeEvTimeWithFT0 == 1) {
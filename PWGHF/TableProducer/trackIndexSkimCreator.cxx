@@ -23,6 +23,9 @@
 
 #include <algorithm> // std::find
 #include <iterator>  // std::distance
+#include <map>       // std::map
+#include <memory>    // std::unique_ptr
+#include <span>      // std::span
 #include <string>    // std::string
 #include <vector>    // std::vector
 
@@ -36,6 +39,7 @@
 #include "Framework/AnalysisTask.h"
 #include "Framework/HistogramRegistry.h"
 #include "Framework/runDataProcessing.h"
+#include "ReconstructionDataFormats/PrimaryVertex.h" // for PV refit
 #include "ReconstructionDataFormats/V0.h"
 #include "ReconstructionDataFormats/Vertex.h" // for PV refit
 
@@ -1136,6 +1140,7 @@ struct HfTrackIndexSkimCreator {
     Configurable<bool> doDstar{"doDstar", false, "do D* candidates"};
     Configurable<bool> debug{"debug", false, "debug mode"};
     Configurable<bool> debugPvRefit{"debugPvRefit", false, "debug lines for primary vertex refit"};
+    Configurable<bool> cachePvRefit{"cachePvRefit", true, "prepare the PV refit once per collision and reuse the refits of the same removed daughters"};
     Configurable<bool> fillHistograms{"fillHistograms", true, "fill histograms"};
     // Configurable<int> nCollsMax{"nCollsMax", -1, "Max collisions per file"}; //can be added to run over limited collisions per file - for tesing purposes
     // preselection
@@ -1229,6 +1234,47 @@ struct HfTrackIndexSkimCreator {
   static constexpr int kNCutsDstar = 3;                                                                                                                                                         // how many different selections are made on Dstars
   std::array<std::array<std::array<double, 2>, 2>, kN2ProngDecays> arrMass2Prong;
   std::array<std::array<std::array<double, 3>, 2>, kN3ProngDecays> arrMass3Prong;
+  // distinct daughter masses and, for each decay hypothesis, indices of the daughter masses in it
+  std::vector<double> massesDaughters;
+  std::array<std::array<std::array<int, 2>, 2>, kN2ProngDecays> arrMassIdx2Prong;
+  std::array<std::array<std::array<int, 3>, 2>, kN3ProngDecays> arrMassIdx3Prong;
+
+  /// Daughter quantities of the tracks of one sign in the current collision,
+  /// computed once per track and shared by all the combinations it enters
+  struct TrackCache {
+    std::vector<o2::track::TrackParCov> trackParVar; // re-propagated to the collision if not the default one
+    std::vector<std::array<float, 3>> pVec;          // momentum at the DCA to the collision
+    std::vector<std::array<float, 2>> dcaInfo;       // DCA xy, z to the collision
+    std::vector<double> energy;                      // energy for each of the daughter masses, per track
+    std::size_t nMasses{0};
+
+    void clear()
+    {
+      trackParVar.clear();
+      pVec.clear();
+      dcaInfo.clear();
+      energy.clear();
+    }
+
+    std::span<const double> energies(std::size_t iTrack) const
+    {
+      return std::span<const double>(energy.data() + iTrack * nMasses, nMasses);
+    }
+  };
+  TrackCache tracksPosCache;
+  TrackCache tracksNegCache;
+
+  /// PV refit of the current collision: the vertexer is prepared once with all the
+  /// contributors, refits are stored by the sorted global indices of the removed daughters
+  struct PvRefitCache {
+    int64_t collisionId{-1};
+    std::unique_ptr<o2::vertexing::PVertexer> vertexer;
+    o2::dataformats::VertexBase primVtx;
+    bool pvRefitDoable{false};
+    std::map<std::vector<int64_t>, o2::dataformats::PrimaryVertex> refits;
+  };
+  PvRefitCache pvRefitCache;
+
   // arrays of 2-prong and 3-prong cuts
   std::array<LabeledArray<double>, kN2ProngDecays> cut2Prong;
   std::array<std::vector<double>, kN2ProngDecays> pTBins2Prong;
@@ -1302,6 +1348,31 @@ struct HfTrackIndexSkimCreator {
     arrMass3Prong[hf_cand_3prong::DecayType::XicToPKPi] = std::array{std::array{massProton, massK, massPi},
                                                                      std::array{massPi, massK, massProton}};
 
+    // daughter energies are cached per track for each distinct mass
+    auto indexOfMass = [this](double mass) {
+      auto itMass = std::find(massesDaughters.begin(), massesDaughters.end(), mass);
+      if (itMass == massesDaughters.end()) {
+        massesDaughters.push_back(mass);
+        return static_cast<int>(massesDaughters.size()) - 1;
+      }
+      return static_cast<int>(std::distance(massesDaughters.begin(), itMass));
+    };
+    for (int iDecay2P = 0; iDecay2P < kN2ProngDecays; iDecay2P++) {
+      for (int iHypo = 0; iHypo < 2; iHypo++) {
+        for (int iProng = 0; iProng < 2; iProng++) {
+          arrMassIdx2Prong[iDecay2P][iHypo][iProng] = indexOfMass(arrMass2Prong[iDecay2P][iHypo][iProng]);
+        }
+      }
+    }
+    for (int iDecay3P = 0; iDecay3P < kN3ProngDecays; iDecay3P++) {
+      for (int iHypo = 0; iHypo < 2; iHypo++) {
+        for (int iProng = 0; iProng < 3; iProng++) {
+          arrMassIdx3Prong[iDecay3P][iHypo][iProng] = indexOfMass(arrMass3Prong[iDecay3P][iHypo][iProng]);
+        }
+      }
+    }
+    tracksPosCache.nMasses = tracksNegCache.nMasses = massesDaughters.size();
+
     // cuts for 2-prong decays retrieved by json. the order must be then one in hf_cand_2prong::DecayType
     cut2Prong = {config.cutsD0ToPiK, config.cutsJpsiToEE, config.cutsJpsiToMuMu};
     pTBins2Prong = {config.binsPtD0ToPiK, config.binsPtJpsiToEE, config.binsPtJpsiToMuMu};
@@ -1443,17 +1514,63 @@ struct HfTrackIndexSkimCreator {
     }
   }
 
+  /// Invariant mass squared from the daughter momenta and energies, same arithmetic as RecoDecay::m2
+  /// \param arrMom is the array of the daughter momentum arrays
+  /// \param arrEnergy is the array of the daughter energies (in the same order as arrMom)
+  /// \return invariant mass squared
+  template <std::size_t N>
+  static double m2FromEnergies(const std::array<std::array<float, 3>, N>& arrMom, const std::array<double, N>& arrEnergy)
+  {
+    std::array<double, 3> momTotal{0., 0., 0.};
+    double energyTot{0.};
+    for (std::size_t iProng = 0; iProng < N; ++iProng) {
+      for (std::size_t iMom = 0; iMom < 3; ++iMom) {
+        momTotal[iMom] += arrMom[iProng][iMom];
+      }
+      energyTot += arrEnergy[iProng];
+    }
+    return energyTot * energyTot - RecoDecay::p2(momTotal);
+  }
+
+  /// Method to fill the daughter quantities of the tracks of one sign in a collision
+  /// \param collision is the collision
+  /// \param groupedTrackIndices are the track indices of the collision
+  /// \param tracksCache is the cache to be filled, in the order of groupedTrackIndices
+  template <typename TTracks, typename TCollision, typename TTrackIndices>
+  void fillTrackCache(TCollision const& collision, TTrackIndices const& groupedTrackIndices, TrackCache& tracksCache)
+  {
+    tracksCache.clear();
+    for (const auto& trackIndex : groupedTrackIndices) {
+      auto track = trackIndex.template track_as<TTracks>();
+      auto trackParVar = getTrackParCov(track);
+      std::array<float, 3> pVecTrack{track.pVector()};
+      std::array<float, 2> dcaInfo{track.dcaXY(), track.dcaZ()};
+      if (collision.globalIndex() != track.collisionId()) { // this is not the "default" collision for this track, we have to re-propagate it
+        o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParVar, 2.f, noMatCorr, &dcaInfo);
+        getPxPyPz(trackParVar, pVecTrack);
+      }
+      for (const auto& mass : massesDaughters) {
+        tracksCache.energy.push_back(RecoDecay::e(pVecTrack, mass));
+      }
+      tracksCache.trackParVar.push_back(trackParVar);
+      tracksCache.pVec.push_back(pVecTrack);
+      tracksCache.dcaInfo.push_back(dcaInfo);
+    }
+  }
+
   /// Method to perform selections for 2-prong candidates before vertex reconstruction
   /// \param pVecTrack0 is the momentum array of the first daughter track
   /// \param pVecTrack1 is the momentum array of the second daughter track
   /// \param dcaTrack0 is the dcaXY of the first daughter track
   /// \param dcaTrack1 is the dcaXY of the second daughter track
+  /// \param energiesTrack0 are the energies of the first daughter track for the daughter masses
+  /// \param energiesTrack1 are the energies of the second daughter track for the daughter masses
   /// \param cutStatus is a 2D array with outcome of each selection (filled only in debug mode)
   /// \param whichHypo information of the mass hypoteses that were selected
   /// \param isSelected is a bitmap with selection outcome
   /// \param pt2Prong is the pt of the 2-prong candidate
   template <typename T1, typename T2, typename T3, typename T4>
-  void applyPreselection2Prong(T1 const& pVecTrack0, T1 const& pVecTrack1, T2 const& dcaTrack0, T2 const& dcaTrack1, T3& cutStatus, T4& whichHypo, int& isSelected, float& pt2Prong)
+  void applyPreselection2Prong(T1 const& pVecTrack0, T1 const& pVecTrack1, T2 const& dcaTrack0, T2 const& dcaTrack1, std::span<const double> energiesTrack0, std::span<const double> energiesTrack1, T3& cutStatus, T4& whichHypo, int& isSelected, float& pt2Prong)
   {
     whichHypo[kN2ProngDecays] = 0; // D0 for D*
 
@@ -1483,8 +1600,9 @@ struct HfTrackIndexSkimCreator {
       double max2 = maxMass * maxMass;
 
       if ((config.debug || TESTBIT(isSelected, iDecay2P)) && minMass >= 0. && maxMass > 0.) {
-        massHypos[0] = RecoDecay::m2(arrMom, arrMass2Prong[iDecay2P][0]);
-        massHypos[1] = (iDecay2P == hf_cand_2prong::DecayType::D0ToPiK) ? RecoDecay::m2(arrMom, arrMass2Prong[iDecay2P][1]) : massHypos[0];
+        const auto& massIdx = arrMassIdx2Prong[iDecay2P];
+        massHypos[0] = m2FromEnergies(arrMom, std::array{energiesTrack0[massIdx[0][0]], energiesTrack1[massIdx[0][1]]});
+        massHypos[1] = (iDecay2P == hf_cand_2prong::DecayType::D0ToPiK) ? m2FromEnergies(arrMom, std::array{energiesTrack0[massIdx[1][0]], energiesTrack1[massIdx[1][1]]}) : massHypos[0];
         if (massHypos[0] < min2 || massHypos[0] >= max2) {
           CLRBIT(whichHypo[iDecay2P], 0);
         }
@@ -1533,21 +1651,23 @@ struct HfTrackIndexSkimCreator {
   /// \param pVecTrack0 is the momentum array of the first daughter track
   /// \param pVecTrack1 is the momentum array of the second daughter track
   /// \param pVecTrack2 is the momentum array of the third daughter track
+  /// \param energies are the energies of the three daughter tracks for the daughter masses
   /// \param cutStatus is a 2D array with outcome of each selection (filled only in debug mode)
   /// \param whichHypo information of the mass hypoteses that were selected
   /// \param isSelected is a bitmap with selection outcome
   template <typename T1, typename T2, typename T3>
-  void applyPreselectionPhiDecay(int& pTBin, T1 const& pVecTrack0, T1 const& pVecTrack1, T1 const& pVecTrack2, T2& cutStatus, T3& whichHypo, int& isSelected)
+  void applyPreselectionPhiDecay(int& pTBin, T1 const& pVecTrack0, T1 const& pVecTrack1, T1 const& pVecTrack2, std::array<std::span<const double>, 3> const& energies, T2& cutStatus, T3& whichHypo, int& isSelected)
   {
     double deltaMassMax = cut3Prong[hf_cand_3prong::DecayType::DsToKKPi].get(pTBin, 4u);
+    const auto& massIdx = arrMassIdx3Prong[hf_cand_3prong::DecayType::DsToKKPi];
     if (TESTBIT(whichHypo[hf_cand_3prong::DecayType::DsToKKPi], 0)) {
-      double mass2PhiKKPi = RecoDecay::m2(std::array{pVecTrack0, pVecTrack1}, std::array{arrMass3Prong[hf_cand_3prong::DecayType::DsToKKPi][0][0], arrMass3Prong[hf_cand_3prong::DecayType::DsToKKPi][0][1]});
+      double mass2PhiKKPi = m2FromEnergies(std::array{pVecTrack0, pVecTrack1}, std::array{energies[0][massIdx[0][0]], energies[1][massIdx[0][1]]});
       if (mass2PhiKKPi > (massPhi + deltaMassMax) * (massPhi + deltaMassMax) || mass2PhiKKPi < (massPhi - deltaMassMax) * (massPhi - deltaMassMax)) {
         CLRBIT(whichHypo[hf_cand_3prong::DecayType::DsToKKPi], 0);
       }
     }
     if (TESTBIT(whichHypo[hf_cand_3prong::DecayType::DsToKKPi], 1)) {
-      double mass2PhiPiKK = RecoDecay::m2(std::array{pVecTrack1, pVecTrack2}, std::array{arrMass3Prong[hf_cand_3prong::DecayType::DsToKKPi][1][1], arrMass3Prong[hf_cand_3prong::DecayType::DsToKKPi][1][2]});
+      double mass2PhiPiKK = m2FromEnergies(std::array{pVecTrack1, pVecTrack2}, std::array{energies[1][massIdx[1][1]], energies[2][massIdx[1][2]]});
       if (mass2PhiPiKK > (massPhi + deltaMassMax) * (massPhi + deltaMassMax) || mass2PhiPiKK < (massPhi - deltaMassMax) * (massPhi - deltaMassMax)) {
         CLRBIT(whichHypo[hf_cand_3prong::DecayType::DsToKKPi], 1);
       }
@@ -1567,11 +1687,12 @@ struct HfTrackIndexSkimCreator {
   /// \param pVecTrack2 is the momentum array of the third daughter track
   /// \param isIdentifiedPidTrack0 is the flag that tells if the track 0 has been tagged as a proton
   /// \param isIdentifiedPidTrack2 is the flag that tells if the track 2 has been tagged as a proton
+  /// \param energies are the energies of the three daughter tracks for the daughter masses
   /// \param cutStatus is a 2D array with outcome of each selection (filled only in debug mode)
   /// \param whichHypo information of the mass hypoteses that were selected
   /// \param isSelected is a bitmap with selection outcome
   template <typename T1, typename T2, typename T3>
-  void applyPreselection3Prong(T1 const& pVecTrack0, T1 const& pVecTrack1, T1 const& pVecTrack2, int8_t& isIdentifiedPidTrack0, int8_t& isIdentifiedPidTrack2, T2& cutStatus, T3& whichHypo, int& isSelected)
+  void applyPreselection3Prong(T1 const& pVecTrack0, T1 const& pVecTrack1, T1 const& pVecTrack2, int8_t& isIdentifiedPidTrack0, int8_t& isIdentifiedPidTrack2, std::array<std::span<const double>, 3> const& energies, T2& cutStatus, T3& whichHypo, int& isSelected)
   {
 
     auto arrMom = std::array{pVecTrack0, pVecTrack1, pVecTrack2};
@@ -1617,8 +1738,9 @@ struct HfTrackIndexSkimCreator {
       double max2 = maxMass * maxMass;
 
       if ((config.debug || TESTBIT(isSelected, iDecay3P)) && minMass >= 0. && maxMass > 0.) { // no need to check isSelected but to avoid mistakes
-        massHypos[0] = RecoDecay::m2(arrMom, arrMass3Prong[iDecay3P][0]);
-        massHypos[1] = (iDecay3P != hf_cand_3prong::DecayType::DplusToPiKPi) ? RecoDecay::m2(arrMom, arrMass3Prong[iDecay3P][1]) : massHypos[0];
+        const auto& massIdx = arrMassIdx3Prong[iDecay3P];
+        massHypos[0] = m2FromEnergies(arrMom, std::array{energies[0][massIdx[0][0]], energies[1][massIdx[0][1]], energies[2][massIdx[0][2]]});
+        massHypos[1] = (iDecay3P != hf_cand_3prong::DecayType::DplusToPiKPi) ? m2FromEnergies(arrMom, std::array{energies[0][massIdx[1][0]], energies[1][massIdx[1][1]], energies[2][massIdx[1][2]]}) : massHypos[0];
         if (massHypos[0] < min2 || massHypos[0] >= max2) {
           CLRBIT(whichHypo[iDecay3P], 0);
         }
@@ -1634,7 +1756,7 @@ struct HfTrackIndexSkimCreator {
       }
 
       if ((config.debug || TESTBIT(isSelected, iDecay3P)) && iDecay3P == hf_cand_3prong::DecayType::DsToKKPi) {
-        applyPreselectionPhiDecay(pTBin, pVecTrack0, pVecTrack1, pVecTrack2, cutStatus, whichHypo, isSelected);
+        applyPreselectionPhiDecay(pTBin, pVecTrack0, pVecTrack1, pVecTrack2, energies, cutStatus, whichHypo, isSelected);
       }
     }
   }
@@ -1889,32 +2011,55 @@ struct HfTrackIndexSkimCreator {
   /// \param vecCandPvContributorGlobId is a vector containing the global indices of daughter tracks that contributed to the original PV refit
   /// \param pvCoord is a vector where to store X, Y and Z values of refitted PV
   /// \param pvCovMatrix is a vector where to store the covariance matrix values of refitted PV
-  void performPvRefitCandProngs(SelectedCollisions::iterator const& collision,
-                                aod::BCsWithTimestamps const&,
-                                std::vector<int64_t> vecPvContributorGlobId,
-                                std::vector<o2::track::TrackParCov> vecPvContributorTrackParCov,
-                                std::vector<int64_t> vecCandPvContributorGlobId,
-                                std::array<float, 3>& pvCoord,
-                                std::array<float, 6>& pvCovMatrix)
+  /// Prepare the PV refit of a collision with all its contributors
+  /// \param collision is the collision
+  /// \param vecPvContributorTrackParCov vector of the TrackParCov of the original PV contributors
+  void preparePvRefit(SelectedCollisions::iterator const& collision,
+                      std::vector<o2::track::TrackParCov> const& vecPvContributorTrackParCov)
   {
-    std::vector<bool> vecPvRefitContributorUsed(vecPvContributorGlobId.size(), true);
-
-    /// Prepare the vertex refitting
     // set the magnetic field from CCDB
     auto bc = collision.bc_as<o2::aod::BCsWithTimestamps>();
     initCCDB(bc, runNumber, ccdb, config.isRun2 ? config.ccdbPathGrp : config.ccdbPathGrpMag, lut, config.isRun2);
 
     // build the VertexBase to initialize the vertexer
-    o2::dataformats::VertexBase primVtx;
+    auto& primVtx = pvRefitCache.primVtx;
+    primVtx = o2::dataformats::VertexBase{};
     primVtx.setX(collision.posX());
     primVtx.setY(collision.posY());
     primVtx.setZ(collision.posZ());
     primVtx.setCov(collision.covXX(), collision.covXY(), collision.covYY(), collision.covXZ(), collision.covYZ(), collision.covZZ());
     // configure PVertexer
-    o2::vertexing::PVertexer vertexer;
+    pvRefitCache.vertexer = std::make_unique<o2::vertexing::PVertexer>();
     o2::conf::ConfigurableParam::updateFromString("pvertexer.useMeanVertexConstraint=false"); /// remove diamond constraint (let's keep it at the moment...)
-    vertexer.init();
-    bool pvRefitDoable = vertexer.prepareVertexRefit(vecPvContributorTrackParCov, primVtx);
+    pvRefitCache.vertexer->init();
+    pvRefitCache.pvRefitDoable = pvRefitCache.vertexer->prepareVertexRefit(vecPvContributorTrackParCov, primVtx);
+    pvRefitCache.collisionId = collision.globalIndex();
+    pvRefitCache.refits.clear();
+  }
+
+  /// Method for the PV refit excluding the candidate daughters that contributed to it
+  /// \param collision is the collision
+  /// \param vecPvContributorGlobId vector with the global indices of the original PV contributors
+  /// \param vecPvContributorTrackParCov vector of the TrackParCov of the original PV contributors
+  /// \param vecCandPvContributorGlobId vector with the global indices of the candidate daughters
+  /// \param pvCoord is the refitted PV position
+  /// \param pvCovMatrix is the refitted PV covariance matrix
+  void performPvRefitCandProngs(SelectedCollisions::iterator const& collision,
+                                aod::BCsWithTimestamps const&,
+                                std::vector<int64_t> const& vecPvContributorGlobId,
+                                std::vector<o2::track::TrackParCov> const& vecPvContributorTrackParCov,
+                                std::vector<int64_t> const& vecCandPvContributorGlobId,
+                                std::array<float, 3>& pvCoord,
+                                std::array<float, 6>& pvCovMatrix)
+  {
+    std::vector<bool> vecPvRefitContributorUsed(vecPvContributorGlobId.size(), true);
+
+    /// Prepare the vertex refitting, only once per collision if the refits are cached
+    if (!config.cachePvRefit || pvRefitCache.collisionId != collision.globalIndex()) {
+      preparePvRefit(collision, vecPvContributorTrackParCov);
+    }
+    const auto& primVtx = pvRefitCache.primVtx;
+    const bool pvRefitDoable = pvRefitCache.pvRefitDoable;
     if (!pvRefitDoable) {
       LOG(info) << "Not enough tracks accepted for the refit";
       if ((doprocess2And3ProngsWithPvRefit || doprocess2And3ProngsWithPvRefitWithPidForHfFiltersBdt) && config.fillHistograms) {
@@ -1934,21 +2079,30 @@ struct HfTrackIndexSkimCreator {
       }
       recalcPvRefit = true;
       int nCandContr = 0;
+      std::vector<int64_t> vecRemovedGlobId{};                                                                    // removed contributors, identify the refit
       for (uint64_t myGlobalID : vecCandPvContributorGlobId) {                                                    // o2-linter: disable=const-ref-in-for-loop (small type)
         auto trackIterator = std::find(vecPvContributorGlobId.begin(), vecPvContributorGlobId.end(), myGlobalID); /// track global index
         if (trackIterator != vecPvContributorGlobId.end()) {
           /// this is a contributor, let's remove it for the PV refit
           const int entry = std::distance(vecPvContributorGlobId.begin(), trackIterator);
           vecPvRefitContributorUsed[entry] = false; /// remove the track from the PV refitting
+          vecRemovedGlobId.push_back(*trackIterator);
           nCandContr++;
         }
       }
+      std::sort(vecRemovedGlobId.begin(), vecRemovedGlobId.end());
 
       /// do the PV refit excluding the candidate daughters that originally contributed to fit it
       if (config.debugPvRefit) {
         LOG(info) << "### PV refit after removing " << nCandContr << " tracks";
       }
-      auto primVtxRefitted = vertexer.refitVertex(vecPvRefitContributorUsed, primVtx); // vertex refit
+      auto itRefit = pvRefitCache.refits.find(vecRemovedGlobId);
+      if (itRefit == pvRefitCache.refits.end()) {
+        itRefit = pvRefitCache.refits.emplace(vecRemovedGlobId, pvRefitCache.vertexer->refitVertex(vecPvRefitContributorUsed, primVtx)).first; // vertex refit
+      } else if (config.debugPvRefit) {
+        LOG(info) << "### PV refit reused for the same removed tracks";
+      }
+      const auto& primVtxRefitted = itRefit->second;
       // LOG(info) << "refit " << cnt << "/" << ntr << " result = " << primVtxRefitted.asString();
       // LOG(info) << "refit for track with global index " << static_cast<int>(myTrack.globalIndex()) << " " << primVtxRefitted.asString();
       if (primVtxRefitted.getChi2() < 0) {
@@ -2037,6 +2191,8 @@ struct HfTrackIndexSkimCreator {
 
     for (const auto& collision : collisions) {
 
+      pvRefitCache.collisionId = -1; // PV refits are prepared again for each collision
+
       /// retrieve PV contributors for the current collision
       std::vector<int64_t> vecPvContributorGlobId{};
       std::vector<o2::track::TrackParCov> vecPvContributorTrackParCov{};
@@ -2111,8 +2267,19 @@ struct HfTrackIndexSkimCreator {
 
       // first loop over positive tracks
       auto groupedTrackIndicesPos1 = positiveFor2And3Prongs->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache);
+      auto groupedTrackIndicesNeg1 = negativeFor2And3Prongs->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache);
+
+      // daughter quantities (re-propagation to this collision, momenta, energies) computed once per track
+      fillTrackCache<TTracks>(collision, groupedTrackIndicesPos1, tracksPosCache);
+      if (tracksPosCache.pVec.empty()) {
+        tracksNegCache.clear();
+      } else {
+        fillTrackCache<TTracks>(collision, groupedTrackIndicesNeg1, tracksNegCache);
+      }
+
       int lastFilledD0 = -1; // index to be filled in table for D* mesons
-      for (auto trackIndexPos1 = groupedTrackIndicesPos1.begin(); trackIndexPos1 != groupedTrackIndicesPos1.end(); ++trackIndexPos1) {
+      std::size_t iPos1 = 0;
+      for (auto trackIndexPos1 = groupedTrackIndicesPos1.begin(); trackIndexPos1 != groupedTrackIndicesPos1.end(); ++trackIndexPos1, ++iPos1) {
         auto trackPos1 = trackIndexPos1.template track_as<TTracks>();
 
         // retrieve the selection flag that corresponds to this collision
@@ -2120,17 +2287,14 @@ struct HfTrackIndexSkimCreator {
         bool sel2ProngStatusPos = TESTBIT(isSelProngPos1, CandidateType::Cand2Prong);
         bool sel3ProngStatusPos1 = TESTBIT(isSelProngPos1, CandidateType::Cand3Prong);
 
-        auto trackParVarPos1 = getTrackParCov(trackPos1);
-        std::array<float, 3> pVecTrackPos1{trackPos1.pVector()};
-        std::array<float, 2> dcaInfoPos1{trackPos1.dcaXY(), trackPos1.dcaZ()};
-        if (thisCollId != trackPos1.collisionId()) { // this is not the "default" collision for this track, we have to re-propagate it
-          o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParVarPos1, 2.f, noMatCorr, &dcaInfoPos1);
-          getPxPyPz(trackParVarPos1, pVecTrackPos1);
-        }
+        const auto& trackParVarPos1 = tracksPosCache.trackParVar[iPos1];
+        const auto& pVecTrackPos1 = tracksPosCache.pVec[iPos1];
+        const auto& dcaInfoPos1 = tracksPosCache.dcaInfo[iPos1];
+        const auto energiesPos1 = tracksPosCache.energies(iPos1);
 
         // first loop over negative tracks
-        auto groupedTrackIndicesNeg1 = negativeFor2And3Prongs->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache);
-        for (auto trackIndexNeg1 = groupedTrackIndicesNeg1.begin(); trackIndexNeg1 != groupedTrackIndicesNeg1.end(); ++trackIndexNeg1) {
+        std::size_t iNeg1 = 0;
+        for (auto trackIndexNeg1 = groupedTrackIndicesNeg1.begin(); trackIndexNeg1 != groupedTrackIndicesNeg1.end(); ++trackIndexNeg1, ++iNeg1) {
           auto trackNeg1 = trackIndexNeg1.template track_as<TTracks>();
 
           // retrieve the selection flag that corresponds to this collision
@@ -2138,13 +2302,10 @@ struct HfTrackIndexSkimCreator {
           bool sel2ProngStatusNeg = TESTBIT(isSelProngNeg1, CandidateType::Cand2Prong);
           bool sel3ProngStatusNeg1 = TESTBIT(isSelProngNeg1, CandidateType::Cand3Prong);
 
-          auto trackParVarNeg1 = getTrackParCov(trackNeg1);
-          std::array<float, 3> pVecTrackNeg1{trackNeg1.pVector()};
-          std::array<float, 2> dcaInfoNeg1{trackNeg1.dcaXY(), trackNeg1.dcaZ()};
-          if (thisCollId != trackNeg1.collisionId()) { // this is not the "default" collision for this track, we have to re-propagate it
-            o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParVarNeg1, 2.f, noMatCorr, &dcaInfoNeg1);
-            getPxPyPz(trackParVarNeg1, pVecTrackNeg1);
-          }
+          const auto& trackParVarNeg1 = tracksNegCache.trackParVar[iNeg1];
+          const auto& pVecTrackNeg1 = tracksNegCache.pVec[iNeg1];
+          const auto& dcaInfoNeg1 = tracksNegCache.dcaInfo[iNeg1];
+          const auto energiesNeg1 = tracksNegCache.energies(iNeg1);
 
           int isSelected2ProngCand = n2ProngBit; // bitmap for checking status of two-prong candidates (1 is true, 0 is rejected)
 
@@ -2168,7 +2329,7 @@ struct HfTrackIndexSkimCreator {
 
             // 2-prong preselections
             // TODO: in case of PV refit, the single-track DCA is calculated wrt two different PV vertices (only 1 track excluded)
-            applyPreselection2Prong(pVecTrackPos1, pVecTrackNeg1, dcaInfoPos1[0], dcaInfoNeg1[0], cutStatus2Prong, whichHypo2Prong, isSelected2ProngCand, pt2Prong);
+            applyPreselection2Prong(pVecTrackPos1, pVecTrackNeg1, dcaInfoPos1[0], dcaInfoNeg1[0], energiesPos1, energiesNeg1, cutStatus2Prong, whichHypo2Prong, isSelected2ProngCand, pt2Prong);
 
             if (isSelected2ProngCand > 0) {
               // secondary vertex reconstruction and further 2-prong selections
@@ -2353,7 +2514,8 @@ struct HfTrackIndexSkimCreator {
 
           if (config.do3Prong == 1 && is2ProngCandidateGoodFor3Prong) { // if 3 prongs are enabled and the first 2 tracks are selected for the 3-prong channels
             // second loop over positive tracks
-            for (auto trackIndexPos2 = trackIndexPos1 + 1; trackIndexPos2 != groupedTrackIndicesPos1.end(); ++trackIndexPos2) {
+            std::size_t iPos2 = iPos1 + 1;
+            for (auto trackIndexPos2 = trackIndexPos1 + 1; trackIndexPos2 != groupedTrackIndicesPos1.end(); ++trackIndexPos2, ++iPos2) {
 
               int isSelected3ProngCand = n3ProngBit;
               if (!TESTBIT(trackIndexPos2.isSelProng(), CandidateType::Cand3Prong)) { // continue immediately
@@ -2373,16 +2535,12 @@ struct HfTrackIndexSkimCreator {
               }
 
               auto trackPos2 = trackIndexPos2.template track_as<TTracks>();
-              auto trackParVarPos2 = getTrackParCov(trackPos2);
-              std::array<float, 2> dcaInfoPos2{trackPos2.dcaXY(), trackPos2.dcaZ()};
+              const auto& trackParVarPos2 = tracksPosCache.trackParVar[iPos2];
+              const auto& dcaInfoPos2 = tracksPosCache.dcaInfo[iPos2];
 
               // preselection of 3-prong candidates
               if (isSelected3ProngCand) {
-                std::array<float, 3> pVecTrackPos2{trackPos2.pVector()};
-                if (thisCollId != trackPos2.collisionId()) { // this is not the "default" collision for this track and we still did not re-propagate it, we have to re-propagate it
-                  o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParVarPos2, 2.f, noMatCorr, &dcaInfoPos2);
-                  getPxPyPz(trackParVarPos2, pVecTrackPos2);
-                }
+                const auto& pVecTrackPos2 = tracksPosCache.pVec[iPos2];
 
                 if (config.debug) {
                   for (int iDecay3P = 0; iDecay3P < kN3ProngDecays; iDecay3P++) {
@@ -2395,7 +2553,7 @@ struct HfTrackIndexSkimCreator {
                 // 3-prong preselections
                 int8_t isIdentifiedPidTrackPos1 = trackIndexPos1.isIdentifiedPid();
                 int8_t isIdentifiedPidTrackPos2 = trackIndexPos2.isIdentifiedPid();
-                applyPreselection3Prong(pVecTrackPos1, pVecTrackNeg1, pVecTrackPos2, isIdentifiedPidTrackPos1, isIdentifiedPidTrackPos2, cutStatus3Prong, whichHypo3Prong, isSelected3ProngCand);
+                applyPreselection3Prong(pVecTrackPos1, pVecTrackNeg1, pVecTrackPos2, isIdentifiedPidTrackPos1, isIdentifiedPidTrackPos2, std::array{energiesPos1, energiesNeg1, tracksPosCache.energies(iPos2)}, cutStatus3Prong, whichHypo3Prong, isSelected3ProngCand);
                 if (!config.debug && isSelected3ProngCand == 0) {
                   continue;
                 }
@@ -2605,7 +2763,8 @@ struct HfTrackIndexSkimCreator {
             }
 
             // second loop over negative tracks
-            for (auto trackIndexNeg2 = trackIndexNeg1 + 1; trackIndexNeg2 != groupedTrackIndicesNeg1.end(); ++trackIndexNeg2) {
+            std::size_t iNeg2 = iNeg1 + 1;
+            for (auto trackIndexNeg2 = trackIndexNeg1 + 1; trackIndexNeg2 != groupedTrackIndicesNeg1.end(); ++trackIndexNeg2, ++iNeg2) {
 
               int isSelected3ProngCand = n3ProngBit;
               if (!TESTBIT(trackIndexNeg2.isSelProng(), CandidateType::Cand3Prong)) { // continue immediately
@@ -2625,16 +2784,12 @@ struct HfTrackIndexSkimCreator {
               }
 
               auto trackNeg2 = trackIndexNeg2.template track_as<TTracks>();
-              auto trackParVarNeg2 = getTrackParCov(trackNeg2);
-              std::array<float, 2> dcaInfoNeg2{trackNeg2.dcaXY(), trackNeg2.dcaZ()};
+              const auto& trackParVarNeg2 = tracksNegCache.trackParVar[iNeg2];
+              const auto& dcaInfoNeg2 = tracksNegCache.dcaInfo[iNeg2];
 
               // preselection of 3-prong candidates
               if (isSelected3ProngCand) {
-                std::array<float, 3> pVecTrackNeg2{trackNeg2.pVector()};
-                if (thisCollId != trackNeg2.collisionId()) { // this is not the "default" collision for this track and we still did not re-propagate it, we have to re-propagate it
-                  o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParVarNeg2, 2.f, noMatCorr, &dcaInfoNeg2);
-                  getPxPyPz(trackParVarNeg2, pVecTrackNeg2);
-                }
+                const auto& pVecTrackNeg2 = tracksNegCache.pVec[iNeg2];
 
                 if (config.debug) {
                   for (int iDecay3P = 0; iDecay3P < kN3ProngDecays; iDecay3P++) {
@@ -2647,7 +2802,7 @@ struct HfTrackIndexSkimCreator {
                 // 3-prong preselections
                 int8_t isIdentifiedPidTrackNeg1 = trackIndexNeg1.isIdentifiedPid();
                 int8_t isIdentifiedPidTrackNeg2 = trackIndexNeg2.isIdentifiedPid();
-                applyPreselection3Prong(pVecTrackNeg1, pVecTrackPos1, pVecTrackNeg2, isIdentifiedPidTrackNeg1, isIdentifiedPidTrackNeg2, cutStatus3Prong, whichHypo3Prong, isSelected3ProngCand);
+                applyPreselection3Prong(pVecTrackNeg1, pVecTrackPos1, pVecTrackNeg2, isIdentifiedPidTrackNeg1, isIdentifiedPidTrackNeg2, std::array{energiesNeg1, energiesPos1, tracksNegCache.energies(iNeg2)}, cutStatus3Prong, whichHypo3Prong, isSelected3ProngCand);
                 if (!config.debug && isSelected3ProngCand == 0) {
                   continue;
                 }
@@ -23,10 +23,12 @@
 #include "PWGHF/Core/HfHelper.h"
 #include "PWGHF/DataModel/CandidateReconstructionTables.h"
 #include "PWGHF/DataModel/CandidateSelectionTables.h"
+#include "PWGHF/Utils/utilsTreeCreator.h"
 
 using namespace o2;
 using namespace o2::framework;
 using namespace o2::framework::expressions;
+using namespace o2::analysis::hf_trees;
 
 namespace o2::aod
 {
@@ -289,11 +291,8 @@ struct HfTreeCreatorBsToDsPi {
       rowCandidateLite.reserve(candidates.size());
     }
     for (const auto& candidate : candidates) {
-      if (fillOnlyBackground && downSampleBkgFactor < 1.) {
-        float pseudoRndm = candidate.ptProng1() * 1000. - static_cast<int64_t>(candidate.ptProng1() * 1000);
-        if (pseudoRndm >= downSampleBkgFactor && candidate.pt() < ptMaxForDownSample) {
-          continue;
-        }
+      if (fillOnlyBackground && !isKeptByDownSampling(candidate.ptProng1(), candidate.pt(), downSampleBkgFactor, ptMaxForDownSample)) {
+        continue;
       }
       auto prong1 = candidate.prong1_as<TracksWPid>();
       fillCandidateTable(candidate, prong1);
@@ -330,8 +329,7 @@ struct HfTreeCreatorBsToDsPi {
         rowCandidateLite.reserve(recBg.size());
       }
       for (const auto& candidate : recBg) {
-        float pseudoRndm = candidate.ptProng1() * 1000. - static_cast<int64_t>(candidate.ptProng1() * 1000);
-        if (candidate.pt() < ptMaxForDownSample && pseudoRndm >= downSampleBkgFactor) {
+        if (!isKeptByDownSampling(candidate.ptProng1(), candidate.pt(), downSampleBkgFactor, ptMaxForDownSample)) {
           continue;
         }
         auto prong1 = candidate.prong1_as<TracksWPid>();
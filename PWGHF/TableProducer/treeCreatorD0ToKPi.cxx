@@ -24,10 +24,12 @@
 #include "PWGHF/Core/HfHelper.h"
 #include "PWGHF/DataModel/CandidateReconstructionTables.h"
 #include "PWGHF/DataModel/CandidateSelectionTables.h"
+#include "PWGHF/Utils/utilsTreeCreator.h"
 
 using namespace o2;
 using namespace o2::framework;
 using namespace o2::framework::expressions;
+using namespace o2::analysis::hf_trees;
 
 namespace o2::aod
 {
@@ -232,6 +234,7 @@ struct HfTreeCreatorD0ToKPi {
   Configurable<float> downSampleBkgFactor{"downSampleBkgFactor", 1., "Fraction of background candidates to keep for ML trainings"};
   Configurable<float> ptMaxForDownSample{"ptMaxForDownSample", 10., "Maximum pt for the application of the downsampling factor"};
   Configurable<bool> fillCorrBkgs{"fillCorrBkgs", false, "Flag to fill derived tables with correlated background candidates"};
+  Configurable<int> nMantissaBitsPid{"nMantissaBitsPid", -1, "Number of mantissa bits kept in the PID columns for a better compression (-1: full precision)"};
 
   HfHelper hfHelper;
 
@@ -296,18 +299,18 @@ struct HfTreeCreatorD0ToKPi {
         candidate.impactParameter1(),
         candidate.impactParameterNormalised0(),
         candidate.impactParameterNormalised1(),
-        candidate.nSigTpcPi0(),
-        candidate.nSigTpcKa0(),
-        candidate.nSigTofPi0(),
-        candidate.nSigTofKa0(),
-        candidate.tpcTofNSigmaPi0(),
-        candidate.tpcTofNSigmaKa0(),
-        candidate.nSigTpcPi1(),
-        candidate.nSigTpcKa1(),
-        candidate.nSigTofPi1(),
-        candidate.nSigTofKa1(),
-        candidate.tpcTofNSigmaPi1(),
-        candidate.tpcTofNSigmaKa1(),
+        reducePrecision(candidate.nSigTpcPi0(), nMantissaBitsPid),
+        reducePrecision(candidate.nSigTpcKa0(), nMantissaBitsPid),
+        reducePrecision(candidate.nSigTofPi0(), nMantissaBitsPid),
+        reducePrecision(candidate.nSigTofKa0(), nMantissaBitsPid),
+        reducePrecision(candidate.tpcTofNSigmaPi0(), nMantissaBitsPid),
+        reducePrecision(candidate.tpcTofNSigmaKa0(), nMantissaBitsPid),
+        reducePrecision(candidate.nSigTpcPi1(), nMantissaBitsPid),
+        reducePrecision(candidate.nSigTpcKa1(), nMantissaBitsPid),
+        reducePrecision(candidate.nSigTofPi1(), nMantissaBitsPid),
+        reducePrecision(candidate.nSigTofKa1(), nMantissaBitsPid),
+        reducePrecision(candidate.tpcTofNSigmaPi1(), nMantissaBitsPid),
+        reducePrecision(candidate.tpcTofNSigmaKa1(), nMantissaBitsPid),
         1 << candFlag,
         invMass,
         candidate.pt(),
@@ -356,18 +359,18 @@ struct HfTreeCreatorD0ToKPi {
         candidate.impactParameter1(),
         candidate.errorImpactParameter0(),
         candidate.errorImpactParameter1(),
-        candidate.nSigTpcPi0(),
-        candidate.nSigTpcKa0(),
-        candidate.nSigTofPi0(),
-        candidate.nSigTofKa0(),
-        candidate.tpcTofNSigmaPi0(),
-        candidate.tpcTofNSigmaKa0(),
-        candidate.nSigTpcPi1(),
-        candidate.nSigTpcKa1(),
-        candidate.nSigTofPi1(),
-        candidate.nSigTofKa1(),
-        candidate.tpcTofNSigmaPi1(),
-        candidate.tpcTofNSigmaKa1(),
+        reducePrecision(candidate.nSigTpcPi0(), nMantissaBitsPid),
+        reducePrecision(candidate.nSigTpcKa0(), nMantissaBitsPid),
+        reducePrecision(candidate.nSigTofPi0(), nMantissaBitsPid),
+        reducePrecision(candidate.nSigTofKa0(), nMantissaBitsPid),
+        reducePrecision(candidate.tpcTofNSigmaPi0(), nMantissaBitsPid),
+        reducePrecision(candidate.tpcTofNSigmaKa0(), nMantissaBitsPid),
+        reducePrecision(candidate.nSigTpcPi1(), nMantissaBitsPid),
+        reducePrecision(candidate.nSigTpcKa1(), nMantissaBitsPid),
+        reducePrecision(candidate.nSigTofPi1(), nMantissaBitsPid),
+        reducePrecision(candidate.nSigTofKa1(), nMantissaBitsPid),
+        reducePrecision(candidate.tpcTofNSigmaPi1(), nMantissaBitsPid),
+        reducePrecision(candidate.tpcTofNSigmaKa1(), nMantissaBitsPid),
         1 << candFlag,
         invMass,
         candidate.maxNormalisedDeltaIP(),
@@ -423,11 +426,8 @@ struct HfTreeCreatorD0ToKPi {
       rowCandidateMl.reserve(candidates.size());
     }
     for (const auto& candidate : candidates) {
-      if (downSampleBkgFactor < 1.) {
-        float pseudoRndm = candidate.ptProng0() * 1000. - static_cast<int64_t>(candidate.ptProng0() * 1000);
-        if (candidate.pt() < ptMaxForDownSample && pseudoRndm >= downSampleBkgFactor) {
-          continue;
-        }
+      if (!isKeptByDownSampling(candidate.ptProng0(), candidate.pt(), downSampleBkgFactor, ptMaxForDownSample)) {
+        continue;
       }
       double yD = hfHelper.yD0(candidate);
       double eD = hfHelper.eD0(candidate);
@@ -515,11 +515,8 @@ struct HfTreeCreatorD0ToKPi {
         if (TESTBIT(std::abs(candidate.flagMcMatchRec()), aod::hf_cand_2prong::DecayType::D0ToPiK) || (fillCorrBkgs && (candidate.flagMcMatchRec() != 0))) {
           continue;
         }
-        if (downSampleBkgFactor < 1.) {
-          float pseudoRndm = candidate.ptProng0() * 1000. - static_cast<int64_t>(candidate.ptProng0() * 1000);
-          if (candidate.pt() < ptMaxForDownSample && pseudoRndm >= downSampleBkgFactor) {
-            continue;
-          }
+        if (!isKeptByDownSampling(candidate.ptProng0(), candidate.pt(), downSampleBkgFactor, ptMaxForDownSample)) {
+          continue;
         }
       }
       if constexpr (onlySig) {
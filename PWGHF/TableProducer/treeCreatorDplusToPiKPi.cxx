@@ -26,11 +26,13 @@
 #include "PWGHF/Core/CentralityEstimation.h"
 #include "PWGHF/DataModel/CandidateReconstructionTables.h"
 #include "PWGHF/DataModel/CandidateSelectionTables.h"
+#include "PWGHF/Utils/utilsTreeCreator.h"
 
 using namespace o2;
 using namespace o2::framework;
 using namespace o2::framework::expressions;
 using namespace o2::hf_centrality;
+using namespace o2::analysis::hf_trees;
 
 namespace o2::aod
 {
@@ -465,11 +467,8 @@ struct HfTreeCreatorDplusToPiKPi {
       rowCandidateFull.reserve(candidates.size());
     }
     for (const auto& candidate : candidates) {
-      if (downSampleBkgFactor < 1.) {
-        float pseudoRndm = candidate.ptProng0() * 1000. - static_cast<int64_t>(candidate.ptProng0() * 1000);
-        if (candidate.pt() < ptMaxForDownSample && pseudoRndm >= downSampleBkgFactor) {
-          continue;
-        }
+      if (!isKeptByDownSampling(candidate.ptProng0(), candidate.pt(), downSampleBkgFactor, ptMaxForDownSample)) {
+        continue;
       }
       fillCandidateTable<aod::Collisions>(candidate);
     }
@@ -494,11 +493,8 @@ struct HfTreeCreatorDplusToPiKPi {
       rowCandidateFull.reserve(candidates.size());
     }
     for (const auto& candidate : candidates) {
-      if (downSampleBkgFactor < 1.) {
-        float pseudoRndm = candidate.ptProng0() * 1000. - static_cast<int64_t>(candidate.ptProng0() * 1000);
-        if (candidate.pt() < ptMaxForDownSample && pseudoRndm >= downSampleBkgFactor) {
-          continue;
-        }
+      if (!isKeptByDownSampling(candidate.ptProng0(), candidate.pt(), downSampleBkgFactor, ptMaxForDownSample)) {
+        continue;
       }
       fillCandidateTable<CollisionsCent>(candidate);
     }
@@ -526,11 +522,8 @@ struct HfTreeCreatorDplusToPiKPi {
       rowCandidateFull.reserve(candidates.size());
     }
     for (const auto& candidate : candidates) {
-      if (downSampleBkgFactor < 1.) {
-        float pseudoRndm = candidate.ptProng0() * 1000. - static_cast<int64_t>(candidate.ptProng0() * 1000);
-        if (candidate.pt() < ptMaxForDownSample && pseudoRndm >= downSampleBkgFactor) {
-          continue;
-        }
+      if (!isKeptByDownSampling(candidate.ptProng0(), candidate.pt(), downSampleBkgFactor, ptMaxForDownSample)) {
+        continue;
       }
       fillCandidateTable<CollType, true, applyMl>(candidate);
     }
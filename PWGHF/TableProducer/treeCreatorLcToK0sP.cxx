@@ -24,10 +24,12 @@
 #include "PWGHF/Core/HfHelper.h"
 #include "PWGHF/DataModel/CandidateReconstructionTables.h"
 #include "PWGHF/DataModel/CandidateSelectionTables.h"
+#include "PWGHF/Utils/utilsTreeCreator.h"
 
 using namespace o2;
 using namespace o2::framework;
 using namespace o2::framework::expressions;
+using namespace o2::analysis::hf_trees;
 using std::array;
 
 namespace o2::aod
@@ -386,11 +388,8 @@ struct HfTreeCreatorLcToK0sP {
         rowCandidateFull.reserve(recBkg.size());
       }
       for (const auto& candidate : recBkg) {
-        if (downSampleBkgFactor < 1.) {
-          float pseudoRndm = candidate.ptProng0() * 1000. - static_cast<int64_t>(candidate.ptProng0() * 1000);
-          if (candidate.pt() < ptMaxForDownSample && pseudoRndm >= downSampleBkgFactor) {
-            continue;
-          }
+        if (!isKeptByDownSampling(candidate.ptProng0(), candidate.pt(), downSampleBkgFactor, ptMaxForDownSample)) {
+          continue;
         }
         auto bach = candidate.prong0_as<TracksWPid>(); // bachelor
         fillCandidate(candidate, bach, candidate.flagMcMatchRec(), candidate.originMcRec());
@@ -24,11 +24,13 @@
 
 #include "PWGHF/DataModel/CandidateReconstructionTables.h"
 #include "PWGHF/DataModel/CandidateSelectionTables.h"
+#include "PWGHF/Utils/utilsTreeCreator.h"
 
 using namespace o2;
 using namespace o2::framework;
 using namespace o2::framework::expressions;
 using namespace o2::constants::physics;
+using namespace o2::analysis::hf_trees;
 
 namespace o2::aod
 {
@@ -655,11 +657,8 @@ struct HfTreeCreatorXicToXiPiPi {
       rowCandidateFull.reserve(candidates.size());
     }
     for (const auto& candidate : candidates) {
-      if (fillOnlyBackground && downSampleBkgFactor < 1.) {
-        float pseudoRndm = candidate.ptProng1() * 1000. - static_cast<int64_t>(candidate.ptProng1() * 1000);
-        if (pseudoRndm >= downSampleBkgFactor && candidate.pt() < ptMaxForDownSample) {
-          continue;
-        }
+      if (fillOnlyBackground && !isKeptByDownSampling(candidate.ptProng1(), candidate.pt(), downSampleBkgFactor, ptMaxForDownSample)) {
+        continue;
       }
       fillCandidateTable<false, false>(candidate);
     }
@@ -675,11 +674,8 @@ struct HfTreeCreatorXicToXiPiPi {
       rowCandidateFull.reserve(candidates.size());
     }
     for (const auto& candidate : candidates) {
-      if (fillOnlyBackground && downSampleBkgFactor < 1.) {
-        float pseudoRndm = candidate.ptProng1() * 1000. - static_cast<int64_t>(candidate.ptProng1() * 1000);
-        if (pseudoRndm >= downSampleBkgFactor && candidate.pt() < ptMaxForDownSample) {
-          continue;
-        }
+      if (fillOnlyBackground && !isKeptByDownSampling(candidate.ptProng1(), candidate.pt(), downSampleBkgFactor, ptMaxForDownSample)) {
+        continue;
       }
       fillCandidateTable<false, true>(candidate);
     }
@@ -706,8 +702,7 @@ struct HfTreeCreatorXicToXiPiPi {
         rowCandidateFull.reserve(recBg.size());
       }
       for (const auto& candidate : recBg) {
-        float pseudoRndm = candidate.ptProng1() * 1000. - static_cast<int64_t>(candidate.ptProng1() * 1000);
-        if (candidate.pt() < ptMaxForDownSample && pseudoRndm >= downSampleBkgFactor) {
+        if (!isKeptByDownSampling(candidate.ptProng1(), candidate.pt(), downSampleBkgFactor, ptMaxForDownSample)) {
           continue;
         }
         fillCandidateTable<true, false>(candidate);
@@ -759,8 +754,7 @@ struct HfTreeCreatorXicToXiPiPi {
         rowCandidateFull.reserve(recBgKf.size());
       }
       for (const auto& candidate : recBgKf) {
-        float pseudoRndm = candidate.ptProng1() * 1000. - static_cast<int64_t>(candidate.ptProng1() * 1000);
-        if (candidate.pt() < ptMaxForDownSample && pseudoRndm >= downSampleBkgFactor) {
+        if (!isKeptByDownSampling(candidate.ptProng1(), candidate.pt(), downSampleBkgFactor, ptMaxForDownSample)) {
           continue;
         }
         fillCandidateTable<true, true>(candidate);
@@ -22,8 +22,8 @@
 #include <Framework/ASoA.h>
 #include <Framework/Configurable.h>
 
+#include <cstddef>
 #include <cstdint>
-#include <map>
 #include <vector>
 
 #include "Common/Core/RecoDecay.h"
@@ -87,14 +87,30 @@ struct HfProducesDerivedData : o2::framework::ProducesGroup {
   o2::framework::Produces<HfPIds> rowParticleId;
 
   HfConfigurableDerivedData const* conf;
-  std::map<int, std::vector<int>> matchedCollisions; // indices of derived reconstructed collisions matched to the global indices of MC collisions
-  std::map<int, bool> hasMcParticles;                // flags for MC collisions with HF particles
+  std::vector<std::vector<int>> matchedCollisions; // indices of derived reconstructed collisions matched to the global indices of MC collisions
+  std::vector<bool> hasMcParticles;                // flags for MC collisions with HF particles, indexed by the global indices of MC collisions
 
   void init(HfConfigurableDerivedData const& c)
   {
     conf = &c;
   }
 
+  /// Whether the MC collision with the given global index has HF particles, as flagged in preProcessMcCollisions
+  bool mcCollisionHasMcParticles(int64_t mcCollisionId) const
+  {
+    return mcCollisionId >= 0 && static_cast<std::size_t>(mcCollisionId) < hasMcParticles.size() && hasMcParticles[mcCollisionId];
+  }
+
+  /// Indices of the derived reconstructed collisions matched to the MC collision with the given global index
+  const std::vector<int>& getMatchedCollisions(int64_t mcCollisionId) const
+  {
+    static const std::vector<int> none{};
+    if (mcCollisionId < 0 || static_cast<std::size_t>(mcCollisionId) >= matchedCollisions.size()) {
+      return none;
+    }
+    return matchedCollisions[mcCollisionId];
+  }
+
   template <typename T>
   void reserveTablesCandidates(T size)
   {
@@ -161,7 +177,11 @@ struct HfProducesDerivedData : o2::framework::ProducesGroup {
       if (conf->fillMcRCollId.value && collision.has_mcCollision()) {
         // Save rowCollBase.lastIndex() at key collision.mcCollisionId()
         LOGF(debug, "Rec. collision %d: Filling derived-collision index %d for MC collision %d", collision.globalIndex(), rowCollBase.lastIndex(), collision.mcCollisionId());
-        matchedCollisions[collision.mcCollisionId()].push_back(rowCollBase.lastIndex()); // [] inserts an empty element if it does not exist
+        const auto mcCollisionId = static_cast<std::size_t>(collision.mcCollisionId());
+        if (mcCollisionId >= matchedCollisions.size()) {
+          matchedCollisions.resize(mcCollisionId + 1);
+        }
+        matchedCollisions[mcCollisionId].push_back(rowCollBase.lastIndex());
       }
     }
   }
@@ -183,7 +203,7 @@ struct HfProducesDerivedData : o2::framework::ProducesGroup {
     if (conf->fillMcRCollId.value) {
       // Fill the table with the vector of indices of derived reconstructed collisions matched to mcCollision.globalIndex()
       rowMcRCollId(
-        matchedCollisions[mcCollision.globalIndex()]);
+        getMatchedCollisions(mcCollision.globalIndex()));
     }
   }
 
@@ -209,19 +229,23 @@ struct HfProducesDerivedData : o2::framework::ProducesGroup {
 
   template <typename CollisionType, typename ParticleType>
   void preProcessMcCollisions(CollisionType const& mcCollisions,
-                              o2::framework::Preslice<ParticleType> const& mcParticlesPerMcCollision,
+                              o2::framework::Preslice<ParticleType> const& /*mcParticlesPerMcCollision*/,
                               ParticleType const& mcParticles)
   {
     if (!conf->fillMcRCollId.value) {
       return;
     }
-    hasMcParticles.clear();
-    // Fill MC collision flags
-    for (const auto& mcCollision : mcCollisions) {
-      auto thisMcCollId = mcCollision.globalIndex();
-      auto particlesThisMcColl = mcParticles.sliceBy(mcParticlesPerMcCollision, thisMcCollId);
-      LOGF(debug, "MC collision %d has %d MC particles (preprocess)", thisMcCollId, particlesThisMcColl.size());
-      hasMcParticles[thisMcCollId] = (particlesThisMcColl.size() > 0);
+    // Fill MC collision flags in one pass over the HF particles of the dataframe
+    hasMcParticles.assign(mcCollisions.size(), false);
+    for (const auto& particle : mcParticles) {
+      const auto mcCollisionId = particle.mcCollisionId();
+      if (mcCollisionId < 0) {
+        continue;
+      }
+      if (static_cast<std::size_t>(mcCollisionId) >= hasMcParticles.size()) {
+        hasMcParticles.resize(mcCollisionId + 1, false);
+      }
+      hasMcParticles[mcCollisionId] = true;
     }
   }
 
@@ -240,8 +264,8 @@ struct HfProducesDerivedData : o2::framework::ProducesGroup {
       auto sizeTablePart = particlesThisMcColl.size();
       LOGF(debug, "MC collision %d has %d MC particles", thisMcCollId, sizeTablePart);
       // Skip MC collisions without HF particles (and without HF candidates in matched reconstructed collisions if saving indices of reconstructed collisions matched to MC collisions)
-      LOGF(debug, "MC collision %d has %d saved derived rec. collisions", thisMcCollId, matchedCollisions[thisMcCollId].size());
-      if (sizeTablePart == 0 && (!conf->fillMcRCollId.value || matchedCollisions[thisMcCollId].empty())) {
+      LOGF(debug, "MC collision %d has %d saved derived rec. collisions", thisMcCollId, getMatchedCollisions(thisMcCollId).size());
+      if (sizeTablePart == 0 && (!conf->fillMcRCollId.value || getMatchedCollisions(thisMcCollId).empty())) {
         LOGF(debug, "Skipping MC collision %d", thisMcCollId);
         continue;
       }
@@ -254,6 +278,8 @@ struct HfProducesDerivedData : o2::framework::ProducesGroup {
         fillTablesParticle(particle, massParticle);
       }
     }
+    // The matching is valid only within the dataframe.
+    matchedCollisions.clear();
   }
 };
 } // namespace o2::analysis::hf_derived
@@ -139,6 +139,8 @@ void setEventRejectionLabels(Histo& hRejection, std::string softwareTriggerLabel
   hRejection->GetXaxis()->SetBinLabel(EventRejection::NoCollInRofStandard + 1, "No coll in ROF std");
 }
 
+/// HF event selection. It is evaluated in each workflow using it, or once per DF by the
+/// event-selection-creator, which stores the rejection mask, centrality and occupancy in the HfEvSelColls table.
 struct HfEventSelection : o2::framework::ConfigurableGroup {
   std::string prefix = "hfEvSel"; // JSON group name
   // event selection parameters (in chronological order of application)
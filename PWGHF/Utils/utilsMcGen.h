@@ -29,13 +29,30 @@
 
 #include <Rtypes.h>
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
+#include <cstdlib>
 #include <vector>
 
 namespace hf_mc_gen
 {
 
+/// Checks the species of a generated particle before any decay-tree walk
+/// \param pdgParticle PDG code of the generated particle
+/// \param pdgMothers PDG codes of the mother species of the matched decay channels
+/// \return true if the particle or its antiparticle is one of the mother species
+template <std::size_t N>
+inline bool isMotherSpecies(int pdgParticle, std::array<int, N> const& pdgMothers)
+{
+  return std::find(pdgMothers.begin(), pdgMothers.end(), std::abs(pdgParticle)) != pdgMothers.end();
+}
+
+inline bool isMotherSpecies(int pdgParticle, std::vector<int> const& pdgMothers)
+{
+  return std::find(pdgMothers.begin(), pdgMothers.end(), std::abs(pdgParticle)) != pdgMothers.end();
+}
+
 template <typename T, typename U, typename V>
 void fillMcMatchGen2Prong(T const& mcParticles, U const& mcParticlesPerMcColl, V& rowMcMatchGen, bool rejectBackground, bool matchCorrelatedBackgrounds)
 {
@@ -54,6 +71,11 @@ void fillMcMatchGen2Prong(T const& mcParticles, U const& mcParticlesPerMcColl, V
       rowMcMatchGen(flag, origin, channel, -1);
       continue;
     }
+    // Reject particles that cannot match any channel without walking their decay trees
+    if (!(matchCorrelatedBackgrounds ? isMotherSpecies(particle.pdgCode(), std::array{Pdg::kD0}) : isMotherSpecies(particle.pdgCode(), std::array{Pdg::kD0, Pdg::kJPsi}))) {
+      rowMcMatchGen(flag, origin, channel, -1);
+      continue;
+    }
     if (matchCorrelatedBackgrounds) {
       constexpr int MaxDepth = 2;     // Depth for final state matching
       constexpr int ResoMaxDepth = 1; // Depth for resonant decay matching
@@ -146,13 +168,18 @@ void fillMcMatchGen3Prong(T const& mcParticles, U const& mcParticlesPerMcColl, V
       rowMcMatchGen(flag, origin, channel, -1);
       continue;
     }
+    // Reject particles that cannot match any channel without walking their decay trees
+    if (!(corrBkgMothersPdgs.size() > 0 ? isMotherSpecies(particle.pdgCode(), corrBkgMothersPdgs) : isMotherSpecies(particle.pdgCode(), std::array{Pdg::kDPlus, Pdg::kDS, Pdg::kDStar, Pdg::kLambdaCPlus, Pdg::kXiCPlus}))) {
+      rowMcMatchGen(flag, origin, channel, -1);
+      continue;
+    }
 
     if (corrBkgMothersPdgs.size() > 0) {
       for (const auto& motherPdgCode : corrBkgMothersPdgs) {
         if (std::abs(particle.pdgCode()) != motherPdgCode) {
           continue; // Skip if the particle PDG code does not match the mother PDG code
         }
-        auto finalStates = o2::hf_decay::hf_cand_3prong::getDecayChannelMain(motherPdgCode);
+        const auto& finalStates = o2::hf_decay::hf_cand_3prong::getDecayChannelMain(motherPdgCode);
         constexpr int MaxDepth = 2;     // Depth for final state matching
         constexpr int ResoMaxDepth = 1; // Depth for resonant decay matching
 
@@ -162,21 +189,17 @@ void fillMcMatchGen3Prong(T const& mcParticles, U const& mcParticlesPerMcColl, V
           maxDepth = MaxDepth + 1; // D0 resonant decays are switched on
         }
 
-        std::vector<int> arrAllDaughtersIndex;
         for (const auto& [chn, finalState] : finalStates) {
           if (finalState.size() == 5) { // o2-linter: disable=magic-number (Partly Reco 3-prong decays from 5-prong decays)
             std::array<int, 5> finalStateParts = std::array{finalState[0], finalState[1], finalState[2], finalState[3], finalState[4]};
             o2::hf_decay::changeFinalStatePdgSign(particle.pdgCode(), +kPi0, finalStateParts);
-            RecoDecay::getDaughters<false>(particle, &arrAllDaughtersIndex, finalStateParts, maxDepth);
             matched = RecoDecay::isMatchedMCGen(mcParticles, particle, motherPdgCode, finalStateParts, true, &sign, -1);
           } else if (finalState.size() == 4) { // o2-linter: disable=magic-number (Partly Reco 3-prong decays from 4-prong decays)
             std::array<int, 4> finalStateParts = std::array{finalState[0], finalState[1], finalState[2], finalState[3]};
             o2::hf_decay::changeFinalStatePdgSign(particle.pdgCode(), +kPi0, finalStateParts);
-            RecoDecay::getDaughters<false>(particle, &arrAllDaughtersIndex, finalStateParts, maxDepth);
             matched = RecoDecay::isMatchedMCGen(mcParticles, particle, motherPdgCode, finalStateParts, true, &sign, -1);
           } else if (finalState.size() == 3) { // o2-linter: disable=magic-number (Fully Reco 3-prong decays)
             std::array<int, 3> finalStateParts = std::array{finalState[0], finalState[1], finalState[2]};
-            RecoDecay::getDaughters<false>(particle, &arrAllDaughtersIndex, finalStateParts, maxDepth);
             matched = RecoDecay::isMatchedMCGen(mcParticles, particle, motherPdgCode, finalStateParts, true, &sign, maxDepth);
           } else {
             LOG(info) << "Final state size not supported: " << finalState.size();
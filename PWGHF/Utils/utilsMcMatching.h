@@ -143,8 +143,9 @@ static const std::unordered_map<DecayChannelResonant, const std::array<int, 2>>
 /// Returns a map of the possible final states for a specific 3-prong particle specie
 /// \param pdgMother PDG code of the mother particle
 /// \return a map of final states with their corresponding PDG codes
-inline std::unordered_map<DecayChannelMain, const std::vector<int>> getDecayChannelMain(int pdgMother)
+inline std::unordered_map<DecayChannelMain, const std::vector<int>> const& getDecayChannelMain(int pdgMother)
 {
+  static const std::unordered_map<DecayChannelMain, const std::vector<int>> noFinalStates{};
   switch (pdgMother) {
     case o2::constants::physics::Pdg::kDPlus:
       return daughtersDplusMain;
@@ -158,7 +159,7 @@ inline std::unordered_map<DecayChannelMain, const std::vector<int>> getDecayChan
       return daughtersXicMain;
     default:
       LOG(fatal) << "Unknown PDG code for 3-prong final states: " << pdgMother;
-      return {};
+      return noFinalStates;
   }
 }
 } // namespace hf_cand_3prong
@@ -0,0 +1,65 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file utilsTreeCreator.h
+/// \brief Utilities shared by the tree creators and derived-data creators of the HF candidates
+
+#ifndef PWGHF_UTILS_UTILSTREECREATOR_H_
+#define PWGHF_UTILS_UTILSTREECREATOR_H_
+
+#include <cstdint>
+#include <cstring>
+
+namespace o2::analysis::hf_trees
+{
+/// Deterministic down-sampling of the candidates.
+/// The digits of the prong pt below the MeV/c are used as a pseudo-random number in [0, 1),
+/// so that the same candidates are kept in every production, independently of the processing order.
+/// \param ptProng  pt of the prong used as seed
+/// \param pt  pt of the candidate
+/// \param downSampleFactor  fraction of candidates to keep
+/// \param ptMaxForDownSample  candidates with pt above this value are always kept
+/// \return true if the candidate is kept
+inline bool isKeptByDownSampling(float ptProng, float pt, float downSampleFactor, float ptMaxForDownSample)
+{
+  if (downSampleFactor >= 1.f || pt >= ptMaxForDownSample) {
+    return true;
+  }
+  const double pseudoRndm = ptProng * 1000. - static_cast<int64_t>(ptProng * 1000);
+  return pseudoRndm < downSampleFactor;
+}
+
+/// Round a float to the given number of mantissa bits (out of 23).
+/// The zeroed low bits make the columns of features that do not need the full precision compress much better.
+/// \param value  value to round
+/// \param nMantissaBits  number of mantissa bits to keep; negative or >= 23: value returned unchanged
+/// \return rounded value
+inline float reducePrecision(float value, int nMantissaBits)
+{
+  constexpr int NMantissaBitsFloat = 23;
+  constexpr uint32_t MaskExponent = 0x7f800000;
+  if (nMantissaBits < 0 || nMantissaBits >= NMantissaBitsFloat) {
+    return value;
+  }
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  if ((bits & MaskExponent) == MaskExponent) { // inf or NaN
+    return value;
+  }
+  const int nDroppedBits = NMantissaBitsFloat - nMantissaBits;
+  bits += 1u << (nDroppedBits - 1); // round to nearest
+  bits &= ~((1u << nDroppedBits) - 1);
+  std::memcpy(&value, &bits, sizeof(bits));
+  return value;
+}
+} // namespace o2::analysis::hf_trees
+
+#endif // PWGHF_UTILS_UTILSTREECREATOR_H_
@@ -33,32 +33,41 @@ namespace fastjetutilities
 
 static constexpr float mPion = 0.139; // TDatabasePDG::Instance()->GetParticle(211)->Mass(); //can be removed when pion mass becomes default for unidentified tracks
 
-// Class defined to store additional info which is passed to the FastJet object
-class fastjet_user_info : public fastjet::PseudoJet::UserInfoBase
+// The status and the index of a constituent are packed in the user_index of its PseudoJet, user_index = index * 4 + status,
+// so that no user info object has to be allocated per constituent. A PseudoJet without user_index (-1, e.g. an area ghost)
+// decodes as status 3, which is not a JetConstituentStatus, and index -1. The index must be below 2^29.
+static constexpr int NStatusBits = 2;
+static constexpr int StatusMask = (1 << NStatusBits) - 1;
+
+inline int encodeUserIndex(int index, int status)
 {
-  int status; // the status of each particle (Options are: TrueParticle (final state particles in generator event which arent special), HFParticle (heavy-flavour particle of interest in generator event), ThermalParticle (particles belonging to the thermal backgound), DecaySisterParticle (other particles poduced in the decay resulting in a non-prompt heavy-flavour particle of interest))
-  int index;  // a number unique to each particle in the event
-
- public:
-  fastjet_user_info()
-  {
-    status = -9;
-    index = -9;
-  }
-  fastjet_user_info(int _status, int _index)
-  {
-    status = _status;
-    index = _index;
-  }
-  ~fastjet_user_info() = default;
-  void setStatus(int set) { status = set; }
-  void setIndex(int set) { index = set; }
-  int getStatus() const { return status; }
-  int getIndex() const { return index; }
-};
+  return index * (1 << NStatusBits) + status;
+}
+
+/**
+ * Get the status (JetConstituentStatus) of a jet constituent
+ *
+ * @param constituent constituent filled with fillTracks or fillClusters
+ */
+
+inline int getConstituentStatus(const fastjet::PseudoJet& constituent)
+{
+  return constituent.user_index() & StatusMask;
+}
+
+/**
+ * Get the global index of a jet constituent
+ *
+ * @param constituent constituent filled with fillTracks or fillClusters
+ */
+
+inline int getConstituentIndex(const fastjet::PseudoJet& constituent)
+{
+  return constituent.user_index() >> NStatusBits;
+}
 
 /**
- * Set the fastjet_user_info object when filling the jet constituents.
+ * Set the status and index of the last constituent, packed in its user_index.
  *
  * @param constituents vector of constituents to be clustered.
  * @param index global index of constituent
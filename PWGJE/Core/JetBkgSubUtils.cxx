@@ -20,6 +20,7 @@
 #include <TMath.h>
 
 #include <fastjet/AreaDefinition.hh>
+#include <fastjet/ClusterSequenceActiveAreaExplicitGhosts.hh>
 #include <fastjet/ClusterSequenceArea.hh>
 #include <fastjet/GhostedAreaSpec.hh>
 #include <fastjet/JetDefinition.hh>
@@ -28,11 +29,41 @@
 #include <fastjet/contrib/ConstituentSubtractor.hh>
 #include <fastjet/tools/Subtractor.hh>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <string>
 #include <tuple>
 #include <vector>
 
 #include <math.h>
 
+namespace
+{
+/// LSD radix sort of 64-bit values by their upper 32 bits, stable, byte by byte
+void radixSortByUpperWord(std::vector<uint64_t>& values, std::vector<uint64_t>& buffer)
+{
+  buffer.resize(values.size());
+  for (int shift = 32; shift < 64; shift += 8) {
+    std::array<size_t, 257> offsets{};
+    for (const auto value : values) {
+      offsets[((value >> shift) & 0xFF) + 1]++;
+    }
+    if (offsets[((values.empty() ? 0 : values[0] >> shift) & 0xFF) + 1] == values.size()) {
+      continue; // same byte everywhere, nothing to reorder
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    for (const auto value : values) {
+      buffer[offsets[(value >> shift) & 0xFF]++] = value;
+    }
+    values.swap(buffer);
+  }
+}
+} // namespace
+
 JetBkgSubUtils::JetBkgSubUtils(float jetBkgR_out, float bkgEtaMin_out, float bkgEtaMax_out, float bkgPhiMin_out, float bkgPhiMax_out, float constSubAlpha_out, float constSubRMax_out, int nHardReject_out, fastjet::GhostedAreaSpec ghostAreaSpec_out) : jetBkgR(jetBkgR_out),
                                                                                                                                                                                                                                                           bkgEtaMin(bkgEtaMin_out),
                                                                                                                                                                                                                                                           bkgEtaMax(bkgEtaMax_out),
@@ -62,9 +93,28 @@ std::tuple<double, double> JetBkgSubUtils::estimateRhoAreaMedian(const std::vect
     return std::make_tuple(0.0, 0.0);
   }
 
+  // the median only needs the jet areas and the ghost flags, so the same (cached) ghosts can be used in all events
+  if (cacheGhosts) {
+    const std::string ghostsKey = ghostAreaSpec.description();
+    if (ghostsCache.empty() || ghostsKey != ghostsCacheKey) {
+      fastjet::GhostedAreaSpec ghostSpecFixed = ghostAreaSpec.with_fixed_seed({12345, 67890});
+      ghostsCache.clear();
+      ghostSpecFixed.add_ghosts(ghostsCache);
+      ghostsCacheArea = ghostSpecFixed.actual_ghost_area();
+      ghostsCacheKey = ghostsKey;
+    }
+    fastjet::ClusterSequenceActiveAreaExplicitGhosts clusterSeq(inputParticles, jetDefBkg, ghostsCache, ghostsCacheArea);
+    return rhoAreaMedianFromClusterSequence(clusterSeq, doSparseSub);
+  }
+
   // cluster the kT jets
   fastjet::ClusterSequenceArea clusterSeq(inputParticles, jetDefBkg, areaDefBkg);
+  return rhoAreaMedianFromClusterSequence(clusterSeq, doSparseSub);
+}
 
+template <typename T>
+std::tuple<double, double> JetBkgSubUtils::rhoAreaMedianFromClusterSequence(const T& clusterSeq, bool doSparseSub)
+{
   // select jets in detector acceptance
   std::vector<fastjet::PseudoJet> alljets = selRho(clusterSeq.inclusive_jets());
 
@@ -112,11 +162,6 @@ std::tuple<double, double> JetBkgSubUtils::estimateRhoPerpCone(const std::vector
     return std::make_tuple(0.0, 0.0);
   }
 
-  double perpPtDensity1 = 0;
-  double perpPtDensity2 = 0;
-  double perpMdDensity1 = 0;
-  double perpMdDensity2 = 0;
-
   fastjet::Selector selectJet = fastjet::SelectorEtaRange(bkgEtaMin, bkgEtaMax) && fastjet::SelectorPhiRange(bkgPhiMin, bkgPhiMax);
 
   std::vector<fastjet::PseudoJet> selectedJets = fastjet::sorted_by_pt(selectJet(jets));
@@ -127,37 +172,108 @@ std::tuple<double, double> JetBkgSubUtils::estimateRhoPerpCone(const std::vector
 
   fastjet::PseudoJet leadingJet = selectedJets[0];
 
-  double dPhi1 = 999.;
-  double dPhi2 = 999.;
-  double dEta = 999.;
-  double PerpendicularConeAxisPhi1 = 999., PerpendicularConeAxisPhi2 = 999.;
+  // the properties of the particles are computed once instead of once per cone
+  particlesPt.clear();
+  particlesEta.clear();
+  particlesPhi.clear();
+  particlesMd.clear();
+  for (const auto& particle : inputParticles) {
+    particlesPt.push_back(particle.perp());
+    particlesEta.push_back(particle.eta());
+    particlesPhi.push_back(particle.phi());
+    particlesMd.push_back(TMath::Sqrt(particle.m() * particle.m() + particle.pt() * particle.pt()) - particle.pt());
+  }
+  return estimateRhoPerpCone(particlesPt, particlesEta, particlesPhi, particlesMd, leadingJet.eta(), leadingJet.phi());
+}
+
+std::tuple<double, double> JetBkgSubUtils::estimateRhoPerpCone(const std::vector<float>& pt, const std::vector<float>& eta, const std::vector<float>& phi, const std::vector<float>& mD, float jetEta, float jetPhi) const
+{
+  constexpr float TwoPI = 2. * M_PI;
   // build 2 perp cones in phi around the leading jet (right and left of the jet)
-  PerpendicularConeAxisPhi1 = RecoDecay::constrainAngle<double, double>(leadingJet.phi() + (M_PI / 2.)); // This will contrain the angel between 0-2Pi
-  PerpendicularConeAxisPhi2 = RecoDecay::constrainAngle<double, double>(leadingJet.phi() - (M_PI / 2.)); // This will contrain the angel between 0-2Pi
-
-  for (auto& particle : inputParticles) {
-    // sum the momentum of all paricles that fill the two cones
-    dPhi1 = particle.phi() - PerpendicularConeAxisPhi1;
-    dPhi1 = RecoDecay::constrainAngle<double, double>(dPhi1, -M_PI); // This will contrain the angel between -pi & Pi
-    dPhi2 = particle.phi() - PerpendicularConeAxisPhi2;
-    dPhi2 = RecoDecay::constrainAngle<double, double>(dPhi2, -M_PI); // This will contrain the angel between -pi & Pi
-    dEta = leadingJet.eta() - particle.eta();                        // The perp cone eta is the same as the leading jet since the cones are perpendicular only in phi
-    if (TMath::Sqrt(dPhi1 * dPhi1 + dEta * dEta) <= jetBkgR) {
-      perpPtDensity1 += particle.perp();
-      perpMdDensity1 += TMath::Sqrt(particle.m() * particle.m() + particle.pt() * particle.pt()) - particle.pt();
+  const float perpendicularConeAxisPhi1 = RecoDecay::constrainAngle<float, float>(jetPhi + static_cast<float>(M_PI / 2.)); // This will contrain the angel between 0-2Pi
+  const float perpendicularConeAxisPhi2 = RecoDecay::constrainAngle<float, float>(jetPhi - static_cast<float>(M_PI / 2.)); // This will contrain the angel between 0-2Pi
+  const float jetBkgR2 = jetBkgR * jetBkgR;
+
+  // sum the momentum of all paricles that fill the two cones, the loop has no branches so that it can be vectorised
+  float perpPtSum = 0.f;
+  float perpMdSum = 0.f;
+  const size_t nParticles = pt.size();
+  for (size_t iParticle = 0; iParticle < nParticles; iParticle++) {
+    const float dEta = jetEta - eta[iParticle]; // The perp cone eta is the same as the leading jet since the cones are perpendicular only in phi
+    const float dPhi1Abs = std::abs(phi[iParticle] - perpendicularConeAxisPhi1);
+    const float dPhi2Abs = std::abs(phi[iParticle] - perpendicularConeAxisPhi2);
+    const float dPhi1 = std::min(dPhi1Abs, TwoPI - dPhi1Abs);
+    const float dPhi2 = std::min(dPhi2Abs, TwoPI - dPhi2Abs);
+    const float nCones = static_cast<float>(dPhi1 * dPhi1 + dEta * dEta <= jetBkgR2) + static_cast<float>(dPhi2 * dPhi2 + dEta * dEta <= jetBkgR2);
+    perpPtSum += nCones * pt[iParticle];
+    perpMdSum += nCones * mD[iParticle];
+  }
+
+  // Caculate rho as the ratio of average pT of the two cones / the cone area
+  double perpPtDensity = perpPtSum / (2 * M_PI * jetBkgR * jetBkgR);
+  double perpMdDensity = perpMdSum / (2 * M_PI * jetBkgR * jetBkgR);
+
+  return std::make_tuple(perpPtDensity, perpMdDensity);
+}
+
+std::tuple<double, double> JetBkgSubUtils::estimateRhoGridMedian(const std::vector<fastjet::PseudoJet>& inputParticles, bool doSparseSub)
+{
+  if (inputParticles.size() == 0) {
+    return std::make_tuple(0.0, 0.0);
+  }
+
+  // the patches cover the background acceptance, with the phi range limited to one turn
+  const double phiRange = std::min<double>(bkgPhiMax - bkgPhiMin, 2.0 * M_PI);
+  const int nPatchesEta = std::max(1, static_cast<int>(std::lround((bkgEtaMax - bkgEtaMin) / gridPatchSize)));
+  const int nPatchesPhi = std::max(1, static_cast<int>(std::lround(phiRange / gridPatchSize)));
+  const double patchSizeEta = (bkgEtaMax - bkgEtaMin) / nPatchesEta;
+  const double patchSizePhi = phiRange / nPatchesPhi;
+  const double patchArea = patchSizeEta * patchSizePhi;
+
+  patchesPt.assign(nPatchesEta * nPatchesPhi, 0.);
+  patchesMd.assign(nPatchesEta * nPatchesPhi, 0.);
+  for (const auto& particle : inputParticles) {
+    const double eta = particle.eta();
+    const double phi = RecoDecay::constrainAngle<double, double>(particle.phi() - bkgPhiMin); // This will contrain the angel between 0-2Pi
+    if (eta < bkgEtaMin || eta >= bkgEtaMax || phi >= phiRange) {
+      continue;
     }
+    const int iEta = std::min(static_cast<int>((eta - bkgEtaMin) / patchSizeEta), nPatchesEta - 1);
+    const int iPhi = std::min(static_cast<int>(phi / patchSizePhi), nPatchesPhi - 1);
+    patchesPt[iEta * nPatchesPhi + iPhi] += particle.perp();
+    patchesMd[iEta * nPatchesPhi + iPhi] += TMath::Sqrt(particle.m() * particle.m() + particle.pt() * particle.pt()) - particle.pt();
+  }
 
-    if (TMath::Sqrt(dPhi2 * dPhi2 + dEta * dEta) <= jetBkgR) {
-      perpPtDensity2 += particle.perp();
-      perpMdDensity2 += TMath::Sqrt(particle.m() * particle.m() + particle.pt() * particle.pt()) - particle.pt();
+  // as for the jets of the median method, the hardest patches are rejected and only the non-empty ones enter the median
+  std::vector<int> patches(patchesPt.size());
+  std::iota(patches.begin(), patches.end(), 0);
+  std::sort(patches.begin(), patches.end(), [&](int a, int b) { return patchesPt[a] > patchesPt[b]; });
+  const int nPatches = patches.size();
+  const int nHard = std::min(nHardReject, nPatches);
+  std::vector<double> rhovector;
+  std::vector<double> rhoMdvector;
+  for (int iPatch = nHard; iPatch < nPatches; iPatch++) {
+    if (patchesPt[patches[iPatch]] > 0.) {
+      rhovector.push_back(patchesPt[patches[iPatch]] / patchArea);
+      rhoMdvector.push_back(patchesMd[patches[iPatch]] / patchArea);
     }
   }
 
-  // Caculate rho as the ratio of average pT of the two cones / the cone area
-  double perpPtDensity = (perpPtDensity1 + perpPtDensity2) / (2 * M_PI * jetBkgR * jetBkgR);
-  double perpMdDensity = (perpMdDensity1 + perpMdDensity2) / (2 * M_PI * jetBkgR * jetBkgR);
+  double rho = 0.0;
+  double rhoM = 0.0;
+  if (rhovector.size() != 0) {
+    rho = TMath::Median<double>(rhovector.size(), rhovector.data());
+    rhoM = TMath::Median<double>(rhoMdvector.size(), rhoMdvector.data());
+  }
 
-  return std::make_tuple(perpPtDensity, perpMdDensity);
+  if (doSparseSub && nPatches > nHard) {
+    // calculate The ocupancy factor, which the ratio of non-empty patches / all patches
+    double occupancyFactor = static_cast<double>(rhovector.size()) / (nPatches - nHard);
+    rho *= occupancyFactor;
+    rhoM *= occupancyFactor;
+  }
+
+  return std::make_tuple(rho, rhoM);
 }
 
 fastjet::PseudoJet JetBkgSubUtils::doRhoAreaSub(const fastjet::PseudoJet& jet, double rhoParam, double rhoMParam)
@@ -188,6 +304,122 @@ std::vector<fastjet::PseudoJet> JetBkgSubUtils::doEventConstSub(std::vector<fast
   return constituentSub.subtract_event(inputParticles, maxEtaEvent);
 }
 
+void JetBkgSubUtils::buildConstSubGhosts(double ghostArea)
+{
+  // same placement as ConstituentSubtractor: ghosts at the centres of a uniform grid covering |y| < maxEtaEvent
+  constSubGhostsNEta = std::max(1, static_cast<int>(std::ceil(2. * maxEtaEvent / std::sqrt(ghostArea))));
+  constSubGhostsNPhi = std::max(1, static_cast<int>(std::ceil(2. * M_PI / std::sqrt(ghostArea))));
+  constSubGhostsStepEta = 2. * maxEtaEvent / constSubGhostsNEta;
+  constSubGhostsStepPhi = 2. * M_PI / constSubGhostsNPhi;
+  constSubGhostsMaxEta = maxEtaEvent;
+  constSubGhostsArea = ghostArea;
+}
+
+std::vector<fastjet::PseudoJet> JetBkgSubUtils::doEventConstSubGrid(std::vector<fastjet::PseudoJet>& inputParticles, double rhoParam, double rhoMParam)
+{
+  if (constSubRMax <= 0.) {
+    return doEventConstSub(inputParticles, rhoParam, rhoMParam); // all the pairs are needed, no gain from the grid
+  }
+  const double ghostArea = ghostAreaSpec.ghost_area();
+  if (maxEtaEvent != constSubGhostsMaxEta || ghostArea != constSubGhostsArea) {
+    buildConstSubGhosts(ghostArea);
+  }
+  const int nGhosts = constSubGhostsNEta * constSubGhostsNPhi;
+  if (static_cast<uint64_t>(inputParticles.size()) * nGhosts > UINT32_MAX) {
+    return doEventConstSub(inputParticles, rhoParam, rhoMParam); // pair indices would not fit in 32 bits
+  }
+  const double ghostCellArea = constSubGhostsStepEta * constSubGhostsStepPhi;
+  constSubGhostsPt.assign(nGhosts, rhoParam * ghostCellArea);
+  constSubGhostsMd.assign(nGhosts, doRhoMassSub ? rhoMParam * ghostCellArea : 0.);
+
+  // particles outside of the event acceptance are not subtracted and not returned, as in ConstituentSubtractor::subtract_event
+  constSubParticles.clear();
+  constSubParticlesPt.clear();
+  constSubParticlesMd.clear();
+  for (size_t iParticle = 0; iParticle < inputParticles.size(); iParticle++) {
+    const auto& particle = inputParticles[iParticle];
+    if (std::abs(particle.eta()) < maxEtaEvent) {
+      constSubParticles.push_back(iParticle);
+      constSubParticlesPt.push_back(particle.pt());
+      constSubParticlesMd.push_back(particle.mt() - particle.pt());
+    }
+  }
+
+  // pairs within constSubRMax, only the ghosts of the neighbouring cells are tested
+  const double rMax2 = constSubRMax * constSubRMax;
+  const int nCellsEta = static_cast<int>(std::ceil(constSubRMax / constSubGhostsStepEta));
+  const int nCellsPhi = std::min(static_cast<int>(std::ceil(constSubRMax / constSubGhostsStepPhi)), (constSubGhostsNPhi - 1) / 2);
+  constSubPairs.clear();
+  for (size_t iParticle = 0; iParticle < constSubParticles.size(); iParticle++) {
+    const auto& particle = inputParticles[constSubParticles[iParticle]];
+    const double rap = particle.rap();
+    const double phi = particle.phi();
+    const double ptAlpha = constSubAlpha != 0. ? std::pow(constSubParticlesPt[iParticle], 2. * constSubAlpha) : 1.;
+    const int iEtaParticle = static_cast<int>(std::floor((rap + maxEtaEvent) / constSubGhostsStepEta));
+    const int iPhiParticle = static_cast<int>(phi / constSubGhostsStepPhi);
+    const int iEtaMin = std::max(0, iEtaParticle - nCellsEta);
+    const int iEtaMax = std::min(constSubGhostsNEta - 1, iEtaParticle + nCellsEta);
+    for (int iEta = iEtaMin; iEta <= iEtaMax; iEta++) {
+      const double dEta = rap - (-maxEtaEvent + (iEta + 0.5) * constSubGhostsStepEta);
+      if (dEta * dEta > rMax2) {
+        continue;
+      }
+      for (int jPhi = 0; jPhi <= 2 * nCellsPhi; jPhi++) {
+        const int iPhi = ((iPhiParticle - nCellsPhi + jPhi) % constSubGhostsNPhi + constSubGhostsNPhi) % constSubGhostsNPhi;
+        const double dPhiAbs = std::abs(phi - (iPhi + 0.5) * constSubGhostsStepPhi);
+        const double dPhi = std::min(dPhiAbs, 2. * M_PI - dPhiAbs);
+        const double deltaR2 = dEta * dEta + dPhi * dPhi;
+        if (deltaR2 > rMax2) {
+          continue;
+        }
+        // distance measure pt^alpha * deltaR, squared; non-negative floats keep their order as unsigned integers
+        const float distance = deltaR2 * ptAlpha;
+        uint32_t distanceBits;
+        std::memcpy(&distanceBits, &distance, sizeof(distanceBits));
+        constSubPairs.push_back((static_cast<uint64_t>(distanceBits) << 32) | (static_cast<uint64_t>(iParticle) * nGhosts + iEta * constSubGhostsNPhi + iPhi));
+      }
+    }
+  }
+  radixSortByUpperWord(constSubPairs, constSubPairsBuffer);
+
+  // greedy subtraction, from the closest pair on
+  for (const auto pair : constSubPairs) {
+    const uint32_t pairIndex = pair & 0xFFFFFFFF;
+    const int iParticle = pairIndex / nGhosts;
+    const int iGhost = pairIndex % nGhosts;
+    auto subtract = [](double& particleValue, double& ghostValue) {
+      if (particleValue > 0. && ghostValue > 0.) {
+        if (particleValue >= ghostValue) {
+          particleValue -= ghostValue;
+          ghostValue = 0.;
+        } else {
+          ghostValue -= particleValue;
+          particleValue = 0.;
+        }
+      }
+    };
+    subtract(constSubParticlesPt[iParticle], constSubGhostsPt[iGhost]);
+    if (doRhoMassSub) {
+      subtract(constSubParticlesMd[iParticle], constSubGhostsMd[iGhost]);
+    }
+  }
+
+  // by default, the masses of all particles are set to zero. With the mass subtraction the subtracted mD is used
+  std::vector<fastjet::PseudoJet> subtractedParticles;
+  for (size_t iParticle = 0; iParticle < constSubParticles.size(); iParticle++) {
+    const double pt = constSubParticlesPt[iParticle];
+    if (pt <= 0.) {
+      continue;
+    }
+    const auto& particle = inputParticles[constSubParticles[iParticle]];
+    const double mt = pt + (doRhoMassSub ? constSubParticlesMd[iParticle] : 0.);
+    fastjet::PseudoJet subtractedParticle = particle;
+    subtractedParticle.reset_momentum(fastjet::PtYPhiM(pt, particle.rap(), particle.phi(), std::sqrt(std::max(mt * mt - pt * pt, 0.))));
+    subtractedParticles.push_back(subtractedParticle);
+  }
+  return subtractedParticles;
+}
+
 std::vector<fastjet::PseudoJet> JetBkgSubUtils::doJetConstSub(std::vector<fastjet::PseudoJet>& jets, double rhoParam, double rhoMParam)
 {
   JetBkgSubUtils::initialise();
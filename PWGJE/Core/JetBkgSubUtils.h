@@ -23,6 +23,8 @@
 #include <fastjet/PseudoJet.hh>
 #include <fastjet/Selector.hh>
 
+#include <cstdint>
+#include <string>
 #include <tuple>
 #include <vector>
 
@@ -31,7 +33,8 @@
 enum class BkgSubEstimator { none = 0,
                              medianRho = 1,
                              medianRhoSparse = 2,
-                             perpCone = 3
+                             perpCone = 3,
+                             gridMedian = 4
 };
 
 enum class BkgSubMode { none = 0,
@@ -74,6 +77,19 @@ class JetBkgSubUtils
   /// @return Rho, RhoM the underlying event density
   std::tuple<double, double> estimateRhoPerpCone(const std::vector<fastjet::PseudoJet>& inputParticles, const std::vector<fastjet::PseudoJet>& jets);
 
+  /// @brief Background estimator using the perpendicular cone method, on arrays of the input particles properties
+  /// @param pt, eta, phi (in [0, 2pi)) of the input particles
+  /// @param mD sqrt(m^2 + pt^2) - pt of the input particles
+  /// @param jetEta, jetPhi direction of the leading jet
+  /// @return Rho, RhoM the underlying event density
+  std::tuple<double, double> estimateRhoPerpCone(const std::vector<float>& pt, const std::vector<float>& eta, const std::vector<float>& phi, const std::vector<float>& mD, float jetEta, float jetPhi) const;
+
+  /// @brief Cheaper alternative to the median method: median of the densities of fixed eta-phi patches
+  /// @param inputParticles (all particles in the event)
+  /// @param doSparseSub weather to scale rho by the fraction of non-empty patches
+  /// @return Rho, RhoM the underlying event density
+  std::tuple<double, double> estimateRhoGridMedian(const std::vector<fastjet::PseudoJet>& inputParticles, bool doSparseSub);
+
   /// @brief method that subtracts the background from jets using the area method
   /// @param jet input jet to be background subtracted
   /// @param rhoParam the underlying evvent density vs pT (to be set)
@@ -88,6 +104,13 @@ class JetBkgSubUtils
   /// @return inputParticles, a vector of background subtracted input particles
   std::vector<fastjet::PseudoJet> doEventConstSub(std::vector<fastjet::PseudoJet>& inputParticles, double rhoParam, double rhoMParam);
 
+  /// @brief same as doEventConstSub, with the particle-ghost pairs closer than constSubRMax taken from the neighbouring cells of the ghost grid and ordered with a radix sort
+  /// @param inputParticles (all the tracks/clusters/particles in the event)
+  /// @param rhoParam the underlying evvent density vs pT (to be set)
+  /// @param rhoParam the underlying evvent density vs jet mass (to be set)
+  /// @return inputParticles, a vector of background subtracted input particles
+  std::vector<fastjet::PseudoJet> doEventConstSubGrid(std::vector<fastjet::PseudoJet>& inputParticles, double rhoParam, double rhoMParam);
+
   /// @brief method that subtracts the background from jets using the jet-wise constituent subtractor
   /// @param jets (all jets in the event)
   /// @param rhoParam the underlying evvent density vs pT (to be set)
@@ -118,6 +141,8 @@ class JetBkgSubUtils
   void setJetDefinition(fastjet::JetDefinition jetdefbkg_out) { jetDefBkg = jetdefbkg_out; }
   void setAreaDefinition(fastjet::AreaDefinition areaDefBkg_out) { areaDefBkg = areaDefBkg_out; }
   void setRhoSelector(fastjet::Selector selRho_out) { selRho = selRho_out; }
+  void setCacheGhosts(bool cacheGhosts_out = true) { cacheGhosts = cacheGhosts_out; }
+  void setGridPatchSize(float gridPatchSize_out) { gridPatchSize = gridPatchSize_out; }
 
   // Getters
   float getJetBkgR() const { return jetBkgR; }
@@ -133,6 +158,8 @@ class JetBkgSubUtils
   fastjet::JetDefinition getJetDefinition() const { return jetDefBkg; }
   fastjet::AreaDefinition getAreaDefinition() const { return areaDefBkg; }
   fastjet::Selector getRhoSelector() const { return selRho; }
+  bool getCacheGhosts() const { return cacheGhosts; }
+  float getGridPatchSize() const { return gridPatchSize; }
 
   // Calculate the jet mass
   double getMd(fastjet::PseudoJet jet) const;
@@ -156,6 +183,41 @@ class JetBkgSubUtils
   fastjet::AreaDefinition areaDefBkg = fastjet::AreaDefinition(fastjet::active_area_explicit_ghosts, ghostAreaSpec);
   fastjet::Selector selRho = fastjet::Selector();
 
+  /// @brief median background estimate from a cluster sequence with explicit or implicit ghosts
+  template <typename T>
+  std::tuple<double, double> rhoAreaMedianFromClusterSequence(const T& clusterSeq, bool doSparseSub);
+
+  bool cacheGhosts = false;                    /// flag whether the ghosts of the median estimate are generated once (with a fixed seed) and reused in all events
+  std::vector<fastjet::PseudoJet> ghostsCache; /// cached ghosts, regenerated when the ghost area specification changes
+  double ghostsCacheArea = 0.;                 /// actual area of the cached ghosts
+  std::string ghostsCacheKey = "";             /// description of the ghost area specification of the cached ghosts
+
+  float gridPatchSize = 0.4; /// eta and phi size of the patches of the grid estimate
+
+  std::vector<float> particlesPt;  /// pt of the input particles of the perpendicular cone estimate
+  std::vector<float> particlesEta; /// eta of the input particles of the perpendicular cone estimate
+  std::vector<float> particlesPhi; /// phi of the input particles of the perpendicular cone estimate
+  std::vector<float> particlesMd;  /// mD of the input particles of the perpendicular cone estimate
+  std::vector<double> patchesPt;   /// summed pt of the patches of the grid estimate
+  std::vector<double> patchesMd;   /// summed mD of the patches of the grid estimate
+
+  /// @brief place the ghosts of the grid constituent subtraction, only when the event acceptance or the ghost area change
+  void buildConstSubGhosts(double ghostArea);
+
+  int constSubGhostsNEta = 0;                /// number of ghosts in rapidity of the grid constituent subtraction
+  int constSubGhostsNPhi = 0;                /// number of ghosts in phi of the grid constituent subtraction
+  double constSubGhostsStepEta = 0.;         /// rapidity spacing of the ghosts
+  double constSubGhostsStepPhi = 0.;         /// phi spacing of the ghosts
+  double constSubGhostsMaxEta = -1.;         /// event acceptance of the placed ghosts
+  double constSubGhostsArea = -1.;           /// requested area of the placed ghosts
+  std::vector<double> constSubParticlesPt;   /// pt of the particles being subtracted
+  std::vector<double> constSubParticlesMd;   /// mD of the particles being subtracted
+  std::vector<double> constSubGhostsPt;      /// pt left in the ghosts
+  std::vector<double> constSubGhostsMd;      /// mD left in the ghosts
+  std::vector<int> constSubParticles;        /// indices of the input particles in the event acceptance
+  std::vector<uint64_t> constSubPairs;       /// particle-ghost pairs, with the distance in the upper 32 bits
+  std::vector<uint64_t> constSubPairsBuffer; /// buffer of the radix sort of the pairs
+
 }; // class JetBkgSubUtils
 
 #endif // PWGJE_CORE_JETBKGSUBUTILS_H_
@@ -21,6 +21,9 @@
 #include <fastjet/PseudoJet.hh>
 #include <fastjet/Selector.hh>
 
+#include <cmath>
+#include <cstdint>
+#include <memory>
 #include <vector>
 
 /// Sets the jet finding parameters
@@ -61,7 +64,7 @@ fastjet::ClusterSequenceArea JetFinder::findJets(std::vector<fastjet::PseudoJet>
 {
   setParams();
   jets.clear();
-  fastjet::ClusterSequenceArea clusterSeq(inputParticles, jetDef, areaDef);
+  fastjet::ClusterSequenceArea clusterSeq(inputParticles, jetDef, eventAreaDefinition());
   jets = clusterSeq.inclusive_jets();
   jets = selJets(jets);
   jets = fastjet::sorted_by_pt(jets);
@@ -70,3 +73,34 @@ fastjet::ClusterSequenceArea JetFinder::findJets(std::vector<fastjet::PseudoJet>
   }
   return clusterSeq;
 }
+
+/// Performs jet finding keeping the cluster sequence inside the JetFinder
+/// \note the returned jets and their constituents stay valid until the next call
+/// \param inputParticles vector of input particles/tracks
+/// \return view of the selected jets, sorted by pt
+const std::vector<fastjet::PseudoJet>& JetFinder::findJets(std::vector<fastjet::PseudoJet>& inputParticles)
+{
+  setParams();
+  clusterSeqCache = std::make_unique<fastjet::ClusterSequenceArea>(inputParticles, jetDef, eventAreaDefinition());
+  jetsCache = fastjet::sorted_by_pt(selJets(clusterSeqCache->inclusive_jets()));
+  if (isReclustering) {
+    jetR = jetR / 5.0;
+  }
+  return jetsCache;
+}
+
+/// Area definition of the current event, with the ghost seed fixed if requested
+fastjet::AreaDefinition JetFinder::eventAreaDefinition() const
+{
+  if (!fixedGhostSeed || !hasEventSeed) {
+    return areaDef;
+  }
+  // splitmix64 of the event and the radius, mapped onto the seed ranges of the fastjet random generator
+  uint64_t seed = eventSeed ^ (static_cast<uint64_t>(std::round(jetR * 1000.)) << 48);
+  seed += 0x9e3779b97f4a7c15ULL;
+  seed = (seed ^ (seed >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  seed = (seed ^ (seed >> 27)) * 0x94d049bb133111ebULL;
+  seed ^= seed >> 31;
+  std::vector<int> ghostSeed{static_cast<int>(1 + (seed & 0xffffffffULL) % 2147483562ULL), static_cast<int>(1 + (seed >> 32) % 2147483398ULL)};
+  return areaDef.with_fixed_seed(ghostSeed);
+}
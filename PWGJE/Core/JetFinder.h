@@ -27,6 +27,8 @@
 
 #include <Rtypes.h>
 
+#include <cstdint>
+#include <memory>
 #include <vector>
 
 #include <math.h>
@@ -83,10 +85,20 @@ class JetFinder
   fastjet::Selector selJets;
   fastjet::Selector selGhosts;
   double fastjetExtraParam = -99.0;
+  bool fixedGhostSeed = false; // seed the ghosts from the event set with setEventSeed, for reproducible jet areas
 
   /// Sets the jet finding parameters
   void setParams();
 
+  /// Sets the event used to seed the ghosts of the following jet finding calls
+  /// \note only used if fixedGhostSeed is set; the seed is further combined with the jet radius
+  /// \param eventId unique identifier of the event, e.g. the collision global index
+  void setEventSeed(uint64_t eventId)
+  {
+    eventSeed = eventId;
+    hasEventSeed = true;
+  }
+
   /// Performs jet finding
   /// \note the input particle and jet lists are passed by reference
   /// \param inputParticles vector of input particles/tracks
@@ -94,7 +106,24 @@ class JetFinder
   /// \return ClusterSequenceArea object needed to access constituents
   fastjet::ClusterSequenceArea findJets(std::vector<fastjet::PseudoJet>& inputParticles, std::vector<fastjet::PseudoJet>& jets); // ideally find a way of passing the cluster sequence as a reeference
 
+  /// Performs jet finding keeping the cluster sequence inside the JetFinder
+  /// \note the returned jets and their constituents stay valid until the next call
+  /// \param inputParticles vector of input particles/tracks
+  /// \return view of the selected jets, sorted by pt
+  const std::vector<fastjet::PseudoJet>& findJets(std::vector<fastjet::PseudoJet>& inputParticles);
+
+  /// Cluster sequence of the last call to findJets(inputParticles)
+  const fastjet::ClusterSequenceArea* getClusterSequence() const { return clusterSeqCache.get(); }
+
  private:
+  /// Area definition of the current event, with the ghost seed fixed if requested
+  fastjet::AreaDefinition eventAreaDefinition() const;
+
+  uint64_t eventSeed = 0;
+  bool hasEventSeed = false;
+  std::unique_ptr<fastjet::ClusterSequenceArea> clusterSeqCache; //!
+  std::vector<fastjet::PseudoJet> jetsCache;                     //!
+
   ClassDefNV(JetFinder, 1);
 };
 
@@ -32,6 +32,7 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <numeric>
 #include <ostream>
 #include <stdexcept>
@@ -292,68 +293,218 @@ std::tuple<std::vector<int>, std::vector<int>> MatchJetsGeometrically(
   return std::make_tuple(baseToTagMap, tagToBaseMap);
 }
 
-template <typename T, typename U>
-void MatchGeo(T const& jetsBasePerCollision, U const& jetsTagPerCollision, std::vector<std::vector<int>>& baseToTagMatchingGeo, std::vector<std::vector<int>>& tagToBaseMatchingGeo, float maxMatchingDistance)
+/**
+ * Eta-phi grid of jets for nearest neighbour searches with periodic phi.
+ *
+ * The cells are at least as large as the search distance, so only the 3x3 neighbouring cells of a point
+ * have to be visited. Phi is treated periodically, so jets do not need to be duplicated around the boundary.
+ */
+template <typename T>
+class JetEtaPhiGrid
 {
-  std::vector<double> jetsR;
-  for (const auto& jetBase : jetsBasePerCollision) {
-    if (std::find(jetsR.begin(), jetsR.end(), std::round(jetBase.r())) == jetsR.end()) {
-      jetsR.push_back(std::round(jetBase.r()));
+ public:
+  /**
+   * @param jetsPhi Jets phi
+   * @param jetsEta Jets eta
+   * @param cellSize Minimum cell size, should be the maximum search distance.
+   */
+  JetEtaPhiGrid(const std::vector<T>& jetsPhi, const std::vector<T>& jetsEta, double cellSize)
+    : mJetsPhi(jetsPhi), mJetsEta(jetsEta)
+  {
+    const std::size_t nJets = jetsEta.size();
+    if (nJets == 0) {
+      return;
     }
-  }
-  for (const auto& jetTag : jetsTagPerCollision) {
-    if (std::find(jetsR.begin(), jetsR.end(), std::round(jetTag.r())) == jetsR.end()) {
-      jetsR.push_back(std::round(jetTag.r()));
+    const auto [etaMin, etaMax] = std::minmax_element(jetsEta.begin(), jetsEta.end());
+    mEtaMin = *etaMin;
+    if (cellSize > 0) {
+      mEtaCellSize = cellSize;
+      mNEtaCells = std::min(static_cast<int>((*etaMax - *etaMin) / cellSize) + 1, kMaxCellsPerAxis);
+      mEtaCellSize = std::max(cellSize, (*etaMax - *etaMin) / mNEtaCells);
+      mNPhiCells = std::clamp(static_cast<int>(2 * M_PI / cellSize), 1, kMaxCellsPerAxis);
+    }
+    mPhiCellSize = 2 * M_PI / mNPhiCells;
+
+    // jet indices sorted by cell, mCellStart[iCell]..mCellStart[iCell + 1] are the jets of cell iCell
+    std::vector<int> jetCells(nJets);
+    mCellStart.assign(mNEtaCells * mNPhiCells + 1, 0);
+    for (std::size_t i = 0; i < nJets; i++) {
+      jetCells[i] = etaCell(jetsEta[i]) * mNPhiCells + phiCell(jetsPhi[i]);
+      mCellStart[jetCells[i] + 1]++;
+    }
+    std::partial_sum(mCellStart.begin(), mCellStart.end(), mCellStart.begin());
+    mJetIndices.resize(nJets);
+    std::vector<int> fill(mCellStart.begin(), mCellStart.end() - 1);
+    for (std::size_t i = 0; i < nJets; i++) {
+      mJetIndices[fill[jetCells[i]]++] = i;
     }
   }
-  for (auto jetR : jetsR) {
-    std::vector<double> jetsBasePhi;
-    std::vector<double> jetsBaseEta;
-    std::vector<int> baseToTagMatchingGeoIndex;
-    std::vector<int> tagToBaseMatchingGeoIndex;
 
-    for (const auto& jetBase : jetsBasePerCollision) {
-      if (std::round(jetBase.r()) != std::round(jetR)) {
-        continue;
-      }
-      jetsBasePhi.emplace_back(jetBase.phi());
-      jetsBaseEta.emplace_back(jetBase.eta());
+  /**
+   * Find the closest jet to a point.
+   *
+   * @param phi Phi of the point
+   * @param eta Eta of the point
+   * @param maxDistance Maximum distance, must not be larger than the cell size.
+   *
+   * @returns Index of the closest jet with a distance smaller than maxDistance, -1 if there is none.
+   */
+  int findClosest(T phi, T eta, double maxDistance) const
+  {
+    if (mJetIndices.empty()) {
+      return -1;
     }
-    std::vector<double> jetsTagPhi;
-    std::vector<double> jetsTagEta;
-    for (const auto& jetTag : jetsTagPerCollision) {
-      if (std::round(jetTag.r()) != std::round(jetR)) {
-        continue;
+    const double etaPosition = std::clamp((eta - mEtaMin) / mEtaCellSize, -2., mNEtaCells + 1.);
+    const int iEtaCenter = static_cast<int>(std::floor(etaPosition));
+    const int iPhiCenter = phiCell(phi);
+    const int nPhiNeighbours = std::min(mNPhiCells, 3);
+    int closest = -1;
+    double closestDistance = maxDistance;
+    for (int iEta = std::max(iEtaCenter - 1, 0); iEta <= std::min(iEtaCenter + 1, mNEtaCells - 1); iEta++) {
+      for (int jPhi = 0; jPhi < nPhiNeighbours; jPhi++) {
+        const int iPhi = (mNPhiCells > 3) ? (iPhiCenter - 1 + jPhi + mNPhiCells) % mNPhiCells : jPhi;
+        const int iCell = iEta * mNPhiCells + iPhi;
+        for (int k = mCellStart[iCell]; k < mCellStart[iCell + 1]; k++) {
+          const int iJet = mJetIndices[k];
+          const double deltaEta = eta - mJetsEta[iJet];
+          double deltaPhi = std::fmod(std::abs(phi - mJetsPhi[iJet]), 2 * M_PI);
+          if (deltaPhi > M_PI) {
+            deltaPhi = 2 * M_PI - deltaPhi;
+          }
+          const double distance = std::sqrt(deltaEta * deltaEta + deltaPhi * deltaPhi);
+          if (distance < closestDistance) {
+            closestDistance = distance;
+            closest = iJet;
+          }
+        }
       }
-      jetsTagPhi.emplace_back(jetTag.phi());
-      jetsTagEta.emplace_back(jetTag.eta());
     }
-    std::tie(baseToTagMatchingGeoIndex, tagToBaseMatchingGeoIndex) = MatchJetsGeometrically(jetsBasePhi, jetsBaseEta, jetsTagPhi, jetsTagEta, maxMatchingDistance); // change max distnace to a function call
-    int jetBaseIndex = 0;
-    for (const auto& jetBase : jetsBasePerCollision) {
-      if (std::round(jetBase.r()) != std::round(jetR)) {
-        continue;
-      }
-      int jetTagIndex = baseToTagMatchingGeoIndex[jetBaseIndex];
-      int jetTagGlobalIndex;
-      if (jetTagIndex > -1 && jetTagIndex < jetsTagPerCollision.size()) {
-        jetTagGlobalIndex = jetsTagPerCollision.iteratorAt(jetTagIndex).globalIndex();
-        baseToTagMatchingGeo[jetBase.globalIndex()].push_back(jetTagGlobalIndex);
+    return closest;
+  }
+
+ private:
+  static constexpr int kMaxCellsPerAxis = 1000;
+
+  int etaCell(T eta) const
+  {
+    return std::clamp(static_cast<int>((eta - mEtaMin) / mEtaCellSize), 0, mNEtaCells - 1);
+  }
+  int phiCell(T phi) const
+  {
+    const double phiWrapped = phi - 2 * M_PI * std::floor(phi / (2 * M_PI));
+    return std::clamp(static_cast<int>(phiWrapped / mPhiCellSize), 0, mNPhiCells - 1);
+  }
+
+  const std::vector<T>& mJetsPhi;
+  const std::vector<T>& mJetsEta;
+  double mEtaMin = 0.;
+  double mEtaCellSize = 1.;
+  double mPhiCellSize = 2 * M_PI;
+  int mNEtaCells = 1;
+  int mNPhiCells = 1;
+  std::vector<int> mCellStart;
+  std::vector<int> mJetIndices;
+};
+
+/**
+ * Geometrical jet matching on an eta-phi grid.
+ *
+ * Same matching as `MatchJetsGeometrically`: jets are required to match uniquely (base <-> tag) to the
+ * closest jet within the matching distance. The nearest neighbour search only visits the neighbouring
+ * cells of a `JetEtaPhiGrid` and treats phi periodically, so no jets are duplicated around the phi boundary.
+ *
+ * @param jetsBasePhi Base jet collection phi.
+ * @param jetsBaseEta Base jet collection eta.
+ * @param jetsTagPhi Tag jet collection phi.
+ * @param jetsTagEta Tag jet collection eta.
+ * @param maxMatchingDistance Maximum matching distance.
+ *
+ * @returns (Base to tag index map, tag to base index map) for uniquely matched jets.
+ */
+template <typename T>
+std::tuple<std::vector<int>, std::vector<int>> MatchJetsGeometricallyGrid(
+  const std::vector<T>& jetsBasePhi,
+  const std::vector<T>& jetsBaseEta,
+  const std::vector<T>& jetsTagPhi,
+  const std::vector<T>& jetsTagEta,
+  double maxMatchingDistance)
+{
+  const std::size_t nJetsBase = jetsBaseEta.size();
+  const std::size_t nJetsTag = jetsTagEta.size();
+  std::vector<int> baseToTagMap(nJetsBase, -1);
+  std::vector<int> tagToBaseMap(nJetsTag, -1);
+  if (!(nJetsBase && nJetsTag)) {
+    return std::make_tuple(baseToTagMap, tagToBaseMap);
+  }
+  if (jetsBasePhi.size() != nJetsBase) {
+    throw std::invalid_argument("Base collection eta and phi sizes don't match. Check the inputs.");
+  }
+  if (jetsTagPhi.size() != nJetsTag) {
+    throw std::invalid_argument("Tag collection eta and phi sizes don't match. Check the inputs.");
+  }
+
+  const JetEtaPhiGrid<T> gridBase(jetsBasePhi, jetsBaseEta, maxMatchingDistance);
+  const JetEtaPhiGrid<T> gridTag(jetsTagPhi, jetsTagEta, maxMatchingDistance);
+
+  // Find the tag jet closest to each base jet, and check if that base jet is the closest one to the tag jet
+  for (std::size_t iBase = 0; iBase < nJetsBase; iBase++) {
+    const int iTag = gridTag.findClosest(jetsBasePhi[iBase], jetsBaseEta[iBase], maxMatchingDistance);
+    if (iTag < 0) {
+      continue;
+    }
+    if (gridBase.findClosest(jetsTagPhi[iTag], jetsTagEta[iTag], maxMatchingDistance) == static_cast<int>(iBase)) {
+      LOG(debug) << "True match! base index: " << iBase << ", tag index: " << iTag << "\n";
+      baseToTagMap[iBase] = iTag;
+      tagToBaseMap[iTag] = iBase;
+    }
+  }
+
+  return std::make_tuple(baseToTagMap, tagToBaseMap);
+}
+
+template <typename T, typename U>
+void MatchGeo(T const& jetsBasePerCollision, U const& jetsTagPerCollision, std::vector<std::vector<int>>& baseToTagMatchingGeo, std::vector<std::vector<int>>& tagToBaseMatchingGeo, float maxMatchingDistance)
+{
+  // jets of all radii are collected in one pass over each collection and then matched per radius
+  struct JetsForR {
+    double jetR;
+    std::vector<double> basePhi, baseEta, tagPhi, tagEta;
+    std::vector<int> baseGlobalIndex, tagGlobalIndex;
+  };
+  std::vector<JetsForR> jetsPerR;
+  auto getJetsForR = [&jetsPerR](double jetR) -> JetsForR& {
+    for (auto& jets : jetsPerR) {
+      if (jets.jetR == jetR) {
+        return jets;
       }
-      jetBaseIndex++;
     }
-    int jetTagIndex = 0;
-    for (const auto& jetTag : jetsTagPerCollision) {
-      if (std::round(jetTag.r()) != std::round(jetR)) {
-        continue;
+    jetsPerR.push_back(JetsForR{jetR, {}, {}, {}, {}, {}, {}});
+    return jetsPerR.back();
+  };
+  for (const auto& jetBase : jetsBasePerCollision) {
+    auto& jets = getJetsForR(std::round(jetBase.r()));
+    jets.basePhi.emplace_back(jetBase.phi());
+    jets.baseEta.emplace_back(jetBase.eta());
+    jets.baseGlobalIndex.emplace_back(jetBase.globalIndex());
+  }
+  for (const auto& jetTag : jetsTagPerCollision) {
+    auto& jets = getJetsForR(std::round(jetTag.r()));
+    jets.tagPhi.emplace_back(jetTag.phi());
+    jets.tagEta.emplace_back(jetTag.eta());
+    jets.tagGlobalIndex.emplace_back(jetTag.globalIndex());
+  }
+
+  for (const auto& jets : jetsPerR) {
+    auto&& [baseToTagMatchingGeoIndex, tagToBaseMatchingGeoIndex] = MatchJetsGeometricallyGrid(jets.basePhi, jets.baseEta, jets.tagPhi, jets.tagEta, maxMatchingDistance);
+    for (std::size_t iBase = 0; iBase < baseToTagMatchingGeoIndex.size(); iBase++) {
+      if (baseToTagMatchingGeoIndex[iBase] > -1) {
+        baseToTagMatchingGeo[jets.baseGlobalIndex[iBase]].push_back(jets.tagGlobalIndex[baseToTagMatchingGeoIndex[iBase]]);
       }
-      int jetBaseIndex = tagToBaseMatchingGeoIndex[jetTagIndex];
-      int jetBaseGlobalIndex;
-      if (jetBaseIndex > -1 && jetBaseIndex < jetsBasePerCollision.size()) {
-        jetBaseGlobalIndex = jetsBasePerCollision.iteratorAt(jetBaseIndex).globalIndex();
-        tagToBaseMatchingGeo[jetTag.globalIndex()].push_back(jetBaseGlobalIndex);
+    }
+    for (std::size_t iTag = 0; iTag < tagToBaseMatchingGeoIndex.size(); iTag++) {
+      if (tagToBaseMatchingGeoIndex[iTag] > -1) {
+        tagToBaseMatchingGeo[jets.tagGlobalIndex[iTag]].push_back(jets.baseGlobalIndex[tagToBaseMatchingGeoIndex[iTag]]);
       }
-      jetTagIndex++;
     }
   }
 }
@@ -411,60 +562,69 @@ auto constexpr getConstituentId(T const& track)
   }
 }
 
+// sorted ids of the track constituents of a jet, as compared to the constituents of the jets of the other collection
+template <bool isMc, typename T>
+std::vector<int64_t> getSortedConstituentIds(T const& tracks)
+{
+  std::vector<int64_t> ids;
+  for (const auto& track : tracks) {
+    ids.push_back(getConstituentId<isMc>(track));
+  }
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+// tagIds are the sorted constituent ids of the tag jet (getSortedConstituentIds<jetsBaseIsMc>), so that each base constituent is a binary search instead of a loop over the tag constituents
 template <bool isEMCAL, bool isCandidate, bool jetsBaseIsMc, bool jetsTagIsMc, typename T, typename U, typename V, typename O, typename P, typename Q, typename R, typename S>
-float getPtSum(T const& tracksBase, U const& candidatesBase, V const& clustersBase, O const& tracksTag, P const& candidatesTag, Q const& clustersTag, R const& fullTracksBase, S const& fullTracksTag)
+float getPtSum(T const& tracksBase, U const& candidatesBase, V const& clustersBase, O const& tracksTag, P const& candidatesTag, Q const& clustersTag, R const& fullTracksBase, S const& fullTracksTag, const std::vector<int64_t>& tagIds)
 {
-  std::vector<int> particleTracker;
+  auto isInSorted = [](const std::vector<int64_t>& ids, int64_t id) {
+    return std::binary_search(ids.begin(), ids.end(), id);
+  };
+
+  std::vector<int64_t> particleTracker;
   float ptSum = 0.;
   for (const auto& trackBase : tracksBase) {
     auto trackBaseId = getConstituentId<jetsTagIsMc>(trackBase);
-    for (const auto& trackTag : tracksTag) {
-      auto trackTagId = getConstituentId<jetsBaseIsMc>(trackTag);
-      if (trackBaseId != -1 && trackBaseId == trackTagId) {
-        ptSum += trackBase.pt();
-        if constexpr (jetsBaseIsMc) {
-          particleTracker.push_back(trackBaseId);
-        }
-        break;
+    if (trackBaseId != -1 && isInSorted(tagIds, trackBaseId)) {
+      ptSum += trackBase.pt();
+      if constexpr (jetsBaseIsMc) {
+        particleTracker.push_back(trackBaseId);
       }
     }
   }
   if constexpr (isEMCAL) {
     if constexpr (jetsTagIsMc) {
+      std::vector<int64_t> tagGlobalIds;
+      for (const auto& trackTag : tracksTag) {
+        tagGlobalIds.push_back(trackTag.globalIndex());
+      }
+      std::sort(tagGlobalIds.begin(), tagGlobalIds.end());
       for (const auto& clusterBase : clustersBase) {
         for (const auto& clusterBaseParticleId : clusterBase.mcParticlesIds()) {
-          bool isClusterMatched = false;
-          for (const auto& trackTag : tracksTag) {
-            if (clusterBaseParticleId != -1 && clusterBaseParticleId == trackTag.globalIndex()) {
-              ptSum += clusterBase.energy() / std::cosh(clusterBase.eta());
-              isClusterMatched = true;
-              break;
-            }
-          }
-          if (isClusterMatched) {
+          if (clusterBaseParticleId != -1 && isInSorted(tagGlobalIds, clusterBaseParticleId)) {
+            ptSum += clusterBase.energy() / std::cosh(clusterBase.eta());
             break;
           }
         }
       }
     }
     if constexpr (jetsBaseIsMc) {
+      std::sort(particleTracker.begin(), particleTracker.end());
+      std::vector<int64_t> clusterTagParticleIds;
+      for (const auto& clusterTag : clustersTag) {
+        for (const auto& clusterTagParticleId : clusterTag.mcParticlesIds()) {
+          clusterTagParticleIds.push_back(clusterTagParticleId);
+        }
+      }
+      std::sort(clusterTagParticleIds.begin(), clusterTagParticleIds.end());
       for (const auto& trackBase : tracksBase) {
-        if (std::find(particleTracker.begin(), particleTracker.end(), trackBase.globalIndex()) != particleTracker.end()) {
+        if (isInSorted(particleTracker, trackBase.globalIndex())) {
           continue;
         }
         auto trackBaseId = trackBase.globalIndex();
-        for (const auto& clusterTag : clustersTag) {
-          bool isClusterMatched = false;
-          for (const auto& clusterTagParticleId : clusterTag.mcParticlesIds()) {
-            if (trackBaseId != -1 && trackBaseId == clusterTagParticleId) {
-              ptSum += trackBase.pt();
-              isClusterMatched = true;
-              break;
-            }
-          }
-          if (isClusterMatched) {
-            break;
-          }
+        if (trackBaseId != -1 && isInSorted(clusterTagParticleIds, trackBaseId)) {
+          ptSum += trackBase.pt();
         }
       }
     }
@@ -532,11 +692,19 @@ void MatchPt(T const& jetsBasePerCollision, U const& jetsTagPerCollision, std::v
 {
   float ptSumBase;
   float ptSumTag;
+  // the sorted constituent ids are built once per jet instead of once per pair of jets
+  std::vector<std::vector<int64_t>> tagJetsIds;
+  for (const auto& jetTag : jetsTagPerCollision) {
+    tagJetsIds.push_back(getSortedConstituentIds<jetsBaseIsMc>(getConstituents(jetTag, tracksTag)));
+  }
   for (const auto& jetBase : jetsBasePerCollision) {
     auto jetBaseTracks = getConstituents(jetBase, tracksBase);
     auto jetBaseClusters = getConstituents(jetBase, clustersBase);
     auto jetBaseCandidates = getConstituents(jetBase, candidatesBase);
+    const auto baseJetIds = getSortedConstituentIds<jetsTagIsMc>(jetBaseTracks);
+    std::size_t iTag = 0;
     for (const auto& jetTag : jetsTagPerCollision) {
+      const auto& tagJetIds = tagJetsIds[iTag++];
       if (std::round(jetBase.r()) != std::round(jetTag.r())) {
         continue;
       }
@@ -544,8 +712,8 @@ void MatchPt(T const& jetsBasePerCollision, U const& jetsTagPerCollision, std::v
       auto jetTagClusters = getConstituents(jetTag, clustersTag);
       auto jetTagCandidates = getConstituents(jetTag, candidatesTag);
 
-      ptSumBase = getPtSum < jetfindingutilities::isEMCALClusterTable<N>() || jetfindingutilities::isEMCALClusterTable<Q>(), (jetcandidateutilities::isCandidateTable<M>() || jetcandidateutilities::isCandidateMcTable<M>()) && (jetcandidateutilities::isCandidateTable<P>() || jetcandidateutilities::isCandidateMcTable<P>()), jetsBaseIsMc, jetsTagIsMc > (jetBaseTracks, jetBaseCandidates, jetBaseClusters, jetTagTracks, jetTagCandidates, jetTagClusters, tracksBase, tracksTag);
-      ptSumTag = getPtSum < jetfindingutilities::isEMCALClusterTable<N>() || jetfindingutilities::isEMCALClusterTable<Q>(), (jetcandidateutilities::isCandidateTable<M>() || jetcandidateutilities::isCandidateMcTable<M>()) && (jetcandidateutilities::isCandidateTable<P>() || jetcandidateutilities::isCandidateMcTable<P>()), jetsTagIsMc, jetsBaseIsMc > (jetTagTracks, jetTagCandidates, jetTagClusters, jetBaseTracks, jetBaseCandidates, jetBaseClusters, tracksTag, tracksBase);
+      ptSumBase = getPtSum < jetfindingutilities::isEMCALClusterTable<N>() || jetfindingutilities::isEMCALClusterTable<Q>(), (jetcandidateutilities::isCandidateTable<M>() || jetcandidateutilities::isCandidateMcTable<M>()) && (jetcandidateutilities::isCandidateTable<P>() || jetcandidateutilities::isCandidateMcTable<P>()), jetsBaseIsMc, jetsTagIsMc > (jetBaseTracks, jetBaseCandidates, jetBaseClusters, jetTagTracks, jetTagCandidates, jetTagClusters, tracksBase, tracksTag, tagJetIds);
+      ptSumTag = getPtSum < jetfindingutilities::isEMCALClusterTable<N>() || jetfindingutilities::isEMCALClusterTable<Q>(), (jetcandidateutilities::isCandidateTable<M>() || jetcandidateutilities::isCandidateMcTable<M>()) && (jetcandidateutilities::isCandidateTable<P>() || jetcandidateutilities::isCandidateMcTable<P>()), jetsTagIsMc, jetsBaseIsMc > (jetTagTracks, jetTagCandidates, jetTagClusters, jetBaseTracks, jetBaseCandidates, jetBaseClusters, tracksTag, tracksBase, baseJetIds);
       if (ptSumBase > jetBase.pt() * minPtFraction) {
         baseToTagMatchingPt[jetBase.globalIndex()].push_back(jetTag.globalIndex());
       }
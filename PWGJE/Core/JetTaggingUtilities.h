@@ -446,6 +446,74 @@ int16_t getJetFlavorHadron(AnyJet const& jet, AllMCParticles const& mcparticles)
   return JetTaggingSpecies::lightflavour; // Light flavor jet
 }
 
+/**
+ * heavy-flavour quark or hadron of an MC collision, used for the jet flavour definition by distance
+ */
+struct HfFlavourSource {
+  float eta;
+  float phi;
+  int16_t flavour; // JetTaggingSpecies::charm or JetTaggingSpecies::beauty
+};
+
+/**
+ * collects the charm and beauty quarks or hadrons of an MC collision, to be done once per collision so that the flavour of each of its jets is a lookup in this short list (see getJetFlavorFromSources) instead of a scan of all the particles
+ *
+ * @param mcparticles the mc particles of the collision
+ * @param searchUpToQuark if true the quarks are collected as in getJetFlavor, otherwise the hadrons as in getJetFlavorHadron
+ * @param sources vector filled with the heavy-flavour quarks or hadrons
+ */
+template <typename AllMCParticles>
+void fillHfFlavourSources(AllMCParticles const& mcparticles, bool searchUpToQuark, std::vector<HfFlavourSource>& sources)
+{
+  sources.clear();
+  for (auto const& mcpart : mcparticles) {
+    int pdgcode = mcpart.pdgCode();
+    int16_t flavour = JetTaggingSpecies::none;
+    if (searchUpToQuark) {
+      if (std::abs(pdgcode) == 5) {
+        flavour = JetTaggingSpecies::beauty;
+      } else if (std::abs(pdgcode) == 4) {
+        flavour = JetTaggingSpecies::charm;
+      }
+    } else {
+      if (isBHadron(pdgcode)) {
+        flavour = JetTaggingSpecies::beauty;
+      } else if (isCHadron(pdgcode)) {
+        flavour = JetTaggingSpecies::charm;
+      }
+    }
+    if (flavour != JetTaggingSpecies::none) {
+      sources.push_back({mcpart.eta(), mcpart.phi(), flavour});
+    }
+  }
+}
+
+/**
+ * return the jet flavor from the heavy-flavour sources of its collision: 0 for lf-jet, 1 for c-jet, 2 for b-jet. Same result as getJetFlavor or getJetFlavorHadron, depending on how the sources were filled
+ *
+ * @param AnyJet the jet that we need to study its flavor
+ * @param sources the heavy-flavour quarks or hadrons of the collision, from fillHfFlavourSources
+ */
+template <typename AnyJet>
+int16_t getJetFlavorFromSources(AnyJet const& jet, std::vector<HfFlavourSource> const& sources)
+{
+  bool charm = false;
+  for (auto const& source : sources) {
+    if (jetutilities::deltaR(jet.eta(), jet.phi(), source.eta, source.phi) < jet.r() / 100.f) {
+      if (source.flavour == JetTaggingSpecies::beauty) {
+        return JetTaggingSpecies::beauty; // Beauty jet
+      }
+      charm = true;
+    }
+  }
+
+  if (charm) {
+    return JetTaggingSpecies::charm; // Charm jet
+  }
+
+  return JetTaggingSpecies::lightflavour; // Light flavor jet
+}
+
 /**
  * return acceptance of track about DCA xy and z due to cut for QualityTracks
  */
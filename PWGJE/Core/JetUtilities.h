@@ -28,6 +28,7 @@
 #include <limits>
 #include <stdexcept>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include <math.h>
@@ -141,6 +142,136 @@ std::tuple<std::vector<std::vector<int>>, std::vector<std::vector<int>>> MatchCl
   return std::make_tuple(matchIndexTrack, matchIndexCluster);
 }
 
+/**
+ * Compact (CSR-like) index map from each entry of a collection to its matches in another one.
+ *
+ * The matches of entry i are indices[offsets[i]], ..., indices[offsets[i + 1] - 1], the closest first.
+ */
+struct MatchIndexMap {
+  std::vector<int> offsets{0};
+  std::vector<int> indices;
+
+  std::size_t size() const { return offsets.size() - 1; }
+  int nMatches(std::size_t i) const { return offsets[i + 1] - offsets[i]; }
+  int match(std::size_t i, int m) const { return indices[offsets[i] + m]; }
+  void clear()
+  {
+    offsets.assign(1, 0);
+    indices.clear();
+  }
+};
+
+/**
+ * Uniform eta-phi grid of the points of a collection, e.g. the tracks at the EMCal surface.
+ *
+ * The points are sorted by cell (counting sort), such that the search of the neighbours within a
+ * distance equal to the cell size only has to look at the 3x3 cells around the query point.
+ * The buffers are kept between builds to avoid allocations.
+ */
+template <typename T>
+class EtaPhiGrid
+{
+ public:
+  void build(std::vector<T> const& eta, std::vector<T> const& phi, T cellSize)
+  {
+    mInvCellSize = 1. / cellSize;
+    const std::size_t nPoints = eta.size();
+    mNEta = mNPhi = 1;
+    if (nPoints) {
+      mMinEta = *std::min_element(eta.begin(), eta.end());
+      mMinPhi = *std::min_element(phi.begin(), phi.end());
+      mNEta = static_cast<int>((*std::max_element(eta.begin(), eta.end()) - mMinEta) * mInvCellSize) + 1;
+      mNPhi = static_cast<int>((*std::max_element(phi.begin(), phi.end()) - mMinPhi) * mInvCellSize) + 1;
+    }
+    mCellOffsets.assign(mNEta * mNPhi + 1, 0);
+    mPointCells.resize(nPoints);
+    for (std::size_t i = 0; i < nPoints; i++) {
+      mPointCells[i] = cellIndex(etaBin(eta[i]), phiBin(phi[i]));
+      mCellOffsets[mPointCells[i] + 1]++;
+    }
+    for (std::size_t iCell = 1; iCell < mCellOffsets.size(); iCell++) {
+      mCellOffsets[iCell] += mCellOffsets[iCell - 1];
+    }
+    mPoints.resize(nPoints);
+    mFill.assign(mCellOffsets.begin(), mCellOffsets.end() - 1);
+    for (std::size_t i = 0; i < nPoints; i++) {
+      mPoints[mFill[mPointCells[i]]++] = i;
+    }
+  }
+
+  /// Call function(index) for all the points in the cells overlapping [eta -+ distance] x [phi -+ distance], distance <= cell size
+  template <typename Function>
+  void forEachNeighbourCandidate(T eta, T phi, T distance, Function function) const
+  {
+    const int etaFirst = std::max(etaBin(eta - distance), 0), etaLast = std::min(etaBin(eta + distance), mNEta - 1);
+    const int phiFirst = std::max(phiBin(phi - distance), 0), phiLast = std::min(phiBin(phi + distance), mNPhi - 1);
+    for (int iEta = etaFirst; iEta <= etaLast; iEta++) {
+      for (int iPhi = phiFirst; iPhi <= phiLast; iPhi++) {
+        const int iCell = cellIndex(iEta, iPhi);
+        for (int iPoint = mCellOffsets[iCell]; iPoint < mCellOffsets[iCell + 1]; iPoint++) {
+          function(mPoints[iPoint]);
+        }
+      }
+    }
+  }
+
+ private:
+  int etaBin(T eta) const { return static_cast<int>(std::floor((eta - mMinEta) * mInvCellSize)); }
+  int phiBin(T phi) const { return static_cast<int>(std::floor((phi - mMinPhi) * mInvCellSize)); }
+  int cellIndex(int iEta, int iPhi) const { return iEta * mNPhi + iPhi; }
+
+  T mMinEta = 0, mMinPhi = 0, mInvCellSize = 1;
+  int mNEta = 1, mNPhi = 1;
+  std::vector<int> mCellOffsets; // first point of each cell in mPoints
+  std::vector<int> mPoints;      // point indices sorted by cell
+  std::vector<int> mPointCells;  // cell of each point
+  std::vector<int> mFill;        // fill position of each cell during the build
+};
+
+/**
+ * Match clusters and tracks with an eta-phi grid of the tracks.
+ *
+ * Same selection as the cluster to track map of MatchClustersAndTracks, i.e. up to maxNumberMatches tracks
+ * with a distance in (eta, phi) smaller than maxMatchingDistance, ordered by distance, but only the tracks
+ * of the neighbouring grid cells are considered. The grid cell size must not be smaller than maxMatchingDistance.
+ *
+ * @param trackGrid grid of the tracks, built with trackEta and trackPhi.
+ * @param clusterToTrackMap output map, with one entry per cluster.
+ */
+template <typename T>
+void MatchClustersAndTracks(
+  EtaPhiGrid<T> const& trackGrid,
+  std::vector<T> const& clusterPhi,
+  std::vector<T> const& clusterEta,
+  std::vector<T> const& trackPhi,
+  std::vector<T> const& trackEta,
+  double maxMatchingDistance,
+  int maxNumberMatches,
+  MatchIndexMap& clusterToTrackMap)
+{
+  clusterToTrackMap.clear();
+  clusterToTrackMap.offsets.reserve(clusterEta.size() + 1);
+  const double maxDistance2 = maxMatchingDistance * maxMatchingDistance;
+  std::vector<std::pair<double, int>> candidates;
+  for (std::size_t iCluster = 0; iCluster < clusterEta.size(); iCluster++) {
+    candidates.clear();
+    trackGrid.forEachNeighbourCandidate(clusterEta[iCluster], clusterPhi[iCluster], maxMatchingDistance, [&](int iTrack) {
+      const double dEta = clusterEta[iCluster] - trackEta[iTrack];
+      const double dPhi = clusterPhi[iCluster] - trackPhi[iTrack];
+      const double distance2 = dEta * dEta + dPhi * dPhi;
+      if (distance2 < maxDistance2) {
+        candidates.emplace_back(distance2, iTrack);
+      }
+    });
+    const std::size_t nMatches = std::min<std::size_t>(candidates.size(), maxNumberMatches);
+    std::partial_sort(candidates.begin(), candidates.begin() + nMatches, candidates.end());
+    for (std::size_t m = 0; m < nMatches; m++) {
+      clusterToTrackMap.indices.push_back(candidates[m].second);
+    }
+    clusterToTrackMap.offsets.push_back(clusterToTrackMap.indices.size());
+  }
+}
+
 template <typename T, typename U>
 float deltaR(T const& A, U const& B)
 {
@@ -18,6 +18,7 @@
 
 #pragma link C++ class JetFinder + ;
 #pragma link C++ class JetBkgSubUtils + ;
+#pragma link C++ class RunCounterSummary + ;
 #pragma link C++ namespace jetutilities + ;
 #pragma link C++ namespace fastjetutilities + ;
 #pragma link C++ namespace jettaggingutilities + ;
@@ -0,0 +1,72 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file RunCounterSummary.cxx
+/// \brief Mergeable 64-bit event counters per run and selection stage
+
+#include "RunCounterSummary.h"
+
+#include <TCollection.h>
+
+#include <cstddef>
+
+void RunCounterSummary::Copy(TObject& c) const
+{
+  static_cast<RunCounterSummary&>(c) = *this;
+}
+
+Long64_t RunCounterSummary::Merge(TCollection* list)
+{
+  if (!list) {
+    return 0;
+  }
+  int n = 1;
+  if (list->IsEmpty()) {
+    return n;
+  }
+
+  const std::size_t nStages = mStages.size();
+  for (auto* obj : *list) {
+    auto* entry = dynamic_cast<RunCounterSummary*>(obj);
+    if (!entry || entry->getStages() != mStages) {
+      continue;
+    }
+    n++;
+    const auto& runs = entry->getRuns();
+    const auto& counters = entry->getCounters();
+    for (std::size_t iRun = 0; iRun < runs.size(); iRun++) {
+      const std::size_t offset = runIndex(runs[iRun]) * nStages;
+      for (std::size_t iStage = 0; iStage < nStages; iStage++) {
+        mCounters[offset + iStage] += counters[iRun * nStages + iStage];
+      }
+    }
+  }
+  return n;
+}
+
+ULong64_t RunCounterSummary::get(int runNumber, int stage) const
+{
+  for (std::size_t i = 0; i < mRuns.size(); i++) {
+    if (mRuns[i] == runNumber) {
+      return mCounters[i * mStages.size() + stage];
+    }
+  }
+  return 0ull;
+}
+
+ULong64_t RunCounterSummary::getTotal(int stage) const
+{
+  ULong64_t total = 0ull;
+  for (std::size_t i = 0; i < mRuns.size(); i++) {
+    total += mCounters[i * mStages.size() + stage];
+  }
+  return total;
+}
@@ -0,0 +1,90 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file RunCounterSummary.h
+/// \brief Mergeable 64-bit event counters per run and selection stage
+///
+/// The counters of all the runs are stored in one contiguous array, the counters of the i-th run
+/// in [i * nStages, (i + 1) * nStages). Contrary to the bins of a histogram, the counts are exact
+/// integers at any size, and merging the outputs of the subjobs only adds arrays of integers.
+
+#ifndef PWGJE_CORE_RUNCOUNTERSUMMARY_H_
+#define PWGJE_CORE_RUNCOUNTERSUMMARY_H_
+
+#include <TNamed.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class RunCounterSummary : public TNamed
+{
+ public:
+  RunCounterSummary() = default;
+  RunCounterSummary(const char* name, const char* objTitle) : TNamed(name, objTitle) {}
+  virtual ~RunCounterSummary() = default; // NOLINT: Making this override breaks compilation, as in ZorroSummary
+  virtual void Copy(TObject& c) const;   // NOLINT: Making this override breaks compilation, as in ZorroSummary
+  virtual Long64_t Merge(TCollection* list);
+
+  /// Names of the selection stages; resets all the counters
+  void setStages(const std::vector<std::string>& stages)
+  {
+    mStages = stages;
+    mRuns.clear();
+    mCounters.clear();
+    mCurrentRunIndex = -1;
+  }
+
+  /// Add n to the counter of the given run and stage
+  void add(int runNumber, int stage, ULong64_t n = 1)
+  {
+    mCounters[runIndex(runNumber) * mStages.size() + stage] += n;
+  }
+
+  /// Counter of the given run and stage; 0 for a run that was not seen
+  ULong64_t get(int runNumber, int stage) const;
+  /// Counter of the given stage summed over the runs
+  ULong64_t getTotal(int stage) const;
+
+  std::size_t getNstages() const { return mStages.size(); }
+  const auto& getStages() const { return mStages; }
+  const auto& getRuns() const { return mRuns; }
+  const auto& getCounters() const { return mCounters; }
+
+ private:
+  /// Position of the run in mRuns, adding it if needed
+  std::size_t runIndex(int runNumber)
+  {
+    if (mCurrentRunIndex >= 0 && mRuns[mCurrentRunIndex] == runNumber) {
+      return mCurrentRunIndex;
+    }
+    for (std::size_t i = 0; i < mRuns.size(); i++) {
+      if (mRuns[i] == runNumber) {
+        mCurrentRunIndex = i;
+        return i;
+      }
+    }
+    mRuns.push_back(runNumber);
+    mCounters.resize(mRuns.size() * mStages.size(), 0ull);
+    mCurrentRunIndex = mRuns.size() - 1;
+    return mCurrentRunIndex;
+  }
+
+  int mCurrentRunIndex = -1; //! Position of the last run accessed
+
+  std::vector<std::string> mStages;
+  std::vector<int> mRuns;
+  std::vector<ULong64_t> mCounters;
+
+  ClassDef(RunCounterSummary, 1);
+};
+
+#endif // PWGJE_CORE_RUNCOUNTERSUMMARY_H_
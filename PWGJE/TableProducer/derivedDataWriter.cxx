@@ -53,6 +53,8 @@ struct JetDerivedDataWriter {
     Configurable<bool> performTrackSelection{"performTrackSelection", true, "only save tracks that pass one of the track selections"};
     Configurable<float> trackPtSelectionMin{"trackPtSelectionMin", 0.15, "only save tracks that have a pT larger than this pT"};
     Configurable<float> trackEtaSelectionMax{"trackEtaSelectionMax", 0.9, "only save tracks that have an eta smaller than this eta"};
+    Configurable<int> precisionPositionBits{"precisionPositionBits", 13, "number of mantissa bits kept for the stored positions, angles and DCAs (23 = no truncation)"};
+    Configurable<int> precisionMomentumBits{"precisionMomentumBits", 13, "number of mantissa bits kept for the stored momenta and energies (23 = no truncation)"};
 
     Configurable<std::string> triggerMasks{"triggerMasks", "", "possible JE Trigger masks: fJetChLowPt,fJetChHighPt,fTrackLowPt,fTrackHighPt,fJetD0ChLowPt,fJetD0ChHighPt,fJetLcChLowPt,fJetLcChHighPt,fEMCALReadout,fJetFullHighPt,fJetFullLowPt,fJetNeutralHighPt,fJetNeutralLowPt,fGammaVeryHighPtEMCAL,fGammaVeryHighPtDCAL,fGammaHighPtEMCAL,fGammaHighPtDCAL,fGammaLowPtEMCAL,fGammaLowPtDCAL,fGammaVeryLowPtEMCAL,fGammaVeryLowPtDCAL"};
   } config;
@@ -181,8 +183,9 @@ struct JetDerivedDataWriter {
 
   void init(InitContext&)
   {
-    precisionPositionMask = 0xFFFFFC00; // 13 bits
-    precisionMomentumMask = 0xFFFFFC00; // 13 bits  this is currently keept at 13 bits wihich gives roughly a resolution of 1/8000. This can be increased to 15 bits if really needed
+    // the default of 13 bits gives roughly a resolution of 1/8000. This can be increased to 15 bits if really needed
+    precisionPositionMask = 0xFFFFFFFF << (23 - std::clamp(config.precisionPositionBits.value, 0, 23));
+    precisionMomentumMask = 0xFFFFFFFF << (23 - std::clamp(config.precisionMomentumBits.value, 0, 23));
   }
 
   template <typename T>
@@ -277,17 +280,15 @@ struct JetDerivedDataWriter {
 
   void processBCs(soa::Join<aod::JCollisions, aod::JCollisionBCs, aod::JCollisionSelections> const& collisions, soa::Join<aod::JBCs, aod::JBCPIs> const& bcs)
   {
-    std::vector<int32_t> bcIndicies;
     bcMapping.clear();
     bcMapping.resize(bcs.size(), -1);
 
     for (auto const& collision : collisions) {
       if (collision.isCollisionSelected()) {
         auto bc = collision.bc_as<soa::Join<aod::JBCs, aod::JBCPIs>>();
-        if (std::find(bcIndicies.begin(), bcIndicies.end(), bc.globalIndex()) == bcIndicies.end()) {
+        if (bcMapping[bc.globalIndex()] < 0) { // BC not stored yet
           products.storedJBCsTable(bc.runNumber(), bc.globalBC(), bc.timestamp(), bc.alias_raw(), bc.selection_raw());
           products.storedJBCParentIndexTable(bc.bcId());
-          bcIndicies.push_back(bc.globalIndex());
           bcMapping[bc.globalIndex()] = products.storedJBCsTable.lastIndex();
         }
       }
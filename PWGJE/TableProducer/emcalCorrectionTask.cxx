@@ -53,9 +53,11 @@
 
 #include <GPUROOTCartesianFwd.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <future>
 #include <memory>
 #include <random>
 #include <sstream>
@@ -112,6 +114,7 @@ struct EmcalCorrectionTask {
   Configurable<bool> applyCellTimeCorrection{"applyCellTimeCorrection", true, "apply a correction to the cell time for data and MC: Shift both average cell times to 0 and smear MC time distribution to fit data better. For MC requires isMC to be true"};
   Configurable<float> trackMinPt{"trackMinPt", 0.3, "Minimum pT for tracks to perform track matching, to reduce computing time. Tracks below a certain pT will be loopers anyway."};
   Configurable<bool> fillQA{"fillQA", false, "Switch to turn on QA histograms."};
+  Configurable<int> nClusterizerThreads{"nClusterizerThreads", 1, "Number of threads running the clusterizers in processFull. The clusters are written in BC order, hence the output does not depend on it (1 = serial)"};
 
   // Require EMCAL cells (CALO type 1)
   Filter emccellfilter = aod::calo::caloType == selectedCellType;
@@ -129,6 +132,35 @@ struct EmcalCorrectionTask {
   std::vector<o2::emcal::AnalysisCluster> mAnalysisClusters;
   std::vector<o2::emcal::ClusterLabel> mClusterLabels;
 
+  // Parallel clusterisation: each thread owns a copy of the clusterizers and of the cluster factory.
+  // The cells of all the BCs of the DF are converted first, then the BCs are clusterised in parallel
+  // and finally the tables are filled serially in BC order. All the buffers are reused across DFs.
+  struct ClusterizerWorker {
+    std::vector<std::unique_ptr<o2::emcal::Clusterizer<o2::emcal::Cell>>> clusterizers;
+    o2::emcal::ClusterFactory<o2::emcal::Cell> clusterFactory;
+    std::vector<o2::emcal::ClusterLabel> clusterLabels;
+  };
+  struct BCCells {
+    int64_t bcIndex;
+    size_t firstCell;
+    size_t nCells;
+  };
+  std::vector<std::unique_ptr<ClusterizerWorker>> mClusterizerWorkers;
+  std::vector<o2::emcal::Cell> mCellsDF;                            // converted cells of all the BCs with cells, in BC order
+  std::vector<int64_t> mCellIndicesDF;                              // global index of these cells
+  std::vector<BCCells> mBCCellsDF;                                  // range of the cells of each BC in mCellsDF
+  std::vector<std::vector<o2::emcal::AnalysisCluster>> mClustersDF; // clusters of each BC and clusterizer (BC-major)
+
+  // Track matching: tracks of the current collision at the EMCal surface and their eta-phi grid, reused for all the clusterizers
+  int64_t mTrackInfoCollisionId = -1;
+  std::vector<double> mTrackPhi;
+  std::vector<double> mTrackEta;
+  std::vector<int64_t> mTrackGlobalIndex;
+  jetutilities::EtaPhiGrid<double> mTrackGrid;
+  std::vector<double> mClusterPhi;
+  std::vector<double> mClusterEta;
+  jetutilities::MatchIndexMap mClusterToTrackMap;
+
   std::vector<o2::aod::EMCALClusterDefinition> mClusterDefinitions;
   // QA
   o2::framework::HistogramRegistry mHistManager{"EMCALCorrectionTaskQAHistograms"};
@@ -177,15 +209,9 @@ struct EmcalCorrectionTask {
         mClusterDefinitions.push_back(clusDef);
       }
     }
-    mClusterFactories.setGeometry(geometry);
-    mClusterFactories.SetECALogWeight(logWeight);
-    mClusterFactories.setExoticCellFraction(exoticCellFraction);
-    mClusterFactories.setExoticCellDiffTime(exoticCellDiffTime);
-    mClusterFactories.setExoticCellMinAmplitude(exoticCellMinAmplitude);
-    mClusterFactories.setExoticCellInCrossMinAmplitude(exoticCellInCrossMinAmplitude);
-    mClusterFactories.setUseWeightExotic(useWeightExotic);
+    setupClusterFactory(mClusterFactories);
     for (const auto& clusterDefinition : mClusterDefinitions) {
-      mClusterizers.emplace_back(std::make_unique<o2::emcal::Clusterizer<o2::emcal::Cell>>(clusterDefinition.timeDiff, clusterDefinition.timeMin, clusterDefinition.timeMax, clusterDefinition.gradientCut, clusterDefinition.doGradientCut, clusterDefinition.seedEnergy, clusterDefinition.minCellEnergy));
+      mClusterizers.emplace_back(makeClusterizer(clusterDefinition));
       LOG(info) << "Cluster definition initialized: " << clusterDefinition.toString();
       LOG(info) << "timeMin: " << clusterDefinition.timeMin;
       LOG(info) << "timeMax: " << clusterDefinition.timeMax;
@@ -203,6 +229,18 @@ struct EmcalCorrectionTask {
       LOG(error) << "No cluster definitions specified!";
     }
 
+    if (nClusterizerThreads > 1) {
+      for (int iThread = 0; iThread < nClusterizerThreads; iThread++) {
+        auto& worker = mClusterizerWorkers.emplace_back(std::make_unique<ClusterizerWorker>());
+        setupClusterFactory(worker->clusterFactory);
+        for (const auto& clusterDefinition : mClusterDefinitions) {
+          worker->clusterizers.emplace_back(makeClusterizer(clusterDefinition));
+          worker->clusterizers.back()->setGeometry(geometry);
+        }
+      }
+      LOG(info) << "Running the clusterizers of processFull with " << nClusterizerThreads.value << " threads";
+    }
+
     mNonlinearityHandler = o2::emcal::NonlinearityFactory::getInstance().getNonlinearity(static_cast<std::string>(nonlinearityFunction));
     LOG(info) << "Using nonlinearity parameterisation: " << nonlinearityFunction.value;
     LOG(info) << "Apply shaper saturation correction:  " << (hasShaperCorrection.value ? "yes" : "no");
@@ -300,6 +338,7 @@ struct EmcalCorrectionTask {
   void processFull(BcEvSels const& bcs, CollEventSels const& collisions, MyGlobTracks const& tracks, FilteredCells const& cells)
   {
     LOG(debug) << "Starting process full.";
+    mTrackInfoCollisionId = -1;
 
     int previousCollisionId = 0; // Collision ID of the last unique BC. Needed to skip unordered collisions to ensure ordered collisionIds in the cluster table
     int nBCsProcessed = 0;
@@ -329,8 +368,7 @@ struct EmcalCorrectionTask {
       }
       // Counters for BCs with matched collisions
       countBC(collisionsInFoundBC.size(), true);
-      std::vector<o2::emcal::Cell> cellsBC;
-      std::vector<int64_t> cellIndicesBC;
+      mBCCellsDF.push_back({bc.globalIndex(), mCellsDF.size(), 0});
       for (const auto& cell : cellsInBC) {
         auto amplitude = cell.amplitude();
         if (static_cast<bool>(hasShaperCorrection) && emcal::intToChannelType(cell.cellType()) == emcal::ChannelType_t::LOW_GAIN) { // Apply shaper correction to LG cells
@@ -339,29 +377,38 @@ struct EmcalCorrectionTask {
         if (applyCellAbsScale) {
           amplitude *= getAbsCellScale(cell.cellNumber());
         }
-        cellsBC.emplace_back(cell.cellNumber(),
-                             amplitude,
-                             cell.time() + getCellTimeShift(cell.cellNumber(), amplitude, o2::emcal::intToChannelType(cell.cellType()), runNumber),
-                             o2::emcal::intToChannelType(cell.cellType()));
-        cellIndicesBC.emplace_back(cell.globalIndex());
+        mCellsDF.emplace_back(cell.cellNumber(),
+                              amplitude,
+                              cell.time() + getCellTimeShift(cell.cellNumber(), amplitude, o2::emcal::intToChannelType(cell.cellType()), runNumber),
+                              o2::emcal::intToChannelType(cell.cellType()));
+        mCellIndicesDF.emplace_back(cell.globalIndex());
       }
-      LOG(detail) << "Number of cells for BC (CF): " << cellsBC.size();
-      nCellsProcessed += cellsBC.size();
-
-      fillQAHistogram(cellsBC);
+      auto& bcCells = mBCCellsDF.back();
+      bcCells.nCells = mCellsDF.size() - bcCells.firstCell;
+      LOG(detail) << "Number of cells for BC (CF): " << bcCells.nCells;
+      nCellsProcessed += bcCells.nCells;
 
-      // TODO: Helpful for now, but should be removed.
-      LOG(debug) << "Converted EMCAL cells";
-      for (const auto& cell : cellsBC) {
-        LOG(debug) << cell.getTower() << ": E: " << cell.getEnergy() << ", time: " << cell.getTimeStamp() << ", type: " << cell.getType();
-      }
+      fillQAHistogram(getCellsOfBC(bcCells));
+      LOG(debug) << "Converted cells. Contains: " << bcCells.nCells << ". Originally " << cellsInBC.size() << ".";
+    } // end of bc loop
 
-      LOG(debug) << "Converted cells. Contains: " << cellsBC.size() << ". Originally " << cellsInBC.size() << ". About to run clusterizer.";
-      //  this is a test
-      //  Run the clusterizers
+    // Run the clusterizers, in parallel if requested
+    if (!mClusterizerWorkers.empty()) {
+      runClusterizerWorkers();
+    }
+    for (size_t iBC = 0; iBC < mBCCellsDF.size(); iBC++) {
+      auto const& bcCells = mBCCellsDF[iBC];
+      auto bc = bcs.rawIteratorAt(bcCells.bcIndex);
+      auto collisionsInFoundBC = collisions.sliceBy(collisionsPerFoundBC, bc.globalIndex());
+      auto cellIndicesBC = gsl::span<int64_t>(mCellIndicesDF.data() + bcCells.firstCell, bcCells.nCells);
       LOG(debug) << "Running clusterizers";
       for (size_t iClusterizer = 0; iClusterizer < mClusterizers.size(); iClusterizer++) {
-        cellsToCluster(iClusterizer, cellsBC);
+        if (mClusterizerWorkers.empty()) {
+          cellsToCluster(iClusterizer, getCellsOfBC(bcCells));
+        } else {
+          mAnalysisClusters.swap(mClustersDF[iBC * mClusterizers.size() + iClusterizer]);
+          mClusterLabels.clear();
+        }
 
         if (collisionsInFoundBC.size() == 1) {
           // dummy loop to get the first collision
@@ -378,15 +425,11 @@ struct EmcalCorrectionTask {
               mHistManager.fill(HIST("hCollisionType"), 1);
               math_utils::Point3D<float> vertexPos = {col.posX(), col.posY(), col.posZ()};
 
-              std::vector<std::vector<int>> clusterToTrackIndexMap;
-              std::vector<std::vector<int>> trackToClusterIndexMap;
-              std::tuple<std::vector<std::vector<int>>, std::vector<std::vector<int>>> indexMapPair{clusterToTrackIndexMap, trackToClusterIndexMap};
-              std::vector<int64_t> trackGlobalIndex;
-              doTrackMatching<CollEventSels::filtered_iterator>(col, tracks, indexMapPair, vertexPos, trackGlobalIndex);
+              doTrackMatching<CollEventSels::filtered_iterator>(col, tracks, vertexPos);
 
               // Store the clusters in the table where a matching collision could
               // be identified.
-              fillClusterTable<CollEventSels::filtered_iterator>(col, vertexPos, iClusterizer, cellIndicesBC, &indexMapPair, &trackGlobalIndex);
+              fillClusterTable<CollEventSels::filtered_iterator>(col, vertexPos, iClusterizer, cellIndicesBC, &mClusterToTrackMap, &mTrackGlobalIndex);
             } else {
               mHistManager.fill(HIST("hBCMatchErrors"), 2);
             }
@@ -408,7 +451,10 @@ struct EmcalCorrectionTask {
       } // end of clusterizer loop
       LOG(debug) << "Done with process BC.";
       nBCsProcessed++;
-    } // end of bc loop
+    } // end of loop over BCs with cells
+    mCellsDF.clear();
+    mCellIndicesDF.clear();
+    mBCCellsDF.clear();
 
     // Loop through all collisions and fill emcalcollisionmatch with a boolean stating, whether the collision was ambiguous (not the only collision in its BC)
     for (const auto& collision : collisions) {
@@ -429,6 +475,7 @@ struct EmcalCorrectionTask {
   void processMCFull(BcEvSels const& bcs, CollEventSels const& collisions, MyGlobTracks const& tracks, FilteredMcCells const& cells, aod::StoredMcParticles_001 const&)
   {
     LOG(debug) << "Starting process full.";
+    mTrackInfoCollisionId = -1;
 
     int previousCollisionId = 0; // Collision ID of the last unique BC. Needed to skip unordered collisions to ensure ordered collisionIds in the cluster table
     int nBCsProcessed = 0;
@@ -509,15 +556,11 @@ struct EmcalCorrectionTask {
               mHistManager.fill(HIST("hCollisionType"), 1);
               math_utils::Point3D<float> vertexPos = {col.posX(), col.posY(), col.posZ()};
 
-              std::vector<std::vector<int>> clusterToTrackIndexMap;
-              std::vector<std::vector<int>> trackToClusterIndexMap;
-              std::tuple<std::vector<std::vector<int>>, std::vector<std::vector<int>>> indexMapPair{clusterToTrackIndexMap, trackToClusterIndexMap};
-              std::vector<int64_t> trackGlobalIndex;
-              doTrackMatching<CollEventSels::filtered_iterator>(col, tracks, indexMapPair, vertexPos, trackGlobalIndex);
+              doTrackMatching<CollEventSels::filtered_iterator>(col, tracks, vertexPos);
 
               // Store the clusters in the table where a matching collision could
               // be identified.
-              fillClusterTable<CollEventSels::filtered_iterator>(col, vertexPos, iClusterizer, cellIndicesBC, &indexMapPair, &trackGlobalIndex);
+              fillClusterTable<CollEventSels::filtered_iterator>(col, vertexPos, iClusterizer, cellIndicesBC, &mClusterToTrackMap, &mTrackGlobalIndex);
             } else {
               mHistManager.fill(HIST("hBCMatchErrors"), 2);
             }
@@ -650,35 +693,83 @@ struct EmcalCorrectionTask {
   }
   PROCESS_SWITCH(EmcalCorrectionTask, processStandalone, "run stand alone analysis", false);
 
+  std::unique_ptr<o2::emcal::Clusterizer<o2::emcal::Cell>> makeClusterizer(o2::aod::EMCALClusterDefinition const& clusterDefinition) const
+  {
+    return std::make_unique<o2::emcal::Clusterizer<o2::emcal::Cell>>(clusterDefinition.timeDiff, clusterDefinition.timeMin, clusterDefinition.timeMax, clusterDefinition.gradientCut, clusterDefinition.doGradientCut, clusterDefinition.seedEnergy, clusterDefinition.minCellEnergy);
+  }
+
+  void setupClusterFactory(o2::emcal::ClusterFactory<o2::emcal::Cell>& clusterFactory)
+  {
+    clusterFactory.setGeometry(geometry);
+    clusterFactory.SetECALogWeight(logWeight);
+    clusterFactory.setExoticCellFraction(exoticCellFraction);
+    clusterFactory.setExoticCellDiffTime(exoticCellDiffTime);
+    clusterFactory.setExoticCellMinAmplitude(exoticCellMinAmplitude);
+    clusterFactory.setExoticCellInCrossMinAmplitude(exoticCellInCrossMinAmplitude);
+    clusterFactory.setUseWeightExotic(useWeightExotic);
+  }
+
+  gsl::span<o2::emcal::Cell> getCellsOfBC(BCCells const& bcCells)
+  {
+    return gsl::span<o2::emcal::Cell>(mCellsDF.data() + bcCells.firstCell, bcCells.nCells);
+  }
+
+  /// Clusterise all the BCs stored in mBCCellsDF, each thread taking every nThreads-th BC
+  void runClusterizerWorkers()
+  {
+    const size_t nClusterizers = mClusterizers.size();
+    mClustersDF.resize(mBCCellsDF.size() * nClusterizers);
+    const int nWorkers = std::min<int>(mClusterizerWorkers.size(), mBCCellsDF.size());
+    std::vector<std::future<void>> results;
+    for (int iWorker = 0; iWorker < nWorkers; iWorker++) {
+      results.push_back(std::async(std::launch::async, [this, iWorker, nWorkers, nClusterizers]() {
+        auto& worker = *mClusterizerWorkers[iWorker];
+        for (size_t iBC = iWorker; iBC < mBCCellsDF.size(); iBC += nWorkers) {
+          for (size_t iClusterizer = 0; iClusterizer < nClusterizers; iClusterizer++) {
+            buildAnalysisClusters(*worker.clusterizers[iClusterizer], worker.clusterFactory, getCellsOfBC(mBCCellsDF[iBC]), mClustersDF[iBC * nClusterizers + iClusterizer], worker.clusterLabels);
+          }
+        }
+      }));
+    }
+    for (auto& result : results) {
+      result.get();
+    }
+  }
+
   void cellsToCluster(size_t iClusterizer, const gsl::span<o2::emcal::Cell> cellsBC, gsl::span<const o2::emcal::CellLabel> cellLabels = {})
   {
-    mClusterizers.at(iClusterizer)->findClusters(cellsBC);
+    buildAnalysisClusters(*mClusterizers.at(iClusterizer), mClusterFactories, cellsBC, mAnalysisClusters, mClusterLabels, cellLabels);
+  }
 
-    auto emcalClusters = mClusterizers.at(iClusterizer)->getFoundClusters();
-    auto emcalClustersInputIndices = mClusterizers.at(iClusterizer)->getFoundClustersInputIndices();
+  static void buildAnalysisClusters(o2::emcal::Clusterizer<o2::emcal::Cell>& clusterizer, o2::emcal::ClusterFactory<o2::emcal::Cell>& clusterFactory, const gsl::span<o2::emcal::Cell> cellsBC, std::vector<o2::emcal::AnalysisCluster>& analysisClusters, std::vector<o2::emcal::ClusterLabel>& clusterLabels, gsl::span<const o2::emcal::CellLabel> cellLabels = {})
+  {
+    clusterizer.findClusters(cellsBC);
+
+    auto emcalClusters = clusterizer.getFoundClusters();
+    auto emcalClustersInputIndices = clusterizer.getFoundClustersInputIndices();
     LOG(debug) << "Retrieved results. About to setup cluster factory.";
 
     // Convert to analysis clusters.
     // First, the cluster factory requires cluster and cell information in order
     // to build the clusters.
-    mAnalysisClusters.clear();
-    mClusterLabels.clear();
-    mClusterFactories.reset();
+    analysisClusters.clear();
+    clusterLabels.clear();
+    clusterFactory.reset();
     // in preparation for future O2 changes
-    // mClusterFactories.setClusterizerSettings(mClusterDefinitions.at(iClusterizer).minCellEnergy, mClusterDefinitions.at(iClusterizer).timeMin, mClusterDefinitions.at(iClusterizer).timeMax, mClusterDefinitions.at(iClusterizer).recalcShowerShape5x5);
+    // clusterFactory.setClusterizerSettings(mClusterDefinitions.at(iClusterizer).minCellEnergy, mClusterDefinitions.at(iClusterizer).timeMin, mClusterDefinitions.at(iClusterizer).timeMax, mClusterDefinitions.at(iClusterizer).recalcShowerShape5x5);
     if (cellLabels.empty()) {
-      mClusterFactories.setContainer(*emcalClusters, cellsBC, *emcalClustersInputIndices);
+      clusterFactory.setContainer(*emcalClusters, cellsBC, *emcalClustersInputIndices);
     } else {
-      mClusterFactories.setContainer(*emcalClusters, cellsBC, *emcalClustersInputIndices, cellLabels);
+      clusterFactory.setContainer(*emcalClusters, cellsBC, *emcalClustersInputIndices, cellLabels);
     }
 
     LOG(debug) << "Cluster factory set up.";
     // Convert to analysis clusters.
-    for (int icl = 0; icl < mClusterFactories.getNumberOfClusters(); icl++) {
+    for (int icl = 0; icl < clusterFactory.getNumberOfClusters(); icl++) {
       o2::emcal::ClusterLabel clusterLabel;
-      auto analysisCluster = mClusterFactories.buildCluster(icl, &clusterLabel);
-      mAnalysisClusters.emplace_back(analysisCluster);
-      mClusterLabels.push_back(clusterLabel);
+      auto analysisCluster = clusterFactory.buildCluster(icl, &clusterLabel);
+      analysisClusters.emplace_back(analysisCluster);
+      clusterLabels.push_back(clusterLabel);
       LOG(debug) << "Cluster " << icl << ": E: " << analysisCluster.E()
                  << ", NCells " << analysisCluster.getNCells();
     }
@@ -686,7 +777,7 @@ struct EmcalCorrectionTask {
   }
 
   template <typename Collision>
-  void fillClusterTable(Collision const& col, math_utils::Point3D<float> const& vertexPos, size_t iClusterizer, const gsl::span<int64_t> cellIndicesBC, const std::tuple<std::vector<std::vector<int>>, std::vector<std::vector<int>>>* indexMapPair = nullptr, const std::vector<int64_t>* trackGlobalIndex = nullptr)
+  void fillClusterTable(Collision const& col, math_utils::Point3D<float> const& vertexPos, size_t iClusterizer, const gsl::span<int64_t> cellIndicesBC, const jetutilities::MatchIndexMap* clusterToTrackMap = nullptr, const std::vector<int64_t>* trackGlobalIndex = nullptr)
   {
     // average number of cells per cluster, only used the reseve a reasonable amount for the clustercells table
     const size_t NAvgNcells = 3;
@@ -752,12 +843,10 @@ struct EmcalCorrectionTask {
         mHistManager.fill(HIST("hClusterFCrossSigmaLongE"), cluster.E(), cluster.getFCross(), cluster.getM02());
         mHistManager.fill(HIST("hClusterFCrossSigmaShortE"), cluster.E(), cluster.getFCross(), cluster.getM20());
       }
-      if (indexMapPair && trackGlobalIndex) {
-        for (unsigned int iTrack = 0; iTrack < std::get<0>(*indexMapPair)[iCluster].size(); iTrack++) {
-          if (std::get<0>(*indexMapPair)[iCluster][iTrack] >= 0) {
-            LOG(debug) << "Found track " << (*trackGlobalIndex)[std::get<0>(*indexMapPair)[iCluster][iTrack]] << " in cluster " << cluster.getID();
-            matchedTracks(clusters.lastIndex(), (*trackGlobalIndex)[std::get<0>(*indexMapPair)[iCluster][iTrack]]);
-          }
+      if (clusterToTrackMap && trackGlobalIndex) {
+        for (int iTrack = 0; iTrack < clusterToTrackMap->nMatches(iCluster); iTrack++) {
+          LOG(debug) << "Found track " << (*trackGlobalIndex)[clusterToTrackMap->match(iCluster, iTrack)] << " in cluster " << cluster.getID();
+          matchedTracks(clusters.lastIndex(), (*trackGlobalIndex)[clusterToTrackMap->match(iCluster, iTrack)]);
         }
       }
       iCluster++;
@@ -819,26 +908,23 @@ struct EmcalCorrectionTask {
   }
 
   template <typename Collision>
-  void doTrackMatching(Collision const& col, MyGlobTracks const& tracks, std::tuple<std::vector<std::vector<int>>, std::vector<std::vector<int>>>& indexMapPair, math_utils::Point3D<float>& vertexPos, std::vector<int64_t>& trackGlobalIndex)
+  void doTrackMatching(Collision const& col, MyGlobTracks const& tracks, math_utils::Point3D<float>& vertexPos)
   {
-    auto groupedTracks = tracks.sliceBy(perCollision, col.globalIndex());
-    int nTracksInCol = groupedTracks.size();
-    std::vector<double> trackPhi;
-    std::vector<double> trackEta;
-    // reserve memory to reduce on the fly memory allocation
-    trackPhi.reserve(nTracksInCol);
-    trackEta.reserve(nTracksInCol);
-    trackGlobalIndex.reserve(nTracksInCol);
-    fillTrackInfo<decltype(groupedTracks)>(groupedTracks, trackPhi, trackEta, trackGlobalIndex);
-
-    int nClusterInCol = mAnalysisClusters.size();
-    std::vector<double> clusterPhi;
-    std::vector<double> clusterEta;
-    clusterPhi.reserve(nClusterInCol);
-    clusterEta.reserve(nClusterInCol);
-
-    // TODO one loop that could in principle be combined with the other
-    // loop to improve performance
+    // the tracks and their grid are the same for all the clusterizers, hence they are only collected for a new collision
+    if (col.globalIndex() != mTrackInfoCollisionId) {
+      mTrackInfoCollisionId = col.globalIndex();
+      auto groupedTracks = tracks.sliceBy(perCollision, col.globalIndex());
+      mTrackPhi.clear();
+      mTrackEta.clear();
+      mTrackGlobalIndex.clear();
+      fillTrackInfo<decltype(groupedTracks)>(groupedTracks, mTrackPhi, mTrackEta, mTrackGlobalIndex);
+      mTrackGrid.build(mTrackEta, mTrackPhi, std::max(static_cast<double>(maxMatchingDistance), 0.01));
+    } else {
+      fillTrackInfoQA(mTrackPhi, mTrackEta);
+    }
+
+    mClusterPhi.clear();
+    mClusterEta.clear();
     for (const auto& cluster : mAnalysisClusters) {
       // Determine the cluster eta, phi, correcting for the vertex
       // position.
@@ -846,19 +932,17 @@ struct EmcalCorrectionTask {
       pos = pos - vertexPos;
       // Normalize the vector and rescale by energy.
       pos *= (cluster.E() / std::sqrt(pos.Mag2()));
-      clusterPhi.emplace_back(TVector2::Phi_0_2pi(pos.Phi()));
-      clusterEta.emplace_back(pos.Eta());
+      mClusterPhi.emplace_back(TVector2::Phi_0_2pi(pos.Phi()));
+      mClusterEta.emplace_back(pos.Eta());
     }
-    indexMapPair =
-      jetutilities::MatchClustersAndTracks(clusterPhi, clusterEta,
-                                           trackPhi, trackEta,
-                                           maxMatchingDistance, 20);
+    jetutilities::MatchClustersAndTracks(mTrackGrid, mClusterPhi, mClusterEta,
+                                         mTrackPhi, mTrackEta,
+                                         maxMatchingDistance, 20, mClusterToTrackMap);
   }
 
   template <typename Tracks>
   void fillTrackInfo(Tracks const& tracks, std::vector<double>& trackPhi, std::vector<double>& trackEta, std::vector<int64_t>& trackGlobalIndex)
   {
-    int nTrack = 0;
     for (const auto& track : tracks) {
       // TODO only consider tracks in current emcal/dcal acceptanc
       if (!track.isGlobalTrack()) { // only global tracks
@@ -872,14 +956,19 @@ struct EmcalCorrectionTask {
       if (trackMinPt > 0 && track.pt() < trackMinPt) {
         continue;
       }
-      nTrack++;
       trackPhi.emplace_back(TVector2::Phi_0_2pi(track.trackPhiEmcal()));
       trackEta.emplace_back(track.trackEtaEmcal());
-      mHistManager.fill(HIST("hGlobalTrackEtaPhi"), track.trackEtaEmcal(),
-                        TVector2::Phi_0_2pi(track.trackPhiEmcal()));
       trackGlobalIndex.emplace_back(track.globalIndex());
     }
-    mHistManager.fill(HIST("hGlobalTrackMult"), nTrack);
+    fillTrackInfoQA(trackPhi, trackEta);
+  }
+
+  void fillTrackInfoQA(std::vector<double> const& trackPhi, std::vector<double> const& trackEta)
+  {
+    for (size_t iTrack = 0; iTrack < trackEta.size(); iTrack++) {
+      mHistManager.fill(HIST("hGlobalTrackEtaPhi"), trackEta[iTrack], trackPhi[iTrack]);
+    }
+    mHistManager.fill(HIST("hGlobalTrackMult"), trackEta.size());
   }
 
   void countBC(int numberOfCollisions, bool hasEMCCells)
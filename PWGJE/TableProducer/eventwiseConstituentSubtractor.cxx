@@ -68,6 +68,7 @@ struct eventWiseConstituentSubtractorTask {
   Configurable<float> rMax{"rMax", 0.24, "maximum distance of subtraction"};
   Configurable<float> eventEtaMax{"eventEtaMax", 0.9, "maximum pseudorapidity of event"};
   Configurable<bool> doRhoMassSub{"doRhoMassSub", true, "perfom mass subtraction as well"};
+  Configurable<bool> useGridSubtraction{"useGridSubtraction", false, "pair the particles and the ghosts closer than rMax on the ghost grid instead of using the FastJet contrib subtractor"};
 
   JetBkgSubUtils eventWiseConstituentSubtractor;
   float bkgPhiMax_;
@@ -89,6 +90,14 @@ struct eventWiseConstituentSubtractorTask {
     eventWiseConstituentSubtractor.setMaxEtaEvent(eventEtaMax);
   }
 
+  std::vector<fastjet::PseudoJet> subtractEvent(double rho, double rhoM)
+  {
+    if (useGridSubtraction) {
+      return eventWiseConstituentSubtractor.doEventConstSubGrid(inputParticles, rho, rhoM);
+    }
+    return eventWiseConstituentSubtractor.JetBkgSubUtils::doEventConstSub(inputParticles, rho, rhoM);
+  }
+
   Filter trackCuts = (aod::jtrack::pt >= trackPtMin && aod::jtrack::pt < trackPtMax && aod::jtrack::eta > trackEtaMin && aod::jtrack::eta < trackEtaMax && aod::jtrack::phi >= trackPhiMin && aod::jtrack::phi <= trackPhiMax);
   Filter partCuts = (aod::jmcparticle::pt >= trackPtMin && aod::jmcparticle::pt < trackPtMax && aod::jmcparticle::eta >= trackEtaMin && aod::jmcparticle::eta <= trackEtaMax && aod::jmcparticle::phi >= trackPhiMin && aod::jmcparticle::phi <= trackPhiMax);
 
@@ -100,7 +109,7 @@ struct eventWiseConstituentSubtractorTask {
       tracksSubtracted.clear();
       jetfindingutilities::analyseTracks(inputParticles, tracks, trackSelection, trackingEfficiency, &candidate);
 
-      tracksSubtracted = eventWiseConstituentSubtractor.JetBkgSubUtils::doEventConstSub(inputParticles, candidate.rho(), candidate.rhoM());
+      tracksSubtracted = subtractEvent(candidate.rho(), candidate.rhoM());
       for (auto const& trackSubtracted : tracksSubtracted) {
         trackSubTable(candidate.globalIndex(), trackSubtracted.pt(), trackSubtracted.eta(), trackSubtracted.phi(), jetderiveddatautilities::setSingleTrackSelectionBit(trackSelection));
       }
@@ -115,7 +124,7 @@ struct eventWiseConstituentSubtractorTask {
       tracksSubtracted.clear();
       jetfindingutilities::analyseParticles<true>(inputParticles, particleSelection, 1, particles, pdgDatabase, &candidate); // currently only works for charged analyses
 
-      tracksSubtracted = eventWiseConstituentSubtractor.JetBkgSubUtils::doEventConstSub(inputParticles, candidate.rho(), candidate.rhoM());
+      tracksSubtracted = subtractEvent(candidate.rho(), candidate.rhoM());
       for (auto const& trackSubtracted : tracksSubtracted) {
         particleSubTable(candidate.globalIndex(), trackSubtracted.pt(), trackSubtracted.eta(), trackSubtracted.phi(), trackSubtracted.rap(), trackSubtracted.e(), 211, 1, 1, 1); // everything after phi is artificial and should not be used for analyses
       }
@@ -131,7 +140,7 @@ struct eventWiseConstituentSubtractorTask {
     tracksSubtracted.clear();
     jetfindingutilities::analyseTracks<soa::Filtered<aod::JetTracks>, soa::Filtered<aod::JetTracks>::iterator>(inputParticles, tracks, trackSelection, trackingEfficiency);
 
-    tracksSubtracted = eventWiseConstituentSubtractor.JetBkgSubUtils::doEventConstSub(inputParticles, collision.rho(), collision.rhoM());
+    tracksSubtracted = subtractEvent(collision.rho(), collision.rhoM());
 
     for (auto const& trackSubtracted : tracksSubtracted) {
       trackSubtractedTable(collision.globalIndex(), trackSubtracted.pt(), trackSubtracted.eta(), trackSubtracted.phi(), jetderiveddatautilities::setSingleTrackSelectionBit(trackSelection));
@@ -148,7 +157,7 @@ struct eventWiseConstituentSubtractorTask {
     tracksSubtracted.clear();
     jetfindingutilities::analyseParticles<true, soa::Filtered<aod::JetParticles>, soa::Filtered<aod::JetParticles>::iterator>(inputParticles, particleSelection, 1, particles, pdgDatabase);
 
-    tracksSubtracted = eventWiseConstituentSubtractor.JetBkgSubUtils::doEventConstSub(inputParticles, mcCollision.rho(), mcCollision.rhoM());
+    tracksSubtracted = subtractEvent(mcCollision.rho(), mcCollision.rhoM());
 
     for (auto const& trackSubtracted : tracksSubtracted) {
       particleSubtractedTable(mcCollision.globalIndex(), trackSubtracted.pt(), trackSubtracted.eta(), trackSubtracted.phi(), trackSubtracted.rap(), trackSubtracted.e(), 211, 1, 1, 1); // everything after phi is artificial and should not be used for analyses
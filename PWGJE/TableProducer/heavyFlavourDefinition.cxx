@@ -26,6 +26,7 @@
 #include <Framework/runDataProcessing.h>
 
 #include <cstdint>
+#include <vector>
 
 using namespace o2;
 using namespace o2::framework;
@@ -44,6 +45,8 @@ struct HeavyFlavourDefinitionTask {
   Preslice<aod::JetParticles> particlesPerCollision = aod::jmcparticle::mcCollisionId;
   Preslice<soa::Join<aod::JMcParticles, aod::JMcParticlePIs>> particlesPerMcCollision = aod::jmcparticle::mcCollisionId;
 
+  std::vector<jettaggingutilities::HfFlavourSource> hfFlavourSources; // heavy-flavour quarks or hadrons of the current MC collision
+
   void init(InitContext const&)
   {
   }
@@ -64,16 +67,16 @@ struct HeavyFlavourDefinitionTask {
 
   void processMCDByDistance(soa::Join<aod::JCollisions, aod::JCollisionPIs, aod::JMcCollisionLbs>::iterator const& collision, soa::Join<JetTableMCD, aod::ChargedMCDetectorLevelJetsMatchedToChargedMCParticleLevelJets> const& mcdjets, soa::Join<JetTableMCP, aod::ChargedMCParticleLevelJetsMatchedToChargedMCDetectorLevelJets> const& /*mcpjets*/, aod::JetParticles const& particles) // it used only for charged jets now
   {
+    if (mcdjets.size() == 0) {
+      return;
+    }
+    auto const particlesPerColl = particles.sliceBy(particlesPerCollision, collision.mcCollisionId());
+    jettaggingutilities::fillHfFlavourSources(particlesPerColl, searchUpToQuark, hfFlavourSources);
     for (auto const& mcdjet : mcdjets) {
-      auto const particlesPerColl = particles.sliceBy(particlesPerCollision, collision.mcCollisionId());
       int8_t origin = -1;
       if (mcdjet.has_matchedJetGeo()) {
         for (auto const& mcpjet : mcdjet.template matchedJetGeo_as<soa::Join<JetTableMCP, aod::ChargedMCParticleLevelJetsMatchedToChargedMCDetectorLevelJets>>()) {
-          if (searchUpToQuark) {
-            origin = jettaggingutilities::getJetFlavor(mcpjet, particlesPerColl);
-          } else {
-            origin = jettaggingutilities::getJetFlavorHadron(mcpjet, particlesPerColl);
-          }
+          origin = jettaggingutilities::getJetFlavorFromSources(mcpjet, hfFlavourSources);
         }
       } else {
         origin = JetTaggingSpecies::none;
@@ -94,13 +97,12 @@ struct HeavyFlavourDefinitionTask {
 
   void processMCPByDistance(aod::JetMcCollision const& /*mcCollision*/, JetTableMCP const& mcpjets, aod::JetParticles const& particles)
   {
+    if (mcpjets.size() == 0) {
+      return;
+    }
+    jettaggingutilities::fillHfFlavourSources(particles, searchUpToQuark, hfFlavourSources);
     for (auto const& mcpjet : mcpjets) {
-      int8_t origin = -1;
-      if (searchUpToQuark) {
-        origin = jettaggingutilities::getJetFlavor(mcpjet, particles);
-      } else {
-        origin = jettaggingutilities::getJetFlavorHadron(mcpjet, particles);
-      }
+      int8_t origin = jettaggingutilities::getJetFlavorFromSources(mcpjet, hfFlavourSources);
       flavourTableMCP(origin);
     }
   }
@@ -45,6 +45,8 @@
 
 #include <onnxruntime_cxx_api.h>
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
@@ -111,6 +113,8 @@ struct JetTaggerHFTask {
   Configurable<int> nClassesMl{"nClassesMl", 2, "Number of classes in ML model"};
   Configurable<std::vector<std::string>> namesInputFeatures{"namesInputFeatures", std::vector<std::string>{"feature1", "feature2"}, "Names of ML model input features"};
   Configurable<bool> useDb{"useDb", false, "Flag to use DB for ML model instead of the score"};
+  Configurable<int> mlBatchSize{"mlBatchSize", 1, "Number of jets evaluated in a single call of an ML model with one input node (1 = one call per jet, 0 = all the jets of the DF)"};
+  Configurable<bool> mlTimingQA{"mlTimingQA", false, "Fill histograms of the model inference time and of the number of jets per model call"};
 
   Configurable<std::string> ccdbUrl{"ccdbUrl", "http://alice-ccdb.cern.ch", "url of the ccdb repository"};
   Configurable<std::vector<std::string>> modelPathsCCDB{"modelPathsCCDB", std::vector<std::string>{"Users/h/hahassan"}, "Paths of models on CCDB"};
@@ -173,6 +177,14 @@ struct JetTaggerHFTask {
 
   o2::analysis::GNNBjetAllocator tensorAlloc;
 
+  // inputs of the jets evaluated together by the batched ML inference
+  std::vector<std::vector<float>> batchInputsML;
+  std::vector<float> batchPtsML;
+  std::vector<int> batchJetIndicesML;
+  std::vector<bool> batchSelectedML;
+
+  using InferenceClock = std::chrono::steady_clock;
+
   template <typename T, typename U>
   float calculateJetProbability(int origin, T const& jet, U const& tracks, bool const& isMC = false)
   {
@@ -506,6 +518,11 @@ struct JetTaggerHFTask {
       bMlResponse.init();
     }
 
+    if (mlTimingQA && (doprocessAlgorithmML || doprocessAlgorithmMLnoSV || doprocessAlgorithmGNN)) {
+      registry.add("h_ml_inference_time", "model inference time per jet;#it{t} (#mus)", {HistType::kTH1F, {{500, 0., 500.}}});
+      registry.add("h_ml_jets_per_call", "number of jets per model call;#it{N}_{jets}", {HistType::kTH1F, {{200, 0., 2000.}}});
+    }
+
     if (doprocessAlgorithmGNN) {
       tensorAlloc = o2::analysis::GNNBjetAllocator(nJetFeat.value, nTrkFeat.value, nClassesMl.value, nTrkOrigin.value, transformFeatureJetMean.value, transformFeatureJetStdev.value, transformFeatureTrkMean.value, transformFeatureTrkStdev.value, nJetConst);
       registry.add("h_db_b", "#it{D}_{b} b-jet;#it{D}_{b}", {HistType::kTH1F, {{50, -10., 35.}}});
@@ -515,6 +532,47 @@ struct JetTaggerHFTask {
     }
   }
 
+  /// Whether the jets are evaluated in batches, possible only for the models with one input node
+  bool isBatchedML()
+  {
+    return mlBatchSize.value != 1 && bMlResponse.getInputShape().size() == 1;
+  }
+
+  /// ML score of a jet from the model output
+  float getScoreML(const float* output, bool withSVs)
+  {
+    if (withSVs && bMlResponse.getOutputNodes() > 1) {
+      return useDb ? std::log(output[2] / (fC.value * output[1] + (1 - fC.value) * output[0])) : output[2]; // 2 is the b-jet index
+    }
+    return output[0];
+  }
+
+  void fillInferenceTimeQA(InferenceClock::time_point start, int nJets)
+  {
+    if (mlTimingQA) {
+      const double time = std::chrono::duration<double, std::micro>(InferenceClock::now() - start).count();
+      registry.fill(HIST("h_ml_inference_time"), time / nJets);
+      registry.fill(HIST("h_ml_jets_per_call"), nJets);
+    }
+  }
+
+  /// Evaluates the queued jets in batches of mlBatchSize and stores their scores
+  void evaluateBatchML(bool withSVs)
+  {
+    const std::size_t batchSize = std::max(mlBatchSize.value, 0);
+    if (!batchJetIndicesML.empty()) {
+      const auto start = InferenceClock::now();
+      auto scores = bMlResponse.isSelectedMlBatch(batchInputsML, batchPtsML, batchSelectedML, batchSize);
+      fillInferenceTimeQA(start, batchJetIndicesML.size());
+      for (std::size_t iJet = 0; iJet < batchJetIndicesML.size(); iJet++) {
+        scoreML[batchJetIndicesML[iJet]] = getScoreML(scores.data() + iJet * nClassesMl.value, withSVs);
+      }
+    }
+    batchInputsML.clear();
+    batchPtsML.clear();
+    batchJetIndicesML.clear();
+  }
+
   template <typename AnyJets, typename AnyTracks, typename SecondaryVertices>
   void analyzeJetAlgorithmML(AnyJets const& alljets, AnyTracks const& allTracks, SecondaryVertices const& allSVs)
   {
@@ -534,6 +592,13 @@ struct JetTaggerHFTask {
 
       std::vector<float> output;
 
+      if (isBatchedML()) {
+        batchInputsML.push_back(bMlResponse.getInputFeatures1D(jetparam, tracksParams, svsParams));
+        batchPtsML.push_back(analysisJet.pt());
+        batchJetIndicesML.push_back(analysisJet.globalIndex());
+        continue;
+      }
+      const auto start = InferenceClock::now();
       if (bMlResponse.getInputShape().size() > 1) {
         auto inputML = bMlResponse.getInputFeatures2D(jetparam, tracksParams, svsParams);
         bMlResponse.isSelectedMl(inputML, analysisJet.pt(), output);
@@ -541,17 +606,11 @@ struct JetTaggerHFTask {
         auto inputML = bMlResponse.getInputFeatures1D(jetparam, tracksParams, svsParams);
         bMlResponse.isSelectedMl(inputML, analysisJet.pt(), output);
       }
+      fillInferenceTimeQA(start, 1);
 
-      if (bMlResponse.getOutputNodes() > 1) {
-        auto mDb = [](std::vector<float> scores, float fC) {
-          return std::log(scores[2] / (fC * scores[1] + (1 - fC) * scores[0]));
-        };
-
-        scoreML[analysisJet.globalIndex()] = useDb ? mDb(output, fC) : output[2]; // 2 is the b-jet index
-      } else {
-        scoreML[analysisJet.globalIndex()] = output[0];
-      }
+      scoreML[analysisJet.globalIndex()] = getScoreML(output.data(), true);
     }
+    evaluateBatchML(true);
   }
 
   template <typename AnyJets, typename AnyTracks>
@@ -569,6 +628,13 @@ struct JetTaggerHFTask {
 
       std::vector<float> output;
 
+      if (isBatchedML()) {
+        batchInputsML.push_back(bMlResponse.getInputFeatures1D(jetparam, tracksParams, svsParams));
+        batchPtsML.push_back(analysisJet.pt());
+        batchJetIndicesML.push_back(analysisJet.globalIndex());
+        continue;
+      }
+      const auto start = InferenceClock::now();
       if (bMlResponse.getInputShape().size() > 1) {
         auto inputML = bMlResponse.getInputFeatures2D(jetparam, tracksParams, svsParams);
         bMlResponse.isSelectedMl(inputML, analysisJet.pt(), output);
@@ -576,9 +642,11 @@ struct JetTaggerHFTask {
         auto inputML = bMlResponse.getInputFeatures1D(jetparam, tracksParams, svsParams);
         bMlResponse.isSelectedMl(inputML, analysisJet.pt(), output);
       }
+      fillInferenceTimeQA(start, 1);
 
-      scoreML[analysisJet.globalIndex()] = output[0];
+      scoreML[analysisJet.globalIndex()] = getScoreML(output.data(), false);
     }
+    evaluateBatchML(false);
   }
 
   template <typename AnyJets, typename AnyTracks, typename AnyOriginalTracks>
@@ -595,7 +663,9 @@ struct JetTaggerHFTask {
         std::vector<Ort::Value> gnnInput;
         tensorAlloc.getGNNInput(jetFeat, trkFeat, feat, gnnInput);
 
+        const auto start = InferenceClock::now();
         auto modelOutput = bMlResponse.getModelOutput(gnnInput, 0);
+        fillInferenceTimeQA(start, 1);
         scoreML[jet.globalIndex()] = jettaggingutilities::getDb(modelOutput, fC);
       } else {
         scoreML[jet.globalIndex()] = -999.;
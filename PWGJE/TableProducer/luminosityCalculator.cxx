@@ -14,11 +14,13 @@
 ///
 /// \author Nima Zardoshti <nima.zardoshti@cern.ch>
 
+#include "PWGJE/Core/RunCounterSummary.h"
 #include "PWGJE/DataModel/JetReducedData.h"
 
 #include "Framework/ASoA.h"
 #include "Framework/AnalysisTask.h"
 #include "Framework/HistogramRegistry.h"
+#include <Framework/AnalysisHelpers.h>
 #include <Framework/Configurable.h>
 #include <Framework/DataProcessorSpec.h>
 #include <Framework/HistogramSpec.h>
@@ -27,6 +29,7 @@
 
 #include <TH1.h>
 
+#include <array>
 #include <string>
 #include <vector>
 
@@ -36,7 +39,12 @@ using namespace o2::framework::expressions;
 
 struct LuminosityCalculator {
 
+  static constexpr int NCounters = 17;
+  static constexpr int RunNumberUnknown = 0; // the stored count tables do not carry the run number
+
   HistogramRegistry registry;
+  OutputObj<RunCounterSummary> counterSummary{"counterSummary"};
+
   void init(InitContext&)
   {
 
@@ -46,69 +54,41 @@ struct LuminosityCalculator {
     for (std::vector<std::string>::size_type iCounter = 0; iCounter < histLabels.size(); iCounter++) {
       counter->GetXaxis()->SetBinLabel(iCounter + 1, histLabels[iCounter].data());
     }
+    counterSummary->setStages(histLabels);
   }
 
   void processCalculateLuminosity(aod::StoredBCCounts const& bcCounts, aod::StoredCollisionCounts const& collisionCounts)
   {
-    int readBC = 0;
-    int readBCWithTVXCounter = 0;
-    int readBCWithTVXAndNoTFBCounter = 0;
-    int readBCWithTVXAndNoTFBAndNoITSROFB = 0;
+    std::array<ULong64_t, NCounters> readCounts{};
 
     for (const auto& bcCount : bcCounts) {
-      readBC += bcCount.readCounts().front();
-      readBCWithTVXCounter += bcCount.readCountsWithTVX().front();
-      readBCWithTVXAndNoTFBCounter += bcCount.readCountsWithTVXAndNoTFB().front();
-      readBCWithTVXAndNoTFBAndNoITSROFB += bcCount.readCountsWithTVXAndNoTFBAndNoITSROFB().front();
+      readCounts[0] += bcCount.readCounts().front();
+      readCounts[1] += bcCount.readCountsWithTVX().front();
+      readCounts[2] += bcCount.readCountsWithTVXAndNoTFB().front();
+      readCounts[3] += bcCount.readCountsWithTVXAndNoTFBAndNoITSROFB().front();
     }
 
-    int readCollision = 0;
-    int readCollisionWithTVXCounter = 0;
-    int readCollisionWithTVXAndZVertexAndSel8Counter = 0;
-    int readCollisionWithTVXAndZVertexAndSel8FullCounter = 0;
-    int readCollisionWithTVXAndZVertexAndSel8FullPbPbCounter = 0;
-    int readCollisionWithTVXAndZVertexAndSelMCCounter = 0;
-    int readCollisionWithTVXAndZVertexAndSelMCFullCounter = 0;
-    int readCollisionWithTVXAndZVertexAndSelMCFullPbPbCounter = 0;
-    int readCollisionWithTVXAndZVertexAndSelUnanchoredMCCounter = 0;
-    int readCollisionWithTVXAndZVertexAndSelTVXCounter = 0;
-    int readCollisionWithTVXAndZVertexAndSel7Counter = 0;
-    int readCollisionWithTVXAndZVertexAndSel7KINT7Counter = 0;
-    int readCollisionWithCustomCounter = 0;
-
     for (const auto& collisionCount : collisionCounts) {
-      readCollision += collisionCount.readCounts().front();
-      readCollisionWithTVXCounter += collisionCount.readCountsWithTVX().front();
-      readCollisionWithTVXAndZVertexAndSel8Counter += collisionCount.readCountsWithTVXAndZVertexAndSel8().front();
-      readCollisionWithTVXAndZVertexAndSel8FullCounter += collisionCount.readCountsWithTVXAndZVertexAndSel8Full().front();
-      readCollisionWithTVXAndZVertexAndSel8FullPbPbCounter += collisionCount.readCountsWithTVXAndZVertexAndSel8FullPbPb().front();
-      readCollisionWithTVXAndZVertexAndSelMCCounter += collisionCount.readCountsWithTVXAndZVertexAndSelMC().front();
-      readCollisionWithTVXAndZVertexAndSelMCFullCounter += collisionCount.readCountsWithTVXAndZVertexAndSelMCFull().front();
-      readCollisionWithTVXAndZVertexAndSelMCFullPbPbCounter += collisionCount.readCountsWithTVXAndZVertexAndSelMCFullPbPb().front();
-      readCollisionWithTVXAndZVertexAndSelUnanchoredMCCounter += collisionCount.readCountsWithTVXAndZVertexAndSelUnanchoredMC().front();
-      readCollisionWithTVXAndZVertexAndSelTVXCounter += collisionCount.readCountsWithTVXAndZVertexAndSelTVX().front();
-      readCollisionWithTVXAndZVertexAndSel7Counter += collisionCount.readCountsWithTVXAndZVertexAndSel7().front();
-      readCollisionWithTVXAndZVertexAndSel7KINT7Counter += collisionCount.readCountsWithTVXAndZVertexAndSel7KINT7().front();
-      readCollisionWithCustomCounter += collisionCount.readCountsWithCustom().front();
+      readCounts[4] += collisionCount.readCounts().front();
+      readCounts[5] += collisionCount.readCountsWithTVX().front();
+      readCounts[6] += collisionCount.readCountsWithTVXAndZVertexAndSel8().front();
+      readCounts[7] += collisionCount.readCountsWithTVXAndZVertexAndSel8Full().front();
+      readCounts[8] += collisionCount.readCountsWithTVXAndZVertexAndSel8FullPbPb().front();
+      readCounts[9] += collisionCount.readCountsWithTVXAndZVertexAndSelMC().front();
+      readCounts[10] += collisionCount.readCountsWithTVXAndZVertexAndSelMCFull().front();
+      readCounts[11] += collisionCount.readCountsWithTVXAndZVertexAndSelMCFullPbPb().front();
+      readCounts[12] += collisionCount.readCountsWithTVXAndZVertexAndSelUnanchoredMC().front();
+      readCounts[13] += collisionCount.readCountsWithTVXAndZVertexAndSelTVX().front();
+      readCounts[14] += collisionCount.readCountsWithTVXAndZVertexAndSel7().front();
+      readCounts[15] += collisionCount.readCountsWithTVXAndZVertexAndSel7KINT7().front();
+      readCounts[16] += collisionCount.readCountsWithCustom().front();
     }
 
-    registry.get<TH1>(HIST("counter"))->SetBinContent(1, registry.get<TH1>(HIST("counter"))->GetBinContent(1) + readBC);
-    registry.get<TH1>(HIST("counter"))->SetBinContent(2, registry.get<TH1>(HIST("counter"))->GetBinContent(2) + readBCWithTVXCounter);
-    registry.get<TH1>(HIST("counter"))->SetBinContent(3, registry.get<TH1>(HIST("counter"))->GetBinContent(3) + readBCWithTVXAndNoTFBCounter);
-    registry.get<TH1>(HIST("counter"))->SetBinContent(4, registry.get<TH1>(HIST("counter"))->GetBinContent(4) + readBCWithTVXAndNoTFBAndNoITSROFB);
-    registry.get<TH1>(HIST("counter"))->SetBinContent(5, registry.get<TH1>(HIST("counter"))->GetBinContent(5) + readCollision);
-    registry.get<TH1>(HIST("counter"))->SetBinContent(6, registry.get<TH1>(HIST("counter"))->GetBinContent(6) + readCollisionWithTVXCounter);
-    registry.get<TH1>(HIST("counter"))->SetBinContent(7, registry.get<TH1>(HIST("counter"))->GetBinContent(7) + readCollisionWithTVXAndZVertexAndSel8Counter);
-    registry.get<TH1>(HIST("counter"))->SetBinContent(8, registry.get<TH1>(HIST("counter"))->GetBinContent(8) + readCollisionWithTVXAndZVertexAndSel8FullCounter);
-    registry.get<TH1>(HIST("counter"))->SetBinContent(9, registry.get<TH1>(HIST("counter"))->GetBinContent(9) + readCollisionWithTVXAndZVertexAndSel8FullPbPbCounter);
-    registry.get<TH1>(HIST("counter"))->SetBinContent(10, registry.get<TH1>(HIST("counter"))->GetBinContent(10) + readCollisionWithTVXAndZVertexAndSelMCCounter);
-    registry.get<TH1>(HIST("counter"))->SetBinContent(11, registry.get<TH1>(HIST("counter"))->GetBinContent(11) + readCollisionWithTVXAndZVertexAndSelMCFullCounter);
-    registry.get<TH1>(HIST("counter"))->SetBinContent(12, registry.get<TH1>(HIST("counter"))->GetBinContent(12) + readCollisionWithTVXAndZVertexAndSelMCFullPbPbCounter);
-    registry.get<TH1>(HIST("counter"))->SetBinContent(13, registry.get<TH1>(HIST("counter"))->GetBinContent(13) + readCollisionWithTVXAndZVertexAndSelUnanchoredMCCounter);
-    registry.get<TH1>(HIST("counter"))->SetBinContent(14, registry.get<TH1>(HIST("counter"))->GetBinContent(14) + readCollisionWithTVXAndZVertexAndSelTVXCounter);
-    registry.get<TH1>(HIST("counter"))->SetBinContent(15, registry.get<TH1>(HIST("counter"))->GetBinContent(15) + readCollisionWithTVXAndZVertexAndSel7Counter);
-    registry.get<TH1>(HIST("counter"))->SetBinContent(16, registry.get<TH1>(HIST("counter"))->GetBinContent(16) + readCollisionWithTVXAndZVertexAndSel7KINT7Counter);
-    registry.get<TH1>(HIST("counter"))->SetBinContent(16, registry.get<TH1>(HIST("counter"))->GetBinContent(17) + readCollisionWithCustomCounter);
+    auto counter = registry.get<TH1>(HIST("counter"));
+    for (int iCounter = 0; iCounter < NCounters; iCounter++) {
+      counter->SetBinContent(iCounter + 1, counter->GetBinContent(iCounter + 1) + readCounts[iCounter]);
+      counterSummary->add(RunNumberUnknown, iCounter, readCounts[iCounter]);
+    }
   }
   PROCESS_SWITCH(LuminosityCalculator, processCalculateLuminosity, "calculate ingredients for luminosity and fill a histogram", true);
 };
@@ -25,6 +25,8 @@
 #include "Framework/O2DatabasePDGPlugin.h"
 #include <Framework/AnalysisHelpers.h>
 #include <Framework/Configurable.h>
+#include <Framework/HistogramRegistry.h>
+#include <Framework/HistogramSpec.h>
 #include <Framework/InitContext.h>
 #include <Framework/runDataProcessing.h>
 
@@ -32,6 +34,7 @@
 #include <fastjet/PseudoJet.hh>
 
 #include <string>
+#include <tuple>
 #include <type_traits>
 #include <vector>
 
@@ -78,6 +81,10 @@ struct RhoEstimatorTask {
     Configurable<float> bkgPhiMin{"bkgPhiMin", -99., "minimim phi for determining background density"};
     Configurable<float> bkgPhiMax{"bkgPhiMax", 99., "maximum phi for determining background density"};
     Configurable<bool> doSparse{"doSparse", false, "perfom sparse estimation"};
+    Configurable<bool> cacheGhosts{"cacheGhosts", false, "generate the ghosts of the median estimate once with a fixed seed and reuse them in all events"};
+    Configurable<int> rhoEstimator{"rhoEstimator", 0, "rho estimator. 0 = median of the kT jet densities, 1 = median of the densities of fixed eta-phi patches"};
+    Configurable<float> gridPatchSize{"gridPatchSize", 0.4, "eta and phi size of the patches of the grid estimator"};
+    Configurable<bool> doGridMedianQA{"doGridMedianQA", false, "compare the grid estimate with the median of the kT jet densities in each event"};
 
     Configurable<float> thresholdTriggerTrackPtMin{"thresholdTriggerTrackPtMin", 0.0, "Minimum trigger track pt to accept event"};
     Configurable<float> thresholdClusterEnergyMin{"thresholdClusterEnergyMin", 0.0, "Minimum cluster energy to accept event"};
@@ -95,6 +102,7 @@ struct RhoEstimatorTask {
   } config;
 
   JetBkgSubUtils bkgSub;
+  HistogramRegistry registry;
   float bkgPhiMax_;
   float bkgPhiMin_;
   std::vector<fastjet::PseudoJet> inputParticles;
@@ -114,6 +122,8 @@ struct RhoEstimatorTask {
     bkgSub.setJetAlgorithmAndScheme(static_cast<fastjet::JetAlgorithm>(static_cast<int>(config.jetAlgorithm)), static_cast<fastjet::RecombinationScheme>(static_cast<int>(config.jetRecombScheme)));
     bkgSub.setJetBkgR(config.bkgjetR);
     bkgSub.setEtaMinMax(config.bkgEtaMin, config.bkgEtaMax);
+    bkgSub.setCacheGhosts(config.cacheGhosts);
+    bkgSub.setGridPatchSize(config.gridPatchSize);
     bkgPhiMax_ = config.bkgPhiMax;
     bkgPhiMin_ = config.bkgPhiMin;
     if (config.bkgPhiMax > 98.0) {
@@ -125,6 +135,28 @@ struct RhoEstimatorTask {
     bkgSub.setPhiMinMax(bkgPhiMin_, bkgPhiMax_);
     eventSelectionBits = jetderiveddatautilities::initialiseEventSelectionBits(static_cast<std::string>(config.eventSelections));
     triggerMaskBits = jetderiveddatautilities::initialiseTriggerMaskBits(config.triggerMasks);
+
+    if (config.doGridMedianQA) {
+      registry.add("h2_rho_areamedian_rho_gridmedian", ";#it{#rho}_{area median} (GeV/#it{c});#it{#rho}_{grid median} (GeV/#it{c})", {HistType::kTH2F, {{400, 0., 400.}, {400, 0., 400.}}});
+      registry.add("h2_rho_areamedian_rho_ratio", ";#it{#rho}_{area median} (GeV/#it{c});#it{#rho}_{grid median} / #it{#rho}_{area median}", {HistType::kTH2F, {{400, 0., 400.}, {200, 0., 2.}}});
+    }
+  }
+
+  std::tuple<double, double> estimateRho()
+  {
+    if (config.rhoEstimator == 0 && !config.doGridMedianQA) {
+      return bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+    }
+    auto rhoGrid = bkgSub.estimateRhoGridMedian(inputParticles, config.doSparse);
+    if (!config.doGridMedianQA) {
+      return rhoGrid;
+    }
+    auto rhoAreaMedian = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+    registry.fill(HIST("h2_rho_areamedian_rho_gridmedian"), std::get<0>(rhoAreaMedian), std::get<0>(rhoGrid));
+    if (std::get<0>(rhoAreaMedian) > 0.) {
+      registry.fill(HIST("h2_rho_areamedian_rho_ratio"), std::get<0>(rhoAreaMedian), std::get<0>(rhoGrid) / std::get<0>(rhoAreaMedian));
+    }
+    return config.rhoEstimator == 0 ? rhoAreaMedian : rhoGrid;
   }
 
   Filter trackCuts = (aod::jtrack::pt >= config.trackPtMin && aod::jtrack::pt < config.trackPtMax && aod::jtrack::eta > config.trackEtaMin && aod::jtrack::eta < config.trackEtaMax && aod::jtrack::phi >= config.trackPhiMin && aod::jtrack::phi <= config.trackPhiMax);
@@ -201,7 +233,7 @@ struct RhoEstimatorTask {
     }
     inputParticles.clear();
     jetfindingutilities::analyseTracks<soa::Filtered<aod::JetTracks>, soa::Filtered<aod::JetTracks>::iterator>(inputParticles, tracks, trackSelection, config.trackingEfficiency);
-    auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+    auto [rho, rhoM] = estimateRho();
     rhoChargedTable(rho, rhoM);
   }
   PROCESS_SWITCH(RhoEstimatorTask, processChargedCollisions, "Fill rho tables for collisions using charged tracks", true);
@@ -214,7 +246,7 @@ struct RhoEstimatorTask {
     }
     inputParticles.clear();
     jetfindingutilities::analyseParticles<true, soa::Filtered<aod::JetParticles>, soa::Filtered<aod::JetParticles>::iterator>(inputParticles, particleSelection, 1, particles, pdgDatabase);
-    auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+    auto [rho, rhoM] = estimateRho();
     rhoChargedMcTable(rho, rhoM);
   }
   PROCESS_SWITCH(RhoEstimatorTask, processChargedMcCollisions, "Fill rho tables for MC collisions using charged tracks", false);
@@ -229,7 +261,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseTracks(inputParticles, tracks, trackSelection, config.trackingEfficiency, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = estimateRho();
       rhoD0Table(rho, rhoM);
     }
   }
@@ -241,7 +273,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseParticles<true>(inputParticles, particleSelection, 1, particles, pdgDatabase, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = estimateRho();
       rhoD0McTable(rho, rhoM);
     }
   }
@@ -257,7 +289,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseTracks(inputParticles, tracks, trackSelection, config.trackingEfficiency, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = estimateRho();
       rhoDplusTable(rho, rhoM);
     }
   }
@@ -269,7 +301,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseParticles<true>(inputParticles, particleSelection, 1, particles, pdgDatabase, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = estimateRho();
       rhoDplusMcTable(rho, rhoM);
     }
   }
@@ -285,7 +317,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseTracks(inputParticles, tracks, trackSelection, config.trackingEfficiency, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = estimateRho();
       rhoLcTable(rho, rhoM);
     }
   }
@@ -297,7 +329,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseParticles<true>(inputParticles, particleSelection, 1, particles, pdgDatabase, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = estimateRho();
       rhoLcMcTable(rho, rhoM);
     }
   }
@@ -313,7 +345,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseTracks(inputParticles, tracks, trackSelection, config.trackingEfficiency, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = estimateRho();
       rhoBplusTable(rho, rhoM);
     }
   }
@@ -325,7 +357,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseParticles<true>(inputParticles, particleSelection, 1, particles, pdgDatabase, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = estimateRho();
       rhoBplusMcTable(rho, rhoM);
     }
   }
@@ -341,7 +373,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseTracks(inputParticles, tracks, trackSelection, config.trackingEfficiency, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = estimateRho();
       rhoDielectronTable(rho, rhoM);
     }
   }
@@ -353,7 +385,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseParticles<true>(inputParticles, particleSelection, 1, particles, pdgDatabase, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = estimateRho();
       rhoDielectronMcTable(rho, rhoM);
     }
   }
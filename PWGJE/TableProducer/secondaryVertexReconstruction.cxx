@@ -85,6 +85,7 @@ struct SecondaryVertexReconstruction {
   Configurable<float> etaMaxTrack{"etaMaxTrack", 4., "max. pseudorapidity"};
   Configurable<float> maxIPxy{"maxIPxy", 10, "maximum track DCA in xy plane"};
   Configurable<float> maxIPz{"maxIPz", 10, "maximum track DCA in z direction"};
+  Configurable<float> minIPxySignificance{"minIPxySignificance", 0., "minimum track DCA significance in xy plane (prefilter before the vertex fit, 0 to disable)"};
   Configurable<bool> fillHistograms{"fillHistograms", true, "do validation plots"};
 
   Configurable<std::string> ccdbUrl{"ccdbUrl", "http://alice-ccdb.cern.ch", "url of the ccdb repository"};
@@ -102,6 +103,12 @@ struct SecondaryVertexReconstruction {
   float toMicrometers = 10000.; // from cm to µm
   double bz{0.};
 
+  // selected constituents of the current jet
+  std::vector<o2::track::TrackParametrizationWithError<float>> jetTrackParCovs;
+  std::vector<double> jetTrackEnergies;
+  std::vector<float> jetTrackPts;
+  std::vector<int> svIndices;
+
   void init(InitContext const&)
   {
     if (fillHistograms) {
@@ -145,170 +152,219 @@ struct SecondaryVertexReconstruction {
   using JetTracksMCDwPIs = soa::Filtered<soa::Join<aod::JetTracksMCD, aod::JTrackPIs>>;
   using OriginalTracks = soa::Join<aod::Tracks, aod::TracksCov, aod::TrackSelection, aod::TracksDCA, aod::TracksDCACov>;
 
-  template <unsigned int numProngs, bool externalMagneticField, typename AnyCollision, typename AnyJet, typename AnyParticles>
-  void runCreatorNProng(AnyCollision const& collision,
-                        AnyJet const& analysisJet,
-                        AnyParticles const& listoftracks,
-                        std::vector<int>& svIndices,
-                        o2::vertexing::DCAFitterN<numProngs>& df,
-                        size_t prongIndex = 0,
-                        std::vector<size_t> currentCombination = {})
+  template <bool externalMagneticField, typename AnyCollision>
+  void setMagneticField(AnyCollision const& collision)
   {
-
-    const auto& particles = analysisJet.template tracks_as<AnyParticles>();
-
-    if (currentCombination.size() == numProngs) {
-      // Create an array of track parameters and covariance matrices for the current combination
-      std::array<o2::track::TrackParametrizationWithError<float>, numProngs> trackParVars;
-      double energySV = 0.;
-      for (unsigned int inum = 0; inum < numProngs; ++inum) {
-        const auto& prong = particles[currentCombination[inum]].template track_as<OriginalTracks>();
-        energySV += prong.energy(o2::constants::physics::MassPiPlus);
-        trackParVars[inum] = getTrackParCov(prong);
+    if constexpr (externalMagneticField) {
+      bz = magneticField;
+    } else {
+      auto bc = collision.template bc_as<aod::BCsWithTimestamps>();
+      if (runNumber != bc.runNumber()) {
+        initCCDB(bc, runNumber, ccdb, ccdbPathGrpMag, lut, false);
+        bz = o2::base::Propagator::Instance()->getNominalBz();
       }
+    }
+    df2.setBz(bz);
+    df3.setBz(bz);
+  }
 
-      if constexpr (externalMagneticField) {
-        bz = magneticField;
-      } else {
-        auto bc = collision.template bc_as<aod::BCsWithTimestamps>();
-        if (runNumber != bc.runNumber()) {
-          initCCDB(bc, runNumber, ccdb, ccdbPathGrpMag, lut, false);
-          bz = o2::base::Propagator::Instance()->getNominalBz();
-        }
+  /// Caches the parameters of the jet constituents passing the track selection, once per jet for all the combinations
+  template <typename AnyParticles, typename AnyJet>
+  void cacheJetTracks(AnyJet const& analysisJet)
+  {
+    jetTrackParCovs.clear();
+    jetTrackEnergies.clear();
+    jetTrackPts.clear();
+    for (const auto& particle : analysisJet.template tracks_as<AnyParticles>()) {
+      const auto& track = particle.template track_as<OriginalTracks>();
+      if (track.pt() < ptMinTrack || track.eta() < etaMinTrack || track.eta() > etaMaxTrack || std::abs(track.dcaXY()) > maxIPxy || std::abs(track.dcaZ()) > maxIPz) {
+        continue;
       }
+      if (minIPxySignificance > 0. && std::abs(track.dcaXY()) < minIPxySignificance * std::sqrt(track.sigmaDcaXY2())) {
+        continue;
+      }
+      jetTrackParCovs.push_back(getTrackParCov(track));
+      jetTrackEnergies.push_back(track.energy(o2::constants::physics::MassPiPlus));
+      jetTrackPts.push_back(track.pt());
+    }
+  }
 
-      // Use a different fitter depending on the number of prongs
-      df.setBz(bz);
+  template <unsigned int numProngs, typename AnyJet>
+  void fitCombination(AnyJet const& analysisJet,
+                      o2::dataformats::VertexBase const& primaryVertex,
+                      std::array<std::size_t, numProngs> const& combination,
+                      std::vector<int>& svIndices,
+                      o2::vertexing::DCAFitterN<numProngs>& df)
+  {
+    // Create an array of track parameters and covariance matrices for the current combination
+    std::array<o2::track::TrackParametrizationWithError<float>, numProngs> trackParVars;
+    double energySV = 0.;
+    for (unsigned int inum = 0; inum < numProngs; ++inum) {
+      energySV += jetTrackEnergies[combination[inum]];
+      trackParVars[inum] = jetTrackParCovs[combination[inum]];
+    }
 
-      // Reconstruct the secondary vertex
-      int processResult = 0;
-      try {
-        std::apply([&df, &processResult](const auto&... elems) { processResult = df.process(elems...); }, trackParVars);
-      } catch (const std::runtime_error& error) {
-        LOG(info) << "Run time error found: " << error.what() << ". DCAFitterN cannot work, skipping the candidate.";
-        return;
-      }
-      if (processResult == 0) {
-        return;
-      }
+    // Reconstruct the secondary vertex
+    int processResult = 0;
+    try {
+      std::apply([&df, &processResult](const auto&... elems) { processResult = df.process(elems...); }, trackParVars);
+    } catch (const std::runtime_error& error) {
+      LOG(info) << "Run time error found: " << error.what() << ". DCAFitterN cannot work, skipping the candidate.";
+      return;
+    }
+    if (processResult == 0) {
+      return;
+    }
 
-      const auto& secondaryVertex = df.getPCACandidatePos();
-      if (std::sqrt(secondaryVertex[0] * secondaryVertex[0] + secondaryVertex[1] * secondaryVertex[1]) > maxRsv || std::abs(secondaryVertex[2]) > maxZsv) {
-        return;
-      }
+    const auto& secondaryVertex = df.getPCACandidatePos();
+    if (std::sqrt(secondaryVertex[0] * secondaryVertex[0] + secondaryVertex[1] * secondaryVertex[1]) > maxRsv || std::abs(secondaryVertex[2]) > maxZsv) {
+      return;
+    }
 
-      float dispersion = 0.;
-      for (unsigned int inum = 0; inum < numProngs; ++inum) {
-        o2::dataformats::VertexBase sv(o2::math_utils::Point3D<float>{secondaryVertex[0], secondaryVertex[1], secondaryVertex[2]}, std::array<float, 6>{0});
-        o2::dataformats::DCA dcaSV;
-        auto& prong = df.getTrack(inum);
-        prong.propagateToDCA(sv, bz, &dcaSV);
-        dispersion += (dcaSV.getY() * dcaSV.getY() + dcaSV.getZ() * dcaSV.getZ());
-      }
-      dispersion = std::sqrt(dispersion / numProngs);
+    float dispersion = 0.;
+    for (unsigned int inum = 0; inum < numProngs; ++inum) {
+      o2::dataformats::VertexBase sv(o2::math_utils::Point3D<float>{secondaryVertex[0], secondaryVertex[1], secondaryVertex[2]}, std::array<float, 6>{0});
+      o2::dataformats::DCA dcaSV;
+      auto& prong = df.getTrack(inum);
+      prong.propagateToDCA(sv, bz, &dcaSV);
+      dispersion += (dcaSV.getY() * dcaSV.getY() + dcaSV.getZ() * dcaSV.getZ());
+    }
+    dispersion = std::sqrt(dispersion / numProngs);
 
-      auto chi2PCA = df.getChi2AtPCACandidate();
-      auto covMatrixPCA = df.calcPCACovMatrixFlat();
+    auto chi2PCA = df.getChi2AtPCACandidate();
+    auto covMatrixPCA = df.calcPCACovMatrixFlat();
 
+    if (fillHistograms) {
       registry.fill(HIST("hDispersion"), dispersion, numProngs);
+    }
 
-      // get track impact parameters
-      // This modifies track momenta!
-      auto primaryVertex = getPrimaryVertex(collision);
-      auto covMatrixPV = primaryVertex.getCov();
-
-      // Get track momenta and impact parameters
-      std::array<std::array<float, 3>, numProngs> arrayMomenta;
-      std::array<o2::dataformats::DCA, numProngs> impactParameters;
-      for (unsigned int inum = 0; inum < numProngs; ++inum) {
-        trackParVars[inum].getPxPyPzGlo(arrayMomenta[inum]);
-        trackParVars[inum].propagateToDCA(primaryVertex, bz, &impactParameters[inum]);
-
-        if (fillHistograms) {
-          const auto& prong = particles[currentCombination[inum]].template track_as<OriginalTracks>();
-          registry.fill(HIST("hDcaXYNProngs"), prong.pt(), impactParameters[inum].getY() * toMicrometers, numProngs);
-          registry.fill(HIST("hDcaZNProngs"), prong.pt(), impactParameters[inum].getZ() * toMicrometers, numProngs);
-        }
-      }
+    // get track impact parameters
+    // This modifies track momenta!
+    auto covMatrixPV = primaryVertex.getCov();
 
-      // get uncertainty of the decay length
-      double phi, theta;
-      getPointDirection(std::array{primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ()}, secondaryVertex, phi, theta);
-      auto errorDecayLength = std::sqrt(getRotatedCovMatrixXX(covMatrixPV, phi, theta) + getRotatedCovMatrixXX(covMatrixPCA, phi, theta));
-      auto errorDecayLengthXY = std::sqrt(getRotatedCovMatrixXX(covMatrixPV, phi, 0.) + getRotatedCovMatrixXX(covMatrixPCA, phi, 0.));
-
-      // calculate invariant mass
-      std::array<double, numProngs> massArray;
-      std::fill(massArray.begin(), massArray.end(), o2::constants::physics::MassPiPlus);
-      double massSV = RecoDecay::m(std::move(arrayMomenta), massArray);
-
-      // fill candidate table rows
-      if ((doprocessData3Prongs || doprocessData3ProngsExternalMagneticField) && numProngs == 3) {
-        sv3prongTableData(analysisJet.globalIndex(),
-                          primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ(),
-                          secondaryVertex[0], secondaryVertex[1], secondaryVertex[2],
-                          arrayMomenta[0][0] + arrayMomenta[1][0] + arrayMomenta[2][0],
-                          arrayMomenta[0][1] + arrayMomenta[1][1] + arrayMomenta[2][1],
-                          arrayMomenta[0][2] + arrayMomenta[1][2] + arrayMomenta[2][2],
-                          energySV, massSV, chi2PCA, dispersion, errorDecayLength, errorDecayLengthXY);
-        svIndices.push_back(sv3prongTableData.lastIndex());
-      } else if ((doprocessData2Prongs || doprocessData2ProngsExternalMagneticField) && numProngs == 2) {
-        sv2prongTableData(analysisJet.globalIndex(),
-                          primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ(),
-                          secondaryVertex[0], secondaryVertex[1], secondaryVertex[2],
-                          arrayMomenta[0][0] + arrayMomenta[1][0],
-                          arrayMomenta[0][1] + arrayMomenta[1][1],
-                          arrayMomenta[0][2] + arrayMomenta[1][2],
-                          energySV, massSV, chi2PCA, dispersion, errorDecayLength, errorDecayLengthXY);
-        svIndices.push_back(sv2prongTableData.lastIndex());
-      } else if ((doprocessMCD3Prongs || doprocessMCD3ProngsExternalMagneticField) && numProngs == 3) {
-        sv3prongTableMCD(analysisJet.globalIndex(),
-                         primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ(),
-                         secondaryVertex[0], secondaryVertex[1], secondaryVertex[2],
-                         arrayMomenta[0][0] + arrayMomenta[1][0] + arrayMomenta[2][0],
-                         arrayMomenta[0][1] + arrayMomenta[1][1] + arrayMomenta[2][1],
-                         arrayMomenta[0][2] + arrayMomenta[1][2] + arrayMomenta[2][2],
-                         energySV, massSV, chi2PCA, dispersion, errorDecayLength, errorDecayLengthXY);
-        svIndices.push_back(sv3prongTableMCD.lastIndex());
-      } else if ((doprocessMCD2Prongs || doprocessMCD2ProngsExternalMagneticField) && numProngs == 2) {
-        sv2prongTableMCD(analysisJet.globalIndex(),
-                         primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ(),
-                         secondaryVertex[0], secondaryVertex[1], secondaryVertex[2],
-                         arrayMomenta[0][0] + arrayMomenta[1][0],
-                         arrayMomenta[0][1] + arrayMomenta[1][1],
-                         arrayMomenta[0][2] + arrayMomenta[1][2],
-                         energySV, massSV, chi2PCA, dispersion, errorDecayLength, errorDecayLengthXY);
-        svIndices.push_back(sv2prongTableMCD.lastIndex());
-      } else {
-        LOG(error) << "No process specified\n";
-      }
+    // Get track momenta and impact parameters
+    std::array<std::array<float, 3>, numProngs> arrayMomenta;
+    std::array<o2::dataformats::DCA, numProngs> impactParameters;
+    for (unsigned int inum = 0; inum < numProngs; ++inum) {
+      trackParVars[inum].getPxPyPzGlo(arrayMomenta[inum]);
+      trackParVars[inum].propagateToDCA(primaryVertex, bz, &impactParameters[inum]);
 
-      // fill histograms
       if (fillHistograms) {
-        double decayLengthNormalised = RecoDecay::distance(std::array{primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ()}, std::array{secondaryVertex[0], secondaryVertex[1], secondaryVertex[2]}) / errorDecayLength;
-        double decayLengthXYNormalised = RecoDecay::distanceXY(std::array{primaryVertex.getX(), primaryVertex.getY()}, std::array{secondaryVertex[0], secondaryVertex[1]}) / errorDecayLengthXY;
-
-        registry.fill(HIST("hMassNProngs"), massSV, numProngs);
-        registry.fill(HIST("hLxySNProngs"), decayLengthXYNormalised, numProngs);
-        registry.fill(HIST("hLSNProngs"), decayLengthNormalised, numProngs);
-        registry.fill(HIST("hFeNProngs"), energySV / analysisJet.energy() > 1. ? 0.99 : energySV / analysisJet.energy(), numProngs);
+        registry.fill(HIST("hDcaXYNProngs"), jetTrackPts[combination[inum]], impactParameters[inum].getY() * toMicrometers, numProngs);
+        registry.fill(HIST("hDcaZNProngs"), jetTrackPts[combination[inum]], impactParameters[inum].getZ() * toMicrometers, numProngs);
       }
+    }
 
-      return;
+    // get uncertainty of the decay length
+    double phi, theta;
+    getPointDirection(std::array{primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ()}, secondaryVertex, phi, theta);
+    auto errorDecayLength = std::sqrt(getRotatedCovMatrixXX(covMatrixPV, phi, theta) + getRotatedCovMatrixXX(covMatrixPCA, phi, theta));
+    auto errorDecayLengthXY = std::sqrt(getRotatedCovMatrixXX(covMatrixPV, phi, 0.) + getRotatedCovMatrixXX(covMatrixPCA, phi, 0.));
+
+    // calculate invariant mass
+    std::array<double, numProngs> massArray;
+    std::fill(massArray.begin(), massArray.end(), o2::constants::physics::MassPiPlus);
+    double massSV = RecoDecay::m(std::move(arrayMomenta), massArray);
+
+    // fill candidate table rows
+    if ((doprocessData3Prongs || doprocessData3ProngsExternalMagneticField) && numProngs == 3) {
+      sv3prongTableData(analysisJet.globalIndex(),
+                        primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ(),
+                        secondaryVertex[0], secondaryVertex[1], secondaryVertex[2],
+                        arrayMomenta[0][0] + arrayMomenta[1][0] + arrayMomenta[2][0],
+                        arrayMomenta[0][1] + arrayMomenta[1][1] + arrayMomenta[2][1],
+                        arrayMomenta[0][2] + arrayMomenta[1][2] + arrayMomenta[2][2],
+                        energySV, massSV, chi2PCA, dispersion, errorDecayLength, errorDecayLengthXY);
+      svIndices.push_back(sv3prongTableData.lastIndex());
+    } else if ((doprocessData2Prongs || doprocessData2ProngsExternalMagneticField) && numProngs == 2) {
+      sv2prongTableData(analysisJet.globalIndex(),
+                        primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ(),
+                        secondaryVertex[0], secondaryVertex[1], secondaryVertex[2],
+                        arrayMomenta[0][0] + arrayMomenta[1][0],
+                        arrayMomenta[0][1] + arrayMomenta[1][1],
+                        arrayMomenta[0][2] + arrayMomenta[1][2],
+                        energySV, massSV, chi2PCA, dispersion, errorDecayLength, errorDecayLengthXY);
+      svIndices.push_back(sv2prongTableData.lastIndex());
+    } else if ((doprocessMCD3Prongs || doprocessMCD3ProngsExternalMagneticField) && numProngs == 3) {
+      sv3prongTableMCD(analysisJet.globalIndex(),
+                       primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ(),
+                       secondaryVertex[0], secondaryVertex[1], secondaryVertex[2],
+                       arrayMomenta[0][0] + arrayMomenta[1][0] + arrayMomenta[2][0],
+                       arrayMomenta[0][1] + arrayMomenta[1][1] + arrayMomenta[2][1],
+                       arrayMomenta[0][2] + arrayMomenta[1][2] + arrayMomenta[2][2],
+                       energySV, massSV, chi2PCA, dispersion, errorDecayLength, errorDecayLengthXY);
+      svIndices.push_back(sv3prongTableMCD.lastIndex());
+    } else if ((doprocessMCD2Prongs || doprocessMCD2ProngsExternalMagneticField) && numProngs == 2) {
+      sv2prongTableMCD(analysisJet.globalIndex(),
+                       primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ(),
+                       secondaryVertex[0], secondaryVertex[1], secondaryVertex[2],
+                       arrayMomenta[0][0] + arrayMomenta[1][0],
+                       arrayMomenta[0][1] + arrayMomenta[1][1],
+                       arrayMomenta[0][2] + arrayMomenta[1][2],
+                       energySV, massSV, chi2PCA, dispersion, errorDecayLength, errorDecayLengthXY);
+      svIndices.push_back(sv2prongTableMCD.lastIndex());
+    } else {
+      LOG(error) << "No process specified\n";
     }
 
-    // Recursive call to explore all combinations
-    for (size_t iprong = prongIndex; iprong < particles.size(); ++iprong) {
+    // fill histograms
+    if (fillHistograms) {
+      double decayLengthNormalised = RecoDecay::distance(std::array{primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ()}, std::array{secondaryVertex[0], secondaryVertex[1], secondaryVertex[2]}) / errorDecayLength;
+      double decayLengthXYNormalised = RecoDecay::distanceXY(std::array{primaryVertex.getX(), primaryVertex.getY()}, std::array{secondaryVertex[0], secondaryVertex[1]}) / errorDecayLengthXY;
 
-      const auto& testTrack = particles[iprong].template track_as<OriginalTracks>();
-      if (testTrack.pt() < ptMinTrack || testTrack.eta() < etaMinTrack || testTrack.eta() > etaMaxTrack || std::abs(testTrack.dcaXY()) > maxIPxy || std::abs(testTrack.dcaZ()) > maxIPz) {
-        continue;
+      registry.fill(HIST("hMassNProngs"), massSV, numProngs);
+      registry.fill(HIST("hLxySNProngs"), decayLengthXYNormalised, numProngs);
+      registry.fill(HIST("hLSNProngs"), decayLengthNormalised, numProngs);
+      registry.fill(HIST("hFeNProngs"), energySV / analysisJet.energy() > 1. ? 0.99 : energySV / analysisJet.energy(), numProngs);
+    }
+  }
+
+  template <unsigned int numProngs, typename AnyJet>
+  void runCreatorNProng(AnyJet const& analysisJet,
+                        o2::dataformats::VertexBase const& primaryVertex,
+                        std::vector<int>& svIndices,
+                        o2::vertexing::DCAFitterN<numProngs>& df)
+  {
+    const std::size_t nTracks = jetTrackParCovs.size();
+    if (nTracks < numProngs) {
+      return;
+    }
+    // Loop over all the combinations of numProngs cached tracks, in increasing order of the indices
+    std::array<std::size_t, numProngs> combination;
+    for (unsigned int inum = 0; inum < numProngs; ++inum) {
+      combination[inum] = inum;
+    }
+    while (true) {
+      fitCombination<numProngs>(analysisJet, primaryVertex, combination, svIndices, df);
+      int iprong = numProngs - 1;
+      while (iprong >= 0 && combination[iprong] == nTracks - numProngs + iprong) {
+        --iprong;
       }
+      if (iprong < 0) {
+        break;
+      }
+      ++combination[iprong];
+      for (unsigned int inum = iprong + 1; inum < numProngs; ++inum) {
+        combination[inum] = combination[inum - 1] + 1;
+      }
+    }
+  }
 
-      currentCombination.push_back(iprong);
-      runCreatorNProng<numProngs, externalMagneticField>(
-        collision, analysisJet, listoftracks, svIndices, df, iprong + 1, currentCombination);
-      currentCombination.pop_back();
+  /// Reconstructs the secondary vertices of all the jets of the collision, with the magnetic field and the primary vertex set once
+  template <unsigned int numProngs, bool externalMagneticField, typename AnyParticles, typename AnyJets, typename AnySvIndicesTable>
+  void runCreatorJets(JetCollisionwPIs::iterator const& collision,
+                      AnyJets const& jets,
+                      AnySvIndicesTable& svIndicesTable,
+                      o2::vertexing::DCAFitterN<numProngs>& df)
+  {
+    const auto& originalCollision = collision.template collision_as<aod::Collisions>();
+    setMagneticField<externalMagneticField>(originalCollision);
+    const auto primaryVertex = getPrimaryVertex(originalCollision);
+    for (const auto& jet : jets) {
+      svIndices.clear();
+      cacheJetTracks<AnyParticles>(jet);
+      runCreatorNProng<numProngs>(jet, primaryVertex, svIndices, df);
+      svIndicesTable(svIndices);
     }
   }
 
@@ -317,83 +373,51 @@ struct SecondaryVertexReconstruction {
   }
   PROCESS_SWITCH(SecondaryVertexReconstruction, processDummy, "Dummy process", true);
 
-  void processData3Prongs(JetCollisionwPIs::iterator const& collision, aod::Collisions const& /*realColl*/, soa::Join<aod::ChargedJets, aod::ChargedJetConstituents> const& jets, JetTracksData const& tracks, OriginalTracks const& /*tracks*/, aod::BCsWithTimestamps const& /*bcWithTimeStamps*/)
+  void processData3Prongs(JetCollisionwPIs::iterator const& collision, aod::Collisions const& /*realColl*/, soa::Join<aod::ChargedJets, aod::ChargedJetConstituents> const& jets, JetTracksData const& /*tracks*/, OriginalTracks const& /*tracks*/, aod::BCsWithTimestamps const& /*bcWithTimeStamps*/)
   {
-    for (const auto& jet : jets) {
-      std::vector<int> svIndices;
-      runCreatorNProng<3, false>(collision.template collision_as<aod::Collisions>(), jet, tracks, svIndices, df3);
-      sv3prongIndicesTableData(svIndices);
-    }
+    runCreatorJets<3, false, JetTracksData>(collision, jets, sv3prongIndicesTableData, df3);
   }
   PROCESS_SWITCH(SecondaryVertexReconstruction, processData3Prongs, "Reconstruct the data 3-prong secondary vertex", false);
 
-  void processData3ProngsExternalMagneticField(JetCollisionwPIs::iterator const& collision, aod::Collisions const& /*realColl*/, soa::Join<aod::ChargedJets, aod::ChargedJetConstituents> const& jets, JetTracksData const& tracks, OriginalTracks const& /*tracks*/)
+  void processData3ProngsExternalMagneticField(JetCollisionwPIs::iterator const& collision, aod::Collisions const& /*realColl*/, soa::Join<aod::ChargedJets, aod::ChargedJetConstituents> const& jets, JetTracksData const& /*tracks*/, OriginalTracks const& /*tracks*/)
   {
-    for (const auto& jet : jets) {
-      std::vector<int> svIndices;
-      runCreatorNProng<3, true>(collision.template collision_as<aod::Collisions>(), jet, tracks, svIndices, df3);
-      sv3prongIndicesTableData(svIndices);
-    }
+    runCreatorJets<3, true, JetTracksData>(collision, jets, sv3prongIndicesTableData, df3);
   }
   PROCESS_SWITCH(SecondaryVertexReconstruction, processData3ProngsExternalMagneticField, "Reconstruct the data 3-prong secondary vertex with external magnetic field", false);
 
-  void processData2Prongs(JetCollisionwPIs::iterator const& collision, aod::Collisions const& /*realColl*/, soa::Join<aod::ChargedJets, aod::ChargedJetConstituents> const& jets, JetTracksData const& tracks, OriginalTracks const& /*tracks*/, aod::BCsWithTimestamps const& /*bcWithTimeStamps*/)
+  void processData2Prongs(JetCollisionwPIs::iterator const& collision, aod::Collisions const& /*realColl*/, soa::Join<aod::ChargedJets, aod::ChargedJetConstituents> const& jets, JetTracksData const& /*tracks*/, OriginalTracks const& /*tracks*/, aod::BCsWithTimestamps const& /*bcWithTimeStamps*/)
   {
-    for (const auto& jet : jets) {
-      std::vector<int> svIndices;
-      runCreatorNProng<2, false>(collision.template collision_as<aod::Collisions>(), jet, tracks, svIndices, df2);
-      sv2prongIndicesTableData(svIndices);
-    }
+    runCreatorJets<2, false, JetTracksData>(collision, jets, sv2prongIndicesTableData, df2);
   }
   PROCESS_SWITCH(SecondaryVertexReconstruction, processData2Prongs, "Reconstruct the data 2-prong secondary vertex", false);
 
-  void processData2ProngsExternalMagneticField(JetCollisionwPIs::iterator const& collision, aod::Collisions const& /*realColl*/, soa::Join<aod::ChargedJets, aod::ChargedJetConstituents> const& jets, JetTracksData const& tracks, OriginalTracks const& /*tracks*/)
+  void processData2ProngsExternalMagneticField(JetCollisionwPIs::iterator const& collision, aod::Collisions const& /*realColl*/, soa::Join<aod::ChargedJets, aod::ChargedJetConstituents> const& jets, JetTracksData const& /*tracks*/, OriginalTracks const& /*tracks*/)
   {
-    for (const auto& jet : jets) {
-      std::vector<int> svIndices;
-      runCreatorNProng<2, true>(collision.template collision_as<aod::Collisions>(), jet, tracks, svIndices, df2);
-      sv2prongIndicesTableData(svIndices);
-    }
+    runCreatorJets<2, true, JetTracksData>(collision, jets, sv2prongIndicesTableData, df2);
   }
   PROCESS_SWITCH(SecondaryVertexReconstruction, processData2ProngsExternalMagneticField, "Reconstruct the data 2-prong secondary vertex with extrernal magnetic field", false);
 
-  void processMCD3Prongs(JetCollisionwPIs::iterator const& collision, aod::Collisions const& /*realColl*/, soa::Join<aod::ChargedMCDetectorLevelJets, aod::ChargedMCDetectorLevelJetConstituents> const& mcdjets, JetTracksMCDwPIs const& tracks, OriginalTracks const& /*tracks*/, aod::BCsWithTimestamps const& /*bcWithTimeStamps*/)
+  void processMCD3Prongs(JetCollisionwPIs::iterator const& collision, aod::Collisions const& /*realColl*/, soa::Join<aod::ChargedMCDetectorLevelJets, aod::ChargedMCDetectorLevelJetConstituents> const& mcdjets, JetTracksMCDwPIs const& /*tracks*/, OriginalTracks const& /*tracks*/, aod::BCsWithTimestamps const& /*bcWithTimeStamps*/)
   {
-    for (const auto& jet : mcdjets) {
-      std::vector<int> svIndices;
-      runCreatorNProng<3, false>(collision.template collision_as<aod::Collisions>(), jet, tracks, svIndices, df3);
-      sv3prongIndicesTableMCD(svIndices);
-    }
+    runCreatorJets<3, false, JetTracksMCDwPIs>(collision, mcdjets, sv3prongIndicesTableMCD, df3);
   }
   PROCESS_SWITCH(SecondaryVertexReconstruction, processMCD3Prongs, "Reconstruct the MCD 3-prong secondary vertex", false);
 
-  void processMCD3ProngsExternalMagneticField(JetCollisionwPIs::iterator const& collision, aod::Collisions const& /*realColl*/, soa::Join<aod::ChargedMCDetectorLevelJets, aod::ChargedMCDetectorLevelJetConstituents> const& mcdjets, JetTracksMCDwPIs const& tracks, OriginalTracks const& /*tracks*/)
+  void processMCD3ProngsExternalMagneticField(JetCollisionwPIs::iterator const& collision, aod::Collisions const& /*realColl*/, soa::Join<aod::ChargedMCDetectorLevelJets, aod::ChargedMCDetectorLevelJetConstituents> const& mcdjets, JetTracksMCDwPIs const& /*tracks*/, OriginalTracks const& /*tracks*/)
   {
-    for (const auto& jet : mcdjets) {
-      std::vector<int> svIndices;
-      runCreatorNProng<3, true>(collision.template collision_as<aod::Collisions>(), jet, tracks, svIndices, df3);
-      sv3prongIndicesTableMCD(svIndices);
-    }
+    runCreatorJets<3, true, JetTracksMCDwPIs>(collision, mcdjets, sv3prongIndicesTableMCD, df3);
   }
   PROCESS_SWITCH(SecondaryVertexReconstruction, processMCD3ProngsExternalMagneticField, "Reconstruct the MCD 3-prong secondary vertex with external magnetic field", false);
 
-  void processMCD2Prongs(JetCollisionwPIs::iterator const& collision, aod::Collisions const& /*realColl*/, soa::Join<aod::ChargedMCDetectorLevelJets, aod::ChargedMCDetectorLevelJetConstituents> const& mcdjets, JetTracksMCDwPIs const& tracks, OriginalTracks const& /*tracks*/, aod::BCsWithTimestamps const& /*bcWithTimeStamps*/)
+  void processMCD2Prongs(JetCollisionwPIs::iterator const& collision, aod::Collisions const& /*realColl*/, soa::Join<aod::ChargedMCDetectorLevelJets, aod::ChargedMCDetectorLevelJetConstituents> const& mcdjets, JetTracksMCDwPIs const& /*tracks*/, OriginalTracks const& /*tracks*/, aod::BCsWithTimestamps const& /*bcWithTimeStamps*/)
   {
-    for (const auto& jet : mcdjets) {
-      std::vector<int> svIndices;
-      runCreatorNProng<2, false>(collision.template collision_as<aod::Collisions>(), jet, tracks, svIndices, df2);
-      sv2prongIndicesTableMCD(svIndices);
-    }
+    runCreatorJets<2, false, JetTracksMCDwPIs>(collision, mcdjets, sv2prongIndicesTableMCD, df2);
   }
   PROCESS_SWITCH(SecondaryVertexReconstruction, processMCD2Prongs, "Reconstruct the MCD 2-prong secondary vertex", false);
 
-  void processMCD2ProngsExternalMagneticField(JetCollisionwPIs::iterator const& collision, aod::Collisions const& /*realColl*/, soa::Join<aod::ChargedMCDetectorLevelJets, aod::ChargedMCDetectorLevelJetConstituents> const& mcdjets, JetTracksMCDwPIs const& tracks, OriginalTracks const& /*tracks*/)
+  void processMCD2ProngsExternalMagneticField(JetCollisionwPIs::iterator const& collision, aod::Collisions const& /*realColl*/, soa::Join<aod::ChargedMCDetectorLevelJets, aod::ChargedMCDetectorLevelJetConstituents> const& mcdjets, JetTracksMCDwPIs const& /*tracks*/, OriginalTracks const& /*tracks*/)
   {
-    for (const auto& jet : mcdjets) {
-      std::vector<int> svIndices;
-      runCreatorNProng<2, true>(collision.template collision_as<aod::Collisions>(), jet, tracks, svIndices, df2);
-      sv2prongIndicesTableMCD(svIndices);
-    }
+    runCreatorJets<2, true, JetTracksMCDwPIs>(collision, mcdjets, sv2prongIndicesTableMCD, df2);
   }
   PROCESS_SWITCH(SecondaryVertexReconstruction, processMCD2ProngsExternalMagneticField, "Reconstruct the MCD 2-prong secondary vertex with external magnetic field", false);
 };
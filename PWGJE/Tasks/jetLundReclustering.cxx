@@ -22,6 +22,7 @@
 #include "PWGJE/Core/JetFinder.h"
 #include "PWGJE/DataModel/Jet.h"
 #include "PWGJE/DataModel/JetReducedData.h"
+#include "PWGJE/DataModel/JetSubstructure.h"
 
 #include "Framework/ASoA.h"
 #include "Framework/AnalysisTask.h"
@@ -94,19 +95,25 @@ struct JetLundReclustering {
       if (j1.pt() < j2.pt()) {
         std::swap(j1, j2);
       }
-      double deltaR = j1.delta_R(j2);
-      double kt = j2.pt() * deltaR;
-      double z = j2.pt() / (j1.pt() + j2.pt());
-      double jetRadius = static_cast<double>(jet.r()) / 100.0;
-      double coord1 = std::log(jetRadius / deltaR);
-      double coord2 = std::log(kt);
-      double coord3 = std::log(1 / z);
-      registry.fill(HIST("PrimaryLundPlane_kT"), coord1, coord2, jet.pt());
-      registry.fill(HIST("PrimaryLundPlane_z"), coord1, coord3, jet.pt());
+      fillPrimaryLundPlane(jet, j1.pt(), j2.pt(), j1.delta_R(j2));
       pair = j1;
     }
   }
 
+  // Fill the primary Lund plane with one splitting of the primary branch
+  template <typename T>
+  void fillPrimaryLundPlane(T const& jet, double ptLeading, double ptSubLeading, double deltaR)
+  {
+    double kt = ptSubLeading * deltaR;
+    double z = ptSubLeading / (ptLeading + ptSubLeading);
+    double jetRadius = static_cast<double>(jet.r()) / 100.0;
+    double coord1 = std::log(jetRadius / deltaR);
+    double coord2 = std::log(kt);
+    double coord3 = std::log(1 / z);
+    registry.fill(HIST("PrimaryLundPlane_kT"), coord1, coord2, jet.pt());
+    registry.fill(HIST("PrimaryLundPlane_z"), coord1, coord3, jet.pt());
+  }
+
   // Dummy process
   void processDummy(aod::JetCollisions const&)
   {
@@ -132,6 +139,25 @@ struct JetLundReclustering {
     }
   }
   PROCESS_SWITCH(JetLundReclustering, processChargedJets, "Process function for charged jets", false);
+
+  // Process function for charged jets, reading the primary splittings already reclustered by the jet-substructure task
+  void processChargedJetsFromSubstructure(soa::Filtered<aod::JetCollisions>::iterator const& collision,
+                                          soa::Filtered<soa::Join<aod::ChargedJets, aod::CJetSSs>> const& jets)
+  {
+    if (!jetderiveddatautilities::selectCollision(collision, eventSelectionBits)) {
+      return;
+    }
+    for (const auto& jet : jets) {
+      registry.fill(HIST("jet_PtEtaPhi"), jet.pt(), jet.eta(), jet.phi());
+      auto ptLeading = jet.ptLeading();
+      auto ptSubLeading = jet.ptSubLeading();
+      auto theta = jet.theta();
+      for (size_t iSplitting = 0; iSplitting < theta.size(); iSplitting++) {
+        fillPrimaryLundPlane(jet, ptLeading[iSplitting], ptSubLeading[iSplitting], theta[iSplitting]);
+      }
+    }
+  }
+  PROCESS_SWITCH(JetLundReclustering, processChargedJetsFromSubstructure, "Process function for charged jets, using the splittings of the jet-substructure task", false);
 };
 
 WorkflowSpec defineDataProcessing(ConfigContext const& cfgc)
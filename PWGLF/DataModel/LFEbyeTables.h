@@ -12,6 +12,10 @@
 #include "Framework/AnalysisDataModel.h"
 #include "Framework/ASoAHelpers.h"
 
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
 #ifndef PWGLF_DATAMODEL_LFEBYETABLES_H_
 #define PWGLF_DATAMODEL_LFEBYETABLES_H_
 
@@ -147,6 +151,49 @@ DECLARE_SOA_TABLE(MiniTrkTables, "AOD", "MINITRKTABLE",
                   LFEbyeTable::OuterPID);
 using MiniTrkTable = MiniTrkTables::iterator;
 
+namespace LFEbyePacking
+{
+constexpr float PtScale{1.e-3f};       // GeV/c per unit of the packed signed pt
+constexpr float OuterPIDScale{1.e-3f}; // nSigma units per unit of the packed outer PID
+
+/// Quantise a value in units of scale, rounding to nearest and saturating at the limits of T
+template <typename T>
+T pack(float value, float scale)
+{
+  const float code = std::round(value / scale);
+  if (code <= static_cast<float>(std::numeric_limits<T>::min())) {
+    return std::numeric_limits<T>::min();
+  }
+  if (code >= static_cast<float>(std::numeric_limits<T>::max())) {
+    return std::numeric_limits<T>::max();
+  }
+  return static_cast<T>(code);
+}
+} // namespace LFEbyePacking
+
+namespace LFEbyePackedTable
+{
+DECLARE_SOA_COLUMN(PtPacked, ptPacked, int16_t);
+DECLARE_SOA_COLUMN(SelMask, selMask, uint16_t);
+DECLARE_SOA_COLUMN(OuterPIDPacked, outerPIDPacked, int16_t);
+DECLARE_SOA_DYNAMIC_COLUMN(Pt, pt, //! signed pt (GeV/c)
+                           [](int16_t ptPacked) -> float { return ptPacked * LFEbyePacking::PtScale; });
+DECLARE_SOA_DYNAMIC_COLUMN(OuterPID, outerPID, //! outer PID nSigma
+                           [](int16_t outerPIDPacked) -> float { return outerPIDPacked * LFEbyePacking::OuterPIDScale; });
+} // namespace LFEbyePackedTable
+
+// Same content as MiniTrkTables, with the pt and outer PID quantised to 16 bits
+DECLARE_SOA_TABLE(PackedMiniTrkTables, "AOD", "PMINITRKTABLE",
+                  o2::soa::Index<>,
+                  LFEbyeTable::MiniCollTableId,
+                  LFEbyePackedTable::PtPacked,
+                  LFEbyeTable::EtaMask,
+                  LFEbyePackedTable::SelMask,
+                  LFEbyePackedTable::OuterPIDPacked,
+                  LFEbyePackedTable::Pt<LFEbyePackedTable::PtPacked>,
+                  LFEbyePackedTable::OuterPID<LFEbyePackedTable::OuterPIDPacked>);
+using PackedMiniTrkTable = PackedMiniTrkTables::iterator;
+
 DECLARE_SOA_TABLE(McMiniTrkTables, "AOD", "MCMINITRKTABLE",
                   o2::soa::Index<>,
                   LFEbyeTable::MiniCollTableId,
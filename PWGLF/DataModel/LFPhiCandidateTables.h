@@ -0,0 +1,58 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+///
+/// \file LFPhiCandidateTables.h
+/// \brief Table of the Phi -> K+K- candidates of each collision, shared by the Phi correlation tasks
+///
+
+#ifndef PWGLF_DATAMODEL_LFPHICANDIDATETABLES_H_
+#define PWGLF_DATAMODEL_LFPHICANDIDATETABLES_H_
+
+#include <cstdint>
+
+#include "Framework/AnalysisDataModel.h"
+
+namespace o2::aod
+{
+namespace phicand
+{
+/// PID selections passed by the kaon daughters, the bits of the negative daughter follow those of the positive one
+enum PIDFlag : uint8_t {
+  kPosTPC = 0,     // |nSigmaTPC| below the TPC cut
+  kPosCombined,    // TOF available and TPC-TOF combined nSigma below the combined cut
+  kPosPtDependent, // TPC below pTToUseTOF, combined above
+  kNegTPC,
+  kNegCombined,
+  kNegPtDependent,
+  kNPIDFlags
+};
+
+DECLARE_SOA_INDEX_COLUMN(Collision, collision);                         //!
+DECLARE_SOA_INDEX_COLUMN_FULL(PosTrack, posTrack, int, Tracks, "_Pos"); //! positive kaon
+DECLARE_SOA_INDEX_COLUMN_FULL(NegTrack, negTrack, int, Tracks, "_Neg"); //! negative kaon
+DECLARE_SOA_COLUMN(M, m, float);                                        //! invariant mass
+DECLARE_SOA_COLUMN(Pt, pt, float);                                      //! transverse momentum
+DECLARE_SOA_COLUMN(Y, y, float);                                        //! rapidity
+DECLARE_SOA_COLUMN(Phi, phi, float);                                    //! azimuthal angle
+DECLARE_SOA_COLUMN(PIDFlags, pidFlags, uint8_t);                        //! bits of PIDFlag
+
+DECLARE_SOA_DYNAMIC_COLUMN(HasPIDFlag, hasPIDFlag, //! check one of the PID bits
+                           [](uint8_t pidFlags, int flag) -> bool { return (pidFlags >> flag) & 1; });
+} // namespace phicand
+
+DECLARE_SOA_TABLE(PhiCands, "AOD", "PHICANDS", //! Phi -> K+K- candidates within the mass window
+                  o2::soa::Index<>, phicand::CollisionId, phicand::PosTrackId, phicand::NegTrackId,
+                  phicand::M, phicand::Pt, phicand::Y, phicand::Phi, phicand::PIDFlags,
+                  phicand::HasPIDFlag<phicand::PIDFlags>);
+using PhiCand = PhiCands::iterator;
+} // namespace o2::aod
+
+#endif // PWGLF_DATAMODEL_LFPHICANDIDATETABLES_H_
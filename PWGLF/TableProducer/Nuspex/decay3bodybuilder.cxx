@@ -621,6 +621,7 @@ struct decay3bodyBuilder {
       return;
     }
     mRunNumber = runNumber; // Update the last run number
+    helper.clearKFCache();
 
     // update propagator
     o2::base::Propagator::Instance()->setNominalBz(magField);
@@ -652,6 +653,7 @@ struct decay3bodyBuilder {
       LOG(info) << "No request for candidate analysis table in place, skipping candidate building." << std::endl;
       return; // don't do if no request for decay3bodys in place
     }
+    helper.clearKFCache(); // track and collision indices are valid within the DF
 
     // prepare MC container (not necessarily used)
     std::vector<bool> mcParticleIsReco;
@@ -988,6 +990,7 @@ struct decay3bodyBuilder {
     if (!mEnabledTables[kVtx3BodyDatas]) {
       return; // don't do if no request for decay3bodys in place
     }
+    helper.clearKFCache(); // track and collision indices are valid within the DF
 
     // Strictly upper index policy for decay3body objects binned by radius, phi
     for (const auto& [decay3body0, decay3body1] : selfPairCombinations(binningType, mixingOpts.n3bodyMixing, -1, decay3bodys)) {
@@ -210,6 +210,7 @@ struct EbyeMaker {
   Produces<aod::NucleiEbyeTable> nucleiEbyeTable;
   Produces<aod::LambdaEbyeTable> lambdaEbyeTable;
   Produces<aod::MiniTrkTable> miniTrkTable;
+  Produces<aod::PackedMiniTrkTable> packedMiniTrkTable;
   Produces<aod::McNucleiEbyeTable> mcNucleiEbyeTable;
   Produces<aod::McLambdaEbyeTable> mcLambdaEbyeTable;
   Produces<aod::McMiniTrkTable> mcMiniTrkTable;
@@ -249,6 +250,7 @@ struct EbyeMaker {
   Configurable<float> outerPIDMin{"outerPIDMin", -4.f, "minimum outer PID"};
 
   Configurable<bool> storeTracksNum{"storeTracksNum", false, "store the number of tracks instead of tracklets"};
+  Configurable<bool> storePackedMiniTracks{"storePackedMiniTracks", false, "store the mini track table with the pt and outer PID packed in 16-bit integers"};
   Configurable<std::string> genName{"genname", "", "Genearator name: HIJING, PYTHIA8, ... Default: \"\""};
 
   Configurable<uint8_t> triggerCut{"triggerCut", 0x0, "trigger cut to select"};
@@ -1263,6 +1265,15 @@ struct EbyeMaker {
         int selMask = getTrackSelMask(candidateTrack);
         if (candidateTrack.outerPID < outerPIDMin)
           continue;
+        if (storePackedMiniTracks) {
+          packedMiniTrkTable(
+            miniCollTable.lastIndex(),
+            aod::LFEbyePacking::pack<int16_t>(candidateTrack.pt, aod::LFEbyePacking::PtScale),
+            static_cast<int8_t>(candidateTrack.eta * 100),
+            static_cast<uint16_t>(selMask),
+            aod::LFEbyePacking::pack<int16_t>(candidateTrack.outerPID, aod::LFEbyePacking::OuterPIDScale));
+          continue;
+        }
         miniTrkTable(
           miniCollTable.lastIndex(),
           candidateTrack.pt,
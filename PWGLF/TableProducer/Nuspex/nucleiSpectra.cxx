@@ -333,6 +333,10 @@ struct nucleiSpectra {
   int mRunNumber = 0;
   float mBz = 0.f;
 
+  // Bethe-Bloch parameters and beta*gamma scalings (per charge) of the species, copied from the configurables in init
+  double mBetheBlochParams[nuclei::species][6];
+  double mBgScalings[nuclei::species][2];
+
   using TrackCandidates = soa::Join<aod::TracksIU, aod::TracksCovIU, aod::TracksExtra, aod::TOFSignal, aod::TOFEvTime>;
 
   // Collisions with chentrality
@@ -447,8 +451,27 @@ struct nucleiSpectra {
     LOGF(info, "Retrieved GRP for timestamp %ull (%i) with magnetic field of %1.2f kZG", timestamp, mRunNumber, mBz);
   }
 
+  /// TPC nSigma of the species with the custom Bethe-Bloch parametrisation
+  double customTpcNsigma(int iS, double betaGamma, float tpcSignal) const
+  {
+    const double* par{mBetheBlochParams[iS]};
+    const double expBethe{tpc::BetheBlochAleph(betaGamma, par[0], par[1], par[2], par[3], par[4])};
+    const double expSigma{expBethe * par[5]};
+    return (tpcSignal - expBethe) / expSigma;
+  }
+
   void init(o2::framework::InitContext&)
   {
+    for (int iS{0}; iS < nuclei::species; ++iS) {
+      for (int iPar{0}; iPar < 6; ++iPar) {
+        mBetheBlochParams[iS][iPar] = cfgBetheBlochParams->get(iS, iPar);
+      }
+      const int iScaling{std::min(iS, 3)}; /// the alpha uses the scaling of the He3
+      for (int iC{0}; iC < 2; ++iC) {
+        mBgScalings[iS][iC] = nuclei::charges[iS] * cfgMomentumScalingBetheBloch->get(iScaling, iC) / nuclei::masses[iS];
+      }
+    }
+
     zorroSummary.setObject(zorro.getZorroSummary());
     zorro.setBaseCCDBPath(cfgZorroCCDBpath.value);
     ccdb->setURL(cfgCCDBurl);
@@ -595,13 +618,6 @@ struct nucleiSpectra {
 
     float centrality = getCentrality(collision);
 
-    const double bgScalings[5][2]{
-      {nuclei::charges[0] * cfgMomentumScalingBetheBloch->get(0u, 0u) / nuclei::masses[0], nuclei::charges[0] * cfgMomentumScalingBetheBloch->get(0u, 1u) / nuclei::masses[0]},
-      {nuclei::charges[1] * cfgMomentumScalingBetheBloch->get(1u, 0u) / nuclei::masses[1], nuclei::charges[1] * cfgMomentumScalingBetheBloch->get(1u, 1u) / nuclei::masses[1]},
-      {nuclei::charges[2] * cfgMomentumScalingBetheBloch->get(2u, 0u) / nuclei::masses[2], nuclei::charges[2] * cfgMomentumScalingBetheBloch->get(2u, 1u) / nuclei::masses[2]},
-      {nuclei::charges[3] * cfgMomentumScalingBetheBloch->get(3u, 0u) / nuclei::masses[3], nuclei::charges[3] * cfgMomentumScalingBetheBloch->get(3u, 1u) / nuclei::masses[3]},
-      {nuclei::charges[4] * cfgMomentumScalingBetheBloch->get(3u, 0u) / nuclei::masses[4], nuclei::charges[4] * cfgMomentumScalingBetheBloch->get(3u, 1u) / nuclei::masses[4]}};
-
     int nGloTracks[2]{0, 0}, nTOFTracks[2]{0, 0};
     for (auto& track : tracks) { // start loop over tracks
       if (std::abs(track.eta()) > cfgCutEta ||
@@ -633,9 +649,7 @@ struct nucleiSpectra {
       bool selectedTPC[5]{false}, goodToAnalyse{false};
       std::array<float, 5> nSigmaTPC;
       for (int iS{0}; iS < nuclei::species; ++iS) {
-        double expBethe{tpc::BetheBlochAleph(static_cast<double>(correctedTpcInnerParam * bgScalings[iS][iC]), cfgBetheBlochParams->get(iS, 0u), cfgBetheBlochParams->get(iS, 1u), cfgBetheBlochParams->get(iS, 2u), cfgBetheBlochParams->get(iS, 3u), cfgBetheBlochParams->get(iS, 4u))};
-        double expSigma{expBethe * cfgBetheBlochParams->get(iS, 5u)};
-        nSigma[0][iS] = static_cast<float>((track.tpcSignal() - expBethe) / expSigma);
+        nSigma[0][iS] = static_cast<float>(customTpcNsigma(iS, correctedTpcInnerParam * mBgScalings[iS][iC], track.tpcSignal()));
         nSigmaTPC[iS] = nSigma[0][iS];
         selectedTPC[iS] = (nSigma[0][iS] > nuclei::pidCuts[0][iS][0] && nSigma[0][iS] < nuclei::pidCuts[0][iS][1]);
         goodToAnalyse = goodToAnalyse || selectedTPC[iS];
@@ -1032,9 +1046,7 @@ struct nucleiSpectra {
           track.itsChi2NCl() > 36.f) {
         continue;
       }
-      double expBethe{tpc::BetheBlochAleph(static_cast<double>(track.tpcInnerParam() * 2. / o2::constants::physics::MassHelium3), cfgBetheBlochParams->get(4, 0u), cfgBetheBlochParams->get(4, 1u), cfgBetheBlochParams->get(4, 2u), cfgBetheBlochParams->get(4, 3u), cfgBetheBlochParams->get(4, 4u))};
-      double expSigma{expBethe * cfgBetheBlochParams->get(4, 5u)};
-      double nSigmaTPC{(track.tpcSignal() - expBethe) / expSigma};
+      double nSigmaTPC{customTpcNsigma(4, track.tpcInnerParam() * 2. / o2::constants::physics::MassHelium3, track.tpcSignal())};
       int iC = track.signed1Pt() > 0;
       const float pt = track.pt();
       const float phi = 2.f * RecoDecay::constrainAngle(track.phi() - collision.psiFT0C(), 0.f, 2);
@@ -26,6 +26,8 @@
 /// \author Bong-Hwi Lim <bong-hwi.lim@cern.ch>
 ///         Nasir Mehdi Malik <nasir.mehdi.malik@cern.ch>
 ///         Min-jae Kim <minjae.kim@cern.ch>
+#include <array>
+#include <tuple>
 #include <vector>
 
 #include "Common/DataModel/PIDResponse.h"
@@ -62,6 +64,7 @@ using namespace o2::soa;
 struct ResonanceMergeDF {
   //  SliceCache cache;
   Configurable<int> nDF{"nDF", 1, "no of combination of collision"};
+  Configurable<int> maxBufferedTracks{"maxBufferedTracks", 0, "write the merged collisions also when this number of tracks is buffered, to bound the memory (0 = only after nDF collisions)"};
   Configurable<bool> cpidCut{"cpidCut", 0, "pid cut"};
   Configurable<bool> crejtpc{"crejtpc", 0, "reject electron pion"};
   Configurable<bool> crejtof{"crejtof", 0, "reject electron pion tof"};
@@ -96,38 +99,37 @@ struct ResonanceMergeDF {
   Produces<aod::ResoCascadeDFs> reso2cascadesdf;
   int df = 0;
 
-  std::vector<std::tuple<float, float, float, float, float, float, int>> vecOfTuples;
-  std::vector<std::vector<std::tuple<float, float, float, float,
-                                     unsigned char, unsigned char,
-                                     int16_t, int16_t, int8_t, int8_t, int8_t,
-                                     int8_t, int8_t, int8_t, float,
-                                     uint8_t>>>
-    vecOfVecOfTuples;
-  std::vector<std::vector<std::tuple<float, float, float, float,
-                                     int*,
-                                     int8_t, int8_t, int8_t, // TPC Pos Trk
-                                     int8_t, int8_t, int8_t, // TPC Neg Trk
-                                     int8_t, int8_t, int8_t, // TPC Bach Trk
-                                     int8_t, int8_t, int8_t, // TOF Pos Trk
-                                     int8_t, int8_t, int8_t, // TOF Neg Trk
-                                     int8_t, int8_t, int8_t, // TOF Bach Trk
-                                     float, float, float, float,
-                                     float, float, float, float,
-                                     float, float, int, float,
-                                     float, float, float,
-                                     float, float, float>>>
-    vecOfVecOfTuplesCasc;
-  void processTrackDataDF(aod::ResoCollisions::iterator const& collision, aod::ResoTracks const& tracks)
+  using CollisionTuple = std::tuple<float, float, float, float, float, float, int>;
+  using TrackTuple = std::tuple<float, float, float, float,
+                                unsigned char, unsigned char,
+                                int16_t, int16_t, int8_t, int8_t, int8_t,
+                                int8_t, int8_t, int8_t, float,
+                                uint8_t>;
+  using CascadeTuple = std::tuple<float, float, float, float,
+                                  std::array<int, 3>,     // copied, the input table is gone when the buffers are flushed
+                                  int8_t, int8_t, int8_t, // TPC Pos Trk
+                                  int8_t, int8_t, int8_t, // TPC Neg Trk
+                                  int8_t, int8_t, int8_t, // TPC Bach Trk
+                                  int8_t, int8_t, int8_t, // TOF Pos Trk
+                                  int8_t, int8_t, int8_t, // TOF Neg Trk
+                                  int8_t, int8_t, int8_t, // TOF Bach Trk
+                                  float, float, float, float,
+                                  float, float, float, float,
+                                  float, float, int, float,
+                                  float, float, float,
+                                  float, float, float>;
+
+  // buffered collisions, with their tracks and cascades stored contiguously; the vectors are cleared but keep their capacity after each flush
+  std::vector<CollisionTuple> bufferedCollisions;
+  std::vector<TrackTuple> bufferedTracks;
+  std::vector<size_t> bufferedTracksBegin; // first buffered track of each collision
+  std::vector<CascadeTuple> bufferedCascades;
+  std::vector<size_t> bufferedCascadesBegin; // first buffered cascade of each collision
+
+  template <typename T>
+  void bufferTracks(T const& tracks)
   {
-
-    int nCollisions = nDF;
-    vecOfTuples.push_back(std::make_tuple(collision.posX(), collision.posY(), collision.posZ(), collision.cent(), 0, 0, 0));
-    std::vector<std::tuple<float, float, float, float,
-                           unsigned char, unsigned char,
-                           int16_t, int16_t, int8_t, int8_t, int8_t,
-                           int8_t, int8_t, int8_t, float,
-                           uint8_t>>
-      innerVector;
+    bufferedTracksBegin.push_back(bufferedTracks.size());
     for (const auto& track : tracks) {
       if (cpidCut) {
         if (!track.hasTOF()) {
@@ -151,7 +153,7 @@ struct ResonanceMergeDF {
           continue;
       }
 
-      innerVector.push_back(std::make_tuple(
+      bufferedTracks.emplace_back(
         //  track.trackId(),
         track.pt(),
         track.px(),
@@ -168,127 +170,22 @@ struct ResonanceMergeDF {
         (int8_t)(track.tofNSigmaKa() * 10),
         (int8_t)(track.tofNSigmaPr() * 10),
         (int8_t)(track.tpcSignal() * 10),
-        track.trackFlags()));
-    }
-
-    vecOfVecOfTuples.push_back(innerVector);
-    innerVector.clear();
-    df++;
-    LOGF(info, "collisions: df = %i", df);
-    if (df < nCollisions)
-      return;
-    df = 0;
-
-    for (size_t i = 0; i < vecOfTuples.size(); ++i) {
-      const auto& tuple = vecOfTuples[i];
-      const auto& innerVector = vecOfVecOfTuples[i];
-
-      histos.fill(HIST("Event/h1d_ft0_mult_percentile"), std::get<3>(tuple));
-      resoCollisionsdf(0, std::get<0>(tuple), std::get<1>(tuple), std::get<2>(tuple), std::get<3>(tuple), std::get<4>(tuple), std::get<5>(tuple), 0., 0., 0., 0., 0, std::get<6>(tuple));
-      //  LOGF(info, "collisions: Index = %d ) %f - %f - %f %f %d -- %d", std::get<0>(tuple).globalIndex(),std::get<1>(tuple),std::get<2>(tuple), std::get<3>(tuple), std::get<4>(tuple), std::get<5>(tuple).size(),resoCollisionsdf.lastIndex());
-
-      for (const auto& tuple : innerVector) {
-        reso2trksdf(resoCollisionsdf.lastIndex(),
-                    std::get<0>(tuple),
-                    std::get<1>(tuple),
-                    std::get<2>(tuple),
-                    std::get<3>(tuple),
-                    std::get<4>(tuple),
-                    std::get<5>(tuple),
-                    std::get<6>(tuple),
-                    std::get<7>(tuple),
-                    std::get<8>(tuple),
-                    std::get<9>(tuple),
-                    std::get<10>(tuple),
-                    std::get<11>(tuple),
-                    std::get<12>(tuple),
-                    std::get<13>(tuple),
-                    std::get<14>(tuple),
-                    std::get<15>(tuple));
-      }
+        track.trackFlags());
     }
-
-    vecOfTuples.clear();
-    vecOfVecOfTuples.clear();
   }
 
-  PROCESS_SWITCH(ResonanceMergeDF, processTrackDataDF, "Process for data merged DF", true);
-
-  void processTrackDataDFCasc(aod::ResoCollisions::iterator const& collision, aod::ResoTracks const& tracks, aod::ResoCascades const& trackCascs)
+  template <typename T>
+  void bufferCascades(T const& trackCascs)
   {
-
-    int nCollisions = nDF;
-    vecOfTuples.push_back(std::make_tuple(collision.posX(), collision.posY(), collision.posZ(), collision.cent(), 0, 0, 0));
-    std::vector<std::tuple<float, float, float, float,
-                           unsigned char, unsigned char,
-                           int16_t, int16_t, int8_t, int8_t, int8_t,
-                           int8_t, int8_t, int8_t, float,
-                           uint8_t>>
-      innerVector;
-    std::vector<std::tuple<float, float, float, float,
-                           int*,
-                           int8_t, int8_t, int8_t, // TPC Pos Trk
-                           int8_t, int8_t, int8_t, // TPC Neg Trk
-                           int8_t, int8_t, int8_t, // TPC Bach Trk
-                           int8_t, int8_t, int8_t, // TOF Pos Trk
-                           int8_t, int8_t, int8_t, // TOF Neg Trk
-                           int8_t, int8_t, int8_t, // TOF Bach Trk
-                           float, float, float, float,
-                           float, float, float, float,
-                           float, float, int, float,
-                           float, float, float,
-                           float, float, float>>
-      innerVectorCasc;
-    for (const auto& track : tracks) {
-      if (cpidCut) {
-        if (!track.hasTOF()) {
-          if (std::abs(track.tpcNSigmaPr()) > nsigmaPr && std::abs(track.tpcNSigmaKa()) > nsigmaKa)
-            continue;
-
-          if (crejtpc && (std::abs(track.tpcNSigmaPr()) > std::abs(track.tpcNSigmaPi()) && std::abs(track.tpcNSigmaKa()) > std::abs(track.tpcNSigmaPi())))
-            continue;
-
-        } else {
-          if (std::abs(track.tofNSigmaPr()) > nsigmatofPr && std::abs(track.tofNSigmaKa()) > nsigmatofKa)
-            continue;
-
-          if (crejtof && (std::abs(track.tofNSigmaPr()) > std::abs(track.tofNSigmaPi()) && std::abs(track.tofNSigmaKa()) > std::abs(track.tofNSigmaPi())))
-            continue;
-        }
-
-        if (std::abs(track.dcaXY()) > cDCAXY)
-          continue;
-        if (std::abs(track.dcaZ()) > cDCAZ)
-          continue;
-      }
-
-      innerVector.push_back(std::make_tuple(
-        //  track.trackId(),
-        track.pt(),
-        track.px(),
-        track.py(),
-        track.pz(),
-        (uint8_t)track.tpcNClsCrossedRows(),
-        (uint8_t)track.tpcNClsFound(),
-        static_cast<int16_t>(track.dcaXY() * 10000),
-        static_cast<int16_t>(track.dcaZ() * 10000),
-        (int8_t)(track.tpcNSigmaPi() * 10),
-        (int8_t)(track.tpcNSigmaKa() * 10),
-        (int8_t)(track.tpcNSigmaPr() * 10),
-        (int8_t)(track.tofNSigmaPi() * 10),
-        (int8_t)(track.tofNSigmaKa() * 10),
-        (int8_t)(track.tofNSigmaPr() * 10),
-        (int8_t)(track.tpcSignal() * 10),
-        track.trackFlags()));
-    }
-
+    bufferedCascadesBegin.push_back(bufferedCascades.size());
     for (const auto& trackCasc : trackCascs) {
-      innerVectorCasc.push_back(std::make_tuple(
+      const int* cascadeIndices = trackCasc.cascadeIndices();
+      bufferedCascades.emplace_back(
         trackCasc.pt(),
         trackCasc.px(),
         trackCasc.py(),
         trackCasc.pz(),
-        const_cast<int*>(trackCasc.cascadeIndices()),
+        std::array<int, 3>{cascadeIndices[0], cascadeIndices[1], cascadeIndices[2]},
         (int8_t)(trackCasc.daughterTPCNSigmaPosPi() * 10),
         (int8_t)(trackCasc.daughterTPCNSigmaPosKa() * 10),
         (int8_t)(trackCasc.daughterTPCNSigmaPosPr() * 10),
@@ -320,100 +217,62 @@ struct ResonanceMergeDF {
         trackCasc.sign(),
         trackCasc.mLambda(),
         trackCasc.mXi(),
-        trackCasc.transRadius(), trackCasc.cascTransRadius(), trackCasc.decayVtxX(), trackCasc.decayVtxY(), trackCasc.decayVtxZ()));
+        trackCasc.transRadius(), trackCasc.cascTransRadius(), trackCasc.decayVtxX(), trackCasc.decayVtxY(), trackCasc.decayVtxZ());
     }
+  }
 
-    vecOfVecOfTuples.push_back(innerVector);
-    vecOfVecOfTuplesCasc.push_back(innerVectorCasc);
-    innerVector.clear();
-    innerVectorCasc.clear();
-
+  /// Write the buffered collisions once nDF of them are collected, or earlier when the buffered tracks reach maxBufferedTracks
+  void flushBuffers(bool withCascades)
+  {
     df++;
-    LOGF(info, "collisions: df = %i", df);
-    if (df < nCollisions)
+    LOGF(debug, "collisions: df = %i", df);
+    if (df < nDF && (maxBufferedTracks <= 0 || bufferedTracks.size() < static_cast<size_t>(maxBufferedTracks.value)))
       return;
     df = 0;
 
-    for (size_t i = 0; i < vecOfTuples.size(); ++i) {
-      const auto& tuple = vecOfTuples[i];
-      const auto& innerVector = vecOfVecOfTuples[i];
-      const auto& innerVectorCasc = vecOfVecOfTuplesCasc[i];
+    for (size_t i = 0; i < bufferedCollisions.size(); ++i) {
+      const auto& tuple = bufferedCollisions[i];
 
       histos.fill(HIST("Event/h1d_ft0_mult_percentile"), std::get<3>(tuple));
       resoCollisionsdf(0, std::get<0>(tuple), std::get<1>(tuple), std::get<2>(tuple), std::get<3>(tuple), std::get<4>(tuple), std::get<5>(tuple), 0., 0., 0., 0., 0, std::get<6>(tuple));
-      //  LOGF(info, "collisions: Index = %d ) %f - %f - %f %f %d -- %d", std::get<0>(tuple).globalIndex(),std::get<1>(tuple),std::get<2>(tuple), std::get<3>(tuple), std::get<4>(tuple), std::get<5>(tuple).size(),resoCollisionsdf.lastIndex());
-
-      for (const auto& tuple : innerVector) {
-        reso2trksdf(resoCollisionsdf.lastIndex(),
-                    std::get<0>(tuple),
-                    std::get<1>(tuple),
-                    std::get<2>(tuple),
-                    std::get<3>(tuple),
-                    std::get<4>(tuple),
-                    std::get<5>(tuple),
-                    std::get<6>(tuple),
-                    std::get<7>(tuple),
-                    std::get<8>(tuple),
-                    std::get<9>(tuple),
-                    std::get<10>(tuple),
-                    std::get<11>(tuple),
-                    std::get<12>(tuple),
-                    std::get<13>(tuple),
-                    std::get<14>(tuple),
-                    std::get<15>(tuple));
+
+      const size_t tracksEnd = i + 1 < bufferedCollisions.size() ? bufferedTracksBegin[i + 1] : bufferedTracks.size();
+      for (size_t iTrack = bufferedTracksBegin[i]; iTrack < tracksEnd; ++iTrack) {
+        std::apply([&](auto const&... columns) { reso2trksdf(resoCollisionsdf.lastIndex(), columns...); }, bufferedTracks[iTrack]);
       }
 
-      for (const auto& tuple : innerVectorCasc) {
-        reso2cascadesdf(resoCollisionsdf.lastIndex(),
-                        std::get<0>(tuple),
-                        std::get<1>(tuple),
-                        std::get<2>(tuple),
-                        std::get<3>(tuple),
-                        std::get<4>(tuple),
-                        std::get<5>(tuple),
-                        std::get<6>(tuple),
-                        std::get<7>(tuple),
-                        std::get<8>(tuple),
-                        std::get<9>(tuple),
-                        std::get<10>(tuple),
-                        std::get<11>(tuple),
-                        std::get<12>(tuple),
-                        std::get<13>(tuple),
-                        std::get<14>(tuple),
-                        std::get<15>(tuple),
-                        std::get<16>(tuple),
-                        std::get<17>(tuple),
-                        std::get<18>(tuple),
-                        std::get<19>(tuple),
-                        std::get<20>(tuple),
-                        std::get<21>(tuple),
-                        std::get<22>(tuple),
-                        std::get<23>(tuple),
-                        std::get<24>(tuple),
-                        std::get<25>(tuple),
-                        std::get<26>(tuple),
-                        std::get<27>(tuple),
-                        std::get<28>(tuple),
-                        std::get<29>(tuple),
-                        std::get<30>(tuple),
-                        std::get<31>(tuple),
-                        std::get<32>(tuple),
-                        std::get<33>(tuple),
-                        std::get<34>(tuple),
-                        std::get<35>(tuple),
-                        std::get<36>(tuple),
-                        std::get<37>(tuple),
-                        std::get<38>(tuple),
-                        std::get<39>(tuple),
-                        std::get<40>(tuple));
+      if (withCascades) {
+        const size_t cascadesEnd = i + 1 < bufferedCollisions.size() ? bufferedCascadesBegin[i + 1] : bufferedCascades.size();
+        for (size_t iCasc = bufferedCascadesBegin[i]; iCasc < cascadesEnd; ++iCasc) {
+          auto& casc = bufferedCascades[iCasc];
+          std::apply([&](auto const& pt, auto const& px, auto const& py, auto const& pz, auto& cascadeIndices, auto const&... columns) { reso2cascadesdf(resoCollisionsdf.lastIndex(), pt, px, py, pz, cascadeIndices.data(), columns...); }, casc);
+        }
       }
     }
 
-    vecOfTuples.clear();
-    vecOfVecOfTuples.clear();
-    vecOfVecOfTuplesCasc.clear(); //
+    bufferedCollisions.clear();
+    bufferedTracks.clear();
+    bufferedTracksBegin.clear();
+    bufferedCascades.clear();
+    bufferedCascadesBegin.clear();
   }
 
+  void processTrackDataDF(aod::ResoCollisions::iterator const& collision, aod::ResoTracks const& tracks)
+  {
+    bufferedCollisions.emplace_back(collision.posX(), collision.posY(), collision.posZ(), collision.cent(), 0, 0, 0);
+    bufferTracks(tracks);
+    flushBuffers(false);
+  }
+
+  PROCESS_SWITCH(ResonanceMergeDF, processTrackDataDF, "Process for data merged DF", true);
+
+  void processTrackDataDFCasc(aod::ResoCollisions::iterator const& collision, aod::ResoTracks const& tracks, aod::ResoCascades const& trackCascs)
+  {
+    bufferedCollisions.emplace_back(collision.posX(), collision.posY(), collision.posZ(), collision.cent(), 0, 0, 0);
+    bufferTracks(tracks);
+    bufferCascades(trackCascs);
+    flushBuffers(true);
+  }
   PROCESS_SWITCH(ResonanceMergeDF, processTrackDataDFCasc, "Process for data merged DF for cascade", false);
 
   void processLambdaStarCandidate(aod::ResoCollisions::iterator const& collision, aod::ResoTracks const& tracks)
@@ -22,6 +22,7 @@
 
 #include <Math/Vector4D.h>
 #include <cmath>
+#include <algorithm>
 #include <array>
 #include <cstdlib>
 
@@ -51,6 +52,7 @@
 #include <TDatabasePDG.h>
 #include "Tools/ML/MlResponse.h"
 #include "Tools/ML/model.h"
+#include "PWGLF/Utils/strangenessMlEvaluator.h"
 
 using namespace o2;
 using namespace o2::analysis;
@@ -83,7 +85,7 @@ struct cascademlselection {
   // CCDB configuration
   o2::ccdb::CcdbApi ccdbApi;
   Service<o2::ccdb::BasicCCDBManager> ccdb;
-  int mRunNumber;
+  int mRunNumber = 0;
 
   // CCDB options
   struct : ConfigurableGroup {
@@ -121,6 +123,23 @@ struct cascademlselection {
     Configurable<float> thresholdOmegaPlus{"mlConfigurations.thresholdOmegaPlus", -1.0f, "Threshold to keep OmegaPlus candidates"};
   } mlConfigurations;
 
+  // Cheap topological prefilter: the candidates failing it are not evaluated and get a score of -1
+  struct : ConfigurableGroup {
+    Configurable<float> cascradius{"prefilter.cascradius", 0.0f, "minimum cascade radius (cm)"};
+    Configurable<float> v0radius{"prefilter.v0radius", 0.0f, "minimum V0 radius (cm)"};
+    Configurable<float> dcacascdau{"prefilter.dcacascdau", 1e+6f, "maximum DCA between the cascade daughters (cm)"};
+    Configurable<float> dcav0dau{"prefilter.dcav0dau", 1e+6f, "maximum DCA between the V0 daughters (cm)"};
+  } prefilter;
+
+  // models evaluated in batch over the candidates of the dataframe
+  enum mlModels { kXiMinusModel = 0,
+                  kXiPlusModel,
+                  kOmegaMinusModel,
+                  kOmegaPlusModel,
+                  kNMlModels };
+  static constexpr std::size_t nFeatures = 4;
+  o2::pwglf::strangenessMlEvaluator mlEvaluator;
+
   // Axis
   // base properties
   ConfigurableAxis vertexZ{"vertexZ", {30, -15.0f, 15.0f}, ""};
@@ -221,71 +240,112 @@ struct cascademlselection {
     ccdb->setURL(ccdbConfigurations.ccdburl);
   }
 
-  // Process candidate and store properties in object
   template <typename TCascObject>
-  void processCandidate(TCascObject const& cand)
+  bool passesPrefilter(TCascObject const& cand)
+  {
+    return cand.cascradius() > prefilter.cascradius &&
+           cand.v0radius() > prefilter.v0radius &&
+           cand.dcacascdaughters() < prefilter.dcacascdau &&
+           cand.dcaV0daughters() < prefilter.dcav0dau;
+  }
+
+  template <typename TCollision>
+  int runNumberOf(TCollision const& collision)
   {
-    // Select features
-    // FIXME THIS NEEDS ADJUSTING
-    std::vector<float> inputFeatures{0.0f, 0.0f,
-                                     0.0f, 0.0f};
+    if constexpr (requires { collision.runNumber(); }) { // we are in derived data
+      return collision.runNumber();
+    } else {
+      return collision.template bc_as<aod::BCsWithTimestamps>().runNumber();
+    }
+  }
 
-    // calculate scores
+  // models scoring the candidate, as a mask of the mlModels bits
+  template <typename TCascObject>
+  uint32_t modelsFor(TCascObject const& cand)
+  {
+    uint32_t models = 0;
     if (cand.sign() < 0) {
-      if (mlConfigurations.calculateXiMinusScores) {
-        float* xiMinusProbability = mlModelXiMinus.evalModel(inputFeatures);
-        xiMLSelections(xiMinusProbability[1]);
-      } else {
-        xiMLSelections(-1);
-      }
-      if (mlConfigurations.calculateOmegaMinusScores) {
-        float* omegaMinusProbability = mlModelOmegaMinus.evalModel(inputFeatures);
-        omegaMLSelections(omegaMinusProbability[1]);
-      } else {
-        omegaMLSelections(-1);
-      }
+      models |= mlConfigurations.calculateXiMinusScores ? 1u << kXiMinusModel : 0u;
+      models |= mlConfigurations.calculateOmegaMinusScores ? 1u << kOmegaMinusModel : 0u;
     }
     if (cand.sign() > 0) {
-      if (mlConfigurations.calculateXiPlusScores) {
-        float* xiPlusProbability = mlModelXiPlus.evalModel(inputFeatures);
-        xiMLSelections(xiPlusProbability[1]);
-      } else {
-        xiMLSelections(-1);
-      }
-      if (mlConfigurations.calculateOmegaPlusScores) {
-        float* omegaPlusProbability = mlModelOmegaPlus.evalModel(inputFeatures);
-        omegaMLSelections(omegaPlusProbability[1]);
-      } else {
-        omegaMLSelections(-1);
-      }
+      models |= mlConfigurations.calculateXiPlusScores ? 1u << kXiPlusModel : 0u;
+      models |= mlConfigurations.calculateOmegaPlusScores ? 1u << kOmegaPlusModel : 0u;
     }
+    return models;
   }
 
-  void processDerivedData(soa::Join<aod::StraCollisions, aod::StraStamps>::iterator const& collision, CascDerivedDatas const& cascades)
+  // evaluates the rows added with the models currently loaded
+  void evaluateModels()
   {
-    initCCDB(collision);
-
-    histos.fill(HIST("hEventVertexZ"), collision.posZ());
-    for (auto& casc : cascades) {
-      nCandidates++;
-      if (nCandidates % 50000 == 0) {
-        LOG(info) << "Candidates processed: " << nCandidates;
-      }
-      processCandidate(casc);
+    if (mlConfigurations.calculateXiMinusScores) {
+      mlEvaluator.evaluate(kXiMinusModel, mlModelXiMinus);
     }
+    if (mlConfigurations.calculateXiPlusScores) {
+      mlEvaluator.evaluate(kXiPlusModel, mlModelXiPlus);
+    }
+    if (mlConfigurations.calculateOmegaMinusScores) {
+      mlEvaluator.evaluate(kOmegaMinusModel, mlModelOmegaMinus);
+    }
+    if (mlConfigurations.calculateOmegaPlusScores) {
+      mlEvaluator.evaluate(kOmegaPlusModel, mlModelOmegaPlus);
+    }
+    mlEvaluator.clearRows();
   }
-  void processStandardData(aod::Collision const& collision, CascOriginalDatas const& cascades)
+
+  // Process the candidates of the dataframe: the features are extracted once per candidate
+  // and every model is evaluated in batch over its candidates, per run as the models depend on it
+  template <typename TCollisions, typename TCascObjects>
+  void processCandidates(TCollisions const& collisions, TCascObjects const& cands)
   {
-    initCCDB(collision);
+    for (auto const& collision : collisions) {
+      histos.fill(HIST("hEventVertexZ"), collision.posZ());
+    }
 
-    histos.fill(HIST("hEventVertexZ"), collision.posZ());
-    for (auto& casc : cascades) {
+    mlEvaluator.reset(kNMlModels, cands.size(), nFeatures);
+    int iCandidate = 0;
+    for (auto const& cand : cands) {
       nCandidates++;
       if (nCandidates % 50000 == 0) {
         LOG(info) << "Candidates processed: " << nCandidates;
       }
-      processCandidate(casc);
+      uint32_t models = modelsFor(cand);
+      if (models != 0 && passesPrefilter(cand)) {
+        auto collision = [&]() {
+          if constexpr (requires { cand.straCollisionId(); }) { // we are in derived data
+            return cand.template straCollision_as<TCollisions>();
+          } else {
+            return cand.template collision_as<TCollisions>();
+          }
+        }();
+        if (mlEvaluator.nRows() > 0 && runNumberOf(collision) != mRunNumber) {
+          // the models are about to be reloaded: evaluate the pending rows with the current ones
+          evaluateModels();
+        }
+        initCCDB(collision);
+        // Select features
+        // FIXME THIS NEEDS ADJUSTING
+        float* inputFeatures = mlEvaluator.addRow(iCandidate, models);
+        std::fill(inputFeatures, inputFeatures + nFeatures, 0.0f);
+      }
+      iCandidate++;
     }
+    evaluateModels();
+
+    // store the scores, joinable with the cascades
+    for (int i = 0; i < iCandidate; i++) {
+      xiMLSelections(std::max(mlEvaluator.score(kXiMinusModel, i), mlEvaluator.score(kXiPlusModel, i)));
+      omegaMLSelections(std::max(mlEvaluator.score(kOmegaMinusModel, i), mlEvaluator.score(kOmegaPlusModel, i)));
+    }
+  }
+
+  void processDerivedData(soa::Join<aod::StraCollisions, aod::StraStamps> const& collisions, CascDerivedDatas const& cascades)
+  {
+    processCandidates(collisions, cascades);
+  }
+  void processStandardData(aod::Collisions const& collisions, CascOriginalDatas const& cascades, aod::BCsWithTimestamps const&)
+  {
+    processCandidates(collisions, cascades);
   }
 
   PROCESS_SWITCH(cascademlselection, processStandardData, "Process standard data", false);
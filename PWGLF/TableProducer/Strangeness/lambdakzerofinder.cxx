@@ -52,6 +52,7 @@
 #include "Common/DataModel/PIDResponse.h"
 #include "PWGLF/DataModel/LFStrangenessTables.h"
 #include "PWGLF/DataModel/LFStrangenessFinderTables.h"
+#include "PWGLF/Utils/strangenessPrefilter.h"
 #include "Common/Core/TrackSelection.h"
 #include "Common/DataModel/TrackSelectionTables.h"
 #include "Common/DataModel/EventSelection.h"
@@ -133,11 +134,16 @@ struct lambdakzerofinder {
     "registry",
     {
       {"hCandPerEvent", "hCandPerEvent", {HistType::kTH1F, {{1000, 0.0f, 1000.0f}}}},
+      {"hPrefilter", "hPrefilter", {HistType::kTH1D, {{3, -0.5f, 2.5f}}}},
     },
   };
 
   // Configurables
   Configurable<double> d_UseAbsDCA{"d_UseAbsDCA", kTRUE, "Use Abs DCAs"};
+
+  // pre-fit prefilter of the daughter pairs in the transverse plane (requires d_UseAbsDCA)
+  Configurable<bool> usePrefilter{"usePrefilter", false, "reject pairs failing the dcav0dau / v0radius selections before the fit"};
+  Configurable<float> prefilterMargin{"prefilterMargin", 0.1f, "margin (cm) added to the maximum distance of the daughters in the prefilter"};
   Configurable<double> d_bz_input{"d_bz", -999, "bz field, -999 is automatic"};
 
   // Selection criteria
@@ -166,8 +172,17 @@ struct lambdakzerofinder {
   int mRunNumber;
   float d_bz;
 
+  // transverse-plane circles of the positive and negative daughters of the current DF
+  o2::pwglf::trackCircles posCircles;
+  o2::pwglf::trackCircles negCircles;
+
   void init(InitContext&)
   {
+    auto hPrefilter = registry.get<TH1>(HIST("hPrefilter"));
+    hPrefilter->GetXaxis()->SetBinLabel(1, "Tested");
+    hPrefilter->GetXaxis()->SetBinLabel(2, "Rejected: DCA daughters");
+    hPrefilter->GetXaxis()->SetBinLabel(3, "Rejected: radius");
+
     mRunNumber = 0;
     d_bz = 0;
     ccdb->setURL("https://alice-ccdb.cern.ch");
@@ -303,8 +318,28 @@ struct lambdakzerofinder {
 
     Long_t lNCand = 0;
 
+    // circles are computed once per track, pairs are then tested on the arrays
+    const bool doPrefilter = usePrefilter && d_UseAbsDCA;
+    if (doPrefilter) {
+      posCircles.clear();
+      negCircles.clear();
+      for (auto& pTrack : pTracks) {
+        posCircles.push_back(getTrackPar(pTrack.track_as<FullTracksExtIU>()), d_bz);
+      }
+      for (auto& nTrack : nTracks) {
+        negCircles.push_back(getTrackPar(nTrack.track_as<FullTracksExtIU>()), d_bz);
+      }
+    }
+    // N.B.: here dcav0dau is compared to the chi2 (d^2 / 2) of the fit
+    const float prefilterMaxDistance = std::sqrt(2.f * dcav0dau) + prefilterMargin;
+    std::array<uint64_t, o2::pwglf::kNPrefilterStages> prefilterCounters{};
+
+    std::size_t iPos = 0;
     for (auto& pTrack : pTracks) { // FIXME: turn into combination(...)
+      const std::size_t thisPos = iPos++;
+      std::size_t iNeg = 0;
       for (auto& nTrack : nTracks) {
+        const std::size_t thisNeg = iNeg++;
         // Check compatibility with certain hypotheses and desired building
         bool keepCandidate = false;
         if (pTrack.compatiblePi() && nTrack.compatiblePi() && findK0Short)
@@ -316,6 +351,15 @@ struct lambdakzerofinder {
         if (!keepCandidate)
           continue;
 
+        if (doPrefilter) {
+          const int stage = posCircles.prefilter(thisPos, negCircles, thisNeg, prefilterMaxDistance, v0radius);
+          prefilterCounters[o2::pwglf::kPrefilterTested]++;
+          if (stage != o2::pwglf::kPrefilterTested) {
+            prefilterCounters[stage]++;
+            continue;
+          }
+        }
+
         auto t1 = pTrack.track_as<FullTracksExtIU>();
         auto t2 = nTrack.track_as<FullTracksExtIU>();
 
@@ -323,6 +367,9 @@ struct lambdakzerofinder {
       }
     }
     registry.fill(HIST("hCandPerEvent"), lNCand);
+    for (int iStage = 0; iStage < o2::pwglf::kNPrefilterStages; iStage++) {
+      registry.fill(HIST("hPrefilter"), iStage, prefilterCounters[iStage]);
+    }
   }
 };
 
@@ -22,6 +22,7 @@
 
 #include <Math/Vector4D.h>
 #include <cmath>
+#include <algorithm>
 #include <array>
 #include <cstdlib>
 
@@ -51,6 +52,7 @@
 #include <TDatabasePDG.h>
 #include "Tools/ML/MlResponse.h"
 #include "Tools/ML/model.h"
+#include "PWGLF/Utils/strangenessMlEvaluator.h"
 
 using namespace o2;
 using namespace o2::analysis;
@@ -99,6 +101,23 @@ struct lambdakzeromlselection {
 
   //// Casting
   std::vector<int> CastKine_SelMap, CastTopo_SelMap, Feature_SelMask;
+  std::size_t nSelectedFeatures = 0;
+
+  // Cheap topological prefilter: the candidates failing it are not evaluated and get a score of -1
+  struct : ConfigurableGroup {
+    Configurable<float> v0radius{"prefilter.v0radius", 0.0f, "minimum V0 radius (cm)"};
+    Configurable<float> v0cospa{"prefilter.v0cospa", -1.0f, "minimum V0 cosine of pointing angle"};
+    Configurable<float> dcav0dau{"prefilter.dcav0dau", 1e+6f, "maximum DCA between the V0 daughters (cm)"};
+  } prefilter;
+
+  // models evaluated in batch over the candidates of the dataframe
+  enum mlModels { kLambdaModel = 0,
+                  kAntiLambdaModel,
+                  kGammaModel,
+                  kKZeroShortModel,
+                  kNMlModels };
+  uint32_t enabledModels = 0;
+  o2::pwglf::strangenessMlEvaluator mlEvaluator;
 
   // CCDB configuration
   o2::ccdb::CcdbApi ccdbApi;
@@ -187,76 +206,98 @@ struct lambdakzeromlselection {
     Feature_SelMask.insert(Feature_SelMask.end(), CastKine_SelMap.begin(), CastKine_SelMap.end());
     Feature_SelMask.insert(Feature_SelMask.end(), CastTopo_SelMap.begin(), CastTopo_SelMap.end());
     LOG(info) << "Feature_SelMask size: " << Feature_SelMask.size();
+    nSelectedFeatures = std::count_if(Feature_SelMask.begin(), Feature_SelMask.end(), [](int mask) { return mask >= 1; });
+
+    enabledModels = (PredictLambda ? 1u << kLambdaModel : 0u) |
+                    (PredictAntiLambda ? 1u << kAntiLambdaModel : 0u) |
+                    (PredictGamma ? 1u << kGammaModel : 0u) |
+                    (PredictKZeroShort ? 1u << kKZeroShortModel : 0u);
   }
 
-  template <typename T, typename U>
-  std::vector<float> extractSelectedElements(const std::vector<T>& base_features, const std::vector<U>& Sel_mask)
+  template <typename TV0Object>
+  bool passesPrefilter(TV0Object const& cand)
   {
-    std::vector<float> selected_elements;
-    for (size_t i = 0; i < Sel_mask.size(); ++i) {
-      if (Sel_mask[i] >= 1) { // If the mask value is true, select the corresponding element
-        selected_elements.push_back(base_features[i]);
-      }
-    }
-    return selected_elements;
+    return cand.v0radius() > prefilter.v0radius &&
+           cand.v0cosPA() > prefilter.v0cospa &&
+           cand.dcaV0daughters() < prefilter.dcav0dau;
   }
 
-  // Process candidate and store properties in object
-  template <typename TV0Object, typename T>
-  void processCandidate(TV0Object const& cand, const std::vector<T>& Feature_SelMask)
+  // Process the candidates of the dataframe: the features are extracted once per candidate
+  // and every enabled model is evaluated in batch over all of them
+  template <typename TV0Objects>
+  void processCandidates(TV0Objects const& cands)
   {
-    // Select features
-    std::vector<float> base_features{cand.mLambda(), cand.mAntiLambda(),
-                                     cand.mGamma(), cand.mK0Short(),
-                                     cand.pt(), static_cast<float>(cand.qtarm()), cand.alpha(),
-                                     cand.positiveeta(), cand.negativeeta(), cand.eta(),
-                                     cand.z(), cand.v0radius(), static_cast<float>(TMath::ACos(cand.v0cosPA())),
-                                     cand.dcapostopv(), cand.dcanegtopv(), cand.dcaV0daughters(),
-                                     cand.dcav0topv(), cand.psipair()};
-
-    // Apply mask to select features
-    std::vector<float> inputFeatures = extractSelectedElements(base_features, Feature_SelMask);
+    mlEvaluator.reset(kNMlModels, cands.size(), nSelectedFeatures);
+    int iCandidate = 0;
+    for (auto const& cand : cands) {
+      nCandidates++;
+      if (nCandidates % 50000 == 0) {
+        LOG(info) << "Candidates processed: " << nCandidates;
+      }
+      if (enabledModels != 0 && passesPrefilter(cand)) {
+        // Select features
+        const std::array<float, 18> base_features{cand.mLambda(), cand.mAntiLambda(),
+                                                  cand.mGamma(), cand.mK0Short(),
+                                                  cand.pt(), static_cast<float>(cand.qtarm()), cand.alpha(),
+                                                  cand.positiveeta(), cand.negativeeta(), cand.eta(),
+                                                  cand.z(), cand.v0radius(), static_cast<float>(TMath::ACos(cand.v0cosPA())),
+                                                  cand.dcapostopv(), cand.dcanegtopv(), cand.dcaV0daughters(),
+                                                  cand.dcav0topv(), cand.psipair()};
+
+        // Apply mask to select features
+        float* inputFeatures = mlEvaluator.addRow(iCandidate, enabledModels);
+        for (size_t i = 0; i < Feature_SelMask.size(); ++i) {
+          if (Feature_SelMask[i] >= 1) { // If the mask value is true, select the corresponding element
+            *inputFeatures++ = base_features[i];
+          }
+        }
+      }
+      iCandidate++;
+    }
 
     // calculate classifier output
     if (PredictLambda) {
-      float* LambdaProbability = lambda_bdt.evalModel(inputFeatures);
-      lambdaMLSelections(LambdaProbability[1]);
+      mlEvaluator.evaluate(kLambdaModel, lambda_bdt);
     }
     if (PredictGamma) {
-      float* GammaProbability = gamma_bdt.evalModel(inputFeatures);
-      gammaMLSelections(GammaProbability[1]);
+      mlEvaluator.evaluate(kGammaModel, gamma_bdt);
     }
     if (PredictAntiLambda) {
-      float* AntiLambdaProbability = antilambda_bdt.evalModel(inputFeatures);
-      antiLambdaMLSelections(AntiLambdaProbability[1]);
+      mlEvaluator.evaluate(kAntiLambdaModel, antilambda_bdt);
     }
     if (PredictKZeroShort) {
-      float* KZeroShortProbability = kzeroshort_bdt.evalModel(inputFeatures);
-      kzeroShortMLSelections(KZeroShortProbability[1]);
+      mlEvaluator.evaluate(kKZeroShortModel, kzeroshort_bdt);
+    }
+
+    for (int i = 0; i < iCandidate; i++) {
+      if (PredictLambda) {
+        lambdaMLSelections(mlEvaluator.score(kLambdaModel, i));
+      }
+      if (PredictGamma) {
+        gammaMLSelections(mlEvaluator.score(kGammaModel, i));
+      }
+      if (PredictAntiLambda) {
+        antiLambdaMLSelections(mlEvaluator.score(kAntiLambdaModel, i));
+      }
+      if (PredictKZeroShort) {
+        kzeroShortMLSelections(mlEvaluator.score(kKZeroShortModel, i));
+      }
     }
   }
 
-  void processDerivedData(aod::StraCollision const& coll, V0DerivedDatas const& v0s)
+  void processDerivedData(aod::StraCollisions const& colls, V0DerivedDatas const& v0s)
   {
-    histos.fill(HIST("hEventVertexZ"), coll.posZ());
-    for (auto& v0 : v0s) {
-      nCandidates++;
-      if (nCandidates % 50000 == 0) {
-        LOG(info) << "Candidates processed: " << nCandidates;
-      }
-      processCandidate(v0, Feature_SelMask);
+    for (auto const& coll : colls) {
+      histos.fill(HIST("hEventVertexZ"), coll.posZ());
     }
+    processCandidates(v0s);
   }
-  void processStandardData(aod::Collision const& coll, V0OriginalDatas const& v0s)
+  void processStandardData(aod::Collisions const& colls, V0OriginalDatas const& v0s)
   {
-    histos.fill(HIST("hEventVertexZ"), coll.posZ());
-    for (auto& v0 : v0s) {
-      nCandidates++;
-      if (nCandidates % 50000 == 0) {
-        LOG(info) << "Candidates processed: " << nCandidates;
-      }
-      processCandidate(v0, Feature_SelMask);
+    for (auto const& coll : colls) {
+      histos.fill(HIST("hEventVertexZ"), coll.posZ());
     }
+    processCandidates(v0s);
   }
 
   PROCESS_SWITCH(lambdakzeromlselection, processStandardData, "Process standard data", false);
@@ -0,0 +1,170 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file phiCandidateBuilder.cxx
+/// \brief Task to pair the kaons of each collision into Phi -> K+K- candidates within a mass window
+///
+/// The kaons are selected once per collision and the candidates are written to the PhiCands table,
+/// so that the Phi correlation tasks loop over the candidate list instead of redoing the K+K- pairing
+/// for every associated particle. The PID selections passed by the daughters are stored as flags and
+/// the final PID choice is left to the reading task.
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <Math/Vector4D.h>
+
+#include "Framework/runDataProcessing.h"
+#include "Framework/AnalysisTask.h"
+#include "Framework/AnalysisDataModel.h"
+#include "Framework/HistogramRegistry.h"
+#include "CommonConstants/PhysicsConstants.h"
+#include "Common/Core/RecoDecay.h"
+#include "Common/DataModel/PIDResponse.h"
+#include "Common/DataModel/TrackSelectionTables.h"
+#include "PWGLF/DataModel/LFPhiCandidateTables.h"
+
+using namespace o2;
+using namespace o2::framework;
+
+struct PhiCandidateBuilder {
+  Produces<aod::PhiCands> phiCands;
+
+  HistogramRegistry histos{"histos", {}, OutputObjHandlingPolicy::AnalysisObject};
+
+  // Configurables for the kaon selection, same meaning as in phik0shortanalysis
+  struct : ConfigurableGroup {
+    Configurable<bool> cfgPrimaryTrack{"cfgPrimaryTrack", false, "Primary track selection"};
+    Configurable<bool> cfgGlobalWoDCATrack{"cfgGlobalWoDCATrack", true, "Global track selection without DCA"};
+    Configurable<bool> cfgPVContributor{"cfgPVContributor", true, "PV contributor track selection"};
+    Configurable<int> minTPCnClsFound{"minTPCnClsFound", 70, "min number of found TPC clusters"};
+    Configurable<float> cMinKaonPtcut{"cMinKaonPtcut", 0.15f, "Track minimum pt cut"};
+    Configurable<float> etaMax{"etaMax", 0.8f, "eta max"};
+    Configurable<float> cMaxDCAzToPVcut{"cMaxDCAzToPVcut", 2.0f, "Track DCAz cut to PV Maximum"};
+    Configurable<float> cMaxDCArToPV1Phi{"cMaxDCArToPV1Phi", 0.004f, "Track DCAr cut to PV config 1 for Phi"};
+    Configurable<float> cMaxDCArToPV2Phi{"cMaxDCArToPV2Phi", 0.013f, "Track DCAr cut to PV config 2 for Phi"};
+    Configurable<float> cMaxDCArToPV3Phi{"cMaxDCArToPV3Phi", 1.0f, "Track DCAr cut to PV config 3 for Phi"};
+    Configurable<float> pTToUseTOF{"pTToUseTOF", 0.5f, "pT above which use TOF"};
+    Configurable<float> nSigmaCutTPCKa{"nSigmaCutTPCKa", 3.0f, "Value of the TPC Nsigma cut for Kaons"};
+    Configurable<float> nSigmaCutCombinedKa{"nSigmaCutCombinedKa", 3.0f, "Value of the TPC-TOF combined Nsigma cut for Kaons"};
+  } trackConfigs;
+
+  // Configurables for the Phi candidates
+  struct : ConfigurableGroup {
+    Configurable<float> lowMPhi{"lowMPhi", 0.99f, "Lower limit on Phi mass"};
+    Configurable<float> upMPhi{"upMPhi", 1.05f, "Upper limit on Phi mass"};
+    Configurable<float> minPhiPt{"minPhiPt", 0.f, "Minimum pT for Phi"};
+    Configurable<float> maxPhiPt{"maxPhiPt", 100.f, "Maximum pT for Phi"};
+    Configurable<float> cfgYAcceptance{"cfgYAcceptance", 0.8f, "Rapidity acceptance for Phi"};
+  } phiConfigs;
+
+  using FullTracks = soa::Join<aod::Tracks, aod::TracksExtra, aod::TracksDCA, aod::TrackSelection, aod::pidTPCFullKa, aod::pidTOFFullKa>;
+
+  // Selected kaon of the collision
+  struct KaonCandidate {
+    int64_t globalIndex;
+    ROOT::Math::PxPyPzMVector momentum;
+    uint8_t pidFlags; // bits of the positive daughter in PIDFlag
+  };
+  std::vector<KaonCandidate> posKaons;
+  std::vector<KaonCandidate> negKaons;
+
+  void init(InitContext const&)
+  {
+    histos.add("hNKaons", "Number of selected kaons per collision", kTH1F, {{100, -0.5f, 99.5f}});
+    histos.add("hNPhiCandidates", "Number of Phi candidates per collision", kTH1F, {{100, -0.5f, 99.5f}});
+    histos.add("h2PhiCandidates", "Phi candidates", kTH2F, {{200, phiConfigs.lowMPhi, phiConfigs.upMPhi, "#it{M}_{inv} [GeV/#it{c}^{2}]"}, {100, 0.f, 10.f, "#it{p}_{T} (GeV/#it{c})"}});
+  }
+
+  template <typename T>
+  bool selectionTrack(const T& track)
+  {
+    if (trackConfigs.cfgPrimaryTrack && !track.isPrimaryTrack())
+      return false;
+    if (trackConfigs.cfgGlobalWoDCATrack && !track.isGlobalTrackWoDCA())
+      return false;
+    if (trackConfigs.cfgPVContributor && !track.isPVContributor())
+      return false;
+    if (track.tpcNClsFound() < trackConfigs.minTPCnClsFound)
+      return false;
+    if (track.pt() < trackConfigs.cMinKaonPtcut)
+      return false;
+    if (std::abs(track.eta()) > trackConfigs.etaMax)
+      return false;
+    if (std::abs(track.dcaXY()) > trackConfigs.cMaxDCArToPV1Phi + (trackConfigs.cMaxDCArToPV2Phi / std::pow(track.pt(), trackConfigs.cMaxDCArToPV3Phi)))
+      return false;
+    if (std::abs(track.dcaZ()) > trackConfigs.cMaxDCAzToPVcut)
+      return false;
+    return true;
+  }
+
+  // PID flags of a kaon candidate, in the bits of the positive daughter
+  template <typename T>
+  uint8_t getPIDFlags(const T& track)
+  {
+    uint8_t pidFlags = 0;
+    bool passTPC = std::abs(track.tpcNSigmaKa()) < trackConfigs.nSigmaCutTPCKa;
+    bool passCombined = track.hasTOF() && (std::pow(track.tofNSigmaKa(), 2) + std::pow(track.tpcNSigmaKa(), 2)) < std::pow(trackConfigs.nSigmaCutCombinedKa, 2);
+    if (passTPC)
+      pidFlags |= 1 << aod::phicand::kPosTPC;
+    if (passCombined)
+      pidFlags |= 1 << aod::phicand::kPosCombined;
+    if (track.pt() < trackConfigs.pTToUseTOF ? passTPC : passCombined)
+      pidFlags |= 1 << aod::phicand::kPosPtDependent;
+    return pidFlags;
+  }
+
+  void process(aod::Collision const& collision, FullTracks const& tracks)
+  {
+    // Select the kaons once, the pairing below is the only quadratic step
+    posKaons.clear();
+    negKaons.clear();
+    for (const auto& track : tracks) {
+      if (!selectionTrack(track))
+        continue;
+      uint8_t pidFlags = getPIDFlags(track);
+      if (pidFlags == 0)
+        continue;
+      KaonCandidate kaon{track.globalIndex(), ROOT::Math::PxPyPzMVector(track.px(), track.py(), track.pz(), o2::constants::physics::MassKaonCharged), pidFlags};
+      if (track.sign() > 0) {
+        posKaons.push_back(kaon);
+      } else {
+        negKaons.push_back(kaon);
+      }
+    }
+    histos.fill(HIST("hNKaons"), posKaons.size() + negKaons.size());
+
+    int nPhiCandidates = 0;
+    for (const auto& posKaon : posKaons) {
+      for (const auto& negKaon : negKaons) {
+        ROOT::Math::PxPyPzMVector recPhi = posKaon.momentum + negKaon.momentum;
+        if (recPhi.M() < phiConfigs.lowMPhi || recPhi.M() > phiConfigs.upMPhi)
+          continue;
+        if (recPhi.Pt() < phiConfigs.minPhiPt || recPhi.Pt() > phiConfigs.maxPhiPt)
+          continue;
+        if (std::abs(recPhi.Rapidity()) > phiConfigs.cfgYAcceptance)
+          continue;
+
+        uint8_t pidFlags = posKaon.pidFlags | (negKaon.pidFlags << aod::phicand::kNegTPC);
+        phiCands(collision.globalIndex(), posKaon.globalIndex, negKaon.globalIndex, recPhi.M(), recPhi.Pt(), recPhi.Rapidity(), RecoDecay::constrainAngle(recPhi.Phi()), pidFlags);
+        histos.fill(HIST("h2PhiCandidates"), recPhi.M(), recPhi.Pt());
+        nPhiCandidates++;
+      }
+    }
+    histos.fill(HIST("hNPhiCandidates"), nPhiCandidates);
+  }
+};
+
+WorkflowSpec defineDataProcessing(ConfigContext const& cfgc)
+{
+  return WorkflowSpec{adaptAnalysisTask<PhiCandidateBuilder>(cfgc)};
+}
@@ -190,6 +190,7 @@ struct strangederivedbuilder {
     Configurable<bool> fillRawSPDclsL1Run2{"fillRawSPDclsL1Run2", true, "Fill raw SPD clusters at layer 1 information for debug (only Run 2)"};
     Configurable<bool> fillRawNTracksForCorrelation{"fillRawNTracksForCorrelation", true, "Fill raw NTracks for correlation cuts"};
     Configurable<bool> fillTOFInformation{"fillTOFInformation", true, "Fill Daughter Track TOF information"};
+    Configurable<bool> fillTPCInformation{"fillTPCInformation", true, "Fill Daughter Track TPC PID information"};
   } fillTruncationOptions;
 
   Configurable<bool> qaCentrality{"qaCentrality", false, "qa centrality flag: check base raw values"};
@@ -221,6 +222,26 @@ struct strangederivedbuilder {
   std::vector<uint32_t> genOmegaMinus;
   std::vector<uint32_t> genOmegaPlus;
 
+  // dense remapping arrays, sized to the input tables of the dataframe and reused across dataframes
+  std::vector<int> V0CollIndices;
+  std::vector<int> CascadeCollIndices;
+  std::vector<int> KFCascadeCollIndices;
+  std::vector<int> TraCascadeCollIndices;
+  std::vector<int> trackMap;
+  std::vector<int> motherReference;
+
+  // turns the entries marked with 0 into their index in the derived table, assuming filling per order
+  static int compactRemap(std::vector<int>& remap)
+  {
+    int nSelected = 0;
+    for (auto& entry : remap) {
+      if (entry >= 0) {
+        entry = nSelected++;
+      }
+    }
+    return nSelected;
+  }
+
   float roundToPrecision(float number, float step = 0.01)
   {
     // this function rounds a certain number in an axis that is quantized by
@@ -423,10 +444,10 @@ struct strangederivedbuilder {
   void populateCollisionTables(coll const& collisions, udcoll const& udCollisions, v0d const& V0s, cad const& Cascades, kfcad const& KFCascades, tracad const& TraCascades, bcType const& /*bcs*/)
   {
     // create collision indices beforehand
-    std::vector<int> V0CollIndices(V0s.size(), -1);                 // index -1: no collision
-    std::vector<int> CascadeCollIndices(Cascades.size(), -1);       // index -1: no collision
-    std::vector<int> KFCascadeCollIndices(KFCascades.size(), -1);   // index -1: no collision
-    std::vector<int> TraCascadeCollIndices(TraCascades.size(), -1); // index -1: no collision
+    V0CollIndices.assign(V0s.size(), -1);                 // index -1: no collision
+    CascadeCollIndices.assign(Cascades.size(), -1);       // index -1: no collision
+    KFCascadeCollIndices.assign(KFCascades.size(), -1);   // index -1: no collision
+    TraCascadeCollIndices.assign(TraCascades.size(), -1); // index -1: no collision
 
     // +-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+
     for (const auto& collision : collisions) {
@@ -656,35 +677,27 @@ struct strangederivedbuilder {
 
   void processTrackExtrasV0sOnly(aod::V0Datas const& V0s, TracksWithExtra const& tracksExtra)
   {
-    std::vector<int> trackMap(tracksExtra.size(), -1); // index -1: not used
+    trackMap.assign(tracksExtra.size(), -1); // index -1: not used
 
     //__________________________________________________
     // mark tracks that belong to V0s
     for (auto const& v0 : V0s) {
-      auto const& posTrack = v0.posTrack_as<TracksWithExtra>();
-      auto const& negTrack = v0.negTrack_as<TracksWithExtra>();
-      trackMap[posTrack.globalIndex()] = 0;
-      trackMap[negTrack.globalIndex()] = 0;
+      trackMap[v0.posTrackId()] = 0;
+      trackMap[v0.negTrackId()] = 0;
     }
     //__________________________________________________
     // Figure out the numbering of the new tracks table
-    // assume filling per order
-    int nTracks = 0;
-    for (int i = 0; i < static_cast<int>(trackMap.size()); i++) {
-      if (trackMap[i] >= 0) {
-        trackMap[i] = nTracks++;
-      }
-    }
+    int nTracks = compactRemap(trackMap);
     //__________________________________________________
     // populate track references
+    v0Extras.reserve(V0s.size());
     for (auto const& v0 : V0s) {
-      auto const& posTrack = v0.posTrack_as<TracksWithExtra>();
-      auto const& negTrack = v0.negTrack_as<TracksWithExtra>();
-      v0Extras(trackMap[posTrack.globalIndex()],
-               trackMap[negTrack.globalIndex()]); // joinable with V0Datas
+      v0Extras(trackMap[v0.posTrackId()],
+               trackMap[v0.negTrackId()]); // joinable with V0Datas
     }
     //__________________________________________________
     // circle back and populate actual DauTrackExtra table
+    dauTrackExtras.reserve(nTracks);
     for (auto const& tr : tracksExtra) {
       if (trackMap[tr.globalIndex()] >= 0) {
         dauTrackExtras(tr.itsChi2NCl(),
@@ -703,84 +716,70 @@ struct strangederivedbuilder {
   template <typename V0Datas, typename CascDatas, typename KFCascDatas, typename TraCascDatas, typename tracksWithExtra>
   void fillTrackExtras(V0Datas const& V0s, CascDatas const& Cascades, KFCascDatas const& KFCascades, TraCascDatas const& TraCascades, tracksWithExtra const& tracksExtra)
   {
-    std::vector<int> trackMap(tracksExtra.size(), -1); // index -1: not used
+    trackMap.assign(tracksExtra.size(), -1); // index -1: not used
 
     //__________________________________________________
     // mark tracks that belong to V0s
+    // (the daughters are addressed by their indices, without building the track iterators)
     for (auto const& v0 : V0s) {
-      auto const& posTrack = v0.template posTrack_as<tracksWithExtra>();
-      auto const& negTrack = v0.template negTrack_as<tracksWithExtra>();
-      trackMap[posTrack.globalIndex()] = 0;
-      trackMap[negTrack.globalIndex()] = 0;
+      trackMap[v0.posTrackId()] = 0;
+      trackMap[v0.negTrackId()] = 0;
     }
 
     //__________________________________________________
     // index tracks that belong to CascDatas
     for (auto const& casc : Cascades) {
-      auto bachTrack = casc.template bachelor_as<tracksWithExtra>();
-      auto posTrack = casc.template posTrack_as<tracksWithExtra>();
-      auto negTrack = casc.template negTrack_as<tracksWithExtra>();
-      trackMap[posTrack.globalIndex()] = 0;
-      trackMap[negTrack.globalIndex()] = 0;
-      trackMap[bachTrack.globalIndex()] = 0;
+      trackMap[casc.posTrackId()] = 0;
+      trackMap[casc.negTrackId()] = 0;
+      trackMap[casc.bachelorId()] = 0;
     }
     //__________________________________________________
     // index tracks that belong to KFCascDatas
     for (auto const& casc : KFCascades) {
-      auto bachTrack = casc.template bachelor_as<tracksWithExtra>();
-      auto posTrack = casc.template posTrack_as<tracksWithExtra>();
-      auto negTrack = casc.template negTrack_as<tracksWithExtra>();
-      trackMap[posTrack.globalIndex()] = 0;
-      trackMap[negTrack.globalIndex()] = 0;
-      trackMap[bachTrack.globalIndex()] = 0;
+      trackMap[casc.posTrackId()] = 0;
+      trackMap[casc.negTrackId()] = 0;
+      trackMap[casc.bachelorId()] = 0;
     }
     //__________________________________________________
     // index tracks that belong to TraCascDatas
     for (auto const& casc : TraCascades) {
-      auto bachTrack = casc.template bachelor_as<tracksWithExtra>();
-      auto posTrack = casc.template posTrack_as<tracksWithExtra>();
-      auto negTrack = casc.template negTrack_as<tracksWithExtra>();
-      auto strangeTrack = casc.template strangeTrack_as<tracksWithExtra>();
-      trackMap[posTrack.globalIndex()] = 0;
-      trackMap[negTrack.globalIndex()] = 0;
-      trackMap[bachTrack.globalIndex()] = 0;
-      trackMap[strangeTrack.globalIndex()] = 0;
+      trackMap[casc.posTrackId()] = 0;
+      trackMap[casc.negTrackId()] = 0;
+      trackMap[casc.bachelorId()] = 0;
+      trackMap[casc.strangeTrackId()] = 0;
     }
     //__________________________________________________
     // Figure out the numbering of the new tracks table
-    // assume filling per order
-    int nTracks = 0;
-    for (int i = 0; i < static_cast<int>(trackMap.size()); i++) {
-      if (trackMap[i] >= 0) {
-        trackMap[i] = nTracks++;
-      }
-    }
+    int nTracks = compactRemap(trackMap);
     //__________________________________________________
     // populate track references
+    v0Extras.reserve(V0s.size());
     for (auto const& v0 : V0s) {
-      auto const& posTrack = v0.template posTrack_as<tracksWithExtra>();
-      auto const& negTrack = v0.template negTrack_as<tracksWithExtra>();
-      v0Extras(trackMap[posTrack.globalIndex()],
-               trackMap[negTrack.globalIndex()]); // joinable with V0Datas
+      v0Extras(trackMap[v0.posTrackId()],
+               trackMap[v0.negTrackId()]); // joinable with V0Datas
     }
     //__________________________________________________
     // populate track references
+    cascExtras.reserve(Cascades.size());
     for (auto const& casc : Cascades) {
-      auto bachTrack = casc.template bachelor_as<tracksWithExtra>();
-      auto posTrack = casc.template posTrack_as<tracksWithExtra>();
-      auto negTrack = casc.template negTrack_as<tracksWithExtra>();
-      cascExtras(trackMap[posTrack.globalIndex()],
-                 trackMap[negTrack.globalIndex()],
-                 trackMap[bachTrack.globalIndex()]); // joinable with CascDatas
+      cascExtras(trackMap[casc.posTrackId()],
+                 trackMap[casc.negTrackId()],
+                 trackMap[casc.bachelorId()]); // joinable with CascDatas
     }
     //__________________________________________________
     // populate track references
+    straTrackExtras.reserve(TraCascades.size());
     for (auto const& casc : TraCascades) {
-      auto strangeTrack = casc.template strangeTrack_as<tracksWithExtra>();
-      straTrackExtras(trackMap[strangeTrack.globalIndex()]); // joinable with TraCascDatas
+      straTrackExtras(trackMap[casc.strangeTrackId()]); // joinable with TraCascDatas
     }
     //__________________________________________________
     // circle back and populate actual DauTrackExtra table
+    dauTrackExtras.reserve(nTracks);
+    dauTrackTPCPIDs.reserve(nTracks);
+    dauTrackTOFPIDs.reserve(nTracks);
+    if constexpr (requires { tracksExtra.begin().mcParticle(); }) {
+      dauTrackMCIds.reserve(nTracks);
+    }
     for (auto const& tr : tracksExtra) {
       if (trackMap[tr.globalIndex()] >= 0) {
         dauTrackExtras(tr.itsChi2NCl(),
@@ -800,7 +799,9 @@ struct strangederivedbuilder {
         }
 
         if constexpr (requires { tr.tpcNSigmaEl(); }) {
-          if (roundNSigmaVariables) { // round if requested
+          if (!fillTruncationOptions.fillTPCInformation) { // keep the table joinable, with empty columns
+            dauTrackTPCPIDs(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+          } else if (roundNSigmaVariables) { // round if requested
             dauTrackTPCPIDs(tr.tpcSignal(),
                             roundToPrecision(tr.tpcNSigmaEl(), precisionNSigmas),
                             roundToPrecision(tr.tpcNSigmaPi(), precisionNSigmas),
@@ -813,7 +814,11 @@ struct strangederivedbuilder {
                             tr.tpcNSigmaPr(), tr.tpcNSigmaHe());
           }
           // populate daughter-level TOF information
-          dauTrackTOFPIDs(tr.tofSignal(), tr.tofEvTime(), tr.length());
+          if (fillTruncationOptions.fillTOFInformation) {
+            dauTrackTOFPIDs(tr.tofSignal(), tr.tofEvTime(), tr.length());
+          } else {
+            dauTrackTOFPIDs(0.0f, 0.0f, 0.0f);
+          }
         } else {
           // populate with empty fully-compatible Nsigmas if no corresponding table available
           dauTrackTPCPIDs(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
@@ -847,7 +852,7 @@ struct strangederivedbuilder {
 
   void processStrangeMothers(soa::Join<aod::V0Datas, aod::McV0Labels> const& V0s, soa::Join<aod::CascDatas, aod::McCascLabels> const& Cascades, aod::McParticles const& mcParticles)
   {
-    std::vector<int> motherReference(mcParticles.size(), -1); // index -1: not used / no reference
+    motherReference.assign(mcParticles.size(), -1); // index -1: not used / no reference
 
     //__________________________________________________
     // mark mcParticles for referencing
@@ -862,12 +867,7 @@ struct strangederivedbuilder {
     //__________________________________________________
     // Figure out the numbering of the new mcMother table
     // assume filling per order
-    int nParticles = 0;
-    for (int i = 0; i < static_cast<int>(motherReference.size()); i++) {
-      if (motherReference[i] >= 0) {
-        motherReference[i] = nParticles++; // count particles of interest
-      }
-    }
+    int nParticles = compactRemap(motherReference); // count particles of interest
     //__________________________________________________
     // populate track references
     for (auto const& v0 : V0s) {
@@ -886,6 +886,7 @@ struct strangederivedbuilder {
     }
     //__________________________________________________
     // populate motherMCParticles
+    motherMCParts.reserve(nParticles);
     for (auto const& tr : mcParticles) {
       if (motherReference[tr.globalIndex()] >= 0) {
         motherMCParts(tr.px(), tr.py(), tr.pz(), tr.pdgCode(), tr.isPhysicalPrimary());
@@ -31,8 +31,13 @@
 //                           When using findables, refer to FoundTag bools for checking if found
 //  -- v0builderopts ......: V0-specific building options (topological, deduplication, etc)
 //  -- cascadebuilderopts .: cascade-specific building options (topological, etc)
+//  -- nThreadsBuilding ...: number of threads for the V0 and cascade fits (tables unchanged)
+//  -- usePrefilter .......: reject V0s / cascades failing DCA or radius cuts before the fit
 
+#include <algorithm>
+#include <limits>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "Framework/DataSpecUtils.h"
@@ -299,6 +304,16 @@ struct StrangenessBuilder {
   // exchanges CPU (generate V0s again) with memory (save pre-generated V0s)
   Configurable<bool> useV0BufferForCascades{"useV0BufferForCascades", false, "store array of V0s for cascades or not. False (default): save RAM, use more CPU; true: save CPU, use more RAM"};
 
+  // multi-threaded building: the fits of a chunk of candidates run concurrently,
+  // the tables are then written serially in candidate order (content unchanged)
+  Configurable<int> nThreadsBuilding{"nThreadsBuilding", 1, "number of threads for the V0 and cascade fits. 1: serial building"};
+  Configurable<int> nCandidatesPerThread{"nCandidatesPerThread", 1024, "candidates fitted per thread and chunk in multi-threaded building"};
+
+  // pre-fit prefilter: daughters whose transverse-plane circles can neither come
+  // within the maximum DCA nor meet beyond the minimum radius are not fitted
+  Configurable<bool> usePrefilter{"usePrefilter", false, "reject V0s and cascades failing the DCA daughters / radius selections before the fit"};
+  Configurable<float> prefilterMargin{"prefilterMargin", 0.1f, "margin (cm) added to the maximum distance of the daughters in the prefilter"};
+
   Configurable<int> mc_findableMode{"mc_findableMode", 0, "0: disabled; 1: add findable-but-not-found to existing V0s from AO2D; 2: reset V0s and generate only findable-but-not-found"};
 
   // Autoconfigure process functions
@@ -529,6 +544,26 @@ struct StrangenessBuilder {
   std::vector<int> ao2dV0toV0List;                     // index to relate v0s -> v0List
   std::vector<int> v0Map;                              // index to relate v0List -> v0sFromCascades
 
+  // multi-threaded building
+  struct v0Prefit {
+    float pvX = 0.0f, pvY = 0.0f, pvZ = 0.0f;
+    o2::track::TrackParCov posTrackPar;
+    o2::track::TrackParCov negTrackPar;
+    bool toBuild = false;
+    bool isBuilt = false;
+    o2::pwglf::v0candidate v0;
+  };
+  struct cascadePrefit {
+    bool isBuilt = false;
+    o2::pwglf::cascadeCandidate cascade;
+  };
+  std::vector<o2::pwglf::strangenessBuilderHelper> threadHelpers; // one copy of straHelper per thread
+  std::vector<v0Prefit> v0Prefits;                                // fit results of the current chunk of V0s
+  std::vector<cascadePrefit> cascadePrefits;                      // fit results of the current chunk of cascades
+  std::size_t prefitBegin = 0;                                    // first candidate of the current chunk
+  std::size_t prefitEnd = 0;                                      // end of the current chunk
+  std::size_t prefitAbort = std::numeric_limits<std::size_t>::max(); // candidate at which serial building would have stopped
+
   void init(InitContext& context)
   {
     // setup bookkeeping histogram
@@ -594,6 +629,16 @@ struct StrangenessBuilder {
       hFindable->GetXaxis()->SetBinLabel(6, "Cascades with collId -1");
     }
 
+    if (usePrefilter.value == true) {
+      auto hPrefilterV0s = histos.add<TH1>("hPrefilterV0s", "hPrefilterV0s", kTH1D, {{3, -0.5f, 2.5f}});
+      auto hPrefilterCascades = histos.add<TH1>("hPrefilterCascades", "hPrefilterCascades", kTH1D, {{3, -0.5f, 2.5f}});
+      for (auto const& hPrefilter : {hPrefilterV0s, hPrefilterCascades}) {
+        hPrefilter->GetXaxis()->SetBinLabel(1, "Tested");
+        hPrefilter->GetXaxis()->SetBinLabel(2, "Rejected: DCA daughters");
+        hPrefilter->GetXaxis()->SetBinLabel(3, "Rejected: radius");
+      }
+    }
+
     auto hPrimaryV0s = histos.add<TH1>("hPrimaryV0s", "hPrimaryV0s", kTH1D, {{2, -0.5f, 1.5f}});
     hPrimaryV0s->GetXaxis()->SetBinLabel(1, "All V0s");
     hPrimaryV0s->GetXaxis()->SetBinLabel(2, "Primary V0s");
@@ -714,6 +759,10 @@ struct StrangenessBuilder {
     straHelper.cascadeselections.dcacascdau = cascadeBuilderOpts.dcacascdau;
     straHelper.cascadeselections.lambdaMassWindow = cascadeBuilderOpts.lambdaMassWindow;
     straHelper.cascadeselections.maxDaughterEta = cascadeBuilderOpts.maxDaughterEta;
+
+    // set prefilter parameters in the helper
+    straHelper.usePrefilter = usePrefilter;
+    straHelper.prefilterMargin = prefilterMargin;
   }
 
   // for sorting
@@ -1358,6 +1407,200 @@ struct StrangenessBuilder {
   }
 
   //__________________________________________________
+  //__________________________________________________
+  // sets the track parametrisations of a V0 before the fit, moving TPC-only tracks (photon conversions)
+  // returns false if a TPC-only track could not be moved, in which case the building of the V0s stops
+  template <class TBCs, typename TCollisions, typename TV0, typename TTrack>
+  bool prepareV0TrackPars(TV0 const& v0, TCollisions const& collisions, TTrack const& posTrack, TTrack const& negTrack, o2::track::TrackParCov& posTrackPar, o2::track::TrackParCov& negTrackPar)
+  {
+    // handle TPC-only tracks properly (photon conversions)
+    if (v0BuilderOpts.moveTPCOnlyTracks) {
+      bool isPosTPCOnly = (posTrack.hasTPC() && !posTrack.hasITS() && !posTrack.hasTRD() && !posTrack.hasTOF());
+      if (isPosTPCOnly) {
+        // Nota bene: positive is TPC-only -> this entire V0 merits treatment as photon candidate
+        posTrackPar.setPID(o2::track::PID::Electron);
+        negTrackPar.setPID(o2::track::PID::Electron);
+
+        auto const& collision = collisions.rawIteratorAt(v0.collisionId);
+        if (!mVDriftMgr.moveTPCTrack<TBCs, TCollisions>(collision, posTrack, posTrackPar)) {
+          return false;
+        }
+      }
+
+      bool isNegTPCOnly = (negTrack.hasTPC() && !negTrack.hasITS() && !negTrack.hasTRD() && !negTrack.hasTOF());
+      if (isNegTPCOnly) {
+        // Nota bene: negative is TPC-only -> this entire V0 merits treatment as photon candidate
+        posTrackPar.setPID(o2::track::PID::Electron);
+        negTrackPar.setPID(o2::track::PID::Electron);
+
+        auto const& collision = collisions.rawIteratorAt(v0.collisionId);
+        if (!mVDriftMgr.moveTPCTrack<TBCs, TCollisions>(collision, negTrack, negTrackPar)) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  //__________________________________________________
+  // builds a cascade with the given helper, from the buffered V0 or from scratch
+  template <typename TCascade, typename TTrack>
+  bool buildCascadeCandidate(o2::pwglf::strangenessBuilderHelper& helper, TCascade const& cascade, float pvX, float pvY, float pvZ, TTrack const& posTrack, TTrack const& negTrack, TTrack const& bachTrack)
+  {
+    if (useV0BufferForCascades) {
+      // this processing path uses a buffer of V0s so that no
+      // additional minimization step is redone. It consumes less
+      // CPU at the cost of more memory. Since memory is a more
+      // limited commodity, this isn't the default option.
+      return helper.buildCascadeCandidate(cascade.collisionId, pvX, pvY, pvZ,
+                                          v0sFromCascades[v0Map[cascade.v0Id]],
+                                          posTrack,
+                                          negTrack,
+                                          bachTrack,
+                                          mEnabledTables[kCascBBs],
+                                          cascadeBuilderOpts.useCascadeMomentumAtPrimVtx,
+                                          mEnabledTables[kCascCovs]);
+    }
+    // this processing path generates the entire cascade
+    // from tracks, without any need to have V0s generated.
+    return helper.buildCascadeCandidate(cascade.collisionId, pvX, pvY, pvZ,
+                                        posTrack,
+                                        negTrack,
+                                        bachTrack,
+                                        mEnabledTables[kCascBBs],
+                                        cascadeBuilderOpts.useCascadeMomentumAtPrimVtx,
+                                        mEnabledTables[kCascCovs]);
+  }
+
+  //__________________________________________________
+  // multi-threaded building: prepares one helper per thread and resets the chunk bookkeeping
+  void resetPrefits()
+  {
+    prefitBegin = prefitEnd = 0;
+    prefitAbort = std::numeric_limits<std::size_t>::max();
+    fillPrefilterHistograms(); // before the counters get copied
+    if (nThreadsBuilding > 1) {
+      // copies carry the current magnetic field, material LUT and selections
+      threadHelpers.assign(nThreadsBuilding.value, straHelper);
+    }
+  }
+
+  // adds the prefilter counters of all helpers to the histograms and resets them
+  void fillPrefilterHistograms()
+  {
+    if (!usePrefilter) {
+      return;
+    }
+    auto fillCounters = [&](o2::pwglf::strangenessBuilderHelper& helper) {
+      for (int iStage = 0; iStage < o2::pwglf::kNPrefilterStages; iStage++) {
+        histos.fill(HIST("hPrefilterV0s"), iStage, helper.v0PrefilterCounters[iStage]);
+        histos.fill(HIST("hPrefilterCascades"), iStage, helper.cascadePrefilterCounters[iStage]);
+      }
+      helper.resetPrefilterCounters();
+    };
+    fillCounters(straHelper);
+    for (auto& helper : threadHelpers) {
+      fillCounters(helper);
+    }
+  }
+
+  // runs work(thread, item) for nItems items, distributed over the threads
+  // Nota bene: relies on the thread safety of the Propagator (material LUT and field look-ups), as the fits do
+  template <typename TWork>
+  void runInThreads(std::size_t nItems, TWork const& work)
+  {
+    const std::size_t nThreads = std::min<std::size_t>(threadHelpers.size(), nItems);
+    std::vector<std::thread> workers;
+    for (std::size_t iThread = 1; iThread < nThreads; iThread++) {
+      workers.emplace_back([&work, iThread, nThreads, nItems]() {
+        for (std::size_t item = iThread; item < nItems; item += nThreads) {
+          work(iThread, item);
+        }
+      });
+    }
+    for (std::size_t item = 0; item < nItems; item += std::max<std::size_t>(nThreads, 1)) {
+      work(0, item);
+    }
+    for (auto& worker : workers) {
+      worker.join();
+    }
+  }
+
+  // fits the V0s of the chunk starting at first: the preparation, which can move TPC-only tracks, stays serial
+  template <class TBCs, typename TCollisions, typename TTracks>
+  void prefitV0s(std::size_t first, TCollisions const& collisions, TTracks const& tracks)
+  {
+    prefitBegin = first;
+    prefitEnd = std::min(v0List.size(), first + static_cast<std::size_t>(nThreadsBuilding.value * std::max(nCandidatesPerThread.value, 1)));
+    v0Prefits.resize(prefitEnd - prefitBegin);
+    for (std::size_t iv0 = prefitBegin; iv0 < prefitEnd; iv0++) {
+      auto& prefit = v0Prefits[iv0 - prefitBegin];
+      const auto& v0 = v0List[sorted_v0[iv0]];
+      prefit.toBuild = mEnabledTables[kV0CoresBase] || v0Map[iv0] != -2;
+      prefit.isBuilt = false;
+      if (!prefit.toBuild) {
+        continue;
+      }
+      prefit.pvX = prefit.pvY = prefit.pvZ = 0.0f;
+      if (v0.collisionId >= 0) {
+        auto const& collision = collisions.rawIteratorAt(v0.collisionId);
+        prefit.pvX = collision.posX();
+        prefit.pvY = collision.posY();
+        prefit.pvZ = collision.posZ();
+      }
+      auto const& posTrack = tracks.rawIteratorAt(v0.posTrackId);
+      auto const& negTrack = tracks.rawIteratorAt(v0.negTrackId);
+      prefit.posTrackPar = getTrackParCov(posTrack);
+      prefit.negTrackPar = getTrackParCov(negTrack);
+      if (!prepareV0TrackPars<TBCs>(v0, collisions, posTrack, negTrack, prefit.posTrackPar, prefit.negTrackPar)) {
+        prefitAbort = iv0;
+        prefitEnd = iv0 + 1;
+        v0Prefits.resize(prefitEnd - prefitBegin);
+        prefit.toBuild = false;
+        break;
+      }
+    }
+    runInThreads(v0Prefits.size(), [&](std::size_t iThread, std::size_t item) {
+      auto& prefit = v0Prefits[item];
+      if (!prefit.toBuild) {
+        return;
+      }
+      auto& helper = threadHelpers[iThread];
+      const auto& v0 = v0List[sorted_v0[prefitBegin + item]];
+      auto const& posTrack = tracks.rawIteratorAt(v0.posTrackId);
+      auto const& negTrack = tracks.rawIteratorAt(v0.negTrackId);
+      prefit.isBuilt = helper.buildV0Candidate(v0.collisionId, prefit.pvX, prefit.pvY, prefit.pvZ, posTrack, negTrack, prefit.posTrackPar, prefit.negTrackPar, v0.isCollinearV0, mEnabledTables[kV0Covs], true);
+      prefit.v0 = helper.v0;
+    });
+  }
+
+  // fits the cascades of the chunk starting at first
+  template <typename TCollisions, typename TCascades, typename TTracks>
+  void prefitCascades(std::size_t first, TCollisions const& collisions, TCascades const& cascades, TTracks const& tracks)
+  {
+    prefitBegin = first;
+    prefitEnd = std::min(cascades.size(), first + static_cast<std::size_t>(nThreadsBuilding.value * std::max(nCandidatesPerThread.value, 1)));
+    cascadePrefits.resize(prefitEnd - prefitBegin);
+    runInThreads(cascadePrefits.size(), [&](std::size_t iThread, std::size_t item) {
+      auto& prefit = cascadePrefits[item];
+      auto const& cascade = cascades[sorted_cascade[prefitBegin + item]];
+      prefit.isBuilt = false;
+      if (useV0BufferForCascades && (cascade.v0Id < 0 || v0Map[cascade.v0Id] < 0)) {
+        return; // skipped by the serial loop
+      }
+      float pvX = 0.0f, pvY = 0.0f, pvZ = 0.0f;
+      if (cascade.collisionId >= 0) {
+        auto const& collision = collisions.rawIteratorAt(cascade.collisionId);
+        pvX = collision.posX();
+        pvY = collision.posY();
+        pvZ = collision.posZ();
+      }
+      auto& helper = threadHelpers[iThread];
+      prefit.isBuilt = buildCascadeCandidate(helper, cascade, pvX, pvY, pvZ, tracks.rawIteratorAt(cascade.posTrackId), tracks.rawIteratorAt(cascade.negTrackId), tracks.rawIteratorAt(cascade.bachTrackId));
+      prefit.cascade = helper.cascade;
+    });
+  }
+
   template <class TBCs, typename TCollisions, typename TTracks, typename TV0s, typename TMCParticles>
   void buildV0s(TCollisions const& collisions, TV0s const& v0s, TTracks const& tracks, TMCParticles const& mcParticles)
   {
@@ -1371,6 +1614,7 @@ struct StrangenessBuilder {
     }
 
     int nV0s = 0;
+    resetPrefits();
     // Loops over all V0s in the time frame
     histos.fill(HIST("hInputStatistics"), kV0CoresBase, v0s.size());
     for (size_t iv0 = 0; iv0 < v0List.size(); iv0++) {
@@ -1395,37 +1639,26 @@ struct StrangenessBuilder {
       auto const& posTrack = tracks.rawIteratorAt(v0.posTrackId);
       auto const& negTrack = tracks.rawIteratorAt(v0.negTrackId);
 
-      auto posTrackPar = getTrackParCov(posTrack);
-      auto negTrackPar = getTrackParCov(negTrack);
-
-      // handle TPC-only tracks properly (photon conversions)
-      if (v0BuilderOpts.moveTPCOnlyTracks) {
-        bool isPosTPCOnly = (posTrack.hasTPC() && !posTrack.hasITS() && !posTrack.hasTRD() && !posTrack.hasTOF());
-        if (isPosTPCOnly) {
-          // Nota bene: positive is TPC-only -> this entire V0 merits treatment as photon candidate
-          posTrackPar.setPID(o2::track::PID::Electron);
-          negTrackPar.setPID(o2::track::PID::Electron);
-
-          auto const& collision = collisions.rawIteratorAt(v0.collisionId);
-          if (!mVDriftMgr.moveTPCTrack<TBCs, TCollisions>(collision, posTrack, posTrackPar)) {
-            return;
-          }
+      bool isBuilt = false;
+      if (nThreadsBuilding > 1) {
+        // fits of this chunk of V0s were done concurrently: pick up the result
+        if (iv0 >= prefitEnd) {
+          prefitV0s<TBCs>(iv0, collisions, tracks);
         }
-
-        bool isNegTPCOnly = (negTrack.hasTPC() && !negTrack.hasITS() && !negTrack.hasTRD() && !negTrack.hasTOF());
-        if (isNegTPCOnly) {
-          // Nota bene: negative is TPC-only -> this entire V0 merits treatment as photon candidate
-          posTrackPar.setPID(o2::track::PID::Electron);
-          negTrackPar.setPID(o2::track::PID::Electron);
-
-          auto const& collision = collisions.rawIteratorAt(v0.collisionId);
-          if (!mVDriftMgr.moveTPCTrack<TBCs, TCollisions>(collision, negTrack, negTrackPar)) {
-            return;
-          }
+        if (iv0 == prefitAbort) {
+          return;
+        }
+        straHelper.v0 = v0Prefits[iv0 - prefitBegin].v0;
+        isBuilt = v0Prefits[iv0 - prefitBegin].isBuilt;
+      } else {
+        auto posTrackPar = getTrackParCov(posTrack);
+        auto negTrackPar = getTrackParCov(negTrack);
+        if (!prepareV0TrackPars<TBCs>(v0, collisions, posTrack, negTrack, posTrackPar, negTrackPar)) {
+          return;
         }
+        isBuilt = straHelper.buildV0Candidate(v0.collisionId, pvX, pvY, pvZ, posTrack, negTrack, posTrackPar, negTrackPar, v0.isCollinearV0, mEnabledTables[kV0Covs], true);
       }
-
-      if (!straHelper.buildV0Candidate(v0.collisionId, pvX, pvY, pvZ, posTrack, negTrack, posTrackPar, negTrackPar, v0.isCollinearV0, mEnabledTables[kV0Covs], true)) {
+      if (!isBuilt) {
         products.v0dataLink(-1, -1);
         continue;
       }
@@ -1906,6 +2139,7 @@ struct StrangenessBuilder {
       return; // don't do if no request for cascades in place
     }
     int nCascades = 0;
+    resetPrefits();
     // Loops over all cascades in the time frame
     histos.fill(HIST("hInputStatistics"), kStoredCascCores, cascades.size());
     for (size_t icascade = 0; icascade < cascades.size(); icascade++) {
@@ -1923,46 +2157,28 @@ struct StrangenessBuilder {
       auto const& posTrack = tracks.rawIteratorAt(cascade.posTrackId);
       auto const& negTrack = tracks.rawIteratorAt(cascade.negTrackId);
       auto const& bachTrack = tracks.rawIteratorAt(cascade.bachTrackId);
-      if (useV0BufferForCascades) {
-        // this processing path uses a buffer of V0s so that no
-        // additional minimization step is redone. It consumes less
-        // CPU at the cost of more memory. Since memory is a more
-        // limited commodity, this isn't the default option.
-
-        // check if cached - if not, skip
-        if (cascade.v0Id < 0 || v0Map[cascade.v0Id] < 0) {
-          // this V0 hasn't been stored / cached
-          products.cascdataLink(-1);
-          interlinks.cascadeToCascCores.push_back(-1);
-          continue; // didn't work out, skip
-        }
-
-        if (!straHelper.buildCascadeCandidate(cascade.collisionId, pvX, pvY, pvZ,
-                                              v0sFromCascades[v0Map[cascade.v0Id]],
-                                              posTrack,
-                                              negTrack,
-                                              bachTrack,
-                                              mEnabledTables[kCascBBs],
-                                              cascadeBuilderOpts.useCascadeMomentumAtPrimVtx,
-                                              mEnabledTables[kCascCovs])) {
-          products.cascdataLink(-1);
-          interlinks.cascadeToCascCores.push_back(-1);
-          continue; // didn't work out, skip
+      // check if cached - if not, skip
+      if (useV0BufferForCascades && (cascade.v0Id < 0 || v0Map[cascade.v0Id] < 0)) {
+        // this V0 hasn't been stored / cached
+        products.cascdataLink(-1);
+        interlinks.cascadeToCascCores.push_back(-1);
+        continue; // didn't work out, skip
+      }
+      bool isBuilt = false;
+      if (nThreadsBuilding > 1) {
+        // fits of this chunk of cascades were done concurrently: pick up the result
+        if (icascade >= prefitEnd) {
+          prefitCascades(icascade, collisions, cascades, tracks);
         }
+        straHelper.cascade = cascadePrefits[icascade - prefitBegin].cascade;
+        isBuilt = cascadePrefits[icascade - prefitBegin].isBuilt;
       } else {
-        // this processing path generates the entire cascade
-        // from tracks, without any need to have V0s generated.
-        if (!straHelper.buildCascadeCandidate(cascade.collisionId, pvX, pvY, pvZ,
-                                              posTrack,
-                                              negTrack,
-                                              bachTrack,
-                                              mEnabledTables[kCascBBs],
-                                              cascadeBuilderOpts.useCascadeMomentumAtPrimVtx,
-                                              mEnabledTables[kCascCovs])) {
-          products.cascdataLink(-1);
-          interlinks.cascadeToCascCores.push_back(-1);
-          continue; // didn't work out, skip
-        }
+        isBuilt = buildCascadeCandidate(straHelper, cascade, pvX, pvY, pvZ, posTrack, negTrack, bachTrack);
+      }
+      if (!isBuilt) {
+        products.cascdataLink(-1);
+        interlinks.cascadeToCascCores.push_back(-1);
+        continue; // didn't work out, skip
       }
       nCascades++;
 
@@ -2584,6 +2800,7 @@ struct StrangenessBuilder {
     }
 
     populateCascadeInterlinks();
+    fillPrefilterHistograms();
   }
 
   void processRealData(soa::Join<aod::Collisions, aod::EvSels> const& collisions, aod::V0s const& v0s, aod::Cascades const& cascades, aod::TrackedCascades const& trackedCascades, FullTracksExtIU const& tracks, aod::BCsWithTimestamps const& bcs)
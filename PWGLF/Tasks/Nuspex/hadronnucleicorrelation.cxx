@@ -40,6 +40,7 @@
 #include <TVector2.h>
 #include <TVector3.h>
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <string>
@@ -102,6 +103,9 @@ struct hadronnucleicorrelation {
   // Mixing parameters
   Configurable<int> _vertexNbinsToMix{"vertexNbinsToMix", 10, "Number of vertexZ bins for the mixing"};
   Configurable<int> _multNsubBins{"multSubBins", 10, "number of sub-bins to perform the mixing within"};
+  Configurable<bool> binnedMixing{"binnedMixing", false, "ME (data): correlate per-event eta-phi maps instead of looping over the pairs of each couple of events"};
+  Configurable<int> binnedMixingNEtaBins{"binnedMixingNEtaBins", 32, "number of eta bins of the per-event maps for binnedMixing"};
+  Configurable<int> binnedMixingNPhiBins{"binnedMixingNPhiBins", 72, "number of phi bins of the per-event maps for binnedMixing"};
 
   // pT/A bins
   Configurable<std::vector<double>> pTBins{"pTBins", {0.6f, 1.0f, 1.2f, 2.f}, "p_{T} bins"};
@@ -174,6 +178,26 @@ struct hadronnucleicorrelation {
   std::vector<std::shared_ptr<TH3>> hEtaPhiGen_AntiPrAntiPr_SE;
   std::vector<std::shared_ptr<TH3>> hEtaPhiGen_AntiPrAntiPr_ME;
 
+  // Per-event maps for binnedMixing, in cells of (pT bin, eta bin, phi bin)
+  struct MapCell {
+    int index;    // (pT bin * n eta bins + eta bin) * n phi bins + phi bin
+    double count; // number of particles
+    double corr;  // sum of 1/efficiency
+    double corr2; // sum of 1/efficiency^2
+  };
+  int mapNEta = 0;
+  int mapNPhi = 0;
+  float mapEtaWidth = 0.f;
+  float mapPhiWidth = 0.f;
+  std::vector<int> mapDeltaEtaBin;                  // Delta-eta bin of the ME histograms for each difference of eta bins of the maps
+  std::vector<int> mapDeltaPhiBin;                  // Delta-phi bin of the ME histograms for each difference of phi bins of the maps
+  std::vector<int> mapCellPosition;                 // position of each cell in the map being filled, -1 if empty
+  std::vector<MapCell> mapSum;                      // sum of the associated maps of the events of a mixing bin, indexed by cell
+  std::vector<int> mapSumIndices;                   // non-empty cells of mapSum
+  std::vector<std::vector<MapCell>> mapsAssociated; // associated map of each event of a mixing bin
+  std::vector<MapCell> mapTrigger;
+  std::vector<MapCell> mapOwnSaved;
+
   int nBinspT;
   TH2F* hEffpTEta_proton;
   TH2F* hEffpTEta_antiproton;
@@ -296,6 +320,10 @@ struct hadronnucleicorrelation {
         hCorrEtaPhi_SE.push_back(std::move(hCorrtempSE_AntiDeAntiPr));
         hCorrEtaPhi_ME.push_back(std::move(hCorrtempME_AntiDeAntiPr));
       }
+
+      if (binnedMixing) {
+        initBinnedMixing();
+      }
     }
 
     if (doQA) {
@@ -701,6 +729,183 @@ struct hadronnucleicorrelation {
     }
   }
 
+  // Efficiency maps of the trigger and of the associated particles for the chosen mode
+  std::pair<TH2F*, TH2F*> getEfficiencyMaps()
+  {
+    switch (mode) {
+      case 0:
+        return {hEffpTEta_antideuteron, hEffpTEta_antiproton};
+      case 1:
+        return {hEffpTEta_deuteron, hEffpTEta_proton};
+      case 2:
+        return {hEffpTEta_antideuteron, hEffpTEta_proton};
+      case 3:
+        return {hEffpTEta_deuteron, hEffpTEta_antiproton};
+      case 4:
+        return {hEffpTEta_antiproton, hEffpTEta_proton};
+      case 5:
+        return {hEffpTEta_antiproton, hEffpTEta_antiproton};
+      case 6:
+        return {hEffpTEta_proton, hEffpTEta_proton};
+    }
+    return {nullptr, nullptr};
+  }
+
+  /// binnedMixing: the ME correlation of a trigger event with all the other events of its mixing bin is obtained from
+  /// binned eta-phi maps of the particles, as the correlation of its trigger map with the sum of the associated maps
+  /// of the other events. The cost scales with the number of occupied cells instead of the number of pairs.
+  /// The Delta-eta and Delta-phi of a pair are those of the centres of its cells, hence they are known within the
+  /// cell size of the maps, to be chosen smaller than the bins of the ME histograms.
+  void initBinnedMixing()
+  {
+    mapNEta = binnedMixingNEtaBins;
+    mapNPhi = binnedMixingNPhiBins;
+    mapEtaWidth = 2.f * etacut / mapNEta;
+    mapPhiWidth = o2::constants::math::TwoPI / mapNPhi;
+    const TAxis* deltaEtaAxis = hEtaPhi_ME[0]->GetXaxis();
+    const TAxis* deltaPhiAxis = hEtaPhi_ME[0]->GetYaxis();
+    mapDeltaEtaBin.resize(2 * mapNEta - 1);
+    for (int dEta = -(mapNEta - 1); dEta < mapNEta; dEta++) {
+      mapDeltaEtaBin[dEta + mapNEta - 1] = deltaEtaAxis->FindBin(dEta * mapEtaWidth);
+    }
+    mapDeltaPhiBin.resize(mapNPhi);
+    for (int dPhi = 0; dPhi < mapNPhi; dPhi++) {
+      mapDeltaPhiBin[dPhi] = deltaPhiAxis->FindBin(RecoDecay::constrainAngle(dPhi * mapPhiWidth, -1 * o2::constants::math::PIHalf));
+    }
+    // pT bins of the associated particles include the underflow and overflow of the pT axis of the ME histograms
+    const int nCells = (nBinspT + 2) * mapNEta * mapNPhi;
+    mapCellPosition.assign(nCells, -1);
+    mapSum.resize(nCells);
+    for (int index = 0; index < nCells; index++) {
+      mapSum[index] = {index, 0., 0., 0.};
+    }
+  }
+
+  /// Map of the trigger particles (cells of the pT bins of the analysis) or of the associated particles
+  /// (cells of the pT bins of the ME histograms)
+  template <bool isTrigger, typename Type>
+  void fillEventMap(Type const& tracks, TH2F* hEfficiency, std::vector<MapCell>& cells)
+  {
+    cells.clear();
+    for (auto const& track : tracks) {
+      int ptBin = -1;
+      if constexpr (isTrigger) {
+        for (int k = 0; k < nBinspT; k++) {
+          if (track->pt() >= pTBins.value.at(k) && track->pt() < pTBins.value.at(k + 1)) {
+            ptBin = k;
+            break;
+          }
+        }
+        if (ptBin < 0) {
+          continue;
+        }
+      } else {
+        ptBin = hEtaPhi_ME[0]->GetZaxis()->FindBin(track->pt());
+      }
+      const int etaBin = std::clamp(static_cast<int>(std::floor((track->eta() + etacut) / mapEtaWidth)), 0, mapNEta - 1);
+      const int phiBin = std::clamp(static_cast<int>(std::floor(RecoDecay::constrainAngle(track->phi(), 0.f) / mapPhiWidth)), 0, mapNPhi - 1);
+      const int index = (ptBin * mapNEta + etaBin) * mapNPhi + phiBin;
+      const double corr = (docorrection && hEfficiency) ? 1. / hEfficiency->Interpolate(track->pt(), track->eta()) : 1.;
+      if (mapCellPosition[index] < 0) {
+        mapCellPosition[index] = cells.size();
+        cells.push_back({index, 0., 0., 0.});
+      }
+      auto& cell = cells[mapCellPosition[index]];
+      cell.count += 1.;
+      cell.corr += corr;
+      cell.corr2 += corr * corr;
+    }
+    for (auto const& cell : cells) {
+      mapCellPosition[cell.index] = -1;
+    }
+  }
+
+  static void addBinnedContent(TH3* hist, int bin, double w, double w2)
+  {
+    hist->AddBinContent(bin, w);
+    if (hist->GetSumw2N() > 0) {
+      hist->GetSumw2()->fArray[bin] += w2;
+    }
+  }
+
+  /// ME of all the events of a mixing bin with binnedMixing, equivalent to mixTracks<1, 0> for each couple of events
+  template <typename TracksMap>
+  void mixEventsBinned(std::vector<colType> const& cols, TracksMap& trigTracks, TracksMap& assocTracks)
+  {
+    const auto [hEffTrigger, hEffAssociated] = getEfficiencyMaps();
+    const int nEvents = cols.size();
+
+    // Sum of the associated maps of the events of the bin
+    mapsAssociated.resize(nEvents);
+    mapSumIndices.clear();
+    for (int indx = 0; indx < nEvents; indx++) {
+      mapsAssociated[indx].clear();
+      auto assoc = assocTracks.find(cols[indx]->index());
+      if (assoc == assocTracks.end()) {
+        continue;
+      }
+      fillEventMap<false>(assoc->second, hEffAssociated, mapsAssociated[indx]);
+      for (auto const& cell : mapsAssociated[indx]) {
+        auto& sum = mapSum[cell.index];
+        if (sum.count == 0.) {
+          mapSumIndices.push_back(cell.index);
+        }
+        sum.count += cell.count;
+        sum.corr += cell.corr;
+        sum.corr2 += cell.corr2;
+      }
+    }
+
+    for (int indx1 = 0; indx1 < nEvents; indx1++) {
+      fillEventMap<true>(trigTracks[cols[indx1]->index()], hEffTrigger, mapTrigger);
+      if (mapTrigger.empty()) {
+        continue;
+      }
+
+      // the event itself is removed from the sum, and restored afterwards
+      mapOwnSaved.clear();
+      for (auto const& cell : mapsAssociated[indx1]) {
+        auto& sum = mapSum[cell.index];
+        mapOwnSaved.push_back(sum);
+        sum.count -= cell.count;
+        sum.corr -= cell.corr;
+        sum.corr2 -= cell.corr2;
+      }
+
+      for (auto const& trig : mapTrigger) {
+        const int k = trig.index / (mapNEta * mapNPhi);
+        const int etaBin1 = (trig.index / mapNPhi) % mapNEta;
+        const int phiBin1 = trig.index % mapNPhi;
+        TH3* hRaw = hEtaPhi_ME[k].get();
+        TH3* hCorr = hCorrEtaPhi_ME[k].get();
+        double nPairs = 0.;
+        for (const int index : mapSumIndices) {
+          auto const& assoc = mapSum[index];
+          if (assoc.count == 0.) {
+            continue;
+          }
+          const int ptBin2 = index / (mapNEta * mapNPhi);
+          const int etaBin2 = (index / mapNPhi) % mapNEta;
+          const int phiBin2 = index % mapNPhi;
+          const int bin = hRaw->GetBin(mapDeltaEtaBin[etaBin2 - etaBin1 + mapNEta - 1], mapDeltaPhiBin[(phiBin2 - phiBin1 + mapNPhi) % mapNPhi], ptBin2);
+          addBinnedContent(hRaw, bin, trig.count * assoc.count, trig.count * assoc.count);
+          addBinnedContent(hCorr, bin, trig.corr * assoc.corr, trig.corr2 * assoc.corr2);
+          nPairs += trig.count * assoc.count;
+        }
+        hRaw->SetEntries(hRaw->GetEntries() + nPairs);
+        hCorr->SetEntries(hCorr->GetEntries() + nPairs);
+      }
+
+      for (auto const& saved : mapOwnSaved) {
+        mapSum[saved.index] = saved;
+      }
+    }
+
+    for (const int index : mapSumIndices) {
+      mapSum[index] = {index, 0., 0., 0.};
+    }
+  }
+
   void GetCorrection(o2::framework::Service<o2::ccdb::BasicCCDBManager> const& ccdbObj, TString filepath, TString histname)
   {
     TList* l = ccdbObj->get<TList>(filepath.Data());
@@ -871,6 +1076,10 @@ struct hadronnucleicorrelation {
         std::vector<colType> value = i->second;
         int EvPerBin = value.size(); // number of collisions in each vertex&mult bin
 
+        if (binnedMixing) {
+          mixEventsBinned(value, selectedtracks_antid, selectedtracks_antip); // mixing ME
+        }
+
         for (int indx1 = 0; indx1 < EvPerBin; indx1++) { // loop over all the events in each vertex&mult bin
 
           auto col1 = value[indx1];
@@ -879,6 +1088,10 @@ struct hadronnucleicorrelation {
             mixTracks<0, 0>(selectedtracks_antid[col1->index()], selectedtracks_antip[col1->index()], 0, 0); // mixing SE
           }
 
+          if (binnedMixing) {
+            continue;
+          }
+
           for (int indx2 = 0; indx2 < EvPerBin; indx2++) { // nested loop for all the combinations of collisions in a chosen mult/vertex bin
 
             auto col2 = value[indx2];
@@ -902,6 +1115,10 @@ struct hadronnucleicorrelation {
         std::vector<colType> value = i->second;
         int EvPerBin = value.size(); // number of collisions in each vertex&mult bin
 
+        if (binnedMixing) {
+          mixEventsBinned(value, selectedtracks_d, selectedtracks_p); // mixing ME
+        }
+
         for (int indx1 = 0; indx1 < EvPerBin; indx1++) { // loop over all the events in each vertex&mult bin
 
           auto col1 = value[indx1];
@@ -910,6 +1127,10 @@ struct hadronnucleicorrelation {
             mixTracks<0, 0>(selectedtracks_d[col1->index()], selectedtracks_p[col1->index()], 0, 0); // mixing SE
           }
 
+          if (binnedMixing) {
+            continue;
+          }
+
           for (int indx2 = 0; indx2 < EvPerBin; indx2++) { // nested loop for all the combinations of collisions in a chosen mult/vertex bin
 
             auto col2 = value[indx2];
@@ -933,6 +1154,10 @@ struct hadronnucleicorrelation {
         std::vector<colType> value = i->second;
         int EvPerBin = value.size(); // number of collisions in each vertex&mult bin
 
+        if (binnedMixing) {
+          mixEventsBinned(value, selectedtracks_antid, selectedtracks_p); // mixing ME
+        }
+
         for (int indx1 = 0; indx1 < EvPerBin; indx1++) { // loop over all the events in each vertex&mult bin
 
           auto col1 = value[indx1];
@@ -941,6 +1166,10 @@ struct hadronnucleicorrelation {
             mixTracks<0, 0>(selectedtracks_antid[col1->index()], selectedtracks_p[col1->index()], 0, 0); // mixing SE
           }
 
+          if (binnedMixing) {
+            continue;
+          }
+
           for (int indx2 = 0; indx2 < EvPerBin; indx2++) { // nested loop for all the combinations of collisions in a chosen mult/vertex bin
 
             auto col2 = value[indx2];
@@ -964,6 +1193,10 @@ struct hadronnucleicorrelation {
         std::vector<colType> value = i->second;
         int EvPerBin = value.size(); // number of collisions in each vertex&mult bin
 
+        if (binnedMixing) {
+          mixEventsBinned(value, selectedtracks_d, selectedtracks_antip); // mixing ME
+        }
+
         for (int indx1 = 0; indx1 < EvPerBin; indx1++) { // loop over all the events in each vertex&mult bin
 
           auto col1 = value[indx1];
@@ -972,6 +1205,10 @@ struct hadronnucleicorrelation {
             mixTracks<0, 0>(selectedtracks_d[col1->index()], selectedtracks_antip[col1->index()], 0, 0); // mixing SE
           }
 
+          if (binnedMixing) {
+            continue;
+          }
+
           for (int indx2 = 0; indx2 < EvPerBin; indx2++) { // nested loop for all the combinations of collisions in a chosen mult/vertex bin
 
             auto col2 = value[indx2];
@@ -995,6 +1232,10 @@ struct hadronnucleicorrelation {
         std::vector<colType> value = i->second;
         int EvPerBin = value.size(); // number of collisions in each vertex&mult bin
 
+        if (binnedMixing) {
+          mixEventsBinned(value, selectedtracks_antip, selectedtracks_p); // mixing ME
+        }
+
         for (int indx1 = 0; indx1 < EvPerBin; indx1++) { // loop over all the events in each vertex&mult bin
 
           auto col1 = value[indx1];
@@ -1003,6 +1244,10 @@ struct hadronnucleicorrelation {
             mixTracks<0, 0>(selectedtracks_antip[col1->index()], selectedtracks_p[col1->index()], 0, 0); // mixing SE
           }
 
+          if (binnedMixing) {
+            continue;
+          }
+
           for (int indx2 = 0; indx2 < EvPerBin; indx2++) { // nested loop for all the combinations of collisions in a chosen mult/vertex bin
 
             auto col2 = value[indx2];
@@ -1026,6 +1271,10 @@ struct hadronnucleicorrelation {
         std::vector<colType> value = i->second;
         int EvPerBin = value.size(); // number of collisions in each vertex&mult bin
 
+        if (binnedMixing) {
+          mixEventsBinned(value, selectedtracks_antip, selectedtracks_antip); // mixing ME
+        }
+
         for (int indx1 = 0; indx1 < EvPerBin; indx1++) { // loop over all the events in each vertex&mult bin
 
           auto col1 = value[indx1];
@@ -1034,6 +1283,10 @@ struct hadronnucleicorrelation {
             mixTracks<0, 0>(selectedtracks_antip[col1->index()], selectedtracks_antip[col1->index()], 1, 0); // mixing SE
           }
 
+          if (binnedMixing) {
+            continue;
+          }
+
           for (int indx2 = 0; indx2 < EvPerBin; indx2++) { // nested loop for all the combinations of collisions in a chosen mult/vertex bin
 
             auto col2 = value[indx2];
@@ -1057,6 +1310,10 @@ struct hadronnucleicorrelation {
         std::vector<colType> value = i->second;
         int EvPerBin = value.size(); // number of collisions in each vertex&mult bin
 
+        if (binnedMixing) {
+          mixEventsBinned(value, selectedtracks_p, selectedtracks_p); // mixing ME
+        }
+
         for (int indx1 = 0; indx1 < EvPerBin; indx1++) { // loop over all the events in each vertex&mult bin
 
           auto col1 = value[indx1];
@@ -1065,6 +1322,10 @@ struct hadronnucleicorrelation {
             mixTracks<0, 0>(selectedtracks_p[col1->index()], selectedtracks_p[col1->index()], 1, 0); // mixing SE
           }
 
+          if (binnedMixing) {
+            continue;
+          }
+
           for (int indx2 = 0; indx2 < EvPerBin; indx2++) { // nested loop for all the combinations of collisions in a chosen mult/vertex bin
 
             auto col2 = value[indx2];
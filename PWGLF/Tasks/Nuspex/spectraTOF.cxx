@@ -830,8 +830,8 @@ struct tofSpectra {
   } // end of the process function
   PROCESS_SWITCH(tofSpectra, processBC, "Processor of BCs for the FT0 calibration", true);
 
-  template <bool fillFullInfo, PID::ID id, typename T, typename C>
-  void fillParticleHistos(const T& track, const C& collision)
+  template <bool fillFullInfo, PID::ID id, typename T>
+  void fillParticleHistos(const T& track, const float multiplicity)
   {
     if (std::abs(track.rapidity(PID::getMass(id))) > trkselOptions.cfgCutY) {
       return;
@@ -845,7 +845,6 @@ struct tofSpectra {
     const auto& nsigmaTPC = o2::aod::pidutils::tpcNSigma<id>(track);
 
     // const auto id = track.sign() > 0 ? id : id + Np;
-    const float multiplicity = getMultiplicity(collision);
     if (multiplicityEstimator == MultCodes::kNoMultiplicity) {
       if (track.sign() > 0) {
         histos.fill(HIST(hnsigmatpc[id]), track.pt(), nsigmaTPC);
@@ -1696,13 +1695,14 @@ struct tofSpectra {
         return;
       }
       const auto& tracksInCollision = tracks.sliceByCached(aod::spectra::collisionId, collision.globalIndex(), cacheTrk);
+      const float multiplicity = getMultiplicity(collision);
       for (const auto& track : tracksInCollision) {
         if (!isTrackSelected<true>(track, collision)) {
           continue;
         }
-        fillParticleHistos<false, PID::Pion>(track, collision);
-        fillParticleHistos<false, PID::Kaon>(track, collision);
-        fillParticleHistos<false, PID::Proton>(track, collision);
+        fillParticleHistos<false, PID::Pion>(track, multiplicity);
+        fillParticleHistos<false, PID::Kaon>(track, multiplicity);
+        fillParticleHistos<false, PID::Proton>(track, multiplicity);
       }
     }
   } // end of the process function
@@ -1717,11 +1717,12 @@ struct tofSpectra {
     if (!isEventSelected<false, false>(collision)) {                                           \
       return;                                                                                  \
     }                                                                                          \
+    const float multiplicity = getMultiplicity(collision);                                     \
     for (const auto& track : tracks) {                                                         \
       if (!isTrackSelected<false>(track, collision)) {                                         \
         continue;                                                                              \
       }                                                                                        \
-      fillParticleHistos<isFull, PID::particleId>(track, collision);                           \
+      fillParticleHistos<isFull, PID::particleId>(track, multiplicity);                        \
     }                                                                                          \
   }                                                                                            \
   PROCESS_SWITCH(tofSpectra, process##processorName##inputPid, Form("Process for the %s hypothesis from %s tables", #particleId, #processorName), false);
@@ -1882,23 +1883,22 @@ struct tofSpectra {
   void fillTrackHistograms_MC(TrackType const& track,
                               ParticleType::iterator const& mcParticle,
                               RecoMCCollisions::iterator const& collision,
-                              ParticleType const& mcParticles)
+                              ParticleType const& mcParticles,
+                              const float multiplicity)
   {
     if (!isParticleEnabled<i>()) { // Check if the particle is enabled
       return;
     }
+    if (mcParticle.pdgCode() != PDGs[i]) { // Only the species of the particle goes further
+      return;
+    }
 
     const auto& mcCollision = collision.mcCollision_as<GenMCCollisions>();
-    const float multiplicity = getMultiplicity(collision);
     const int occupancy = collision.trackOccupancyInTimeRange();
     //************************************RD**************************************************
     const float impParam = mcCollision.impactParameter();
     //************************************RD**************************************************
 
-    if (mcParticle.pdgCode() != PDGs[i]) {
-      return;
-    }
-
     if (track.eta() < trkselOptions.cfgCutEtaMin || track.eta() > trkselOptions.cfgCutEtaMax) {
       return;
     }
@@ -2500,6 +2500,9 @@ struct tofSpectra {
 
   Preslice<aod::McParticles> perMCCol = aod::mcparticle::mcCollisionId;
   SliceCache cache;
+  std::vector<bool> isCollisionSelected;     // event selection of the reconstructed collisions of the DF
+  std::vector<float> collisionMultiplicities; // multiplicity of the reconstructed collisions of the DF
+
   void processMC(soa::Join<aod::Tracks, aod::TracksExtra,
                            aod::TracksDCA, aod::McTrackLabels,
                            aod::pidTPCFullPi, aod::pidTPCFullKa, aod::pidTPCFullPr,
@@ -2513,6 +2516,14 @@ struct tofSpectra {
     histos.fill(HIST("MC/GenRecoCollisions"), 1.f, mcCollisions.size());
     histos.fill(HIST("MC/GenRecoCollisions"), 2.f, collisions.size());
 
+    // Event selection and multiplicity once per collision, instead of once per track and species
+    isCollisionSelected.assign(collisions.size(), false);
+    collisionMultiplicities.assign(collisions.size(), 0.f);
+    for (const auto& collision : collisions) {
+      isCollisionSelected[collision.globalIndex()] = isEventSelected<false, false>(collision);
+      collisionMultiplicities[collision.globalIndex()] = getMultiplicity(collision);
+    }
+
     for (const auto& track : tracks) {
       if (!track.has_collision()) {
         if (track.sign() > 0) {
@@ -2522,7 +2533,7 @@ struct tofSpectra {
         }
         continue;
       }
-      if (!isEventSelected<false, false>(track.collision_as<RecoMCCollisions>())) {
+      if (!isCollisionSelected[track.collisionId()]) {
         continue;
       }
       if (!passesCutWoDCA(track)) {
@@ -2537,9 +2548,11 @@ struct tofSpectra {
         continue;
       }
       const auto& mcParticle = track.mcParticle();
+      const auto& collision = track.collision_as<RecoMCCollisions>();
+      const float multiplicity = collisionMultiplicities[track.collisionId()];
 
       static_for<0, 17>([&](auto i) {
-        fillTrackHistograms_MC<i>(track, mcParticle, track.collision_as<RecoMCCollisions>(), mcParticles);
+        fillTrackHistograms_MC<i>(track, mcParticle, collision, mcParticles, multiplicity);
       });
     }
     if (includeCentralityMC) {
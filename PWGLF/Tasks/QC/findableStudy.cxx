@@ -35,6 +35,7 @@
 #include "PWGLF/DataModel/LFStrangenessPIDTables.h"
 #include "PWGLF/DataModel/LFParticleIdentification.h"
 #include "Common/Core/TrackSelection.h"
+#include "Common/Core/VariationSet.h"
 #include "Common/DataModel/McCollisionExtra.h"
 #include "Common/DataModel/TrackSelectionTables.h"
 #include "Common/DataModel/EventSelection.h"
@@ -51,6 +52,7 @@
 
 #include <TFile.h>
 #include <TH2F.h>
+#include <TH3.h>
 #include <TProfile.h>
 #include <TLorentzVector.h>
 #include <TPDGCode.h>
@@ -67,6 +69,10 @@ using reconstructedV0sNoMC = soa::Join<aod::V0Cores, aod::V0Extras>;
 
 using dauTracks = soa::Join<aod::DauTrackExtras, aod::DauTrackTPCPIDs>;
 
+// default systematic variations of the V0 selections (columns: v0SelectionGroup members)
+static const std::vector<std::string> v0VariationParameters{"v0cospa", "dcav0dau", "dcanegtopv", "dcapostopv", "v0radius"};
+static const float v0VariationDefaults[1][5]{{0.97f, 1.0f, 0.05f, 0.05f, 1.2f}};
+
 // simple checkers, but ensure 64 bit integers
 #define bitset(var, nbit) ((var) |= (static_cast<uint64_t>(1) << static_cast<uint64_t>(nbit)))
 #define bitcheck(var, nbit) ((var) & (static_cast<uint64_t>(1) << static_cast<uint64_t>(nbit)))
@@ -84,6 +90,10 @@ struct findableStudy {
   // +-~-+-~-+-~-+-~-+-~-+-~-+-~-+-~-+-~-+-~-+-~-+-~-+-~-+-~-+-~-+
   // Full wrapper for configurables related to actual analysis
   Configurable<v0SelectionGroup> v0Selections{"v0Selections", {}, "V0 selection criteria for analysis"};
+
+  // systematic variations of v0Selections, evaluated in the same pass: one row per variation
+  Configurable<bool> doV0Variations{"doV0Variations", false, "evaluate the variations of the V0 selections"};
+  Configurable<LabeledArray<float>> v0Variations{"v0Variations", {v0VariationDefaults[0], 1, 5, {"nominal"}, v0VariationParameters}, "variations of the V0 selections: one row per variation, one column per v0SelectionGroup member changed"};
   // +-~-+-~-+-~-+-~-+-~-+-~-+-~-+-~-+-~-+-~-+-~-+-~-+-~-+-~-+-~-+
 
   // pack track quality but separte also afterburner
@@ -105,6 +115,10 @@ struct findableStudy {
   uint64_t maskSelectionLambda;
   uint64_t maskSelectionAntiLambda;
 
+  o2::analysis::VariationSet<v0SelectionGroup> variations;
+  std::vector<uint64_t> variationTrackMasks;   // per variation
+  std::vector<uint64_t> variationSpeciesMasks; // per variation, for the selected pdgCode
+
   void init(InitContext const&)
   {
     v0Selections->PrintSelections(); // for the logs
@@ -165,6 +179,22 @@ struct findableStudy {
     histos.add("h2dTrackPropAnalysisTracks", "h2dTrackPropAnalysisTracks", kTH3D, {{32, -0.5, 31.5f}, {32, -0.5, 31.5f}, axisCentrality});
     histos.add("h2dTrackPropAnalysisTopo", "h2dTrackPropAnalysisTopo", kTH3D, {{32, -0.5, 31.5f}, {32, -0.5, 31.5f}, axisCentrality});
     histos.add("h2dTrackPropAnalysisSpecies", "h2dTrackPropAnalysisSpecies", kTH3D, {{32, -0.5, 31.5f}, {32, -0.5, 31.5f}, axisCentrality});
+
+    if (doV0Variations) {
+      variations.build(v0Selections.value, v0Variations.value);
+      for (std::size_t i = 0; i < variations.size(); i++) {
+        uint64_t topological, trackProperties, k0Short, lambda, antiLambda;
+        variations[i].provideMasks(topological, trackProperties, k0Short, lambda, antiLambda);
+        uint64_t species = pdgCode == 3122 ? lambda : (pdgCode == -3122 ? antiLambda : k0Short);
+        variationTrackMasks.push_back(trackProperties);
+        variationSpeciesMasks.push_back(topological | species);
+      }
+      const AxisSpec axisVariation{static_cast<int>(variations.size()), -0.5f, variations.size() - 0.5f, "variation"};
+      auto h = histos.add<TH3>("h3dPtVsCentralityVsVariation_PassesThisSpecies", "h3dPtVsCentralityVsVariation_PassesThisSpecies", kTH3D, {axisCentrality, axisPt, axisVariation});
+      for (std::size_t i = 0; i < variations.size(); i++) {
+        h->GetZaxis()->SetBinLabel(i + 1, variations.name(i).c_str());
+      }
+    }
   }
 
   void processEvents(
@@ -368,7 +398,9 @@ struct findableStudy {
             histos.fill(HIST("h2dTrackPropFound"), positiveTrackCode, negativeTrackCode, centrality);
           }
 
-          uint64_t selMap = v0data::computeReconstructionBitmap(recv0, pTrack, nTrack, coll, recv0.yLambda(), recv0.yK0Short(), v0Selections);
+          // read once, evaluated for the nominal selections and for each variation
+          auto selQuantities = v0data::getSelectionQuantities(recv0, pTrack, nTrack, coll, recv0.yLambda(), recv0.yK0Short());
+          uint64_t selMap = v0data::computeReconstructionBitmap(selQuantities, v0Selections);
 
           // Consider in all cases
           selMap = selMap | (uint64_t(1) << v0data::selConsiderK0Short) | (uint64_t(1) << v0data::selConsiderLambda) | (uint64_t(1) << v0data::selConsiderAntiLambda);
@@ -403,6 +435,17 @@ struct findableStudy {
 
           // trackTPCPIDOK = v0Selections->verifyMask(selMap, tpcPidMask);
 
+          if (doV0Variations && pTrackOK && nTrackOK) {
+            const uint64_t consider = (uint64_t(1) << v0data::selConsiderK0Short) | (uint64_t(1) << v0data::selConsiderLambda) | (uint64_t(1) << v0data::selConsiderAntiLambda);
+            uint64_t passed = variations.accepted([&](const v0SelectionGroup& variation, std::size_t i) {
+              uint64_t variationMap = v0data::computeReconstructionBitmap(selQuantities, variation) | consider;
+              return variation.verifyMask(variationMap, variationTrackMasks[i] | variationSpeciesMasks[i]);
+            });
+            variations.forEach(passed, [&](std::size_t i) {
+              histos.fill(HIST("h3dPtVsCentralityVsVariation_PassesThisSpecies"), centrality, ptmc, i);
+            });
+          }
+
           // Broad level
           if (validTrackProperties) {
             histos.fill(HIST("h2dPtVsCentrality_PassesTrackQuality"), centrality, ptmc);
@@ -15,6 +15,7 @@
 
 // #include <TDatabasePDG.h>
 #include "PWGLF/DataModel/LFStrangenessTables.h" //
+#include "PWGLF/Utils/mixingPool.h"
 
 #include "Common/Core/TrackSelection.h"
 #include "Common/Core/trackUtilities.h"
@@ -131,6 +132,7 @@ struct HigherMassResonances {
     // Configurable for track selection and multiplicity
     Configurable<float> cfgPTcut{"cfgPTcut", 0.2f, "Track PT cut"};
     Configurable<int> cfgNmixedEvents{"cfgNmixedEvents", 5, "Number of mixed events"};
+    Configurable<int> cfgMixingPoolMaxCandidates{"cfgMixingPoolMaxCandidates", 100, "Maximum number of K0s stored per event in the mixing pools kept across DFs"};
     Configurable<bool> cfgMultFOTM{"cfgMultFOTM", true, "Use FOTM multiplicity if pp else use 0 here for PbPb (FT0C)"};
     ConfigurableAxis binsCent{"binsCent", {VARIABLE_WIDTH, 0., 5., 10., 30., 50., 70., 100., 110., 150.}, "Binning of the centrality axis"};
 
@@ -184,8 +186,20 @@ struct HigherMassResonances {
   // const double massK0s = o2::constants::physics::MassK0Short;
   bool isMix = false;
 
+  // K0s candidate stored in the mixing pools
+  struct MixingCandidate {
+    float px, py, pz, pt, eta, phi;
+    int posTrackId, negTrackId;
+  };
+  o2::pwglf::MixingPool<MixingCandidate> mixingPool;
+  std::vector<MixingCandidate> mixingCandidates;
+  Preslice<aod::V0Datas> perCollisionV0 = aod::v0data::collisionId;
+
   void init(InitContext const&)
   {
+    if (doprocessMEPool) {
+      mixingPool.init(mevz.value, memult.value, config.cfgNmixedEvents, config.cfgMixingPoolMaxCandidates);
+    }
     rctCut.rctChecker.init(
       rctCut.cfgEvtRCTFlagCheckerLabel,
       rctCut.cfgEvtRCTFlagCheckerZDCCheck,
@@ -982,6 +996,56 @@ struct HigherMassResonances {
   }
   PROCESS_SWITCH(HigherMassResonances, processME, "mixed event process", true);
 
+  // mixed event with the pools of the previous events of each bin, kept across DFs
+  void processMEPool(EventCandidates const& collisions, TrackCandidates const& /*tracks*/, V0TrackCandidate const& v0s)
+  {
+    mixingPool.newDataFrame();
+    for (const auto& collision : collisions) {
+      if (!eventselection(collision)) {
+        continue;
+      }
+      if (config.cfgMultFOTM && rctCut.requireRCTFlagChecker && !rctCut.rctChecker(collision)) {
+        continue;
+      }
+      multiplicity = config.cfgMultFOTM ? collision.centFT0M() : collision.centFT0C();
+      const int bin = mixingPool.getBin(collision.posZ(), multiplicity);
+      if (bin < 0) {
+        continue;
+      }
+
+      mixingCandidates.clear();
+      for (const auto& v0 : v0s.sliceBy(perCollisionV0, collision.globalIndex())) {
+        if (!selectionV0(collision, v0, multiplicity)) {
+          continue;
+        }
+        auto postrack = v0.template posTrack_as<TrackCandidates>();
+        auto negtrack = v0.template negTrack_as<TrackCandidates>();
+        if (!isSelectedV0Daughter(postrack, 1, postrack.tpcNSigmaPi(), v0) || !isSelectedV0Daughter(negtrack, -1, negtrack.tpcNSigmaPi(), v0)) {
+          continue;
+        }
+        mixingCandidates.push_back({v0.px(), v0.py(), v0.pz(), v0.pt(), v0.eta(), v0.phi(), static_cast<int>(postrack.globalIndex()), static_cast<int>(negtrack.globalIndex())});
+      }
+
+      mixingPool.forEachPair(bin, mixingCandidates, [&](const MixingCandidate& t1, const MixingCandidate& t2, bool sameDataFrame) {
+        if (sameDataFrame && (t1.posTrackId == t2.posTrackId || t1.negTrackId == t2.negTrackId)) {
+          return;
+        }
+        daughter1 = ROOT::Math::PxPyPzMVector(t1.px, t1.py, t1.pz, o2::constants::physics::MassK0Short); // Kshort
+
+        lv3.SetPtEtaPhiM(0.0, 0.0, 0.0, 0.0);
+        lv1.SetPtEtaPhiM(t1.pt, t1.eta, t1.phi, o2::constants::physics::MassK0Short);
+        lv2.SetPtEtaPhiM(t2.pt, t2.eta, t2.phi, o2::constants::physics::MassK0Short);
+        lv4.SetPtEtaPhiM(t1.pt, t1.eta, t1.phi + theta2, o2::constants::physics::MassK0Short); // for rotated background
+        lv3 = lv1 + lv2;
+        lv5 = lv2 + lv4;
+        isMix = true;
+        fillInvMass(lv3, lv5, multiplicity, daughter1, isMix);
+      });
+      mixingPool.push(bin, mixingCandidates);
+    }
+  }
+  PROCESS_SWITCH(HigherMassResonances, processMEPool, "mixed event process with pools kept across DFs", false);
+
   int counter = 0;
   float multiplicityGen = 0.0;
   void processGen(aod::McCollision const& mcCollision, aod::McParticles const& mcParticles, const soa::SmallGroups<EventCandidatesMC>& collisions)
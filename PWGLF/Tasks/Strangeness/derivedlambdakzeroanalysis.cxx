@@ -265,6 +265,18 @@ struct derivedlambdakzeroanalysis {
   int mRunNumber;
   std::map<std::string, std::string> metadata;
 
+  // daughter track selections, computed once per dataframe in a pass over the DauTracks columns
+  // and read by the V0 selection instead of evaluating them for every V0 sharing the daughter
+  enum dauTrackSelection : uint8_t { kDauGoodITSClusters = 0, // ITS clusters and chi2 per cluster
+                                     kDauITSAfterburner,
+                                     kDauGoodTPCTrack,
+                                     kDauTPCPIDPion,
+                                     kDauTPCPIDProton,
+                                     kDauItsOnly,
+                                     kDauNotTPCOnly };
+  std::vector<uint8_t> dauTrackSelMaps;
+  int64_t lastCollisionIndex = -1;
+
   static constexpr float DefaultLifetimeCuts[1][2] = {{30., 20.}};
   Configurable<LabeledArray<float>> lifetimecut{"lifetimecut", {DefaultLifetimeCuts[0], 2, {"lifetimecutLambda", "lifetimecutK0S"}}, "lifetimecut"};
 
@@ -1028,47 +1040,37 @@ struct derivedlambdakzeroanalysis {
     if (std::abs(rapidityK0Short) < v0Selections.rapidityCut)
       BITSET(bitMap, selK0ShortRapidity);
 
-    auto posTrackExtra = v0.template posTrackExtra_as<DauTracks>();
-    auto negTrackExtra = v0.template negTrackExtra_as<DauTracks>();
+    const uint8_t posTrackSelMap = dauTrackSelMaps[v0.posTrackExtraId()];
+    const uint8_t negTrackSelMap = dauTrackSelMaps[v0.negTrackExtraId()];
 
     // ITS quality flags
-    bool posIsFromAfterburner = posTrackExtra.hasITSAfterburner();
-    bool negIsFromAfterburner = negTrackExtra.hasITSAfterburner();
+    bool posIsFromAfterburner = BITCHECK(posTrackSelMap, kDauITSAfterburner);
+    bool negIsFromAfterburner = BITCHECK(negTrackSelMap, kDauITSAfterburner);
 
     // check minimum number of ITS clusters + maximum ITS chi2 per clusters + reject or select ITS afterburner tracks if requested
-    if (posTrackExtra.itsNCls() >= v0Selections.minITSclusters &&             // check minium ITS clusters
-        posTrackExtra.itsChi2NCl() < v0Selections.maxITSchi2PerNcls &&        // check maximum ITS chi2 per clusters
+    if (BITCHECK(posTrackSelMap, kDauGoodITSClusters) &&                      // check minium ITS clusters and maximum ITS chi2 per clusters
         (!v0Selections.rejectPosITSafterburner || !posIsFromAfterburner) &&   // reject afterburner track or not
         (!v0Selections.requirePosITSafterburnerOnly || posIsFromAfterburner)) // keep afterburner track or not
       BITSET(bitMap, selPosGoodITSTrack);
-    if (negTrackExtra.itsNCls() >= v0Selections.minITSclusters &&             // check minium ITS clusters
-        negTrackExtra.itsChi2NCl() < v0Selections.maxITSchi2PerNcls &&        // check maximum ITS chi2 per clusters
+    if (BITCHECK(negTrackSelMap, kDauGoodITSClusters) &&                      // check minium ITS clusters and maximum ITS chi2 per clusters
         (!v0Selections.rejectNegITSafterburner || !negIsFromAfterburner) &&   // reject afterburner track or not
         (!v0Selections.requireNegITSafterburnerOnly || negIsFromAfterburner)) // select only afterburner track or not
       BITSET(bitMap, selNegGoodITSTrack);
 
     // TPC quality flags
-    if (posTrackExtra.tpcCrossedRows() >= v0Selections.minTPCrows &&                                    // check minimum TPC crossed rows
-        posTrackExtra.tpcChi2NCl() < v0Selections.maxTPCchi2PerNcls &&                                  // check maximum TPC chi2 per clusters
-        posTrackExtra.tpcCrossedRowsOverFindableCls() >= v0Selections.minTPCrowsOverFindableClusters && // check minimum fraction of TPC rows over findable
-        posTrackExtra.tpcFoundOverFindableCls() >= v0Selections.minTPCfoundOverFindableClusters &&      // check minimum fraction of found over findable TPC clusters
-        posTrackExtra.tpcFractionSharedCls() < v0Selections.maxFractionTPCSharedClusters)               // check the maximum fraction of allowed shared TPC clusters
+    if (BITCHECK(posTrackSelMap, kDauGoodTPCTrack))
       BITSET(bitMap, selPosGoodTPCTrack);
-    if (negTrackExtra.tpcCrossedRows() >= v0Selections.minTPCrows &&                                    // check minimum TPC crossed rows
-        negTrackExtra.tpcChi2NCl() < v0Selections.maxTPCchi2PerNcls &&                                  // check maximum TPC chi2 per clusters
-        negTrackExtra.tpcCrossedRowsOverFindableCls() >= v0Selections.minTPCrowsOverFindableClusters && // check minimum fraction of TPC rows over findable
-        negTrackExtra.tpcFoundOverFindableCls() >= v0Selections.minTPCfoundOverFindableClusters &&      // check minimum fraction of found over findable TPC clusters
-        negTrackExtra.tpcFractionSharedCls() < v0Selections.maxFractionTPCSharedClusters)               // check the maximum fraction of allowed shared TPC clusters
+    if (BITCHECK(negTrackSelMap, kDauGoodTPCTrack))
       BITSET(bitMap, selNegGoodTPCTrack);
 
     // TPC PID
-    if (std::fabs(posTrackExtra.tpcNSigmaPi()) < v0Selections.tpcPidNsigmaCut)
+    if (BITCHECK(posTrackSelMap, kDauTPCPIDPion))
       BITSET(bitMap, selTPCPIDPositivePion);
-    if (std::fabs(posTrackExtra.tpcNSigmaPr()) < v0Selections.tpcPidNsigmaCut)
+    if (BITCHECK(posTrackSelMap, kDauTPCPIDProton))
       BITSET(bitMap, selTPCPIDPositiveProton);
-    if (std::fabs(negTrackExtra.tpcNSigmaPi()) < v0Selections.tpcPidNsigmaCut)
+    if (BITCHECK(negTrackSelMap, kDauTPCPIDPion))
       BITSET(bitMap, selTPCPIDNegativePion);
-    if (std::fabs(negTrackExtra.tpcNSigmaPr()) < v0Selections.tpcPidNsigmaCut)
+    if (BITCHECK(negTrackSelMap, kDauTPCPIDProton))
       BITSET(bitMap, selTPCPIDNegativeProton);
 
     // TOF PID in DeltaT
@@ -1104,15 +1106,15 @@ struct derivedlambdakzeroanalysis {
       BITSET(bitMap, selTOFNSigmaNegativePionK0Short);
 
     // ITS only tag
-    if (posTrackExtra.tpcCrossedRows() < 1)
+    if (BITCHECK(posTrackSelMap, kDauItsOnly))
       BITSET(bitMap, selPosItsOnly);
-    if (negTrackExtra.tpcCrossedRows() < 1)
+    if (BITCHECK(negTrackSelMap, kDauItsOnly))
       BITSET(bitMap, selNegItsOnly);
 
     // TPC only tag
-    if (posTrackExtra.detectorMap() != o2::aod::track::TPC)
+    if (BITCHECK(posTrackSelMap, kDauNotTPCOnly))
       BITSET(bitMap, selPosNotTPCOnly);
-    if (negTrackExtra.detectorMap() != o2::aod::track::TPC)
+    if (BITCHECK(negTrackSelMap, kDauNotTPCOnly))
       BITSET(bitMap, selNegNotTPCOnly);
 
     // proper lifetime
@@ -1128,6 +1130,40 @@ struct derivedlambdakzeroanalysis {
     return bitMap;
   }
 
+  template <typename TCollision, typename TDauTracks>
+  void computeDauTrackSelections(TCollision const& collision, TDauTracks const& dauTracks)
+  {
+    // the collisions of a dataframe come in increasing order: a new dataframe starts when the index does not increase
+    bool newDataframe = collision.globalIndex() <= lastCollisionIndex || dauTrackSelMaps.size() != static_cast<std::size_t>(dauTracks.size());
+    lastCollisionIndex = collision.globalIndex();
+    if (!newDataframe) {
+      return;
+    }
+    dauTrackSelMaps.resize(dauTracks.size());
+    for (auto const& track : dauTracks) {
+      uint8_t selMap = 0;
+      if (track.itsNCls() >= v0Selections.minITSclusters && track.itsChi2NCl() < v0Selections.maxITSchi2PerNcls)
+        BITSET(selMap, kDauGoodITSClusters);
+      if (track.hasITSAfterburner())
+        BITSET(selMap, kDauITSAfterburner);
+      if (track.tpcCrossedRows() >= v0Selections.minTPCrows &&                                    // check minimum TPC crossed rows
+          track.tpcChi2NCl() < v0Selections.maxTPCchi2PerNcls &&                                  // check maximum TPC chi2 per clusters
+          track.tpcCrossedRowsOverFindableCls() >= v0Selections.minTPCrowsOverFindableClusters && // check minimum fraction of TPC rows over findable
+          track.tpcFoundOverFindableCls() >= v0Selections.minTPCfoundOverFindableClusters &&      // check minimum fraction of found over findable TPC clusters
+          track.tpcFractionSharedCls() < v0Selections.maxFractionTPCSharedClusters)               // check the maximum fraction of allowed shared TPC clusters
+        BITSET(selMap, kDauGoodTPCTrack);
+      if (std::fabs(track.tpcNSigmaPi()) < v0Selections.tpcPidNsigmaCut)
+        BITSET(selMap, kDauTPCPIDPion);
+      if (std::fabs(track.tpcNSigmaPr()) < v0Selections.tpcPidNsigmaCut)
+        BITSET(selMap, kDauTPCPIDProton);
+      if (track.tpcCrossedRows() < 1)
+        BITSET(selMap, kDauItsOnly);
+      if (track.detectorMap() != o2::aod::track::TPC)
+        BITSET(selMap, kDauNotTPCOnly);
+      dauTrackSelMaps[track.globalIndex()] = selMap;
+    }
+  }
+
   template <typename TV0>
   uint64_t computeMCAssociation(TV0 v0)
   // precalculate this information so that a check is one mask operation, not many
@@ -2127,8 +2163,10 @@ struct derivedlambdakzeroanalysis {
   // ______________________________________________________
   // Real data processing - no MC subscription
   template <typename TCollision, typename TV0s>
-  void analyzeRecoedV0sInRealData(TCollision const& collision, TV0s const& fullV0s)
+  void analyzeRecoedV0sInRealData(TCollision const& collision, TV0s const& fullV0s, DauTracks const& dauTracks)
   {
+    computeDauTrackSelections(collision, dauTracks);
+
     // Fire up CCDB
     if ((mlConfigurations.useK0ShortScores && mlConfigurations.calculateK0ShortScores) ||
         (mlConfigurations.useLambdaScores && mlConfigurations.calculateLambdaScores) ||
@@ -2195,8 +2233,10 @@ struct derivedlambdakzeroanalysis {
   // ______________________________________________________
   // Simulated processing (subscribes to MC information too)
   template <typename TCollision, typename TV0s>
-  void analyzeRecoedV0sInMonteCarlo(TCollision const& collision, TV0s const& fullV0s)
+  void analyzeRecoedV0sInMonteCarlo(TCollision const& collision, TV0s const& fullV0s, DauTracks const& dauTracks)
   {
+    computeDauTrackSelections(collision, dauTracks);
+
     // Fire up CCDB
     if ((mlConfigurations.useK0ShortScores && mlConfigurations.calculateK0ShortScores) ||
         (mlConfigurations.useLambdaScores && mlConfigurations.calculateLambdaScores) ||
@@ -2442,30 +2482,30 @@ struct derivedlambdakzeroanalysis {
 
   // ______________________________________________________
   // Real data processing in Run 3 - no MC subscription
-  void processRealDataRun3(soa::Join<aod::StraCollisions, aod::StraCents, aod::StraEvSels, aod::StraStamps>::iterator const& collision, V0Candidates const& fullV0s, DauTracks const&)
+  void processRealDataRun3(soa::Join<aod::StraCollisions, aod::StraCents, aod::StraEvSels, aod::StraStamps>::iterator const& collision, V0Candidates const& fullV0s, DauTracks const& dauTracks)
   {
-    analyzeRecoedV0sInRealData(collision, fullV0s);
+    analyzeRecoedV0sInRealData(collision, fullV0s, dauTracks);
   }
 
   // ______________________________________________________
   // Real data processing in Run 2 - no MC subscription
-  void processRealDataRun2(soa::Join<aod::StraCollisions, aod::StraCentsRun2, aod::StraEvSelsRun2, aod::StraStamps>::iterator const& collision, V0Candidates const& fullV0s, DauTracks const&)
+  void processRealDataRun2(soa::Join<aod::StraCollisions, aod::StraCentsRun2, aod::StraEvSelsRun2, aod::StraStamps>::iterator const& collision, V0Candidates const& fullV0s, DauTracks const& dauTracks)
   {
-    analyzeRecoedV0sInRealData(collision, fullV0s);
+    analyzeRecoedV0sInRealData(collision, fullV0s, dauTracks);
   }
 
   // ______________________________________________________
   // Simulated processing in Run 3 (subscribes to MC information too)
-  void processMonteCarloRun3(soa::Join<aod::StraCollisions, aod::StraCents, aod::StraEvSels, aod::StraStamps, aod::StraCollLabels>::iterator const& collision, V0McCandidates const& fullV0s, DauTracks const&, aod::MotherMCParts const&, soa::Join<aod::StraMCCollisions, aod::StraMCCollMults> const& /*mccollisions*/, soa::Join<aod::V0MCCores, aod::V0MCCollRefs> const&)
+  void processMonteCarloRun3(soa::Join<aod::StraCollisions, aod::StraCents, aod::StraEvSels, aod::StraStamps, aod::StraCollLabels>::iterator const& collision, V0McCandidates const& fullV0s, DauTracks const& dauTracks, aod::MotherMCParts const&, soa::Join<aod::StraMCCollisions, aod::StraMCCollMults> const& /*mccollisions*/, soa::Join<aod::V0MCCores, aod::V0MCCollRefs> const&)
   {
-    analyzeRecoedV0sInMonteCarlo(collision, fullV0s);
+    analyzeRecoedV0sInMonteCarlo(collision, fullV0s, dauTracks);
   }
 
   // ______________________________________________________
   // Simulated processing in Run 2 (subscribes to MC information too)
-  void processMonteCarloRun2(soa::Join<aod::StraCollisions, aod::StraCentsRun2, aod::StraEvSelsRun2, aod::StraStamps, aod::StraCollLabels>::iterator const& collision, V0McCandidates const& fullV0s, DauTracks const&, aod::MotherMCParts const&, soa::Join<aod::StraMCCollisions, aod::StraMCCollMults> const& /*mccollisions*/, soa::Join<aod::V0MCCores, aod::V0MCCollRefs> const&)
+  void processMonteCarloRun2(soa::Join<aod::StraCollisions, aod::StraCentsRun2, aod::StraEvSelsRun2, aod::StraStamps, aod::StraCollLabels>::iterator const& collision, V0McCandidates const& fullV0s, DauTracks const& dauTracks, aod::MotherMCParts const&, soa::Join<aod::StraMCCollisions, aod::StraMCCollMults> const& /*mccollisions*/, soa::Join<aod::V0MCCores, aod::V0MCCollRefs> const&)
   {
-    analyzeRecoedV0sInMonteCarlo(collision, fullV0s);
+    analyzeRecoedV0sInMonteCarlo(collision, fullV0s, dauTracks);
   }
 
   // ______________________________________________________
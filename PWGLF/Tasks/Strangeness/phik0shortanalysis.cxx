@@ -898,6 +898,74 @@ struct Phik0shortanalysis {
     return phiPurityFunctions[multIdx][pTIdx]->Eval(Phi.M());
   }
 
+  // Reconstruct the Phi candidates of the collision once, to be reused for every associated particle
+  template <bool isMC, typename T1, typename T2>
+  void buildPhiCandidates(const T1& posThisColl, const T2& negThisColl, float multiplicity, std::vector<ROOT::Math::PxPyPzMVector>& listrecPhi, std::vector<double>& listPhiPurity)
+  {
+    listrecPhi.clear();
+    listPhiPurity.clear();
+
+    // Loop over positive tracks
+    for (const auto& track1 : posThisColl) {
+      if (!selectionTrackResonance<isMC>(track1, false) || !selectionPIDKaonpTdependent(track1))
+        continue; // topological and PID selection
+
+      auto track1ID = track1.globalIndex();
+
+      // Loop over all negative tracks
+      for (const auto& track2 : negThisColl) {
+        if (!selectionTrackResonance<isMC>(track2, false) || !selectionPIDKaonpTdependent(track2))
+          continue; // topological and PID selection
+
+        auto track2ID = track2.globalIndex();
+        if (track2ID == track1ID)
+          continue; // condition to avoid double counting of pair
+
+        if constexpr (isMC) {
+          if (cfgisRecMCWPDGForClosure2) {
+            if (!track1.has_mcParticle())
+              continue;
+            auto mcTrack1 = track1.template mcParticle_as<aod::McParticles>();
+            if (mcTrack1.pdgCode() != PDG_t::kKPlus || !mcTrack1.isPhysicalPrimary())
+              continue;
+
+            if (!track2.has_mcParticle())
+              continue;
+            auto mcTrack2 = track2.template mcParticle_as<aod::McParticles>();
+            if (mcTrack2.pdgCode() != PDG_t::kKMinus || !mcTrack2.isPhysicalPrimary())
+              continue;
+
+            bool isMCMotherPhi = false;
+            for (const auto& motherOfMcTrack1 : mcTrack1.template mothers_as<aod::McParticles>()) {
+              for (const auto& motherOfMcTrack2 : mcTrack2.template mothers_as<aod::McParticles>()) {
+                if (motherOfMcTrack1.pdgCode() != motherOfMcTrack2.pdgCode())
+                  continue;
+                if (motherOfMcTrack1.globalIndex() != motherOfMcTrack2.globalIndex())
+                  continue;
+                if (motherOfMcTrack1.pdgCode() != o2::constants::physics::Pdg::kPhi)
+                  continue;
+                isMCMotherPhi = true;
+              }
+            }
+            if (!isMCMotherPhi)
+              continue;
+          }
+        }
+
+        ROOT::Math::PxPyPzMVector recPhi = recMother(track1, track2, massKa, massKa);
+        if (recPhi.Pt() < minPhiPt || recPhi.Pt() > maxPhiPt)
+          continue;
+        if (recPhi.M() < lowMPhi || recPhi.M() > upMPhi)
+          continue;
+        if (std::abs(recPhi.Rapidity()) > cfgYAcceptance)
+          continue;
+
+        listrecPhi.push_back(recPhi);
+        listPhiPurity.push_back(fillMethodSingleWeight ? getPhiPurity(multiplicity, recPhi) : 0.);
+      }
+    }
+  }
+
   // Fill 2D invariant mass histogram for V0 and Phi
   template <bool isMC, typename T>
   void fillInvMass2D(const T& V0, const std::vector<ROOT::Math::PxPyPzMVector>& listPhi, float multiplicity, const std::vector<float>& weights)
@@ -1118,6 +1186,11 @@ struct Phik0shortanalysis {
     auto posThisColl = posTracks->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache);
     auto negThisColl = negTracks->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache);
 
+    // Phi reconstruction, once for all the associated particles
+    std::vector<ROOT::Math::PxPyPzMVector> listrecPhi;
+    std::vector<double> listPhiPurity;
+    buildPhiCandidates<false>(posThisColl, negThisColl, multiplicity, listrecPhi, listPhiPurity);
+
     // V0 already reconstructed by the builder
     for (const auto& v0 : V0s) {
       const auto& posDaughterTrack = v0.posTrack_as<V0DauTracks>();
@@ -1134,50 +1207,17 @@ struct Phik0shortanalysis {
       if (std::abs(v0.yK0Short()) > cfgYAcceptance)
         continue;
 
-      std::vector<ROOT::Math::PxPyPzMVector> listrecPhi;
       std::vector<int> counts(cfgDeltaYAcceptanceBins->size() + 1, 0);
       std::vector<float> weights(cfgDeltaYAcceptanceBins->size() + 1, 1);
 
-      // Phi reconstruction
-      // Loop over positive tracks
-      for (const auto& track1 : posThisColl) {
-        if (!selectionTrackResonance<false>(track1, false) || !selectionPIDKaonpTdependent(track1))
-          continue; // topological and PID selection
-
-        auto track1ID = track1.globalIndex();
-
-        // Loop over all negative tracks
-        for (const auto& track2 : negThisColl) {
-          if (!selectionTrackResonance<false>(track2, false) || !selectionPIDKaonpTdependent(track2))
-            continue; // topological and PID selection
-
-          auto track2ID = track2.globalIndex();
-          if (track2ID == track1ID)
-            continue; // condition to avoid double counting of pair
-
-          ROOT::Math::PxPyPzMVector recPhi = recMother(track1, track2, massKa, massKa);
-          if (recPhi.Pt() < minPhiPt || recPhi.Pt() > maxPhiPt)
-            continue;
-          if (recPhi.M() < lowMPhi || recPhi.M() > upMPhi)
-            continue;
-          if (std::abs(recPhi.Rapidity()) > cfgYAcceptance)
+      for (size_t iPhi = 0; iPhi < listrecPhi.size(); iPhi++) {
+        counts.at(0)++;
+        weights.at(0) *= (1 - listPhiPurity[iPhi]);
+        for (size_t i = 0; i < cfgDeltaYAcceptanceBins->size(); i++) {
+          if (std::abs(v0.yK0Short() - listrecPhi[iPhi].Rapidity()) > cfgDeltaYAcceptanceBins->at(i))
             continue;
-
-          double phiPurity{};
-          if (fillMethodSingleWeight)
-            phiPurity = getPhiPurity(multiplicity, recPhi);
-
-          if (fillMethodMultipleWeights)
-            listrecPhi.push_back(recPhi);
-
-          counts.at(0)++;
-          weights.at(0) *= (1 - phiPurity);
-          for (size_t i = 0; i < cfgDeltaYAcceptanceBins->size(); i++) {
-            if (std::abs(v0.yK0Short() - recPhi.Rapidity()) > cfgDeltaYAcceptanceBins->at(i))
-              continue;
-            counts.at(i + 1)++;
-            weights.at(i + 1) *= (1 - phiPurity);
-          }
+          counts.at(i + 1)++;
+          weights.at(i + 1) *= (1 - listPhiPurity[iPhi]);
         }
       }
 
@@ -1209,6 +1249,11 @@ struct Phik0shortanalysis {
     auto posThisColl = posTracks->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache);
     auto negThisColl = negTracks->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache);
 
+    // Phi reconstruction, once for all the associated particles
+    std::vector<ROOT::Math::PxPyPzMVector> listrecPhi;
+    std::vector<double> listPhiPurity;
+    buildPhiCandidates<false>(posThisColl, negThisColl, multiplicity, listrecPhi, listPhiPurity);
+
     // Loop over all primary pion candidates
     for (const auto& track : fullTracks) {
 
@@ -1221,50 +1266,17 @@ struct Phik0shortanalysis {
       if (std::abs(track.rapidity(massPi)) > cfgYAcceptance)
         continue;
 
-      std::vector<ROOT::Math::PxPyPzMVector> listrecPhi;
       std::vector<int> counts(cfgDeltaYAcceptanceBins->size() + 1, 0);
       std::vector<float> weights(cfgDeltaYAcceptanceBins->size() + 1, 1);
 
-      // Phi reconstruction
-      // Loop over positive tracks
-      for (const auto& track1 : posThisColl) { // loop over all selected tracks
-        if (!selectionTrackResonance<false>(track1, false) || !selectionPIDKaonpTdependent(track1))
-          continue; // topological and PID selection
-
-        auto track1ID = track1.globalIndex();
-
-        // Loop over all negative tracks
-        for (const auto& track2 : negThisColl) {
-          if (!selectionTrackResonance<false>(track2, false) || !selectionPIDKaonpTdependent(track2))
-            continue; // topological and PID selection
-
-          auto track2ID = track2.globalIndex();
-          if (track2ID == track1ID)
-            continue; // condition to avoid double counting of pair
-
-          ROOT::Math::PxPyPzMVector recPhi = recMother(track1, track2, massKa, massKa);
-          if (recPhi.Pt() < minPhiPt || recPhi.Pt() > maxPhiPt)
-            continue;
-          if (recPhi.M() < lowMPhi || recPhi.M() > upMPhi)
-            continue;
-          if (std::abs(recPhi.Rapidity()) > cfgYAcceptance)
+      for (size_t iPhi = 0; iPhi < listrecPhi.size(); iPhi++) {
+        counts.at(0)++;
+        weights.at(0) *= (1 - listPhiPurity[iPhi]);
+        for (size_t i = 0; i < cfgDeltaYAcceptanceBins->size(); i++) {
+          if (std::abs(track.rapidity(massPi) - listrecPhi[iPhi].Rapidity()) > cfgDeltaYAcceptanceBins->at(i))
             continue;
-
-          double phiPurity{};
-          if (fillMethodSingleWeight)
-            phiPurity = getPhiPurity(multiplicity, recPhi);
-
-          if (fillMethodMultipleWeights)
-            listrecPhi.push_back(recPhi);
-
-          counts.at(0)++;
-          weights.at(0) *= (1 - phiPurity);
-          for (size_t i = 0; i < cfgDeltaYAcceptanceBins->size(); i++) {
-            if (std::abs(track.rapidity(massPi) - recPhi.Rapidity()) > cfgDeltaYAcceptanceBins->at(i))
-              continue;
-            counts.at(i + 1)++;
-            weights.at(i + 1) *= (1 - phiPurity);
-          }
+          counts.at(i + 1)++;
+          weights.at(i + 1) *= (1 - listPhiPurity[iPhi]);
         }
       }
 
@@ -1764,6 +1776,11 @@ struct Phik0shortanalysis {
     auto posThisColl = posMCTracks->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache);
     auto negThisColl = negMCTracks->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache);
 
+    // Phi reconstruction, once for all the associated particles
+    std::vector<ROOT::Math::PxPyPzMVector> listrecPhi;
+    std::vector<double> listPhiPurity;
+    buildPhiCandidates<true>(posThisColl, negThisColl, genmultiplicity, listrecPhi, listPhiPurity);
+
     // V0 already reconstructed by the builder
     for (const auto& v0 : V0s) {
       if (cfgisRecMCWPDGForClosure1) {
@@ -1785,77 +1802,17 @@ struct Phik0shortanalysis {
       if (std::abs(v0.yK0Short()) > cfgYAcceptance)
         continue;
 
-      std::vector<ROOT::Math::PxPyPzMVector> listrecPhi;
       std::vector<int> counts(cfgDeltaYAcceptanceBins->size() + 1, 0);
       std::vector<float> weights(cfgDeltaYAcceptanceBins->size() + 1, 1);
 
-      // Phi reconstruction
-      for (const auto& track1 : posThisColl) { // loop over all selected tracks
-        if (!selectionTrackResonance<true>(track1, false) || !selectionPIDKaonpTdependent(track1))
-          continue; // topological and PID selection
-
-        auto track1ID = track1.globalIndex();
-
-        for (const auto& track2 : negThisColl) {
-          if (!selectionTrackResonance<true>(track2, false) || !selectionPIDKaonpTdependent(track2))
-            continue; // topological and PID selection
-
-          auto track2ID = track2.globalIndex();
-          if (track2ID == track1ID)
-            continue; // condition to avoid double counting of pair
-
-          if (cfgisRecMCWPDGForClosure2) {
-            if (!track1.has_mcParticle())
-              continue;
-            auto mcTrack1 = track1.mcParticle_as<aod::McParticles>();
-            if (mcTrack1.pdgCode() != PDG_t::kKPlus || !mcTrack1.isPhysicalPrimary())
-              continue;
-
-            if (!track2.has_mcParticle())
-              continue;
-            auto mcTrack2 = track2.mcParticle_as<aod::McParticles>();
-            if (mcTrack2.pdgCode() != PDG_t::kKMinus || !mcTrack2.isPhysicalPrimary())
-              continue;
-
-            bool isMCMotherPhi = false;
-            for (const auto& motherOfMcTrack1 : mcTrack1.mothers_as<aod::McParticles>()) {
-              for (const auto& motherOfMcTrack2 : mcTrack2.mothers_as<aod::McParticles>()) {
-                if (motherOfMcTrack1.pdgCode() != motherOfMcTrack2.pdgCode())
-                  continue;
-                if (motherOfMcTrack1.globalIndex() != motherOfMcTrack2.globalIndex())
-                  continue;
-                if (motherOfMcTrack1.pdgCode() != o2::constants::physics::Pdg::kPhi)
-                  continue;
-                isMCMotherPhi = true;
-              }
-            }
-            if (!isMCMotherPhi)
-              continue;
-          }
-
-          ROOT::Math::PxPyPzMVector recPhi = recMother(track1, track2, massKa, massKa);
-          if (recPhi.Pt() < minPhiPt || recPhi.Pt() > maxPhiPt)
-            continue;
-          if (recPhi.M() < lowMPhi || recPhi.M() > upMPhi)
-            continue;
-          if (std::abs(recPhi.Rapidity()) > cfgYAcceptance)
+      for (size_t iPhi = 0; iPhi < listrecPhi.size(); iPhi++) {
+        counts.at(0)++;
+        weights.at(0) *= (1 - listPhiPurity[iPhi]);
+        for (size_t i = 0; i < cfgDeltaYAcceptanceBins->size(); i++) {
+          if (std::abs(v0.yK0Short() - listrecPhi[iPhi].Rapidity()) > cfgDeltaYAcceptanceBins->at(i))
             continue;
-
-          double phiPurity{};
-          if (fillMethodSingleWeight)
-            phiPurity = getPhiPurity(genmultiplicity, recPhi);
-
-          if (fillMethodMultipleWeights)
-            listrecPhi.push_back(recPhi);
-
-          counts.at(0)++;
-          weights.at(0) *= (1 - phiPurity);
-          for (size_t i = 0; i < cfgDeltaYAcceptanceBins->size(); i++) {
-            if (std::abs(v0.yK0Short() - recPhi.Rapidity()) > cfgDeltaYAcceptanceBins->at(i))
-              continue;
-            counts.at(i + 1)++;
-            weights.at(i + 1) *= (1 - phiPurity);
-          }
+          counts.at(i + 1)++;
+          weights.at(i + 1) *= (1 - listPhiPurity[iPhi]);
         }
       }
 
@@ -1890,6 +1847,11 @@ struct Phik0shortanalysis {
     auto posThisColl = posMCTracks->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache);
     auto negThisColl = negMCTracks->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache);
 
+    // Phi reconstruction, once for all the associated particles
+    std::vector<ROOT::Math::PxPyPzMVector> listrecPhi;
+    std::vector<double> listPhiPurity;
+    buildPhiCandidates<true>(posThisColl, negThisColl, genmultiplicity, listrecPhi, listPhiPurity);
+
     // Loop over all primary pion candidates
     for (const auto& track : fullMCTracks) {
       if (cfgisRecMCWPDGForClosure1) {
@@ -1907,77 +1869,17 @@ struct Phik0shortanalysis {
       if (std::abs(track.rapidity(massPi)) > cfgYAcceptance)
         continue;
 
-      std::vector<ROOT::Math::PxPyPzMVector> listrecPhi;
       std::vector<int> counts(cfgDeltaYAcceptanceBins->size() + 1, 0);
       std::vector<float> weights(cfgDeltaYAcceptanceBins->size() + 1, 1);
 
-      // Phi reconstruction
-      for (const auto& track1 : posThisColl) { // loop over all selected tracks
-        if (!selectionTrackResonance<true>(track1, false) || !selectionPIDKaonpTdependent(track1))
-          continue; // topological and PID selection
-
-        auto track1ID = track1.globalIndex();
-
-        for (const auto& track2 : negThisColl) {
-          if (!selectionTrackResonance<true>(track2, false) || !selectionPIDKaonpTdependent(track2))
-            continue; // topological and PID selection
-
-          auto track2ID = track2.globalIndex();
-          if (track2ID == track1ID)
-            continue; // condition to avoid double counting of pair
-
-          if (cfgisRecMCWPDGForClosure2) {
-            if (!track1.has_mcParticle())
-              continue;
-            auto mcTrack1 = track1.mcParticle_as<aod::McParticles>();
-            if (mcTrack1.pdgCode() != PDG_t::kKPlus || !mcTrack1.isPhysicalPrimary())
-              continue;
-
-            if (!track2.has_mcParticle())
-              continue;
-            auto mcTrack2 = track2.mcParticle_as<aod::McParticles>();
-            if (mcTrack2.pdgCode() != PDG_t::kKMinus || !mcTrack2.isPhysicalPrimary())
-              continue;
-
-            bool isMCMotherPhi = false;
-            for (const auto& motherOfMcTrack1 : mcTrack1.mothers_as<aod::McParticles>()) {
-              for (const auto& motherOfMcTrack2 : mcTrack2.mothers_as<aod::McParticles>()) {
-                if (motherOfMcTrack1.pdgCode() != motherOfMcTrack2.pdgCode())
-                  continue;
-                if (motherOfMcTrack1.globalIndex() != motherOfMcTrack2.globalIndex())
-                  continue;
-                if (motherOfMcTrack1.pdgCode() != o2::constants::physics::Pdg::kPhi)
-                  continue;
-                isMCMotherPhi = true;
-              }
-            }
-            if (!isMCMotherPhi)
-              continue;
-          }
-
-          ROOT::Math::PxPyPzMVector recPhi = recMother(track1, track2, massKa, massKa);
-          if (recPhi.Pt() < minPhiPt || recPhi.Pt() > maxPhiPt)
-            continue;
-          if (recPhi.M() < lowMPhi || recPhi.M() > upMPhi)
-            continue;
-          if (std::abs(recPhi.Rapidity()) > cfgYAcceptance)
+      for (size_t iPhi = 0; iPhi < listrecPhi.size(); iPhi++) {
+        counts.at(0)++;
+        weights.at(0) *= (1 - listPhiPurity[iPhi]);
+        for (size_t i = 0; i < cfgDeltaYAcceptanceBins->size(); i++) {
+          if (std::abs(track.rapidity(massPi) - listrecPhi[iPhi].Rapidity()) > cfgDeltaYAcceptanceBins->at(i))
             continue;
-
-          double phiPurity{};
-          if (fillMethodSingleWeight)
-            phiPurity = getPhiPurity(genmultiplicity, recPhi);
-
-          if (fillMethodMultipleWeights)
-            listrecPhi.push_back(recPhi);
-
-          counts.at(0)++;
-          weights.at(0) *= (1 - phiPurity);
-          for (size_t i = 0; i < cfgDeltaYAcceptanceBins->size(); i++) {
-            if (std::abs(track.rapidity(massPi) - recPhi.Rapidity()) > cfgDeltaYAcceptanceBins->at(i))
-              continue;
-            counts.at(i + 1)++;
-            weights.at(i + 1) *= (1 - phiPurity);
-          }
+          counts.at(i + 1)++;
+          weights.at(i + 1) *= (1 - listPhiPurity[iPhi]);
         }
       }
 
@@ -194,6 +194,14 @@ struct StrangenessInJets {
   // Jet background subtraction
   JetBkgSubUtils backgroundSub;
 
+  // Directions of the selected jets and of their perpendicular cones, computed once per event
+  struct JetCones {
+    double etaJet, phiJet;
+    double etaUe1, phiUe1;
+    double etaUe2, phiUe2;
+  };
+  std::vector<JetCones> jetCones;
+
   void initCCDB(aod::BCsWithTimestamps::iterator const& bc)
   {
     if (cfgSkimmedProcessing) {
@@ -531,6 +539,30 @@ struct StrangenessInJets {
     return deltaPhi;
   }
 
+  void fillJetCones(const std::vector<TVector3>& selectedJet, const std::vector<TVector3>& ue1, const std::vector<TVector3>& ue2)
+  {
+    jetCones.clear();
+    for (std::size_t i = 0; i < selectedJet.size(); i++) {
+      jetCones.push_back({selectedJet[i].Eta(), selectedJet[i].Phi(), ue1[i].Eta(), ue1[i].Phi(), ue2[i].Eta(), ue2[i].Phi()});
+    }
+  }
+
+  // Whether the direction (eta, phi) is inside the jet cone and inside one of the two UE cones
+  void checkJetCones(double eta, double phi, const JetCones& cones, bool& isInJet, bool& isUe)
+  {
+    float deltaEtaJet = eta - cones.etaJet;
+    float deltaPhiJet = getDeltaPhi(phi, cones.phiJet);
+    float deltaRjet = std::sqrt(deltaEtaJet * deltaEtaJet + deltaPhiJet * deltaPhiJet);
+    float deltaEtaUe1 = eta - cones.etaUe1;
+    float deltaPhiUe1 = getDeltaPhi(phi, cones.phiUe1);
+    float deltaRue1 = std::sqrt(deltaEtaUe1 * deltaEtaUe1 + deltaPhiUe1 * deltaPhiUe1);
+    float deltaEtaUe2 = eta - cones.etaUe2;
+    float deltaPhiUe2 = getDeltaPhi(phi, cones.phiUe2);
+    float deltaRue2 = std::sqrt(deltaEtaUe2 * deltaEtaUe2 + deltaPhiUe2 * deltaPhiUe2);
+    isInJet = deltaRjet < rJet;
+    isUe = deltaRue1 < rJet || deltaRue2 < rJet;
+  }
+
   // ITS hit
   template <typename TrackIts>
   bool hasITSHit(const TrackIts& track, int layer)
@@ -1140,159 +1172,152 @@ struct StrangenessInJets {
 
     registryData.fill(HIST("number_of_events_vsmultiplicity"), multiplicity);
 
-    for (int i = 0; i < static_cast<int>(selectedJet.size()); i++) {
+    fillJetCones(selectedJet, ue1, ue2);
 
-      // KZeroLambda
-      if (particleOfInterest == Option::KZeroLambda) {
-        for (const auto& v0 : fullV0s) {
+    // KZeroLambda
+    if (particleOfInterest == Option::KZeroLambda) {
+      for (const auto& v0 : fullV0s) {
 
-          const auto& pos = v0.posTrack_as<StrHadronDaughterTracks>();
-          const auto& neg = v0.negTrack_as<StrHadronDaughterTracks>();
-          TVector3 v0dir(v0.px(), v0.py(), v0.pz());
+        const auto& pos = v0.posTrack_as<StrHadronDaughterTracks>();
+        const auto& neg = v0.negTrack_as<StrHadronDaughterTracks>();
+        const bool isK0s = passedK0ShortSelection(v0, pos, neg);
+        const bool isLambda = passedLambdaSelection(v0, pos, neg);
+        const bool isAntiLambda = passedAntiLambdaSelection(v0, pos, neg);
+        if (!isK0s && !isLambda && !isAntiLambda)
+          continue;
+        TVector3 v0dir(v0.px(), v0.py(), v0.pz());
+        const double v0Eta = v0dir.Eta();
+        const double v0Phi = v0dir.Phi();
 
-          float deltaEtaJet = v0dir.Eta() - selectedJet[i].Eta();
-          float deltaPhiJet = getDeltaPhi(v0dir.Phi(), selectedJet[i].Phi());
-          float deltaRjet = std::sqrt(deltaEtaJet * deltaEtaJet + deltaPhiJet * deltaPhiJet);
-          float deltaEtaUe1 = v0dir.Eta() - ue1[i].Eta();
-          float deltaPhiUe1 = getDeltaPhi(v0dir.Phi(), ue1[i].Phi());
-          float deltaRue1 = std::sqrt(deltaEtaUe1 * deltaEtaUe1 + deltaPhiUe1 * deltaPhiUe1);
-          float deltaEtaUe2 = v0dir.Eta() - ue2[i].Eta();
-          float deltaPhiUe2 = getDeltaPhi(v0dir.Phi(), ue2[i].Phi());
-          float deltaRue2 = std::sqrt(deltaEtaUe2 * deltaEtaUe2 + deltaPhiUe2 * deltaPhiUe2);
+        for (const auto& cones : jetCones) {
+          bool isInJet = false;
+          bool isUe = false;
+          checkJetCones(v0Eta, v0Phi, cones, isInJet, isUe);
 
           // K0s
-          if (passedK0ShortSelection(v0, pos, neg)) {
-            if (deltaRjet < rJet) {
+          if (isK0s) {
+            if (isInJet) {
               registryData.fill(HIST("K0s_in_jet"), multiplicity, v0.pt(), v0.mK0Short());
             }
-            if (deltaRue1 < rJet || deltaRue2 < rJet) {
+            if (isUe) {
               registryData.fill(HIST("K0s_in_ue"), multiplicity, v0.pt(), v0.mK0Short());
             }
           }
           // Lambda
-          if (passedLambdaSelection(v0, pos, neg)) {
-            if (deltaRjet < rJet) {
+          if (isLambda) {
+            if (isInJet) {
               registryData.fill(HIST("Lambda_in_jet"), multiplicity, v0.pt(), v0.mLambda());
             }
-            if (deltaRue1 < rJet || deltaRue2 < rJet) {
+            if (isUe) {
               registryData.fill(HIST("Lambda_in_ue"), multiplicity, v0.pt(), v0.mLambda());
             }
           }
           // AntiLambda
-          if (passedAntiLambdaSelection(v0, pos, neg)) {
-            if (deltaRjet < rJet) {
+          if (isAntiLambda) {
+            if (isInJet) {
               registryData.fill(HIST("AntiLambda_in_jet"), multiplicity, v0.pt(), v0.mAntiLambda());
             }
-            if (deltaRue1 < rJet || deltaRue2 < rJet) {
+            if (isUe) {
               registryData.fill(HIST("AntiLambda_in_ue"), multiplicity, v0.pt(), v0.mAntiLambda());
             }
           }
         }
       }
+    }
 
-      // Cascades
-      if (particleOfInterest == Option::CascadePart) {
-        for (const auto& casc : Cascades) {
-
-          auto bach = casc.bachelor_as<StrHadronDaughterTracks>();
-          auto pos = casc.posTrack_as<StrHadronDaughterTracks>();
-          auto neg = casc.negTrack_as<StrHadronDaughterTracks>();
-
-          TVector3 cascadeDir(casc.px(), casc.py(), casc.pz());
-          float deltaEtaJet = cascadeDir.Eta() - selectedJet[i].Eta();
-          float deltaPhiJet = getDeltaPhi(cascadeDir.Phi(), selectedJet[i].Phi());
-          float deltaRjet = std::sqrt(deltaEtaJet * deltaEtaJet + deltaPhiJet * deltaPhiJet);
-          float deltaEtaUe1 = cascadeDir.Eta() - ue1[i].Eta();
-          float deltaPhiUe1 = getDeltaPhi(cascadeDir.Phi(), ue1[i].Phi());
-          float deltaRue1 = std::sqrt(deltaEtaUe1 * deltaEtaUe1 + deltaPhiUe1 * deltaPhiUe1);
-          float deltaEtaUe2 = cascadeDir.Eta() - ue2[i].Eta();
-          float deltaPhiUe2 = getDeltaPhi(cascadeDir.Phi(), ue2[i].Phi());
-          float deltaRue2 = std::sqrt(deltaEtaUe2 * deltaEtaUe2 + deltaPhiUe2 * deltaPhiUe2);
+    // Cascades
+    if (particleOfInterest == Option::CascadePart) {
+      for (const auto& casc : Cascades) {
+
+        auto bach = casc.bachelor_as<StrHadronDaughterTracks>();
+        auto pos = casc.posTrack_as<StrHadronDaughterTracks>();
+        auto neg = casc.negTrack_as<StrHadronDaughterTracks>();
+        const bool isXi = passedXiSelection(casc, pos, neg, bach, collision);
+        const bool isOmega = passedOmegaSelection(casc, pos, neg, bach, collision);
+        if (!isXi && !isOmega)
+          continue;
+
+        TVector3 cascadeDir(casc.px(), casc.py(), casc.pz());
+        const double cascadeEta = cascadeDir.Eta();
+        const double cascadePhi = cascadeDir.Phi();
+
+        for (const auto& cones : jetCones) {
+          bool isInJet = false;
+          bool isUe = false;
+          checkJetCones(cascadeEta, cascadePhi, cones, isInJet, isUe);
 
           // Xi+
-          if (passedXiSelection(casc, pos, neg, bach, collision) &&
-              bach.sign() > 0) {
-            if (deltaRjet < rJet) {
+          if (isXi && bach.sign() > 0) {
+            if (isInJet) {
               registryData.fill(HIST("XiPos_in_jet"), multiplicity, casc.pt(), casc.mXi());
             }
-            if (deltaRue1 < rJet || deltaRue2 < rJet) {
+            if (isUe) {
               registryData.fill(HIST("XiPos_in_ue"), multiplicity, casc.pt(), casc.mXi());
             }
           }
           // Xi-
-          if (passedXiSelection(casc, pos, neg, bach, collision) &&
-              bach.sign() < 0) {
-            if (deltaRjet < rJet) {
+          if (isXi && bach.sign() < 0) {
+            if (isInJet) {
               registryData.fill(HIST("XiNeg_in_jet"), multiplicity, casc.pt(), casc.mXi());
             }
-            if (deltaRue1 < rJet || deltaRue2 < rJet) {
+            if (isUe) {
               registryData.fill(HIST("XiNeg_in_ue"), multiplicity, casc.pt(), casc.mXi());
             }
           }
           // Omega+
-          if (passedOmegaSelection(casc, pos, neg, bach, collision) &&
-              bach.sign() > 0) {
-            if (deltaRjet < rJet) {
+          if (isOmega && bach.sign() > 0) {
+            if (isInJet) {
               registryData.fill(HIST("OmegaPos_in_jet"), multiplicity, casc.pt(), casc.mOmega());
             }
-            if (deltaRue1 < rJet || deltaRue2 < rJet) {
+            if (isUe) {
               registryData.fill(HIST("OmegaPos_in_ue"), multiplicity, casc.pt(), casc.mOmega());
             }
           }
           // Omega-
-          if (passedOmegaSelection(casc, pos, neg, bach, collision) &&
-              bach.sign() < 0) {
-            if (deltaRjet < rJet) {
+          if (isOmega && bach.sign() < 0) {
+            if (isInJet) {
               registryData.fill(HIST("OmegaNeg_in_jet"), multiplicity, casc.pt(), casc.mOmega());
             }
-            if (deltaRue1 < rJet || deltaRue2 < rJet) {
+            if (isUe) {
               registryData.fill(HIST("OmegaNeg_in_ue"), multiplicity, casc.pt(), casc.mOmega());
             }
           }
         }
       }
+    }
 
-      // Pions
-      if (particleOfInterest == Option::ChargedPions) {
-        for (const auto& track : tracks) {
+    // Pions
+    if (particleOfInterest == Option::ChargedPions) {
+      for (const auto& track : tracks) {
 
-          if (!passedTrackSelectionForPions(track))
-            continue;
+        if (!passedTrackSelectionForPions(track))
+          continue;
 
-          TVector3 trackDir(track.px(), track.py(), track.pz());
-          const float deltaEtaJet = trackDir.Eta() - selectedJet[i].Eta();
-          const float deltaPhiJet = getDeltaPhi(trackDir.Phi(), selectedJet[i].Phi());
-          const float deltaRjet = std::sqrt(deltaEtaJet * deltaEtaJet + deltaPhiJet * deltaPhiJet);
-          const float deltaEtaUe1 = trackDir.Eta() - ue1[i].Eta();
-          const float deltaPhiUe1 = getDeltaPhi(trackDir.Phi(), ue1[i].Phi());
-          const float deltaRue1 = std::sqrt(deltaEtaUe1 * deltaEtaUe1 + deltaPhiUe1 * deltaPhiUe1);
-          const float deltaEtaUe2 = trackDir.Eta() - ue2[i].Eta();
-          const float deltaPhiUe2 = getDeltaPhi(trackDir.Phi(), ue2[i].Phi());
-          const float deltaRue2 = std::sqrt(deltaEtaUe2 * deltaEtaUe2 + deltaPhiUe2 * deltaPhiUe2);
-
-          float nsigmaTPC = 999.f;
-          float nsigmaTOF = 999.f;
-          switch (particleOfInterest) {
-            case Option::ChargedPions:
-              nsigmaTPC = track.tpcNSigmaPi();
-              nsigmaTOF = track.tofNSigmaPi();
-              break;
-            case Option::ChargedKaon:
-              nsigmaTPC = track.tpcNSigmaKa();
-              nsigmaTOF = track.tofNSigmaKa();
-              break;
-            case Option::ProtonAntiproton:
-              nsigmaTPC = track.tpcNSigmaPr();
-              nsigmaTOF = track.tofNSigmaPr();
-              break;
-          }
+        TVector3 trackDir(track.px(), track.py(), track.pz());
+        const double trackEta = trackDir.Eta();
+        const double trackPhi = trackDir.Phi();
+
+        float nsigmaTPC = 999.f;
+        float nsigmaTOF = 999.f;
+        switch (particleOfInterest) {
+          case Option::ChargedPions:
+            nsigmaTPC = track.tpcNSigmaPi();
+            nsigmaTOF = track.tofNSigmaPi();
+            break;
+          case Option::ChargedKaon:
+            nsigmaTPC = track.tpcNSigmaKa();
+            nsigmaTOF = track.tofNSigmaKa();
+            break;
+          case Option::ProtonAntiproton:
+            nsigmaTPC = track.tpcNSigmaPr();
+            nsigmaTOF = track.tofNSigmaPr();
+            break;
+        }
 
+        for (const auto& cones : jetCones) {
           bool isInJet = false;
           bool isUe = false;
-          if (deltaRjet < rJet)
-            isInJet = true;
-          if (deltaRue1 < rJet || deltaRue2 < rJet)
-            isUe = true;
+          checkJetCones(trackEta, trackPhi, cones, isInJet, isUe);
 
           if (isHighPurityPion(track, nsigmaTPC, nsigmaTOF)) {
             if (track.sign() > 0) {
@@ -2120,31 +2145,29 @@ struct StrangenessInJets {
       if (!isAtLeastOneJetSelected)
         continue;
 
-      // loop over selected jets / UE
-      for (int i = 0; i < static_cast<int>(selectedJet.size()); i++) {
-        for (const auto& particle : mcParticlesPerColl) {
+      // loop over particles and selected jets / UE
+      fillJetCones(selectedJet, ue1, ue2);
+      for (const auto& particle : mcParticlesPerColl) {
 
-          if (!particle.isPhysicalPrimary())
-            continue;
-          if (std::fabs(particle.eta()) > etaMax)
-            continue;
-          double ptMinPart = 0.1;
-          if (particle.pt() < ptMinPart)
-            continue;
+        if (!particle.isPhysicalPrimary())
+          continue;
+        if (std::fabs(particle.eta()) > etaMax)
+          continue;
+        double ptMinPart = 0.1;
+        if (particle.pt() < ptMinPart)
+          continue;
+
+        TVector3 particleDir(particle.px(), particle.py(), particle.pz());
+        const double particleEta = particleDir.Eta();
+        const double particlePhi = particleDir.Phi();
 
-          TVector3 particleDir(particle.px(), particle.py(), particle.pz());
-          float deltaEtaJet = particleDir.Eta() - selectedJet[i].Eta();
-          float deltaPhiJet = getDeltaPhi(particleDir.Phi(), selectedJet[i].Phi());
-          float deltaRjet = std::sqrt(deltaEtaJet * deltaEtaJet + deltaPhiJet * deltaPhiJet);
-          float deltaEtaUe1 = particleDir.Eta() - ue1[i].Eta();
-          float deltaPhiUe1 = getDeltaPhi(particleDir.Phi(), ue1[i].Phi());
-          float deltaRue1 = std::sqrt(deltaEtaUe1 * deltaEtaUe1 + deltaPhiUe1 * deltaPhiUe1);
-          float deltaEtaUe2 = particleDir.Eta() - ue2[i].Eta();
-          float deltaPhiUe2 = getDeltaPhi(particleDir.Phi(), ue2[i].Phi());
-          float deltaRue2 = std::sqrt(deltaEtaUe2 * deltaEtaUe2 + deltaPhiUe2 * deltaPhiUe2);
+        for (const auto& cones : jetCones) {
+          bool isInJet = false;
+          bool isUe = false;
+          checkJetCones(particleEta, particlePhi, cones, isInJet, isUe);
 
           // In jet
-          if (deltaRjet < rJet) {
+          if (isInJet) {
             switch (particle.pdgCode()) {
               /*
               case kPiPlus:
@@ -2180,7 +2203,7 @@ struct StrangenessInJets {
             }
           }
 
-          if (deltaRue1 < rJet || deltaRue2 < rJet) {
+          if (isUe) {
             switch (particle.pdgCode()) {
               /*
               case kPiPlus:
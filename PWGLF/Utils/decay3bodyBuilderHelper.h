@@ -15,6 +15,7 @@
 #include <cstdlib>
 #include <cmath>
 #include <array>
+#include <unordered_map>
 #include "DCAFitter/DCAFitterN.h"
 #include "Framework/AnalysisDataModel.h"
 #include "ReconstructionDataFormats/Track.h"
@@ -121,6 +122,21 @@ class decay3bodyBuilderHelper
 
   decay3bodyCandidate decay3body; // storage for Decay3body candidate properties
 
+  //_______________________________________________________________________
+  // KFParticle cache: the daughters are created once per track and mass hypothesis and the
+  // primary vertex once per collision, as the same tracks enter many candidates.
+  // To be cleared at the beginning of each DF and when the magnetic field changes.
+  enum kfSpecies { kfProton = 0,
+                   kfPion,
+                   kfDeuteron,
+                   kfNSpecies };
+
+  void clearKFCache()
+  {
+    kfDaughterCache.clear();
+    kfPvCollisionId = -1;
+  }
+
   o2::dataformats::VertexBase mMeanVertex{{0., 0., 0.}, {0.1 * 0.1, 0., 0.1 * 0.1, 0., 0., 6. * 6.}};
   o2::vertexing::SVertexHypothesis mV0Hyps; // 0 - Lambda, 1 - AntiLambda
 
@@ -505,14 +521,17 @@ class decay3bodyBuilderHelper
     auto trackParCovDeuteron = getTrackParCov(trackDeuteron);
 
     // initialise KF primary vertex
-    KFVertex kfpVertex = createKFPVertexFromCollision(collision);
-    KFParticle kfpv(kfpVertex);
+    if (kfPvCollisionId != collision.globalIndex()) {
+      KFVertex kfpVertex = createKFPVertexFromCollision(collision);
+      kfPvCache = KFParticle(kfpVertex);
+      kfPvCollisionId = collision.globalIndex();
+    }
+    const KFParticle& kfpv = kfPvCache;
 
-    // create KFParticle objects
-    KFParticle kfpProton, kfpPion, kfpDeuteron;
-    kfpProton = createKFParticleFromTrackParCov(trackParCovProton, trackProton.sign(), constants::physics::MassProton);
-    kfpPion = createKFParticleFromTrackParCov(trackParCovPion, trackPion.sign(), constants::physics::MassPionCharged);
-    kfpDeuteron = createKFParticleFromTrackParCov(trackParCovDeuteron, trackDeuteron.sign(), constants::physics::MassDeuteron);
+    // create KFParticle objects, copied from the cache as they are transported below
+    KFParticle kfpProton = getCachedKFParticle(trackProton, trackParCovProton, kfProton, constants::physics::MassProton);
+    KFParticle kfpPion = getCachedKFParticle(trackPion, trackParCovPion, kfPion, constants::physics::MassPionCharged);
+    KFParticle kfpDeuteron = getCachedKFParticle(trackDeuteron, trackParCovDeuteron, kfDeuteron, constants::physics::MassDeuteron);
 
     // construct V0 vertex
     KFParticle KFV0;
@@ -614,6 +633,18 @@ class decay3bodyBuilderHelper
     return;
   }
 
+  //_______________________________________________________________________
+  // daughter KFParticle from the cache, created at the first use of the track with this mass hypothesis
+  template <typename TTrack, typename TTrackParCov>
+  KFParticle const& getCachedKFParticle(TTrack const& track, TTrackParCov const& trackParCov, kfSpecies species, float mass)
+  {
+    auto [it, inserted] = kfDaughterCache.try_emplace(static_cast<int64_t>(track.globalIndex()) * kfNSpecies + species);
+    if (inserted) {
+      it->second = createKFParticleFromTrackParCov(trackParCov, track.sign(), mass);
+    }
+    return it->second;
+  }
+
   //_______________________________________________________________________
   // functionality to fit 3body vertex with DCAFitter
   template <typename TTrack>
@@ -838,6 +869,10 @@ class decay3bodyBuilderHelper
   }
 
  private:
+  std::unordered_map<int64_t, KFParticle> kfDaughterCache; // daughter KFParticles by track index and mass hypothesis
+  KFParticle kfPvCache;                                     // KF primary vertex of the collision kfPvCollisionId
+  int64_t kfPvCollisionId = -1;
+
   // internal helper to calculate DCA (3D) of a straight line to a given PV analytically
   float CalculateDCAStraightToPV(float X, float Y, float Z, float Px, float Py, float Pz, float pvX, float pvY, float pvZ)
   {
@@ -21,6 +21,8 @@
 
 #include "Framework/O2DatabasePDGPlugin.h"
 
+#include "Common/Core/PdgLookup.h"
+
 #include "TParticlePDG.h"
 
 #include <vector>
@@ -95,6 +97,15 @@ template <typename pdgDatabase>
 struct ParticleCounter {
   bool mSelectPrimaries = true;
   pdgDatabase* mPdgDatabase;
+  o2::common::core::PdgLookup mPdgLookup; // charges cached from mPdgDatabase
+
+  const o2::common::core::PdgLookup::Properties& getProperties(int pdgCode)
+  {
+    if (!mPdgLookup.hasDatabase()) {
+      mPdgLookup.setDatabase(mPdgDatabase->get());
+    }
+    return mPdgLookup.get(pdgCode);
+  }
 
   float countMultInAcceptance(const aod::McParticles& mcParticles, const float etamin, const float etamax)
   {
@@ -108,12 +119,12 @@ struct ParticleCounter {
       }
 
       // has pdg
-      TParticlePDG* p = mPdgDatabase->get()->GetParticle(particle.pdgCode());
-      if (!p) {
+      const auto& p = getProperties(particle.pdgCode());
+      if (!p.isKnown) {
         continue;
       }
       // is charged
-      if (abs(p->Charge()) == 0) {
+      if (p.charge == 0) {
         continue;
       }
       // in acceptance
@@ -135,16 +146,16 @@ struct ParticleCounter {
         continue;
       }
       // has pdg
-      TParticlePDG* p = mPdgDatabase->get()->GetParticle(particle.pdgCode());
-      if (!p) {
+      const auto& p = getProperties(particle.pdgCode());
+      if (!p.isKnown) {
         continue;
       }
       // is neutral
       if (requireNeutral) {
-        if (std::abs(p->Charge()) > 1e-3)
+        if (std::abs(p.charge) > 1e-3 / 3.)
           continue;
       } else {
-        if (std::abs(p->Charge()) <= 1e-3)
+        if (std::abs(p.charge) <= 1e-3 / 3.)
           continue;
       }
       // in acceptance
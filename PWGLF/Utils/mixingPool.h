@@ -0,0 +1,145 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+///
+/// \file mixingPool.h
+/// \brief Event-mixing pools of compact candidate records, persistent across DFs
+///
+/// Each (vertex z, multiplicity) bin keeps a ring buffer of the candidates of the last `depth`
+/// events that entered it. The current event is mixed with the stored events of its bin and then
+/// stored in place of the oldest one, so that the pools are not emptied at the DF boundaries and
+/// the mixing does not need to group or slice the tables. The records are plain structs chosen by
+/// the task, holding only what is needed to build the pairs. Memory is bounded by
+/// nBins x depth x maxRecordsPerEvent records and the slots are reused.
+///
+
+#ifndef PWGLF_UTILS_MIXINGPOOL_H_
+#define PWGLF_UTILS_MIXINGPOOL_H_
+
+#include "Framework/HistogramSpec.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace o2::pwglf
+{
+
+template <typename Record>
+class MixingPool
+{
+ public:
+  /// \param axisVtxZ, axisMult binning in the ConfigurableAxis format, {nBins, min, max} or {VARIABLE_WIDTH, edges...}
+  /// \param depth number of events kept per bin
+  /// \param maxRecordsPerEvent maximum number of candidates stored per event, the others are not stored
+  void init(std::vector<double> const& axisVtxZ, std::vector<double> const& axisMult, int depth, int maxRecordsPerEvent)
+  {
+    mEdgesVtxZ = binEdges(axisVtxZ);
+    mEdgesMult = binEdges(axisMult);
+    mDepth = std::max(depth, 1);
+    mMaxRecordsPerEvent = std::max(maxRecordsPerEvent, 1);
+    mBins.assign((mEdgesVtxZ.size() - 1) * (mEdgesMult.size() - 1), Bin{});
+  }
+
+  /// To be called once per DF, pairs of events of the same DF can then be identified
+  void newDataFrame() { mDataFrame++; }
+
+  /// Bin of an event, -1 if outside of the binning
+  int getBin(float vtxZ, float mult) const
+  {
+    const int iVtxZ = findBin(mEdgesVtxZ, vtxZ);
+    const int iMult = findBin(mEdgesMult, mult);
+    if (iVtxZ < 0 || iMult < 0) {
+      return -1;
+    }
+    return iVtxZ * (mEdgesMult.size() - 1) + iMult;
+  }
+
+  /// Call function(current, stored, sameDataFrame) for all the pairs of the records of the current event with the ones stored in its bin
+  template <typename Function>
+  void forEachPair(int bin, std::vector<Record> const& records, Function&& function) const
+  {
+    if (bin < 0 || records.empty()) {
+      return;
+    }
+    for (auto const& event : mBins[bin].events) {
+      const bool sameDataFrame = event.dataFrame == mDataFrame;
+      for (auto const& record : records) {
+        for (auto const& storedRecord : event.records) {
+          function(record, storedRecord, sameDataFrame);
+        }
+      }
+    }
+  }
+
+  /// Store the records of the current event in its bin, in place of the oldest event once the pool is full
+  void push(int bin, std::vector<Record> const& records)
+  {
+    if (bin < 0 || records.empty()) {
+      return;
+    }
+    auto& poolBin = mBins[bin];
+    if (static_cast<int>(poolBin.events.size()) < mDepth) {
+      poolBin.events.emplace_back();
+    }
+    auto& event = poolBin.events[poolBin.next];
+    poolBin.next = (poolBin.next + 1) % mDepth;
+    event.dataFrame = mDataFrame;
+    event.records.assign(records.begin(), records.begin() + std::min<size_t>(records.size(), mMaxRecordsPerEvent));
+  }
+
+  /// Number of events stored in a bin
+  int nEvents(int bin) const { return bin < 0 ? 0 : mBins[bin].events.size(); }
+
+ private:
+  struct Event {
+    uint64_t dataFrame = 0;
+    std::vector<Record> records;
+  };
+  struct Bin {
+    std::vector<Event> events; // ring buffer, filled up to the pool depth
+    int next = 0;              // slot of the next event
+  };
+
+  static std::vector<double> binEdges(std::vector<double> const& axis)
+  {
+    if (axis.empty()) {
+      return {};
+    }
+    if (axis[0] == o2::framework::VARIABLE_WIDTH) {
+      return std::vector<double>(axis.begin() + 1, axis.end());
+    }
+    const int nBins = std::max(static_cast<int>(axis[0]), 1);
+    std::vector<double> edges(nBins + 1);
+    for (int iBin = 0; iBin <= nBins; iBin++) {
+      edges[iBin] = axis[1] + iBin * (axis[2] - axis[1]) / nBins;
+    }
+    return edges;
+  }
+
+  static int findBin(std::vector<double> const& edges, float value)
+  {
+    if (edges.size() < 2 || !(value >= edges.front() && value < edges.back())) { // also catches NaN
+      return -1;
+    }
+    return std::upper_bound(edges.begin(), edges.end(), value) - edges.begin() - 1;
+  }
+
+  std::vector<double> mEdgesVtxZ;
+  std::vector<double> mEdgesMult;
+  int mDepth = 1;
+  int mMaxRecordsPerEvent = 1;
+  uint64_t mDataFrame = 0;
+  std::vector<Bin> mBins;
+};
+
+} // namespace o2::pwglf
+
+#endif // PWGLF_UTILS_MIXINGPOOL_H_
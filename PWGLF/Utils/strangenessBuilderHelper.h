@@ -22,6 +22,7 @@
 #include "CommonConstants/PhysicsConstants.h"
 #include "Common/Core/trackUtilities.h"
 #include "Tools/KFparticle/KFUtilities.h"
+#include "PWGLF/Utils/strangenessPrefilter.h"
 
 #ifndef HomogeneousField
 #define HomogeneousField
@@ -302,6 +303,11 @@ class strangenessBuilderHelper
         v0 = {};
         return false;
       }
+      // cheap geometrical prefilter before any propagation
+      if (usePrefilter && !prefilterV0(positiveTrackParam, negativeTrackParam)) {
+        v0 = {};
+        return false;
+      }
     }
 
     // Calculate DCA with respect to the collision associated to the V0
@@ -724,6 +730,12 @@ class strangenessBuilderHelper
       return false;
     }
 
+    // cheap geometrical prefilter before the fit
+    if (usePrefilter && !prefilterCascade(v0input, bachelorTrack)) {
+      cascade = {};
+      return false;
+    }
+
     // Do actual minimization
     auto lBachelorTrack = getTrackParCov(bachelorTrack);
 
@@ -1228,7 +1240,64 @@ class strangenessBuilderHelper
     float maxDaughterEta;
   } cascadeselections;
 
+  // pre-fit prefilter in the transverse plane (see prefilterCircles)
+  bool usePrefilter = false;                                          // reject hopeless pairs before the fit
+  float prefilterMargin = 0.1f;                                       // cm, added to the maximum daughter distance
+  std::array<uint64_t, kNPrefilterStages> v0PrefilterCounters{};      // pairs tested / rejected per stage
+  std::array<uint64_t, kNPrefilterStages> cascadePrefilterCounters{}; // pairs tested / rejected per stage
+
+  void resetPrefilterCounters()
+  {
+    v0PrefilterCounters.fill(0);
+    cascadePrefilterCounters.fill(0);
+  }
+
  private:
+  // prefilter of the V0 daughters, only meaningful with absolute DCA minimisation
+  template <typename TTrackParametrization>
+  bool prefilterV0(TTrackParametrization const& positiveTrackParam, TTrackParametrization const& negativeTrackParam)
+  {
+    if (!fitter.getUseAbsDCA()) {
+      return true;
+    }
+    o2::math_utils::CircleXYf_t positiveCircle, negativeCircle;
+    float sna, csa;
+    positiveTrackParam.getCircleParams(fitter.getBz(), positiveCircle, sna, csa);
+    negativeTrackParam.getCircleParams(fitter.getBz(), negativeCircle, sna, csa);
+    const int stage = prefilterCircles(positiveCircle.xC, positiveCircle.yC, positiveCircle.rC,
+                                       negativeCircle.xC, negativeCircle.yC, negativeCircle.rC,
+                                       prefilterMaxDistance(v0selections.dcav0dau, prefilterMargin), v0selections.v0radius);
+    v0PrefilterCounters[kPrefilterTested]++;
+    if (stage != kPrefilterTested) {
+      v0PrefilterCounters[stage]++;
+      return false;
+    }
+    return true;
+  }
+
+  // prefilter of V0 (straight line) and bachelor, only meaningful with absolute DCA minimisation
+  template <typename TTrack>
+  bool prefilterCascade(v0candidate const& v0input, TTrack const& bachelorTrack)
+  {
+    if (!fitter.getUseAbsDCA()) {
+      return true;
+    }
+    o2::math_utils::CircleXYf_t bachelorCircle;
+    float sna, csa;
+    getTrackPar(bachelorTrack).getCircleParams(fitter.getBz(), bachelorCircle, sna, csa);
+    const int stage = prefilterLineCircle(v0input.position[0], v0input.position[1],
+                                          v0input.positiveMomentum[0] + v0input.negativeMomentum[0],
+                                          v0input.positiveMomentum[1] + v0input.negativeMomentum[1],
+                                          bachelorCircle.xC, bachelorCircle.yC, bachelorCircle.rC,
+                                          prefilterMaxDistance(cascadeselections.dcacascdau, prefilterMargin), cascadeselections.cascradius);
+    cascadePrefilterCounters[kPrefilterTested]++;
+    if (stage != kPrefilterTested) {
+      cascadePrefilterCounters[stage]++;
+      return false;
+    }
+    return true;
+  }
+
   // internal helper to calculate DCA (3D) of a straight line to a given PV analytically
   float CalculateDCAStraightToPV(float X, float Y, float Z, float Px, float Py, float Pz, float pvX, float pvY, float pvZ)
   {
@@ -0,0 +1,104 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#ifndef PWGLF_UTILS_STRANGENESSMLEVALUATOR_H_
+#define PWGLF_UTILS_STRANGENESSMLEVALUATOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Tools/ML/model.h"
+
+namespace o2
+{
+namespace pwglf
+{
+//_______________________________________________________________________
+// evaluation of several ML models over the candidates of a dataframe:
+// the features of each candidate are written once into a row-major
+// matrix, together with the mask of the models that have to score it,
+// and every model is then run in batch over its rows. The candidates
+// not added (e.g. failing a prefilter) and the ones not scored by a
+// model keep the default score, so that the score tables stay joinable
+// with the candidate tables.
+class strangenessMlEvaluator
+{
+ public:
+  // prepares the evaluation of nModels models over nCandidates candidates with nFeatures features
+  void reset(std::size_t nModels, std::size_t nCandidates, std::size_t nFeatures, float defaultScore = -1.0f)
+  {
+    mNFeatures = nFeatures;
+    clearRows();
+    mScores.resize(nModels);
+    for (auto& scores : mScores) {
+      scores.assign(nCandidates, defaultScore);
+    }
+  }
+
+  // adds a row for the candidate, to be scored by the models of the mask (bit i: model i);
+  // returns where to write its nFeatures features
+  float* addRow(int candidate, uint32_t modelMask)
+  {
+    mRowCandidate.push_back(candidate);
+    mRowModels.push_back(modelMask);
+    mFeatures.resize(mFeatures.size() + mNFeatures);
+    return mFeatures.data() + mFeatures.size() - mNFeatures;
+  }
+  std::size_t nRows() const { return mRowCandidate.size(); }
+  // drops the rows already evaluated, keeping their scores (e.g. before changing the models)
+  void clearRows()
+  {
+    mFeatures.clear();
+    mRowCandidate.clear();
+    mRowModels.clear();
+  }
+
+  // runs the model over its rows and stores the scores of the given column of its last output
+  void evaluate(std::size_t iModel, o2::ml::OnnxModel& model, std::size_t scoreColumn = 1)
+  {
+    mInput.clear();
+    mInputCandidate.clear();
+    const uint32_t bit = 1u << iModel;
+    for (std::size_t iRow = 0; iRow < mRowCandidate.size(); iRow++) {
+      if (mRowModels[iRow] & bit) {
+        mInput.insert(mInput.end(), mFeatures.begin() + iRow * mNFeatures, mFeatures.begin() + (iRow + 1) * mNFeatures);
+        mInputCandidate.push_back(mRowCandidate[iRow]);
+      }
+    }
+    if (mInputCandidate.empty()) {
+      return;
+    }
+    const std::size_t nScoresPerRow = model.evalModelBatch(mInput, mOutput);
+    auto& scores = mScores[iModel];
+    for (std::size_t iRow = 0; iRow < mInputCandidate.size(); iRow++) {
+      scores[mInputCandidate[iRow]] = mOutput[iRow * nScoresPerRow + scoreColumn];
+    }
+  }
+
+  float score(std::size_t iModel, int candidate) const { return mScores[iModel][candidate]; }
+
+ private:
+  std::size_t mNFeatures = 0;
+  std::vector<float> mFeatures;      // row-major feature matrix
+  std::vector<int> mRowCandidate;    // candidate of each row
+  std::vector<uint32_t> mRowModels;  // models scoring each row
+  std::vector<std::vector<float>> mScores; // per model, per candidate
+
+  // work buffers of the batched evaluation
+  std::vector<float> mInput;
+  std::vector<int> mInputCandidate;
+  std::vector<float> mOutput;
+};
+
+} // namespace pwglf
+} // namespace o2
+
+#endif // PWGLF_UTILS_STRANGENESSMLEVALUATOR_H_
@@ -0,0 +1,192 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#ifndef PWGLF_UTILS_STRANGENESSPREFILTER_H_
+#define PWGLF_UTILS_STRANGENESSPREFILTER_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include "MathUtils/Primitive2D.h"
+
+namespace o2
+{
+namespace pwglf
+{
+//_______________________________________________________________________
+// pre-fit topological prefilter: in the transverse plane, a track helix is
+// a circle and a neutral V0 a straight line. Without any fit, they give
+// - a lower bound of the distance of closest approach of the daughters
+// - an upper bound of the radius of the decay vertex, which is the
+//   midpoint of two daughter points closer than the maximum DCA.
+// Pairs failing either bound cannot pass the DCA / radius selections
+// applied after the fit and can be rejected before calling the fitter.
+enum prefilterStage { kPrefilterTested = 0,
+                      kPrefilterRejectedDCA,
+                      kPrefilterRejectedRadius,
+                      kNPrefilterStages };
+
+constexpr float prefilterPrecision = 1e-6f; // relative float precision of the circle parameters, with some slack
+
+// largest radius of the points of circle (xC, yC, rC) lying within tolerance of
+// the curve described by distanceTo; nothing within tolerance: negative value
+template <typename TDistance, typename TBoundaryPoints>
+float maxRadiusNearCurve(float xC, float yC, float rC, float tolerance, TDistance const& distanceTo, TBoundaryPoints const& boundaryPoints, float gap)
+{
+  if (gap > tolerance) {
+    return -1.0f;
+  }
+  // farthest point of the circle from the origin: if close enough, it is the maximum
+  const float dC = std::hypot(xC, yC);
+  const float xF = dC > 0.0f ? xC * (1.0f + rC / dC) : xC + rC;
+  const float yF = dC > 0.0f ? yC * (1.0f + rC / dC) : yC;
+  if (distanceTo(xF, yF) <= tolerance) {
+    return dC + rC;
+  }
+  // otherwise the radius is largest at one of the ends of the arcs within tolerance
+  float maxRadius = -1.0f;
+  boundaryPoints([&](float x, float y) { maxRadius = std::max(maxRadius, std::hypot(x, y)); });
+  return maxRadius < 0.0f ? dC + rC : maxRadius; // ends not found numerically (tangency): stay conservative
+}
+
+// intersections of circles (x0, y0, r0) and (x1, y1, r1), passed to fill(x, y)
+template <typename TFill>
+void circleIntersections(float x0, float y0, float r0, float x1, float y1, float r1, TFill const& fill)
+{
+  const float dx = x1 - x0, dy = y1 - y0;
+  const float d = std::hypot(dx, dy);
+  if (d <= 0.0f || d > r0 + r1 || d < std::fabs(r0 - r1)) {
+    return;
+  }
+  const float a = (d * d + r0 * r0 - r1 * r1) / (2.0f * d);
+  const float h = std::sqrt(std::max(r0 * r0 - a * a, 0.0f));
+  const float xM = x0 + a * dx / d, yM = y0 + a * dy / d;
+  fill(xM - h * dy / d, yM + h * dx / d);
+  fill(xM + h * dy / d, yM - h * dx / d);
+}
+
+// intersections of circle (xC, yC, rC) and the line through (x0, y0) along (ux, uy) (unit vector), passed to fill(x, y)
+template <typename TFill>
+void lineCircleIntersections(float x0, float y0, float ux, float uy, float xC, float yC, float rC, TFill const& fill)
+{
+  const float t0 = (xC - x0) * ux + (yC - y0) * uy; // foot of the perpendicular from the centre
+  const float xP = x0 + t0 * ux, yP = y0 + t0 * uy;
+  const float dl = std::hypot(xC - xP, yC - yP);
+  if (dl > rC) {
+    return;
+  }
+  const float h = std::sqrt(rC * rC - dl * dl);
+  fill(xP - h * ux, yP - h * uy);
+  fill(xP + h * ux, yP + h * uy);
+}
+
+// prefilter of a pair of charged daughters given their circles
+// maxDistance: maximum 3D distance between the daughters at the decay point
+inline int prefilterCircles(float x0, float y0, float r0, float x1, float y1, float r1, float maxDistance, float minRadius)
+{
+  maxDistance += prefilterPrecision * (r0 + r1); // stiff tracks: centres and radii are large numbers
+  const float d = std::hypot(x1 - x0, y1 - y0);
+  const float gap = d > r0 + r1 ? d - r0 - r1 : (d < std::fabs(r0 - r1) ? std::fabs(r0 - r1) - d : 0.0f);
+  if (gap > maxDistance) {
+    return kPrefilterRejectedDCA;
+  }
+  if (minRadius <= 0.0f) {
+    return kPrefilterTested;
+  }
+  // the decay vertex is within maxDistance / 2 of a point of either circle close to the other one
+  auto distanceTo1 = [&](float x, float y) { return std::fabs(std::hypot(x - x1, y - y1) - r1); };
+  auto ends0 = [&](auto const& fill) {
+    circleIntersections(x0, y0, r0, x1, y1, r1 - maxDistance, fill);
+    circleIntersections(x0, y0, r0, x1, y1, r1 + maxDistance, fill);
+  };
+  const float maxRadius = maxRadiusNearCurve(x0, y0, r0, maxDistance, distanceTo1, ends0, gap);
+  if (maxRadius + 0.5f * maxDistance < minRadius) {
+    return kPrefilterRejectedRadius;
+  }
+  return kPrefilterTested;
+}
+
+// prefilter of a neutral daughter (straight line through (x0, y0) with transverse momentum (px, py)) and a charged one given its circle
+inline int prefilterLineCircle(float x0, float y0, float px, float py, float xC, float yC, float rC, float maxDistance, float minRadius)
+{
+  const float pt = std::hypot(px, py);
+  if (pt <= 0.0f) {
+    return kPrefilterTested;
+  }
+  maxDistance += prefilterPrecision * (rC + std::hypot(xC, yC));
+  const float ux = px / pt, uy = py / pt;
+  const float dl = std::fabs((xC - x0) * uy - (yC - y0) * ux); // distance of the centre from the line
+  const float gap = dl > rC ? dl - rC : 0.0f;
+  if (gap > maxDistance) {
+    return kPrefilterRejectedDCA;
+  }
+  if (minRadius <= 0.0f) {
+    return kPrefilterTested;
+  }
+  auto distanceToLine = [&](float x, float y) { return std::fabs((x - x0) * uy - (y - y0) * ux); };
+  auto ends = [&](auto const& fill) {
+    lineCircleIntersections(x0 - maxDistance * uy, y0 + maxDistance * ux, ux, uy, xC, yC, rC, fill);
+    lineCircleIntersections(x0 + maxDistance * uy, y0 - maxDistance * ux, ux, uy, xC, yC, rC, fill);
+  };
+  const float maxRadius = maxRadiusNearCurve(xC, yC, rC, maxDistance, distanceToLine, ends, gap);
+  if (maxRadius + 0.5f * maxDistance < minRadius) {
+    return kPrefilterRejectedRadius;
+  }
+  return kPrefilterTested;
+}
+
+//_______________________________________________________________________
+// transverse-plane circles of a set of tracks, stored as arrays so that
+// one track can be tested against many others in a tight loop
+struct trackCircles {
+  std::vector<float> xC;
+  std::vector<float> yC;
+  std::vector<float> rC;
+
+  void clear()
+  {
+    xC.clear();
+    yC.clear();
+    rC.clear();
+  }
+
+  template <typename TTrackParametrization>
+  void push_back(TTrackParametrization const& trackParam, float bz)
+  {
+    o2::math_utils::CircleXYf_t circle;
+    float sna, csa;
+    trackParam.getCircleParams(bz, circle, sna, csa);
+    xC.push_back(circle.xC);
+    yC.push_back(circle.yC);
+    rC.push_back(circle.rC);
+  }
+
+  std::size_t size() const { return rC.size(); }
+
+  int prefilter(std::size_t i, trackCircles const& other, std::size_t j, float maxDistance, float minRadius) const
+  {
+    return prefilterCircles(xC[i], yC[i], rC[i], other.xC[j], other.yC[j], other.rC[j], maxDistance, minRadius);
+  }
+};
+
+// maximum 3D distance of the daughters at the decay point: with absolute DCA
+// minimisation, chi2 = d^2 / 2 for a 2-prong fit. margin absorbs the changes
+// of curvature from material corrections during the fit
+inline float prefilterMaxDistance(float maxDaughterDCA, float margin)
+{
+  return static_cast<float>(M_SQRT2) * maxDaughterDCA + margin;
+}
+
+} // namespace pwglf
+} // namespace o2
+
+#endif // PWGLF_UTILS_STRANGENESSPREFILTER_H_
@@ -12,6 +12,7 @@
 #ifndef PWGLF_UTILS_SVPOOLCREATOR_H_
 #define PWGLF_UTILS_SVPOOLCREATOR_H_
 
+#include <algorithm>
 #include <array>
 #include <unordered_map>
 #include <vector>
@@ -65,51 +66,84 @@ class svPoolCreator
     tmap.clear();
     svCandPool.clear();
     bc2Coll.clear();
+    track2AmbiBC.clear();
+    isTrack2AmbiFilled = false;
   }
 
   void setTimeMargin(float timeMargin) { timeMarginNS = timeMargin; }
   void setFitter(const o2::vertexing::DCAFitterN<2>& fitter) { this->fitter = fitter; }
   void setSkipAmbiTracks() { skipAmbiTracks = true; }
   o2::vertexing::DCAFitterN<2>* getFitter() { return &fitter; }
-  std::array<std::vector<TrackCand>, 4> getTrackCandPool() { return trackCandPool; }
+  const std::array<std::vector<TrackCand>, 4>& getTrackCandPool() const { return trackCandPool; }
 
+  /// sorted BC-to-collision array, if several collisions share a BC the last one is kept
   template <typename C, typename BC>
   void fillBC2Coll(const C& collisions, BC const&)
   {
+    bc2Coll.clear();
+    bc2Coll.reserve(collisions.size());
     for (unsigned i = 0; i < collisions.size(); i++) {
       auto collision = collisions.rawIteratorAt(i);
       if (!collision.has_bc()) {
         continue;
       }
-      bc2Coll[collision.template bc_as<BC>().globalBC()] = i;
+      bc2Coll.emplace_back(collision.template bc_as<BC>().globalBC(), i);
+    }
+    std::stable_sort(bc2Coll.begin(), bc2Coll.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    size_t nUnique = 0;
+    for (size_t i = 0; i < bc2Coll.size(); i++) {
+      if (i + 1 < bc2Coll.size() && bc2Coll[i + 1].first == bc2Coll[i].first) {
+        continue;
+      }
+      bc2Coll[nUnique++] = bc2Coll[i];
+    }
+    bc2Coll.resize(nUnique);
+  }
+
+  /// dense track-to-BC index of the ambiguous tracks of the DF, the first entry of a track is kept
+  template <typename BC>
+  void fillTrack2Ambi(o2::aod::AmbiguousTracks const& ambiTracks, BC const&)
+  {
+    track2AmbiBC.clear();
+    for (const auto& ambTrack : ambiTracks) {
+      if (ambTrack.trackId() < 0) {
+        continue;
+      }
+      if (ambTrack.trackId() >= static_cast<int64_t>(track2AmbiBC.size())) {
+        track2AmbiBC.resize(ambTrack.trackId() + 1, BcNoAmbiTrack);
+      }
+      auto& globalBC = track2AmbiBC[ambTrack.trackId()];
+      if (globalBC != BcNoAmbiTrack) {
+        continue;
+      }
+      if (!ambTrack.has_bc() || ambTrack.template bc_as<BC>().size() == 0) {
+        globalBC = BcInvalid;
+      } else {
+        globalBC = ambTrack.template bc_as<BC>().begin().globalBC();
+      }
     }
+    isTrack2AmbiFilled = true;
   }
 
   template <typename T, typename C, typename BC>
-  void appendTrackCand(const T& trackCand, const C& collisions, int pdgHypo, o2::aod::AmbiguousTracks const& ambiTracks, BC const&)
+  void appendTrackCand(const T& trackCand, const C& collisions, int pdgHypo, o2::aod::AmbiguousTracks const& ambiTracks, BC const& bcs)
   {
     if (pdgHypo != track0Pdg && pdgHypo != track1Pdg) {
       LOG(debug) << "Wrong pdg hypothesis";
       return;
     }
     bool isDau0 = pdgHypo == track0Pdg;
-    constexpr uint64_t BcInvalid = -1;
     uint64_t globalBC = BcInvalid;
     if (trackCand.has_collision()) {
       if (trackCand.template collision_as<C>().has_bc()) {
         globalBC = trackCand.template collision_as<C>().template bc_as<BC>().globalBC();
       }
     } else if (!skipAmbiTracks) {
-      for (const auto& ambTrack : ambiTracks) {
-        if (ambTrack.trackId() != trackCand.globalIndex()) {
-          continue;
-        }
-        if (!ambTrack.has_bc() || ambTrack.bc_as<BC>().size() == 0) {
-          globalBC = BcInvalid;
-          break;
-        }
-        globalBC = ambTrack.bc_as<BC>().begin().globalBC();
-        break;
+      if (!isTrack2AmbiFilled) {
+        fillTrack2Ambi(ambiTracks, bcs);
+      }
+      if (trackCand.globalIndex() < static_cast<int64_t>(track2AmbiBC.size()) && track2AmbiBC[trackCand.globalIndex()] != BcNoAmbiTrack) {
+        globalBC = track2AmbiBC[trackCand.globalIndex()];
       }
     } else {
       globalBC = BcInvalid;
@@ -119,19 +153,14 @@ class svPoolCreator
       return;
     }
 
+    // first collision with a BC in [globalBC - bOffsetMax, globalBC + bOffsetMax)
     uint64_t firstBC = globalBC < bOffsetMax ? 0 : globalBC - bOffsetMax;
     uint64_t lastBC = globalBC + bOffsetMax;
-    int firstCollIdx = -1;
-    while (firstBC < lastBC) {
-      if (bc2Coll.find(firstBC) != bc2Coll.end()) {
-        firstCollIdx = bc2Coll[firstBC];
-        break;
-      }
-      firstBC++;
-    }
-    if (firstCollIdx == -1) {
+    auto firstColl = std::lower_bound(bc2Coll.begin(), bc2Coll.end(), firstBC, [](const auto& entry, uint64_t bc) { return entry.first < bc; });
+    if (firstColl == bc2Coll.end() || firstColl->first >= lastBC) {
       return;
     }
+    int firstCollIdx = firstColl->second;
 
     // now loop over all the collisions to make the pool
     for (int i = firstCollIdx; i < collisions.size(); i++) {
@@ -220,39 +249,47 @@ class svPoolCreator
         }
       }
       int track1sign = combineLikeSign ? pn : 1 - pn;
-      auto& signTrack1 = track1Pool[track1sign];
-      for (unsigned itp = 0; itp < signTrack1.size(); itp++) {
-        auto& track1Seed = signTrack1[itp];
-        LOG(debug) << "Processing track1 with index: " << track1Seed.Idxtr << " min bracket: " << track1Seed.collBracket.getMin() << " max bracket: " << track1Seed.collBracket.getMax();
-        int firsOverlapIdx = -1;
-        for (int j{track1Seed.collBracket.getMin()}; j <= track1Seed.collBracket.getMax(); ++j) {
-          LOG(debug) << "Checking vtxFirstT at position " << j << " with value " << vtxFirstT[j];
-          if (vtxFirstT[j] != -1) {
-            firsOverlapIdx = vtxFirstT[j];
-            break;
-          }
-        }
-        if (firsOverlapIdx < 0) {
-          continue;
-        }
-        for (unsigned itn = firsOverlapIdx; itn < signTrack0Pool.size(); itn++) {
-          auto& track0Seed = signTrack0Pool[itn];
+      const auto& signTrack1 = track1Pool[track1sign];
+      pairTrackCands(signTrack0Pool, vtxFirstT, signTrack1, 0, signTrack1.size(), svCandPool);
+    }
+    return svCandPool;
+  }
 
-          if (track0Seed.collBracket.getMin() > track1Seed.collBracket.getMax()) {
-            break;
-          }
+  /// pairs the track1 seeds [firstTrack1, lastTrack1) with the track0 candidates sharing a collision bracket
+  /// \note the track1 seeds are independent of each other, so the pairing can be split in ranges of track1 seeds
+  /// (e.g. one per thread, with one output vector each) and the outputs concatenated in range order
+  static void pairTrackCands(const std::vector<TrackCand>& signTrack0Pool, const std::vector<int>& vtxFirstT, const std::vector<TrackCand>& signTrack1, size_t firstTrack1, size_t lastTrack1, std::vector<SVCand>& svCands)
+  {
+    for (size_t itp = firstTrack1; itp < lastTrack1; itp++) {
+      const auto& track1Seed = signTrack1[itp];
+      LOG(debug) << "Processing track1 with index: " << track1Seed.Idxtr << " min bracket: " << track1Seed.collBracket.getMin() << " max bracket: " << track1Seed.collBracket.getMax();
+      int firsOverlapIdx = -1;
+      for (int j{track1Seed.collBracket.getMin()}; j <= track1Seed.collBracket.getMax(); ++j) {
+        LOG(debug) << "Checking vtxFirstT at position " << j << " with value " << vtxFirstT[j];
+        if (vtxFirstT[j] != -1) {
+          firsOverlapIdx = vtxFirstT[j];
+          break;
+        }
+      }
+      if (firsOverlapIdx < 0) {
+        continue;
+      }
+      for (unsigned itn = firsOverlapIdx; itn < signTrack0Pool.size(); itn++) {
+        const auto& track0Seed = signTrack0Pool[itn];
 
-          if (track0Seed.collBracket.isOutside(track1Seed.collBracket)) {
-            LOG(debug) << "Brackets do not match";
-            continue;
-          }
-          auto overlapBracket = track0Seed.collBracket.getOverlap(track1Seed.collBracket);
+        if (track0Seed.collBracket.getMin() > track1Seed.collBracket.getMax()) {
+          break;
+        }
 
-          svCandPool.emplace_back(SVCand{track0Seed.Idxtr, track1Seed.Idxtr, overlapBracket});
+        if (track0Seed.collBracket.isOutside(track1Seed.collBracket)) {
+          LOG(debug) << "Brackets do not match";
+          continue;
         }
+        auto overlapBracket = track0Seed.collBracket.getOverlap(track1Seed.collBracket);
+
+        svCands.emplace_back(SVCand{track0Seed.Idxtr, track1Seed.Idxtr, overlapBracket});
       }
     }
-    return svCandPool;
   }
 
   template <typename T>
@@ -265,7 +302,12 @@ class svPoolCreator
   float timeMarginNS = 600.;
   bool skipAmbiTracks = false;
   std::unordered_map<int, std::pair<int, int>> tmap;
-  std::unordered_map<uint64_t, int> bc2Coll;
+  std::vector<std::pair<uint64_t, int>> bc2Coll; // sorted by BC
+  std::vector<uint64_t> track2AmbiBC;            // BC of the ambiguous track entry, indexed by track
+  bool isTrack2AmbiFilled = false;
+
+  static constexpr uint64_t BcInvalid = -1;
+  static constexpr uint64_t BcNoAmbiTrack = -2;
 
   std::array<std::vector<TrackCand>, 4> trackCandPool; // Sorting: dau0 pos, dau0 neg, dau1 pos, dau1 neg
   std::vector<SVCand> svCandPool;                      // index of the two tracks in the track table
@@ -77,6 +77,59 @@ void v0SelectionGroup::provideMasks(uint64_t& maskTopological, uint64_t& maskTra
   }
 }
 
+// sets a selection by the name of its member
+bool v0SelectionGroup::setParameter(std::string const& name, float value)
+{
+  if (name == "rapidityCut") {
+    rapidityCut = value;
+  } else if (name == "daughterEtaCut") {
+    daughterEtaCut = value;
+  } else if (name == "v0cospa") {
+    v0cospa = value;
+  } else if (name == "dcav0dau") {
+    dcav0dau = value;
+  } else if (name == "dcanegtopv") {
+    dcanegtopv = value;
+  } else if (name == "dcapostopv") {
+    dcapostopv = value;
+  } else if (name == "v0radius") {
+    v0radius = value;
+  } else if (name == "v0radiusMax") {
+    v0radiusMax = value;
+  } else if (name == "minTPCrows") {
+    minTPCrows = static_cast<int>(value);
+  } else if (name == "minITSclusters") {
+    minITSclusters = static_cast<int>(value);
+  } else if (name == "skipTPConly") {
+    skipTPConly = value > 0.5f;
+  } else if (name == "requirePosITSonly") {
+    requirePosITSonly = value > 0.5f;
+  } else if (name == "requireNegITSonly") {
+    requireNegITSonly = value > 0.5f;
+  } else if (name == "TpcPidNsigmaCut") {
+    TpcPidNsigmaCut = value;
+  } else if (name == "TofPidNsigmaCutLaPr") {
+    TofPidNsigmaCutLaPr = value;
+  } else if (name == "TofPidNsigmaCutLaPi") {
+    TofPidNsigmaCutLaPi = value;
+  } else if (name == "TofPidNsigmaCutK0Pi") {
+    TofPidNsigmaCutK0Pi = value;
+  } else if (name == "maxDeltaTimeProton") {
+    maxDeltaTimeProton = value;
+  } else if (name == "maxDeltaTimePion") {
+    maxDeltaTimePion = value;
+  } else if (name == "lifetimeCutK0Short") {
+    lifetimeCutK0Short = value;
+  } else if (name == "lifetimeCutLambda") {
+    lifetimeCutLambda = value;
+  } else if (name == "armPodCut") {
+    armPodCut = value;
+  } else {
+    return false;
+  }
+  return true;
+}
+
 void v0SelectionGroup::PrintSelections() const
 {
   LOGF(info, "+++ Phase space selections ++++++++++++++++++++++++");
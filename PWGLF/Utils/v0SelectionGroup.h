@@ -13,6 +13,7 @@
 #define PWGLF_UTILS_V0SELECTIONGROUP_H_
 
 #include <iosfwd>
+#include <string>
 #include <Rtypes.h>
 #include <TMath.h>
 #include "v0SelectionBits.h"
@@ -31,6 +32,9 @@ class v0SelectionGroup
   void provideMasks(uint64_t& maskTopological, uint64_t& maskTrackProperties, uint64_t& maskK0ShortSpecific, uint64_t& maskLambdaSpecific, uint64_t& maskAntiLambdaSpecific) const;
   bool verifyMask(uint64_t bitmap, uint64_t mask) const;
 
+  // sets a selection by the name of its member (e.g. for the variations of a VariationSet), false if unknown
+  bool setParameter(std::string const& name, float value);
+
   float getRapidityCut() const { return rapidityCut; }
   float getDaughterEtaCut() const { return daughterEtaCut; }
 
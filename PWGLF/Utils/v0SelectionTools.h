@@ -22,110 +22,168 @@
 namespace v0data
 {
 
-// utility method to calculate a selection map for the V0s
+// quantities of a V0 entering its selection map, read once from the tables
+// so that the map can be computed for several selections (e.g. the variations of a VariationSet)
+struct v0SelectionQuantities {
+  float v0radius, dcapostopv, dcanegtopv, v0cosPA, dcaV0daughters;
+  float rapidityLambda, rapidityK0Short;
+  int posITSclusters, negITSclusters, posTPCrows, negTPCrows;
+  float posTPCNSigmaPi, posTPCNSigmaPr, negTPCNSigmaPi, negTPCNSigmaPr;
+  float posTOFDeltaTLaPr, posTOFDeltaTLaPi, posTOFDeltaTK0Pi, negTOFDeltaTLaPr, negTOFDeltaTLaPi, negTOFDeltaTK0Pi;
+  float tofNSigmaLaPr, tofNSigmaALaPi, tofNSigmaK0PiPlus, tofNSigmaALaPr, tofNSigmaLaPi, tofNSigmaK0PiMinus;
+  bool posNotTPCOnly, negNotTPCOnly;
+  float distOverTotMom, qtarm, alpha;
+};
+
 template <typename TV0, typename TTrack, typename TCollision>
-uint64_t computeReconstructionBitmap(TV0 v0, TTrack posTrackExtra, TTrack negTrackExtra, TCollision collision, float rapidityLambda, float rapidityK0Short, const v0SelectionGroup& v0sels)
+v0SelectionQuantities getSelectionQuantities(TV0 const& v0, TTrack const& posTrackExtra, TTrack const& negTrackExtra, TCollision const& collision, float rapidityLambda, float rapidityK0Short)
+{
+  v0SelectionQuantities q;
+  q.v0radius = v0.v0radius();
+  q.dcapostopv = v0.dcapostopv();
+  q.dcanegtopv = v0.dcanegtopv();
+  q.v0cosPA = v0.v0cosPA();
+  q.dcaV0daughters = v0.dcaV0daughters();
+  q.rapidityLambda = rapidityLambda;
+  q.rapidityK0Short = rapidityK0Short;
+  q.posITSclusters = posTrackExtra.itsNCls();
+  q.negITSclusters = negTrackExtra.itsNCls();
+  q.posTPCrows = posTrackExtra.tpcCrossedRows();
+  q.negTPCrows = negTrackExtra.tpcCrossedRows();
+  q.posTPCNSigmaPi = posTrackExtra.tpcNSigmaPi();
+  q.posTPCNSigmaPr = posTrackExtra.tpcNSigmaPr();
+  q.negTPCNSigmaPi = negTrackExtra.tpcNSigmaPi();
+  q.negTPCNSigmaPr = negTrackExtra.tpcNSigmaPr();
+  q.posTOFDeltaTLaPr = v0.posTOFDeltaTLaPr();
+  q.posTOFDeltaTLaPi = v0.posTOFDeltaTLaPi();
+  q.posTOFDeltaTK0Pi = v0.posTOFDeltaTK0Pi();
+  q.negTOFDeltaTLaPr = v0.negTOFDeltaTLaPr();
+  q.negTOFDeltaTLaPi = v0.negTOFDeltaTLaPi();
+  q.negTOFDeltaTK0Pi = v0.negTOFDeltaTK0Pi();
+  q.tofNSigmaLaPr = v0.tofNSigmaLaPr();
+  q.tofNSigmaALaPi = v0.tofNSigmaALaPi();
+  q.tofNSigmaK0PiPlus = v0.tofNSigmaK0PiPlus();
+  q.tofNSigmaALaPr = v0.tofNSigmaALaPr();
+  q.tofNSigmaLaPi = v0.tofNSigmaLaPi();
+  q.tofNSigmaK0PiMinus = v0.tofNSigmaK0PiMinus();
+  q.posNotTPCOnly = posTrackExtra.detectorMap() != o2::aod::track::TPC;
+  q.negNotTPCOnly = negTrackExtra.detectorMap() != o2::aod::track::TPC;
+  q.distOverTotMom = v0.distovertotmom(collision.posX(), collision.posY(), collision.posZ());
+  q.qtarm = v0.qtarm();
+  q.alpha = v0.alpha();
+  return q;
+}
+
+// selection map of the V0 with the given quantities
+inline uint64_t computeReconstructionBitmap(v0SelectionQuantities const& q, const v0SelectionGroup& v0sels)
 // precalculate this information so that a check is one mask operation, not many
 {
   uint64_t bitMap = 0;
   // Base topological variables
-  if (v0.v0radius() > v0sels.getv0radius())
+  if (q.v0radius > v0sels.getv0radius())
     bitset(bitMap, v0data::selRadius);
-  if (v0.v0radius() < v0sels.getv0radiusMax())
+  if (q.v0radius < v0sels.getv0radiusMax())
     bitset(bitMap, v0data::selRadiusMax);
-  if (TMath::Abs(v0.dcapostopv()) > v0sels.getdcapostopv())
+  if (TMath::Abs(q.dcapostopv) > v0sels.getdcapostopv())
     bitset(bitMap, v0data::selDCAPosToPV);
-  if (TMath::Abs(v0.dcanegtopv()) > v0sels.getdcanegtopv())
+  if (TMath::Abs(q.dcanegtopv) > v0sels.getdcanegtopv())
     bitset(bitMap, v0data::selDCANegToPV);
-  if (v0.v0cosPA() > v0sels.getv0cospa())
+  if (q.v0cosPA > v0sels.getv0cospa())
     bitset(bitMap, v0data::selCosPA);
-  if (v0.dcaV0daughters() < v0sels.getdcav0dau())
+  if (q.dcaV0daughters < v0sels.getdcav0dau())
     bitset(bitMap, v0data::selDCAV0Dau);
 
   // rapidity
-  if (TMath::Abs(rapidityLambda) < v0sels.getRapidityCut())
+  if (TMath::Abs(q.rapidityLambda) < v0sels.getRapidityCut())
     bitset(bitMap, v0data::selLambdaRapidity);
-  if (TMath::Abs(rapidityK0Short) < v0sels.getRapidityCut())
+  if (TMath::Abs(q.rapidityK0Short) < v0sels.getRapidityCut())
     bitset(bitMap, v0data::selK0ShortRapidity);
 
   // ITS quality flags
-  if (posTrackExtra.itsNCls() >= v0sels.getminITSclusters())
+  if (q.posITSclusters >= v0sels.getminITSclusters())
     bitset(bitMap, v0data::selPosGoodITSTrack);
-  if (negTrackExtra.itsNCls() >= v0sels.getminITSclusters())
+  if (q.negITSclusters >= v0sels.getminITSclusters())
     bitset(bitMap, v0data::selNegGoodITSTrack);
 
   // TPC quality flags
-  if (posTrackExtra.tpcCrossedRows() >= v0sels.getminTPCrows())
+  if (q.posTPCrows >= v0sels.getminTPCrows())
     bitset(bitMap, v0data::selPosGoodTPCTrack);
-  if (negTrackExtra.tpcCrossedRows() >= v0sels.getminTPCrows())
+  if (q.negTPCrows >= v0sels.getminTPCrows())
     bitset(bitMap, v0data::selNegGoodTPCTrack);
 
   // TPC PID
-  if (fabs(posTrackExtra.tpcNSigmaPi()) < v0sels.getTpcPidNsigmaCut())
+  if (fabs(q.posTPCNSigmaPi) < v0sels.getTpcPidNsigmaCut())
     bitset(bitMap, v0data::selTPCPIDPositivePion);
-  if (fabs(posTrackExtra.tpcNSigmaPr()) < v0sels.getTpcPidNsigmaCut())
+  if (fabs(q.posTPCNSigmaPr) < v0sels.getTpcPidNsigmaCut())
     bitset(bitMap, v0data::selTPCPIDPositiveProton);
-  if (fabs(negTrackExtra.tpcNSigmaPi()) < v0sels.getTpcPidNsigmaCut())
+  if (fabs(q.negTPCNSigmaPi) < v0sels.getTpcPidNsigmaCut())
     bitset(bitMap, v0data::selTPCPIDNegativePion);
-  if (fabs(negTrackExtra.tpcNSigmaPr()) < v0sels.getTpcPidNsigmaCut())
+  if (fabs(q.negTPCNSigmaPr) < v0sels.getTpcPidNsigmaCut())
     bitset(bitMap, v0data::selTPCPIDNegativeProton);
 
   // TOF PID in DeltaT (deprecated, kept for compatibility)
   // Positive track
-  if (fabs(v0.posTOFDeltaTLaPr()) < v0sels.getmaxDeltaTimeProton())
+  if (fabs(q.posTOFDeltaTLaPr) < v0sels.getmaxDeltaTimeProton())
     bitset(bitMap, v0data::selTOFDeltaTPositiveProtonLambda);
-  if (fabs(v0.posTOFDeltaTLaPi()) < v0sels.getmaxDeltaTimePion())
+  if (fabs(q.posTOFDeltaTLaPi) < v0sels.getmaxDeltaTimePion())
     bitset(bitMap, v0data::selTOFDeltaTPositivePionLambda);
-  if (fabs(v0.posTOFDeltaTK0Pi()) < v0sels.getmaxDeltaTimePion())
+  if (fabs(q.posTOFDeltaTK0Pi) < v0sels.getmaxDeltaTimePion())
     bitset(bitMap, v0data::selTOFDeltaTPositivePionK0Short);
   // Negative track
-  if (fabs(v0.negTOFDeltaTLaPr()) < v0sels.getmaxDeltaTimeProton())
+  if (fabs(q.negTOFDeltaTLaPr) < v0sels.getmaxDeltaTimeProton())
     bitset(bitMap, v0data::selTOFDeltaTNegativeProtonLambda);
-  if (fabs(v0.negTOFDeltaTLaPi()) < v0sels.getmaxDeltaTimePion())
+  if (fabs(q.negTOFDeltaTLaPi) < v0sels.getmaxDeltaTimePion())
     bitset(bitMap, v0data::selTOFDeltaTNegativePionLambda);
-  if (fabs(v0.negTOFDeltaTK0Pi()) < v0sels.getmaxDeltaTimePion())
+  if (fabs(q.negTOFDeltaTK0Pi) < v0sels.getmaxDeltaTimePion())
     bitset(bitMap, v0data::selTOFDeltaTNegativePionK0Short);
 
   // TOF PID in NSigma
   // Positive track
-  if (fabs(v0.tofNSigmaLaPr()) < v0sels.getTofPidNsigmaCutLaPr())
+  if (fabs(q.tofNSigmaLaPr) < v0sels.getTofPidNsigmaCutLaPr())
     bitset(bitMap, v0data::selTOFNSigmaPositiveProtonLambda);
-  if (fabs(v0.tofNSigmaALaPi()) < v0sels.getTofPidNsigmaCutLaPi())
+  if (fabs(q.tofNSigmaALaPi) < v0sels.getTofPidNsigmaCutLaPi())
     bitset(bitMap, v0data::selTOFNSigmaPositivePionLambda);
-  if (fabs(v0.tofNSigmaK0PiPlus()) < v0sels.getTofPidNsigmaCutK0Pi())
+  if (fabs(q.tofNSigmaK0PiPlus) < v0sels.getTofPidNsigmaCutK0Pi())
     bitset(bitMap, v0data::selTOFNSigmaPositivePionK0Short);
   // Negative track
-  if (fabs(v0.tofNSigmaALaPr()) < v0sels.getTofPidNsigmaCutLaPr())
+  if (fabs(q.tofNSigmaALaPr) < v0sels.getTofPidNsigmaCutLaPr())
     bitset(bitMap, v0data::selTOFNSigmaNegativeProtonLambda);
-  if (fabs(v0.tofNSigmaLaPi()) < v0sels.getTofPidNsigmaCutLaPi())
+  if (fabs(q.tofNSigmaLaPi) < v0sels.getTofPidNsigmaCutLaPi())
     bitset(bitMap, v0data::selTOFNSigmaNegativePionLambda);
-  if (fabs(v0.tofNSigmaK0PiMinus()) < v0sels.getTofPidNsigmaCutK0Pi())
+  if (fabs(q.tofNSigmaK0PiMinus) < v0sels.getTofPidNsigmaCutK0Pi())
     bitset(bitMap, v0data::selTOFNSigmaNegativePionK0Short);
 
   // ITS only tag
-  if (posTrackExtra.tpcCrossedRows() < 1)
+  if (q.posTPCrows < 1)
     bitset(bitMap, v0data::selPosItsOnly);
-  if (negTrackExtra.tpcCrossedRows() < 1)
+  if (q.negTPCrows < 1)
     bitset(bitMap, v0data::selNegItsOnly);
 
   // TPC only tag
-  if (posTrackExtra.detectorMap() != o2::aod::track::TPC)
+  if (q.posNotTPCOnly)
     bitset(bitMap, v0data::selPosNotTPCOnly);
-  if (negTrackExtra.detectorMap() != o2::aod::track::TPC)
+  if (q.negNotTPCOnly)
     bitset(bitMap, v0data::selNegNotTPCOnly);
 
   // proper lifetime
-  if (v0.distovertotmom(collision.posX(), collision.posY(), collision.posZ()) * o2::constants::physics::MassLambda0 < v0sels.getlifetimeCutLambda())
+  if (q.distOverTotMom * o2::constants::physics::MassLambda0 < v0sels.getlifetimeCutLambda())
     bitset(bitMap, v0data::selLambdaCTau);
-  if (v0.distovertotmom(collision.posX(), collision.posY(), collision.posZ()) * o2::constants::physics::MassK0Short < v0sels.getlifetimeCutK0Short())
+  if (q.distOverTotMom * o2::constants::physics::MassK0Short < v0sels.getlifetimeCutK0Short())
     bitset(bitMap, v0data::selK0ShortCTau);
 
   // armenteros
-  if (v0.qtarm() * v0sels.getarmPodCut() > TMath::Abs(v0.alpha()) || v0sels.getarmPodCut() < 1e-4)
+  if (q.qtarm * v0sels.getarmPodCut() > TMath::Abs(q.alpha) || v0sels.getarmPodCut() < 1e-4)
     bitset(bitMap, v0data::selK0ShortArmenteros);
 
   return bitMap;
 }
+
+// utility method to calculate a selection map for the V0s
+template <typename TV0, typename TTrack, typename TCollision>
+uint64_t computeReconstructionBitmap(TV0 v0, TTrack posTrackExtra, TTrack negTrackExtra, TCollision collision, float rapidityLambda, float rapidityK0Short, const v0SelectionGroup& v0sels)
+{
+  return computeReconstructionBitmap(getSelectionQuantities(v0, posTrackExtra, negTrackExtra, collision, rapidityLambda, rapidityK0Short), v0sels);
+}
 } // namespace v0data
 
 #endif // PWGLF_UTILS_V0SELECTIONTOOLS_H_
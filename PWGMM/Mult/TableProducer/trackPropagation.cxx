@@ -252,6 +252,7 @@ struct AmbiguousTrackPropagation {
       o2::track::TrackParCovFwd trackPar{track.z(), tpars, tcovs, track.chi2()};
 
       int degree = 0; // degree of ambiguity of the track
+      const float origPosZ = (track.has_collision() && produceHistos) ? track.collision().posZ() : 0.f;
 
       auto compatibleBCs = atrack.bc_as<ExtBCs>();
       for (auto& bc : compatibleBCs) {
@@ -261,7 +262,7 @@ struct AmbiguousTrackPropagation {
         auto collisions = bc.collisions();
         for (auto const& collision : collisions) {
           degree++;
-          trackPar.propagateToZhelix(collision.posZ(), Bz); // track parameters propagation to the position of the z vertex
+          trackPar.propagateParamToZhelix(collision.posZ(), Bz); // track parameters propagation to the position of the z vertex, the covariance is null and not propagated
 
           const auto dcaX(trackPar.getX() - collision.posX());
           const auto dcaY(trackPar.getY() - collision.posY());
@@ -278,8 +279,8 @@ struct AmbiguousTrackPropagation {
           if (produceHistos) {
             registry.fill(HIST("TracksDCAXY"), dcaInfo);
           }
-          if ((track.collisionId() != collision.globalIndex()) && produceHistos) {
-            registry.fill(HIST("DeltaZ"), track.collision().posZ() - collision.posZ()); // deltaZ between the 1st coll zvtx and the other compatible ones
+          if ((track.collisionId() != collision.globalIndex()) && track.has_collision() && produceHistos) {
+            registry.fill(HIST("DeltaZ"), origPosZ - collision.posZ()); // deltaZ between the 1st coll zvtx and the other compatible ones
           }
 
           if ((collision.globalIndex() == track.collisionId()) && produceHistos) {
@@ -344,10 +345,11 @@ struct AmbiguousTrackPropagation {
       SMatrix55 tcovs(v1.begin(), v1.end());
       SMatrix5 tpars(track.x(), track.y(), track.phi(), track.tgl(), track.signed1Pt());
       o2::track::TrackParCovFwd trackPar{track.z(), tpars, tcovs, track.chi2()};
+      const float origPosZ = (track.has_collision() && produceHistos) ? track.collision().posZ() : 0.f;
 
       for (auto& collision : compatibleColls) {
 
-        trackPar.propagateToZhelix(collision.posZ(), Bz); // track parameters propagation to the position of the z vertex
+        trackPar.propagateParamToZhelix(collision.posZ(), Bz); // track parameters propagation to the position of the z vertex, the covariance is null and not propagated
 
         const auto dcaX(trackPar.getX() - collision.posX());
         const auto dcaY(trackPar.getY() - collision.posY());
@@ -360,8 +362,8 @@ struct AmbiguousTrackPropagation {
           bestDCAy = dcaY;
           bestTrackPar = trackPar;
         }
-        if ((track.collisionId() != collision.globalIndex()) && produceHistos) {
-          registry.fill(HIST("DeltaZ"), track.collision().posZ() - collision.posZ()); // deltaZ between the 1st coll zvtx and the other compatible ones
+        if ((track.collisionId() != collision.globalIndex()) && track.has_collision() && produceHistos) {
+          registry.fill(HIST("DeltaZ"), origPosZ - collision.posZ()); // deltaZ between the 1st coll zvtx and the other compatible ones
         }
         if (produceHistos) {
           registry.fill(HIST("TracksDCAXY"), dcaInfo);
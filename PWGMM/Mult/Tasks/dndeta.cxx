@@ -21,6 +21,8 @@
 #include <TDatabasePDG.h>
 #include <TPDGCode.h>
 
+#include <unordered_set>
+
 #include "Gencentralities.h"
 #include "Index.h"
 #include "bestCollisionTable.h"
@@ -108,10 +110,11 @@ struct MultiplicityCounter {
     false,
     true};
 
-  std::vector<int> usedTracksIds;
-  std::vector<int> usedTracksIdsDF;
-  std::vector<int> usedTracksIdsDFMC;
-  std::vector<int> usedTracksIdsDFMCEff;
+  // ids of the tracks already counted through their ambiguous-track entry, looked up for every track
+  std::unordered_set<int> usedTracksIds;
+  std::unordered_set<int> usedTracksIdsDF;
+  std::unordered_set<int> usedTracksIdsDFMC;
+  std::unordered_set<int> usedTracksIdsDFMCEff;
 
   void init(InitContext&)
   {
@@ -580,7 +583,7 @@ struct MultiplicityCounter {
           continue;
         }
       }
-      usedTracksIds.emplace_back(track.trackId());
+      usedTracksIds.emplace(track.trackId());
       if (std::abs(otrack.eta()) < estimatorEta) {
         ++Ntrks;
       }
@@ -600,7 +603,7 @@ struct MultiplicityCounter {
         }
       }
       if (otrack.has_collision() && otrack.collisionId() != track.bestCollisionId()) {
-        usedTracksIdsDF.emplace_back(track.trackId());
+        usedTracksIdsDF.emplace(track.trackId());
         if constexpr (fillHistos) {
           if constexpr (has_reco_cent<C>) {
             binnedRegistry.fill(HIST(ReassignedEtaZvtx), otrack.eta(), z, c, o);
@@ -634,10 +637,10 @@ struct MultiplicityCounter {
     }
 
     for (auto& track : tracks) {
-      if (std::find(usedTracksIds.begin(), usedTracksIds.end(), track.globalIndex()) != usedTracksIds.end()) {
+      if (usedTracksIds.contains(track.globalIndex())) {
         continue;
       }
-      if (std::find(usedTracksIdsDF.begin(), usedTracksIdsDF.end(), track.globalIndex()) != usedTracksIdsDF.end()) {
+      if (usedTracksIdsDF.contains(track.globalIndex())) {
         continue;
       }
       if (std::abs(track.eta()) < estimatorEta) {
@@ -706,10 +709,10 @@ struct MultiplicityCounter {
             }
           }
           for (auto& track : tracks) {
-            if (std::find(usedTracksIds.begin(), usedTracksIds.end(), track.globalIndex()) != usedTracksIds.end()) {
+            if (usedTracksIds.contains(track.globalIndex())) {
               continue;
             }
-            if (std::find(usedTracksIdsDF.begin(), usedTracksIdsDF.end(), track.globalIndex()) != usedTracksIdsDF.end()) {
+            if (usedTracksIdsDF.contains(track.globalIndex())) {
               continue;
             }
             if (Ntrks > 0) {
@@ -739,10 +742,10 @@ struct MultiplicityCounter {
             }
           }
           for (auto& track : tracks) {
-            if (std::find(usedTracksIds.begin(), usedTracksIds.end(), track.globalIndex()) != usedTracksIds.end()) {
+            if (usedTracksIds.contains(track.globalIndex())) {
               continue;
             }
-            if (std::find(usedTracksIdsDF.begin(), usedTracksIdsDF.end(), track.globalIndex()) != usedTracksIdsDF.end()) {
+            if (usedTracksIdsDF.contains(track.globalIndex())) {
               continue;
             }
             if (Ntrks > 0) {
@@ -1066,9 +1069,9 @@ struct MultiplicityCounter {
     usedTracksIds.clear();
     for (auto const& track : atracks) {
       auto otrack = track.template track_as<FiLTracks>();
-      usedTracksIds.emplace_back(track.trackId());
+      usedTracksIds.emplace(track.trackId());
       if (otrack.collisionId() != track.bestCollisionId()) {
-        usedTracksIdsDFMCEff.emplace_back(track.trackId());
+        usedTracksIdsDFMCEff.emplace(track.trackId());
       }
       if (otrack.has_mcParticle()) {
         auto particle = otrack.mcParticle_as<Particles>();
@@ -1111,10 +1114,10 @@ struct MultiplicityCounter {
       }
     }
     for (auto const& track : tracks) {
-      if (std::find(usedTracksIds.begin(), usedTracksIds.end(), track.globalIndex()) != usedTracksIds.end()) {
+      if (usedTracksIds.contains(track.globalIndex())) {
         continue;
       }
-      if (std::find(usedTracksIdsDFMCEff.begin(), usedTracksIdsDFMCEff.end(), track.globalIndex()) != usedTracksIdsDFMCEff.end()) {
+      if (usedTracksIdsDFMCEff.contains(track.globalIndex())) {
         continue;
       }
       if (track.has_mcParticle()) {
@@ -31,6 +31,10 @@ class DGSelector
   DGSelector() { fPDG = TDatabasePDG::Instance(); }
   ~DGSelector() { delete fPDG; }
 
+  // Use per-DF flags of the BCs with a FIT veto (udhelpers::FITveto) instead of evaluating the vetoes,
+  // they must be built with the cuts of the selection. nullptr to evaluate the BCs again
+  void SetFITVetoFlags(udhelpers::BCFlagIndex const* fitVeto) { fFITVeto = fitVeto; }
+
   template <typename CC, typename BCs, typename TCs, typename FWs>
   int Print(DGCutparHolder /*diffCuts*/, CC& collision, BCs& /*bcRange*/, TCs& /*tracks*/, FWs& /*fwdtracks*/)
   {
@@ -52,18 +56,24 @@ class DGSelector
     //  1 TSC
     //  2 TCE
     //  3 TOR
-    for (auto const& bc : bcRange) {
-      /* for debuging
-      auto isVetoed = udhelpers::FITveto(bc, diffCuts);
-      auto isClean = udhelpers::cleanFIT(bc, diffCuts.maxFITtime(), diffCuts.FITAmpLimits());
-      LOGF(info, "<IsSelected> isVetoed: %d isClean: %d", isVetoed, isClean);
-      if (isVetoed) {
+    if (fFITVeto) {
+      if (fFITVeto->count(bcRange) > 0) {
         return 1;
       }
-      */
+    } else {
+      for (auto const& bc : bcRange) {
+        /* for debuging
+        auto isVetoed = udhelpers::FITveto(bc, diffCuts);
+        auto isClean = udhelpers::cleanFIT(bc, diffCuts.maxFITtime(), diffCuts.FITAmpLimits());
+        LOGF(info, "<IsSelected> isVetoed: %d isClean: %d", isVetoed, isClean);
+        if (isVetoed) {
+          return 1;
+        }
+        */
 
-      if (udhelpers::FITveto(bc, diffCuts)) {
-        return 1;
+        if (udhelpers::FITveto(bc, diffCuts)) {
+          return 1;
+        }
       }
     }
 
@@ -207,10 +217,16 @@ class DGSelector
     //  1 TSC
     //  2 TCE
     //  3 TOR
-    for (auto const& bc : bcRange) {
-      if (udhelpers::FITveto(bc, diffCuts)) {
+    if (fFITVeto) {
+      if (fFITVeto->count(bcRange) > 0) {
         return 1;
       }
+    } else {
+      for (auto const& bc : bcRange) {
+        if (udhelpers::FITveto(bc, diffCuts)) {
+          return 1;
+        }
+      }
     }
 
     // no activity in muon arm
@@ -277,6 +293,7 @@ class DGSelector
 
  private:
   TDatabasePDG* fPDG;
+  udhelpers::BCFlagIndex const* fFITVeto = nullptr; //!
 
   ClassDefNV(DGSelector, 1);
 };
@@ -38,6 +38,14 @@ class SGSelector
     return 1;
   }
 
+  // Use per-DF flags of the BCs which are not clean on the A and C sides instead of cleanFITA/C,
+  // they must be built with the cuts of the selection. nullptr to evaluate the BCs again
+  void SetFITFlags(udhelpers::BCFlagIndex const* notCleanA, udhelpers::BCFlagIndex const* notCleanC)
+  {
+    fNotCleanA = notCleanA;
+    fNotCleanC = notCleanC;
+  }
+
   template <typename CC, typename BCs, typename BC>
   SelectionResult<BC> IsSelected(SGCutParHolder diffCuts, CC& collision, BCs& bcRange, BC& oldbc)
   {
@@ -57,15 +65,30 @@ class SGSelector
     float ampc = 0;
     float ampa = 0;
     bool gA = true, gC = true;
+    // with the flags, windows not clean on both sides are rejected and clean ones skip the search
+    const bool useFlags = fNotCleanA && fNotCleanC;
+    bool searchNewBC = true;
+    if (useFlags) {
+      const bool cleanA = fNotCleanA->count(bcRange) == 0;
+      const bool cleanC = fNotCleanC->count(bcRange) == 0;
+      if (!cleanA && !cleanC) {
+        result.value = 3;
+        return result;
+      }
+      searchNewBC = !(cleanA && cleanC);
+    }
     for (auto const& bc : bcRange) {
-      if (!udhelpers::cleanFITA(bc, diffCuts.maxFITtime(), diffCuts.FITAmpLimits())) {
+      if (!searchNewBC) {
+        break;
+      }
+      if (useFlags ? fNotCleanA->isSet(bc.globalIndex()) : !udhelpers::cleanFITA(bc, diffCuts.maxFITtime(), diffCuts.FITAmpLimits())) {
         if (gA)
           newbc = bc;
         if (!gA && std::abs(static_cast<int64_t>(bc.globalBC() - oldbc.globalBC())) < std::abs(static_cast<int64_t>(newbc.globalBC() - oldbc.globalBC())))
           newbc = bc;
         gA = false;
       }
-      if (!udhelpers::cleanFITC(bc, diffCuts.maxFITtime(), diffCuts.FITAmpLimits())) {
+      if (useFlags ? fNotCleanC->isSet(bc.globalIndex()) : !udhelpers::cleanFITC(bc, diffCuts.maxFITtime(), diffCuts.FITAmpLimits())) {
         if (gC)
           newbc = bc;
         if (!gC && std::abs(static_cast<int64_t>(bc.globalBC() - oldbc.globalBC())) < std::abs(static_cast<int64_t>(newbc.globalBC() - oldbc.globalBC())))
@@ -148,6 +171,8 @@ class SGSelector
 
  private:
   TDatabasePDG* fPDG;
+  udhelpers::BCFlagIndex const* fNotCleanA = nullptr;
+  udhelpers::BCFlagIndex const* fNotCleanC = nullptr;
 };
 
 #endif // PWGUD_CORE_SGSELECTOR_H_
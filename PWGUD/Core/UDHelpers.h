@@ -16,6 +16,7 @@
 #ifndef PWGUD_CORE_UDHELPERS_H_
 #define PWGUD_CORE_UDHELPERS_H_
 
+#include <cstdint>
 #include <vector>
 #include <bitset>
 
@@ -534,6 +535,59 @@ bool FITveto(T const& bc, DGCutparHolder const& diffCuts)
   return false;
 }
 
+// -----------------------------------------------------------------------------
+// Flags of all the BCs of a DF, indexed by the BC globalIndex, with the number of flagged
+// BCs up to each BC. The BCs of a window are then checked in O(1) instead of evaluating the
+// flag (e.g. !cleanFITA) for every BC of the window of every collision.
+// The index is rebuilt when it is used with the BCs of another DF.
+class BCFlagIndex
+{
+ public:
+  template <typename BCs, typename F>
+  void build(BCs const& bcs, F&& flag)
+  {
+    mTable = bcs.asArrowTable().get();
+    mSize = bcs.size();
+    mFirstBC = mSize > 0 ? bcs.iteratorAt(0).globalBC() : 0;
+    mLastBC = mSize > 0 ? bcs.iteratorAt(mSize - 1).globalBC() : 0;
+    mFlags.assign(mSize, false);
+    mCounts.assign(mSize + 1, 0);
+    for (auto const& bc : bcs) {
+      const int64_t index = bc.globalIndex();
+      mFlags[index] = flag(bc);
+      mCounts[index + 1] = mCounts[index] + (mFlags[index] ? 1 : 0);
+    }
+  }
+
+  template <typename BCs>
+  bool isBuiltFor(BCs const& bcs) const
+  {
+    return mTable == bcs.asArrowTable().get() && mSize == bcs.size() &&
+           (mSize == 0 || (mFirstBC == bcs.iteratorAt(0).globalBC() && mLastBC == bcs.iteratorAt(mSize - 1).globalBC()));
+  }
+
+  bool isSet(int64_t index) const { return mFlags[index]; }
+
+  // number of flagged BCs of a slice of the BCs table
+  template <typename BCs>
+  int64_t count(BCs const& bcRange) const
+  {
+    if (bcRange.size() == 0) {
+      return 0;
+    }
+    const int64_t first = bcRange.begin().globalIndex();
+    return mCounts[first + bcRange.size()] - mCounts[first];
+  }
+
+ private:
+  const void* mTable = nullptr;
+  int64_t mSize = -1;
+  uint64_t mFirstBC = 0;
+  uint64_t mLastBC = 0;
+  std::vector<bool> mFlags;
+  std::vector<int32_t> mCounts;
+};
+
 // -----------------------------------------------------------------------------
 
 template <typename T>
@@ -12,6 +12,11 @@
 #ifndef PWGUD_CORE_UPCHELPERS_H_
 #define PWGUD_CORE_UPCHELPERS_H_
 
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
 #include "Framework/AnalysisDataModel.h"
 #include "Common/DataModel/EventSelection.h"
 #include "Common/CCDB/EventSelectionParams.h"
@@ -95,6 +100,73 @@ struct FITInfo {
   int32_t distClosestBcT0A = 999;
 };
 
+// global BCs of the detector entries passing a selection and their row indices,
+// stored as sorted flat arrays that are refilled (without reallocation) every DF
+struct BCIndex {
+  std::vector<uint64_t> globalBCs;
+  std::vector<int32_t> rows;
+
+  void clear()
+  {
+    mEntries.clear();
+    globalBCs.clear();
+    rows.clear();
+  }
+
+  void add(uint64_t globalBC, int32_t row) { mEntries.emplace_back(globalBC, row); }
+
+  // sort the added entries; for repeated BCs the last added entry is kept
+  void build()
+  {
+    if (!std::is_sorted(mEntries.begin(), mEntries.end(), [](const auto& a, const auto& b) { return a.first < b.first; })) {
+      std::stable_sort(mEntries.begin(), mEntries.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    }
+    globalBCs.clear();
+    rows.clear();
+    for (const auto& [globalBC, row] : mEntries) {
+      if (!globalBCs.empty() && globalBCs.back() == globalBC) {
+        rows.back() = row;
+        continue;
+      }
+      globalBCs.push_back(globalBC);
+      rows.push_back(row);
+    }
+  }
+
+  std::size_t size() const { return globalBCs.size(); }
+
+  // row of the entry at this BC, -1 if none
+  int32_t find(uint64_t globalBC) const
+  {
+    auto it = std::lower_bound(globalBCs.begin(), globalBCs.end(), globalBC);
+    return (it != globalBCs.end() && *it == globalBC) ? rows[it - globalBCs.begin()] : -1;
+  }
+
+  // position of the closest BC, the later one for equal distances; the index must not be empty
+  std::size_t closest(uint64_t globalBC) const
+  {
+    std::size_t i1 = std::lower_bound(globalBCs.begin(), globalBCs.end(), globalBC) - globalBCs.begin();
+    if (i1 == globalBCs.size()) {
+      return i1 - 1;
+    }
+    std::size_t i2 = i1 > 0 ? i1 - 1 : i1;
+    auto dbc1 = globalBCs[i1] - globalBC;
+    auto dbc2 = globalBC - globalBCs[i2];
+    return (i1 == i2 || dbc1 <= dbc2) ? i1 : i2;
+  }
+
+  // positions [first, last) of the entries with BC in [bcLow, bcHigh]
+  std::pair<std::size_t, std::size_t> window(uint64_t bcLow, uint64_t bcHigh) const
+  {
+    auto first = std::lower_bound(globalBCs.begin(), globalBCs.end(), bcLow);
+    auto last = std::upper_bound(first, globalBCs.end(), bcHigh);
+    return {static_cast<std::size_t>(first - globalBCs.begin()), static_cast<std::size_t>(last - globalBCs.begin())};
+  }
+
+ private:
+  std::vector<std::pair<uint64_t, int32_t>> mEntries;
+};
+
 template <typename T, typename TSelectorsArray>
 void applyFwdCuts(UPCCutparHolder& upcCuts, const T& track, TSelectorsArray& fwdSelectors)
 {
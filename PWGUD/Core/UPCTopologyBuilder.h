@@ -0,0 +1,180 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file UPCTopologyBuilder.h
+/// \brief Enumeration of the k-prong combinations of the tracks of a UPC event
+///
+/// The kinematics, the charge and the selection bits (PID, quality, ..., defined by the task) of the
+/// tracks are stored once per event. The combinations of k prongs are then enumerated in increasing track
+/// order, optionally requiring some selection bits for all the prongs and a given net charge. The loops
+/// are pruned with the numbers of positive and negative selected tracks left, so that the branches which
+/// cannot reach the net charge are not explored.
+
+#ifndef PWGUD_CORE_UPCTOPOLOGYBUILDER_H_
+#define PWGUD_CORE_UPCTOPOLOGYBUILDER_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace upctopology
+{
+
+struct Prong {
+  float px = 0.f;
+  float py = 0.f;
+  float pz = 0.f;
+  int sign = 0;
+  uint32_t flags = 0; // selection bits defined by the task
+  int64_t index = -1; // index() of the track
+};
+
+template <int NMaxProngs = 16>
+class TopologyBuilder
+{
+ public:
+  static_assert(NMaxProngs > 0 && NMaxProngs <= 32, "At most 32 prongs, combinations are also given as bit masks");
+  static constexpr int kAnyCharge = std::numeric_limits<int>::max();
+
+  void clear() { mNProngs = 0; }
+
+  /// Store a track with its selection bits, false if the builder is full
+  template <typename T>
+  bool add(T const& track, uint32_t flags)
+  {
+    if (mNProngs >= NMaxProngs) {
+      return false;
+    }
+    mProngs[mNProngs++] = Prong{track.px(), track.py(), track.pz(), track.sign(), flags, track.index()};
+    return true;
+  }
+
+  int size() const { return mNProngs; }
+  Prong const& operator[](int i) const { return mProngs[i]; }
+
+  int netCharge() const
+  {
+    int charge = 0;
+    for (int i = 0; i < mNProngs; i++) {
+      charge += mProngs[i].sign;
+    }
+    return charge;
+  }
+
+  /// Number of prongs with all the given bits
+  int count(uint32_t flags) const
+  {
+    int n = 0;
+    for (int i = 0; i < mNProngs; i++) {
+      n += (mProngs[i].flags & flags) == flags;
+    }
+    return n;
+  }
+
+  /// Bit mask of the prongs of a combination, e.g. to get the recoiling prongs of a 1+3 topology
+  template <std::size_t K>
+  static uint32_t mask(std::array<int, K> const& combination)
+  {
+    uint32_t bits = 0;
+    for (const auto i : combination) {
+      bits |= (1u << i);
+    }
+    return bits;
+  }
+
+  /// Call callback(std::array<int, K> const&) with the positions of the prongs of every combination of K prongs
+  /// having all the bits requiredFlags and a total charge netCharge (or any with kAnyCharge).
+  /// Returns the number of combinations.
+  template <int K, typename F>
+  int forEachCombination(F&& callback, int netCharge = kAnyCharge, uint32_t requiredFlags = 0) const
+  {
+    static_assert(K > 0 && K <= NMaxProngs, "Invalid number of prongs");
+    Selection sel;
+    sel.constrained = netCharge != kAnyCharge;
+    sel.netCharge = netCharge;
+    for (int i = 0; i < mNProngs; i++) {
+      if ((mProngs[i].flags & requiredFlags) != requiredFlags) {
+        continue;
+      }
+      // the pruning relies on unit charges
+      if (sel.constrained && mProngs[i].sign != 1 && mProngs[i].sign != -1) {
+        continue;
+      }
+      sel.prongs[sel.n++] = i;
+    }
+    if (sel.n < K) {
+      return 0;
+    }
+    sel.nPosLeft[sel.n] = sel.nNegLeft[sel.n] = 0;
+    for (int j = sel.n - 1; j >= 0; j--) {
+      const int sign = mProngs[sel.prongs[j]].sign;
+      sel.nPosLeft[j] = sel.nPosLeft[j + 1] + (sign > 0);
+      sel.nNegLeft[j] = sel.nNegLeft[j + 1] + (sign < 0);
+    }
+    if (sel.constrained && !sel.reachable(0, K, 0)) {
+      return 0;
+    }
+    std::array<int, K> combination{};
+    int nCombinations = 0;
+    enumerate<K, 0>(combination, 0, 0, sel, callback, nCombinations);
+    return nCombinations;
+  }
+
+ private:
+  struct Selection {
+    std::array<int, NMaxProngs> prongs{};
+    std::array<int, NMaxProngs + 1> nPosLeft{}; // selected positive prongs from position j on
+    std::array<int, NMaxProngs + 1> nNegLeft{};
+    int n = 0;
+    bool constrained = false;
+    int netCharge = 0;
+
+    // whether nLeft prongs taken from position j on can bring the charge to netCharge
+    bool reachable(int j, int nLeft, int charge) const
+    {
+      const int missing = netCharge - charge;
+      if ((nLeft + missing) % 2 != 0) {
+        return false;
+      }
+      const int nPos = (nLeft + missing) / 2;
+      const int nNeg = nLeft - nPos;
+      return nPos >= 0 && nNeg >= 0 && nPos <= nPosLeft[j] && nNeg <= nNegLeft[j];
+    }
+  };
+
+  template <int K, int Depth, typename F>
+  void enumerate(std::array<int, K>& combination, int first, int charge, Selection const& sel, F& callback, int& nCombinations) const
+  {
+    if constexpr (Depth == K) {
+      callback(static_cast<std::array<int, K> const&>(combination));
+      nCombinations++;
+    } else {
+      constexpr int NLeft = K - Depth;
+      for (int j = first; j <= sel.n - NLeft; j++) {
+        const int prong = sel.prongs[j];
+        const int newCharge = charge + mProngs[prong].sign;
+        if (sel.constrained && !sel.reachable(j + 1, NLeft - 1, newCharge)) {
+          continue;
+        }
+        combination[Depth] = prong;
+        enumerate<K, Depth + 1>(combination, j + 1, newCharge, sel, callback, nCombinations);
+      }
+    }
+  }
+
+  std::array<Prong, NMaxProngs> mProngs{};
+  int mNProngs = 0;
+};
+
+} // namespace upctopology
+
+#endif // PWGUD_CORE_UPCTOPOLOGYBUILDER_H_
@@ -494,6 +494,9 @@ class decayTree
       return decayTreeResType{{"ULS", ULSresults}, {"LS", LSresults}};
     }
 
+    // four-momenta and cuts of the finals for all the tracks
+    computeFinals(tracks);
+
     // create all possible track combinations including permutations
     auto combs = combinations(tracks.size());
 
@@ -761,6 +764,11 @@ class decayTree
   int fnFinals;
   std::vector<std::vector<int>> fPermutations;
 
+  // per event: four-momentum and status of each final for each track, track charges
+  std::vector<std::vector<TLorentzVector>> fFinalIVMs;
+  std::vector<std::vector<int>> fFinalStatus;
+  std::vector<int> fTrackCharges;
+
   // histogram registry
   std::vector<std::string> fccs;
   std::vector<std::string> fdets;
@@ -790,6 +798,34 @@ class decayTree
   void updateChargeState();
 
   // templated functions
+  // compute the four-momentum and apply the cuts of each final for each track
+  // the results only depend on the final and the track and are used for all the combinations
+  template <typename TTs>
+  void computeFinals(TTs const& tracks)
+  {
+    auto ntracks = tracks.size();
+    fTrackCharges.resize(ntracks);
+    fFinalIVMs.resize(fnFinals);
+    fFinalStatus.resize(fnFinals);
+    for (auto ind = 0; ind < fnFinals; ind++) {
+      auto fin = getFinal(ind);
+      auto mass = fPDG->GetParticle(fin->pid())->Mass();
+      fFinalIVMs[ind].resize(ntracks);
+      fFinalStatus[ind].resize(ntracks);
+      auto itrack = 0;
+      for (const auto& track : tracks) {
+        fFinalIVMs[ind][itrack].SetXYZM(track.px(), track.py(), track.pz(), mass);
+        fTrackCharges[itrack] = track.sign();
+        fin->setIVM(fFinalIVMs[ind][itrack]);
+        fin->setCharge(track.sign());
+        fin->setStatus(1);
+        fin->updateStatus(track);
+        fFinalStatus[ind][itrack] = fin->status();
+        itrack++;
+      }
+    }
+  }
+
   template <typename TTs>
   void computeResonance(resonance* res, TTs const& tracks, std::vector<int>& comb)
   {
@@ -804,16 +840,11 @@ class decayTree
 
     // is this a final state or a resonance
     if (res->isFinal()) {
-      // is a final
-      auto pdgparticle = fPDG->GetParticle(res->pid());
-      auto track = (tracks.begin() + comb[res->counter()]);
-      ivm.SetXYZM(track.px(), track.py(), track.pz(), pdgparticle->Mass());
-      res->setIVM(ivm);
-      res->setCharge(track.sign());
-      res->setStatus(1);
-
-      // apply cuts
-      res->updateStatus(track);
+      // is a final, the cuts were applied in computeFinals
+      auto itrack = comb[res->counter()];
+      res->setIVM(fFinalIVMs[res->counter()][itrack]);
+      res->setCharge(fTrackCharges[itrack]);
+      res->setStatus(fFinalStatus[res->counter()][itrack]);
 
     } else {
       // is a resonance
@@ -57,6 +57,7 @@ struct DGCandProducer {
 
   // DG selector
   DGSelector dgSelector;
+  udhelpers::BCFlagIndex fitVeto; // BCs of the DF with a FIT veto
 
   // configurables
   Configurable<bool> saveAllTracks{"saveAllTracks", true, "save only PV contributors or all tracks associated to a collision"};
@@ -314,6 +315,11 @@ struct DGCandProducer {
     // fill FIT histograms
     fillFIThistograms(bc, histdir);
 
+    // FIT vetoes of the BCs, evaluated once per DF for all the collisions
+    if (!fitVeto.isBuiltFor(bcs)) {
+      fitVeto.build(bcs, [&](auto const& fitbc) { return udhelpers::FITveto(fitbc, diffCuts); });
+    }
+
     // obtain slice of compatible BCs
     auto bcRange = udhelpers::compatibleBCs(collision, diffCuts.NDtcoll(), bcs, diffCuts.minNBCs());
     LOGF(debug, "<DGCandProducer>  Size of bcRange %d", bcRange.size());
@@ -429,6 +435,7 @@ struct DGCandProducer {
 
     // DGCuts
     diffCuts = (DGCutparHolder)DGCuts;
+    dgSelector.SetFITVetoFlags(&fitVeto);
 
     // add histograms for the different process functions
     histPointers.clear();
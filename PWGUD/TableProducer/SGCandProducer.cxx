@@ -86,6 +86,8 @@ struct SGCandProducer {
 
   //  SG selector
   SGSelector sgSelector;
+  udhelpers::BCFlagIndex fitNotCleanA; // BCs of the DF not clean on the A side
+  udhelpers::BCFlagIndex fitNotCleanC; // BCs of the DF not clean on the C side
   ctpRateFetcher mRateFetcher;
 
   // data tables
@@ -320,6 +322,13 @@ struct SGCandProducer {
     }
     auto newbc = bc;
 
+    // FIT cleanliness of the BCs, evaluated once per DF for all the collisions
+    if (!fitNotCleanA.isBuiltFor(bcs)) {
+      const auto lims = sameCuts.FITAmpLimits();
+      fitNotCleanA.build(bcs, [&](auto const& fitbc) { return !udhelpers::cleanFITA(fitbc, sameCuts.maxFITtime(), lims); });
+      fitNotCleanC.build(bcs, [&](auto const& fitbc) { return !udhelpers::cleanFITC(fitbc, sameCuts.maxFITtime(), lims); });
+    }
+
     // obtain slice of compatible BCs
     auto bcRange = udhelpers::compatibleBCs(collision, sameCuts.NDtcoll(), bcs, sameCuts.minNBCs());
     auto isSGEvent = sgSelector.IsSelected(sameCuts, collision, bcRange, bc);
@@ -403,6 +412,7 @@ struct SGCandProducer {
     ccdb->setCaching(true);
     ccdb->setFatalWhenNull(false);
     sameCuts = (SGCutParHolder)SGCuts;
+    sgSelector.SetFITFlags(&fitNotCleanA, &fitNotCleanC);
 
     // add histograms for the different process functions
     histPointers.clear();
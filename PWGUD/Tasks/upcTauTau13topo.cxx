@@ -33,6 +33,7 @@
 #include "PWGUD/Core/UDHelpers.h"
 #include "PWGUD/Core/DGPIDSelector.h"
 #include "PWGUD/Core/SGSelector.h"
+#include "PWGUD/Core/UPCTopologyBuilder.h"
 
 #include "Common/Core/RecoDecay.h"
 // #include <CommonUtils/EnumFlags.h>
@@ -128,6 +129,11 @@ struct TauTau13topo {
   Produces<o2::aod::TauFourTracks> tauFourTracks;
 
   SGSelector sgSelector;
+  // selection bits of the tracks in the topology builder
+  enum TopoFlags : uint32_t {
+    kTopoHasTPC = 1u << 0,
+    kTopoGoodTOF = 1u << 1
+  };
   // configurables
   Configurable<float> cutFV0{"cutFV0", 10000., "FV0A threshold"};
   Configurable<float> cutFT0A{"cutFT0A", 150., "FT0A threshold"};
@@ -2259,24 +2265,29 @@ struct TauTau13topo {
     int counterTmp = 0;
     bool flagIMGam2ePV[4] = {true, true, true, true};
 
+    // kinematics and detector flags of the 4 tracks, read once for all the combinations
+    upctopology::TopologyBuilder<4> topology;
     for (const auto& trk : PVContributors) {
-      p.SetXYZM(trk.px(), trk.py(), trk.pz(), MassElectron);
-      for (const auto& trk1 : PVContributors) {
-        if (trk.index() >= trk1.index())
-          continue;
-        if (trk1.hasTPC())
-          nPiHasTPC[trk.index()]++;
-        p1.SetXYZM(trk1.px(), trk1.py(), trk1.pz(), MassElectron);
-        invMass2El[(counterTmp < 3 ? counterTmp : 5 - counterTmp)][(counterTmp < 3 ? 0 : 1)] = (p + p1).Mag2();
-        gammaPair[(counterTmp < 3 ? counterTmp : 5 - counterTmp)][(counterTmp < 3 ? 0 : 1)] = (p + p1);
-        registry.get<TH1>(HIST("control/cut0/hInvMass2ElAll"))->Fill((p + p1).Mag2());
-        counterTmp++;
-        if ((p + p1).M() < 0.015) {
-          flagIMGam2ePV[trk.index()] = false;
-          flagIMGam2ePV[trk1.index()] = false;
-        }
-      } // end of loop over PVContributors
-    } // end of loop over PVContributors
+      topology.add(trk, (trk.hasTPC() ? kTopoHasTPC : 0u) | (isGoodTOFTrackCheck(trk) ? kTopoGoodTOF : 0u));
+    }
+
+    // pairs in increasing track order
+    topology.forEachCombination<2>([&](auto const& pair) {
+      const auto& trk = topology[pair[0]];
+      const auto& trk1 = topology[pair[1]];
+      if (trk1.flags & kTopoHasTPC)
+        nPiHasTPC[trk.index]++;
+      p.SetXYZM(trk.px, trk.py, trk.pz, MassElectron);
+      p1.SetXYZM(trk1.px, trk1.py, trk1.pz, MassElectron);
+      invMass2El[(counterTmp < 3 ? counterTmp : 5 - counterTmp)][(counterTmp < 3 ? 0 : 1)] = (p + p1).Mag2();
+      gammaPair[(counterTmp < 3 ? counterTmp : 5 - counterTmp)][(counterTmp < 3 ? 0 : 1)] = (p + p1);
+      registry.get<TH1>(HIST("control/cut0/hInvMass2ElAll"))->Fill((p + p1).Mag2());
+      counterTmp++;
+      if ((p + p1).M() < 0.015) {
+        flagIMGam2ePV[trk.index] = false;
+        flagIMGam2ePV[trk1.index] = false;
+      }
+    });
 
     // first loop to add all the tracks together
     p = TLorentzVector(0., 0., 0., 0.);
@@ -2294,6 +2305,18 @@ struct TauTau13topo {
     float deltaphi = 0;
     // remove combinatoric
     bool flagVcalPV[4] = {false, false, false, false};
+    // opening angle of each pair, filled once per track of the pair
+    topology.forEachCombination<2>([&](auto const& pair) {
+      v1.SetXYZ(topology[pair[0]].px, topology[pair[0]].py, topology[pair[0]].pz);
+      vtmp.SetXYZ(topology[pair[1]].px, topology[pair[1]].py, topology[pair[1]].pz);
+      deltaphi = v1.Angle(vtmp);
+      registry.get<TH1>(HIST("global/hDeltaAngleTrackPV"))->Fill(deltaphi);
+      registry.get<TH1>(HIST("global/hDeltaAngleTrackPV"))->Fill(deltaphi);
+      if (deltaphi < minAnglecut) { // default 0.05
+        flagVcalPV[pair[0]] = true;
+        flagVcalPV[pair[1]] = true;
+      }
+    });
 
     // bool trkIsGood[4] = {false, false, false, false};
     bool trkIsTOFGood[4] = {false, false, false, false};
@@ -2304,7 +2327,7 @@ struct TauTau13topo {
     for (const auto& trk : PVContributors) {
       // trkIsGood[counterTmp] =
       isGoodTrackCheck(trk);
-      trkIsTOFGood[counterTmp] = isGoodTOFTrackCheck(trk);
+      trkIsTOFGood[counterTmp] = (topology[counterTmp].flags & kTopoGoodTOF) != 0;
       tmpTrkCheck = trackCheck(trk); // check detectors associated to track
       registry.get<TH1>(HIST("global/hTrkCheck"))->Fill(tmpTrkCheck);
 
@@ -2313,17 +2336,6 @@ struct TauTau13topo {
       p2.SetXYZM(trk.px(), trk.py(), trk.pz(), MassElectron);
       mass3pi1e[counterTmp] = (p - p1 + p2).Mag();
 
-      v1.SetXYZ(trk.px(), trk.py(), trk.pz());
-      for (const auto& trk1 : PVContributors) {
-        if (trk.index() == trk1.index())
-          continue;
-        vtmp.SetXYZ(trk1.px(), trk1.py(), trk1.pz());
-        deltaphi = v1.Angle(vtmp);
-        registry.get<TH1>(HIST("global/hDeltaAngleTrackPV"))->Fill(deltaphi);
-        if (deltaphi < minAnglecut) { // default 0.05
-          flagVcalPV[counterTmp] = true;
-        }
-      } // end of loop over PVContributors
       nSigmaEl[counterTmp] = trk.tpcNSigmaEl();
       nSigmaPi[counterTmp] = trk.tpcNSigmaPi();
       nSigma3Pi[3] += (nSigmaPi[counterTmp] * nSigmaPi[counterTmp]);
@@ -2353,7 +2365,7 @@ struct TauTau13topo {
       // nclTPCfind[counterTmp] = trk.tpcNClsFindable();
       nclTPCcrossedRows[counterTmp] = trk.tpcNClsCrossedRows();
       // trkHasTof[counterTmp] = trk.hasTOF();
-      trkHasTof[counterTmp] = isGoodTOFTrackCheck(trk);
+      trkHasTof[counterTmp] = trkIsTOFGood[counterTmp];
       trkHasTpc[counterTmp] = trk.hasTPC();
       trkTime[counterTmp] = trk.trackTime();
       trkTimeRes[counterTmp] = trk.trackTimeRes();
@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+
+# Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+# See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+# All rights not expressly granted are reserved.
+#
+# This software is distributed under the terms of the GNU General Public
+# License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+#
+# In applying this license CERN does not waive the privileges and immunities
+# granted to it by virtue of its status as an Intergovernmental Organization
+# or submit itself to any jurisdiction.
+
+"""
+Script to share the tables of the common producers between trains running on the same node.
+The producer workflows (by default the ones of the "common" chain of train_throughput_chains.json)
+are run once per input AO2D file, and the tables they produce are written into a node-local store
+(by default in /dev/shm). The entries are keyed by:
+- the input file (path, size and modification time),
+- the producer workflows,
+- the hash of their configuration (the whole JSON file or only the given device keys),
+- the O2Physics installation.
+The first train requesting an entry produces it, the trains requesting it meanwhile wait for it,
+and the later ones find it ready. An entry is written into a temporary directory and renamed once
+complete, so that it is never read half-written.
+With --sidecar, the entry is instead kept next to the input file, as a sidecar of service tables
+named after the input file and the key, so that it is found again by the later trains on any node
+reading the same file.
+The script prints the options with which a train reads the entry instead of running the producers:
+the stored file is given as --aod-file with --aod-parent-access-level 1, so that the tables not in
+the entry are read from the original AO2D file, which is referenced as its parent. With the variable
+O2PHYSICS_SERVICE_TABLES_FROM_INPUT=1, the producers of the service tables (event selection,
+mult-cent table, TPC and TOF PID, track selection) find their tables in the input metadata and are
+left out of the workflow (see areTablesInInput in Common/Core/TableHelper.h).
+Usage:
+  shared_producers.py -i AO2D.root -c dpl-config.json [--config-keys event-selection-task ...] [--sidecar]
+  o2-analysis-my-task $(shared_producers.py -i AO2D.root -c dpl-config.json --options-only) ...
+"""
+
+import argparse
+import fcntl
+import hashlib
+import json
+import os
+import shlex
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+DEFAULT_STORE = "/dev/shm/o2physics-shared-producers"
+DEFAULT_PRODUCERS = [
+    "o2-analysis-timestamp",
+    "o2-analysis-event-selection",
+    "o2-analysis-multiplicity-table",
+    "o2-analysis-centrality-table",
+    "o2-analysis-track-propagation",
+    "o2-analysis-trackselection",
+    "o2-analysis-pid-tpc-base",
+    "o2-analysis-pid-tpc",
+    "o2-analysis-pid-tof-base",
+    "o2-analysis-pid-tof-merge",
+]
+ENTRY_FILE = "AO2D_producers.root"
+
+
+def entry_key(input_file, producers, configuration, config_keys):
+    """
+    Key of the entry of the store: hash of the input file, of the producers and of their configuration.
+    """
+    stat = os.stat(input_file)
+    config = {}
+    if configuration:
+        with open(configuration) as f:
+            config = json.load(f)
+        if config_keys:
+            config = {k: v for k, v in config.items() if k in config_keys}
+    description = {
+        "input": [os.path.realpath(input_file), stat.st_size, stat.st_mtime_ns],
+        "producers": producers,
+        "configuration": config,
+        "o2physics": [os.environ.get(v, "") for v in ("O2PHYSICS_ROOT", "O2PHYSICS_VERSION", "O2PHYSICS_REVISION")],
+    }
+    return hashlib.sha256(json.dumps(description, sort_keys=True).encode()).hexdigest()[:32]
+
+
+def produce(entry_dir, input_file, producers, configuration, tables, extra_options, verbose=0):
+    """
+    Runs the producers on the input file and publishes their tables as entry_dir, returns the return code.
+    """
+    tmp_dir = tempfile.mkdtemp(prefix=".tmp-", dir=os.path.dirname(entry_dir))
+    options = "-b"
+    if configuration:
+        options += f" --configuration json://{os.path.abspath(configuration)}"
+    if extra_options:
+        options += f" {extra_options}"
+    commands = [f"{wf} {options}" for wf in producers]
+    commands[0] += f" --aod-file {shlex.quote(os.path.realpath(input_file))}"
+    commands[-1] += f" --aod-writer-keep {shlex.quote(tables)} --aod-writer-resfile {ENTRY_FILE[:-5]}"
+    cmd = " | ".join(commands)
+    if verbose:
+        print("Running:", cmd, file=sys.stderr)
+    with open(os.path.join(tmp_dir, "log.txt"), "w") as log:
+        process = subprocess.run(cmd, shell=True, cwd=tmp_dir, stdout=log, stderr=subprocess.STDOUT)
+    if process.returncode != 0 or not os.path.isfile(os.path.join(tmp_dir, ENTRY_FILE)):
+        print(f"Producers failed, see {os.path.join(tmp_dir, 'log.txt')}", file=sys.stderr)
+        return process.returncode or 1
+    with open(os.path.join(tmp_dir, "entry.json"), "w") as f:
+        json.dump({"input": os.path.realpath(input_file), "producers": producers, "time": time.strftime("%Y-%m-%d %H:%M:%S")}, f, indent=2)
+    os.rename(tmp_dir, entry_dir)
+    return 0
+
+
+def get_entry(store, key, input_file, producers, configuration, tables, extra_options, verbose=0):
+    """
+    Returns the directory of the entry, producing it if no other train did, None on failure.
+    """
+    entry_dir = os.path.join(store, key)
+    if os.path.isdir(entry_dir):
+        return entry_dir
+    # the lock only serialises the trains producing the same entry, the complete entries are read without it
+    with open(os.path.join(store, key + ".lock"), "w") as lock:
+        fcntl.flock(lock, fcntl.LOCK_EX)
+        if not os.path.isdir(entry_dir):
+            if produce(entry_dir, input_file, producers, configuration, tables, extra_options, verbose) != 0:
+                return None
+        elif verbose:
+            print("Entry produced by another train:", entry_dir, file=sys.stderr)
+    return entry_dir
+
+
+def prune(store, max_age_hours):
+    """
+    Removes the entries (and the leftovers of failed productions) older than max_age_hours.
+    """
+    limit = time.time() - max_age_hours * 3600
+    for name in os.listdir(store):
+        path = os.path.join(store, name)
+        if os.path.getmtime(path) < limit:
+            if os.path.isdir(path):
+                shutil.rmtree(path, ignore_errors=True)
+            else:
+                os.remove(path)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("-i", "--input", required=True, help="Input AO2D file")
+    parser.add_argument("-c", "--configuration", default=None, help="DPL JSON configuration of the producers")
+    parser.add_argument("-k", "--config-keys", nargs="+", default=None, help="Hash only these device keys of the configuration")
+    parser.add_argument("-p", "--producers", nargs="+", default=DEFAULT_PRODUCERS, help="Producer workflows")
+    parser.add_argument("-t", "--tables", default="dangling", help="Tables stored, as for --aod-writer-keep")
+    parser.add_argument("-s", "--store", default=DEFAULT_STORE, help="Directory of the node-local store")
+    parser.add_argument("--sidecar", action="store_true", help="Keep the entry next to the input file instead of in the store")
+    parser.add_argument("-e", "--extra-options", default="", help="Further options of the producer workflows")
+    parser.add_argument("--max-age", type=float, default=None, help="Remove the entries older than this number of hours first")
+    parser.add_argument("--options-only", action="store_true", help="Print only the options of the train")
+    parser.add_argument("-v", "--verbose", action="count", default=0, help="Verbose mode")
+    args = parser.parse_args()
+
+    key = entry_key(args.input, args.producers, args.configuration, args.config_keys)
+    store = args.store
+    if args.sidecar:
+        store = os.path.dirname(os.path.realpath(args.input))
+        key = f".{os.path.splitext(os.path.basename(args.input))[0]}_service_{key}"
+    else:
+        os.makedirs(store, exist_ok=True)
+        if args.max_age is not None:
+            prune(store, args.max_age)
+    entry_dir = get_entry(store, key, args.input, args.producers, args.configuration, args.tables, args.extra_options, args.verbose)
+    if entry_dir is None:
+        sys.exit(1)
+    # touched at each use, so that --max-age removes the entries no longer used
+    os.utime(entry_dir)
+    options = f"--aod-file {shlex.quote(os.path.join(entry_dir, ENTRY_FILE))} --aod-parent-access-level 1"
+    if not args.options_only:
+        print("Entry:", entry_dir)
+        print("Set O2PHYSICS_SERVICE_TABLES_FROM_INPUT=1 to leave out the producers of the stored tables")
+        print("Options of the train:", end=" ")
+    print(options)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,189 @@
+#!/usr/bin/env python3
+
+# Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+# See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+# All rights not expressly granted are reserved.
+#
+# This software is distributed under the terms of the GNU General Public
+# License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+#
+# In applying this license CERN does not waive the privileges and immunities
+# granted to it by virtue of its status as an Intergovernmental Organization
+# or submit itself to any jurisdiction.
+
+"""
+Script to measure the throughput of chains of analysis workflows on reference AO2D files.
+Each chain of the configuration (see train_throughput_chains.json) is run on the given input
+with the DPL resources monitoring enabled. The report collects, per chain:
+- the wall time and the CPU time of all the processes of the chain,
+- the peak memory of the devices (from the DPL metrics, else the peak RSS of the processes),
+- the per-device metrics written by DPL in performanceMetrics.json (maximum and mean of each),
+- the number of DFs read and the DF rate,
+- the size of the output files.
+The report can be compared with a baseline report, the chains slower (or larger) than the
+baseline by more than the tolerance are listed and the script exits with a non-zero code.
+Usage:
+  train_throughput.py -i AO2D.root -c train_throughput_chains.json -o report.json [-b baseline.json]
+"""
+
+import argparse
+import json
+import os
+import resource
+import shlex
+import shutil
+import subprocess
+import sys
+import time
+
+# report quantities compared with the baseline, larger is worse
+COMPARED_QUANTITIES = ["wallTime", "cpuTime", "peakRss", "outputSize"]
+
+
+def run_chain(name, chain, input_file, work_dir, monitoring_interval, verbose=0):
+    """
+    Runs the workflows of a chain, piped as usual, in a dedicated directory and returns its report.
+    """
+    chain_dir = os.path.join(work_dir, name)
+    shutil.rmtree(chain_dir, ignore_errors=True)
+    os.makedirs(chain_dir)
+    input_file = ("@" + os.path.abspath(input_file[1:])) if input_file.startswith("@") else os.path.abspath(input_file)
+    workflows = chain["workflows"]
+    options = f"-b --resources-monitoring {monitoring_interval}"
+    if "configuration" in chain:
+        options += f" --configuration json://{os.path.abspath(chain['configuration'])}"
+    commands = [f"{wf} {options}" for wf in workflows]
+    commands[0] += f" --aod-file {shlex.quote(input_file)}"
+    if chain.get("aodWriter", False):
+        commands[-1] += " --aod-writer-keep dangling"
+    cmd = " | ".join(commands)
+    if verbose:
+        print("Running", name, ":", cmd)
+
+    usage_before = resource.getrusage(resource.RUSAGE_CHILDREN)
+    start = time.monotonic()
+    with open(os.path.join(chain_dir, "log.txt"), "w") as log:
+        process = subprocess.run(cmd, shell=True, cwd=chain_dir, stdout=log, stderr=subprocess.STDOUT)
+    wall_time = time.monotonic() - start
+    usage_after = resource.getrusage(resource.RUSAGE_CHILDREN)
+
+    report = {
+        "returnCode": process.returncode,
+        "wallTime": wall_time,
+        "cpuTime": (usage_after.ru_utime + usage_after.ru_stime) - (usage_before.ru_utime + usage_before.ru_stime),
+        "outputSize": sum(os.path.getsize(os.path.join(chain_dir, f)) for f in os.listdir(chain_dir) if f.endswith(".root")),
+        "devices": read_device_metrics(os.path.join(chain_dir, "performanceMetrics.json")),
+    }
+    # memory metrics of the devices, ru_maxrss (in kB) is the maximum over all the processes run so far
+    memory = [m["max"] for d in report["devices"].values() for k, m in d.items() if "setsize" in k.lower() or "rss" in k.lower()]
+    report["peakRss"] = max(memory) if memory else usage_after.ru_maxrss * 1024
+    n_dfs = count_dataframes(input_file)
+    if n_dfs > 0:
+        report["dataFrames"] = n_dfs
+        report["dataFrameRate"] = n_dfs / wall_time
+    return report
+
+
+def read_device_metrics(file_name):
+    """
+    Summarises the per-device metrics of the DPL resources monitoring with their maximum and mean.
+    """
+    if not os.path.isfile(file_name):
+        return {}
+    with open(file_name) as f:
+        metrics = json.load(f)
+    devices = {}
+    for device, device_metrics in metrics.items():
+        if not isinstance(device_metrics, dict):
+            continue
+        devices[device] = {}
+        for metric, samples in device_metrics.items():
+            values = [s["value"] for s in samples if isinstance(s, dict) and isinstance(s.get("value"), (int, float))] if isinstance(samples, list) else []
+            if values:
+                devices[device][metric] = {"max": max(values), "mean": sum(values) / len(values)}
+    return devices
+
+
+def count_dataframes(input_file):
+    """
+    Number of DFs (DF_ folders) of the input AO2D file(s), 0 if PyROOT is not available.
+    """
+    try:
+        import ROOT
+    except ImportError:
+        return 0
+    if input_file.startswith("@"):
+        with open(input_file[1:]) as f:
+            files = [line.strip() for line in f if line.strip()]
+    else:
+        files = [input_file]
+    n_dfs = 0
+    for file_name in files:
+        root_file = ROOT.TFile.Open(file_name)
+        if not root_file or root_file.IsZombie():
+            continue
+        n_dfs += len({key.GetName() for key in root_file.GetListOfKeys() if key.GetName().startswith("DF_")})
+        root_file.Close()
+    return n_dfs
+
+
+def compare(report, baseline, tolerance):
+    """
+    Returns the list of the quantities of the chains exceeding the baseline by more than the tolerance.
+    """
+    regressions = []
+    for name, chain_report in report["chains"].items():
+        if name not in baseline.get("chains", {}):
+            continue
+        reference = baseline["chains"][name]
+        for quantity in COMPARED_QUANTITIES:
+            value = chain_report.get(quantity, 0)
+            ref = reference.get(quantity, 0)
+            if ref > 0 and value > ref * (1 + tolerance):
+                regressions.append(f"{name}: {quantity} {value:.4g} vs {ref:.4g} in the baseline (+{100 * (value / ref - 1):.1f}%)")
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("-i", "--input", required=True, help="Reference AO2D file (or list of files prefixed with @)")
+    parser.add_argument("-c", "--chains", required=True, help="JSON file with the chains of workflows")
+    parser.add_argument("-o", "--output", default="train_throughput_report.json", help="Output report")
+    parser.add_argument("-b", "--baseline", default=None, help="Baseline report to compare with")
+    parser.add_argument("-t", "--tolerance", type=float, default=0.1, help="Relative tolerance of the comparison with the baseline")
+    parser.add_argument("-s", "--select", nargs="+", default=None, help="Run only these chains")
+    parser.add_argument("-w", "--work-dir", default="train_throughput", help="Directory where the chains are run")
+    parser.add_argument("--monitoring-interval", type=int, default=5, help="Interval of the DPL resources monitoring (s)")
+    parser.add_argument("-v", "--verbose", action="count", default=0, help="Verbose mode")
+    args = parser.parse_args()
+
+    with open(args.chains) as f:
+        chains = json.load(f)
+    # configurations given relative to the file of the chains
+    for chain in chains.values():
+        if "configuration" in chain and not os.path.isabs(chain["configuration"]):
+            chain["configuration"] = os.path.join(os.path.dirname(os.path.abspath(args.chains)), chain["configuration"])
+    report = {"input": args.input, "time": time.strftime("%Y-%m-%d %H:%M:%S"), "chains": {}}
+    for name, chain in chains.items():
+        if args.select and name not in args.select:
+            continue
+        report["chains"][name] = run_chain(name, chain, args.input, args.work_dir, args.monitoring_interval, args.verbose)
+        if report["chains"][name]["returnCode"] != 0:
+            print(f"Chain {name} failed, see {os.path.join(args.work_dir, name, 'log.txt')}")
+    with open(args.output, "w") as f:
+        json.dump(report, f, indent=2)
+    print("Report written to", args.output)
+
+    failed = any(c["returnCode"] != 0 for c in report["chains"].values())
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+        regressions = compare(report, baseline, args.tolerance)
+        for regression in regressions:
+            print("Regression:", regression)
+        failed = failed or len(regressions) > 0
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
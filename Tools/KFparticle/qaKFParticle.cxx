@@ -18,6 +18,7 @@
 #include "Tools/KFparticle/qaKFParticle.h"
 #include <CCDB/BasicCCDBManager.h>
 #include <string>
+#include <vector>
 #include <TDatabasePDG.h>
 #include <TPDGCode.h>
 #include "TableHelper.h"
@@ -325,6 +326,26 @@ struct qaKFParticle {
     histos.print();
   } /// End init
 
+  /// PID decisions and KF tracks of the tracks of the collision, built once per track instead of once per pair
+  struct TrackCache {
+    std::vector<uint8_t> pidPion;
+    std::vector<uint8_t> pidKaon;
+    std::vector<KFPTrack> kfpTracks;
+  } trackCache;
+
+  template <typename T>
+  void fillTrackCache(const T& tracks)
+  {
+    trackCache.pidPion.resize(tracks.size());
+    trackCache.pidKaon.resize(tracks.size());
+    trackCache.kfpTracks.resize(tracks.size());
+    for (const auto& track : tracks) {
+      trackCache.pidPion[track.filteredIndex()] = SelectPIDCombined(track, kPiPlus);
+      trackCache.pidKaon[track.filteredIndex()] = SelectPIDCombined(track, kKPlus);
+      trackCache.kfpTracks[track.filteredIndex()] = createKFPTrackFromTrack(track);
+    }
+  }
+
   /// Function for single track selection
   template <typename T>
   bool isSelectedTracks(const T& track1, const T& track2)
@@ -665,6 +686,7 @@ struct qaKFParticle {
     /// set KF primary vertex
     KFPVertex kfpVertex = createKFPVertexFromCollision(collision);
     KFParticle KFPV(kfpVertex);
+    fillTrackCache(tracks);
     for (auto& [track1, track2] : combinations(soa::CombinationsStrictlyUpperIndexPolicy(tracks, tracks))) {
 
       histos.fill(HIST("DZeroCandTopo/Selections"), 3.f);
@@ -697,10 +719,10 @@ struct qaKFParticle {
       float TOFnSigmaNegKa = 0;
       int source = 0;
 
-      bool pidKaonTr1 = SelectPIDCombined(track1, kKPlus);
-      bool pidKaonTr2 = SelectPIDCombined(track2, kKPlus);
-      bool pidPionTr1 = SelectPIDCombined(track1, kPiPlus);
-      bool pidPionTr2 = SelectPIDCombined(track2, kPiPlus);
+      bool pidKaonTr1 = trackCache.pidKaon[track1.filteredIndex()];
+      bool pidKaonTr2 = trackCache.pidKaon[track2.filteredIndex()];
+      bool pidPionTr1 = trackCache.pidPion[track1.filteredIndex()];
+      bool pidPionTr2 = trackCache.pidPion[track2.filteredIndex()];
 
       if (track1.isPVContributor() || track2.isPVContributor()) {
         PVContributor = 1;
@@ -715,8 +737,8 @@ struct qaKFParticle {
         if (track1.sign() == 1 && track2.sign() == -1) {
           CandD0 = true;
           source = 1;
-          kfpTrackPosPi = createKFPTrackFromTrack(track1);
-          kfpTrackNegKa = createKFPTrackFromTrack(track2);
+          kfpTrackPosPi = trackCache.kfpTracks[track1.filteredIndex()];
+          kfpTrackNegKa = trackCache.kfpTracks[track2.filteredIndex()];
           TPCnSigmaPosPi = track1.tpcNSigmaPi();
           TPCnSigmaNegKa = track2.tpcNSigmaKa();
           TOFnSigmaPosPi = track1.tofNSigmaPi();
@@ -726,8 +748,8 @@ struct qaKFParticle {
         } else if (track1.sign() == -1 && track2.sign() == 1) {
           CandD0bar = true;
           source = 2;
-          kfpTrackNegPi = createKFPTrackFromTrack(track1);
-          kfpTrackPosKa = createKFPTrackFromTrack(track2);
+          kfpTrackNegPi = trackCache.kfpTracks[track1.filteredIndex()];
+          kfpTrackPosKa = trackCache.kfpTracks[track2.filteredIndex()];
           TPCnSigmaNegPi = track1.tpcNSigmaPi();
           TPCnSigmaPosKa = track2.tpcNSigmaKa();
           TOFnSigmaNegPi = track1.tofNSigmaPi();
@@ -745,8 +767,8 @@ struct qaKFParticle {
           if (CandD0 == true) {
             source = 3;
           }
-          kfpTrackNegPi = createKFPTrackFromTrack(track2);
-          kfpTrackPosKa = createKFPTrackFromTrack(track1);
+          kfpTrackNegPi = trackCache.kfpTracks[track2.filteredIndex()];
+          kfpTrackPosKa = trackCache.kfpTracks[track1.filteredIndex()];
           TPCnSigmaNegPi = track2.tpcNSigmaPi();
           TPCnSigmaPosKa = track1.tpcNSigmaKa();
           TOFnSigmaNegPi = track2.tofNSigmaPi();
@@ -759,8 +781,8 @@ struct qaKFParticle {
           if (CandD0bar == true) {
             source = 3;
           }
-          kfpTrackPosPi = createKFPTrackFromTrack(track2);
-          kfpTrackNegKa = createKFPTrackFromTrack(track1);
+          kfpTrackPosPi = trackCache.kfpTracks[track2.filteredIndex()];
+          kfpTrackNegKa = trackCache.kfpTracks[track1.filteredIndex()];
           TPCnSigmaPosPi = track2.tpcNSigmaPi();
           TPCnSigmaNegKa = track1.tpcNSigmaKa();
           TOFnSigmaPosPi = track2.tofNSigmaPi();
@@ -886,6 +908,7 @@ struct qaKFParticle {
     KFPVertex kfpVertexDefault = createKFPVertexFromCollision(collision);
     KFParticle KFPVDefault(kfpVertexDefault);
 
+    fillTrackCache(tracks);
     for (auto& [track1, track2] : combinations(soa::CombinationsStrictlyUpperIndexPolicy(tracks, tracks))) {
 
       histos.fill(HIST("DZeroCandTopo/Selections"), 3.f);
@@ -999,10 +1022,10 @@ struct qaKFParticle {
       float TOFnSigmaPosKa = 0;
       float TOFnSigmaNegKa = 0;
 
-      bool pidKaonTr1 = SelectPIDCombined(track1, kKPlus);
-      bool pidKaonTr2 = SelectPIDCombined(track2, kKPlus);
-      bool pidPionTr1 = SelectPIDCombined(track1, kPiPlus);
-      bool pidPionTr2 = SelectPIDCombined(track2, kPiPlus);
+      bool pidKaonTr1 = trackCache.pidKaon[track1.filteredIndex()];
+      bool pidKaonTr2 = trackCache.pidKaon[track2.filteredIndex()];
+      bool pidPionTr1 = trackCache.pidPion[track1.filteredIndex()];
+      bool pidPionTr2 = trackCache.pidPion[track2.filteredIndex()];
 
       if (track1.isPVContributor() || track2.isPVContributor()) {
         PVContributor = 1;
@@ -1022,8 +1045,8 @@ struct qaKFParticle {
           if (pdgMother == -421) {
             sourceD0 |= kReflection;
           }
-          kfpTrackPosPi = createKFPTrackFromTrack(track1);
-          kfpTrackNegKa = createKFPTrackFromTrack(track2);
+          kfpTrackPosPi = trackCache.kfpTracks[track1.filteredIndex()];
+          kfpTrackNegKa = trackCache.kfpTracks[track2.filteredIndex()];
           TPCnSigmaPosPi = track1.tpcNSigmaPi();
           TPCnSigmaNegKa = track2.tpcNSigmaKa();
           TOFnSigmaPosPi = track1.tofNSigmaPi();
@@ -1035,8 +1058,8 @@ struct qaKFParticle {
           if (pdgMother == 421) {
             sourceD0Bar |= kReflection;
           }
-          kfpTrackNegPi = createKFPTrackFromTrack(track1);
-          kfpTrackPosKa = createKFPTrackFromTrack(track2);
+          kfpTrackNegPi = trackCache.kfpTracks[track1.filteredIndex()];
+          kfpTrackPosKa = trackCache.kfpTracks[track2.filteredIndex()];
           TPCnSigmaNegPi = track1.tpcNSigmaPi();
           TPCnSigmaPosKa = track2.tpcNSigmaKa();
           TOFnSigmaNegPi = track1.tofNSigmaPi();
@@ -1053,8 +1076,8 @@ struct qaKFParticle {
           if (pdgMother == 421) {
             sourceD0Bar |= kReflection;
           }
-          kfpTrackNegPi = createKFPTrackFromTrack(track2);
-          kfpTrackPosKa = createKFPTrackFromTrack(track1);
+          kfpTrackNegPi = trackCache.kfpTracks[track2.filteredIndex()];
+          kfpTrackPosKa = trackCache.kfpTracks[track1.filteredIndex()];
           TPCnSigmaNegPi = track2.tpcNSigmaPi();
           TPCnSigmaPosKa = track1.tpcNSigmaKa();
           TOFnSigmaNegPi = track2.tofNSigmaPi();
@@ -1066,8 +1089,8 @@ struct qaKFParticle {
           if (pdgMother == -421) {
             sourceD0 |= kReflection;
           }
-          kfpTrackPosPi = createKFPTrackFromTrack(track2);
-          kfpTrackNegKa = createKFPTrackFromTrack(track1);
+          kfpTrackPosPi = trackCache.kfpTracks[track2.filteredIndex()];
+          kfpTrackNegKa = trackCache.kfpTracks[track1.filteredIndex()];
           TPCnSigmaPosPi = track2.tpcNSigmaPi();
           TPCnSigmaNegKa = track1.tpcNSigmaKa();
           TOFnSigmaPosPi = track2.tofNSigmaPi();
@@ -19,7 +19,9 @@
 
 #include <onnxruntime_cxx_api.h>
 
+#include <algorithm>
 #include <map>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -149,13 +151,23 @@ class MlResponse
   /// \return model prediction for each class and the selected model
   template <typename T1, typename T2>
   std::vector<TypeOutputScore> getModelOutput(T1& input, const T2& nModel)
+  {
+    TypeOutputScore* outputPtr = getModelOutputPtr(input, nModel);
+    return std::vector<TypeOutputScore>{outputPtr, outputPtr + mNClasses};
+  }
+
+  /// Get pointer to model predictions, without copy
+  /// \param input a vector containing the values of features used in the model
+  /// \param nModel is the model index
+  /// \return pointer to the mNClasses predictions of the selected model
+  /// \note The predictions are owned by the model and stay valid until its next evaluation
+  template <typename T1, typename T2>
+  TypeOutputScore* getModelOutputPtr(T1& input, const T2& nModel)
   {
     if (nModel < 0 || static_cast<std::size_t>(nModel) >= mModels.size()) {
       LOG(fatal) << "Model index " << nModel << " is out of range! The number of initialised models is " << mModels.size() << ". Please check your configurables.";
     }
-
-    TypeOutputScore* outputPtr = mModels[nModel].template evalModel<TypeOutputScore>(input);
-    return std::vector<TypeOutputScore>{outputPtr, outputPtr + mNClasses};
+    return mModels[nModel].template evalModel<TypeOutputScore>(input);
   }
 
   /// ML selections
@@ -166,21 +178,7 @@ class MlResponse
   bool isSelectedMl(T1& input, const T2& candVar)
   {
     int nModel = findBin(candVar);
-    auto output = getModelOutput(input, nModel);
-    uint8_t iClass{0};
-    for (const auto& outputValue : output) {
-      uint8_t dir = mCutDir.at(iClass);
-      if (dir != o2::cuts_ml::CutDirection::CutNot) {
-        if (dir == o2::cuts_ml::CutDirection::CutGreater && outputValue > mCuts.get(nModel, iClass)) {
-          return false;
-        }
-        if (dir == o2::cuts_ml::CutDirection::CutSmaller && outputValue < mCuts.get(nModel, iClass)) {
-          return false;
-        }
-      }
-      ++iClass;
-    }
-    return true;
+    return passesCuts(getModelOutputPtr(input, nModel), nModel);
   }
 
   /// ML selections
@@ -192,21 +190,60 @@ class MlResponse
   bool isSelectedMl(T1& input, const T2& candVar, std::vector<TypeOutputScore>& output)
   {
     int nModel = findBin(candVar);
-    output = getModelOutput(input, nModel);
-    uint8_t iClass{0};
-    for (const auto& outputValue : output) {
-      uint8_t dir = mCutDir.at(iClass);
-      if (dir != o2::cuts_ml::CutDirection::CutNot) {
-        if (dir == o2::cuts_ml::CutDirection::CutGreater && outputValue > mCuts.get(nModel, iClass)) {
-          return false;
-        }
-        if (dir == o2::cuts_ml::CutDirection::CutSmaller && outputValue < mCuts.get(nModel, iClass)) {
-          return false;
+    const TypeOutputScore* outputPtr = getModelOutputPtr(input, nModel);
+    output.assign(outputPtr, outputPtr + mNClasses);
+    return passesCuts(outputPtr, nModel);
+  }
+
+  /// ML selections for a batch of candidates, with one model inference per pT bin
+  /// \param inputs is a vector with the input features of each candidate
+  /// \param candVars is a vector with the variable value (e.g. pT) of each candidate, used to select which model to use
+  /// \param isSelected is filled with the selection decision of each candidate
+  /// \param maxBatchSize is the maximum number of candidates evaluated in a single model call (0 = no limit)
+  /// \return span with the model predictions, mNClasses consecutive scores per candidate in the order of inputs
+  /// \note The returned span stays valid until the next call of isSelectedMlBatch
+  template <typename T1, typename T2>
+  std::span<const TypeOutputScore> isSelectedMlBatch(std::vector<T1>& inputs, const std::vector<T2>& candVars, std::vector<bool>& isSelected, std::size_t maxBatchSize = 0)
+  {
+    if (inputs.size() != candVars.size()) {
+      LOG(fatal) << "Number of candidates (" << inputs.size() << ") different from the number of candidate variables (" << candVars.size() << ")!";
+    }
+    const std::size_t nCands = inputs.size();
+    isSelected.assign(nCands, false);
+    mBatchScores.assign(nCands * mNClasses, TypeOutputScore{0});
+
+    std::vector<int> binCands(nCands);
+    for (std::size_t iCand{0}; iCand < nCands; ++iCand) {
+      binCands[iCand] = findBin(candVars[iCand]);
+      if (binCands[iCand] < 0 || static_cast<std::size_t>(binCands[iCand]) >= mModels.size()) {
+        LOG(fatal) << "Model index " << binCands[iCand] << " is out of range! The number of initialised models is " << mModels.size() << ". Please check your configurables.";
+      }
+    }
+
+    std::vector<std::size_t> idxCandsModel;
+    for (int iModel{0}; iModel < static_cast<int>(mModels.size()); ++iModel) {
+      idxCandsModel.clear();
+      mBatchInput.clear();
+      for (std::size_t iCand{0}; iCand < nCands; ++iCand) {
+        if (binCands[iCand] == iModel) {
+          idxCandsModel.push_back(iCand);
+          mBatchInput.insert(mBatchInput.end(), inputs[iCand].begin(), inputs[iCand].end());
         }
       }
-      ++iClass;
+      if (idxCandsModel.empty()) {
+        continue;
+      }
+      std::size_t nScoresPerCand = mModels[iModel].template evalModelBatch<TypeOutputScore>(mBatchInput, mBatchOutput, maxBatchSize);
+      if (nScoresPerCand < mNClasses) {
+        LOG(fatal) << "Model " << iModel << " returns " << nScoresPerCand << " scores per candidate, while " << static_cast<int>(mNClasses) << " classes are expected! Please check your configurables.";
+      }
+      for (std::size_t iRow{0}; iRow < idxCandsModel.size(); ++iRow) {
+        const auto iCand = idxCandsModel[iRow];
+        std::copy_n(mBatchOutput.begin() + iRow * nScoresPerCand, mNClasses, mBatchScores.begin() + iCand * mNClasses);
+        isSelected[iCand] = passesCuts(mBatchScores.data() + iCand * mNClasses, iModel);
+      }
     }
-    return true;
+    return std::span<const TypeOutputScore>(mBatchScores);
   }
 
  protected:
@@ -223,6 +260,28 @@ class MlResponse
   virtual void setAvailableInputFeatures() { return; } // method to fill the map of available input features
 
  private:
+  std::vector<TypeOutputScore> mBatchInput;  // contiguous feature matrix of the candidates of a batch sharing the same model
+  std::vector<TypeOutputScore> mBatchOutput; // raw model output of a batch
+  std::vector<TypeOutputScore> mBatchScores; // model predictions of all candidates of a batch, in input order
+
+  /// Applies the cuts of a given model to its predictions
+  /// \param scores pointer to the mNClasses scores of a candidate
+  /// \param nModel is the model index
+  /// \return boolean telling if model predictions pass the cuts
+  bool passesCuts(const TypeOutputScore* scores, int nModel)
+  {
+    for (uint8_t iClass{0}; iClass < mNClasses; ++iClass) {
+      uint8_t dir = mCutDir.at(iClass);
+      if (dir == o2::cuts_ml::CutDirection::CutGreater && scores[iClass] > mCuts.get(nModel, iClass)) {
+        return false;
+      }
+      if (dir == o2::cuts_ml::CutDirection::CutSmaller && scores[iClass] < mCuts.get(nModel, iClass)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
   /// Finds matching bin in mBinsLimits
   /// \param value e.g. pT
   /// \return index of the matching bin, used to access mModels
@@ -0,0 +1,130 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file     SessionRegistry.cxx
+///
+/// \brief    Process-wide registry of ONNX runtime sessions, shared by all o2::ml::OnnxModel instances
+///
+
+#include "Tools/ML/SessionRegistry.h"
+
+#include "Common/Core/ThreadBudget.h"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "Framework/Logger.h"
+
+namespace o2
+{
+
+namespace ml
+{
+
+SessionRegistry& SessionRegistry::instance()
+{
+  static SessionRegistry registry;
+  return registry;
+}
+
+void SessionRegistry::configure(int globalThreads, std::string const& cacheDir)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  if (mEnv) {
+    LOG(warning) << "ONNX session registry already in use, the thread-pool configuration will not change";
+  } else {
+    mGlobalThreads = globalThreads;
+  }
+  mCacheDir = cacheDir;
+  if (!mCacheDir.empty()) {
+    std::filesystem::create_directories(mCacheDir);
+  }
+}
+
+std::shared_ptr<Ort::Env> SessionRegistry::getEnv()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  if (!mEnv) {
+    if (mGlobalThreads > 0) {
+      mGlobalThreads = o2::common::core::ThreadBudget::instance().request("ONNX global thread pool", mGlobalThreads);
+      Ort::ThreadingOptions threadingOptions;
+      threadingOptions.SetGlobalIntraOpNumThreads(mGlobalThreads);
+      threadingOptions.SetGlobalInterOpNumThreads(1);
+      mEnv = std::make_shared<Ort::Env>(threadingOptions, ORT_LOGGING_LEVEL_WARNING, "onnx-model");
+      LOG(info) << "ONNX runtime environment created with a global thread pool of " << mGlobalThreads << " threads";
+    } else {
+      mEnv = std::make_shared<Ort::Env>(ORT_LOGGING_LEVEL_WARNING, "onnx-model");
+    }
+  }
+  return mEnv;
+}
+
+uint64_t SessionRegistry::hashFile(std::string const& path)
+{
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open()) {
+    LOG(fatal) << "Cannot open ONNX model file " << path;
+  }
+  uint64_t hash = 14695981039346656037ULL;
+  char buffer[1 << 16];
+  while (file) {
+    file.read(buffer, sizeof(buffer));
+    const std::streamsize nRead = file.gcount();
+    for (std::streamsize i = 0; i < nRead; ++i) {
+      hash ^= static_cast<unsigned char>(buffer[i]);
+      hash *= 1099511628211ULL;
+    }
+  }
+  return hash;
+}
+
+std::shared_ptr<Ort::Session> SessionRegistry::getSession(std::string const& modelPath, Ort::SessionOptions& sessionOptions, bool enableOptimizations, int threads, uint64_t validFrom, uint64_t validUntil)
+{
+  const uint64_t hash = hashFile(modelPath);
+  auto env = getEnv();
+
+  std::lock_guard<std::mutex> lock(mMutex);
+  const Key key{hash, validFrom, validUntil, enableOptimizations, threads};
+  if (auto session = mSessions[key].lock()) {
+    LOGP(info, "Reusing ONNX session for {} (hash {:016x})", modelPath, hash);
+    return session;
+  }
+
+  Ort::SessionOptions options = sessionOptions.Clone();
+  if (mGlobalThreads > 0) {
+    options.DisablePerSessionThreads();
+  } else if (o2::common::core::ThreadBudget::instance().getBudget() > 0) {
+    options.SetIntraOpNumThreads(o2::common::core::ThreadBudget::instance().request("ONNX session " + modelPath, threads));
+  }
+
+  std::string pathToLoad = modelPath;
+  if (!mCacheDir.empty()) {
+    const std::string cachedPath = fmt::format("{}/{:016x}_{}.onnx", mCacheDir, hash, enableOptimizations ? "opt" : "basic");
+    if (std::filesystem::exists(cachedPath)) {
+      LOGP(info, "Loading optimised ONNX graph from local cache {}", cachedPath);
+      pathToLoad = cachedPath;
+      options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_DISABLE_ALL);
+    } else {
+      LOGP(info, "Optimised ONNX graph will be stored in local cache {}", cachedPath);
+      options.SetOptimizedModelFilePath(cachedPath.c_str());
+    }
+  }
+
+  auto session = std::make_shared<Ort::Session>(*env, pathToLoad.c_str(), options);
+  mSessions[key] = session;
+  return session;
+}
+
+} // namespace ml
+
+} // namespace o2
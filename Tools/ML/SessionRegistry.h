@@ -0,0 +1,87 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file     SessionRegistry.h
+///
+/// \brief    Process-wide registry of ONNX runtime sessions, shared by all o2::ml::OnnxModel instances
+///
+/// Sessions are deduplicated by the content hash of the model file, the validity range of the model
+/// and the session settings, so that models loaded several times in the same process (e.g. the same
+/// CCDB object fetched by different tasks or pT bins) are parsed and optimised only once.
+/// All sessions share the same Ort::Env and, if enabled, the same global thread pool.
+/// The threads of the global thread pool, or else of each new session, are taken from the
+/// process-wide o2::common::core::ThreadBudget, if one is set.
+/// Optionally, the optimised graph is serialised to a local directory and reused at the next start.
+///
+
+#ifndef TOOLS_ML_SESSIONREGISTRY_H_
+#define TOOLS_ML_SESSIONREGISTRY_H_
+
+#include <onnxruntime_cxx_api.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+namespace o2
+{
+
+namespace ml
+{
+
+class SessionRegistry
+{
+ public:
+  /// Access to the process-wide instance
+  static SessionRegistry& instance();
+
+  /// Configure the registry; must be called before the first session is created to take effect
+  /// \param globalThreads number of threads of the process-wide intra-op thread pool (0 = one thread pool per session)
+  /// \param cacheDir local directory where optimised graphs are stored (empty = no disk cache)
+  void configure(int globalThreads, std::string const& cacheDir = "");
+
+  /// Get a session for a model file, creating it only if no equivalent session is alive
+  /// \param modelPath path to the .onnx file
+  /// \param sessionOptions options used if the session has to be created
+  /// \param enableOptimizations whether graph optimisations are enabled, part of the cache key
+  /// \param threads number of intra-op threads, part of the cache key
+  /// \param validFrom start of the model validity, part of the cache key
+  /// \param validUntil end of the model validity, part of the cache key
+  std::shared_ptr<Ort::Session> getSession(std::string const& modelPath, Ort::SessionOptions& sessionOptions, bool enableOptimizations, int threads, uint64_t validFrom, uint64_t validUntil);
+
+  /// Shared environment of the ONNX runtime
+  std::shared_ptr<Ort::Env> getEnv();
+
+  /// Content hash (64-bit FNV-1a) of a file
+  static uint64_t hashFile(std::string const& path);
+
+ private:
+  SessionRegistry() = default;
+
+  // content hash, validity from, validity until, optimisations, threads
+  using Key = std::tuple<uint64_t, uint64_t, uint64_t, bool, int>;
+
+  std::mutex mMutex;
+  std::shared_ptr<Ort::Env> mEnv = nullptr;
+  std::map<Key, std::weak_ptr<Ort::Session>> mSessions;
+  int mGlobalThreads = 0;
+  std::string mCacheDir = "";
+};
+
+} // namespace ml
+
+} // namespace o2
+
+#endif // TOOLS_ML_SESSIONREGISTRY_H_
@@ -19,6 +19,8 @@
 
 // ONNX includes
 #include "Tools/ML/model.h"
+#include "Tools/ML/SessionRegistry.h"
+#include "Common/Core/ThreadBudget.h"
 
 namespace o2
 {
@@ -74,8 +76,17 @@ void OnnxModel::initModel(std::string localPath, bool enableOptimizations, int t
     sessionOptions.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_EXTENDED);
   }
 
-  mEnv = std::make_shared<Ort::Env>(ORT_LOGGING_LEVEL_WARNING, "onnx-model");
-  mSession = std::make_shared<Ort::Session>(*mEnv, modelPath.c_str(), sessionOptions);
+  /// Sessions are shared within the process through the registry, unless explicitly disabled
+  mEnv = SessionRegistry::instance().getEnv();
+  if (mUseSessionRegistry) {
+    mSession = SessionRegistry::instance().getSession(modelPath, sessionOptions, enableOptimizations, activeThreads, from, until);
+  } else {
+    if (o2::common::core::ThreadBudget::instance().getBudget() > 0) {
+      activeThreads = o2::common::core::ThreadBudget::instance().request("ONNX session " + modelPath, activeThreads);
+      sessionOptions.SetIntraOpNumThreads(activeThreads);
+    }
+    mSession = std::make_shared<Ort::Session>(*mEnv, modelPath.c_str(), sessionOptions);
+  }
 
   Ort::AllocatorWithDefaultOptions tmpAllocator;
   for (size_t i = 0; i < mSession->GetInputCount(); ++i) {
@@ -89,7 +100,12 @@ void OnnxModel::initModel(std::string localPath, bool enableOptimizations, int t
   }
   for (size_t i = 0; i < mSession->GetOutputCount(); ++i) {
     mOutputShapes.emplace_back(mSession->GetOutputTypeInfo(i).GetTensorTypeAndShapeInfo().GetShape());
+    mOutputTypes.emplace_back(mSession->GetOutputTypeInfo(i).GetTensorTypeAndShapeInfo().GetElementType());
   }
+
+  mMemoryInfo = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
+  mRunOptions = Ort::RunOptions();
+  initBinding();
   LOG(info) << "Input Nodes:";
   for (size_t i = 0; i < mInputNames.size(); i++) {
     LOG(info) << "\t" << mInputNames[i] << " : " << printShape(mInputShapes[i]);
@@ -108,6 +124,63 @@ void OnnxModel::initModel(std::string localPath, bool enableOptimizations, int t
   LOG(info) << "--- Model initialized! ---";
 }
 
+void OnnxModel::initBinding()
+{
+  /// Node names are bound once, the IO binding is tied to the current session
+  Ort::AllocatorWithDefaultOptions tmpAllocator;
+  mNamesAllocated.clear();
+  mInputNamesChar.clear();
+  mOutputNamesChar.clear();
+  for (size_t i = 0; i < mSession->GetInputCount(); ++i) {
+    mNamesAllocated.emplace_back(mSession->GetInputNameAllocated(i, tmpAllocator));
+    mInputNamesChar.push_back(mNamesAllocated.back().get());
+  }
+  for (size_t i = 0; i < mSession->GetOutputCount(); ++i) {
+    mNamesAllocated.emplace_back(mSession->GetOutputNameAllocated(i, tmpAllocator));
+    mOutputNamesChar.push_back(mNamesAllocated.back().get());
+  }
+
+  mIoBinding = std::make_unique<Ort::IoBinding>(*mSession);
+  mOutputTensors.clear();
+  mBoundBatchSize = 0;
+
+  /// Output tensors can be preallocated only if their shape is fixed up to the batch dimension
+  mDynamicOutputShapes = false;
+  for (const auto& shape : mOutputShapes) {
+    for (size_t idim = 1; idim < shape.size(); idim++) {
+      if (shape[idim] < 0) {
+        mDynamicOutputShapes = true;
+      }
+    }
+  }
+  if (mDynamicOutputShapes) {
+    LOG(info) << "Output shapes not fixed by the batch size, output tensors allocated at each inference";
+    for (const auto& name : mOutputNamesChar) {
+      mIoBinding->BindOutput(name, mMemoryInfo);
+    }
+  }
+}
+
+void OnnxModel::bindOutputs(int64_t batchSize)
+{
+  /// (Re)allocate the output tensors only when the batch size changes
+  if (mDynamicOutputShapes || batchSize == mBoundBatchSize) {
+    return;
+  }
+  mIoBinding->ClearBoundOutputs();
+  mOutputTensors.clear();
+  Ort::AllocatorWithDefaultOptions allocator;
+  for (size_t i = 0; i < mOutputShapes.size(); ++i) {
+    std::vector<int64_t> shape = mOutputShapes[i];
+    if (!shape.empty() && shape[0] < 0) {
+      shape[0] = batchSize;
+    }
+    mOutputTensors.emplace_back(Ort::Value::CreateTensor(allocator, shape.data(), shape.size(), mOutputTypes[i]));
+    mIoBinding->BindOutput(mOutputNamesChar[i], mOutputTensors.back());
+  }
+  mBoundBatchSize = batchSize;
+}
+
 void OnnxModel::setActiveThreads(int threads)
 {
   activeThreads = threads;
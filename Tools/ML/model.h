@@ -22,6 +22,7 @@
 
 // C++ and system includes
 #include <onnxruntime_cxx_api.h>
+#include <array>
 #include <vector>
 #include <string>
 #include <memory>
@@ -51,6 +52,8 @@ class OnnxModel
   void initModel(std::string, bool = false, int = 0, uint64_t = 0, uint64_t = 0);
 
   // template methods -- best to define them in header
+  /// \return pointer to the values of the last output tensor
+  /// \note The output tensors are owned by the model: the pointer stays valid until the next evaluation or session reset
   template <typename T>
   T* evalModel(std::vector<Ort::Value>& input)
   {
@@ -58,26 +61,8 @@ class OnnxModel
     // assert(input[0].GetTensorTypeAndShapeInfo().GetShape() == getNumInputNodes()); --> Fails build in debug mode, TODO: assertion should be checked somehow
 
     try {
-      Ort::RunOptions runOptions;
-      std::vector<const char*> inputNamesChar(mInputNames.size(), nullptr);
-      std::transform(std::begin(mInputNames), std::end(mInputNames), std::begin(inputNamesChar),
-                     [&](const std::string& str) { return str.c_str(); });
-
-      std::vector<const char*> outputNamesChar(mOutputNames.size(), nullptr);
-      std::transform(std::begin(mOutputNames), std::end(mOutputNames), std::begin(outputNamesChar),
-                     [&](const std::string& str) { return str.c_str(); });
-      auto outputTensors = mSession->Run(runOptions, inputNamesChar.data(), input.data(), input.size(), outputNamesChar.data(), outputNamesChar.size());
-      LOG(debug) << "Number of output tensors: " << outputTensors.size();
-      if (outputTensors.size() != mOutputNames.size()) {
-        LOG(fatal) << "Number of output tensors: " << outputTensors.size() << " does not agree with the model specified size: " << mOutputNames.size();
-      }
-      for (std::size_t i = 0; i < outputTensors.size(); i++) {
-        LOG(debug) << "Output tensor shape: " << printShape(outputTensors[i].GetTensorTypeAndShapeInfo().GetShape());
-        if ((outputTensors[i].GetTensorTypeAndShapeInfo().GetShape() != mOutputShapes[i]) && (mOutputShapes[i][0] != -1)) {
-          LOG(fatal) << "Shape of tensor " << i << " does not agree with model specification! Output: " << printShape(outputTensors[i].GetTensorTypeAndShapeInfo().GetShape()) << " model: " << printShape(mOutputShapes[i]);
-        }
-      }
-      T* outputValues = outputTensors.back().GetTensorMutableData<T>();
+      runSession(input);
+      T* outputValues = mOutputTensors.back().GetTensorMutableData<T>();
       return outputValues;
     } catch (const Ort::Exception& exception) {
       LOG(error) << "Error running model inference: " << exception.what();
@@ -90,22 +75,17 @@ class OnnxModel
   {
     int64_t size = input.size();
     assert(size % mInputShapes[0][1] == 0);
-    std::vector<int64_t> inputShape{size / mInputShapes[0][1], mInputShapes[0][1]};
-    std::vector<Ort::Value> inputTensors;
-    Ort::MemoryInfo memInfo =
-      Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
-    inputTensors.emplace_back(Ort::Value::CreateTensor<T>(memInfo, input.data(), size, inputShape.data(), inputShape.size()));
-    LOG(debug) << "Input shape calculated from vector: " << printShape(inputShape);
-    return evalModel<T>(inputTensors);
+    std::array<int64_t, 2> inputShape{size / mInputShapes[0][1], mInputShapes[0][1]};
+    mInputTensors.clear();
+    mInputTensors.emplace_back(Ort::Value::CreateTensor<T>(mMemoryInfo, input.data(), size, inputShape.data(), inputShape.size()));
+    return evalModel<T>(mInputTensors);
   }
 
   // For 2D inputs
   template <typename T>
   T* evalModel(std::vector<std::vector<T>>& input)
   {
-    std::vector<Ort::Value> inputTensors;
-
-    Ort::MemoryInfo memInfo = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
+    mInputTensors.clear();
 
     for (size_t iinput = 0; iinput < input.size(); iinput++) {
       [[maybe_unused]] int totalSize = 1;
@@ -120,16 +100,63 @@ class OnnxModel
         inputShape.push_back(mInputShapes[iinput][idim]);
       }
 
-      inputTensors.emplace_back(Ort::Value::CreateTensor<T>(memInfo, input[iinput].data(), size, inputShape.data(), inputShape.size()));
+      mInputTensors.emplace_back(Ort::Value::CreateTensor<T>(mMemoryInfo, input[iinput].data(), size, inputShape.data(), inputShape.size()));
     }
 
-    return evalModel<T>(inputTensors);
+    return evalModel<T>(mInputTensors);
+  }
+
+  /// Batched inference on a row-major feature matrix (one row per candidate)
+  /// \param input contiguous matrix of nRows x getNumInputNodes() features
+  /// \param output is filled with the scores of the selected output tensor, one row per candidate
+  /// \param maxBatchSize maximum number of rows passed to a single Ort::Session::Run call (0 = no limit)
+  /// \param outputIndex index of the output tensor read (-1 = last one)
+  /// \return number of scores per candidate
+  /// \note Models exported with a fixed batch dimension are evaluated in chunks of that size
+  template <typename T>
+  std::size_t evalModelBatch(std::vector<T>& input, std::vector<T>& output, std::size_t maxBatchSize = 0, int outputIndex = -1)
+  {
+    output.clear();
+    const int64_t nFeatures = mInputShapes[0][1];
+    const std::size_t nRows = input.size() / nFeatures;
+    assert(input.size() % nFeatures == 0);
+    if (nRows == 0) {
+      return 0;
+    }
+
+    std::size_t chunkSize = nRows;
+    if (mInputShapes[0][0] > 0) {
+      chunkSize = static_cast<std::size_t>(mInputShapes[0][0]);
+    }
+    if (maxBatchSize > 0 && maxBatchSize < chunkSize) {
+      chunkSize = maxBatchSize;
+    }
+
+    std::size_t nScoresPerRow{0};
+    for (std::size_t firstRow = 0; firstRow < nRows; firstRow += chunkSize) {
+      const std::size_t nRowsChunk = std::min(chunkSize, nRows - firstRow);
+      std::array<int64_t, 2> inputShape{static_cast<int64_t>(nRowsChunk), nFeatures};
+      mInputTensors.clear();
+      mInputTensors.emplace_back(Ort::Value::CreateTensor<T>(mMemoryInfo, input.data() + firstRow * nFeatures, nRowsChunk * nFeatures, inputShape.data(), inputShape.size()));
+      try {
+        runSession(mInputTensors);
+        const auto& outputTensor = outputIndex < 0 ? mOutputTensors.back() : mOutputTensors[outputIndex];
+        const std::size_t nScores = outputTensor.GetTensorTypeAndShapeInfo().GetElementCount();
+        nScoresPerRow = nScores / nRowsChunk;
+        const T* outputValues = outputTensor.GetTensorData<T>();
+        output.insert(output.end(), outputValues, outputValues + nScores);
+      } catch (const Ort::Exception& exception) {
+        LOG(fatal) << "Error running batched model inference: " << exception.what();
+      }
+    }
+    return nScoresPerRow;
   }
 
   // Reset session
   void resetSession()
   {
     mSession.reset(new Ort::Session{*mEnv, modelPath.c_str(), sessionOptions});
+    initBinding();
   }
 
   // Getters & Setters
@@ -144,6 +171,7 @@ class OnnxModel
   uint64_t getValidityFrom() const { return validFrom; }
   uint64_t getValidityUntil() const { return validUntil; }
   void setActiveThreads(int);
+  void setUseSessionRegistry(bool use) { mUseSessionRegistry = use; } // To be called before initModel
 
  private:
   // Environment variables for the ONNX runtime
@@ -156,13 +184,54 @@ class OnnxModel
   std::vector<std::vector<int64_t>> mInputShapes;
   std::vector<std::string> mOutputNames;
   std::vector<std::vector<int64_t>> mOutputShapes;
+  std::vector<ONNXTensorElementDataType> mOutputTypes;
+
+  // Inference context, bound once at initModel and reused for all evaluations
+  std::vector<Ort::AllocatedStringPtr> mNamesAllocated; // heap-owned node names, stable when the model is moved
+  std::vector<const char*> mInputNamesChar;
+  std::vector<const char*> mOutputNamesChar;
+  Ort::MemoryInfo mMemoryInfo{nullptr};
+  Ort::RunOptions mRunOptions{nullptr};
+  std::unique_ptr<Ort::IoBinding> mIoBinding = nullptr;
+  std::vector<Ort::Value> mInputTensors;  // input tensors wrapping the caller buffers
+  std::vector<Ort::Value> mOutputTensors; // preallocated output tensors owned by the model
+  int64_t mBoundBatchSize = 0;            // batch size of the preallocated output tensors (0 = none bound)
+  bool mDynamicOutputShapes = false;      // output shapes not determined by the batch size, allocated by ONNX runtime at each run
 
   // Environment settings
   std::string modelPath;
   int activeThreads = 0;
+  bool mUseSessionRegistry = true; // share identical sessions within the process
   uint64_t validFrom = 0;
   uint64_t validUntil = 0;
 
+  // Runs the session on the given input tensors, writing into mOutputTensors, and checks the output against the model specification
+  void runSession(std::vector<Ort::Value>& input)
+  {
+    mIoBinding->ClearBoundInputs();
+    for (std::size_t i = 0; i < input.size(); i++) {
+      mIoBinding->BindInput(mInputNamesChar[i], input[i]);
+    }
+    bindOutputs(input[0].GetTensorTypeAndShapeInfo().GetShape()[0]);
+    mSession->Run(mRunOptions, *mIoBinding);
+    if (mDynamicOutputShapes) {
+      mOutputTensors = mIoBinding->GetOutputValues();
+    }
+    LOG(debug) << "Number of output tensors: " << mOutputTensors.size();
+    if (mOutputTensors.size() != mOutputNames.size()) {
+      LOG(fatal) << "Number of output tensors: " << mOutputTensors.size() << " does not agree with the model specified size: " << mOutputNames.size();
+    }
+    for (std::size_t i = 0; i < mOutputTensors.size(); i++) {
+      LOG(debug) << "Output tensor shape: " << printShape(mOutputTensors[i].GetTensorTypeAndShapeInfo().GetShape());
+      if ((mOutputTensors[i].GetTensorTypeAndShapeInfo().GetShape() != mOutputShapes[i]) && (mOutputShapes[i][0] != -1)) {
+        LOG(fatal) << "Shape of tensor " << i << " does not agree with model specification! Output: " << printShape(mOutputTensors[i].GetTensorTypeAndShapeInfo().GetShape()) << " model: " << printShape(mOutputShapes[i]);
+      }
+    }
+  }
+
+  void initBinding();
+  void bindOutputs(int64_t);
+
   // Internal function for printing the shape of tensors
   std::string printShape(const std::vector<int64_t>&);
   bool checkHyperloop(bool = true);
@@ -80,6 +80,7 @@ struct PidMlBatchEffAndPurProducer {
   Configurable<std::string> localPath{"localPath", "/home/mkabus/PIDML/", "Base path to the local directory with ONNX models"};
   Configurable<bool> useFixedTimestamp{"useFixedTimestamp", false, "Whether to use fixed timestamp from configurable instead of timestamp calculated from the data"};
   Configurable<uint64_t> fixedTimestamp{"fixedTimestamp", 1524176895000, "Hardcoded timestamp for tests"};
+  Configurable<int> batchSize{"batchSize", 1024, "Maximum number of tracks per model inference"};
 
   Filter trackFilter = requireGlobalTrackInFilter();
 
@@ -223,20 +224,29 @@ struct PidMlBatchEffAndPurProducer {
       }
     }
 
+    std::vector<BigTracks::iterator> primaryTracks;
     for (const auto& track : tracks) {
-      if (track.has_mcParticle()) {
-        auto mcPart = track.mcParticle();
-        if (mcPart.isPhysicalPrimary()) {
-          fillTrackedHist(mcPart.pdgCode(), track.pt());
-
-          for (size_t i = 0; i < pdgPids.value.size(); ++i) {
-            float mlCertainty = models[i].applyModel(track);
-            nSigma_t nSigma = getNSigma(track, pdgPids.value[i]);
-            bool isMCPid = mcPart.pdgCode() == pdgPids.value[i];
-
-            effAndPurPIDResult(track.index(), pdgPids.value[i], track.pt(), mlCertainty, nSigma.composed, isMCPid, track.hasTOF(), track.hasTRD());
-          }
-        }
+      if (track.has_mcParticle() && track.mcParticle().isPhysicalPrimary()) {
+        primaryTracks.push_back(track);
+      }
+    }
+
+    // one model inference per batch of tracks for each PID
+    std::vector<std::vector<float>> mlCertainties(pdgPids.value.size());
+    for (size_t i = 0; i < pdgPids.value.size(); ++i) {
+      mlCertainties[i] = models[i].applyModelBatch(primaryTracks, batchSize);
+    }
+
+    for (size_t iTrack = 0; iTrack < primaryTracks.size(); ++iTrack) {
+      const auto& track = primaryTracks[iTrack];
+      auto mcPart = track.mcParticle();
+      fillTrackedHist(mcPart.pdgCode(), track.pt());
+
+      for (size_t i = 0; i < pdgPids.value.size(); ++i) {
+        nSigma_t nSigma = getNSigma(track, pdgPids.value[i]);
+        bool isMCPid = mcPart.pdgCode() == pdgPids.value[i];
+
+        effAndPurPIDResult(track.index(), pdgPids.value[i], track.pt(), mlCertainties[i][iTrack], nSigma.composed, isMCPid, track.hasTOF(), track.hasTRD());
       }
     }
   }
@@ -105,6 +105,7 @@ struct PidONNXModel {
     for (size_t i = 0; i < mSession->GetOutputCount(); ++i) {
       mOutputShapes.emplace_back(mSession->GetOutputTypeInfo(i).GetTensorTypeAndShapeInfo().GetShape());
     }
+    setNamesChar();
 
     LOG(debug) << "Input Node Name/Shape (" << mInputNames.size() << "):";
     for (size_t i = 0; i < mInputNames.size(); i++) {
@@ -136,6 +137,49 @@ struct PidONNXModel {
     return getModelOutput(track) >= mMinCertainty;
   }
 
+  /// Certainties of a set of tracks, in the same order, with one model inference per chunk of maxBatchSize tracks.
+  /// The tracks are grouped by the detectors used, so that the rows of a batch have the same missing (NaN) features.
+  std::vector<float> applyModelBatch(const std::vector<typename T::iterator>& tracks, std::size_t maxBatchSize = 1024)
+  {
+    std::vector<float> certainties(tracks.size(), 0.f);
+    if (tracks.empty() || maxBatchSize == 0) {
+      return certainties;
+    }
+
+    std::array<std::vector<std::size_t>, kNDetectorsUsed> groups;
+    for (std::size_t iTrack = 0; iTrack < tracks.size(); ++iTrack) {
+      groups[getDetectorsUsed(tracks[iTrack])].push_back(iTrack);
+    }
+
+    const std::size_t nColumns = mTrainColumns.size();
+    std::vector<float> inputValues;
+    std::vector<float> outputValues;
+    for (int detectorsUsed = 0; detectorsUsed < kNDetectorsUsed; ++detectorsUsed) {
+      const auto& group = groups[detectorsUsed];
+      for (std::size_t first = 0; first < group.size(); first += maxBatchSize) {
+        const std::size_t nRows = std::min(maxBatchSize, group.size() - first);
+        inputValues.resize(nRows * nColumns);
+        for (std::size_t iRow = 0; iRow < nRows; ++iRow) {
+          fillValues(tracks[group[first + iRow]], detectorsUsed, &inputValues[iRow * nColumns]);
+        }
+        runModel(inputValues, nRows, outputValues);
+        for (std::size_t iRow = 0; iRow < nRows; ++iRow) {
+          certainties[group[first + iRow]] = outputValues[iRow];
+        }
+      }
+    }
+    return certainties;
+  }
+
+  /// Acceptance of a set of tracks based on the minimum certainty, see applyModelBatch
+  std::vector<bool> applyModelBooleanBatch(const std::vector<typename T::iterator>& tracks, std::size_t maxBatchSize = 1024)
+  {
+    std::vector<float> certainties = applyModelBatch(tracks, maxBatchSize);
+    std::vector<bool> accepted(certainties.size());
+    std::transform(certainties.begin(), certainties.end(), accepted.begin(), [&](float certainty) { return certainty >= mMinCertainty; });
+    return accepted;
+  }
+
   int mPid;
   double mMinCertainty;
 
@@ -202,6 +246,7 @@ struct PidONNXModel {
         mScalingParams[param[0].GetString()] = std::make_pair(param[1].GetFloat(), param[2].GetFloat());
       }
     }
+    setColumnInfos();
   }
 
   static float scale(float value, const std::pair<float, float>& scalingParams)
@@ -209,58 +254,70 @@ struct PidONNXModel {
     return (value - scalingParams.first) / scalingParams.second;
   }
 
-  std::vector<float> getValues(const typename T::iterator& track)
-  {
-    std::vector<float> output;
-    output.reserve(mTrainColumns.size());
+  // Bits of the detectors used for a track, beyond TPC
+  static constexpr int kUseTOF = 1;
+  static constexpr int kUseTRD = 2;
+  static constexpr int kNDetectorsUsed = 4;
 
+  int getDetectorsUsed(const typename T::iterator& track) const
+  {
     bool useTOF = !pidml::pidutils::tofMissing(track) && pidml::pidutils::inPLimit(track, mPLimits[kTPCTOF]);
     bool useTRD = !pidml::pidutils::trdMissing(track) && pidml::pidutils::inPLimit(track, mPLimits[kTPCTOFTRD]);
+    return (useTOF ? kUseTOF : 0) | (useTRD ? kUseTRD : 0);
+  }
 
-    for (uint32_t i = 0; i < mTrainColumns.size(); ++i) {
-      auto& columnLabel = mTrainColumns[i];
-
-      if (
-        ((columnLabel == "fTRDSignal" || columnLabel == "fTRDPattern") && !useTRD) ||
-        ((columnLabel == "fTOFSignal" || columnLabel == "fBeta") && !useTOF)) {
-        output.push_back(std::numeric_limits<float>::quiet_NaN());
-        continue;
+  // Per-column scaling and detector, resolved once from the labels when the configuration files are read
+  void setColumnInfos()
+  {
+    mColumnInfos.clear();
+    mColumnInfos.reserve(mTrainColumns.size());
+    for (const auto& columnLabel : mTrainColumns) {
+      ColumnInfo info;
+      if (columnLabel == "fTRDSignal" || columnLabel == "fTRDPattern") {
+        info.requiredDetector = kUseTRD;
+      } else if (columnLabel == "fTOFSignal" || columnLabel == "fBeta") {
+        info.requiredDetector = kUseTOF;
       }
-
-      std::optional<std::pair<float, float>> scalingParams = std::nullopt;
-
       auto scalingParamsEntry = mScalingParams.find(columnLabel);
       if (scalingParamsEntry != mScalingParams.end()) {
-        scalingParams = scalingParamsEntry->second;
+        info.scaled = true;
+        info.scalingParams = scalingParamsEntry->second;
       }
+      mColumnInfos.push_back(info);
+    }
+  }
 
-      float value = mGetters[i](track);
-
-      if (scalingParams) {
-        value = scale(value, scalingParams.value());
+  void fillValues(const typename T::iterator& track, int detectorsUsed, float* output) const
+  {
+    for (std::size_t i = 0; i < mColumnInfos.size(); ++i) {
+      const auto& info = mColumnInfos[i];
+      if ((info.requiredDetector & detectorsUsed) != info.requiredDetector) {
+        output[i] = std::numeric_limits<float>::quiet_NaN();
+        continue;
       }
-
-      output.push_back(value);
+      float value = mGetters[i](track);
+      output[i] = info.scaled ? scale(value, info.scalingParams) : value;
     }
+  }
 
+  std::vector<float> getValues(const typename T::iterator& track) const
+  {
+    std::vector<float> output(mColumnInfos.size());
+    fillValues(track, getDetectorsUsed(track), output.data());
     return output;
   }
 
-  float getModelOutput(const typename T::iterator& track)
+  // Runs the model on nRows rows of features stored contiguously, one certainty per row in output
+  void runModel(std::vector<float>& inputTensorValues, std::size_t nRows, std::vector<float>& output)
   {
-    // First rank of the expected model input is -1 which means that it is dynamic axis.
-    // Axis is exported as dynamic to make it possible to run model inference with the batch of
-    // tracks at once in the future (batch would need to have the same amount of quiet_NaNs in each row).
-    // For now we hardcode 1.
-    static constexpr int64_t BatchSize = 1;
+    // First rank of the expected model input is -1 which means that it is dynamic axis,
+    // the rows of a batch must have the same amount of quiet_NaNs.
     auto inputShape = mInputShapes[0];
-    inputShape[0] = BatchSize;
+    inputShape[0] = static_cast<int64_t>(nRows);
+    output.assign(nRows, 0.f);
 
-    std::vector<float> inputTensorValues = getValues(track);
     std::vector<Ort::Value> inputTensors;
-
-    Ort::MemoryInfo memInfo = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
-    inputTensors.emplace_back(Ort::Value::CreateTensor<float>(memInfo, inputTensorValues.data(), inputTensorValues.size(), inputShape.data(), inputShape.size()));
+    inputTensors.emplace_back(Ort::Value::CreateTensor<float>(mMemoryInfo, inputTensorValues.data(), inputTensorValues.size(), inputShape.data(), inputShape.size()));
 
     // Double-check the dimensions of the input tensor
     assert(inputTensors[0].IsTensor() &&
@@ -269,27 +326,41 @@ struct PidONNXModel {
 
     try {
       Ort::RunOptions runOptions;
-      std::vector<const char*> inputNamesChar(mInputNames.size(), nullptr);
-      std::transform(std::begin(mInputNames), std::end(mInputNames), std::begin(inputNamesChar),
-                     [&](const std::string& str) { return str.c_str(); });
-
-      std::vector<const char*> outputNamesChar(mOutputNames.size(), nullptr);
-      std::transform(std::begin(mOutputNames), std::end(mOutputNames), std::begin(outputNamesChar),
-                     [&](const std::string& str) { return str.c_str(); });
-      auto outputTensors = mSession->Run(runOptions, inputNamesChar.data(), inputTensors.data(), inputTensors.size(), outputNamesChar.data(), outputNamesChar.size());
+      auto outputTensors = mSession->Run(runOptions, mInputNamesChar.data(), inputTensors.data(), inputTensors.size(), mOutputNamesChar.data(), mOutputNamesChar.size());
 
       // Double-check the dimensions of the output tensors
       // The number of output tensors is equal to the number of output nodes specified in the Run() call
       assert(outputTensors.size() == mOutputNames.size() && outputTensors[0].IsTensor());
       LOG(debug) << "output tensor shape: " << printShape(outputTensors[0].GetTensorTypeAndShapeInfo().GetShape());
 
-      const float* outputValue = outputTensors[0].GetTensorData<float>();
-      float certainty = *outputValue;
-      return certainty;
+      // certainty is the first value of each output row
+      const float* outputValues = outputTensors[0].GetTensorData<float>();
+      const std::size_t rowSize = outputTensors[0].GetTensorTypeAndShapeInfo().GetElementCount() / nRows;
+      for (std::size_t iRow = 0; iRow < nRows; ++iRow) {
+        output[iRow] = outputValues[iRow * rowSize];
+      }
     } catch (const Ort::Exception& exception) {
       LOG(error) << "Error running model inference: " << exception.what();
     }
-    return false; // unreachable code
+  }
+
+  float getModelOutput(const typename T::iterator& track)
+  {
+    std::vector<float> inputTensorValues = getValues(track);
+    std::vector<float> output;
+    runModel(inputTensorValues, 1, output);
+    return output[0];
+  }
+
+  // C strings of the node names passed to Run(), pointing to mInputNames and mOutputNames
+  void setNamesChar()
+  {
+    mInputNamesChar.resize(mInputNames.size());
+    std::transform(std::begin(mInputNames), std::end(mInputNames), std::begin(mInputNamesChar),
+                   [&](const std::string& str) { return str.c_str(); });
+    mOutputNamesChar.resize(mOutputNames.size());
+    std::transform(std::begin(mOutputNames), std::end(mOutputNames), std::begin(mOutputNamesChar),
+                   [&](const std::string& str) { return str.c_str(); });
   }
 
   // Pretty prints a shape dimension vector
@@ -306,6 +377,13 @@ struct PidONNXModel {
   std::vector<float (*)(const typename T::iterator&)> mGetters;
   std::map<std::string, std::pair<float, float>> mScalingParams;
 
+  struct ColumnInfo {
+    int requiredDetector = 0; // kUseTOF or kUseTRD if the feature is NaN without the detector
+    bool scaled = false;
+    std::pair<float, float> scalingParams{0.f, 1.f};
+  };
+  std::vector<ColumnInfo> mColumnInfos;
+
   std::shared_ptr<Ort::Env> mEnv = nullptr;
   // No empty constructors for Session, we need a pointer
   std::shared_ptr<Ort::Session> mSession = nullptr;
@@ -315,6 +393,9 @@ struct PidONNXModel {
   std::vector<std::vector<int64_t>> mInputShapes;
   std::vector<std::string> mOutputNames;
   std::vector<std::vector<int64_t>> mOutputShapes;
+  std::vector<const char*> mInputNamesChar;
+  std::vector<const char*> mOutputNamesChar;
+  Ort::MemoryInfo mMemoryInfo = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
 };
 
 #endif // TOOLS_PIDML_PIDONNXMODEL_H_
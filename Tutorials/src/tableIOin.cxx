@@ -13,7 +13,10 @@
 /// \author
 /// \since
 
+#include "Common/Core/TaskInstrumentation.h"
+
 #include "Framework/AnalysisTask.h"
+#include "Framework/HistogramRegistry.h"
 #include "Framework/runDataProcessing.h"
 
 namespace o2::aod
@@ -35,8 +38,24 @@ using namespace o2;
 using namespace o2::framework;
 
 struct RootReader {
+  // The time waited for each DF is in Instrumentation/hInputWaitPerDF. If it is a large fraction of the
+  // wall time, the reading can be overlapped with the processing with more readers (--readers N),
+  // within the memory allowed by --aod-memory-rate-limit
+  Configurable<bool> cfgInstrumentation{"cfgInstrumentation", false, "Measure the wait for the input per DF"};
+  HistogramRegistry registry{"registry"};
+  o2::common::core::TaskInstrumentation instrumentation;
+
+  void init(InitContext&)
+  {
+    if (cfgInstrumentation) {
+      instrumentation.init(registry, "root-reader", {"Process"});
+    }
+  }
+
   void process(aod::PtRange const& ptranges, aod::EtaRange const& etaranges)
   {
+    auto dataFrame = instrumentation.dataFrame();
+    auto timer = instrumentation.time(0, ptranges.size());
     // check ptranges and etaranges to have same number of rows
     if (ptranges.size() != etaranges.size()) {
       LOGF(